@@ -3,13 +3,73 @@
 #include "Engine/Application/Node/NodeTree.h"
 #include "Engine/System/Object/Variant.h"
 #include "TestNode.h"
+#include "SceneBenchmark.h"
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
 
 using namespace Engine;
 //using var = Variant;
 
-int main() {
+namespace {
 	using App = ::Engine::Engine;
 
+	bool ParseOption(std::string_view argument, std::string_view name, std::string_view& value) {
+		if (argument.size() < name.size() + 1 || argument.substr(0, name.size()) != name || argument[name.size()] != '=') {
+			return false;
+		}
+		value = argument.substr(name.size() + 1);
+		return true;
+	}
+
+	/// @brief --benchmark [--nodes=<count>] [--frames=<count>] [--warmup=<count>] [--json=<path>]\n
+	/// Spawns the test nodes in a headless engine ticking as fast as it can, and writes the frame times, to SceneBenchmark.json by default, for Benchmark --baseline=<path> --compare=<path>.
+	int RunSceneBenchmark(int argc, char** argv) {
+		int32 nodes = 1000;
+		int32 frames = 600;
+		int32 warmup = 60;
+		String json = u8"SceneBenchmark.json";
+		for (int i = 1; i < argc; i += 1) {
+			std::string_view argument = argv[i];
+			std::string_view value{};
+			if (argument == "--benchmark") {
+				continue;
+			} else if (ParseOption(argument, "--nodes", value)) {
+				nodes = std::atoi(value.data());
+			} else if (ParseOption(argument, "--frames", value)) {
+				frames = std::atoi(value.data());
+			} else if (ParseOption(argument, "--warmup", value)) {
+				warmup = std::atoi(value.data());
+			} else if (ParseOption(argument, "--json", value)) {
+				json = String(std::string(value));
+			} else {
+				ERR_MSG(String::Format(u8"Unknown argument {0}.", String(std::string(argument))).GetRawArray());
+				return 1;
+			}
+		}
+		ERR_ASSERT(nodes >= 0 && frames > 0 && warmup >= 0, u8"--nodes and --warmup must not be negative, --frames must be positive.", return 1);
+
+		UniquePtr<App> engine = UniquePtr<App>::Create(true);
+		engine->SetTargetFps(-1);
+		UniquePtr<NodeTree> tree{ MEMNEW(NodeTree()) };
+		for (int32 i = 0; i < nodes; i += 1) {
+			tree->GetRoot()->AddChild(MEMNEW(Application::TestNode(false)));
+		}
+		tree->GetRoot()->AddChild(MEMNEW(Application::SceneBenchmark(String::Format(u8"Scene/TestNodes/{0}", nodes), warmup, frames, json)));
+
+		engine->SetAppLoop(UniquePtr<AppLoop>(tree.Release()));
+		engine->Run();
+		return 0;
+	}
+}
+
+int main(int argc, char** argv) {
+	for (int i = 1; i < argc; i += 1) {
+		if (std::strcmp(argv[i], "--benchmark") == 0) {
+			return RunSceneBenchmark(argc, argv);
+		}
+	}
+
 	UniquePtr<App> engine = UniquePtr<App>::Create();
 	UniquePtr<NodeTree> tree{ MEMNEW(NodeTree()) };
 
@@ -25,4 +85,4 @@ int main() {
 	engine->Run();
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,71 @@
+#include "SceneBenchmark.h"
+#include "Engine/Application/Engine.h"
+#include "Engine/Application/Node/NodeTree.h"
+#include <cmath>
+#include <cstdio>
+
+using namespace Engine;
+namespace Application {
+	namespace {
+		double Median(List<double>& values) {
+			int32 count = values.GetCount();
+			values.Sort();
+			return count % 2 == 1 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+		}
+	}
+
+	SceneBenchmark::SceneBenchmark(const String& benchmarkName, int32 warmupFrames, int32 frames, const String& jsonPath)
+		:benchmarkName(benchmarkName), warmupFrames(warmupFrames), frames(frames), jsonPath(jsonPath) {
+		ERR_ASSERT(frames > 0, u8"frames must be positive.", return);
+		SetUpdateEnabled(true);
+	}
+	void SceneBenchmark::OnUpdate(float delta) {
+		if (warmupFrames > 0) {
+			warmupFrames -= 1;
+			return;
+		}
+		if (samples.GetCount() >= frames) {
+			return;
+		}
+		// The delta given is scaled, the frame took the unscaled one.
+		samples.Add(::Engine::Engine::GetInstance()->GetTime().GetUnscaledDelta() * 1e9);
+		if (samples.GetCount() == frames) {
+			Write();
+			GetTree()->RequestStop();
+		}
+	}
+	void SceneBenchmark::Write() {
+		List<double> sorted = samples;
+		int32 count = sorted.GetCount();
+		double median = Median(sorted);
+		List<double> deviations{};
+		double mean = 0;
+		for (double sample : samples) {
+			deviations.Add(std::fabs(sample - median));
+			mean += sample / count;
+		}
+		double medianDeviation = Median(deviations);
+		double deviation = 0;
+		for (double sample : samples) {
+			deviation += (sample - mean) * (sample - mean) / count;
+		}
+		deviation = std::sqrt(deviation);
+
+		bool print = jsonPath == u8"-";
+		std::FILE* file = print ? stdout : std::fopen((const char*)jsonPath.GetRawArray(), "w");
+		ERR_ASSERT(file != nullptr, String::Format(u8"Cannot write {0}.", jsonPath).GetRawArray(), return);
+
+		std::fprintf(file, "{\n\t\"context\": {\n\t\t\"frames\": %d\n\t},\n", count);
+		std::fprintf(file, "\t\"benchmarks\": [\n\t\t{\n\t\t\t\"name\": \"%s\",\n\t\t\t\"iterations\": %d,\n", (const char*)benchmarkName.GetRawArray(), count);
+		std::fprintf(file, "\t\t\t\"median_ns\": %.3f,\n\t\t\t\"mean_ns\": %.3f,\n\t\t\t\"min_ns\": %.3f,\n\t\t\t\"stddev_ns\": %.3f,\n\t\t\t\"mad_ns\": %.3f,\n",
+			median, mean, sorted[0], deviation, medianDeviation);
+		std::fprintf(file, "\t\t\t\"samples_ns\": [");
+		for (int32 i = 0; i < count; i += 1) {
+			std::fprintf(file, i == 0 ? "%.3f" : ", %.3f", samples[i]);
+		}
+		std::fprintf(file, "]\n\t\t}\n\t]\n}\n");
+		if (!print) {
+			std::fclose(file);
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Engine/Application/Node/Node.h"
+#include "Engine/System/Collection/List.h"
+
+namespace Application {
+	/// @brief Records the duration of every frame, then stops the tree and writes them as JSON in the format of the Benchmark target,
+	/// so its --baseline and --compare options gate the result like any other benchmark.\n
+	/// Add it next to the scene to measure, with the engine running headless and without a frame limit.
+	class SceneBenchmark :public ::Engine::Node {
+		REFLECTION_CLASS(::Application::SceneBenchmark, ::Engine::Node) {}
+
+	public:
+		/// @param benchmarkName Name of the benchmark in the JSON, "Scene/<Case>".
+		/// @param warmupFrames Frames skipped before recording, while the caches and allocators settle.
+		/// @param frames Frames recorded.
+		/// @param jsonPath Where to write the results, "-" to print them among the logs of the engine.
+		SceneBenchmark(const ::Engine::String& benchmarkName, ::Engine::int32 warmupFrames, ::Engine::int32 frames, const ::Engine::String& jsonPath);
+		void OnUpdate(float delta) override;
+
+	private:
+		void Write();
+
+		::Engine::String benchmarkName;
+		::Engine::int32 warmupFrames;
+		::Engine::int32 frames;
+		::Engine::String jsonPath;
+		/// @brief In nanoseconds.
+		::Engine::List<double> samples{};
+	};
+}
@@ -7,26 +7,34 @@
 
 using namespace Engine;
 namespace Application {
-	TestNode::TestNode() {
+	TestNode::TestNode(bool verbose) :verbose(verbose) {
+		SetUpdateEnabled(true);
 		Node* node = MEMNEW(Node());
 		AddChild(node);
 	}
 	void TestNode::OnEnteredTree() {
+		if (!verbose) {
+			return;
+		}
 		INFO_MSG(String::Format(u8"{0}: Entered tree.",GetName()).GetRawArray());
 	}
 	void TestNode::OnReady() {
-		INFO_MSG(String::Format(u8"{0}: Ready.", GetName()).GetRawArray());
+		if (verbose) {
+			INFO_MSG(String::Format(u8"{0}: Ready.", GetName()).GetRawArray());
+		}
 
-		::Engine::Engine::
-			GetInstance()->
-			GetWindowSystem()->
-			GetWindow(0)->
-			ConnectSignal(STRL("KeyDown"), Invokable(this, STRL("OnKeyDown")));
+		// Headless engines have no window.
+		Window* window = ::Engine::Engine::GetInstance()->GetWindowSystem()->GetWindow(0);
+		if (window != nullptr) {
+			window->ConnectSignal(STRL("KeyDown"), Invokable(this, STRL("OnKeyDown")));
+		}
 	}
 	void TestNode::OnUpdate(float delta) {
 		double elapsed = ::Engine::Engine::GetInstance()->GetTime().GetTotal();
 		if (elapsed > next) {
-			INFO_MSG(String::Format(u8"{0}: {1} seconds elapsed!.", GetName(),elapsed).GetRawArray());
+			if (verbose) {
+				INFO_MSG(String::Format(u8"{0}: {1} seconds elapsed!.", GetName(),elapsed).GetRawArray());
+			}
 			next += 1;
 			border = !border;
 
@@ -34,6 +42,9 @@ namespace Application {
 		}
 	}
 	void TestNode::OnExitingTree() {
+		if (!verbose) {
+			return;
+		}
 		INFO_MSG(String::Format(u8"{0}: Exiting tree.", GetName()).GetRawArray());
 	}
 
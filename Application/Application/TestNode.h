@@ -8,7 +8,8 @@ namespace Application {
 		}
 
 	public:
-		TestNode();
+		/// @param verbose Log the tree notifications and the time, off when spawning many for the scene benchmark.
+		TestNode(bool verbose = true);
 		void OnEnteredTree() override;
 		void OnReady() override;
 		void OnUpdate(float delta) override;
@@ -17,6 +18,7 @@ namespace Application {
 
 		void OnKeyDown(::Engine::int32 keyCode);
 	private:
+		bool verbose;
 		double next = 1;
 		bool border = true;
 	};
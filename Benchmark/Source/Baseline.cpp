@@ -0,0 +1,258 @@
+#include "Baseline.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string_view>
+
+using namespace Engine;
+
+namespace Benchmark {
+	namespace {
+		/// @brief Scale of the median absolute deviation to a standard deviation, for normally distributed samples.
+		constexpr double DeviationScale = 1.4826;
+		constexpr double Significance = 3;
+
+		/// @brief Just enough JSON to read the benchmarks back: strings without unicode escapes are kept, other values are skipped.
+		class Reader final {
+		public:
+			explicit Reader(std::string_view text) :text(text) {}
+
+			void SkipSpace() {
+				while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r')) {
+					position += 1;
+				}
+			}
+			bool Consume(char c) {
+				SkipSpace();
+				if (position < text.size() && text[position] == c) {
+					position += 1;
+					return true;
+				}
+				return false;
+			}
+			char Peek() {
+				SkipSpace();
+				return position < text.size() ? text[position] : '\0';
+			}
+			bool ReadString(std::string& result) {
+				result.clear();
+				if (!Consume('"')) {
+					return false;
+				}
+				while (position < text.size() && text[position] != '"') {
+					char c = text[position];
+					if (c == '\\') {
+						position += 1;
+						if (position >= text.size()) {
+							return false;
+						}
+						c = text[position];
+						c = c == 'n' ? '\n' : c == 't' ? '\t' : c;
+					}
+					result += c;
+					position += 1;
+				}
+				return Consume('"');
+			}
+			bool ReadNumber(double& result) {
+				SkipSpace();
+				const char* begin = text.data() + position;
+				char* end = nullptr;
+				result = std::strtod(begin, &end);
+				if (end == begin) {
+					return false;
+				}
+				position += end - begin;
+				return true;
+			}
+			bool SkipValue() {
+				char c = Peek();
+				if (c == '"') {
+					std::string ignored{};
+					return ReadString(ignored);
+				}
+				if (c == '{' || c == '[') {
+					char close = c == '{' ? '}' : ']';
+					position += 1;
+					if (Consume(close)) {
+						return true;
+					}
+					do {
+						if (c == '{') {
+							std::string ignored{};
+							if (!ReadString(ignored) || !Consume(':')) {
+								return false;
+							}
+						}
+						if (!SkipValue()) {
+							return false;
+						}
+					} while (Consume(','));
+					return Consume(close);
+				}
+				for (std::string_view word : { std::string_view("true"), std::string_view("false"), std::string_view("null") }) {
+					if (text.substr(position, word.size()) == word) {
+						position += word.size();
+						return true;
+					}
+				}
+				double ignored = 0;
+				return ReadNumber(ignored);
+			}
+
+		private:
+			std::string_view text;
+			size_t position = 0;
+		};
+
+		bool ReadMeasurement(Reader& reader, Measurement& result) {
+			if (!reader.Consume('{')) {
+				return false;
+			}
+			if (reader.Consume('}')) {
+				return true;
+			}
+			do {
+				std::string key{};
+				if (!reader.ReadString(key) || !reader.Consume(':')) {
+					return false;
+				}
+				bool read = true;
+				if (key == "name") {
+					read = reader.ReadString(result.name);
+				} else if (key == "median_ns") {
+					read = reader.ReadNumber(result.median);
+				} else if (key == "mad_ns") {
+					read = reader.ReadNumber(result.deviation);
+				} else if (key == "tolerance") {
+					read = reader.ReadNumber(result.tolerance);
+				} else {
+					read = reader.SkipValue();
+				}
+				if (!read) {
+					return false;
+				}
+			} while (reader.Consume(','));
+			return reader.Consume('}');
+		}
+		bool ReadBenchmarks(Reader& reader, List<Measurement>& result) {
+			if (!reader.Consume('{')) {
+				return false;
+			}
+			if (reader.Consume('}')) {
+				return true;
+			}
+			do {
+				std::string key{};
+				if (!reader.ReadString(key) || !reader.Consume(':')) {
+					return false;
+				}
+				if (key != "benchmarks") {
+					if (!reader.SkipValue()) {
+						return false;
+					}
+					continue;
+				}
+				if (!reader.Consume('[')) {
+					return false;
+				}
+				if (reader.Consume(']')) {
+					continue;
+				}
+				do {
+					if (!ReadMeasurement(reader, result.Emplace())) {
+						return false;
+					}
+				} while (reader.Consume(','));
+				if (!reader.Consume(']')) {
+					return false;
+				}
+			} while (reader.Consume(','));
+			return reader.Consume('}');
+		}
+	}
+
+	bool ReadMeasurements(const char* path, List<Measurement>& result) {
+		std::FILE* file = std::fopen(path, "rb");
+		if (file == nullptr) {
+			std::fprintf(stderr, "Cannot read %s.\n", path);
+			return false;
+		}
+		std::string text{};
+		char buffer[4096];
+		size_t read = 0;
+		while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+			text.append(buffer, read);
+		}
+		std::fclose(file);
+
+		Reader reader(text);
+		if (!ReadBenchmarks(reader, result)) {
+			std::fprintf(stderr, "%s is not a JSON file of benchmarks.\n", path);
+			return false;
+		}
+		return true;
+	}
+
+	int32 Compare(const List<Measurement>& baseline, const List<Measurement>& current, double tolerance, std::FILE* output) {
+		std::fprintf(output, "\n%-40s %12s %12s %9s  %s\n", "Compared to baseline", "Baseline ns", "Current ns", "Change", "Verdict");
+		int32 regressions = 0;
+		for (const auto& base : baseline) {
+			const Measurement* found = nullptr;
+			for (const auto& one : current) {
+				if (one.name == base.name) {
+					found = &one;
+					break;
+				}
+			}
+			if (found == nullptr) {
+				std::fprintf(output, "%-40s %12.1f %12s %9s  %s\n", base.name.c_str(), base.median, "-", "-", "missing");
+				continue;
+			}
+
+			double allowed = base.tolerance >= 0 ? base.tolerance : tolerance;
+			double change = base.median > 0 ? found->median / base.median - 1 : 0;
+			double baseHigh = base.median + Significance * DeviationScale * base.deviation;
+			double currentLow = found->median - Significance * DeviationScale * found->deviation;
+			const char* verdict = "ok";
+			if (change > allowed) {
+				if (currentLow > baseHigh) {
+					verdict = "REGRESSION";
+					regressions += 1;
+				} else {
+					verdict = "slower, within noise";
+				}
+			} else if (change < -allowed && found->median + Significance * DeviationScale * found->deviation < base.median - Significance * DeviationScale * base.deviation) {
+				verdict = "faster";
+			}
+			std::fprintf(output, "%-40s %12.1f %12.1f %+8.1f%%  %s\n", base.name.c_str(), base.median, found->median, change * 100, verdict);
+		}
+		for (const auto& one : current) {
+			bool known = false;
+			for (const auto& base : baseline) {
+				known = known || base.name == one.name;
+			}
+			if (!known) {
+				std::fprintf(output, "%-40s %12s %12.1f %9s  %s\n", one.name.c_str(), "-", one.median, "-", "new");
+			}
+		}
+		std::fprintf(output, "%d regression(s).\n", regressions);
+		return regressions;
+	}
+
+	double Median(List<double>& values) {
+		int32 count = values.GetCount();
+		if (count == 0) {
+			return 0;
+		}
+		values.Sort();
+		return count % 2 == 1 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+	}
+	double MedianAbsoluteDeviation(const List<double>& values, double median) {
+		List<double> deviations{};
+		for (double value : values) {
+			deviations.Add(std::fabs(value - median));
+		}
+		return Median(deviations);
+	}
+}
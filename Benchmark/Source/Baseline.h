@@ -0,0 +1,37 @@
+#pragma once
+#include "Engine/System/Collection/List.h"
+#include <cstdio>
+#include <string>
+
+namespace Benchmark {
+	using Engine::int32;
+
+	/// @brief A benchmark read back from the JSON written by RunAll(), or by the scene benchmark of the Application which writes the same keys.
+	struct Measurement {
+		std::string name;
+		/// @brief In nanoseconds per iteration.
+		double median = 0;
+		/// @brief Median absolute deviation of the repetitions, 0 if the file doesn't have it.
+		double deviation = 0;
+		/// @brief Slowdown allowed as a fraction of the median, negative to use the one given to Compare().
+		double tolerance = -1;
+	};
+
+	/// @brief Read the "benchmarks" of a JSON file, the other keys are skipped.
+	/// @return false if the file can't be read or is not valid JSON of that shape.
+	bool ReadMeasurements(const char* path, Engine::List<Measurement>& result);
+
+	/// @brief Print every benchmark of the baseline next to its current median, flagging the regressions.\n
+	/// A benchmark regressed when its median is slower than the tolerance allows and the slowdown is significant:
+	/// the current median minus 3 deviations is still above the baseline median plus 3 deviations, deviations
+	/// being the median absolute deviations scaled to be comparable to standard deviations. Noisy benchmarks need larger slowdowns to be flagged.
+	/// @param tolerance Of the benchmarks without their own in the baseline, as a fraction, 0.05 for 5%.
+	/// @param output Where the report is printed.
+	/// @return How many regressed.
+	int32 Compare(const Engine::List<Measurement>& baseline, const Engine::List<Measurement>& current, double tolerance, std::FILE* output);
+
+	/// @brief Median of the values, sorted in place. 0 if there are none.
+	double Median(Engine::List<double>& values);
+	/// @brief Median absolute deviation from the median. 0 if there are none.
+	double MedianAbsoluteDeviation(const Engine::List<double>& values, double median);
+}
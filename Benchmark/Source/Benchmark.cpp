@@ -0,0 +1,357 @@
+#include "Benchmark.h"
+#include "Baseline.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <string_view>
+
+using namespace Engine;
+
+namespace Benchmark {
+#pragma region State
+	State::State(int64 iterations) :iterations(iterations) {}
+
+	int64 State::GetIterations() const {
+		return iterations;
+	}
+	int64 State::GetTime() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	bool State::Advance() {
+		if (!started) {
+			started = true;
+			remaining = iterations - 1;
+			start = GetTime();
+			return iterations > 0;
+		}
+		int64 now = GetTime();
+		if (pausedAt >= 0) {
+			now = pausedAt;
+			pausedAt = -1;
+		}
+		elapsed += now - start;
+		return false;
+	}
+
+	void State::PauseTiming() {
+		if (started && pausedAt < 0) {
+			pausedAt = GetTime();
+		}
+	}
+	void State::ResumeTiming() {
+		if (pausedAt >= 0) {
+			elapsed += pausedAt - start;
+			pausedAt = -1;
+			start = GetTime();
+		}
+	}
+
+	void State::SetItemsProcessed(int64 items) {
+		this->items = items;
+	}
+	void State::SetBytesProcessed(int64 bytes) {
+		this->bytes = bytes;
+	}
+	int64 State::GetElapsed() const {
+		return elapsed;
+	}
+	int64 State::GetItemsProcessed() const {
+		return items;
+	}
+	int64 State::GetBytesProcessed() const {
+		return bytes;
+	}
+#pragma endregion
+
+#pragma region Runner
+	namespace {
+		struct Entry {
+			const char* name;
+			Function function;
+		};
+		struct Options {
+			std::string_view filter{};
+			double minTime = 0.2;
+			int32 repetitions = 5;
+			const char* json = nullptr;
+			bool list = false;
+			const char* baseline = nullptr;
+			const char* compare = nullptr;
+			double tolerance = 0.05;
+		};
+		struct Result {
+			const char* name;
+			int64 iterations;
+			/// @brief In nanoseconds per iteration, over the repetitions.
+			double median;
+			double mean;
+			double min;
+			double deviation;
+			/// @brief Median absolute deviation, what the comparison to a baseline uses since it ignores the outliers.
+			double medianDeviation;
+			/// @brief Of each repetition, in the order they ran.
+			List<double> samples;
+			/// @brief Per second, negative if not reported.
+			double itemsRate;
+			double bytesRate;
+		};
+
+		List<Entry>& GetEntries() {
+			static List<Entry> entries{};
+			return entries;
+		}
+
+		bool ParseOption(std::string_view argument, std::string_view name, std::string_view& value) {
+			if (argument.size() < name.size() + 1 || argument.substr(0, name.size()) != name || argument[name.size()] != '=') {
+				return false;
+			}
+			value = argument.substr(name.size() + 1);
+			return true;
+		}
+		bool ParseOptions(int argc, char** argv, Options& options) {
+			for (int i = 1; i < argc; i += 1) {
+				std::string_view argument = argv[i];
+				std::string_view value{};
+				if (ParseOption(argument, "--filter", value)) {
+					options.filter = value;
+				} else if (ParseOption(argument, "--min-time", value)) {
+					options.minTime = std::atof(value.data());
+				} else if (ParseOption(argument, "--repetitions", value)) {
+					options.repetitions = std::atoi(value.data());
+				} else if (ParseOption(argument, "--json", value)) {
+					options.json = value.data();
+				} else if (ParseOption(argument, "--baseline", value)) {
+					options.baseline = value.data();
+				} else if (ParseOption(argument, "--compare", value)) {
+					options.compare = value.data();
+				} else if (ParseOption(argument, "--tolerance", value)) {
+					options.tolerance = std::atof(value.data());
+				} else if (argument == "--list") {
+					options.list = true;
+				} else {
+					std::fprintf(stderr, "Unknown argument %s.\n", argv[i]);
+					return false;
+				}
+			}
+			if (options.minTime <= 0 || options.repetitions <= 0) {
+				std::fprintf(stderr, "--min-time and --repetitions must be positive.\n");
+				return false;
+			}
+			if (options.tolerance < 0) {
+				std::fprintf(stderr, "--tolerance must not be negative.\n");
+				return false;
+			}
+			if (options.compare != nullptr && options.baseline == nullptr) {
+				std::fprintf(stderr, "--compare needs --baseline.\n");
+				return false;
+			}
+			return true;
+		}
+
+		State RunOnce(const Entry& entry, int64 iterations) {
+			State state(iterations);
+			entry.function(state);
+			return state;
+		}
+		/// @brief The iterations of a run taking the least time, growing them until a run does.
+		int64 Calibrate(const Entry& entry, double minTime) {
+			int64 iterations = 1;
+			while (true) {
+				State state = RunOnce(entry, iterations);
+				double seconds = state.GetElapsed() / 1e9;
+				if (seconds >= minTime || iterations >= 1000000000) {
+					return iterations;
+				}
+				// Aim a bit past the time, growing 10 times at most in case the first runs were noise.
+				double scale = seconds <= 0 ? 10.0 : minTime * 1.4 / seconds;
+				int64 next = (int64)(iterations * (scale < 10.0 ? scale : 10.0));
+				iterations = next > iterations ? next : iterations + 1;
+			}
+		}
+		Result Measure(const Entry& entry, const Options& options) {
+			int64 iterations = Calibrate(entry, options.minTime);
+			List<double> times{};
+			double items = 0;
+			double bytes = 0;
+			double seconds = 0;
+			bool hasItems = false;
+			bool hasBytes = false;
+			for (int32 i = 0; i < options.repetitions; i += 1) {
+				State state = RunOnce(entry, iterations);
+				times.Add((double)state.GetElapsed() / iterations);
+				seconds += state.GetElapsed() / 1e9;
+				hasItems = state.GetItemsProcessed() >= 0;
+				hasBytes = state.GetBytesProcessed() >= 0;
+				items += hasItems ? (double)state.GetItemsProcessed() : 0;
+				bytes += hasBytes ? (double)state.GetBytesProcessed() : 0;
+			}
+			Result result{};
+			result.name = entry.name;
+			result.iterations = iterations;
+			result.samples = times;
+			int32 count = times.GetCount();
+			result.median = Median(times);
+			result.medianDeviation = MedianAbsoluteDeviation(times, result.median);
+			result.min = times[0];
+			for (double time : times) {
+				result.mean += time / count;
+			}
+			for (double time : times) {
+				result.deviation += (time - result.mean) * (time - result.mean) / count;
+			}
+			result.deviation = std::sqrt(result.deviation);
+			result.itemsRate = hasItems && seconds > 0 ? items / seconds : -1;
+			result.bytesRate = hasBytes && seconds > 0 ? bytes / seconds : -1;
+			return result;
+		}
+
+		void PrintRate(double rate, const char* unit) {
+			if (rate < 0) {
+				std::printf(" %14s", "");
+			} else if (rate >= 1e9) {
+				std::printf(" %9.2f G%s/s", rate / 1e9, unit);
+			} else if (rate >= 1e6) {
+				std::printf(" %9.2f M%s/s", rate / 1e6, unit);
+			} else {
+				std::printf(" %9.2f k%s/s", rate / 1e3, unit);
+			}
+		}
+		void PrintTable(const Result& result) {
+			std::printf("%-40s %12lld %12.1f %12.1f %7.1f%%", result.name, (long long)result.iterations, result.median, result.min,
+				result.mean > 0 ? result.deviation * 100 / result.mean : 0.0);
+			PrintRate(result.itemsRate, "");
+			PrintRate(result.bytesRate, "B");
+			std::printf("\n");
+			std::fflush(stdout);
+		}
+
+		void WriteString(std::FILE* file, const char* text) {
+			std::fputc('"', file);
+			for (const char* c = text; *c != '\0'; c += 1) {
+				if (*c == '"' || *c == '\\') {
+					std::fputc('\\', file);
+				}
+				std::fputc(*c, file);
+			}
+			std::fputc('"', file);
+		}
+		void WriteJson(std::FILE* file, const List<Result>& results, const Options& options) {
+			char date[32] = {};
+			std::time_t now = std::time(nullptr);
+			std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+			std::fprintf(file, "{\n\t\"context\": {\n");
+			std::fprintf(file, "\t\t\"date\": \"%s\",\n", date);
+			std::fprintf(file, "\t\t\"hardware_threads\": %d,\n", ThreadUtil::GetHardwareThreadCount());
+#if defined(NDEBUG)
+			std::fprintf(file, "\t\t\"build\": \"release\",\n");
+#else
+			std::fprintf(file, "\t\t\"build\": \"debug\",\n");
+#endif
+			std::fprintf(file, "\t\t\"min_time\": %g,\n\t\t\"repetitions\": %d\n\t},\n", options.minTime, options.repetitions);
+			std::fprintf(file, "\t\"benchmarks\": [");
+			for (int32 i = 0; i < results.GetCount(); i += 1) {
+				const Result& result = results[i];
+				std::fprintf(file, i == 0 ? "\n\t\t{\n\t\t\t\"name\": " : ",\n\t\t{\n\t\t\t\"name\": ");
+				WriteString(file, result.name);
+				std::fprintf(file, ",\n\t\t\t\"iterations\": %lld,\n", (long long)result.iterations);
+				std::fprintf(file, "\t\t\t\"median_ns\": %.3f,\n\t\t\t\"mean_ns\": %.3f,\n\t\t\t\"min_ns\": %.3f,\n\t\t\t\"stddev_ns\": %.3f,\n\t\t\t\"mad_ns\": %.3f",
+					result.median, result.mean, result.min, result.deviation, result.medianDeviation);
+				std::fprintf(file, ",\n\t\t\t\"samples_ns\": [");
+				for (int32 j = 0; j < result.samples.GetCount(); j += 1) {
+					std::fprintf(file, j == 0 ? "%.3f" : ", %.3f", result.samples[j]);
+				}
+				std::fprintf(file, "]");
+				if (result.itemsRate >= 0) {
+					std::fprintf(file, ",\n\t\t\t\"items_per_second\": %.1f", result.itemsRate);
+				}
+				if (result.bytesRate >= 0) {
+					std::fprintf(file, ",\n\t\t\t\"bytes_per_second\": %.1f", result.bytesRate);
+				}
+				std::fprintf(file, "\n\t\t}");
+			}
+			std::fprintf(file, "\n\t]\n}\n");
+		}
+	}
+
+	Registration::Registration(const char* name, Function function) {
+		GetEntries().Add(Entry{ name, function });
+	}
+
+	int32 RunAll(int argc, char** argv) {
+		Options options{};
+		if (!ParseOptions(argc, argv, options)) {
+			return 1;
+		}
+
+		List<Measurement> baseline{};
+		if (options.baseline != nullptr && !ReadMeasurements(options.baseline, baseline)) {
+			return 1;
+		}
+		if (options.compare != nullptr) {
+			List<Measurement> current{};
+			if (!ReadMeasurements(options.compare, current)) {
+				return 1;
+			}
+			return Compare(baseline, current, options.tolerance, stdout) > 0 ? 2 : 0;
+		}
+
+		List<Entry> entries{};
+		for (const auto& entry : GetEntries()) {
+			if (options.filter.empty() || std::string_view(entry.name).find(options.filter) != std::string_view::npos) {
+				entries.Add(entry);
+			}
+		}
+		entries.Sort([](const Entry& a, const Entry& b) {
+			return std::strcmp(a.name, b.name) < 0;
+		});
+		if (options.list) {
+			for (const auto& entry : entries) {
+				std::printf("%s\n", entry.name);
+			}
+			return 0;
+		}
+
+		bool table = options.json == nullptr || std::strcmp(options.json, "-") != 0;
+		if (table) {
+			std::printf("%-40s %12s %12s %12s %8s %14s %14s\n", "Benchmark", "Iterations", "Median ns", "Min ns", "Spread", "Items", "Bytes");
+		}
+		List<Result> results{};
+		for (const auto& entry : entries) {
+			results.Add(Measure(entry, options));
+			if (table) {
+				PrintTable(results[results.GetCount() - 1]);
+			}
+		}
+
+		if (options.json != nullptr) {
+			std::FILE* file = table ? std::fopen(options.json, "w") : stdout;
+			if (file == nullptr) {
+				std::fprintf(stderr, "Cannot write %s.\n", options.json);
+				return 1;
+			}
+			WriteJson(file, results, options);
+			if (file != stdout) {
+				std::fclose(file);
+			}
+		}
+
+		if (options.baseline != nullptr) {
+			List<Measurement> current{};
+			for (const auto& result : results) {
+				Measurement& measurement = current.Emplace();
+				measurement.name = result.name;
+				measurement.median = result.median;
+				measurement.deviation = result.medianDeviation;
+			}
+			// To the error output when the JSON is printed, keeping that parsable.
+			return Compare(baseline, current, options.tolerance, table ? stdout : stderr) > 0 ? 2 : 0;
+		}
+		return 0;
+	}
+#pragma endregion
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "Engine/System/Definition.h"
+
+namespace Benchmark {
+	using Engine::int32;
+	using Engine::int64;
+
+	/// @brief Given to a benchmark for one timed run of a number of iterations picked by the runner.\n
+	/// Loop on KeepRunning() around the code measured. The timer starts at its first call and stops at the last,
+	/// so the setup before the loop isn't measured.
+	class State final {
+	public:
+		explicit State(int64 iterations);
+
+		/// @brief true once per iteration. Only a decrement on the hot path, the clock is read on the first and last calls.
+		bool KeepRunning() {
+			if (remaining > 0) {
+				remaining -= 1;
+				return true;
+			}
+			return Advance();
+		}
+		int64 GetIterations() const;
+
+		/// @brief Leave out what runs until ResumeTiming(), the setup done each iteration for example. Reads the clock, so costs some tens of nanoseconds.
+		void PauseTiming();
+		void ResumeTiming();
+
+		/// @brief Over all the iterations, reported as items per second. Not reported unless set.
+		void SetItemsProcessed(int64 items);
+		/// @brief Over all the iterations, reported as bytes per second. Not reported unless set.
+		void SetBytesProcessed(int64 bytes);
+
+		/// @brief In nanoseconds, after the loop.
+		int64 GetElapsed() const;
+		int64 GetItemsProcessed() const;
+		int64 GetBytesProcessed() const;
+
+	private:
+		static int64 GetTime();
+		/// @brief Start the timer on the first call, stop it on the last.
+		bool Advance();
+
+		int64 iterations;
+		int64 remaining = 0;
+		bool started = false;
+		int64 start = 0;
+		int64 elapsed = 0;
+		int64 pausedAt = -1;
+		int64 items = -1;
+		int64 bytes = -1;
+	};
+
+	using Function = void (*)(State& state);
+
+	/// @brief Adds the benchmark to the ones RunAll() runs, made by BENCHMARK().
+	struct Registration final {
+		Registration(const char* name, Function function);
+	};
+
+	/// @brief Keep the compiler from optimizing the value away, nor the computation of it.
+	template<typename T>
+	inline void DoNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+		const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+		(void)*sink;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+	/// @brief Keep the compiler from optimizing away or reordering the writes to memory before it.
+	inline void ClobberMemory() {
+#if defined(_MSC_VER)
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : : "memory");
+#endif
+	}
+
+	/// @brief Run the registered benchmarks, in the order of their names, printing a table and optionally writing JSON.\n
+	/// --filter=<text> runs the ones with the text in their names, --min-time=<seconds> is the least time of each run, 0.2 by default,
+	/// --repetitions=<count> the runs of each, 5 by default, --json=<path> writes the results as JSON, "-" to print them instead of the table,
+	/// --list prints the names only.\n
+	/// --baseline=<path> compares the results to the JSON of an earlier run, --tolerance=<fraction> being the slowdown allowed, 0.05 by default,
+	/// unless the benchmark has its own "tolerance" in the baseline. With --compare=<path> it compares the JSON of another run instead of running any,
+	/// the one of the scene benchmark of the Application for example.
+	/// @return The exit code of the program, 2 if a benchmark regressed, 1 on errors.
+	int32 RunAll(int argc, char** argv);
+}
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+#define BENCHMARK_CASE_INNER(name, function)										\
+static void function(::Benchmark::State& state);									\
+static ::Benchmark::Registration BENCHMARK_CONCAT(function, _Registration)(name, function);	\
+static void function(::Benchmark::State& state)
+
+/// @brief Define a benchmark, the body takes ::Benchmark::State& state. Names are "<Group>/<Case>".
+#define BENCHMARK(name) BENCHMARK_CASE_INNER(name, BENCHMARK_CONCAT(Benchmark_, __COUNTER__))
@@ -0,0 +1,19 @@
+#include "Benchmark.h"
+#include "Engine/System/Collection/Deque.h"
+
+using namespace Engine;
+
+BENCHMARK("Deque/PushPop") {
+	constexpr int32 Count = 1000;
+	Deque<int32> deque{};
+	while (state.KeepRunning()) {
+		for (int32 i = 0; i < Count; i += 1) {
+			deque.PushBack(i);
+		}
+		int32 value = 0;
+		while (deque.TryPopFront(value)) {
+			Benchmark::DoNotOptimize(value);
+		}
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+}
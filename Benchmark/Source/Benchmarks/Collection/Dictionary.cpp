@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/String.h"
+
+using namespace Engine;
+
+namespace {
+	constexpr int32 Count = 1000;
+
+	void FillKeys(List<String>& keys) {
+		for (int32 i = 0; i < Count; i += 1) {
+			keys.Add(String::Format(STRL("key {0}"), i));
+		}
+	}
+}
+
+BENCHMARK("Dictionary/Insert") {
+	while (state.KeepRunning()) {
+		Dictionary<int32, int32> dictionary{};
+		for (int32 i = 0; i < Count; i += 1) {
+			dictionary.Set(i * 7, i);
+		}
+		Benchmark::DoNotOptimize(dictionary.GetCount());
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+}
+
+BENCHMARK("Dictionary/Lookup") {
+	Dictionary<int32, int32> dictionary{};
+	for (int32 i = 0; i < Count; i += 1) {
+		dictionary.Set(i * 7, i);
+	}
+	int32 key = 0;
+	while (state.KeepRunning()) {
+		int32 value = 0;
+		Benchmark::DoNotOptimize(dictionary.TryGet(key * 7, value));
+		Benchmark::DoNotOptimize(value);
+		key = (key + 337) % Count;
+	}
+}
+
+BENCHMARK("Dictionary/LookupString") {
+	List<String> keys{};
+	FillKeys(keys);
+	Dictionary<String, int32> dictionary{};
+	for (int32 i = 0; i < Count; i += 1) {
+		dictionary.Set(keys[i], i);
+	}
+	int32 key = 0;
+	while (state.KeepRunning()) {
+		int32 value = 0;
+		Benchmark::DoNotOptimize(dictionary.TryGet(keys[key], value));
+		Benchmark::DoNotOptimize(value);
+		key = (key + 337) % Count;
+	}
+}
+
+BENCHMARK("Dictionary/Iterate") {
+	Dictionary<int32, int32> dictionary{};
+	for (int32 i = 0; i < Count; i += 1) {
+		dictionary.Set(i * 7, i);
+	}
+	while (state.KeepRunning()) {
+		int64 sum = 0;
+		for (const auto& pair : dictionary) {
+			sum += pair.value;
+		}
+		Benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+}
@@ -0,0 +1,52 @@
+#include "Benchmark.h"
+#include "Engine/System/Collection/List.h"
+
+using namespace Engine;
+
+namespace {
+	constexpr int32 Count = 1000;
+}
+
+BENCHMARK("List/Add") {
+	while (state.KeepRunning()) {
+		List<int32> list{};
+		for (int32 i = 0; i < Count; i += 1) {
+			list.Add(i);
+		}
+		Benchmark::DoNotOptimize(list.GetRawElementPtr());
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+}
+
+BENCHMARK("List/Iterate") {
+	List<int32> list{};
+	for (int32 i = 0; i < Count; i += 1) {
+		list.Add(i);
+	}
+	while (state.KeepRunning()) {
+		int64 sum = 0;
+		for (int32 value : list) {
+			sum += value;
+		}
+		Benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+}
+
+BENCHMARK("List/Sort") {
+	List<int32> source{};
+	uint32 seed = 12345;
+	for (int32 i = 0; i < Count; i += 1) {
+		seed = seed * 1664525u + 1013904223u;
+		source.Add((int32)(seed >> 8));
+	}
+	List<int32> list{};
+	while (state.KeepRunning()) {
+		state.PauseTiming();
+		list = source;
+		state.ResumeTiming();
+		list.Sort();
+		Benchmark::DoNotOptimize(list.GetRawElementPtr());
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+}
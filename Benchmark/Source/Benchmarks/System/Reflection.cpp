@@ -0,0 +1,64 @@
+#include "Benchmark.h"
+#include "Engine/System/Object/Object.h"
+
+using namespace Engine;
+
+namespace {
+	class Counter :public ManualObject {
+		REFLECTION_CLASS(::Counter, ::Engine::ManualObject) {
+			REFLECTION_METHOD(STRL("Add"), Counter::Add, { STRL("value") }, {});
+			REFLECTION_METHOD(STRL("OnChanged"), Counter::OnChanged, { STRL("value") }, {});
+			REFLECTION_SIGNAL(STRL("Changed"), { SIGARG(STRL("value"), Variant::Type::Int64) });
+		}
+
+	public:
+		int64 total = 0;
+		void Add(int64 value) {
+			total += value;
+		}
+		void OnChanged(int64 value) {
+			total += value;
+		}
+	};
+}
+
+BENCHMARK("Reflection/InvokeByName") {
+	Counter counter{};
+	StringName name = STRL("Add");
+	Variant value = 1;
+	const Variant* arguments[] = { &value };
+	Variant result{};
+	while (state.KeepRunning()) {
+		counter.InvokeMethod(name, arguments, 1, result);
+	}
+	Benchmark::DoNotOptimize(counter.total);
+}
+
+BENCHMARK("Reflection/InvokeResolved") {
+	Counter counter{};
+	MethodHandle method = counter.GetReflectionClass()->ResolveMethod(STRL("Add"));
+	Variant value = 1;
+	const Variant* arguments[] = { &value };
+	Variant result{};
+	while (state.KeepRunning()) {
+		method.Invoke(&counter, arguments, 1, result);
+	}
+	Benchmark::DoNotOptimize(counter.total);
+}
+
+BENCHMARK("Reflection/EmitSignal") {
+	constexpr int32 Receivers = 4;
+	Counter sender{};
+	Counter receivers[Receivers]{};
+	StringName signal = STRL("Changed");
+	for (auto& receiver : receivers) {
+		sender.ConnectSignal(signal, Invokable(&receiver, STRL("OnChanged")));
+	}
+	Variant value = 1;
+	const Variant* arguments[] = { &value };
+	while (state.KeepRunning()) {
+		sender.EmitSignal(signal, arguments, 1);
+	}
+	state.SetItemsProcessed(state.GetIterations() * Receivers);
+	Benchmark::DoNotOptimize(receivers[0].total);
+}
@@ -0,0 +1,57 @@
+#include "Benchmark.h"
+#include "Engine/System/MemoryStream.h"
+
+using namespace Engine;
+
+namespace {
+	constexpr int32 Length = 64 * 1024;
+}
+
+BENCHMARK("Stream/WriteBytes") {
+	List<byte> data{};
+	data.SetCount(Length);
+	while (state.KeepRunning()) {
+		MemoryStream stream{};
+		stream.WriteBytes(data.GetRawElementPtr(), Length);
+		Benchmark::DoNotOptimize(stream.GetLength());
+	}
+	state.SetBytesProcessed(state.GetIterations() * Length);
+}
+
+BENCHMARK("Stream/ReadBytes") {
+	List<byte> data{};
+	data.SetCount(Length);
+	List<byte> buffer{};
+	buffer.SetCount(Length);
+	MemoryStream stream(data.GetRawElementPtr(), Length);
+	while (state.KeepRunning()) {
+		stream.SetPosition(0);
+		Benchmark::DoNotOptimize(stream.ReadBytes(buffer.GetRawElementPtr(), Length));
+	}
+	state.SetBytesProcessed(state.GetIterations() * Length);
+}
+
+BENCHMARK("Stream/WriteInt32") {
+	constexpr int32 Count = 1024;
+	while (state.KeepRunning()) {
+		MemoryStream stream{};
+		for (int32 i = 0; i < Count; i += 1) {
+			stream.WriteInt32(i);
+		}
+		Benchmark::DoNotOptimize(stream.GetLength());
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+}
+
+BENCHMARK("Stream/ReadArray") {
+	constexpr int32 Count = Length / sizeof(int32);
+	List<int32> values{};
+	values.SetCount(Count);
+	MemoryStream stream{};
+	stream.WriteArray(values.GetRawElementPtr(), Count);
+	while (state.KeepRunning()) {
+		stream.SetPosition(0);
+		Benchmark::DoNotOptimize(stream.ReadArray(values.GetRawElementPtr(), Count));
+	}
+	state.SetBytesProcessed(state.GetIterations() * Length);
+}
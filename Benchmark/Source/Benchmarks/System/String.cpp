@@ -0,0 +1,36 @@
+#include "Benchmark.h"
+#include "Engine/System/String.h"
+#include "Engine/System/Object/ObjectUtil.h"
+
+using namespace Engine;
+
+BENCHMARK("String/Format") {
+	int32 value = 0;
+	while (state.KeepRunning()) {
+		String text = String::Format(STRL("Frame {0}: {1} ms, {2}"), value, 16.6f, STRL("ok"));
+		Benchmark::DoNotOptimize(text.GetRawArray());
+		value += 1;
+	}
+}
+
+BENCHMARK("String/IndexOf") {
+	String text{};
+	for (int32 i = 0; i < 64; i += 1) {
+		text = text + STRL("the quick brown fox jumps over the lazy dog ");
+	}
+	text = text + STRL("needle");
+	String pattern = STRL("needle");
+	while (state.KeepRunning()) {
+		Benchmark::DoNotOptimize(text.IndexOf(pattern));
+	}
+	state.SetBytesProcessed(state.GetIterations() * text.GetCount());
+}
+
+BENCHMARK("String/GetHashCode") {
+	String text = STRL("Engine/Application/Resource/Textures/Character/Diffuse.png");
+	while (state.KeepRunning()) {
+		// The content itself, a String caches the hash code of its block.
+		Benchmark::DoNotOptimize(ObjectUtil::GetHashCode(text.GetStringView()));
+	}
+	state.SetBytesProcessed(state.GetIterations() * text.GetCount());
+}
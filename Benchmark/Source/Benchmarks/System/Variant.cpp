@@ -0,0 +1,35 @@
+#include "Benchmark.h"
+#include "Engine/System/Object/Variant.h"
+
+using namespace Engine;
+
+BENCHMARK("Variant/EvaluateInt") {
+	Variant a = 3;
+	Variant b = 4;
+	Variant result{};
+	while (state.KeepRunning()) {
+		Variant::Evaluate(Variant::Operator::Add, a, b, result);
+		Benchmark::DoNotOptimize(result);
+	}
+}
+
+BENCHMARK("Variant/EvaluateConverted") {
+	// Int and float, the int is converted first.
+	Variant a = 3;
+	Variant b = 0.5f;
+	Variant result{};
+	while (state.KeepRunning()) {
+		Variant::Evaluate(Variant::Operator::Multiply, a, b, result);
+		Benchmark::DoNotOptimize(result);
+	}
+}
+
+BENCHMARK("Variant/EvaluateString") {
+	Variant a = STRL("left");
+	Variant b = STRL("right");
+	Variant result{};
+	while (state.KeepRunning()) {
+		Variant::Evaluate(Variant::Operator::Equal, a, b, result);
+		Benchmark::DoNotOptimize(result);
+	}
+}
@@ -0,0 +1,57 @@
+#include "Benchmark.h"
+#include "Engine/System/Thread/JobSystem.h"
+
+using namespace Engine;
+
+namespace {
+	JobSystem& GetJobSystem() {
+		// Started once, creating the workers is not what is measured.
+		static JobSystem jobSystem{};
+		static bool started = (jobSystem.Start(), true);
+		(void)started;
+		return jobSystem;
+	}
+	void Increase(Job* job) {
+		(*job->GetDataAs<AtomicValue<int32>*>())->FetchAdd(1);
+	}
+}
+
+BENCHMARK("JobSystem/Throughput") {
+	constexpr int32 Count = 1000;
+	JobSystem& jobSystem = GetJobSystem();
+	AtomicValue<int32> sum{ 0 };
+	AtomicValue<int32>* sumPtr = &sum;
+	while (state.KeepRunning()) {
+		auto counter = SharedPtr<JobCounter>::Create();
+		for (int32 i = 0; i < Count; i += 1) {
+			jobSystem.AddJob(Increase, &sumPtr, sizeof(sumPtr), Job::Preference::Null, counter);
+		}
+		jobSystem.WaitCounter(counter);
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+	Benchmark::DoNotOptimize(sum.Get());
+}
+
+BENCHMARK("JobSystem/Latency") {
+	JobSystem& jobSystem = GetJobSystem();
+	AtomicValue<int32> sum{ 0 };
+	AtomicValue<int32>* sumPtr = &sum;
+	while (state.KeepRunning()) {
+		JobHandle job = jobSystem.AddJob(Increase, &sumPtr, sizeof(sumPtr));
+		jobSystem.WaitJob(job);
+	}
+	Benchmark::DoNotOptimize(sum.Get());
+}
+
+BENCHMARK("JobSystem/ParallelFor") {
+	constexpr int32 Count = 100000;
+	JobSystem& jobSystem = GetJobSystem();
+	List<float> values{};
+	values.SetCount(Count);
+	while (state.KeepRunning()) {
+		jobSystem.ParallelFor(0, Count, 0, [&values](int32 index) {
+			values[index] = values[index] * 0.5f + 1.0f;
+		});
+	}
+	state.SetItemsProcessed(state.GetIterations() * Count);
+}
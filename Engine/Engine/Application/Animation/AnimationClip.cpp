@@ -0,0 +1,146 @@
+#include "Engine/Application/Animation/AnimationClip.h"
+#include "Engine/System/Debug.h"
+
+namespace Engine {
+	int32 AnimationClip::AddTrack(const StringName& name, AnimationTrackType type) {
+		Track track{};
+		track.name = name;
+		track.type = type;
+		track.components = GetComponentCount(type);
+		tracks.Add(Memory::Move(track));
+		return tracks.GetCount() - 1;
+	}
+	int32 AnimationClip::FindTrack(const StringName& name) const {
+		for (int32 i = 0; i < tracks.GetCount(); i += 1) {
+			if (tracks[i].name == name) {
+				return i;
+			}
+		}
+		return -1;
+	}
+	int32 AnimationClip::GetTrackCount() const {
+		return tracks.GetCount();
+	}
+	const StringName& AnimationClip::GetTrackName(int32 track) const {
+		return tracks[track].name;
+	}
+	AnimationTrackType AnimationClip::GetTrackType(int32 track) const {
+		return tracks[track].type;
+	}
+	int32 AnimationClip::GetComponentCount(AnimationTrackType type) {
+		switch (type) {
+		case AnimationTrackType::Vector2:
+			return 2;
+		case AnimationTrackType::Vector3:
+			return 3;
+		case AnimationTrackType::Quaternion:
+			return 4;
+		default:
+			return 1;
+		}
+	}
+
+	bool AnimationClip::AddKey(int32 track, float time, const float* values) {
+		ERR_ASSERT(track >= 0 && track < tracks.GetCount(), u8"track out of bounds.", return false);
+		ERR_ASSERT(values != nullptr, u8"values is nullptr.", return false);
+		Track& target = tracks[track];
+		int32 keyCount = target.times.GetCount();
+		ERR_ASSERT(keyCount == 0 || time >= target.times[keyCount - 1], u8"Keys must be added in order of time.", return false);
+		target.times.Add(time);
+		for (int32 i = 0; i < target.components; i += 1) {
+			target.values.Add(values[i]);
+		}
+		if (!lengthSet && time > length) {
+			length = time;
+		}
+		return true;
+	}
+	bool AnimationClip::AddKey(int32 track, float time, float value) {
+		return AddKey(track, time, &value);
+	}
+	bool AnimationClip::AddKey(int32 track, float time, const Vector2& value) {
+		float values[2] = { value.x, value.y };
+		return AddKey(track, time, values);
+	}
+	bool AnimationClip::AddKey(int32 track, float time, const Vector3& value) {
+		float values[3] = { value.x, value.y, value.z };
+		return AddKey(track, time, values);
+	}
+	bool AnimationClip::AddKey(int32 track, float time, const Quaternion& value) {
+		float values[4] = { value.x, value.y, value.z, value.w };
+		return AddKey(track, time, values);
+	}
+	int32 AnimationClip::GetKeyCount(int32 track) const {
+		return tracks[track].times.GetCount();
+	}
+
+	float AnimationClip::GetLength() const {
+		return length;
+	}
+	void AnimationClip::SetLength(float length) {
+		ERR_ASSERT(length >= 0, u8"length cannot be negative.", return);
+		this->length = length;
+		lengthSet = true;
+	}
+
+	void AnimationClip::Sample(int32 track, float time, int32& cursor, float* result) const {
+		const Track& target = tracks[track];
+		const float* times = target.times.GetRawElementPtr();
+		const float* values = target.values.GetRawElementPtr();
+		int32 keyCount = target.times.GetCount();
+		int32 components = target.components;
+		if (keyCount <= 0) {
+			return;
+		}
+		if (keyCount == 1 || time <= times[0]) {
+			cursor = 0;
+			for (int32 i = 0; i < components; i += 1) {
+				result[i] = values[i];
+			}
+			return;
+		}
+
+		// Playing forward the key is usually the same as last time or the next one.
+		if (cursor < 0 || cursor >= keyCount || times[cursor] > time) {
+			// Rewound or looped, search the key at or before the time.
+			int32 low = 0;
+			int32 high = keyCount - 1;
+			while (low < high) {
+				int32 middle = (low + high + 1) / 2;
+				if (times[middle] <= time) {
+					low = middle;
+				} else {
+					high = middle - 1;
+				}
+			}
+			cursor = low;
+		}
+		while (cursor + 1 < keyCount && times[cursor + 1] <= time) {
+			cursor += 1;
+		}
+		if (cursor + 1 >= keyCount) {
+			const float* last = values + (keyCount - 1) * components;
+			for (int32 i = 0; i < components; i += 1) {
+				result[i] = last[i];
+			}
+			return;
+		}
+
+		float from = times[cursor];
+		float to = times[cursor + 1];
+		float weight = to > from ? (time - from) / (to - from) : 0;
+		const float* a = values + cursor * components;
+		const float* b = a + components;
+		if (target.type == AnimationTrackType::Quaternion) {
+			Quaternion rotation = Quaternion::NLerp(Quaternion(a[0], a[1], a[2], a[3]), Quaternion(b[0], b[1], b[2], b[3]), weight);
+			result[0] = rotation.x;
+			result[1] = rotation.y;
+			result[2] = rotation.z;
+			result[3] = rotation.w;
+			return;
+		}
+		for (int32 i = 0; i < components; i += 1) {
+			result[i] = a[i] + (b[i] - a[i]) * weight;
+		}
+	}
+}
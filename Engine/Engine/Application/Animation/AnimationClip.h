@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/StringName.h"
+#include "Engine/System/Math/Vector.h"
+#include "Engine/System/Math/Quaternion.h"
+
+namespace Engine {
+	/// @brief What the keys of a track hold, quaternions are interpolated along the shortest path.
+	enum class AnimationTrackType :byte {
+		Float,
+		Vector2,
+		Vector3,
+		Quaternion
+	};
+
+	/// @brief Keyframed tracks played by an AnimationSystem. Each track keeps its key times and its values in two separate arrays,
+	/// so finding the keys around a time only walks the times.\n
+	/// Values are interpolated linearly between keys and held before the first and after the last one.\n
+	/// Build a clip once and share it between the players, sampling only reads it.
+	class AnimationClip final {
+	public:
+		AnimationClip() = default;
+
+		/// @brief Add an empty track, the name is for finding it again.
+		/// @return The index of the track.
+		int32 AddTrack(const StringName& name, AnimationTrackType type);
+		/// @brief -1 if no track has the name.
+		int32 FindTrack(const StringName& name) const;
+		int32 GetTrackCount() const;
+		const StringName& GetTrackName(int32 track) const;
+		AnimationTrackType GetTrackType(int32 track) const;
+		/// @brief Floats per value of the type, 4 for quaternions.
+		static int32 GetComponentCount(AnimationTrackType type);
+
+		/// @brief Append a key, later than the last one of the track.
+		/// @param values As many as the track has components.
+		/// @return false if the time is earlier than the last key.
+		bool AddKey(int32 track, float time, const float* values);
+		bool AddKey(int32 track, float time, float value);
+		bool AddKey(int32 track, float time, const Vector2& value);
+		bool AddKey(int32 track, float time, const Vector3& value);
+		bool AddKey(int32 track, float time, const Quaternion& value);
+		int32 GetKeyCount(int32 track) const;
+
+		/// @brief The time of the last key of all the tracks, unless set.
+		float GetLength() const;
+		/// @brief Where looping players wrap around, can be past the last key to hold it a while.
+		void SetLength(float length);
+
+		/// @brief Interpolate the track at the time.
+		/// @param cursor The key at or before the time, kept by the caller between samples. Moving forward from it is constant time, moving back searches the keys.
+		/// @param result Gets as many floats as the track has components, left untouched if the track has no keys.
+		void Sample(int32 track, float time, int32& cursor, float* result) const;
+
+	private:
+		struct Track {
+			StringName name{};
+			AnimationTrackType type = AnimationTrackType::Float;
+			int32 components = 1;
+			List<float> times{};
+			// components floats per key, in the order of the times.
+			List<float> values{};
+		};
+
+		List<Track> tracks{};
+		float length = 0;
+		bool lengthSet = false;
+	};
+}
@@ -0,0 +1,247 @@
+#include "Engine/Application/Animation/AnimationSystem.h"
+#include "Engine/Application/Node/Node2D.h"
+#include "Engine/Application/Node/Node3D.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Profiler.h"
+#include "Engine/System/Debug.h"
+#include <cmath>
+
+namespace Engine {
+	int32 AnimationSystem::AddPlayer(const SharedPtr<AnimationClip>& clip, bool loop) {
+		ERR_ASSERT(clip.GetRaw() != nullptr, u8"clip is nullptr.", return -1);
+		int32 id;
+		if (freePlayers.GetCount() > 0) {
+			id = freePlayers[freePlayers.GetCount() - 1];
+			freePlayers.RemoveAt(freePlayers.GetCount() - 1);
+		} else {
+			id = players.GetCount();
+			players.Add(Player());
+		}
+		Player& player = players[id];
+		player = Player();
+		player.clip = clip;
+		player.loop = loop;
+		player.valid = true;
+		for (int32 i = 0; i < clip->GetTrackCount(); i += 1) {
+			player.bindings.Add(Binding());
+		}
+		return id;
+	}
+	void AnimationSystem::RemovePlayer(int32 player) {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return);
+		// Drop the clip and the bindings now rather than when the id is reused.
+		players[player] = Player();
+		freePlayers.Add(player);
+	}
+	bool AnimationSystem::IsPlayerValid(int32 player) const {
+		return player >= 0 && player < players.GetCount() && players[player].valid;
+	}
+	int32 AnimationSystem::GetPlayerCount() const {
+		return players.GetCount() - freePlayers.GetCount();
+	}
+	SharedPtr<AnimationClip> AnimationSystem::GetClip(int32 player) const {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return SharedPtr<AnimationClip>());
+		return players[player].clip;
+	}
+
+	bool AnimationSystem::Bind(int32 player, int32 track, BindingKind kind, AnimationTrackType type, void* target) {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return false);
+		ERR_ASSERT(target != nullptr, u8"target is nullptr.", return false);
+		Player& owner = players[player];
+		ERR_ASSERT(track >= 0 && track < owner.bindings.GetCount(), u8"track out of bounds.", return false);
+		if (kind != BindingKind::Value) {
+			ERR_ASSERT(owner.clip->GetTrackType(track) == type, u8"The type of the track does not match the channel.", return false);
+		}
+		Binding& binding = owner.bindings[track];
+		binding.kind = kind;
+		binding.components = (byte)AnimationClip::GetComponentCount(owner.clip->GetTrackType(track));
+		binding.target = target;
+		binding.cursor = 0;
+		owner.dirty = true;
+		return true;
+	}
+	bool AnimationSystem::BindValue(int32 player, int32 track, float* target) {
+		return Bind(player, track, BindingKind::Value, AnimationTrackType::Float, target);
+	}
+	bool AnimationSystem::BindNode2D(int32 player, int32 track, Node2D* node, AnimationChannel channel) {
+		switch (channel) {
+		case AnimationChannel::Position:
+			return Bind(player, track, BindingKind::Node2DPosition, AnimationTrackType::Vector2, node);
+		case AnimationChannel::Rotation:
+			return Bind(player, track, BindingKind::Node2DRotation, AnimationTrackType::Float, node);
+		default:
+			return Bind(player, track, BindingKind::Node2DScale, AnimationTrackType::Vector2, node);
+		}
+	}
+	bool AnimationSystem::BindNode3D(int32 player, int32 track, Node3D* node, AnimationChannel channel) {
+		switch (channel) {
+		case AnimationChannel::Position:
+			return Bind(player, track, BindingKind::Node3DPosition, AnimationTrackType::Vector3, node);
+		case AnimationChannel::Rotation:
+			return Bind(player, track, BindingKind::Node3DRotation, AnimationTrackType::Quaternion, node);
+		default:
+			return Bind(player, track, BindingKind::Node3DScale, AnimationTrackType::Vector3, node);
+		}
+	}
+	void AnimationSystem::Unbind(int32 player, int32 track) {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return);
+		Player& owner = players[player];
+		ERR_ASSERT(track >= 0 && track < owner.bindings.GetCount(), u8"track out of bounds.", return);
+		owner.bindings[track] = Binding();
+	}
+	void AnimationSystem::UnbindTarget(const void* target) {
+		for (int32 i = 0; i < players.GetCount(); i += 1) {
+			Player& player = players[i];
+			for (int32 j = 0; j < player.bindings.GetCount(); j += 1) {
+				if (player.bindings[j].target == target) {
+					player.bindings[j] = Binding();
+				}
+			}
+		}
+	}
+
+	float AnimationSystem::GetTime(int32 player) const {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return 0);
+		return players[player].time;
+	}
+	void AnimationSystem::SetTime(int32 player, float time) {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return);
+		players[player].time = time;
+		players[player].dirty = true;
+	}
+	float AnimationSystem::GetSpeed(int32 player) const {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return 0);
+		return players[player].speed;
+	}
+	void AnimationSystem::SetSpeed(int32 player, float speed) {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return);
+		players[player].speed = speed;
+	}
+	bool AnimationSystem::IsLooping(int32 player) const {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return false);
+		return players[player].loop;
+	}
+	void AnimationSystem::SetLooping(int32 player, bool loop) {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return);
+		players[player].loop = loop;
+	}
+	bool AnimationSystem::IsPlaying(int32 player) const {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return false);
+		return players[player].playing;
+	}
+	void AnimationSystem::SetPlaying(int32 player, bool playing) {
+		ERR_ASSERT(IsPlayerValid(player), u8"Invalid player.", return);
+		players[player].playing = playing;
+	}
+
+	void AnimationSystem::Update(float delta, JobSystem* jobSystem) {
+		PROFILE_SCOPE("AnimationSystem::Update");
+		updating.Clear();
+		for (int32 i = 0; i < players.GetCount(); i += 1) {
+			const Player& player = players[i];
+			if (player.valid && (player.playing || player.dirty)) {
+				updating.Add(i);
+			}
+		}
+
+		Player* elements = players.GetRawElementPtr();
+		const int32* indices = updating.GetRawElementPtr();
+		auto update = [elements, indices, delta](int32 index) {
+			Player& player = elements[indices[index]];
+			if (player.playing) {
+				Advance(player, delta);
+			}
+			Apply(player);
+			player.dirty = false;
+		};
+		// Each player only writes to its own targets, so they can run in any order.
+		if (jobSystem != nullptr && updating.GetCount() >= ParallelUpdateThreshold) {
+			jobSystem->ParallelFor(0, updating.GetCount(), 0, update);
+			return;
+		}
+		for (int32 i = 0; i < updating.GetCount(); i += 1) {
+			update(i);
+		}
+	}
+
+	void AnimationSystem::Advance(Player& player, float delta) {
+		float length = player.clip->GetLength();
+		float time = player.time + delta * player.speed;
+		if (player.loop && length > 0) {
+			time = std::fmod(time, length);
+			if (time < 0) {
+				time += length;
+			}
+		} else if (time >= length) {
+			time = length;
+			player.playing = player.speed < 0;
+		} else if (time <= 0) {
+			time = 0;
+			player.playing = player.speed > 0;
+		}
+		player.time = time;
+	}
+	void AnimationSystem::Apply(Player& player) {
+		const AnimationClip& clip = *player.clip.GetRaw();
+		Binding* bindings = player.bindings.GetRawElementPtr();
+		int32 count = player.bindings.GetCount();
+		float values[4];
+		for (int32 i = 0; i < count; i += 1) {
+			Binding& binding = bindings[i];
+			if (binding.kind == BindingKind::None || clip.GetKeyCount(i) <= 0) {
+				continue;
+			}
+			clip.Sample(i, player.time, binding.cursor, values);
+			Write(binding, values);
+		}
+	}
+	void AnimationSystem::Write(Binding& binding, const float* values) {
+		switch (binding.kind) {
+		case BindingKind::Value: {
+			float* target = static_cast<float*>(binding.target);
+			for (int32 i = 0; i < binding.components; i += 1) {
+				target[i] = values[i];
+			}
+			break;
+		}
+		case BindingKind::Node2DPosition: {
+			Node2D* node = static_cast<Node2D*>(binding.target);
+			node->position = Vector2(values[0], values[1]);
+			node->MarkTransformChanged();
+			break;
+		}
+		case BindingKind::Node2DRotation: {
+			Node2D* node = static_cast<Node2D*>(binding.target);
+			node->rotation = values[0];
+			node->MarkTransformChanged();
+			break;
+		}
+		case BindingKind::Node2DScale: {
+			Node2D* node = static_cast<Node2D*>(binding.target);
+			node->scale = Vector2(values[0], values[1]);
+			node->MarkTransformChanged();
+			break;
+		}
+		case BindingKind::Node3DPosition: {
+			Node3D* node = static_cast<Node3D*>(binding.target);
+			node->position = Vector3(values[0], values[1], values[2]);
+			node->MarkTransformChanged();
+			break;
+		}
+		case BindingKind::Node3DRotation: {
+			Node3D* node = static_cast<Node3D*>(binding.target);
+			node->rotation = Quaternion(values[0], values[1], values[2], values[3]);
+			node->MarkTransformChanged();
+			break;
+		}
+		case BindingKind::Node3DScale: {
+			Node3D* node = static_cast<Node3D*>(binding.target);
+			node->scale = Vector3(values[0], values[1], values[2]);
+			node->MarkTransformChanged();
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/Application/Animation/AnimationClip.h"
+
+namespace Engine {
+	class Node2D;
+	class Node3D;
+	class JobSystem;
+
+	/// @brief Which transform value of a node a track drives.\n
+	/// Node2D takes a Vector2 track for the position and scale and a Float one for the rotation, Node3D takes Vector3 tracks and a Quaternion one for the rotation.
+	enum class AnimationChannel :byte {
+		Position,
+		Rotation,
+		Scale
+	};
+
+	/// @brief Plays AnimationClips and writes the sampled values straight into their targets, without going through reflection or the setters.\n
+	/// Every player keeps the key each of its tracks was at, so playing forward costs the same however many keys the tracks have.
+	/// Update() advances and samples all the players in one pass, spread over a JobSystem when there are many of them.\n
+	/// Nodes get their values written into their fields and their transform flagged, the NodeTree recomputes the changed transforms in one batch on its next update.\n
+	/// A target must stay alive as long as it is bound and be bound by only one player, so that players never write to the same memory at once.
+	class AnimationSystem final {
+	public:
+		/// @brief Fewer playing players than this are updated on the calling thread.
+		static inline constexpr int32 ParallelUpdateThreshold = 32;
+
+		AnimationSystem() = default;
+		AnimationSystem(const AnimationSystem&) = delete;
+		AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+		/// @brief Start playing the clip from its beginning.
+		/// @param loop Wrap around at the length of the clip, stop at its end otherwise.
+		/// @return The id of the player, kept until it is removed. -1 if the clip is null.
+		int32 AddPlayer(const SharedPtr<AnimationClip>& clip, bool loop = true);
+		/// @brief Stop writing to the targets of the player and free its id.
+		void RemovePlayer(int32 player);
+		bool IsPlayerValid(int32 player) const;
+		/// @brief Players currently added.
+		int32 GetPlayerCount() const;
+		SharedPtr<AnimationClip> GetClip(int32 player) const;
+
+		/// @brief Write the track to floats, as many as the track has components. For reflected fields or any other plain storage.
+		bool BindValue(int32 player, int32 track, float* target);
+		bool BindNode2D(int32 player, int32 track, Node2D* node, AnimationChannel channel);
+		bool BindNode3D(int32 player, int32 track, Node3D* node, AnimationChannel channel);
+		void Unbind(int32 player, int32 track);
+		/// @brief Unbind every track of every player writing to the target. For nodes about to be destroyed.
+		void UnbindTarget(const void* target);
+
+		float GetTime(int32 player) const;
+		/// @brief Jump to the time, the targets get its values on the next update even when paused.
+		void SetTime(int32 player, float time);
+		float GetSpeed(int32 player) const;
+		/// @brief Negative speeds play backwards, though every sample then searches the keys.
+		void SetSpeed(int32 player, float speed);
+		bool IsLooping(int32 player) const;
+		void SetLooping(int32 player, bool loop);
+		/// @brief Players which are not looping stop by themselves at the end of the clip.
+		bool IsPlaying(int32 player) const;
+		void SetPlaying(int32 player, bool playing);
+
+		/// @brief Advance the playing players and write their values to the targets.
+		/// @param jobSystem nullptr to update on the calling thread only.
+		void Update(float delta, JobSystem* jobSystem = nullptr);
+
+	private:
+		enum class BindingKind :byte {
+			None,
+			Value,
+			Node2DPosition,
+			Node2DRotation,
+			Node2DScale,
+			Node3DPosition,
+			Node3DRotation,
+			Node3DScale
+		};
+		// One per track of the clip.
+		struct Binding {
+			BindingKind kind = BindingKind::None;
+			byte components = 0;
+			int32 cursor = 0;
+			void* target = nullptr;
+		};
+		struct Player {
+			SharedPtr<AnimationClip> clip{};
+			List<Binding> bindings{};
+			float time = 0;
+			float speed = 1;
+			bool loop = true;
+			bool playing = true;
+			// Sample on the next update even when not playing.
+			bool dirty = true;
+			bool valid = false;
+		};
+
+		bool Bind(int32 player, int32 track, BindingKind kind, AnimationTrackType type, void* target);
+		static void Advance(Player& player, float delta);
+		static void Apply(Player& player);
+		static void Write(Binding& binding, const float* values);
+
+		List<Player> players{};
+		List<int32> freePlayers{};
+		// The players to update this frame, rebuilt by every update.
+		List<int32> updating{};
+	};
+}
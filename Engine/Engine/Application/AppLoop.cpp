@@ -2,4 +2,5 @@
 
 namespace Engine {
 	AppLoop::~AppLoop() {}
+	void AppLoop::OnInput(const InputEvent& event) {}
 }
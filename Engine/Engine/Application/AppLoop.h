@@ -1,6 +1,7 @@
 #pragma once
 #include "Engine/System/Object/Object.h"
 #include "Engine/Application/Time.h"
+#include "Engine/Application/InputEvent.h"
 
 namespace Engine {
 	/// @brief Controls how the application runs its logic.
@@ -18,8 +19,9 @@ namespace Engine {
 		virtual void OnUpdate(const Time& time) = 0;
 		/// @brief Called every physics update.
 		virtual void OnPhysicsUpdate(const Time& time) = 0;
-		
-		//virtual void Input(const InputEvent& event)=0;
+
+		/// @brief Called at the start of a frame for every input event which arrived since the last one, in order. Ignores them by default.
+		virtual void OnInput(const InputEvent& event);
 
 		/// @brief Called when the AppLoop is being shutdown.\n
 		/// It is called after IsRunning() returns false.\n
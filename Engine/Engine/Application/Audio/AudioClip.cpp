@@ -0,0 +1,149 @@
+#include "Engine/Application/Audio/AudioClip.h"
+#include "Engine/System/Debug.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIOCLIP_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define AUDIOCLIP_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Engine {
+	namespace {
+		uint16 ReadUInt16(const byte* data) {
+			return (uint16)(data[0] | (data[1] << 8));
+		}
+		uint32 ReadUInt32(const byte* data) {
+			return (uint32)data[0] | ((uint32)data[1] << 8) | ((uint32)data[2] << 16) | ((uint32)data[3] << 24);
+		}
+		bool IsTag(const byte* data, const char* tag) {
+			return std::memcmp(data, tag, 4) == 0;
+		}
+	}
+
+	ResultCode AudioClip::SetSamples(const float* samples, int32 frameCount, int32 channelCount, int32 sampleRate) {
+		ERR_ASSERT(frameCount >= 0 && (frameCount == 0 || samples != nullptr), u8"samples is nullptr.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(channelCount >= 1 && channelCount <= MaxChannelCount, u8"channelCount must be 1 or 2.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(sampleRate > 0, u8"sampleRate must be larger than 0.", return ResultCode::InvalidArgument);
+		this->samples.SetCount(frameCount * channelCount);
+		if (frameCount > 0) {
+			std::memcpy(this->samples.GetRawElementPtr(), samples, sizeof(float) * frameCount * channelCount);
+		}
+		this->frameCount = frameCount;
+		this->channelCount = channelCount;
+		this->sampleRate = sampleRate;
+		return ResultCode::OK;
+	}
+	ResultCode AudioClip::SetSamplesPcm16(const int16* samples, int32 frameCount, int32 channelCount, int32 sampleRate) {
+		ERR_ASSERT(frameCount >= 0 && (frameCount == 0 || samples != nullptr), u8"samples is nullptr.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(channelCount >= 1 && channelCount <= MaxChannelCount, u8"channelCount must be 1 or 2.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(sampleRate > 0, u8"sampleRate must be larger than 0.", return ResultCode::InvalidArgument);
+		this->samples.SetCount(frameCount * channelCount);
+		ConvertPcm16(samples, this->samples.GetRawElementPtr(), frameCount * channelCount);
+		this->frameCount = frameCount;
+		this->channelCount = channelCount;
+		this->sampleRate = sampleRate;
+		return ResultCode::OK;
+	}
+	ResultCode AudioClip::LoadWav(const byte* data, sizeint size) {
+		if (data == nullptr || size < 12 || !IsTag(data, "RIFF") || !IsTag(data + 8, "WAVE")) {
+			return ResultCode::InvalidStream;
+		}
+		uint16 format = 0;
+		uint16 channels = 0;
+		uint32 rate = 0;
+		uint16 bits = 0;
+		const byte* samplesBegin = nullptr;
+		sizeint samplesSize = 0;
+		sizeint offset = 12;
+		while (offset + 8 <= size) {
+			const byte* chunk = data + offset;
+			sizeint chunkSize = ReadUInt32(chunk + 4);
+			sizeint available = size - offset - 8;
+			if (IsTag(chunk, "fmt ")) {
+				if (chunkSize < 16 || chunkSize > available) {
+					return ResultCode::InvalidStream;
+				}
+				format = ReadUInt16(chunk + 8);
+				channels = ReadUInt16(chunk + 10);
+				rate = ReadUInt32(chunk + 12);
+				bits = ReadUInt16(chunk + 22);
+			} else if (IsTag(chunk, "data")) {
+				// Writers streaming to a pipe leave the size unknown, take what is there.
+				samplesBegin = chunk + 8;
+				samplesSize = chunkSize < available ? chunkSize : available;
+			}
+			// Chunks are padded to an even size.
+			offset += 8 + chunkSize + (chunkSize & 1);
+		}
+		if (samplesBegin == nullptr || channels == 0 || rate == 0) {
+			return ResultCode::InvalidStream;
+		}
+		if (channels > MaxChannelCount) {
+			return ResultCode::NotSupported;
+		}
+
+		if (format == 1 && bits == 16) {
+			int32 count = (int32)(samplesSize / (sizeof(int16) * channels));
+			// The data is not aligned for int16 reads, convert through a copy.
+			List<int16> pcm{};
+			pcm.SetCount(count * channels);
+			std::memcpy(pcm.GetRawElementPtr(), samplesBegin, sizeof(int16) * count * channels);
+			return SetSamplesPcm16(pcm.GetRawElementPtr(), count, channels, (int32)rate);
+		}
+		if (format == 3 && bits == 32) {
+			int32 count = (int32)(samplesSize / (sizeof(float) * channels));
+			samples.SetCount(count * channels);
+			std::memcpy(samples.GetRawElementPtr(), samplesBegin, sizeof(float) * count * channels);
+			frameCount = count;
+			channelCount = channels;
+			sampleRate = (int32)rate;
+			return ResultCode::OK;
+		}
+		return ResultCode::NotSupported;
+	}
+
+	const float* AudioClip::GetSamples() const {
+		return samples.GetRawElementPtr();
+	}
+	int32 AudioClip::GetFrameCount() const {
+		return frameCount;
+	}
+	int32 AudioClip::GetChannelCount() const {
+		return channelCount;
+	}
+	int32 AudioClip::GetSampleRate() const {
+		return sampleRate;
+	}
+	float AudioClip::GetDuration() const {
+		return (float)frameCount / sampleRate;
+	}
+
+	void AudioClip::ConvertPcm16(const int16* in, float* out, int32 count) {
+		constexpr float scale = 1.0f / 32768;
+		int32 i = 0;
+#if defined(AUDIOCLIP_SSE)
+		__m128 factor = _mm_set1_ps(scale);
+		for (; i + 8 <= count; i += 8) {
+			__m128i values = _mm_loadu_si128((const __m128i*)(in + i));
+			// Interleaving with themselves and shifting back down sign-extends to 32 bits.
+			__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+			__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+			_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(low), factor));
+			_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), factor));
+		}
+#elif defined(AUDIOCLIP_NEON)
+		float32x4_t factor = vdupq_n_f32(scale);
+		for (; i + 8 <= count; i += 8) {
+			int16x8_t values = vld1q_s16(in + i);
+			vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(values))), factor));
+			vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(values))), factor));
+		}
+#endif
+		for (; i < count; i += 1) {
+			out[i] = in[i] * scale;
+		}
+	}
+}
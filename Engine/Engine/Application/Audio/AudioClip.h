@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+
+namespace Engine {
+	/// @brief Decoded samples played by voices of an AudioMixer, kept whole in memory. Long music goes through an AudioStream instead.\n
+	/// Samples are floats in [-1, 1] with the channels of a frame next to each other. Load the file with AsyncFileReader and hand the bytes to LoadWav(),
+	/// so nothing reads the disk while playing. A clip must not change while a voice plays it.
+	class AudioClip final {
+	public:
+		static inline constexpr int32 MaxChannelCount = 2;
+
+		AudioClip() = default;
+
+		/// @param channelCount 1 for mono, 2 for stereo.
+		ResultCode SetSamples(const float* samples, int32 frameCount, int32 channelCount, int32 sampleRate);
+		/// @brief Converts 16-bit samples to floats.
+		ResultCode SetSamplesPcm16(const int16* samples, int32 frameCount, int32 channelCount, int32 sampleRate);
+		/// @brief Decode a RIFF WAVE file holding 16-bit integer or 32-bit float samples.
+		/// @return InvalidStream if the data is not a WAVE file, NotSupported for other sample formats or more than MaxChannelCount channels.
+		ResultCode LoadWav(const byte* data, sizeint size);
+
+		/// @brief Interleaved samples, GetFrameCount() * GetChannelCount() of them.
+		const float* GetSamples() const;
+		int32 GetFrameCount() const;
+		int32 GetChannelCount() const;
+		int32 GetSampleRate() const;
+		/// @brief In seconds.
+		float GetDuration() const;
+
+		/// @brief Convert 16-bit samples to floats in [-1, 1), 8 at once where SSE or NEON is available.
+		static void ConvertPcm16(const int16* in, float* out, int32 count);
+
+	private:
+		List<float> samples{};
+		int32 frameCount = 0;
+		int32 channelCount = 1;
+		int32 sampleRate = 48000;
+	};
+}
@@ -0,0 +1,507 @@
+#include "Engine/Application/Audio/AudioMixer.h"
+#include "Engine/System/Math/Math.h"
+#include "Engine/System/Profiler.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIOMIXER_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define AUDIOMIXER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Engine {
+	namespace {
+		// A command per voice change, commands past this wait in the pending list of the main thread.
+		constexpr int32 CommandCapacity = 1024;
+		// Commands taken off the ring at once by the mixer thread.
+		constexpr int32 CommandBatch = 64;
+		constexpr int32 SlotBits = 16;
+		constexpr int32 SlotMask = (1 << SlotBits) - 1;
+	}
+
+	AudioMixer::AudioMixer(int32 sampleRate, int32 blockFrameCount, int32 voiceCount)
+		:sampleRate(sampleRate), blockFrameCount(blockFrameCount), voiceCount(voiceCount), commands(CommandCapacity), ended(voiceCount > 0 ? voiceCount : DefaultVoiceCount) {
+		ERR_ASSERT(sampleRate > 0, u8"sampleRate must be larger than 0.", this->sampleRate = DefaultSampleRate);
+		ERR_ASSERT(blockFrameCount > 0 && blockFrameCount <= MaxBlockFrameCount, u8"blockFrameCount must be from 1 to MaxBlockFrameCount.", this->blockFrameCount = DefaultBlockFrameCount);
+		ERR_ASSERT(voiceCount > 0 && voiceCount <= MaxVoiceCount, u8"voiceCount must be from 1 to MaxVoiceCount.", this->voiceCount = DefaultVoiceCount);
+
+		slots.SetCount(this->voiceCount);
+		freeSlots.SetCapacity(this->voiceCount);
+		// Taken from the back, so the lowest slots go first.
+		for (int32 i = this->voiceCount - 1; i >= 0; i -= 1) {
+			freeSlots.Add(i);
+		}
+		// Everything the mixer thread touches is allocated here, it never grows.
+		voices.SetCount(this->voiceCount);
+		active.SetCapacity(this->voiceCount);
+		block.SetCount(this->blockFrameCount * 2);
+		scratch.SetCount(this->blockFrameCount * 2);
+	}
+	AudioMixer::~AudioMixer() {
+		Stop();
+	}
+
+	void AudioMixer::Start() {
+		ERR_ASSERT(!running, u8"The mixer is already running.", return);
+		running = true;
+		stopping.store(false, std::memory_order_relaxed);
+		thread = std::thread(&AudioMixer::MixLoop, this);
+	}
+	void AudioMixer::StartPulled() {
+		ERR_ASSERT(!running, u8"The mixer is already running.", return);
+		running = true;
+	}
+	void AudioMixer::Stop() {
+		if (!running) {
+			return;
+		}
+		if (thread.joinable()) {
+			stopping.store(true, std::memory_order_release);
+			thread.join();
+		}
+		running = false;
+	}
+	bool AudioMixer::IsRunning() const {
+		return running;
+	}
+
+	int32 AudioMixer::GetSampleRate() const {
+		return sampleRate;
+	}
+	int32 AudioMixer::GetBlockFrameCount() const {
+		return blockFrameCount;
+	}
+	int32 AudioMixer::GetVoiceCount() const {
+		return voiceCount;
+	}
+
+	int32 AudioMixer::Play(const SharedPtr<AudioClip>& clip, float gain, float pan, float pitch, bool loop) {
+		ERR_ASSERT(clip.GetRaw() != nullptr, u8"clip is nullptr.", return InvalidVoice);
+		int32 voice = Allocate();
+		if (voice == InvalidVoice) {
+			return InvalidVoice;
+		}
+		slots[voice & SlotMask].clip = clip;
+
+		Command command{};
+		command.type = CommandType::Play;
+		command.voice = voice & SlotMask;
+		command.clip = clip.GetRaw();
+		command.pitch = pitch;
+		command.loop = loop;
+		GetPanGains(gain, pan, command.gainLeft, command.gainRight);
+		Send(command);
+		return voice;
+	}
+	int32 AudioMixer::PlayStream(const SharedPtr<AudioStream>& stream, float gain, float pan, float pitch) {
+		ERR_ASSERT(stream.GetRaw() != nullptr, u8"stream is nullptr.", return InvalidVoice);
+		int32 voice = Allocate();
+		if (voice == InvalidVoice) {
+			return InvalidVoice;
+		}
+		slots[voice & SlotMask].stream = stream;
+
+		Command command{};
+		command.type = CommandType::Play;
+		command.voice = voice & SlotMask;
+		command.stream = stream.GetRaw();
+		command.pitch = pitch;
+		GetPanGains(gain, pan, command.gainLeft, command.gainRight);
+		Send(command);
+		return voice;
+	}
+	void AudioMixer::StopVoice(int32 voice) {
+		int32 slot = GetSlot(voice);
+		if (slot < 0) {
+			return;
+		}
+		Command command{};
+		command.type = CommandType::Stop;
+		command.voice = slot;
+		Send(command);
+	}
+	void AudioMixer::SetVoiceGain(int32 voice, float gain, float pan) {
+		int32 slot = GetSlot(voice);
+		if (slot < 0) {
+			return;
+		}
+		Command command{};
+		command.type = CommandType::SetGain;
+		command.voice = slot;
+		GetPanGains(gain, pan, command.gainLeft, command.gainRight);
+		Send(command);
+	}
+	void AudioMixer::SetVoicePitch(int32 voice, float pitch) {
+		int32 slot = GetSlot(voice);
+		if (slot < 0) {
+			return;
+		}
+		Command command{};
+		command.type = CommandType::SetPitch;
+		command.voice = slot;
+		command.pitch = pitch;
+		Send(command);
+	}
+	bool AudioMixer::IsVoicePlaying(int32 voice) const {
+		return GetSlot(voice) >= 0;
+	}
+	int32 AudioMixer::GetPlayingVoiceCount() const {
+		return playingCount;
+	}
+	void AudioMixer::SetMasterGain(float gain) {
+		masterGain = gain;
+		Command command{};
+		command.type = CommandType::SetMasterGain;
+		command.gainLeft = gain;
+		Send(command);
+	}
+	float AudioMixer::GetMasterGain() const {
+		return masterGain;
+	}
+
+	void AudioMixer::Update() {
+		PROFILE_SCOPE("AudioMixer::Update");
+		if (!running) {
+			// Nothing mixes, so the main thread is the only side of both rings. Every voice ends unheard.
+			Command command{};
+			while (commands.Pop(command)) {
+				if (command.type == CommandType::SetMasterGain) {
+					Apply(command);
+				}
+			}
+			pending.Clear();
+			int32 slot = 0;
+			while (ended.Pop(slot)) {}
+			active.Clear();
+			for (int32 i = 0; i < voiceCount; i += 1) {
+				voices[i] = Voice();
+				if (slots[i].playing) {
+					ended.Push(i);
+				}
+			}
+		}
+		Flush();
+
+		int32 slot = 0;
+		while (ended.Pop(slot)) {
+			VoiceSlot& target = slots[slot];
+			// Freed here rather than on the mixer thread.
+			target.clip = SharedPtr<AudioClip>();
+			target.stream = SharedPtr<AudioStream>();
+			target.playing = false;
+			target.generation = (target.generation + 1) & (MaxVoiceCount / 2 - 1);
+			freeSlots.Add(slot);
+			playingCount -= 1;
+		}
+	}
+
+	uint64 AudioMixer::GetMixedFrameCount() const {
+		return mixedFrameCount.load(std::memory_order_relaxed);
+	}
+
+	void AudioMixer::WriteBlock(const float* samples, int32 frameCount) {
+		using Clock = std::chrono::steady_clock;
+		Clock::time_point now = Clock::now();
+		Clock::duration duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((double)frameCount / sampleRate));
+		if (blockDue + duration < now) {
+			// Fell behind by more than a block, a device would have skipped ahead too.
+			blockDue = now;
+		}
+		blockDue += duration;
+		std::this_thread::sleep_until(blockDue);
+	}
+
+	int32 AudioMixer::Allocate() {
+		if (freeSlots.GetCount() == 0) {
+			return InvalidVoice;
+		}
+		int32 slot = freeSlots[freeSlots.GetCount() - 1];
+		freeSlots.RemoveAt(freeSlots.GetCount() - 1);
+		VoiceSlot& target = slots[slot];
+		target.playing = true;
+		playingCount += 1;
+		return (target.generation << SlotBits) | slot;
+	}
+	int32 AudioMixer::GetSlot(int32 voice) const {
+		if (voice < 0) {
+			return -1;
+		}
+		int32 slot = voice & SlotMask;
+		if (slot >= voiceCount) {
+			return -1;
+		}
+		const VoiceSlot& target = slots[slot];
+		return target.playing && target.generation == (voice >> SlotBits) ? slot : -1;
+	}
+	void AudioMixer::Send(const Command& command) {
+		// Keep the order, nothing passes the commands already waiting.
+		if (pending.GetCount() > 0 || !commands.Push(command)) {
+			pending.Add(command);
+		}
+	}
+	void AudioMixer::Flush() {
+		int32 sent = 0;
+		while (sent < pending.GetCount() && commands.Push(pending[sent])) {
+			sent += 1;
+		}
+		if (sent == pending.GetCount()) {
+			pending.Clear();
+			return;
+		}
+		for (int32 i = sent; i < pending.GetCount(); i += 1) {
+			pending[i - sent] = pending[i];
+		}
+		pending.SetCount(pending.GetCount() - sent);
+	}
+
+	void AudioMixer::MixLoop() {
+		Profiler::SetCurrentThreadName(STRL("Audio"));
+		// May need extra permission, mixing still works at the normal priority.
+		ThreadUtil::SetCurrentThreadPriority(ThreadUtil::Priority::Highest);
+		float* samples = block.GetRawElementPtr();
+		while (!stopping.load(std::memory_order_acquire)) {
+			Mix(samples, blockFrameCount);
+			WriteBlock(samples, blockFrameCount);
+		}
+	}
+	void AudioMixer::Mix(float* out, int32 frameCount) {
+		ERR_ASSERT(frameCount > 0 && frameCount <= blockFrameCount, u8"frameCount must be from 1 to the block frame count.", return);
+		Command batch[CommandBatch];
+		int32 count = 0;
+		while ((count = commands.PopBatch(batch, CommandBatch)) > 0) {
+			for (int32 i = 0; i < count; i += 1) {
+				Apply(batch[i]);
+			}
+		}
+
+		std::memset(out, 0, sizeof(float) * 2 * frameCount);
+		float* rendered = scratch.GetRawElementPtr();
+		for (int32 i = 0; i < active.GetCount();) {
+			int32 slot = active[i];
+			Voice& voice = voices[slot];
+			bool playing = Render(voice, rendered, frameCount);
+			// A stopping voice fades out over this block.
+			float target[2] = { voice.stopping ? 0 : voice.targetGain[0], voice.stopping ? 0 : voice.targetGain[1] };
+			Accumulate(rendered, out, frameCount, voice.gain, target);
+			voice.gain[0] = target[0];
+			voice.gain[1] = target[1];
+			if (playing && !voice.stopping) {
+				i += 1;
+				continue;
+			}
+			voice = Voice();
+			active[i] = active[active.GetCount() - 1];
+			active.RemoveAt(active.GetCount() - 1);
+			// Never full, a slot ends at most once per play and is only reused after the main thread took it.
+			ended.Push(slot);
+		}
+
+		Finalize(out, frameCount, currentMasterGain, targetMasterGain);
+		currentMasterGain = targetMasterGain;
+		mixedFrameCount.fetch_add(frameCount, std::memory_order_relaxed);
+	}
+	void AudioMixer::Apply(const Command& command) {
+		float pitch = Math::Clamp(command.pitch, 1 / MaxPitch, MaxPitch);
+		switch (command.type) {
+		case CommandType::Play: {
+			Voice& voice = voices[command.voice];
+			voice = Voice();
+			voice.clip = command.clip;
+			voice.stream = command.stream;
+			voice.loop = command.loop;
+			voice.pitch = pitch;
+			int32 sourceRate = voice.clip != nullptr ? voice.clip->GetSampleRate() : voice.stream->GetSampleRate();
+			voice.step = (double)pitch * sourceRate / sampleRate;
+			// Starts at full gain, a fade-in would blunt the attack of short sounds.
+			voice.gain[0] = voice.targetGain[0] = command.gainLeft;
+			voice.gain[1] = voice.targetGain[1] = command.gainRight;
+			if (voice.stream != nullptr) {
+				// The first two reads fill previous and next.
+				voice.position = 2;
+			}
+			active.Add(command.voice);
+			break;
+		}
+		case CommandType::Stop:
+			voices[command.voice].stopping = true;
+			break;
+		case CommandType::SetGain:
+			voices[command.voice].targetGain[0] = command.gainLeft;
+			voices[command.voice].targetGain[1] = command.gainRight;
+			break;
+		case CommandType::SetPitch: {
+			Voice& voice = voices[command.voice];
+			if (voice.clip == nullptr && voice.stream == nullptr) {
+				break;
+			}
+			int32 sourceRate = voice.clip != nullptr ? voice.clip->GetSampleRate() : voice.stream->GetSampleRate();
+			voice.pitch = pitch;
+			voice.step = (double)pitch * sourceRate / sampleRate;
+			break;
+		}
+		case CommandType::SetMasterGain:
+			targetMasterGain = command.gainLeft;
+			break;
+		}
+	}
+
+	bool AudioMixer::Render(Voice& voice, float* out, int32 frameCount) {
+		if (voice.stream != nullptr) {
+			return RenderStream(voice, out, frameCount);
+		}
+		const AudioClip* clip = voice.clip;
+		const float* samples = clip->GetSamples();
+		int32 length = clip->GetFrameCount();
+		int32 channels = clip->GetChannelCount();
+		double position = voice.position;
+		double step = voice.step;
+		int32 i = 0;
+		bool playing = length > 0;
+		for (; playing && i < frameCount; i += 1) {
+			if (position >= length) {
+				if (voice.loop) {
+					position = std::fmod(position, (double)length);
+				} else {
+					playing = false;
+					break;
+				}
+			}
+			int32 index = (int32)position;
+			float fraction = (float)(position - index);
+			int32 next = index + 1;
+			if (next >= length) {
+				next = voice.loop ? 0 : index;
+			}
+			if (channels == 1) {
+				float a = samples[index];
+				float value = a + (samples[next] - a) * fraction;
+				out[2 * i] = value;
+				out[2 * i + 1] = value;
+			} else {
+				const float* a = samples + 2 * index;
+				const float* b = samples + 2 * next;
+				out[2 * i] = a[0] + (b[0] - a[0]) * fraction;
+				out[2 * i + 1] = a[1] + (b[1] - a[1]) * fraction;
+			}
+			position += step;
+		}
+		for (; i < frameCount; i += 1) {
+			out[2 * i] = 0;
+			out[2 * i + 1] = 0;
+		}
+		voice.position = position;
+		return playing;
+	}
+	bool AudioMixer::RenderStream(Voice& voice, float* out, int32 frameCount) {
+		AudioStream* stream = voice.stream;
+		int32 channels = stream->GetChannelCount();
+		double position = voice.position;
+		double step = voice.step;
+		int32 i = 0;
+		bool starved = false;
+		for (; i < frameCount; i += 1) {
+			while (position >= 1) {
+				float frame[2];
+				if (stream->Read(frame, 1) == 0) {
+					starved = true;
+					break;
+				}
+				voice.previous[0] = voice.next[0];
+				voice.previous[1] = voice.next[1];
+				voice.next[0] = frame[0];
+				voice.next[1] = channels == 1 ? frame[0] : frame[1];
+				position -= 1;
+			}
+			if (starved) {
+				break;
+			}
+			float fraction = (float)position;
+			out[2 * i] = voice.previous[0] + (voice.next[0] - voice.previous[0]) * fraction;
+			out[2 * i + 1] = voice.previous[1] + (voice.next[1] - voice.previous[1]) * fraction;
+			position += step;
+		}
+		for (; i < frameCount; i += 1) {
+			out[2 * i] = 0;
+			out[2 * i + 1] = 0;
+		}
+		voice.position = position;
+		if (!starved) {
+			return true;
+		}
+		if (stream->IsDrained()) {
+			return false;
+		}
+		stream->underrunCount.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void AudioMixer::Accumulate(const float* in, float* out, int32 frameCount, const float* from, const float* to) {
+		float stepLeft = (to[0] - from[0]) / frameCount;
+		float stepRight = (to[1] - from[1]) / frameCount;
+		int32 i = 0;
+#if defined(AUDIOMIXER_SSE)
+		// Two stereo frames per register, the gains of both frames side by side.
+		__m128 gain = _mm_setr_ps(from[0], from[1], from[0] + stepLeft, from[1] + stepRight);
+		__m128 step = _mm_setr_ps(2 * stepLeft, 2 * stepRight, 2 * stepLeft, 2 * stepRight);
+		for (; i + 2 <= frameCount; i += 2) {
+			__m128 mixed = _mm_add_ps(_mm_loadu_ps(out + 2 * i), _mm_mul_ps(_mm_loadu_ps(in + 2 * i), gain));
+			_mm_storeu_ps(out + 2 * i, mixed);
+			gain = _mm_add_ps(gain, step);
+		}
+#elif defined(AUDIOMIXER_NEON)
+		float initial[4] = { from[0], from[1], from[0] + stepLeft, from[1] + stepRight };
+		float steps[4] = { 2 * stepLeft, 2 * stepRight, 2 * stepLeft, 2 * stepRight };
+		float32x4_t gain = vld1q_f32(initial);
+		float32x4_t step = vld1q_f32(steps);
+		for (; i + 2 <= frameCount; i += 2) {
+			vst1q_f32(out + 2 * i, vmlaq_f32(vld1q_f32(out + 2 * i), vld1q_f32(in + 2 * i), gain));
+			gain = vaddq_f32(gain, step);
+		}
+#endif
+		for (; i < frameCount; i += 1) {
+			out[2 * i] += in[2 * i] * (from[0] + stepLeft * i);
+			out[2 * i + 1] += in[2 * i + 1] * (from[1] + stepRight * i);
+		}
+	}
+	void AudioMixer::Finalize(float* samples, int32 frameCount, float from, float to) {
+		float step = (to - from) / frameCount;
+		int32 i = 0;
+#if defined(AUDIOMIXER_SSE)
+		__m128 gain = _mm_setr_ps(from, from, from + step, from + step);
+		__m128 increment = _mm_set1_ps(2 * step);
+		__m128 low = _mm_set1_ps(-1);
+		__m128 high = _mm_set1_ps(1);
+		for (; i + 2 <= frameCount; i += 2) {
+			__m128 value = _mm_mul_ps(_mm_loadu_ps(samples + 2 * i), gain);
+			_mm_storeu_ps(samples + 2 * i, _mm_min_ps(_mm_max_ps(value, low), high));
+			gain = _mm_add_ps(gain, increment);
+		}
+#elif defined(AUDIOMIXER_NEON)
+		float initial[4] = { from, from, from + step, from + step };
+		float32x4_t gain = vld1q_f32(initial);
+		float32x4_t increment = vdupq_n_f32(2 * step);
+		float32x4_t low = vdupq_n_f32(-1);
+		float32x4_t high = vdupq_n_f32(1);
+		for (; i + 2 <= frameCount; i += 2) {
+			float32x4_t value = vmulq_f32(vld1q_f32(samples + 2 * i), gain);
+			vst1q_f32(samples + 2 * i, vminq_f32(vmaxq_f32(value, low), high));
+			gain = vaddq_f32(gain, increment);
+		}
+#endif
+		for (; i < frameCount; i += 1) {
+			float gain = from + step * i;
+			samples[2 * i] = Math::Clamp(samples[2 * i] * gain, -1, 1);
+			samples[2 * i + 1] = Math::Clamp(samples[2 * i + 1] * gain, -1, 1);
+		}
+	}
+	void AudioMixer::GetPanGains(float gain, float pan, float& left, float& right) {
+		// Constant power, both sides at -3 dB in the middle.
+		float angle = (Math::Clamp(pan, -1, 1) + 1) * (Math::PI / 4);
+		left = gain * std::cos(angle);
+		right = gain * std::sin(angle);
+	}
+}
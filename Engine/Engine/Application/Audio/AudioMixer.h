@@ -0,0 +1,176 @@
+#pragma once
+#include "Engine/System/Object/Object.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/SpscRing.h"
+#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/Application/Audio/AudioClip.h"
+#include "Engine/Application/Audio/AudioStream.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace Engine {
+	/// @brief Mixes the playing voices into stereo blocks on a dedicated high priority mixer thread, which never allocates, locks or waits for the main thread.\n
+	/// The main thread starts, stops and changes voices through a lock-free command ring, and learns in Update() which voices ended through another one.
+	/// Clips and streams are kept alive by the main thread while a voice plays them, so the mixer thread never frees them.\n
+	/// Voices are resampled to the output rate with linear interpolation and their gains ramp over a block when they change, so changes never click.
+	/// Mixing, ramping and clipping run 4 samples per instruction where SSE or NEON is available.\n
+	/// Backends override WriteBlock() to hand the blocks to the device, the base class only paces the mixing to the sample rate.
+	/// Devices asking for the samples from their own callback use StartPulled() and call Mix() from it instead.
+	class AudioMixer :public ManualObject {
+		REFLECTION_CLASS(::Engine::AudioMixer, ::Engine::ManualObject) {
+			REFLECTION_CLASS_INSTANTIABLE(false);
+		}
+
+	public:
+		static inline constexpr int32 DefaultSampleRate = 48000;
+		/// @brief About 5 ms at 48 kHz.
+		static inline constexpr int32 DefaultBlockFrameCount = 256;
+		static inline constexpr int32 MaxBlockFrameCount = 4096;
+		static inline constexpr int32 DefaultVoiceCount = 128;
+		/// @brief Voices are indexed by 16 bits of their ids.
+		static inline constexpr int32 MaxVoiceCount = 1 << 16;
+		/// @brief Pitches are clamped to [1 / MaxPitch, MaxPitch].
+		static inline constexpr float MaxPitch = 4;
+		/// @brief Returned instead of a voice when none is free.
+		static inline constexpr int32 InvalidVoice = -1;
+
+		/// @param blockFrameCount Frames mixed at once, the latency is about twice the duration of a block.
+		/// @param voiceCount Voices playing at once at most, their state is allocated up front.
+		AudioMixer(int32 sampleRate = DefaultSampleRate, int32 blockFrameCount = DefaultBlockFrameCount, int32 voiceCount = DefaultVoiceCount);
+		/// @brief Stops the mixer thread. Subclasses need to call Stop() in their own destructor, their WriteBlock() is gone by the time this one runs.
+		virtual ~AudioMixer();
+
+		/// @brief Start the mixer thread. Until then, voices end right away without being heard.
+		void Start();
+		/// @brief Start without the mixer thread, the backend calls Mix() from the callback of its device in its place.
+		void StartPulled();
+		/// @brief Join the mixer thread. The voices playing end on the next Update().
+		void Stop();
+		bool IsRunning() const;
+
+		int32 GetSampleRate() const;
+		int32 GetBlockFrameCount() const;
+		int32 GetVoiceCount() const;
+
+		/// @brief Main thread only. Play the clip on a free voice.
+		/// @param pan -1 for left, 1 for right, panned at constant power.
+		/// @return The id of the voice, InvalidVoice if none is free.
+		int32 Play(const SharedPtr<AudioClip>& clip, float gain = 1, float pan = 0, float pitch = 1, bool loop = false);
+		/// @brief Main thread only. Play the stream on a free voice until it is drained.
+		/// @return The id of the voice, InvalidVoice if none is free.
+		int32 PlayStream(const SharedPtr<AudioStream>& stream, float gain = 1, float pan = 0, float pitch = 1);
+		/// @brief Main thread only. Fade the voice out over a block and end it. Does nothing if the voice ended already.
+		void StopVoice(int32 voice);
+		/// @brief Main thread only. The voice ramps to the new values over a block.
+		void SetVoiceGain(int32 voice, float gain, float pan = 0);
+		void SetVoicePitch(int32 voice, float pitch);
+		/// @brief Main thread only. True from Play() until Update() learns that the voice ended.
+		bool IsVoicePlaying(int32 voice) const;
+		/// @brief Main thread only.
+		int32 GetPlayingVoiceCount() const;
+		/// @brief Main thread only. Applied to the whole mix before clipping.
+		void SetMasterGain(float gain);
+		float GetMasterGain() const;
+
+		/// @brief Main thread only, once per frame. Send the commands which did not fit into the ring before, and free the voices which ended.
+		void Update();
+
+		/// @brief Frames mixed since the start, read by any thread.
+		uint64 GetMixedFrameCount() const;
+
+	protected:
+		/// @brief Mixer thread only, or the device callback after StartPulled(). Apply the commands sent so far and mix the next frames.
+		/// @param out Gets frameCount interleaved stereo frames, GetBlockFrameCount() at most.
+		void Mix(float* out, int32 frameCount);
+		/// @brief Mixer thread only. Hand a block of interleaved stereo samples to the device, blocking until it can take more.\n
+		/// The base class sleeps until the block would have played, so the voices advance at the right speed without a device.
+		virtual void WriteBlock(const float* samples, int32 frameCount);
+
+	private:
+		enum class CommandType :byte {
+			Play,
+			Stop,
+			SetGain,
+			SetPitch,
+			SetMasterGain
+		};
+		struct Command {
+			CommandType type = CommandType::Play;
+			bool loop = false;
+			int32 voice = 0;
+			const AudioClip* clip = nullptr;
+			AudioStream* stream = nullptr;
+			float gainLeft = 0;
+			float gainRight = 0;
+			float pitch = 1;
+		};
+		// Mixer thread only.
+		struct Voice {
+			const AudioClip* clip = nullptr;
+			AudioStream* stream = nullptr;
+			// In source frames. Streams keep the fraction between the two frames they hold.
+			double position = 0;
+			double step = 1;
+			float pitch = 1;
+			float gain[2] = { 0, 0 };
+			float targetGain[2] = { 0, 0 };
+			// The source frames around the position of a stream voice.
+			float previous[2] = { 0, 0 };
+			float next[2] = { 0, 0 };
+			bool loop = false;
+			bool stopping = false;
+		};
+		// Main thread only.
+		struct VoiceSlot {
+			SharedPtr<AudioClip> clip{};
+			SharedPtr<AudioStream> stream{};
+			// Counts the plays of the slot so that ids of ended voices don't reach newer ones.
+			int32 generation = 0;
+			bool playing = false;
+		};
+
+		int32 Allocate();
+		int32 GetSlot(int32 voice) const;
+		void Send(const Command& command);
+		void Flush();
+		void MixLoop();
+		void Apply(const Command& command);
+		/// @return false once the voice reached the end.
+		bool Render(Voice& voice, float* out, int32 frameCount);
+		bool RenderStream(Voice& voice, float* out, int32 frameCount);
+		static void Accumulate(const float* in, float* out, int32 frameCount, const float* from, const float* to);
+		static void Finalize(float* samples, int32 frameCount, float from, float to);
+		static void GetPanGains(float gain, float pan, float& left, float& right);
+
+		int32 sampleRate;
+		int32 blockFrameCount;
+		int32 voiceCount;
+
+		// Main thread.
+		List<VoiceSlot> slots{};
+		List<int32> freeSlots{};
+		List<Command> pending{};
+		int32 playingCount = 0;
+		float masterGain = 1;
+		bool running = false;
+
+		SpscRing<Command> commands;
+		SpscRing<int32> ended;
+
+		// Mixer thread.
+		List<Voice> voices{};
+		// Slots of the voices playing, unordered.
+		List<int32> active{};
+		List<float> block{};
+		List<float> scratch{};
+		float currentMasterGain = 1;
+		float targetMasterGain = 1;
+		// When the base WriteBlock() lets the next block go.
+		std::chrono::steady_clock::time_point blockDue{};
+
+		std::atomic<bool> stopping{ false };
+		std::atomic<uint64> mixedFrameCount{ 0 };
+		std::thread thread{};
+	};
+}
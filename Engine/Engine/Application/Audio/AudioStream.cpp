@@ -0,0 +1,70 @@
+#include "Engine/Application/Audio/AudioStream.h"
+#include "Engine/Application/Audio/AudioClip.h"
+
+namespace Engine {
+	AudioStream::AudioStream(int32 channelCount, int32 sampleRate, int32 capacity)
+		:channelCount(channelCount), sampleRate(sampleRate), samples(capacity * (channelCount >= 1 && channelCount <= AudioClip::MaxChannelCount ? channelCount : 1)) {
+		ERR_ASSERT(channelCount >= 1 && channelCount <= AudioClip::MaxChannelCount, u8"channelCount must be 1 or 2.", this->channelCount = 1);
+		ERR_ASSERT(sampleRate > 0, u8"sampleRate must be larger than 0.", this->sampleRate = 48000);
+	}
+
+	int32 AudioStream::GetChannelCount() const {
+		return channelCount;
+	}
+	int32 AudioStream::GetSampleRate() const {
+		return sampleRate;
+	}
+
+	int32 AudioStream::GetFreeFrameCount() const {
+		// The producer sees its own end exactly and the consumer's late, so this never counts more than is free.
+		return (samples.GetCapacity() - samples.GetCount()) / channelCount;
+	}
+	int32 AudioStream::Write(const float* values, int32 frameCount) {
+		int32 count = GetFreeFrameCount();
+		count = count < frameCount ? count : frameCount;
+		if (count <= 0) {
+			return 0;
+		}
+		samples.PushBatch(values, count * channelCount);
+		return count;
+	}
+	int32 AudioStream::WritePcm16(const int16* values, int32 frameCount) {
+		constexpr int32 chunkSamples = 512;
+		float converted[chunkSamples];
+		int32 count = GetFreeFrameCount();
+		count = count < frameCount ? count : frameCount;
+		int32 total = count * channelCount;
+		for (int32 i = 0; i < total; i += chunkSamples) {
+			int32 n = total - i < chunkSamples ? total - i : chunkSamples;
+			AudioClip::ConvertPcm16(values + i, converted, n);
+			samples.PushBatch(converted, n);
+		}
+		return count > 0 ? count : 0;
+	}
+	void AudioStream::Finish() {
+		finished.store(true, std::memory_order_release);
+	}
+	bool AudioStream::IsFinished() const {
+		return finished.load(std::memory_order_acquire);
+	}
+
+	int32 AudioStream::GetReadyFrameCount() const {
+		return samples.GetCount() / channelCount;
+	}
+	int32 AudioStream::Read(float* values, int32 frameCount) {
+		int32 count = GetReadyFrameCount();
+		count = count < frameCount ? count : frameCount;
+		if (count <= 0) {
+			return 0;
+		}
+		samples.PopBatch(values, count * channelCount);
+		return count;
+	}
+	bool AudioStream::IsDrained() const {
+		// The flag first, frames written before it are visible by then.
+		return IsFinished() && samples.GetCount() < channelCount;
+	}
+	uint64 AudioStream::GetUnderrunCount() const {
+		return underrunCount.load(std::memory_order_relaxed);
+	}
+}
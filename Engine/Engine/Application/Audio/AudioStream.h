@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/SpscRing.h"
+#include <atomic>
+
+namespace Engine {
+	/// @brief Samples decoded a little ahead of a voice of an AudioMixer, for music and other sounds too long to keep whole in memory.\n
+	/// One producer thread at a time decodes into it, usually a job refilling it every frame from the data an AsyncFileReader read,
+	/// while the mixer thread takes the samples out. Neither side ever waits for the other: a voice running out of samples plays silence until more come.\n
+	/// Samples are floats in [-1, 1] with the channels of a frame next to each other, like in an AudioClip.
+	class AudioStream final {
+	public:
+		/// @brief Half a second at 48 kHz.
+		static inline constexpr int32 DefaultCapacity = 24000;
+
+		/// @param channelCount 1 for mono, 2 for stereo.
+		/// @param capacity Frames decoded ahead at most. The producer needs to refill the stream before this many frames have played.
+		AudioStream(int32 channelCount, int32 sampleRate, int32 capacity = DefaultCapacity);
+		AudioStream(const AudioStream&) = delete;
+		AudioStream& operator=(const AudioStream&) = delete;
+
+		int32 GetChannelCount() const;
+		int32 GetSampleRate() const;
+
+		/// @brief Producer only. Frames which can be written without any being dropped.
+		int32 GetFreeFrameCount() const;
+		/// @brief Producer only. Append whole frames, as many of them as fit.
+		/// @return The count of frames written.
+		int32 Write(const float* samples, int32 frameCount);
+		/// @brief Producer only. Convert 16-bit frames and append as many of them as fit.
+		/// @return The count of frames written.
+		int32 WritePcm16(const int16* samples, int32 frameCount);
+		/// @brief Producer only. No more frames are coming, the voice stops once it played the ones left.
+		void Finish();
+		bool IsFinished() const;
+
+		/// @brief Consumer only. Frames ready to be read.
+		int32 GetReadyFrameCount() const;
+		/// @brief Consumer only. Move up to frameCount frames into samples.
+		/// @return The count of frames read.
+		int32 Read(float* samples, int32 frameCount);
+		/// @brief Consumer only. Finished and every frame read.
+		bool IsDrained() const;
+		/// @brief Times a voice wanted more frames than were ready, read by any thread.
+		uint64 GetUnderrunCount() const;
+
+	private:
+		friend class AudioMixer;
+
+		int32 channelCount;
+		int32 sampleRate;
+		SpscRing<float> samples;
+		std::atomic<bool> finished{ false };
+		std::atomic<uint64> underrunCount{ 0 };
+	};
+}
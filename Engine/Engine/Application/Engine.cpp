@@ -1,10 +1,18 @@
 #include "Engine/Application/Engine.h"
 #include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/FrameAllocator.h"
 #include <chrono>
+#include <cmath>
 #include "Engine/Platform/Window.h"
 #include "Engine/System/File/FileSystem.h"
 #include "Engine/System/Thread/JobSystem.h"
 #include "Engine/Application/AppLoop.h"
+#include "Engine/Application/FramePacer.h"
+#include "Engine/Application/Rendering/Renderer.h"
+#include "Engine/Application/Audio/AudioMixer.h"
+#include "Engine/System/Profiler.h"
+#include "Engine/System/Clock.h"
+#include "Engine/System/Thread/Epoch.h"
 
 namespace Engine {
 	Engine* Engine::instance = nullptr;
@@ -12,14 +20,22 @@ namespace Engine {
 		return instance;
 	}
 
-	Engine::Engine() {
+	Engine::Engine(bool headless) :headless(headless) {
 		instance = this;
 
-		windowSystem.Reset(MEMNEW(PLATFORM_SPECIFIC_CLASS_WINDOWMANAGER));
+		if (headless) {
+			windowSystem.Reset(MEMNEW(HeadlessWindowSystem()));
+		} else {
+			windowSystem.Reset(MEMNEW(PLATFORM_SPECIFIC_CLASS_WINDOWMANAGER));
+		}
 		
 		fileSystem.Reset(MEMNEW(FileSystem()));
 
 		jobSystem.Reset(MEMNEW(JobSystem()));
+
+		renderer.Reset(MEMNEW(Renderer()));
+
+		audioMixer.Reset(MEMNEW(AudioMixer()));
 	}
 	Engine::~Engine() {
 		if (instance == this) {
@@ -38,6 +54,13 @@ namespace Engine {
 	void Engine::SetTargetFps(float targetFps) {
 		this->targetFps = targetFps;
 	}
+	void Engine::SetEfficiencyMode(bool enabled) {
+		efficiencyMode = enabled;
+		jobSystem->SetEfficiencyMode(enabled);
+	}
+	bool Engine::IsEfficiencyMode() const {
+		return efficiencyMode;
+	}
 	float Engine::GetFps() const {
 		return fps;
 	}
@@ -51,6 +74,9 @@ namespace Engine {
 	Time& Engine::GetTime() {
 		return time;
 	}
+	bool Engine::IsHeadless() const {
+		return headless;
+	}
 	WindowSystem* Engine::GetWindowSystem() const {
 		return windowSystem.GetRaw();
 	}
@@ -60,8 +86,32 @@ namespace Engine {
 	JobSystem* Engine::GetJobSystem() const {
 		return jobSystem.GetRaw();
 	}
+	Renderer* Engine::GetRenderer() const {
+		return renderer.GetRaw();
+	}
+	TaskGraph& Engine::GetFrameGraph() {
+		return frameGraph;
+	}
+	void Engine::SetRenderer(UniquePtr<Renderer>&& renderer) {
+		ERR_ASSERT(renderer != nullptr, u8"renderer is nullptr.", return);
+		ERR_ASSERT(this->renderer == nullptr || !this->renderer->IsRunning(), u8"The renderer can't be replaced while running.", return);
+		this->renderer = Memory::Move(renderer);
+	}
+
+	AudioMixer* Engine::GetAudioMixer() const {
+		return audioMixer.GetRaw();
+	}
+	void Engine::SetAudioMixer(UniquePtr<AudioMixer>&& audioMixer) {
+		ERR_ASSERT(audioMixer != nullptr, u8"audioMixer is nullptr.", return);
+		ERR_ASSERT(this->audioMixer == nullptr || !this->audioMixer->IsRunning(), u8"The audio mixer can't be replaced while running.", return);
+		this->audioMixer = Memory::Move(audioMixer);
+	}
 
 	void Engine::Run() {
+		// Workers and the loop don't wait on the console while the engine runs.
+		DebugStartAsync();
+		Profiler::SetCurrentThreadName(STRL("Main"));
+
 #pragma region Info messages
 		INFO_MSG(u8"Rabbik Engine Development");
 		INFO_MSG(u8"Under MIT public license. TML 2020-2021");
@@ -75,65 +125,144 @@ namespace Engine {
 #pragma region Start
 		if (appLoop == nullptr) {
 			FATAL_MSG(u8"No AppLoop has been assigned.");
+			DebugStopAsync();
 			return;
 		}
 
 		jobSystem->Start();
 		INFO_MSG(u8"Job system started.");
+		if (!headless) {
+			// Headless engines execute the recorded frames right away, nothing is ever drawn.
+			renderer->Start();
+			INFO_MSG(u8"Render thread started.");
+			audioMixer->Start();
+			INFO_MSG(u8"Audio thread started.");
+		}
 		appLoop->OnStart();
 		INFO_MSG(u8"App loop started.");
 #pragma endregion
 
 #pragma region Loop
 		// Process other things...
-		using Clock = std::chrono::steady_clock;
-		using TimePoint = Clock::time_point;
-		using Duration = std::chrono::duration<double>;
+		// The frame pacer sleeps to deadlines of the system clock, the frame and its phases are timed with the cheaper Clock.
+		using PacerClock = FramePacer::Clock;
+		using TimePoint = FramePacer::TimePoint;
+		using Duration = FramePacer::Duration;
 
-		TimePoint lastUpdate = Clock::now() - std::chrono::duration_cast<Clock::duration>(Duration(1.0 / GetTargetFps()));;;
-		TimePoint nextUpdate = Clock::now();
+		uint64 lastUpdate = Clock::Now() - Clock::FromSeconds(GetTargetFps() > 0 ? 1.0 / GetTargetFps() : 0);
+		TimePoint nextUpdate = PacerClock::now();
+		// Sleeps out the time left to the next frame instead of spinning on the clock.
+		FramePacer framePacer{};
 
-		TimePoint lastFpsCheck = Clock::now();
+		uint64 lastFpsCheck = Clock::Now();
 		int32 updateTimes = 0;
+		// Unscaled seconds not yet consumed by physics updates.
+		double physicsAccumulator = 0;
+
+		using Phase = FrameStatistics::Phase;
+		FrameStatistics& statistics = time.GetFrameStatistics();
+		auto secondsSince = [](uint64 begin) {
+			return (float)Clock::ToSeconds(Clock::Now() - begin);
+		};
 
 		while (appLoop->IsRunning()) {
-			TimePoint now = Clock::now();
+			TimePoint paced = PacerClock::now();
+
+			if (paced >= nextUpdate) {
+				uint64 now = Clock::Now();
+				time.frameTimestamp = now;
+				Profiler::BeginFrame();
+				{
+					PROFILE_SCOPE("Engine::Frame");
+					uint64 phaseBegin = Clock::Now();
+					windowSystem->Update();
+					InputEventQueue& inputEvents = windowSystem->GetInputEvents();
+					InputEvent inputEvent{};
+					while (inputEvents.Pop(inputEvent)) {
+						appLoop->OnInput(inputEvent);
+					}
+					statistics.Record(Phase::WindowEvents, secondsSince(phaseBegin));
+
+					time.Advance((float)Clock::ToSeconds(now - lastUpdate));
+					statistics.Record(Phase::Frame, time.GetUnscaledDelta());
+
+					// Physics runs at a fixed rate whatever the frame rate, catching up by several steps when frames are slow.
+					physicsAccumulator += time.GetUnscaledDelta();
+					double physicsStep = time.GetUnscaledPhysicsDelta();
+					int32 physicsSteps = 0;
+					phaseBegin = Clock::Now();
+					while (physicsAccumulator >= physicsStep && physicsSteps < time.GetMaxPhysicsSteps()) {
+						PROFILE_SCOPE("Engine::PhysicsUpdate");
+						appLoop->OnPhysicsUpdate(time);
+						physicsAccumulator -= physicsStep;
+						physicsSteps += 1;
+						time.totalPhysicsSteps += 1;
+					}
+					if (physicsAccumulator >= physicsStep) {
+						// Too far behind to catch up, drop the rest instead of spiraling into ever longer frames.
+						physicsAccumulator = std::fmod(physicsAccumulator, physicsStep);
+					}
+					time.physicsInterpolation = (float)(physicsAccumulator / physicsStep);
+					statistics.Record(Phase::Physics, secondsSince(phaseBegin));
 
-			if (now >= nextUpdate) {
-				windowSystem->Update();
+					phaseBegin = Clock::Now();
+					appLoop->OnUpdate(time);
+					statistics.Record(Phase::Update, secondsSince(phaseBegin));
 
-				time.unscaledDelta = std::chrono::duration_cast<Duration>(now - lastUpdate).count();
-				time.unscaledTotal += time.GetUnscaledDelta();
-				time.total += time.GetDelta();
-				time.totalFrames += 1;
-				appLoop->OnUpdate(time);
+					phaseBegin = Clock::Now();
+					frameGraph.Run(jobSystem.GetRaw());
+					statistics.Record(Phase::FrameGraph, secondsSince(phaseBegin));
+
+					// Sends the voice changes of the frame to the mixer thread and frees the voices which ended.
+					audioMixer->Update();
+
+					// The render thread draws this frame while the next one updates.
+					phaseBegin = Clock::Now();
+					renderer->SubmitFrame();
+					statistics.Record(Phase::Render, secondsSince(phaseBegin));
+					// Frame allocations don't survive the frame.
+					FrameAllocator::Reset();
+					// Frees what readers left while nothing retired since.
+					Epoch::Collect();
+				}
+				Profiler::EndFrame();
 
 #pragma region FPS Count
 				updateTimes += 1;
-				Duration fpsCheckDuration = now-lastFpsCheck;
-				if (fpsCheckDuration >= Duration(fpsUpdateFrequency)) {
-					fps = updateTimes / fpsCheckDuration.count();
+				double fpsCheckDuration = Clock::ToSeconds(now - lastFpsCheck);
+				if (fpsCheckDuration >= fpsUpdateFrequency) {
+					fps = updateTimes / fpsCheckDuration;
 					updateTimes = 0;
 					lastFpsCheck = now;
 				}
 #pragma endregion
 
 				lastUpdate = now;
-				do {
-					nextUpdate += std::chrono::duration_cast<Clock::duration>(Duration(1.0 / GetTargetFps()));
-				} while (nextUpdate < lastUpdate);
-
-				now = Clock::now();
-				std::this_thread::sleep_for(nextUpdate - now - Duration(0.005));
+				if (GetTargetFps() > 0) {
+					do {
+						nextUpdate += std::chrono::duration_cast<PacerClock::duration>(Duration(1.0 / GetTargetFps()));
+					} while (nextUpdate < paced);
+					uint64 waitBegin = Clock::Now();
+					framePacer.SetSpinning(!efficiencyMode);
+					framePacer.WaitUntil(nextUpdate);
+					statistics.Record(Phase::Wait, secondsSince(waitBegin));
+				} else {
+					nextUpdate = paced;
+				}
+				statistics.EndFrame();
 			}
 		}
 #pragma endregion
 
 #pragma region Stop
 		appLoop->OnStop();
+		renderer->Stop();
+		audioMixer->Stop();
+		audioMixer->Update();
 		jobSystem->Stop();
 
 		INFO_MSG(u8"AppLoop finished running.");
+		DebugStopAsync();
 #pragma endregion
 	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "Engine/System/Memory/UniquePtr.h"
 #include "Engine/Application/Time.h"
+#include "Engine/System/Thread/TaskGraph.h"
 
 #define ENGINEINST ::Engine::Engine::GetInstance()
 
@@ -9,6 +10,8 @@ namespace Engine {
 	class FileSystem;
 	class JobSystem;
 	class AppLoop;
+	class Renderer;
+	class AudioMixer;
 
 	/// @brief The engine application manager. Contains every information necessary for a application to run.
 	class Engine final{
@@ -16,7 +19,9 @@ namespace Engine {
 		/// @brief Get the currently active Engine instance. 
 		static Engine* GetInstance();
 
-		Engine();
+		/// @param headless Run without a window system, for dedicated servers and benchmarks. The window framework of the platform is never initialized.\n
+		/// Combine with SetTargetFps(-1) to tick as fast as possible.
+		Engine(bool headless = false);
 		~Engine();
 		/// @brief Start the engine, this will block the program until the engine stops.
 		void Run();
@@ -35,13 +40,32 @@ namespace Engine {
 		/// @brief Get the FPS limit.
 		float GetTargetFps() const;
 
+		/// @brief Lower the CPU cost of the engine at some latency, for many headless servers on a host.\n
+		/// Job workers park right away and only as many as the load needs are woken, see JobSystem::SetEfficiencyMode(),
+		/// and waits for the next frame sleep instead of spinning their end.
+		void SetEfficiencyMode(bool enabled);
+		bool IsEfficiencyMode() const;
+
 		float GetFps() const;
 		float GetFpsUpdateFrequency() const;
 		void SetFpsUpdateFrequency(float frequency);
 
+		/// @brief Check if the engine runs without windows, see HeadlessWindowSystem.
+		bool IsHeadless() const;
 		WindowSystem* GetWindowSystem() const;
 		FileSystem* GetFileSystem() const;
 		JobSystem* GetJobSystem() const;
+		/// @brief Record the draw commands of the frame into its recording buffer during AppLoop::OnUpdate().
+		Renderer* GetRenderer() const;
+		/// @brief Replace the renderer with a backend, before Run().
+		void SetRenderer(UniquePtr<Renderer>&& renderer);
+		/// @brief Plays sounds on the mixer thread, started with the engine unless headless.
+		AudioMixer* GetAudioMixer() const;
+		/// @brief Replace the mixer with a backend, before Run().
+		void SetAudioMixer(UniquePtr<AudioMixer>&& audioMixer);
+		/// @brief Phases of subsystems run every frame on the job system, after AppLoop::OnUpdate() and before the frame is submitted.\n
+		/// Add them before Run() or from the AppLoop, phases touching different resources overlap.
+		TaskGraph& GetFrameGraph();
 
 	private:
 		static Engine* instance;
@@ -51,9 +75,14 @@ namespace Engine {
 		UniquePtr<WindowSystem> windowSystem;
 		UniquePtr<FileSystem> fileSystem;
 		UniquePtr<JobSystem> jobSystem;
+		UniquePtr<Renderer> renderer;
+		UniquePtr<AudioMixer> audioMixer;
+		TaskGraph frameGraph{};
 
 		float targetFps = 60;
 		float fps = 0;
 		float fpsUpdateFrequency = 1;
+		bool headless = false;
+		bool efficiencyMode = false;
 	};
 }
@@ -0,0 +1,85 @@
+#include "Engine/Application/FramePacer.h"
+#include "Engine/Platform/Definition.h"
+#include "Engine/System/Math/Math.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+
+#if CURRENT_PLATFORM_WINDOWS
+#	include "Engine/Platform/Windows/BetterWindows.h"
+#	include <timeapi.h>
+#elif CURRENT_PLATFORM_LINUX
+#	include <time.h>
+#	include <errno.h>
+#endif
+
+namespace Engine {
+#if CURRENT_PLATFORM_WINDOWS
+	FramePacer::FramePacer() {
+		// Lowers the granularity of every wait in the process, undone in the destructor.
+		timeBeginPeriod(1);
+		timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (timer == nullptr) {
+			// The high resolution flag needs Windows 10 1803.
+			timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+		}
+	}
+	FramePacer::~FramePacer() {
+		if (timer != nullptr) {
+			CloseHandle((HANDLE)timer);
+		}
+		timeEndPeriod(1);
+	}
+	void FramePacer::Sleep(TimePoint deadline) {
+		// Relative due times are negative, in 100 nanoseconds.
+		LONGLONG ticks = std::chrono::duration_cast<std::chrono::duration<LONGLONG, std::ratio<1, 10000000>>>(deadline - Clock::now()).count();
+		if (ticks <= 0) {
+			return;
+		}
+		if (timer == nullptr) {
+			::Sleep((DWORD)(ticks / 10000));
+			return;
+		}
+		LARGE_INTEGER dueTime{};
+		dueTime.QuadPart = -ticks;
+		if (SetWaitableTimerEx((HANDLE)timer, &dueTime, 0, nullptr, nullptr, nullptr, 0)) {
+			WaitForSingleObject((HANDLE)timer, INFINITE);
+		}
+	}
+#elif CURRENT_PLATFORM_LINUX
+	FramePacer::FramePacer() {}
+	FramePacer::~FramePacer() {}
+	void FramePacer::Sleep(TimePoint deadline) {
+		// steady_clock is CLOCK_MONOTONIC, so the deadline is absolute and signals can't stretch the sleep.
+		auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+		timespec target{};
+		target.tv_sec = (time_t)(sinceEpoch / 1000000000);
+		target.tv_nsec = (long)(sinceEpoch % 1000000000);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {}
+	}
+#endif
+
+	void FramePacer::WaitUntil(TimePoint deadline) {
+		if (!spinning) {
+			Sleep(deadline);
+			return;
+		}
+		TimePoint sleepUntil = deadline - std::chrono::duration_cast<Clock::duration>(Duration(GetSpinMargin()));
+		if (Clock::now() < sleepUntil) {
+			Sleep(sleepUntil);
+			double late = std::chrono::duration_cast<Duration>(Clock::now() - sleepUntil).count();
+			// Jump up on a late wake up, drift down slowly while the timer behaves.
+			oversleep = late > oversleep ? late : oversleep + (late - oversleep) * OversleepDecay;
+		}
+		while (Clock::now() < deadline) {
+			ThreadUtil::SpinPause();
+		}
+	}
+	double FramePacer::GetSpinMargin() const {
+		return Math::Clamp(oversleep + MinSpinMargin, MinSpinMargin, MaxSpinMargin);
+	}
+	void FramePacer::SetSpinning(bool spinning) {
+		this->spinning = spinning;
+	}
+	bool FramePacer::IsSpinning() const {
+		return spinning;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include <chrono>
+
+namespace Engine {
+	/// @brief Waits for frame deadlines precisely without keeping a core busy.\n
+	/// Sleeps on the high resolution timer of the platform until shortly before the deadline, then spins the rest.
+	/// The spinning part follows how late the sleeps actually wake up, so it stays short where the timer is precise.
+	class FramePacer final {
+	public:
+		using Clock = std::chrono::steady_clock;
+		using TimePoint = Clock::time_point;
+		using Duration = std::chrono::duration<double>;
+
+		FramePacer();
+		~FramePacer();
+		FramePacer(const FramePacer&) = delete;
+		FramePacer& operator=(const FramePacer&) = delete;
+
+		/// @brief Block the current thread until the deadline, returns right away if it already passed.
+		void WaitUntil(TimePoint deadline);
+
+		/// @brief Seconds before the deadline at which sleeping stops and spinning starts.
+		double GetSpinMargin() const;
+		/// @brief Without spinning the whole wait is a sleep, waking up late by the timer granularity but leaving the core idle.
+		void SetSpinning(bool spinning);
+		bool IsSpinning() const;
+
+	private:
+		/// @brief Sleep on the platform timer, may wake up late by the timer granularity.
+		void Sleep(TimePoint deadline);
+
+		static inline constexpr double MinSpinMargin = 0.0002;
+		static inline constexpr double MaxSpinMargin = 0.004;
+		// How fast the oversleep estimate forgets a late wake up.
+		static inline constexpr double OversleepDecay = 0.05;
+
+		// Estimated seconds a sleep wakes up past its deadline.
+		double oversleep = MaxSpinMargin;
+		bool spinning = true;
+		// The waitable timer on Windows.
+		void* timer = nullptr;
+	};
+}
@@ -0,0 +1,128 @@
+#include "Engine/Application/FrameStatistics.h"
+#include "Engine/System/Collection/Sorting.h"
+#include "Engine/System/Math/Math.h"
+#include "Engine/System/Debug.h"
+
+namespace Engine {
+	FrameStatistics::FrameStatistics(int32 capacity) :capacity(capacity) {
+		ERR_ASSERT(capacity > 0, u8"capacity must be positive.", this->capacity = DefaultCapacity);
+		samples = List<float>(this->capacity * PhaseCount);
+		for (int32 i = 0; i < this->capacity * PhaseCount; i += 1) {
+			samples.Add(0);
+		}
+	}
+
+	int32 FrameStatistics::GetCapacity() const {
+		return capacity;
+	}
+	int32 FrameStatistics::GetCount() const {
+		return count;
+	}
+	void FrameStatistics::Clear() {
+		oldest = 0;
+		count = 0;
+		totalHitchCount = 0;
+		for (int32 i = 0; i < PhaseCount; i += 1) {
+			current[i] = 0;
+		}
+	}
+
+	void FrameStatistics::Record(Phase phase, float seconds) {
+		current[(int32)phase] += seconds;
+	}
+	void FrameStatistics::EndFrame() {
+		int32 frame = oldest + count;
+		if (frame >= capacity) {
+			frame -= capacity;
+		}
+		if (count < capacity) {
+			count += 1;
+		} else {
+			oldest = oldest + 1 < capacity ? oldest + 1 : 0;
+		}
+
+		float* target = samples.GetRawElementPtr() + frame * PhaseCount;
+		for (int32 i = 0; i < PhaseCount; i += 1) {
+			target[i] = current[i];
+			current[i] = 0;
+		}
+		if (target[(int32)Phase::Frame] > hitchThreshold) {
+			totalHitchCount += 1;
+		}
+	}
+
+	float FrameStatistics::GetMin(Phase phase) const {
+		if (count <= 0) {
+			return 0;
+		}
+		float result = Get(0, phase);
+		for (int32 i = 1; i < count; i += 1) {
+			float value = Get(i, phase);
+			result = value < result ? value : result;
+		}
+		return result;
+	}
+	float FrameStatistics::GetMax(Phase phase) const {
+		if (count <= 0) {
+			return 0;
+		}
+		float result = Get(0, phase);
+		for (int32 i = 1; i < count; i += 1) {
+			float value = Get(i, phase);
+			result = value > result ? value : result;
+		}
+		return result;
+	}
+	float FrameStatistics::GetAverage(Phase phase) const {
+		if (count <= 0) {
+			return 0;
+		}
+		double sum = 0;
+		for (int32 i = 0; i < count; i += 1) {
+			sum += Get(i, phase);
+		}
+		return (float)(sum / count);
+	}
+	float FrameStatistics::GetPercentile(float percent, Phase phase) const {
+		if (count <= 0) {
+			return 0;
+		}
+		sorted.Clear();
+		sorted.RequireCapacity(count);
+		for (int32 i = 0; i < count; i += 1) {
+			sorted.Add(Get(i, phase));
+		}
+		Sorting::Sort(sorted.GetRawElementPtr(), count);
+		// The smallest value with at least percent of the frames at or below it.
+		int32 rank = (int32)Math::Ceil(Math::Clamp(percent, 0.0f, 100.0f) / 100 * count);
+		return sorted[Math::Clamp(rank - 1, 0, count - 1)];
+	}
+
+	void FrameStatistics::SetHitchThreshold(float seconds) {
+		ERR_ASSERT(seconds > 0, u8"seconds must be positive.", return);
+		hitchThreshold = seconds;
+	}
+	float FrameStatistics::GetHitchThreshold() const {
+		return hitchThreshold;
+	}
+	int32 FrameStatistics::GetHitchCount() const {
+		int32 result = 0;
+		for (int32 i = 0; i < count; i += 1) {
+			if (Get(i, Phase::Frame) > hitchThreshold) {
+				result += 1;
+			}
+		}
+		return result;
+	}
+	int32 FrameStatistics::GetTotalHitchCount() const {
+		return totalHitchCount;
+	}
+
+	float FrameStatistics::Get(int32 i, Phase phase) const {
+		int32 frame = oldest + i;
+		if (frame >= capacity) {
+			frame -= capacity;
+		}
+		return samples[frame * PhaseCount + (int32)phase];
+	}
+}
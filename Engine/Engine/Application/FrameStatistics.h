@@ -0,0 +1,76 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+
+namespace Engine {
+	/// @brief Keeps the durations of the last frames, split by phase, for percentiles and hitch counts.\n
+	/// Recording is a few stores per frame, so it can stay on in shipping builds. Queries walk the kept frames and are meant for occasional reporting.
+	class FrameStatistics final {
+	public:
+		enum class Phase :byte {
+			/// @brief Seconds since the previous frame began, what the player actually sees.
+			Frame,
+			/// @brief Processing the events of the window system.
+			WindowEvents,
+			/// @brief Every physics update run during the frame.
+			Physics,
+			Update,
+			/// @brief The phases of the frame graph, see Engine::GetFrameGraph().
+			FrameGraph,
+			/// @brief Handing the recorded commands to the render thread, including the wait while it is a whole frame behind.
+			Render,
+			/// @brief Waiting for the next frame, the headroom left by the frame limit.
+			Wait,
+			Count
+		};
+
+		static inline constexpr int32 DefaultCapacity = 256;
+		/// @brief Frames longer than this count as hitches. Twice the length of a 60 FPS frame.
+		static inline constexpr float DefaultHitchThreshold = 1.0f / 30;
+
+		/// @param capacity How many of the latest frames are kept.
+		FrameStatistics(int32 capacity = DefaultCapacity);
+
+		int32 GetCapacity() const;
+		/// @brief Count of frames kept, up to the capacity.
+		int32 GetCount() const;
+		/// @brief Forget every frame and hitch.
+		void Clear();
+
+		/// @brief Add seconds to a phase of the frame being recorded, phases may be recorded several times per frame.
+		void Record(Phase phase, float seconds);
+		/// @brief Keep the recorded frame, dropping the oldest one when full, and start the next one.
+		void EndFrame();
+
+		float GetMin(Phase phase = Phase::Frame) const;
+		float GetMax(Phase phase = Phase::Frame) const;
+		float GetAverage(Phase phase = Phase::Frame) const;
+		/// @brief Nearest-rank percentile over the kept frames.
+		/// @param percent From 0 to 100, 50 gives the median.
+		float GetPercentile(float percent, Phase phase = Phase::Frame) const;
+
+		void SetHitchThreshold(float seconds);
+		float GetHitchThreshold() const;
+		/// @brief Count of hitches among the kept frames.
+		int32 GetHitchCount() const;
+		/// @brief Count of hitches since the beginning or the last Clear().
+		int32 GetTotalHitchCount() const;
+
+	private:
+		static inline constexpr int32 PhaseCount = (int32)Phase::Count;
+
+		/// @brief Seconds of the phase in the i-th oldest kept frame.
+		float Get(int32 i, Phase phase) const;
+
+		int32 capacity;
+		// PhaseCount values per frame, used as a ring.
+		List<float> samples{};
+		int32 oldest = 0;
+		int32 count = 0;
+		float current[PhaseCount]{};
+		float hitchThreshold = DefaultHitchThreshold;
+		int32 totalHitchCount = 0;
+		// Reused by GetPercentile() so reporting doesn't allocate every time.
+		mutable List<float> sorted{};
+	};
+}
@@ -0,0 +1,44 @@
+#include "Engine/Application/InputEvent.h"
+
+namespace Engine {
+	bool InputEvent::IsCoalescable() const {
+		return type == Type::MouseMove || type == Type::Resize;
+	}
+
+	InputEventQueue::InputEventQueue(int32 capacity) :ring(capacity) {}
+
+	void InputEventQueue::Push(const InputEvent& event) {
+		if (pending.type != InputEvent::Type::None) {
+			if (event.type == pending.type && event.window == pending.window) {
+				pending = event;
+				return;
+			}
+			Flush();
+		}
+		if (event.IsCoalescable()) {
+			pending = event;
+		} else {
+			Publish(event);
+		}
+	}
+	void InputEventQueue::Flush() {
+		if (pending.type == InputEvent::Type::None) {
+			return;
+		}
+		Publish(pending);
+		pending.type = InputEvent::Type::None;
+	}
+
+	bool InputEventQueue::Pop(InputEvent& result) {
+		return ring.Pop(result);
+	}
+	int32 InputEventQueue::GetDroppedCount() const {
+		return droppedCount.Get();
+	}
+
+	void InputEventQueue::Publish(const InputEvent& event) {
+		if (!ring.Push(event)) {
+			droppedCount.Add(1);
+		}
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Math/Vector.h"
+#include "Engine/System/Collection/SpscRing.h"
+#include "Engine/System/Thread/Atomic.h"
+
+namespace Engine {
+	/// @brief An input or window event, as written by the platform layer.
+	struct InputEvent {
+		enum class Type :byte {
+			None,
+			KeyDown,
+			KeyUp,
+			MouseMove,
+			MouseButtonDown,
+			MouseButtonUp,
+			MouseWheel,
+			Resize,
+			Close
+		};
+
+		Type type = Type::None;
+		/// @brief The Window::ID of the window the event happened on.
+		int32 window = -1;
+		/// @brief The key code of the platform for key events, 0 left, 1 right and 2 middle for mouse buttons.
+		int32 code = 0;
+		/// @brief The cursor position inside the window for mouse events, the scrolled steps for MouseWheel, the new size for Resize.
+		Vector2 value{};
+
+		/// @brief Only the latest of a burst of these matters, see InputEventQueue::Push().
+		bool IsCoalescable() const;
+	};
+
+	/// @brief Carries input events from the thread pumping the window messages to the main loop without locks.\n
+	/// Only the pumping thread may call Push() and Flush(), only the main loop may call Pop().
+	class InputEventQueue final {
+	public:
+		static inline constexpr int32 DefaultCapacity = 1024;
+
+		InputEventQueue(int32 capacity = DefaultCapacity);
+		InputEventQueue(const InputEventQueue&) = delete;
+		InputEventQueue& operator=(const InputEventQueue&) = delete;
+
+		/// @brief Producer only. Mouse moves and resizes of a window replace the previous one in a row instead of piling up,
+		/// they're held back until an event of another kind arrives or Flush() is called.
+		void Push(const InputEvent& event);
+		/// @brief Producer only. Publish the held back event, called once the pending messages are pumped.
+		void Flush();
+
+		/// @brief Consumer only. Take the oldest event.
+		/// @return false when there is none.
+		bool Pop(InputEvent& result);
+
+		/// @brief Events lost because the main loop didn't keep up and the queue was full.
+		int32 GetDroppedCount() const;
+
+	private:
+		void Publish(const InputEvent& event);
+
+		SpscRing<InputEvent> ring;
+		// Type::None when nothing is held back.
+		InputEvent pending{};
+		AtomicValue<int32> droppedCount{ 0 };
+	};
+}
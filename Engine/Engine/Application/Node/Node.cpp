@@ -1,4 +1,7 @@
 #include "Engine/Application/Node/Node.h"
+#include "Engine/Application/Node/NodeTree.h"
+#include "Engine/Application/Node/TransformHierarchy.h"
+#include "Engine/Application/Node/NodePool.h"
 #include "Engine/System/Debug.h"
 
 namespace Engine {
@@ -6,6 +9,9 @@ namespace Engine {
 		SetNameUnchecked(GenerateAutoName());
 	}
 	Node::~Node() {
+		if (pool != nullptr) {
+			pool->Forget(this);
+		}
 		while (children.GetCount() > 0) {
 			Node* child = children.Get(children.GetCount() - 1);
 			MEMDEL(child);
@@ -27,12 +33,17 @@ namespace Engine {
 		ERR_ASSERT(index >= 0 && index < children.GetCount(), u8"index out of bounds.", return nullptr);
 		return children.Get(index);
 	}
-	Node* Node::GetChildByName(const String& name) const {
-		if (name.GetCount() <= 0) {
+	Node* Node::GetChildByName(const StringName& name) const {
+		if (name.IsEmpty()) {
 			return nullptr;
 		}
+		if (childrenIndex.GetRaw() != nullptr) {
+			Node* child = nullptr;
+			childrenIndex->TryGet(name, child);
+			return child;
+		}
 		for (Node* child : children) {
-			if (child->GetName() == name) {
+			if (child->name == name) {
 				return child;
 			}
 		}
@@ -52,6 +63,10 @@ namespace Engine {
 	}
 
 	bool Node::AddChild(Node* node,int index) {
+		if (tree != nullptr && tree->IsUpdatingInParallel()) {
+			tree->DeferAddChild(this, node, index);
+			return true;
+		}
 		ERR_ASSERT(
 			CanAddChild(),
 			u8"The node is busy preparing its children. Try not to add or remove nodes of the parent in OnEnteredTree(), OnReady() or OnExitTree(). If you want to auto-create its depended nodes, do it in the constructor.",
@@ -69,7 +84,7 @@ namespace Engine {
 			index = GetChildrenCount();
 		}
 
-		String name = ValidateChildName(node->GetName(), nullptr, node->GetName(), this);
+		String name = ValidateChildName(node->GetName().GetString(), nullptr, node->GetName().GetString(), this);
 		node->SetNameUnchecked(name);
 		children.Insert(index, node);
 		node->parent = this;
@@ -79,12 +94,28 @@ namespace Engine {
 			children.Get(i)->index = i;
 		}
 
+		if (childrenIndex.GetRaw() != nullptr) {
+			IndexChild(node);
+		} else if (children.GetCount() > IndexedChildrenThreshold) {
+			childrenIndex = UniquePtr<FlatDictionary<StringName, Node*>>::Create(children.GetCount() * 2);
+			for (Node* child : children) {
+				IndexChild(child);
+			}
+		}
+
 		node->SystemAssignTree(tree);
+		if (tree != nullptr) {
+			tree->OnSubtreeEntered(node);
+		}
 		return true;
 	}
 	bool Node::RemoveChild(Node* child) {
 		ERR_ASSERT(child != nullptr, u8"child is nullptr.", return false);
 		ERR_ASSERT(child != this, u8"child can't be itself.", return false);
+		if (tree != nullptr && tree->IsUpdatingInParallel()) {
+			tree->DeferRemoveChild(this, child);
+			return true;
+		}
 
 		if (!child->HasParent()) {
 			return false;
@@ -93,11 +124,17 @@ namespace Engine {
 			return false;
 		}
 		
+		if (tree != nullptr) {
+			tree->OnSubtreeExiting(child);
+		}
 		child->SystemAssignTree(nullptr);
-		child->parent = nullptr;
 		
 		int32 index = child->GetIndex();
 		children.RemoveAt(index);
+		if (childrenIndex.GetRaw() != nullptr) {
+			UnindexChild(child);
+		}
+		child->parent = nullptr;
 		// Re-assign index for affected nodes.
 		for (int32 i = index; i < children.GetCount(); i += 1) {
 			children.Get(i)->index = i;
@@ -108,6 +145,45 @@ namespace Engine {
 		return true;
 	}
 	
+	void Node::AddChildDeferred(Node* node, int32 index) {
+		ERR_ASSERT(node != nullptr, u8"node is nullptr.", return);
+		if (tree == nullptr) {
+			AddChild(node, index);
+			return;
+		}
+		tree->QueueAddChild(this, node, index);
+	}
+	void Node::RemoveChildDeferred(Node* child) {
+		ERR_ASSERT(child != nullptr, u8"child is nullptr.", return);
+		if (tree == nullptr) {
+			RemoveChild(child);
+			return;
+		}
+		tree->QueueRemoveChild(this, child);
+	}
+	void Node::QueueFree() {
+		if (freeQueued) {
+			return;
+		}
+		ERR_ASSERT(tree == nullptr || tree->GetRoot() != this, u8"The root of the tree can't be freed.", return);
+		if (tree == nullptr) {
+			Free();
+			return;
+		}
+		freeQueued = true;
+		tree->QueueFree(this);
+	}
+	bool Node::IsQueuedForFree() const {
+		return freeQueued;
+	}
+	void Node::Free() {
+		if (pool != nullptr) {
+			pool->Release(this);
+		} else {
+			MEMDEL(this);
+		}
+	}
+	
 	bool Node::CanAddChild() const {
 		return !childrenAddLocked;
 	}
@@ -115,32 +191,104 @@ namespace Engine {
 	int Node::GetIndex() const {
 		return index;
 	}
-	String Node::GetName() const {
+	StringName Node::GetName() const {
 		return name;
 	}
-	void Node::SetNameUnchecked(const String& name) {
-		this->name = name;
+	void Node::SetNameUnchecked(const StringName& name) {
+		if (tree != nullptr) {
+			tree->OnStructureChanged();
+		}
+		if (parent != nullptr && parent->childrenIndex.GetRaw() != nullptr) {
+			parent->UnindexChild(this);
+			this->name = name;
+			parent->IndexChild(this);
+		} else {
+			this->name = name;
+		}
+	}
+	void Node::IndexChild(Node* child) {
+		// Unchecked names may collide, the index keeps the first of them like the linear scan does.
+		Node** found = childrenIndex->Find(child->name);
+		if (found == nullptr) {
+			childrenIndex->Add(child->name, child);
+		} else if (child->index < (*found)->index) {
+			*found = child;
+		}
+	}
+	void Node::UnindexChild(Node* child) {
+		Node** found = childrenIndex->Find(child->name);
+		if (found == nullptr || *found != child) {
+			return;
+		}
+		childrenIndex->Remove(child->name);
+		for (Node* other : children) {
+			if (other != child && other->name == child->name) {
+				IndexChild(other);
+			}
+		}
 	}
 	void Node::SetName(const String& name) {
-		if (name == GetName()) {
+		if (name == GetName().GetString()) {
 			return;
 		}
 		// Node names that start with @@ is auto names.
 		if (name.StartsWith(STRING_LITERAL("@@"))) {
 			return;
 		}
+		if (tree != nullptr && tree->IsUpdatingInParallel()) {
+			tree->DeferSetName(this, name);
+			return;
+		}
 
-		String validated = ValidateChildName(GetName(), GetParent(), ValidateName(name), GetParent());
+		String validated = ValidateChildName(GetName().GetString(), GetParent(), ValidateName(name), GetParent());
 		SetNameUnchecked(validated);
 	}
 
-	/*
 	Node* Node::GetNode(const NodePath& path) const {
 		Node* node = GetNodeOrNull(path);
-		ERR_ASSERT(node != nullptr, "Cannot find node with the given path.", return nullptr);
+		ERR_ASSERT(node != nullptr, u8"Cannot find node with the given path.", return nullptr);
+		return node;
+	}
+	Node* Node::GetNodeOrNull(const NodePath& path) const {
+		if (tree != nullptr) {
+			return tree->ResolvePath(this, path);
+		}
+		return ResolvePath(path);
+	}
+	Node* Node::ResolvePath(const NodePath& path) const {
+		if (path.IsEmpty()) {
+			return nullptr;
+		}
+		static const StringName current{ u8"." };
+		static const StringName up{ u8".." };
+
+		Node* node = const_cast<Node*>(this);
+		int32 start = 0;
+		if (path.IsAbsolute()) {
+			while (node->parent != nullptr) {
+				node = node->parent;
+			}
+			// The first name is the topmost node itself.
+			if (path.GetNameCount() > 0) {
+				if (path.GetInternedName(0) != node->name) {
+					return nullptr;
+				}
+				start = 1;
+			}
+		}
+		for (int32 i = start; i < path.GetNameCount() && node != nullptr; i += 1) {
+			StringName name = path.GetInternedName(i);
+			if (name == current) {
+				continue;
+			}
+			if (name == up) {
+				node = node->parent;
+			} else {
+				node = node->GetChildByName(name);
+			}
+		}
 		return node;
 	}
-	*/
 
 	NodeTree* Node::GetTree() const {
 		return tree;
@@ -149,7 +297,6 @@ namespace Engine {
 		return tree != nullptr;
 	}
 
-	List<String> Node::invalidChars = { STRING_LITERAL("."),STRING_LITERAL("/"),STRING_LITERAL(":"),STRING_LITERAL("\r"),STRING_LITERAL("\n") };
 	AtomicValue<uint64> Node::autoNameCounter{};
 
 	String Node::ValidateName(const String& name) {
@@ -157,10 +304,7 @@ namespace Engine {
 			return GenerateAutoName();
 		}
 
-		String result = name;
-		for (const String& c : invalidChars) {
-			result.Replace(c, String::GetEmpty());
-		}
+		String result = name.RemoveChars(InvalidNameChars);
 
 		if (result.GetCount() <= 0) {
 			return GenerateAutoName();
@@ -177,7 +321,8 @@ namespace Engine {
 			return targetName;
 		}
 		// Not collided with other nodes in parent.
-		if (targetParent->GetChildByName(targetName) == nullptr) {
+		// A name nobody has interned can't be used by any child, look it up without interning it.
+		if (targetParent->GetChildByName(StringName::Find(targetName.GetStringView())) == nullptr) {
 			return targetName;
 		}
 		
@@ -198,16 +343,23 @@ namespace Engine {
 				}
 			}
 			split += 1;
-			String part = targetName.Substring(0, targetName.GetCount() - split);
-			for (uint32 i = 1; i <= 25565; i += 1) {
+			String part = split > 0 ? targetName.Substring(0, split) : String();
+			// Continue from the last suffix given for the base name, so spawning many alike nodes doesn't retry every taken one.
+			if (targetParent->ordinalSuffixes.GetRaw() == nullptr) {
+				targetParent->ordinalSuffixes = UniquePtr<FlatDictionary<String, uint32>>::Create();
+			}
+			uint32 start = 1;
+			targetParent->ordinalSuffixes->TryGet(part, start);
+			for (uint32 i = start; i < start + 25565; i += 1) {
 				String candidate = String::Format(STRING_LITERAL("{0}{1}"), part, i);
 				// Stop if the candidate name is the same as the original.
 				if (originalParent == targetParent && candidate == originalName) {
 					return originalName;
 				}
 				// Check if any node in targetParent is using the candidate name.
-				Node* node = targetParent->GetChildByName(candidate);
+				Node* node = targetParent->GetChildByName(StringName::Find(candidate.GetStringView()));
 				if (node == nullptr) {
+					targetParent->ordinalSuffixes->Set(part, i + 1);
 					return candidate;
 				}
 			}
@@ -226,8 +378,124 @@ namespace Engine {
 	void Node::OnPhysicsUpdate(float delta) {}
 	void Node::OnExitingTree() {}
 
+	void Node::SetUpdateEnabled(bool enabled) {
+		if (updateEnabled == enabled) {
+			return;
+		}
+		updateEnabled = enabled;
+		if (tree != nullptr) {
+			if (tree->IsUpdatingInParallel()) {
+				tree->DeferUpdateChanged(this, false);
+			} else {
+				tree->OnNodeUpdateChanged(this, false);
+			}
+		}
+	}
+	bool Node::IsUpdateEnabled() const {
+		return updateEnabled;
+	}
+	void Node::SetPhysicsUpdateEnabled(bool enabled) {
+		if (physicsUpdateEnabled == enabled) {
+			return;
+		}
+		physicsUpdateEnabled = enabled;
+		if (tree != nullptr) {
+			if (tree->IsUpdatingInParallel()) {
+				tree->DeferUpdateChanged(this, true);
+			} else {
+				tree->OnNodeUpdateChanged(this, true);
+			}
+		}
+	}
+	bool Node::IsPhysicsUpdateEnabled() const {
+		return physicsUpdateEnabled;
+	}
+	void Node::SetUpdateGroup(const StringName& group) {
+		if (updateGroup == group) {
+			return;
+		}
+		if (tree != nullptr && tree->IsUpdatingInParallel()) {
+			// The orders find the node by its group, it can't change before the tree moves it.
+			tree->DeferSetUpdateGroup(this, group);
+			return;
+		}
+		if (tree != nullptr) {
+			tree->OnNodeUpdateGroupChanging(this);
+		}
+		updateGroup = group;
+		if (tree != nullptr && updateEnabled) {
+			tree->OnNodeUpdateChanged(this, false);
+		}
+	}
+	StringName Node::GetUpdateGroup() const {
+		return updateGroup;
+	}
+	void Node::SetUpdateThreadSafe(bool threadSafe) {
+		updateThreadSafe = threadSafe;
+	}
+	bool Node::IsUpdateThreadSafe() const {
+		return updateThreadSafe;
+	}
+	void Node::SetUpdateIndependent(bool independent) {
+		if (updateIndependent == independent) {
+			return;
+		}
+		updateIndependent = independent;
+		if (tree != nullptr) {
+			RefreshIndependentRoot();
+		}
+	}
+	bool Node::IsUpdateIndependent() const {
+		return updateIndependent;
+	}
+	void Node::RefreshIndependentRoot() {
+		if (parent != nullptr && parent->independentRoot != nullptr) {
+			independentRoot = parent->independentRoot;
+		} else {
+			independentRoot = updateIndependent ? this : nullptr;
+		}
+		for (Node* child : children) {
+			child->RefreshIndependentRoot();
+		}
+	}
+
+	void Node::SetTransformFunction(TransformFunction function, bool planar) {
+		ERR_ASSERT(tree == nullptr, u8"The transform can't be given to a node in a tree.", return);
+		transformFunction = function;
+		transformPlanar = planar;
+	}
+	void Node::MarkTransformChanged() {
+		if (transformSlot >= 0) {
+			tree->GetTransforms().MarkChanged(transformSlot);
+		}
+	}
+	TransformMatrix Node::GetNodeLocalTransform() const {
+		if (transformSlot >= 0) {
+			return tree->GetTransforms().GetLocal(transformSlot);
+		}
+		return transformFunction != nullptr ? transformFunction(this) : TransformMatrix();
+	}
+	TransformMatrix Node::GetNodeGlobalTransform() const {
+		if (transformSlot >= 0) {
+			return tree->GetTransforms().GetGlobal(transformSlot);
+		}
+		return TransformHierarchy::ComputeGlobal(this);
+	}
+
 	String Node::GetTreeStructureFormated(int32 level) const {
-		String r;
+		StringBuilder builder;
+		AppendTreeStructureFormated(builder, level);
+		return builder.ToString();
+	}
+	void Node::AppendTreeStructureFormated(StringBuilder& builder, int32 level) const {
+		AppendTreePrefix(builder, level);
+		builder.AppendFormat(STRING_LITERAL("{0}: {1} ({2})\n"), GetIndex(), GetName(), GetReflectionClassName());
+		
+		for (Node* child : children) {
+			child->AppendTreeStructureFormated(builder, level + 1);
+		}
+	}
+	void Node::AppendTreePrefix(StringBuilder& builder, int32 level) const {
 		bool isLast = false;
 		if (HasParent()) {
 			Node* p = GetParent();
@@ -235,26 +503,134 @@ namespace Engine {
 				isLast = p->GetIndex() == p->GetParent()->GetChildrenCount() - 1;
 			}
 		}
-		for (int32 i = 0; i < level; i++) {
-			r = String::Format(STRING_LITERAL("{0}\t{1}"), i < level - 1 && !isLast ? STRING_LITERAL("│  ") : String::GetEmpty(), r);
+		for (int32 i = level - 1; i >= 0; i -= 1) {
+			if (i < level - 1 && !isLast) {
+				builder.Append(STRING_LITERAL("│  "));
+			}
+			builder.Append(u8'\t');
 		}
 		
-		String symbol;
 		if (level > 0) {
 			if (!HasParent()) {
-				symbol = STRING_LITERAL("┌  ");
+				builder.Append(STRING_LITERAL("┌  "));
 			} else if (GetIndex() == GetParent()->GetChildrenCount() - 1) {
-				symbol = STRING_LITERAL("└  ");
+				builder.Append(STRING_LITERAL("└  "));
 			} else {
-				symbol = STRING_LITERAL("├  ");
+				builder.Append(STRING_LITERAL("├  "));
 			}
 		}
-		r = r + String::Format(STRING_LITERAL("{0}{1}: {2} ({3})\n"), symbol,GetIndex(), GetName(), GetReflectionClassName());
-		
+	}
+
+	sizeint Node::GetMemoryUsage() const {
+		// The storage of a FlatDictionary, a control byte per slot plus a group of them, and the entries.
+		auto tableSize = [](int32 capacity, sizeint entrySize) -> sizeint {
+			return capacity > 0 ? (sizeint)capacity * (entrySize + 1) + 16 : 0;
+		};
+		sizeint size = Memory::GetAllocationSize(const_cast<void*>(dynamic_cast<const void*>(this)));
+		if (!children.IsInline()) {
+			size += (sizeint)children.GetCapacity() * sizeof(Node*);
+		}
+		if (childrenIndex != nullptr) {
+			size += sizeof(FlatDictionary<StringName, Node*>) + tableSize(childrenIndex->GetCapacity(), sizeof(FlatDictionary<StringName, Node*>::Entry));
+		}
+		if (ordinalSuffixes != nullptr) {
+			size += sizeof(FlatDictionary<String, uint32>) + tableSize(ordinalSuffixes->GetCapacity(), sizeof(FlatDictionary<String, uint32>::Entry));
+		}
+		size += (sizeint)name.GetString().GetCount();
+		return size + GetExtraMemoryUsage();
+	}
+	sizeint Node::GetExtraMemoryUsage() const {
+		return 0;
+	}
+	uint64 Node::GetLastFrameUpdateNanoseconds() const {
+		// The frame of the tree moves on once every node has updated, the costs of the frame before are the last complete ones.
+		if (tree == nullptr || updateCostFrame + 1 != tree->costFrame) {
+			return 0;
+		}
+		return updateCost;
+	}
+	NodeCost Node::GetSubtreeCost() const {
+		List<NodeCost> costs{};
+		return CollectCosts(costs);
+	}
+	void Node::GetSubtreeClassCosts(List<NodeClassCost>& result) const {
+		result.Clear();
+		FlatDictionary<String, int32> classIndices{};
+		List<const Node*> stack{};
+		stack.Add(this);
+		while (stack.GetCount() > 0) {
+			const Node* node = stack[stack.GetCount() - 1];
+			stack.RemoveAt(stack.GetCount() - 1);
+			String className = node->GetReflectionClassName();
+			int32 classIndex = -1;
+			if (!classIndices.TryGet(className, classIndex)) {
+				classIndex = result.GetCount();
+				classIndices.Add(className, classIndex);
+				NodeClassCost classCost{};
+				classCost.className = className;
+				result.Add(classCost);
+			}
+			NodeCost& cost = result[classIndex].cost;
+			cost.nodeCount += 1;
+			cost.memoryBytes += node->GetMemoryUsage();
+			cost.updateNanoseconds += node->GetLastFrameUpdateNanoseconds();
+			for (Node* child : node->children) {
+				stack.Add(child);
+			}
+		}
+		// A handful of classes, insertion sort keeps it simple.
+		for (int32 i = 1; i < result.GetCount(); i += 1) {
+			for (int32 j = i; j > 0; j -= 1) {
+				const NodeCost& a = result[j - 1].cost;
+				const NodeCost& b = result[j].cost;
+				if (a.updateNanoseconds > b.updateNanoseconds || (a.updateNanoseconds == b.updateNanoseconds && a.memoryBytes >= b.memoryBytes)) {
+					break;
+				}
+				NodeClassCost swap = Memory::Move(result[j - 1]);
+				result[j - 1] = Memory::Move(result[j]);
+				result[j] = Memory::Move(swap);
+			}
+		}
+	}
+	String Node::GetTreeCostFormated(int32 level) const {
+		List<NodeCost> costs{};
+		CollectCosts(costs);
+		StringBuilder builder;
+		int32 index = 0;
+		AppendTreeCostFormated(builder, level, costs, index);
+
+		List<NodeClassCost> classCosts{};
+		GetSubtreeClassCosts(classCosts);
+		for (const NodeClassCost& classCost : classCosts) {
+			builder.AppendFormat(STRING_LITERAL("{0}: {1} nodes, {2} bytes, {3:.3f} ms\n"), classCost.className, classCost.cost.nodeCount, classCost.cost.memoryBytes, classCost.cost.updateNanoseconds / 1000000.0);
+		}
+		return builder.ToString();
+	}
+	NodeCost Node::CollectCosts(List<NodeCost>& costs) const {
+		int32 at = costs.GetCount();
+		costs.Add(NodeCost{});
+		NodeCost cost{};
+		cost.nodeCount = 1;
+		cost.memoryBytes = GetMemoryUsage();
+		cost.updateNanoseconds = GetLastFrameUpdateNanoseconds();
 		for (Node* child : children) {
-			r = r + child->GetTreeStructureFormated(level + 1);
+			NodeCost childCost = child->CollectCosts(costs);
+			cost.nodeCount += childCost.nodeCount;
+			cost.memoryBytes += childCost.memoryBytes;
+			cost.updateNanoseconds += childCost.updateNanoseconds;
+		}
+		costs[at] = cost;
+		return cost;
+	}
+	void Node::AppendTreeCostFormated(StringBuilder& builder, int32 level, const List<NodeCost>& costs, int32& index) const {
+		const NodeCost& cost = costs[index];
+		index += 1;
+		AppendTreePrefix(builder, level);
+		builder.AppendFormat(STRING_LITERAL("{0}: {1} ({2}) {3} nodes, {4} bytes, {5:.3f} ms\n"), GetIndex(), GetName(), GetReflectionClassName(), cost.nodeCount, cost.memoryBytes, cost.updateNanoseconds / 1000000.0);
+
+		for (Node* child : children) {
+			child->AppendTreeCostFormated(builder, level + 1, costs, index);
 		}
-		return r;
 	}
 
 	void Node::SystemAssignTree(NodeTree* tree) {
@@ -268,6 +644,15 @@ namespace Engine {
 		if (this->tree == nullptr && tree != nullptr) {
 			// Current has no tree, assigning into a tree.
 			this->tree = tree;
+			if (parent != nullptr && parent->independentRoot != nullptr) {
+				independentRoot = parent->independentRoot;
+			} else {
+				independentRoot = updateIndependent ? this : nullptr;
+			}
+			// Parents enter first, so the closest one with a transform already has its slot.
+			if (transformFunction != nullptr) {
+				tree->GetTransforms().Add(this);
+			}
 			
 			// Mutex the current node to prevent the child from adding or removing nodes into the current node.
 			childrenAddLocked = true;
@@ -291,19 +676,18 @@ namespace Engine {
 
 			OnExitingTree();
 			childrenAddLocked = false;
+			if (transformSlot >= 0) {
+				this->tree->GetTransforms().Remove(transformSlot);
+			}
+			if (spatialEntry >= 0) {
+				if (transformPlanar) {
+					this->tree->GetSpatialIndex2D().Remove(this);
+				} else {
+					this->tree->GetSpatialIndex3D().Remove(this);
+				}
+			}
 			this->tree = nullptr;
-		}
-	}
-	void Node::SystemUpdate(float delta) {
-		OnUpdate(delta);
-		for (int i = 0; i < children.GetCount(); i += 1) {
-			children.Get(i)->SystemUpdate(delta);
-		}
-	}
-	void Node::SystemPhysicsUpdate(float delta) {
-		OnPhysicsUpdate(delta);
-		for (int i = 0; i < children.GetCount(); i += 1) {
-			children.Get(i)->SystemPhysicsUpdate(delta);
+			independentRoot = nullptr;
 		}
 	}
 }
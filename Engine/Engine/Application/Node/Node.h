@@ -2,15 +2,46 @@
 
 #include "Engine/System/Definition.h"
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/StringName.h"
+#include "Engine/System/StringBuilder.h"
 #include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/SmallList.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/Math/TransformMatrix.h"
 #include "Engine/Application/Node/NodePath.h"
 
 namespace Engine {
 	// Avoid circular dependency.
 	class NodeTree;
+	class TransformHierarchy;
+	class NodePool;
+
+	/// @brief Totals over the nodes of a subtree, see Node::GetSubtreeCost().
+	struct NodeCost {
+		int32 nodeCount = 0;
+		/// @brief See Node::GetMemoryUsage().
+		sizeint memoryBytes = 0;
+		/// @brief See Node::GetLastFrameUpdateNanoseconds().
+		uint64 updateNanoseconds = 0;
+	};
+	/// @brief The totals of the nodes of one class in a subtree.
+	struct NodeClassCost {
+		String className{};
+		NodeCost cost{};
+	};
 
 	class Node :public ManualObject {
-		REFLECTION_CLASS(::Engine::Node, ::Engine::ManualObject) {}
+		REFLECTION_CLASS(::Engine::Node, ::Engine::ManualObject) {
+			REFLECTION_CLASS_CONSTRUCTIBLE(Node);
+
+			REFLECTION_METHOD(STRL("IsUpdateEnabled"), Node::IsUpdateEnabled, {}, {});
+			REFLECTION_METHOD(STRL("SetUpdateEnabled"), Node::SetUpdateEnabled, { STRL("enabled") }, {});
+			REFLECTION_PROPERTY(STRL("UpdateEnabled"), STRL("IsUpdateEnabled"), STRL("SetUpdateEnabled"));
+			REFLECTION_METHOD(STRL("IsPhysicsUpdateEnabled"), Node::IsPhysicsUpdateEnabled, {}, {});
+			REFLECTION_METHOD(STRL("SetPhysicsUpdateEnabled"), Node::SetPhysicsUpdateEnabled, { STRL("enabled") }, {});
+			REFLECTION_PROPERTY(STRL("PhysicsUpdateEnabled"), STRL("IsPhysicsUpdateEnabled"), STRL("SetPhysicsUpdateEnabled"));
+		}
 
 	public:
 		Node();
@@ -27,23 +58,41 @@ namespace Engine {
 		int32 GetChildrenCount() const;
 		/// @brief Get the child by the given index.
 		Node* GetChildByIndex(int32 index) const;
-		/// @brief Get the child by the given name.
-		Node* GetChildByName(const String& name) const;
+		/// @brief Get the child by the given name.\n
+		/// Node names are interned, so the children are matched by pointer compares.\n
+		/// Nodes with more than IndexedChildrenThreshold children look it up in a hash index instead.
+		Node* GetChildByName(const StringName& name) const;
+		static inline constexpr int32 IndexedChildrenThreshold = 8;
 
 		//bool MoveChild(int32 from, int32 to);
 
 		/// @brief Check if the given node is a child of the current node.
 		bool IsChild(Node* node) const;
 
-		/// @brief Add a node as a child of current node.
+		/// @brief Add a node as a child of current node.\n
+		/// While the tree updates in parallel, changes to nodes in the tree are deferred until the running nodes finish, and reported as done.
 		/// @param node The node to add.
 		/// @param index The position to insert at. -1 for the last position.
 		bool AddChild(Node* node, int index = -1);
 
-		/// @brief Remove a child from the current node.
+		/// @brief Remove a child from the current node. Deferred like AddChild() while the tree updates in parallel.
 		/// @param The node to remove.
 		bool RemoveChild(Node* child);
 
+		/// @brief Queue adding a node as a child, applied by the tree with the other queued changes once the frame has updated.
+
+		/// Safe to call from OnEnteredTree(), OnReady() and OnUpdate(). Applied right away when the current node isn't in a tree.
+		/// @param index The position to insert at when applied. -1 for the last position.
+		void AddChildDeferred(Node* node, int32 index = -1);
+		/// @brief Queue removing a child, see AddChildDeferred().
+		void RemoveChildDeferred(Node* child);
+		/// @brief Queue destroying the node and all its children, applied after the queued additions and removals of the frame.
+
+		/// Don't destroy the node in other ways once queued. Destroyed right away when it isn't in a tree.
+		void QueueFree();
+		/// @brief Check if QueueFree() has been called on the node.
+		bool IsQueuedForFree() const;
+
 		/// @brief Check if other nodes can add or remove child for the current node.\n
 		/// When preparing node tree, the parent node is locked to prevent the data from out of sync.  
 		bool CanAddChild() const;
@@ -54,26 +103,29 @@ namespace Engine {
 		int GetIndex() const;
  
 		/// @brief Get the name of the node.
-		String GetName() const;
+		StringName GetName() const;
 		
 		/// @brief Set the name of the node directly, without the name check.\n
 		/// This might cause some problems in certain situation. 
-		void SetNameUnchecked(const String& name);
+		void SetNameUnchecked(const StringName& name);
 
 		/// @brief Set the name of the node directly, with the name check.\n
 		/// The invalid characters in the name will be removed.\n
-		/// A suffix number will be added if a node in the parent has the same name.
+		/// A suffix number will be added if a node in the parent has the same name.\n
+		/// Deferred like AddChild() while the tree updates in parallel.
 		void SetName(const String& name);
 
 		/// @brief Find the node with the given path. Produces error messages when not found.
 		/// @return The found node.\n
 		/// nullptr when not found.
-		//Node* GetNode(const NodePath& path) const;
+		Node* GetNode(const NodePath& path) const;
 
-		/// @brief Find the node with the given path. Will not produce error messages when not found.
+		/// @brief Find the node with the given path. Will not produce error messages when not found.\n
+		/// Inside a NodeTree the results are cached until the structure of the tree changes, see NodeTree::GetStructureVersion().\n
+		/// Subnames of the path are ignored.
 		/// @return The found node.\n
 		/// nullptr when not found.
-		//Node* GetNodeOrNull(const NodePath& path) const;
+		Node* GetNodeOrNull(const NodePath& path) const;
 		
 		/// @brief Get the NodeTree the current node is in.
 		/// @return The NodeTree the current node is in.\n
@@ -119,19 +171,78 @@ namespace Engine {
 		virtual void OnEnteredTree();
 		/// @brief Called when all children of the current node is ready.
 		virtual void OnReady();
-		/// @brief Called when logic update occurs.
+		/// @brief Called when logic update occurs, only if SetUpdateEnabled(true).
 		/// @param delta Elapsed seconds since last Update.
 		virtual void OnUpdate(float delta);
-		/// @brief Called when physics update occurs.
+		/// @brief Called when physics update occurs, only if SetPhysicsUpdateEnabled(true).
 		/// @param delta Elapsed seconds since last PhysicsUpdate.
 		virtual void OnPhysicsUpdate(float delta);
+
+		/// @brief Have OnUpdate() called every frame.\n
+		/// Disabled by default, the NodeTree only visits the nodes that enabled it.
+		void SetUpdateEnabled(bool enabled);
+		bool IsUpdateEnabled() const;
+		/// @brief Have OnPhysicsUpdate() called every physics update. Disabled by default.
+		void SetPhysicsUpdateEnabled(bool enabled);
+		bool IsPhysicsUpdateEnabled() const;
+		/// @brief Update the node with a group of the NodeTree, updated at the rate and priority set for it.\n
+		/// See NodeTree::SetUpdateGroupInterval(). Empty for the default group, updated every frame.
+		void SetUpdateGroup(const StringName& group);
+		StringName GetUpdateGroup() const;
+		/// @brief Let OnUpdate() run on a worker thread, alongside other thread-safe nodes, when the tree updates in parallel.\n
+		/// See NodeTree::SetParallelUpdate(). Disabled by default.
+		void SetUpdateThreadSafe(bool threadSafe);
+		bool IsUpdateThreadSafe() const;
+		/// @brief Mark the subtree as touching nothing outside itself in OnUpdate().\n
+		/// When the tree updates in parallel, the nodes of the subtree update in order on a single worker, alongside other independent subtrees and thread-safe nodes.
+		void SetUpdateIndependent(bool independent);
+		bool IsUpdateIndependent() const;
 		/// @brief Called right before the current node exits the NodeTree.
 		virtual void OnExitingTree();
 
 		String GetTreeStructureFormated(int32 level = 0) const;
+
+		/// @brief Bytes allocated for the node: the object, its children list and index, its name and GetExtraMemoryUsage().\n
+		/// Names are interned, a node counts its own in full even when others share it. Nodes need to be allocated by MEMNEW or a NodePool.
+		sizeint GetMemoryUsage() const;
+		/// @brief Time spent in OnUpdate() and OnPhysicsUpdate() of the node during the last frame of its tree.\n
+		/// Only measured with NodeTree::SetCostTracking(), 0 otherwise and outside a tree.
+		uint64 GetLastFrameUpdateNanoseconds() const;
+		/// @brief The totals over the current node and its descendants.
+		NodeCost GetSubtreeCost() const;
+		/// @brief The totals over the current node and its descendants per node class, the costliest to update first.
+		void GetSubtreeClassCosts(List<NodeClassCost>& result) const;
+		/// @brief The structure like GetTreeStructureFormated(), with the totals of the subtree of every node and then the totals per class.
+		String GetTreeCostFormated(int32 level = 0) const;
+
+	protected:
+		/// @brief Override to count what a subclass allocates on top of the node, such as the components it owns. 0 by default.
+		virtual sizeint GetExtraMemoryUsage() const;
+		/// @brief Computes the local transform of a node from its own values.
+		using TransformFunction = TransformMatrix(*)(const Node* node);
+		/// @brief Give the node a transform, kept in the TransformHierarchy of the tree. Called by the constructors of Node2D and Node3D.
+		/// @param planar The node lives on the 2D plane and is put into the SpatialIndex2D of the tree, the SpatialIndex3D otherwise.
+		void SetTransformFunction(TransformFunction function, bool planar = false);
+		/// @brief Flag the transform as changed after the values it is computed from changed.
+		void MarkTransformChanged();
+		TransformMatrix GetNodeLocalTransform() const;
+		/// @brief Cached in the tree until the node or a parent changes, computed from the parents on every call outside a tree.
+		TransformMatrix GetNodeGlobalTransform() const;
+
 	private:
-		String name;
-		List<Node*> children{};
+		void AppendTreeStructureFormated(StringBuilder& builder, int32 level) const;
+		void AppendTreePrefix(StringBuilder& builder, int32 level) const;
+		/// @brief Add the totals of the subtree of every node in depth-first order.
+		NodeCost CollectCosts(List<NodeCost>& costs) const;
+		void AppendTreeCostFormated(StringBuilder& builder, int32 level, const List<NodeCost>& costs, int32& index) const;
+
+		StringName name;
+		// Most nodes are leaves or have only a few children, keep those inline.
+		SmallList<Node*, 4> children{};
+		// Built once there are more than IndexedChildrenThreshold children, kept until the node is destroyed.
+		UniquePtr<FlatDictionary<StringName, Node*>> childrenIndex{};
+		// The next suffix to try for each base name, for the ordinal validation of child names.
+		UniquePtr<FlatDictionary<String, uint32>> ordinalSuffixes{};
 		Node* parent = nullptr;
 		int index = -1;
 
@@ -139,14 +250,51 @@ namespace Engine {
 
 		bool childrenAddLocked = false;
 
-		static List<String> invalidChars;
+		bool updateEnabled = false;
+		bool physicsUpdateEnabled = false;
+		StringName updateGroup{};
+		bool updateThreadSafe = false;
+		bool updateIndependent = false;
+		TransformFunction transformFunction = nullptr;
+		// Slot in the TransformHierarchy of the tree, -1 when not in a tree or without a transform.
+		int32 transformSlot = -1;
+		bool transformPlanar = false;
+		// Entry in the SpatialIndex2D or SpatialIndex3D of the tree by transformPlanar, -1 when not in it.
+		int32 spatialEntry = -1;
+
+		// The topmost independent node among this one and its ancestors in the tree, nullptr if none.
+		Node* independentRoot = nullptr;
+		// Positions in the update orders of the tree, -1 when not in them. Maintained by the NodeTree.
+		int32 updateOrderIndex = -1;
+		int32 physicsUpdateOrderIndex = -1;
+		// The NodeTree has put this node into its update orders, or knows it isn't in them.
+		bool updateOrderTracked = false;
+		bool freeQueued = false;
+		// The pool the node is an instance of, nullptr if none. The index is the one in its instances.
+		NodePool* pool = nullptr;
+		int32 poolIndex = -1;
+		// Time spent in the callbacks during the frame of the tree in updateCostFrame, see NodeTree::SetCostTracking().
+		uint64 updateCost = 0;
+		uint64 updateCostFrame = 0;
+
+		/// @brief Chars that would make a name ambiguous in a NodePath, removed by ValidateName().
+		static inline constexpr String::CharMask InvalidNameChars{ "./:\r\n" };
 		static AtomicValue<uint64> autoNameCounter;
 
 		friend class NodeTree;
+		friend class TransformHierarchy;
+		friend class NodePool;
+		friend class SpatialIndex2D;
+		friend class SpatialIndex3D;
 
 		void SystemAssignTree(NodeTree* tree);
+		/// @brief Give the node back to its pool, or destroy it if it has none.
+		void Free();
+		void RefreshIndependentRoot();
+		void IndexChild(Node* child);
+		/// @brief Walk the path name by name.
+		Node* ResolvePath(const NodePath& path) const;
+		void UnindexChild(Node* child);
 		//void SystemRemoveFromTree();
-		void SystemUpdate(float delta);
-		void SystemPhysicsUpdate(float delta);
 	};
 }
\ No newline at end of file
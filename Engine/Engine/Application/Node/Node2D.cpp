@@ -1,35 +1,51 @@
 #include "Engine/Application/Node/Node2D.h"
 
 namespace Engine {
+	Node2D::Node2D() {
+		SetTransformFunction(&Node2D::ComputeLocalTransform, true);
+	}
+
 	Vector2 Node2D::GetPosition() const {
 		return position;
 	}
 	void Node2D::SetPosition(const Vector2& position) {
 		this->position = position;
-		localTransformDirty = true;
+		MarkTransformChanged();
 	}
 	Vector2 Node2D::GetScale() const {
 		return scale;
 	}
 	void Node2D::SetScale(const Vector2& scale) {
 		this->scale = scale;
-		localTransformDirty = true;
+		MarkTransformChanged();
 	}
 	float Node2D::GetRotation() const {
 		return rotation;
 	}
 	void Node2D::SetRotation(float rotation) {
 		this->rotation = rotation;
-		localTransformDirty = true;
+		MarkTransformChanged();
 	}
 
-	void Node2D::UpdateLocalTransform() const {
-		TransformMatrix t;
-		t = TransformMatrix::Rotate(Vector3(0, 0, 1), rotation) * t;
-		t = TransformMatrix::Scale(Vector3(scale,1)) * t;
-		t = TransformMatrix::Translate(position) * t;
-		localTransform = t;
+	Transform2 Node2D::GetLocalTransform() const {
+		return Transform2::FromTransformMatrix(GetNodeLocalTransform());
+	}
+	Transform2 Node2D::GetGlobalTransform() const {
+		return Transform2::FromTransformMatrix(GetNodeGlobalTransform());
+	}
 
-		localTransformDirty = false;
+	TransformMatrix Node2D::ComputeLocalTransform(const Node* node) {
+		const Node2D* self = static_cast<const Node2D*>(node);
+		// Rotated, then scaled, then translated. The same as composing Translate(), Scale() and Rotate() without the multiplies.
+		float sin = Math::Sin(self->rotation);
+		float cos = Math::Cos(self->rotation);
+		Transform2 t;
+		t.matrix[0][0] = cos * self->scale.x;
+		t.matrix[0][1] = sin * self->scale.y;
+		t.matrix[1][0] = -sin * self->scale.x;
+		t.matrix[1][1] = cos * self->scale.y;
+		t.matrix[2][0] = self->position.x;
+		t.matrix[2][1] = self->position.y;
+		return t.ToTransformMatrix();
 	}
 }
@@ -2,13 +2,27 @@
 
 #include "Engine/Application/Node/Node.h"
 #include "Engine/System/Math/Vector.h"
-#include "Engine/System/Math/TransformMatrix.h"
+#include "Engine/System/Math/Transform2.h"
 
 namespace Engine {
 	class Node2D :public Node {
-		REFLECTION_CLASS(::Engine::Node2D, ::Engine::Node) {}
+		REFLECTION_CLASS(::Engine::Node2D, ::Engine::Node) {
+			REFLECTION_CLASS_CONSTRUCTIBLE(Node2D);
+
+			REFLECTION_METHOD(STRL("GetPosition"), Node2D::GetPosition, {}, {});
+			REFLECTION_METHOD(STRL("SetPosition"), Node2D::SetPosition, { STRL("position") }, {});
+			REFLECTION_PROPERTY(STRL("Position"), STRL("GetPosition"), STRL("SetPosition"));
+			REFLECTION_METHOD(STRL("GetScale"), Node2D::GetScale, {}, {});
+			REFLECTION_METHOD(STRL("SetScale"), Node2D::SetScale, { STRL("scale") }, {});
+			REFLECTION_PROPERTY(STRL("Scale"), STRL("GetScale"), STRL("SetScale"));
+			REFLECTION_METHOD(STRL("GetRotation"), Node2D::GetRotation, {}, {});
+			REFLECTION_METHOD(STRL("SetRotation"), Node2D::SetRotation, { STRL("rotation") }, {});
+			REFLECTION_PROPERTY(STRL("Rotation"), STRL("GetRotation"), STRL("SetRotation"));
+		}
 
 	public:
+		Node2D();
+
 		Vector2 GetPosition() const;
 		void SetPosition(const Vector2& position);
 		
@@ -17,20 +31,17 @@ namespace Engine {
 
 		float GetRotation() const;
 		void SetRotation(float rotation);
-
-
-		
-		void UpdateLocalTransform() const;
-		void UpdateGlobalTransform() const;
+		Transform2 GetLocalTransform() const;
+		/// @brief Taken from the TransformHierarchy of the tree when in one.
+		Transform2 GetGlobalTransform() const;
 
 	private:
 		Vector2 position = Vector2(0, 0);
 		Vector2 scale = Vector2(1, 1);
 		float rotation = 0;
 
-		mutable TransformMatrix localTransform;
-		mutable TransformMatrix globalTransform;
-		mutable bool localTransformDirty = true;
-		mutable bool globalTransformDirty = true;
+		static TransformMatrix ComputeLocalTransform(const Node* node);
+
+		friend class AnimationSystem;
 	};
 }
\ No newline at end of file
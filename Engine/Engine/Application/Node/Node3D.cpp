@@ -1,35 +1,55 @@
 #include "Engine/Application/Node/Node3D.h"
 
 namespace Engine {
+	Node3D::Node3D() {
+		SetTransformFunction(&Node3D::ComputeLocalTransform);
+	}
+
 	Vector3 Node3D::GetPosition() const {
 		return position;
 	}
 	void Node3D::SetPosition(const Vector3& position) {
 		this->position = position;
-		localTransformDirty = true;
+		MarkTransformChanged();
 	}
 	Vector3 Node3D::GetScale() const {
 		return scale;
 	}
 	void Node3D::SetScale(const Vector3& scale) {
 		this->scale = scale;
-		localTransformDirty = true;
+		MarkTransformChanged();
 	}
 	Quaternion Node3D::GetRotation() const {
 		return rotation;
 	}
 	void Node3D::SetRotation(Quaternion rotation) {
 		this->rotation = rotation;
-		localTransformDirty = true;
+		MarkTransformChanged();
+	}
+
+	TransformMatrix Node3D::GetLocalTransform() const {
+		return GetNodeLocalTransform();
+	}
+	TransformMatrix Node3D::GetGlobalTransform() const {
+		return GetNodeGlobalTransform();
 	}
 
-	void Node3D::UpdateLocalTransform() const {
-		TransformMatrix t;
-		t = rotation.ToTransformMatrix() * t;
-		t = TransformMatrix::Scale(scale) * t;
-		t = TransformMatrix::Translate(position) * t;
-		localTransform = t;
+	Vector3 Node3D::GetBoundsCenter() const {
+		return boundsCenter;
+	}
+	Vector3 Node3D::GetBoundsExtent() const {
+		return boundsExtent;
+	}
+	void Node3D::SetBounds(const Vector3& center, const Vector3& extent) {
+		ERR_ASSERT(extent.x >= 0 && extent.y >= 0 && extent.z >= 0, u8"extent cannot be negative.", return);
+		boundsCenter = center;
+		boundsExtent = extent;
+		// The spatial index picks the new box up with the moved transforms.
+		MarkTransformChanged();
+	}
 
-		localTransformDirty = false;
+	TransformMatrix Node3D::ComputeLocalTransform(const Node* node) {
+		const Node3D* self = static_cast<const Node3D*>(node);
+		return self->rotation.ToTransformMatrix(self->scale, self->position);
 	}
 }
@@ -7,9 +7,14 @@
 
 namespace Engine {
 	class Node3D :public Node {
-		REFLECTION_CLASS(::Engine::Node3D, ::Engine::Node) {}
+		REFLECTION_CLASS(::Engine::Node3D, ::Engine::Node) {
+			// Variants can't hold Vector3 and Quaternion yet, so the transform isn't a property.
+			REFLECTION_CLASS_CONSTRUCTIBLE(Node3D);
+		}
 
 	public:
+		Node3D();
+
 		Vector3 GetPosition() const;
 		void SetPosition(const Vector3& position);
 
@@ -18,20 +23,26 @@ namespace Engine {
 
 		Quaternion GetRotation() const;
 		void SetRotation(Quaternion rotation);
+		TransformMatrix GetLocalTransform() const;
+		/// @brief Taken from the TransformHierarchy of the tree when in one.
+		TransformMatrix GetGlobalTransform() const;
 
-		
-
-		void UpdateLocalTransform() const;
-		void UpdateGlobalTransform() const;
+		/// @brief The box the node takes up in its local space, given by its center and half of its size.\n
+		/// Raycasts and overlap queries of the SpatialIndex3D of the tree test it through the global transform.
+		/// Empty by default, which still puts the node in the index as a point.
+		Vector3 GetBoundsCenter() const;
+		Vector3 GetBoundsExtent() const;
+		void SetBounds(const Vector3& center, const Vector3& extent);
 
 	private:
 		Vector3 position = Vector3(0, 0, 0);
 		Vector3 scale = Vector3(1, 1, 1);
 		Quaternion rotation = Quaternion();
+		Vector3 boundsCenter = Vector3(0, 0, 0);
+		Vector3 boundsExtent = Vector3(0, 0, 0);
+
+		static TransformMatrix ComputeLocalTransform(const Node* node);
 
-		mutable TransformMatrix localTransform;
-		mutable TransformMatrix globalTransform;
-		mutable bool localTransformDirty = true;
-		mutable bool globalTransformDirty = true;
+		friend class AnimationSystem;
 	};
 }
\ No newline at end of file
@@ -1,9 +1,45 @@
 #include "Engine/Application/Node/NodePath.h"
 #include "Engine/System/Debug.h"
+#include "Engine/System/Object/ObjectUtil.h"
 
 namespace Engine {
 	NodePath::NodePath(String path) {
+		if (path.GetCount() == 0) {
+			return;
+		}
+		data = SharedPtr<Data>::Create();
+		data->absolute = (path[0] == u8'/');
+
+		String::Tokenizer parts = path.Tokenize(STRL(":"));
+		String nodePart;
+		parts.Next(nodePart);
+		String::Tokenizer names = nodePart.Tokenize(STRL("/"), true);
+		String name;
+		while (names.Next(name)) {
+			data->names.Add(StringName(name));
+		}
+		String subname;
+		while (parts.Next(subname)) {
+			if (subname.GetCount() > 0) {
+				data->subnames.Add(Memory::Move(subname));
+			}
+		}
+
+		uint32 hash = (uint32)ObjectUtil::GetHashCode(data->absolute);
+		for (const StringName& item : data->names) {
+			hash = hash * 31 + (uint32)item.GetHashCode();
+		}
+		for (const String& item : data->subnames) {
+			hash = hash * 31 + (uint32)item.GetHashCode();
+		}
+		data->hash = (int32)hash;
+	}
 
+	bool NodePath::IsEmpty() const {
+		return data == nullptr || (data->names.GetCount() == 0 && data->subnames.GetCount() == 0 && !data->absolute);
+	}
+	bool NodePath::IsAbsolute() const {
+		return data != nullptr && data->absolute;
 	}
 
 	int32 NodePath::GetNameCount() const {
@@ -15,6 +51,11 @@ namespace Engine {
 	String NodePath::GetName(int32 index) const {
 		ERR_ASSERT(index >= 0 && index < GetNameCount(), u8"index out of bounds.", return String());
 
+		return data->names.Get(index).GetString();
+	}
+	StringName NodePath::GetInternedName(int32 index) const {
+		ERR_ASSERT(index >= 0 && index < GetNameCount(), u8"index out of bounds.", return StringName());
+
 		return data->names.Get(index);
 	}
 	int32 NodePath::GetSubnameCount() const {
@@ -28,4 +69,33 @@ namespace Engine {
 
 		return data->subnames.Get(index);
 	}
-}
+
+	bool NodePath::operator==(const NodePath& obj) const {
+		if (data.GetRaw() == obj.data.GetRaw()) {
+			return true;
+		}
+		if (IsAbsolute() != obj.IsAbsolute() || GetNameCount() != obj.GetNameCount() || GetSubnameCount() != obj.GetSubnameCount()) {
+			return false;
+		}
+		if (GetHashCode() != obj.GetHashCode()) {
+			return false;
+		}
+		for (int32 i = 0; i < GetNameCount(); i += 1) {
+			if (data->names.Get(i) != obj.data->names.Get(i)) {
+				return false;
+			}
+		}
+		for (int32 i = 0; i < GetSubnameCount(); i += 1) {
+			if (data->subnames.Get(i) != obj.data->subnames.Get(i)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	bool NodePath::operator!=(const NodePath& obj) const {
+		return !(*this == obj);
+	}
+	int32 NodePath::GetHashCode() const {
+		return data == nullptr ? 0 : data->hash;
+	}
+}
\ No newline at end of file
@@ -1,26 +1,41 @@
 #pragma once
 
-#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/SmallList.h"
 #include "Engine/System/Memory/SharedPtr.h"
 #include "Engine/System/String.h"
+#include "Engine/System/StringName.h"
 
 namespace Engine {
-	/// @brief Stores a parsed node path.
+	/// @brief Stores a parsed node path.\n
+	/// A path is node names separated by `/`, followed by subnames led by `:`, such as `/root/Player:position:x`.
+	/// A leading `/` makes it absolute, starting from the topmost node, which is named first. `.` and `..` stand for a node itself and its parent.\n
+	/// Names are interned on parsing, so resolving a path compares them by pointer. Parse a path once and keep it rather than parsing it on every lookup.
 	class NodePath {
 	public:
 		NodePath(String path = u8"");
 
+		bool IsEmpty() const;
+		bool IsAbsolute() const;
 
 		int32 GetNameCount() const;
 		String GetName(int32 index) const;
+		/// @brief Get the name as it is stored, without copying its content.
+		StringName GetInternedName(int32 index) const;
 		int32 GetSubnameCount() const;
 		String GetSubname(int32 index) const;
 
+		/// @brief Paths are equal when they have the same names and subnames and are both absolute or both relative.
+		bool operator==(const NodePath& obj) const;
+		bool operator!=(const NodePath& obj) const;
+		int32 GetHashCode() const;
+
 	private:
 		struct Data {
 			bool absolute = false;
-			List<String> names{};
-			List<String> subnames{};
+			SmallList<StringName, 4> names{};
+			SmallList<String, 2> subnames{};
+			// Computed on parsing, the paths are immutable.
+			int32 hash = 0;
 		};
 		SharedPtr<Data> data;
 	};
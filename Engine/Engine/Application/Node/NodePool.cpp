@@ -0,0 +1,126 @@
+#include "Engine/Application/Node/NodePool.h"
+#include "Engine/Application/Node/NodeTree.h"
+#include "Engine/System/Object/ObjectRegistry.h"
+#include "Engine/System/Debug.h"
+
+namespace Engine {
+	NodePool::NodePool(BuildFunction build, ResetFunction reset) :build(build), reset(reset) {
+		ERR_ASSERT(build != nullptr, u8"build is nullptr.", return);
+	}
+	NodePool::~NodePool() {
+		for (Node* node : instances) {
+			node->pool = nullptr;
+			node->poolIndex = -1;
+		}
+		// Their nodes have no ids left, destroying them doesn't unregister anything.
+		for (Node* node : released) {
+			MEMDEL(node);
+		}
+	}
+
+	void NodePool::Reserve(int32 count) {
+		while (released.GetCount() < count) {
+			Build();
+		}
+	}
+	Node* NodePool::Acquire() {
+		if (released.GetCount() <= 0) {
+			Build();
+		}
+		Node* node = released[released.GetCount() - 1];
+		released.RemoveAt(released.GetCount() - 1);
+		Register(&node, 1);
+		return node;
+	}
+	void NodePool::AcquireMany(int32 count, List<Node*>& result) {
+		if (count <= 0) {
+			return;
+		}
+		Reserve(count);
+		int32 start = released.GetCount() - count;
+		Register(released.GetRawElementPtr() + start, count);
+		result.RequireCapacity(result.GetCount() + count);
+		for (int32 i = start; i < released.GetCount(); i += 1) {
+			result.Add(released[i]);
+		}
+		while (released.GetCount() > start) {
+			released.RemoveAt(released.GetCount() - 1);
+		}
+	}
+	void NodePool::Release(Node* node) {
+		ERR_ASSERT(node != nullptr, u8"node is nullptr.", return);
+		ERR_ASSERT(node->pool == this, u8"node doesn't belong to the pool.", return);
+		ERR_ASSERT(node->GetInstanceId().IsValid(), u8"node is released already.", return);
+		if (node->HasParent()) {
+			NodeTree* tree = node->GetTree();
+			ERR_ASSERT(tree == nullptr || !tree->IsUpdatingInParallel(), u8"Cannot release nodes of a tree updating in parallel, use QueueFree() instead.", return);
+			node->GetParent()->RemoveChild(node);
+		}
+		node->freeQueued = false;
+		if (reset != nullptr) {
+			reset(node);
+		}
+		Unregister(node);
+		released.Add(node);
+	}
+
+	int32 NodePool::GetReleasedCount() const {
+		return released.GetCount();
+	}
+	int32 NodePool::GetInstanceCount() const {
+		return instances.GetCount();
+	}
+
+	void NodePool::Build() {
+		Node* node = build();
+		ERR_ASSERT(node != nullptr, u8"The build function returned nullptr.", return);
+		ERR_ASSERT(!node->HasParent() && node->pool == nullptr, u8"The build function must return a new node without a parent.", return);
+		node->pool = this;
+		node->poolIndex = instances.GetCount();
+		instances.Add(node);
+		Unregister(node);
+		released.Add(node);
+	}
+	void NodePool::Forget(Node* node) {
+		int32 index = node->poolIndex;
+		Node* last = instances[instances.GetCount() - 1];
+		instances[index] = last;
+		last->poolIndex = index;
+		instances.RemoveAt(instances.GetCount() - 1);
+		node->pool = nullptr;
+		node->poolIndex = -1;
+	}
+
+	void NodePool::Register(Node* const* roots, int32 count) {
+		subtree.Clear();
+		for (int32 i = 0; i < count; i += 1) {
+			CollectSubtree(roots[i], subtree);
+		}
+		objects.Clear();
+		ids.Clear();
+		for (Node* node : subtree) {
+			objects.Add(node);
+			ids.Add(InstanceId());
+		}
+		ObjectRegistry::RegisterMany(objects.GetRawElementPtr(), objects.GetCount(), false, ids.GetRawElementPtr());
+		for (int32 i = 0; i < subtree.GetCount(); i += 1) {
+			subtree[i]->instanceId = ids[i];
+		}
+	}
+	void NodePool::Unregister(Node* root) {
+		subtree.Clear();
+		CollectSubtree(root, subtree);
+		ids.Clear();
+		for (Node* node : subtree) {
+			ids.Add(node->instanceId);
+			node->instanceId = InstanceId();
+		}
+		ObjectRegistry::UnregisterMany(ids.GetRawElementPtr(), ids.GetCount());
+	}
+	void NodePool::CollectSubtree(Node* node, List<Node*>& result) {
+		result.Add(node);
+		for (int32 i = 0; i < node->GetChildrenCount(); i += 1) {
+			CollectSubtree(node->GetChildByIndex(i), result);
+		}
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/Application/Node/Node.h"
+
+namespace Engine {
+	/// @brief Keeps instances of a subtree built by a function, so spawning many alike nodes such as projectiles reuses released ones instead of building them again.\n
+	/// A released instance leaves its parent and gives up the ids of its nodes, as if it were destroyed. Acquiring it registers them again in one go.\n
+	/// QueueFree() on an instance gives it back to the pool. Not thread-safe, use it from the thread that owns the tree.
+	class NodePool final {
+	public:
+		/// @brief Build a new instance, the node returned is the root of the subtree.
+		using BuildFunction = Node* (*)();
+		/// @brief Prepare a released instance for reuse, such as restoring the values it was built with.
+		using ResetFunction = void(*)(Node* node);
+
+		NodePool(BuildFunction build, ResetFunction reset = nullptr);
+		/// @brief Destroys the released instances. The acquired ones stay alive and no longer belong to the pool.
+		~NodePool();
+		NodePool(const NodePool&) = delete;
+		NodePool& operator=(const NodePool&) = delete;
+
+		/// @brief Build instances until at least the given count of them is released.
+		void Reserve(int32 count);
+		/// @brief Get a released instance, building a new one if there is none.
+		Node* Acquire();
+		template<typename T>
+		T* Acquire() {
+			return static_cast<T*>(Acquire());
+		}
+		/// @brief Acquire several instances, registering all their nodes at once.
+		/// @param result The instances are appended to it.
+		void AcquireMany(int32 count, List<Node*>& result);
+		/// @brief Take the instance out of its parent and keep it for reuse.\n
+		/// Don't release nodes of a tree updating in parallel, use QueueFree() instead.
+		void Release(Node* node);
+
+		/// @brief Count of instances waiting to be acquired.
+		int32 GetReleasedCount() const;
+		/// @brief Count of instances belonging to the pool, acquired or not.
+		int32 GetInstanceCount() const;
+
+	private:
+		friend class Node;
+		/// @brief Build an instance and release it right away.
+		void Build();
+		/// @brief Drop the node from the instances, it's being destroyed.
+		void Forget(Node* node);
+		/// @brief Register or unregister the ids of every node of the released instances.
+		void Register(Node* const* roots, int32 count);
+		void Unregister(Node* root);
+		static void CollectSubtree(Node* node, List<Node*>& result);
+
+		BuildFunction build;
+		ResetFunction reset;
+		// Every instance, its index is Node::poolIndex.
+		List<Node*> instances{};
+		List<Node*> released{};
+		// Kept between calls so they stop allocating.
+		List<Node*> subtree{};
+		List<Object*> objects{};
+		List<InstanceId> ids{};
+	};
+}
@@ -1,42 +1,95 @@
 #include "Engine/Application/Node/NodeTree.h"
 #include "Engine/Application/Engine.h"
 #include "Engine/Application/Window.h"
+#include "Engine/System/Object/DeferredCallQueue.h"
+#include "Engine/System/Profiler.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Object/ObjectUtil.h"
 
 namespace Engine {
 	NodeTree::NodeTree() {
 		root->index = 0;
 		root->SetNameUnchecked(STRING_LITERAL("Root"));
+		GetOrCreateGroup(StringName());
+	}
+	NodeTree::~NodeTree() {
+		// Nodes still in the tree leave the orders of the groups while being destroyed.
+		root.Reset();
+		for (UpdateGroup* group : groups) {
+			MEMDEL(group);
+		}
 	}
 
 	void NodeTree::OnStart() {
-		// Create the first window.
-		WindowSystem* nwm = ::Engine::Engine::GetInstance()->GetWindowSystem();
-		Window* nw = nwm->CreateWindow();
-		nw->SetTitle(STRING_LITERAL("Rabbik Engine"));
-		nw->SetSize(Vector2(640, 480));
-		nw->SetVisible(true);
+		// Create the first window. Without an engine or with a headless one, the tree runs without windows.
+		Window* nw = nullptr;
+		if (::Engine::Engine::GetInstance() != nullptr && !::Engine::Engine::GetInstance()->IsHeadless()) {
+			WindowSystem* nwm = ::Engine::Engine::GetInstance()->GetWindowSystem();
+			nw = nwm->CreateWindow();
+		}
+		if (nw != nullptr) {
+			nw->SetTitle(STRING_LITERAL("Rabbik Engine"));
+			nw->SetSize(Vector2(640, 480));
+			nw->SetVisible(true);
+		} else {
+			// There is no window to close, stop with RequestStop() instead.
+			stopWhenNoWindow = false;
+		}
 
 		GetRoot()->SystemAssignTree(this);
+		OnSubtreeEntered(GetRoot());
 		running = true;
 
 		INFO_MSG(root->GetTreeStructureFormated().GetRawArray());
 	}
 
 	void NodeTree::OnUpdate(const Time& time) {
-		GetRoot()->SystemUpdate(time.GetDelta());
+		PROFILE_SCOPE("NodeTree::OnUpdate");
+		float delta = time.GetDelta();
+		// Groups made or moved while updating are picked up by the cursor, see PlaceGroup().
+		groupCursor = 0;
+		while (groupCursor < groups.GetCount()) {
+			UpdateGroup* group = groups[groupCursor];
+			groupCursor += 1;
+			RunGroup(*group, delta);
+		}
+		groupCursor = -1;
+		FlushQueuedChanges();
+		// Deferred signals emitted during the update run here, after every node has updated.
+		DeferredCallQueue::GetCurrent().Flush();
+		// Rendering reads the global transforms of this frame straight from the arrays.
+		UpdateTransforms();
+		inputEvents.Clear();
+		costFrame += 1;
 
 		if (stopWhenNoWindow && ::Engine::Engine::GetInstance()->GetWindowSystem()->GetWindowCount() <= 0) {
 			running = false;
 		}
 	}
 	void NodeTree::OnPhysicsUpdate(const Time& time) {
-		GetRoot()->SystemPhysicsUpdate(time.GetDelta());
+		Run(physicsUpdateOrder, &Node::OnPhysicsUpdate, time.GetPhysicsDelta());
+		UpdateTransforms();
 
 		if (stopWhenNoWindow && ::Engine::Engine::GetInstance()->GetWindowSystem()->GetWindowCount() <= 0) {
 			running = false;
 		}
 	}
 	void NodeTree::OnStop() {
+		// Nodes waiting to be added aren't owned by anything else yet.
+		FlushQueuedChanges();
+		// The root isn't removed from a parent, drop its entries before it goes.
+		List<Node*> nodes;
+		CollectSubtree(GetRoot(), nodes);
+		for (Node* node : nodes) {
+			node->updateOrderTracked = false;
+			node->updateOrderIndex = -1;
+			node->physicsUpdateOrderIndex = -1;
+		}
+		for (UpdateGroup* group : groups) {
+			group->order.nodes.Clear();
+		}
+		physicsUpdateOrder.nodes.Clear();
+		pathCache.Clear();
 		root.Reset();
 	}
 	bool NodeTree::IsRunning() const {
@@ -50,4 +103,676 @@ namespace Engine {
 	void NodeTree::RequestStop() {
 		running = false;
 	}
+	void NodeTree::OnInput(const InputEvent& event) {
+		inputEvents.Add(event);
+	}
+	const List<InputEvent>& NodeTree::GetInputEvents() const {
+		return inputEvents;
+	}
+	void NodeTree::SetStopWhenNoWindow(bool stop) {
+		stopWhenNoWindow = stop;
+	}
+	bool NodeTree::IsStopWhenNoWindow() const {
+		return stopWhenNoWindow;
+	}
+
+	int32 NodeTree::GetUpdateNodeCount() const {
+		int32 count = 0;
+		for (UpdateGroup* group : groups) {
+			count += group->order.nodes.GetCount();
+		}
+		return count;
+	}
+	int32 NodeTree::GetPhysicsUpdateNodeCount() const {
+		return physicsUpdateOrder.nodes.GetCount();
+	}
+
+	void NodeTree::SetUpdateGroupInterval(const StringName& group, int32 frames, bool sliced) {
+		ERR_ASSERT(frames >= 1, u8"frames must be at least 1.", return);
+		UpdateGroup& target = GetOrCreateGroup(group);
+		target.interval = frames;
+		target.sliced = sliced && frames > 1;
+		target.frame = 0;
+		int32 slices = target.sliced ? frames : 1;
+		target.deltas.Clear();
+		for (int32 i = 0; i < slices; i += 1) {
+			target.deltas.Add(0);
+		}
+	}
+	void NodeTree::SetUpdateGroupPriority(const StringName& group, int32 priority) {
+		UpdateGroup& target = GetOrCreateGroup(group);
+		if (target.priority == priority) {
+			return;
+		}
+		for (int32 i = 0; i < groups.GetCount(); i += 1) {
+			if (groups[i] == &target) {
+				groups.RemoveAt(i);
+				if (groupCursor >= 0 && i < groupCursor) {
+					groupCursor -= 1;
+				}
+				break;
+			}
+		}
+		target.priority = priority;
+		PlaceGroup(&target);
+	}
+	int32 NodeTree::GetUpdateGroupNodeCount(const StringName& group) const {
+		UpdateGroup* target = FindGroup(group);
+		return target != nullptr ? target->order.nodes.GetCount() : 0;
+	}
+
+	void NodeTree::SetParallelUpdate(JobSystem* jobSystem) {
+		ERR_ASSERT(!updatingInParallel, u8"Cannot switch the parallel update while updating in parallel.", return);
+		parallelJobSystem = jobSystem;
+	}
+	JobSystem* NodeTree::GetParallelUpdate() const {
+		return parallelJobSystem;
+	}
+	void NodeTree::SetCostTracking(bool tracking) {
+		costTracking = tracking;
+	}
+	bool NodeTree::IsCostTracking() const {
+		return costTracking;
+	}
+	void NodeTree::RecordCost(Node* node, uint64 begin) const {
+		uint64 end = Profiler::GetTimestamp();
+		// Each node updates on one thread at a time, so its cost needs no synchronization.
+		if (node->updateCostFrame != costFrame) {
+			node->updateCost = 0;
+			node->updateCostFrame = costFrame;
+		}
+		node->updateCost += end - begin;
+	}
+	bool NodeTree::IsUpdatingInParallel() const {
+		return updatingInParallel;
+	}
+
+	TransformHierarchy& NodeTree::GetTransforms() {
+		return transforms;
+	}
+	const TransformHierarchy& NodeTree::GetTransforms() const {
+		return transforms;
+	}
+	SpatialIndex2D& NodeTree::GetSpatialIndex2D() {
+		return spatialIndex2D;
+	}
+	const SpatialIndex2D& NodeTree::GetSpatialIndex2D() const {
+		return spatialIndex2D;
+	}
+	SpatialIndex3D& NodeTree::GetSpatialIndex3D() {
+		return spatialIndex3D;
+	}
+	const SpatialIndex3D& NodeTree::GetSpatialIndex3D() const {
+		return spatialIndex3D;
+	}
+	void NodeTree::UpdateTransforms() {
+		transforms.Update(parallelJobSystem);
+		movedSlots.Clear();
+		transforms.CollectMoved(movedSlots);
+		spatialIndex2D.Update(transforms, movedSlots);
+		spatialIndex3D.Update(transforms, movedSlots);
+	}
+
+	uint64 NodeTree::GetStructureVersion() const {
+		return structureVersion;
+	}
+	void NodeTree::OnStructureChanged() {
+		structureVersion += 1;
+	}
+
+	int32 NodeTree::PathCacheKey::GetHashCode() const {
+		return ObjectUtil::GetHashCode((const void*)origin) ^ path.GetHashCode();
+	}
+	bool NodeTree::PathCacheKey::operator==(const PathCacheKey& obj) const {
+		return origin == obj.origin && path == obj.path;
+	}
+	Node* NodeTree::ResolvePath(const Node* origin, const NodePath& path) {
+		if (updatingInParallel) {
+			// The structure can't change meanwhile, but the cache isn't safe to touch from several threads.
+			return origin->ResolvePath(path);
+		}
+		if (pathCacheVersion != structureVersion || pathCache.GetCount() >= MaxCachedPaths) {
+			// Nodes gone since then may still be keys, they're never dereferenced.
+			pathCache.Clear();
+			pathCacheVersion = structureVersion;
+		}
+		PathCacheKey key;
+		key.origin = origin;
+		key.path = path;
+		Node** found = pathCache.Find(key);
+		if (found != nullptr) {
+			return *found;
+		}
+		Node* node = origin->ResolvePath(path);
+		pathCache.Add(key, node);
+		return node;
+	}
+
+	void NodeTree::DeferAddChild(Node* parent, Node* node, int32 index) {
+		DeferredChange change;
+		change.kind = DeferredChange::Kind::AddChild;
+		change.target = parent;
+		change.node = node;
+		change.index = index;
+		Defer(change);
+	}
+	void NodeTree::DeferRemoveChild(Node* parent, Node* child) {
+		DeferredChange change;
+		change.kind = DeferredChange::Kind::RemoveChild;
+		change.target = parent;
+		change.node = child;
+		Defer(change);
+	}
+	void NodeTree::DeferSetName(Node* node, const String& name) {
+		DeferredChange change;
+		change.kind = DeferredChange::Kind::SetName;
+		change.target = node;
+		change.name = name;
+		Defer(change);
+	}
+	void NodeTree::DeferSetUpdateGroup(Node* node, const StringName& group) {
+		DeferredChange change;
+		change.kind = DeferredChange::Kind::SetUpdateGroup;
+		change.target = node;
+		change.group = group;
+		Defer(change);
+	}
+	void NodeTree::DeferUpdateChanged(Node* node, bool physics) {
+		DeferredChange change;
+		change.kind = physics ? DeferredChange::Kind::PhysicsUpdateChanged : DeferredChange::Kind::UpdateChanged;
+		change.target = node;
+		Defer(change);
+	}
+	void NodeTree::Defer(const DeferredChange& change) {
+		SimpleLock<Mutex> lock(deferredChangesMutex);
+		deferredChanges.Add(change);
+	}
+	void NodeTree::ApplyDeferredChanges() {
+		// Only called between batches, nothing is deferred meanwhile.
+		for (int32 i = 0; i < deferredChanges.GetCount(); i += 1) {
+			DeferredChange& change = deferredChanges[i];
+			switch (change.kind) {
+				case DeferredChange::Kind::AddChild:
+					change.target->AddChild(change.node, change.index);
+					break;
+				case DeferredChange::Kind::RemoveChild:
+					change.target->RemoveChild(change.node);
+					break;
+				case DeferredChange::Kind::SetName:
+					change.target->SetName(change.name);
+					break;
+				case DeferredChange::Kind::SetUpdateGroup:
+					change.target->SetUpdateGroup(change.group);
+					break;
+				case DeferredChange::Kind::UpdateChanged:
+				case DeferredChange::Kind::PhysicsUpdateChanged:
+					// Removed by an earlier change.
+					if (change.target->GetTree() == this) {
+						OnNodeUpdateChanged(change.target, change.kind == DeferredChange::Kind::PhysicsUpdateChanged);
+					}
+					break;
+				case DeferredChange::Kind::Free:
+					// Only ever queued, see FlushQueuedChanges().
+					break;
+			}
+		}
+		deferredChanges.Clear();
+	}
+
+	void NodeTree::QueueAddChild(Node* parent, Node* node, int32 index) {
+		DeferredChange change;
+		change.kind = DeferredChange::Kind::AddChild;
+		change.target = parent;
+		change.node = node;
+		change.index = index;
+		Queue(change);
+	}
+	void NodeTree::QueueRemoveChild(Node* parent, Node* child) {
+		DeferredChange change;
+		change.kind = DeferredChange::Kind::RemoveChild;
+		change.target = parent;
+		change.node = child;
+		Queue(change);
+	}
+	void NodeTree::QueueFree(Node* node) {
+		DeferredChange change;
+		change.kind = DeferredChange::Kind::Free;
+		change.target = node;
+		Queue(change);
+	}
+	void NodeTree::Queue(const DeferredChange& change) {
+		SimpleLock<Mutex> lock(deferredChangesMutex);
+		queuedChanges.Add(change);
+	}
+	int32 NodeTree::GetQueuedChangeCount() const {
+		return queuedChanges.GetCount();
+	}
+	void NodeTree::FlushQueuedChanges() {
+		ERR_ASSERT(!updatingInParallel, u8"Cannot flush the queued changes while updating in parallel.", return);
+		if (applyingQueuedChanges) {
+			// Called from a callback, the running flush picks the new changes up.
+			return;
+		}
+		applyingQueuedChanges = true;
+		List<DeferredChange> changes;
+		List<Node*> freed;
+		while (queuedChanges.GetCount() > 0) {
+			changes = Memory::Move(queuedChanges);
+			for (int32 i = 0; i < changes.GetCount(); i += 1) {
+				DeferredChange& change = changes[i];
+				switch (change.kind) {
+					case DeferredChange::Kind::AddChild:
+						change.target->AddChild(change.node, change.index);
+						break;
+					case DeferredChange::Kind::RemoveChild:
+						change.target->RemoveChild(change.node);
+						break;
+					case DeferredChange::Kind::Free:
+						freed.Add(change.target);
+						break;
+					default:
+						break;
+				}
+			}
+			// Detach every freed node first, so none of them is deleted along with a freed ancestor.
+			for (Node* node : freed) {
+				if (node->HasParent()) {
+					node->GetParent()->RemoveChild(node);
+				}
+			}
+			for (Node* node : freed) {
+				node->Free();
+			}
+			freed.Clear();
+		}
+		applyingQueuedChanges = false;
+		if (ordersDirty) {
+			RebuildOrders();
+		}
+	}
+
+	bool NodeTree::UpdateOrder::Accepts(const Node* node) const {
+		return node->*enabled && (!grouped || node->updateGroup == group);
+	}
+	int32 NodeTree::UpdateOrder::IndexOf(const Node* node) const {
+		// The index of a node refers to the order of its own group.
+		if (grouped && node->updateGroup != group) {
+			return -1;
+		}
+		return node->*index;
+	}
+
+	void NodeTree::Run(UpdateOrder& order, void (Node::* callback)(float), float delta, int32 first, int32 stride) {
+		if (ordersDirty) {
+			RebuildOrders();
+		}
+		// Nodes added or removed by the callbacks move the cursor, see InsertNodes() and RemoveNodes().
+		bool parallel = parallelJobSystem != nullptr && callback == &Node::OnUpdate;
+		order.cursor = first;
+		while (order.cursor < order.nodes.GetCount()) {
+			Node* node = order.nodes[order.cursor];
+			if (parallel && (node->updateThreadSafe || node->independentRoot != nullptr)) {
+				RunParallelBatch(order, delta, stride);
+				continue;
+			}
+			order.cursor += stride;
+			if (costTracking) {
+				uint64 begin = Profiler::GetTimestamp();
+				(node->*callback)(delta);
+				RecordCost(node, begin);
+			} else {
+				(node->*callback)(delta);
+			}
+		}
+		order.cursor = -1;
+	}
+	void NodeTree::RunParallelBatch(UpdateOrder& order, float delta, int32 stride) {
+		// Split the run into units, an independent subtree is contiguous in the order so it makes one unit.
+		batchNodes.Clear();
+		batchUnits.Clear();
+		Node* unitRoot = nullptr;
+		while (order.cursor < order.nodes.GetCount()) {
+			Node* node = order.nodes[order.cursor];
+			if (!node->updateThreadSafe && node->independentRoot == nullptr) {
+				break;
+			}
+			if (node->independentRoot == nullptr || node->independentRoot != unitRoot) {
+				batchUnits.Add(batchNodes.GetCount());
+			}
+			unitRoot = node->independentRoot;
+			batchNodes.Add(node);
+			order.cursor += stride;
+		}
+		batchUnits.Add(batchNodes.GetCount());
+
+		updatingInParallel = true;
+		parallelJobSystem->ParallelFor(0, batchUnits.GetCount() - 1, 0, [this, delta](int32 unit) {
+			for (int32 i = batchUnits[unit]; i < batchUnits[unit + 1]; i += 1) {
+				if (costTracking) {
+					uint64 begin = Profiler::GetTimestamp();
+					batchNodes[i]->OnUpdate(delta);
+					RecordCost(batchNodes[i], begin);
+				} else {
+					batchNodes[i]->OnUpdate(delta);
+				}
+			}
+		});
+		updatingInParallel = false;
+		// The sync point, changes move the cursor like the ones made by nodes updating in order.
+		ApplyDeferredChanges();
+	}
+	void NodeTree::RunGroup(UpdateGroup& group, float delta) {
+		for (int32 i = 0; i < group.deltas.GetCount(); i += 1) {
+			group.deltas[i] += delta;
+		}
+		int32 step = group.frame;
+		group.frame = (group.frame + 1) % group.interval;
+		if (group.sliced) {
+			// Nodes shifting while sliced may be updated a frame early or late, the deltas stay per slice.
+			float elapsed = group.deltas[step];
+			group.deltas[step] = 0;
+			Run(group.order, &Node::OnUpdate, elapsed, step, group.interval);
+		} else if (step == 0) {
+			float elapsed = group.deltas[0];
+			group.deltas[0] = 0;
+			Run(group.order, &Node::OnUpdate, elapsed);
+		}
+	}
+
+	typename NodeTree::UpdateGroup& NodeTree::GetOrCreateGroup(const StringName& name) {
+		UpdateGroup* group = FindGroup(name);
+		if (group == nullptr) {
+			group = MEMNEW(UpdateGroup(name));
+			group->deltas.Add(0);
+			PlaceGroup(group);
+		}
+		return *group;
+	}
+	typename NodeTree::UpdateGroup* NodeTree::FindGroup(const StringName& name) const {
+		// Only a handful of groups, and names compare by pointer.
+		for (UpdateGroup* group : groups) {
+			if (group->name == name) {
+				return group;
+			}
+		}
+		return nullptr;
+	}
+	void NodeTree::PlaceGroup(UpdateGroup* group) {
+		int32 at = groups.GetCount();
+		while (at > 0 && groups[at - 1]->priority > group->priority) {
+			at -= 1;
+		}
+		groups.Insert(at, group);
+		// Groups placed before the cursor wait for the next frame.
+		if (groupCursor >= 0 && at < groupCursor) {
+			groupCursor += 1;
+		}
+	}
+
+	void NodeTree::OnSubtreeEntered(Node* node) {
+		OnStructureChanged();
+		if (applyingQueuedChanges) {
+			// Picked up by the rebuild after the flush.
+			ordersDirty = true;
+			return;
+		}
+		List<Node*> entered;
+		bool foundTracked = false;
+		CollectUntracked(node, entered, foundTracked);
+		if (foundTracked) {
+			// Some of it joined the orders on its own while entering, a block insert would misplace them.
+			ordersDirty = true;
+			return;
+		}
+
+		for (Node* item : entered) {
+			if (item->updateEnabled) {
+				GetOrCreateGroup(item->updateGroup);
+			}
+		}
+		List<Node*> block;
+		for (UpdateGroup* group : groups) {
+			InsertEntered(group->order, node, entered, block);
+		}
+		InsertEntered(physicsUpdateOrder, node, entered, block);
+	}
+	void NodeTree::OnSubtreeExiting(Node* node) {
+		OnStructureChanged();
+		List<Node*> exiting;
+		CollectSubtree(node, exiting);
+		if (applyingQueuedChanges) {
+			DropExiting(exiting);
+			return;
+		}
+		for (UpdateGroup* group : groups) {
+			RemoveExiting(group->order, exiting);
+		}
+		RemoveExiting(physicsUpdateOrder, exiting);
+		for (Node* item : exiting) {
+			item->updateOrderTracked = false;
+		}
+	}
+	void NodeTree::DropExiting(const List<Node*>& exiting) {
+		// Indices may be stale while the orders wait for the rebuild, only trust the ones that still point back at the node.
+		for (Node* item : exiting) {
+			int32 index = item->updateOrderIndex;
+			for (UpdateGroup* group : groups) {
+				if (index >= 0 && index < group->order.nodes.GetCount() && group->order.nodes[index] == item) {
+					group->order.nodes[index] = nullptr;
+				}
+			}
+			index = item->physicsUpdateOrderIndex;
+			if (index >= 0 && index < physicsUpdateOrder.nodes.GetCount() && physicsUpdateOrder.nodes[index] == item) {
+				physicsUpdateOrder.nodes[index] = nullptr;
+			}
+			item->updateOrderIndex = -1;
+			item->physicsUpdateOrderIndex = -1;
+			item->updateOrderTracked = false;
+		}
+		ordersDirty = true;
+	}
+	void NodeTree::InsertEntered(UpdateOrder& order, Node* node, const List<Node*>& entered, List<Node*>& block) {
+		block.Clear();
+		for (Node* item : entered) {
+			if (order.Accepts(item)) {
+				block.Add(item);
+			}
+		}
+		if (block.GetCount() > 0) {
+			// A subtree is contiguous in depth-first order.
+			InsertNodes(order, FindInsertIndex(node, order, true), block);
+		}
+	}
+	void NodeTree::RemoveExiting(UpdateOrder& order, const List<Node*>& exiting) {
+		int32 first = -1;
+		int32 last = -1;
+		int32 count = 0;
+		for (Node* item : exiting) {
+			int32 index = order.IndexOf(item);
+			if (index < 0) {
+				continue;
+			}
+			first = (first < 0 || index < first) ? index : first;
+			last = index > last ? index : last;
+			count += 1;
+		}
+		if (count == 0) {
+			return;
+		}
+		if (last - first + 1 == count) {
+			RemoveNodes(order, first, count);
+		} else {
+			// Out of order until the next rebuild, remove them one by one.
+			for (Node* item : exiting) {
+				int32 index = order.IndexOf(item);
+				if (index >= 0) {
+					RemoveNodes(order, index, 1);
+				}
+			}
+		}
+	}
+	void NodeTree::OnNodeUpdateChanged(Node* node, bool physics) {
+		if (applyingQueuedChanges) {
+			// The orders hold holes until the rebuild.
+			ordersDirty = true;
+			return;
+		}
+		if (!node->updateOrderTracked) {
+			// Still entering, picked up with its subtree.
+			return;
+		}
+		UpdateOrder& order = physics ? physicsUpdateOrder : GetOrCreateGroup(node->updateGroup).order;
+		int32 index = order.IndexOf(node);
+		if (order.Accepts(node)) {
+			if (index < 0) {
+				List<Node*> single;
+				single.Add(node);
+				InsertNodes(order, FindInsertIndex(node, order, false), single);
+			}
+		} else if (index >= 0) {
+			RemoveNodes(order, index, 1);
+		}
+	}
+
+	void NodeTree::OnNodeUpdateGroupChanging(Node* node) {
+		if (!node->updateOrderTracked || applyingQueuedChanges) {
+			return;
+		}
+		// Leaves the order of its current group, OnNodeUpdateChanged() puts it into the new one.
+		UpdateGroup* group = FindGroup(node->updateGroup);
+		if (group != nullptr) {
+			int32 index = group->order.IndexOf(node);
+			if (index >= 0) {
+				RemoveNodes(group->order, index, 1);
+			}
+		}
+	}
+
+	void NodeTree::RebuildOrders() {
+		ordersDirty = false;
+		List<Node*> nodes;
+		CollectSubtree(GetRoot(), nodes);
+		for (UpdateGroup* group : groups) {
+			for (Node* item : group->order.nodes) {
+				// Holes left by DropExiting().
+				if (item != nullptr) {
+					item->updateOrderIndex = -1;
+				}
+			}
+			group->order.nodes.Clear();
+		}
+		for (Node* item : physicsUpdateOrder.nodes) {
+			if (item != nullptr) {
+				item->physicsUpdateOrderIndex = -1;
+			}
+		}
+		physicsUpdateOrder.nodes.Clear();
+		for (Node* item : nodes) {
+			if (item->updateEnabled) {
+				UpdateOrder& order = GetOrCreateGroup(item->updateGroup).order;
+				item->updateOrderIndex = order.nodes.GetCount();
+				order.nodes.Add(item);
+			}
+			if (item->physicsUpdateEnabled) {
+				item->physicsUpdateOrderIndex = physicsUpdateOrder.nodes.GetCount();
+				physicsUpdateOrder.nodes.Add(item);
+			}
+		}
+		for (Node* item : nodes) {
+			item->updateOrderTracked = true;
+		}
+	}
+
+	void NodeTree::CollectUntracked(Node* node, List<Node*>& result, bool& foundTracked) {
+		if (node->updateOrderTracked) {
+			foundTracked = true;
+		} else {
+			node->updateOrderTracked = true;
+			result.Add(node);
+		}
+		for (Node* child : node->children) {
+			CollectUntracked(child, result, foundTracked);
+		}
+	}
+	void NodeTree::CollectSubtree(Node* node, List<Node*>& result) {
+		result.Add(node);
+		for (Node* child : node->children) {
+			CollectSubtree(child, result);
+		}
+	}
+	int32 NodeTree::FindFirstIndex(Node* node, const UpdateOrder& order) {
+		int32 index = order.IndexOf(node);
+		if (index >= 0) {
+			return index;
+		}
+		for (Node* child : node->children) {
+			index = FindFirstIndex(child, order);
+			if (index >= 0) {
+				return index;
+			}
+		}
+		return -1;
+	}
+	int32 NodeTree::FindInsertIndex(Node* node, const UpdateOrder& order, bool afterDescendants) {
+		// The first ordered node after the given one in depth-first order takes the place.
+		if (!afterDescendants) {
+			for (Node* child : node->children) {
+				int32 index = FindFirstIndex(child, order);
+				if (index >= 0) {
+					return index;
+				}
+			}
+		}
+		for (Node* current = node; current->parent != nullptr; current = current->parent) {
+			Node* parent = current->parent;
+			for (int32 i = current->index + 1; i < parent->children.GetCount(); i += 1) {
+				int32 index = FindFirstIndex(parent->children[i], order);
+				if (index >= 0) {
+					return index;
+				}
+			}
+		}
+		return order.nodes.GetCount();
+	}
+	void NodeTree::InsertNodes(UpdateOrder& order, int32 at, const List<Node*>& nodes) {
+		int32 count = nodes.GetCount();
+		int32 oldCount = order.nodes.GetCount();
+		order.nodes.RequireCapacity(oldCount + count);
+		for (int32 i = 0; i < count; i += 1) {
+			order.nodes.Add(nullptr);
+		}
+		for (int32 i = oldCount - 1; i >= at; i -= 1) {
+			order.nodes[i + count] = order.nodes[i];
+		}
+		for (int32 i = 0; i < count; i += 1) {
+			order.nodes[at + i] = nodes[i];
+		}
+		for (int32 i = at; i < order.nodes.GetCount(); i += 1) {
+			order.nodes[i]->*(order.index) = i;
+		}
+		// Nodes inserted before the cursor wait for the next frame.
+		if (order.cursor >= 0 && at < order.cursor) {
+			order.cursor += count;
+		}
+	}
+	void NodeTree::RemoveNodes(UpdateOrder& order, int32 at, int32 count) {
+		for (int32 i = at; i < at + count; i += 1) {
+			order.nodes[i]->*(order.index) = -1;
+		}
+		int32 newCount = order.nodes.GetCount() - count;
+		for (int32 i = at; i < newCount; i += 1) {
+			order.nodes[i] = order.nodes[i + count];
+			order.nodes[i]->*(order.index) = i;
+		}
+		while (order.nodes.GetCount() > newCount) {
+			order.nodes.RemoveAt(order.nodes.GetCount() - 1);
+		}
+		if (order.cursor >= 0) {
+			if (at + count <= order.cursor) {
+				order.cursor -= count;
+			} else if (at < order.cursor) {
+				order.cursor = at;
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -2,8 +2,14 @@
 
 #include "Engine/Application/AppLoop.h"
 #include "Engine/Application/Node/Node.h"
+#include "Engine/Application/Node/TransformHierarchy.h"
+#include "Engine/Application/Node/SpatialIndex2D.h"
+#include "Engine/Application/Node/SpatialIndex3D.h"
+#include "Engine/System/Thread/ThreadUtil.h"
 
 namespace Engine{
+	class JobSystem;
+
 	/// @brief Default AppLoop of the engine. Manages a tree of game nodes.\n
 	/// Only the nodes that are joined in the tree are active.
 	class NodeTree final:public AppLoop {
@@ -12,10 +18,12 @@ namespace Engine{
 	public:
 		using RootType = Node;
 		NodeTree();
+		~NodeTree();
 
 		void OnStart() override;
 		void OnUpdate(const Time& time) override;
 		void OnPhysicsUpdate(const Time& time) override;
+		void OnInput(const InputEvent& event) override;
 
 		void OnStop() override;
 		bool IsRunning() const override;
@@ -23,9 +31,209 @@ namespace Engine{
 		RootType* GetRoot() const;
 
 		void RequestStop();
+		/// @brief Stop once every window is closed, the default. Turned off on start when the tree runs without windows.
+		void SetStopWhenNoWindow(bool stop);
+		bool IsStopWhenNoWindow() const;
+
+		/// @brief Count of nodes in the tree with OnUpdate() enabled.
+		int32 GetUpdateNodeCount() const;
+		/// @brief Count of nodes in the tree with OnPhysicsUpdate() enabled.
+		int32 GetPhysicsUpdateNodeCount() const;
+
+		/// @brief Update the nodes of a group once every given frames, see Node::SetUpdateGroup().\n
+		/// The delta passed is the time elapsed since the nodes were last updated.
+		/// @param frames 1 updates every frame, like the default group.
+		/// @param sliced Spread the nodes over the frames instead of updating all of them together, every frame updates every frames-th node of the group.
+		void SetUpdateGroupInterval(const StringName& group, int32 frames, bool sliced = false);
+		/// @brief Groups are updated in the order of their priority, lowest first.\n
+		/// The default group has priority 0, groups of the same priority are updated in the order they were first used.
+		void SetUpdateGroupPriority(const StringName& group, int32 priority);
+		/// @brief Count of nodes in the tree with OnUpdate() enabled in the given group.
+		int32 GetUpdateGroupNodeCount(const StringName& group) const;
+
+		/// @brief Update the thread-safe nodes and the independent subtrees on the workers of the job system, see Node::SetUpdateThreadSafe().\n
+		/// Runs of them next to each other in the update order are updated together, the other nodes still update in order on the calling thread between the runs.\n
+		/// Structural changes made meanwhile are deferred until the run finishes, then applied in the order they were made on each thread.
+		/// @param jobSystem nullptr to update everything on the calling thread, the default.
+		void SetParallelUpdate(JobSystem* jobSystem);
+		JobSystem* GetParallelUpdate() const;
+		/// @brief Check if nodes are updating on the workers right now.
+		bool IsUpdatingInParallel() const;
+
+		/// @brief Time the callbacks of every node, read with Node::GetLastFrameUpdateNanoseconds() and Node::GetTreeCostFormated().\n
+		/// Off by default, it takes two timestamps per callback.
+		void SetCostTracking(bool tracking);
+		bool IsCostTracking() const;
+
+		/// @brief Apply the changes queued by Node::AddChildDeferred(), Node::RemoveChildDeferred() and Node::QueueFree(), in the order they were queued with the frees last.\n
+		/// Called once the frame has updated. The update orders are rebuilt once for the whole batch instead of per change.\n
+		/// Changes queued while applying, such as children spawned in OnReady(), are applied in the same call.
+		void FlushQueuedChanges();
+		/// @brief Count of changes waiting for FlushQueuedChanges().
+		int32 GetQueuedChangeCount() const;
+
+		/// @brief The transforms of the nodes in the tree, brought up to date after every update.
+		TransformHierarchy& GetTransforms();
+		const TransformHierarchy& GetTransforms() const;
+		/// @brief The global positions of the Node2Ds in the tree, brought up to date after the transforms.
+		SpatialIndex2D& GetSpatialIndex2D();
+		const SpatialIndex2D& GetSpatialIndex2D() const;
+		/// @brief The world-space bounds of the Node3Ds in the tree, brought up to date after the transforms.
+		SpatialIndex3D& GetSpatialIndex3D();
+		const SpatialIndex3D& GetSpatialIndex3D() const;
+
+		/// @brief The input events which arrived before the current frame, in order. Cleared once the frame has updated.
+		const List<InputEvent>& GetInputEvents() const;
+
+		/// @brief Increased every time a node enters, exits or is renamed in the tree.
+		uint64 GetStructureVersion() const;
+		/// @brief Results of Node::GetNodeOrNull() kept until the structure changes. Dropped as a whole past this count.
+		static inline constexpr int32 MaxCachedPaths = 4096;
 
 	private:
+		/// @brief The nodes receiving a callback in depth-first order, so updating is a walk over a flat array.\n
+		/// Kept up to date when subtrees enter or exit the tree and when nodes switch the callback.
+		struct UpdateOrder {
+			UpdateOrder(bool Node::* enabled, int32 Node::* index, bool grouped, const StringName& group = StringName()) :enabled(enabled), index(index), grouped(grouped), group(group) {}
+
+			/// @brief Check if the node belongs in this order.
+			bool Accepts(const Node* node) const;
+			/// @brief The position of the node in this order, -1 when it isn't in it.
+			int32 IndexOf(const Node* node) const;
+
+			List<Node*> nodes{};
+			bool Node::* enabled;
+			int32 Node::* index;
+			// Only holds the nodes of the group.
+			bool grouped;
+			StringName group;
+			// The next position to visit while running the callbacks, -1 otherwise.
+			int32 cursor = -1;
+		};
+		/// @brief The nodes updating at the same rate, see SetUpdateGroupInterval().
+		struct UpdateGroup {
+			UpdateGroup(const StringName& name) :name(name), order(&Node::updateEnabled, &Node::updateOrderIndex, true, name) {}
+
+			StringName name;
+			int32 priority = 0;
+			int32 interval = 1;
+			bool sliced = false;
+			int32 frame = 0;
+			// Time elapsed since each slice was updated, a single one when not sliced.
+			List<float> deltas{};
+			UpdateOrder order;
+		};
+
+		friend class Node;
+		void OnSubtreeEntered(Node* node);
+		void OnSubtreeExiting(Node* node);
+		void OnNodeUpdateChanged(Node* node, bool physics);
+		void OnNodeUpdateGroupChanging(Node* node);
+		void OnStructureChanged();
+
+		struct PathCacheKey {
+			const Node* origin = nullptr;
+			NodePath path{};
+
+			int32 GetHashCode() const;
+			bool operator==(const PathCacheKey& obj) const;
+		};
+		/// @brief Resolve the path from the origin node through the cache.
+		Node* ResolvePath(const Node* origin, const NodePath& path);
+
+		/// @brief A structural change made while updating in parallel.
+		struct DeferredChange {
+			enum class Kind :byte {
+				AddChild,
+				RemoveChild,
+				SetName,
+				SetUpdateGroup,
+				UpdateChanged,
+				PhysicsUpdateChanged,
+				Free
+			};
+			Kind kind;
+			Node* target = nullptr;
+			Node* node = nullptr;
+			int32 index = -1;
+			String name{};
+			StringName group{};
+		};
+		void DeferAddChild(Node* parent, Node* node, int32 index);
+		void DeferRemoveChild(Node* parent, Node* child);
+		void DeferSetName(Node* node, const String& name);
+		void DeferSetUpdateGroup(Node* node, const StringName& group);
+		void DeferUpdateChanged(Node* node, bool physics);
+		void Defer(const DeferredChange& change);
+		void ApplyDeferredChanges();
+		void QueueAddChild(Node* parent, Node* node, int32 index);
+		void QueueRemoveChild(Node* parent, Node* child);
+		void QueueFree(Node* node);
+		void Queue(const DeferredChange& change);
+		/// @brief Take the nodes of an exiting subtree out of the orders without moving the others, the orders are rebuilt afterwards.
+		void DropExiting(const List<Node*>& exiting);
+		/// @brief Update the next run of thread-safe nodes and independent subtrees from the cursor on the workers.
+		void RunParallelBatch(UpdateOrder& order, float delta, int32 stride);
+
+		/// @brief Add the time since the begin timestamp to the cost of the node in the current frame.
+		void RecordCost(Node* node, uint64 begin) const;
+		/// @brief Run the callback for every stride-th node from the first.
+		void Run(UpdateOrder& order, void (Node::* callback)(float), float delta, int32 first = 0, int32 stride = 1);
+		void RunGroup(UpdateGroup& group, float delta);
+		UpdateGroup& GetOrCreateGroup(const StringName& name);
+		UpdateGroup* FindGroup(const StringName& name) const;
+		/// @brief Insert the group among the others by its priority.
+		void PlaceGroup(UpdateGroup* group);
+		void RebuildOrders();
+		static void InsertEntered(UpdateOrder& order, Node* node, const List<Node*>& entered, List<Node*>& block);
+		static void RemoveExiting(UpdateOrder& order, const List<Node*>& exiting);
+		static void CollectUntracked(Node* node, List<Node*>& result, bool& foundTracked);
+		static void CollectSubtree(Node* node, List<Node*>& result);
+		static int32 FindFirstIndex(Node* node, const UpdateOrder& order);
+		static int32 FindInsertIndex(Node* node, const UpdateOrder& order, bool afterDescendants);
+		static void InsertNodes(UpdateOrder& order, int32 at, const List<Node*>& nodes);
+		static void RemoveNodes(UpdateOrder& order, int32 at, int32 count);
+		/// @brief Update the transforms, then move the nodes whose global transform changed in the spatial indices.
+		void UpdateTransforms();
+
+		// Sorted by priority, the default group is the one with an empty name.
+		List<UpdateGroup*> groups{};
+		// The next group to update while updating, -1 otherwise.
+		int32 groupCursor = -1;
+		// Physics updates run at a fixed rate, so they aren't grouped.
+		UpdateOrder physicsUpdateOrder{ &Node::physicsUpdateEnabled, &Node::physicsUpdateOrderIndex, false };
+		// A subtree entered with nodes already tracked inside, the orders are rebuilt before the next update.
+		bool ordersDirty = false;
+
+		uint64 structureVersion = 0;
+		// Valid for pathCacheVersion only, cleared on the first lookup after the structure changed.
+		FlatDictionary<PathCacheKey, Node*> pathCache{};
+		uint64 pathCacheVersion = 0;
+
+		JobSystem* parallelJobSystem = nullptr;
+		bool updatingInParallel = false;
+		Mutex deferredChangesMutex;
+		List<DeferredChange> deferredChanges{};
+		// Guarded by deferredChangesMutex too, nodes may queue changes while updating in parallel.
+		List<DeferredChange> queuedChanges{};
+		bool applyingQueuedChanges = false;
+		// Kept between batches so they stop allocating.
+		List<Node*> batchNodes{};
+		// Where each unit of the batch starts in batchNodes, and the end of the last one.
+		List<int32> batchUnits{};
+
+		TransformHierarchy transforms{};
+		SpatialIndex2D spatialIndex2D{};
+		SpatialIndex3D spatialIndex3D{};
+		// Kept between updates so it stops allocating.
+		List<int32> movedSlots{};
+
+		bool costTracking = false;
+		// Moves on once every node has updated, the costs of nodes measured in an older frame are stale.
+		uint64 costFrame = 1;
+
 		bool running = false;
+		List<InputEvent> inputEvents{};
 
 		bool stopWhenNoWindow = true;
 
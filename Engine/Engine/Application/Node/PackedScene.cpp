@@ -0,0 +1,564 @@
+#include "Engine/Application/Node/PackedScene.h"
+#include "Engine/Application/Node/Node.h"
+#include "Engine/System/Object/Reflection.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+#include "Engine/System/Stream.h"
+#include "Engine/System/Debug.h"
+#include <bit>
+#include <cstring>
+
+namespace Engine {
+	namespace {
+		// Everything is stored in little endian, whichever the platform.
+		void WriteUInt32(List<byte>& out, uint32 value) {
+			for (int32 i = 0; i < 4; i += 1) {
+				out.Add((byte)(value >> (i * 8)));
+			}
+		}
+		void WriteUInt64(List<byte>& out, uint64 value) {
+			for (int32 i = 0; i < 8; i += 1) {
+				out.Add((byte)(value >> (i * 8)));
+			}
+		}
+		void WriteFloat(List<byte>& out, float value) {
+			WriteUInt32(out, std::bit_cast<uint32>(value));
+		}
+		void WriteString(List<byte>& out, const String& value) {
+			int32 count = value.GetCount();
+			WriteUInt32(out, (uint32)count);
+			const byte* raw = (const byte*)value.GetRawArray();
+			out.RequireCapacity(out.GetCount() + count);
+			for (int32 i = 0; i < count; i += 1) {
+				out.Add(raw[i]);
+			}
+		}
+
+		/// @brief Reads from the bytes in memory, every read past the end fails and marks the reader as failed.
+		struct Reader {
+			const byte* data;
+			int32 length;
+			int32 position = 0;
+			bool failed = false;
+
+			bool Require(int32 count) {
+				if (failed || count < 0 || length - position < count) {
+					failed = true;
+					return false;
+				}
+				return true;
+			}
+			byte ReadByte() {
+				if (!Require(1)) {
+					return 0;
+				}
+				return data[position++];
+			}
+			uint32 ReadUInt32() {
+				if (!Require(4)) {
+					return 0;
+				}
+				uint32 value = 0;
+				for (int32 i = 0; i < 4; i += 1) {
+					value |= (uint32)data[position + i] << (i * 8);
+				}
+				position += 4;
+				return value;
+			}
+			uint64 ReadUInt64() {
+				if (!Require(8)) {
+					return 0;
+				}
+				uint64 value = 0;
+				for (int32 i = 0; i < 8; i += 1) {
+					value |= (uint64)data[position + i] << (i * 8);
+				}
+				position += 8;
+				return value;
+			}
+			int32 ReadInt32() {
+				return (int32)ReadUInt32();
+			}
+			float ReadFloat() {
+				return std::bit_cast<float>(ReadUInt32());
+			}
+			/// @brief Read an element count, each element taking at least the given bytes.
+			int32 ReadCount(int32 elementSize) {
+				int32 count = ReadInt32();
+				if (count < 0 || (elementSize > 0 && count > (length - position) / elementSize)) {
+					failed = true;
+					return 0;
+				}
+				return count;
+			}
+			String ReadString() {
+				int32 count = ReadCount(1);
+				if (failed) {
+					return String::GetEmpty();
+				}
+				String result((const u8char*)(data + position), count);
+				position += count;
+				return result;
+			}
+		};
+
+		void WriteVariant(List<byte>& out, const Variant& value) {
+			Variant::Type type = value.GetType();
+			out.Add((byte)type);
+			switch (type) {
+				case Variant::Type::Bool:
+					out.Add(value.AsBool() ? 1 : 0);
+					break;
+				case Variant::Type::Int64:
+					WriteUInt64(out, (uint64)value.AsInt64());
+					break;
+				case Variant::Type::Double:
+					WriteUInt64(out, std::bit_cast<uint64>(value.AsDouble()));
+					break;
+				case Variant::Type::String:
+					WriteString(out, value.AsString());
+					break;
+				case Variant::Type::Vector2:
+				{
+					Vector2 v = value.AsVector2();
+					WriteFloat(out, v.x);
+					WriteFloat(out, v.y);
+					break;
+				}
+				case Variant::Type::PackedByteArray:
+				{
+					PackedByteArray array = value.AsPackedByteArray();
+					WriteUInt32(out, (uint32)array.GetCount());
+					for (byte element : array) {
+						out.Add(element);
+					}
+					break;
+				}
+				case Variant::Type::PackedInt64Array:
+				{
+					PackedInt64Array array = value.AsPackedInt64Array();
+					WriteUInt32(out, (uint32)array.GetCount());
+					for (int64 element : array) {
+						WriteUInt64(out, (uint64)element);
+					}
+					break;
+				}
+				case Variant::Type::PackedFloat32Array:
+				{
+					PackedFloat32Array array = value.AsPackedFloat32Array();
+					WriteUInt32(out, (uint32)array.GetCount());
+					for (float element : array) {
+						WriteFloat(out, element);
+					}
+					break;
+				}
+				case Variant::Type::PackedVector2Array:
+				{
+					PackedVector2Array array = value.AsPackedVector2Array();
+					WriteUInt32(out, (uint32)array.GetCount());
+					for (const Vector2& element : array) {
+						WriteFloat(out, element.x);
+						WriteFloat(out, element.y);
+					}
+					break;
+				}
+				default:
+					// Null, and objects which aren't stored.
+					break;
+			}
+		}
+		Variant ReadVariant(Reader& reader) {
+			Variant::Type type = (Variant::Type)reader.ReadByte();
+			switch (type) {
+				case Variant::Type::Null:
+					return Variant();
+				case Variant::Type::Bool:
+					return Variant(reader.ReadByte() != 0);
+				case Variant::Type::Int64:
+					return Variant((int64)reader.ReadUInt64());
+				case Variant::Type::Double:
+					return Variant(std::bit_cast<double>(reader.ReadUInt64()));
+				case Variant::Type::String:
+					return Variant(reader.ReadString());
+				case Variant::Type::Vector2:
+				{
+					float x = reader.ReadFloat();
+					float y = reader.ReadFloat();
+					return Variant(Vector2(x, y));
+				}
+				case Variant::Type::PackedByteArray:
+				{
+					PackedByteArray array;
+					array.Resize(reader.ReadCount(1));
+					if (!reader.failed && array.GetCount() > 0) {
+						std::memcpy(array.GetDataForWrite(), reader.data + reader.position, array.GetCount());
+						reader.position += array.GetCount();
+					}
+					return Variant(array);
+				}
+				case Variant::Type::PackedInt64Array:
+				{
+					PackedInt64Array array;
+					array.Resize(reader.ReadCount(8));
+					int64* elements = array.GetDataForWrite();
+					for (int32 i = 0; i < array.GetCount(); i += 1) {
+						elements[i] = (int64)reader.ReadUInt64();
+					}
+					return Variant(array);
+				}
+				case Variant::Type::PackedFloat32Array:
+				{
+					PackedFloat32Array array;
+					array.Resize(reader.ReadCount(4));
+					float* elements = array.GetDataForWrite();
+					for (int32 i = 0; i < array.GetCount(); i += 1) {
+						elements[i] = reader.ReadFloat();
+					}
+					return Variant(array);
+				}
+				case Variant::Type::PackedVector2Array:
+				{
+					PackedVector2Array array;
+					array.Resize(reader.ReadCount(8));
+					Vector2* elements = array.GetDataForWrite();
+					for (int32 i = 0; i < array.GetCount(); i += 1) {
+						float x = reader.ReadFloat();
+						float y = reader.ReadFloat();
+						elements[i] = Vector2(x, y);
+					}
+					return Variant(array);
+				}
+				default:
+					reader.failed = true;
+					return Variant();
+			}
+		}
+
+		/// @brief The properties stored for the nodes of a class, and their values on a freshly constructed node.
+		struct ClassInfo {
+			int32 index = -1;
+			List<ReflectionProperty*> properties{};
+			List<Variant> defaults{};
+			// The index in the property table for each property, -1 until a node uses it.
+			List<int32> tableIndices{};
+		};
+
+		void CollectDepthFirst(const Node* node, int32 parent, List<const Node*>& order, List<int32>& parents) {
+			int32 index = order.GetCount();
+			order.Add(node);
+			parents.Add(parent);
+			for (int32 i = 0; i < node->GetChildrenCount(); i += 1) {
+				CollectDepthFirst(node->GetChildByIndex(i), index, order, parents);
+			}
+		}
+	}
+
+	ResultCode PackedScene::Pack(const Node* root) {
+		Clear();
+		ERR_ASSERT(root != nullptr, u8"root is nullptr.", return ResultCode::InvalidArgument);
+
+		List<const Node*> order;
+		List<int32> parents;
+		CollectDepthFirst(root, -1, order, parents);
+
+		FlatDictionary<StringName, int32> nameIndices;
+		auto addName = [this, &nameIndices](const StringName& name) {
+			int32 index = -1;
+			if (!nameIndices.TryGet(name, index)) {
+				index = names.GetCount();
+				names.Add(name);
+				nameIndices.Add(name, index);
+			}
+			return index;
+		};
+		// By the ids of the classes.
+		FlatDictionary<int32, ClassInfo*> classInfos;
+		List<ClassInfo*> ownedInfos;
+		ResultCode result = ResultCode::OK;
+
+		nodes.RequireCapacity(order.GetCount());
+		for (int32 i = 0; i < order.GetCount() && result == ResultCode::OK; i += 1) {
+			const Node* node = order[i];
+			ReflectionClass* reflectionClass = node->GetReflectionClass();
+
+			ClassInfo* info = nullptr;
+			if (!classInfos.TryGet(reflectionClass->GetId(), info)) {
+				Object* sample = reflectionClass->Instantiate();
+				if (sample == nullptr) {
+					ERR_MSG(u8"A node has a class which can't be instantiated, see REFLECTION_CLASS_CONSTRUCTIBLE().");
+					result = ResultCode::NotSupported;
+					break;
+				}
+				info = MEMNEW(ClassInfo);
+				ownedInfos.Add(info);
+				classInfos.Add(reflectionClass->GetId(), info);
+				info->index = classNames.GetCount();
+				classNames.Add(addName(StringName(reflectionClass->GetName())));
+				resolvedClasses.Add(reflectionClass);
+				// The properties the class sees, its own ones first.
+				for (ReflectionClass* current = reflectionClass; current != nullptr; current = current->GetParent()) {
+					for (int32 j = 0; j < current->GetPropertyCount(); j += 1) {
+						ReflectionProperty* property = current->GetPropertyAt(j);
+						if (reflectionClass->GetProperty(property->GetName()) != property || !property->CanGet() || !property->CanSet()) {
+							continue;
+						}
+						Variant value;
+						if (property->Get(sample, value) != ResultCode::OK) {
+							continue;
+						}
+						info->properties.Add(property);
+						info->defaults.Add(Memory::Move(value));
+						info->tableIndices.Add(-1);
+					}
+				}
+				MEMDEL(sample);
+			}
+
+			NodeData data;
+			data.classIndex = info->index;
+			data.parent = parents[i];
+			StringName name = node->GetName();
+			if (!name.GetString().StartsWith(STRING_LITERAL("@@"))) {
+				data.nameIndex = addName(name);
+			}
+			for (int32 j = 0; j < info->properties.GetCount(); j += 1) {
+				ValueData value;
+				if (info->properties[j]->Get(node, value.value) != ResultCode::OK || !IsValueSupported(value.value.GetType()) || value.value == info->defaults[j]) {
+					continue;
+				}
+				if (info->tableIndices[j] < 0) {
+					PropertyData property;
+					property.classIndex = info->index;
+					property.nameIndex = addName(info->properties[j]->GetName());
+					info->tableIndices[j] = properties.GetCount();
+					properties.Add(property);
+					resolvedProperties.Add(info->properties[j]);
+				}
+				value.propertyIndex = info->tableIndices[j];
+				values.Add(Memory::Move(value));
+				data.valueCount += 1;
+			}
+			nodes.Add(data);
+		}
+
+		for (ClassInfo* info : ownedInfos) {
+			MEMDEL(info);
+		}
+		if (result != ResultCode::OK) {
+			Clear();
+		}
+		return result;
+	}
+
+	Node* PackedScene::Instantiate() const {
+		if (nodes.GetCount() <= 0) {
+			return nullptr;
+		}
+		ERR_ASSERT(resolvedClasses.GetCount() == classNames.GetCount() && resolvedProperties.GetCount() == properties.GetCount(), u8"The scene isn't resolved.", return nullptr);
+
+		// The nodes of each class are created together, then taken in scene order.
+		List<int32> next{};
+		next.SetCount(resolvedClasses.GetCount());
+		for (const NodeData& data : nodes) {
+			next[data.classIndex] += 1;
+		}
+		List<Object*> created{};
+		created.SetCount(nodes.GetCount());
+		int32 offset = 0;
+		for (int32 i = 0; i < resolvedClasses.GetCount(); i += 1) {
+			int32 count = next[i];
+			// Resolve() made sure every class is a constructible Node.
+			resolvedClasses[i]->InstantiateMany(count, created.GetRawElementPtr() + offset);
+			next[i] = offset;
+			offset += count;
+		}
+
+		List<Node*> built(nodes.GetCount());
+		int32 value = 0;
+		for (const NodeData& data : nodes) {
+			Node* node = static_cast<Node*>(created[next[data.classIndex]]);
+			next[data.classIndex] += 1;
+			if (data.nameIndex >= 0) {
+				node->SetNameUnchecked(names[data.nameIndex]);
+			}
+			for (int32 i = 0; i < data.valueCount; i += 1, value += 1) {
+				const ValueData& item = values[value];
+				resolvedProperties[item.propertyIndex]->Set(node, item.value);
+			}
+			if (data.parent >= 0) {
+				built[data.parent]->AddChild(node);
+			}
+			built.Add(node);
+		}
+		return built[0];
+	}
+
+	ResultCode PackedScene::Save(Stream* stream) const {
+		ERR_ASSERT(stream != nullptr && stream->CanWrite(), u8"stream is not writable.", return ResultCode::InvalidStream);
+		List<byte> data;
+		Serialize(data);
+		return stream->WriteBytes(data);
+	}
+	ResultCode PackedScene::Load(Stream* stream) {
+		ERR_ASSERT(stream != nullptr && stream->CanRead() && stream->CanRandomAccess(), u8"stream must be readable and capable of random access.", return ResultCode::InvalidStream);
+		int64 length = stream->GetLength() - stream->GetPosition();
+		ERR_ASSERT(length >= 0 && length <= 0x7FFFFFFF, u8"stream is too large.", return ResultCode::InvalidStream);
+		List<byte> data((int32)length);
+		int32 read = stream->ReadBytes((int32)length, data);
+		if (read != length) {
+			return ResultCode::InvalidStream;
+		}
+		return Deserialize(data.GetRawElementPtr(), read);
+	}
+
+	void PackedScene::Serialize(List<byte>& result) const {
+		WriteUInt32(result, Magic);
+		WriteUInt32(result, FormatVersion);
+
+		WriteUInt32(result, (uint32)names.GetCount());
+		for (const StringName& name : names) {
+			WriteString(result, name.GetString());
+		}
+		WriteUInt32(result, (uint32)classNames.GetCount());
+		for (int32 name : classNames) {
+			WriteUInt32(result, (uint32)name);
+		}
+		WriteUInt32(result, (uint32)properties.GetCount());
+		for (const PropertyData& property : properties) {
+			WriteUInt32(result, (uint32)property.classIndex);
+			WriteUInt32(result, (uint32)property.nameIndex);
+		}
+		WriteUInt32(result, (uint32)nodes.GetCount());
+		result.RequireCapacity(result.GetCount() + nodes.GetCount() * 16);
+		for (const NodeData& node : nodes) {
+			WriteUInt32(result, (uint32)node.classIndex);
+			WriteUInt32(result, (uint32)node.parent);
+			WriteUInt32(result, (uint32)node.nameIndex);
+			WriteUInt32(result, (uint32)node.valueCount);
+		}
+		WriteUInt32(result, (uint32)values.GetCount());
+		for (const ValueData& value : values) {
+			WriteUInt32(result, (uint32)value.propertyIndex);
+			WriteVariant(result, value.value);
+		}
+	}
+	ResultCode PackedScene::Deserialize(const byte* data, int32 length) {
+		Clear();
+		ERR_ASSERT(data != nullptr || length == 0, u8"data is nullptr.", return ResultCode::InvalidArgument);
+		Reader reader{ data, length };
+		if (reader.ReadUInt32() != Magic || reader.ReadUInt32() != FormatVersion) {
+			return ResultCode::InvalidStream;
+		}
+
+		int32 count = reader.ReadCount(4);
+		names.RequireCapacity(count);
+		for (int32 i = 0; i < count && !reader.failed; i += 1) {
+			// Interned once here, so building the nodes doesn't touch the strings again.
+			names.Add(StringName(reader.ReadString()));
+		}
+		count = reader.ReadCount(4);
+		for (int32 i = 0; i < count && !reader.failed; i += 1) {
+			int32 name = reader.ReadInt32();
+			if (name < 0 || name >= names.GetCount()) {
+				reader.failed = true;
+			}
+			classNames.Add(name);
+		}
+		count = reader.ReadCount(8);
+		for (int32 i = 0; i < count && !reader.failed; i += 1) {
+			PropertyData property;
+			property.classIndex = reader.ReadInt32();
+			property.nameIndex = reader.ReadInt32();
+			if (property.classIndex < 0 || property.classIndex >= classNames.GetCount() || property.nameIndex < 0 || property.nameIndex >= names.GetCount()) {
+				reader.failed = true;
+			}
+			properties.Add(property);
+		}
+		count = reader.ReadCount(16);
+		nodes.RequireCapacity(count);
+		int32 valueCount = 0;
+		for (int32 i = 0; i < count && !reader.failed; i += 1) {
+			NodeData node;
+			node.classIndex = reader.ReadInt32();
+			node.parent = reader.ReadInt32();
+			node.nameIndex = reader.ReadInt32();
+			node.valueCount = reader.ReadInt32();
+			// Only the first node is a root, the others come after their parents.
+			bool parentValid = i == 0 ? node.parent == -1 : (node.parent >= 0 && node.parent < i);
+			if (!parentValid || node.classIndex < 0 || node.classIndex >= classNames.GetCount() || node.nameIndex < -1 || node.nameIndex >= names.GetCount() || node.valueCount < 0) {
+				reader.failed = true;
+			}
+			valueCount += node.valueCount;
+			nodes.Add(node);
+		}
+		count = reader.ReadCount(5);
+		if (count != valueCount) {
+			reader.failed = true;
+		}
+		values.RequireCapacity(count);
+		for (int32 i = 0; i < count && !reader.failed; i += 1) {
+			ValueData value;
+			value.propertyIndex = reader.ReadInt32();
+			if (value.propertyIndex < 0 || value.propertyIndex >= properties.GetCount()) {
+				reader.failed = true;
+			}
+			value.value = ReadVariant(reader);
+			values.Add(Memory::Move(value));
+		}
+
+		if (reader.failed) {
+			Clear();
+			return ResultCode::InvalidStream;
+		}
+		ResultCode result = Resolve();
+		if (result != ResultCode::OK) {
+			Clear();
+		}
+		return result;
+	}
+
+	int32 PackedScene::GetNodeCount() const {
+		return nodes.GetCount();
+	}
+	bool PackedScene::IsEmpty() const {
+		return nodes.GetCount() <= 0;
+	}
+	void PackedScene::Clear() {
+		names.Clear();
+		classNames.Clear();
+		properties.Clear();
+		nodes.Clear();
+		values.Clear();
+		resolvedClasses.Clear();
+		resolvedProperties.Clear();
+	}
+
+	ResultCode PackedScene::Resolve() {
+		ReflectionClass* nodeClass = Node::GetReflectionClassStatic();
+		resolvedClasses.RequireCapacity(classNames.GetCount());
+		for (int32 name : classNames) {
+			ReflectionClass* reflectionClass = Reflection::GetClass(names[name].GetString());
+			if (reflectionClass == nullptr || !reflectionClass->IsChildOf(nodeClass)) {
+				ERR_MSG(u8"A class of the scene doesn't exist or isn't a Node.");
+				return ResultCode::NotFound;
+			}
+			if (reflectionClass->GetConstructor() == nullptr || !reflectionClass->IsInstantiatable()) {
+				ERR_MSG(u8"A class of the scene can't be instantiated, see REFLECTION_CLASS_CONSTRUCTIBLE().");
+				return ResultCode::NotSupported;
+			}
+			resolvedClasses.Add(reflectionClass);
+		}
+		resolvedProperties.RequireCapacity(properties.GetCount());
+		for (const PropertyData& property : properties) {
+			ReflectionProperty* resolved = resolvedClasses[property.classIndex]->GetProperty(names[property.nameIndex]);
+			if (resolved == nullptr || !resolved->CanSet()) {
+				ERR_MSG(u8"A property of the scene doesn't exist or can't be set.");
+				return ResultCode::NotFound;
+			}
+			resolvedProperties.Add(resolved);
+		}
+		return ResultCode::OK;
+	}
+	bool PackedScene::IsValueSupported(Variant::Type type) {
+		return type != Variant::Type::Object && type < Variant::Type::End;
+	}
+}
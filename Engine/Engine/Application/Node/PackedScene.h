@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/String.h"
+#include "Engine/System/StringName.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Object/Variant.h"
+
+namespace Engine {
+	class Node;
+	class Stream;
+	class ReflectionClass;
+	class ReflectionProperty;
+
+	/// @brief A node tree stored as flat arrays, so it can be saved and built again without any code.\n
+	/// Nodes are kept in depth-first order with the index of their parent, their class and name point into tables shared by every node.
+	/// Properties point into a table of the properties used, each resolved through reflection once per scene instead of once per node.\n
+	/// Only properties which can be got and set and differ from the ones of a freshly constructed node are stored.
+	/// Classes need REFLECTION_CLASS_CONSTRUCTIBLE() to be instantiated.
+	class PackedScene final {
+	public:
+		/// @brief "PSCN" in little endian.
+		static inline constexpr uint32 Magic = 0x4E435350;
+		static inline constexpr uint32 FormatVersion = 1;
+
+		/// @brief Store the node and everything under it, replacing the current content.
+		/// @return NotSupported if a node has a class which can't be instantiated, nothing is stored then.
+		ResultCode Pack(const Node* root);
+		/// @brief Build the stored tree in one pass over the nodes.
+		/// @return The root of the new tree, not in any parent. nullptr if the scene is empty.
+		Node* Instantiate() const;
+
+		/// @brief Write the scene in one go.
+		ResultCode Save(Stream* stream) const;
+		/// @brief Read the rest of the stream in one go and resolve the classes and properties, replacing the current content.
+		/// @return InvalidStream if the data is broken, NotFound if a class or property doesn't exist anymore.
+		ResultCode Load(Stream* stream);
+		/// @brief The same as Save() and Load() but on bytes in memory.
+		void Serialize(List<byte>& result) const;
+		ResultCode Deserialize(const byte* data, int32 length);
+
+		int32 GetNodeCount() const;
+		bool IsEmpty() const;
+		void Clear();
+
+	private:
+		struct NodeData {
+			int32 classIndex = -1;
+			// -1 for the root, parents always come before their children.
+			int32 parent = -1;
+			// -1 for auto names, which are generated again on instantiation.
+			int32 nameIndex = -1;
+			int32 valueCount = 0;
+		};
+		struct PropertyData {
+			int32 classIndex = -1;
+			int32 nameIndex = -1;
+		};
+		struct ValueData {
+			int32 propertyIndex = -1;
+			Variant value{};
+		};
+
+		/// @brief Look the classes and properties up, after they were read.
+		ResultCode Resolve();
+		static bool IsValueSupported(Variant::Type type);
+
+		List<StringName> names{};
+		List<int32> classNames{};
+		List<PropertyData> properties{};
+		List<NodeData> nodes{};
+		// Laid out node by node, NodeData::valueCount values each.
+		List<ValueData> values{};
+
+		// Resolved from the tables above.
+		List<ReflectionClass*> resolvedClasses{};
+		List<ReflectionProperty*> resolvedProperties{};
+	};
+}
@@ -0,0 +1,273 @@
+#include "Engine/Application/Node/SpatialIndex2D.h"
+#include "Engine/Application/Node/Node2D.h"
+#include "Engine/Application/Node/TransformHierarchy.h"
+#include "Engine/System/Debug.h"
+
+namespace Engine {
+	SpatialIndex2D::SpatialIndex2D(float cellSize) :cellSize(cellSize) {
+		ERR_ASSERT(cellSize > 0, u8"cellSize must be positive.", this->cellSize = DefaultCellSize);
+	}
+
+	float SpatialIndex2D::GetCellSize() const {
+		return cellSize;
+	}
+	void SpatialIndex2D::SetCellSize(float cellSize) {
+		ERR_ASSERT(cellSize > 0, u8"cellSize must be positive.", return);
+		this->cellSize = cellSize;
+		cells.Clear();
+		cellIndices.Clear();
+		for (int32 i = 0; i < entries.GetCount(); i += 1) {
+			Place(i);
+		}
+	}
+
+	void SpatialIndex2D::Update(const TransformHierarchy& transforms, const List<int32>& movedSlots) {
+		const TransformMatrix* globals = transforms.GetGlobals();
+		for (int32 slot : movedSlots) {
+			Node* node = transforms.GetNode(slot);
+			if (node == nullptr || !node->transformPlanar) {
+				continue;
+			}
+			Vector2 position(globals[slot].matrix[3][0], globals[slot].matrix[3][1]);
+			if (node->spatialEntry < 0) {
+				Entry entry{};
+				entry.node = static_cast<Node2D*>(node);
+				entry.position = position;
+				node->spatialEntry = entries.GetCount();
+				entries.Add(entry);
+				Place(node->spatialEntry);
+				continue;
+			}
+			Entry& entry = entries[node->spatialEntry];
+			entry.position = position;
+			const Cell& cell = cells[entry.cell];
+			if (cell.x != ToCellCoordinate(position.x) || cell.y != ToCellCoordinate(position.y)) {
+				Unplace(node->spatialEntry);
+				Place(node->spatialEntry);
+			}
+		}
+	}
+	void SpatialIndex2D::Remove(Node* node) {
+		ERR_ASSERT(node != nullptr, u8"node is nullptr.", return);
+		int32 index = node->spatialEntry;
+		if (index < 0) {
+			return;
+		}
+		Unplace(index);
+		node->spatialEntry = -1;
+		int32 last = entries.GetCount() - 1;
+		if (index != last) {
+			entries[index] = entries[last];
+			Entry& moved = entries[index];
+			moved.node->spatialEntry = index;
+			cells[moved.cell].entries[moved.slot] = index;
+		}
+		entries.RemoveAt(last);
+	}
+
+	int32 SpatialIndex2D::GetCount() const {
+		return entries.GetCount();
+	}
+	int32 SpatialIndex2D::GetCellCount() const {
+		return cells.GetCount();
+	}
+
+	void SpatialIndex2D::QueryRect(const Vector2& min, const Vector2& max, List<Node2D*>& result) const {
+		if (min.x > max.x || min.y > max.y) {
+			return;
+		}
+		VisitCells(ToCellCoordinate(min.x), ToCellCoordinate(min.y), ToCellCoordinate(max.x), ToCellCoordinate(max.y), [&](const Cell& cell) {
+			for (int32 index : cell.entries) {
+				const Entry& entry = entries[index];
+				if (entry.position.x >= min.x && entry.position.x <= max.x && entry.position.y >= min.y && entry.position.y <= max.y) {
+					result.Add(entry.node);
+				}
+			}
+		});
+	}
+	void SpatialIndex2D::QueryRadius(const Vector2& center, float radius, List<Node2D*>& result) const {
+		if (radius < 0) {
+			return;
+		}
+		float radiusSquared = radius * radius;
+		VisitCells(ToCellCoordinate(center.x - radius), ToCellCoordinate(center.y - radius), ToCellCoordinate(center.x + radius), ToCellCoordinate(center.y + radius), [&](const Cell& cell) {
+			for (int32 index : cell.entries) {
+				const Entry& entry = entries[index];
+				if ((entry.position - center).GetLengthSquared() <= radiusSquared) {
+					result.Add(entry.node);
+				}
+			}
+		});
+	}
+	Node2D* SpatialIndex2D::QueryNearest(const Vector2& point, float maxDistance) const {
+		if (entries.GetCount() <= 0 || maxDistance < 0) {
+			return nullptr;
+		}
+		Node2D* nearest = nullptr;
+		float nearestSquared = Math::IsInfinity(maxDistance) ? Math::Infinity : maxDistance * maxDistance;
+		auto visit = [&](const Cell& cell) {
+			for (int32 index : cell.entries) {
+				const Entry& entry = entries[index];
+				float distanceSquared = (entry.position - point).GetLengthSquared();
+				if (distanceSquared <= nearestSquared) {
+					nearestSquared = distanceSquared;
+					nearest = entry.node;
+				}
+			}
+		};
+
+		int32 x = ToCellCoordinate(point.x);
+		int32 y = ToCellCoordinate(point.y);
+		// Cells of ring r are at least (r - 1) * cellSize away, search outwards until nothing closer can be left.
+		for (int32 ring = 0;; ring += 1) {
+			float reach = (ring - 1) * cellSize;
+			if (ring > 0 && (reach > maxDistance || (nearest != nullptr && reach * reach > nearestSquared))) {
+				break;
+			}
+			int64 side = 2 * (int64)ring + 1;
+			if (side * side > cells.GetCount()) {
+				// The rings cover more coordinates than there are cells, checking every cell is cheaper.
+				nearest = nullptr;
+				nearestSquared = Math::IsInfinity(maxDistance) ? Math::Infinity : maxDistance * maxDistance;
+				for (const Cell& cell : cells) {
+					visit(cell);
+				}
+				break;
+			}
+			if (ring == 0) {
+				if (const Cell* cell = FindCell(x, y)) {
+					visit(*cell);
+				}
+				continue;
+			}
+			for (int32 i = -ring; i <= ring; i += 1) {
+				if (const Cell* cell = FindCell(x + i, y - ring)) {
+					visit(*cell);
+				}
+				if (const Cell* cell = FindCell(x + i, y + ring)) {
+					visit(*cell);
+				}
+			}
+			for (int32 i = -ring + 1; i <= ring - 1; i += 1) {
+				if (const Cell* cell = FindCell(x - ring, y + i)) {
+					visit(*cell);
+				}
+				if (const Cell* cell = FindCell(x + ring, y + i)) {
+					visit(*cell);
+				}
+			}
+		}
+		return nearest;
+	}
+
+	void SpatialIndex2D::QueryRectBatch(const Vector2* mins, const Vector2* maxs, int32 count, List<Node2D*>& result, List<int32>& offsets) const {
+		ERR_ASSERT(count <= 0 || (mins != nullptr && maxs != nullptr), u8"mins or maxs is nullptr.", return);
+		offsets.RequireCapacity(offsets.GetCount() + (count > 0 ? count : 0) + 1);
+		offsets.Add(result.GetCount());
+		for (int32 i = 0; i < count; i += 1) {
+			QueryRect(mins[i], maxs[i], result);
+			offsets.Add(result.GetCount());
+		}
+	}
+	void SpatialIndex2D::QueryRadiusBatch(const Vector2* centers, int32 count, float radius, List<Node2D*>& result, List<int32>& offsets) const {
+		ERR_ASSERT(count <= 0 || centers != nullptr, u8"centers is nullptr.", return);
+		offsets.RequireCapacity(offsets.GetCount() + (count > 0 ? count : 0) + 1);
+		offsets.Add(result.GetCount());
+		for (int32 i = 0; i < count; i += 1) {
+			QueryRadius(centers[i], radius, result);
+			offsets.Add(result.GetCount());
+		}
+	}
+	void SpatialIndex2D::QueryNearestBatch(const Vector2* points, int32 count, List<Node2D*>& result, float maxDistance) const {
+		ERR_ASSERT(count <= 0 || points != nullptr, u8"points is nullptr.", return);
+		result.RequireCapacity(result.GetCount() + (count > 0 ? count : 0));
+		for (int32 i = 0; i < count; i += 1) {
+			result.Add(QueryNearest(points[i], maxDistance));
+		}
+	}
+
+	int32 SpatialIndex2D::ToCellCoordinate(float value) const {
+		// Clamped so huge or infinite positions still land in a cell instead of overflowing.
+		static constexpr float Limit = 1 << 30;
+		return (int32)Math::Clamp(Math::Floor(value / cellSize), -Limit, Limit);
+	}
+	int64 SpatialIndex2D::ToKey(int32 x, int32 y) {
+		return (int64)(((uint64)(uint32)x << 32) | (uint32)y);
+	}
+	const SpatialIndex2D::Cell* SpatialIndex2D::FindCell(int32 x, int32 y) const {
+		int32 index = -1;
+		if (!cellIndices.TryGet(ToKey(x, y), index)) {
+			return nullptr;
+		}
+		return &cells[index];
+	}
+	template<typename TFunction>
+	void SpatialIndex2D::VisitCells(int32 minX, int32 minY, int32 maxX, int32 maxY, TFunction function) const {
+		int64 area = ((int64)maxX - minX + 1) * ((int64)maxY - minY + 1);
+		if (area > cells.GetCount()) {
+			for (const Cell& cell : cells) {
+				if (cell.x >= minX && cell.x <= maxX && cell.y >= minY && cell.y <= maxY) {
+					function(cell);
+				}
+			}
+			return;
+		}
+		for (int32 y = minY; y <= maxY; y += 1) {
+			for (int32 x = minX; x <= maxX; x += 1) {
+				if (const Cell* cell = FindCell(x, y)) {
+					function(*cell);
+				}
+			}
+		}
+	}
+
+	void SpatialIndex2D::Place(int32 entry) {
+		Entry& target = entries[entry];
+		int32 x = ToCellCoordinate(target.position.x);
+		int32 y = ToCellCoordinate(target.position.y);
+		int64 key = ToKey(x, y);
+		int32 index = -1;
+		if (!cellIndices.TryGet(key, index)) {
+			index = cells.GetCount();
+			Cell cell{};
+			cell.key = key;
+			cell.x = x;
+			cell.y = y;
+			cells.Add(Memory::Move(cell));
+			cellIndices.Set(key, index);
+		}
+		Cell& cell = cells[index];
+		target.cell = index;
+		target.slot = cell.entries.GetCount();
+		cell.entries.Add(entry);
+	}
+	void SpatialIndex2D::Unplace(int32 entry) {
+		Entry& target = entries[entry];
+		int32 index = target.cell;
+		Cell& cell = cells[index];
+		int32 lastSlot = cell.entries.GetCount() - 1;
+		if (target.slot != lastSlot) {
+			int32 moved = cell.entries[lastSlot];
+			cell.entries[target.slot] = moved;
+			entries[moved].slot = target.slot;
+		}
+		cell.entries.RemoveAt(lastSlot);
+		target.cell = -1;
+		target.slot = -1;
+		if (cell.entries.GetCount() > 0) {
+			return;
+		}
+
+		cellIndices.Remove(cell.key);
+		int32 lastCell = cells.GetCount() - 1;
+		if (index != lastCell) {
+			cells[index] = Memory::Move(cells[lastCell]);
+			Cell& moved = cells[index];
+			cellIndices.Set(moved.key, index);
+			for (int32 movedEntry : moved.entries) {
+				entries[movedEntry].cell = index;
+			}
+		}
+		cells.RemoveAt(lastCell);
+	}
+}
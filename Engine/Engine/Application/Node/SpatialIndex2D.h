@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+#include "Engine/System/Math/Math.h"
+#include "Engine/System/Math/Vector.h"
+
+namespace Engine {
+	class Node;
+	class Node2D;
+	class TransformHierarchy;
+
+	/// @brief A uniform grid over the global positions of the Node2Ds in a NodeTree, for finding the nodes in a region, within a radius or nearest to a point without walking the tree.\n
+	/// The tree keeps it up to date after every update from the transforms which changed, so queries see the positions as of the last update.\n
+	/// Cells are hashed by their coordinates, so the grid has no bounds and empty space costs nothing.
+	/// A cell size around the usual query radius works best.
+	class SpatialIndex2D final {
+	public:
+		static inline constexpr float DefaultCellSize = 64;
+
+		SpatialIndex2D(float cellSize = DefaultCellSize);
+		SpatialIndex2D(const SpatialIndex2D&) = delete;
+		SpatialIndex2D& operator=(const SpatialIndex2D&) = delete;
+
+		float GetCellSize() const;
+		/// @brief Put every node into the cells of the new size.
+		void SetCellSize(float cellSize);
+
+		/// @brief Add the Node2Ds among the slots and move the ones already in the index.
+		/// @param movedSlots Slots whose global transform changed, from TransformHierarchy::CollectMoved().
+		void Update(const TransformHierarchy& transforms, const List<int32>& movedSlots);
+		/// @brief Drop the node, done when it exits the tree.
+		void Remove(Node* node);
+
+		/// @brief Count of nodes in the index.
+		int32 GetCount() const;
+		/// @brief Count of cells holding at least a node.
+		int32 GetCellCount() const;
+
+		/// @brief Find the nodes positioned inside the rectangle, borders included.
+		/// @param result The nodes are appended to it, in no particular order.
+		void QueryRect(const Vector2& min, const Vector2& max, List<Node2D*>& result) const;
+		/// @brief Find the nodes within the distance of the center, borders included.
+		/// @param result The nodes are appended to it, in no particular order.
+		void QueryRadius(const Vector2& center, float radius, List<Node2D*>& result) const;
+		/// @brief Find the node nearest to the point.
+		/// @return nullptr if no node is within maxDistance.
+		Node2D* QueryNearest(const Vector2& point, float maxDistance = Math::Infinity) const;
+
+		/// @brief Run QueryRect() for every pair of corners.
+		/// @param result The nodes of every query are appended one query after another.
+		/// @param offsets Gets count + 1 entries appended, the nodes of query i are the ones from offsets[i] to offsets[i + 1].
+		void QueryRectBatch(const Vector2* mins, const Vector2* maxs, int32 count, List<Node2D*>& result, List<int32>& offsets) const;
+		/// @brief Run QueryRadius() for every center, the results are laid out like the ones of QueryRectBatch().
+		void QueryRadiusBatch(const Vector2* centers, int32 count, float radius, List<Node2D*>& result, List<int32>& offsets) const;
+		/// @brief Run QueryNearest() for every point.
+		/// @param result Gets one node per point appended, nullptr where nothing is within maxDistance.
+		void QueryNearestBatch(const Vector2* points, int32 count, List<Node2D*>& result, float maxDistance = Math::Infinity) const;
+
+	private:
+		struct Entry {
+			Node2D* node = nullptr;
+			Vector2 position{};
+			int32 cell = -1;
+			// Position in the entries of the cell.
+			int32 slot = -1;
+		};
+		struct Cell {
+			int64 key = 0;
+			int32 x = 0;
+			int32 y = 0;
+			List<int32> entries{};
+		};
+
+		int32 ToCellCoordinate(float value) const;
+		static int64 ToKey(int32 x, int32 y);
+		/// @brief nullptr if the cell holds no node.
+		const Cell* FindCell(int32 x, int32 y) const;
+		/// @brief Call the function with every non-empty cell in the range, borders included.
+		/// Walks the cells themselves instead when the range holds more coordinates than there are cells.
+		template<typename TFunction>
+		void VisitCells(int32 minX, int32 minY, int32 maxX, int32 maxY, TFunction function) const;
+		/// @brief Put the entry into the cell of its position.
+		void Place(int32 entry);
+		/// @brief Take the entry out of its cell, dropping the cell if it's left empty.
+		void Unplace(int32 entry);
+
+		float cellSize;
+		List<Entry> entries{};
+		List<Cell> cells{};
+		// Position of every cell in cells by its key.
+		FlatDictionary<int64, int32> cellIndices{};
+	};
+}
@@ -0,0 +1,639 @@
+#include "Engine/Application/Node/SpatialIndex3D.h"
+#include "Engine/Application/Node/Node3D.h"
+#include "Engine/Application/Node/TransformHierarchy.h"
+#include "Engine/System/Collection/SmallList.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Debug.h"
+#include "Engine/System/Profiler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPATIALINDEX3D_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define SPATIALINDEX3D_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Engine {
+	namespace {
+		// Deep enough for a balanced tree of any size, taller ones spill to the heap.
+		using NodeStack = SmallList<int32, 64>;
+		// Bins per axis when rebuilding.
+		constexpr int32 BinCount = 12;
+
+		float Component(const Vector3& value, int32 axis) {
+			return axis == 0 ? value.x : (axis == 1 ? value.y : value.z);
+		}
+		Vector3 Min(const Vector3& a, const Vector3& b) {
+			return Vector3(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z);
+		}
+		Vector3 Max(const Vector3& a, const Vector3& b) {
+			return Vector3(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z);
+		}
+		/// @brief Half of the surface area, only ever compared.
+		float Area(const Vector3& min, const Vector3& max) {
+			Vector3 size = max - min;
+			return size.x * size.y + size.y * size.z + size.z * size.x;
+		}
+		bool Overlaps(const Vector3& minA, const Vector3& maxA, const Vector3& minB, const Vector3& maxB) {
+			return minA.x <= maxB.x && maxA.x >= minB.x && minA.y <= maxB.y && maxA.y >= minB.y && minA.z <= maxB.z && maxA.z >= minB.z;
+		}
+		bool Contains(const Vector3& outerMin, const Vector3& outerMax, const Vector3& min, const Vector3& max) {
+			return outerMin.x <= min.x && outerMin.y <= min.y && outerMin.z <= min.z && outerMax.x >= max.x && outerMax.y >= max.y && outerMax.z >= max.z;
+		}
+		bool OverlapsSphere(const Vector3& min, const Vector3& max, const Vector3& center, float radiusSquared) {
+			Vector3 closest = Max(min, Min(center, max));
+			return (closest - center).GetLengthSquared() <= radiusSquared;
+		}
+
+		/// @brief A ray with its inverse direction, for the slab test against boxes.
+		struct Ray {
+			Ray(const Vector3& origin, const Vector3& direction) :origin(origin), direction(direction) {
+				// Axes the ray runs parallel to get infinities, which the slab test handles.
+				inverse = Vector3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+#if defined(SPATIALINDEX3D_SSE)
+				origin4 = _mm_setr_ps(origin.x, origin.y, origin.z, origin.x);
+				inverse4 = _mm_setr_ps(inverse.x, inverse.y, inverse.z, inverse.x);
+#elif defined(SPATIALINDEX3D_NEON)
+				float originValues[4] = { origin.x, origin.y, origin.z, origin.x };
+				float inverseValues[4] = { inverse.x, inverse.y, inverse.z, inverse.x };
+				origin4 = vld1q_f32(originValues);
+				inverse4 = vld1q_f32(inverseValues);
+#endif
+			}
+
+			/// @brief Find where the ray enters the box, 0 if it starts inside.
+			/// @return false if it misses the box or enters it past the limit.
+			bool Intersect(const Vector3& min, const Vector3& max, float limit, float& distance) const {
+				// The three slabs go in the first three lanes, the last one repeats x so it never changes the result.
+#if defined(SPATIALINDEX3D_SSE)
+				__m128 low = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(min.x, min.y, min.z, min.x), origin4), inverse4);
+				__m128 high = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(max.x, max.y, max.z, max.x), origin4), inverse4);
+				__m128 entering = _mm_min_ps(low, high);
+				__m128 exiting = _mm_max_ps(low, high);
+				entering = _mm_max_ps(entering, _mm_shuffle_ps(entering, entering, _MM_SHUFFLE(2, 3, 0, 1)));
+				entering = _mm_max_ps(entering, _mm_shuffle_ps(entering, entering, _MM_SHUFFLE(1, 0, 3, 2)));
+				exiting = _mm_min_ps(exiting, _mm_shuffle_ps(exiting, exiting, _MM_SHUFFLE(2, 3, 0, 1)));
+				exiting = _mm_min_ps(exiting, _mm_shuffle_ps(exiting, exiting, _MM_SHUFFLE(1, 0, 3, 2)));
+				float enter = _mm_cvtss_f32(entering);
+				float exit = _mm_cvtss_f32(exiting);
+#elif defined(SPATIALINDEX3D_NEON)
+				float minValues[4] = { min.x, min.y, min.z, min.x };
+				float maxValues[4] = { max.x, max.y, max.z, max.x };
+				float32x4_t low = vmulq_f32(vsubq_f32(vld1q_f32(minValues), origin4), inverse4);
+				float32x4_t high = vmulq_f32(vsubq_f32(vld1q_f32(maxValues), origin4), inverse4);
+				float32x4_t entering = vminq_f32(low, high);
+				float32x4_t exiting = vmaxq_f32(low, high);
+				float32x2_t enterPair = vpmax_f32(vget_low_f32(entering), vget_high_f32(entering));
+				float32x2_t exitPair = vpmin_f32(vget_low_f32(exiting), vget_high_f32(exiting));
+				float enter = vget_lane_f32(vpmax_f32(enterPair, enterPair), 0);
+				float exit = vget_lane_f32(vpmin_f32(exitPair, exitPair), 0);
+#else
+				float enter = -Math::Infinity;
+				float exit = Math::Infinity;
+				for (int32 axis = 0; axis < 3; axis += 1) {
+					float low = (Component(min, axis) - Component(origin, axis)) * Component(inverse, axis);
+					float high = (Component(max, axis) - Component(origin, axis)) * Component(inverse, axis);
+					float entering = low < high ? low : high;
+					float exiting = low < high ? high : low;
+					enter = entering > enter ? entering : enter;
+					exit = exiting < exit ? exiting : exit;
+				}
+#endif
+				// Written so a NaN from a ray grazing a face counts as a miss.
+				if (!(enter <= exit) || exit < 0 || enter > limit) {
+					return false;
+				}
+				distance = enter > 0 ? enter : 0;
+				return true;
+			}
+
+			Vector3 origin;
+			Vector3 direction;
+			Vector3 inverse;
+#if defined(SPATIALINDEX3D_SSE)
+			__m128 origin4;
+			__m128 inverse4;
+#elif defined(SPATIALINDEX3D_NEON)
+			float32x4_t origin4;
+			float32x4_t inverse4;
+#endif
+		};
+	}
+
+	SpatialIndex3D::SpatialIndex3D(float margin) :margin(margin) {
+		ERR_ASSERT(margin >= 0, u8"margin cannot be negative.", this->margin = DefaultMargin);
+	}
+
+	float SpatialIndex3D::GetMargin() const {
+		return margin;
+	}
+	void SpatialIndex3D::SetMargin(float margin) {
+		ERR_ASSERT(margin >= 0, u8"margin cannot be negative.", return);
+		this->margin = margin;
+	}
+
+	void SpatialIndex3D::Update(const TransformHierarchy& transforms, const List<int32>& movedSlots) {
+		const TransformMatrix* globals = transforms.GetGlobals();
+		Vector3 enlarge(margin, margin, margin);
+		for (int32 slot : movedSlots) {
+			Node* node = transforms.GetNode(slot);
+			// The nodes with a transform that isn't planar are Node3Ds.
+			if (node == nullptr || node->transformPlanar) {
+				continue;
+			}
+			Node3D* target = static_cast<Node3D*>(node);
+			// The local box through the global transform, the extent takes the absolute value of every axis.
+			const float(*matrix)[4] = globals[slot].matrix;
+			Vector3 center = target->GetBoundsCenter();
+			Vector3 extent = target->GetBoundsExtent();
+			Vector3 worldCenter(
+				center.x * matrix[0][0] + center.y * matrix[1][0] + center.z * matrix[2][0] + matrix[3][0],
+				center.x * matrix[0][1] + center.y * matrix[1][1] + center.z * matrix[2][1] + matrix[3][1],
+				center.x * matrix[0][2] + center.y * matrix[1][2] + center.z * matrix[2][2] + matrix[3][2]);
+			Vector3 worldExtent(
+				extent.x * Math::Abs(matrix[0][0]) + extent.y * Math::Abs(matrix[1][0]) + extent.z * Math::Abs(matrix[2][0]),
+				extent.x * Math::Abs(matrix[0][1]) + extent.y * Math::Abs(matrix[1][1]) + extent.z * Math::Abs(matrix[2][1]),
+				extent.x * Math::Abs(matrix[0][2]) + extent.y * Math::Abs(matrix[1][2]) + extent.z * Math::Abs(matrix[2][2]));
+			Vector3 min = worldCenter - worldExtent;
+			Vector3 max = worldCenter + worldExtent;
+
+			int32 leaf = -1;
+			if (node->spatialEntry < 0) {
+				leaf = AllocateNode();
+				Entry entry{};
+				entry.node = target;
+				entry.leaf = leaf;
+				node->spatialEntry = entries.GetCount();
+				entries.Add(entry);
+				nodes[leaf].entry = node->spatialEntry;
+			} else {
+				Entry& entry = entries[node->spatialEntry];
+				entry.min = min;
+				entry.max = max;
+				leaf = entry.leaf;
+				if (Contains(nodes[leaf].min, nodes[leaf].max, min, max)) {
+					continue;
+				}
+				RemoveLeaf(leaf);
+			}
+			Entry& entry = entries[node->spatialEntry];
+			entry.min = min;
+			entry.max = max;
+			nodes[leaf].min = min - enlarge;
+			nodes[leaf].max = max + enlarge;
+			InsertLeaf(leaf);
+		}
+	}
+	void SpatialIndex3D::Remove(Node* node) {
+		ERR_ASSERT(node != nullptr, u8"node is nullptr.", return);
+		int32 index = node->spatialEntry;
+		if (index < 0) {
+			return;
+		}
+		int32 leaf = entries[index].leaf;
+		RemoveLeaf(leaf);
+		FreeNode(leaf);
+		node->spatialEntry = -1;
+		int32 last = entries.GetCount() - 1;
+		if (index != last) {
+			entries[index] = entries[last];
+			Entry& moved = entries[index];
+			moved.node->spatialEntry = index;
+			nodes[moved.leaf].entry = index;
+		}
+		entries.RemoveAt(last);
+	}
+	void SpatialIndex3D::Rebuild() {
+		PROFILE_SCOPE("SpatialIndex3D::Rebuild");
+		nodes.Clear();
+		root = -1;
+		freeNode = -1;
+		int32 count = entries.GetCount();
+		if (count <= 0) {
+			return;
+		}
+		nodes.RequireCapacity(count * 2 - 1);
+
+		List<int32> order(count);
+		List<Vector3> centroids(count);
+		for (int32 i = 0; i < count; i += 1) {
+			order.Add(i);
+			centroids.Add((entries[i].min + entries[i].max) * 0.5f);
+		}
+		struct Range {
+			int32 begin = 0;
+			int32 end = 0;
+			int32 parent = -1;
+			bool left = false;
+		};
+		struct Bin {
+			Vector3 min{ Math::Infinity, Math::Infinity, Math::Infinity };
+			Vector3 max{ -Math::Infinity, -Math::Infinity, -Math::Infinity };
+			int32 count = 0;
+		};
+		Vector3 enlarge(margin, margin, margin);
+		List<Range> ranges{};
+		ranges.Add(Range{ 0, count, -1, false });
+		while (ranges.GetCount() > 0) {
+			Range range = ranges[ranges.GetCount() - 1];
+			ranges.RemoveAt(ranges.GetCount() - 1);
+			int32 index = AllocateNode();
+			nodes[index].parent = range.parent;
+			if (range.parent < 0) {
+				root = index;
+			} else if (range.left) {
+				nodes[range.parent].left = index;
+			} else {
+				nodes[range.parent].right = index;
+			}
+
+			if (range.end - range.begin == 1) {
+				int32 entry = order[range.begin];
+				TreeNode& leaf = nodes[index];
+				leaf.entry = entry;
+				leaf.min = entries[entry].min - enlarge;
+				leaf.max = entries[entry].max + enlarge;
+				entries[entry].leaf = index;
+				continue;
+			}
+
+			// Split along the widest axis of the centroids, at the border of bins with the lowest area times count on both sides.
+			Vector3 centroidMin = centroids[order[range.begin]];
+			Vector3 centroidMax = centroidMin;
+			for (int32 i = range.begin + 1; i < range.end; i += 1) {
+				centroidMin = Min(centroidMin, centroids[order[i]]);
+				centroidMax = Max(centroidMax, centroids[order[i]]);
+			}
+			Vector3 size = centroidMax - centroidMin;
+			int32 axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+			float low = Component(centroidMin, axis);
+			float width = Component(size, axis);
+			int32 middle = (range.begin + range.end) / 2;
+			if (width > 0) {
+				auto binOf = [&](int32 entry) {
+					int32 bin = (int32)((Component(centroids[entry], axis) - low) / width * BinCount);
+					return bin < BinCount ? bin : BinCount - 1;
+				};
+				Bin bins[BinCount]{};
+				for (int32 i = range.begin; i < range.end; i += 1) {
+					int32 entry = order[i];
+					Bin& bin = bins[binOf(entry)];
+					bin.min = Min(bin.min, entries[entry].min);
+					bin.max = Max(bin.max, entries[entry].max);
+					bin.count += 1;
+				}
+				// Cost of the right side of every border, swept from the right.
+				float rightCosts[BinCount]{};
+				Bin right{};
+				for (int32 i = BinCount - 1; i > 0; i -= 1) {
+					right.min = Min(right.min, bins[i].min);
+					right.max = Max(right.max, bins[i].max);
+					right.count += bins[i].count;
+					rightCosts[i] = right.count > 0 ? Area(right.min, right.max) * right.count : 0;
+				}
+				Bin left{};
+				float bestCost = Math::Infinity;
+				int32 bestBorder = -1;
+				for (int32 i = 1; i < BinCount; i += 1) {
+					left.min = Min(left.min, bins[i - 1].min);
+					left.max = Max(left.max, bins[i - 1].max);
+					left.count += bins[i - 1].count;
+					if (left.count == 0 || left.count == range.end - range.begin) {
+						continue;
+					}
+					float cost = Area(left.min, left.max) * left.count + rightCosts[i];
+					if (cost < bestCost) {
+						bestCost = cost;
+						bestBorder = i;
+					}
+				}
+				if (bestBorder > 0) {
+					int32 split = range.begin;
+					for (int32 i = range.begin; i < range.end; i += 1) {
+						if (binOf(order[i]) < bestBorder) {
+							int32 swapped = order[i];
+							order[i] = order[split];
+							order[split] = swapped;
+							split += 1;
+						}
+					}
+					middle = split;
+				}
+			}
+			ranges.Add(Range{ middle, range.end, index, false });
+			ranges.Add(Range{ range.begin, middle, index, true });
+		}
+		// Children are allocated after their parent, so going backwards fits every node after its children.
+		for (int32 i = nodes.GetCount() - 1; i >= 0; i -= 1) {
+			if (!nodes[i].IsLeaf()) {
+				Refit(i);
+			}
+		}
+	}
+
+	int32 SpatialIndex3D::GetCount() const {
+		return entries.GetCount();
+	}
+	int32 SpatialIndex3D::GetHeight() const {
+		return root < 0 ? 0 : nodes[root].height + 1;
+	}
+	float SpatialIndex3D::GetAreaRatio() const {
+		if (root < 0) {
+			return 0;
+		}
+		float rootArea = Area(nodes[root].min, nodes[root].max);
+		if (rootArea <= 0) {
+			return 1;
+		}
+		float total = 0;
+		for (const TreeNode& node : nodes) {
+			if (node.height >= 0) {
+				total += Area(node.min, node.max);
+			}
+		}
+		return total / rootArea;
+	}
+
+	void SpatialIndex3D::QueryBox(const Vector3& min, const Vector3& max, List<Node3D*>& result) const {
+		if (root < 0 || min.x > max.x || min.y > max.y || min.z > max.z) {
+			return;
+		}
+		NodeStack stack{};
+		stack.Add(root);
+		while (stack.GetCount() > 0) {
+			const TreeNode& node = nodes[stack[stack.GetCount() - 1]];
+			stack.RemoveAt(stack.GetCount() - 1);
+			if (!Overlaps(node.min, node.max, min, max)) {
+				continue;
+			}
+			if (node.IsLeaf()) {
+				const Entry& entry = entries[node.entry];
+				if (Overlaps(entry.min, entry.max, min, max)) {
+					result.Add(entry.node);
+				}
+				continue;
+			}
+			stack.Add(node.left);
+			stack.Add(node.right);
+		}
+	}
+	void SpatialIndex3D::QuerySphere(const Vector3& center, float radius, List<Node3D*>& result) const {
+		if (root < 0 || radius < 0) {
+			return;
+		}
+		float radiusSquared = radius * radius;
+		NodeStack stack{};
+		stack.Add(root);
+		while (stack.GetCount() > 0) {
+			const TreeNode& node = nodes[stack[stack.GetCount() - 1]];
+			stack.RemoveAt(stack.GetCount() - 1);
+			if (!OverlapsSphere(node.min, node.max, center, radiusSquared)) {
+				continue;
+			}
+			if (node.IsLeaf()) {
+				const Entry& entry = entries[node.entry];
+				if (OverlapsSphere(entry.min, entry.max, center, radiusSquared)) {
+					result.Add(entry.node);
+				}
+				continue;
+			}
+			stack.Add(node.left);
+			stack.Add(node.right);
+		}
+	}
+	bool SpatialIndex3D::Raycast(const Vector3& origin, const Vector3& direction, float maxDistance, RaycastHit3D& hit) const {
+		return CastRay(origin, direction, maxDistance, false, &hit);
+	}
+	bool SpatialIndex3D::RaycastAny(const Vector3& origin, const Vector3& direction, float maxDistance) const {
+		return CastRay(origin, direction, maxDistance, true, nullptr);
+	}
+
+	void SpatialIndex3D::RaycastBatch(const Vector3* origins, const Vector3* directions, int32 count, float maxDistance, RaycastHit3D* hits, JobSystem* jobSystem) const {
+		ERR_ASSERT(count <= 0 || (origins != nullptr && directions != nullptr && hits != nullptr), u8"origins, directions or hits is nullptr.", return);
+		auto cast = [this, origins, directions, maxDistance, hits](int32 index) {
+			hits[index] = RaycastHit3D();
+			Raycast(origins[index], directions[index], maxDistance, hits[index]);
+		};
+		if (jobSystem != nullptr && count >= ParallelBatchThreshold) {
+			jobSystem->ParallelFor(0, count, 0, cast);
+			return;
+		}
+		for (int32 i = 0; i < count; i += 1) {
+			cast(i);
+		}
+	}
+	void SpatialIndex3D::RaycastAnyBatch(const Vector3* origins, const Vector3* directions, int32 count, float maxDistance, bool* results, JobSystem* jobSystem) const {
+		ERR_ASSERT(count <= 0 || (origins != nullptr && directions != nullptr && results != nullptr), u8"origins, directions or results is nullptr.", return);
+		auto cast = [this, origins, directions, maxDistance, results](int32 index) {
+			results[index] = RaycastAny(origins[index], directions[index], maxDistance);
+		};
+		if (jobSystem != nullptr && count >= ParallelBatchThreshold) {
+			jobSystem->ParallelFor(0, count, 0, cast);
+			return;
+		}
+		for (int32 i = 0; i < count; i += 1) {
+			cast(i);
+		}
+	}
+
+	bool SpatialIndex3D::CastRay(const Vector3& origin, const Vector3& direction, float maxDistance, bool any, RaycastHit3D* hit) const {
+		float length = direction.GetLength();
+		ERR_ASSERT(length > 0, u8"direction is zero.", return false);
+		if (root < 0 || maxDistance < 0) {
+			return false;
+		}
+		Ray ray(origin, direction / length);
+		float distance = 0;
+		if (!ray.Intersect(nodes[root].min, nodes[root].max, maxDistance, distance)) {
+			return false;
+		}
+
+		float nearest = maxDistance;
+		Node3D* found = nullptr;
+		NodeStack stack{};
+		stack.Add(root);
+		while (stack.GetCount() > 0) {
+			const TreeNode& node = nodes[stack[stack.GetCount() - 1]];
+			stack.RemoveAt(stack.GetCount() - 1);
+			if (node.IsLeaf()) {
+				const Entry& entry = entries[node.entry];
+				if (ray.Intersect(entry.min, entry.max, nearest, distance)) {
+					nearest = distance;
+					found = entry.node;
+					if (any) {
+						return true;
+					}
+				}
+				continue;
+			}
+			// Visit the nearer child first, the hits found in it cut the farther one short.
+			float leftDistance = 0;
+			float rightDistance = 0;
+			bool left = ray.Intersect(nodes[node.left].min, nodes[node.left].max, nearest, leftDistance);
+			bool right = ray.Intersect(nodes[node.right].min, nodes[node.right].max, nearest, rightDistance);
+			if (left && right) {
+				bool leftFirst = leftDistance <= rightDistance;
+				stack.Add(leftFirst ? node.right : node.left);
+				stack.Add(leftFirst ? node.left : node.right);
+			} else if (left) {
+				stack.Add(node.left);
+			} else if (right) {
+				stack.Add(node.right);
+			}
+		}
+		if (found == nullptr) {
+			return false;
+		}
+		if (hit != nullptr) {
+			hit->node = found;
+			hit->distance = nearest;
+			hit->point = ray.origin + ray.direction * nearest;
+		}
+		return true;
+	}
+
+	int32 SpatialIndex3D::AllocateNode() {
+		int32 index = freeNode;
+		if (index >= 0) {
+			freeNode = nodes[index].parent;
+			nodes[index] = TreeNode();
+		} else {
+			index = nodes.GetCount();
+			nodes.Add(TreeNode());
+		}
+		return index;
+	}
+	void SpatialIndex3D::FreeNode(int32 index) {
+		nodes[index] = TreeNode();
+		nodes[index].height = -1;
+		nodes[index].parent = freeNode;
+		freeNode = index;
+	}
+	void SpatialIndex3D::InsertLeaf(int32 leaf) {
+		if (root < 0) {
+			root = leaf;
+			nodes[leaf].parent = -1;
+			return;
+		}
+
+		// Descend towards the sibling whose union with the leaf costs the least, counting the growth of the ancestors on the way.
+		Vector3 min = nodes[leaf].min;
+		Vector3 max = nodes[leaf].max;
+		int32 index = root;
+		while (!nodes[index].IsLeaf()) {
+			const TreeNode& node = nodes[index];
+			float area = Area(node.min, node.max);
+			float combined = Area(Min(node.min, min), Max(node.max, max));
+			// Pairing with this node makes a parent of the combined box.
+			float cost = 2 * combined;
+			// Going deeper grows this node anyway.
+			float inheritance = 2 * (combined - area);
+			auto childCost = [&](int32 child) {
+				const TreeNode& target = nodes[child];
+				float grown = Area(Min(target.min, min), Max(target.max, max));
+				return (target.IsLeaf() ? grown : grown - Area(target.min, target.max)) + inheritance;
+			};
+			float leftCost = childCost(node.left);
+			float rightCost = childCost(node.right);
+			if (cost < leftCost && cost < rightCost) {
+				break;
+			}
+			index = leftCost < rightCost ? node.left : node.right;
+		}
+
+		int32 sibling = index;
+		int32 oldParent = nodes[sibling].parent;
+		int32 parent = AllocateNode();
+		nodes[parent].parent = oldParent;
+		nodes[parent].left = sibling;
+		nodes[parent].right = leaf;
+		nodes[sibling].parent = parent;
+		nodes[leaf].parent = parent;
+		if (oldParent < 0) {
+			root = parent;
+		} else if (nodes[oldParent].left == sibling) {
+			nodes[oldParent].left = parent;
+		} else {
+			nodes[oldParent].right = parent;
+		}
+		RefitUpwards(parent);
+	}
+	void SpatialIndex3D::RemoveLeaf(int32 leaf) {
+		if (leaf == root) {
+			root = -1;
+			return;
+		}
+		int32 parent = nodes[leaf].parent;
+		int32 grandParent = nodes[parent].parent;
+		int32 sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+		nodes[leaf].parent = -1;
+		FreeNode(parent);
+		nodes[sibling].parent = grandParent;
+		if (grandParent < 0) {
+			root = sibling;
+			return;
+		}
+		if (nodes[grandParent].left == parent) {
+			nodes[grandParent].left = sibling;
+		} else {
+			nodes[grandParent].right = sibling;
+		}
+		RefitUpwards(grandParent);
+	}
+	int32 SpatialIndex3D::Balance(int32 index) {
+		TreeNode& a = nodes[index];
+		if (a.IsLeaf() || a.height < 2) {
+			return index;
+		}
+		int32 b = a.left;
+		int32 c = a.right;
+		int32 difference = nodes[c].height - nodes[b].height;
+		if (difference >= -1 && difference <= 1) {
+			return index;
+		}
+
+		// The taller child takes the place of the node, which keeps the shorter child and the shorter grandchild.
+		bool rightTaller = difference > 1;
+		int32 up = rightTaller ? c : b;
+		int32 kept = rightTaller ? b : c;
+		TreeNode& raised = nodes[up];
+		int32 first = raised.left;
+		int32 second = raised.right;
+		int32 tall = nodes[first].height > nodes[second].height ? first : second;
+		int32 shortChild = tall == first ? second : first;
+
+		raised.left = index;
+		raised.right = tall;
+		raised.parent = a.parent;
+		a.parent = up;
+		if (raised.parent < 0) {
+			root = up;
+		} else if (nodes[raised.parent].left == index) {
+			nodes[raised.parent].left = up;
+		} else {
+			nodes[raised.parent].right = up;
+		}
+		a.left = kept;
+		a.right = shortChild;
+		nodes[shortChild].parent = index;
+		Refit(index);
+		Refit(up);
+		return up;
+	}
+	void SpatialIndex3D::Refit(int32 index) {
+		TreeNode& node = nodes[index];
+		const TreeNode& left = nodes[node.left];
+		const TreeNode& right = nodes[node.right];
+		node.min = Min(left.min, right.min);
+		node.max = Max(left.max, right.max);
+		node.height = 1 + (left.height > right.height ? left.height : right.height);
+	}
+	void SpatialIndex3D::RefitUpwards(int32 index) {
+		while (index >= 0) {
+			index = Balance(index);
+			Refit(index);
+			index = nodes[index].parent;
+		}
+	}
+}
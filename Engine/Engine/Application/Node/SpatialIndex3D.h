@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Math/Math.h"
+#include "Engine/System/Math/Vector.h"
+
+namespace Engine {
+	class Node;
+	class Node3D;
+	class TransformHierarchy;
+	class JobSystem;
+
+	/// @brief Where a ray first enters the bounds of a node.
+	struct RaycastHit3D final {
+		/// @brief nullptr if the ray hit nothing.
+		Node3D* node = nullptr;
+		/// @brief From the origin along the ray, 0 if the origin is inside the bounds.
+		float distance = 0;
+		Vector3 point{};
+	};
+
+	/// @brief A dynamic bounding volume tree over the world-space boxes of the Node3Ds in a NodeTree, for raycasts and overlap queries without walking the tree.\n
+	/// The tree keeps it up to date after every update from the transforms which changed. A moved node is only reinserted once its box leaves the enlarged one it was inserted with,
+	/// so nodes moving a little every frame cost nothing. Insertion picks the sibling that grows the surface area the least and rotates the ancestors to keep the tree balanced.\n
+	/// Rebuild() builds the whole tree again with the surface area heuristic, which makes queries faster after many insertions, such as once a level has loaded.\n
+	/// Queries only read the tree, so any number of them can run at once between updates.
+	class SpatialIndex3D final {
+	public:
+		/// @brief How far the boxes in the tree reach past the ones of the nodes.
+		static inline constexpr float DefaultMargin = 0.1f;
+		/// @brief Batches shorter than this run on the calling thread.
+		static inline constexpr int32 ParallelBatchThreshold = 64;
+
+		SpatialIndex3D(float margin = DefaultMargin);
+		SpatialIndex3D(const SpatialIndex3D&) = delete;
+		SpatialIndex3D& operator=(const SpatialIndex3D&) = delete;
+
+		float GetMargin() const;
+		/// @brief Applies to the nodes inserted from now on.
+		void SetMargin(float margin);
+
+		/// @brief Add the Node3Ds among the slots and move the ones already in the index.
+		/// @param movedSlots Slots whose global transform changed, from TransformHierarchy::CollectMoved().
+		void Update(const TransformHierarchy& transforms, const List<int32>& movedSlots);
+		/// @brief Drop the node, done when it exits the tree.
+		void Remove(Node* node);
+		/// @brief Build the tree again from scratch with the surface area heuristic.
+		void Rebuild();
+
+		/// @brief Count of nodes in the index.
+		int32 GetCount() const;
+		/// @brief Longest path from the root to a node, 0 when empty.
+		int32 GetHeight() const;
+		/// @brief Total surface area of the boxes inside the tree over the one of the root, the cost of a query grows with it.
+		float GetAreaRatio() const;
+
+		/// @brief Find the nodes whose box overlaps the box, borders included.
+		/// @param result The nodes are appended to it, in no particular order.
+		void QueryBox(const Vector3& min, const Vector3& max, List<Node3D*>& result) const;
+		/// @brief Find the nodes whose box overlaps the sphere.
+		/// @param result The nodes are appended to it, in no particular order.
+		void QuerySphere(const Vector3& center, float radius, List<Node3D*>& result) const;
+		/// @brief Find the first box the ray enters within the distance.
+		/// @param direction Doesn't need to be normalized, distances are measured in world units.
+		/// @return false if the ray hits nothing, hit is left untouched then.
+		bool Raycast(const Vector3& origin, const Vector3& direction, float maxDistance, RaycastHit3D& hit) const;
+		/// @brief Check if the ray enters any box within the distance, stopping at the first found. Faster than Raycast() for line of sight.
+		bool RaycastAny(const Vector3& origin, const Vector3& direction, float maxDistance) const;
+
+		/// @brief Run Raycast() for every origin and direction.
+		/// @param hits Gets count hits written, with a nullptr node where nothing was hit.
+		/// @param jobSystem Split the rays across its workers when given.
+		void RaycastBatch(const Vector3* origins, const Vector3* directions, int32 count, float maxDistance, RaycastHit3D* hits, JobSystem* jobSystem = nullptr) const;
+		/// @brief Run RaycastAny() for every origin and direction.
+		/// @param results Gets count results written.
+		void RaycastAnyBatch(const Vector3* origins, const Vector3* directions, int32 count, float maxDistance, bool* results, JobSystem* jobSystem = nullptr) const;
+
+	private:
+		struct Entry {
+			Node3D* node = nullptr;
+			Vector3 min{};
+			Vector3 max{};
+			int32 leaf = -1;
+		};
+		struct TreeNode {
+			// Enlarged by the margin for leaves.
+			Vector3 min{};
+			Vector3 max{};
+			// The next free node while in the free list.
+			int32 parent = -1;
+			int32 left = -1;
+			int32 right = -1;
+			// Into entries for leaves, -1 for the others.
+			int32 entry = -1;
+			// 0 for leaves, -1 while free.
+			int32 height = 0;
+
+			bool IsLeaf() const {
+				return left < 0;
+			}
+		};
+
+		int32 AllocateNode();
+		void FreeNode(int32 index);
+		void InsertLeaf(int32 leaf);
+		void RemoveLeaf(int32 leaf);
+		/// @brief Rotate a grandchild up if one side of the node is more than one taller, returns the node now in its place.
+		int32 Balance(int32 index);
+		/// @brief Recompute the box and height of a node from its children.
+		void Refit(int32 index);
+		/// @brief Walk up from the node, balancing and refitting every ancestor.
+		void RefitUpwards(int32 index);
+
+		/// @brief Shared by the raycasts, any stops at the first hit instead of looking for the nearest.
+		bool CastRay(const Vector3& origin, const Vector3& direction, float maxDistance, bool any, RaycastHit3D* hit) const;
+
+		float margin;
+		List<Entry> entries{};
+		List<TreeNode> nodes{};
+		int32 root = -1;
+		int32 freeNode = -1;
+	};
+}
@@ -0,0 +1,233 @@
+#include "Engine/Application/Node/TransformHierarchy.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Math/Transform2.h"
+
+namespace Engine {
+	int32 TransformHierarchy::Add(Node* node) {
+		ERR_ASSERT(node != nullptr && node->transformFunction != nullptr, u8"node has no transform.", return -1);
+
+		int32 parent = -1;
+		for (Node* current = node->parent; current != nullptr; current = current->parent) {
+			if (current->transformSlot >= 0) {
+				parent = current->transformSlot;
+				break;
+			}
+		}
+
+		int32 slot = nodes.GetCount();
+		nodes.Add(node);
+		locals.Add(TransformMatrix());
+		globals.Add(TransformMatrix());
+		parents.Add(parent);
+		flags.Add(LocalChanged | GlobalChanged | (node->transformPlanar ? Planar : 0));
+		versions.Add(0);
+		parentVersions.Add(0);
+		moved.Add(0);
+		count += 1;
+		node->transformSlot = slot;
+		return slot;
+	}
+	void TransformHierarchy::Remove(int32 slot) {
+		ERR_ASSERT(slot >= 0 && slot < nodes.GetCount() && nodes[slot] != nullptr, u8"slot is not valid.", return);
+		// Children leave the tree before their parents, no slot refers to this one anymore.
+		nodes[slot]->transformSlot = -1;
+		nodes[slot] = nullptr;
+		count -= 1;
+	}
+	void TransformHierarchy::MarkChanged(int32 slot) {
+		flags[slot] |= LocalChanged;
+	}
+
+	const TransformMatrix& TransformHierarchy::GetLocal(int32 slot) {
+		if (flags[slot] & LocalChanged) {
+			locals[slot] = nodes[slot]->transformFunction(nodes[slot]);
+			flags[slot] = (flags[slot] & ~LocalChanged) | GlobalChanged;
+		}
+		return locals[slot];
+	}
+	const TransformMatrix& TransformHierarchy::GetGlobal(int32 slot) {
+		int32 parent = parents[slot];
+		if (parent >= 0) {
+			GetGlobal(parent);
+		}
+		Refresh(slot);
+		return globals[slot];
+	}
+
+	void TransformHierarchy::Update(JobSystem* jobSystem) {
+		int32 slotCount = nodes.GetCount();
+		if (slotCount >= MinCompactSlots) {
+			bool holes = (slotCount - count) * 4 > slotCount;
+			bool ungrouped = jobSystem != nullptr && (slotCount - groupedCount) * 4 > slotCount;
+			if (holes || ungrouped) {
+				Compact();
+				slotCount = nodes.GetCount();
+			}
+		}
+
+		if (jobSystem != nullptr && groups.GetCount() > 2) {
+			jobSystem->ParallelFor(0, groups.GetCount() - 1, 0, [this](int32 group) {
+				RefreshRange(groups[group], groups[group + 1]);
+			});
+			// Parents of the slots added since are either grouped or come before them.
+			RefreshRange(groupedCount, slotCount);
+		} else {
+			RefreshRange(0, slotCount);
+		}
+	}
+
+	void TransformHierarchy::CollectMoved(List<int32>& result) {
+		int32 slotCount = nodes.GetCount();
+		for (int32 i = 0; i < slotCount; i += 1) {
+			if (moved[i] == 0) {
+				continue;
+			}
+			moved[i] = 0;
+			if (nodes[i] != nullptr) {
+				result.Add(i);
+			}
+		}
+	}
+
+	int32 TransformHierarchy::GetCount() const {
+		return count;
+	}
+	int32 TransformHierarchy::GetSlotCount() const {
+		return nodes.GetCount();
+	}
+	const TransformMatrix* TransformHierarchy::GetGlobals() const {
+		return globals.GetRawElementPtr();
+	}
+	Node* TransformHierarchy::GetNode(int32 slot) const {
+		ERR_ASSERT(slot >= 0 && slot < nodes.GetCount(), u8"slot out of bounds.", return nullptr);
+		return nodes[slot];
+	}
+
+	TransformMatrix TransformHierarchy::ComputeGlobal(const Node* node) {
+		TransformMatrix local = node->transformFunction != nullptr ? node->transformFunction(node) : TransformMatrix();
+		for (Node* current = node->parent; current != nullptr; current = current->parent) {
+			if (current->transformFunction != nullptr) {
+				return ComputeGlobal(current) * local;
+			}
+		}
+		return local;
+	}
+
+	void TransformHierarchy::Refresh(int32 slot) {
+		byte flag = flags[slot];
+		if (flag & LocalChanged) {
+			locals[slot] = nodes[slot]->transformFunction(nodes[slot]);
+			flag = (flag & Planar) | GlobalChanged;
+		}
+		int32 parent = parents[slot];
+		if (parent >= 0) {
+			if ((flag & GlobalChanged) || parentVersions[slot] != versions[parent]) {
+				if ((flag & Planar) && (flags[parent] & Planar)) {
+					// Both stay on the plane, composing the 2D parts is enough.
+					globals[slot] = (Transform2::FromTransformMatrix(globals[parent]) * Transform2::FromTransformMatrix(locals[slot])).ToTransformMatrix();
+				} else {
+					globals[slot] = globals[parent] * locals[slot];
+				}
+				parentVersions[slot] = versions[parent];
+				versions[slot] += 1;
+				moved[slot] = 1;
+			}
+		} else if (flag & GlobalChanged) {
+			globals[slot] = locals[slot];
+			versions[slot] += 1;
+			moved[slot] = 1;
+		}
+		flags[slot] = flag & Planar;
+	}
+	void TransformHierarchy::RefreshRange(int32 begin, int32 end) {
+		for (int32 i = begin; i < end; i += 1) {
+			if (nodes[i] != nullptr) {
+				Refresh(i);
+			}
+		}
+	}
+
+	void TransformHierarchy::Compact() {
+		int32 slotCount = nodes.GetCount();
+
+		// The group of every slot is the one of its root, parents are met before their children.
+		List<int32> groupOf(slotCount);
+		List<int32> groupStarts{};
+		for (int32 i = 0; i < slotCount; i += 1) {
+			int32 group = -1;
+			if (nodes[i] != nullptr) {
+				if (parents[i] < 0) {
+					group = groupStarts.GetCount();
+					groupStarts.Add(0);
+				} else {
+					group = groupOf[parents[i]];
+				}
+				groupStarts[group] += 1;
+			}
+			groupOf.Add(group);
+		}
+		int32 start = 0;
+		for (int32 i = 0; i < groupStarts.GetCount(); i += 1) {
+			int32 size = groupStarts[i];
+			groupStarts[i] = start;
+			start += size;
+		}
+
+		// Slots keep their order inside a group, so parents stay before their children.
+		groups = groupStarts;
+		groups.Add(count);
+		List<int32> remap(slotCount);
+		for (int32 i = 0; i < slotCount; i += 1) {
+			int32 group = groupOf[i];
+			if (group < 0) {
+				remap.Add(-1);
+				continue;
+			}
+			remap.Add(groupStarts[group]);
+			groupStarts[group] += 1;
+		}
+
+		List<Node*> newNodes(count);
+		List<TransformMatrix> newLocals(count);
+		List<TransformMatrix> newGlobals(count);
+		List<int32> newParents(count);
+		List<byte> newFlags(count);
+		List<uint32> newVersions(count);
+		List<uint32> newParentVersions(count);
+		List<byte> newMoved(count);
+		for (int32 i = 0; i < count; i += 1) {
+			newNodes.Add(nullptr);
+			newLocals.Add(TransformMatrix());
+			newGlobals.Add(TransformMatrix());
+			newParents.Add(-1);
+			newFlags.Add(0);
+			newVersions.Add(0);
+			newParentVersions.Add(0);
+			newMoved.Add(0);
+		}
+		for (int32 i = 0; i < slotCount; i += 1) {
+			int32 target = remap[i];
+			if (target < 0) {
+				continue;
+			}
+			newNodes[target] = nodes[i];
+			newLocals[target] = locals[i];
+			newGlobals[target] = globals[i];
+			newParents[target] = parents[i] < 0 ? -1 : remap[parents[i]];
+			newFlags[target] = flags[i];
+			newVersions[target] = versions[i];
+			newParentVersions[target] = parentVersions[i];
+			newMoved[target] = moved[i];
+			nodes[i]->transformSlot = target;
+		}
+		nodes = Memory::Move(newNodes);
+		locals = Memory::Move(newLocals);
+		globals = Memory::Move(newGlobals);
+		parents = Memory::Move(newParents);
+		flags = Memory::Move(newFlags);
+		versions = Memory::Move(newVersions);
+		parentVersions = Memory::Move(newParentVersions);
+		moved = Memory::Move(newMoved);
+		groupedCount = count;
+	}
+}
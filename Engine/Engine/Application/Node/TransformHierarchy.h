@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Math/TransformMatrix.h"
+#include "Engine/Application/Node/Node.h"
+
+namespace Engine {
+	class JobSystem;
+
+	/// @brief The transforms of the nodes in a NodeTree which have one, such as Node2D and Node3D, kept in parallel arrays.\n
+	/// Changing a node only flags its slot. Update() recomputes the flagged transforms and everything under them in one pass over the arrays,
+	/// so readers such as rendering and physics get the global transforms without walking the parents.\n
+	/// A parent always comes before its children in the arrays. Removed slots are compacted away once enough of them pile up,
+	/// which also groups every root with the nodes under it so the roots can be updated in parallel.
+	class TransformHierarchy final {
+	public:
+		TransformHierarchy() = default;
+		TransformHierarchy(const TransformHierarchy&) = delete;
+		TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+		/// @brief Give the node a slot. Its transform parent is the closest ancestor which has a slot.
+		/// @return The slot of the node, which moves when the arrays are compacted.
+		int32 Add(Node* node);
+		void Remove(int32 slot);
+		/// @brief Flag the local transform of the slot as changed, the global ones of its children follow.
+		void MarkChanged(int32 slot);
+
+		/// @brief Recompute the local transform first if it changed.
+		const TransformMatrix& GetLocal(int32 slot);
+		/// @brief Recompute the global transform and the ones of the parents first if any of them changed.\n
+		/// Don't call it for nodes of other subtrees while updating in parallel.
+		const TransformMatrix& GetGlobal(int32 slot);
+
+		/// @brief Recompute every changed transform in a pass over the arrays.
+		/// @param jobSystem Update the roots in parallel when given.
+		void Update(JobSystem* jobSystem = nullptr);
+
+		/// @brief Collect the slots whose global transform was recomputed since the last call, and clear their flags.\n
+		/// Meant for a single consumer, the tree passes them on to its spatial indices. New slots count as moved.
+		/// @param result The slots are appended to it.
+		void CollectMoved(List<int32>& result);
+
+		/// @brief Count of nodes with a slot.
+		int32 GetCount() const;
+		/// @brief Count of slots in the arrays, including removed ones.
+		int32 GetSlotCount() const;
+		/// @brief The global transforms as of the last Update(), one per slot. Removed slots hold stale values.
+		const TransformMatrix* GetGlobals() const;
+		/// @brief nullptr for removed slots.
+		Node* GetNode(int32 slot) const;
+
+		/// @brief Compute the global transform from the parents without any caching, for nodes outside a tree.
+		static TransformMatrix ComputeGlobal(const Node* node);
+
+	private:
+		enum Flag :byte {
+			LocalChanged = 1 << 0,
+			GlobalChanged = 1 << 1,
+			// Kept for good. The node lives on the 2D plane, so is composed with a planar parent as a Transform2.
+			Planar = 1 << 2
+		};
+		static inline constexpr int32 MinCompactSlots = 64;
+
+		/// @brief Bring the slot up to date, its parent needs to be already.
+		void Refresh(int32 slot);
+		void RefreshRange(int32 begin, int32 end);
+		/// @brief Drop the removed slots and group the roots with their children.
+		void Compact();
+
+		List<Node*> nodes{};
+		List<TransformMatrix> locals{};
+		List<TransformMatrix> globals{};
+		List<int32> parents{};
+		List<byte> flags{};
+		// Increased every time the global transform is recomputed, children compare it with the one they were computed from.
+		List<uint32> versions{};
+		List<uint32> parentVersions{};
+		// Set when the global transform is recomputed, cleared by CollectMoved(). Each slot is only written by the thread refreshing it.
+		List<byte> moved{};
+
+		int32 count = 0;
+		// The slots from here on were added after the last compaction and aren't grouped by root.
+		int32 groupedCount = 0;
+		// Start of every root group, followed by groupedCount.
+		List<int32> groups{};
+	};
+}
@@ -0,0 +1,309 @@
+#include "Engine/Application/Rendering/Culling.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Math/Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define CULLING_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Engine {
+	namespace {
+		template<typename T>
+		void GrowTo(List<T>& list, int32 count) {
+			if (list.GetCount() < count) {
+				list.SetCount(count);
+			}
+		}
+#if defined(CULLING_SSE)
+		inline void StoreMask(__m128 inside, byte* visible) {
+			int32 mask = _mm_movemask_ps(inside);
+			visible[0] = (byte)(mask & 1);
+			visible[1] = (byte)((mask >> 1) & 1);
+			visible[2] = (byte)((mask >> 2) & 1);
+			visible[3] = (byte)((mask >> 3) & 1);
+		}
+#elif defined(CULLING_NEON)
+		inline void StoreMask(uint32x4_t inside, byte* visible) {
+			uint32 lanes[4];
+			vst1q_u32(lanes, inside);
+			visible[0] = (byte)(lanes[0] & 1);
+			visible[1] = (byte)(lanes[1] & 1);
+			visible[2] = (byte)(lanes[2] & 1);
+			visible[3] = (byte)(lanes[3] & 1);
+		}
+#endif
+	}
+
+	Frustum Frustum::FromViewProjection(const TransformMatrix& viewProjection) {
+		// Row vectors: clip = p * M, so every clip component is a column. Inside is -w <= x, y, z <= w.
+		const auto& m = viewProjection.matrix;
+		Frustum result{};
+		for (int32 i = 0; i < 4; i += 1) {
+			result.planes[Left][i] = m[i][3] + m[i][0];
+			result.planes[Right][i] = m[i][3] - m[i][0];
+			result.planes[Bottom][i] = m[i][3] + m[i][1];
+			result.planes[Top][i] = m[i][3] - m[i][1];
+			result.planes[Near][i] = m[i][3] + m[i][2];
+			result.planes[Far][i] = m[i][3] - m[i][2];
+		}
+		for (int32 plane = 0; plane < PlaneCount; plane += 1) {
+			float* p = result.planes[plane];
+			float length = Math::Sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+			if (length > 0) {
+				float scale = 1 / length;
+				p[0] *= scale;
+				p[1] *= scale;
+				p[2] *= scale;
+				p[3] *= scale;
+			}
+		}
+		return result;
+	}
+	bool Frustum::IntersectsSphere(const Vector3& center, float radius) const {
+		for (int32 plane = 0; plane < PlaneCount; plane += 1) {
+			const float* p = planes[plane];
+			if (p[0] * center.x + p[1] * center.y + p[2] * center.z + p[3] < -radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+	bool Frustum::IntersectsBox(const Vector3& center, const Vector3& extent) const {
+		for (int32 plane = 0; plane < PlaneCount; plane += 1) {
+			const float* p = planes[plane];
+			// The corner furthest along the normal is extent away from the center projected on it.
+			float reach = Math::Abs(p[0]) * extent.x + Math::Abs(p[1]) * extent.y + Math::Abs(p[2]) * extent.z;
+			if (p[0] * center.x + p[1] * center.y + p[2] * center.z + p[3] < -reach) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void Culler::Cull(const Frustum& frustum, const TransformMatrix* globals, const CullBounds* bounds, int32 count, JobSystem* jobSystem) {
+		Prepare(count);
+		RunChunks(count, jobSystem, [this, &frustum, globals, bounds, count](int32 chunk) {
+			TransformChunk(chunk, globals, bounds, count, false);
+			int32 begin = chunk * ChunkSize;
+			int32 size = count - begin < ChunkSize ? count - begin : ChunkSize;
+			TestSpheres(frustum, worldX.GetRawElementPtr() + begin, worldY.GetRawElementPtr() + begin, worldZ.GetRawElementPtr() + begin, worldRadius.GetRawElementPtr() + begin, flags.GetRawElementPtr() + begin, size);
+		});
+		CollectVisible(count);
+	}
+	void Culler::Cull(const Vector2& viewMin, const Vector2& viewMax, const TransformMatrix* globals, const CullBounds* bounds, int32 count, JobSystem* jobSystem) {
+		Prepare(count);
+		RunChunks(count, jobSystem, [this, &viewMin, &viewMax, globals, bounds, count](int32 chunk) {
+			TransformChunk(chunk, globals, bounds, count, true);
+			int32 begin = chunk * ChunkSize;
+			int32 size = count - begin < ChunkSize ? count - begin : ChunkSize;
+			// The square around the circle, a little more than what is visible at the corners only.
+			const float* radius = worldRadius.GetRawElementPtr() + begin;
+			TestRects(viewMin, viewMax, worldX.GetRawElementPtr() + begin, worldY.GetRawElementPtr() + begin, radius, radius, flags.GetRawElementPtr() + begin, size);
+		});
+		CollectVisible(count);
+	}
+
+	const List<int32>& Culler::GetVisible() const {
+		return visible;
+	}
+	Vector3 Culler::GetWorldCenter(int32 index) const {
+		ERR_ASSERT(index >= 0 && index < boundCount, u8"index out of bounds.", return Vector3());
+		return Vector3(worldX[index], worldY[index], worldZ[index]);
+	}
+	float Culler::GetWorldRadius(int32 index) const {
+		ERR_ASSERT(index >= 0 && index < boundCount, u8"index out of bounds.", return 0);
+		return worldRadius[index];
+	}
+
+	void Culler::TestSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius, byte* visible, int32 count) {
+		int32 i = 0;
+#if defined(CULLING_SSE)
+		const __m128 allInside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (; i + 4 <= count; i += 4) {
+			__m128 vx = _mm_loadu_ps(x + i);
+			__m128 vy = _mm_loadu_ps(y + i);
+			__m128 vz = _mm_loadu_ps(z + i);
+			__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+			__m128 inside = allInside;
+			for (int32 plane = 0; plane < Frustum::PlaneCount; plane += 1) {
+				const float* p = frustum.planes[plane];
+				__m128 distance = _mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(p[0])), _mm_set1_ps(p[3]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(vy, _mm_set1_ps(p[1])));
+				distance = _mm_add_ps(distance, _mm_mul_ps(vz, _mm_set1_ps(p[2])));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+			}
+			StoreMask(inside, visible + i);
+		}
+#elif defined(CULLING_NEON)
+		for (; i + 4 <= count; i += 4) {
+			float32x4_t vx = vld1q_f32(x + i);
+			float32x4_t vy = vld1q_f32(y + i);
+			float32x4_t vz = vld1q_f32(z + i);
+			float32x4_t negativeRadius = vnegq_f32(vld1q_f32(radius + i));
+			uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+			for (int32 plane = 0; plane < Frustum::PlaneCount; plane += 1) {
+				const float* p = frustum.planes[plane];
+				float32x4_t distance = vfmaq_f32(vdupq_n_f32(p[3]), vx, vdupq_n_f32(p[0]));
+				distance = vfmaq_f32(distance, vy, vdupq_n_f32(p[1]));
+				distance = vfmaq_f32(distance, vz, vdupq_n_f32(p[2]));
+				inside = vandq_u32(inside, vcgeq_f32(distance, negativeRadius));
+			}
+			StoreMask(inside, visible + i);
+		}
+#endif
+		for (; i < count; i += 1) {
+			visible[i] = frustum.IntersectsSphere(Vector3(x[i], y[i], z[i]), radius[i]) ? 1 : 0;
+		}
+	}
+	void Culler::TestBoxes(const Frustum& frustum, const float* x, const float* y, const float* z, const float* extentX, const float* extentY, const float* extentZ, byte* visible, int32 count) {
+		int32 i = 0;
+#if defined(CULLING_SSE)
+		const __m128 allInside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (; i + 4 <= count; i += 4) {
+			__m128 vx = _mm_loadu_ps(x + i);
+			__m128 vy = _mm_loadu_ps(y + i);
+			__m128 vz = _mm_loadu_ps(z + i);
+			__m128 ex = _mm_loadu_ps(extentX + i);
+			__m128 ey = _mm_loadu_ps(extentY + i);
+			__m128 ez = _mm_loadu_ps(extentZ + i);
+			__m128 inside = allInside;
+			for (int32 plane = 0; plane < Frustum::PlaneCount; plane += 1) {
+				const float* p = frustum.planes[plane];
+				__m128 distance = _mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(p[0])), _mm_set1_ps(p[3]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(vy, _mm_set1_ps(p[1])));
+				distance = _mm_add_ps(distance, _mm_mul_ps(vz, _mm_set1_ps(p[2])));
+				__m128 reach = _mm_mul_ps(ex, _mm_set1_ps(Math::Abs(p[0])));
+				reach = _mm_add_ps(reach, _mm_mul_ps(ey, _mm_set1_ps(Math::Abs(p[1]))));
+				reach = _mm_add_ps(reach, _mm_mul_ps(ez, _mm_set1_ps(Math::Abs(p[2]))));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+			}
+			StoreMask(inside, visible + i);
+		}
+#elif defined(CULLING_NEON)
+		for (; i + 4 <= count; i += 4) {
+			float32x4_t vx = vld1q_f32(x + i);
+			float32x4_t vy = vld1q_f32(y + i);
+			float32x4_t vz = vld1q_f32(z + i);
+			float32x4_t ex = vld1q_f32(extentX + i);
+			float32x4_t ey = vld1q_f32(extentY + i);
+			float32x4_t ez = vld1q_f32(extentZ + i);
+			uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+			for (int32 plane = 0; plane < Frustum::PlaneCount; plane += 1) {
+				const float* p = frustum.planes[plane];
+				float32x4_t distance = vfmaq_f32(vdupq_n_f32(p[3]), vx, vdupq_n_f32(p[0]));
+				distance = vfmaq_f32(distance, vy, vdupq_n_f32(p[1]));
+				distance = vfmaq_f32(distance, vz, vdupq_n_f32(p[2]));
+				distance = vfmaq_f32(distance, ex, vdupq_n_f32(Math::Abs(p[0])));
+				distance = vfmaq_f32(distance, ey, vdupq_n_f32(Math::Abs(p[1])));
+				distance = vfmaq_f32(distance, ez, vdupq_n_f32(Math::Abs(p[2])));
+				inside = vandq_u32(inside, vcgeq_f32(distance, vdupq_n_f32(0)));
+			}
+			StoreMask(inside, visible + i);
+		}
+#endif
+		for (; i < count; i += 1) {
+			visible[i] = frustum.IntersectsBox(Vector3(x[i], y[i], z[i]), Vector3(extentX[i], extentY[i], extentZ[i])) ? 1 : 0;
+		}
+	}
+	void Culler::TestRects(const Vector2& viewMin, const Vector2& viewMax, const float* x, const float* y, const float* extentX, const float* extentY, byte* visible, int32 count) {
+		// Overlapping when the centers are closer than the sum of the half sizes on both axes.
+		float viewX = (viewMin.x + viewMax.x) / 2;
+		float viewY = (viewMin.y + viewMax.y) / 2;
+		float viewExtentX = (viewMax.x - viewMin.x) / 2;
+		float viewExtentY = (viewMax.y - viewMin.y) / 2;
+		int32 i = 0;
+#if defined(CULLING_SSE)
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 vViewX = _mm_set1_ps(viewX);
+		const __m128 vViewY = _mm_set1_ps(viewY);
+		const __m128 vViewExtentX = _mm_set1_ps(viewExtentX);
+		const __m128 vViewExtentY = _mm_set1_ps(viewExtentY);
+		for (; i + 4 <= count; i += 4) {
+			__m128 dx = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_loadu_ps(x + i), vViewX));
+			__m128 dy = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_loadu_ps(y + i), vViewY));
+			__m128 inside = _mm_cmple_ps(dx, _mm_add_ps(_mm_loadu_ps(extentX + i), vViewExtentX));
+			inside = _mm_and_ps(inside, _mm_cmple_ps(dy, _mm_add_ps(_mm_loadu_ps(extentY + i), vViewExtentY)));
+			StoreMask(inside, visible + i);
+		}
+#elif defined(CULLING_NEON)
+		const float32x4_t vViewX = vdupq_n_f32(viewX);
+		const float32x4_t vViewY = vdupq_n_f32(viewY);
+		const float32x4_t vViewExtentX = vdupq_n_f32(viewExtentX);
+		const float32x4_t vViewExtentY = vdupq_n_f32(viewExtentY);
+		for (; i + 4 <= count; i += 4) {
+			float32x4_t dx = vabdq_f32(vld1q_f32(x + i), vViewX);
+			float32x4_t dy = vabdq_f32(vld1q_f32(y + i), vViewY);
+			uint32x4_t inside = vcleq_f32(dx, vaddq_f32(vld1q_f32(extentX + i), vViewExtentX));
+			inside = vandq_u32(inside, vcleq_f32(dy, vaddq_f32(vld1q_f32(extentY + i), vViewExtentY)));
+			StoreMask(inside, visible + i);
+		}
+#endif
+		for (; i < count; i += 1) {
+			bool inside = Math::Abs(x[i] - viewX) <= extentX[i] + viewExtentX && Math::Abs(y[i] - viewY) <= extentY[i] + viewExtentY;
+			visible[i] = inside ? 1 : 0;
+		}
+	}
+
+	void Culler::Prepare(int32 count) {
+		boundCount = count;
+		GrowTo(worldX, count);
+		GrowTo(worldY, count);
+		GrowTo(worldZ, count);
+		GrowTo(worldRadius, count);
+		GrowTo(flags, count);
+	}
+	void Culler::TransformChunk(int32 chunk, const TransformMatrix* globals, const CullBounds* bounds, int32 count, bool planar) {
+		int32 begin = chunk * ChunkSize;
+		int32 end = begin + ChunkSize < count ? begin + ChunkSize : count;
+		float* x = worldX.GetRawElementPtr();
+		float* y = worldY.GetRawElementPtr();
+		float* z = worldZ.GetRawElementPtr();
+		float* radius = worldRadius.GetRawElementPtr();
+		for (int32 i = begin; i < end; i += 1) {
+			const CullBounds& bound = bounds[i];
+			if (bound.slot < 0) {
+				x[i] = bound.center.x;
+				y[i] = bound.center.y;
+				z[i] = bound.center.z;
+				radius[i] = bound.radius;
+				continue;
+			}
+			const auto& m = globals[bound.slot].matrix;
+			const Vector3& c = bound.center;
+			x[i] = c.x * m[0][0] + c.y * m[1][0] + c.z * m[2][0] + m[3][0];
+			y[i] = c.x * m[0][1] + c.y * m[1][1] + c.z * m[2][1] + m[3][1];
+			z[i] = c.x * m[0][2] + c.y * m[1][2] + c.z * m[2][2] + m[3][2];
+			// A sphere scaled unevenly is inside the sphere of its longest axis.
+			float scaleSquared = 0;
+			for (int32 axis = 0; axis < (planar ? 2 : 3); axis += 1) {
+				float lengthSquared = m[axis][0] * m[axis][0] + m[axis][1] * m[axis][1] + m[axis][2] * m[axis][2];
+				scaleSquared = lengthSquared > scaleSquared ? lengthSquared : scaleSquared;
+			}
+			radius[i] = bound.radius * Math::Sqrt(scaleSquared);
+		}
+	}
+	template<typename Function>
+	void Culler::RunChunks(int32 count, JobSystem* jobSystem, const Function& function) {
+		int32 chunkCount = (count + ChunkSize - 1) / ChunkSize;
+		if (jobSystem != nullptr && chunkCount > 1) {
+			jobSystem->ParallelFor(0, chunkCount, 1, function);
+			return;
+		}
+		for (int32 chunk = 0; chunk < chunkCount; chunk += 1) {
+			function(chunk);
+		}
+	}
+	void Culler::CollectVisible(int32 count) {
+		visible.Clear();
+		const byte* flag = flags.GetRawElementPtr();
+		for (int32 i = 0; i < count; i += 1) {
+			if (flag[i] != 0) {
+				visible.Add(i);
+			}
+		}
+	}
+}
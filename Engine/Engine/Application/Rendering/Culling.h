@@ -0,0 +1,84 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Math/Vector.h"
+#include "Engine/System/Math/TransformMatrix.h"
+
+namespace Engine {
+	class JobSystem;
+
+	/// @brief The 6 planes of a camera view volume, a point p is inside when a * p.x + b * p.y + c * p.z + d >= 0 for all of them.
+	struct Frustum final {
+		enum Plane {
+			Left,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			PlaneCount,
+		};
+		/// @brief (a, b, c, d) per plane, the normal (a, b, c) is of unit length and points inwards.
+		float planes[PlaneCount][4] = {};
+
+		/// @brief Extract the planes of a view * projection matrix, with the clip space of TransformMatrix::Perspective() and TransformMatrix::Ortho().
+		static Frustum FromViewProjection(const TransformMatrix& viewProjection);
+
+		bool IntersectsSphere(const Vector3& center, float radius) const;
+		/// @brief The axis-aligned box given by its center and half of its size.
+		bool IntersectsBox(const Vector3& center, const Vector3& extent) const;
+	};
+
+	/// @brief A bounding sphere in the local space of a transform slot.
+	struct CullBounds final {
+		/// @brief Into TransformHierarchy::GetGlobals(), -1 if the sphere is already in world space.
+		int32 slot = -1;
+		Vector3 center{};
+		float radius = 0;
+	};
+
+	/// @brief Finds the bounds that can be seen by a camera, so the renderer only gets what is on screen.\n
+	/// Cull() puts the bounds into world space with the globals of the TransformHierarchy, caching them as arrays of x, y, z and radius,
+	/// then tests 4 of them at a time against the view. Chunks of ChunkSize bounds run as a ParallelFor when given a JobSystem.
+	/// The lists are kept between calls, so a Culler per view allocates nothing once warmed up.
+	class Culler final {
+	public:
+		/// @brief Bounds per job of the JobSystem.
+		static inline constexpr int32 ChunkSize = 1024;
+
+		/// @brief Cull against the frustum of a 3D camera, a radius is scaled by the largest axis of its transform.
+		/// @param globals TransformHierarchy::GetGlobals(), can be nullptr if every slot is -1.
+		void Cull(const Frustum& frustum, const TransformMatrix* globals, const CullBounds* bounds, int32 count, JobSystem* jobSystem = nullptr);
+		/// @brief Cull against the rectangle seen by a 2D camera, in world space. The z components are ignored.
+		void Cull(const Vector2& viewMin, const Vector2& viewMax, const TransformMatrix* globals, const CullBounds* bounds, int32 count, JobSystem* jobSystem = nullptr);
+
+		/// @brief The indices into the bounds of the last Cull() that are visible, in increasing order.
+		const List<int32>& GetVisible() const;
+		/// @brief The world space sphere of bounds[index] in the last Cull().
+		Vector3 GetWorldCenter(int32 index) const;
+		float GetWorldRadius(int32 index) const;
+
+		/// @brief Set visible[i] to 1 if the sphere i intersects the frustum, 0 if it doesn't. Uses SSE or NEON where available.
+		static void TestSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius, byte* visible, int32 count);
+		/// @brief Set visible[i] to 1 if the axis-aligned box i, given by its center and half of its size, intersects the frustum.
+		static void TestBoxes(const Frustum& frustum, const float* x, const float* y, const float* z, const float* extentX, const float* extentY, const float* extentZ, byte* visible, int32 count);
+		/// @brief Set visible[i] to 1 if the rectangle i, given by its center and half of its size, overlaps the view rectangle.
+		static void TestRects(const Vector2& viewMin, const Vector2& viewMax, const float* x, const float* y, const float* extentX, const float* extentY, byte* visible, int32 count);
+
+	private:
+		void Prepare(int32 count);
+		/// @brief Write the world space spheres of the chunk.
+		void TransformChunk(int32 chunk, const TransformMatrix* globals, const CullBounds* bounds, int32 count, bool planar);
+		template<typename Function>
+		void RunChunks(int32 count, JobSystem* jobSystem, const Function& function);
+		void CollectVisible(int32 count);
+
+		List<float> worldX{};
+		List<float> worldY{};
+		List<float> worldZ{};
+		List<float> worldRadius{};
+		List<byte> flags{};
+		List<int32> visible{};
+		int32 boundCount = 0;
+	};
+}
@@ -0,0 +1,56 @@
+#include "Engine/Application/Rendering/RenderCommandBuffer.h"
+
+namespace Engine {
+	RenderCommandBuffer::RenderCommandBuffer(sizeint capacity) :capacity(capacity) {
+		if (capacity > 0) {
+			data = (byte*)Memory::AllocateAligned(capacity, Alignment);
+		}
+	}
+	RenderCommandBuffer::~RenderCommandBuffer() {
+		if (data != nullptr) {
+			Memory::Deallocate(data);
+		}
+	}
+
+	void RenderCommandBuffer::Add(uint32 type) {
+		Allocate(type, 0);
+	}
+
+	void RenderCommandBuffer::Clear() {
+		size = 0;
+		count = 0;
+	}
+	int32 RenderCommandBuffer::GetCount() const {
+		return count;
+	}
+	sizeint RenderCommandBuffer::GetSize() const {
+		return size;
+	}
+
+	const RenderCommandBuffer::Command* RenderCommandBuffer::GetFirst() const {
+		return size > 0 ? reinterpret_cast<const Command*>(data) : nullptr;
+	}
+	const RenderCommandBuffer::Command* RenderCommandBuffer::GetNext(const Command* command) const {
+		const byte* next = reinterpret_cast<const byte*>(command) + command->size;
+		return next < data + size ? reinterpret_cast<const Command*>(next) : nullptr;
+	}
+
+	RenderCommandBuffer::Command* RenderCommandBuffer::Allocate(uint32 type, sizeint payloadSize) {
+		sizeint commandSize = sizeof(Command) + (payloadSize + Alignment - 1) / Alignment * Alignment;
+		if (size + commandSize > capacity) {
+			sizeint newCapacity = capacity > 0 ? capacity : DefaultCapacity;
+			while (newCapacity < size + commandSize) {
+				newCapacity *= 2;
+			}
+			// Payloads are trivially copyable, moving the block moves them.
+			data = (byte*)(data == nullptr ? Memory::AllocateAligned(newCapacity, Alignment) : Memory::Reallocate(data, newCapacity));
+			capacity = newCapacity;
+		}
+		Command* command = reinterpret_cast<Command*>(data + size);
+		command->type = type;
+		command->size = (uint32)commandSize;
+		size += commandSize;
+		count += 1;
+		return command;
+	}
+}
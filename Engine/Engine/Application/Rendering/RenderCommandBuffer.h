@@ -0,0 +1,70 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Debug.h"
+#include <type_traits>
+
+namespace Engine {
+	/// @brief A frame worth of draw commands, recorded by the main thread and executed by the render thread.\n
+	/// Commands are packed one after another in a single growing block, so recording is a bump of an offset and executing is a walk over memory.
+	/// The block is kept between frames, a buffer stops allocating once it has seen the largest frame.
+	class RenderCommandBuffer final {
+	public:
+		/// @brief Every command and its payload start at a multiple of this, enough for SIMD types like TransformMatrix.
+		static inline constexpr sizeint Alignment = 16;
+		static inline constexpr sizeint DefaultCapacity = 64 * 1024;
+
+		struct alignas(Alignment) Command {
+			/// @brief Defined by the renderer executing the buffer.
+			uint32 type = 0;
+			/// @brief Bytes from this command to the next one, the payload included.
+			uint32 size = 0;
+
+			template<typename T>
+			const T& GetData() const {
+				return *reinterpret_cast<const T*>(this + 1);
+			}
+		};
+
+		RenderCommandBuffer(sizeint capacity = DefaultCapacity);
+		~RenderCommandBuffer();
+		RenderCommandBuffer(const RenderCommandBuffer&) = delete;
+		RenderCommandBuffer& operator=(const RenderCommandBuffer&) = delete;
+
+		/// @brief Append a command and get its payload to fill in place.
+		/// @tparam T Copied as raw bytes and never destructed, so it needs to be trivially copyable.
+		template<typename T>
+		T& Add(uint32 type) {
+			static_assert(std::is_trivially_copyable_v<T>, "Render command payloads are copied as bytes.");
+			static_assert(alignof(T) <= Alignment, "Render command payloads can't be aligned past RenderCommandBuffer::Alignment.");
+			T* payload = reinterpret_cast<T*>(Allocate(type, sizeof(T)) + 1);
+			Memory::Construct(payload);
+			return *payload;
+		}
+		template<typename T>
+		void Add(uint32 type, const T& data) {
+			Add<T>(type) = data;
+		}
+		/// @brief Append a command without payload.
+		void Add(uint32 type);
+
+		/// @brief Drop every command, keeping the memory.
+		void Clear();
+		int32 GetCount() const;
+		/// @brief Bytes taken by the commands.
+		sizeint GetSize() const;
+
+		/// @brief nullptr if there is no command.
+		const Command* GetFirst() const;
+		/// @brief nullptr past the last command.
+		const Command* GetNext(const Command* command) const;
+
+	private:
+		Command* Allocate(uint32 type, sizeint payloadSize);
+
+		byte* data = nullptr;
+		sizeint capacity = 0;
+		sizeint size = 0;
+		int32 count = 0;
+	};
+}
@@ -0,0 +1,81 @@
+#include "Engine/Application/Rendering/Renderer.h"
+#include "Engine/System/Profiler.h"
+
+namespace Engine {
+	Renderer::Renderer(int32 frameCount) :frameCount(frameCount), releasedCount(0) {
+		ERR_ASSERT(frameCount >= 2 && frameCount <= MaxFrameCount, u8"frameCount must be from 2 to MaxFrameCount.", this->frameCount = DefaultFrameCount);
+		// The first buffer records, the others wait to be recorded.
+		for (int32 i = 1; i < this->frameCount; i += 1) {
+			released.Push(i);
+			releasedCount.release();
+		}
+	}
+	Renderer::~Renderer() {
+		Stop();
+	}
+
+	void Renderer::Start() {
+		ERR_ASSERT(!running, u8"The renderer is already running.", return);
+		running = true;
+		thread = std::thread(&Renderer::RenderLoop, this);
+	}
+	void Renderer::Stop() {
+		if (!running) {
+			return;
+		}
+		submitted.Push(StopFrame);
+		submittedCount.release();
+		thread.join();
+		running = false;
+	}
+	bool Renderer::IsRunning() const {
+		return running;
+	}
+
+	RenderCommandBuffer& Renderer::GetRecordingBuffer() {
+		return buffers[recording];
+	}
+	void Renderer::SubmitFrame() {
+		PROFILE_SCOPE("Renderer::SubmitFrame");
+		if (!running) {
+			ExecuteCommands(buffers[recording]);
+			buffers[recording].Clear();
+			renderedFrameCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		submitted.Push(recording);
+		submittedCount.release();
+		// Waits here while the render thread is behind by every other buffer.
+		releasedCount.acquire();
+		released.Pop(recording);
+		buffers[recording].Clear();
+	}
+
+	int32 Renderer::GetFrameCount() const {
+		return frameCount;
+	}
+	uint64 Renderer::GetRenderedFrameCount() const {
+		return renderedFrameCount.load(std::memory_order_relaxed);
+	}
+
+	void Renderer::ExecuteCommands(const RenderCommandBuffer& commands) {}
+
+	void Renderer::RenderLoop() {
+		Profiler::SetCurrentThreadName(STRL("Render"));
+		while (true) {
+			submittedCount.acquire();
+			int32 frame = StopFrame;
+			submitted.Pop(frame);
+			if (frame == StopFrame) {
+				break;
+			}
+			{
+				PROFILE_SCOPE("Renderer::ExecuteCommands");
+				ExecuteCommands(buffers[frame]);
+			}
+			renderedFrameCount.fetch_add(1, std::memory_order_relaxed);
+			released.Push(frame);
+			releasedCount.release();
+		}
+	}
+}
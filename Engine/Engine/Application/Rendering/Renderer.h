@@ -1,9 +1,65 @@
 #pragma once
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/Collection/SpscRing.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/Application/Rendering/RenderCommandBuffer.h"
+#include <thread>
 
 namespace Engine {
-	class Renderer:public ManualObject {
-		Renderer() = default;
-		~Renderer() = default;
+	/// @brief Runs the draw commands of a frame on a dedicated render thread while the main thread records the next one.\n
+	/// The main thread fills GetRecordingBuffer() during the frame and hands it over with SubmitFrame().
+	/// With two frames, frame N is recorded while frame N-1 renders. With three, the main thread may run a whole frame ahead.\n
+	/// Backends override ExecuteCommands(), the base class only cycles the buffers.
+	class Renderer :public ManualObject {
+		REFLECTION_CLASS(::Engine::Renderer, ::Engine::ManualObject) {
+			REFLECTION_CLASS_INSTANTIABLE(false);
+		}
+
+	public:
+		static inline constexpr int32 DefaultFrameCount = 2;
+		static inline constexpr int32 MaxFrameCount = 3;
+
+		/// @param frameCount Command buffers cycled between the threads, from 2 to MaxFrameCount.
+		Renderer(int32 frameCount = DefaultFrameCount);
+		/// @brief Stops the render thread. Subclasses need to call Stop() in their own destructor, their ExecuteCommands() is gone by the time this one runs.
+		virtual ~Renderer();
+
+		/// @brief Start the render thread. Until then, SubmitFrame() executes the commands on the calling thread.
+		void Start();
+		/// @brief Let the render thread finish the submitted frames and join it.
+		void Stop();
+		bool IsRunning() const;
+
+		/// @brief Main thread only. The buffer of the frame being recorded.
+		RenderCommandBuffer& GetRecordingBuffer();
+		/// @brief Main thread only. Hand the recorded frame to the render thread and start recording the next one.\n
+		/// Blocks while every other buffer is still waiting to be rendered, so the main thread never runs more than frameCount - 1 frames ahead.
+		void SubmitFrame();
+
+		int32 GetFrameCount() const;
+		/// @brief Count of frames executed so far.
+		uint64 GetRenderedFrameCount() const;
+
+	protected:
+		/// @brief Render thread only, or the submitting thread when not started. Turn the commands of a frame into draws.
+		virtual void ExecuteCommands(const RenderCommandBuffer& commands);
+
+	private:
+		/// @brief Sent to the render thread to make it exit.
+		static inline constexpr int32 StopFrame = -1;
+
+		void RenderLoop();
+
+		int32 frameCount;
+		RenderCommandBuffer buffers[MaxFrameCount];
+		int32 recording = 0;
+		// Indices of the buffers handed to the render thread, and of the ones handed back.
+		SpscRing<int32> submitted{ MaxFrameCount + 1 };
+		SpscRing<int32> released{ MaxFrameCount + 1 };
+		Semaphore submittedCount{ 0 };
+		Semaphore releasedCount;
+		std::thread thread{};
+		bool running = false;
+		std::atomic<uint64> renderedFrameCount{ 0 };
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,104 @@
+#include "Engine/Application/Rendering/SpriteBatcher.h"
+#include "Engine/Application/Rendering/TextureAtlas.h"
+#include "Engine/System/Collection/Sorting.h"
+
+namespace Engine {
+	void SpriteBatcher::Clear() {
+		items.Clear();
+		order.Clear();
+		vertices.Clear();
+		batches.Clear();
+	}
+	void SpriteBatcher::SetAtlas(const TextureAtlas* atlas) {
+		this->atlas = atlas;
+	}
+	const TextureAtlas* SpriteBatcher::GetAtlas() const {
+		return atlas;
+	}
+	void SpriteBatcher::Add(const SpriteDrawItem& item) {
+		items.Add(item);
+		if (atlas != nullptr) {
+			atlas->Remap(items[items.GetCount() - 1]);
+		}
+	}
+	int32 SpriteBatcher::GetItemCount() const {
+		return items.GetCount();
+	}
+
+	void SpriteBatcher::Build() {
+		int32 count = items.GetCount();
+		order.Clear();
+		vertices.Clear();
+		batches.Clear();
+		order.RequireCapacity(count);
+		for (int32 i = 0; i < count; i += 1) {
+			order.Add(i);
+		}
+		// Indices are sorted instead of the items, each one moves 4 bytes instead of a whole item.
+		Sorting::RadixSort(order.GetRawElementPtr(), count, [this](int32 index) {
+			return GetSortKey(items[index]);
+		});
+
+		vertices.RequireCapacity(count * 4);
+		for (int32 i = 0; i < count; i += 1) {
+			const SpriteDrawItem& item = items[order[i]];
+			SpriteBatch* batch = batches.GetCount() > 0 ? &batches[batches.GetCount() - 1] : nullptr;
+			if (batch == nullptr || batch->layer != item.layer || batch->material != item.material || batch->texture != item.texture || batch->quadCount >= MaxBatchQuads) {
+				SpriteBatch next{};
+				next.layer = item.layer;
+				next.material = item.material;
+				next.texture = item.texture;
+				next.firstQuad = i;
+				batches.Add(next);
+				batch = &batches[batches.GetCount() - 1];
+			}
+			batch->quadCount += 1;
+
+			const float (&m)[3][2] = item.transform.matrix;
+			Vector2 axisX(m[0][0], m[0][1]);
+			Vector2 axisY(m[1][0], m[1][1]);
+			Vector2 corner = Vector2(m[2][0], m[2][1]) + axisX * item.offset.x + axisY * item.offset.y;
+			Vector2 width = axisX * item.size.x;
+			Vector2 height = axisY * item.size.y;
+
+			SpriteVertex vertex{};
+			vertex.color = item.color;
+			vertex.position = corner;
+			vertex.uv = item.uvMin;
+			vertices.Add(vertex);
+			vertex.position = corner + width;
+			vertex.uv = Vector2(item.uvMax.x, item.uvMin.y);
+			vertices.Add(vertex);
+			vertex.position = corner + width + height;
+			vertex.uv = item.uvMax;
+			vertices.Add(vertex);
+			vertex.position = corner + height;
+			vertex.uv = Vector2(item.uvMin.x, item.uvMax.y);
+			vertices.Add(vertex);
+		}
+	}
+	const List<SpriteVertex>& SpriteBatcher::GetVertices() const {
+		return vertices;
+	}
+	const List<SpriteBatch>& SpriteBatcher::GetBatches() const {
+		return batches;
+	}
+
+	void SpriteBatcher::BuildIndices(uint16* out, int32 quadCount) {
+		for (int32 i = 0; i < quadCount; i += 1) {
+			uint16 first = (uint16)((i % MaxBatchQuads) * 4);
+			out[i * 6 + 0] = first;
+			out[i * 6 + 1] = first + 1;
+			out[i * 6 + 2] = first + 2;
+			out[i * 6 + 3] = first + 2;
+			out[i * 6 + 4] = first + 3;
+			out[i * 6 + 5] = first;
+		}
+	}
+
+	uint64 SpriteBatcher::GetSortKey(const SpriteDrawItem& item) {
+		// Flipping the sign bit makes negative layers sort below the positive ones.
+		uint64 layer = (uint16)item.layer ^ 0x8000u;
+		return (layer << 48) | ((uint64)(item.material & 0xFFFFFF) << 24) | (uint64)(item.texture & 0xFFFFFF);
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Math/Vector.h"
+#include "Engine/System/Math/Color.h"
+#include "Engine/System/Math/Transform2.h"
+
+namespace Engine {
+	/// @brief A textured quad to draw, given in the local space of its transform.
+	struct SpriteDrawItem {
+		Transform2 transform{};
+		/// @brief The corner of the quad at uvMin, in local space.
+		Vector2 offset{};
+		Vector2 size = Vector2(1, 1);
+		Vector2 uvMin = Vector2(0, 0);
+		Vector2 uvMax = Vector2(1, 1);
+		Color color = Color::White;
+		/// @brief Layers are drawn lowest first, inside a layer the items are grouped by material then texture.
+		int16 layer = 0;
+		/// @brief Ids of the renderer, items sharing both of them and the layer are drawn together.
+		uint32 material = 0;
+		uint32 texture = 0;
+	};
+
+	class TextureAtlas;
+
+	struct SpriteVertex {
+		Vector2 position{};
+		Vector2 uv{};
+		Color color{};
+	};
+
+	/// @brief A run of quads sharing the same state, one draw call.
+	struct SpriteBatch {
+		int16 layer = 0;
+		uint32 material = 0;
+		uint32 texture = 0;
+		/// @brief The vertices of quad i are 4 * i to 4 * i + 3 in SpriteBatcher::GetVertices().
+		int32 firstQuad = 0;
+		int32 quadCount = 0;
+	};
+
+	/// @brief Merges the sprites of a frame into few draw calls.\n
+	/// Items are sorted by (layer, material, texture) with a radix sort, keeping the order they were added in among equal states,
+	/// then transformed into a single vertex array with a batch per run of the same state.
+	/// The order between different materials or textures of a layer isn't kept, put sprites that need to overlap in order on separate layers.
+	class SpriteBatcher final {
+	public:
+		/// @brief Batches are split past this count, so each fits 16-bit indices.
+		static inline constexpr int32 MaxBatchQuads = 65536 / 4;
+
+		/// @brief Drop the items, vertices and batches, keeping the memory.
+		void Clear();
+		/// @brief Items added from now on using a texture of the atlas draw from its page instead, see TextureAtlas::Remap(). nullptr to stop remapping.
+		void SetAtlas(const TextureAtlas* atlas);
+		const TextureAtlas* GetAtlas() const;
+		void Add(const SpriteDrawItem& item);
+		int32 GetItemCount() const;
+
+		/// @brief Sort the items added since Clear() and build the vertices and batches.
+		void Build();
+		/// @brief 4 per quad, counter-clockwise from the corner at uvMin: (uvMin.x, uvMin.y), (uvMax.x, uvMin.y), (uvMax.x, uvMax.y), (uvMin.x, uvMax.y).
+		const List<SpriteVertex>& GetVertices() const;
+		/// @brief In drawing order.
+		const List<SpriteBatch>& GetBatches() const;
+
+		/// @brief Fill the 6 indices of 2 triangles per quad, the same for every frame so it works as a static index buffer.
+		static void BuildIndices(uint16* out, int32 quadCount);
+
+	private:
+		/// @brief The layer in the top bits, then 24 bits of material and texture. Ids past 24 bits share keys but still get batches of their own.
+		static uint64 GetSortKey(const SpriteDrawItem& item);
+
+		const TextureAtlas* atlas = nullptr;
+		List<SpriteDrawItem> items{};
+		List<int32> order{};
+		List<SpriteVertex> vertices{};
+		List<SpriteBatch> batches{};
+	};
+}
@@ -0,0 +1,231 @@
+#include "Engine/Application/Rendering/TextureAtlas.h"
+#include "Engine/Application/Rendering/SpriteBatcher.h"
+
+namespace Engine {
+	TextureAtlas::TextureAtlas(uint32 firstPageTexture, int32 pageSize, int32 maxTextureSize, int32 padding, int32 maxPageCount)
+		:firstPageTexture(firstPageTexture), pageSize(pageSize), maxTextureSize(maxTextureSize), padding(padding), maxPageCount(maxPageCount) {
+		ERR_ASSERT(pageSize > 0, u8"pageSize must be larger than 0.", this->pageSize = DefaultPageSize);
+		ERR_ASSERT(padding >= 0, u8"padding cannot be negative.", this->padding = DefaultPadding);
+		ERR_ASSERT(maxPageCount > 0, u8"maxPageCount must be larger than 0.", this->maxPageCount = 1);
+		inverseSize = 1.0f / this->pageSize;
+	}
+
+	bool TextureAtlas::Add(uint32 texture, int32 width, int32 height) {
+		ERR_ASSERT(width > 0 && height > 0, u8"The size of the texture must be larger than 0.", return false);
+		if (entries.ContainsKey(texture)) {
+			return true;
+		}
+		if (width > maxTextureSize || height > maxTextureSize) {
+			return false;
+		}
+		int32 paddedWidth = width + 2 * padding;
+		int32 paddedHeight = height + 2 * padding;
+		if (paddedWidth > pageSize || paddedHeight > pageSize) {
+			return false;
+		}
+
+		Entry entry{};
+		entry.page = -1;
+		// The fullest pages first would pack tighter, but trying them in order keeps the early pages full and the late ones empty.
+		for (int32 i = 0; i < pages.GetCount(); i += 1) {
+			if (Place(pages[i], paddedWidth, paddedHeight, entry.rect)) {
+				entry.page = i;
+				break;
+			}
+		}
+		if (entry.page < 0) {
+			if (pages.GetCount() >= maxPageCount) {
+				return false;
+			}
+			Page page{};
+			page.free.Add(Rect{ 0, 0, pageSize, pageSize });
+			pages.Add(Memory::Move(page));
+			entry.page = pages.GetCount() - 1;
+			Place(pages[entry.page], paddedWidth, paddedHeight, entry.rect);
+		}
+		entries.Add(texture, entry);
+
+		AtlasCopy copy{};
+		copy.sourceTexture = texture;
+		copy.region = GetRegion(entry);
+		pendingCopies.Add(copy);
+		return true;
+	}
+	bool TextureAtlas::Remove(uint32 texture) {
+		Entry entry{};
+		if (!entries.TryGet(texture, entry)) {
+			return false;
+		}
+		entries.Remove(texture);
+		Release(pages[entry.page], entry.rect);
+		for (int32 i = pendingCopies.GetCount() - 1; i >= 0; i -= 1) {
+			if (pendingCopies[i].sourceTexture == texture) {
+				pendingCopies.RemoveAt(i);
+			}
+		}
+		return true;
+	}
+	bool TextureAtlas::Contains(uint32 texture) const {
+		return entries.ContainsKey(texture);
+	}
+	bool TextureAtlas::TryGetRegion(uint32 texture, AtlasRegion& result) const {
+		Entry entry{};
+		if (!entries.TryGet(texture, entry)) {
+			return false;
+		}
+		result = GetRegion(entry);
+		return true;
+	}
+	int32 TextureAtlas::GetTextureCount() const {
+		return entries.GetCount();
+	}
+
+	int32 TextureAtlas::GetPageSize() const {
+		return pageSize;
+	}
+	int32 TextureAtlas::GetPadding() const {
+		return padding;
+	}
+	int32 TextureAtlas::GetPageCount() const {
+		return pages.GetCount();
+	}
+	float TextureAtlas::GetPageOccupancy(int32 page) const {
+		ERR_ASSERT(page >= 0 && page < pages.GetCount(), u8"page out of bounds.", return 0);
+		return (float)pages[page].usedArea / ((float)pageSize * pageSize);
+	}
+
+	const List<AtlasCopy>& TextureAtlas::GetPendingCopies() const {
+		return pendingCopies;
+	}
+	void TextureAtlas::ClearPendingCopies() {
+		pendingCopies.Clear();
+	}
+
+	void TextureAtlas::Remap(SpriteDrawItem& item) const {
+		Entry entry{};
+		if (!entries.TryGet(item.texture, entry)) {
+			return;
+		}
+		AtlasRegion region = GetRegion(entry);
+		float x = region.x * inverseSize;
+		float y = region.y * inverseSize;
+		float width = region.width * inverseSize;
+		float height = region.height * inverseSize;
+		item.uvMin = Vector2(x + item.uvMin.x * width, y + item.uvMin.y * height);
+		item.uvMax = Vector2(x + item.uvMax.x * width, y + item.uvMax.y * height);
+		item.texture = region.pageTexture;
+	}
+
+	bool TextureAtlas::Place(Page& page, int32 width, int32 height, Rect& result) {
+		int32 best = -1;
+		int32 bestShort = 0;
+		int32 bestLong = 0;
+		for (int32 i = 0; i < page.free.GetCount(); i += 1) {
+			const Rect& candidate = page.free[i];
+			if (candidate.width < width || candidate.height < height) {
+				continue;
+			}
+			int32 leftWidth = candidate.width - width;
+			int32 leftHeight = candidate.height - height;
+			int32 shortSide = leftWidth < leftHeight ? leftWidth : leftHeight;
+			int32 longSide = leftWidth < leftHeight ? leftHeight : leftWidth;
+			if (best < 0 || shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+				best = i;
+				bestShort = shortSide;
+				bestLong = longSide;
+			}
+		}
+		if (best < 0) {
+			if (!page.fragmented) {
+				return false;
+			}
+			Rebuild(page);
+			return Place(page, width, height, result);
+		}
+		result = Rect{ page.free[best].x, page.free[best].y, width, height };
+		Split(page.free, result);
+		page.used.Add(result);
+		page.usedArea += width * height;
+		return true;
+	}
+	void TextureAtlas::Release(Page& page, const Rect& rect) {
+		for (int32 i = 0; i < page.used.GetCount(); i += 1) {
+			const Rect& used = page.used[i];
+			if (used.x == rect.x && used.y == rect.y) {
+				page.used[i] = page.used[page.used.GetCount() - 1];
+				page.used.RemoveAt(page.used.GetCount() - 1);
+				break;
+			}
+		}
+		page.usedArea -= rect.width * rect.height;
+		// No free rectangle overlaps a used one, so none can contain another here.
+		page.free.Add(rect);
+		// The freed rectangle is not maximal, larger ones spanning it and its neighbours are found again once a texture does not fit.
+		page.fragmented = page.used.GetCount() > 0;
+		if (!page.fragmented) {
+			page.free.Clear();
+			page.free.Add(Rect{ 0, 0, pageSize, pageSize });
+		}
+	}
+	void TextureAtlas::Rebuild(Page& page) {
+		page.free.Clear();
+		page.free.Add(Rect{ 0, 0, pageSize, pageSize });
+		for (int32 i = 0; i < page.used.GetCount(); i += 1) {
+			Split(page.free, page.used[i]);
+		}
+		page.fragmented = false;
+	}
+
+	void TextureAtlas::Split(List<Rect>& free, const Rect& used) {
+		int32 count = free.GetCount();
+		for (int32 i = 0; i < count;) {
+			Rect rect = free[i];
+			if (used.x >= rect.x + rect.width || used.x + used.width <= rect.x || used.y >= rect.y + rect.height || used.y + used.height <= rect.y) {
+				i += 1;
+				continue;
+			}
+			// Replace the rectangle with the up to 4 maximal ones around the used part.
+			free[i] = free[count - 1];
+			free.RemoveAt(count - 1);
+			count -= 1;
+			if (used.x > rect.x) {
+				free.Add(Rect{ rect.x, rect.y, used.x - rect.x, rect.height });
+			}
+			if (used.x + used.width < rect.x + rect.width) {
+				free.Add(Rect{ used.x + used.width, rect.y, rect.x + rect.width - used.x - used.width, rect.height });
+			}
+			if (used.y > rect.y) {
+				free.Add(Rect{ rect.x, rect.y, rect.width, used.y - rect.y });
+			}
+			if (used.y + used.height < rect.y + rect.height) {
+				free.Add(Rect{ rect.x, used.y + used.height, rect.width, rect.y + rect.height - used.y - used.height });
+			}
+		}
+
+		// Only the new rectangles can be redundant, the old ones were maximal inside the rectangles they were cut from.
+		auto contains = [](const Rect& outer, const Rect& inner) {
+			return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+		};
+		for (int32 i = free.GetCount() - 1; i >= count; i -= 1) {
+			for (int32 j = 0; j < free.GetCount(); j += 1) {
+				if (j != i && contains(free[j], free[i])) {
+					// The last one was checked already, it can take the place.
+					free[i] = free[free.GetCount() - 1];
+					free.RemoveAt(free.GetCount() - 1);
+					break;
+				}
+			}
+		}
+	}
+
+	AtlasRegion TextureAtlas::GetRegion(const Entry& entry) const {
+		AtlasRegion region{};
+		region.page = entry.page;
+		region.pageTexture = firstPageTexture + (uint32)entry.page;
+		region.x = entry.rect.x + padding;
+		region.y = entry.rect.y + padding;
+		region.width = entry.rect.width - 2 * padding;
+		region.height = entry.rect.height - 2 * padding;
+		return region;
+	}
+}
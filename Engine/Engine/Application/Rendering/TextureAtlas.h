@@ -0,0 +1,104 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+#include "Engine/System/Math/Vector.h"
+
+namespace Engine {
+	struct SpriteDrawItem;
+
+	/// @brief Where a texture was put in a TextureAtlas, in pixels of its page.
+	struct AtlasRegion {
+		/// @brief The renderer id of the page texture.
+		uint32 pageTexture = 0;
+		int32 page = -1;
+		int32 x = 0;
+		int32 y = 0;
+		int32 width = 0;
+		int32 height = 0;
+	};
+
+	/// @brief A copy of a texture into a page for the backend to do, then extending its edge pixels over the padding so filtering never picks up a neighbour.
+	struct AtlasCopy {
+		uint32 sourceTexture = 0;
+		AtlasRegion region{};
+	};
+
+	/// @brief Packs small textures into a few large pages, so sprites using different ones can be drawn in the same batch.\n
+	/// Every page keeps the maximal free rectangles left in it and places a texture where the shorter leftover side is the smallest (MaxRects, best short side fit).
+	/// Textures can be removed at any time for streamed content, a page which becomes empty is reset whole and a fragmented one is rebuilt from its textures when one does not fit.\n
+	/// The atlas only plans the layout. The backend creates a texture per page, does the copies of GetPendingCopies() and clears them.
+	/// Give SpriteBatcher::SetAtlas() the atlas and the sprites using atlased textures get the page texture and uvs inside their region.
+	class TextureAtlas final {
+	public:
+		static inline constexpr int32 DefaultPageSize = 2048;
+		/// @brief Larger textures are left out, they would waste too much of a page and rarely batch anyway.
+		static inline constexpr int32 DefaultMaxTextureSize = 256;
+		static inline constexpr int32 DefaultPadding = 2;
+
+		/// @param firstPageTexture Page i gets the renderer texture id firstPageTexture + i, the backend needs to keep a range of ids for them.
+		/// @param maxPageCount Textures which fit in none of this many pages are left out.
+		TextureAtlas(uint32 firstPageTexture, int32 pageSize = DefaultPageSize, int32 maxTextureSize = DefaultMaxTextureSize, int32 padding = DefaultPadding, int32 maxPageCount = 16);
+
+		/// @brief Find room for the texture, nothing happens if it is in the atlas already.
+		/// @return false if the texture is too large or no page has room for it, sprites keep drawing it on its own then.
+		bool Add(uint32 texture, int32 width, int32 height);
+		/// @brief Free the room of the texture, sprites draw it on its own again.
+		bool Remove(uint32 texture);
+		bool Contains(uint32 texture) const;
+		bool TryGetRegion(uint32 texture, AtlasRegion& result) const;
+		int32 GetTextureCount() const;
+
+		int32 GetPageSize() const;
+		int32 GetPadding() const;
+		/// @brief Pages created so far, empty ones are kept and filled first.
+		int32 GetPageCount() const;
+		/// @brief The share of the pixels of the page taken by textures and their padding.
+		float GetPageOccupancy(int32 page) const;
+
+		/// @brief The copies the backend has to do before drawing, in the order the textures were added.
+		const List<AtlasCopy>& GetPendingCopies() const;
+		void ClearPendingCopies();
+
+		/// @brief Move the uvs of the item into the region of its texture and make it use the page texture. Items of textures not in the atlas are left as they are.
+		void Remap(SpriteDrawItem& item) const;
+
+	private:
+		struct Rect {
+			int32 x = 0;
+			int32 y = 0;
+			int32 width = 0;
+			int32 height = 0;
+		};
+		struct Page {
+			// Maximal free rectangles, they overlap each other.
+			List<Rect> free{};
+			List<Rect> used{};
+			int32 usedArea = 0;
+			// Textures were removed since the free rectangles were last built from the used ones.
+			bool fragmented = false;
+		};
+		struct Entry {
+			int32 page = 0;
+			// With the padding.
+			Rect rect{};
+		};
+
+		bool Place(Page& page, int32 width, int32 height, Rect& result);
+		void Release(Page& page, const Rect& rect);
+		void Rebuild(Page& page);
+		/// @brief Cut the used rectangle out of the free ones and drop the pieces inside others.
+		static void Split(List<Rect>& free, const Rect& used);
+		AtlasRegion GetRegion(const Entry& entry) const;
+
+		uint32 firstPageTexture;
+		int32 pageSize;
+		int32 maxTextureSize;
+		int32 padding;
+		int32 maxPageCount;
+		float inverseSize;
+		List<Page> pages{};
+		FlatDictionary<uint32, Entry> entries{};
+		List<AtlasCopy> pendingCopies{};
+	};
+}
@@ -0,0 +1,67 @@
+#include "Engine/Application/Rendering/UploadRing.h"
+#include "Engine/System/Debug.h"
+
+namespace Engine {
+	bool UploadRing::Allocation::IsValid() const {
+		return data != nullptr;
+	}
+
+	UploadRing::UploadRing(void* mappedMemory, sizeint size, int32 partitionCount) :memory((byte*)mappedMemory), partitionCount(partitionCount) {
+		ERR_ASSERT(partitionCount > 0 && partitionCount <= MaxPartitionCount, u8"partitionCount must be from 1 to MaxPartitionCount.", this->partitionCount = 3);
+		ERR_ASSERT(mappedMemory != nullptr || size == 0, u8"mappedMemory is nullptr.", size = 0);
+		partitionSize = size / this->partitionCount;
+		// Nothing can be allocated before the first BeginFrame().
+		used.store(partitionSize, std::memory_order_relaxed);
+	}
+
+	bool UploadRing::BeginFrame(uint64 frame) {
+		ERR_ASSERT(frame > 0, u8"Frames count from 1.", return false);
+		int32 partition = (int32)(frame % partitionCount);
+		if (GetPendingFrame(frame) != 0) {
+			return false;
+		}
+		partitionFrames[partition] = frame;
+		current = memory + partition * partitionSize;
+		used.store(0, std::memory_order_release);
+		return true;
+	}
+	uint64 UploadRing::GetPendingFrame(uint64 frame) const {
+		uint64 previous = partitionFrames[frame % partitionCount];
+		return previous > completedFrame.load(std::memory_order_acquire) ? previous : 0;
+	}
+	void UploadRing::SetCompletedFrame(uint64 frame) {
+		// Fences may report out of order from different callbacks, only move forward.
+		uint64 known = completedFrame.load(std::memory_order_relaxed);
+		while (known < frame && !completedFrame.compare_exchange_weak(known, frame, std::memory_order_release, std::memory_order_relaxed)) {}
+	}
+	uint64 UploadRing::GetCompletedFrame() const {
+		return completedFrame.load(std::memory_order_acquire);
+	}
+
+	UploadRing::Allocation UploadRing::Allocate(sizeint size, sizeint alignment) {
+		ERR_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, u8"alignment must be a power of 2.", return Allocation());
+		sizeint begin = used.load(std::memory_order_relaxed);
+		sizeint aligned = 0;
+		do {
+			// Aligned as an address, the partitions don't need to start aligned.
+			aligned = (((sizeint)(current + begin) + alignment - 1) & ~(alignment - 1)) - (sizeint)current;
+			if (aligned + size > partitionSize) {
+				return Allocation();
+			}
+		} while (!used.compare_exchange_weak(begin, aligned + size, std::memory_order_relaxed));
+
+		Allocation result{};
+		result.data = current + aligned;
+		result.offset = (sizeint)(current - memory) + aligned;
+		result.size = size;
+		return result;
+	}
+
+	sizeint UploadRing::GetPartitionSize() const {
+		return partitionSize;
+	}
+	sizeint UploadRing::GetUsedSize() const {
+		sizeint value = used.load(std::memory_order_relaxed);
+		return value < partitionSize ? value : partitionSize;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+
+namespace Engine {
+	/// @brief Hands out per-frame upload space from a persistently mapped GPU buffer, so streaming vertices or uniforms needs no buffer creation or driver copy.\n
+	/// The buffer is split into a partition per frame in flight. A frame bump-allocates from its partition and may only start once the GPU is done with the frame that used the partition before.
+	/// The backend owns the memory and the fences: it passes the mapped pointer in and reports finished frames with SetCompletedFrame().\n
+	/// Allocate() is lock-free and may be called by any number of job workers during a frame, BeginFrame() must not run concurrently with it.
+	class UploadRing final {
+	public:
+		static inline constexpr int32 MaxPartitionCount = 4;
+		static inline constexpr sizeint DefaultAlignment = 16;
+
+		struct Allocation {
+			/// @brief nullptr if the partition of the frame is out of space.
+			void* data = nullptr;
+			/// @brief From the start of the buffer, for binding the range on the GPU.
+			sizeint offset = 0;
+			sizeint size = 0;
+
+			bool IsValid() const;
+		};
+
+		/// @param mappedMemory Kept mapped by the backend for the lifetime of the ring.
+		/// @param partitionCount Frames that may be in flight, usually the frame count of the Renderer plus the one the GPU is working on.
+		UploadRing(void* mappedMemory, sizeint size, int32 partitionCount = 3);
+		UploadRing(const UploadRing&) = delete;
+		UploadRing& operator=(const UploadRing&) = delete;
+
+		/// @brief Start allocating for the frame from its partition, dropping what the frame before it in the partition allocated.
+		/// @param frame Increases by 1 each frame.
+		/// @return false if the GPU is still reading the partition, wait on the fence of GetPendingFrame() and try again.
+		bool BeginFrame(uint64 frame);
+		/// @brief The frame the GPU needs to be done with before BeginFrame(frame) succeeds. 0 once it is.
+		uint64 GetPendingFrame(uint64 frame) const;
+		/// @brief Report that the GPU finished reading everything up to the frame, usually from a fence callback. Thread-safe.
+		void SetCompletedFrame(uint64 frame);
+		uint64 GetCompletedFrame() const;
+
+		/// @brief Thread-safe. Take space from the partition of the current frame.
+		/// @param alignment A power of 2.
+		Allocation Allocate(sizeint size, sizeint alignment = DefaultAlignment);
+
+		sizeint GetPartitionSize() const;
+		/// @brief Bytes taken from the partition of the current frame, alignment padding included.
+		sizeint GetUsedSize() const;
+
+	private:
+		byte* memory;
+		sizeint partitionSize;
+		int32 partitionCount;
+		// The frame each partition was last used by, 0 if none yet. Frames count from 1 so 0 stays free.
+		uint64 partitionFrames[MaxPartitionCount]{};
+		byte* current = nullptr;
+		alignas(ThreadUtil::CacheLineSize) std::atomic<sizeint> used{ 0 };
+		alignas(ThreadUtil::CacheLineSize) std::atomic<uint64> completedFrame{ 0 };
+	};
+}
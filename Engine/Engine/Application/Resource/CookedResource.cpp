@@ -0,0 +1,246 @@
+#include "Engine/Application/Resource/CookedResource.h"
+#include <cstdint>
+
+namespace Engine {
+#pragma region Layout
+	bool CookedResource::IsCookedPath(const String& path) {
+		std::string_view view = path.GetStringView();
+		size_t dot = view.find_last_of("./\\");
+		return dot != std::string_view::npos && view[dot] == '.' && view.substr(dot + 1) == std::string_view((const char*)Extension);
+	}
+	String CookedResource::GetCookedPath(const String& path) {
+		return path + STRL(".") + String(Extension);
+	}
+#pragma endregion
+
+#pragma region View
+	ResultCode CookedResourceView::Open(const IntrusivePtr<MappedFileStream>& file) {
+		Close();
+		ERR_ASSERT(file.GetRaw() != nullptr && file->IsValid(), u8"The file is not valid.", return ResultCode::InvalidArgument);
+		ResultCode r = Open(file->GetViewData(), file->GetLength());
+		if (r == ResultCode::OK) {
+			this->file = file;
+		}
+		return r;
+	}
+	ResultCode CookedResourceView::Open(const byte* data, int64 length) {
+		Close();
+		ERR_ASSERT(Stream::LocalEndianness == Stream::Endianness::Little, u8"Cooked resources are only read on little-endian machines.", return ResultCode::NotSupported);
+		ERR_ASSERT(data != nullptr && length >= (int64)sizeof(CookedResource::Header), u8"The data is too short for a cooked resource.", return ResultCode::InvalidArgument);
+		ERR_ASSERT((uintptr_t)data % alignof(CookedResource::Header) == 0, u8"The data is not aligned.", return ResultCode::InvalidArgument);
+
+		const CookedResource::Header* head = reinterpret_cast<const CookedResource::Header*>(data);
+		ERR_ASSERT(head->magic == CookedResource::Magic && head->version == CookedResource::Version, u8"The data is not a cooked resource of this version.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(head->fileSize == (uint64)length, u8"The size of the cooked resource doesn't match, it may be cut.", return ResultCode::InvalidArgument);
+
+		uint64 tableEnd = sizeof(CookedResource::Header) + (uint64)head->sectionCount * sizeof(CookedResource::Section);
+		ERR_ASSERT(tableEnd <= (uint64)length, u8"The sections of the cooked resource are out of the data.", return ResultCode::InvalidArgument);
+		const CookedResource::Section* table = reinterpret_cast<const CookedResource::Section*>(data + sizeof(CookedResource::Header));
+		// Sections are in the order of their offsets and don't overlap, so a relocation finds its with a binary search.
+		uint64 end = tableEnd;
+		for (int32 i = 0; i < head->sectionCount; i += 1) {
+			const CookedResource::Section& section = table[i];
+			uint32 alignment = section.alignment;
+			bool aligned = alignment > 0 && alignment <= CookedResource::MaxAlignment && (alignment & (alignment - 1)) == 0
+				&& section.offset % alignment == 0 && (uintptr_t)(data + section.offset) % alignment == 0;
+			bool inside = section.offset >= end && section.offset <= (uint64)length && section.size <= (uint64)length - section.offset;
+			ERR_ASSERT(aligned && inside, u8"A section of the cooked resource is not valid.", return ResultCode::InvalidArgument);
+			end = section.offset + section.size;
+		}
+		auto findSection = [table, head](uint64 offset, uint64 size) {
+			int32 low = 0;
+			int32 high = head->sectionCount;
+			while (low < high) {
+				int32 middle = low + (high - low) / 2;
+				if (table[middle].offset + table[middle].size <= offset) {
+					low = middle + 1;
+				} else {
+					high = middle;
+				}
+			}
+			return low < head->sectionCount && offset >= table[low].offset && size <= table[low].offset + table[low].size - offset;
+		};
+
+		uint64 relocationEnd = head->relocationOffset + (uint64)head->relocationCount * sizeof(CookedResource::Relocation);
+		bool tableInside = head->relocationOffset % alignof(CookedResource::Relocation) == 0 && head->relocationOffset >= end
+			&& head->relocationOffset <= (uint64)length && relocationEnd <= (uint64)length;
+		ERR_ASSERT(tableInside, u8"The relocations of the cooked resource are out of the data.", return ResultCode::InvalidArgument);
+		const CookedResource::Relocation* relocations = reinterpret_cast<const CookedResource::Relocation*>(data + head->relocationOffset);
+		for (uint32 i = 0; i < head->relocationCount; i += 1) {
+			const CookedResource::Relocation& relocation = relocations[i];
+			bool valid = relocation.offset % alignof(int64) == 0 && findSection(relocation.offset, sizeof(int64));
+			if (valid) {
+				int64 offset = 0;
+				std::memcpy(&offset, data + relocation.offset, sizeof(offset));
+				// Null pointers point nowhere, the others within a section whatever their length.
+				uint64 target = relocation.offset + (uint64)offset;
+				bool inside = offset >= 0 ? (uint64)offset <= (uint64)length - relocation.offset : (uint64)(-offset) <= relocation.offset;
+				bool aligned = relocation.alignment > 0 && (relocation.alignment & (relocation.alignment - 1)) == 0 && (uintptr_t)(data + target) % relocation.alignment == 0;
+				valid = offset == 0 || (inside && aligned && findSection(target, relocation.length));
+			}
+			ERR_ASSERT(valid, u8"A pointer of the cooked resource points out of its sections.", return ResultCode::InvalidArgument);
+		}
+
+		this->data = data;
+		this->length = length;
+		header = head;
+		sections = table;
+		return ResultCode::OK;
+	}
+	void CookedResourceView::Close() {
+		file = IntrusivePtr<MappedFileStream>();
+		data = nullptr;
+		length = 0;
+		header = nullptr;
+		sections = nullptr;
+	}
+	bool CookedResourceView::IsOpen() const {
+		return header != nullptr;
+	}
+
+	uint32 CookedResourceView::GetFormat() const {
+		return header == nullptr ? 0 : header->format;
+	}
+	uint32 CookedResourceView::GetFormatVersion() const {
+		return header == nullptr ? 0 : header->formatVersion;
+	}
+	int32 CookedResourceView::GetSectionCount() const {
+		return header == nullptr ? 0 : header->sectionCount;
+	}
+	uint32 CookedResourceView::GetSectionTag(int32 index) const {
+		ERR_ASSERT(index >= 0 && index < GetSectionCount(), u8"index out of bounds.", return 0);
+		return sections[index].tag;
+	}
+	int32 CookedResourceView::FindSection(uint32 tag) const {
+		for (int32 i = 0; i < GetSectionCount(); i += 1) {
+			if (sections[i].tag == tag) {
+				return i;
+			}
+		}
+		return -1;
+	}
+	const byte* CookedResourceView::GetSectionData(int32 index) const {
+		ERR_ASSERT(index >= 0 && index < GetSectionCount(), u8"index out of bounds.", return nullptr);
+		return data + sections[index].offset;
+	}
+	int64 CookedResourceView::GetSectionSize(int32 index) const {
+		ERR_ASSERT(index >= 0 && index < GetSectionCount(), u8"index out of bounds.", return 0);
+		return (int64)sections[index].size;
+	}
+#pragma endregion
+
+#pragma region Writer
+	CookedResourceWriter::CookedResourceWriter(uint32 format, uint32 formatVersion) :format(format), formatVersion(formatVersion) {}
+
+	uint32 CookedResourceWriter::GetFormat() const {
+		return format;
+	}
+	void CookedResourceWriter::SetFormatVersion(uint32 formatVersion) {
+		this->formatVersion = formatVersion;
+	}
+	uint32 CookedResourceWriter::GetFormatVersion() const {
+		return formatVersion;
+	}
+
+	int32 CookedResourceWriter::AddSection(uint32 tag, int32 alignment) {
+		bool valid = alignment > 0 && alignment <= CookedResource::MaxAlignment && (alignment & (alignment - 1)) == 0;
+		ERR_ASSERT(valid, u8"alignment must be a power of 2 up to 4096.", alignment = CookedResource::DefaultAlignment);
+		ERR_ASSERT(sections.GetCount() < UINT16_MAX, u8"Too many sections.", return -1);
+		sections.Add(PendingSection{ tag, alignment, List<byte>() });
+		return sections.GetCount() - 1;
+	}
+	int32 CookedResourceWriter::GetSectionCount() const {
+		return sections.GetCount();
+	}
+	int64 CookedResourceWriter::GetSectionSize(int32 section) const {
+		ERR_ASSERT(section >= 0 && section < sections.GetCount(), u8"section out of bounds.", return 0);
+		return sections[section].data.GetCount();
+	}
+
+	int64 CookedResourceWriter::Append(int32 section, const void* data, int64 length, int32 alignment) {
+		ERR_ASSERT(section >= 0 && section < sections.GetCount(), u8"section out of bounds.", return -1);
+		PendingSection& pending = sections[section];
+		ERR_ASSERT(alignment > 0 && alignment <= pending.alignment && (alignment & (alignment - 1)) == 0, u8"alignment must be a power of 2 up to the one of the section.", return -1);
+		ERR_ASSERT(length >= 0 && (data != nullptr || length == 0), u8"data is not valid.", return -1);
+
+		int64 offset = ((int64)pending.data.GetCount() + alignment - 1) & ~(int64)(alignment - 1);
+		ERR_ASSERT(offset + length <= INT32_MAX, u8"The section is too large.", return -1);
+		int32 start = pending.data.GetCount();
+		pending.data.SetCount((int32)(offset + length));
+		std::memset(pending.data.GetRawElementPtr() + start, 0, (sizeint)(offset - start));
+		if (length > 0) {
+			std::memcpy(pending.data.GetRawElementPtr() + offset, data, (sizeint)length);
+		}
+		return offset;
+	}
+	byte* CookedResourceWriter::GetData(int32 section, int64 offset) {
+		ERR_ASSERT(section >= 0 && section < sections.GetCount(), u8"section out of bounds.", return nullptr);
+		ERR_ASSERT(offset >= 0 && offset <= sections[section].data.GetCount(), u8"offset out of the section.", return nullptr);
+		return sections[section].data.GetRawElementPtr() + offset;
+	}
+
+	ResultCode CookedResourceWriter::Link(int32 section, int64 offset, int32 targetSection, int64 targetOffset, int64 length, int32 alignment) {
+		ERR_ASSERT(section >= 0 && section < sections.GetCount() && targetSection >= 0 && targetSection < sections.GetCount(), u8"section out of bounds.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(sections[section].alignment >= (int32)alignof(int64) && offset % alignof(int64) == 0, u8"The pointer is not aligned.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(offset >= 0 && offset + (int64)sizeof(int64) <= GetSectionSize(section), u8"The pointer is out of the section.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(targetOffset >= 0 && length >= 0 && targetOffset + length <= GetSectionSize(targetSection), u8"The target is out of its section.", return ResultCode::InvalidArgument);
+		bool aligned = alignment > 0 && alignment <= sections[targetSection].alignment && (alignment & (alignment - 1)) == 0 && targetOffset % alignment == 0;
+		ERR_ASSERT(aligned, u8"The target is not aligned.", return ResultCode::InvalidArgument);
+		links.Add(PendingLink{ section, offset, targetSection, targetOffset, length, alignment });
+		return ResultCode::OK;
+	}
+
+	ResultCode CookedResourceWriter::Write(Stream& stream) const {
+		ERR_ASSERT(stream.CanWrite(), u8"The stream cannot write.", return ResultCode::NoPermission);
+
+		// Everything is placed first, then the file is assembled in memory with the pointers filled in.
+		List<uint64> offsets{};
+		offsets.SetCount(sections.GetCount());
+		uint64 offset = sizeof(CookedResource::Header) + (uint64)sections.GetCount() * sizeof(CookedResource::Section);
+		for (int32 i = 0; i < sections.GetCount(); i += 1) {
+			offset = (offset + sections[i].alignment - 1) & ~(uint64)(sections[i].alignment - 1);
+			offsets[i] = offset;
+			offset += (uint64)sections[i].data.GetCount();
+		}
+
+		CookedResource::Header header{};
+		header.magic = CookedResource::Magic;
+		header.version = CookedResource::Version;
+		header.sectionCount = (uint16)sections.GetCount();
+		header.format = format;
+		header.formatVersion = formatVersion;
+		header.relocationOffset = (offset + alignof(CookedResource::Relocation) - 1) & ~(uint64)(alignof(CookedResource::Relocation) - 1);
+		header.relocationCount = (uint32)links.GetCount();
+		header.fileSize = header.relocationOffset + (uint64)links.GetCount() * sizeof(CookedResource::Relocation);
+		ERR_ASSERT(header.fileSize <= INT32_MAX, u8"The cooked resource is too large.", return ResultCode::NotSupported);
+
+		List<byte> file{};
+		file.SetCount((int32)header.fileSize);
+		byte* out = file.GetRawElementPtr();
+		std::memset(out, 0, (sizeint)header.fileSize);
+		std::memcpy(out, &header, sizeof(header));
+		for (int32 i = 0; i < sections.GetCount(); i += 1) {
+			CookedResource::Section section{};
+			section.offset = offsets[i];
+			section.size = (uint64)sections[i].data.GetCount();
+			section.tag = sections[i].tag;
+			section.alignment = (uint32)sections[i].alignment;
+			std::memcpy(out + sizeof(CookedResource::Header) + i * sizeof(CookedResource::Section), &section, sizeof(section));
+			if (section.size > 0) {
+				std::memcpy(out + section.offset, sections[i].data.GetRawElementPtr(), (sizeint)section.size);
+			}
+		}
+		for (int32 i = 0; i < links.GetCount(); i += 1) {
+			const PendingLink& link = links[i];
+			CookedResource::Relocation relocation{};
+			relocation.offset = offsets[link.section] + (uint64)link.offset;
+			relocation.length = (uint32)link.length;
+			relocation.alignment = (uint32)link.alignment;
+			int64 value = (int64)(offsets[link.targetSection] + (uint64)link.targetOffset) - (int64)relocation.offset;
+			std::memcpy(out + relocation.offset, &value, sizeof(value));
+			std::memcpy(out + header.relocationOffset + i * sizeof(CookedResource::Relocation), &relocation, sizeof(relocation));
+		}
+		return stream.WriteBytes(file);
+	}
+#pragma endregion
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include "Engine/System/File/FileStream.h"
+#include "Engine/System/Collection/List.h"
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+
+namespace Engine {
+	/// @brief The layout of a cooked resource, a resource converted offline to what it is in memory, so loading it is mapping its file.\n
+	/// A header, the table of sections, each section aligned as it asks, then the table of relocations.
+	/// Data refers to other data with CookedPointer, an offset from the pointer itself, so the file is used in place wherever it is mapped.
+	/// Every pointer is listed in the relocations with the span it points to, checked once when opened, see CookedResourceView::Open().\n
+	/// Everything is little-endian. The sections hold what the handler of the format puts there, told apart by their tags.
+	class CookedResource final {
+	public:
+		static inline constexpr uint32 Magic = 0x4B4F4F43; // "COOK"
+		static inline constexpr uint16 Version = 1;
+		static inline constexpr int32 DefaultAlignment = 16;
+		/// @brief Of a section, the size of a page.
+		static inline constexpr int32 MaxAlignment = 4096;
+		/// @brief Of the cooked files, after the one of their source: "icon.png.cooked".
+		static inline constexpr const u8char* Extension = u8"cooked";
+
+		struct Header {
+			uint32 magic;
+			uint16 version;
+			uint16 sectionCount;
+			/// @brief Which handler loads it, see ResourceFileHandler::GetCookedFormat().
+			uint32 format;
+			/// @brief The version of the data of the format, for the handler to refuse old files.
+			uint32 formatVersion;
+			/// @brief Of the whole file, to tell a cut one.
+			uint64 fileSize;
+			/// @brief An 8-byte aligned offset, followed by relocationCount relocations.
+			uint64 relocationOffset;
+			uint32 relocationCount;
+			uint32 padding;
+		};
+		/// @brief Follows the header.
+		struct Section {
+			uint64 offset;
+			uint64 size;
+			uint32 tag;
+			/// @brief Of the offset, a power of 2 up to MaxAlignment.
+			uint32 alignment;
+		};
+		struct Relocation {
+			/// @brief Of the pointer in the file.
+			uint64 offset;
+			/// @brief Of what it points to, which stays within one section.
+			uint32 length;
+			/// @brief Of what it points to, a power of 2.
+			uint32 alignment;
+		};
+		static_assert(sizeof(Header) == 40 && sizeof(Section) == 24 && sizeof(Relocation) == 16, "The layout must not depend on the compiler.");
+
+		/// @brief A tag or a format from 4 characters, as "TEXR".
+		static constexpr uint32 MakeTag(const char (&name)[5]) {
+			return (uint32)(byte)name[0] | ((uint32)(byte)name[1] << 8) | ((uint32)(byte)name[2] << 16) | ((uint32)(byte)name[3] << 24);
+		}
+		/// @brief Whether the extension of the path is the cooked one.
+		static bool IsCookedPath(const String& path);
+		/// @brief Where the source at the path is cooked to.
+		static String GetCookedPath(const String& path);
+	};
+
+	/// @brief A pointer stored as the offset to its target from itself, 0 for nullptr. Only valid inside a cooked file.
+	template<typename T>
+	struct CookedPointer {
+		int64 offset;
+
+		const T* Get() const {
+			return offset == 0 ? nullptr : reinterpret_cast<const T*>(reinterpret_cast<const byte*>(this) + offset);
+		}
+		const T* operator->() const {
+			return Get();
+		}
+		const T& operator*() const {
+			return *Get();
+		}
+		bool IsNull() const {
+			return offset == 0;
+		}
+	};
+
+	/// @brief Elements stored elsewhere in a cooked file.
+	template<typename T>
+	struct CookedArray {
+		CookedPointer<T> data;
+		int64 count;
+
+		int64 GetCount() const {
+			return count;
+		}
+		const T& operator[](int64 index) const {
+			FATAL_ASSERT(index >= 0 && index < count, u8"index out of bounds.");
+			return data.Get()[index];
+		}
+		const T* begin() const {
+			return data.Get();
+		}
+		const T* end() const {
+			return data.Get() + count;
+		}
+	};
+
+	/// @brief A cooked file, checked once and then read in place through its sections.\n
+	/// Copies share the mapping, which stays alive as long as one of them does. A resource using its data keeps a copy.
+	class CookedResourceView final {
+	public:
+		/// @brief Check the header, the sections and every relocation, then use the view of the mapped file.
+		/// @return ResultCode::InvalidArgument if it is not a valid cooked file, and nothing is opened then.
+		ResultCode Open(const IntrusivePtr<MappedFileStream>& file);
+		/// @brief Same as the mapped file, over memory kept alive by the caller and aligned for the largest section alignment.
+		ResultCode Open(const byte* data, int64 length);
+		void Close();
+		bool IsOpen() const;
+
+		uint32 GetFormat() const;
+		uint32 GetFormatVersion() const;
+		int32 GetSectionCount() const;
+		uint32 GetSectionTag(int32 index) const;
+		/// @brief The index of the first section with the tag, -1 if there is none.
+		int32 FindSection(uint32 tag) const;
+		const byte* GetSectionData(int32 index) const;
+		int64 GetSectionSize(int32 index) const;
+
+		/// @brief The object at the start of the section, nullptr if the section is too small or not aligned for it.
+		template<typename T>
+		const T* GetRoot(int32 index) const {
+			static_assert(std::is_trivially_copyable_v<T>, "Cooked data must be trivially copyable.");
+			if (GetSectionSize(index) < (int64)sizeof(T) || (uintptr_t)GetSectionData(index) % alignof(T) != 0) {
+				return nullptr;
+			}
+			return reinterpret_cast<const T*>(GetSectionData(index));
+		}
+
+	private:
+		IntrusivePtr<MappedFileStream> file{};
+		const byte* data = nullptr;
+		int64 length = 0;
+		const CookedResource::Header* header = nullptr;
+		const CookedResource::Section* sections = nullptr;
+	};
+
+	/// @brief Builds a cooked file in memory, for the cook step of the resource handlers.\n
+	/// Data is appended to sections and linked with offsets within them, the offsets in the file are only known when written.
+	class CookedResourceWriter final {
+	public:
+		CookedResourceWriter(uint32 format, uint32 formatVersion = 0);
+
+		uint32 GetFormat() const;
+		void SetFormatVersion(uint32 formatVersion);
+		uint32 GetFormatVersion() const;
+
+		/// @param alignment Of the start of the section, a power of 2 up to CookedResource::MaxAlignment.
+		/// @return The index of the section.
+		int32 AddSection(uint32 tag, int32 alignment = CookedResource::DefaultAlignment);
+		int32 GetSectionCount() const;
+		int64 GetSectionSize(int32 section) const;
+
+		/// @brief Copy the bytes to the end of the section, padded with zeros to the alignment, which can't be larger than the one of the section.
+		/// @return The offset of the bytes in the section, -1 if the arguments are not valid.
+		int64 Append(int32 section, const void* data, int64 length, int32 alignment = 1);
+		template<typename T>
+		int64 Append(int32 section, const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>, "Cooked data must be trivially copyable.");
+			return Append(section, &value, (int64)sizeof(T), (int32)alignof(T));
+		}
+		template<typename T>
+		int64 AppendArray(int32 section, const T* values, int64 count) {
+			static_assert(std::is_trivially_copyable_v<T>, "Cooked data must be trivially copyable.");
+			return Append(section, values, count * (int64)sizeof(T), (int32)alignof(T));
+		}
+		/// @brief The bytes appended so far, to fill in what was appended as a placeholder. Invalid after the next Append().
+		byte* GetData(int32 section, int64 offset);
+
+		/// @brief Point the CookedPointer at the offset in the section to the length bytes at the target offset of the target section,
+		/// appended before with the alignment. Pointers need a section aligned to 8 at least.
+		ResultCode Link(int32 section, int64 offset, int32 targetSection, int64 targetOffset, int64 length, int32 alignment = 1);
+		/// @brief Point the CookedArray at the offset in the section to count elements at the target offset of the target section.
+		template<typename T>
+		ResultCode LinkArray(int32 section, int64 offset, int32 targetSection, int64 targetOffset, int64 count) {
+			byte* at = GetData(section, offset);
+			ERR_ASSERT(at != nullptr && offset + (int64)sizeof(CookedArray<T>) <= GetSectionSize(section), u8"The array is out of the section.", return ResultCode::InvalidArgument);
+			int64 value = count;
+			std::memcpy(at + offsetof(CookedArray<T>, count), &value, sizeof(value));
+			return Link(section, offset + (int64)offsetof(CookedArray<T>, data), targetSection, targetOffset, count * (int64)sizeof(T), (int32)alignof(T));
+		}
+
+		/// @brief Write the whole file from the current position of the stream, which doesn't need random access.
+		ResultCode Write(Stream& stream) const;
+
+	private:
+		struct PendingSection {
+			uint32 tag;
+			int32 alignment;
+			List<byte> data;
+		};
+		struct PendingLink {
+			int32 section;
+			int64 offset;
+			int32 targetSection;
+			int64 targetOffset;
+			int64 length;
+			int32 alignment;
+		};
+
+		uint32 format;
+		uint32 formatVersion;
+		List<PendingSection> sections{};
+		List<PendingLink> links{};
+	};
+}
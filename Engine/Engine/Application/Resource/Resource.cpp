@@ -1,6 +1,21 @@
 #include "Engine/Application/Resource/Resource.h"
+#include "Engine/Application/Resource/CookedResource.h"
+#include "Engine/System/File/FileSystem.h"
+#include "Engine/System/File/FileWatcher.h"
 
 namespace Engine {
+	Resource::~Resource() {
+		if (cacheOwner != nullptr) {
+			cacheOwner->Forget(this);
+		}
+	}
+	const String& Resource::GetPath() const {
+		return path;
+	}
+	ResultCode Resource::ReloadFrom(Resource& fresh) {
+		return ResultCode::NotSupported;
+	}
+
 	bool ResourceFileHandler::CanHandle(const String& extension) const {
 		for (const auto& v : extensions) {
 			if (v == extension) {
@@ -15,4 +30,599 @@ namespace Engine {
 		}
 		return extensions.GetCount();
 	}
-}
\ No newline at end of file
+	bool ResourceFileHandler::CanLoadFromData() const {
+		return false;
+	}
+	ResultCode ResourceFileHandler::LoadFromData(const String& path, const List<byte>& data, IntrusivePtr<Resource>& result) const {
+		return ResultCode::NotSupported;
+	}
+	void ResourceFileHandler::GetDependencies(const String& path, const List<byte>& data, List<String>& result) const {}
+	uint32 ResourceFileHandler::GetCookedFormat() const {
+		return 0;
+	}
+	ResultCode ResourceFileHandler::Cook(const String& path, const List<byte>& source, CookedResourceWriter& result) const {
+		return ResultCode::NotSupported;
+	}
+	ResultCode ResourceFileHandler::LoadCooked(const String& path, const CookedResourceView& view, IntrusivePtr<Resource>& result) const {
+		return ResultCode::NotSupported;
+	}
+
+	bool ResourceLoad::IsDone() const {
+		return stage.load(std::memory_order_acquire) == Stage::Done;
+	}
+	ResourceLoad::Stage ResourceLoad::GetStage() const {
+		return stage.load(std::memory_order_acquire);
+	}
+	float ResourceLoad::GetProgress() const {
+		Stage current = stage.load(std::memory_order_acquire);
+		if (current == Stage::Done) {
+			return 1.0f;
+		}
+		if (current == Stage::Reading) {
+			return 0.0f;
+		}
+		// Read, half way for the resource itself.
+		float progress = 0.5f;
+		if (current == Stage::Decoding && dependencies.GetCount() == 0) {
+			return progress;
+		}
+		for (const auto& dependency : dependencies) {
+			progress += dependency->GetProgress();
+		}
+		return progress / (dependencies.GetCount() + 1);
+	}
+	ResultCode ResourceLoad::GetResult() const {
+		ERR_ASSERT(IsDone(), u8"The load is not done yet.", return ResultCode::UnknownError);
+		return result;
+	}
+	const IntrusivePtr<Resource>& ResourceLoad::GetResource() const {
+		static const IntrusivePtr<Resource> none{};
+		return IsDone() ? resource : none;
+	}
+	const String& ResourceLoad::GetPath() const {
+		return path;
+	}
+	Job::Priority ResourceLoad::GetPriority() const {
+		return priority;
+	}
+	void ResourceLoad::Cancel() {
+		cancelled.store(true, std::memory_order_release);
+	}
+	bool ResourceLoad::IsCancelled() const {
+		return cancelled.load(std::memory_order_acquire);
+	}
+
+	ResourceSystem::ResourceSystem(FileSystem* fileSystem, JobSystem* jobSystem) :fileSystem(fileSystem), jobSystem(jobSystem) {}
+
+	ResourceSystem::~ResourceSystem() {
+		List<IntrusivePtr<Resource>> released{};
+		List<Reload> done{};
+		SimpleLock<Mutex> lock(mutex);
+		ERR_ASSERT(loading.GetCount() == 0, u8"Destroyed while resources are still loading.", {});
+		ERR_ASSERT(reloading.GetCount() == 0, u8"Destroyed while resources are still reloading.", {});
+		done = Memory::Move(reloaded);
+		for (const auto& pair : cache) {
+			pair.value->cacheOwner = nullptr;
+		}
+		cache.Clear();
+		released = Memory::Move(retained);
+	}
+
+	void ResourceSystem::AddFileHandler(const SharedPtr<ResourceFileHandler>& handler) {
+		ERR_ASSERT(handler != nullptr, u8"handler cannot be null.", return);
+		List<String> extensions{};
+		handler->GetSupportedExtensions(extensions);
+		uint32 format = handler->GetCookedFormat();
+		SimpleLock<ReadWriteLock> lock(handlersLock);
+		for (const auto& extension : extensions) {
+			fileHandlers.Set(extension, handler);
+		}
+		if (format != 0) {
+			cookedHandlers.Set(format, handler);
+		}
+	}
+	ResourceFileHandler* ResourceSystem::GetFileHandler(const String& path, SharedPtr<ResourceFileHandler>& holder) const {
+		// The extension of the last part of the path.
+		std::string_view view = path.GetStringView();
+		size_t dot = view.find_last_of("./\\");
+		if (dot != std::string_view::npos && view[dot] == '.' && dot + 1 < view.size()) {
+			String extension = path.Substring((int32)dot + 1, path.GetCount() - (int32)dot - 1);
+			SharedLock<ReadWriteLock> lock(handlersLock);
+			if (fileHandlers.TryGet(extension, holder)) {
+				return holder.GetRaw();
+			}
+		}
+		return defaultFileHandler.GetRaw();
+	}
+
+	ResultCode ResourceSystem::Load(const String& path, IntrusivePtr<Resource>& result) {
+		// Declared before the locks, so what they let go of is freed after the locks are released.
+		List<IntrusivePtr<Resource>> released{};
+		IntrusivePtr<Resource> loaded{};
+		{
+			SimpleLock<Mutex> lock(mutex);
+			loaded = TryGetCached(path);
+			if (loaded.GetRaw() != nullptr) {
+				Retain(loaded, released);
+			}
+		}
+		if (loaded.GetRaw() != nullptr) {
+			result = loaded;
+			return ResultCode::OK;
+		}
+
+		ResultCode r = LoadUncached(path, loaded);
+		if (r != ResultCode::OK) {
+			return r;
+		}
+
+		IntrusivePtr<Resource> cached{};
+		{
+			SimpleLock<Mutex> lock(mutex);
+			cached = AddCached(path, loaded, released);
+		}
+		result = cached;
+		return ResultCode::OK;
+	}
+	ResultCode ResourceSystem::LoadUncached(const String& path, IntrusivePtr<Resource>& result) const {
+		ResultCode r = ResultCode::OK;
+		if (CookedResource::IsCookedPath(path)) {
+			r = LoadCookedFile(path, result);
+		} else {
+			SharedPtr<ResourceFileHandler> holder{};
+			ResourceFileHandler* handler = GetFileHandler(path, holder);
+			ERR_ASSERT(handler != nullptr, u8"No file handler takes the extension of the path.", return ResultCode::NotSupported);
+			r = handler->Load(path, result);
+		}
+		if (r != ResultCode::OK) {
+			return r;
+		}
+		ERR_ASSERT(result.GetRaw() != nullptr, u8"The file handler returned no resource.", return ResultCode::InvalidArgument);
+		return ResultCode::OK;
+	}
+	ResultCode ResourceSystem::LoadCookedFile(const String& path, IntrusivePtr<Resource>& result) const {
+		ERR_ASSERT(fileSystem != nullptr, u8"Cooked files are mapped by the FileSystem, there is none.", return ResultCode::NotSupported);
+		auto mapped = fileSystem->MapFile(path);
+		if (mapped.result != ResultCode::OK) {
+			return mapped.result;
+		}
+		CookedResourceView view{};
+		ResultCode r = view.Open(mapped.value);
+		if (r != ResultCode::OK) {
+			return r;
+		}
+
+		SharedPtr<ResourceFileHandler> handler{};
+		{
+			SharedLock<ReadWriteLock> lock(handlersLock);
+			cookedHandlers.TryGet(view.GetFormat(), handler);
+		}
+		ERR_ASSERT(handler != nullptr, u8"No file handler takes the format of the cooked file.", return ResultCode::NotSupported);
+		return handler->LoadCooked(path, view, result);
+	}
+	ResultCode ResourceSystem::Cook(const String& sourcePath, const String& cookedPath) {
+		ERR_ASSERT(fileSystem != nullptr, u8"Cooking reads and writes with the FileSystem, there is none.", return ResultCode::NotSupported);
+		SharedPtr<ResourceFileHandler> holder{};
+		ResourceFileHandler* handler = GetFileHandler(sourcePath, holder);
+		ERR_ASSERT(handler != nullptr, u8"No file handler takes the extension of the path.", return ResultCode::NotSupported);
+		uint32 format = handler->GetCookedFormat();
+		if (format == 0) {
+			return ResultCode::NotSupported;
+		}
+
+		List<byte> source{};
+		{
+			auto opened = fileSystem->OpenFile(sourcePath, FileStream::OpenMode::ReadOnly);
+			if (opened.result != ResultCode::OK) {
+				return opened.result;
+			}
+			int64 length = opened.value->GetLength();
+			ERR_ASSERT(length >= 0 && length <= INT32_MAX, u8"The source file is too large.", opened.value->Close(); return ResultCode::NotSupported);
+			int32 read = opened.value->ReadBytes((int32)length, source);
+			opened.value->Close();
+			if (read != length) {
+				return ResultCode::UnknownError;
+			}
+		}
+
+		CookedResourceWriter writer(format);
+		ResultCode r = handler->Cook(sourcePath, source, writer);
+		if (r != ResultCode::OK) {
+			return r;
+		}
+		auto created = fileSystem->OpenFile(cookedPath, FileStream::OpenMode::WriteTruncate);
+		if (created.result != ResultCode::OK) {
+			return created.result;
+		}
+		r = writer.Write(*created.value.GetRaw());
+		created.value->Close();
+		return r;
+	}
+	IntrusivePtr<Resource> ResourceSystem::AddCached(const String& path, const IntrusivePtr<Resource>& loaded, List<IntrusivePtr<Resource>>& released) {
+		// Another thread may have loaded it meanwhile, the first one stays.
+		IntrusivePtr<Resource> cached = TryGetCached(path);
+		if (cached.GetRaw() == nullptr) {
+			cached = loaded;
+			if (loaded->cacheOwner == nullptr) {
+				loaded->path = path;
+				loaded->cacheOwner = this;
+				cache.Set(path, loaded.GetRaw());
+			}
+		}
+		Retain(cached, released);
+		return cached;
+	}
+
+	SharedPtr<ResourceLoad> ResourceSystem::LoadAsync(const String& path, Job::Priority priority) {
+		return StartLoad(path, priority);
+	}
+	int32 ResourceSystem::GetLoadingCount() const {
+		SimpleLock<Mutex> lock(mutex);
+		return loading.GetCount();
+	}
+	SharedPtr<ResourceLoad> ResourceSystem::StartLoad(const String& path, Job::Priority priority) {
+		List<IntrusivePtr<Resource>> released{};
+		SharedPtr<ResourceLoad> load{};
+		{
+			SimpleLock<Mutex> lock(mutex);
+			if (loading.TryGet(path, load)) {
+				return load;
+			}
+			load = SharedPtr<ResourceLoad>::Create();
+			load->system = this;
+			load->path = path;
+			load->priority = priority;
+			load->resource = TryGetCached(path);
+			if (load->resource.GetRaw() != nullptr) {
+				Retain(load->resource, released);
+				load->finished = true;
+				load->stage.store(ResourceLoad::Stage::Done, std::memory_order_release);
+				return load;
+			}
+			loading.Set(path, load);
+		}
+
+		if (CookedResource::IsCookedPath(path)) {
+			// Mapping costs next to nothing, the reads happen as the handler touches the data.
+			load->stage.store(ResourceLoad::Stage::Decoding, std::memory_order_release);
+			RunLoadJob(load->priority, [this, load]() {
+				if (load->IsCancelled()) {
+					Finish(load, ResultCode::Cancelled, IntrusivePtr<Resource>());
+					return;
+				}
+				IntrusivePtr<Resource> resource{};
+				ResultCode r = LoadCookedFile(load->path, resource);
+				Finish(load, r, resource);
+			});
+			return load;
+		}
+
+		load->handler = GetFileHandler(path, load->holder);
+		if (load->handler == nullptr) {
+			ERR_MSG(u8"No file handler takes the extension of the path.");
+			Finish(load, ResultCode::NotSupported, IntrusivePtr<Resource>());
+		} else if (fileSystem != nullptr && load->handler->CanLoadFromData()) {
+			// The reader calls back with its own read, the load only keeps the data.
+			fileSystem->ReadFileAsync(path, &ResourceSystem::OnRead, MEMNEW(SharedPtr<ResourceLoad>(load)), jobSystem, priority);
+		} else {
+			load->stage.store(ResourceLoad::Stage::Decoding, std::memory_order_release);
+			RunLoadJob(load->priority, [this, load]() {
+				if (load->IsCancelled()) {
+					Finish(load, ResultCode::Cancelled, IntrusivePtr<Resource>());
+					return;
+				}
+				IntrusivePtr<Resource> resource{};
+				ResultCode r = load->handler->Load(load->path, resource);
+				Finish(load, r, resource);
+			});
+		}
+		return load;
+	}
+	template<typename Function>
+	void ResourceSystem::RunLoadJob(Job::Priority priority, Function&& function) {
+		if (jobSystem == nullptr || !jobSystem->IsRunning()) {
+			function();
+			return;
+		}
+		jobSystem->AddJob(Memory::Forward<Function>(function), Job::Preference::Null, SharedPtr<JobCounter>(), priority);
+	}
+	void ResourceSystem::OnRead(AsyncFileRead& read, void* userData) {
+		SharedPtr<ResourceLoad> load = *(SharedPtr<ResourceLoad>*)userData;
+		MEMDEL((SharedPtr<ResourceLoad>*)userData);
+		ResourceSystem* system = load->system;
+		if (load->IsCancelled()) {
+			system->Finish(load, ResultCode::Cancelled, IntrusivePtr<Resource>());
+			return;
+		}
+		if (read.GetResult() != ResultCode::OK) {
+			system->Finish(load, read.GetResult(), IntrusivePtr<Resource>());
+			return;
+		}
+		load->data = Memory::Move(read.GetData());
+		system->AddDependencies(load);
+	}
+	void ResourceSystem::AddDependencies(const SharedPtr<ResourceLoad>& load) {
+		List<String> paths{};
+		load->handler->GetDependencies(load->path, load->data, paths);
+		if (paths.GetCount() == 0) {
+			Decode(load);
+			return;
+		}
+
+		List<SharedPtr<ResourceLoad>> dependencies{};
+		for (const auto& path : paths) {
+			dependencies.Add(StartLoad(path, load->priority));
+		}
+		// A path loading already may be a load started on its own that needs this one, waiting for it would never end.
+		// Checked and linked under the lock, so of two loads needing each other the second to get here sees the first.
+		bool circular = false;
+		{
+			SimpleLock<Mutex> lock(mutex);
+			for (const auto& dependency : dependencies) {
+				if (WaitsFor(dependency.GetRaw(), load.GetRaw())) {
+					circular = true;
+					break;
+				}
+			}
+			if (!circular) {
+				load->dependencies = Memory::Move(dependencies);
+			}
+		}
+		if (circular) {
+			ERR_MSG(u8"Circular resource dependency.");
+			Finish(load, ResultCode::InvalidArgument, IntrusivePtr<Resource>());
+			return;
+		}
+
+		// One more for this loop, so the dependencies done meanwhile don't start decoding.
+		load->waiting.store(load->dependencies.GetCount() + 1, std::memory_order_relaxed);
+		for (const auto& dependency : load->dependencies) {
+			bool wait = false;
+			{
+				SimpleLock<Mutex> lock(dependency->mutex);
+				wait = !dependency->finished;
+				if (wait) {
+					dependency->dependents.Add(load);
+				}
+			}
+			if (!wait) {
+				load->waiting.fetch_sub(1, std::memory_order_acq_rel);
+			}
+		}
+		load->stage.store(ResourceLoad::Stage::Dependencies, std::memory_order_release);
+		if (load->waiting.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			Decode(load);
+		}
+	}
+	bool ResourceSystem::WaitsFor(const ResourceLoad* load, const ResourceLoad* target) {
+		// Loads are only linked when no cycle forms, so the walk ends. Dependencies shared by several loads are walked once.
+		List<const ResourceLoad*> pending{};
+		List<const ResourceLoad*> visited{};
+		pending.Add(load);
+		while (pending.GetCount() > 0) {
+			const ResourceLoad* current = pending[pending.GetCount() - 1];
+			pending.RemoveAt(pending.GetCount() - 1);
+			if (current == target) {
+				return true;
+			}
+			bool seen = false;
+			for (const ResourceLoad* other : visited) {
+				if (other == current) {
+					seen = true;
+					break;
+				}
+			}
+			if (seen) {
+				continue;
+			}
+			visited.Add(current);
+			for (const auto& dependency : current->dependencies) {
+				pending.Add(dependency.GetRaw());
+			}
+		}
+		return false;
+	}
+	void ResourceSystem::Decode(const SharedPtr<ResourceLoad>& load) {
+		load->stage.store(ResourceLoad::Stage::Decoding, std::memory_order_release);
+		RunLoadJob(load->priority, [this, load]() {
+			if (load->IsCancelled()) {
+				Finish(load, ResultCode::Cancelled, IntrusivePtr<Resource>());
+				return;
+			}
+			for (const auto& dependency : load->dependencies) {
+				if (dependency->result != ResultCode::OK) {
+					Finish(load, dependency->result, IntrusivePtr<Resource>());
+					return;
+				}
+			}
+			IntrusivePtr<Resource> resource{};
+			ResultCode r = load->handler->LoadFromData(load->path, load->data, resource);
+			Finish(load, r, resource);
+		});
+	}
+	void ResourceSystem::Finish(const SharedPtr<ResourceLoad>& load, ResultCode result, const IntrusivePtr<Resource>& resource) {
+		ERR_ASSERT(result != ResultCode::OK || resource.GetRaw() != nullptr, u8"The file handler returned no resource.", result = ResultCode::InvalidArgument);
+		List<IntrusivePtr<Resource>> released{};
+		IntrusivePtr<Resource> cached{};
+		{
+			SimpleLock<Mutex> lock(mutex);
+			if (result == ResultCode::OK) {
+				cached = AddCached(load->path, resource, released);
+			}
+			SharedPtr<ResourceLoad> current{};
+			if (loading.TryGet(load->path, current) && current.GetRaw() == load.GetRaw()) {
+				loading.Remove(load->path);
+			}
+		}
+
+		load->result = result;
+		load->resource = cached;
+		load->data.Clear();
+		// The dependencies are done, the resource holds what it needs of them.
+		List<SharedPtr<ResourceLoad>> dependents{};
+		{
+			SimpleLock<Mutex> lock(load->mutex);
+			load->finished = true;
+			dependents = Memory::Move(load->dependents);
+		}
+		load->stage.store(ResourceLoad::Stage::Done, std::memory_order_release);
+
+		for (const auto& dependent : dependents) {
+			if (dependent->waiting.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				Decode(dependent);
+			}
+		}
+	}
+	ResultCode ResourceSystem::Save(const String& path, const IntrusivePtr<Resource>& resource) {
+		ERR_ASSERT(resource.GetRaw() != nullptr, u8"resource cannot be null.", return ResultCode::InvalidArgument);
+		SharedPtr<ResourceFileHandler> holder{};
+		ResourceFileHandler* handler = GetFileHandler(path, holder);
+		ERR_ASSERT(handler != nullptr, u8"No file handler takes the extension of the path.", return ResultCode::NotSupported);
+		return handler->Save(path, resource);
+	}
+	IntrusivePtr<Resource> ResourceSystem::GetCached(const String& path) const {
+		SimpleLock<Mutex> lock(mutex);
+		return TryGetCached(path);
+	}
+	IntrusivePtr<Resource> ResourceSystem::TryGetCached(const String& path) const {
+		Resource* resource = nullptr;
+		// The count may be 0 already, with the destructor waiting for the lock to forget it.
+		if (!cache.TryGet(path, resource) || !resource->TryReference()) {
+			return IntrusivePtr<Resource>();
+		}
+		IntrusivePtr<Resource> result(resource);
+		resource->Dereference();
+		return result;
+	}
+	int32 ResourceSystem::GetCachedCount() const {
+		SimpleLock<Mutex> lock(mutex);
+		return cache.GetCount();
+	}
+	void ResourceSystem::Forget(Resource* resource) {
+		SimpleLock<Mutex> lock(mutex);
+		// The path may hold a newer resource already, loaded while this one was dying.
+		Resource* cached = nullptr;
+		if (cache.TryGet(resource->path, cached) && cached == resource) {
+			cache.Remove(resource->path);
+		}
+	}
+
+	void ResourceSystem::SetRetainCount(int32 count) {
+		ERR_ASSERT(count >= 0, u8"count cannot be negative.", return);
+		List<IntrusivePtr<Resource>> released{};
+		SimpleLock<Mutex> lock(mutex);
+		retainCount = count;
+		while (retained.GetCount() > retainCount) {
+			released.Add(Memory::Move(retained[0]));
+			retained.RemoveAt(0);
+		}
+	}
+	int32 ResourceSystem::GetRetainCount() const {
+		SimpleLock<Mutex> lock(mutex);
+		return retainCount;
+	}
+	void ResourceSystem::ClearRetained() {
+		List<IntrusivePtr<Resource>> released{};
+		SimpleLock<Mutex> lock(mutex);
+		released = Memory::Move(retained);
+	}
+	void ResourceSystem::Retain(const IntrusivePtr<Resource>& resource, List<IntrusivePtr<Resource>>& released) {
+		if (retainCount == 0) {
+			return;
+		}
+		for (int32 i = retained.GetCount() - 1; i >= 0; i -= 1) {
+			if (retained[i].GetRaw() == resource.GetRaw()) {
+				retained.RemoveAt(i);
+				break;
+			}
+		}
+		while (retained.GetCount() >= retainCount) {
+			released.Add(Memory::Move(retained[0]));
+			retained.RemoveAt(0);
+		}
+		retained.Add(resource);
+	}
+
+	ResultPair<int32> ResourceSystem::WatchForReload(const String& directory) {
+		ERR_ASSERT(fileSystem != nullptr, u8"Files are watched through the FileSystem, there is none.", return ResultPair<int32>(ResultCode::NotSupported, -1));
+		if (watcher == nullptr) {
+			watcher.Reset(MEMNEW(FileWatcher(fileSystem)));
+		}
+		return watcher->Watch(directory);
+	}
+	void ResourceSystem::UnwatchForReload(int32 watch) {
+		if (watcher != nullptr) {
+			watcher->Unwatch(watch);
+		}
+	}
+	int32 ResourceSystem::UpdateReload() {
+		if (watcher != nullptr) {
+			List<FileChange> changes{};
+			watcher->Update(changes);
+			for (const auto& change : changes) {
+				if (change.directory || (change.kind != FileChange::Kind::Added && change.kind != FileChange::Kind::Modified)) {
+					continue;
+				}
+				IntrusivePtr<Resource> target{};
+				{
+					SimpleLock<Mutex> lock(mutex);
+					if (reloading.ContainsKey(change.path)) {
+						reloading.Set(change.path, true);
+						continue;
+					}
+					target = TryGetCached(change.path);
+					if (target.GetRaw() == nullptr) {
+						continue;
+					}
+					reloading.Set(change.path, false);
+				}
+				StartReload(change.path, target);
+			}
+		}
+
+		List<Reload> done{};
+		{
+			SimpleLock<Mutex> lock(mutex);
+			done = Memory::Move(reloaded);
+		}
+		int32 swapped = 0;
+		for (auto& reload : done) {
+			if (reload.result != ResultCode::OK) {
+				continue;
+			}
+			ResultCode r = reload.target->ReloadFrom(*reload.fresh.GetRaw());
+			if (r != ResultCode::OK) {
+				WARN_MSG(u8"The resource changed but could not take the new content.");
+				continue;
+			}
+			swapped += 1;
+			reload.target->EmitSignal(STRL("Reloaded"), nullptr, 0);
+		}
+		return swapped;
+	}
+	int32 ResourceSystem::GetReloadingCount() const {
+		SimpleLock<Mutex> lock(mutex);
+		return reloading.GetCount() + reloaded.GetCount();
+	}
+	void ResourceSystem::StartReload(const String& path, const IntrusivePtr<Resource>& target) {
+		RunLoadJob(Job::Priority::Background, [this, path, target]() {
+			IntrusivePtr<Resource> fresh{};
+			ResultCode r = LoadUncached(path, fresh);
+			bool again = false;
+			{
+				SimpleLock<Mutex> lock(mutex);
+				reloading.TryGet(path, again);
+				if (again) {
+					// Changed while it was loading, what was loaded may be half written already.
+					reloading.Set(path, false);
+				} else {
+					reloading.Remove(path);
+					reloaded.Add(Reload{ target, fresh, r });
+				}
+			}
+			if (again) {
+				StartReload(path, target);
+			}
+		});
+	}
+}
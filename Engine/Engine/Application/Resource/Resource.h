@@ -1,15 +1,35 @@
 #pragma once
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Thread/ReadWriteLock.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include <atomic>
 
 namespace Engine {
+	class ResourceSystem;
+	class FileSystem;
+	class AsyncFileRead;
+	class CookedResourceView;
+	class CookedResourceWriter;
+	class FileWatcher;
+
 	class Resource:public ReferencedObject{
 		REFLECTION_CLASS(::Engine::Resource, ::Engine::ReferencedObject) {
-
+			REFLECTION_SIGNAL(STRL("Reloaded"), {});
 		}
 	public:
-		virtual ~Resource() = default;
+		virtual ~Resource();
+		/// @brief The path it was loaded from by a ResourceSystem, empty if it wasn't.
+		const String& GetPath() const;
+		/// @brief Take the content of the same resource loaded again from its changed file, so everything holding this one sees the new content.
+		/// Called by ResourceSystem::UpdateReload(), which emits "Reloaded" after it.
+		/// @return ResultCode::NotSupported by default, the resource is left as it is then.
+		virtual ResultCode ReloadFrom(Resource& fresh);
 	private:
-
+		friend class ResourceSystem;
+		String path{};
+		/// @brief The system caching it, told when it's destroyed.
+		ResourceSystem* cacheOwner = nullptr;
 	};
 
 	class ResourceFileHandler:public ManualObject {
@@ -26,20 +46,199 @@ namespace Engine {
 		virtual ResultCode Load(const String& path, IntrusivePtr<Resource>& result) const = 0;
 		virtual ResultCode Save(const String& path, const IntrusivePtr<Resource>& resource) = 0;
 
+		/// @brief Whether LoadFromData() is implemented, so ResourceSystem::LoadAsync() reads the file on the I/O thread
+		/// and only decodes on a worker. Otherwise Load() runs on a worker, reading there too.
+		virtual bool CanLoadFromData() const;
+		/// @brief Decode the resource from the whole content of its file. Called on any thread.\n
+		/// The dependencies are loaded by then, get them with ResourceSystem::GetCached().
+		virtual ResultCode LoadFromData(const String& path, const List<byte>& data, IntrusivePtr<Resource>& result) const;
+		/// @brief Add the paths of the resources this one needs, LoadAsync() loads them first. None by default.
+		virtual void GetDependencies(const String& path, const List<byte>& data, List<String>& result) const;
+
+		/// @brief The format of the cooked files of Cook() and LoadCooked(), CookedResource::MakeTag() of 4 characters. 0 by default, for none.
+		virtual uint32 GetCookedFormat() const;
+		/// @brief The offline step converting the source file to what the resource is in memory, see CookedResource.
+		virtual ResultCode Cook(const String& path, const List<byte>& source, CookedResourceWriter& result) const;
+		/// @brief Make the resource from a cooked file of its format, checked already. Called on any thread.\n
+		/// Use the data in place rather than copying it, keeping a copy of the view in the resource so the file stays mapped.
+		virtual ResultCode LoadCooked(const String& path, const CookedResourceView& view, IntrusivePtr<Resource>& result) const;
+
 	protected:
 		List<String> extensions{};
 	};
 
+	/// @brief A resource loading in the background, see ResourceSystem::LoadAsync().
+	class ResourceLoad final {
+	public:
+		enum class Stage :byte {
+			/// @brief The file is read on the I/O thread.
+			Reading,
+			/// @brief Waiting for the dependencies.
+			Dependencies,
+			/// @brief Decoded on a worker.
+			Decoding,
+			Done,
+		};
+
+		/// @brief Thread-safe. Once true, the result and the resource are ready.
+		bool IsDone() const;
+		Stage GetStage() const;
+		/// @brief From 0 to 1, the dependencies counting as much as the resource itself once they are known.
+		float GetProgress() const;
+		/// @brief ResultCode::Cancelled after Cancel(), the error of a failed dependency, or the one of the file handler.
+		ResultCode GetResult() const;
+		/// @brief nullptr until done, or if it failed.
+		const IntrusivePtr<Resource>& GetResource() const;
+		const String& GetPath() const;
+		Job::Priority GetPriority() const;
+
+		/// @brief Give up at the next stage. The load is shared by everyone loading the path at the time, it's cancelled for all of them.
+		/// Its dependencies keep loading, other resources may need them.
+		void Cancel();
+		bool IsCancelled() const;
+
+	private:
+		friend class ResourceSystem;
+
+		ResourceSystem* system = nullptr;
+		String path{};
+		Job::Priority priority = Job::Priority::Background;
+		SharedPtr<ResourceFileHandler> holder{};
+		ResourceFileHandler* handler = nullptr;
+		/// @brief The content of the file, until decoded.
+		List<byte> data{};
+		/// @brief Set under the lock of the system before the stage moves to Stage::Dependencies, read only after.
+		List<SharedPtr<ResourceLoad>> dependencies{};
+		/// @brief Dependencies not done yet.
+		std::atomic<int32> waiting{ 0 };
+
+		ResultCode result = ResultCode::OK;
+		IntrusivePtr<Resource> resource{};
+		std::atomic<Stage> stage{ Stage::Reading };
+		std::atomic<bool> cancelled{ false };
+
+		Mutex mutex{};
+		/// @brief Guarded by the mutex. The loads waiting for this one, told once it's done.
+		List<SharedPtr<ResourceLoad>> dependents{};
+		bool finished = false;
+	};
+
+	/// @brief Loads and saves resources with the file handler of their extension.
+	/// Cooked files, see CookedResource, are mapped and go to the handler of their format instead.\n
+	/// Loaded resources are cached by path with weak references: loading a path again returns the same resource while anything holds it,
+	/// and it is freed as soon as nothing does. SetRetainCount() keeps the most recently loaded ones alive after that,
+	/// for loading the same resources again soon, like the next level sharing textures and sounds.\n
+	/// Thread-safe, except the hot reload functions which are called from one thread. Destroy the system after the resources it loaded are released,
+	/// or at least not while they are being released.
 	class ResourceSystem {
 	public:
-		ResultCode Load(const String& path, IntrusivePtr<Resource>& result) const;
+		/// @param fileSystem Reads the files of LoadAsync() on its I/O thread and maps the cooked ones, nullptr to read them on the workers.
+		/// @param jobSystem Decodes the resources of LoadAsync(), nullptr to decode them right away, on the I/O thread or the calling one.
+		ResourceSystem(FileSystem* fileSystem = nullptr, JobSystem* jobSystem = nullptr);
+		/// @brief Wait for the loads of LoadAsync() to be done first, GetLoadingCount() tells how many are left.
+		~ResourceSystem();
+
+		/// @brief Use the handler for each extension it supports, in place of the ones used so far.
+		void AddFileHandler(const SharedPtr<ResourceFileHandler>& handler);
+
+		/// @brief The cached resource of the path, or loaded with the handler of its extension and cached.\n
+		/// Threads loading the same path at once may each load it, the first one done is cached and returned to all.
+		/// @return ResultCode::NotSupported if no handler takes the extension, or the error of the handler.
+		ResultCode Load(const String& path, IntrusivePtr<Resource>& result);
 		ResultCode Save(const String& path, const IntrusivePtr<Resource>& resource);
+		/// @brief Convert the source file with the handler of its extension to a cooked file, which Load() maps and uses in place.
+		/// Run offline, by the tools packaging the resources. Needs a FileSystem.
+		/// @return ResultCode::NotSupported if the handler doesn't cook, or the error of the handler or the files.
+		ResultCode Cook(const String& sourcePath, const String& cookedPath);
+		/// @brief Load in the background, then cache like Load(). Poll the returned load.\n
+		/// The file is read on the I/O thread of the FileSystem, its dependencies are loaded the same way,
+		/// then it's decoded as a job of the JobSystem, all with the priority.
+		/// Loading a path already loading returns that load, a cached one returns a load already done.
+		SharedPtr<ResourceLoad> LoadAsync(const String& path, Job::Priority priority = Job::Priority::Background);
+		/// @brief The loads of LoadAsync() not done yet.
+		int32 GetLoadingCount() const;
+		/// @brief The cached resource of the path if something still holds it, nullptr otherwise. Doesn't load.
+		IntrusivePtr<Resource> GetCached(const String& path) const;
+		int32 GetCachedCount() const;
+
+		/// @brief How many of the most recently loaded resources are kept alive after nothing else holds them, 0 by default.
+		void SetRetainCount(int32 count);
+		int32 GetRetainCount() const;
+		/// @brief Stop keeping the recently loaded resources alive, the ones nothing else holds are freed.
+		void ClearRetained();
+
+		/// @brief Reload the cached resources under the directory when their files change, for development. Needs a FileSystem.\n
+		/// The resources are matched by the path they were loaded with, the directory then the path relative to it separated with '/'.
+		/// @return The id of the watch, see FileWatcher::Watch().
+		ResultPair<int32> WatchForReload(const String& directory);
+		void UnwatchForReload(int32 watch);
+		/// @brief Call once a frame from the thread using the resources. Starts loading again the changed files of cached resources, in the background,
+		/// and swaps the ones done into the cached resources with Resource::ReloadFrom(), emitting their "Reloaded" signal.
+		/// @return How many resources were swapped.
+		int32 UpdateReload();
+		/// @brief The reloads started and not swapped yet.
+		int32 GetReloadingCount() const;
 
 	private:
+		friend class Resource;
+		/// @brief Called by the resource being destroyed.
+		void Forget(Resource* resource);
+		/// @brief The lock needs to be held. Resources pushed out go to released, to be freed once the lock is released.
+		void Retain(const IntrusivePtr<Resource>& resource, List<IntrusivePtr<Resource>>& released);
+		/// @brief The lock needs to be held. nullptr if the resource is gone or dying.
+		IntrusivePtr<Resource> TryGetCached(const String& path) const;
+		ResourceFileHandler* GetFileHandler(const String& path, SharedPtr<ResourceFileHandler>& holder) const;
+		/// @brief Map the cooked file and make the resource with the handler of its format.
+		ResultCode LoadCookedFile(const String& path, IntrusivePtr<Resource>& result) const;
+		/// @brief Load with the handler of the path, skipping the cache.
+		ResultCode LoadUncached(const String& path, IntrusivePtr<Resource>& result) const;
+		/// @brief The lock needs to be held. Cache the loaded resource, or take the one cached meanwhile.
+		IntrusivePtr<Resource> AddCached(const String& path, const IntrusivePtr<Resource>& loaded, List<IntrusivePtr<Resource>>& released);
+
+		SharedPtr<ResourceLoad> StartLoad(const String& path, Job::Priority priority);
+		/// @brief The lock needs to be held. Whether the load waits for the target through its dependencies, or is the target.
+		static bool WaitsFor(const ResourceLoad* load, const ResourceLoad* target);
+		/// @brief As a job with the priority, or right away without a running job system.
+		template<typename Function>
+		void RunLoadJob(Job::Priority priority, Function&& function);
+		void StartReload(const String& path, const IntrusivePtr<Resource>& target);
+		static void OnRead(AsyncFileRead& read, void* userData);
+		void AddDependencies(const SharedPtr<ResourceLoad>& load);
+		void Decode(const SharedPtr<ResourceLoad>& load);
+		void Finish(const SharedPtr<ResourceLoad>& load, ResultCode result, const IntrusivePtr<Resource>& resource);
+
+		/// @brief Guards the handlers, looked up by every load and added once at startup.
+		mutable ReadWriteLock handlersLock{};
+		/// @brief By extension, without the dot.
 		Dictionary<String, SharedPtr<ResourceFileHandler>> fileHandlers{ 10 };
+		/// @brief By the format of their cooked files.
+		Dictionary<uint32, SharedPtr<ResourceFileHandler>> cookedHandlers{};
 		//using DefaultFileHandlerType = ResourceFileHandlerRouter;
 		UniquePtr<ResourceFileHandler> defaultFileHandler;
 
 		//Dictionary<String, SharedPtr<ResourceTypeHandler>> typeHandlers{ 50 };
+
+		mutable Mutex mutex{};
+		/// @brief Weak, the resources remove themselves when they are destroyed.
+		Dictionary<String, Resource*> cache{};
+		/// @brief The most recently loaded last.
+		List<IntrusivePtr<Resource>> retained{};
+		int32 retainCount = 0;
+
+		FileSystem* fileSystem;
+		JobSystem* jobSystem;
+		/// @brief The loads of LoadAsync() not done yet, by path.
+		Dictionary<String, SharedPtr<ResourceLoad>> loading{};
+
+		struct Reload {
+			IntrusivePtr<Resource> target;
+			IntrusivePtr<Resource> fresh;
+			ResultCode result;
+		};
+		UniquePtr<FileWatcher> watcher;
+		/// @brief Guarded by the lock. The paths reloading, with whether their file changed again meanwhile.
+		Dictionary<String, bool> reloading{};
+		/// @brief Guarded by the lock. The reloads done, swapped by the next UpdateReload().
+		List<Reload> reloaded{};
 	};
-}
\ No newline at end of file
+}
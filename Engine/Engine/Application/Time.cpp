@@ -1,4 +1,5 @@
 #include "Engine/Application/Time.h"
+#include "Engine/System/Debug.h"
 
 namespace Engine {
 	void Time::SetScale(float scale) {
@@ -24,11 +25,25 @@ namespace Engine {
 		return unscaledPhysicsDelta;
 	}
 	void Time::SetUnscaledPhysicsDelta(float unscaledDelta) {
+		ERR_ASSERT(unscaledDelta > 0, u8"unscaledDelta must be positive.", return);
 		unscaledPhysicsDelta = unscaledDelta;
 	}
 	float Time::GetPhysicsDelta() const {
 		return unscaledPhysicsDelta * physicsScale;
 	}
+	void Time::SetMaxPhysicsSteps(int32 maxSteps) {
+		ERR_ASSERT(maxSteps > 0, u8"maxSteps must be positive.", return);
+		maxPhysicsSteps = maxSteps;
+	}
+	int32 Time::GetMaxPhysicsSteps() const {
+		return maxPhysicsSteps;
+	}
+	float Time::GetPhysicsInterpolation() const {
+		return physicsInterpolation;
+	}
+	int32 Time::GetTotalPhysicsSteps() const {
+		return totalPhysicsSteps;
+	}
 
 	int32 Time::GetTotalFrames() const {
 		return totalFrames;
@@ -39,4 +54,21 @@ namespace Engine {
 	double Time::GetUnscaledTotal() const {
 		return unscaledTotal;
 	}
+	uint64 Time::GetFrameTimestamp() const {
+		return frameTimestamp;
+	}
+
+	void Time::Advance(float unscaledDelta) {
+		this->unscaledDelta = unscaledDelta;
+		unscaledTotal += unscaledDelta;
+		total += GetDelta();
+		totalFrames += 1;
+	}
+
+	FrameStatistics& Time::GetFrameStatistics() {
+		return frameStatistics;
+	}
+	const FrameStatistics& Time::GetFrameStatistics() const {
+		return frameStatistics;
+	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/System/Definition.h"
+#include "Engine/Application/FrameStatistics.h"
 
 namespace Engine {
 	class Time final {
@@ -18,11 +19,22 @@ namespace Engine {
 		void SetPhysicsScale(float scale);
 		float GetPhysicsScale() const;
 		
+		/// @brief Set the seconds between two physics updates, 1 / ticks per second. Every physics update advances by exactly this much, whatever the frame rate.
 		void SetUnscaledPhysicsDelta(float unscaledDelta);
 		float GetUnscaledPhysicsDelta() const;
 		
 		float GetPhysicsDelta() const;
 
+		/// @brief Set how many physics updates a frame may run at most to catch up.\n
+		/// A frame which falls further behind drops the time it couldn't catch up, so a slow frame doesn't make the next one slower.
+		void SetMaxPhysicsSteps(int32 maxSteps);
+		int32 GetMaxPhysicsSteps() const;
+		/// @brief How far the current frame is between the last physics update and the next one, from 0 to 1.\n
+		/// Blend the previous and current physics states by it to render smoothly at any frame rate.
+		float GetPhysicsInterpolation() const;
+		/// @brief Count of physics updates run since the beginning.
+		int32 GetTotalPhysicsSteps() const;
+
 
 		// Summed up
 
@@ -33,18 +45,38 @@ namespace Engine {
 		/// @see https://randomascii.wordpress.com/2012/02/13/dont-store-that-in-a-float/
 		double GetTotal() const;
 		double GetUnscaledTotal() const;
+		/// @brief Clock::Now() when the current frame began, measure from it with Clock::ToSeconds(Clock::Now() - GetFrameTimestamp()).
+		uint64 GetFrameTimestamp() const;
+
+
+		/// @brief Start a frame lasting the given unscaled seconds, updating the deltas and the totals.\n
+		/// Called by the engine every frame, and by whatever drives an AppLoop without it.
+		void Advance(float unscaledDelta);
+
+
+		// Statistics
+
+		/// @brief Durations of the latest frames by phase, recorded by the engine every frame.
+		FrameStatistics& GetFrameStatistics();
+		const FrameStatistics& GetFrameStatistics() const;
 
 	private:
 		float scale = 1;
 		float unscaledDelta = 0;
 
 		float physicsScale = 1;
-		float unscaledPhysicsDelta = 60;
-		
+		float unscaledPhysicsDelta = 1.0f / 60;
+		int32 maxPhysicsSteps = 8;
+		float physicsInterpolation = 0;
+		int32 totalPhysicsSteps = 0;
+
 		int32 totalFrames = 0;
 
 		double total = 0;
 		double unscaledTotal = 0;
+		uint64 frameTimestamp = 0;
+
+		FrameStatistics frameStatistics{};
 
 
 		friend class Engine;
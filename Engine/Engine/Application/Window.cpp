@@ -13,7 +13,10 @@ namespace Engine {
 	WindowSystem::~WindowSystem() {}
 
 	Window* WindowSystem::CreateWindow() {
-		SharedPtr<Window> window = SharedPtr<PLATFORM_SPECIFIC_CLASS_WINDOW>::Create();
+		SharedPtr<Window> window = NewWindow();
+		if (window == nullptr) {
+			return nullptr;
+		}
 
 		window->id = idCounter.Add(1);
 		window->manager = this;
@@ -59,4 +62,15 @@ namespace Engine {
 		auto lock = SimpleLock<Mutex>(windowsMutex);
 		windows.Clear();
 	}
+	InputEventQueue& WindowSystem::GetInputEvents() {
+		return inputEvents;
+	}
+	SharedPtr<Window> WindowSystem::NewWindow() {
+		return SharedPtr<PLATFORM_SPECIFIC_CLASS_WINDOW>::Create();
+	}
+
+	void HeadlessWindowSystem::Update() {}
+	SharedPtr<Window> HeadlessWindowSystem::NewWindow() {
+		return SharedPtr<Window>();
+	}
 }
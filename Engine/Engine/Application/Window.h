@@ -7,6 +7,7 @@
 #include "Engine/System/Thread/Atomic.h"
 #include "Engine/System/Memory/SharedPtr.h"
 #include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/Application/InputEvent.h"
 
 namespace Engine{
 	class WindowSystem;
@@ -96,9 +97,30 @@ namespace Engine{
 
 		virtual void Update() = 0;
 
+		/// @brief The input events of every window. Written by whichever thread Update() pumps the messages on, read by the engine at the start of a frame.
+		InputEventQueue& GetInputEvents();
+
+	protected:
+		/// @brief Make the native window of the platform, CreateWindow() gives it an id afterwards.
+		/// @return nullptr when the system has no windows.
+		virtual SharedPtr<Window> NewWindow();
+
 	private:
 		AtomicValue<Window::ID> idCounter{ Window::NullId };
 		Dictionary<Window::ID, SharedPtr<Window>> windows;
 		mutable Mutex windowsMutex;
+		InputEventQueue inputEvents{};
+	};
+
+	/// @brief A window system without windows, for dedicated servers and benchmarks.\n
+	/// Never touches the window framework of the platform, CreateWindow() always returns nullptr.
+	class HeadlessWindowSystem final :public WindowSystem {
+		REFLECTION_CLASS(::Engine::HeadlessWindowSystem, ::Engine::WindowSystem) {}
+
+	public:
+		void Update() override;
+
+	protected:
+		SharedPtr<Window> NewWindow() override;
 	};
 }
\ No newline at end of file
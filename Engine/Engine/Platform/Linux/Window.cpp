@@ -1,7 +1,7 @@
 #include "Engine/Platform/Linux/Window.h"
+#include "Engine/System/Profiler.h"
 
 namespace Engine::PlatformSpecific::Linux {
-	typename WindowSystem::_Initializer WindowSystem::_initializer{};
 
 	WindowSystem::_Initializer::_Initializer() {
 		bool inited = gtk_init_check(0, NULL);
@@ -12,8 +12,16 @@ namespace Engine::PlatformSpecific::Linux {
 		
 	}
 
+	WindowSystem::WindowSystem() {
+		static _Initializer initializer{};
+	}
 	void WindowSystem::Update(){
-		gtk_main_iteration_do(false);
+		PROFILE_SCOPE("WindowSystem::Update");
+		// An iteration handles a single event, drain everything queued so far.
+		while (gtk_events_pending()) {
+			gtk_main_iteration_do(false);
+		}
+		GetInputEvents().Flush();
 	}
 
 	Window::Window() {
@@ -21,6 +29,11 @@ namespace Engine::PlatformSpecific::Linux {
 
 		g_object_set_data(G_OBJECT(window), "WindowPtr", this);
 		g_signal_connect(window, "delete-event",G_CALLBACK(OnGtkCloseWindow), NULL);
+
+		gtk_widget_add_events(window, GDK_KEY_PRESS_MASK | GDK_KEY_RELEASE_MASK | GDK_POINTER_MOTION_MASK | GDK_BUTTON_PRESS_MASK | GDK_BUTTON_RELEASE_MASK | GDK_SCROLL_MASK | GDK_STRUCTURE_MASK);
+		for (const char* signal : { "key-press-event", "key-release-event", "motion-notify-event", "button-press-event", "button-release-event", "scroll-event", "configure-event" }) {
+			g_signal_connect(window, signal, G_CALLBACK(OnGtkInput), NULL);
+		}
 	}
 	Window::~Window() {
 		if (IsValid) {
@@ -184,6 +197,10 @@ namespace Engine::PlatformSpecific::Linux {
 	}
 
 	void Window::OnCallbackClose() {
+		InputEvent event{};
+		event.type = InputEvent::Type::Close;
+		event.window = GetId();
+		GetManager()->GetInputEvents().Push(event);
 		GetManager()->Destroy(GetId());
 	}
 	gboolean Window::OnGtkCloseWindow(GtkWidget* widget, GdkEvent* event, gpointer data){
@@ -195,4 +212,49 @@ namespace Engine::PlatformSpecific::Linux {
 		}
 		return TRUE;
 	}
+	gboolean Window::OnGtkInput(GtkWidget* widget, GdkEvent* event, gpointer data) {
+		Window* nw = (Window*)g_object_get_data(G_OBJECT(widget), "WindowPtr");
+		if (nw == nullptr) {
+			return FALSE;
+		}
+		InputEvent input{};
+		input.window = nw->GetId();
+		switch (event->type) {
+			case GDK_KEY_PRESS:
+			case GDK_KEY_RELEASE:
+				input.type = event->type == GDK_KEY_PRESS ? InputEvent::Type::KeyDown : InputEvent::Type::KeyUp;
+				input.code = (int32)event->key.keyval;
+				break;
+			case GDK_MOTION_NOTIFY:
+				input.type = InputEvent::Type::MouseMove;
+				input.value = Vector2((float)event->motion.x, (float)event->motion.y);
+				break;
+			case GDK_BUTTON_PRESS:
+			case GDK_BUTTON_RELEASE:
+				input.type = event->type == GDK_BUTTON_PRESS ? InputEvent::Type::MouseButtonDown : InputEvent::Type::MouseButtonUp;
+				// GTK counts left, middle, right from 1.
+				input.code = event->button.button == 1 ? 0 : (event->button.button == 3 ? 1 : (event->button.button == 2 ? 2 : (int32)event->button.button - 1));
+				input.value = Vector2((float)event->button.x, (float)event->button.y);
+				break;
+			case GDK_SCROLL:
+				input.type = InputEvent::Type::MouseWheel;
+				switch (event->scroll.direction) {
+					case GDK_SCROLL_UP: input.value = Vector2(0, 1); break;
+					case GDK_SCROLL_DOWN: input.value = Vector2(0, -1); break;
+					case GDK_SCROLL_LEFT: input.value = Vector2(-1, 0); break;
+					case GDK_SCROLL_RIGHT: input.value = Vector2(1, 0); break;
+					default: input.value = Vector2((float)event->scroll.delta_x, (float)-event->scroll.delta_y); break;
+				}
+				break;
+			case GDK_CONFIGURE:
+				input.type = InputEvent::Type::Resize;
+				input.value = Vector2((float)event->configure.width, (float)event->configure.height);
+				break;
+			default:
+				return FALSE;
+		}
+		nw->GetManager()->GetInputEvents().Push(input);
+		// Let GTK keep handling the event.
+		return FALSE;
+	}
 }
\ No newline at end of file
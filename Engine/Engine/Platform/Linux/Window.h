@@ -12,15 +12,16 @@ namespace Engine::PlatformSpecific::Linux{
 		REFLECTION_CLASS(::Engine::PlatformSpecific::Linux::WindowSystem, ::Engine::WindowSystem) {}
 
 	public:
+		WindowSystem();
 		void Update() override;
 
 	private:
+		/// @brief Brings up the window framework with the first window system, so running headless never touches it.
 		class _Initializer final {
 		public:
 			_Initializer();
 			~_Initializer();
 		};
-		static _Initializer _initializer;
 	};
 	class Window final :public ::Engine::Window {
 	public:
@@ -59,6 +60,8 @@ namespace Engine::PlatformSpecific::Linux{
 
 		void OnCallbackClose();
 		static gboolean OnGtkCloseWindow(GtkWidget* widget,GdkEvent* event,gpointer data);
+		/// @brief Turns the input events GTK delivers while pumping into InputEvents of the manager.
+		static gboolean OnGtkInput(GtkWidget* widget, GdkEvent* event, gpointer data);
 		
 	private:
 		GtkWidget* window;
@@ -3,13 +3,22 @@
 using namespace Engine;
 namespace Engine::PlatformSpecific::Windows {
 	bool UnicodeHelper::UTF8ToUnicode(const String& string,UniquePtr<WCHAR[]>& result) {
-		int32 len = MultiByteToWideChar(CP_UTF8, NULL, reinterpret_cast<const char*>(string.GetRawArray()), -1, NULL, 0);
-		ERR_ASSERT(len > 0, u8"MultiByteToWideChar failed to calculate required WCHAR[] length!", return false);
+		// Convert by count from the start, a substring isn't NULL-terminated at its end.
+		const char* chars = reinterpret_cast<const char*>(string.GetStartPtr());
+		int32 count = string.GetCount();
+		int32 len = 0;
+		if (count > 0) {
+			len = MultiByteToWideChar(CP_UTF8, NULL, chars, count, NULL, 0);
+			ERR_ASSERT(len > 0, u8"MultiByteToWideChar failed to calculate required WCHAR[] length!", return false);
+		}
 		
-		UniquePtr<WCHAR[]> wchar = UniquePtr<WCHAR[]>::Create(len);
+		UniquePtr<WCHAR[]> wchar = UniquePtr<WCHAR[]>::Create(len + 1);
 
-		int32 converted = MultiByteToWideChar(CP_UTF8, NULL, reinterpret_cast<const char*>(string.GetRawArray()), string.GetCount() + 1, wchar.GetRaw(), len);
-		ERR_ASSERT(converted > 0, u8"MultiByteToWideChar failed to convert!", return false);
+		if (count > 0) {
+			int32 converted = MultiByteToWideChar(CP_UTF8, NULL, chars, count, wchar.GetRaw(), len);
+			ERR_ASSERT(converted > 0, u8"MultiByteToWideChar failed to convert!", return false);
+		}
+		wchar.GetRaw()[len] = L'\0';
 
 		result.Reset(wchar.Release());
 		return true;
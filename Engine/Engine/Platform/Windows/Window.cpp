@@ -3,9 +3,9 @@
 #include <ShellScalingApi.h>
 #include "Engine/Application/Engine.h"
 #include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Profiler.h"
 
 namespace Engine::PlatformSpecific::Windows {
-	typename WindowSystem::_Initializer WindowSystem::_initializer{};
 
 	WindowSystem::_Initializer::_Initializer() {
 		// Make console support UTF-8
@@ -34,17 +34,30 @@ namespace Engine::PlatformSpecific::Windows {
 		UnregisterClassW(Window::GlobalWindowClassName, NULL);
 	}
 
+	WindowSystem::WindowSystem() {
+		static _Initializer initializer{};
+	}
 	void WindowSystem::Update() {
+		PROFILE_SCOPE("WindowSystem::Update");
+		// The previous pump is still waiting for the window worker, it picks up the new messages as well.
+		if (pumping.Exchange(true)) {
+			return;
+		}
 		auto func = [](Job* job) {
+			WindowSystem* system = *job->GetDataAs<WindowSystem*>();
 			MSG msg = {};
-			if (PeekMessageW(&msg, NULL, NULL, NULL, PM_REMOVE)) {
+			// Everything queued so far, so floods of mouse moves or resizes don't back up one message per frame.
+			while (PeekMessageW(&msg, NULL, NULL, NULL, PM_REMOVE)) {
 				if (msg.message != WM_QUIT) {
 					TranslateMessage(&msg);
 					DispatchMessageW(&msg);
 				}
 			}
+			system->GetInputEvents().Flush();
+			system->pumping.Set(false);
 		};
-		ENGINEINST->GetJobSystem()->AddJob(func, nullptr, 0, Job::Preference::Window);
+		WindowSystem* system = this;
+		ENGINEINST->GetJobSystem()->AddJob(func, &system, sizeof(system), Job::Preference::Window);
 	}
 
 	Window* Window::GetFromHWnd(HWND hWnd) {
@@ -105,7 +118,7 @@ namespace Engine::PlatformSpecific::Windows {
 
 	Window::Window() {
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWInit>();
+			auto data = *job->GetDataAs<_NWWInit*>();
 
 			HWND w = CreateWindowExW(DefaultWindowExStyle,GlobalWindowClassName, L"", DefaultWindowStyle, CW_USEDEFAULT, CW_USEDEFAULT, CW_USEDEFAULT, CW_USEDEFAULT, NULL, NULL, NULL, NULL);
 			if (!IsWindow(w)) {
@@ -123,11 +136,12 @@ namespace Engine::PlatformSpecific::Windows {
 		data.userDataPtr = (LONG_PTR)this;
 		// Start job
 		auto js = ENGINEINST->GetJobSystem();
-		auto job=js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		// Wait for the result
 		js->WaitJob(job);
 
-		HWND w = job->GetDataAs<_NWWInit>()->result;
+		HWND w = data.result;
 		ERR_ASSERT(IsWindow(w), u8"CreateWindowW failed to create a window!", return);
 		hWnd = w;
 	}
@@ -148,12 +162,31 @@ namespace Engine::PlatformSpecific::Windows {
 		js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
 	}
 
+	/// @brief Hand an event of the window to the input queue of its manager. Runs on the window worker, the only producer of the queue.
+	static void PushInputEvent(HWND hWnd, InputEvent::Type type, int32 code, const Vector2& value) {
+		Window* nw = Window::GetFromHWnd(hWnd);
+		if (nw == nullptr) {
+			return;
+		}
+		InputEvent event{};
+		event.type = type;
+		event.window = nw->GetId();
+		event.code = code;
+		event.value = value;
+		nw->GetManager()->GetInputEvents().Push(event);
+	}
+	/// @brief The cursor position packed in the lParam of mouse messages, signed for positions left or above the client area.
+	static Vector2 GetMousePosition(LPARAM lParam) {
+		return Vector2((float)(int16)LOWORD(lParam), (float)(int16)HIWORD(lParam));
+	}
+
 	LRESULT CALLBACK Window::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
 		switch (message) {
 			case WM_CLOSE:
 			{
 				Window* nw = Window::GetFromHWnd(hWnd);
 				if (nw != nullptr) {
+					PushInputEvent(hWnd, InputEvent::Type::Close, 0, Vector2());
 					nw->GetManager()->DestroyWindow(nw->GetId());
 				} else {
 					ERR_MSG(u8"User data in hWnd is not a Window ptr! This shouldn't happen!");
@@ -166,8 +199,43 @@ namespace Engine::PlatformSpecific::Windows {
 				PostQuitMessage(0);
 				return 0;
 
+			case WM_KEYUP:
+				PushInputEvent(hWnd, InputEvent::Type::KeyUp, (int32)wParam, Vector2());
+				break;
+			case WM_MOUSEMOVE:
+				PushInputEvent(hWnd, InputEvent::Type::MouseMove, 0, GetMousePosition(lParam));
+				break;
+			case WM_LBUTTONDOWN:
+				PushInputEvent(hWnd, InputEvent::Type::MouseButtonDown, 0, GetMousePosition(lParam));
+				break;
+			case WM_LBUTTONUP:
+				PushInputEvent(hWnd, InputEvent::Type::MouseButtonUp, 0, GetMousePosition(lParam));
+				break;
+			case WM_RBUTTONDOWN:
+				PushInputEvent(hWnd, InputEvent::Type::MouseButtonDown, 1, GetMousePosition(lParam));
+				break;
+			case WM_RBUTTONUP:
+				PushInputEvent(hWnd, InputEvent::Type::MouseButtonUp, 1, GetMousePosition(lParam));
+				break;
+			case WM_MBUTTONDOWN:
+				PushInputEvent(hWnd, InputEvent::Type::MouseButtonDown, 2, GetMousePosition(lParam));
+				break;
+			case WM_MBUTTONUP:
+				PushInputEvent(hWnd, InputEvent::Type::MouseButtonUp, 2, GetMousePosition(lParam));
+				break;
+			case WM_MOUSEWHEEL:
+				PushInputEvent(hWnd, InputEvent::Type::MouseWheel, 0, Vector2(0, (float)GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA));
+				break;
+			case WM_MOUSEHWHEEL:
+				PushInputEvent(hWnd, InputEvent::Type::MouseWheel, 0, Vector2((float)GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA, 0));
+				break;
+			case WM_SIZE:
+				PushInputEvent(hWnd, InputEvent::Type::Resize, 0, Vector2(LOWORD(lParam), HIWORD(lParam)));
+				break;
+
 			case WM_KEYDOWN:
 			{
+				PushInputEvent(hWnd, InputEvent::Type::KeyDown, (int32)wParam, Vector2());
 				Window* nw = Window::GetFromHWnd(hWnd);
 				if (nw != nullptr) {
 					Variant key = wParam;
@@ -188,7 +256,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return String::GetEmpty());
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWGetTitle>();
+			auto data = *job->GetDataAs<_NWWGetTitle*>();
 			HWND hWnd = data->hWnd;
 			int len = GetWindowTextLengthW(hWnd);
 			if (len <= 0) {
@@ -209,7 +277,8 @@ namespace Engine::PlatformSpecific::Windows {
 		data.buffer = &buffer;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
 		if (buffer == nullptr) {
@@ -223,6 +292,9 @@ namespace Engine::PlatformSpecific::Windows {
 	}
 	bool Window::SetTitle(const String& title) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
+		if (title == this->title) {
+			return true;
+		}
 
 		UniquePtr<WCHAR[]> buffer;
 		bool succeeded = UnicodeHelper::UTF8ToUnicode(title, buffer);
@@ -230,7 +302,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(succeeded, u8"Failed to convert engine string to Windows wide string!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetTitle>();
+			auto data = *job->GetDataAs<_NWWSetTitle*>();
 			bool succeeded = SetWindowTextW(data->hWnd, data->title);
 			data->result = succeeded;
 		};
@@ -240,12 +312,14 @@ namespace Engine::PlatformSpecific::Windows {
 		data.title = buffer.GetRaw();
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		succeeded = job->GetDataAs<_NWWSetTitle>()->result;
+		succeeded = data.result;
 		ERR_ASSERT(succeeded, u8"SetWindowTextW failed to set window title!", return false);
 		
+		this->title = title;
 		return true;
 	}
 
@@ -253,7 +327,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return Vector2());
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWGetVector2>();
+			auto data = *job->GetDataAs<_NWWGetVector2*>();
 
 			POINT pos{};
 			ClientToScreen(data->hWnd, &pos);
@@ -266,10 +340,11 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		auto rdata = job->GetDataAs<_NWWGetVector2>();
+		auto rdata = &data;
 
 		return Vector2(rdata->x, rdata->y);
 	}
@@ -286,7 +361,7 @@ namespace Engine::PlatformSpecific::Windows {
 
 		// Job
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetVector2>();
+			auto data = *job->GetDataAs<_NWWSetVector2*>();
 			bool succeeded = SetWindowPos(data->hWnd, NULL, data->x, data->y, 0, 0, SWP_NOREPOSITION | SWP_NOSIZE);
 			data->result = succeeded;
 		};
@@ -297,11 +372,12 @@ namespace Engine::PlatformSpecific::Windows {
 		data.y = rect.top;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
-		succeeded = job->GetDataAs<_NWWSetVector2>()->result;
+		succeeded = data.result;
 		ERR_ASSERT(succeeded, u8"SetWindowPos failed to set window rect!", return false);
 		return true;
 	}
@@ -310,7 +386,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return Vector2());
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWGetVector2>();
+			auto data = *job->GetDataAs<_NWWGetVector2*>();
 			
 			RECT rect = {};
 			GetClientRect(data->hWnd, &rect);
@@ -323,10 +399,11 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		auto rdata = job->GetDataAs<_NWWGetVector2>();
+		auto rdata = &data;
 
 		return Vector2(rdata->x, rdata->y);
 	}
@@ -342,7 +419,7 @@ namespace Engine::PlatformSpecific::Windows {
 
 		// Job
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetVector2>();
+			auto data = *job->GetDataAs<_NWWSetVector2*>();
 			bool succeeded = SetWindowPos(data->hWnd, NULL, 0, 0, data->x, data->y, SWP_NOREPOSITION | SWP_NOMOVE);
 			data->result = succeeded;
 		};
@@ -353,11 +430,12 @@ namespace Engine::PlatformSpecific::Windows {
 		data.y = rect.bottom - rect.top;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
-		bool succeeded = job->GetDataAs<_NWWSetVector2>()->result;
+		bool succeeded = data.result;
 		ERR_ASSERT(succeeded, u8"SetWindowPos failed to set window rect!", return false);
 		return true;
 	}
@@ -366,7 +444,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWHasStyleFlag>();
+			auto data = *job->GetDataAs<_NWWHasStyleFlag*>();
 			bool result = Window::HasStyleFlag(data->hWnd, WS_VISIBLE);
 			data->result = result;
 		};
@@ -374,17 +452,18 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		bool result = job->GetDataAs<_NWWHasStyleFlag>()->result;
+		bool result = data.result;
 		return result;
 	}
 	bool Window::SetVisible(bool visible) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 		
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetStyleFlag>();
+			auto data = *job->GetDataAs<_NWWSetStyleFlag*>();
 			ShowWindow(data->hWnd, data->enabled ? SW_SHOW : SW_HIDE);
 			//UpdateWindow(data->hWnd);
 		};
@@ -393,7 +472,8 @@ namespace Engine::PlatformSpecific::Windows {
 		data.enabled = visible;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
@@ -404,7 +484,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWHasStyleFlag>();
+			auto data = *job->GetDataAs<_NWWHasStyleFlag*>();
 			bool result = Window::HasStyleFlag(data->hWnd, WS_MINIMIZE);
 			data->result = result;
 		};
@@ -412,17 +492,18 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		bool result = job->GetDataAs<_NWWHasStyleFlag>()->result;
+		bool result = data.result;
 		return result;
 	}
 	bool Window::SetMinimized(bool minimized) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetStyleFlag>();
+			auto data = *job->GetDataAs<_NWWSetStyleFlag*>();
 			ShowWindow(data->hWnd, data->enabled ? SW_MINIMIZE : SW_RESTORE);
 		};
 		_NWWSetStyleFlag data = {};
@@ -430,7 +511,8 @@ namespace Engine::PlatformSpecific::Windows {
 		data.enabled = minimized;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
@@ -440,7 +522,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWHasStyleFlag>();
+			auto data = *job->GetDataAs<_NWWHasStyleFlag*>();
 			bool result = Window::HasStyleFlag(data->hWnd, WS_MAXIMIZE);
 			data->result = result;
 		};
@@ -448,17 +530,18 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		bool result = job->GetDataAs<_NWWHasStyleFlag>()->result;
+		bool result = data.result;
 		return result;
 	}
 	bool Window::SetMaximized(bool maximized) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetStyleFlag>();
+			auto data = *job->GetDataAs<_NWWSetStyleFlag*>();
 			ShowWindow(data->hWnd, data->enabled ? SW_MAXIMIZE : SW_RESTORE);
 		};
 		_NWWSetStyleFlag data = {};
@@ -466,7 +549,8 @@ namespace Engine::PlatformSpecific::Windows {
 		data.enabled = maximized;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
@@ -476,7 +560,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWHasStyleFlag>();
+			auto data = *job->GetDataAs<_NWWHasStyleFlag*>();
 			bool result = GetMenuState(GetSystemMenu(data->hWnd, false), SC_CLOSE, MF_BYCOMMAND) & MF_ENABLED;
 			data->result = result;
 		};
@@ -484,17 +568,18 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		bool result = job->GetDataAs<_NWWHasStyleFlag>()->result;
+		bool result = data.result;
 		return result;
 	}
 	bool Window::SetCloseButton(bool enabled) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetStyleFlag>();
+			auto data = *job->GetDataAs<_NWWSetStyleFlag*>();
 			DWORD flag = (data->enabled ? MF_ENABLED : MF_DISABLED | MF_GRAYED);
 			bool succeeded = EnableMenuItem(GetSystemMenu(data->hWnd, false), SC_CLOSE, MF_BYCOMMAND | flag);
 			data->result = succeeded;
@@ -504,18 +589,19 @@ namespace Engine::PlatformSpecific::Windows {
 		data.enabled = enabled;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
-		bool succeeded = job->GetDataAs<_NWWSetStyleFlag>()->result;
+		bool succeeded = data.result;
 		return succeeded;
 	}
 	bool Window::HasMinimizeButton() const {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWHasStyleFlag>();
+			auto data = *job->GetDataAs<_NWWHasStyleFlag*>();
 			bool result = Window::HasStyleFlag(data->hWnd, WS_MINIMIZEBOX);
 			data->result = result;
 		};
@@ -523,17 +609,18 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		bool result = job->GetDataAs<_NWWHasStyleFlag>()->result;
+		bool result = data.result;
 		return result;
 	}
 	bool Window::SetMinimizeButton(bool enabled) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetStyleFlag>();
+			auto data = *job->GetDataAs<_NWWSetStyleFlag*>();
 			bool succeeded = Window::SetStyleFlag(data->hWnd, WS_MINIMIZEBOX, data->enabled);
 			data->result = succeeded;
 		};
@@ -542,18 +629,19 @@ namespace Engine::PlatformSpecific::Windows {
 		data.enabled = enabled;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
-		bool succeeded = job->GetDataAs<_NWWSetStyleFlag>()->result;
+		bool succeeded = data.result;
 		return succeeded;
 	}
 	bool Window::HasMaximizeButton() const {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWHasStyleFlag>();
+			auto data = *job->GetDataAs<_NWWHasStyleFlag*>();
 			bool result = Window::HasStyleFlag(data->hWnd, WS_MAXIMIZEBOX);
 			data->result = result;
 		};
@@ -561,17 +649,18 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		bool result = job->GetDataAs<_NWWHasStyleFlag>()->result;
+		bool result = data.result;
 		return result;
 	}
 	bool Window::SetMaximizeButton(bool enabled) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetStyleFlag>();
+			auto data = *job->GetDataAs<_NWWSetStyleFlag*>();
 			bool succeeded = Window::SetStyleFlag(data->hWnd, WS_MAXIMIZEBOX, data->enabled);
 			data->result = succeeded;
 		};
@@ -580,11 +669,12 @@ namespace Engine::PlatformSpecific::Windows {
 		data.enabled = enabled;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
-		bool succeeded = job->GetDataAs<_NWWSetStyleFlag>()->result;
+		bool succeeded = data.result;
 		return succeeded;
 	}
 
@@ -592,7 +682,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWHasStyleFlag>();
+			auto data = *job->GetDataAs<_NWWHasStyleFlag*>();
 			bool result = Window::HasStyleFlag(data->hWnd, WS_BORDER);
 			data->result = result;
 		};
@@ -600,17 +690,18 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		bool result = job->GetDataAs<_NWWHasStyleFlag>()->result;
+		bool result = data.result;
 		return result;
 	}
 	bool Window::SetBorder(bool enabled) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetStyleFlag>();
+			auto data = *job->GetDataAs<_NWWSetStyleFlag*>();
 			HWND hWnd = data->hWnd;
 
 			POINT pos{};
@@ -635,11 +726,12 @@ namespace Engine::PlatformSpecific::Windows {
 		data.enabled = enabled;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
-		bool succeeded = job->GetDataAs<_NWWSetStyleFlag>()->result;
+		bool succeeded = data.result;
 		return succeeded;
 	}
 
@@ -647,7 +739,7 @@ namespace Engine::PlatformSpecific::Windows {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWHasStyleFlag>();
+			auto data = *job->GetDataAs<_NWWHasStyleFlag*>();
 			bool result = Window::HasStyleFlag(data->hWnd, WS_SIZEBOX);
 			data->result = result;
 		};
@@ -655,17 +747,18 @@ namespace Engine::PlatformSpecific::Windows {
 		data.hWnd = hWnd;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 		js->WaitJob(job);
 
-		bool result = job->GetDataAs<_NWWHasStyleFlag>()->result;
+		bool result = data.result;
 		return result;
 	}
 	bool Window::SetResizable(bool resizable) {
 		ERR_ASSERT(IsValid(), u8"The window is not valid!", return false);
 
 		auto func = [](Job* job) {
-			auto data = job->GetDataAs<_NWWSetStyleFlag>();
+			auto data = *job->GetDataAs<_NWWSetStyleFlag*>();
 			bool succeeded = Window::SetStyleFlag(data->hWnd, WS_SIZEBOX, data->enabled);
 			data->result = succeeded;
 		};
@@ -674,11 +767,12 @@ namespace Engine::PlatformSpecific::Windows {
 		data.enabled = resizable;
 
 		auto js = ENGINEINST->GetJobSystem();
-		auto job = js->AddJob(func, &data, sizeof(data), Job::Preference::Window);
+		auto dataPtr = &data;
+		auto job = js->AddJob(func, &dataPtr, sizeof(dataPtr), Job::Preference::Window);
 
 		js->WaitJob(job);
 
-		bool succeeded = job->GetDataAs<_NWWSetStyleFlag>()->result;
+		bool succeeded = data.result;
 		return succeeded;
 	}
 
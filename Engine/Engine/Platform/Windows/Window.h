@@ -10,15 +10,19 @@ namespace Engine::PlatformSpecific::Windows {
 		REFLECTION_CLASS(::Engine::PlatformSpecific::Windows::WindowSystem, ::Engine::WindowSystem) {}
 
 	public:
+		WindowSystem();
 		void Update() override;
 
 	private:
+		/// @brief Brings up the window framework with the first window system, so running headless never touches it.
 		class _Initializer final {
 		public:
 			_Initializer();
 			~_Initializer();
 		};
-		static _Initializer _initializer;
+
+		// Set while a pump job is queued or running, so slow frames don't queue one per frame.
+		AtomicValue<bool> pumping{ false };
 	};
 
 	class Window final:public ::Engine::Window {
@@ -81,5 +85,7 @@ namespace Engine::PlatformSpecific::Windows {
 
 	private:
 		HWND hWnd = NULL;
+		/// @brief The last title set, so setting the same one again skips the conversion and the window job.
+		String title;
 	};
 }
@@ -0,0 +1,175 @@
+#include "Engine/System/BufferedStream.h"
+
+namespace Engine {
+	BufferedStream::BufferedStream(const IntrusivePtr<Stream>& stream, int32 bufferSize) :stream(stream), bufferSize(bufferSize) {
+		ERR_ASSERT(bufferSize > 0, u8"bufferSize must be greater than 0.", this->bufferSize = DefaultBufferSize);
+		buffer.SetCount(this->bufferSize);
+	}
+	BufferedStream::~BufferedStream() {
+		if (IsValid()) {
+			Flush();
+		}
+	}
+
+	void BufferedStream::Close() {
+		if (!IsValid()) {
+			return;
+		}
+		Flush();
+		bufferStart = 0;
+		bufferEnd = 0;
+		stream->Close();
+	}
+	bool BufferedStream::IsValid() const {
+		return stream.GetRaw() != nullptr && stream->IsValid();
+	}
+	bool BufferedStream::CanRead() const {
+		return IsValid() && stream->CanRead();
+	}
+	bool BufferedStream::CanWrite() const {
+		return IsValid() && stream->CanWrite();
+	}
+	bool BufferedStream::CanRandomAccess() const {
+		return IsValid() && stream->CanRandomAccess();
+	}
+
+	ResultCode BufferedStream::SetPosition(int64 position) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return ResultCode::InvalidStream);
+		ResultCode r = Flush();
+		if (r != ResultCode::OK) {
+			return r;
+		}
+		bufferStart = 0;
+		bufferEnd = 0;
+		return stream->SetPosition(position);
+	}
+	int64 BufferedStream::GetPosition() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return -1);
+		int64 position = stream->GetPosition();
+		if (position < 0) {
+			return position;
+		}
+		return writing ? position + bufferEnd : position - (bufferEnd - bufferStart);
+	}
+	int64 BufferedStream::GetLength() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return -1);
+		int64 length = stream->GetLength();
+		if (!writing || length < 0) {
+			return length;
+		}
+		// The pending bytes may go past the end.
+		int64 end = GetPosition();
+		return end > length ? end : length;
+	}
+
+	ResultCode BufferedStream::Flush() {
+		if (!writing || bufferEnd == 0) {
+			return ResultCode::OK;
+		}
+		ResultCode r = stream->WriteBytes(buffer.GetRawElementPtr(), bufferEnd);
+		bufferEnd = 0;
+		return r;
+	}
+	const IntrusivePtr<Stream>& BufferedStream::GetStream() const {
+		return stream;
+	}
+	int32 BufferedStream::GetBufferSize() const {
+		return bufferSize;
+	}
+
+	ResultCode BufferedStream::WriteBytesUnchecked(const byte* valuePtr, int32 length) {
+		ERR_ASSERT(CheckWrite(), u8"This stream cannot write.", return ResultCode::NoPermission);
+		return WriteRaw(valuePtr, length);
+	}
+	int32 BufferedStream::ReadBytesUnchecked(byte* result, int32 length) {
+		ERR_ASSERT(CheckRead(), u8"This stream cannot read.", return 0);
+		if (BeginRead() != ResultCode::OK) {
+			return 0;
+		}
+
+		int32 buffered = bufferEnd - bufferStart < length ? bufferEnd - bufferStart : length;
+		std::memcpy(result, buffer.GetRawElementPtr() + bufferStart, buffered);
+		bufferStart += buffered;
+
+		int32 remaining = length - buffered;
+		if (remaining < bufferSize) {
+			return buffered + ReadRaw(result + buffered, remaining);
+		}
+		// Too big to be worth buffering, the stream reads right into the place of the remaining bytes.
+		return buffered + stream->ReadBytes(result + buffered, remaining);
+	}
+
+	bool BufferedStream::CheckRead() const {
+		return IsValid() && stream->CanRead();
+	}
+	bool BufferedStream::CheckWrite() const {
+		return IsValid() && stream->CanWrite();
+	}
+	ResultCode BufferedStream::BeginWrite() {
+		if (writing) {
+			return ResultCode::OK;
+		}
+		int32 unread = bufferEnd - bufferStart;
+		if (unread > 0) {
+			ERR_ASSERT(stream->CanRandomAccess(), u8"Cannot write after reading ahead without random access.", return ResultCode::NotSupported);
+			ResultCode r = stream->SetPosition(stream->GetPosition() - unread);
+			if (r != ResultCode::OK) {
+				return r;
+			}
+		}
+		bufferStart = 0;
+		bufferEnd = 0;
+		writing = true;
+		return ResultCode::OK;
+	}
+	ResultCode BufferedStream::BeginRead() {
+		if (!writing) {
+			return ResultCode::OK;
+		}
+		ResultCode r = Flush();
+		bufferStart = 0;
+		bufferEnd = 0;
+		writing = false;
+		return r;
+	}
+	ResultCode BufferedStream::WriteRaw(const byte* valuePtr, int32 length) {
+		ResultCode r = BeginWrite();
+		if (r != ResultCode::OK || length == 0) {
+			return r;
+		}
+		if (bufferEnd + length > bufferSize) {
+			r = Flush();
+			if (r != ResultCode::OK) {
+				return r;
+			}
+			if (length >= bufferSize) {
+				return stream->WriteBytes(valuePtr, length);
+			}
+		}
+		std::memcpy(buffer.GetRawElementPtr() + bufferEnd, valuePtr, length);
+		bufferEnd += length;
+		return ResultCode::OK;
+	}
+	int32 BufferedStream::ReadRaw(byte* result, int32 length) {
+		if (BeginRead() != ResultCode::OK) {
+			return 0;
+		}
+		int32 done = 0;
+		while (done < length) {
+			if (bufferStart == bufferEnd && Refill() == 0) {
+				break;
+			}
+			int32 size = bufferEnd - bufferStart < length - done ? bufferEnd - bufferStart : length - done;
+			std::memcpy(result + done, buffer.GetRawElementPtr() + bufferStart, size);
+			bufferStart += size;
+			done += size;
+		}
+		return done;
+	}
+	int32 BufferedStream::Refill() {
+		int32 read = stream->ReadBytes(buffer.GetRawElementPtr(), bufferSize);
+		bufferStart = 0;
+		bufferEnd = read;
+		return read;
+	}
+}
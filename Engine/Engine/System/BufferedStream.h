@@ -0,0 +1,149 @@
+#pragma once
+#include "Engine/System/Stream.h"
+#include "Engine/System/Memory/IntrusivePtr.h"
+#include <cstring>
+
+namespace Engine {
+	/// @brief Puts a buffer in front of another Stream, so small reads and writes do not each reach it.\n
+	/// The typed Read() and Write() check the stream once and copy straight from or into the buffer, swapping the bytes in registers when the endianness differs.
+	/// The arrays versions do the same for many values at once, use them for binary assets.\n
+	/// The buffer either holds bytes read ahead or bytes waiting to be written, switching from reading to writing needs random access to go back to the read position.
+	/// Writes are flushed by Flush(), SetPosition(), Close() and the destructor.
+	class BufferedStream final :public Stream {
+		REFLECTION_CLASS(::Engine::BufferedStream, ::Engine::Stream) {}
+
+	public:
+		static inline constexpr int32 DefaultBufferSize = 4096;
+
+		/// @param stream Read and written from its current position.
+		BufferedStream(const IntrusivePtr<Stream>& stream, int32 bufferSize = DefaultBufferSize);
+		~BufferedStream();
+
+		/// @brief Flush, then close the underlying stream.
+		void Close() override;
+		bool IsValid() const override;
+		bool CanRead() const override;
+		bool CanWrite() const override;
+		bool CanRandomAccess() const override;
+
+		ResultCode SetPosition(int64 position) override;
+		int64 GetPosition() const override;
+		int64 GetLength() const override;
+
+		/// @brief Write the buffered bytes to the underlying stream.
+		ResultCode Flush();
+		const IntrusivePtr<Stream>& GetStream() const;
+		int32 GetBufferSize() const;
+
+		/// @brief Write an integer or floating point in the current endianness.
+		template<typename T>
+		ResultCode Write(T value);
+		/// @brief Write count integers or floating points in the current endianness.
+		template<typename T>
+		ResultCode Write(const T* values, int32 count);
+		/// @brief Read an integer or floating point in the current endianness.
+		/// @return 0 if there are not enough bytes left.
+		template<typename T>
+		T Read();
+		/// @brief Read up to count integers or floating points in the current endianness.
+		/// @return The number of values read. The bytes of a partial last value are consumed but not counted.
+		template<typename T>
+		int32 Read(T* values, int32 count);
+
+	protected:
+		ResultCode WriteBytesUnchecked(const byte* valuePtr, int32 length) override;
+		int32 ReadBytesUnchecked(byte* result, int32 length) override;
+
+	private:
+		bool CheckRead() const;
+		bool CheckWrite() const;
+		/// @brief Give the read ahead bytes back, so the buffer can take writes.
+		ResultCode BeginWrite();
+		ResultCode BeginRead();
+		ResultCode WriteRaw(const byte* valuePtr, int32 length);
+		int32 ReadRaw(byte* result, int32 length);
+		/// @return The number of bytes read ahead.
+		int32 Refill();
+
+		IntrusivePtr<Stream> stream{};
+		/// @brief Always bufferSize bytes, the used part is [bufferStart, bufferEnd).
+		List<byte> buffer{};
+		int32 bufferSize = 0;
+		int32 bufferStart = 0;
+		int32 bufferEnd = 0;
+		/// @brief Whether the used part is waiting to be written, or was read ahead.
+		bool writing = false;
+	};
+
+	template<typename T>
+	inline ResultCode BufferedStream::Write(T value) {
+		static_assert(std::is_arithmetic_v<T>, "Only integers and floating points can be written.");
+		if (GetCurrentEndianness() != LocalEndianness) {
+			value = SwapBytes(value);
+		}
+		if (writing && bufferEnd + (int32)sizeof(T) <= bufferSize) {
+			std::memcpy(buffer.GetRawElementPtr() + bufferEnd, &value, sizeof(T));
+			bufferEnd += sizeof(T);
+			return ResultCode::OK;
+		}
+		ERR_ASSERT(CheckWrite(), u8"This stream cannot write.", return ResultCode::NoPermission);
+		return WriteRaw((const byte*)&value, sizeof(T));
+	}
+	template<typename T>
+	inline ResultCode BufferedStream::Write(const T* values, int32 count) {
+		static_assert(std::is_arithmetic_v<T>, "Only integers and floating points can be written.");
+		ERR_ASSERT(count >= 0, u8"count must be greater than 0.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(CheckWrite(), u8"This stream cannot write.", return ResultCode::NoPermission);
+		if (GetCurrentEndianness() == LocalEndianness) {
+			return WriteRaw((const byte*)values, count * (int32)sizeof(T));
+		}
+
+		// Copy as many as fit into the buffer and swap them there.
+		ResultCode r = BeginWrite();
+		for (int32 done = 0; done < count && r == ResultCode::OK;) {
+			int32 part = (bufferSize - bufferEnd) / (int32)sizeof(T);
+			if (part == 0) {
+				if (bufferEnd > 0) {
+					r = Flush();
+				} else {
+					// A buffer smaller than a value.
+					T value = SwapBytes(values[done]);
+					r = WriteRaw((const byte*)&value, sizeof(T));
+					done += 1;
+				}
+				continue;
+			}
+			part = part < count - done ? part : count - done;
+			std::memcpy(buffer.GetRawElementPtr() + bufferEnd, values + done, part * sizeof(T));
+			SwapBytes(buffer.GetRawElementPtr() + bufferEnd, part, (int32)sizeof(T));
+			bufferEnd += part * (int32)sizeof(T);
+			done += part;
+		}
+		return r;
+	}
+	template<typename T>
+	inline T BufferedStream::Read() {
+		static_assert(std::is_arithmetic_v<T>, "Only integers and floating points can be read.");
+		T value;
+		if (!writing && bufferEnd - bufferStart >= (int32)sizeof(T)) {
+			std::memcpy(&value, buffer.GetRawElementPtr() + bufferStart, sizeof(T));
+			bufferStart += sizeof(T);
+		} else {
+			ERR_ASSERT(CheckRead(), u8"This stream cannot read.", return 0);
+			int32 read = ReadRaw((byte*)&value, sizeof(T));
+			ERR_ASSERT(read == sizeof(T), u8"Not enough bytes left.", return 0);
+		}
+		return GetCurrentEndianness() != LocalEndianness ? SwapBytes(value) : value;
+	}
+	template<typename T>
+	inline int32 BufferedStream::Read(T* values, int32 count) {
+		static_assert(std::is_arithmetic_v<T>, "Only integers and floating points can be read.");
+		ERR_ASSERT(count >= 0, u8"count must be greater than 0.", return 0);
+		ERR_ASSERT(CheckRead(), u8"This stream cannot read.", return 0);
+		int32 read = ReadRaw((byte*)values, count * (int32)sizeof(T)) / (int32)sizeof(T);
+		if (GetCurrentEndianness() != LocalEndianness) {
+			SwapBytes((byte*)values, read, (int32)sizeof(T));
+		}
+		return read;
+	}
+}
@@ -0,0 +1,140 @@
+#include "Engine/System/Clock.h"
+#include "Engine/Platform/Definition.h"
+#include <chrono>
+#include <thread>
+
+#if CURRENT_PLATFORM_WINDOWS
+#	include "Engine/Platform/Windows/BetterWindows.h"
+#elif CURRENT_PLATFORM_LINUX
+#	include <cstdio>
+#	include <cstring>
+#	include <time.h>
+#endif
+
+#if defined(CLOCK_TSC) && !(defined(_MSC_VER) && !defined(__clang__))
+#	include <cpuid.h>
+#endif
+
+namespace Engine {
+	namespace {
+#if defined(CLOCK_TSC)
+		bool HasInvariantTsc() {
+			uint32 registers[4] = { 0, 0, 0, 0 };
+#	if defined(_MSC_VER) && !defined(__clang__)
+			int32 values[4];
+			__cpuid(values, (int32)0x80000000);
+			if ((uint32)values[0] < 0x80000007) {
+				return false;
+			}
+			__cpuid(values, (int32)0x80000007);
+			registers[3] = (uint32)values[3];
+#	else
+			if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+				return false;
+			}
+			__get_cpuid(0x80000007, &registers[0], &registers[1], &registers[2], &registers[3]);
+#	endif
+			// Ticks at a constant rate in every power state and on every core.
+			return (registers[3] & (1u << 8)) != 0;
+		}
+		bool IsTscTrusted() {
+			if (!HasInvariantTsc()) {
+				return false;
+			}
+#	if CURRENT_PLATFORM_LINUX
+			// The kernel drops the TSC when it finds it unsynchronized across sockets or unstable under a hypervisor.
+			FILE* file = std::fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+			if (file == nullptr) {
+				return false;
+			}
+			char source[32] = {};
+			bool read = std::fgets(source, sizeof(source), file) != nullptr;
+			std::fclose(file);
+			return read && std::strncmp(source, "tsc", 3) == 0;
+#	else
+			return true;
+#	endif
+		}
+		/// @brief Read the TSC and the system clock as close together as possible, the tightest of a few tries.
+		void ReadPair(uint64 (*readSystem)(), uint64& tsc, uint64& system) {
+			uint64 best = ~(uint64)0;
+			for (int32 i = 0; i < 8; i += 1) {
+				uint64 before = __rdtsc();
+				uint64 value = readSystem();
+				uint64 after = __rdtsc();
+				if (after - before < best) {
+					best = after - before;
+					tsc = before + (after - before) / 2;
+					system = value;
+				}
+			}
+		}
+#endif
+	}
+
+	uint64 Clock::GetFrequency() {
+		return GetCalibration().frequency;
+	}
+	uint64 Clock::FromSeconds(double seconds) {
+		if (seconds <= 0) {
+			return 0;
+		}
+		return (uint64)(seconds * (double)GetCalibration().frequency);
+	}
+	bool Clock::IsUsingTsc() {
+		return GetCalibration().tsc;
+	}
+
+	Clock::Calibration Clock::Calibrate() {
+		Calibration calibration{};
+		calibration.frequency = GetSystemFrequency();
+#if defined(CLOCK_TSC)
+		if (IsTscTrusted()) {
+			// 10 ms against a clock read within tens of nanoseconds puts the frequency within a few parts per million.
+			uint64 tscBegin = 0;
+			uint64 systemBegin = 0;
+			ReadPair(&Clock::ReadSystem, tscBegin, systemBegin);
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			uint64 tscEnd = 0;
+			uint64 systemEnd = 0;
+			ReadPair(&Clock::ReadSystem, tscEnd, systemEnd);
+			double seconds = (double)(systemEnd - systemBegin) / (double)calibration.frequency;
+			if (tscEnd > tscBegin && seconds > 0) {
+				calibration.tsc = true;
+				calibration.frequency = (uint64)((double)(tscEnd - tscBegin) / seconds);
+			}
+		}
+#endif
+		calibration.secondsPerTick = 1.0 / (double)calibration.frequency;
+#if defined(CLOCK_TSC)
+		calibration.base = calibration.tsc ? __rdtsc() : ReadSystem();
+#else
+		calibration.base = ReadSystem();
+#endif
+		return calibration;
+	}
+
+	uint64 Clock::ReadSystem() {
+#if CURRENT_PLATFORM_WINDOWS
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+		return (uint64)counter.QuadPart;
+#elif CURRENT_PLATFORM_LINUX
+		// Not slewed by NTP, so the rate stays the one calibrated against.
+		timespec spec;
+		clock_gettime(CLOCK_MONOTONIC_RAW, &spec);
+		return (uint64)spec.tv_sec * 1000000000ull + (uint64)spec.tv_nsec;
+#else
+		return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+	uint64 Clock::GetSystemFrequency() {
+#if CURRENT_PLATFORM_WINDOWS
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		return (uint64)frequency.QuadPart;
+#else
+		return 1000000000ull;
+#endif
+	}
+}
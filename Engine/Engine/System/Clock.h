@@ -0,0 +1,72 @@
+#pragma once
+#include "Engine/System/Definition.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#	define CLOCK_TSC
+#	if defined(_MSC_VER) && !defined(__clang__)
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#endif
+
+namespace Engine {
+	/// @brief Monotonic timestamps cheap enough to take around every piece of instrumented code.\n
+	/// On x86 with an invariant TSC the counter is read directly, calibrated against the system clock once on first use.
+	/// Elsewhere, or when the kernel doesn't trust the TSC, the system monotonic clock is read instead:
+	/// CLOCK_MONOTONIC_RAW on Linux and QueryPerformanceCounter on Windows.\n
+	/// Ticks only mean something relative to each other in the same process, convert differences with ToSeconds() or ToNanoseconds().
+	class Clock final {
+		STATIC_CLASS(Clock);
+
+	public:
+		/// @brief The current ticks, never going backwards on a thread.
+		static uint64 Now() {
+			const Calibration& calibration = GetCalibration();
+#if defined(CLOCK_TSC)
+			if (calibration.tsc) {
+				return __rdtsc();
+			}
+#endif
+			(void)calibration;
+			return ReadSystem();
+		}
+		/// @brief Nanoseconds since the clock was first used, for timestamps that are readable on their own.
+		static uint64 GetNanoseconds() {
+			return ToNanoseconds(Now() - GetCalibration().base);
+		}
+
+		/// @brief Ticks per second.
+		static uint64 GetFrequency();
+		/// @brief Convert a difference of ticks.
+		static double ToSeconds(uint64 ticks) {
+			return (double)ticks * GetCalibration().secondsPerTick;
+		}
+		/// @brief Convert a difference of ticks, truncated to the nanosecond however long the span is.
+		static uint64 ToNanoseconds(uint64 ticks) {
+			// Whole seconds and the rest apart, so nothing goes through a double or overflows below 18 GHz.
+			uint64 frequency = GetCalibration().frequency;
+			return ticks / frequency * 1000000000ull + ticks % frequency * 1000000000ull / frequency;
+		}
+		/// @brief The ticks elapsing in the seconds, negative seconds give 0.
+		static uint64 FromSeconds(double seconds);
+		/// @brief Check if the TSC is read, false when falling back to the system clock.
+		static bool IsUsingTsc();
+
+	private:
+		struct Calibration {
+			bool tsc = false;
+			// The ticks when calibrated, the origin of GetNanoseconds().
+			uint64 base = 0;
+			uint64 frequency = 0;
+			double secondsPerTick = 0;
+		};
+		static const Calibration& GetCalibration() {
+			static const Calibration calibration = Calibrate();
+			return calibration;
+		}
+		static Calibration Calibrate();
+		static uint64 ReadSystem();
+		static uint64 GetSystemFrequency();
+	};
+}
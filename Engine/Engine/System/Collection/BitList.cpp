@@ -0,0 +1,125 @@
+#include "Engine/System/Collection/BitList.h"
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BITLIST_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define BITLIST_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Engine {
+	namespace {
+		enum class Operation {
+			And,
+			Or,
+			AndNot,
+			Xor
+		};
+		/// @brief target = target op source, two words at a time with SIMD, the odd one left as a scalar.
+		template<Operation Op>
+		void Combine(uint64* target, const uint64* source, int32 count) {
+			int32 i = 0;
+#if defined(BITLIST_SSE2)
+			for (; i + 2 <= count; i += 2) {
+				__m128i a = _mm_loadu_si128((const __m128i*)(target + i));
+				__m128i b = _mm_loadu_si128((const __m128i*)(source + i));
+				if constexpr (Op == Operation::And) {
+					a = _mm_and_si128(a, b);
+				} else if constexpr (Op == Operation::Or) {
+					a = _mm_or_si128(a, b);
+				} else if constexpr (Op == Operation::AndNot) {
+					// Negates its first operand.
+					a = _mm_andnot_si128(b, a);
+				} else {
+					a = _mm_xor_si128(a, b);
+				}
+				_mm_storeu_si128((__m128i*)(target + i), a);
+			}
+#elif defined(BITLIST_NEON)
+			for (; i + 2 <= count; i += 2) {
+				uint64x2_t a = vld1q_u64(target + i);
+				uint64x2_t b = vld1q_u64(source + i);
+				if constexpr (Op == Operation::And) {
+					a = vandq_u64(a, b);
+				} else if constexpr (Op == Operation::Or) {
+					a = vorrq_u64(a, b);
+				} else if constexpr (Op == Operation::AndNot) {
+					a = vbicq_u64(a, b);
+				} else {
+					a = veorq_u64(a, b);
+				}
+				vst1q_u64(target + i, a);
+			}
+#endif
+			for (; i < count; i += 1) {
+				if constexpr (Op == Operation::And) {
+					target[i] &= source[i];
+				} else if constexpr (Op == Operation::Or) {
+					target[i] |= source[i];
+				} else if constexpr (Op == Operation::AndNot) {
+					target[i] &= ~source[i];
+				} else {
+					target[i] ^= source[i];
+				}
+			}
+		}
+	}
+
+	void BitOperations::And(uint64* target, const uint64* source, int32 count) {
+		Combine<Operation::And>(target, source, count);
+	}
+	void BitOperations::Or(uint64* target, const uint64* source, int32 count) {
+		Combine<Operation::Or>(target, source, count);
+	}
+	void BitOperations::AndNot(uint64* target, const uint64* source, int32 count) {
+		Combine<Operation::AndNot>(target, source, count);
+	}
+	void BitOperations::Xor(uint64* target, const uint64* source, int32 count) {
+		Combine<Operation::Xor>(target, source, count);
+	}
+
+	int32 BitOperations::PopCount(const uint64* words, int32 count) {
+		// Separate sums let the popcounts of consecutive words overlap.
+		int32 sums[4]{};
+		int32 i = 0;
+		for (; i + 4 <= count; i += 4) {
+			sums[0] += std::popcount(words[i]);
+			sums[1] += std::popcount(words[i + 1]);
+			sums[2] += std::popcount(words[i + 2]);
+			sums[3] += std::popcount(words[i + 3]);
+		}
+		for (; i < count; i += 1) {
+			sums[0] += std::popcount(words[i]);
+		}
+		return sums[0] + sums[1] + sums[2] + sums[3];
+	}
+	bool BitOperations::Intersects(const uint64* a, const uint64* b, int32 count) {
+		for (int32 i = 0; i < count; i += 1) {
+			if ((a[i] & b[i]) != 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+	int32 BitOperations::FindFirstSet(const uint64* words, int32 count, int32 from) {
+		if (from < 0) {
+			from = 0;
+		}
+		int32 i = from / WordBits;
+		if (i >= count) {
+			return -1;
+		}
+		// Bits before from in the first word are masked off.
+		uint64 word = words[i] & (~(uint64)0 << (from % WordBits));
+		while (true) {
+			if (word != 0) {
+				return i * WordBits + std::countr_zero(word);
+			}
+			i += 1;
+			if (i >= count) {
+				return -1;
+			}
+			word = words[i];
+		}
+	}
+}
@@ -0,0 +1,252 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Debug.h"
+#include <bit>
+
+namespace Engine {
+	/// @brief Operations over arrays of 64 bit words, shared by BitList and BitSet.\n
+	/// The bulk ones go 128 bits at a time with SSE2 or NEON where available.
+	class BitOperations final {
+		STATIC_CLASS(BitOperations);
+
+	public:
+		static inline constexpr int32 WordBits = 64;
+
+		static constexpr int32 GetWordCount(int32 bitCount) {
+			return (bitCount + WordBits - 1) / WordBits;
+		}
+
+		/// @brief target &= source, for count words.
+		static void And(uint64* target, const uint64* source, int32 count);
+		/// @brief target |= source.
+		static void Or(uint64* target, const uint64* source, int32 count);
+		/// @brief target &= ~source, clearing the bits set in source.
+		static void AndNot(uint64* target, const uint64* source, int32 count);
+		/// @brief target ^= source.
+		static void Xor(uint64* target, const uint64* source, int32 count);
+		/// @brief Count of set bits.
+		static int32 PopCount(const uint64* words, int32 count);
+		/// @brief Whether any bit is set in both.
+		static bool Intersects(const uint64* a, const uint64* b, int32 count);
+		/// @brief Index of the first set bit at or after the bit from, -1 if none.
+		static int32 FindFirstSet(const uint64* words, int32 count, int32 from);
+		/// @brief Call function(index) for every set bit in increasing order, a word at a time.
+		template<typename Function>
+		static void ForEachSet(const uint64* words, int32 count, const Function& function) {
+			for (int32 i = 0; i < count; i += 1) {
+				uint64 word = words[i];
+				while (word != 0) {
+					function(i * WordBits + std::countr_zero(word));
+					// Clear the lowest set bit.
+					word &= word - 1;
+				}
+			}
+		}
+	};
+
+	/// @brief A growable array of bits packed in 64 bit words, for flags kept parallel to packed storage.\n
+	/// Bits past the count in the last word are always zero.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.
+	class BitList final {
+	public:
+		BitList(int32 count = 0, Allocator* allocator = nullptr) :words(0, allocator) {
+			SetCount(count);
+		}
+
+		int32 GetCount() const {
+			return count;
+		}
+		/// @brief Grow with bits of the value or shrink from the end.
+		void SetCount(int32 count, bool value = false) {
+			ERR_ASSERT(count >= 0, u8"count cannot be less than 0.", return);
+			int32 oldCount = this->count;
+			words.SetCount(BitOperations::GetWordCount(count));
+			this->count = count;
+			if (count > oldCount && value) {
+				for (int32 i = oldCount; i < count && i % BitOperations::WordBits != 0; i += 1) {
+					Set(i, true);
+				}
+				int32 firstWord = BitOperations::GetWordCount(oldCount);
+				for (int32 i = firstWord; i < words.GetCount(); i += 1) {
+					words[i] = ~(uint64)0;
+				}
+			}
+			ClearTail();
+		}
+		void Add(bool value) {
+			SetCount(count + 1);
+			if (value) {
+				Set(count - 1, true);
+			}
+		}
+		void Clear() {
+			words.Clear();
+			count = 0;
+		}
+
+		bool Get(int32 index) const {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return false);
+			return (words[index / BitOperations::WordBits] >> (index % BitOperations::WordBits)) & 1;
+		}
+		void Set(int32 index, bool value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			uint64 mask = (uint64)1 << (index % BitOperations::WordBits);
+			uint64& word = words[index / BitOperations::WordBits];
+			word = value ? (word | mask) : (word & ~mask);
+		}
+		void Flip(int32 index) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			words[index / BitOperations::WordBits] ^= (uint64)1 << (index % BitOperations::WordBits);
+		}
+		void SetAll(bool value) {
+			if (words.GetCount() > 0) {
+				std::memset(words.GetRawElementPtr(), value ? 0xFF : 0, words.GetCount() * sizeof(uint64));
+				ClearTail();
+			}
+		}
+
+		int32 PopCount() const {
+			return BitOperations::PopCount(words.GetRawElementPtr(), words.GetCount());
+		}
+		bool Any() const {
+			return FindFirstSet() >= 0;
+		}
+		/// @brief Index of the first set bit at or after from, -1 if none.
+		int32 FindFirstSet(int32 from = 0) const {
+			return BitOperations::FindFirstSet(words.GetRawElementPtr(), words.GetCount(), from);
+		}
+		/// @brief Call function(index) for every set bit in increasing order.
+		template<typename Function>
+		void ForEachSet(const Function& function) const {
+			BitOperations::ForEachSet(words.GetRawElementPtr(), words.GetCount(), function);
+		}
+
+		/// @brief Combine with a list of the same count, bit by bit.
+		void And(const BitList& other) {
+			ERR_ASSERT(other.count == count, u8"The counts are different.", return);
+			BitOperations::And(words.GetRawElementPtr(), other.words.GetRawElementPtr(), words.GetCount());
+		}
+		void Or(const BitList& other) {
+			ERR_ASSERT(other.count == count, u8"The counts are different.", return);
+			BitOperations::Or(words.GetRawElementPtr(), other.words.GetRawElementPtr(), words.GetCount());
+		}
+		/// @brief Clear the bits set in the other list.
+		void AndNot(const BitList& other) {
+			ERR_ASSERT(other.count == count, u8"The counts are different.", return);
+			BitOperations::AndNot(words.GetRawElementPtr(), other.words.GetRawElementPtr(), words.GetCount());
+		}
+		void Xor(const BitList& other) {
+			ERR_ASSERT(other.count == count, u8"The counts are different.", return);
+			BitOperations::Xor(words.GetRawElementPtr(), other.words.GetRawElementPtr(), words.GetCount());
+		}
+		bool Intersects(const BitList& other) const {
+			ERR_ASSERT(other.count == count, u8"The counts are different.", return false);
+			return BitOperations::Intersects(words.GetRawElementPtr(), other.words.GetRawElementPtr(), words.GetCount());
+		}
+
+		bool operator==(const BitList& other) const {
+			return count == other.count && (count == 0 || std::memcmp(words.GetRawElementPtr(), other.words.GetRawElementPtr(), words.GetCount() * sizeof(uint64)) == 0);
+		}
+		bool operator!=(const BitList& other) const {
+			return !(*this == other);
+		}
+
+		int32 GetWordCount() const {
+			return words.GetCount();
+		}
+		/// @brief The words, bit i is bit i % 64 of word i / 64. Keep the bits past the count zero when writing.
+		uint64* GetWords() const {
+			return words.GetRawElementPtr();
+		}
+
+	private:
+		void ClearTail() {
+			int32 used = count % BitOperations::WordBits;
+			if (used != 0) {
+				words[words.GetCount() - 1] &= ((uint64)1 << used) - 1;
+			}
+		}
+
+		List<uint64> words;
+		int32 count = 0;
+	};
+
+	/// @brief A fixed count of bits, see BitList.
+	template<int32 Count>
+	class BitSet final {
+	public:
+		static_assert(Count > 0, "A BitSet needs at least one bit.");
+		static inline constexpr int32 WordCount = BitOperations::GetWordCount(Count);
+
+		constexpr int32 GetCount() const {
+			return Count;
+		}
+		bool Get(int32 index) const {
+			ERR_ASSERT(index >= 0 && index < Count, u8"index out of bounds.", return false);
+			return (words[index / BitOperations::WordBits] >> (index % BitOperations::WordBits)) & 1;
+		}
+		void Set(int32 index, bool value) {
+			ERR_ASSERT(index >= 0 && index < Count, u8"index out of bounds.", return);
+			uint64 mask = (uint64)1 << (index % BitOperations::WordBits);
+			uint64& word = words[index / BitOperations::WordBits];
+			word = value ? (word | mask) : (word & ~mask);
+		}
+		void Flip(int32 index) {
+			ERR_ASSERT(index >= 0 && index < Count, u8"index out of bounds.", return);
+			words[index / BitOperations::WordBits] ^= (uint64)1 << (index % BitOperations::WordBits);
+		}
+		void SetAll(bool value) {
+			for (uint64& word : words) {
+				word = value ? ~(uint64)0 : 0;
+			}
+			if constexpr (Count % BitOperations::WordBits != 0) {
+				words[WordCount - 1] &= ((uint64)1 << (Count % BitOperations::WordBits)) - 1;
+			}
+		}
+
+		int32 PopCount() const {
+			return BitOperations::PopCount(words, WordCount);
+		}
+		bool Any() const {
+			return FindFirstSet() >= 0;
+		}
+		int32 FindFirstSet(int32 from = 0) const {
+			return BitOperations::FindFirstSet(words, WordCount, from);
+		}
+		template<typename Function>
+		void ForEachSet(const Function& function) const {
+			BitOperations::ForEachSet(words, WordCount, function);
+		}
+
+		void And(const BitSet& other) {
+			BitOperations::And(words, other.words, WordCount);
+		}
+		void Or(const BitSet& other) {
+			BitOperations::Or(words, other.words, WordCount);
+		}
+		void AndNot(const BitSet& other) {
+			BitOperations::AndNot(words, other.words, WordCount);
+		}
+		void Xor(const BitSet& other) {
+			BitOperations::Xor(words, other.words, WordCount);
+		}
+		bool Intersects(const BitSet& other) const {
+			return BitOperations::Intersects(words, other.words, WordCount);
+		}
+
+		bool operator==(const BitSet& other) const {
+			return std::memcmp(words, other.words, sizeof(words)) == 0;
+		}
+		bool operator!=(const BitSet& other) const {
+			return !(*this == other);
+		}
+
+		const uint64* GetWords() const {
+			return words;
+		}
+
+	private:
+		uint64 words[WordCount]{};
+	};
+}
@@ -1,58 +1,135 @@
 #pragma once
 #include "Engine/System/Definition.h"
-#include "Engine/System/Collection/List.h"
-#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
+#include "Engine/System/Debug.h"
 
 namespace Engine {
+	/// @brief A double-ended queue.\n
+	/// Elements live in fixed-size chunks addressed by a ring of chunk pointers, so they never move once pushed.\n
+	/// Chunks emptied by popping are kept in a free list and reused by later pushes.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.\n
+	/// Copy construction uses the default allocator, copy assignment keeps the target's, moves take the allocator along.
 	template<typename T>
 	class Deque final {
 	public:
+		Deque(Allocator* allocator = nullptr) :allocator(allocator) {}
 		~Deque() {
+			Destroy();
+		}
+
+		Deque(const Deque& obj) {
+			CopyFromOther(obj);
+		}
+		Deque& operator=(const Deque& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
 			Clear();
+			CopyFromOther(obj);
+
+			return *this;
 		}
 
-		void PushFront(const T& value) {
-			int32 chunkIndex = PrepareChunk(GetChunkIndex(frontIndex));
-			SharedPtr<ElementChunk> chunk = chunks.Get(chunkIndex);
-			
-			T* ptr = chunk->elements + GetElementIndexInChunk(frontIndex);
-			Memory::Construct(ptr, value);
+		Deque(Deque&& obj) :chunks(obj.chunks), chunkCapacity(obj.chunkCapacity), start(obj.start), count(obj.count), freeChunks(obj.freeChunks), allocator(obj.allocator) {
+			obj.chunks = nullptr;
+			obj.chunkCapacity = 0;
+			obj.start = 0;
+			obj.count = 0;
+			obj.freeChunks = nullptr;
+		}
+		Deque& operator=(Deque&& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			Destroy();
 
-			frontIndex -= 1;
+			allocator = obj.allocator;
+			chunks = obj.chunks;
+			obj.chunks = nullptr;
+			chunkCapacity = obj.chunkCapacity;
+			obj.chunkCapacity = 0;
+			start = obj.start;
+			obj.start = 0;
+			count = obj.count;
+			obj.count = 0;
+			freeChunks = obj.freeChunks;
+			obj.freeChunks = nullptr;
+
+			return *this;
+		}
+
+		void PushFront(const T& value) {
+			EmplaceFront(value);
+		}
+		void PushFront(T&& value) {
+			EmplaceFront(Memory::Move(value));
 		}
 		void PushBack(const T& value) {
-			int32 chunkIndex = PrepareChunk(GetChunkIndex(backIndex));
-			SharedPtr<ElementChunk> chunk = chunks.Get(chunkIndex);
+			EmplaceBack(value);
+		}
+		void PushBack(T&& value) {
+			EmplaceBack(Memory::Move(value));
+		}
+		/// @brief Construct an element in place before the first one.
+		/// @return The new element, which stays at the same address until it is popped.
+		template<typename ...Args>
+		T& EmplaceFront(Args&& ...args) {
+			RequireSpace();
+			uint32 position = (start - 1) & GetPositionMask();
+			T* ptr = PrepareChunk(position)->GetElements() + position % ChunkSize;
+			Memory::Construct(ptr, Memory::Forward<Args>(args)...);
 
-			T* ptr = chunk->elements + GetElementIndexInChunk(backIndex);
-			Memory::Construct(ptr, value);
+			start = position;
+			count += 1;
+			return *ptr;
+		}
+		/// @brief Construct an element in place after the last one.
+		/// @return The new element, which stays at the same address until it is popped.
+		template<typename ...Args>
+		T& EmplaceBack(Args&& ...args) {
+			RequireSpace();
+			uint32 position = (start + count) & GetPositionMask();
+			T* ptr = PrepareChunk(position)->GetElements() + position % ChunkSize;
+			Memory::Construct(ptr, Memory::Forward<Args>(args)...);
 
-			backIndex += 1;
+			count += 1;
+			return *ptr;
 		}
+
+		/// @brief Move the first element into result and remove it.
 		bool TryPopFront(T& result) {
-			if (GetCount() <= 0) {
+			if (count <= 0) {
 				return false;
 			}
-			frontIndex += 1;
-			
-			int32 chunkIndex = GetChunkIndex(frontIndex);
-			SharedPtr<ElementChunk> chunk = chunks.Get(chunkIndex);
-			result = chunk->elements[GetElementIndexInChunk(frontIndex)];
+			uint32 position = start;
+			T* ptr = GetElement(position);
+			result = Memory::Move(*ptr);
+			Memory::Destruct(ptr);
 
-			Memory::Destruct(chunk->elements + GetElementIndexInChunk(frontIndex));
+			start = (start + 1) & GetPositionMask();
+			count -= 1;
+			if (count == 0 || start % ChunkSize == 0) {
+				RetireChunk(position);
+			}
 			return true;
 		}
+		/// @brief Move the last element into result and remove it.
 		bool TryPopBack(T& result) {
-			if (GetCount() <= 0) {
+			if (count <= 0) {
 				return false;
 			}
-			backIndex -= 1;
+			uint32 position = (start + count - 1) & GetPositionMask();
+			T* ptr = GetElement(position);
+			result = Memory::Move(*ptr);
+			Memory::Destruct(ptr);
 
-			int32 chunkIndex = GetChunkIndex(backIndex);
-			SharedPtr<ElementChunk> chunk = chunks.Get(chunkIndex);
-			result = chunk->elements[GetElementIndexInChunk(backIndex)];
-
-			Memory::Destruct(chunk->elements + GetElementIndexInChunk(backIndex));
+			count -= 1;
+			if (count == 0 || position % ChunkSize == 0) {
+				RetireChunk(position);
+			}
 			return true;
 		}
 		T PopFront() {
@@ -68,71 +145,121 @@ namespace Engine {
 			return result;
 		}
 		int32 GetCount() const {
-			return backIndex - frontIndex - 1;
+			return (int32)count;
 		}
+		/// @brief Destroy all elements. Their chunks are kept for reuse.
 		void Clear() {
-			int32 lastChunkIndex = -1;
-			SharedPtr<ElementChunk> lastChunk;
-			for (int i = frontIndex + 1; i < backIndex; i += 1) {
-				int32 chunkIndex = GetChunkIndex(i);
-				if (lastChunkIndex != chunkIndex) {
-					lastChunkIndex = chunkIndex;
-					lastChunk = chunks.Get(chunkIndex);
+			for (uint32 i = 0; i < count; i += 1) {
+				uint32 position = (start + i) & GetPositionMask();
+				Memory::Destruct(GetElement(position));
+				if (i == count - 1 || (position + 1) % ChunkSize == 0) {
+					RetireChunk(position);
 				}
-				Memory::Destruct(lastChunk->elements + GetElementIndexInChunk(i));
 			}
 
-			frontIndex = -1;
-			backIndex = 0;
+			start = 0;
+			count = 0;
+		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return allocator;
 		}
 
+		/// @brief Element count of a chunk. Needs to be a power of two.
 		static inline constexpr int32 ChunkSize = 8;
+		/// @brief Chunk pointer count of the ring when it is first allocated.
+		static inline constexpr int32 MinChunkCapacity = 4;
 
 	private:
+		static_assert((ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two.");
+
 		struct ElementChunk {
-			ElementChunk() {
-				elements = (T*)Memory::Allocate(sizeof(T) * ChunkSize);
-			}
-			~ElementChunk() {
-				Memory::Deallocate(elements);
+			T* GetElements() {
+				return reinterpret_cast<T*>(storage);
 			}
-			T* elements;
+			/// @brief The next chunk in the free list.
+			ElementChunk* next;
+			alignas(T) byte storage[sizeof(T) * ChunkSize];
 		};
-		//                                  CenterChunk
-		// [ *  *  *  *  *  *  *  * ] [ *  *  *  *  *  *  *  * ]
-		//  -8 -7 -6 -5 -4 -3 -2 -1     0  1  2  3  4  5  6  7
-		List<SharedPtr<ElementChunk>> chunks{};
 
-		int32 frontIndex = -1;
-		int32 backIndex = 0;
-		int32 centerChunk = -1;
+		//              start                       start + count
+		//                v                               v
+		// [ .  .  .  *  *  * ] [ *  *  *  *  *  * ] [ *  .  .  .  .  . ] [ nullptr ]
+		// Positions wrap around the ring of chunkCapacity * ChunkSize elements.
+		// Chunk slots without elements are nullptr, their chunks are in freeChunks.
+		ElementChunk** chunks = nullptr;
+		uint32 chunkCapacity = 0;
+		uint32 start = 0;
+		uint32 count = 0;
+		ElementChunk* freeChunks = nullptr;
+		Allocator* allocator = nullptr;
 
+		uint32 GetPositionMask() const {
+			return chunkCapacity * ChunkSize - 1;
+		}
+		T* GetElement(uint32 position) const {
+			return chunks[position / ChunkSize]->GetElements() + position % ChunkSize;
+		}
 
-		int32 GetChunkIndex(int32 elementIndex) const {
-			if (elementIndex >= 0) {
-				return elementIndex / ChunkSize + centerChunk;
-			} else {
-				return (elementIndex + 1) / ChunkSize - 1 + centerChunk;
+		/// @brief Make sure the ring has room for one more element, keeping at least one chunk slot unused.\n
+		/// That way the first and the last element never share a chunk from both ends.
+		void RequireSpace() {
+			if (chunkCapacity > 0 && count < (chunkCapacity - 1) * ChunkSize) {
+				return;
 			}
-		}
-		int32 GetElementIndexInChunk(int32 elementIndex) const {
-			if (elementIndex >= 0) {
-				return elementIndex % ChunkSize;
-			} else {
-				return (ChunkSize - 1) - ((-elementIndex - 1) % ChunkSize);
+
+			uint32 capacity = (chunkCapacity == 0 ? MinChunkCapacity : chunkCapacity * 2);
+			ElementChunk** newChunks = (ElementChunk**)Allocator::AllocateFrom(allocator, sizeof(ElementChunk*) * capacity, alignof(ElementChunk*));
+			// Lay the old slots out again from the chunk of start.
+			uint32 startChunk = start / ChunkSize;
+			for (uint32 i = 0; i < capacity; i += 1) {
+				newChunks[i] = (i < chunkCapacity ? chunks[(startChunk + i) % chunkCapacity] : nullptr);
+			}
+			if (chunks != nullptr) {
+				Allocator::DeallocateTo(allocator, chunks, sizeof(ElementChunk*) * chunkCapacity);
 			}
+
+			chunks = newChunks;
+			chunkCapacity = capacity;
+			start %= ChunkSize;
 		}
-		int32 PrepareChunk(int32 chunkIndex) {
-			while (chunkIndex < 0 || chunkIndex >= chunks.GetCount()) {
-				if (chunkIndex < 0) {
-					chunks.Insert(0, SharedPtr<ElementChunk>::Create());
-					centerChunk += 1;
-					chunkIndex += 1;
-				} else if (chunkIndex >= chunks.GetCount()) {
-					chunks.Add(SharedPtr<ElementChunk>::Create());
+		ElementChunk* PrepareChunk(uint32 position) {
+			ElementChunk*& chunk = chunks[position / ChunkSize];
+			if (chunk == nullptr) {
+				if (freeChunks != nullptr) {
+					chunk = freeChunks;
+					freeChunks = freeChunks->next;
+				} else {
+					chunk = (ElementChunk*)Allocator::AllocateFrom(allocator, sizeof(ElementChunk), alignof(ElementChunk));
 				}
 			}
-			return chunkIndex;
+			return chunk;
+		}
+		/// @brief Move the chunk holding position into the free list, after its last element is gone.
+		void RetireChunk(uint32 position) {
+			ElementChunk*& chunk = chunks[position / ChunkSize];
+			chunk->next = freeChunks;
+			freeChunks = chunk;
+			chunk = nullptr;
+		}
+
+		void CopyFromOther(const Deque& obj) {
+			for (uint32 i = 0; i < obj.count; i += 1) {
+				EmplaceBack(*obj.GetElement((obj.start + i) & obj.GetPositionMask()));
+			}
+		}
+		void Destroy() {
+			Clear();
+			while (freeChunks != nullptr) {
+				ElementChunk* next = freeChunks->next;
+				Allocator::DeallocateTo(allocator, freeChunks, sizeof(ElementChunk));
+				freeChunks = next;
+			}
+			if (chunks != nullptr) {
+				Allocator::DeallocateTo(allocator, chunks, sizeof(ElementChunk*) * chunkCapacity);
+				chunks = nullptr;
+			}
+			chunkCapacity = 0;
 		}
 	};
-}
\ No newline at end of file
+}
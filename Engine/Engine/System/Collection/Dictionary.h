@@ -2,10 +2,16 @@
 #include "Engine/System/Object/ObjectUtil.h"
 #include "Engine/System/Collection/HashHelper.h"
 #include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
 #include "Engine/System/Debug.h"
 
 namespace Engine {
-	/// @brief A hashmap.
+	/// @brief A hashmap.\n
+	/// Entries are packed at the front of one array, so iterating is a linear scan. They are iterated in the order they were added,
+	/// except that removing one moves the last entry into its place.\n
+	/// Growing rebuilds the table at once by default, see SetIncrementalRehash for spreading it over later calls instead.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.\n
+	/// Copy construction uses the default allocator, copy assignment keeps the target's, moves take the allocator along.
 	/// @tparam TKey The key type. Needs to implement `int32 GetHashCode() const` and `bool operator==(const T&) const`.
 	/// @tparam TValue The value type. Needs to be default-constructable, copy-constructable and move-contstructable.
 	template<typename TKey,typename TValue>
@@ -14,11 +20,11 @@ namespace Engine {
 		Dictionary(int32 capacity=0) {
 			SetCapacity(capacity);
 		}
+		Dictionary(int32 capacity, Allocator* allocator) :allocator(allocator) {
+			SetCapacity(capacity);
+		}
 		~Dictionary() {
-			Clear();
-
-			MEMDELARR(buckets);
-			Memory::Deallocate(entries);
+			Destroy();
 		}
 
 		Dictionary(const Dictionary& obj) {
@@ -29,85 +35,86 @@ namespace Engine {
 				return *this;
 			}
 
+			Destroy();
 			CopyFromOther(obj);
 
 			return *this;
 		}
 
-		Dictionary(Dictionary&& obj) :buckets(obj.buckets), entries(obj.entries), capacity(obj.capacity), count(obj.count), freeIndex(obj.freeIndex) {
-			obj.buckets = nullptr;
-			obj.entries = nullptr;
-			obj.capacity = 0;
-			obj.count = 0;
-			obj.freeIndex = -1;
+		Dictionary(Dictionary&& obj) :table(obj.table), oldTable(obj.oldTable), incrementalRehash(obj.incrementalRehash), allocator(obj.allocator) {
+			obj.table = Table();
+			obj.oldTable = Table();
 		}
 		Dictionary& operator=(Dictionary&& obj) {
 			if (this == &obj) {
 				return *this;
 			}
 
-			buckets = obj.buckets;
-			obj.buckets = nullptr;
-			entries = obj.entries;
-			obj.entries = nullptr;
-			capacity = obj.capacity;
-			obj.capacity = 0;
-			count = obj.count;
-			obj.count = 0;
-			freeIndex = obj.freeIndex;
-			obj.freeIndex = -1;
+			Destroy();
+
+			allocator = obj.allocator;
+			table = obj.table;
+			obj.table = Table();
+			oldTable = obj.oldTable;
+			obj.oldTable = Table();
+			incrementalRehash = obj.incrementalRehash;
 
 			return *this;
 		}
 
+		/// @brief Make room for at least capacity entries, rounded up to a prime.\n
+		/// The table is rebuilt at once, finishing any incremental rehash in progress.
 		bool SetCapacity(int32 capacity) {
-			ERR_ASSERT(capacity >= count, u8"capacity cannot be smaller than element count.", return false);
-			if (capacity == count) {
+			ERR_ASSERT(capacity >= GetCount(), u8"capacity cannot be smaller than element count.", return false);
+			if (capacity == GetCount()) {
 				return true;
 			}
 
-			CheckSyncState();
-
 			// Get a closest prime to help mod the hash code.
 			int32 desired = HashHelper::GetPrime(capacity);
 			ERR_ASSERT(desired >= capacity, u8"Failed to find a prime number for capacity!", return false);
 
-			if (buckets == nullptr && entries == nullptr) {
-				this->buckets = MEMNEWARR(int32, desired);
-				std::memset(this->buckets, -1, desired * sizeof(int32));
-				this->entries = (Entry*)Memory::Allocate(desired * sizeof(Entry));
-				this->capacity = desired;
-			} else {
-				int32 oldCapacity = this->capacity;
-				int32* oldBuckets = this->buckets;
-				Entry* oldEntries = this->entries;
-
-				this->capacity = desired;
-				this->count = 0;
-				this->buckets = MEMNEWARR(int32, desired);
-				std::memset(this->buckets, -1, desired * sizeof(int32));
-				this->entries = (Entry*)Memory::Allocate(desired * sizeof(Entry));
-
-				// Re-index the elements in the old container into the new one and destroy the old element.
-				for (int32 i = 0; i < oldCapacity; i += 1) {
-					for (int32 j = oldBuckets[i]; j >= 0; j = oldEntries[j].next) {
-						Insert(oldEntries[j].key, oldEntries[j].value, oldEntries[j].hashCode, InsertMode::Set);
-						Memory::Destruct(oldEntries + j);
-					}
-				}
-
-				MEMDELARR(oldBuckets);
-				Memory::Deallocate(oldEntries);
-
-				freeIndex = -1;
+			Resize(desired, false);
+			return true;
+		}
+		/// @brief Make room for exactly capacity entries, without rounding it up to a prime.\n
+		/// Does nothing if the capacity is already enough, otherwise the table is rebuilt at once.
+		bool Reserve(int32 capacity) {
+			ERR_ASSERT(capacity >= 0, u8"capacity cannot be negative.", return false);
+			if (capacity <= this->table.capacity) {
+				return true;
 			}
+
+			Resize(capacity, false);
 			return true;
 		}
 		int32 GetCapacity() const {
-			return capacity;
+			return table.capacity;
 		}
 		int32 GetCount() const {
-			return count;
+			return table.count + oldTable.count;
+		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return allocator;
+		}
+
+		/// @brief When enabled, growing in Add and Set only allocates the new table,
+		/// the entries are moved over a few at a time, oldest first, by the following Add, Set and Remove calls.\n
+		/// Lookups check both tables meanwhile, and iterating lists the entries not moved yet first.
+		/// Entries added during the rehash end up among the rest of the moved ones. Disabling finishes the rehash in progress.
+		void SetIncrementalRehash(bool enabled) {
+			incrementalRehash = enabled;
+			if (!enabled && IsRehashing()) {
+				FinishRehash();
+			}
+		}
+		bool IsIncrementalRehash() const {
+			return incrementalRehash;
+		}
+		/// @brief Whether entries are still left in the old table from an incremental rehash.
+		bool IsRehashing() const {
+			return oldTable.buckets != nullptr;
 		}
 
 		bool Add(const TKey& key, const TValue& value) {
@@ -120,55 +127,37 @@ namespace Engine {
 		}
 
 		bool ContainsKey(const TKey& key) const {
-			if (buckets == nullptr && entries == nullptr) {
-				return false;
-			}
-
-			uint32 hash = GetKeyHash(key);
-			int bucket = GetBucketIndex(hash);
-			if (buckets[bucket] == -1) {
-				return false;
-			}
-			for (int32 i = buckets[bucket]; i >= 0; i = entries[i].next) {
-				if (entries[i].hashCode == hash && entries[i].key == key) {
-					return true;
-				}
-			}
-			return false;
+			return FindEntry(key) != nullptr;
+		}
+		/// @brief Check a key by a type enabled with HashLookup, such as std::string_view for String keys, without constructing a key.
+		template<typename TLookup> requires HashLookup<TKey, TLookup>::Enabled
+		bool ContainsKey(const TLookup& key) const {
+			return FindEntry(key) != nullptr;
 		}
 		void Clear() {
-			if (buckets == nullptr && entries == nullptr) {
-				return;
+			ClearTable(table);
+			if (IsRehashing()) {
+				ClearTable(oldTable);
+				EndRehash();
 			}
-
-			// Do destruction
-			for (int32 i = 0; i < capacity; i += 1) {
-				for (int32 j = buckets[i]; j >= 0; j = entries[j].next) {
-					Memory::Destruct(entries + j);
-				}
-				buckets[i] = -1;
-			}
-
-			count = 0;
-			freeIndex = -1;
 		}
 		bool TryGet(const TKey& key, TValue& result) const {
-			if (buckets == nullptr && entries == nullptr) {
+			Entry* entry = FindEntry(key);
+			if (entry == nullptr) {
 				return false;
 			}
-
-			uint32 hash = GetKeyHash(key);
-			int bucket = GetBucketIndex(hash);
-			if (buckets[bucket] == -1) {
+			result = entry->value;
+			return true;
+		}
+		/// @brief Look up by a type enabled with HashLookup, such as std::string_view for String keys, without constructing a key.
+		template<typename TLookup> requires HashLookup<TKey, TLookup>::Enabled
+		bool TryGet(const TLookup& key, TValue& result) const {
+			Entry* entry = FindEntry(key);
+			if (entry == nullptr) {
 				return false;
 			}
-			for (int32 i = buckets[bucket]; i >= 0; i = entries[i].next) {
-				if (entries[i].hashCode == hash && entries[i].key == key) {
-					result = entries[i].value;
-					return true;
-				}
-			}
-			return false;
+			result = entry->value;
+			return true;
 		}
 		TValue Get(const TKey& key) const {
 			TValue result{};
@@ -177,197 +166,327 @@ namespace Engine {
 			return result;
 		}
 		bool Remove(const TKey& key) {
-			if (buckets == nullptr && entries == nullptr) {
-				return false;
+			if (IsRehashing()) {
+				StepRehash();
 			}
 
 			uint32 hash = GetKeyHash(key);
-			int bucket = GetBucketIndex(hash);
-			if (buckets[bucket] == -1) {
-				return false;
-			}
-			for (int32 i = buckets[bucket],prev=-1; i >= 0; prev=i,i = entries[i].next) {
-				if (entries[i].hashCode == hash && entries[i].key == key) {
-					if (prev != -1) {
-						// Connect prev and next if it has a prev linked entry.
-						entries[prev].next = entries[i].next;
-					} else {
-						// Set bucket entry target to next if it is the first entry of the bucket.
-						buckets[bucket] = entries[i].next;
-					}
-					// Destruct this entry
-					Memory::Destruct(entries + i);
-					
-					// Add i into free list
-					entries[i].next = freeIndex;
-					freeIndex = i;
-
-					count -= 1;
-
-					return true;
-				}
+			if (RemoveFrom(table, key, hash)) {
+				return true;
 			}
-			return false;
+			return IsRehashing() && RemoveFrom(oldTable, key, hash);
 		}
 
 		struct Entry {
 			Entry(const TKey& key, const TValue& value, uint32 hashCode, int32 next) :key(key), value(value), hashCode(hashCode), next(next) {}
+			Entry(TKey&& key, TValue&& value, uint32 hashCode, int32 next) :key(Memory::Move(key)), value(Memory::Move(value)), hashCode(hashCode), next(next) {}
 			TKey key;
 			TValue value;
 			uint32 hashCode;
 			int32 next;
 		};
 
+	private:
+		struct Table {
+			int32 capacity = 0;
+			/// @brief The entries are [begin, begin + count), begin only moves during an incremental rehash.
+			int32 begin = 0;
+			int32 count = 0;
+			int32* buckets = nullptr;
+			Entry* entries = nullptr;
+		};
+
+	public:
+		/// @brief Goes through the old table of an incremental rehash first, then the current one.
 		class Iterator {
 		public:
-			Iterator(const Dictionary* dic, int bucket) :dic(dic),bucketIndex(bucket) {
-				while (bucketIndex < dic->GetCapacity()&&dic->buckets[bucketIndex]==-1) {
-					bucketIndex += 1;
-				}
-				if (bucketIndex < dic->GetCapacity()) {
-					entryIndex = dic->buckets[bucketIndex];
-				} else {
-					entryIndex = -1;
-				}
+			Iterator(const Dictionary* dic, const Table* table, int32 index) :dic(dic), table(table), index(index) {
+				SkipEmptyTable();
 			}
 
 			bool operator!=(const Iterator& obj) const {
-				return bucketIndex != obj.bucketIndex && entryIndex != obj.entryIndex;
+				return table != obj.table || index != obj.index;
 			}
 			const Entry& operator*() const {
-				Entry* entry = dic->entries + entryIndex;
-				return *entry;
+				return table->entries[index];
 			}
 			Iterator& operator++() {
-				if (entryIndex >= 0) {
-					Entry* entry = dic->entries + entryIndex;
-					if (entry->next >= 0) {
-						entryIndex = entry->next;
-					} else {
-						bucketIndex += 1;
-						while (bucketIndex < dic->GetCapacity() && dic->buckets[bucketIndex] == -1) {
-							bucketIndex += 1;
-						}
-						if (bucketIndex < dic->GetCapacity()) {
-							entryIndex = dic->buckets[bucketIndex];
-						} else {
-							entryIndex = -1;
-						}
-					}
-				}
+				index += 1;
+				SkipEmptyTable();
 				return *this;
 			}
 		private:
+			void SkipEmptyTable() {
+				if (table == &dic->oldTable && index >= table->begin + table->count) {
+					table = &dic->table;
+					index = 0;
+				}
+			}
+
 			const Dictionary* dic;
-			int32 bucketIndex;
-			int32 entryIndex;
+			const Table* table;
+			int32 index;
 		};
 
 		Iterator begin() const {
-			return Iterator(this, 0);
+			return IsRehashing() ? Iterator(this, &oldTable, oldTable.begin) : Iterator(this, &table, 0);
 		}
 		Iterator end() const {
-			return Iterator(this, GetCapacity());
+			return Iterator(this, &table, table.count);
 		}
 
 
 		static inline constexpr int32 CapacityMultiplier = 2;
+		/// @brief How many entries each Add, Set or Remove moves during an incremental rehash.
+		static inline constexpr int32 RehashEntriesPerStep = 16;
 
 	private:
 		void CopyFromOther(const Dictionary& obj) {
-			capacity = obj.capacity;
-			count = obj.count;
-			freeIndex = obj.freeIndex;
-			buckets = MEMNEWARR(int32, capacity);
-			entries = (Entry*)Memory::Allocate(capacity * sizeof(Entry));
-			// Copy entries
-			for (int32 i = 0; i < obj.capacity; i += 1) {
-				buckets[i] = obj.buckets[i];
-				for (int j = obj.buckets[i]; j >= 0; j = obj.entries[j].next) {
-					Memory::Construct(entries + j, obj.entries[j]);
-				}
+			CopyTable(table, obj.table);
+			CopyTable(oldTable, obj.oldTable);
+			incrementalRehash = obj.incrementalRehash;
+		}
+		void CopyTable(Table& target, const Table& obj) {
+			if (obj.capacity <= 0) {
+				target = Table();
+				return;
 			}
-			// Copy free indexes
-			for (int32 i = freeIndex; i >= 0; i = obj.entries[i].next) {
-				entries[i].next = obj.entries[i].next;
+			AllocateStorage(target, obj.capacity);
+			// Same indices, so the chains stay valid.
+			std::memcpy(target.buckets, obj.buckets, obj.capacity * sizeof(int32));
+			for (int32 i = obj.begin; i < obj.begin + obj.count; i += 1) {
+				Memory::Construct(target.entries + i, obj.entries[i]);
 			}
+			target.begin = obj.begin;
+			target.count = obj.count;
+		}
+
+		void AllocateStorage(Table& target, int32 capacity) {
+			target.capacity = capacity;
+			target.begin = 0;
+			target.count = 0;
+			target.buckets = (int32*)Allocator::AllocateFrom(allocator, capacity * sizeof(int32));
+			std::memset(target.buckets, -1, capacity * sizeof(int32));
+			target.entries = (Entry*)Allocator::AllocateFrom(allocator, capacity * sizeof(Entry), alignof(Entry));
+		}
+		void DeallocateStorage(Table& target) {
+			if (target.buckets != nullptr) {
+				Allocator::DeallocateTo(allocator, target.buckets, target.capacity * sizeof(int32));
+				Allocator::DeallocateTo(allocator, target.entries, target.capacity * sizeof(Entry));
+			}
+			target = Table();
+		}
+		void ClearTable(Table& target) {
+			if (target.buckets == nullptr && target.entries == nullptr) {
+				return;
+			}
+
+			for (int32 i = target.begin; i < target.begin + target.count; i += 1) {
+				Memory::Destruct(target.entries + i);
+			}
+			std::memset(target.buckets, -1, target.capacity * sizeof(int32));
+
+			target.begin = 0;
+			target.count = 0;
+		}
+		void Destroy() {
+			Clear();
+			DeallocateStorage(table);
 		}
 
 		enum class InsertMode { Add, Set };
-		static uint32 GetKeyHash(const TKey& key) {
+		template<typename TLookup>
+		static uint32 GetKeyHash(const TLookup& key) {
 			int32 s_hash = ObjectUtil::GetHashCode(key);
 			return *((uint32*)(&s_hash));
 		}
+		template<typename TLookup>
+		Entry* FindEntry(const TLookup& key) const {
+			uint32 hash = GetKeyHash(key);
+			Entry* entry = FindIn(table, key, hash);
+			if (entry == nullptr && IsRehashing()) {
+				entry = FindIn(oldTable, key, hash);
+			}
+			return entry;
+		}
+		template<typename TLookup>
+		static Entry* FindIn(const Table& target, const TLookup& key, uint32 hash) {
+			if (target.buckets == nullptr && target.entries == nullptr) {
+				return nullptr;
+			}
+
+			int bucket = GetBucketIndex(target, hash);
+			for (int32 i = target.buckets[bucket]; i >= 0; i = target.entries[i].next) {
+				if (target.entries[i].hashCode == hash && target.entries[i].key == key) {
+					return target.entries + i;
+				}
+			}
+			return nullptr;
+		}
 		
 		bool Insert(const TKey& key, const TValue& value, uint32 hash, InsertMode mode) {
-			RequireCapacity(count + 1);
-			int32 bucket = GetBucketIndex(hash);
-
-			// If bucket is empty.
-			if (buckets[bucket] == -1) {
-				buckets[bucket] = AddEntry(key, value, hash, -1);
-				return true;
+			if (IsRehashing()) {
+				StepRehash();
+			}
+			// A key lives in only one of the tables, keys still in the old one are updated there.
+			if (IsRehashing()) {
+				Entry* entry = FindIn(oldTable, key, hash);
+				if (entry != nullptr) {
+					if (mode == InsertMode::Add) {
+						ERR_MSG(u8"Key is already exists.");
+						return false;
+					}
+					entry->value = value;
+					return true;
+				}
 			}
 
-			for (int32 i = buckets[bucket]; i >= 0; i = entries[i].next) {
+			RequireCapacity(GetCount() + 1);
+			int32 bucket = GetBucketIndex(table, hash);
+
+			for (int32 i = table.buckets[bucket]; i >= 0; i = table.entries[i].next) {
 				// the key already exists.
-				if (entries[i].hashCode == hash && entries[i].key == key) {
+				if (table.entries[i].hashCode == hash && table.entries[i].key == key) {
 					if (mode == InsertMode::Add) {
 						// In add mode, fails.
 						ERR_MSG(u8"Key is already exists.");
 						return false;
 					} else {
 						// In set mode, overwrite the value.
-						entries[i].value = value;
+						table.entries[i].value = value;
 						return true;
 					}
 				}
 			}
 			// the key doesn't exist, add entry.
-			buckets[bucket] = AddEntry(key, value, hash, buckets[bucket]);
+			AddEntry(table, key, value, hash);
 
 			return true;
 		}
 
-		int32 AddEntry(const TKey& key, const TValue& value, uint32 hash, int32 next) {
-			int32 index = -1;
-			if (freeIndex == -1) {
-				index = count;
-			} else {
-				index = freeIndex;
-				freeIndex = entries[freeIndex].next;
+		/// @brief Append an entry and put it at the head of its bucket.
+		template<typename K, typename V>
+		void AddEntry(Table& target, K&& key, V&& value, uint32 hash) {
+			int32 index = target.begin + target.count;
+			int32 bucket = GetBucketIndex(target, hash);
+			Memory::Construct(target.entries + index, Memory::Forward<K>(key), Memory::Forward<V>(value), hash, target.buckets[bucket]);
+			target.buckets[bucket] = index;
+			target.count += 1;
+		}
+		/// @brief Where the chain of its bucket refers to the entry, the bucket itself or the entry before it.
+		static int32* FindLink(Table& target, int32 index) {
+			int32* link = target.buckets + GetBucketIndex(target, target.entries[index].hashCode);
+			while (*link != index) {
+				link = &target.entries[*link].next;
+			}
+			return link;
+		}
+
+		bool RemoveFrom(Table& target, const TKey& key, uint32 hash) {
+			if (target.buckets == nullptr && target.entries == nullptr) {
+				return false;
+			}
+
+			int32* link = target.buckets + GetBucketIndex(target, hash);
+			while (*link >= 0) {
+				int32 i = *link;
+				Entry* entry = target.entries + i;
+				if (entry->hashCode == hash && entry->key == key) {
+					*link = entry->next;
+					Memory::Destruct(entry);
+
+					// Keep the entries packed, the last one takes the place.
+					int32 last = target.begin + target.count - 1;
+					if (i != last) {
+						*FindLink(target, last) = i;
+						Memory::Construct(entry, Memory::Move(target.entries[last]));
+						Memory::Destruct(target.entries + last);
+					}
+					target.count -= 1;
+					return true;
+				}
+				link = &entry->next;
 			}
-			Memory::Construct(entries + index, key, value, hash, next);
-			count += 1;
-			return index;
+			return false;
 		}
 
 		void RequireCapacity(int32 capacity) {
-			if (capacity <= this->capacity) {
+			if (capacity <= table.capacity) {
 				return;
 			}
-			int result = (this->capacity == 0 ? capacity : this->capacity);
+			int result = (table.capacity == 0 ? capacity : table.capacity);
 			while (result < capacity) {
 				result *= CapacityMultiplier;
 			}
-			SetCapacity(result);
+			int32 desired = HashHelper::GetPrime(result);
+			ERR_ASSERT(desired >= result, u8"Failed to find a prime number for capacity!", return);
+			Resize(desired, incrementalRehash);
+		}
+		void Resize(int32 capacity, bool incremental) {
+			CheckSyncState();
+
+			if (IsRehashing()) {
+				FinishRehash();
+			}
+			if (table.buckets == nullptr) {
+				AllocateStorage(table, capacity);
+				return;
+			}
+
+			oldTable = table;
+			AllocateStorage(table, capacity);
+			if (!incremental) {
+				FinishRehash();
+			}
+		}
+
+		/// @brief Move the oldest entry of the old table into the current table.
+		/// @param unlink Whether the old chains are still looked up afterwards.
+		void MigrateEntry(bool unlink) {
+			int32 index = oldTable.begin;
+			Entry* entry = oldTable.entries + index;
+			if (unlink) {
+				*FindLink(oldTable, index) = entry->next;
+			}
+			AddEntry(table, Memory::Move(entry->key), Memory::Move(entry->value), entry->hashCode);
+			Memory::Destruct(entry);
+			oldTable.begin += 1;
+			oldTable.count -= 1;
+		}
+		void StepRehash() {
+			for (int32 i = 0; i < RehashEntriesPerStep && oldTable.count > 0; i += 1) {
+				MigrateEntry(true);
+			}
+			if (oldTable.count == 0) {
+				EndRehash();
+			}
 		}
-		int32 GetBucketIndex(uint32 hash) const {
-			return (int32)(hash % capacity);
+		void FinishRehash() {
+			while (oldTable.count > 0) {
+				MigrateEntry(false);
+			}
+			EndRehash();
+		}
+		void EndRehash() {
+			DeallocateStorage(oldTable);
+		}
+
+		static int32 GetBucketIndex(const Table& target, uint32 hash) {
+			return (int32)(hash % target.capacity);
 		}
 
 		void CheckSyncState() const {
 			// Stop immediately if buckets and entries are not in sync (this should never happen, but just in case)
-			ERR_ASSERT((buckets == nullptr && entries == nullptr) || (buckets != nullptr && entries != nullptr),
+			ERR_ASSERT((table.buckets == nullptr && table.entries == nullptr) || (table.buckets != nullptr && table.entries != nullptr),
 				u8"buckets and entries are out of sync!",
 				FATAL_CRASH(u8"Cannot proceed as Dictionary is in a dangerous state and may have caused memory leak!")
 			);
 		}
 
-		int32 capacity = 0;
-		int32 count = 0;
-		int32* buckets = nullptr;
-		Entry* entries = nullptr;
-		int32 freeIndex = -1;
+		Table table{};
+		/// @brief Entries not moved yet by an incremental rehash, empty otherwise.
+		Table oldTable{};
+		bool incrementalRehash = false;
+		Allocator* allocator = nullptr;
 	};
 }
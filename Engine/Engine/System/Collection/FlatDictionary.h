@@ -0,0 +1,133 @@
+#pragma once
+#include "Engine/System/Collection/FlatHashTable.h"
+
+namespace Engine {
+	/// @brief An open addressing hashmap with the interface of Dictionary, see FlatHashTable.\n
+	/// Keys can also be looked up by the types enabled with HashLookup, such as std::string_view for String keys.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.\n
+	/// Copy construction uses the default allocator, copy assignment keeps the target's, moves take the allocator along.
+	/// @tparam TKey The key type. Needs to implement `int32 GetHashCode() const` and `bool operator==(const T&) const`.
+	/// @tparam TValue The value type. Needs to be default-constructable, copy-constructable and move-contstructable.
+	template<typename TKey, typename TValue>
+	class FlatDictionary {
+	public:
+		struct Entry {
+			Entry(const TKey& key, const TValue& value) :key(key), value(value) {}
+			TKey key;
+			TValue value;
+		};
+	private:
+		using Table = FlatHashTable<TKey, Entry>;
+	public:
+		using Iterator = typename Table::Iterator;
+
+		FlatDictionary(int32 capacity = 0) :table(capacity) {}
+		FlatDictionary(int32 capacity, Allocator* allocator) :table(capacity, allocator) {}
+
+		/// @brief Make room for at least capacity entries without growing.
+		bool SetCapacity(int32 capacity) {
+			return table.SetCapacity(capacity);
+		}
+		/// @brief The slot count. Entries fit without growing up to 7/8 of it.
+		int32 GetCapacity() const {
+			return table.GetCapacity();
+		}
+		int32 GetCount() const {
+			return table.GetCount();
+		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return table.GetAllocator();
+		}
+
+		bool Add(const TKey& key, const TValue& value) {
+			uint64 hash = Table::GetHash(key);
+			ERR_ASSERT(table.Find(key, hash) == nullptr, u8"Failed to add an entry, the key already exists.", return false);
+			table.Insert(hash, key, value);
+			return true;
+		}
+		void Set(const TKey& key, const TValue& value) {
+			uint64 hash = Table::GetHash(key);
+			Entry* entry = table.Find(key, hash);
+			if (entry != nullptr) {
+				entry->value = value;
+			} else {
+				table.Insert(hash, key, value);
+			}
+		}
+
+		bool ContainsKey(const TKey& key) const {
+			return Find(key) != nullptr;
+		}
+		/// @brief Get a pointer to the value without copying it, nullptr if the key doesn't exist.\n
+		/// The pointer is invalidated by any insert or remove.
+		TValue* Find(const TKey& key) const {
+			Entry* entry = table.Find(key, Table::GetHash(key));
+			return entry == nullptr ? nullptr : &entry->value;
+		}
+		bool TryGet(const TKey& key, TValue& result) const {
+			TValue* value = Find(key);
+			if (value == nullptr) {
+				return false;
+			}
+			result = *value;
+			return true;
+		}
+		TValue Get(const TKey& key) const {
+			TValue* value = Find(key);
+			ERR_ASSERT(value != nullptr, u8"Entry with key does not exists!", return TValue());
+			return *value;
+		}
+		bool Remove(const TKey& key) {
+			Entry* entry = table.Find(key, Table::GetHash(key));
+			if (entry == nullptr) {
+				return false;
+			}
+			table.Remove(entry);
+			return true;
+		}
+		void Clear() {
+			table.Clear();
+		}
+
+#pragma region Lookup without constructing a key
+		template<typename TLookup> requires HashLookup<TKey, TLookup>::Enabled
+		bool ContainsKey(const TLookup& key) const {
+			return Find(key) != nullptr;
+		}
+		template<typename TLookup> requires HashLookup<TKey, TLookup>::Enabled
+		TValue* Find(const TLookup& key) const {
+			Entry* entry = table.Find(key, Table::GetHash(key));
+			return entry == nullptr ? nullptr : &entry->value;
+		}
+		template<typename TLookup> requires HashLookup<TKey, TLookup>::Enabled
+		bool TryGet(const TLookup& key, TValue& result) const {
+			TValue* value = Find(key);
+			if (value == nullptr) {
+				return false;
+			}
+			result = *value;
+			return true;
+		}
+		template<typename TLookup> requires HashLookup<TKey, TLookup>::Enabled
+		bool Remove(const TLookup& key) {
+			Entry* entry = table.Find(key, Table::GetHash(key));
+			if (entry == nullptr) {
+				return false;
+			}
+			table.Remove(entry);
+			return true;
+		}
+#pragma endregion
+
+		Iterator begin() const {
+			return table.begin();
+		}
+		Iterator end() const {
+			return table.end();
+		}
+
+	private:
+		Table table;
+	};
+}
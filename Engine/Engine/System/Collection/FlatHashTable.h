@@ -0,0 +1,403 @@
+#pragma once
+#include "Engine/System/Object/ObjectUtil.h"
+#include "Engine/System/Collection/HashHelper.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
+#include "Engine/System/Debug.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLATHASHTABLE_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Open addressing layout follows the Swiss table design used by Abseil's flat_hash_map:
+// one control byte per slot, scanned a group at a time, holding 7 bits of the hash.
+
+namespace Engine {
+	/// @brief The open addressing hash table shared by FlatDictionary and HashSet.\n
+	/// Entries are stored in one flat array next to a control byte array, lookups scan 16 control bytes at once.
+	/// Capacity is always a power of 2. Removed entries leave tombstones which are cleaned up when rehashing.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.\n
+	/// Copy construction uses the default allocator, copy assignment keeps the target's, moves take the allocator along.
+	/// @tparam TKey The key type. Needs to implement `int32 GetHashCode() const` and `bool operator==(const T&) const`.
+	/// @tparam TEntry The stored type, holding the key as its `key` member.
+	template<typename TKey, typename TEntry>
+	class FlatHashTable {
+	public:
+		static inline constexpr int32 GroupWidth = 16;
+		/// @brief The table grows when it gets fuller than 7/8.
+		static inline constexpr int32 MaxLoadNumerator = 7;
+		static inline constexpr int32 MaxLoadDenominator = 8;
+
+		FlatHashTable(int32 capacity = 0, Allocator* allocator = nullptr) :allocator(allocator) {
+			SetCapacity(capacity);
+		}
+		~FlatHashTable() {
+			Destroy();
+		}
+
+		FlatHashTable(const FlatHashTable& obj) {
+			CopyFromOther(obj);
+		}
+		FlatHashTable& operator=(const FlatHashTable& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			Destroy();
+			CopyFromOther(obj);
+
+			return *this;
+		}
+
+		FlatHashTable(FlatHashTable&& obj) :capacity(obj.capacity), count(obj.count), growthLeft(obj.growthLeft), controls(obj.controls), entries(obj.entries), allocator(obj.allocator) {
+			obj.ResetEmpty();
+		}
+		FlatHashTable& operator=(FlatHashTable&& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			Destroy();
+
+			allocator = obj.allocator;
+			capacity = obj.capacity;
+			count = obj.count;
+			growthLeft = obj.growthLeft;
+			controls = obj.controls;
+			entries = obj.entries;
+			obj.ResetEmpty();
+
+			return *this;
+		}
+
+		/// @brief Make room for at least capacity entries without growing.
+		bool SetCapacity(int32 capacity) {
+			ERR_ASSERT(capacity >= count, u8"capacity cannot be smaller than element count.", return false);
+			if (capacity == 0 && count == 0) {
+				return true;
+			}
+
+			int32 desired = GetSlotCountFor(capacity);
+			if (desired == this->capacity) {
+				return true;
+			}
+			Rehash(desired);
+			return true;
+		}
+		/// @brief The slot count. Entries fit without growing up to 7/8 of it.
+		int32 GetCapacity() const {
+			return capacity;
+		}
+		int32 GetCount() const {
+			return count;
+		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return allocator;
+		}
+
+		void Clear() {
+			if (controls == nullptr) {
+				return;
+			}
+
+			for (int32 i = 0; i < capacity; i += 1) {
+				if (IsFull(controls[i])) {
+					Memory::Destruct(entries + i);
+				}
+			}
+			std::memset(controls, ControlEmpty, capacity + GroupWidth);
+
+			count = 0;
+			growthLeft = GetMaxLoad(capacity);
+		}
+
+		template<typename TLookup>
+		static uint64 GetHash(const TLookup& key) {
+			// Spread the bits, many hash codes are the values themselves.
+			uint64 hash = (uint64)(uint32)ObjectUtil::GetHashCode(key) * 0x9E3779B97F4A7C15ull;
+			return hash ^ (hash >> 29);
+		}
+		/// @brief Find the entry with the key.
+		/// @param hash The hash from GetHash().
+		/// @return The entry, nullptr if the key doesn't exist. Invalidated by any insert or remove.
+		template<typename TLookup>
+		TEntry* Find(const TLookup& key, uint64 hash) const {
+			if (count == 0) {
+				return nullptr;
+			}
+
+			sbyte h2 = GetH2(hash);
+			ProbeSequence probe(GetH1(hash), capacity - 1);
+			while (true) {
+				Group group(controls + probe.offset);
+				for (uint32 match = group.Match(h2); match != 0; match &= match - 1) {
+					int32 index = probe.GetOffset(GetLowestBit(match));
+					if (entries[index].key == key) {
+						return entries + index;
+					}
+				}
+				if (group.MatchEmpty() != 0) {
+					return nullptr;
+				}
+				probe.Next();
+			}
+		}
+		/// @brief Construct an entry whose key is known to be absent.
+		/// @param hash The hash of the key from GetHash().
+		/// @return The new entry. Invalidated by any insert or remove.
+		template<typename ... Args>
+		TEntry* Insert(uint64 hash, Args&& ... args) {
+			int32 index = controls == nullptr ? -1 : FindInsertIndex(hash);
+			if (index < 0 || (growthLeft == 0 && controls[index] == ControlEmpty)) {
+				// Out of space. Grow, or clean up the tombstones if they are taking most of it.
+				Rehash(count * 2 < GetMaxLoad(capacity) ? capacity : GetSlotCountFor(count + 1));
+				index = FindInsertIndex(hash);
+			}
+
+			if (controls[index] == ControlEmpty) {
+				growthLeft -= 1;
+			}
+			Memory::Construct(entries + index, Memory::Forward<Args>(args)...);
+			SetControl(index, GetH2(hash));
+			count += 1;
+			return entries + index;
+		}
+		/// @brief Destroy an entry got from Find().
+		void Remove(TEntry* entry) {
+			int32 index = (int32)(entry - entries);
+			Memory::Destruct(entry);
+			// Other keys may have probed past this slot, keep the chain going with a tombstone.
+			SetControl(index, ControlDeleted);
+			count -= 1;
+		}
+
+		class Iterator {
+		public:
+			Iterator(const FlatHashTable* table, int32 index) :table(table), index(index) {
+				Skip();
+			}
+
+			bool operator!=(const Iterator& obj) const {
+				return index != obj.index;
+			}
+			const TEntry& operator*() const {
+				return table->entries[index];
+			}
+			Iterator& operator++() {
+				index += 1;
+				Skip();
+				return *this;
+			}
+		private:
+			void Skip() {
+				while (index < table->capacity && !IsFull(table->controls[index])) {
+					index += 1;
+				}
+			}
+
+			const FlatHashTable* table;
+			int32 index;
+		};
+
+		Iterator begin() const {
+			return Iterator(this, 0);
+		}
+		Iterator end() const {
+			return Iterator(this, capacity);
+		}
+
+	private:
+		// Full slots store the top 7 bits of the hash, the special ones have the sign bit set.
+		static inline constexpr sbyte ControlEmpty = -128;
+		static inline constexpr sbyte ControlDeleted = -2;
+
+		static bool IsFull(sbyte control) {
+			return control >= 0;
+		}
+
+		/// @brief 16 control bytes loaded at once.
+		struct Group {
+			explicit Group(const sbyte* position) {
+#ifdef FLATHASHTABLE_SSE2
+				controls = _mm_loadu_si128((const __m128i*)position);
+#else
+				std::memcpy(controls, position, GroupWidth);
+#endif
+			}
+			/// @brief Bit i is set when control byte i equals the hash.
+			uint32 Match(sbyte hash) const {
+#ifdef FLATHASHTABLE_SSE2
+				return (uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), controls));
+#else
+				uint32 result = 0;
+				for (int32 i = 0; i < GroupWidth; i += 1) {
+					result |= (uint32)(controls[i] == hash) << i;
+				}
+				return result;
+#endif
+			}
+			uint32 MatchEmpty() const {
+				return Match(ControlEmpty);
+			}
+			/// @brief Bit i is set when slot i is empty or a tombstone.
+			uint32 MatchEmptyOrDeleted() const {
+#ifdef FLATHASHTABLE_SSE2
+				return (uint32)_mm_movemask_epi8(controls);
+#else
+				uint32 result = 0;
+				for (int32 i = 0; i < GroupWidth; i += 1) {
+					result |= (uint32)(controls[i] < 0) << i;
+				}
+				return result;
+#endif
+			}
+
+#ifdef FLATHASHTABLE_SSE2
+			__m128i controls;
+#else
+			sbyte controls[GroupWidth];
+#endif
+		};
+
+		/// @brief Visits every group exactly once with triangular steps, as the capacity is a power of 2.
+		struct ProbeSequence {
+			ProbeSequence(uint64 hash, int32 mask) :mask(mask), offset((int32)(hash & mask)) {}
+			int32 GetOffset(int32 i) const {
+				return (offset + i) & mask;
+			}
+			void Next() {
+				index += GroupWidth;
+				offset = (offset + index) & mask;
+			}
+
+			int32 mask;
+			int32 offset;
+			int32 index = 0;
+		};
+
+		static int32 GetLowestBit(uint32 mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return (int32)index;
+#else
+			return __builtin_ctz(mask);
+#endif
+		}
+
+		static sbyte GetH2(uint64 hash) {
+			return (sbyte)(hash >> 57);
+		}
+		static uint64 GetH1(uint64 hash) {
+			return hash >> 7;
+		}
+
+		static int32 GetMaxLoad(int32 capacity) {
+			return capacity / MaxLoadDenominator * MaxLoadNumerator;
+		}
+		static int32 GetSlotCountFor(int32 entryCount) {
+			int32 result = GroupWidth;
+			while (GetMaxLoad(result) < entryCount) {
+				result *= 2;
+			}
+			return result;
+		}
+
+		/// @brief Find a slot for a key known to be absent.
+		int32 FindInsertIndex(uint64 hash) const {
+			ProbeSequence probe(GetH1(hash), capacity - 1);
+			while (true) {
+				Group group(controls + probe.offset);
+				uint32 match = group.MatchEmptyOrDeleted();
+				if (match != 0) {
+					return probe.GetOffset(GetLowestBit(match));
+				}
+				probe.Next();
+			}
+		}
+		/// @brief Set a control byte and its copy after the end, which lets a group be read across the wrap-around.
+		void SetControl(int32 index, sbyte control) {
+			controls[index] = control;
+			controls[((index - GroupWidth) & (capacity - 1)) + GroupWidth] = control;
+		}
+
+		/// @brief Move all entries into new storage with the given slot count, dropping the tombstones.
+		void Rehash(int32 newCapacity) {
+			int32 oldCapacity = capacity;
+			sbyte* oldControls = controls;
+			TEntry* oldEntries = entries;
+
+			AllocateStorage(newCapacity);
+			growthLeft = GetMaxLoad(newCapacity) - count;
+
+			// Keys are unique already, place them without comparing.
+			for (int32 i = 0; i < oldCapacity; i += 1) {
+				if (!IsFull(oldControls[i])) {
+					continue;
+				}
+				uint64 hash = GetHash(oldEntries[i].key);
+				int32 index = FindInsertIndex(hash);
+				Memory::Construct(entries + index, Memory::Move(oldEntries[i]));
+				SetControl(index, GetH2(hash));
+				Memory::Destruct(oldEntries + i);
+			}
+
+			DeallocateStorage(oldControls, oldEntries, oldCapacity);
+		}
+
+		void CopyFromOther(const FlatHashTable& obj) {
+			if (obj.controls == nullptr) {
+				return;
+			}
+			AllocateStorage(obj.capacity);
+			std::memcpy(controls, obj.controls, capacity + GroupWidth);
+			for (int32 i = 0; i < capacity; i += 1) {
+				if (IsFull(controls[i])) {
+					Memory::Construct(entries + i, obj.entries[i]);
+				}
+			}
+			count = obj.count;
+			growthLeft = obj.growthLeft;
+		}
+
+		void AllocateStorage(int32 capacity) {
+			controls = (sbyte*)Allocator::AllocateFrom(allocator, capacity + GroupWidth, GroupWidth);
+			std::memset(controls, ControlEmpty, capacity + GroupWidth);
+			entries = (TEntry*)Allocator::AllocateFrom(allocator, capacity * sizeof(TEntry), alignof(TEntry));
+			this->capacity = capacity;
+		}
+		void DeallocateStorage(sbyte* controls, TEntry* entries, int32 capacity) {
+			if (controls == nullptr) {
+				return;
+			}
+			Allocator::DeallocateTo(allocator, controls, capacity + GroupWidth);
+			Allocator::DeallocateTo(allocator, entries, capacity * sizeof(TEntry));
+		}
+		void Destroy() {
+			Clear();
+			DeallocateStorage(controls, entries, capacity);
+			ResetEmpty();
+		}
+		void ResetEmpty() {
+			controls = nullptr;
+			entries = nullptr;
+			capacity = 0;
+			count = 0;
+			growthLeft = 0;
+		}
+
+		int32 capacity = 0;
+		int32 count = 0;
+		/// @brief Empty slots that can still be filled before the load limit is reached.
+		int32 growthLeft = 0;
+		sbyte* controls = nullptr;
+		TEntry* entries = nullptr;
+		Allocator* allocator = nullptr;
+	};
+}
@@ -0,0 +1,192 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/Sorting.h"
+#include "Engine/System/Debug.h"
+
+namespace Engine {
+	/// @brief A map keeping its keys and values in two sorted arrays, for small tables built once and read often.\n
+	/// Lookups are a branch-free binary search over the keys only, adding and removing shift the elements after it.\n
+	/// Freeze() trims the storage once the table is complete, after which keys can no longer be added or removed.\n
+	/// Keys can also be looked up by any type the comparator and `TKey == TLookup` accept, such as std::string_view for String keys.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.\n
+	/// Copy construction uses the default allocator, copy assignment keeps the target's, moves take the allocator along.
+	/// @tparam TKey The key type. Needs to be ordered by Compare and implement `bool operator==(const T&) const`.
+	/// @tparam TValue The value type. Needs to be default-constructable, copy-constructable and move-contstructable.
+	/// @tparam Compare Returns true if the first key goes before the second.
+	template<typename TKey, typename TValue, typename Compare = SortLess>
+	class FlatMap final {
+	public:
+		struct Pair {
+			const TKey& key;
+			TValue& value;
+		};
+		class Iterator {
+		public:
+			Iterator(const FlatMap* map, int32 index) :map(map), index(index) {}
+
+			bool operator!=(const Iterator& obj) const {
+				return index != obj.index;
+			}
+			Pair operator*() const {
+				return Pair{ map->keys[index], map->values.GetRawElementPtr()[index] };
+			}
+			Iterator& operator++() {
+				index += 1;
+				return *this;
+			}
+		private:
+			const FlatMap* map;
+			int32 index;
+		};
+
+		FlatMap(int32 capacity = 0) :keys(capacity), values(capacity) {}
+		FlatMap(int32 capacity, Allocator* allocator) :keys(capacity, allocator), values(capacity, allocator) {}
+
+		bool Add(const TKey& key, const TValue& value) {
+			ERR_ASSERT(!frozen, u8"Failed to add an entry, the map is frozen.", return false);
+			int32 index = LowerBound(key);
+			ERR_ASSERT(!IsMatch(index, key), u8"Failed to add an entry, the key already exists.", return false);
+			keys.Insert(index, key);
+			values.Insert(index, value);
+			return true;
+		}
+		/// @brief Overwrite the value of the key, or add it if the map isn't frozen.
+		/// @return false if the key doesn't exist and the map is frozen.
+		bool Set(const TKey& key, const TValue& value) {
+			int32 index = LowerBound(key);
+			if (IsMatch(index, key)) {
+				values.Set(index, value);
+				return true;
+			}
+			ERR_ASSERT(!frozen, u8"Failed to add an entry, the map is frozen.", return false);
+			keys.Insert(index, key);
+			values.Insert(index, value);
+			return true;
+		}
+		bool Remove(const TKey& key) {
+			ERR_ASSERT(!frozen, u8"Failed to remove an entry, the map is frozen.", return false);
+			int32 index = IndexOf(key);
+			if (index < 0) {
+				return false;
+			}
+			keys.RemoveAt(index);
+			values.RemoveAt(index);
+			return true;
+		}
+		void Clear() {
+			ERR_ASSERT(!frozen, u8"Failed to clear, the map is frozen.", return);
+			keys.Clear();
+			values.Clear();
+		}
+
+		/// @brief Trim the storage to the entry count and stop keys from being added or removed.\n
+		/// Values of existing keys can still be changed.
+		void Freeze() {
+			if (frozen) {
+				return;
+			}
+			frozen = true;
+			if (keys.GetCount() == keys.GetCapacity()) {
+				return;
+			}
+
+			List<TKey> trimmedKeys(keys.GetCount(), keys.GetAllocator());
+			List<TValue> trimmedValues(values.GetCount(), values.GetAllocator());
+			for (int32 i = 0; i < keys.GetCount(); i += 1) {
+				trimmedKeys.Add(Memory::Move(keys[i]));
+				trimmedValues.Add(Memory::Move(values[i]));
+			}
+			keys = Memory::Move(trimmedKeys);
+			values = Memory::Move(trimmedValues);
+		}
+		bool IsFrozen() const {
+			return frozen;
+		}
+
+		/// @brief Get the index of the key in the sorted arrays, -1 if it doesn't exist.
+		template<typename TLookup>
+		int32 IndexOf(const TLookup& key) const {
+			int32 index = LowerBound(key);
+			return IsMatch(index, key) ? index : -1;
+		}
+		template<typename TLookup>
+		bool ContainsKey(const TLookup& key) const {
+			return IndexOf(key) >= 0;
+		}
+		/// @brief Get a pointer to the value without copying it, nullptr if the key doesn't exist.\n
+		/// The pointer is invalidated by any add or remove.
+		template<typename TLookup>
+		TValue* Find(const TLookup& key) const {
+			int32 index = IndexOf(key);
+			return index < 0 ? nullptr : values.GetRawElementPtr() + index;
+		}
+		template<typename TLookup>
+		bool TryGet(const TLookup& key, TValue& result) const {
+			TValue* value = Find(key);
+			if (value == nullptr) {
+				return false;
+			}
+			result = *value;
+			return true;
+		}
+		TValue Get(const TKey& key) const {
+			TValue* value = Find(key);
+			ERR_ASSERT(value != nullptr, u8"Entry with key does not exists!", return TValue());
+			return *value;
+		}
+
+		int32 GetCount() const {
+			return keys.GetCount();
+		}
+		int32 GetCapacity() const {
+			return keys.GetCapacity();
+		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return keys.GetAllocator();
+		}
+		const TKey& GetKey(int32 index) const {
+			return keys[index];
+		}
+		TValue& GetValue(int32 index) const {
+			FATAL_ASSERT(index >= 0 && index < GetCount(), u8"index out of bounds.");
+			return values.GetRawElementPtr()[index];
+		}
+
+		Iterator begin() const {
+			return Iterator(this, 0);
+		}
+		Iterator end() const {
+			return Iterator(this, GetCount());
+		}
+
+	private:
+		/// @brief Get the index of the first key not ordered before the lookup key.\n
+		/// The range halves on every step and the pick compiles to a conditional move, so the loop never branches on the keys.
+		template<typename TLookup>
+		int32 LowerBound(const TLookup& key) const {
+			int32 count = keys.GetCount();
+			if (count == 0) {
+				return 0;
+			}
+			const TKey* base = keys.GetRawElementPtr();
+			const TKey* first = base;
+			while (count > 1) {
+				int32 half = count / 2;
+				first = (compare(first[half], key) ? first + half : first);
+				count -= half;
+			}
+			return (int32)(first - base) + (compare(*first, key) ? 1 : 0);
+		}
+		template<typename TLookup>
+		bool IsMatch(int32 index, const TLookup& key) const {
+			return index < keys.GetCount() && keys[index] == key;
+		}
+
+		List<TKey> keys;
+		List<TValue> values;
+		bool frozen = false;
+		[[no_unique_address]] Compare compare{};
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/System/Definition.h"
+#include <string_view>
 
 namespace Engine {
 	// Referenced .NET 5 standard library: https://source.dot.net
@@ -14,4 +15,17 @@ namespace Engine {
 		static const int32 hashPrime;
 		static const int32 primes[];
 	};
+
+	/// @brief Opt-in for looking up TKey keys by a TLookup without constructing a TKey.\n
+	/// A TLookup must give the same hash code from ObjectUtil::GetHashCode as the equal TKey, and be comparable with `TKey == TLookup`.
+	template<typename TKey, typename TLookup>
+	struct HashLookup {
+		static inline constexpr bool Enabled = false;
+	};
+
+	class String;
+	template<>
+	struct HashLookup<String, std::string_view> {
+		static inline constexpr bool Enabled = true;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#include "Engine/System/Collection/FlatHashTable.h"
+#include <initializer_list>
+
+namespace Engine {
+	/// @brief A set of unique values, on the same hash table as FlatDictionary, see FlatHashTable.\n
+	/// Values can also be looked up by the types enabled with HashLookup, such as std::string_view for Strings.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.\n
+	/// Copy construction uses the default allocator, copy assignment keeps the target's, moves take the allocator along.
+	/// @tparam T The value type. Needs to implement `int32 GetHashCode() const` and `bool operator==(const T&) const`.
+	template<typename T>
+	class HashSet {
+	private:
+		struct Entry {
+			Entry(const T& key) :key(key) {}
+			T key;
+		};
+		using Table = FlatHashTable<T, Entry>;
+
+	public:
+		class Iterator {
+		public:
+			Iterator(typename Table::Iterator iterator) :iterator(iterator) {}
+
+			bool operator!=(const Iterator& obj) const {
+				return iterator != obj.iterator;
+			}
+			const T& operator*() const {
+				return (*iterator).key;
+			}
+			Iterator& operator++() {
+				++iterator;
+				return *this;
+			}
+		private:
+			typename Table::Iterator iterator;
+		};
+
+		HashSet(int32 capacity = 0) :table(capacity) {}
+		HashSet(int32 capacity, Allocator* allocator) :table(capacity, allocator) {}
+		HashSet(std::initializer_list<T> values) :table((int32)values.size()) {
+			for (const auto& value : values) {
+				Add(value);
+			}
+		}
+
+		/// @brief Make room for at least capacity values without growing.
+		bool SetCapacity(int32 capacity) {
+			return table.SetCapacity(capacity);
+		}
+		/// @brief The slot count. Values fit without growing up to 7/8 of it.
+		int32 GetCapacity() const {
+			return table.GetCapacity();
+		}
+		int32 GetCount() const {
+			return table.GetCount();
+		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return table.GetAllocator();
+		}
+
+		/// @return false if the value already exists.
+		bool Add(const T& value) {
+			uint64 hash = Table::GetHash(value);
+			if (table.Find(value, hash) != nullptr) {
+				return false;
+			}
+			table.Insert(hash, value);
+			return true;
+		}
+		bool Contains(const T& value) const {
+			return table.Find(value, Table::GetHash(value)) != nullptr;
+		}
+		/// @return false if the value doesn't exist.
+		bool Remove(const T& value) {
+			Entry* entry = table.Find(value, Table::GetHash(value));
+			if (entry == nullptr) {
+				return false;
+			}
+			table.Remove(entry);
+			return true;
+		}
+		void Clear() {
+			table.Clear();
+		}
+
+#pragma region Lookup without constructing a value
+		template<typename TLookup> requires HashLookup<T, TLookup>::Enabled
+		bool Contains(const TLookup& value) const {
+			return table.Find(value, Table::GetHash(value)) != nullptr;
+		}
+		template<typename TLookup> requires HashLookup<T, TLookup>::Enabled
+		bool Remove(const TLookup& value) {
+			Entry* entry = table.Find(value, Table::GetHash(value));
+			if (entry == nullptr) {
+				return false;
+			}
+			table.Remove(entry);
+			return true;
+		}
+#pragma endregion
+
+		Iterator begin() const {
+			return Iterator(table.begin());
+		}
+		Iterator end() const {
+			return Iterator(table.end());
+		}
+
+	private:
+		Table table;
+	};
+}
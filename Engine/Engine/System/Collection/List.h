@@ -1,12 +1,19 @@
 #pragma once
 #include "Engine/System/Definition.h"
 #include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
 #include "Engine/System/Debug.h"
 #include "Engine/System/Collection/Iterator.h"
+#include "Engine/System/Collection/Sorting.h"
 #include <initializer_list>
+#include <type_traits>
+#include <cstring>
 
 namespace Engine{
-	/// @brief A random-access list.
+	/// @brief A random-access list.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.\n
+	/// Copy construction uses the default allocator, copy assignment keeps the target's, moves take the allocator along.\n
+	/// Elements are relocated bitwise when the storage grows. Trivially copyable elements are shifted with memmove on insert and remove.
 	/// @tparam T The value type. Needs to be default-constructable, copy-constructable and move-contstructable.
 	template<typename T>
 	class List {
@@ -16,13 +23,16 @@ namespace Engine{
 		List(int32 capacity = 0) {
 			SetCapacity(capacity);
 		}
+		List(int32 capacity, Allocator* allocator) :allocator(allocator) {
+			SetCapacity(capacity);
+		}
 
 		List(std::initializer_list<T> values) {
 			if (values.size() <= 0) {
 				return;
 			}
 			SetCapacity(static_cast<int32>(values.size()));
-			for (auto value : values) {
+			for (const auto& value : values) {
 				Add(value);
 			}
 		}
@@ -46,14 +56,19 @@ namespace Engine{
 			return *this;
 		}
 
-		List(List&& obj) :elements(obj.elements), capacity(obj.capacity), count(obj.count) {
+		List(List&& obj) :elements(obj.elements), capacity(obj.capacity), count(obj.count), allocator(obj.allocator) {
 			obj.elements = nullptr;
 			obj.capacity = 0;
 			obj.count = 0;
 		}
 		List& operator=(List&& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
 			Destroy();
 
+			allocator = obj.allocator;
 			elements = obj.elements;
 			obj.elements = nullptr;
 			capacity = obj.capacity;
@@ -67,6 +82,10 @@ namespace Engine{
 		int32 GetCapacity() const {
 			return capacity;
 		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return allocator;
+		}
 		void SetCapacity(int32 capacity) {
 			ERR_ASSERT(capacity >= 0 && capacity >= count, u8"capacity cannot be less than 0 or the current size.", return);
 
@@ -75,9 +94,9 @@ namespace Engine{
 			}
 
 			if (elements == nullptr) {
-				elements = (T*)Memory::Allocate(capacity * sizeof(T));
+				elements = (T*)Allocator::AllocateFrom(allocator, capacity * sizeof(T), alignof(T));
 			} else {
-				elements = (T*)Memory::Reallocate(elements, capacity * sizeof(T));
+				elements = (T*)Allocator::ReallocateFrom(allocator, elements, this->capacity * sizeof(T), capacity * sizeof(T), alignof(T));
 			}
 			this->capacity = capacity;
 		}
@@ -96,55 +115,119 @@ namespace Engine{
 		int32 GetCount() const {
 			return count;
 		}
+		/// @brief Grow with default-constructed elements or shrink from the end, reserving the storage at once.\n
+		/// Trivial elements are zeroed with a single memset, the others are constructed so their default member initializers apply.
+		void SetCount(int32 count) {
+			ERR_ASSERT(count >= 0, u8"count cannot be less than 0.", return);
+
+			if (count < this->count) {
+				for (int32 i = count; i < this->count; i += 1) {
+					Memory::Destruct(elements + i);
+				}
+			} else if (count > this->count) {
+				RequireCapacity(count);
+				if constexpr (std::is_trivial_v<T>) {
+					std::memset((void*)(elements + this->count), 0, (count - this->count) * sizeof(T));
+				} else {
+					for (int32 i = this->count; i < count; i += 1) {
+						Memory::Construct(elements + i);
+					}
+				}
+			}
+			this->count = count;
+		}
 		T Get(int32 index) const {
 			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return T());
 			return elements[index];
 		}
+		/// @brief Access the element without copying it. The reference is invalidated by any insert or remove.
+		T& operator[](int32 index) {
+			FATAL_ASSERT(index >= 0 && index < count, u8"index out of bounds.");
+			return elements[index];
+		}
+		/// @brief Access the element without copying it. The reference is invalidated by any insert or remove.
+		const T& operator[](int32 index) const {
+			FATAL_ASSERT(index >= 0 && index < count, u8"index out of bounds.");
+			return elements[index];
+		}
 		void Set(int32 index, const T& value) {
 			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
 			*(elements + index) = value;
 		}
+		void Set(int32 index, T&& value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			*(elements + index) = Memory::Move(value);
+		}
 		void Add(const T& value) {
-			RequireCapacity(count + 1);
-			Memory::Construct(elements + count, value);
+			Emplace(value);
+		}
+		void Add(T&& value) {
+			Emplace(Memory::Move(value));
+		}
+		/// @brief Construct a new element at the end from the arguments.
+		/// @return The new element.
+		template<typename ... Args>
+		T& Emplace(Args&& ... args) {
+			if (count < capacity) {
+				Memory::Construct(elements + count, Memory::Forward<Args>(args)...);
+			} else {
+				// The arguments may refer to an element, build the value before the storage moves.
+				T value(Memory::Forward<Args>(args)...);
+				RequireCapacity(count + 1);
+				Memory::Construct(elements + count, Memory::Move(value));
+			}
 			count += 1;
+			return elements[count - 1];
 		}
 		void Insert(int32 index, const T& value) {
 			ERR_ASSERT(index >= 0 && index <= count, u8"index out of bounds.", return);
-			
+			EmplaceAt(index, value);
+		}
+		void Insert(int32 index, T&& value) {
+			ERR_ASSERT(index >= 0 && index <= count, u8"index out of bounds.", return);
+			EmplaceAt(index, Memory::Move(value));
+		}
+		/// @brief Construct a new element at the index from the arguments, elements after it are shifted back.
+		/// @return The new element.
+		template<typename ... Args>
+		T& EmplaceAt(int32 index, Args&& ... args) {
+			FATAL_ASSERT(index >= 0 && index <= count, u8"index out of bounds.");
+
 			if (index == count) {
-				Add(value);
-				return;
+				return Emplace(Memory::Forward<Args>(args)...);
 			}
 
+			// The arguments may refer to an element, build the value before shifting.
+			T value(Memory::Forward<Args>(args)...);
 			RequireCapacity(count + 1);
-			
-			// Move objects.
-			for (int32 i = count; i > index; i -= 1) {
-				if (i == count) {
-					Memory::Construct(elements + i, *(elements + i - 1));
-				} else {
-					*(elements + i) = *(elements + i - 1);
+
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				std::memmove(elements + index + 1, elements + index, (count - index) * sizeof(T));
+				Memory::Construct(elements + index, Memory::Move(value));
+			} else {
+				Memory::Construct(elements + count, Memory::Move(*(elements + count - 1)));
+				for (int32 i = count - 1; i > index; i -= 1) {
+					*(elements + i) = Memory::Move(*(elements + i - 1));
 				}
+				*(elements + index) = Memory::Move(value);
 			}
 
-			// Assign
-			*(elements + index) = value;
-			
 			count += 1;
+			return elements[index];
 		}
 		void RemoveAt(int32 index) {
 			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds", return);
 
-			// Move object routine.
-			if (index < count - 1) {
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				std::memmove(elements + index, elements + index + 1, (count - index - 1) * sizeof(T));
+			} else {
 				for (int32 i = index; i < count - 1; i += 1) {
-					*(elements + i) = *(elements + i + 1);
+					*(elements + i) = Memory::Move(*(elements + i + 1));
 				}
-			}
 
-			// Destruct the last element.
-			Memory::Destruct(elements + count - 1);
+				// Destruct the last element.
+				Memory::Destruct(elements + count - 1);
+			}
 
 			count -= 1;
 		}
@@ -154,6 +237,28 @@ namespace Engine{
 			}
 			count = 0;
 		}
+
+		/// @brief Sort the elements with introsort, see Sorting::Sort(). Equal elements may be reordered.
+		/// @param compare Returns true if the first argument goes before the second.
+		template<typename Compare = SortLess>
+		void Sort(const Compare& compare = Compare()) {
+			Sorting::Sort(elements, count, compare);
+		}
+		/// @brief Sort the elements with merge sort, keeping the order of equal elements, see Sorting::StableSort().\n
+		/// The buffer comes from the list's allocator.
+		/// @param compare Returns true if the first argument goes before the second.
+		template<typename Compare = SortLess>
+		void StableSort(const Compare& compare = Compare()) {
+			Sorting::StableSort(elements, count, compare, allocator);
+		}
+		/// @brief Sort the elements by an integer or floating point key, keeping the order of equal keys, see Sorting::RadixSort().\n
+		/// The buffers come from the list's allocator.
+		/// @param keyOf Returns the key of an element.
+		template<typename KeyOf>
+		void RadixSort(const KeyOf& keyOf) {
+			Sorting::RadixSort(elements, count, keyOf, allocator);
+		}
+
 		/// @brief Get the raw element pointer for high performance operation, if you know what you are doing.\n
 		/// Only read or write existing elements. Do not insert or remove.
 		/// The element pointer can vary after an insert or remove operation!
@@ -171,7 +276,7 @@ namespace Engine{
 		void CopyFromOther(const List& obj) {
 			capacity = obj.capacity;
 			count = obj.count;
-			elements = (T*)Memory::Allocate(sizeof(T) * count);
+			elements = capacity > 0 ? (T*)Allocator::AllocateFrom(allocator, sizeof(T) * capacity, alignof(T)) : nullptr;
 			for (int32 i = 0; i < count; i += 1) {
 				Memory::Construct(elements + i, *(obj.elements + i));
 			}
@@ -183,10 +288,14 @@ namespace Engine{
 			for (int32 i = 0; i < count; i += 1) {
 				Memory::Destruct(elements + i);
 			}
-			Memory::Deallocate(elements);
+			Allocator::DeallocateTo(allocator, elements, capacity * sizeof(T));
+			elements = nullptr;
+			capacity = 0;
+			count = 0;
 		}
 		T* elements = nullptr;
 		int32 capacity = 0;
 		int32 count = 0;
+		Allocator* allocator = nullptr;
 	};
 }
\ No newline at end of file
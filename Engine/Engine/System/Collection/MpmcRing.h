@@ -0,0 +1,165 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Debug.h"
+#include <atomic>
+
+// Bounded MPMC queue by Dmitry Vyukov, every cell carries a sequence number telling
+// which lap of the ring may write or read it next.
+// https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+
+namespace Engine {
+	/// @brief A fixed capacity lock-free ring buffer for any number of producer and consumer threads.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.
+	/// @tparam T The value type. Needs to be move-constructable and move-assignable.
+	template<typename T>
+	class MpmcRing final {
+	public:
+		static inline constexpr int32 DefaultCapacity = 1024;
+
+		/// @param capacity Will be rounded up to the power of 2, at least 2.
+		MpmcRing(int32 capacity = DefaultCapacity, Allocator* allocator = nullptr) :allocator(allocator) {
+			ERR_ASSERT(capacity > 0, u8"capacity must be larger than 0.", capacity = DefaultCapacity);
+
+			uint64 size = 2;
+			while (size < (uint64)capacity) {
+				size <<= 1;
+			}
+			mask = size - 1;
+			cells = (Cell*)Allocator::AllocateFrom(allocator, sizeof(Cell) * size, alignof(Cell));
+			for (uint64 i = 0; i < size; i += 1) {
+				Memory::Construct(&cells[i].sequence, i);
+			}
+		}
+		~MpmcRing() {
+			uint64 end = enqueuePosition.load(std::memory_order_relaxed);
+			for (uint64 i = dequeuePosition.load(std::memory_order_relaxed); i != end; i += 1) {
+				Memory::Destruct(cells[i & mask].GetValue());
+			}
+			Allocator::DeallocateTo(allocator, cells, sizeof(Cell) * (mask + 1));
+		}
+		MpmcRing(const MpmcRing&) = delete;
+		MpmcRing& operator=(const MpmcRing&) = delete;
+
+		/// @return false when the ring is full.
+		bool Push(const T& value) {
+			return Emplace(value);
+		}
+		/// @brief value is left untouched when the ring is full.
+		/// @return false when the ring is full.
+		bool Push(T&& value) {
+			return Emplace(Memory::Move(value));
+		}
+		/// @brief Construct a value in place at the back.
+		/// @return false when the ring is full.
+		template<typename ...Args>
+		bool Emplace(Args&& ...args) {
+			uint64 position;
+			if (Claim(enqueuePosition, 0, 1, position) == 0) {
+				return false;
+			}
+			Cell& cell = cells[position & mask];
+			Memory::Construct(cell.GetValue(), Memory::Forward<Args>(args)...);
+			cell.sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+		/// @brief Push as many of the values as fit, claiming their cells with a single CAS.
+		/// @return The count of values pushed, counted from the first.
+		int32 PushBatch(const T* values, int32 count) {
+			uint64 position;
+			int32 n = Claim(enqueuePosition, 0, count, position);
+			for (int32 i = 0; i < n; i += 1) {
+				Cell& cell = cells[(position + i) & mask];
+				Memory::Construct(cell.GetValue(), values[i]);
+				cell.sequence.store(position + i + 1, std::memory_order_release);
+			}
+			return n;
+		}
+
+		/// @brief Move the oldest value into result.
+		/// @return false when the ring is empty.
+		bool Pop(T& result) {
+			uint64 position;
+			if (Claim(dequeuePosition, 1, 1, position) == 0) {
+				return false;
+			}
+			Release(position, result);
+			return true;
+		}
+		/// @brief Move up to maxCount of the oldest ready values into results, claiming their cells with a single CAS.
+		/// @return The count of values popped.
+		int32 PopBatch(T* results, int32 maxCount) {
+			uint64 position;
+			int32 n = Claim(dequeuePosition, 1, maxCount, position);
+			for (int32 i = 0; i < n; i += 1) {
+				Release(position + i, results[i]);
+			}
+			return n;
+		}
+
+		/// @brief Get an approximate value count, values being pushed or popped may be counted or not.
+		int32 GetCount() const {
+			uint64 end = enqueuePosition.load(std::memory_order_acquire);
+			uint64 begin = dequeuePosition.load(std::memory_order_acquire);
+			return end > begin ? (int32)(end - begin) : 0;
+		}
+		int32 GetCapacity() const {
+			return (int32)(mask + 1);
+		}
+
+	private:
+		struct Cell {
+			T* GetValue() {
+				return reinterpret_cast<T*>(storage);
+			}
+			std::atomic<uint64> sequence;
+			alignas(T) byte storage[sizeof(T)];
+		};
+
+		/// @brief Take up to maxCount consecutive cells from target whose sequence is position + lap.\n
+		/// lap is 0 for writing a cell and 1 for reading it.
+		/// @return The count of cells taken, starting at position.
+		int32 Claim(std::atomic<uint64>& target, uint64 lap, int32 maxCount, uint64& position) {
+			position = target.load(std::memory_order_relaxed);
+			while (true) {
+				int32 n = 0;
+				while (n < maxCount && n <= (int32)mask) {
+					uint64 sequence = cells[(position + n) & mask].sequence.load(std::memory_order_acquire);
+					int64 diff = (int64)(sequence - (position + n + lap));
+					if (diff != 0) {
+						if (n == 0 && diff > 0) {
+							// Another thread took this cell already, catch up.
+							n = -1;
+						}
+						break;
+					}
+					n += 1;
+				}
+				if (n == 0) {
+					return 0;
+				}
+				if (n > 0 && target.compare_exchange_weak(position, position + n, std::memory_order_relaxed)) {
+					return n;
+				}
+				if (n < 0) {
+					position = target.load(std::memory_order_relaxed);
+				}
+			}
+		}
+		void Release(uint64 position, T& result) {
+			Cell& cell = cells[position & mask];
+			result = Memory::Move(*cell.GetValue());
+			Memory::Destruct(cell.GetValue());
+			cell.sequence.store(position + mask + 1, std::memory_order_release);
+		}
+
+		// Producers and consumers contend on different cache lines, away from the read-only data.
+		alignas(ThreadUtil::CacheLineSize) std::atomic<uint64> enqueuePosition{ 0 };
+		alignas(ThreadUtil::CacheLineSize) std::atomic<uint64> dequeuePosition{ 0 };
+		alignas(ThreadUtil::CacheLineSize) Cell* cells = nullptr;
+		uint64 mask = 0;
+		Allocator* allocator = nullptr;
+	};
+}
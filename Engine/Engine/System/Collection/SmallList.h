@@ -0,0 +1,278 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
+#include "Engine/System/Debug.h"
+#include "Engine/System/Collection/Iterator.h"
+#include <initializer_list>
+#include <type_traits>
+#include <cstring>
+
+namespace Engine {
+	/// @brief A random-access list keeping up to N elements inline, the same interface as List.\n
+	/// Storage only comes from the Allocator, or from Memory by default, once the list grows beyond N.\n
+	/// Elements are relocated bitwise when moving between the inline and the heap storage, and when the list is moved.
+	/// @tparam T The value type. Needs to be default-constructable, copy-constructable and move-contstructable.
+	/// @tparam N The inline capacity.
+	template<typename T, int32 N>
+	class SmallList {
+		static_assert(N > 0, "SmallList needs a positive inline capacity, use List instead.");
+
+	public:
+		using Iterator = ReadonlyIterator<T>;
+		static inline constexpr int32 InlineCapacity = N;
+
+		SmallList(int32 capacity = 0) {
+			SetCapacity(capacity);
+		}
+		SmallList(int32 capacity, Allocator* allocator) :allocator(allocator) {
+			SetCapacity(capacity);
+		}
+
+		SmallList(std::initializer_list<T> values) {
+			SetCapacity(static_cast<int32>(values.size()));
+			for (const auto& value : values) {
+				Add(value);
+			}
+		}
+
+		~SmallList() {
+			Destroy();
+		}
+
+		SmallList(const SmallList& obj) {
+			CopyFromOther(obj);
+		}
+		SmallList& operator=(const SmallList& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			Destroy();
+
+			CopyFromOther(obj);
+
+			return *this;
+		}
+
+		SmallList(SmallList&& obj) :allocator(obj.allocator) {
+			TakeFromOther(obj);
+		}
+		SmallList& operator=(SmallList&& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			Destroy();
+
+			allocator = obj.allocator;
+			TakeFromOther(obj);
+
+			return *this;
+		}
+
+		int32 GetCapacity() const {
+			return capacity;
+		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return allocator;
+		}
+		/// @brief Check if the elements are stored inline, without any heap storage.
+		bool IsInline() const {
+			return elements == GetInlineElements();
+		}
+		/// @brief Capacities not larger than N go back to the inline storage.
+		void SetCapacity(int32 capacity) {
+			ERR_ASSERT(capacity >= 0 && capacity >= count, u8"capacity cannot be less than 0 or the current size.", return);
+
+			if (capacity < N) {
+				capacity = N;
+			}
+			if (capacity == this->capacity) {
+				return;
+			}
+
+			if (capacity == N) {
+				// Back to inline.
+				T* heap = elements;
+				std::memcpy((void*)GetInlineElements(), (void*)heap, count * sizeof(T));
+				Allocator::DeallocateTo(allocator, heap, this->capacity * sizeof(T));
+				elements = GetInlineElements();
+			} else if (IsInline()) {
+				T* heap = (T*)Allocator::AllocateFrom(allocator, capacity * sizeof(T), alignof(T));
+				std::memcpy((void*)heap, (void*)elements, count * sizeof(T));
+				elements = heap;
+			} else {
+				elements = (T*)Allocator::ReallocateFrom(allocator, elements, this->capacity * sizeof(T), capacity * sizeof(T), alignof(T));
+			}
+			this->capacity = capacity;
+		}
+		static inline constexpr int32 CapacityMultiplier = 2;
+		void RequireCapacity(int32 capacity) {
+			if (capacity <= this->capacity) {
+				return;
+			}
+			int32 result = this->capacity;
+			while (result < capacity) {
+				result *= CapacityMultiplier;
+			}
+			SetCapacity(result);
+		}
+		int32 GetCount() const {
+			return count;
+		}
+		T Get(int32 index) const {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return T());
+			return elements[index];
+		}
+		/// @brief Access the element without copying it. The reference is invalidated by any insert or remove.
+		T& operator[](int32 index) {
+			FATAL_ASSERT(index >= 0 && index < count, u8"index out of bounds.");
+			return elements[index];
+		}
+		/// @brief Access the element without copying it. The reference is invalidated by any insert or remove.
+		const T& operator[](int32 index) const {
+			FATAL_ASSERT(index >= 0 && index < count, u8"index out of bounds.");
+			return elements[index];
+		}
+		void Set(int32 index, const T& value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			*(elements + index) = value;
+		}
+		void Set(int32 index, T&& value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			*(elements + index) = Memory::Move(value);
+		}
+		void Add(const T& value) {
+			Emplace(value);
+		}
+		void Add(T&& value) {
+			Emplace(Memory::Move(value));
+		}
+		/// @brief Construct a new element at the end from the arguments.
+		/// @return The new element.
+		template<typename ... Args>
+		T& Emplace(Args&& ... args) {
+			if (count < capacity) {
+				Memory::Construct(elements + count, Memory::Forward<Args>(args)...);
+			} else {
+				// The arguments may refer to an element, build the value before the storage moves.
+				T value(Memory::Forward<Args>(args)...);
+				RequireCapacity(count + 1);
+				Memory::Construct(elements + count, Memory::Move(value));
+			}
+			count += 1;
+			return elements[count - 1];
+		}
+		void Insert(int32 index, const T& value) {
+			ERR_ASSERT(index >= 0 && index <= count, u8"index out of bounds.", return);
+			EmplaceAt(index, value);
+		}
+		void Insert(int32 index, T&& value) {
+			ERR_ASSERT(index >= 0 && index <= count, u8"index out of bounds.", return);
+			EmplaceAt(index, Memory::Move(value));
+		}
+		/// @brief Construct a new element at the index from the arguments, elements after it are shifted back.
+		/// @return The new element.
+		template<typename ... Args>
+		T& EmplaceAt(int32 index, Args&& ... args) {
+			FATAL_ASSERT(index >= 0 && index <= count, u8"index out of bounds.");
+
+			if (index == count) {
+				return Emplace(Memory::Forward<Args>(args)...);
+			}
+
+			// The arguments may refer to an element, build the value before shifting.
+			T value(Memory::Forward<Args>(args)...);
+			RequireCapacity(count + 1);
+
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				std::memmove(elements + index + 1, elements + index, (count - index) * sizeof(T));
+				Memory::Construct(elements + index, Memory::Move(value));
+			} else {
+				Memory::Construct(elements + count, Memory::Move(*(elements + count - 1)));
+				for (int32 i = count - 1; i > index; i -= 1) {
+					*(elements + i) = Memory::Move(*(elements + i - 1));
+				}
+				*(elements + index) = Memory::Move(value);
+			}
+
+			count += 1;
+			return elements[index];
+		}
+		void RemoveAt(int32 index) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds", return);
+
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				std::memmove(elements + index, elements + index + 1, (count - index - 1) * sizeof(T));
+			} else {
+				for (int32 i = index; i < count - 1; i += 1) {
+					*(elements + i) = Memory::Move(*(elements + i + 1));
+				}
+
+				// Destruct the last element.
+				Memory::Destruct(elements + count - 1);
+			}
+
+			count -= 1;
+		}
+		void Clear() {
+			for (int32 i = 0; i < count; i += 1) {
+				Memory::Destruct(elements + i);
+			}
+			count = 0;
+		}
+		/// @brief Get the raw element pointer for high performance operation, if you know what you are doing.\n
+		/// Only read or write existing elements. Do not insert or remove.
+		/// The element pointer can vary after an insert or remove operation, or after the list is moved!
+		T* GetRawElementPtr() const {
+			return elements;
+		}
+
+		Iterator begin() const {
+			return Iterator(elements);
+		}
+		Iterator end() const {
+			return Iterator(elements + count);
+		}
+	private:
+		T* GetInlineElements() const {
+			return (T*)inlineElements;
+		}
+		void CopyFromOther(const SmallList& obj) {
+			SetCapacity(obj.capacity);
+			for (int32 i = 0; i < obj.count; i += 1) {
+				Memory::Construct(elements + i, *(obj.elements + i));
+			}
+			count = obj.count;
+		}
+		/// @brief Take the elements of the other list, which has the same allocator and is left empty and inline.
+		void TakeFromOther(SmallList& obj) {
+			if (obj.IsInline()) {
+				std::memcpy((void*)elements, (void*)obj.elements, obj.count * sizeof(T));
+			} else {
+				elements = obj.elements;
+				capacity = obj.capacity;
+				obj.elements = obj.GetInlineElements();
+				obj.capacity = N;
+			}
+			count = obj.count;
+			obj.count = 0;
+		}
+		void Destroy() {
+			Clear();
+			if (!IsInline()) {
+				Allocator::DeallocateTo(allocator, elements, capacity * sizeof(T));
+				elements = GetInlineElements();
+				capacity = N;
+			}
+		}
+
+		alignas(T) byte inlineElements[N * sizeof(T)];
+		T* elements = GetInlineElements();
+		int32 capacity = N;
+		int32 count = 0;
+		Allocator* allocator = nullptr;
+	};
+}
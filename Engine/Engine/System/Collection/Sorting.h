@@ -0,0 +1,303 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
+#include <type_traits>
+#include <cstring>
+
+namespace Engine {
+	/// @brief The default comparator of Sorting, uses `operator<`.\n
+	/// The two sides may differ in type, for looking up keys by another type.
+	struct SortLess {
+		template<typename A, typename B>
+		bool operator()(const A& a, const B& b) const {
+			return a < b;
+		}
+	};
+
+	/// @brief Sorting algorithms over plain arrays, used by List and JobSystem::ParallelSort().\n
+	/// A comparator is called as `compare(a, b)` and returns true if a goes before b.
+	class Sorting final {
+	public:
+		STATIC_CLASS(Sorting);
+
+		/// @brief Ranges up to this size are finished with insertion sort.
+		static inline constexpr int32 InsertionThreshold = 16;
+
+		/// @brief Introsort: quicksort with median-of-three pivots, falling back to heapsort when it recurses too deep.\n
+		/// Not stable, doesn't allocate.
+		template<typename T, typename Compare = SortLess>
+		static void Sort(T* data, int32 count, const Compare& compare = Compare()) {
+			if (count <= 1) {
+				return;
+			}
+			int32 depth = 0;
+			for (int32 n = count; n > 1; n >>= 1) {
+				depth += 2;
+			}
+			Introsort(data, count, depth, compare);
+		}
+
+		/// @brief Merge sort, keeps the order of equal elements.\n
+		/// Allocates a buffer for half of the elements from the allocator.
+		template<typename T, typename Compare = SortLess>
+		static void StableSort(T* data, int32 count, const Compare& compare = Compare(), Allocator* allocator = nullptr) {
+			if (count <= InsertionThreshold) {
+				InsertionSort(data, count, compare);
+				return;
+			}
+			int32 bufferCount = (count + 1) / 2;
+			T* buffer = (T*)Allocator::AllocateFrom(allocator, sizeof(T) * bufferCount, alignof(T));
+			MergeSort(data, count, buffer, compare);
+			Allocator::DeallocateTo(allocator, buffer, sizeof(T) * bufferCount);
+		}
+
+		/// @brief Merge the sorted ranges [0, middle) and [middle, count) in place, keeping the order of equal elements.
+		/// @param buffer Uninitialized storage for at least middle elements.
+		template<typename T, typename Compare = SortLess>
+		static void Merge(T* data, int32 middle, int32 count, T* buffer, const Compare& compare = Compare()) {
+			if (middle <= 0 || middle >= count || !compare(data[middle], data[middle - 1])) {
+				// Already in order.
+				return;
+			}
+
+			for (int32 i = 0; i < middle; i += 1) {
+				Memory::Construct(buffer + i, Memory::Move(data[i]));
+			}
+			int32 left = 0;
+			int32 right = middle;
+			int32 target = 0;
+			while (left < middle && right < count) {
+				if (compare(data[right], buffer[left])) {
+					data[target] = Memory::Move(data[right]);
+					right += 1;
+				} else {
+					data[target] = Memory::Move(buffer[left]);
+					left += 1;
+				}
+				target += 1;
+			}
+			while (left < middle) {
+				data[target] = Memory::Move(buffer[left]);
+				left += 1;
+				target += 1;
+			}
+			for (int32 i = 0; i < middle; i += 1) {
+				Memory::Destruct(buffer + i);
+			}
+		}
+
+		/// @brief LSD radix sort by an integer or floating point key, keeps the order of equal keys.\n
+		/// Sorts (key, index) pairs a byte at a time, skipping bytes all keys share, then moves every element once.\n
+		/// Floating point keys sort as `operator<` does, except that -0 goes before +0. NaNs are not supported.
+		/// @param keyOf Called once per element as `keyOf(element)`, returns the key.
+		template<typename T, typename KeyOf>
+		static void RadixSort(T* data, int32 count, const KeyOf& keyOf, Allocator* allocator = nullptr) {
+			using Key = decltype(ToRadixKey(keyOf(data[0])));
+			struct Item {
+				Key key;
+				int32 index;
+			};
+			constexpr int32 ByteCount = (int32)sizeof(Key);
+
+			if (count <= 1) {
+				return;
+			}
+
+			Item* items = (Item*)Allocator::AllocateFrom(allocator, sizeof(Item) * count * 2, alignof(Item));
+			Item* swap = items + count;
+
+			// Gather the keys and the histograms of all the bytes in one go.
+			int32 histograms[ByteCount][256] = {};
+			for (int32 i = 0; i < count; i += 1) {
+				Key key = ToRadixKey(keyOf(data[i]));
+				items[i].key = key;
+				items[i].index = i;
+				for (int32 b = 0; b < ByteCount; b += 1) {
+					histograms[b][(key >> (b * 8)) & 0xFF] += 1;
+				}
+			}
+
+			for (int32 b = 0; b < ByteCount; b += 1) {
+				int32* histogram = histograms[b];
+				if (histogram[(items[0].key >> (b * 8)) & 0xFF] == count) {
+					// Every key has the same byte here.
+					continue;
+				}
+
+				int32 offset = 0;
+				for (int32 i = 0; i < 256; i += 1) {
+					int32 n = histogram[i];
+					histogram[i] = offset;
+					offset += n;
+				}
+				for (int32 i = 0; i < count; i += 1) {
+					int32 digit = (int32)((items[i].key >> (b * 8)) & 0xFF);
+					swap[histogram[digit]] = items[i];
+					histogram[digit] += 1;
+				}
+				Item* temp = items;
+				items = swap;
+				swap = temp;
+			}
+
+			// Move the elements into place through a buffer.
+			T* buffer = (T*)Allocator::AllocateFrom(allocator, sizeof(T) * count, alignof(T));
+			for (int32 i = 0; i < count; i += 1) {
+				Memory::Construct(buffer + i, Memory::Move(data[items[i].index]));
+			}
+			for (int32 i = 0; i < count; i += 1) {
+				data[i] = Memory::Move(buffer[i]);
+				Memory::Destruct(buffer + i);
+			}
+			Allocator::DeallocateTo(allocator, buffer, sizeof(T) * count);
+
+			Allocator::DeallocateTo(allocator, (items < swap ? items : swap), sizeof(Item) * count * 2);
+		}
+
+		/// @brief Map a key to an unsigned integer of the same order, so it can be sorted byte by byte.
+		template<typename K>
+		static auto ToRadixKey(K key) {
+			static_assert(std::is_arithmetic_v<K>, "Radix sort keys need to be integers or floating point numbers.");
+			if constexpr (std::is_same_v<K, float>) {
+				uint32 bits;
+				std::memcpy(&bits, &key, sizeof(bits));
+				return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+			} else if constexpr (std::is_same_v<K, double>) {
+				uint64 bits;
+				std::memcpy(&bits, &key, sizeof(bits));
+				return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+			} else if constexpr (sizeof(K) <= sizeof(uint32)) {
+				if constexpr (std::is_signed_v<K>) {
+					return (uint32)(int32)key ^ 0x80000000u;
+				} else {
+					return (uint32)key;
+				}
+			} else {
+				if constexpr (std::is_signed_v<K>) {
+					return (uint64)(int64)key ^ 0x8000000000000000ull;
+				} else {
+					return (uint64)key;
+				}
+			}
+		}
+
+	private:
+		template<typename T, typename Compare>
+		static void InsertionSort(T* data, int32 count, const Compare& compare) {
+			for (int32 i = 1; i < count; i += 1) {
+				if (!compare(data[i], data[i - 1])) {
+					continue;
+				}
+				T value = Memory::Move(data[i]);
+				int32 j = i;
+				for (; j > 0 && compare(value, data[j - 1]); j -= 1) {
+					data[j] = Memory::Move(data[j - 1]);
+				}
+				data[j] = Memory::Move(value);
+			}
+		}
+
+		template<typename T>
+		static void Swap(T& a, T& b) {
+			T temp = Memory::Move(a);
+			a = Memory::Move(b);
+			b = Memory::Move(temp);
+		}
+
+		template<typename T, typename Compare>
+		static void Introsort(T* data, int32 count, int32 depth, const Compare& compare) {
+			while (count > InsertionThreshold) {
+				if (depth == 0) {
+					HeapSort(data, count, compare);
+					return;
+				}
+				depth -= 1;
+
+				// Put the median of the first, middle and last elements at the front as the pivot.
+				int32 middle = count / 2;
+				int32 last = count - 1;
+				if (compare(data[middle], data[0])) {
+					Swap(data[middle], data[0]);
+				}
+				if (compare(data[last], data[middle])) {
+					Swap(data[last], data[middle]);
+					if (compare(data[middle], data[0])) {
+						Swap(data[middle], data[0]);
+					}
+				}
+				Swap(data[0], data[middle]);
+
+				// Hoare partition around data[0], the ends act as sentinels.
+				int32 left = 0;
+				int32 right = count;
+				while (true) {
+					do {
+						left += 1;
+					} while (left < count && compare(data[left], data[0]));
+					do {
+						right -= 1;
+					} while (compare(data[0], data[right]));
+					if (left >= right) {
+						break;
+					}
+					Swap(data[left], data[right]);
+				}
+				Swap(data[0], data[right]);
+
+				// Recurse into the smaller side, loop on the larger one.
+				int32 leftCount = right;
+				int32 rightCount = count - right - 1;
+				if (leftCount < rightCount) {
+					Introsort(data, leftCount, depth, compare);
+					data += right + 1;
+					count = rightCount;
+				} else {
+					Introsort(data + right + 1, rightCount, depth, compare);
+					count = leftCount;
+				}
+			}
+			InsertionSort(data, count, compare);
+		}
+
+		template<typename T, typename Compare>
+		static void SiftDown(T* data, int32 root, int32 count, const Compare& compare) {
+			while (true) {
+				int32 child = root * 2 + 1;
+				if (child >= count) {
+					return;
+				}
+				if (child + 1 < count && compare(data[child], data[child + 1])) {
+					child += 1;
+				}
+				if (!compare(data[root], data[child])) {
+					return;
+				}
+				Swap(data[root], data[child]);
+				root = child;
+			}
+		}
+		template<typename T, typename Compare>
+		static void HeapSort(T* data, int32 count, const Compare& compare) {
+			for (int32 i = count / 2 - 1; i >= 0; i -= 1) {
+				SiftDown(data, i, count, compare);
+			}
+			for (int32 i = count - 1; i > 0; i -= 1) {
+				Swap(data[0], data[i]);
+				SiftDown(data, 0, i, compare);
+			}
+		}
+
+		template<typename T, typename Compare>
+		static void MergeSort(T* data, int32 count, T* buffer, const Compare& compare) {
+			if (count <= InsertionThreshold) {
+				InsertionSort(data, count, compare);
+				return;
+			}
+			int32 middle = (count + 1) / 2;
+			MergeSort(data, middle, buffer, compare);
+			MergeSort(data + middle, count - middle, buffer, compare);
+			Merge(data, middle, count, buffer, compare);
+		}
+	};
+}
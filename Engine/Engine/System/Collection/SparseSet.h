@@ -0,0 +1,216 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Object/InstanceId.h"
+#include "Engine/System/Memory/Allocator.h"
+#include "Engine/System/Debug.h"
+#include <cstring>
+
+namespace Engine {
+	/// @brief Values keyed by InstanceId, packed contiguously for iteration.\n
+	/// A sparse array indexed by InstanceId::GetIndex() points into the dense arrays of ids and values.
+	/// Add, Remove and lookups are O(1), removing moves the last value into the hole.\n
+	/// The dense index of a value changes when others are removed or swapped, and pointers to values are invalidated by Add and Remove.\n
+	/// Ids of the same slot with an older generation are treated as absent.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.\n
+	/// Copy construction uses the default allocator, copy assignment keeps the target's, moves take the allocator along.
+	/// @tparam T The value type. Needs to be copy-constructable and move-assignable.
+	template<typename T>
+	class SparseSet final {
+	public:
+		SparseSet(Allocator* allocator = nullptr) :ids(0, allocator), values(0, allocator), pages(0, allocator), allocator(allocator) {}
+		~SparseSet() {
+			DeallocatePages();
+		}
+
+		SparseSet(const SparseSet& obj) :ids(obj.ids), values(obj.values) {
+			CopyPagesFromOther(obj);
+		}
+		SparseSet& operator=(const SparseSet& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			ids = obj.ids;
+			values = obj.values;
+			DeallocatePages();
+			CopyPagesFromOther(obj);
+
+			return *this;
+		}
+		SparseSet(SparseSet&& obj) :ids(Memory::Move(obj.ids)), values(Memory::Move(obj.values)), pages(Memory::Move(obj.pages)), allocator(obj.allocator) {}
+		SparseSet& operator=(SparseSet&& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			DeallocatePages();
+			allocator = obj.allocator;
+			ids = Memory::Move(obj.ids);
+			values = Memory::Move(obj.values);
+			pages = Memory::Move(obj.pages);
+
+			return *this;
+		}
+
+		bool Add(const InstanceId& id, const T& value) {
+			return Emplace(id, value) != nullptr;
+		}
+		bool Add(const InstanceId& id, T&& value) {
+			return Emplace(id, Memory::Move(value)) != nullptr;
+		}
+		/// @brief Construct a value for the id at the end of the dense array.
+		/// @return The new value, nullptr if the id already exists.
+		template<typename ...Args>
+		T* Emplace(const InstanceId& id, Args&& ...args) {
+			ERR_ASSERT(id.IsValid(), u8"Invalid id.", return nullptr);
+			int32& position = GetPosition(id.GetIndex());
+			ERR_ASSERT(position < 0 || ids[position] != id, u8"Failed to add a value, the id already exists.", return nullptr);
+			// A stale id of the same slot may still be here, drop it first.
+			if (position >= 0) {
+				RemoveAt(position);
+			}
+
+			position = values.GetCount();
+			ids.Add(id);
+			return &values.Emplace(Memory::Forward<Args>(args)...);
+		}
+
+		bool Contains(const InstanceId& id) const {
+			return IndexOf(id) >= 0;
+		}
+		/// @brief Get the index of the id in the dense arrays, -1 if it doesn't exist.
+		int32 IndexOf(const InstanceId& id) const {
+			uint32 index = id.GetIndex();
+			uint32 page = index / PageSize;
+			if (page >= (uint32)pages.GetCount() || pages[page] == nullptr) {
+				return -1;
+			}
+			int32 position = pages[page][index % PageSize];
+			return (position >= 0 && ids[position] == id) ? position : -1;
+		}
+		/// @brief Get a pointer to the value without copying it, nullptr if the id doesn't exist.
+		T* Find(const InstanceId& id) const {
+			int32 position = IndexOf(id);
+			return position < 0 ? nullptr : values.GetRawElementPtr() + position;
+		}
+		bool Remove(const InstanceId& id) {
+			int32 position = IndexOf(id);
+			if (position < 0) {
+				return false;
+			}
+			RemoveAt(position);
+			return true;
+		}
+		/// @brief Remove the value at the dense index, moving the last value into its place.
+		void RemoveAt(int32 index) {
+			ERR_ASSERT(index >= 0 && index < GetCount(), u8"index out of bounds.", return);
+
+			int32 last = values.GetCount() - 1;
+			GetPosition(ids[index].GetIndex()) = -1;
+			if (index != last) {
+				GetPosition(ids[last].GetIndex()) = index;
+				ids.Set(index, ids[last]);
+				values.Set(index, Memory::Move(values[last]));
+			}
+			ids.RemoveAt(last);
+			values.RemoveAt(last);
+		}
+		/// @brief Swap two values in the dense arrays, such as for sorting them.
+		void Swap(int32 a, int32 b) {
+			ERR_ASSERT(a >= 0 && a < GetCount() && b >= 0 && b < GetCount(), u8"index out of bounds.", return);
+			if (a == b) {
+				return;
+			}
+
+			GetPosition(ids[a].GetIndex()) = b;
+			GetPosition(ids[b].GetIndex()) = a;
+			InstanceId id = ids[a];
+			ids.Set(a, ids[b]);
+			ids.Set(b, id);
+			T value = Memory::Move(values[a]);
+			values.Set(a, Memory::Move(values[b]));
+			values.Set(b, Memory::Move(value));
+		}
+		/// @brief Remove all values, the sparse pages are kept.
+		void Clear() {
+			for (int32 i = 0; i < ids.GetCount(); i += 1) {
+				GetPosition(ids[i].GetIndex()) = -1;
+			}
+			ids.Clear();
+			values.Clear();
+		}
+
+		int32 GetCount() const {
+			return values.GetCount();
+		}
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const {
+			return allocator;
+		}
+
+		InstanceId GetId(int32 index) const {
+			return ids.Get(index);
+		}
+		T& GetValue(int32 index) const {
+			FATAL_ASSERT(index >= 0 && index < GetCount(), u8"index out of bounds.");
+			return values.GetRawElementPtr()[index];
+		}
+		/// @brief The dense ids, in the same order as the values.
+		const InstanceId* GetIds() const {
+			return ids.GetRawElementPtr();
+		}
+		/// @brief The dense values, valid until the next Add or Remove.
+		T* GetValues() const {
+			return values.GetRawElementPtr();
+		}
+
+		T* begin() const {
+			return values.GetRawElementPtr();
+		}
+		T* end() const {
+			return values.GetRawElementPtr() + values.GetCount();
+		}
+
+		/// @brief Sparse entries per page, pages are allocated once an id index falls into them.
+		static inline constexpr int32 PageSize = 4096;
+
+	private:
+		int32& GetPosition(uint32 index) {
+			uint32 page = index / PageSize;
+			while ((uint32)pages.GetCount() <= page) {
+				pages.Add(nullptr);
+			}
+			if (pages[page] == nullptr) {
+				int32* data = (int32*)Allocator::AllocateFrom(allocator, PageSize * sizeof(int32), alignof(int32));
+				std::memset(data, -1, PageSize * sizeof(int32));
+				pages.Set(page, data);
+			}
+			return pages[page][index % PageSize];
+		}
+
+		void CopyPagesFromOther(const SparseSet& obj) {
+			for (int32 i = 0; i < obj.pages.GetCount(); i += 1) {
+				int32* data = nullptr;
+				if (obj.pages[i] != nullptr) {
+					data = (int32*)Allocator::AllocateFrom(allocator, PageSize * sizeof(int32), alignof(int32));
+					std::memcpy(data, obj.pages[i], PageSize * sizeof(int32));
+				}
+				pages.Add(data);
+			}
+		}
+		void DeallocatePages() {
+			for (int32 i = 0; i < pages.GetCount(); i += 1) {
+				if (pages[i] != nullptr) {
+					Allocator::DeallocateTo(allocator, pages[i], PageSize * sizeof(int32));
+				}
+			}
+			pages.Clear();
+		}
+
+		List<InstanceId> ids;
+		List<T> values;
+		List<int32*> pages;
+		Allocator* allocator = nullptr;
+	};
+}
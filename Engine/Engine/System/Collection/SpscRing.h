@@ -0,0 +1,141 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Debug.h"
+#include <atomic>
+
+namespace Engine {
+	/// @brief A fixed capacity lock-free ring buffer for one producer thread and one consumer thread.\n
+	/// Only the producer may call Push(), Emplace() and PushBatch(), only the consumer may call Pop() and PopBatch().\n
+	/// Each side caches the other side's index and only reloads it when the ring looks full or empty.\n
+	/// Storage comes from the Allocator given on construction, or from Memory by default.
+	/// @tparam T The value type. Needs to be move-constructable and move-assignable.
+	template<typename T>
+	class SpscRing final {
+	public:
+		static inline constexpr int32 DefaultCapacity = 1024;
+
+		/// @param capacity Will be rounded up to the power of 2.
+		SpscRing(int32 capacity = DefaultCapacity, Allocator* allocator = nullptr) :allocator(allocator) {
+			ERR_ASSERT(capacity > 0, u8"capacity must be larger than 0.", capacity = DefaultCapacity);
+
+			uint64 size = 1;
+			while (size < (uint64)capacity) {
+				size <<= 1;
+			}
+			mask = size - 1;
+			slots = (T*)Allocator::AllocateFrom(allocator, sizeof(T) * size, alignof(T));
+		}
+		~SpscRing() {
+			uint64 t = tail.load(std::memory_order_relaxed);
+			for (uint64 h = head.load(std::memory_order_relaxed); h != t; h += 1) {
+				Memory::Destruct(slots + (h & mask));
+			}
+			Allocator::DeallocateTo(allocator, slots, sizeof(T) * (mask + 1));
+		}
+		SpscRing(const SpscRing&) = delete;
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		/// @brief Producer only.
+		/// @return false when the ring is full.
+		bool Push(const T& value) {
+			return Emplace(value);
+		}
+		/// @brief Producer only. value is left untouched when the ring is full.
+		/// @return false when the ring is full.
+		bool Push(T&& value) {
+			return Emplace(Memory::Move(value));
+		}
+		/// @brief Construct a value in place at the back. Producer only.
+		/// @return false when the ring is full.
+		template<typename ...Args>
+		bool Emplace(Args&& ...args) {
+			uint64 t = tail.load(std::memory_order_relaxed);
+			if (GetFreeCount(t) == 0) {
+				return false;
+			}
+			Memory::Construct(slots + (t & mask), Memory::Forward<Args>(args)...);
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+		/// @brief Push as many of the values as fit, publishing them at once. Producer only.
+		/// @return The count of values pushed, counted from the first.
+		int32 PushBatch(const T* values, int32 count) {
+			uint64 t = tail.load(std::memory_order_relaxed);
+			uint64 n = GetFreeCount(t);
+			n = (n < (uint64)count ? n : (uint64)count);
+			for (uint64 i = 0; i < n; i += 1) {
+				Memory::Construct(slots + ((t + i) & mask), values[i]);
+			}
+			tail.store(t + n, std::memory_order_release);
+			return (int32)n;
+		}
+
+		/// @brief Move the oldest value into result. Consumer only.
+		/// @return false when the ring is empty.
+		bool Pop(T& result) {
+			uint64 h = head.load(std::memory_order_relaxed);
+			if (GetReadyCount(h) == 0) {
+				return false;
+			}
+			T* slot = slots + (h & mask);
+			result = Memory::Move(*slot);
+			Memory::Destruct(slot);
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+		/// @brief Move up to maxCount of the oldest values into results, releasing their slots at once. Consumer only.
+		/// @return The count of values popped.
+		int32 PopBatch(T* results, int32 maxCount) {
+			uint64 h = head.load(std::memory_order_relaxed);
+			uint64 n = GetReadyCount(h);
+			n = (n < (uint64)maxCount ? n : (uint64)maxCount);
+			for (uint64 i = 0; i < n; i += 1) {
+				T* slot = slots + ((h + i) & mask);
+				results[i] = Memory::Move(*slot);
+				Memory::Destruct(slot);
+			}
+			head.store(h + n, std::memory_order_release);
+			return (int32)n;
+		}
+
+		/// @brief Get an approximate value count. Exact when called by either side with the other one idle.
+		int32 GetCount() const {
+			uint64 t = tail.load(std::memory_order_acquire);
+			uint64 h = head.load(std::memory_order_acquire);
+			return t > h ? (int32)(t - h) : 0;
+		}
+		int32 GetCapacity() const {
+			return (int32)(mask + 1);
+		}
+
+	private:
+		uint64 GetFreeCount(uint64 t) {
+			uint64 free = mask + 1 - (t - cachedHead);
+			if (free == 0) {
+				cachedHead = head.load(std::memory_order_acquire);
+				free = mask + 1 - (t - cachedHead);
+			}
+			return free;
+		}
+		uint64 GetReadyCount(uint64 h) {
+			uint64 ready = cachedTail - h;
+			if (ready == 0) {
+				cachedTail = tail.load(std::memory_order_acquire);
+				ready = cachedTail - h;
+			}
+			return ready;
+		}
+
+		// The producer side, the consumer side and the shared read-only data each get their own cache line.
+		alignas(ThreadUtil::CacheLineSize) std::atomic<uint64> tail{ 0 };
+		uint64 cachedHead = 0;
+		alignas(ThreadUtil::CacheLineSize) std::atomic<uint64> head{ 0 };
+		uint64 cachedTail = 0;
+		alignas(ThreadUtil::CacheLineSize) T* slots = nullptr;
+		uint64 mask = 0;
+		Allocator* allocator = nullptr;
+	};
+}
@@ -0,0 +1,282 @@
+#include "Engine/System/CompressedStream.h"
+#include "Engine/System/Compression/Lz4.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+
+namespace Engine {
+	namespace {
+		/// @brief Bigger blocks would let the compressed size of a block overflow.
+		constexpr int32 MaxBlockSize = 1 << 24;
+	}
+
+	CompressedStream::CompressedStream(const IntrusivePtr<Stream>& stream, Mode mode, Codec codec, int32 blockSize) :stream(stream), mode(mode), codec(codec), blockSize(blockSize) {
+		ERR_ASSERT(blockSize > 0 && blockSize <= MaxBlockSize, u8"blockSize must be greater than 0 and up to 16 MiB.", this->blockSize = DefaultBlockSize);
+		ERR_ASSERT(codec >= Codec::None && codec < Codec::End, u8"codec is invalid.", this->codec = Codec::Lz4);
+		ERR_ASSERT(stream.GetRaw() != nullptr && stream->IsValid(), u8"The stream is not valid.", return);
+		ERR_ASSERT(Stream::LocalEndianness == Stream::Endianness::Little, u8"Compressed frames are only handled on little-endian machines.", return);
+
+		if (mode == Mode::Compress) {
+			ERR_ASSERT(stream->CanWrite(), u8"The stream cannot write.", return);
+			valid = true;
+			return;
+		}
+		ERR_ASSERT(stream->CanRead() && stream->CanRandomAccess(), u8"Decompressing needs a stream that can read with random access.", return);
+		valid = ReadFrame() == ResultCode::OK;
+	}
+	CompressedStream::~CompressedStream() {
+		if (IsValid() && mode == Mode::Compress) {
+			FinishFrame();
+		}
+	}
+
+	void CompressedStream::Close() {
+		if (!IsValid()) {
+			return;
+		}
+		if (mode == Mode::Compress) {
+			FinishFrame();
+		}
+		stream->Close();
+		valid = false;
+		block.Clear();
+		cachedBlock = -1;
+	}
+	bool CompressedStream::IsValid() const {
+		return valid && stream->IsValid();
+	}
+	bool CompressedStream::CanRead() const {
+		return IsValid() && mode == Mode::Decompress;
+	}
+	bool CompressedStream::CanWrite() const {
+		return IsValid() && mode == Mode::Compress;
+	}
+	bool CompressedStream::CanRandomAccess() const {
+		return mode == Mode::Decompress;
+	}
+
+	ResultCode CompressedStream::SetPosition(int64 position) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return ResultCode::InvalidStream);
+		ERR_ASSERT(mode == Mode::Decompress, u8"Cannot seek while compressing.", return ResultCode::NotSupported);
+		ERR_ASSERT(position >= 0 && position <= length, u8"position out of the stream.", return ResultCode::InvalidArgument);
+		this->position = position;
+		return ResultCode::OK;
+	}
+	int64 CompressedStream::GetPosition() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return -1);
+		return position;
+	}
+	int64 CompressedStream::GetLength() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return -1);
+		return length;
+	}
+
+	int32 CompressedStream::GetBlockSize() const {
+		return blockSize;
+	}
+	int32 CompressedStream::GetBlockCount() const {
+		return storedSizes.GetCount();
+	}
+	CompressedStream::Codec CompressedStream::GetCodec() const {
+		return codec;
+	}
+
+	ResultCode CompressedStream::ReadAll(List<byte>& result, JobSystem* jobSystem) {
+		ERR_ASSERT(CanRead(), u8"This stream cannot read.", return ResultCode::NoPermission);
+		ERR_ASSERT(length - position <= INT32_MAX - result.GetCount(), u8"The rest of the stream is too long for a List.", return ResultCode::NotSupported);
+		// The rest of the current block as usual, then the whole blocks after it at once.
+		int32 first = (int32)((position + blockSize - 1) / blockSize);
+		int32 head = (int32)((first < GetBlockCount() ? (int64)first * blockSize : length) - position);
+		int64 storedLength = blockOffsets[GetBlockCount()] - blockOffsets[first < GetBlockCount() ? first : GetBlockCount()];
+		ERR_ASSERT(storedLength <= INT32_MAX, u8"The compressed blocks are too long to read at once.", return ResultCode::NotSupported);
+
+		int32 start = result.GetCount();
+		result.SetCount(start + (int32)(length - position));
+		if (head > 0 && ReadBytesUnchecked(result.GetRawElementPtr() + start, head) != head) {
+			result.SetCount(start);
+			return ResultCode::UnknownError;
+		}
+		if (first >= GetBlockCount()) {
+			return ResultCode::OK;
+		}
+
+		stream->SetPosition(frameStart + blockOffsets[first]);
+		const byte* stored = nullptr;
+		List<byte> storedCopy{};
+		if (stream->CanReadSpan()) {
+			ByteSpan span = stream->ReadSpan((int32)storedLength);
+			stored = span.length == storedLength ? span.data : nullptr;
+		} else if (stream->ReadBytes((int32)storedLength, storedCopy) == storedLength) {
+			stored = storedCopy.GetRawElementPtr();
+		}
+		if (stored == nullptr) {
+			result.SetCount(start);
+			return ResultCode::UnknownError;
+		}
+
+		byte* output = result.GetRawElementPtr() + start + head;
+		std::atomic<bool> failed{ false };
+		auto decode = [this, first, stored, output, &failed](int32 index) {
+			const byte* source = stored + (blockOffsets[index] - blockOffsets[first]);
+			if (!DecodeBlock(index, source, output + (int64)(index - first) * blockSize)) {
+				failed.store(true, std::memory_order_relaxed);
+			}
+		};
+		if (jobSystem != nullptr && jobSystem->IsRunning()) {
+			jobSystem->ParallelFor(first, GetBlockCount(), 1, decode);
+		} else {
+			for (int32 i = first; i < GetBlockCount(); i += 1) {
+				decode(i);
+			}
+		}
+		position = length;
+		if (failed.load(std::memory_order_relaxed)) {
+			result.SetCount(start);
+			return ResultCode::UnknownError;
+		}
+		return ResultCode::OK;
+	}
+
+	ResultCode CompressedStream::WriteBytesUnchecked(const byte* valuePtr, int32 length) {
+		ERR_ASSERT(mode == Mode::Compress, u8"Cannot write while decompressing.", return ResultCode::NoPermission);
+		while (length > 0) {
+			int32 count = block.GetCount();
+			int32 size = blockSize - count < length ? blockSize - count : length;
+			block.SetCount(count + size);
+			std::memcpy(block.GetRawElementPtr() + count, valuePtr, size);
+			valuePtr += size;
+			length -= size;
+			position += size;
+			this->length += size;
+			if (block.GetCount() == blockSize) {
+				ResultCode r = WriteBlock();
+				if (r != ResultCode::OK) {
+					return r;
+				}
+			}
+		}
+		return ResultCode::OK;
+	}
+	int32 CompressedStream::ReadBytesUnchecked(byte* buffer, int32 length) {
+		ERR_ASSERT(mode == Mode::Decompress, u8"Cannot read while compressing.", return 0);
+		int32 done = 0;
+		while (done < length && position < this->length) {
+			int32 index = (int32)(position / blockSize);
+			if (!LoadBlock(index)) {
+				break;
+			}
+			int32 offset = (int32)(position - (int64)index * blockSize);
+			int32 size = block.GetCount() - offset < length - done ? block.GetCount() - offset : length - done;
+			std::memcpy(buffer + done, block.GetRawElementPtr() + offset, size);
+			position += size;
+			done += size;
+		}
+		return done;
+	}
+
+	ResultCode CompressedStream::ReadFrame() {
+		frameStart = stream->GetPosition();
+		int64 end = stream->GetLength();
+		ERR_ASSERT(frameStart >= 0 && end - frameStart >= (int64)sizeof(Footer), u8"The stream is too short for a compressed frame.", return ResultCode::InvalidArgument);
+
+		Footer footer{};
+		stream->SetPosition(end - (int64)sizeof(Footer));
+		ERR_ASSERT(stream->ReadBytes((byte*)&footer, sizeof(Footer)) == sizeof(Footer), u8"Cannot read the footer of the frame.", return ResultCode::UnknownError);
+		bool known = footer.magic == Magic && footer.codec < (uint32)Codec::End && footer.blockSize > 0 && footer.blockSize <= (uint32)MaxBlockSize;
+		ERR_ASSERT(known, u8"The stream doesn't end with a compressed frame.", return ResultCode::InvalidArgument);
+		uint64 blockCount = (footer.length + footer.blockSize - 1) / footer.blockSize;
+		int64 indexStart = end - (int64)sizeof(Footer) - (int64)footer.blockCount * (int64)sizeof(uint32);
+		ERR_ASSERT(blockCount == footer.blockCount && footer.blockCount <= INT32_MAX / sizeof(uint32) && indexStart >= frameStart, u8"The blocks of the frame don't match its length.", return ResultCode::InvalidArgument);
+
+		codec = (Codec)footer.codec;
+		blockSize = (int32)footer.blockSize;
+		length = (int64)footer.length;
+		storedSizes.SetCount((int32)footer.blockCount);
+		stream->SetPosition(indexStart);
+		int32 indexLength = storedSizes.GetCount() * (int32)sizeof(uint32);
+		ERR_ASSERT(stream->ReadBytes((byte*)storedSizes.GetRawElementPtr(), indexLength) == indexLength, u8"Cannot read the index of the frame.", return ResultCode::UnknownError);
+
+		blockOffsets.SetCount(storedSizes.GetCount() + 1);
+		blockOffsets[0] = 0;
+		for (int32 i = 0; i < storedSizes.GetCount(); i += 1) {
+			uint32 stored = storedSizes[i];
+			bool raw = (stored & RawBlockFlag) != 0;
+			stored &= ~RawBlockFlag;
+			ERR_ASSERT(!raw || (int32)stored == GetBlockLength(i), u8"A stored block of the frame has the wrong size.", return ResultCode::InvalidArgument);
+			blockOffsets[i + 1] = blockOffsets[i] + stored;
+		}
+		ERR_ASSERT(blockOffsets[storedSizes.GetCount()] == indexStart - frameStart, u8"The blocks of the frame don't fill it.", return ResultCode::InvalidArgument);
+		return ResultCode::OK;
+	}
+	ResultCode CompressedStream::WriteBlock() {
+		int32 count = block.GetCount();
+		if (count == 0) {
+			return ResultCode::OK;
+		}
+		const byte* data = block.GetRawElementPtr();
+		uint32 stored = (uint32)count | RawBlockFlag;
+		if (codec == Codec::Lz4) {
+			scratch.SetCount(Lz4::GetMaxCompressedSize(count));
+			int32 compressed = Lz4::Compress(data, count, scratch.GetRawElementPtr(), scratch.GetCount());
+			if (compressed > 0 && compressed < count) {
+				data = scratch.GetRawElementPtr();
+				stored = (uint32)compressed;
+			}
+		}
+		storedSizes.Add(stored);
+		block.Clear();
+		return stream->WriteBytes(data, (int32)(stored & ~RawBlockFlag));
+	}
+	ResultCode CompressedStream::FinishFrame() {
+		ResultCode r = WriteBlock();
+		if (r != ResultCode::OK) {
+			return r;
+		}
+		r = stream->WriteBytes((const byte*)storedSizes.GetRawElementPtr(), storedSizes.GetCount() * (int32)sizeof(uint32));
+		if (r != ResultCode::OK) {
+			return r;
+		}
+		Footer footer{ (uint64)length, (uint32)blockSize, (uint32)storedSizes.GetCount(), (uint32)codec, Magic };
+		return stream->WriteBytes((const byte*)&footer, sizeof(Footer));
+	}
+
+	bool CompressedStream::LoadBlock(int32 index) {
+		if (cachedBlock == index) {
+			return true;
+		}
+		cachedBlock = -1;
+		int32 stored = (int32)(storedSizes[index] & ~RawBlockFlag);
+		block.SetCount(GetBlockLength(index));
+		stream->SetPosition(frameStart + blockOffsets[index]);
+
+		const byte* source = nullptr;
+		if (stream->CanReadSpan()) {
+			ByteSpan span = stream->ReadSpan(stored);
+			source = span.length == stored ? span.data : nullptr;
+		} else {
+			scratch.Clear();
+			source = stream->ReadBytes(stored, scratch) == stored ? scratch.GetRawElementPtr() : nullptr;
+		}
+		ERR_ASSERT(source != nullptr && DecodeBlock(index, source, block.GetRawElementPtr()), u8"Cannot decompress a block of the frame.", return false);
+		cachedBlock = index;
+		return true;
+	}
+	bool CompressedStream::DecodeBlock(int32 index, const byte* stored, byte* result) const {
+		uint32 size = storedSizes[index];
+		int32 blockLength = GetBlockLength(index);
+		if ((size & RawBlockFlag) != 0) {
+			std::memcpy(result, stored, blockLength);
+			return true;
+		}
+		switch (codec) {
+			case Codec::Lz4:
+				return Lz4::Decompress(stored, (int32)size, result, blockLength) == blockLength;
+			default:
+				return false;
+		}
+	}
+	int32 CompressedStream::GetBlockLength(int32 index) const {
+		return index == storedSizes.GetCount() - 1 ? (int32)(length - (int64)index * blockSize) : blockSize;
+	}
+}
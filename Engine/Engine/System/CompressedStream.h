@@ -0,0 +1,99 @@
+#pragma once
+#include "Engine/System/Stream.h"
+#include "Engine/System/Memory/IntrusivePtr.h"
+
+namespace Engine {
+	class JobSystem;
+
+	/// @brief Compresses what is written to another Stream, or decompresses what is read from it, a block at a time.\n
+	/// The frame is the compressed blocks, the stored size of each, then a footer, so the blocks are independent:
+	/// reading seeks to the block holding a position and decompresses only that one, and ReadAll() decompresses them all in parallel.\n
+	/// Reading finds the footer at the end of the stream, which needs random access. Writing is sequential, Close() writes the footer.
+	class CompressedStream final :public Stream {
+		REFLECTION_CLASS(::Engine::CompressedStream, ::Engine::Stream) {}
+
+	public:
+		enum class Mode :byte {
+			Compress,
+			Decompress,
+		};
+		enum class Codec :byte {
+			/// @brief Stored as they are, for data already compressed.
+			None,
+			/// @brief See Lz4.
+			Lz4,
+			/// @brief End of the codec enum.
+			End,
+		};
+		static inline constexpr int32 DefaultBlockSize = 65536;
+		static inline constexpr uint32 Magic = 0x4B4C4243; // "CBLK"
+
+		/// @param stream Compress: written from its current position. Decompress: holds a frame up to its end, from its current position.
+		/// @param codec Only used to compress, the frame tells the one to decompress with.
+		CompressedStream(const IntrusivePtr<Stream>& stream, Mode mode, Codec codec = Codec::Lz4, int32 blockSize = DefaultBlockSize);
+		~CompressedStream();
+
+		/// @brief Finish the frame when compressing, then close the underlying stream.
+		void Close() override;
+		bool IsValid() const override;
+		bool CanRead() const override;
+		bool CanWrite() const override;
+		/// @brief Only when decompressing.
+		bool CanRandomAccess() const override;
+
+		ResultCode SetPosition(int64 position) override;
+		int64 GetPosition() const override;
+		/// @brief The decompressed length.
+		int64 GetLength() const override;
+
+		int32 GetBlockSize() const;
+		int32 GetBlockCount() const;
+		Codec GetCodec() const;
+		/// @brief Decompress the rest of the stream onto the end of the result, the blocks in parallel on the job system.
+		/// @param jobSystem nullptr to decompress on the calling thread.
+		ResultCode ReadAll(List<byte>& result, JobSystem* jobSystem = nullptr);
+
+	protected:
+		ResultCode WriteBytesUnchecked(const byte* valuePtr, int32 length) override;
+		int32 ReadBytesUnchecked(byte* buffer, int32 length) override;
+
+	private:
+		struct Footer {
+			uint64 length;
+			uint32 blockSize;
+			uint32 blockCount;
+			uint32 codec;
+			uint32 magic;
+		};
+		/// @brief Set in the stored size of a block kept as it is, because compressing made it bigger.
+		static inline constexpr uint32 RawBlockFlag = 0x80000000u;
+
+		ResultCode ReadFrame();
+		ResultCode WriteBlock();
+		ResultCode FinishFrame();
+		/// @brief Decompress the block into the cache, if it isn't there already.
+		bool LoadBlock(int32 block);
+		/// @brief Decompress the stored bytes of the block into a buffer of its decompressed size.
+		bool DecodeBlock(int32 block, const byte* stored, byte* result) const;
+		int32 GetBlockLength(int32 block) const;
+
+		IntrusivePtr<Stream> stream{};
+		Mode mode;
+		Codec codec;
+		int32 blockSize;
+		bool valid = false;
+
+		/// @brief The position of the frame in the underlying stream.
+		int64 frameStart = 0;
+		int64 length = 0;
+		int64 position = 0;
+		/// @brief Stored sizes with RawBlockFlag, and where each block starts in the frame, one more for the end.
+		List<uint32> storedSizes{};
+		List<int64> blockOffsets{};
+
+		/// @brief Compress: the pending bytes of the block. Decompress: the block cachedBlock.
+		List<byte> block{};
+		int32 cachedBlock = -1;
+		List<byte> scratch{};
+	};
+}
@@ -0,0 +1,183 @@
+#include "Engine/System/Compression/Lz4.h"
+#include <cstring>
+
+namespace Engine {
+	namespace {
+		constexpr int32 MinMatch = 4;
+		/// @brief The last bytes of a block are always literals.
+		constexpr int32 LastLiterals = 5;
+		/// @brief No match starts this close to the end of a block.
+		constexpr int32 MatchStartLimit = 12;
+		constexpr int32 MaxOffset = 65535;
+		constexpr int32 HashBits = 12;
+
+		uint32 Read32(const byte* ptr) {
+			uint32 value;
+			std::memcpy(&value, ptr, sizeof(value));
+			return value;
+		}
+		uint32 Hash(uint32 sequence) {
+			return (sequence * 2654435761u) >> (32 - HashBits);
+		}
+		/// @brief Write a length past the 4 bits of the token.
+		byte* WriteLength(byte* output, int32 length) {
+			for (; length >= 255; length -= 255) {
+				*output++ = 255;
+			}
+			*output++ = (byte)length;
+			return output;
+		}
+		/// @brief Read a length past the 4 bits of the token.
+		/// @return false if the input ends first.
+		bool ReadLength(const byte*& input, const byte* inputEnd, int32& length) {
+			byte part = 255;
+			while (part == 255) {
+				if (input >= inputEnd) {
+					return false;
+				}
+				part = *input++;
+				length += part;
+				if (length < 0) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	int32 Lz4::GetMaxCompressedSize(int32 length) {
+		return length + length / 255 + 16;
+	}
+
+	int32 Lz4::Compress(const byte* source, int32 length, byte* destination, int32 capacity) {
+		const byte* input = source;
+		const byte* anchor = source;
+		const byte* inputEnd = source + length;
+		byte* output = destination;
+		byte* outputEnd = destination + capacity;
+
+		// Positions + 1, so 0 means empty.
+		int32 table[1 << HashBits] = {};
+		if (length > MatchStartLimit) {
+			const byte* inputLimit = inputEnd - MatchStartLimit;
+			const byte* matchEnd = inputEnd - LastLiterals;
+			int32 misses = 0;
+			while (input < inputLimit) {
+				uint32 sequence = Read32(input);
+				uint32 hash = Hash(sequence);
+				int32 candidate = table[hash] - 1;
+				table[hash] = (int32)(input - source) + 1;
+				if (candidate < 0 || (input - source) - candidate > MaxOffset || Read32(source + candidate) != sequence) {
+					// Jump faster through data that doesn't compress.
+					input += 1 + (misses++ >> 6);
+					continue;
+				}
+				misses = 0;
+
+				const byte* match = source + candidate;
+				const byte* end = input + MinMatch;
+				const byte* from = match + MinMatch;
+				while (end < matchEnd && *end == *from) {
+					end += 1;
+					from += 1;
+				}
+
+				int32 literals = (int32)(input - anchor);
+				int32 matchLength = (int32)(end - input) - MinMatch;
+				// Token, literals and their length, offset, then the extra match length.
+				if (outputEnd - output < 1 + literals / 255 + 1 + literals + 2 + matchLength / 255 + 1) {
+					return 0;
+				}
+				byte* token = output++;
+				*token = (byte)((literals < 15 ? literals : 15) << 4);
+				if (literals >= 15) {
+					output = WriteLength(output, literals - 15);
+				}
+				std::memcpy(output, anchor, literals);
+				output += literals;
+
+				int32 offset = (int32)(input - match);
+				*output++ = (byte)(offset & 0xFF);
+				*output++ = (byte)(offset >> 8);
+				*token |= (byte)(matchLength < 15 ? matchLength : 15);
+				if (matchLength >= 15) {
+					output = WriteLength(output, matchLength - 15);
+				}
+
+				input = end;
+				anchor = end;
+			}
+		}
+
+		int32 literals = (int32)(inputEnd - anchor);
+		if (outputEnd - output < 1 + literals / 255 + 1 + literals) {
+			return 0;
+		}
+		*output++ = (byte)((literals < 15 ? literals : 15) << 4);
+		if (literals >= 15) {
+			output = WriteLength(output, literals - 15);
+		}
+		if (literals > 0) {
+			std::memcpy(output, anchor, literals);
+		}
+		output += literals;
+		return (int32)(output - destination);
+	}
+
+	int32 Lz4::Decompress(const byte* source, int32 length, byte* destination, int32 capacity) {
+		const byte* input = source;
+		const byte* inputEnd = source + length;
+		byte* output = destination;
+		byte* outputEnd = destination + capacity;
+
+		while (true) {
+			if (input >= inputEnd) {
+				return -1;
+			}
+			byte token = *input++;
+
+			int32 literals = token >> 4;
+			if (literals == 15 && !ReadLength(input, inputEnd, literals)) {
+				return -1;
+			}
+			if (literals > inputEnd - input || literals > outputEnd - output) {
+				return -1;
+			}
+			std::memcpy(output, input, literals);
+			input += literals;
+			output += literals;
+			// Only the last sequence has no match.
+			if (input == inputEnd) {
+				return (int32)(output - destination);
+			}
+
+			if (inputEnd - input < 2) {
+				return -1;
+			}
+			int32 offset = input[0] | (input[1] << 8);
+			input += 2;
+			if (offset == 0 || offset > output - destination) {
+				return -1;
+			}
+			int32 matchLength = token & 15;
+			if (matchLength == 15 && !ReadLength(input, inputEnd, matchLength)) {
+				return -1;
+			}
+			matchLength += MinMatch;
+			if (matchLength > outputEnd - output) {
+				return -1;
+			}
+
+			const byte* match = output - offset;
+			if (offset >= matchLength) {
+				std::memcpy(output, match, matchLength);
+			} else {
+				// Overlapping, the match repeats the bytes it just wrote.
+				for (int32 i = 0; i < matchLength; i += 1) {
+					output[i] = match[i];
+				}
+			}
+			output += matchLength;
+		}
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Engine/System/Definition.h"
+
+namespace Engine {
+	/// @brief The LZ4 block format, fast to compress and much faster to decompress.\n
+	/// Blocks are compatible with the reference implementation, the frame format is not handled here, see CompressedStream.
+	/// Compression is greedy with a single hash table on the stack, nothing is allocated.
+	class Lz4 final {
+	public:
+		/// @brief The most a block of length bytes can take once compressed.
+		static int32 GetMaxCompressedSize(int32 length);
+		/// @return The compressed size, 0 if it doesn't fit in the capacity.
+		static int32 Compress(const byte* source, int32 length, byte* destination, int32 capacity);
+		/// @brief Decompress a whole block, checking every length and offset against the buffers.
+		/// @return The decompressed size, -1 if the block is malformed or doesn't fit in the capacity.
+		static int32 Decompress(const byte* source, int32 length, byte* destination, int32 capacity);
+	};
+}
@@ -1,23 +1,382 @@
 #include "Engine/System/Debug.h"
+#include "Engine/System/Collection/MpmcRing.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Memory/Memory.h"
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <new>
 
 namespace Engine {
-	void DebugPrintInfo(const u8char* message) {
-		std::printf("%s\n", reinterpret_cast<const char*>(message));
+	namespace {
+		enum class RecordKind :byte {
+			Info,
+			Warn,
+			Error,
+			ErrorAssert,
+			Fatal,
+			FatalAssert
+		};
+		/// @brief Everything needed to format a message. All but the message point to static strings.
+		struct Record {
+			RecordKind kind = RecordKind::Info;
+			const char* category = nullptr;
+			const char* func = nullptr;
+			const char* file = nullptr;
+			int line = 0;
+			const char* expr = nullptr;
+			const char* action = nullptr;
+			const char* message = nullptr;
+		};
+
+		int FormatRecord(const Record& record, char* buffer, sizeint size) {
+			const char* category = record.category == nullptr ? "" : record.category;
+			const char* separator = record.category == nullptr ? "" : ": ";
+			switch (record.kind) {
+				case RecordKind::Info:
+					return std::snprintf(buffer, size, "%s%s%s\n", category, separator, record.message);
+				case RecordKind::Warn:
+					return std::snprintf(buffer, size, "\033[93m[WARNING] %s%s%s:\033[39m %s\n          \033[33mAt:\033[90m %s\033[39m::\033[90m%d\033[0m\n", category, separator, record.func, record.message, record.file, record.line);
+				case RecordKind::Error:
+					return std::snprintf(buffer, size, "\033[91m[ ERROR ] %s%s%s:\033[39m %s\n          \033[31mAt:\033[90m %s\033[39m::\033[90m%d\033[0m\n", category, separator, record.func, record.message, record.file, record.line);
+				case RecordKind::ErrorAssert:
+					return std::snprintf(buffer, size, "\033[91m[ ERROR ] %s:\033[39m Assertion \"%s\" failed: %s Executing \"%s\".\n          \033[31mAt:\033[90m %s\033[39m::\033[90m%d\033[0m\n", record.func, record.expr, record.message, record.action, record.file, record.line);
+				case RecordKind::Fatal:
+					return std::snprintf(buffer, size, "\033[97;101m[ FATAL ] %s:\033[39;49m %s\n          \033[37;41mAt:\033[90;49m %s\033[39m::\033[90m%d\033[0m\n", record.func, record.message, record.file, record.line);
+				case RecordKind::FatalAssert:
+					return std::snprintf(buffer, size, "\033[97;101m[ FATAL ] %s:\033[39;49m Assertion \"%s\" failed: %s Crashing.\n          \033[37;41mAt:\033[90;49m %s\033[39m::\033[90m%d\033[0m\n", record.func, record.expr, record.message, record.file, record.line);
+			}
+			return 0;
+		}
+
+		void PrintToStandardOutput(const char* text) {
+			std::fputs(text, stdout);
+		}
+
+		/// @brief A queued message, copied so the caller's buffer can go away.
+		struct Entry {
+			Record record;
+			char message[256];
+		};
+
+		struct CategoryLevel {
+			const char* name = nullptr;
+			std::atomic<byte> level{ 0 };
+		};
+
+		struct DebugData {
+			static inline constexpr int32 RingCapacity = 1024;
+			static inline constexpr int32 MaxCategoryCount = 64;
+
+			std::atomic<byte> level{ (byte)DebugLevel::Info };
+			CategoryLevel categories[MaxCategoryCount];
+			std::atomic<int32> categoryCount{ 0 };
+			std::mutex categoryMutex;
+
+			std::atomic<DebugOutput> output{ PrintToStandardOutput };
+			// Keeps lines from different threads apart.
+			std::mutex outputMutex;
+
+			MpmcRing<Entry>* ring = nullptr;
+			std::atomic<bool> async{ false };
+			// Threads between checking async and pushing, the ring isn't deleted under them.
+			std::atomic<int32> producers{ 0 };
+			std::atomic<uint64> queuedCount{ 0 };
+			std::atomic<uint64> printedCount{ 0 };
+
+			std::atomic<bool> stopping{ false };
+			std::thread writer;
+			std::mutex writerMutex;
+			std::mutex wakeMutex;
+			std::condition_variable wake;
+
+			void Print(const Record& record) {
+				char buffer[1024];
+				int length = FormatRecord(record, buffer, sizeof(buffer));
+				if (length < 0) {
+					return;
+				}
+				DebugOutput target = output.load(std::memory_order_acquire);
+				if ((sizeint)length < sizeof(buffer)) {
+					target(buffer);
+					return;
+				}
+				// Too long for the stack.
+				char* large = (char*)std::malloc((sizeint)length + 1);
+				if (large == nullptr) {
+					return;
+				}
+				FormatRecord(record, large, (sizeint)length + 1);
+				target(large);
+				std::free(large);
+			}
+			void PrintNow(const Record& record) {
+				std::lock_guard<std::mutex> lock(outputMutex);
+				Print(record);
+			}
+
+			/// @brief Copy the record into the ring, waiting for the writer if the ring is full.
+			/// @return false if not printing asynchronously or the message doesn't fit an entry.
+			bool Enqueue(const Record& record) {
+				sizeint length = std::strlen(record.message);
+				if (length >= sizeof(Entry::message)) {
+					return false;
+				}
+				// Sequentially consistent against StopWriter(), either it sees this producer or this producer sees it stopping.
+				producers.fetch_add(1);
+				if (!async.load()) {
+					producers.fetch_sub(1, std::memory_order_release);
+					return false;
+				}
+
+				Entry entry;
+				entry.record = record;
+				std::memcpy(entry.message, record.message, length + 1);
+				while (!ring->Push(entry)) {
+					wake.notify_one();
+					ThreadUtil::YieldThread();
+				}
+				queuedCount.fetch_add(1, std::memory_order_release);
+				producers.fetch_sub(1, std::memory_order_release);
+				wake.notify_one();
+				return true;
+			}
+			/// @brief Print every queued entry. Only one thread drains at a time.
+			/// @return If anything was printed.
+			bool Drain() {
+				bool any = false;
+				Entry entry;
+				while (ring->Pop(entry)) {
+					entry.record.message = entry.message;
+					PrintNow(entry.record);
+					printedCount.fetch_add(1, std::memory_order_release);
+					any = true;
+				}
+				return any;
+			}
+			void WriterLoop() {
+				ThreadUtil::SetCurrentThreadName(STRL("Debug Writer"));
+				while (true) {
+					bool stop = stopping.load(std::memory_order_acquire);
+					if (Drain()) {
+						continue;
+					}
+					if (stop) {
+						break;
+					}
+					WaitForMessages();
+				}
+				std::fflush(stdout);
+			}
+			void WaitForMessages() {
+				std::unique_lock<std::mutex> lock(wakeMutex);
+				// Waking up regularly, a notification might come in before waiting.
+				wake.wait_for(lock, std::chrono::milliseconds(5));
+			}
+
+			void Flush() {
+				if (!async.load(std::memory_order_acquire)) {
+					return;
+				}
+				uint64 target = queuedCount.load(std::memory_order_acquire);
+				while (printedCount.load(std::memory_order_acquire) < target) {
+					wake.notify_one();
+					ThreadUtil::YieldThread();
+				}
+			}
+
+			void StartWriter() {
+				std::lock_guard<std::mutex> lock(writerMutex);
+				if (async.load(std::memory_order_acquire)) {
+					return;
+				}
+				ring = MEMNEW(MpmcRing<Entry>(RingCapacity));
+				stopping.store(false, std::memory_order_release);
+				writer = std::thread([this]() {
+					WriterLoop();
+				});
+				async.store(true, std::memory_order_release);
+			}
+			void StopWriter() {
+				std::lock_guard<std::mutex> lock(writerMutex);
+				if (!async.load(std::memory_order_acquire)) {
+					return;
+				}
+				// New messages print synchronously from now on, the writer prints what is left.
+				async.store(false);
+				while (producers.load() > 0) {
+					ThreadUtil::YieldThread();
+				}
+				stopping.store(true, std::memory_order_release);
+				wake.notify_one();
+				writer.join();
+				MEMDEL(ring);
+				ring = nullptr;
+			}
+
+			void Submit(const Record& record) {
+				if (async.load(std::memory_order_acquire) && Enqueue(record)) {
+					return;
+				}
+				// Keep the order with the queued messages.
+				Flush();
+				PrintNow(record);
+			}
+		};
+
+		DebugData& GetData() {
+			// Never destructed, so messages can still be printed during static destruction.
+			alignas(DebugData) static byte storage[sizeof(DebugData)];
+			static DebugData* data = new (storage) DebugData();
+			return *data;
+		}
+		/// @brief Stops the writer thread at exit, messages after that are printed synchronously.
+		struct WriterStopper {
+			~WriterStopper() {
+				GetData().StopWriter();
+			}
+		};
+
+		CategoryLevel* FindCategory(DebugData& data, const char* category) {
+			int32 count = data.categoryCount.load(std::memory_order_acquire);
+			for (int32 i = 0; i < count; i += 1) {
+				CategoryLevel& item = data.categories[i];
+				if (item.name == category || std::strcmp(item.name, category) == 0) {
+					return &item;
+				}
+			}
+			return nullptr;
+		}
+
+		void SubmitFatal(const Record& record) {
+			DebugData& data = GetData();
+			// Print everything before it, the program crashes right after.
+			data.Flush();
+			data.PrintNow(record);
+			std::fflush(stdout);
+		}
+	}
+
+	void DebugSetLevel(DebugLevel level) {
+		GetData().level.store((byte)level, std::memory_order_relaxed);
+	}
+	DebugLevel DebugGetLevel() {
+		return (DebugLevel)GetData().level.load(std::memory_order_relaxed);
+	}
+	void DebugSetCategoryLevel(const char* category, DebugLevel level) {
+		ERR_ASSERT(category != nullptr, u8"category must not be null.", return);
+		DebugData& data = GetData();
+		std::lock_guard<std::mutex> lock(data.categoryMutex);
+		CategoryLevel* item = FindCategory(data, category);
+		if (item != nullptr) {
+			item->level.store((byte)level, std::memory_order_relaxed);
+			return;
+		}
+		int32 count = data.categoryCount.load(std::memory_order_relaxed);
+		ERR_ASSERT(count < DebugData::MaxCategoryCount, u8"Too many debug categories.", return);
+		item = &data.categories[count];
+		item->name = category;
+		item->level.store((byte)level, std::memory_order_relaxed);
+		// Published after the name is set, readers don't lock.
+		data.categoryCount.store(count + 1, std::memory_order_release);
+	}
+	bool DebugIsLevelEnabled(const char* category, DebugLevel level) {
+		if (level == DebugLevel::Fatal) {
+			return true;
+		}
+		DebugData& data = GetData();
+		if (category != nullptr) {
+			CategoryLevel* item = FindCategory(data, category);
+			if (item != nullptr) {
+				return (byte)level >= item->level.load(std::memory_order_relaxed);
+			}
+		}
+		return (byte)level >= data.level.load(std::memory_order_relaxed);
+	}
+
+	void DebugStartAsync() {
+		static WriterStopper stopper{};
+		GetData().StartWriter();
+	}
+	void DebugStopAsync() {
+		GetData().StopWriter();
+	}
+	bool DebugIsAsync() {
+		return GetData().async.load(std::memory_order_acquire);
+	}
+	void DebugFlush() {
+		GetData().Flush();
+	}
+	void DebugSetOutput(DebugOutput output) {
+		DebugData& data = GetData();
+		data.Flush();
+		std::lock_guard<std::mutex> lock(data.outputMutex);
+		data.output.store(output == nullptr ? PrintToStandardOutput : output, std::memory_order_release);
+	}
+
+	void DebugPrintInfo(const char* category, const u8char* message) {
+		Record record;
+		record.kind = RecordKind::Info;
+		record.category = category;
+		record.message = reinterpret_cast<const char*>(message);
+		GetData().Submit(record);
 	}
-	void DebugPrintWarn(const char* func, const char* file, int line, const u8char* message) {
-		std::printf("\033[93m[WARNING] %s:\033[39m %s\n          \033[33mAt:\033[90m %s\033[39m::\033[90m%d\033[0m\n", func, reinterpret_cast<const char*>(message), file, line);
+	void DebugPrintWarn(const char* category, const char* func, const char* file, int line, const u8char* message) {
+		Record record;
+		record.kind = RecordKind::Warn;
+		record.category = category;
+		record.func = func;
+		record.file = file;
+		record.line = line;
+		record.message = reinterpret_cast<const char*>(message);
+		GetData().Submit(record);
 	}
-	void DebugPrintError(const char* func, const char* file, int line, const u8char* message) {
-		std::printf("\033[91m[ ERROR ] %s:\033[39m %s\n          \033[31mAt:\033[90m %s\033[39m::\033[90m%d\033[0m\n", func, reinterpret_cast<const char*>(message), file, line);
+	void DebugPrintError(const char* category, const char* func, const char* file, int line, const u8char* message) {
+		Record record;
+		record.kind = RecordKind::Error;
+		record.category = category;
+		record.func = func;
+		record.file = file;
+		record.line = line;
+		record.message = reinterpret_cast<const char*>(message);
+		GetData().Submit(record);
 	}
 	void DebugPrintErrorAssert(const char* func, const char* file, int line, const char* expr, const u8char* message, const char* action) {
-		std::printf("\033[91m[ ERROR ] %s:\033[39m Assertion \"%s\" failed: %s Executing \"%s\".\n          \033[31mAt:\033[90m %s\033[39m::\033[90m%d\033[0m\n", func, expr, reinterpret_cast<const char*>(message), action, file, line);
+		if (!DebugIsLevelEnabled(nullptr, DebugLevel::Error)) {
+			return;
+		}
+		Record record;
+		record.kind = RecordKind::ErrorAssert;
+		record.func = func;
+		record.file = file;
+		record.line = line;
+		record.expr = expr;
+		record.action = action;
+		record.message = reinterpret_cast<const char*>(message);
+		GetData().Submit(record);
 	}
 	void DebugPrintFatal(const char* func, const char* file, int line, const u8char* message) {
-		std::printf("\033[97;101m[ FATAL ] %s:\033[39;49m %s\n          \033[37;41mAt:\033[90;49m %s\033[39m::\033[90m%d\033[0m\n", func, reinterpret_cast<const char*>(message), file, line);
+		Record record;
+		record.kind = RecordKind::Fatal;
+		record.func = func;
+		record.file = file;
+		record.line = line;
+		record.message = reinterpret_cast<const char*>(message);
+		SubmitFatal(record);
 	}
 	void DebugPrintFatalAssert(const char* func, const char* file, int line, const char* expr, const u8char* message) {
-		std::printf("\033[97;101m[ FATAL ] %s:\033[39;49m Assertion \"%s\" failed: %s Crashing.\n          \033[37;41mAt:\033[90;49m %s\033[39m::\033[90m%d\033[0m\n", func, expr, reinterpret_cast<const char*>(message), file, line);
+		Record record;
+		record.kind = RecordKind::FatalAssert;
+		record.func = func;
+		record.file = file;
+		record.line = line;
+		record.expr = expr;
+		record.message = reinterpret_cast<const char*>(message);
+		SubmitFatal(record);
 	}
-}
\ No newline at end of file
+}
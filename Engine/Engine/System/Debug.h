@@ -9,11 +9,28 @@
 #define DEBUG_TEXT(text) ""
 #endif
 
-#define INFO_MSG(msg) ::Engine::DebugPrintInfo(msg)
+// Info messages are stripped from release builds, the message isn't even evaluated.
+#ifndef DEBUG_INFO_ENABLED
+#ifdef NDEBUG
+#define DEBUG_INFO_ENABLED false
+#else
+#define DEBUG_INFO_ENABLED true
+#endif
+#endif
 
-#define WARN_MSG(msg) ::Engine::DebugPrintWarn(__func__,__FILE__,__LINE__,DEBUG_TEXT(msg))
+// The message is only evaluated if the level of the category is enabled, so formatting is skipped for filtered messages.
+#if(DEBUG_INFO_ENABLED)
+#define INFO_MSG_CATEGORY(category,msg) do { if (::Engine::DebugIsLevelEnabled(category, ::Engine::DebugLevel::Info)) { ::Engine::DebugPrintInfo(category,msg); } } while (false)
+#else
+#define INFO_MSG_CATEGORY(category,msg) do {} while (false)
+#endif
+#define INFO_MSG(msg) INFO_MSG_CATEGORY(nullptr,msg)
 
-#define ERR_MSG(msg) ::Engine::DebugPrintError(__func__,__FILE__,__LINE__,DEBUG_TEXT(msg))
+#define WARN_MSG_CATEGORY(category,msg) do { if (::Engine::DebugIsLevelEnabled(category, ::Engine::DebugLevel::Warning)) { ::Engine::DebugPrintWarn(category,__func__,__FILE__,__LINE__,DEBUG_TEXT(msg)); } } while (false)
+#define WARN_MSG(msg) WARN_MSG_CATEGORY(nullptr,msg)
+
+#define ERR_MSG_CATEGORY(category,msg) do { if (::Engine::DebugIsLevelEnabled(category, ::Engine::DebugLevel::Error)) { ::Engine::DebugPrintError(category,__func__,__FILE__,__LINE__,DEBUG_TEXT(msg)); } } while (false)
+#define ERR_MSG(msg) ERR_MSG_CATEGORY(nullptr,msg)
 #define ERR_ASSERT(expr,msg,action) if (!(expr)) { ::Engine::DebugPrintErrorAssert(__func__,__FILE__,__LINE__,#expr,msg,#action);action;}
 
 #ifdef _MSC_VER
@@ -26,10 +43,39 @@
 #define FATAL_ASSERT(expr,msg) if (!(expr)) { ::Engine::DebugPrintFatalAssert(__func__,__FILE__,__LINE__,#expr,msg);FATAL_CRASH_IMMEDIATELY();}
 
 namespace Engine {
-	void DebugPrintInfo(const u8char* message);
-	void DebugPrintWarn(const char* func, const char* file, int line, const u8char* message);
-	void DebugPrintError(const char* func, const char* file, int line, const u8char* message);
+	enum class DebugLevel :byte {
+		Info,
+		Warning,
+		Error,
+		/// @brief Fatal messages are always printed.
+		Fatal
+	};
+	/// @brief Receives every formatted message, one or more lines ending with a line break.
+	using DebugOutput = void(*)(const char* text);
+
+	/// @brief The lowest level printed, for categories without their own level and uncategorized messages.
+	void DebugSetLevel(DebugLevel level);
+	DebugLevel DebugGetLevel();
+	/// @brief Override the level of a category. Categories are compared by name.
+	/// @param category Stored as it is, needs to live as long as the program, like a string literal.
+	void DebugSetCategoryLevel(const char* category, DebugLevel level);
+	bool DebugIsLevelEnabled(const char* category, DebugLevel level);
+
+	/// @brief Print messages from a background thread instead of the calling thread.\n
+	/// Messages are copied into a fixed ring buffer and formatted by the writer thread, so logging threads don't wait for the output.
+	void DebugStartAsync();
+	/// @brief Print the messages still queued and stop the writer thread.
+	void DebugStopAsync();
+	bool DebugIsAsync();
+	/// @brief Block until every queued message is printed.
+	void DebugFlush();
+	/// @brief Redirect the formatted messages. nullptr prints to the standard output.
+	void DebugSetOutput(DebugOutput output);
+
+	void DebugPrintInfo(const char* category, const u8char* message);
+	void DebugPrintWarn(const char* category, const char* func, const char* file, int line, const u8char* message);
+	void DebugPrintError(const char* category, const char* func, const char* file, int line, const u8char* message);
 	void DebugPrintErrorAssert(const char* func, const char* file, int line, const char* expr, const u8char* message, const char* action);
 	void DebugPrintFatal(const char* func, const char* file, int line, const u8char* message);
 	void DebugPrintFatalAssert(const char* func, const char* file, int line, const char* expr, const u8char* message);
-}
\ No newline at end of file
+}
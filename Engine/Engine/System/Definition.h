@@ -46,6 +46,7 @@ namespace Engine {
 		AlreadyExists,
 		InvalidStream,
 		OutOfMemory,
+		Cancelled,
 	};
 
 	/// @brief A helper struct for storing result code and result value together.\n
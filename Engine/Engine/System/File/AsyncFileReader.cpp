@@ -0,0 +1,114 @@
+#include "Engine/System/File/AsyncFileReader.h"
+#include "Engine/System/File/FileSystem.h"
+#include "Engine/System/Profiler.h"
+#include <cstdint>
+
+namespace Engine {
+	bool AsyncFileRead::IsDone() const {
+		return done.load(std::memory_order_acquire);
+	}
+	ResultCode AsyncFileRead::GetResult() const {
+		ERR_ASSERT(IsDone(), u8"The read is not done yet.", return ResultCode::UnknownError);
+		return result;
+	}
+	const String& AsyncFileRead::GetPath() const {
+		return path;
+	}
+	List<byte>& AsyncFileRead::GetData() {
+		FATAL_ASSERT(IsDone(), u8"The read is not done yet.");
+		return data;
+	}
+	const List<byte>& AsyncFileRead::GetData() const {
+		FATAL_ASSERT(IsDone(), u8"The read is not done yet.");
+		return data;
+	}
+
+	AsyncFileReader::AsyncFileReader(FileSystem* fileSystem) :fileSystem(fileSystem) {
+		thread = std::thread(&AsyncFileReader::IoLoop, this);
+	}
+	AsyncFileReader::~AsyncFileReader() {
+		{
+			SimpleLock<Mutex> lock(mutex);
+			stopping = true;
+		}
+		queued.release();
+		thread.join();
+	}
+
+	SharedPtr<AsyncFileRead> AsyncFileReader::Read(const String& path, AsyncFileRead::Callback callback, void* userData, JobSystem* jobSystem, Job::Priority priority) {
+		auto read = SharedPtr<AsyncFileRead>::Create();
+		read->path = path;
+		read->callback = callback;
+		read->userData = userData;
+		read->jobSystem = jobSystem;
+		read->priority = priority;
+
+		pendingCount.fetch_add(1, std::memory_order_relaxed);
+		{
+			SimpleLock<Mutex> lock(mutex);
+			queues[(int32)priority].PushBack(read);
+		}
+		queued.release();
+		return read;
+	}
+	int32 AsyncFileReader::GetPendingCount() const {
+		return pendingCount.load(std::memory_order_relaxed);
+	}
+
+	void AsyncFileReader::IoLoop() {
+		Profiler::SetCurrentThreadName(STRL("File IO"));
+		while (true) {
+			queued.acquire();
+			SharedPtr<AsyncFileRead> read{};
+			{
+				SimpleLock<Mutex> lock(mutex);
+				bool popped = false;
+				for (int32 i = 0; i < Job::PriorityCount && !popped; i += 1) {
+					popped = queues[i].TryPopFront(read);
+				}
+				if (!popped) {
+					// Only the stop request releases without a read, and it comes after the last one.
+					if (stopping) {
+						return;
+					}
+					continue;
+				}
+			}
+			Execute(*read.GetRaw());
+			pendingCount.fetch_sub(1, std::memory_order_relaxed);
+			Complete(read);
+		}
+	}
+	void AsyncFileReader::Execute(AsyncFileRead& read) {
+		PROFILE_SCOPE("AsyncFileReader::Execute");
+		auto opened = fileSystem->OpenFile(read.path, FileStream::OpenMode::ReadOnly);
+		if (opened.result != ResultCode::OK) {
+			read.result = opened.result;
+			return;
+		}
+
+		auto file = opened.value;
+		int64 length = file->GetLength();
+		if (length < 0 || length > INT32_MAX) {
+			read.result = length < 0 ? ResultCode::UnknownError : ResultCode::NotSupported;
+			file->Close();
+			return;
+		}
+		int32 readLength = file->ReadBytes((int32)length, read.data);
+		read.result = readLength == length ? ResultCode::OK : ResultCode::UnknownError;
+		file->Close();
+	}
+	void AsyncFileReader::Complete(const SharedPtr<AsyncFileRead>& read) {
+		read->done.store(true, std::memory_order_release);
+		if (read->callback == nullptr) {
+			return;
+		}
+		if (read->jobSystem == nullptr || !read->jobSystem->IsRunning()) {
+			read->callback(*read.GetRaw(), read->userData);
+			return;
+		}
+		read->jobSystem->AddJob([read]() {
+			read->callback(*read.GetRaw(), read->userData);
+		}, Job::Preference::Null, SharedPtr<JobCounter>(), read->priority);
+	}
+}
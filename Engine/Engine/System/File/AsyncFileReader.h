@@ -0,0 +1,73 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/String.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/Deque.h"
+#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include <atomic>
+#include <thread>
+
+namespace Engine {
+	class FileSystem;
+
+	/// @brief A whole-file read running on the I/O thread, see FileSystem::ReadFileAsync().
+	class AsyncFileRead final {
+	public:
+		/// @brief Called once the read is over, failed or not.
+		using Callback = void (*)(AsyncFileRead& read, void* userData);
+
+		/// @brief Thread-safe. Once true, the result and the data are ready and the I/O thread doesn't touch them anymore.
+		bool IsDone() const;
+		ResultCode GetResult() const;
+		const String& GetPath() const;
+		/// @brief The content of the file, only after IsDone().
+		List<byte>& GetData();
+		const List<byte>& GetData() const;
+
+	private:
+		friend class AsyncFileReader;
+
+		String path{};
+		Callback callback = nullptr;
+		void* userData = nullptr;
+		JobSystem* jobSystem = nullptr;
+		Job::Priority priority = Job::Priority::Background;
+		List<byte> data{};
+		ResultCode result = ResultCode::OK;
+		std::atomic<bool> done{ false };
+	};
+
+	/// @brief Reads files on a dedicated I/O thread, so loading never blocks the thread asking for it.\n
+	/// Files are opened through the FileSystem, so every protocol works, and read in one call each, the higher priorities first.
+	/// The callback runs as a job of the given JobSystem, or on the I/O thread without one.
+	class AsyncFileReader final {
+	public:
+		AsyncFileReader(FileSystem* fileSystem);
+		/// @brief Finishes the queued reads, then joins the I/O thread.
+		~AsyncFileReader();
+		AsyncFileReader(const AsyncFileReader&) = delete;
+		AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+		/// @brief Thread-safe. Queue a read of the whole file.
+		/// @param jobSystem Runs the callback as a job with the priority, nullptr to call it on the I/O thread.
+		SharedPtr<AsyncFileRead> Read(const String& path, AsyncFileRead::Callback callback = nullptr, void* userData = nullptr, JobSystem* jobSystem = nullptr, Job::Priority priority = Job::Priority::Background);
+		/// @brief Reads queued and not finished yet.
+		int32 GetPendingCount() const;
+
+	private:
+		void IoLoop();
+		void Execute(AsyncFileRead& read);
+		static void Complete(const SharedPtr<AsyncFileRead>& read);
+
+		FileSystem* fileSystem;
+		mutable Mutex mutex{};
+		/// @brief A queue per Job::Priority.
+		Deque<SharedPtr<AsyncFileRead>> queues[Job::PriorityCount]{};
+		Semaphore queued{ 0 };
+		bool stopping = false;
+		std::atomic<int32> pendingCount{ 0 };
+		std::thread thread{};
+	};
+}
@@ -0,0 +1,60 @@
+#include "Engine/System/File/FileEntry.h"
+#include <cstring>
+
+namespace Engine {
+	int32 FileEntryList::GetCount() const {
+		return entries.GetCount();
+	}
+
+	const FileEntry& FileEntryList::operator[](int32 index) const {
+		return entries[index];
+	}
+
+	std::string_view FileEntryList::GetName(int32 index) const {
+		const FileEntry& entry = entries[index];
+		return std::string_view(names.GetRawElementPtr() + entry.nameOffset, entry.nameLength);
+	}
+
+	String FileEntryList::GetPath(int32 index) const {
+		std::string_view name = GetName(index);
+		return String((const u8char*)name.data(), (int32)name.size());
+	}
+
+	void FileEntryList::Add(std::string_view name, FileEntry::Type type, int64 size, int64 modifiedTime) {
+		FileEntry& entry = entries.Emplace();
+		entry.nameOffset = (uint32)names.GetCount();
+		entry.nameLength = (uint32)name.size();
+		entry.size = size;
+		entry.modifiedTime = modifiedTime;
+		entry.type = type;
+
+		int32 offset = names.GetCount();
+		names.SetCount(offset + (int32)name.size());
+		if (!name.empty()) {
+			std::memcpy(names.GetRawElementPtr() + offset, name.data(), name.size());
+		}
+	}
+
+	void FileEntryList::Append(FileEntryList& other) {
+		uint32 base = (uint32)names.GetCount();
+		int32 first = entries.GetCount();
+		entries.SetCount(first + other.entries.GetCount());
+		for (int32 i = 0; i < other.entries.GetCount(); i += 1) {
+			FileEntry& entry = entries[first + i];
+			entry = other.entries[i];
+			entry.nameOffset += base;
+		}
+
+		int32 offset = names.GetCount();
+		names.SetCount(offset + other.names.GetCount());
+		if (other.names.GetCount() > 0) {
+			std::memcpy(names.GetRawElementPtr() + offset, other.names.GetRawElementPtr(), other.names.GetCount());
+		}
+		other.Clear();
+	}
+
+	void FileEntryList::Clear() {
+		entries.Clear();
+		names.Clear();
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine/System/String.h"
+#include "Engine/System/Collection/List.h"
+#include <string_view>
+
+namespace Engine {
+	class JobSystem;
+
+	/// @brief One file or directory found by FileProtocol::Enumerate(). The path lives in the names of the FileEntryList.
+	struct FileEntry {
+		enum class Type :byte {
+			File,
+			Directory,
+			/// @brief Devices, sockets, pipes and broken links.
+			Other,
+		};
+
+		uint32 nameOffset;
+		uint32 nameLength;
+		/// @brief In bytes, 0 for directories.
+		int64 size;
+		/// @brief Nanoseconds since the Unix epoch.
+		int64 modifiedTime;
+		Type type;
+	};
+
+	/// @brief The entries of an enumeration, with their paths packed one after another in a single buffer instead of a String each.\n
+	/// Paths are relative to the enumerated directory and separated with '/'. Clear() keeps the storage for the next enumeration.
+	class FileEntryList final {
+	public:
+		int32 GetCount() const;
+		const FileEntry& operator[](int32 index) const;
+		/// @brief Valid until the list changes.
+		std::string_view GetName(int32 index) const;
+		/// @brief A String copy of the path, for keeping it.
+		String GetPath(int32 index) const;
+
+		/// @brief Add an entry, copying the path into the names.
+		void Add(std::string_view name, FileEntry::Type type, int64 size, int64 modifiedTime);
+		/// @brief Move the entries of the other list to the end of this one.
+		void Append(FileEntryList& other);
+		void Clear();
+
+	private:
+		List<FileEntry> entries{};
+		List<char> names{};
+	};
+
+	/// @brief What FileProtocol::Enumerate() looks for.
+	struct FileEnumerateConfig {
+		/// @brief Go into the subdirectories. Links to directories are listed but not followed.
+		bool recursive = true;
+		bool includeFiles = true;
+		bool includeDirectories = true;
+		/// @brief A Glob pattern the entries must match, empty for all of them.
+		/// Patterns with a '/' are matched with the relative path, the others with the name alone.
+		String filter{};
+		/// @brief Scans the directories of each depth in parallel, nullptr to scan them on the calling thread.
+		JobSystem* jobSystem = nullptr;
+	};
+}
@@ -0,0 +1,19 @@
+#include "Engine/System/File/FilePath.h"
+
+namespace Engine {
+	bool FilePath::IsValid() const {
+		return FileProtocol::IsProtocolValid(protocol);
+	}
+	const String& FilePath::GetPath() const {
+		return path;
+	}
+	FileProtocol::Protocol FilePath::GetProtocol() const {
+		return protocol;
+	}
+	FileProtocol* FilePath::GetHandler() const {
+		return handler;
+	}
+	const String& FilePath::GetHandlerPath() const {
+		return handlerPath;
+	}
+}
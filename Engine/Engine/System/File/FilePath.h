@@ -0,0 +1,30 @@
+#pragma once
+#include "Engine/System/String.h"
+#include "Engine/System/File/FileProtocol.h"
+
+namespace Engine {
+	/// @brief A path split once into its protocol, the handler for it and the path the handler is given, see FileSystem::ParsePath().\n
+	/// Keep one for a path used many times, so each FileSystem call doesn't look the protocol up again.
+	/// The handler path shares the content of the whole path.
+	class FilePath final {
+	public:
+		FilePath() = default;
+
+		/// @brief Whether the protocol is valid. The handler may still be missing if the protocol has none.
+		bool IsValid() const;
+		const String& GetPath() const;
+		FileProtocol::Protocol GetProtocol() const;
+		/// @return nullptr if the protocol has no handler.
+		FileProtocol* GetHandler() const;
+		/// @brief The part after "protocol://", or the whole path without a protocol.
+		const String& GetHandlerPath() const;
+
+	private:
+		friend class FileSystem;
+
+		String path{};
+		String handlerPath{};
+		FileProtocol::Protocol protocol = FileProtocol::Protocol::Null;
+		FileProtocol* handler = nullptr;
+	};
+}
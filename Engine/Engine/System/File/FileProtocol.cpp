@@ -5,4 +5,16 @@ namespace Engine {
 	bool FileProtocol::IsProtocolValid(Protocol protocol) {
 		return protocol > Protocol::Null && protocol < Protocol::End;
 	}
+
+	ResultPair<IntrusivePtr<MappedFileStream>> FileProtocol::MapFile(const String& path) {
+		return ResultPair<IntrusivePtr<MappedFileStream>>(ResultCode::NotSupported, IntrusivePtr<MappedFileStream>(nullptr));
+	}
+
+	ResultCode FileProtocol::Enumerate(const String& path, const FileEnumerateConfig& config, FileEntryList& result) const {
+		return ResultCode::NotSupported;
+	}
+
+	ResultCode FileProtocol::GetNativePath(const String& path, String& result) const {
+		return ResultCode::NotSupported;
+	}
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/System/File/FileStream.h"
+#include "Engine/System/File/FileEntry.h"
 #include "Engine/System/Collection/List.h"
 
 namespace Engine {
@@ -33,12 +34,19 @@ namespace Engine {
 		virtual ResultCode CreateDirectory(const String& path) = 0;
 
 		virtual ResultPair<IntrusivePtr<FileStream>> OpenFile(const String& path, FileStream::OpenMode mode) = 0;
+		/// @brief Map the file read-only into memory. The default returns ResultCode::NotSupported.
+		virtual ResultPair<IntrusivePtr<MappedFileStream>> MapFile(const String& path);
 
 		virtual ResultCode RemoveFile(const String& path) = 0;
 		virtual ResultCode RemoveDirectory(const String& path) = 0;
 
 		virtual ResultCode GetAllFiles(const String& path, List<String>& result) const = 0;
 		virtual ResultCode GetAllDirectories(const String& path, List<String>& result) const = 0;
+		/// @brief Add the entries under the directory to the result, see FileEnumerateConfig. The default returns ResultCode::NotSupported.
+		virtual ResultCode Enumerate(const String& path, const FileEnumerateConfig& config, FileEntryList& result) const;
+		/// @brief The path on the machine the path of the protocol refers to, for the OS APIs such as FileWatcher.
+		/// The default returns ResultCode::NotSupported.
+		virtual ResultCode GetNativePath(const String& path, String& result) const;
 
 	private:
 		friend class FileSystem;
@@ -1,4 +1,6 @@
 #include "Engine/System/File/FileStream.h"
+#include <cstring>
+#include <cstdint>
 
 namespace Engine{
 	bool FileStream::IsOpenModeValid(OpenMode mode) {
@@ -50,4 +52,75 @@ namespace Engine{
 	bool FileStream::CanRandomAccess() const {
 		return true;
 	}
+
+	bool MappedFileStream::IsValid() const {
+		return valid;
+	}
+	bool MappedFileStream::CanRead() const {
+		return valid;
+	}
+	bool MappedFileStream::CanWrite() const {
+		return false;
+	}
+
+	ResultCode MappedFileStream::SetPosition(int64 position) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return ResultCode::InvalidStream);
+		ERR_ASSERT(position >= 0 && position <= length, u8"position out of the file.", return ResultCode::InvalidArgument);
+		this->position = position;
+		return ResultCode::OK;
+	}
+	int64 MappedFileStream::GetPosition() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return -1);
+		return position;
+	}
+	int64 MappedFileStream::GetLength() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return -1);
+		return length;
+	}
+
+	ByteSpan MappedFileStream::GetSpan() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return ByteSpan());
+		return ByteSpan{ data, length > INT32_MAX ? INT32_MAX : (int32)length };
+	}
+	bool MappedFileStream::CanReadSpan() const {
+		return valid;
+	}
+	ByteSpan MappedFileStream::ReadSpan(int32 length) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return ByteSpan());
+		ERR_ASSERT(length >= 0, u8"length must be greater than 0.", return ByteSpan());
+		int64 left = this->length - position;
+		int32 size = left < length ? (int32)left : length;
+		ByteSpan result{ data + position, size };
+		position += size;
+		return result;
+	}
+
+	void MappedFileStream::SetView(const byte* data, int64 length) {
+		this->data = data;
+		this->length = length;
+		position = 0;
+		valid = true;
+	}
+	void MappedFileStream::ClearView() {
+		data = nullptr;
+		length = 0;
+		position = 0;
+		valid = false;
+	}
+	const byte* MappedFileStream::GetViewData() const {
+		return data;
+	}
+
+	ResultCode MappedFileStream::WriteBytesUnchecked(const byte* valuePtr, int32 length) {
+		return ResultCode::NoPermission;
+	}
+	int32 MappedFileStream::ReadBytesUnchecked(byte* buffer, int32 length) {
+		int64 left = this->length - position;
+		int32 size = left < length ? (int32)left : length;
+		if (size > 0) {
+			std::memcpy(buffer, data + position, size);
+			position += size;
+		}
+		return size;
+	}
 }
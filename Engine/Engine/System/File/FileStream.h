@@ -34,4 +34,43 @@ namespace Engine {
 		bool CanRandomAccess() const override;
 	};
 
+	/// @brief A read-only FileStream over a file mapped into memory, see FileSystem::MapFile().\n
+	/// The OS loads the pages when they are first touched, reads copy straight from them and ReadSpan() doesn't copy at all.
+	/// The view stays until Close(), which invalidates every span taken from it.
+	class MappedFileStream :public FileStream {
+		REFLECTION_CLASS(::Engine::MappedFileStream, ::Engine::FileStream) {
+			REFLECTION_CLASS_INSTANTIABLE(false);
+		}
+
+	public:
+		bool IsValid() const override;
+		bool CanRead() const override;
+		bool CanWrite() const override;
+
+		ResultCode SetPosition(int64 position) override;
+		int64 GetPosition() const override;
+		int64 GetLength() const override;
+
+		/// @brief The whole file, spans past 2 GiB are cut, use ReadSpan() in parts for those.
+		ByteSpan GetSpan() const;
+		/// @brief The start of the view, GetLength() bytes. nullptr for an empty file.
+		const byte* GetViewData() const;
+		bool CanReadSpan() const override;
+		ByteSpan ReadSpan(int32 length) override;
+
+	protected:
+		/// @brief Called by the protocol once the file is mapped, an empty file has no data.
+		void SetView(const byte* data, int64 length);
+		/// @brief Drop the view, the protocol unmaps it.
+		void ClearView();
+
+		ResultCode WriteBytesUnchecked(const byte* valuePtr, int32 length) override;
+		int32 ReadBytesUnchecked(byte* buffer, int32 length) override;
+
+	private:
+		const byte* data = nullptr;
+		int64 length = 0;
+		int64 position = 0;
+		bool valid = false;
+	};
 }
\ No newline at end of file
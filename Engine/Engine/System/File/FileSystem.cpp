@@ -1,5 +1,6 @@
 #include "Engine/System/File/FileSystem.h"
 #include "Engine/System/File/Protocol/Native.h"
+#include "Engine/System/File/Protocol/Pack.h"
 
 namespace Engine {
 	FileSystem::FileSystem() {
@@ -7,28 +8,38 @@ namespace Engine {
 		AddProtocol(STRING_LITERAL("file"), FileProtocol::Protocol::Native);
 		AddProtocolHandler(FileProtocol::Protocol::Native, Handler(MEMNEW(FileProtocolNative)));
 		AddProtocol(STRING_LITERAL("res"), FileProtocol::Protocol::Resource);
-		//AddProtocolHandler(Protocol::Resource, Handler(MEMNEW(...));
+		AddProtocolHandler(FileProtocol::Protocol::Resource, Handler(MEMNEW(FileProtocolPack)));
 		AddProtocol(STRING_LITERAL("user"), FileProtocol::Protocol::Persistent);
 		//AddProtocolHandler(Protocol::User, Handler(MEMNEW(...));
 	}
+	FileSystem::~FileSystem() {
+		// The I/O thread still uses the protocols until it is joined.
+		asyncReader.Reset();
+	}
 
 #pragma region Protocols
-	FileSystem::SplitData FileSystem::GetSplitData(const String& path) const {
+	FilePath FileSystem::ParsePath(const String& path) const {
 		const String prefix = STRING_LITERAL("://");
 
-		int32 index = path.IndexOf(prefix);
-
-		String protocolName;
-		int32 rIndex = 0;
+		FilePath result{};
+		result.path = path;
+		result.protocol = FileProtocol::Protocol::Native;
+		result.handlerPath = path;
 
+		int32 index = (path.GetCount() > 0 ? path.IndexOf(prefix) : -1);
 		if (index >= 0) {
-			protocolName = path.Substring(0, index);
-			rIndex = index + prefix.GetCount();
+			if (index > 0) {
+				// Look up the protocol name in place, without allocating a substring.
+				result.protocol = FileProtocol::Protocol::Null;
+				protocols.TryGet(path.GetStringView().substr(0, index), result.protocol);
+			}
+			int32 start = index + prefix.GetCount();
+			result.handlerPath = (start < path.GetCount() ? path.Substring(start, path.GetCount() - start) : String::GetEmpty());
 		}
-
-		FileProtocol::Protocol rProtocol = protocolName.GetCount() > 0 ? GetProtocol(protocolName) : FileProtocol::Protocol::Native;
-
-		return SplitData(rProtocol, rIndex);
+		if (FileProtocol::IsProtocolValid(result.protocol)) {
+			result.handler = GetProtocolHandler(result.protocol);
+		}
+		return result;
 	}
 
 	FileProtocol::Protocol FileSystem::GetProtocol(const String& name) const {
@@ -45,6 +56,15 @@ namespace Engine {
 		}
 	}
 
+	ResultCode FileSystem::MountResourcePack(const String& path) {
+		auto mapped = MapFile(path);
+		if (mapped.result != ResultCode::OK) {
+			return mapped.result;
+		}
+		FileProtocolPack* pack = static_cast<FileProtocolPack*>(GetProtocolHandler(FileProtocol::Protocol::Resource));
+		return pack->Mount(mapped.value);
+	}
+
 	void FileSystem::AddProtocol(const String& name, FileProtocol::Protocol protocol) {
 		protocols.Set(name, protocol);
 	}
@@ -56,98 +76,111 @@ namespace Engine {
 
 #pragma region File operations
 	bool FileSystem::IsFileExists(const String& path) const {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return false);
-
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
-
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->IsFileExists(handlerPath);
+		return IsFileExists(ParsePath(path));
+	}
+	bool FileSystem::IsFileExists(const FilePath& path) const {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return false);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->IsFileExists(path.GetHandlerPath());
 	}
 	bool FileSystem::IsDirectoryExists(const String& path) const {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return false);
-
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
-
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->IsDirectoryExists(handlerPath);
+		return IsDirectoryExists(ParsePath(path));
+	}
+	bool FileSystem::IsDirectoryExists(const FilePath& path) const {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return false);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->IsDirectoryExists(path.GetHandlerPath());
 	}
 
 	ResultCode FileSystem::CreateFile(const String& path) {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
-
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
-
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->CreateFile(handlerPath);
+		return CreateFile(ParsePath(path));
+	}
+	ResultCode FileSystem::CreateFile(const FilePath& path) {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->CreateFile(path.GetHandlerPath());
 	}
 	ResultCode FileSystem::CreateDirectory(const String& path) {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
-
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
-
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->CreateDirectory(handlerPath);
+		return CreateDirectory(ParsePath(path));
+	}
+	ResultCode FileSystem::CreateDirectory(const FilePath& path) {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->CreateDirectory(path.GetHandlerPath());
 	}
 
 	ResultPair<IntrusivePtr<FileStream>> FileSystem::OpenFile(const String& path, FileStream::OpenMode mode) {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return ResultPair<IntrusivePtr<FileStream>>(ResultCode::InvalidArgument, IntrusivePtr<FileStream>(nullptr)));
-
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
-
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->OpenFile(handlerPath, mode);
+		return OpenFile(ParsePath(path), mode);
+	}
+	ResultPair<IntrusivePtr<FileStream>> FileSystem::OpenFile(const FilePath& path, FileStream::OpenMode mode) {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultPair<IntrusivePtr<FileStream>>(ResultCode::InvalidArgument, IntrusivePtr<FileStream>(nullptr)));
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->OpenFile(path.GetHandlerPath(), mode);
+	}
+	ResultPair<IntrusivePtr<MappedFileStream>> FileSystem::MapFile(const String& path) {
+		return MapFile(ParsePath(path));
+	}
+	ResultPair<IntrusivePtr<MappedFileStream>> FileSystem::MapFile(const FilePath& path) {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultPair<IntrusivePtr<MappedFileStream>>(ResultCode::InvalidArgument, IntrusivePtr<MappedFileStream>(nullptr)));
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->MapFile(path.GetHandlerPath());
 	}
 
 	ResultCode FileSystem::RemoveFile(const String& path) {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
-
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
-
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->RemoveFile(handlerPath);
+		return RemoveFile(ParsePath(path));
+	}
+	ResultCode FileSystem::RemoveFile(const FilePath& path) {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->RemoveFile(path.GetHandlerPath());
 	}
 	ResultCode FileSystem::RemoveDirectory(const String& path) {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
-
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
-
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->RemoveDirectory(handlerPath);
+		return RemoveDirectory(ParsePath(path));
+	}
+	ResultCode FileSystem::RemoveDirectory(const FilePath& path) {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->RemoveDirectory(path.GetHandlerPath());
 	}
 
 	ResultCode FileSystem::GetAllFiles(const String& path, List<String>& result) const {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
-
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
-
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->GetAllFiles(handlerPath, result);
+		return GetAllFiles(ParsePath(path), result);
+	}
+	ResultCode FileSystem::GetAllFiles(const FilePath& path, List<String>& result) const {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->GetAllFiles(path.GetHandlerPath(), result);
 	}
 	ResultCode FileSystem::GetAllDirectories(const String& path, List<String>& result) const {
-		auto data = GetSplitData(path);
-		ERR_ASSERT(FileProtocol::IsProtocolValid(data.protocol), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
+		return GetAllDirectories(ParsePath(path), result);
+	}
+	ResultCode FileSystem::GetAllDirectories(const FilePath& path, List<String>& result) const {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->GetAllDirectories(path.GetHandlerPath(), result);
+	}
 
-		FileProtocol* handler = GetProtocolHandler(data.protocol);
-		FATAL_ASSERT(handler != nullptr, u8"Protocol handler not found!");
+	ResultCode FileSystem::Enumerate(const String& path, const FileEnumerateConfig& config, FileEntryList& result) const {
+		return Enumerate(ParsePath(path), config, result);
+	}
+	ResultCode FileSystem::Enumerate(const FilePath& path, const FileEnumerateConfig& config, FileEntryList& result) const {
+		ERR_ASSERT(path.IsValid(), u8"Invalid path protocol!", return ResultCode::InvalidArgument);
+		FATAL_ASSERT(path.GetHandler() != nullptr, u8"Protocol handler not found!");
+		return path.GetHandler()->Enumerate(path.GetHandlerPath(), config, result);
+	}
+#pragma endregion
 
-		String handlerPath = path.Substring(data.index, path.GetCount() - data.index);
-		return handler->GetAllDirectories(handlerPath, result);
+#pragma region Async
+	SharedPtr<AsyncFileRead> FileSystem::ReadFileAsync(const String& path, AsyncFileRead::Callback callback, void* userData, JobSystem* jobSystem, Job::Priority priority) {
+		AsyncFileReader* reader = nullptr;
+		{
+			SimpleLock<Mutex> lock(asyncReaderMutex);
+			if (asyncReader == nullptr) {
+				asyncReader.Reset(MEMNEW(AsyncFileReader(this)));
+			}
+			reader = asyncReader.GetRaw();
+		}
+		return reader->Read(path, callback, userData, jobSystem, priority);
 	}
 #pragma endregion
 }
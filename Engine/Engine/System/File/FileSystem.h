@@ -3,6 +3,8 @@
 #include "Engine/System/Object/Object.h"
 #include "Engine/System/Collection/Dictionary.h"
 #include "Engine/System/File/FileProtocol.h"
+#include "Engine/System/File/FilePath.h"
+#include "Engine/System/File/AsyncFileReader.h"
 
 
 namespace Engine {
@@ -12,6 +14,7 @@ namespace Engine {
 	class FileSystem final {
 	public:
 		FileSystem();
+		~FileSystem();
 
 #pragma region Protocols
 		/// @brief Get the protocol enum item by its name.
@@ -20,46 +23,70 @@ namespace Engine {
 		/// @brief Get a protocol handler.
 		/// @return nullptr when not found.
 		FileProtocol* GetProtocolHandler(FileProtocol::Protocol protocol) const;
+		/// @brief Split the path into its protocol and handler path once, for the overloads taking a FilePath.
+		FilePath ParsePath(const String& path) const;
+		/// @brief Serve "res://" from the pack file at the path, mapped until another one is mounted.\n
+		/// Mount before any resource is read, see FileProtocolPack.
+		ResultCode MountResourcePack(const String& path);
 #pragma endregion
 
 #pragma region File operations
 		/// @brief Check if the file exists.
 		bool IsFileExists(const String& path) const;
+		bool IsFileExists(const FilePath& path) const;
 		/// @brief Check if the directory exists.
 		bool IsDirectoryExists(const String& path) const;
+		bool IsDirectoryExists(const FilePath& path) const;
 
 		/// @brief Create a empty file at the given path.
 		ResultCode CreateFile(const String& path);
+		ResultCode CreateFile(const FilePath& path);
 		/// @brief Create a empty directory at the given path.
 		ResultCode CreateDirectory(const String& path);
+		ResultCode CreateDirectory(const FilePath& path);
 
 		/// @brief Open the file at the given path with the given mode.\n
 		/// If the mode is read-only, and the file doesn't exists, the operation will fail.
 		ResultPair<IntrusivePtr<FileStream>> OpenFile(const String& path, FileStream::OpenMode mode);
+		ResultPair<IntrusivePtr<FileStream>> OpenFile(const FilePath& path, FileStream::OpenMode mode);
+		/// @brief Map the file at the given path read-only into memory, for reading big files without copies.\n
+		/// Fails with ResultCode::NotSupported if the protocol has no mapping.
+		ResultPair<IntrusivePtr<MappedFileStream>> MapFile(const String& path);
+		ResultPair<IntrusivePtr<MappedFileStream>> MapFile(const FilePath& path);
 
 		/// @brief Delete a file.
 		ResultCode RemoveFile(const String& path);
+		ResultCode RemoveFile(const FilePath& path);
 		/// @brief Delete a directory.
 		ResultCode RemoveDirectory(const String& path);
+		ResultCode RemoveDirectory(const FilePath& path);
 
 		/// @brief Enumerate all files only in the given path.
 		ResultCode GetAllFiles(const String& path, List<String>& result) const;
+		ResultCode GetAllFiles(const FilePath& path, List<String>& result) const;
 		/// @brief Enumerate all directories only in the given path.
 		ResultCode GetAllDirectories(const String& path, List<String>& result) const;
+		ResultCode GetAllDirectories(const FilePath& path, List<String>& result) const;
+		/// @brief Enumerate the files and directories under the given path, recursively by default, into compact entries.\n
+		/// Much cheaper than GetAllFiles() and GetAllDirectories() for big trees. Fails with ResultCode::NotSupported if the protocol can't.
+		ResultCode Enumerate(const String& path, const FileEnumerateConfig& config, FileEntryList& result) const;
+		ResultCode Enumerate(const FilePath& path, const FileEnumerateConfig& config, FileEntryList& result) const;
+#pragma endregion
+
+#pragma region Async
+		/// @brief Thread-safe. Read the whole file on the I/O thread, started on the first call.\n
+		/// Poll the returned read with AsyncFileRead::IsDone(), or get called back as a job of the JobSystem.
+		/// @param jobSystem Runs the callback, nullptr to call it on the I/O thread.
+		SharedPtr<AsyncFileRead> ReadFileAsync(const String& path, AsyncFileRead::Callback callback = nullptr, void* userData = nullptr, JobSystem* jobSystem = nullptr, Job::Priority priority = Job::Priority::Background);
 #pragma endregion
 
 	private:
 		void AddProtocol(const String& name, FileProtocol::Protocol protocol);
 		void AddProtocolHandler(FileProtocol::Protocol protocol, UniquePtr<FileProtocol>&& handler);
 
-		struct SplitData {
-			SplitData(FileProtocol::Protocol protocol, int32 index) :protocol(protocol), index(index) {}
-			FileProtocol::Protocol protocol;
-			int32 index;
-		};
-		SplitData GetSplitData(const String& path) const;
-
 		Dictionary<String, FileProtocol::Protocol> protocols{};
 		Dictionary<FileProtocol::Protocol, SharedPtr<FileProtocol>> protocolHandlers{};
+		Mutex asyncReaderMutex{};
+		UniquePtr<AsyncFileReader> asyncReader{};
 	};
 }
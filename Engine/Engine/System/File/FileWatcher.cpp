@@ -0,0 +1,446 @@
+#include "Engine/System/File/FileWatcher.h"
+#include "Engine/System/File/FileSystem.h"
+#include "Engine/Platform/Definition.h"
+#include <chrono>
+#include <filesystem>
+
+#if CURRENT_PLATFORM_WINDOWS
+#	include "Engine/Platform/Windows/BetterWindows.h"
+#	undef CreateFile
+#	undef CreateDirectory
+#	undef RemoveDirectory
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+#	include <sys/inotify.h>
+#	include <unistd.h>
+#endif
+
+namespace Engine {
+	struct FileWatcher::Watched {
+		int32 id = 0;
+		/// @brief As given to Watch(), without the separators at the end.
+		String path{};
+		String nativePath{};
+		FileProtocol* handler = nullptr;
+		String handlerPath{};
+		bool recursive = true;
+#if CURRENT_PLATFORM_WINDOWS
+		HANDLE directory = INVALID_HANDLE_VALUE;
+		OVERLAPPED overlapped{};
+		/// @brief Where the OS writes the notifications, DWORD aligned.
+		DWORD buffer[16384];
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		List<int32> descriptors{};
+#endif
+	};
+
+	namespace {
+		String TrimSeparators(const String& path) {
+			int32 count = path.GetCount();
+			while (count > 1 && (path[count - 1] == '/' || path[count - 1] == '\\')) {
+				count -= 1;
+			}
+			return count == path.GetCount() ? path : path.Substring(0, count);
+		}
+
+		String JoinPath(const String& directory, const String& name) {
+			if (directory.GetCount() == 0) {
+				return name;
+			}
+			if (name.GetCount() == 0) {
+				return directory;
+			}
+			return directory + STRL("/") + name;
+		}
+
+		/// @return false if the change cancels the previous one out.
+		bool Coalesce(FileChange::Kind& previous, FileChange::Kind next) {
+			using Kind = FileChange::Kind;
+			if (previous == Kind::Overflow || next == Kind::Overflow) {
+				previous = Kind::Overflow;
+			} else if (previous == Kind::Added) {
+				// Still new, unless it's gone already.
+				return next != Kind::Removed;
+			} else {
+				// Removed then added again is a replacement, so modified too.
+				previous = next == Kind::Removed ? Kind::Removed : Kind::Modified;
+			}
+			return true;
+		}
+
+#if CURRENT_PLATFORM_WINDOWS
+		static constexpr DWORD NotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		static constexpr uint32 NotifyMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+#endif
+	}
+
+	FileWatcher::FileWatcher(FileSystem* fileSystem) :fileSystem(fileSystem) {
+#if CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		ERR_ASSERT(notify >= 0, u8"Failed to create the inotify instance, nothing can be watched!", return);
+#endif
+	}
+
+	FileWatcher::~FileWatcher() {
+		List<int32> ids{};
+		for (const auto& pair : watches) {
+			ids.Add(pair.key);
+		}
+		for (int32 id : ids) {
+			Unwatch(id);
+		}
+#if CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		if (notify >= 0) {
+			close(notify);
+		}
+#endif
+	}
+
+	ResultPair<int32> FileWatcher::Watch(const String& path, bool recursive) {
+		FilePath parsed = fileSystem->ParsePath(path);
+		ERR_ASSERT(parsed.IsValid(), u8"Invalid path protocol!", return ResultPair<int32>(ResultCode::InvalidArgument, 0));
+		FileProtocol* handler = parsed.GetHandler();
+		String handlerPath = TrimSeparators(parsed.GetHandlerPath());
+		String nativePath{};
+		if (handler == nullptr || handler->GetNativePath(handlerPath, nativePath) != ResultCode::OK) {
+			return ResultPair<int32>(ResultCode::NotSupported, 0);
+		}
+		if (!handler->IsDirectoryExists(handlerPath)) {
+			return ResultPair<int32>(ResultCode::NotFound, 0);
+		}
+
+		auto watched = SharedPtr<Watched>::Create();
+		watched->id = nextId;
+		int32 trimmed = parsed.GetHandlerPath().GetCount() - handlerPath.GetCount();
+		watched->path = trimmed > 0 ? path.Substring(0, path.GetCount() - trimmed) : path;
+		watched->nativePath = nativePath;
+		watched->handler = handler;
+		watched->handlerPath = handlerPath;
+		watched->recursive = recursive;
+
+#if CURRENT_PLATFORM_WINDOWS
+		watched->directory = CreateFileW(
+			std::filesystem::u8path(nativePath.GetStringView()).c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr
+		);
+		ERR_ASSERT(watched->directory != INVALID_HANDLE_VALUE, u8"Failed to open the directory to watch!", return ResultPair<int32>(ResultCode::UnknownError, 0));
+		BOOL started = ReadDirectoryChangesW(watched->directory, watched->buffer, sizeof(watched->buffer), recursive, NotifyFilter, nullptr, &watched->overlapped, nullptr);
+		if (!started) {
+			CloseHandle(watched->directory);
+			ERR_ASSERT(started, u8"Failed to watch the directory!", return ResultPair<int32>(ResultCode::UnknownError, 0));
+		}
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		if (notify < 0) {
+			return ResultPair<int32>(ResultCode::NotSupported, 0);
+		}
+		AddDirectory(*watched.GetRaw(), String(), false, GetTime());
+		ERR_ASSERT(watched->descriptors.GetCount() > 0, u8"Failed to watch the directory!", return ResultPair<int32>(ResultCode::UnknownError, 0));
+#else
+		return ResultPair<int32>(ResultCode::NotSupported, 0);
+#endif
+
+		watches.Set(nextId, watched);
+		nextId += 1;
+		return ResultPair<int32>(ResultCode::OK, watched->id);
+	}
+
+	void FileWatcher::Unwatch(int32 watch) {
+		SharedPtr<Watched> watched{};
+		if (!watches.TryGet(watch, watched)) {
+			return;
+		}
+#if CURRENT_PLATFORM_WINDOWS
+		if (watched->directory != INVALID_HANDLE_VALUE) {
+			// The OS writes into the buffer until the cancelled read is over.
+			CancelIoEx(watched->directory, &watched->overlapped);
+			DWORD bytes = 0;
+			GetOverlappedResult(watched->directory, &watched->overlapped, &bytes, TRUE);
+			CloseHandle(watched->directory);
+		}
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		for (int32 descriptor : watched->descriptors) {
+			List<DirectoryTarget> owners{};
+			if (!targets.TryGet(descriptor, owners)) {
+				continue;
+			}
+			for (int32 i = owners.GetCount() - 1; i >= 0; i -= 1) {
+				if (owners[i].watch == watch) {
+					owners.RemoveAt(i);
+				}
+			}
+			if (owners.GetCount() == 0) {
+				inotify_rm_watch(notify, descriptor);
+				targets.Remove(descriptor);
+			} else {
+				targets.Set(descriptor, owners);
+			}
+		}
+#endif
+		watches.Remove(watch);
+
+		for (int32 i = 0; i < pending.GetCount(); i += 1) {
+			Pending& one = pending[i];
+			if (one.change.watch == watch && !one.cancelled) {
+				one.cancelled = true;
+				pendingIndices.Remove(one.change.path);
+			}
+		}
+	}
+
+	int32 FileWatcher::GetWatchCount() const {
+		return watches.GetCount();
+	}
+
+	void FileWatcher::SetDebounceTime(int32 milliseconds) {
+		debounceTime = milliseconds > 0 ? milliseconds : 0;
+	}
+
+	int32 FileWatcher::GetDebounceTime() const {
+		return debounceTime;
+	}
+
+	void FileWatcher::Update(List<FileChange>& result) {
+		int64 now = GetTime();
+		Collect(now);
+
+		bool taken = false;
+		for (int32 i = 0; i < pending.GetCount(); i += 1) {
+			Pending& one = pending[i];
+			if (!one.cancelled && now - one.time >= debounceTime) {
+				result.Add(one.change);
+				one.cancelled = true;
+				taken = true;
+			}
+		}
+		if (!taken && pendingIndices.GetCount() == pending.GetCount()) {
+			return;
+		}
+
+		// Keep the ones still waiting, in order.
+		int32 kept = 0;
+		pendingIndices.Clear();
+		for (int32 i = 0; i < pending.GetCount(); i += 1) {
+			if (pending[i].cancelled) {
+				continue;
+			}
+			if (kept != i) {
+				pending[kept] = Memory::Move(pending[i]);
+			}
+			pendingIndices.Set(pending[kept].change.path, kept);
+			kept += 1;
+		}
+		pending.SetCount(kept);
+	}
+
+	int32 FileWatcher::GetPendingCount() const {
+		return pendingIndices.GetCount();
+	}
+
+	int64 FileWatcher::GetTime() {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void FileWatcher::Record(const Watched& watched, const String& relative, FileChange::Kind kind, bool directory, int64 now) {
+		String path = JoinPath(watched.path, relative);
+		int32 index = -1;
+		if (pendingIndices.TryGet(path, index)) {
+			Pending& previous = pending[index];
+			previous.time = now;
+			previous.change.directory = previous.change.directory || directory;
+			if (!Coalesce(previous.change.kind, kind)) {
+				previous.cancelled = true;
+				pendingIndices.Remove(path);
+			}
+			return;
+		}
+
+		Pending& added = pending.Emplace();
+		added.change.kind = kind;
+		added.change.directory = directory;
+		added.change.path = path;
+		added.change.watch = watched.id;
+		added.time = now;
+		added.cancelled = false;
+		pendingIndices.Set(path, pending.GetCount() - 1);
+	}
+
+	void FileWatcher::Collect(int64 now) {
+#if CURRENT_PLATFORM_WINDOWS
+		for (const auto& pair : watches) {
+			Watched& watched = *pair.value.GetRaw();
+			if (watched.directory == INVALID_HANDLE_VALUE) {
+				continue;
+			}
+			DWORD bytes = 0;
+			if (!GetOverlappedResult(watched.directory, &watched.overlapped, &bytes, FALSE)) {
+				if (GetLastError() != ERROR_IO_INCOMPLETE) {
+					// The directory itself is gone.
+					Record(watched, String(), FileChange::Kind::Removed, true, now);
+					CloseHandle(watched.directory);
+					watched.directory = INVALID_HANDLE_VALUE;
+				}
+				continue;
+			}
+
+			if (bytes == 0) {
+				// The buffer overflowed and the notifications are lost.
+				Record(watched, String(), FileChange::Kind::Overflow, true, now);
+			}
+			const byte* cursor = bytes > 0 ? (const byte*)watched.buffer : nullptr;
+			while (cursor != nullptr) {
+				const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)cursor;
+				char name[MAX_PATH * 3];
+				int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, (int)(info->FileNameLength / sizeof(WCHAR)), name, sizeof(name), nullptr, nullptr);
+				for (int i = 0; i < length; i += 1) {
+					name[i] = name[i] == '\\' ? '/' : name[i];
+				}
+				String relative((const u8char*)name, length);
+
+				FileChange::Kind kind = FileChange::Kind::Modified;
+				if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+					kind = FileChange::Kind::Added;
+				} else if (info->Action == FILE_ACTION_REMOVED || info->Action == FILE_ACTION_RENAMED_OLD_NAME) {
+					kind = FileChange::Kind::Removed;
+				}
+				bool directory = false;
+				if (kind != FileChange::Kind::Removed) {
+					DWORD attributes = GetFileAttributesW(std::filesystem::u8path(JoinPath(watched.nativePath, relative).GetStringView()).c_str());
+					directory = attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+				}
+				// A directory is modified whenever its content changes, which is reported by itself.
+				if (length > 0 && !(directory && kind == FileChange::Kind::Modified)) {
+					Record(watched, relative, kind, directory, now);
+				}
+				cursor = info->NextEntryOffset != 0 ? cursor + info->NextEntryOffset : nullptr;
+			}
+
+			watched.overlapped = OVERLAPPED{};
+			if (!ReadDirectoryChangesW(watched.directory, watched.buffer, sizeof(watched.buffer), watched.recursive, NotifyFilter, nullptr, &watched.overlapped, nullptr)) {
+				Record(watched, String(), FileChange::Kind::Removed, true, now);
+				CloseHandle(watched.directory);
+				watched.directory = INVALID_HANDLE_VALUE;
+			}
+		}
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		if (notify < 0) {
+			return;
+		}
+		alignas(inotify_event) char buffer[4096];
+		while (true) {
+			ssize_t length = read(notify, buffer, sizeof(buffer));
+			if (length <= 0) {
+				break;
+			}
+			for (ssize_t offset = 0; offset < length;) {
+				const inotify_event* event = (const inotify_event*)(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				if ((event->mask & IN_Q_OVERFLOW) != 0) {
+					for (const auto& pair : watches) {
+						Record(*pair.value.GetRaw(), String(), FileChange::Kind::Overflow, true, now);
+					}
+					continue;
+				}
+				List<DirectoryTarget> owners{};
+				if (!targets.TryGet(event->wd, owners)) {
+					continue;
+				}
+				if ((event->mask & IN_IGNORED) != 0) {
+					// The directory is gone and so is the descriptor, which may be reused.
+					targets.Remove(event->wd);
+					for (const DirectoryTarget& owner : owners) {
+						SharedPtr<Watched> watched{};
+						if (!watches.TryGet(owner.watch, watched)) {
+							continue;
+						}
+						List<int32>& descriptors = watched->descriptors;
+						for (int32 i = descriptors.GetCount() - 1; i >= 0; i -= 1) {
+							if (descriptors[i] == event->wd) {
+								descriptors.RemoveAt(i);
+							}
+						}
+					}
+					continue;
+				}
+
+				for (const DirectoryTarget& owner : owners) {
+					SharedPtr<Watched> watched{};
+					if (!watches.TryGet(owner.watch, watched)) {
+						continue;
+					}
+					if (event->len == 0) {
+						// Events of the directory itself, the ones under the root are reported by their parents.
+						if (owner.relative.GetCount() == 0 && (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0) {
+							Record(*watched.GetRaw(), String(), FileChange::Kind::Removed, true, now);
+						}
+						if ((event->mask & IN_MOVE_SELF) != 0) {
+							// Watching it at its new place would report wrong paths.
+							inotify_rm_watch(notify, event->wd);
+						}
+						continue;
+					}
+
+					String relative = JoinPath(owner.relative, String((const u8char*)event->name));
+					bool directory = (event->mask & IN_ISDIR) != 0;
+					FileChange::Kind kind = FileChange::Kind::Modified;
+					if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+						kind = FileChange::Kind::Added;
+					} else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+						kind = FileChange::Kind::Removed;
+					}
+					Record(*watched.GetRaw(), relative, kind, directory, now);
+					if (kind == FileChange::Kind::Added && directory && watched->recursive) {
+						AddDirectory(*watched.GetRaw(), relative, true, now);
+					}
+				}
+			}
+		}
+#endif
+	}
+
+	void FileWatcher::AddDirectory(Watched& watched, const String& relative, bool reportContents, int64 now) {
+#if CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		String nativePath = JoinPath(watched.nativePath, relative);
+		int32 descriptor = inotify_add_watch(notify, (const char*)nativePath.ToIndividual().GetRawArray(), NotifyMask);
+		if (descriptor < 0) {
+			return;
+		}
+		List<DirectoryTarget> owners{};
+		targets.TryGet(descriptor, owners);
+		bool known = false;
+		for (const DirectoryTarget& owner : owners) {
+			known = known || owner.watch == watched.id;
+		}
+		if (!known) {
+			DirectoryTarget& owner = owners.Emplace();
+			owner.watch = watched.id;
+			owner.relative = relative;
+			targets.Set(descriptor, owners);
+			watched.descriptors.Add(descriptor);
+		}
+		if (!watched.recursive) {
+			return;
+		}
+
+		// inotify watches one directory, each one under it needs its own watch.
+		// Watched before listing, so what shows up meanwhile is reported either way.
+		FileEnumerateConfig config{};
+		config.recursive = false;
+		config.includeFiles = reportContents;
+		FileEntryList entries{};
+		if (watched.handler->Enumerate(JoinPath(watched.handlerPath, relative), config, entries) != ResultCode::OK) {
+			return;
+		}
+		for (int32 i = 0; i < entries.GetCount(); i += 1) {
+			String child = JoinPath(relative, entries.GetPath(i));
+			bool directory = entries[i].type == FileEntry::Type::Directory;
+			if (reportContents) {
+				Record(watched, child, FileChange::Kind::Added, directory, now);
+			}
+			if (directory) {
+				AddDirectory(watched, child, reportContents, now);
+			}
+		}
+#endif
+	}
+}
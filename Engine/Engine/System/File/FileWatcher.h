@@ -0,0 +1,99 @@
+#pragma once
+#include "Engine/System/String.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Memory/SharedPtr.h"
+
+namespace Engine {
+	class FileSystem;
+	class FileProtocol;
+
+	/// @brief A change reported by FileWatcher::Update().
+	struct FileChange {
+		enum class Kind :byte {
+			Added,
+			Modified,
+			Removed,
+			/// @brief The OS dropped events, anything under the path may have changed. Rescan it.
+			Overflow,
+		};
+
+		Kind kind;
+		/// @brief Whether the path is a directory. Always false for removed entries on Windows, which doesn't tell.
+		bool directory;
+		/// @brief The watched path, then the changed one relative to it, separated with '/'.
+		String path;
+		/// @brief The id returned by FileWatcher::Watch().
+		int32 watch;
+	};
+
+	/// @brief Tells which files under some directories changed, with inotify on Linux and ReadDirectoryChangesW on Windows.\n
+	/// Nothing runs in the background: Update() takes what the OS queued, coalesces the events of each path
+	/// and returns them once the path stayed quiet for the debounce time, so a save done in many writes is reported once.\n
+	/// Coalescing keeps what happened overall: added then modified is added, removed then added is modified, added then removed is nothing.\n
+	/// Not thread-safe, call everything from the thread the changes are handled on, once a frame for example.
+	class FileWatcher final {
+	public:
+		/// @brief In milliseconds.
+		static inline constexpr int32 DefaultDebounceTime = 100;
+
+		/// @param fileSystem Resolves the watched paths, which need a protocol with a native path, see FileProtocol::GetNativePath().
+		FileWatcher(FileSystem* fileSystem);
+		~FileWatcher();
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		/// @brief Start watching the directory, and all under it when recursive.
+		/// @return The id of the watch, or ResultCode::NotFound if there is no such directory,
+		/// ResultCode::NotSupported if the protocol or the platform can't be watched.
+		ResultPair<int32> Watch(const String& path, bool recursive = true);
+		/// @brief Stop watching. The pending changes of the watch are dropped.
+		void Unwatch(int32 watch);
+		int32 GetWatchCount() const;
+
+		void SetDebounceTime(int32 milliseconds);
+		int32 GetDebounceTime() const;
+
+		/// @brief Add the changes done debouncing to the end of the result, oldest first.
+		void Update(List<FileChange>& result);
+		/// @brief Changes recorded but still in their debounce time.
+		int32 GetPendingCount() const;
+
+	private:
+		/// @brief Platform state of a watch, defined with the implementation.
+		struct Watched;
+		struct Pending {
+			FileChange change;
+			/// @brief Of the latest event, in milliseconds.
+			int64 time;
+			/// @brief Came and went within the debounce time, nothing to report.
+			bool cancelled;
+		};
+		/// @brief A watched directory, relative to the root of its watch.
+		struct DirectoryTarget {
+			int32 watch;
+			String relative;
+		};
+
+		static int64 GetTime();
+		/// @brief Read what the OS queued into the pending changes.
+		void Collect(int64 now);
+		void Record(const Watched& watched, const String& relative, FileChange::Kind kind, bool directory, int64 now);
+		/// @brief Linux only. Watch the directory and the ones under it when recursive,
+		/// reporting what is in them as added when they showed up after the watch started.
+		void AddDirectory(Watched& watched, const String& relative, bool reportContents, int64 now);
+
+		FileSystem* fileSystem;
+		int32 debounceTime = DefaultDebounceTime;
+		int32 nextId = 1;
+		// No initializer, Watched is only complete in the implementation.
+		Dictionary<int32, SharedPtr<Watched>> watches;
+		List<Pending> pending{};
+		/// @brief Index of each path in the pending changes.
+		Dictionary<String, int32> pendingIndices{};
+
+		/// @brief Linux only, the inotify instance and what each of its watch descriptors belongs to.
+		int32 notify = -1;
+		Dictionary<int32, List<DirectoryTarget>> targets{};
+	};
+}
@@ -0,0 +1,103 @@
+#include "Engine/System/File/Glob.h"
+
+namespace Engine {
+	namespace {
+		/// @brief The length of the UTF-8 sequence starting at the index, so '?' takes a whole char.
+		sizeint GetCharLength(std::string_view path, sizeint index) {
+			sizeint end = index + 1;
+			while (end < path.size() && ((byte)path[end] & 0xC0) == 0x80) {
+				end += 1;
+			}
+			return end - index;
+		}
+	}
+
+	bool Glob::Match(std::string_view pattern, std::string_view path) {
+		sizeint p = 0;
+		sizeint s = 0;
+		while (p < pattern.size()) {
+			char c = pattern[p];
+			if (c == '*') {
+				bool any = p + 1 < pattern.size() && pattern[p + 1] == '*';
+				sizeint next = p + (any ? 2 : 1);
+				if (any && next < pattern.size() && pattern[next] == '/' && Match(pattern.substr(next + 1), path.substr(s))) {
+					return true;
+				}
+				std::string_view rest = pattern.substr(next);
+				for (sizeint i = s;; i += 1) {
+					if (Match(rest, path.substr(i))) {
+						return true;
+					}
+					if (i >= path.size() || (!any && path[i] == '/')) {
+						return false;
+					}
+				}
+			}
+			if (s >= path.size()) {
+				return false;
+			}
+
+			if (c == '?') {
+				if (path[s] == '/') {
+					return false;
+				}
+				s += GetCharLength(path, s);
+				p += 1;
+				continue;
+			}
+			if (c == '[') {
+				bool matched = false;
+				sizeint end = MatchClass(pattern, p, path[s], matched);
+				if (end != p) {
+					if (!matched) {
+						return false;
+					}
+					s += 1;
+					p = end;
+					continue;
+				}
+			} else if (c == '\\' && p + 1 < pattern.size()) {
+				p += 1;
+				c = pattern[p];
+			}
+			if (path[s] != c) {
+				return false;
+			}
+			s += 1;
+			p += 1;
+		}
+		return s == path.size();
+	}
+
+	bool Glob::HasSeparator(std::string_view pattern) {
+		return pattern.find('/') != std::string_view::npos;
+	}
+
+	sizeint Glob::MatchClass(std::string_view pattern, sizeint index, char c, bool& matched) {
+		sizeint i = index + 1;
+		bool negated = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+		if (negated) {
+			i += 1;
+		}
+		bool found = false;
+		// A ']' right after the '[' is part of the set.
+		sizeint first = i;
+		while (i < pattern.size() && (pattern[i] != ']' || i == first)) {
+			char low = pattern[i];
+			char high = low;
+			if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+				high = pattern[i + 2];
+				i += 2;
+			}
+			if (c >= low && c <= high) {
+				found = true;
+			}
+			i += 1;
+		}
+		if (i >= pattern.size()) {
+			return index;
+		}
+		matched = (found != negated) && c != '/';
+		return i + 1;
+	}
+}
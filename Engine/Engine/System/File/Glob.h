@@ -0,0 +1,19 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include <string_view>
+
+namespace Engine {
+	/// @brief Shell-style wildcard matching of '/' separated paths, case-sensitive.\n
+	/// '*' matches any chars but '/', "**" any chars including '/', and "**/" also matches no directory at all.
+	/// '?' matches one char but '/', "[abc]", "[a-z]" and "[!abc]" match one ASCII char of the set or not in it, '\\' escapes the next char.
+	class Glob final {
+	public:
+		static bool Match(std::string_view pattern, std::string_view path);
+		/// @brief Whether the pattern tells directories apart, otherwise it is usually matched with names only.
+		static bool HasSeparator(std::string_view pattern);
+
+	private:
+		/// @return The index after the class, or the index of the '[' if it is not closed.
+		static sizeint MatchClass(std::string_view pattern, sizeint index, char c, bool& matched);
+	};
+}
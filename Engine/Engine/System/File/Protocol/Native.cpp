@@ -1,10 +1,132 @@
 #include "Engine/System/File/Protocol/Native.h"
+#include "Engine/System/File/Glob.h"
+#include "Engine/System/Thread/JobSystem.h"
 #include <filesystem>
+#include <cerrno>
+#include <cstring>
 #include "Engine/System/Collection/List.h"
+#include "Engine/Platform/Definition.h"
+
+#if CURRENT_PLATFORM_WINDOWS
+#	include "Engine/Platform/Windows/BetterWindows.h"
+// Same names as the protocol members.
+#	undef CreateFile
+#	undef CreateDirectory
+#	undef RemoveDirectory
+#else
+#	include <dirent.h>
+#	include <fcntl.h>
+#	if CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+#		include <sys/inotify.h>
+#	endif
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
 
 namespace fs = std::filesystem;
 
 namespace Engine {
+	namespace {
+		/// @brief A NULL-terminated UTF-8 path for the C APIs, copied only when the String doesn't end with NULL already.
+		class NativePath final {
+		public:
+			NativePath(const String& path) {
+				if (path.IsNullTerminated()) {
+					chars = (const char*)path.GetStartPtr();
+				} else {
+					copy = path.ToIndividual();
+					chars = (const char*)copy.GetRawArray();
+				}
+			}
+			NativePath(const NativePath&) = delete;
+			NativePath& operator=(const NativePath&) = delete;
+
+			const char* Get() const {
+				return chars;
+			}
+
+		private:
+			String copy{};
+			const char* chars = nullptr;
+		};
+
+		/// @brief Open a FILE by a UTF-8 path. Windows takes wide paths for anything past ASCII.
+		std::FILE* OpenNativeFile(const String& path, const char* mode) {
+#if CURRENT_PLATFORM_WINDOWS
+			wchar_t wideMode[8] = {};
+			for (int32 i = 0; mode[i] != '\0' && i < 7; i += 1) {
+				wideMode[i] = (wchar_t)mode[i];
+			}
+			return _wfopen(fs::u8path(path.GetStringView()).c_str(), wideMode);
+#else
+			return std::fopen(NativePath(path).Get(), mode);
+#endif
+		}
+
+		ResultCode GetErrnoResult(int error) {
+			switch (error) {
+			case ENOENT:
+			case ENOTDIR:
+				return ResultCode::NotFound;
+			case EACCES:
+			case EPERM:
+				return ResultCode::NoPermission;
+			case EEXIST:
+				return ResultCode::AlreadyExists;
+			default:
+				return ResultCode::UnknownError;
+			}
+		}
+
+		bool IsSeparator(u8char c) {
+#if CURRENT_PLATFORM_WINDOWS
+			return c == '/' || c == '\\';
+#else
+			return c == '/';
+#endif
+		}
+
+		/// @brief The path without the separators at the end, "." for the current directory.
+		String GetDirectoryKey(const String& path) {
+			int32 count = path.GetCount();
+			while (count > 1 && IsSeparator(path[count - 1])) {
+#if CURRENT_PLATFORM_WINDOWS
+				// "C:\\" is the root, "C:" is the current directory of the drive.
+				if (path[count - 2] == ':') {
+					break;
+				}
+#endif
+				count -= 1;
+			}
+			if (count == 0) {
+				return STRL(".");
+			}
+			return count == path.GetCount() ? path : path.Substring(0, count);
+		}
+
+		/// @brief Split the path into the directory holding it, see GetDirectoryKey(), and its name in there.
+		/// @return false for the root, which is in no directory.
+		bool SplitPath(const String& path, String& directory, String& name) {
+			String trimmed = GetDirectoryKey(path);
+			int32 count = trimmed.GetCount();
+			int32 separator = count - 1;
+			while (separator >= 0 && !IsSeparator(trimmed[separator])) {
+				separator -= 1;
+			}
+			if (separator == count - 1) {
+				return false;
+			}
+			name = trimmed.Substring(separator + 1, count - separator - 1);
+			if (separator < 0) {
+				directory = STRL(".");
+			} else {
+				directory = GetDirectoryKey(separator == 0 ? trimmed.Substring(0, 1) : trimmed.Substring(0, separator));
+			}
+			return true;
+		}
+	}
+
 #pragma region Protocol
 	ResultCode FileProtocolNative::GetResult(const std::error_code& err) {
 		if (err == std::errc::permission_denied) {
@@ -18,59 +140,87 @@ namespace Engine {
 		}
 	}
 
-	bool FileProtocolNative::IsFileExists(const String& path) const {
-		std::error_code err;
-		auto st = fs::status(fs::u8path(path.GetStringView()), err);
-		if (!fs::status_known(st)) {
-			return false;
+	FileProtocolNative::PathType FileProtocolNative::StatPath(const String& path) {
+#if CURRENT_PLATFORM_WINDOWS
+		DWORD attributes = GetFileAttributesW(fs::u8path(path.GetStringView()).c_str());
+		if (attributes == INVALID_FILE_ATTRIBUTES) {
+			return PathType::Missing;
+		}
+		return (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0 ? PathType::Directory : PathType::File;
+#else
+		struct stat status{};
+		if (stat(NativePath(path).Get(), &status) != 0) {
+			return PathType::Missing;
 		}
+		return S_ISDIR(status.st_mode) ? PathType::Directory : PathType::File;
+#endif
+	}
+
+	FileProtocolNative::PathType FileProtocolNative::GetPathType(const String& path) const {
+		SimpleLock<Mutex> lock(cacheMutex);
+		if (!cacheEnabled) {
+			return StatPath(path);
+		}
+		PollChanges();
 
-		auto type = st.type();
-		if (type == fs::file_type::not_found) {
-			return false;
+		String directory{};
+		String name{};
+		CachedDirectory* cached = SplitPath(path, directory, name) ? GetCachedDirectory(directory) : nullptr;
+		if (cached == nullptr) {
+			return StatPath(path);
 		}
-		if (type == fs::file_type::directory) {
-			return false;
+		PathType type = PathType::Missing;
+		if (!cached->types.TryGet(name, type)) {
+			// Watched before the stat, a change right after it is still reported.
+			type = StatPath(path);
+			cached->types.Set(name, type);
 		}
-		return true;
+		return type;
 	}
 
-	bool FileProtocolNative::IsDirectoryExists(const String& path) const {
-		std::error_code err;
-		auto st = fs::status(fs::u8path(path.GetStringView()), err);
-		if (!fs::status_known(st)) {
-			return false;
-		}
+	bool FileProtocolNative::IsFileExists(const String& path) const {
+		return GetPathType(path) == PathType::File;
+	}
 
-		return st.type() == fs::file_type::directory;
+	bool FileProtocolNative::IsDirectoryExists(const String& path) const {
+		return GetPathType(path) == PathType::Directory;
 	}
 
 	ResultCode FileProtocolNative::CreateFile(const String& path) {
 		if (IsFileExists(path)) {
 			return ResultCode::AlreadyExists;
 		}
-		FILE* f = std::fopen((char*)path.ToIndividual().GetRawArray(), "wb");
+		FILE* f = OpenNativeFile(path, "wb");
 		ERR_ASSERT(f != nullptr, u8"Failed to create file!", return ResultCode::UnknownError);
 
 		fclose(f);
+		{
+			SimpleLock<Mutex> lock(cacheMutex);
+			Invalidate(path);
+		}
 		return ResultCode::OK;
 	}
 
 	ResultCode FileProtocolNative::CreateDirectory(const String& path) {
 		std::error_code err;
 		fs::create_directories(fs::u8path(path.GetStringView()), err);
+		{
+			SimpleLock<Mutex> lock(cacheMutex);
+			// Every missing directory on the way was created, each of them may be cached as missing.
+			String current = path;
+			String directory{};
+			String name{};
+			Invalidate(current);
+			while (SplitPath(current, directory, name) && directory != STRL(".")) {
+				Invalidate(directory);
+				current = directory;
+			}
+		}
 		return GetResult(err);
 	}
 
 	ResultPair<IntrusivePtr<FileStream>> FileProtocolNative::OpenFile(const String& path, FileStream::OpenMode mode) {
 		ERR_ASSERT(FileStream::IsOpenModeValid(mode), u8"mode is invalid!", return ResultPair<IntrusivePtr<FileStream>>(ResultCode::InvalidArgument, IntrusivePtr<FileStream>(nullptr)));
-		// make sure the file exists when read-only.
-		if (FileStream::IsOpenModeReadOnly(mode)) {
-			ERR_ASSERT(
-				IsFileExists(path), u8"Attemped to open a non-existing file in read-only mode!",
-				return ResultPair<IntrusivePtr<FileStream>>(ResultCode::NotFound, IntrusivePtr<FileStream>(nullptr));
-			);
-		}
 		static const char* modes[] = { // See FileSystem::OpenMode, must be matched
 			"rb",	//ReadOnly
 			"wb",	//WriteTruncate
@@ -78,54 +228,439 @@ namespace Engine {
 			"w+b",	//ReadWriteTruncate
 			"w+ab"	//ReadWriteAppend
 		};
-		FILE* file = std::fopen((char*)path.ToIndividual().GetRawArray(), modes[(byte)mode]);
+		// No stat beforehand, a missing file is told by the failed open itself.
+		FILE* file = OpenNativeFile(path, modes[(byte)mode]);
 		ERR_ASSERT(file != nullptr, u8"Failed to open the file!",
-			return ResultPair<IntrusivePtr<FileStream>>(ResultCode::UnknownError, IntrusivePtr<FileStream>(nullptr))
+			return ResultPair<IntrusivePtr<FileStream>>(GetErrnoResult(errno), IntrusivePtr<FileStream>(nullptr))
 		);
+		if (FileStream::IsOpenModeWrite(mode)) {
+			SimpleLock<Mutex> lock(cacheMutex);
+			Invalidate(path);
+		}
 
 		auto fileStream = IntrusivePtr<FileStreamNative>::Create(file, mode);
 		return ResultPair<IntrusivePtr<FileStream>>(ResultCode::OK, fileStream);
 	}
 
+	ResultPair<IntrusivePtr<MappedFileStream>> FileProtocolNative::MapFile(const String& path) {
+		using Result = ResultPair<IntrusivePtr<MappedFileStream>>;
+
+		const byte* view = nullptr;
+		int64 length = 0;
+#if CURRENT_PLATFORM_WINDOWS
+		HANDLE file = CreateFileW(fs::u8path(path.GetStringView()).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		DWORD error = file == INVALID_HANDLE_VALUE ? GetLastError() : ERROR_SUCCESS;
+		ERR_ASSERT(file != INVALID_HANDLE_VALUE, u8"Failed to open the file!",
+			return Result(error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND ? ResultCode::NotFound : ResultCode::UnknownError, IntrusivePtr<MappedFileStream>(nullptr))
+		);
+		LARGE_INTEGER size{};
+		GetFileSizeEx(file, &size);
+		length = size.QuadPart;
+		if (length > 0) {
+			HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr) {
+				view = (const byte*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				// The view keeps the mapping alive.
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		int file = open(NativePath(path).Get(), O_RDONLY | O_CLOEXEC);
+		ERR_ASSERT(file >= 0, u8"Failed to open the file!", return Result(GetErrnoResult(errno), IntrusivePtr<MappedFileStream>(nullptr)));
+		struct stat status{};
+		fstat(file, &status);
+		length = (int64)status.st_size;
+		if (length > 0) {
+			void* mapped = mmap(nullptr, (size_t)length, PROT_READ, MAP_PRIVATE, file, 0);
+			view = mapped != MAP_FAILED ? (const byte*)mapped : nullptr;
+		}
+		// The mapping keeps the file alive.
+		close(file);
+#endif
+		ERR_ASSERT(length == 0 || view != nullptr, u8"Failed to map the file!", return Result(ResultCode::UnknownError, IntrusivePtr<MappedFileStream>(nullptr)));
+
+		auto stream = IntrusivePtr<MappedFileStreamNative>::Create(view, length);
+		return Result(ResultCode::OK, stream);
+	}
+
 	ResultCode FileProtocolNative::RemoveFile(const String& path) {
 		std::error_code err;
 		fs::remove(fs::u8path(path.GetStringView()), err);
+		{
+			SimpleLock<Mutex> lock(cacheMutex);
+			Invalidate(path);
+		}
 		return GetResult(err);
 	}
 
 	ResultCode FileProtocolNative::RemoveDirectory(const String& path) {
 		std::error_code err;
 		fs::remove_all(fs::u8path(path.GetStringView()), err);
+		{
+			SimpleLock<Mutex> lock(cacheMutex);
+			Invalidate(path);
+		}
 		return GetResult(err);
 	}
 
 	ResultCode FileProtocolNative::GetAllFiles(const String& path, List<String>& result) const {
+		return ListDirectory(path, result, false);
+	}
+
+	ResultCode FileProtocolNative::GetAllDirectories(const String& path, List<String>& result) const {
+		return ListDirectory(path, result, true);
+	}
+
+	ResultCode FileProtocolNative::ListDirectory(const String& path, List<String>& result, bool directories) const {
 		if (!IsDirectoryExists(path)) {
 			return ResultCode::NotFound;
 		}
 
-		auto iter = fs::directory_iterator(fs::u8path(path.GetStringView()));
-		for (const auto& one : iter) {
-			if (!one.is_directory()) {
-				result.Add(one.path().u8string());
+		SimpleLock<Mutex> lock(cacheMutex);
+		CachedDirectory* cached = cacheEnabled ? GetCachedDirectory(GetDirectoryKey(path)) : nullptr;
+		if (cached != nullptr && cached->listed) {
+			for (const String& one : directories ? cached->directories : cached->files) {
+				result.Add(one);
+			}
+			return ResultCode::OK;
+		}
+
+		std::error_code err;
+		auto iter = fs::directory_iterator(fs::u8path(path.GetStringView()), err);
+		if (err) {
+			ResultCode code = GetResult(err);
+			return code == ResultCode::OK ? ResultCode::UnknownError : code;
+		}
+		if (cached == nullptr) {
+			for (const auto& one : iter) {
+				if (one.is_directory() == directories) {
+					result.Add(one.path().u8string());
+				}
 			}
+			return ResultCode::OK;
+		}
+
+		// One listing fills both, the other one is usually asked for next.
+		for (const auto& one : iter) {
+			(one.is_directory() ? cached->directories : cached->files).Add(one.path().u8string());
+		}
+		cached->listed = true;
+		for (const String& one : directories ? cached->directories : cached->files) {
+			result.Add(one);
 		}
 		return ResultCode::OK;
 	}
 
-	ResultCode FileProtocolNative::GetAllDirectories(const String& path, List<String>& result) const {
+	ResultCode FileProtocolNative::Enumerate(const String& path, const FileEnumerateConfig& config, FileEntryList& result) const {
 		if (!IsDirectoryExists(path)) {
 			return ResultCode::NotFound;
 		}
 
-		auto iter = fs::directory_iterator(fs::u8path(path.GetStringView()));
-		for (const auto& one : iter) {
-			if (one.is_directory()) {
-				result.Add(one.path().u8string());
+		// Breadth first, so all the directories of a depth are known at once and scanned in parallel.
+		String root = GetDirectoryKey(path);
+		List<String> level{};
+		level.Add(String());
+		List<ScannedDirectory> scanned{};
+		bool first = true;
+		while (level.GetCount() > 0) {
+			scanned.Clear();
+			scanned.SetCount(level.GetCount());
+			auto scan = [&root, &config, &level, &scanned](int32 index) {
+				ScanDirectory(root, level[index], config, scanned[index]);
+			};
+			if (config.jobSystem != nullptr && level.GetCount() > 1) {
+				config.jobSystem->ParallelFor(0, level.GetCount(), 1, scan);
+			} else {
+				for (int32 i = 0; i < level.GetCount(); i += 1) {
+					scan(i);
+				}
+			}
+
+			// The directories under the root that can't be read are skipped.
+			if (first && scanned[0].result != ResultCode::OK) {
+				return scanned[0].result;
+			}
+			first = false;
+			level.Clear();
+			for (int32 i = 0; i < scanned.GetCount(); i += 1) {
+				ScannedDirectory& one = scanned[i];
+				result.Append(one.entries);
+				for (int32 j = 0; j < one.subdirectories.GetCount(); j += 1) {
+					level.Add(Memory::Move(one.subdirectories[j]));
+				}
 			}
 		}
 		return ResultCode::OK;
 	}
+
+	ResultCode FileProtocolNative::GetNativePath(const String& path, String& result) const {
+		result = path;
+		return ResultCode::OK;
+	}
+
+	void FileProtocolNative::ScanDirectory(const String& root, const String& directory, const FileEnumerateConfig& config, ScannedDirectory& result) {
+		std::string_view filter = config.filter.GetStringView();
+		bool matchName = !Glob::HasSeparator(filter);
+		auto isWanted = [&config, filter, matchName](std::string_view name, std::string_view path, FileEntry::Type type) {
+			bool included = type == FileEntry::Type::Directory ? config.includeDirectories : config.includeFiles;
+			return included && (filter.empty() || Glob::Match(filter, matchName ? name : path));
+		};
+
+		// The relative path of each entry is built in place after the one of the directory.
+		List<char> relative{};
+		std::string_view prefix = directory.GetStringView();
+		relative.SetCount((int32)prefix.size() + (prefix.empty() ? 0 : 1));
+		if (!prefix.empty()) {
+			std::memcpy(relative.GetRawElementPtr(), prefix.data(), prefix.size());
+			relative[(int32)prefix.size()] = '/';
+		}
+		int32 prefixLength = relative.GetCount();
+		auto setName = [&relative, prefixLength](const char* name, sizeint length) {
+			relative.SetCount(prefixLength + (int32)length);
+			std::memcpy(relative.GetRawElementPtr() + prefixLength, name, length);
+			return std::string_view(relative.GetRawElementPtr(), relative.GetCount());
+		};
+		auto add = [&config, &result](std::string_view path, FileEntry::Type type, bool link, bool wanted, int64 size, int64 modifiedTime) {
+			if (wanted) {
+				result.entries.Add(path, type, type == FileEntry::Type::Directory ? 0 : size, modifiedTime);
+			}
+			if (config.recursive && type == FileEntry::Type::Directory && !link) {
+				result.subdirectories.Add(String((const u8char*)path.data(), (int32)path.size()));
+			}
+		};
+
+		String full = root;
+		if (!prefix.empty()) {
+			full = IsSeparator(root[root.GetCount() - 1]) ? root + directory : root + STRL("/") + directory;
+		}
+#if CURRENT_PLATFORM_WINDOWS
+		std::wstring pattern = fs::u8path(full.GetStringView()).wstring() + L"\\*";
+		WIN32_FIND_DATAW data{};
+		HANDLE find = FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+		if (find == INVALID_HANDLE_VALUE) {
+			DWORD error = GetLastError();
+			result.result = error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND ? ResultCode::NotFound : error == ERROR_ACCESS_DENIED ? ResultCode::NoPermission : ResultCode::UnknownError;
+			return;
+		}
+		char name[MAX_PATH * 3];
+		do {
+			const wchar_t* wide = data.cFileName;
+			if (wide[0] == L'.' && (wide[1] == L'\0' || (wide[1] == L'.' && wide[2] == L'\0'))) {
+				continue;
+			}
+			int length = WideCharToMultiByte(CP_UTF8, 0, wide, -1, name, sizeof(name), nullptr, nullptr) - 1;
+			if (length <= 0) {
+				continue;
+			}
+			bool link = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+			FileEntry::Type type = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0 ? FileEntry::Type::Directory : FileEntry::Type::File;
+			int64 size = (int64)(((uint64)data.nFileSizeHigh << 32) | data.nFileSizeLow);
+			// FILETIME counts 100 nanoseconds since 1601.
+			int64 time = (int64)(((uint64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime);
+			time = (time - 116444736000000000LL) * 100;
+			std::string_view path = setName(name, length);
+			add(path, type, link, isWanted(std::string_view(name, length), path, type), size, time);
+		} while (FindNextFileW(find, &data));
+		FindClose(find);
+#else
+		DIR* handle = opendir(NativePath(full).Get());
+		if (handle == nullptr) {
+			result.result = GetErrnoResult(errno);
+			return;
+		}
+		int descriptor = dirfd(handle);
+		auto getType = [](const struct stat& status) {
+			return S_ISREG(status.st_mode) ? FileEntry::Type::File : S_ISDIR(status.st_mode) ? FileEntry::Type::Directory : FileEntry::Type::Other;
+		};
+		while (dirent* one = readdir(handle)) {
+			const char* name = one->d_name;
+			if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+				continue;
+			}
+			sizeint length = std::strlen(name);
+			std::string_view path = setName(name, length);
+
+			// The type usually comes with the listing, only links and some file systems need a stat for it.
+			bool link = one->d_type == DT_LNK;
+			FileEntry::Type type = one->d_type == DT_REG ? FileEntry::Type::File : one->d_type == DT_DIR ? FileEntry::Type::Directory : FileEntry::Type::Other;
+			struct stat status{};
+			bool stated = false;
+			if (one->d_type == DT_UNKNOWN && fstatat(descriptor, name, &status, AT_SYMLINK_NOFOLLOW) == 0) {
+				link = S_ISLNK(status.st_mode);
+				type = getType(status);
+				stated = !link;
+			}
+			if (link) {
+				// Listed as what it points to, Other when broken.
+				stated = fstatat(descriptor, name, &status, 0) == 0;
+				type = stated ? getType(status) : FileEntry::Type::Other;
+			}
+			// Size and time are only needed for what ends up in the result.
+			bool wanted = isWanted(std::string_view(name, length), path, type);
+			if (wanted && !stated) {
+				stated = fstatat(descriptor, name, &status, AT_SYMLINK_NOFOLLOW) == 0;
+			}
+#if CURRENT_PLATFORM_MACOS || CURRENT_PLATFORM_IOS
+			const timespec& modified = status.st_mtimespec;
+#else
+			const timespec& modified = status.st_mtim;
+#endif
+			int64 time = stated ? (int64)modified.tv_sec * 1000000000LL + modified.tv_nsec : 0;
+			add(path, type, link, wanted, stated ? (int64)status.st_size : 0, time);
+		}
+		closedir(handle);
+#endif
+	}
+#pragma endregion
+
+#pragma region Cache
+	FileProtocolNative::~FileProtocolNative() {
+		SimpleLock<Mutex> lock(cacheMutex);
+		DropAll();
+	}
+
+	void FileProtocolNative::SetCacheEnabled(bool enabled) {
+		SimpleLock<Mutex> lock(cacheMutex);
+		if (enabled == cacheEnabled) {
+			return;
+		}
+		if (!enabled) {
+			DropAll();
+		}
+#if CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		else {
+			notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			ERR_ASSERT(notify >= 0, u8"Failed to create the inotify instance, nothing is cached!", return);
+		}
+#endif
+		cacheEnabled = enabled;
+	}
+
+	bool FileProtocolNative::IsCacheEnabled() const {
+		SimpleLock<Mutex> lock(cacheMutex);
+		return cacheEnabled;
+	}
+
+	FileProtocolNative::CachedDirectory* FileProtocolNative::GetCachedDirectory(const String& directory) const {
+		SharedPtr<CachedDirectory> cached{};
+		if (cachedDirectories.TryGet(directory, cached)) {
+			return cached.GetRaw();
+		}
+
+		intptr_t watch = -1;
+#if CURRENT_PLATFORM_WINDOWS
+		HANDLE handle = FindFirstChangeNotificationW(fs::u8path(directory.GetStringView()).c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME);
+		if (handle == INVALID_HANDLE_VALUE) {
+			return nullptr;
+		}
+		watch = (intptr_t)handle;
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		int32 descriptor = inotify_add_watch(notify, NativePath(directory).Get(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+		if (descriptor < 0) {
+			return nullptr;
+		}
+		watch = descriptor;
+		// The same directory by another path gives back the same watch.
+		List<String> directories{};
+		watchedDirectories.TryGet(descriptor, directories);
+		directories.Add(directory);
+		watchedDirectories.Set(descriptor, directories);
+#else
+		// Nothing to watch the directory with, it can't be cached.
+		return nullptr;
+#endif
+		cached = SharedPtr<CachedDirectory>::Create();
+		cached->watch = watch;
+		cachedDirectories.Set(directory, cached);
+		return cached.GetRaw();
+	}
+
+	void FileProtocolNative::PollChanges() const {
+#if CURRENT_PLATFORM_WINDOWS
+		for (const auto& pair : cachedDirectories) {
+			HANDLE handle = (HANDLE)pair.value->watch;
+			if (WaitForSingleObject(handle, 0) == WAIT_OBJECT_0) {
+				pair.value->Clear();
+				FindNextChangeNotification(handle);
+			}
+		}
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		alignas(inotify_event) char buffer[4096];
+		while (true) {
+			ssize_t length = read(notify, buffer, sizeof(buffer));
+			if (length <= 0) {
+				break;
+			}
+			for (ssize_t offset = 0; offset < length;) {
+				const inotify_event* event = (const inotify_event*)(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				if ((event->mask & IN_Q_OVERFLOW) != 0) {
+					for (const auto& pair : cachedDirectories) {
+						pair.value->Clear();
+					}
+					continue;
+				}
+				List<String> directories{};
+				if (!watchedDirectories.TryGet(event->wd, directories)) {
+					continue;
+				}
+				for (const String& directory : directories) {
+					if ((event->mask & IN_IGNORED) != 0) {
+						// The directory is gone, so is its watch.
+						cachedDirectories.Remove(directory);
+						continue;
+					}
+					SharedPtr<CachedDirectory> cached{};
+					if (cachedDirectories.TryGet(directory, cached)) {
+						cached->Clear();
+					}
+				}
+				if ((event->mask & IN_IGNORED) != 0) {
+					watchedDirectories.Remove(event->wd);
+				}
+			}
+		}
+#endif
+	}
+
+	void FileProtocolNative::Invalidate(const String& path) const {
+		if (!cacheEnabled) {
+			return;
+		}
+		// Changes made here are reported too, but maybe not before the next lookup.
+		String directory{};
+		String name{};
+		SharedPtr<CachedDirectory> cached{};
+		if (SplitPath(path, directory, name) && cachedDirectories.TryGet(directory, cached)) {
+			cached->Clear();
+		}
+		String key = GetDirectoryKey(path);
+		for (const auto& pair : cachedDirectories) {
+			const String& one = pair.key;
+			if (one.StartsWith(key) && (one.GetCount() == key.GetCount() || IsSeparator(one[key.GetCount()]))) {
+				pair.value->Clear();
+			}
+		}
+	}
+
+	void FileProtocolNative::DropAll() {
+#if CURRENT_PLATFORM_WINDOWS
+		for (const auto& pair : cachedDirectories) {
+			FindCloseChangeNotification((HANDLE)pair.value->watch);
+		}
+#elif CURRENT_PLATFORM_LINUX || CURRENT_PLATFORM_ANDROID
+		if (notify >= 0) {
+			// Closing the instance removes all its watches.
+			close(notify);
+			notify = -1;
+		}
+		watchedDirectories.Clear();
+#endif
+		cachedDirectories.Clear();
+		cacheEnabled = false;
+	}
 #pragma endregion
 
 #pragma region File
@@ -187,10 +722,31 @@ namespace Engine {
 		return ResultCode::OK;
 	}
 
-	int32 FileStreamNative::ReadBytesUnchecked(int32 length, List<byte>& result) {
-		int32 read = (int32)fread(result.GetRawElementPtr() + result.GetCount() - length, sizeof(byte), length, file);
+	int32 FileStreamNative::ReadBytesUnchecked(byte* buffer, int32 length) {
+		int32 read = (int32)fread(buffer, sizeof(byte), length, file);
 		return read;
 	}
+
+	MappedFileStreamNative::MappedFileStreamNative(const byte* view, int64 length) {
+		SetView(view, length);
+	}
+	MappedFileStreamNative::~MappedFileStreamNative() {
+		Close();
+	}
+	void MappedFileStreamNative::Close() {
+		if (!IsValid()) {
+			return;
+		}
+		const byte* view = GetViewData();
+		if (view != nullptr) {
+#if CURRENT_PLATFORM_WINDOWS
+			UnmapViewOfFile(view);
+#else
+			munmap((void*)view, (size_t)GetLength());
+#endif
+		}
+		ClearView();
+	}
 #pragma endregion
 
 }
\ No newline at end of file
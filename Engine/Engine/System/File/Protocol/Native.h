@@ -1,14 +1,27 @@
 #pragma once
 #include "Engine/System/File/FileStream.h"
 #include "Engine/System/File/FileProtocol.h"
+#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/Thread/ThreadUtil.h"
 #include <cstdio>
 #include <system_error>
 
 namespace Engine {
+	/// @brief Files of the machine, paths are UTF-8.\n
+	/// With the cache enabled, whether a path is a file or a directory and the listings of directories are kept,
+	/// each directory watched with inotify or a change notification of Windows and forgotten once the OS reports a change in it.
+	/// Other platforms have nothing to watch with and never cache.
 	class FileProtocolNative final :public FileProtocol {
 		REFLECTION_CLASS(::Engine::FileProtocolNative, ::Engine::FileProtocol) {}
 
 	public:
+		~FileProtocolNative();
+
+		/// @brief Thread-safe. Start or stop caching, stopping drops everything cached.
+		void SetCacheEnabled(bool enabled);
+		bool IsCacheEnabled() const;
+
 		bool IsFileExists(const String& path) const override;
 		bool IsDirectoryExists(const String& path) const override;
 
@@ -16,15 +29,72 @@ namespace Engine {
 		ResultCode CreateDirectory(const String& path) override;
 
 		ResultPair<IntrusivePtr<FileStream>> OpenFile(const String& path, FileStream::OpenMode mode) override;
+		ResultPair<IntrusivePtr<MappedFileStream>> MapFile(const String& path) override;
 
 		ResultCode RemoveFile(const String& path) override;
 		ResultCode RemoveDirectory(const String& path) override;
 
 		ResultCode GetAllFiles(const String& path, List<String>& result) const override;
 		ResultCode GetAllDirectories(const String& path, List<String>& result) const override;
+		/// @brief Scans the directories of each depth in parallel on the job system. Entries come depth by depth,
+		/// in the order the OS lists each directory. Bypasses the cache.
+		ResultCode Enumerate(const String& path, const FileEnumerateConfig& config, FileEntryList& result) const override;
+		/// @brief The path itself.
+		ResultCode GetNativePath(const String& path, String& result) const override;
 
 	private:
+		enum class PathType :byte {
+			Missing,
+			File,
+			Directory,
+		};
+		/// @brief What is known of the children of a directory, until it changes.
+		struct CachedDirectory {
+			/// @brief inotify watch descriptor, or change notification HANDLE.
+			intptr_t watch = -1;
+			Dictionary<String, PathType> types{};
+			bool listed = false;
+			List<String> files{};
+			List<String> directories{};
+
+			void Clear() {
+				types.Clear();
+				listed = false;
+				files.Clear();
+				directories.Clear();
+			}
+		};
+
 		static ResultCode GetResult(const std::error_code& err);
+		static PathType StatPath(const String& path);
+		PathType GetPathType(const String& path) const;
+		ResultCode ListDirectory(const String& path, List<String>& result, bool directories) const;
+		/// @brief The result of scanning one directory for Enumerate().
+		struct ScannedDirectory {
+			ResultCode result = ResultCode::OK;
+			FileEntryList entries{};
+			/// @brief Relative paths of the subdirectories to scan next.
+			List<String> subdirectories{};
+		};
+		static void ScanDirectory(const String& root, const String& directory, const FileEnumerateConfig& config, ScannedDirectory& result);
+
+		/// @brief Get the cached directory, watching it first. Needs the cacheMutex.
+		/// @return nullptr if the directory cannot be watched, then nothing in it is cached.
+		CachedDirectory* GetCachedDirectory(const String& directory) const;
+		/// @brief Forget what is in the directories the OS reported changes in. Needs the cacheMutex.
+		void PollChanges() const;
+		/// @brief Forget what is in the directory holding the path and in the path itself with all under it, after changing it.
+		/// Needs the cacheMutex.
+		void Invalidate(const String& path) const;
+		/// @brief Stop watching and forget everything. Needs the cacheMutex.
+		void DropAll();
+
+		mutable Mutex cacheMutex{};
+		bool cacheEnabled = false;
+		mutable Dictionary<String, SharedPtr<CachedDirectory>> cachedDirectories{};
+		/// @brief Linux and Android only, the inotify instance and the directory of each watch.
+		int32 notify = -1;
+		mutable Dictionary<int32, List<String>> watchedDirectories{};
 	};
 
 	class FileStreamNative final : public FileStream {
@@ -45,7 +115,7 @@ namespace Engine {
 
 	protected:
 		ResultCode WriteBytesUnchecked(const byte* valuePtr, int32 length) override;
-		int32 ReadBytesUnchecked(int32 length, List<byte>& result) override;
+		int32 ReadBytesUnchecked(byte* buffer, int32 length) override;
 
 	private:
 		std::FILE* file;
@@ -53,4 +123,16 @@ namespace Engine {
 		bool canRead;
 		bool canWrite;
 	};
+
+	/// @brief Maps with mmap() or a file mapping of Windows. The file itself is closed once mapped, only the view is kept.
+	class MappedFileStreamNative final : public MappedFileStream {
+		REFLECTION_CLASS(::Engine::MappedFileStreamNative, ::Engine::MappedFileStream) {}
+
+	public:
+		/// @param view nullptr for an empty file.
+		MappedFileStreamNative(const byte* view, int64 length);
+		~MappedFileStreamNative();
+
+		void Close() override;
+	};
 }
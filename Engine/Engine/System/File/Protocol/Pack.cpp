@@ -0,0 +1,308 @@
+#include "Engine/System/File/Protocol/Pack.h"
+#include "Engine/System/Collection/List.h"
+#include <cstring>
+#include <cstdint>
+
+namespace Engine {
+#pragma region Layout
+	uint32 PackFile::HashPath(std::string_view path) {
+		uint32 hash = 2166136261u;
+		for (char c : path) {
+			hash ^= (byte)c;
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+	std::string_view PackFile::TrimPath(std::string_view path) {
+		while (!path.empty() && path.front() == '/') {
+			path.remove_prefix(1);
+		}
+		return path;
+	}
+#pragma endregion
+
+#pragma region Protocol
+	ResultCode FileProtocolPack::Mount(const IntrusivePtr<MappedFileStream>& archive) {
+		Unmount();
+		ERR_ASSERT(archive.GetRaw() != nullptr && archive->IsValid(), u8"The archive is not valid.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(Stream::LocalEndianness == Stream::Endianness::Little, u8"Pack files are only read on little-endian machines.", return ResultCode::NotSupported);
+
+		const byte* view = archive->GetViewData();
+		int64 length = archive->GetLength();
+		ERR_ASSERT(length >= (int64)sizeof(PackFile::Header), u8"The archive is too short for a pack file.", return ResultCode::InvalidArgument);
+
+		PackFile::Header header{};
+		std::memcpy(&header, view, sizeof(header));
+		ERR_ASSERT(header.magic == PackFile::Magic && header.version == PackFile::Version, u8"The archive is not a pack file of this version.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(header.entryCount <= INT32_MAX / sizeof(PackFile::Entry), u8"The pack file has too many entries.", return ResultCode::InvalidArgument);
+		uint64 tableEnd = header.tableOffset + (uint64)header.entryCount * sizeof(PackFile::Entry) + header.namesLength;
+		ERR_ASSERT(header.tableOffset % alignof(PackFile::Entry) == 0 && header.tableOffset <= (uint64)length && tableEnd <= (uint64)length, u8"The table of the pack file is out of the archive.", return ResultCode::InvalidArgument);
+
+		const PackFile::Entry* table = reinterpret_cast<const PackFile::Entry*>(view + header.tableOffset);
+		for (uint32 i = 0; i < header.entryCount; i += 1) {
+			const PackFile::Entry& entry = table[i];
+			bool inside = entry.offset <= (uint64)length && entry.storedSize <= (uint64)length - entry.offset;
+			bool named = (uint64)entry.nameOffset + entry.nameLength <= header.namesLength;
+			ERR_ASSERT(inside && named && entry.compression < PackFile::Compression::End, u8"An entry of the pack file is not valid.", return ResultCode::InvalidArgument);
+		}
+
+		this->archive = archive;
+		data = view;
+		entries = table;
+		names = reinterpret_cast<const u8char*>(view + header.tableOffset + (uint64)header.entryCount * sizeof(PackFile::Entry));
+		entryCount = (int32)header.entryCount;
+		return ResultCode::OK;
+	}
+	void FileProtocolPack::Unmount() {
+		archive = IntrusivePtr<MappedFileStream>();
+		data = nullptr;
+		entries = nullptr;
+		names = nullptr;
+		entryCount = 0;
+	}
+	bool FileProtocolPack::IsMounted() const {
+		return archive.GetRaw() != nullptr;
+	}
+	int32 FileProtocolPack::GetEntryCount() const {
+		return entryCount;
+	}
+
+	std::string_view FileProtocolPack::GetName(const PackFile::Entry& entry) const {
+		return std::string_view(reinterpret_cast<const char*>(names + entry.nameOffset), entry.nameLength);
+	}
+	const PackFile::Entry* FileProtocolPack::Find(std::string_view path) const {
+		path = PackFile::TrimPath(path);
+		uint32 hash = PackFile::HashPath(path);
+
+		// The first entry with the hash, then the few sharing it.
+		int32 low = 0;
+		int32 high = entryCount;
+		while (low < high) {
+			int32 middle = low + (high - low) / 2;
+			if (entries[middle].hash < hash) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		for (int32 i = low; i < entryCount && entries[i].hash == hash; i += 1) {
+			if (GetName(entries[i]) == path) {
+				return entries + i;
+			}
+		}
+		return nullptr;
+	}
+	template<typename Function>
+	bool FileProtocolPack::ForEachChild(std::string_view directory, bool directories, Function function) const {
+		directory = PackFile::TrimPath(directory);
+		while (!directory.empty() && directory.back() == '/') {
+			directory.remove_suffix(1);
+		}
+
+		// Directories only exist through the files in them, so they are found by scanning the names.
+		bool found = directory.empty();
+		List<std::string_view> seen{};
+		for (int32 i = 0; i < entryCount; i += 1) {
+			std::string_view name = GetName(entries[i]);
+			if (!directory.empty()) {
+				if (name.size() <= directory.size() || name[directory.size()] != '/' || name.substr(0, directory.size()) != directory) {
+					continue;
+				}
+				name.remove_prefix(directory.size() + 1);
+			}
+			found = true;
+
+			sizeint slash = name.find('/');
+			if ((slash != std::string_view::npos) != directories) {
+				continue;
+			}
+			std::string_view child = GetName(entries[i]).substr(0, (directory.empty() ? 0 : directory.size() + 1) + (directories ? slash : name.size()));
+			if (directories) {
+				bool repeated = false;
+				for (int32 j = 0; j < seen.GetCount() && !repeated; j += 1) {
+					repeated = seen[j] == child;
+				}
+				if (repeated) {
+					continue;
+				}
+				seen.Add(child);
+			}
+			function(child);
+		}
+		return found;
+	}
+
+	bool FileProtocolPack::IsFileExists(const String& path) const {
+		return Find(path.GetStringView()) != nullptr;
+	}
+	bool FileProtocolPack::IsDirectoryExists(const String& path) const {
+		return ForEachChild(path.GetStringView(), true, [](std::string_view) {});
+	}
+
+	ResultCode FileProtocolPack::CreateFile(const String& path) {
+		return ResultCode::NoPermission;
+	}
+	ResultCode FileProtocolPack::CreateDirectory(const String& path) {
+		return ResultCode::NoPermission;
+	}
+
+	ResultPair<IntrusivePtr<FileStream>> FileProtocolPack::OpenFile(const String& path, FileStream::OpenMode mode) {
+		using Result = ResultPair<IntrusivePtr<FileStream>>;
+		ERR_ASSERT(FileStream::IsOpenModeValid(mode), u8"mode is invalid!", return Result(ResultCode::InvalidArgument, IntrusivePtr<FileStream>(nullptr)));
+		if (!FileStream::IsOpenModeReadOnly(mode)) {
+			return Result(ResultCode::NoPermission, IntrusivePtr<FileStream>(nullptr));
+		}
+		auto mapped = MapFile(path);
+		return Result(mapped.result, mapped.value);
+	}
+	ResultPair<IntrusivePtr<MappedFileStream>> FileProtocolPack::MapFile(const String& path) {
+		using Result = ResultPair<IntrusivePtr<MappedFileStream>>;
+		const PackFile::Entry* entry = Find(path.GetStringView());
+		if (entry == nullptr) {
+			return Result(ResultCode::NotFound, IntrusivePtr<MappedFileStream>(nullptr));
+		}
+		ERR_ASSERT(entry->compression == PackFile::Compression::None, u8"The compression of the entry is not supported.", return Result(ResultCode::NotSupported, IntrusivePtr<MappedFileStream>(nullptr)));
+
+		auto stream = IntrusivePtr<PackEntryStream>::Create(archive, data + entry->offset, (int64)entry->size);
+		return Result(ResultCode::OK, stream);
+	}
+
+	ResultCode FileProtocolPack::RemoveFile(const String& path) {
+		return ResultCode::NoPermission;
+	}
+	ResultCode FileProtocolPack::RemoveDirectory(const String& path) {
+		return ResultCode::NoPermission;
+	}
+
+	ResultCode FileProtocolPack::GetAllFiles(const String& path, List<String>& result) const {
+		bool found = ForEachChild(path.GetStringView(), false, [&result](std::string_view child) {
+			result.Add(String((const u8char*)child.data(), (int32)child.size()));
+		});
+		return found ? ResultCode::OK : ResultCode::NotFound;
+	}
+	ResultCode FileProtocolPack::GetAllDirectories(const String& path, List<String>& result) const {
+		bool found = ForEachChild(path.GetStringView(), true, [&result](std::string_view child) {
+			result.Add(String((const u8char*)child.data(), (int32)child.size()));
+		});
+		return found ? ResultCode::OK : ResultCode::NotFound;
+	}
+#pragma endregion
+
+#pragma region File
+	PackEntryStream::PackEntryStream(const IntrusivePtr<MappedFileStream>& archive, const byte* view, int64 length) :archive(archive) {
+		SetView(view, length);
+	}
+	PackEntryStream::~PackEntryStream() {
+		Close();
+	}
+	void PackEntryStream::Close() {
+		if (!IsValid()) {
+			return;
+		}
+		ClearView();
+		archive = IntrusivePtr<MappedFileStream>();
+	}
+#pragma endregion
+
+#pragma region Writer
+	PackFileWriter::PackFileWriter(int32 alignment) :alignment(alignment) {
+		bool valid = alignment > 0 && alignment <= 4096 && (alignment & (alignment - 1)) == 0;
+		ERR_ASSERT(valid, u8"alignment must be a power of 2 up to 4096.", this->alignment = PackFile::DefaultAlignment);
+	}
+
+	ResultCode PackFileWriter::Add(const String& path, const byte* data, int32 length) {
+		ERR_ASSERT(length >= 0 && (data != nullptr || length == 0), u8"data is not valid.", return ResultCode::InvalidArgument);
+		std::string_view trimmed = PackFile::TrimPath(path.GetStringView());
+		ERR_ASSERT(!trimmed.empty() && trimmed.back() != '/', u8"The path must name a file.", return ResultCode::InvalidArgument);
+
+		String name((const u8char*)trimmed.data(), (int32)trimmed.size());
+		if (indices.ContainsKey(name)) {
+			return ResultCode::AlreadyExists;
+		}
+		indices.Add(name, pending.GetCount());
+
+		Pending one{ name, PackFile::HashPath(trimmed), List<byte>() };
+		one.data.SetCount(length);
+		if (length > 0) {
+			std::memcpy(one.data.GetRawElementPtr(), data, length);
+		}
+		pending.Add(Memory::Move(one));
+		return ResultCode::OK;
+	}
+	ResultCode PackFileWriter::Add(const String& path, const List<byte>& data) {
+		return Add(path, data.GetRawElementPtr(), data.GetCount());
+	}
+	int32 PackFileWriter::GetCount() const {
+		return pending.GetCount();
+	}
+
+	ResultCode PackFileWriter::Write(Stream& stream) const {
+		ERR_ASSERT(stream.CanWrite(), u8"The stream cannot write.", return ResultCode::NoPermission);
+
+		// The table order, by hash then by path so that the archive doesn't depend on the order of adding.
+		List<int32> order{};
+		order.SetCount(pending.GetCount());
+		for (int32 i = 0; i < order.GetCount(); i += 1) {
+			order[i] = i;
+		}
+		order.Sort([this](int32 a, int32 b) {
+			const Pending& first = pending[a];
+			const Pending& second = pending[b];
+			if (first.hash != second.hash) {
+				return first.hash < second.hash;
+			}
+			return first.path < second.path;
+		});
+
+		// Everything is placed first, so the archive is written front to back.
+		List<PackFile::Entry> table{};
+		table.SetCount(order.GetCount());
+		uint64 offset = sizeof(PackFile::Header);
+		uint32 namesLength = 0;
+		for (int32 i = 0; i < order.GetCount(); i += 1) {
+			const Pending& one = pending[order[i]];
+			offset = (offset + alignment - 1) & ~(uint64)(alignment - 1);
+			PackFile::Entry& entry = table[i];
+			entry.offset = offset;
+			entry.size = (uint64)one.data.GetCount();
+			entry.storedSize = entry.size;
+			entry.hash = one.hash;
+			entry.nameOffset = namesLength;
+			entry.nameLength = (uint32)one.path.GetCount();
+			entry.compression = PackFile::Compression::None;
+			offset += entry.storedSize;
+			namesLength += entry.nameLength;
+		}
+
+		PackFile::Header header{};
+		header.magic = PackFile::Magic;
+		header.version = PackFile::Version;
+		header.alignment = (uint16)alignment;
+		header.entryCount = (uint32)table.GetCount();
+		header.namesLength = namesLength;
+		header.tableOffset = (offset + alignof(PackFile::Entry) - 1) & ~(uint64)(alignof(PackFile::Entry) - 1);
+
+		static const byte zeros[4096] = {};
+		uint64 written = sizeof(PackFile::Header);
+		ResultCode r = stream.WriteBytes((const byte*)&header, sizeof(header));
+		for (int32 i = 0; i < order.GetCount() && r == ResultCode::OK; i += 1) {
+			const PackFile::Entry& entry = table[i];
+			r = stream.WriteBytes(zeros, (int32)(entry.offset - written));
+			if (r == ResultCode::OK) {
+				r = stream.WriteBytes(pending[order[i]].data);
+			}
+			written = entry.offset + entry.storedSize;
+		}
+		if (r == ResultCode::OK) {
+			r = stream.WriteBytes(zeros, (int32)(header.tableOffset - written));
+		}
+		if (r == ResultCode::OK) {
+			r = stream.WriteBytes((const byte*)table.GetRawElementPtr(), table.GetCount() * (int32)sizeof(PackFile::Entry));
+		}
+		for (int32 i = 0; i < order.GetCount() && r == ResultCode::OK; i += 1) {
+			r = stream.WriteText(pending[order[i]].path);
+		}
+		return r;
+	}
+#pragma endregion
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include "Engine/System/File/FileStream.h"
+#include "Engine/System/File/FileProtocol.h"
+#include "Engine/System/Collection/Dictionary.h"
+#include <string_view>
+
+namespace Engine {
+	/// @brief The layout of a pack file, one archive holding many files so that each open costs no system call.\n
+	/// A header, the aligned entry data, then a table of entries sorted by the hash of their paths and the UTF-8 paths themselves.
+	/// Everything is little-endian, paths are relative and separated with '/'.
+	class PackFile final {
+	public:
+		static inline constexpr uint32 Magic = 0x4B434150; // "PACK"
+		static inline constexpr uint16 Version = 1;
+		static inline constexpr int32 DefaultAlignment = 16;
+
+		enum class Compression :byte {
+			/// @brief Stored as it is, opened in place.
+			None,
+			/// @brief End of the compression enum.
+			End,
+		};
+
+		struct Header {
+			uint32 magic;
+			uint16 version;
+			/// @brief Of the entry data, a power of 2.
+			uint16 alignment;
+			uint32 entryCount;
+			uint32 namesLength;
+			/// @brief An 8-byte aligned offset, followed by entryCount entries then namesLength bytes of paths.
+			uint64 tableOffset;
+		};
+		struct Entry {
+			uint64 offset;
+			/// @brief The size of the file.
+			uint64 size;
+			/// @brief The size in the archive, the same as size without compression.
+			uint64 storedSize;
+			uint32 hash;
+			uint32 nameOffset;
+			uint32 nameLength;
+			Compression compression;
+			byte padding[3];
+		};
+		static_assert(sizeof(Header) == 24 && sizeof(Entry) == 40, "The layout must not depend on the compiler.");
+
+		/// @brief FNV-1a of the path, stable across runs and platforms.
+		static uint32 HashPath(std::string_view path);
+		/// @brief Drop the leading '/'s, pack paths are always relative.
+		static std::string_view TrimPath(std::string_view path);
+	};
+
+	/// @brief Read-only protocol over a mounted pack file, registered for Protocol::Resource.\n
+	/// The archive is mapped once, finding an entry is a binary search in its table and opening one gives a view of its bytes,
+	/// so neither touches the OS. Mount before reading, mounting is not thread-safe.
+	class FileProtocolPack final :public FileProtocol {
+		REFLECTION_CLASS(::Engine::FileProtocolPack, ::Engine::FileProtocol) {}
+
+	public:
+		/// @brief Use the archive, replacing the mounted one. The streams already opened keep the old one alive.
+		/// @return ResultCode::InvalidArgument if the archive is not a valid pack file, and nothing is mounted then.
+		ResultCode Mount(const IntrusivePtr<MappedFileStream>& archive);
+		void Unmount();
+		bool IsMounted() const;
+		int32 GetEntryCount() const;
+
+		bool IsFileExists(const String& path) const override;
+		bool IsDirectoryExists(const String& path) const override;
+
+		/// @brief Pack files are read-only, always ResultCode::NoPermission.
+		ResultCode CreateFile(const String& path) override;
+		/// @brief Pack files are read-only, always ResultCode::NoPermission.
+		ResultCode CreateDirectory(const String& path) override;
+
+		/// @brief Only OpenMode::ReadOnly. The stream is a MappedFileStream over the entry.
+		ResultPair<IntrusivePtr<FileStream>> OpenFile(const String& path, FileStream::OpenMode mode) override;
+		ResultPair<IntrusivePtr<MappedFileStream>> MapFile(const String& path) override;
+
+		/// @brief Pack files are read-only, always ResultCode::NoPermission.
+		ResultCode RemoveFile(const String& path) override;
+		/// @brief Pack files are read-only, always ResultCode::NoPermission.
+		ResultCode RemoveDirectory(const String& path) override;
+
+		/// @brief The paths in the pack of the files right in the directory, "" for the root.
+		ResultCode GetAllFiles(const String& path, List<String>& result) const override;
+		/// @brief The paths in the pack of the directories right in the directory, "" for the root.
+		ResultCode GetAllDirectories(const String& path, List<String>& result) const override;
+
+	private:
+		const PackFile::Entry* Find(std::string_view path) const;
+		std::string_view GetName(const PackFile::Entry& entry) const;
+		/// @brief Call the function with every distinct child of the directory, files or directories.
+		template<typename Function>
+		bool ForEachChild(std::string_view directory, bool directories, Function function) const;
+
+		IntrusivePtr<MappedFileStream> archive{};
+		const byte* data = nullptr;
+		const PackFile::Entry* entries = nullptr;
+		const u8char* names = nullptr;
+		int32 entryCount = 0;
+	};
+
+	/// @brief The view of an entry, holding the archive mapped as long as it is open.
+	class PackEntryStream final :public MappedFileStream {
+		REFLECTION_CLASS(::Engine::PackEntryStream, ::Engine::MappedFileStream) {}
+
+	public:
+		PackEntryStream(const IntrusivePtr<MappedFileStream>& archive, const byte* view, int64 length);
+		~PackEntryStream();
+
+		void Close() override;
+
+	private:
+		IntrusivePtr<MappedFileStream> archive;
+	};
+
+	/// @brief Builds a pack file from files added in memory, for the tools packaging the resources.
+	class PackFileWriter final {
+	public:
+		/// @param alignment Of each entry in the archive, a power of 2 up to 4096.
+		PackFileWriter(int32 alignment = PackFile::DefaultAlignment);
+
+		/// @brief Copy the bytes as the file at the path.
+		/// @return ResultCode::AlreadyExists if the path was added before.
+		ResultCode Add(const String& path, const byte* data, int32 length);
+		ResultCode Add(const String& path, const List<byte>& data);
+		int32 GetCount() const;
+		/// @brief Write the whole archive from the current position of the stream, which doesn't need random access.
+		ResultCode Write(Stream& stream) const;
+
+	private:
+		struct Pending {
+			String path;
+			uint32 hash;
+			List<byte> data;
+		};
+
+		int32 alignment;
+		List<Pending> pending{};
+		Dictionary<String, int32> indices{};
+	};
+}
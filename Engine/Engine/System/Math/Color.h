@@ -3,15 +3,15 @@
 
 namespace Engine {
 	struct Color {
-		Color(float r = 0, float g = 0, float b = 0, float a = 1);
+		constexpr Color(float r = 0, float g = 0, float b = 0, float a = 1);
 		float r;
 		float g;
 		float b;
 		float a;
 
-		static Color From8(byte r = 0, byte g = 0, byte b = 0, byte a = 255);
+		static constexpr Color From8(byte r = 0, byte g = 0, byte b = 0, byte a = 255);
 		//static Color FromHSV(float h = 0, float s = 0, float v = 0, float a = 1);
-		static Color Lerp(const Color& from, const Color& to, float time);
+		static constexpr Color Lerp(const Color& from, const Color& to, float time);
 
 		static const Color Clear;
 		static const Color Black;
@@ -20,4 +20,30 @@ namespace Engine {
 		static const Color Green;
 		static const Color Blue;
 	};
-}
\ No newline at end of file
+
+	inline constexpr Color::Color(float r, float g, float b, float a) :r(r), g(g), b(b), a(a) {}
+
+	inline constexpr Color Color::From8(byte r, byte g, byte b, byte a) {
+		return Color(
+			r / 255.0f,
+			g / 255.0f,
+			b / 255.0f,
+			a / 255.0f
+		);
+	}
+	inline constexpr Color Color::Lerp(const Color& from, const Color& to, float time) {
+		return Color(
+			Math::Lerp(from.r, to.r, time),
+			Math::Lerp(from.g, to.g, time),
+			Math::Lerp(from.b, to.b, time),
+			Math::Lerp(from.a, to.a, time)
+		);
+	}
+
+	inline constexpr Color Color::Clear(0, 0, 0, 0);
+	inline constexpr Color Color::Black(0, 0, 0, 1);
+	inline constexpr Color Color::White(1, 1, 1, 1);
+	inline constexpr Color Color::Red(1, 0, 0, 1);
+	inline constexpr Color Color::Green(0, 1, 0, 1);
+	inline constexpr Color Color::Blue(0, 0, 1, 1);
+}
@@ -0,0 +1,362 @@
+#include "Engine/System/Math/ColorBatch.h"
+#include "Engine/System/Math/Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLORBATCH_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define COLORBATCH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Engine {
+	static_assert(sizeof(Color) == sizeof(float) * 4, "A Color must load as a single SIMD register.");
+
+	namespace {
+		// The linear segments at the dark end of the sRGB curve.
+		constexpr float EncodeThreshold = 0.0031308f;
+		constexpr float DecodeThreshold = 0.04045f;
+		constexpr float LinearSlope = 12.92f;
+		// Fitted to 1.055 * x^(5 / 12) - 0.055 over u = x^(1 / 4), where the curve is smooth, absolute error below 7e-6.
+		constexpr float EncodeCoefficients[6] = { -0.0613402920f, 0.162027049f, 1.25540139f, -0.577477245f, 0.289528305f, -0.0681457728f };
+		// Fitted to ((x + 0.055) / 1.055)^2.4 over s = ((x + 0.055) / 1.055)^(1 / 2), absolute error below 3e-6.
+		constexpr float DecodeCoefficients[6] = { 0.00199599637f, -0.0229640664f, 0.109354133f, -0.287765466f, 0.529153404f, 0.670228014f };
+		constexpr float Inverse255 = 1.0f / 255;
+		constexpr float Inverse1023 = 1.0f / 1023;
+		constexpr float Inverse3 = 1.0f / 3;
+
+		inline float Saturate(float value) {
+			return value > 0 ? (value < 1 ? value : 1) : 0;
+		}
+		inline float Polynomial(const float(&coefficients)[6], float x) {
+			float result = coefficients[5];
+			for (int32 i = 4; i >= 0; i -= 1) {
+				result = result * x + coefficients[i];
+			}
+			return result;
+		}
+		inline float Encode(float value) {
+			value = Saturate(value);
+			if (value <= EncodeThreshold) {
+				return value * LinearSlope;
+			}
+			return Polynomial(EncodeCoefficients, Math::Sqrt(Math::Sqrt(value)));
+		}
+		inline float Decode(float value) {
+			value = Saturate(value);
+			if (value <= DecodeThreshold) {
+				return value / LinearSlope;
+			}
+			return Polynomial(DecodeCoefficients, Math::Sqrt((value + 0.055f) / 1.055f));
+		}
+		inline uint32 Quantize(float value, float scale) {
+			return (uint32)(Saturate(value) * scale + 0.5f);
+		}
+		inline uint32 PackColor(const Color& color) {
+			return Quantize(color.r, 255) | (Quantize(color.g, 255) << 8) | (Quantize(color.b, 255) << 16) | (Quantize(color.a, 255) << 24);
+		}
+		inline Color UnpackColor(uint32 packed) {
+			return Color((packed & 0xFF) * Inverse255, ((packed >> 8) & 0xFF) * Inverse255, ((packed >> 16) & 0xFF) * Inverse255, (packed >> 24) * Inverse255);
+		}
+
+		/// @brief The linear value of every 8 bit sRGB value, computed with the exact curve on first use.
+		const float* GetDecodeTable() {
+			struct Table {
+				Table() {
+					for (int32 i = 0; i < 256; i += 1) {
+						float value = i * Inverse255;
+						values[i] = value <= DecodeThreshold ? value / LinearSlope : Math::Pow((value + 0.055f) / 1.055f, 2.4f);
+					}
+				}
+				float values[256];
+			};
+			static const Table table{};
+			return table.values;
+		}
+
+#if defined(COLORBATCH_SSE) || defined(COLORBATCH_NEON)
+#define COLORBATCH_SIMD
+		// A whole color in a register, the same operations on both platforms so the kernels are written once.
+#if defined(COLORBATCH_SSE)
+		using Float4 = __m128;
+		using Mask4 = __m128;
+		inline Float4 Load(const Color& color) {
+			return _mm_loadu_ps(&color.r);
+		}
+		inline void Store(Color& color, Float4 value) {
+			_mm_storeu_ps(&color.r, value);
+		}
+		inline Float4 Splat(float value) {
+			return _mm_set1_ps(value);
+		}
+		inline Float4 SplatAlpha(Float4 value) {
+			return _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+		}
+		inline Float4 Add(Float4 a, Float4 b) {
+			return _mm_add_ps(a, b);
+		}
+		inline Float4 Multiply(Float4 a, Float4 b) {
+			return _mm_mul_ps(a, b);
+		}
+		inline Float4 Divide(Float4 a, Float4 b) {
+			return _mm_div_ps(a, b);
+		}
+		inline Float4 Sqrt(Float4 value) {
+			return _mm_sqrt_ps(value);
+		}
+		inline Float4 Saturate(Float4 value) {
+			return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1));
+		}
+		inline Mask4 LessEqual(Float4 a, Float4 b) {
+			return _mm_cmple_ps(a, b);
+		}
+		inline Mask4 Greater(Float4 a, Float4 b) {
+			return _mm_cmpgt_ps(a, b);
+		}
+		inline Float4 Select(Mask4 mask, Float4 a, Float4 b) {
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+		/// @brief Set for red, green and blue, clear for alpha.
+		inline Mask4 ColorMask() {
+			return _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+		}
+#else
+		using Float4 = float32x4_t;
+		using Mask4 = uint32x4_t;
+		inline Float4 Load(const Color& color) {
+			return vld1q_f32(&color.r);
+		}
+		inline void Store(Color& color, Float4 value) {
+			vst1q_f32(&color.r, value);
+		}
+		inline Float4 Splat(float value) {
+			return vdupq_n_f32(value);
+		}
+		inline Float4 SplatAlpha(Float4 value) {
+			return vdupq_laneq_f32(value, 3);
+		}
+		inline Float4 Add(Float4 a, Float4 b) {
+			return vaddq_f32(a, b);
+		}
+		inline Float4 Multiply(Float4 a, Float4 b) {
+			return vmulq_f32(a, b);
+		}
+		inline Float4 Divide(Float4 a, Float4 b) {
+			return vdivq_f32(a, b);
+		}
+		inline Float4 Sqrt(Float4 value) {
+			return vsqrtq_f32(value);
+		}
+		inline Float4 Saturate(Float4 value) {
+			return vminq_f32(vmaxq_f32(value, vdupq_n_f32(0)), vdupq_n_f32(1));
+		}
+		inline Mask4 LessEqual(Float4 a, Float4 b) {
+			return vcleq_f32(a, b);
+		}
+		inline Mask4 Greater(Float4 a, Float4 b) {
+			return vcgtq_f32(a, b);
+		}
+		inline Float4 Select(Mask4 mask, Float4 a, Float4 b) {
+			return vbslq_f32(mask, a, b);
+		}
+		inline Mask4 ColorMask() {
+			static constexpr uint32 Lanes[4] = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0 };
+			return vld1q_u32(Lanes);
+		}
+#endif
+		inline Float4 Polynomial(const float(&coefficients)[6], Float4 x) {
+			Float4 result = Splat(coefficients[5]);
+			for (int32 i = 4; i >= 0; i -= 1) {
+				result = Add(Multiply(result, x), Splat(coefficients[i]));
+			}
+			return result;
+		}
+		/// @brief Alpha comes through untouched.
+		inline Float4 Encode(Float4 color) {
+			Float4 value = Saturate(color);
+			Float4 curve = Polynomial(EncodeCoefficients, Sqrt(Sqrt(value)));
+			Float4 linear = Multiply(value, Splat(LinearSlope));
+			return Select(ColorMask(), Select(LessEqual(value, Splat(EncodeThreshold)), linear, curve), color);
+		}
+		inline Float4 Decode(Float4 color) {
+			Float4 value = Saturate(color);
+			Float4 curve = Polynomial(DecodeCoefficients, Sqrt(Multiply(Add(value, Splat(0.055f)), Splat(1 / 1.055f))));
+			Float4 linear = Multiply(value, Splat(1 / LinearSlope));
+			return Select(ColorMask(), Select(LessEqual(value, Splat(DecodeThreshold)), linear, curve), color);
+		}
+		/// @brief Clamp, scale and round four colors to 8 bits per channel and pack them.
+		inline void Pack4(Float4 c0, Float4 c1, Float4 c2, Float4 c3, uint32* out) {
+			Float4 scale = Splat(255);
+			Float4 half = Splat(0.5f);
+			c0 = Add(Multiply(Saturate(c0), scale), half);
+			c1 = Add(Multiply(Saturate(c1), scale), half);
+			c2 = Add(Multiply(Saturate(c2), scale), half);
+			c3 = Add(Multiply(Saturate(c3), scale), half);
+#if defined(COLORBATCH_SSE)
+			__m128i low = _mm_packs_epi32(_mm_cvttps_epi32(c0), _mm_cvttps_epi32(c1));
+			__m128i high = _mm_packs_epi32(_mm_cvttps_epi32(c2), _mm_cvttps_epi32(c3));
+			_mm_storeu_si128((__m128i*)out, _mm_packus_epi16(low, high));
+#else
+			uint16x8_t low = vcombine_u16(vmovn_u32(vcvtq_u32_f32(c0)), vmovn_u32(vcvtq_u32_f32(c1)));
+			uint16x8_t high = vcombine_u16(vmovn_u32(vcvtq_u32_f32(c2)), vmovn_u32(vcvtq_u32_f32(c3)));
+			vst1q_u8((uint8_t*)out, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+#endif
+		}
+		/// @brief Unpack four colors of 8 bits per channel.
+		inline void Unpack4(const uint32* in, Float4& c0, Float4& c1, Float4& c2, Float4& c3) {
+			Float4 scale = Splat(Inverse255);
+#if defined(COLORBATCH_SSE)
+			__m128i bytes = _mm_loadu_si128((const __m128i*)in);
+			__m128i zero = _mm_setzero_si128();
+			__m128i low = _mm_unpacklo_epi8(bytes, zero);
+			__m128i high = _mm_unpackhi_epi8(bytes, zero);
+			c0 = Multiply(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale);
+			c1 = Multiply(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale);
+			c2 = Multiply(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale);
+			c3 = Multiply(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale);
+#else
+			uint8x16_t bytes = vld1q_u8((const uint8_t*)in);
+			uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+			uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+			c0 = Multiply(vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))), scale);
+			c1 = Multiply(vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))), scale);
+			c2 = Multiply(vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))), scale);
+			c3 = Multiply(vcvtq_f32_u32(vmovl_u16(vget_high_u16(high))), scale);
+#endif
+		}
+#endif
+	}
+
+	void ColorBatch::SrgbToLinear(const Color* in, Color* out, int32 count) {
+#if defined(COLORBATCH_SIMD)
+		for (int32 i = 0; i < count; i += 1) {
+			Store(out[i], Decode(Load(in[i])));
+		}
+#else
+		for (int32 i = 0; i < count; i += 1) {
+			out[i] = Color(Decode(in[i].r), Decode(in[i].g), Decode(in[i].b), in[i].a);
+		}
+#endif
+	}
+	void ColorBatch::LinearToSrgb(const Color* in, Color* out, int32 count) {
+#if defined(COLORBATCH_SIMD)
+		for (int32 i = 0; i < count; i += 1) {
+			Store(out[i], Encode(Load(in[i])));
+		}
+#else
+		for (int32 i = 0; i < count; i += 1) {
+			out[i] = Color(Encode(in[i].r), Encode(in[i].g), Encode(in[i].b), in[i].a);
+		}
+#endif
+	}
+
+	void ColorBatch::PackRGBA8(const Color* in, uint32* out, int32 count) {
+		int32 i = 0;
+#if defined(COLORBATCH_SIMD)
+		for (; i + 4 <= count; i += 4) {
+			Pack4(Load(in[i]), Load(in[i + 1]), Load(in[i + 2]), Load(in[i + 3]), out + i);
+		}
+#endif
+		for (; i < count; i += 1) {
+			out[i] = PackColor(in[i]);
+		}
+	}
+	void ColorBatch::UnpackRGBA8(const uint32* in, Color* out, int32 count) {
+		int32 i = 0;
+#if defined(COLORBATCH_SIMD)
+		for (; i + 4 <= count; i += 4) {
+			Float4 c0, c1, c2, c3;
+			Unpack4(in + i, c0, c1, c2, c3);
+			Store(out[i], c0);
+			Store(out[i + 1], c1);
+			Store(out[i + 2], c2);
+			Store(out[i + 3], c3);
+		}
+#endif
+		for (; i < count; i += 1) {
+			out[i] = UnpackColor(in[i]);
+		}
+	}
+	void ColorBatch::PackSrgbRGBA8(const Color* in, uint32* out, int32 count) {
+		int32 i = 0;
+#if defined(COLORBATCH_SIMD)
+		for (; i + 4 <= count; i += 4) {
+			Pack4(Encode(Load(in[i])), Encode(Load(in[i + 1])), Encode(Load(in[i + 2])), Encode(Load(in[i + 3])), out + i);
+		}
+#endif
+		for (; i < count; i += 1) {
+			out[i] = PackColor(Color(Encode(in[i].r), Encode(in[i].g), Encode(in[i].b), in[i].a));
+		}
+	}
+	void ColorBatch::UnpackSrgbRGBA8(const uint32* in, Color* out, int32 count) {
+		// Tables don't vectorize without gathers, but one load per channel is still far cheaper than the curve.
+		const float* table = GetDecodeTable();
+		for (int32 i = 0; i < count; i += 1) {
+			uint32 packed = in[i];
+			out[i] = Color(table[packed & 0xFF], table[(packed >> 8) & 0xFF], table[(packed >> 16) & 0xFF], (packed >> 24) * Inverse255);
+		}
+	}
+	void ColorBatch::PackRGB10A2(const Color* in, uint32* out, int32 count) {
+#if defined(COLORBATCH_SIMD)
+		// The channels shift by different amounts, which SSE2 can't do per lane, so only the scaling is vectorized.
+		const Float4 scale = Select(ColorMask(), Splat(1023), Splat(3));
+		const Float4 half = Splat(0.5f);
+		alignas(16) float channels[4];
+		for (int32 i = 0; i < count; i += 1) {
+			Float4 value = Add(Multiply(Saturate(Load(in[i])), scale), half);
+#if defined(COLORBATCH_SSE)
+			_mm_store_ps(channels, value);
+#else
+			vst1q_f32(channels, value);
+#endif
+			out[i] = (uint32)channels[0] | ((uint32)channels[1] << 10) | ((uint32)channels[2] << 20) | ((uint32)channels[3] << 30);
+		}
+#else
+		for (int32 i = 0; i < count; i += 1) {
+			out[i] = Quantize(in[i].r, 1023) | (Quantize(in[i].g, 1023) << 10) | (Quantize(in[i].b, 1023) << 20) | (Quantize(in[i].a, 3) << 30);
+		}
+#endif
+	}
+	void ColorBatch::UnpackRGB10A2(const uint32* in, Color* out, int32 count) {
+		for (int32 i = 0; i < count; i += 1) {
+			uint32 packed = in[i];
+			out[i] = Color((packed & 0x3FF) * Inverse1023, ((packed >> 10) & 0x3FF) * Inverse1023, ((packed >> 20) & 0x3FF) * Inverse1023, (packed >> 30) * Inverse3);
+		}
+	}
+
+	void ColorBatch::Premultiply(const Color* in, Color* out, int32 count) {
+#if defined(COLORBATCH_SIMD)
+		const Mask4 mask = ColorMask();
+		for (int32 i = 0; i < count; i += 1) {
+			Float4 color = Load(in[i]);
+			Store(out[i], Select(mask, Multiply(color, SplatAlpha(color)), color));
+		}
+#else
+		for (int32 i = 0; i < count; i += 1) {
+			float alpha = in[i].a;
+			out[i] = Color(in[i].r * alpha, in[i].g * alpha, in[i].b * alpha, alpha);
+		}
+#endif
+	}
+	void ColorBatch::Unpremultiply(const Color* in, Color* out, int32 count) {
+#if defined(COLORBATCH_SIMD)
+		const Mask4 mask = ColorMask();
+		const Float4 zero = Splat(0);
+		for (int32 i = 0; i < count; i += 1) {
+			Float4 color = Load(in[i]);
+			Float4 alpha = SplatAlpha(color);
+			Float4 divided = Select(Greater(alpha, zero), Divide(color, alpha), zero);
+			Store(out[i], Select(mask, divided, color));
+		}
+#else
+		for (int32 i = 0; i < count; i += 1) {
+			float alpha = in[i].a;
+			if (alpha > 0) {
+				out[i] = Color(in[i].r / alpha, in[i].g / alpha, in[i].b / alpha, alpha);
+			} else {
+				out[i] = Color(0, 0, 0, alpha);
+			}
+		}
+#endif
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Math/Color.h"
+
+namespace Engine {
+	/// @brief Color conversions over arrays, such as the pixels of an imported texture or the vertex colors of a mesh.\n
+	/// Processes a whole color per SIMD instruction where SSE or NEON is available, and packs 4 colors at once.
+	/// Outputs can be the same arrays as inputs, but must not partially overlap them.\n
+	/// Packed formats keep red in the lowest bits, which is the memory order of RGBA8 textures on little-endian machines.
+	class ColorBatch final {
+	public:
+		STATIC_CLASS(ColorBatch);
+
+		/// @brief Decode sRGB colors to linear ones. Alpha is linear already and copied as it is.\n
+		/// A polynomial stands in for the power curve, the error stays below 1e-5. Channels are clamped to [0, 1].
+		static void SrgbToLinear(const Color* in, Color* out, int32 count);
+		/// @brief Encode linear colors to sRGB, the inverse of SrgbToLinear() with the same error.
+		static void LinearToSrgb(const Color* in, Color* out, int32 count);
+
+		/// @brief 8 bits per channel, rounded to the nearest. Channels are clamped to [0, 1].
+		static void PackRGBA8(const Color* in, uint32* out, int32 count);
+		static void UnpackRGBA8(const uint32* in, Color* out, int32 count);
+		/// @brief Encode linear colors to sRGB and pack them, for sRGB textures. Alpha is packed as it is.
+		static void PackSrgbRGBA8(const Color* in, uint32* out, int32 count);
+		/// @brief Unpack sRGB colors and decode them to linear ones through a table of the 256 values, exact up to float precision.
+		static void UnpackSrgbRGBA8(const uint32* in, Color* out, int32 count);
+		/// @brief 10 bits for red, green and blue and 2 for alpha in the highest bits, rounded to the nearest. Channels are clamped to [0, 1].
+		static void PackRGB10A2(const Color* in, uint32* out, int32 count);
+		static void UnpackRGB10A2(const uint32* in, Color* out, int32 count);
+
+		/// @brief Multiply red, green and blue by alpha, for blending with premultiplied alpha.
+		static void Premultiply(const Color* in, Color* out, int32 count);
+		/// @brief Divide red, green and blue by alpha, colors with an alpha of 0 become black.
+		static void Unpremultiply(const Color* in, Color* out, int32 count);
+	};
+}
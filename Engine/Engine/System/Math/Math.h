@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Engine/System/Definition.h"
+#include <cmath>
+#include <limits>
+#include <bit>
 
 namespace Engine {
 	class Math final {
@@ -10,13 +13,13 @@ namespace Engine {
 		static inline constexpr float PI = (float)3.14159265358f;
 		static inline constexpr float Deg2Rad = PI / 180;
 		static inline constexpr float Rad2Deg = 180 / PI;
-		static const float Infinity;
+		static inline constexpr float Infinity = std::numeric_limits<float>::infinity();
 
 		static bool IsNaN(float value);
 		static bool IsInfinity(float value);
 
-		static float Clamp(float value, float min = 0.0f, float max = 1.0f);
-		static float Lerp(float a, float b, float time);
+		static constexpr float Clamp(float value, float min = 0.0f, float max = 1.0f);
+		static constexpr float Lerp(float a, float b, float time);
 
 		static float Tan(float value);
 		static float Cot(float value);
@@ -28,8 +31,8 @@ namespace Engine {
 		static float ArcSin(float value);
 		static float ArcCos(float value);
 
-		static float Sign(float value);
-		static float Abs(float value);
+		static constexpr float Sign(float value);
+		static constexpr float Abs(float value);
 
 		static float Round(float value);
 		static float Floor(float value);
@@ -37,5 +40,117 @@ namespace Engine {
 
 		static float Pow(float base, float power);
 		static float Sqrt(float value);
+
+		/// @brief Approximate 1 / Sqrt(value), relative error below 5e-6. Only for positive values.
+		static constexpr float FastInverseSqrt(float value);
+		/// @brief Approximate Sin() without a library call, absolute error below 5e-7 within [-10, 10] radians.
+		/// @note Precision drops further away from 0, as the range reduction is done in float. Only for finite values.
+		static constexpr float FastSin(float value);
+		/// @brief Approximate Cos(), with the same error as FastSin().
+		static constexpr float FastCos(float value);
 	};
-}
\ No newline at end of file
+
+	inline bool Math::IsNaN(float value) {
+		return std::isnan(value);
+	}
+	inline bool Math::IsInfinity(float value) {
+		return std::isinf(value);
+	}
+
+	inline constexpr float Math::Clamp(float value, float min, float max) {
+		if (value < min) {
+			return min;
+		}
+		if (value > max) {
+			return max;
+		}
+		return value;
+	}
+	inline constexpr float Math::Lerp(float a, float b, float time) {
+		return (b - a) * time + a;
+	}
+
+	inline float Math::Tan(float value) {
+		return std::tan(value);
+	}
+	inline float Math::Cot(float value) {
+		return 1 / std::tan(value);
+	}
+	inline float Math::Sin(float value) {
+		return std::sin(value);
+	}
+	inline float Math::Cos(float value) {
+		return std::cos(value);
+	}
+
+	inline float Math::ArcTan(float value) {
+		return std::atan(value);
+	}
+	inline float Math::ArcCot(float value) {
+		return 1 / std::atan(value);
+	}
+	inline float Math::ArcSin(float value) {
+		return std::asin(value);
+	}
+	inline float Math::ArcCos(float value) {
+		return std::acos(value);
+	}
+
+	inline constexpr float Math::Sign(float value) {
+		if (value < 0) {
+			return -1;
+		}
+		if (value > 0) {
+			return 1;
+		}
+		return 0;
+	}
+	inline constexpr float Math::Abs(float value) {
+		return (value < 0 ? -value : value);
+	}
+
+	inline float Math::Round(float value) {
+		return std::round(value);
+	}
+	inline float Math::Floor(float value) {
+		return std::floor(value);
+	}
+	inline float Math::Ceil(float value) {
+		return std::ceil(value);
+	}
+
+	inline float Math::Pow(float base, float power) {
+		return std::pow(base, power);
+	}
+	inline float Math::Sqrt(float value) {
+		return std::sqrt(value);
+	}
+
+	inline constexpr float Math::FastInverseSqrt(float value) {
+		// A first guess from the bits of the float, refined by two Newton steps.
+		float guess = std::bit_cast<float>(0x5F375A86u - (std::bit_cast<uint32>(value) >> 1));
+		float half = value * 0.5f;
+		guess *= 1.5f - half * guess * guess;
+		guess *= 1.5f - half * guess * guess;
+		return guess;
+	}
+	inline constexpr float Math::FastSin(float value) {
+		constexpr float TwoPI = PI * 2;
+		constexpr float HalfPI = PI / 2;
+		// Bring the value into [-PI, PI], then fold it into [-PI/2, PI/2] where the polynomial is accurate.
+		float turns = value * (1 / TwoPI);
+		turns = (float)(int64)(turns + (turns < 0 ? -0.5f : 0.5f));
+		float x = value - turns * TwoPI;
+		if (x > HalfPI) {
+			x = PI - x;
+		} else if (x < -HalfPI) {
+			x = -PI - x;
+		}
+		// Odd polynomial of degree 11, which is within 2e-7 on that range.
+		float x2 = x * x;
+		return x * (1 + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880 + x2 * (-1.0f / 39916800))))));
+	}
+	inline constexpr float Math::FastCos(float value) {
+		return FastSin(value + PI / 2);
+	}
+}
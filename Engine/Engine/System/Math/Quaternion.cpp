@@ -1,14 +1,41 @@
 #include "Engine/System/Math/Quaternion.h"
 
-namespace Engine{
-	Quaternion::Quaternion(float x, float y, float z, float w) :x(x), y(y), z(z), w(w) {}
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QUATERNION_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define QUATERNION_NEON
+#include <arm_neon.h>
+#endif
 
-	float Quaternion::GetSquaredMagnitude() const {
-		return x * x + y * y + z * z + w * w;
-	}
-	float Quaternion::GetMagnitude() const {
-		return Math::Sqrt(GetSquaredMagnitude());
+namespace Engine{
+	namespace {
+		/// @brief Write the rotation rows scaled per axis, the translation row is left alone.
+		inline void WriteRotation(const Quaternion& q, float sx, float sy, float sz, TransformMatrix& m) {
+			float x2 = q.x * q.x;
+			float y2 = q.y * q.y;
+			float z2 = q.z * q.z;
+			float xy = q.x * q.y;
+			float xz = q.x * q.z;
+			float yz = q.y * q.z;
+			float wx = q.w * q.x;
+			float wy = q.w * q.y;
+			float wz = q.w * q.z;
+
+			m.matrix[0][0] = (1 - 2 * (y2 + z2)) * sx;
+			m.matrix[0][1] = 2 * (xy + wz) * sy;
+			m.matrix[0][2] = 2 * (xz - wy) * sz;
+
+			m.matrix[1][0] = 2 * (xy - wz) * sx;
+			m.matrix[1][1] = (1 - 2 * (x2 + z2)) * sy;
+			m.matrix[1][2] = 2 * (yz + wx) * sz;
+
+			m.matrix[2][0] = 2 * (xz + wy) * sx;
+			m.matrix[2][1] = 2 * (yz - wx) * sy;
+			m.matrix[2][2] = (1 - 2 * (x2 + y2)) * sz;
+		}
 	}
+
 	void Quaternion::Normalize() {
 		float mag2 = GetSquaredMagnitude();
 		if (mag2 != 0 && Math::Abs(mag2 - 1) > NormalizeTolerance) {
@@ -24,17 +51,21 @@ namespace Engine{
 		q.Normalize();
 		return q;
 	}
-	void Quaternion::Conjugate() {
-		x *= -1;
-		y *= -1;
-		z *= -1;
-	}
-	Quaternion Quaternion::GetConjugated() const {
-		Quaternion q = *this;
-		q.Conjugate();
-		return q;
-	}
 	Quaternion& Quaternion::operator*=(const Quaternion& value) {
+#if defined(QUATERNION_SSE)
+		// Each lane is one component of the product, the scalar version below spelled out over shuffled copies.
+		__m128 a = _mm_load_ps(&x);
+		__m128 b = _mm_load_ps(&value.x);
+		const __m128 negateW = _mm_set_ps(-0.0f, 0, 0, 0);
+		__m128 result = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+		__m128 term = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 2, 1, 0)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 3, 3)));
+		result = _mm_add_ps(result, _mm_xor_ps(term, negateW));
+		term = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 2, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 0, 2)));
+		result = _mm_add_ps(result, _mm_xor_ps(term, negateW));
+		term = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 0, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 0, 2, 1)));
+		result = _mm_sub_ps(result, term);
+		_mm_store_ps(&x, result);
+#else
 		float xx = w * value.x + x * value.w + y * value.z - z * value.y;
 		float yy = w * value.y + y * value.w + z * value.x - x * value.z;
 		float zz = w * value.z + z * value.w + x * value.y - y * value.x;
@@ -43,6 +74,7 @@ namespace Engine{
 		y = yy;
 		z = zz;
 		w = ww;
+#endif
 		return *this;
 	}
 	Quaternion Quaternion::operator*(const Quaternion& value) const {
@@ -65,6 +97,90 @@ namespace Engine{
 
 		return Vector3(qr.x, qr.y, qr.z);
 	}
+	Vector3 Quaternion::Rotate(const Vector3& value) const {
+		// v + 2w(u x v) + 2u x (u x v), with u the vector part.
+		Vector3 u(x, y, z);
+		Vector3 t = Vector3::Cross(u, value) * 2;
+		return value + t * w + Vector3::Cross(u, t);
+	}
+
+	Quaternion Quaternion::NLerp(const Quaternion& a, const Quaternion& b, float time) {
+		Quaternion result;
+		NLerp(&a, &b, time, &result, 1);
+		return result;
+	}
+	Quaternion Quaternion::Slerp(const Quaternion& a, const Quaternion& b, float time) {
+		float dot = Dot(a, b);
+		// q and -q are the same rotation, flip one to take the shorter arc.
+		float sign = dot < 0 ? -1.0f : 1.0f;
+		dot *= sign;
+		if (dot > SlerpThreshold) {
+			return NLerp(a, b, time);
+		}
+		float angle = Math::ArcCos(dot);
+		float inverseSin = 1 / Math::Sin(angle);
+		float weightA = Math::Sin((1 - time) * angle) * inverseSin;
+		float weightB = Math::Sin(time * angle) * inverseSin * sign;
+		return Quaternion(
+			a.x * weightA + b.x * weightB,
+			a.y * weightA + b.y * weightB,
+			a.z * weightA + b.z * weightB,
+			a.w * weightA + b.w * weightB
+		);
+	}
+	void Quaternion::NLerp(const Quaternion* a, const Quaternion* b, float time, Quaternion* out, int32 count) {
+#if defined(QUATERNION_SSE)
+		const __m128 t = _mm_set1_ps(time);
+		const __m128 signBit = _mm_set1_ps(-0.0f);
+		for (int32 i = 0; i < count; i += 1) {
+			__m128 va = _mm_load_ps(&a[i].x);
+			__m128 vb = _mm_load_ps(&b[i].x);
+			__m128 dot = _mm_mul_ps(va, vb);
+			dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+			dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+			// Take the shorter arc by giving b the sign of the dot product.
+			vb = _mm_xor_ps(vb, _mm_and_ps(dot, signBit));
+			__m128 value = _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), t));
+			__m128 length = _mm_mul_ps(value, value);
+			length = _mm_add_ps(length, _mm_shuffle_ps(length, length, _MM_SHUFFLE(2, 3, 0, 1)));
+			length = _mm_add_ps(length, _mm_shuffle_ps(length, length, _MM_SHUFFLE(1, 0, 3, 2)));
+			_mm_store_ps(&out[i].x, _mm_div_ps(value, _mm_sqrt_ps(length)));
+		}
+#elif defined(QUATERNION_NEON)
+		for (int32 i = 0; i < count; i += 1) {
+			float32x4_t va = vld1q_f32(&a[i].x);
+			float32x4_t vb = vld1q_f32(&b[i].x);
+			float dot = vaddvq_f32(vmulq_f32(va, vb));
+			if (dot < 0) {
+				vb = vnegq_f32(vb);
+			}
+			float32x4_t value = vfmaq_n_f32(va, vsubq_f32(vb, va), time);
+			float length = Math::Sqrt(vaddvq_f32(vmulq_f32(value, value)));
+			vst1q_f32(&out[i].x, vmulq_n_f32(value, 1 / length));
+		}
+#else
+		for (int32 i = 0; i < count; i += 1) {
+			const Quaternion& qa = a[i];
+			Quaternion qb = b[i];
+			if (Dot(qa, qb) < 0) {
+				qb = Quaternion(-qb.x, -qb.y, -qb.z, -qb.w);
+			}
+			Quaternion value(
+				qa.x + (qb.x - qa.x) * time,
+				qa.y + (qb.y - qa.y) * time,
+				qa.z + (qb.z - qa.z) * time,
+				qa.w + (qb.w - qa.w) * time
+			);
+			float inverseLength = 1 / value.GetMagnitude();
+			out[i] = Quaternion(value.x * inverseLength, value.y * inverseLength, value.z * inverseLength, value.w * inverseLength);
+		}
+#endif
+	}
+	void Quaternion::Slerp(const Quaternion* a, const Quaternion* b, float time, Quaternion* out, int32 count) {
+		for (int32 i = 0; i < count; i += 1) {
+			out[i] = Slerp(a[i], b[i], time);
+		}
+	}
 
 	Quaternion Quaternion::FromAxisAngle(const Vector3& axis, float angle) {
 		angle *= 0.5f;
@@ -98,29 +214,38 @@ namespace Engine{
 	}
 	TransformMatrix Quaternion::ToTransformMatrix() const {
 		TransformMatrix m;
-
-		float x2 = x * x;
-		float y2 = y * y;
-		float z2 = z * z;
-		float xy = x * y;
-		float xz = x * z;
-		float yz = y * z;
-		float wx = w * x;
-		float wy = w * y;
-		float wz = w * z;
-
-		m.matrix[0][0] = 1 - 2 * (y2 + z2);
-		m.matrix[0][1] = 2 * (xy + wz);
-		m.matrix[0][2] = 2 * (xz - wy);
-
-		m.matrix[1][0] = 2 * (xy - wz);
-		m.matrix[1][1] = 1 - 2 * (x2 + z2);
-		m.matrix[1][2] = 2 * (yz + wx);
-
-		m.matrix[2][0] = 2 * (xz + wy);
-		m.matrix[2][1] = 2 * (yz - wx);
-		m.matrix[2][2] = 1 - 2 * (x2 + y2);
-
+		WriteRotation(*this, 1, 1, 1, m);
 		return m;
 	}
+	TransformMatrix Quaternion::ToTransformMatrix(const Vector3& scale, const Vector3& translation) const {
+		TransformMatrix m;
+		WriteRotation(*this, scale.x, scale.y, scale.z, m);
+		m.matrix[3][0] = translation.x;
+		m.matrix[3][1] = translation.y;
+		m.matrix[3][2] = translation.z;
+		return m;
+	}
+	void Quaternion::ToTransformMatrices(const Quaternion* rotations, const Vector3* scales, const Vector3* translations, TransformMatrix* out, int32 count) {
+		for (int32 i = 0; i < count; i += 1) {
+			TransformMatrix& m = out[i];
+			if (scales != nullptr) {
+				WriteRotation(rotations[i], scales[i].x, scales[i].y, scales[i].z, m);
+			} else {
+				WriteRotation(rotations[i], 1, 1, 1, m);
+			}
+			m.matrix[0][3] = 0;
+			m.matrix[1][3] = 0;
+			m.matrix[2][3] = 0;
+			if (translations != nullptr) {
+				m.matrix[3][0] = translations[i].x;
+				m.matrix[3][1] = translations[i].y;
+				m.matrix[3][2] = translations[i].z;
+			} else {
+				m.matrix[3][0] = 0;
+				m.matrix[3][1] = 0;
+				m.matrix[3][2] = 0;
+			}
+			m.matrix[3][3] = 1;
+		}
+	}
 }
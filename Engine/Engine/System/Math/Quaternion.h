@@ -4,28 +4,73 @@
 #include "Engine/System/Math/TransformMatrix.h"
 
 namespace Engine {
-	struct Quaternion final {
-		Quaternion(float x = 0, float y = 0, float z = 0, float w = 1);
+	/// @brief A rotation as a unit quaternion, aligned to 16 bytes so it loads as one SIMD register.
+	struct alignas(16) Quaternion final {
+		constexpr Quaternion(float x = 0, float y = 0, float z = 0, float w = 1);
 
 		float x = 0;
 		float y = 0;
 		float z = 0;
 		float w = 1;
 
-		float GetSquaredMagnitude() const;
+		constexpr float GetSquaredMagnitude() const;
 		float GetMagnitude() const;
 		static inline constexpr float NormalizeTolerance = 0.00001f;
 		void Normalize();
 		Quaternion GetNormalized() const;
-		void Conjugate();
-		Quaternion GetConjugated() const;
+		constexpr void Conjugate();
+		constexpr Quaternion GetConjugated() const;
 		Quaternion& operator*=(const Quaternion& value);
 		Quaternion operator*(const Quaternion& value) const;
 
+		/// @brief Rotate the direction of the vector, the result is normalized.
 		Vector3 operator*(const Vector3& value) const;
+		/// @brief Rotate the vector keeping its length, without building the conjugate. The quaternion must be normalized.
+		Vector3 Rotate(const Vector3& value) const;
+
+		static constexpr float Dot(const Quaternion& a, const Quaternion& b);
+		/// @brief Interpolate linearly along the shortest path and normalize. Cheaper than Slerp() but the speed isn't constant.
+		static Quaternion NLerp(const Quaternion& a, const Quaternion& b, float time);
+		/// @brief Interpolate along the shortest arc at a constant speed. Falls back to NLerp() when the rotations are nearly the same.
+		static Quaternion Slerp(const Quaternion& a, const Quaternion& b, float time);
+		/// @brief Run NLerp() for every pair, out can be the same as a or b.
+		static void NLerp(const Quaternion* a, const Quaternion* b, float time, Quaternion* out, int32 count);
+		/// @brief Run Slerp() for every pair, out can be the same as a or b.
+		static void Slerp(const Quaternion* a, const Quaternion* b, float time, Quaternion* out, int32 count);
 
 		static Quaternion FromAxisAngle(const Vector3& axis, float angle);
 		static Quaternion FromEuler(const Vector3& angle);
 		TransformMatrix ToTransformMatrix() const;
+		/// @brief Rotated, then scaled per axis, then translated, as Node3D composes its transform. Skips the three matrix products.
+		TransformMatrix ToTransformMatrix(const Vector3& scale, const Vector3& translation) const;
+		/// @brief Build the matrix of every bone in one pass.
+		/// @param scales nullptr for no scaling.
+		/// @param translations nullptr for no translation.
+		static void ToTransformMatrices(const Quaternion* rotations, const Vector3* scales, const Vector3* translations, TransformMatrix* out, int32 count);
+
+	private:
+		static inline constexpr float SlerpThreshold = 0.9995f;
 	};
+
+	inline constexpr Quaternion::Quaternion(float x, float y, float z, float w) :x(x), y(y), z(z), w(w) {}
+
+	inline constexpr float Quaternion::GetSquaredMagnitude() const {
+		return x * x + y * y + z * z + w * w;
+	}
+	inline float Quaternion::GetMagnitude() const {
+		return Math::Sqrt(GetSquaredMagnitude());
+	}
+	inline constexpr void Quaternion::Conjugate() {
+		x *= -1;
+		y *= -1;
+		z *= -1;
+	}
+	inline constexpr Quaternion Quaternion::GetConjugated() const {
+		Quaternion q = *this;
+		q.Conjugate();
+		return q;
+	}
+	inline constexpr float Quaternion::Dot(const Quaternion& a, const Quaternion& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	}
 }
@@ -1,38 +1,117 @@
 #include "Engine/System/Math/Random.h"
 #include "Engine/System/Debug.h"
-#include "Engine/System/String.h"
+#include "Engine/System/Thread/Atomic.h"
 #include <chrono>
 
 namespace Engine {
+	namespace {
+		uint64 SplitMix(uint64& value) {
+			value += 0x9E3779B97F4A7C15ull;
+			uint64 z = value;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+		uint64 GetTimeSeed() {
+			// TODO: Change this to DateTime calls.
+			return (uint64)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		}
+		/// @brief [0, 1) with every value evenly spaced, from the upper 24 bits.
+		inline float ToUnitFloat(uint32 value) {
+			return (value >> 8) * (1.0f / 16777216.0f);
+		}
+		/// @brief (value * range) >> 32 maps the whole 32-bit range onto [0, range) without a division.
+		inline uint32 Bound(uint32 value, uint32 range) {
+			return (uint32)(((uint64)value * range) >> 32);
+		}
+	}
+
 	Random::Random() {
-		// TODO: Change this to DateTime calls.
-		int32 time = (int32)std::chrono::high_resolution_clock::now().time_since_epoch().count();
-		uint32 seed = 0;
-		std::memcpy(&seed, &time, sizeof(int32));
-		SetSeed(seed);
+		SetSeed(GetTimeSeed());
 	}
-	Random::Random(uint32 seed) {
+	Random::Random(uint64 seed) {
 		SetSeed(seed);
 	}
+
+	Random& Random::GetCurrent() {
+		// Every thread mixes in its own number so those created at the same time still differ.
+		static AtomicValue<uint64> threadCounter(0);
+		static thread_local Random random(GetTimeSeed() ^ (threadCounter.FetchAdd(1) * 0xD1B54A32D192ED03ull));
+		return random;
+	}
+
 	int32 Random::Next(int32 min, int32 max) {
 		ERR_ASSERT(min <= max, u8"min cannot be greater than max.", return max);
 
-		if (min == max) {
-			return min;
-		}
-		return std::uniform_int_distribution<int32>(min, max - 1)(engine);
+		// A range of 0 gives min back.
+		uint32 range = (uint32)max - (uint32)min;
+		return (int32)((uint32)min + Bound(NextUInt32(), range));
 	}
 	float Random::NextFloat(float min, float max) {
 		ERR_ASSERT(min <= max, u8"min cannot be greater than max.", return max);
 
-		return std::uniform_real_distribution<float>(min, max)(engine);
+		return min + (max - min) * ToUnitFloat(NextUInt32());
 	}
 	double Random::NextDouble(double min, double max) {
 		ERR_ASSERT(min <= max, u8"min cannot be greater than max.", return max);
 
-		return std::uniform_real_distribution<double>(min, max)(engine);
+		return min + (max - min) * ((NextUInt64() >> 11) * (1.0 / 9007199254740992.0));
+	}
+
+	void Random::Fill(int32* values, int32 count, int32 min, int32 max) {
+		ERR_ASSERT(min <= max, u8"min cannot be greater than max.", return);
+		ERR_ASSERT(count <= 0 || values != nullptr, u8"values is nullptr.", return);
+
+		uint32 range = (uint32)max - (uint32)min;
+		int32 i = 0;
+		// Both halves of every 64-bit number are used.
+		for (; i + 2 <= count; i += 2) {
+			uint64 value = NextUInt64();
+			values[i] = (int32)((uint32)min + Bound((uint32)(value >> 32), range));
+			values[i + 1] = (int32)((uint32)min + Bound((uint32)value, range));
+		}
+		if (i < count) {
+			values[i] = (int32)((uint32)min + Bound(NextUInt32(), range));
+		}
+	}
+	void Random::Fill(float* values, int32 count, float min, float max) {
+		ERR_ASSERT(min <= max, u8"min cannot be greater than max.", return);
+		ERR_ASSERT(count <= 0 || values != nullptr, u8"values is nullptr.", return);
+
+		float range = max - min;
+		int32 i = 0;
+		for (; i + 2 <= count; i += 2) {
+			uint64 value = NextUInt64();
+			values[i] = min + range * ToUnitFloat((uint32)(value >> 32));
+			values[i + 1] = min + range * ToUnitFloat((uint32)value);
+		}
+		if (i < count) {
+			values[i] = min + range * ToUnitFloat(NextUInt32());
+		}
 	}
-	void Random::SetSeed(uint32 seed) {
-		engine.seed(seed);
+
+	void Random::SetSeed(uint64 seed) {
+		// splitmix64 spreads any seed, 0 included, into a state which isn't all zeros.
+		for (uint64& value : state) {
+			value = SplitMix(seed);
+		}
+	}
+	void Random::Jump() {
+		static constexpr uint64 JumpPolynomial[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+		uint64 jumped[4]{};
+		for (uint64 polynomial : JumpPolynomial) {
+			for (int32 bit = 0; bit < 64; bit += 1) {
+				if (polynomial & ((uint64)1 << bit)) {
+					for (int32 i = 0; i < 4; i += 1) {
+						jumped[i] ^= state[i];
+					}
+				}
+				NextUInt64();
+			}
+		}
+		for (int32 i = 0; i < 4; i += 1) {
+			state[i] = jumped[i];
+		}
 	}
-}
\ No newline at end of file
+}
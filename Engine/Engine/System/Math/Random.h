@@ -1,26 +1,63 @@
 #pragma once
 
 #include "Engine/System/Definition.h"
-#include <random>
 
 namespace Engine {
-	/// @brief A pseudo random number generator.
+	/// @brief A pseudo random number generator, xoshiro256** seeded through splitmix64.\n
+	/// 32 bytes of state and a handful of instructions per number. Not thread safe, use GetCurrent() for a generator of the current thread.
+	/// Not meant for cryptography.
 	class Random final {
 	public:
-		
 		/// @brief Initializes a random number generator with the current timestamp as seed.
 		Random();
 		/// @brief Initializes a random number generator with the given seed.
-		Random(uint32 seed);
+		Random(uint64 seed);
+
+		/// @brief The generator of the current thread, seeded differently on every thread on first use.
+		static Random& GetCurrent();
+
 		/// @brief Generates a integer which is between [min, max).
+		/// @note Bounded by a multiply and a shift instead of rejection, so some values are more likely by up to (max - min) / 2^32.
 		int32 Next(int32 min, int32 max);
 		/// @brief Generates a float which is [min, max).
-		float NextFloat(float min=0, float max=1);
+		float NextFloat(float min = 0, float max = 1);
 		/// @brief Generates a double which is [min, max).
-		double NextDouble(double min=0, double max=1);
+		double NextDouble(double min = 0, double max = 1);
+		uint32 NextUInt32();
+		uint64 NextUInt64();
+
+		/// @brief Generate many integers which are between [min, max) in one call.
+		void Fill(int32* values, int32 count, int32 min, int32 max);
+		/// @brief Generate many floats which are [min, max) in one call.
+		void Fill(float* values, int32 count, float min = 0, float max = 1);
+
 		/// @brief Set the seed of the random number generator.
-		void SetSeed(uint32 seed);
+		void SetSeed(uint64 seed);
+		/// @brief Advance as if 2^128 numbers were generated, giving a stream which doesn't overlap the current one for splitting work.
+		void Jump();
+
 	private:
-		std::default_random_engine engine;
+		static uint64 RotateLeft(uint64 value, int32 count);
+
+		uint64 state[4]{};
 	};
-}
\ No newline at end of file
+
+	inline uint64 Random::RotateLeft(uint64 value, int32 count) {
+		return (value << count) | (value >> (64 - count));
+	}
+	inline uint64 Random::NextUInt64() {
+		uint64 result = RotateLeft(state[1] * 5, 7) * 9;
+		uint64 shifted = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= shifted;
+		state[3] = RotateLeft(state[3], 45);
+		return result;
+	}
+	inline uint32 Random::NextUInt32() {
+		// The upper bits are the better ones.
+		return (uint32)(NextUInt64() >> 32);
+	}
+}
@@ -0,0 +1,131 @@
+#include "Engine/System/Math/Transform2.h"
+#include "Engine/System/Math/Math.h"
+
+namespace Engine {
+	Transform2 Transform2::operator*(const Transform2& child) const {
+		Transform2 result;
+		for (int32 i = 0; i < 3; i += 1) {
+			result.matrix[i][0] = child.matrix[i][0] * matrix[0][0] + child.matrix[i][1] * matrix[1][0];
+			result.matrix[i][1] = child.matrix[i][0] * matrix[0][1] + child.matrix[i][1] * matrix[1][1];
+		}
+		result.matrix[2][0] += matrix[2][0];
+		result.matrix[2][1] += matrix[2][1];
+		return result;
+	}
+	bool Transform2::operator==(const Transform2& value) const {
+		for (int32 i = 0; i < 3; i += 1) {
+			if (matrix[i][0] != value.matrix[i][0] || matrix[i][1] != value.matrix[i][1]) {
+				return false;
+			}
+		}
+		return true;
+	}
+	bool Transform2::operator!=(const Transform2& value) const {
+		return !(*this == value);
+	}
+
+	Vector2 Transform2::GetOrigin() const {
+		return Vector2(matrix[2][0], matrix[2][1]);
+	}
+	Vector2 Transform2::TransformPoint(const Vector2& point) const {
+		return Vector2(
+			point.x * matrix[0][0] + point.y * matrix[1][0] + matrix[2][0],
+			point.x * matrix[0][1] + point.y * matrix[1][1] + matrix[2][1]
+		);
+	}
+	Vector2 Transform2::TransformVector(const Vector2& vector) const {
+		return Vector2(
+			vector.x * matrix[0][0] + vector.y * matrix[1][0],
+			vector.x * matrix[0][1] + vector.y * matrix[1][1]
+		);
+	}
+	float Transform2::GetDeterminant() const {
+		return matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
+	}
+	Transform2 Transform2::GetInverse() const {
+		Transform2 result;
+		float determinant = GetDeterminant();
+		if (determinant == 0) {
+			return result;
+		}
+		float inverse = 1 / determinant;
+		result.matrix[0][0] = matrix[1][1] * inverse;
+		result.matrix[0][1] = -matrix[0][1] * inverse;
+		result.matrix[1][0] = -matrix[1][0] * inverse;
+		result.matrix[1][1] = matrix[0][0] * inverse;
+		result.matrix[2][0] = -(matrix[2][0] * result.matrix[0][0] + matrix[2][1] * result.matrix[1][0]);
+		result.matrix[2][1] = -(matrix[2][0] * result.matrix[0][1] + matrix[2][1] * result.matrix[1][1]);
+		return result;
+	}
+
+	TransformMatrix Transform2::ToTransformMatrix() const {
+		TransformMatrix result;
+		result.matrix[0][0] = matrix[0][0];
+		result.matrix[0][1] = matrix[0][1];
+		result.matrix[1][0] = matrix[1][0];
+		result.matrix[1][1] = matrix[1][1];
+		result.matrix[3][0] = matrix[2][0];
+		result.matrix[3][1] = matrix[2][1];
+		return result;
+	}
+	Transform2 Transform2::FromTransformMatrix(const TransformMatrix& value) {
+		Transform2 result;
+		result.matrix[0][0] = value.matrix[0][0];
+		result.matrix[0][1] = value.matrix[0][1];
+		result.matrix[1][0] = value.matrix[1][0];
+		result.matrix[1][1] = value.matrix[1][1];
+		result.matrix[2][0] = value.matrix[3][0];
+		result.matrix[2][1] = value.matrix[3][1];
+		return result;
+	}
+
+	void Transform2::TransformPoints(const Transform2& transform, const Vector2* in, Vector2* out, int32 count) {
+		// Copied out so the compiler knows writing the points can't change them.
+		float xx = transform.matrix[0][0];
+		float xy = transform.matrix[0][1];
+		float yx = transform.matrix[1][0];
+		float yy = transform.matrix[1][1];
+		float ox = transform.matrix[2][0];
+		float oy = transform.matrix[2][1];
+		for (int32 i = 0; i < count; i += 1) {
+			float x = in[i].x;
+			float y = in[i].y;
+			out[i].x = x * xx + y * yx + ox;
+			out[i].y = x * xy + y * yy + oy;
+		}
+	}
+	void Transform2::Multiply(const Transform2* parents, const Transform2* children, Transform2* out, int32 count) {
+		for (int32 i = 0; i < count; i += 1) {
+			out[i] = parents[i] * children[i];
+		}
+	}
+	void Transform2::Multiply(const Transform2& parent, const Transform2* children, Transform2* out, int32 count) {
+		Transform2 shared = parent;
+		for (int32 i = 0; i < count; i += 1) {
+			out[i] = shared * children[i];
+		}
+	}
+
+	Transform2 Transform2::Translate(const Vector2& value) {
+		Transform2 result;
+		result.matrix[2][0] = value.x;
+		result.matrix[2][1] = value.y;
+		return result;
+	}
+	Transform2 Transform2::Scale(const Vector2& value) {
+		Transform2 result;
+		result.matrix[0][0] = value.x;
+		result.matrix[1][1] = value.y;
+		return result;
+	}
+	Transform2 Transform2::Rotate(float angle) {
+		float sin = Math::Sin(angle);
+		float cos = Math::Cos(angle);
+		Transform2 result;
+		result.matrix[0][0] = cos;
+		result.matrix[0][1] = sin;
+		result.matrix[1][0] = -sin;
+		result.matrix[1][1] = cos;
+		return result;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Math/Vector.h"
+#include "Engine/System/Math/TransformMatrix.h"
+
+namespace Engine {
+	/// @brief A 2D affine transform as 3 row vectors of 2 floats: the x axis, the y axis and the origin.\n
+	/// Laid out and multiplied like the rows 0, 1 and 3 of a TransformMatrix, so converting between them only copies 6 floats.
+	/// Composing costs 12 multiplies instead of 64, convert to a TransformMatrix only where a 4x4 one is needed, such as rendering.
+	struct Transform2 final {
+		float matrix[3][2] = {
+			{1,0},
+			{0,1},
+			{0,0},
+		};
+
+		/// @brief Compose as TransformMatrix does, the child is applied first.
+		Transform2 operator*(const Transform2& child) const;
+		bool operator==(const Transform2& value) const;
+		bool operator!=(const Transform2& value) const;
+
+		Vector2 GetOrigin() const;
+		/// @brief Transform a position, translation included.
+		Vector2 TransformPoint(const Vector2& point) const;
+		/// @brief Transform a direction, without the translation.
+		Vector2 TransformVector(const Vector2& vector) const;
+		float GetDeterminant() const;
+		/// @brief The transform undoing this one. The axes must not be degenerate, returns the identity if they are.
+		Transform2 GetInverse() const;
+
+		TransformMatrix ToTransformMatrix() const;
+		/// @brief Take the 2D part, the z axis and z components are dropped.
+		static Transform2 FromTransformMatrix(const TransformMatrix& value);
+
+		/// @brief Transform the points, which can be the same as out.
+		static void TransformPoints(const Transform2& transform, const Vector2* in, Vector2* out, int32 count);
+		/// @brief Compose every parent with its child, out can be the same as either.
+		static void Multiply(const Transform2* parents, const Transform2* children, Transform2* out, int32 count);
+		/// @brief Compose every child with the same parent, out can be the same as children.
+		static void Multiply(const Transform2& parent, const Transform2* children, Transform2* out, int32 count);
+
+		static Transform2 Translate(const Vector2& value);
+		static Transform2 Scale(const Vector2& value);
+		/// @brief Rotate around the origin, the same as TransformMatrix::Rotate() around the z axis.
+		static Transform2 Rotate(float angle);
+	};
+}
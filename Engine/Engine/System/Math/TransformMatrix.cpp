@@ -1,10 +1,64 @@
 #include "Engine/System/Math/TransformMatrix.h"
 #include "Engine/System/Math/Quaternion.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORMMATRIX_SSE
+#include <xmmintrin.h>
+#if defined(__AVX__)
+#define TRANSFORMMATRIX_AVX
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define TRANSFORMMATRIX_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Engine {
 	TransformMatrix TransformMatrix::operator*(const TransformMatrix& child) const {
 		TransformMatrix result = *this;
 
+		// Row i of the result is the rows of this one weighted by row i of the child.
+#if defined(TRANSFORMMATRIX_AVX)
+		__m256 row0 = _mm256_broadcast_ps((const __m128*)matrix[0]);
+		__m256 row1 = _mm256_broadcast_ps((const __m128*)matrix[1]);
+		__m256 row2 = _mm256_broadcast_ps((const __m128*)matrix[2]);
+		__m256 row3 = _mm256_broadcast_ps((const __m128*)matrix[3]);
+		for (int32 i = 0; i < 4; i += 2) {
+			const float* a = child.matrix[i];
+			const float* b = child.matrix[i + 1];
+			__m256 value = _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(a[0]), _mm_set1_ps(b[0])), row0);
+			value = _mm256_add_ps(value, _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(a[1]), _mm_set1_ps(b[1])), row1));
+			value = _mm256_add_ps(value, _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(a[2]), _mm_set1_ps(b[2])), row2));
+			value = _mm256_add_ps(value, _mm256_mul_ps(_mm256_setr_m128(_mm_set1_ps(a[3]), _mm_set1_ps(b[3])), row3));
+			_mm256_store_ps(result.matrix[i], value);
+		}
+#elif defined(TRANSFORMMATRIX_SSE)
+		__m128 row0 = _mm_load_ps(matrix[0]);
+		__m128 row1 = _mm_load_ps(matrix[1]);
+		__m128 row2 = _mm_load_ps(matrix[2]);
+		__m128 row3 = _mm_load_ps(matrix[3]);
+		for (int32 i = 0; i < 4; i += 1) {
+			const float* c = child.matrix[i];
+			__m128 value = _mm_mul_ps(_mm_set1_ps(c[0]), row0);
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(c[1]), row1));
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(c[2]), row2));
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(c[3]), row3));
+			_mm_store_ps(result.matrix[i], value);
+		}
+#elif defined(TRANSFORMMATRIX_NEON)
+		float32x4_t row0 = vld1q_f32(matrix[0]);
+		float32x4_t row1 = vld1q_f32(matrix[1]);
+		float32x4_t row2 = vld1q_f32(matrix[2]);
+		float32x4_t row3 = vld1q_f32(matrix[3]);
+		for (int32 i = 0; i < 4; i += 1) {
+			float32x4_t c = vld1q_f32(child.matrix[i]);
+			float32x4_t value = vmulq_laneq_f32(row0, c, 0);
+			value = vfmaq_laneq_f32(value, row1, c, 1);
+			value = vfmaq_laneq_f32(value, row2, c, 2);
+			value = vfmaq_laneq_f32(value, row3, c, 3);
+			vst1q_f32(result.matrix[i], value);
+		}
+#else
 		for (int32 i = 0; i < 4; i += 1) {
 			for (int32 j = 0; j < 4; j += 1) {
 				float value = 0;
@@ -14,20 +68,82 @@ namespace Engine {
 				result.matrix[i][j] = value;
 			}
 		}
+#endif
 		return result;
 	}
 	Vector3 TransformMatrix::operator*(const Vector3& child) const {
+		// Each component is a row dotted with the vector, computed as the transposed rows weighted by the components.
+#if defined(TRANSFORMMATRIX_SSE)
+		__m128 column0 = _mm_load_ps(matrix[0]);
+		__m128 column1 = _mm_load_ps(matrix[1]);
+		__m128 column2 = _mm_load_ps(matrix[2]);
+		__m128 column3 = _mm_load_ps(matrix[3]);
+		_MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+		__m128 value = _mm_mul_ps(column0, _mm_set1_ps(child.x));
+		value = _mm_add_ps(value, _mm_mul_ps(column1, _mm_set1_ps(child.y)));
+		value = _mm_add_ps(value, _mm_mul_ps(column2, _mm_set1_ps(child.z)));
+		alignas(16) float components[4];
+		_mm_store_ps(components, value);
+		return Vector3(components[0], components[1], components[2]);
+#elif defined(TRANSFORMMATRIX_NEON)
+		float32x4x4_t columns = vld4q_f32(&matrix[0][0]);
+		float32x4_t value = vmulq_n_f32(columns.val[0], child.x);
+		value = vfmaq_n_f32(value, columns.val[1], child.y);
+		value = vfmaq_n_f32(value, columns.val[2], child.z);
+		return Vector3(vgetq_lane_f32(value, 0), vgetq_lane_f32(value, 1), vgetq_lane_f32(value, 2));
+#else
 		return Vector3(
 			matrix[0][0] * child.x + matrix[0][1] * child.y + matrix[0][2] * child.z,
 			matrix[1][0] * child.x + matrix[1][1] * child.y + matrix[1][2] * child.z,
 			matrix[2][0] * child.x + matrix[2][1] * child.y + matrix[2][2] * child.z
 		);
+#endif
 	}
 
 	const float* TransformMatrix::GetRaw() const {
 		return (float*)matrix;
 	}
 
+	void TransformMatrix::TransformPoints(const TransformMatrix& transform, const Vector3* in, Vector3* out, int32 count) {
+		const auto& m = transform.matrix;
+#if defined(TRANSFORMMATRIX_SSE)
+		__m128 row0 = _mm_load_ps(m[0]);
+		__m128 row1 = _mm_load_ps(m[1]);
+		__m128 row2 = _mm_load_ps(m[2]);
+		__m128 row3 = _mm_load_ps(m[3]);
+		alignas(16) float components[4];
+		for (int32 i = 0; i < count; i += 1) {
+			const Vector3& point = in[i];
+			__m128 value = _mm_add_ps(row3, _mm_mul_ps(_mm_set1_ps(point.x), row0));
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(point.y), row1));
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(point.z), row2));
+			_mm_store_ps(components, value);
+			out[i] = Vector3(components[0], components[1], components[2]);
+		}
+#elif defined(TRANSFORMMATRIX_NEON)
+		float32x4_t row0 = vld1q_f32(m[0]);
+		float32x4_t row1 = vld1q_f32(m[1]);
+		float32x4_t row2 = vld1q_f32(m[2]);
+		float32x4_t row3 = vld1q_f32(m[3]);
+		for (int32 i = 0; i < count; i += 1) {
+			const Vector3& point = in[i];
+			float32x4_t value = vfmaq_n_f32(row3, row0, point.x);
+			value = vfmaq_n_f32(value, row1, point.y);
+			value = vfmaq_n_f32(value, row2, point.z);
+			out[i] = Vector3(vgetq_lane_f32(value, 0), vgetq_lane_f32(value, 1), vgetq_lane_f32(value, 2));
+		}
+#else
+		for (int32 i = 0; i < count; i += 1) {
+			const Vector3& point = in[i];
+			out[i] = Vector3(
+				point.x * m[0][0] + point.y * m[1][0] + point.z * m[2][0] + m[3][0],
+				point.x * m[0][1] + point.y * m[1][1] + point.z * m[2][1] + m[3][1],
+				point.x * m[0][2] + point.y * m[1][2] + point.z * m[2][2] + m[3][2]
+			);
+		}
+#endif
+	}
+
 	TransformMatrix TransformMatrix::Translate(const Vector3& value) {
 		TransformMatrix m;
 		m.matrix[3][0] = value.x;
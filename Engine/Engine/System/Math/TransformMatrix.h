@@ -4,7 +4,9 @@
 #include "Engine/System/Math/Vector.h"
 
 namespace Engine {
-	struct TransformMatrix final {
+	/// @brief A 4x4 matrix of row vectors, the translation is in the last row.\n
+	/// Aligned to 16 bytes so every row loads as one SIMD register, products use SSE, AVX or NEON where available.
+	struct alignas(16) TransformMatrix final {
 		float matrix[4][4] = {
 			{1,0,0,0},
 			{0,1,0,0},
@@ -15,6 +17,11 @@ namespace Engine {
 		Vector3 operator*(const Vector3& child) const;
 		const float* GetRaw() const;
 
+		/// @brief Transform the points by the matrix, translation included. Each result is the translation of transform * Translate(point).
+		/// @param in The points to transform, can be the same as out.
+		/// @param out Gets count points written.
+		static void TransformPoints(const TransformMatrix& transform, const Vector3* in, Vector3* out, int32 count);
+
 		static TransformMatrix Translate(const Vector3& value);
 		static TransformMatrix Scale(const Vector3& value);
 		static TransformMatrix Rotate(const Vector3& axis, float angle);
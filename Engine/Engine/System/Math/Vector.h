@@ -2,10 +2,11 @@
 
 #include "Engine/System/Definition.h"
 #include "Engine/System/String.h"
+#include "Engine/System/Math/Math.h"
 
 namespace Engine {
 	struct Vector2 final {
-		Vector2(float x = 0, float y = 0);
+		constexpr Vector2(float x = 0, float y = 0);
 
 		float x;
 		float y;
@@ -16,25 +17,25 @@ namespace Engine {
 		/// @brief Get the squared length / magnitude of the Vector2.
 		/// @note This is faster than GetLength() because it doesn't need to be rooted.\n
 		/// If you need the length information for comparing distance, this method is usually preferred.
-		float GetLengthSquared() const;
+		constexpr float GetLengthSquared() const;
 
 		/// @brief Get normalized Vector2. The length will be changed to 1 without changing its direction. 
 		Vector2 GetNormalized() const;
 		/// @brief Normalize the current Vector2. The length will be changed to 1 without changing its direction.
 		void Normalize();
 
-		Vector2 operator+(const Vector2& value) const;
-		Vector2& operator+=(const Vector2& value);
-		Vector2 operator-(const Vector2& value) const;
-		Vector2& operator-=(const Vector2& value);
-		Vector2 operator*(float value) const;
-		Vector2& operator*=(float value);
-		Vector2 operator/(float value) const;
-		Vector2& operator/=(float value);
-		bool operator==(const Vector2& value) const;
-		bool operator!=(const Vector2& value) const;
-		Vector2 operator+() const;
-		Vector2 operator-() const;
+		constexpr Vector2 operator+(const Vector2& value) const;
+		constexpr Vector2& operator+=(const Vector2& value);
+		constexpr Vector2 operator-(const Vector2& value) const;
+		constexpr Vector2& operator-=(const Vector2& value);
+		constexpr Vector2 operator*(float value) const;
+		constexpr Vector2& operator*=(float value);
+		constexpr Vector2 operator/(float value) const;
+		constexpr Vector2& operator/=(float value);
+		constexpr bool operator==(const Vector2& value) const;
+		constexpr bool operator!=(const Vector2& value) const;
+		constexpr Vector2 operator+() const;
+		constexpr Vector2 operator-() const;
 
 		String ToString() const;
 		int32 GetHashCode() const;
@@ -54,24 +55,24 @@ namespace Engine {
 		/// 
 		/// @see https://docs.godotengine.org/en/stable/tutorials/math/vector_math.html#dot-product
 		/// @see https://kidscancode.org/godot_recipes/math/dot_cross_product/
-		static float Dot(const Vector2& a, const Vector2& b);
+		static constexpr float Dot(const Vector2& a, const Vector2& b);
 
 		/// @brief Calculate the cross product.
 		/// @see https://kidscancode.org/godot_recipes/math/dot_cross_product/
-		static float Cross(const Vector2& a, const Vector2& b);
+		static constexpr float Cross(const Vector2& a, const Vector2& b);
 
-		static Vector2 Lerp(const Vector2& a, const Vector2& b, float time);
+		static constexpr Vector2 Lerp(const Vector2& a, const Vector2& b, float time);
 
 		/// @brief Get the radian angle between Vector a and b.
 		/// @return The radian angle.
 		static float AngleBetween(const Vector2& a, const Vector2& b);
 	};
-	Vector2 operator*(float a, const Vector2& b);
-	Vector2 operator/(float a, const Vector2& b);
+	constexpr Vector2 operator*(float a, const Vector2& b);
+	constexpr Vector2 operator/(float a, const Vector2& b);
 
 	struct Vector3 final {
-		Vector3(float x = 0, float y = 0, float z = 0);
-		Vector3(const Vector2& vec2, float z = 0);
+		constexpr Vector3(float x = 0, float y = 0, float z = 0);
+		constexpr Vector3(const Vector2& vec2, float z = 0);
 
 		float x = 0;
 		float y = 0;
@@ -83,25 +84,25 @@ namespace Engine {
 		/// @brief Get the squared length / magnitude of the Vector2.
 		/// @note This is faster than GetLength() because it doesn't need to be rooted.\n
 		/// If you need the length information for comparing distance, this method is usually preferred.
-		float GetLengthSquared() const;
+		constexpr float GetLengthSquared() const;
 
 		/// @brief Get normalized Vector2. The length will be changed to 1 without changing its direction. 
 		Vector3 GetNormalized() const;
 		/// @brief Normalize the current Vector2. The length will be changed to 1 without changing its direction.
 		void Normalize();
 
-		Vector3 operator+(const Vector3& value) const;
-		Vector3& operator+=(const Vector3& value);
-		Vector3 operator-(const Vector3& value) const;
-		Vector3& operator-=(const Vector3& value);
-		Vector3 operator*(float value) const;
-		Vector3& operator*=(float value);
-		Vector3 operator/(float value) const;
-		Vector3& operator/=(float value);
-		bool operator==(const Vector3& value) const;
-		bool operator!=(const Vector3& value) const;
-		Vector3 operator+() const;
-		Vector3 operator-() const;
+		constexpr Vector3 operator+(const Vector3& value) const;
+		constexpr Vector3& operator+=(const Vector3& value);
+		constexpr Vector3 operator-(const Vector3& value) const;
+		constexpr Vector3& operator-=(const Vector3& value);
+		constexpr Vector3 operator*(float value) const;
+		constexpr Vector3& operator*=(float value);
+		constexpr Vector3 operator/(float value) const;
+		constexpr Vector3& operator/=(float value);
+		constexpr bool operator==(const Vector3& value) const;
+		constexpr bool operator!=(const Vector3& value) const;
+		constexpr Vector3 operator+() const;
+		constexpr Vector3 operator-() const;
 
 		String ToString() const;
 		int32 GetHashCode() const;
@@ -123,18 +124,211 @@ namespace Engine {
 		/// 
 		/// @see https://docs.godotengine.org/en/stable/tutorials/math/vector_math.html#dot-product
 		/// @see https://kidscancode.org/godot_recipes/math/dot_cross_product/
-		static float Dot(const Vector3& a, const Vector3& b);
+		static constexpr float Dot(const Vector3& a, const Vector3& b);
 
 		/// @brief Calculate the cross product.
 		/// @see https://kidscancode.org/godot_recipes/math/dot_cross_product/
-		static Vector3 Cross(const Vector3& a, const Vector3& b);
+		static constexpr Vector3 Cross(const Vector3& a, const Vector3& b);
 
-		static Vector3 Lerp(const Vector3& a, const Vector3& b, float time);
+		static constexpr Vector3 Lerp(const Vector3& a, const Vector3& b, float time);
 
 		/// @brief Get the radian angle between Vector a and b.
 		/// @return The radian angle.
 		static float AngleBetween(const Vector3& a, const Vector3& b);
 	};
-	Vector3 operator*(float a, const Vector3& b);
-	Vector3 operator/(float a, const Vector3& b);
-}
\ No newline at end of file
+	constexpr Vector3 operator*(float a, const Vector3& b);
+	constexpr Vector3 operator/(float a, const Vector3& b);
+
+	// Small enough to be inlined, so loops over vectors can be optimized across the calls.
+#pragma region Vector2 Inline
+	inline constexpr Vector2::Vector2(float x, float y) :x(x), y(y) {}
+
+	inline float Vector2::GetLength() const {
+		return Math::Sqrt(GetLengthSquared());
+	}
+	inline constexpr float Vector2::GetLengthSquared() const {
+		return x * x + y * y;
+	}
+
+	inline Vector2 Vector2::GetNormalized() const {
+		Vector2 vec = *this;
+		vec.Normalize();
+		return vec;
+	}
+	inline void Vector2::Normalize() {
+		float len = GetLength();
+		x /= len;
+		y /= len;
+	}
+
+	inline constexpr Vector2 Vector2::operator+(const Vector2& value) const {
+		return Vector2(x + value.x, y + value.y);
+	}
+	inline constexpr Vector2& Vector2::operator+=(const Vector2& value) {
+		x += value.x;
+		y += value.y;
+		return *this;
+	}
+	inline constexpr Vector2 Vector2::operator-(const Vector2& value) const {
+		return Vector2(x - value.x, y - value.y);
+	}
+	inline constexpr Vector2& Vector2::operator-=(const Vector2& value) {
+		x -= value.x;
+		y -= value.y;
+		return *this;
+	}
+	inline constexpr Vector2 Vector2::operator*(float value) const {
+		return Vector2(x * value, y * value);
+	}
+	inline constexpr Vector2 operator*(float a, const Vector2& b) {
+		return Vector2(a * b.x, a * b.y);
+	}
+	inline constexpr Vector2& Vector2::operator*=(float value) {
+		x *= value;
+		y *= value;
+		return *this;
+	}
+	inline constexpr Vector2 Vector2::operator/(float value) const {
+		return Vector2(x / value, y / value);
+	}
+	inline constexpr Vector2 operator/(float a, const Vector2& b) {
+		return Vector2(a / b.x, a / b.y);
+	}
+	inline constexpr Vector2& Vector2::operator/=(float value) {
+		x /= value;
+		y /= value;
+		return *this;
+	}
+	inline constexpr bool Vector2::operator==(const Vector2& value) const {
+		return (x == value.x && y == value.y);
+	}
+	inline constexpr bool Vector2::operator!=(const Vector2& value) const {
+		return (x != value.x || y != value.y);
+	}
+	inline constexpr Vector2 Vector2::operator+() const {
+		return *this;
+	}
+	inline constexpr Vector2 Vector2::operator-() const {
+		return *this * -1;
+	}
+
+	inline constexpr float Vector2::Dot(const Vector2& a, const Vector2& b) {
+		return (a.x * b.x + a.y * b.y);
+	}
+	inline constexpr float Vector2::Cross(const Vector2& a, const Vector2& b) {
+		return (a.x * b.y - a.y * b.x);
+	}
+	inline constexpr Vector2 Vector2::Lerp(const Vector2& a, const Vector2& b, float time) {
+		return Vector2(Math::Lerp(a.x, b.x, time), Math::Lerp(a.y, b.y, time));
+	}
+
+	inline constexpr Vector2 Vector2::Up(0, -1);
+	inline constexpr Vector2 Vector2::Down(0, 1);
+	inline constexpr Vector2 Vector2::Left(-1, 0);
+	inline constexpr Vector2 Vector2::Right(1, 0);
+	inline constexpr Vector2 Vector2::One(1, 1);
+	inline constexpr Vector2 Vector2::Zero(0, 0);
+#pragma endregion
+
+#pragma region Vector3 Inline
+	inline constexpr Vector3::Vector3(float x, float y, float z) :x(x), y(y), z(z) {}
+	inline constexpr Vector3::Vector3(const Vector2& vec2, float z) : x(vec2.x), y(vec2.y), z(z) {}
+
+	inline constexpr float Vector3::GetLengthSquared() const {
+		return x * x + y * y + z * z;
+	}
+	inline float Vector3::GetLength() const {
+		return Math::Sqrt(GetLengthSquared());
+	}
+
+	inline void Vector3::Normalize() {
+		float len = GetLength();
+		x /= len;
+		y /= len;
+		z /= len;
+	}
+	inline Vector3 Vector3::GetNormalized() const {
+		Vector3 vec = *this;
+		vec.Normalize();
+		return vec;
+	}
+
+	inline constexpr Vector3 Vector3::operator+(const Vector3& value) const {
+		return Vector3(x + value.x, y + value.y, z + value.z);
+	}
+	inline constexpr Vector3& Vector3::operator+=(const Vector3& value) {
+		x += value.x;
+		y += value.y;
+		z += value.z;
+		return *this;
+	}
+	inline constexpr Vector3 Vector3::operator-(const Vector3& value) const {
+		return Vector3(x - value.x, y - value.y, z - value.z);
+	}
+	inline constexpr Vector3& Vector3::operator-=(const Vector3& value) {
+		x -= value.x;
+		y -= value.y;
+		z -= value.z;
+		return *this;
+	}
+	inline constexpr Vector3 Vector3::operator*(float value) const {
+		return Vector3(x * value, y * value, z * value);
+	}
+	inline constexpr Vector3 operator*(float a, const Vector3& b) {
+		return Vector3(a * b.x, a * b.y, a * b.z);
+	}
+	inline constexpr Vector3& Vector3::operator*=(float value) {
+		x *= value;
+		y *= value;
+		z *= value;
+		return *this;
+	}
+	inline constexpr Vector3 Vector3::operator/(float value) const {
+		return Vector3(x / value, y / value, z / value);
+	}
+	inline constexpr Vector3 operator/(float a, const Vector3& b) {
+		return Vector3(a / b.x, a / b.y, a / b.z);
+	}
+	inline constexpr Vector3& Vector3::operator/=(float value) {
+		x /= value;
+		y /= value;
+		z /= value;
+		return *this;
+	}
+	inline constexpr bool Vector3::operator==(const Vector3& value) const {
+		return (x == value.x && y == value.y && z == value.z);
+	}
+	inline constexpr bool Vector3::operator!=(const Vector3& value) const {
+		return (x != value.x || y != value.y || z != value.z);
+	}
+	inline constexpr Vector3 Vector3::operator+() const {
+		return *this;
+	}
+	inline constexpr Vector3 Vector3::operator-() const {
+		return *this * -1;
+	}
+
+	inline constexpr float Vector3::Dot(const Vector3& a, const Vector3& b) {
+		return (a.x * b.x + a.y * b.y + a.z * b.z);
+	}
+	inline constexpr Vector3 Vector3::Cross(const Vector3& a, const Vector3& b) {
+		return Vector3(
+			a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x
+		);
+	}
+	inline constexpr Vector3 Vector3::Lerp(const Vector3& a, const Vector3& b, float time) {
+		return Vector3(Math::Lerp(a.x, b.x, time), Math::Lerp(a.y, b.y, time), Math::Lerp(a.z, b.z, time));
+	}
+
+	inline constexpr Vector3 Vector3::Up(0, 1, 0);
+	inline constexpr Vector3 Vector3::Down(0, -1, 0);
+	inline constexpr Vector3 Vector3::Left(-1, 0, 0);
+	inline constexpr Vector3 Vector3::Right(1, 0, 0);
+	inline constexpr Vector3 Vector3::Forward(0, 0, 1);
+	inline constexpr Vector3 Vector3::Back(0, 0, -1);
+	inline constexpr Vector3 Vector3::One(1, 1, 1);
+	inline constexpr Vector3 Vector3::Zero(0, 0, 0);
+#pragma endregion
+}
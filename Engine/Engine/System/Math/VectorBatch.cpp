@@ -0,0 +1,201 @@
+#include "Engine/System/Math/VectorBatch.h"
+#include "Engine/System/Math/Math.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VECTORBATCH_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define VECTORBATCH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Engine {
+	namespace {
+		inline float NormalizeScale(float lengthSquared) {
+			return lengthSquared > 0 ? 1 / Math::Sqrt(lengthSquared) : 1;
+		}
+		void SqrtInPlace(float* values, int32 count) {
+			int32 i = 0;
+#if defined(VECTORBATCH_SSE)
+			for (; i + 4 <= count; i += 4) {
+				_mm_storeu_ps(values + i, _mm_sqrt_ps(_mm_loadu_ps(values + i)));
+			}
+#elif defined(VECTORBATCH_NEON)
+			for (; i + 4 <= count; i += 4) {
+				vst1q_f32(values + i, vsqrtq_f32(vld1q_f32(values + i)));
+			}
+#endif
+			for (; i < count; i += 1) {
+				values[i] = Math::Sqrt(values[i]);
+			}
+		}
+	}
+
+	void VectorBatch::Length(const float* x, const float* y, float* result, int32 count) {
+		LengthSquared(x, y, result, count);
+		SqrtInPlace(result, count);
+	}
+	void VectorBatch::Length(const float* x, const float* y, const float* z, float* result, int32 count) {
+		LengthSquared(x, y, z, result, count);
+		SqrtInPlace(result, count);
+	}
+	void VectorBatch::LengthSquared(const float* x, const float* y, float* result, int32 count) {
+		Dot(x, y, x, y, result, count);
+	}
+	void VectorBatch::LengthSquared(const float* x, const float* y, const float* z, float* result, int32 count) {
+		Dot(x, y, z, x, y, z, result, count);
+	}
+
+	void VectorBatch::Dot(const float* ax, const float* ay, const float* bx, const float* by, float* result, int32 count) {
+		int32 i = 0;
+#if defined(VECTORBATCH_SSE)
+		for (; i + 4 <= count; i += 4) {
+			__m128 value = _mm_mul_ps(_mm_loadu_ps(ax + i), _mm_loadu_ps(bx + i));
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(ay + i), _mm_loadu_ps(by + i)));
+			_mm_storeu_ps(result + i, value);
+		}
+#elif defined(VECTORBATCH_NEON)
+		for (; i + 4 <= count; i += 4) {
+			float32x4_t value = vmulq_f32(vld1q_f32(ax + i), vld1q_f32(bx + i));
+			value = vfmaq_f32(value, vld1q_f32(ay + i), vld1q_f32(by + i));
+			vst1q_f32(result + i, value);
+		}
+#endif
+		for (; i < count; i += 1) {
+			result[i] = ax[i] * bx[i] + ay[i] * by[i];
+		}
+	}
+	void VectorBatch::Dot(const float* ax, const float* ay, const float* az, const float* bx, const float* by, const float* bz, float* result, int32 count) {
+		int32 i = 0;
+#if defined(VECTORBATCH_SSE)
+		for (; i + 4 <= count; i += 4) {
+			__m128 value = _mm_mul_ps(_mm_loadu_ps(ax + i), _mm_loadu_ps(bx + i));
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(ay + i), _mm_loadu_ps(by + i)));
+			value = _mm_add_ps(value, _mm_mul_ps(_mm_loadu_ps(az + i), _mm_loadu_ps(bz + i)));
+			_mm_storeu_ps(result + i, value);
+		}
+#elif defined(VECTORBATCH_NEON)
+		for (; i + 4 <= count; i += 4) {
+			float32x4_t value = vmulq_f32(vld1q_f32(ax + i), vld1q_f32(bx + i));
+			value = vfmaq_f32(value, vld1q_f32(ay + i), vld1q_f32(by + i));
+			value = vfmaq_f32(value, vld1q_f32(az + i), vld1q_f32(bz + i));
+			vst1q_f32(result + i, value);
+		}
+#endif
+		for (; i < count; i += 1) {
+			result[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+		}
+	}
+
+	void VectorBatch::Normalize(float* x, float* y, int32 count) {
+		int32 i = 0;
+#if defined(VECTORBATCH_SSE)
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1);
+		for (; i + 4 <= count; i += 4) {
+			__m128 vx = _mm_loadu_ps(x + i);
+			__m128 vy = _mm_loadu_ps(y + i);
+			__m128 lengthSquared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+			// Zero vectors get a scale of 1 instead of an infinite one.
+			__m128 nonZero = _mm_cmpgt_ps(lengthSquared, zero);
+			__m128 scale = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+			scale = _mm_or_ps(_mm_and_ps(nonZero, scale), _mm_andnot_ps(nonZero, one));
+			_mm_storeu_ps(x + i, _mm_mul_ps(vx, scale));
+			_mm_storeu_ps(y + i, _mm_mul_ps(vy, scale));
+		}
+#elif defined(VECTORBATCH_NEON)
+		const float32x4_t zero = vdupq_n_f32(0);
+		const float32x4_t one = vdupq_n_f32(1);
+		for (; i + 4 <= count; i += 4) {
+			float32x4_t vx = vld1q_f32(x + i);
+			float32x4_t vy = vld1q_f32(y + i);
+			float32x4_t lengthSquared = vfmaq_f32(vmulq_f32(vx, vx), vy, vy);
+			float32x4_t scale = vbslq_f32(vcgtq_f32(lengthSquared, zero), vdivq_f32(one, vsqrtq_f32(lengthSquared)), one);
+			vst1q_f32(x + i, vmulq_f32(vx, scale));
+			vst1q_f32(y + i, vmulq_f32(vy, scale));
+		}
+#endif
+		for (; i < count; i += 1) {
+			float scale = NormalizeScale(x[i] * x[i] + y[i] * y[i]);
+			x[i] *= scale;
+			y[i] *= scale;
+		}
+	}
+	void VectorBatch::Normalize(float* x, float* y, float* z, int32 count) {
+		int32 i = 0;
+#if defined(VECTORBATCH_SSE)
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1);
+		for (; i + 4 <= count; i += 4) {
+			__m128 vx = _mm_loadu_ps(x + i);
+			__m128 vy = _mm_loadu_ps(y + i);
+			__m128 vz = _mm_loadu_ps(z + i);
+			__m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+			__m128 nonZero = _mm_cmpgt_ps(lengthSquared, zero);
+			__m128 scale = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+			scale = _mm_or_ps(_mm_and_ps(nonZero, scale), _mm_andnot_ps(nonZero, one));
+			_mm_storeu_ps(x + i, _mm_mul_ps(vx, scale));
+			_mm_storeu_ps(y + i, _mm_mul_ps(vy, scale));
+			_mm_storeu_ps(z + i, _mm_mul_ps(vz, scale));
+		}
+#elif defined(VECTORBATCH_NEON)
+		const float32x4_t zero = vdupq_n_f32(0);
+		const float32x4_t one = vdupq_n_f32(1);
+		for (; i + 4 <= count; i += 4) {
+			float32x4_t vx = vld1q_f32(x + i);
+			float32x4_t vy = vld1q_f32(y + i);
+			float32x4_t vz = vld1q_f32(z + i);
+			float32x4_t lengthSquared = vfmaq_f32(vfmaq_f32(vmulq_f32(vx, vx), vy, vy), vz, vz);
+			float32x4_t scale = vbslq_f32(vcgtq_f32(lengthSquared, zero), vdivq_f32(one, vsqrtq_f32(lengthSquared)), one);
+			vst1q_f32(x + i, vmulq_f32(vx, scale));
+			vst1q_f32(y + i, vmulq_f32(vy, scale));
+			vst1q_f32(z + i, vmulq_f32(vz, scale));
+		}
+#endif
+		for (; i < count; i += 1) {
+			float scale = NormalizeScale(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+			x[i] *= scale;
+			y[i] *= scale;
+			z[i] *= scale;
+		}
+	}
+
+	void VectorBatch::Lerp(const float* a, const float* b, float time, float* result, int32 count) {
+		int32 i = 0;
+#if defined(VECTORBATCH_SSE)
+		const __m128 t = _mm_set1_ps(time);
+		for (; i + 4 <= count; i += 4) {
+			__m128 va = _mm_loadu_ps(a + i);
+			__m128 vb = _mm_loadu_ps(b + i);
+			_mm_storeu_ps(result + i, _mm_add_ps(_mm_mul_ps(_mm_sub_ps(vb, va), t), va));
+		}
+#elif defined(VECTORBATCH_NEON)
+		const float32x4_t t = vdupq_n_f32(time);
+		for (; i + 4 <= count; i += 4) {
+			float32x4_t va = vld1q_f32(a + i);
+			float32x4_t vb = vld1q_f32(b + i);
+			vst1q_f32(result + i, vfmaq_f32(va, vsubq_f32(vb, va), t));
+		}
+#endif
+		for (; i < count; i += 1) {
+			result[i] = Math::Lerp(a[i], b[i], time);
+		}
+	}
+	void VectorBatch::MultiplyAdd(float* values, const float* deltas, float scale, int32 count) {
+		int32 i = 0;
+#if defined(VECTORBATCH_SSE)
+		const __m128 s = _mm_set1_ps(scale);
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), s)));
+		}
+#elif defined(VECTORBATCH_NEON)
+		const float32x4_t s = vdupq_n_f32(scale);
+		for (; i + 4 <= count; i += 4) {
+			vst1q_f32(values + i, vfmaq_f32(vld1q_f32(values + i), vld1q_f32(deltas + i), s));
+		}
+#endif
+		for (; i < count; i += 1) {
+			values[i] += deltas[i] * scale;
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+
+namespace Engine {
+	/// @brief Vector math over arrays laid out as structures of arrays, one array per component, such as the positions and velocities of particles.\n
+	/// Processes 4 vectors per SIMD instruction where SSE or NEON is available, the rest one by one.
+	/// Outputs can be the same arrays as inputs, but must not partially overlap them.
+	class VectorBatch final {
+	public:
+		STATIC_CLASS(VectorBatch);
+
+		/// @brief The length of every 2D vector.
+		static void Length(const float* x, const float* y, float* result, int32 count);
+		/// @brief The length of every 3D vector.
+		static void Length(const float* x, const float* y, const float* z, float* result, int32 count);
+		static void LengthSquared(const float* x, const float* y, float* result, int32 count);
+		static void LengthSquared(const float* x, const float* y, const float* z, float* result, int32 count);
+
+		/// @brief The dot product of every pair of 2D vectors.
+		static void Dot(const float* ax, const float* ay, const float* bx, const float* by, float* result, int32 count);
+		/// @brief The dot product of every pair of 3D vectors.
+		static void Dot(const float* ax, const float* ay, const float* az, const float* bx, const float* by, const float* bz, float* result, int32 count);
+
+		/// @brief Normalize every 2D vector in place. Unlike Vector2::Normalize(), zero vectors are left as they are.
+		static void Normalize(float* x, float* y, int32 count);
+		/// @brief Normalize every 3D vector in place. Unlike Vector3::Normalize(), zero vectors are left as they are.
+		static void Normalize(float* x, float* y, float* z, int32 count);
+
+		/// @brief Interpolate a single component array, call it once per component.
+		static void Lerp(const float* a, const float* b, float time, float* result, int32 count);
+		/// @brief values[i] += deltas[i] * scale for a single component array, such as moving positions by velocities over a frame.
+		static void MultiplyAdd(float* values, const float* deltas, float scale, int32 count);
+	};
+}
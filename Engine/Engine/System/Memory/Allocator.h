@@ -0,0 +1,38 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include <cstddef>
+
+namespace Engine {
+	/// @brief A memory source for containers, such as an arena or a per-subsystem heap.\n
+	/// Containers given nullptr use Memory directly, without any virtual call, tagged as MemoryTag::Container.
+	class Allocator {
+	public:
+		virtual ~Allocator() {}
+
+		/// @param alignment A power of 2.
+		virtual void* Allocate(sizeint size, sizeint alignment) = 0;
+		/// @param oldSize The size the memory was allocated with.
+		/// @param alignment The alignment the memory was allocated with.
+		virtual void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize, sizeint alignment) = 0;
+		/// @param size The size the memory was allocated with.
+		virtual void Deallocate(void* ptr, sizeint size) = 0;
+
+		/// @brief Allocate from the allocator, or from Memory if it is nullptr.
+		static void* AllocateFrom(Allocator* allocator, sizeint size, sizeint alignment = alignof(std::max_align_t)) {
+			return allocator == nullptr ? Memory::AllocateAligned(size, alignment, MemoryTag::Container) : allocator->Allocate(size, alignment);
+		}
+		/// @brief Reallocate from the allocator, or from Memory if it is nullptr.
+		static void* ReallocateFrom(Allocator* allocator, void* ptr, sizeint oldSize, sizeint newSize, sizeint alignment = alignof(std::max_align_t)) {
+			return allocator == nullptr ? Memory::Reallocate(ptr, newSize) : allocator->Reallocate(ptr, oldSize, newSize, alignment);
+		}
+		/// @brief Give the memory back to the allocator, or to Memory if it is nullptr.
+		static void DeallocateTo(Allocator* allocator, void* ptr, sizeint size) {
+			if (allocator == nullptr) {
+				Memory::Deallocate(ptr);
+			} else {
+				allocator->Deallocate(ptr, size);
+			}
+		}
+	};
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "Engine/System/Memory/SharedPtr.h"
 
 namespace Engine {
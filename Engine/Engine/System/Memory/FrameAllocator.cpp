@@ -0,0 +1,128 @@
+#include "Engine/System/Memory/FrameAllocator.h"
+#include <atomic>
+#include <cstring>
+
+namespace Engine {
+	namespace {
+		std::atomic<uint64> currentFrame{ 0 };
+
+		struct FrameBlock {
+			FrameBlock* previous = nullptr;
+			sizeint size = 0;
+
+			byte* GetStart() {
+				return (byte*)(this + 1);
+			}
+		};
+
+		struct FrameArena {
+			FrameBlock* block = nullptr;
+			byte* cursor = nullptr;
+			byte* end = nullptr;
+			sizeint used = 0;
+			sizeint capacity = 0;
+			uint64 frame = 0;
+
+			~FrameArena() {
+				FreeBlocks();
+			}
+			void FreeBlocks() {
+				while (block != nullptr) {
+					FrameBlock* previous = block->previous;
+					Memory::Deallocate(block);
+					block = previous;
+				}
+				cursor = nullptr;
+				end = nullptr;
+				capacity = 0;
+			}
+			void AddBlock(sizeint size) {
+				FrameBlock* added = (FrameBlock*)Memory::Allocate(sizeof(FrameBlock) + size);
+				added->previous = block;
+				added->size = size;
+				block = added;
+				cursor = added->GetStart();
+				end = cursor + size;
+				capacity += size;
+			}
+			void Rewind() {
+				if (block != nullptr && block->previous != nullptr) {
+					// The last frame needed several blocks, merge them into one so the next frame fits in.
+					sizeint size = capacity;
+					FreeBlocks();
+					AddBlock(size);
+				} else if (block != nullptr) {
+					cursor = block->GetStart();
+				}
+				used = 0;
+			}
+			void* Allocate(sizeint size, sizeint alignment) {
+				byte* result = Align(cursor, alignment);
+				if (block == nullptr || result + size > end) {
+					sizeint blockSize = (block == nullptr ? FrameAllocator::DefaultBlockSize : block->size * 2);
+					while (blockSize < size + alignment) {
+						blockSize *= 2;
+					}
+					AddBlock(blockSize);
+					result = Align(cursor, alignment);
+				}
+				cursor = result + size;
+				used += size;
+				return result;
+			}
+			static byte* Align(byte* ptr, sizeint alignment) {
+				return (byte*)(((sizeint)ptr + alignment - 1) & ~(alignment - 1));
+			}
+		};
+		thread_local FrameArena arena;
+
+		FrameArena& GetArena() {
+			uint64 frame = currentFrame.load(std::memory_order_acquire);
+			if (arena.frame != frame) {
+				arena.Rewind();
+				arena.frame = frame;
+			}
+			return arena;
+		}
+	}
+
+	namespace {
+		class FrameArenaAllocator final :public Allocator {
+		public:
+			void* Allocate(sizeint size, sizeint alignment) override {
+				return FrameAllocator::Allocate(size, alignment);
+			}
+			void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize, sizeint alignment) override {
+				if (newSize <= oldSize) {
+					return ptr;
+				}
+				void* result = FrameAllocator::Allocate(newSize, alignment);
+				std::memcpy(result, ptr, oldSize);
+				return result;
+			}
+			void Deallocate(void* ptr, sizeint size) override {}
+		};
+	}
+
+	void* FrameAllocator::Allocate(sizeint size, sizeint alignment) {
+		ERR_ASSERT(size > 0, u8"size must be larger than 0.", return nullptr);
+		ERR_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, u8"alignment must be a power of 2.", return nullptr);
+		return GetArena().Allocate(size, alignment);
+	}
+	void FrameAllocator::Reset() {
+		currentFrame.fetch_add(1, std::memory_order_release);
+	}
+	uint64 FrameAllocator::GetFrame() {
+		return currentFrame.load(std::memory_order_acquire);
+	}
+	sizeint FrameAllocator::GetUsedSize() {
+		return GetArena().used;
+	}
+	sizeint FrameAllocator::GetCapacity() {
+		return arena.capacity;
+	}
+	Allocator* FrameAllocator::GetAllocator() {
+		static FrameArenaAllocator allocator;
+		return &allocator;
+	}
+}
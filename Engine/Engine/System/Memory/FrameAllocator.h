@@ -0,0 +1,52 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/Allocator.h"
+#include <cstddef>
+
+namespace Engine {
+	/// @brief Per-thread linear allocator for temporary memory which lives until the end of the frame.\n
+	/// Allocating is a pointer bump and nothing is freed individually, everything becomes invalid after Reset().\n
+	/// Destructors are never called, only put trivially destructible data here or destruct them manually.
+	class FrameAllocator final {
+		STATIC_CLASS(FrameAllocator);
+
+	public:
+		/// @brief Size of the first block of every thread. Blocks grow when a frame needs more.
+		static inline constexpr sizeint DefaultBlockSize = 64 * 1024;
+
+		/// @param alignment Must be a power of 2.
+		static void* Allocate(sizeint size, sizeint alignment = alignof(std::max_align_t));
+		template<typename T, typename ... Args>
+		static T* New(Args&& ... args) {
+			T* ptr = (T*)Allocate(sizeof(T), alignof(T));
+			Memory::Construct(ptr, Memory::Forward<Args>(args)...);
+			return ptr;
+		}
+		/// @brief Allocate default constructed elements.
+		template<typename T>
+		static T* NewArray(sizeint count) {
+			ERR_ASSERT(count > 0, u8"count must be larger than 0.", return nullptr);
+			T* ptr = (T*)Allocate(sizeof(T) * count, alignof(T));
+			for (sizeint i = 0; i < count; i += 1) {
+				Memory::Construct(ptr + i);
+			}
+			return ptr;
+		}
+
+		/// @brief Invalidate the frame allocations of all the threads. Called by Engine at the end of every frame.\n
+		/// Threads rewind their own memory lazily on their next allocation.
+		static void Reset();
+		/// @brief Get how many times Reset() has been called.
+		static uint64 GetFrame();
+
+		/// @brief Bytes allocated by the current thread in this frame.
+		static sizeint GetUsedSize();
+		/// @brief Bytes reserved by the current thread.
+		static sizeint GetCapacity();
+
+		/// @brief Get an Allocator for containers which only live in the current frame.\n
+		/// Deallocating does nothing, growing copies into a new allocation.
+		static Allocator* GetAllocator();
+	};
+}
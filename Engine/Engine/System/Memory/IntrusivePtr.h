@@ -4,6 +4,9 @@
 #include "Engine/System/Memory/Memory.h"
 
 namespace Engine {
+	/// @brief Smart pointer using the reference count stored in the object itself.\n
+	/// T provides Reference(), Dereference() and GetReferenceCount(),
+	/// commonly backed by ReferenceCount, or by LocalReferenceCount for objects confined to one thread.
 	template<typename T>
 	class IntrusivePtr {
 	public:
@@ -1,32 +1,195 @@
 #include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/PoolAllocator.h"
+#include "Engine/System/Memory/MemoryTracker.h"
 #include <memory>
+#include <cstdlib>
+#include <cstring>
 #include "Engine/System/Debug.h"
 
 namespace Engine {
+	namespace {
+		// Put right before every allocation. Keeps the user memory aligned as malloc does.
+		// Block layout: [tracking record] [alignment padding] [header] [user memory]
+		struct alignas(std::max_align_t) AllocationHeader {
+			sizeint size;
+			// -1 for allocations straight from the system.
+			int16 sizeClass;
+			MemoryTag tag;
+			bool tracked;
+			// Bytes between the record and the header for over-aligned allocations.
+			uint16 padding;
+			// log2 of the requested alignment, 0 for the default alignment.
+			byte alignmentShift;
+		};
+		static_assert(sizeof(AllocationHeader) % alignof(std::max_align_t) == 0, "The header must keep the alignment.");
+		static inline constexpr sizeint DefaultAlignment = alignof(std::max_align_t);
+
+		AllocationHeader* GetHeader(void* ptr) {
+			return ((AllocationHeader*)ptr) - 1;
+		}
+		byte* GetBlock(AllocationHeader* header) {
+			return (byte*)header - header->padding - (header->tracked ? MemoryTracker::RecordSize : 0);
+		}
+		sizeint GetAlignment(AllocationHeader* header) {
+			return header->alignmentShift == 0 ? DefaultAlignment : ((sizeint)1 << header->alignmentShift);
+		}
+
+		thread_local MemoryTag currentTag = MemoryTag::General;
+	}
+
 	void* Memory::Allocate(sizeint size) {
+		return Allocate(size, currentTag);
+	}
+	void* Memory::Allocate(sizeint size, MemoryTag tag) {
+		return AllocateAligned(size, DefaultAlignment, tag);
+	}
+	void* Memory::AllocateAligned(sizeint size, sizeint alignment) {
+		return AllocateAligned(size, alignment, currentTag);
+	}
+	void* Memory::AllocateAligned(sizeint size, sizeint alignment, MemoryTag tag) {
 		ERR_ASSERT(size > 0, u8"size must be larger than 0.", return nullptr);
+		ERR_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, u8"alignment must be a power of 2.", return nullptr);
+		ERR_ASSERT(alignment <= MaxAlignment, u8"alignment is too large.", return nullptr);
+		if (alignment < DefaultAlignment) {
+			alignment = DefaultAlignment;
+		}
+
+		bool tracked = MemoryTracker::IsEnabled();
+		sizeint prefix = sizeof(AllocationHeader) + (tracked ? MemoryTracker::RecordSize : 0);
+		// Blocks are aligned by default, so the padding never exceeds this.
+		sizeint extra = alignment - DefaultAlignment;
+		int32 sizeClass = PoolAllocator::GetSizeClass(size + prefix + extra);
+		byte* block;
+		if (sizeClass >= 0) {
+			block = (byte*)PoolAllocator::Allocate(sizeClass);
+		} else {
+			block = (byte*)std::malloc(size + prefix + extra);
+			if (block == nullptr) {
+				return nullptr;
+			}
+		}
 
-		void* ptr = std::malloc(size);
-		return ptr;
+		sizeint user = ((sizeint)(block + prefix) + alignment - 1) & ~(alignment - 1);
+		AllocationHeader* header = GetHeader((void*)user);
+		header->size = size;
+		header->sizeClass = (int16)sizeClass;
+		header->tag = tag;
+		header->tracked = tracked;
+		header->padding = (uint16)(user - (sizeint)(block + prefix));
+		header->alignmentShift = 0;
+		if (alignment > DefaultAlignment) {
+			while (((sizeint)1 << header->alignmentShift) < alignment) {
+				header->alignmentShift += 1;
+			}
+		}
+		if (tracked) {
+			MemoryTracker::OnAllocate(block, size, tag);
+		}
+		return (void*)user;
+	}
+	void Memory::AllocateMany(sizeint size, int32 count, void** results) {
+		ERR_ASSERT(size > 0, u8"size must be larger than 0.", return);
+		ERR_ASSERT(results != nullptr || count <= 0, u8"results cannot be nullptr.", return);
+		int32 sizeClass = PoolAllocator::GetSizeClass(size + sizeof(AllocationHeader));
+		if (sizeClass < 0 || MemoryTracker::IsEnabled()) {
+			for (int32 i = 0; i < count; i += 1) {
+				results[i] = Allocate(size);
+			}
+			return;
+		}
+
+		// Blocks come in as results and go out as the user memory after their headers.
+		PoolAllocator::AllocateMany(sizeClass, count, results);
+		MemoryTag tag = currentTag;
+		for (int32 i = 0; i < count; i += 1) {
+			AllocationHeader* header = (AllocationHeader*)results[i];
+			header->size = size;
+			header->sizeClass = (int16)sizeClass;
+			header->tag = tag;
+			header->tracked = false;
+			header->padding = 0;
+			header->alignmentShift = 0;
+			results[i] = header + 1;
+		}
 	}
 	void* Memory::Reallocate(void* ptr, sizeint newSize) {
 		ERR_ASSERT(ptr != nullptr, u8"ptr must not be nullptr!", return nullptr);
 		ERR_ASSERT(newSize > 0, u8"newSize must be larger than 0.", return nullptr);
 
-		void* result = std::realloc(ptr, newSize);
+		AllocationHeader* header = GetHeader(ptr);
+		if (!header->tracked && header->alignmentShift == 0 && !MemoryTracker::IsEnabled()) {
+			int32 newClass = PoolAllocator::GetSizeClass(newSize + sizeof(AllocationHeader));
+			if (header->sizeClass < 0 && newClass < 0) {
+				header = (AllocationHeader*)std::realloc(header, newSize + sizeof(AllocationHeader));
+				if (header == nullptr) {
+					return nullptr;
+				}
+				header->size = newSize;
+				return header + 1;
+			}
+			if (header->sizeClass >= 0 && header->sizeClass == newClass) {
+				// Still fits in the block.
+				header->size = newSize;
+				return ptr;
+			}
+		}
+
+		void* result = AllocateAligned(newSize, GetAlignment(header), header->tag);
+		if (result == nullptr) {
+			return nullptr;
+		}
+		std::memcpy(result, ptr, header->size < newSize ? header->size : newSize);
+		Deallocate(ptr);
 		return result;
 	}
 	void Memory::Deallocate(void* ptr) {
-		std::free(ptr);
+		if (ptr == nullptr) {
+			return;
+		}
+
+		AllocationHeader* header = GetHeader(ptr);
+		byte* block = GetBlock(header);
+		if (header->tracked) {
+			MemoryTracker::OnDeallocate(block, header->size, header->tag);
+		}
+		if (header->sizeClass >= 0) {
+			PoolAllocator::Deallocate(block, header->sizeClass);
+		} else {
+			std::free(block);
+		}
+	}
+	sizeint Memory::GetAllocationSize(void* ptr) {
+		ERR_ASSERT(ptr != nullptr, u8"ptr must not be nullptr!", return 0);
+		return GetHeader(ptr)->size;
+	}
+	MemoryTag Memory::GetAllocationTag(void* ptr) {
+		ERR_ASSERT(ptr != nullptr, u8"ptr must not be nullptr!", return MemoryTag::General);
+		return GetHeader(ptr)->tag;
+	}
+
+	Memory::TagScope::TagScope(MemoryTag tag) :previous(currentTag) {
+		currentTag = tag;
+	}
+	Memory::TagScope::~TagScope() {
+		currentTag = previous;
+	}
+	MemoryTag Memory::GetCurrentTag() {
+		return currentTag;
 	}
 	sizeint Memory::GetHeapArrayElementCount(void* ptr) {
 		return *(((sizeint*)ptr) - 1);
 	}
 }
 
-void* operator new(size_t size, bool reserved) {
+void* operator new(size_t size, Engine::MemoryNewTag tag) {
 	return Engine::Memory::Allocate(size);
 }
-void operator delete(void* ptr, bool reserved){
+void operator delete(void* ptr, Engine::MemoryNewTag tag){
+	Engine::Memory::Deallocate(ptr);
+}
+void* operator new(size_t size, std::align_val_t alignment, Engine::MemoryNewTag tag) {
+	return Engine::Memory::AllocateAligned(size, (size_t)alignment);
+}
+void operator delete(void* ptr, std::align_val_t alignment, Engine::MemoryNewTag tag) {
 	Engine::Memory::Deallocate(ptr);
 }
\ No newline at end of file
@@ -9,6 +9,18 @@
 // https://www.github.com/godotengine/godot
 
 namespace Engine {
+	/// @brief Categories for memory tracking. See MemoryTracker.
+	enum class MemoryTag :byte {
+		General,
+		Container,
+		String,
+		Job,
+		Node,
+		Resource,
+		Reflection,
+	};
+	static inline constexpr int32 MemoryTagCount = 7;
+
 	class Memory final {
 		STATIC_CLASS(Memory);
 	public:
@@ -36,7 +48,7 @@ namespace Engine {
 		// Turn everything to Right Value Reference.
 		// Convenient tool for moving objects.
 		template<typename T>
-		static typename ReferenceRemover<T>::Type Move(T&& obj) {
+		static typename ReferenceRemover<T>::Type&& Move(T&& obj) {
 			return static_cast<typename ReferenceRemover<T>::Type&&>(obj);
 		}
 
@@ -53,11 +65,42 @@ namespace Engine {
 #pragma endregion
 
 		// Allocate a memory of the specific size.
+		// Small sizes are served by PoolAllocator, others go to the system.
 		static void* Allocate(sizeint size);
+		// Allocate count memories of the same size at once, each freed by Deallocate().
+		// Cheaper than as many Allocate() calls when they come from PoolAllocator.
+		static void AllocateMany(sizeint size, int32 count, void** results);
 		// Resize a memory block.
 		static void* Reallocate(void* ptr, sizeint newSize);
 		// Free a memory block.
 		static void Deallocate(void* ptr);
+		// Get the size requested for a memory block.
+		static sizeint GetAllocationSize(void* ptr);
+
+		static inline constexpr sizeint MaxAlignment = 4096;
+		// Allocate a memory aligned to the alignment, which must be a power of 2 no larger than MaxAlignment.
+		// Freed by Deallocate(), Reallocate() keeps the alignment.
+		static void* AllocateAligned(sizeint size, sizeint alignment);
+		// Allocate an aligned memory, tagged for MemoryTracker.
+		static void* AllocateAligned(sizeint size, sizeint alignment, MemoryTag tag);
+
+		// Allocate a memory of the specific size, tagged for MemoryTracker.
+		static void* Allocate(sizeint size, MemoryTag tag);
+		// Get the tag a memory block is allocated with.
+		static MemoryTag GetAllocationTag(void* ptr);
+
+		// Tags the allocations of the current thread without an explicit tag while alive.
+		class TagScope final {
+		public:
+			TagScope(MemoryTag tag);
+			~TagScope();
+			TagScope(const TagScope&) = delete;
+			TagScope& operator=(const TagScope&) = delete;
+		private:
+			MemoryTag previous;
+		};
+		// Get the tag used by allocations of the current thread without an explicit tag.
+		static MemoryTag GetCurrentTag();
 
 		template<typename T>
 		static constexpr bool IsDestructionNeeded() {
@@ -98,15 +141,16 @@ namespace Engine {
 		static T* NewArray(sizeint count, Args&& ... args) {
 			ERR_ASSERT(count > 0, u8"count must be larger than 0.", return nullptr);
 
-			// Reserve a few bytes of size_t for saving the count data.
-			sizeint size = sizeof(T) * count + sizeof(sizeint);
+			// Reserve a few bytes of size_t for saving the count data, keeping the elements aligned.
+			constexpr sizeint offset = GetArrayHeaderSize<T>();
+			sizeint size = sizeof(T) * count + offset;
 
-			// Allocate memory and write count data.
-			sizeint* rawPtr = (sizeint*)Allocate(size);
-			rawPtr[0] = count;
+			// Allocate memory and write count data right before the elements.
+			byte* rawPtr = (byte*)(alignof(T) > alignof(std::max_align_t) ? AllocateAligned(size, alignof(T)) : Allocate(size));
+			T* ptr = (T*)(rawPtr + offset);
+			((sizeint*)ptr)[-1] = count;
 
 			// Do constructions.
-			T* ptr = (T*)(rawPtr + 1);
 			for (sizeint i = 0; i < count; i += 1) {
 				Construct(ptr + i, Forward<Args>(args)...);
 			}
@@ -121,8 +165,8 @@ namespace Engine {
 			}
 
 			// Get count data.
-			sizeint* rawPtr = ((sizeint*)ptr) - 1;
-			sizeint count = rawPtr[0];
+			sizeint count = ((sizeint*)ptr)[-1];
+			byte* rawPtr = ((byte*)ptr) - GetArrayHeaderSize<T>();
 
 			// Do destructions if necessary.
 			if (IsDestructionNeeded<T>()) {
@@ -136,15 +180,28 @@ namespace Engine {
 		}
 
 		static sizeint GetHeapArrayElementCount(void* ptr);
+
+	private:
+		template<typename T>
+		static constexpr sizeint GetArrayHeaderSize() {
+			return alignof(T) > sizeof(sizeint) ? alignof(T) : sizeof(sizeint);
+		}
 	};
+
+	/// @brief Tag type selecting the engine operator new overloads used by MEMNEW.\n
+	/// A dedicated type keeps placement new (void*) from ever converting into these overloads.
+	struct MemoryNewTag {};
 }
 
-#define MEMNEW(type) new (true) type
+#define MEMNEW(type) new (::Engine::MemoryNewTag{}) type
 #define MEMDEL(ptr) ::Engine::Memory::Delete(ptr)
 #define MEMNEWARR(type,count) ::Engine::Memory::NewArray<type>(count)
 #define MEMDELARR(ptr) ::Engine::Memory::DeleteArray(ptr)
 
-void* operator new(size_t size, bool reserved);
+void* operator new(size_t size, Engine::MemoryNewTag tag);
 // Paired operator delete for freeing memory when exception is thrown in ctor.
-void operator delete(void* ptr, bool reserved);
+void operator delete(void* ptr, Engine::MemoryNewTag tag);
+// Used by MEMNEW for over-aligned types.
+void* operator new(size_t size, std::align_val_t alignment, Engine::MemoryNewTag tag);
+void operator delete(void* ptr, std::align_val_t alignment, Engine::MemoryNewTag tag);
 
@@ -0,0 +1,174 @@
+#include "Engine/System/Memory/MemoryTracker.h"
+#include "Engine/System/Debug.h"
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+
+namespace Engine {
+	namespace {
+		struct alignas(16) TrackingRecord {
+			TrackingRecord* previous;
+			TrackingRecord* next;
+			uint64 serial;
+			sizeint size;
+			MemoryTag tag;
+		};
+		static_assert(sizeof(TrackingRecord) == MemoryTracker::RecordSize, "RecordSize must match the record.");
+
+		struct TagCounters {
+			std::atomic<sizeint> bytes{ 0 };
+			std::atomic<sizeint> peakBytes{ 0 };
+			std::atomic<int64> count{ 0 };
+			std::atomic<uint64> totalCount{ 0 };
+			std::atomic<sizeint> budget{ 0 };
+			std::atomic<bool> overBudget{ false };
+		};
+		TagCounters counters[MemoryTagCount];
+		std::atomic<bool> enabled{ false };
+
+		// Live tracked allocations, newest first.
+		struct RecordList {
+			std::mutex mutex;
+			TrackingRecord* head = nullptr;
+			uint64 nextSerial = 0;
+		};
+		RecordList& GetRecordList() {
+			// Never destroyed, allocations may still be freed during static destruction.
+			static RecordList* list = new RecordList();
+			return *list;
+		}
+	}
+
+	void MemoryTracker::SetEnabled(bool value) {
+		enabled.store(value, std::memory_order_relaxed);
+	}
+	bool MemoryTracker::IsEnabled() {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	MemoryTagStats MemoryTracker::GetStats(MemoryTag tag) {
+		auto& counter = counters[(int32)tag];
+		MemoryTagStats stats;
+		stats.bytes = counter.bytes.load(std::memory_order_relaxed);
+		stats.peakBytes = counter.peakBytes.load(std::memory_order_relaxed);
+		stats.count = counter.count.load(std::memory_order_relaxed);
+		stats.totalCount = counter.totalCount.load(std::memory_order_relaxed);
+		stats.budget = counter.budget.load(std::memory_order_relaxed);
+		return stats;
+	}
+	void MemoryTracker::ResetPeaks() {
+		for (auto& counter : counters) {
+			counter.peakBytes.store(counter.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	}
+	void MemoryTracker::SetBudget(MemoryTag tag, sizeint bytes) {
+		auto& counter = counters[(int32)tag];
+		counter.budget.store(bytes, std::memory_order_relaxed);
+		counter.overBudget.store(false, std::memory_order_relaxed);
+	}
+	const u8char* MemoryTracker::GetTagName(MemoryTag tag) {
+		switch (tag) {
+			case MemoryTag::General:
+				return u8"General";
+			case MemoryTag::Container:
+				return u8"Container";
+			case MemoryTag::String:
+				return u8"String";
+			case MemoryTag::Job:
+				return u8"Job";
+			case MemoryTag::Node:
+				return u8"Node";
+			case MemoryTag::Resource:
+				return u8"Resource";
+			case MemoryTag::Reflection:
+				return u8"Reflection";
+			default:
+				return u8"Unknown";
+		}
+	}
+
+	uint64 MemoryTracker::GetSerial() {
+		auto& list = GetRecordList();
+		std::lock_guard<std::mutex> lock(list.mutex);
+		return list.nextSerial;
+	}
+	int32 MemoryTracker::DumpLiveAllocations(uint64 sinceSerial) {
+		// Only print with fixed buffers here, printing must not allocate while holding the lock.
+		char message[192];
+		for (int32 i = 0; i < MemoryTagCount; i += 1) {
+			MemoryTagStats stats = GetStats((MemoryTag)i);
+			std::snprintf(message, sizeof(message), "[Memory] %s: %zu bytes in %lld allocations, peak %zu bytes, budget %zu bytes.",
+				(const char*)GetTagName((MemoryTag)i), stats.bytes, (long long)stats.count, stats.peakBytes, stats.budget);
+			INFO_MSG((const u8char*)message);
+		}
+
+		auto& list = GetRecordList();
+		std::lock_guard<std::mutex> lock(list.mutex);
+		int32 count = 0;
+		for (TrackingRecord* record = list.head; record != nullptr; record = record->next) {
+			if (record->serial < sinceSerial) {
+				// Newest first, the rest are older.
+				break;
+			}
+			std::snprintf(message, sizeof(message), "[Memory] #%llu %s %zu bytes",
+				(unsigned long long)record->serial, (const char*)GetTagName(record->tag), record->size);
+			INFO_MSG((const u8char*)message);
+			count += 1;
+		}
+		return count;
+	}
+
+	void MemoryTracker::OnAllocate(void* block, sizeint size, MemoryTag tag) {
+		TrackingRecord* record = (TrackingRecord*)block;
+		record->size = size;
+		record->tag = tag;
+		{
+			auto& list = GetRecordList();
+			std::lock_guard<std::mutex> lock(list.mutex);
+			record->serial = list.nextSerial;
+			list.nextSerial += 1;
+			record->previous = nullptr;
+			record->next = list.head;
+			if (list.head != nullptr) {
+				list.head->previous = record;
+			}
+			list.head = record;
+		}
+
+		auto& counter = counters[(int32)tag];
+		sizeint bytes = counter.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+		counter.count.fetch_add(1, std::memory_order_relaxed);
+		counter.totalCount.fetch_add(1, std::memory_order_relaxed);
+		sizeint peak = counter.peakBytes.load(std::memory_order_relaxed);
+		while (bytes > peak && !counter.peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {}
+
+		sizeint budget = counter.budget.load(std::memory_order_relaxed);
+		if (budget > 0 && bytes > budget && !counter.overBudget.exchange(true, std::memory_order_relaxed)) {
+			char message[128];
+			std::snprintf(message, sizeof(message), "Memory tag %s is over budget: %zu / %zu bytes.", (const char*)GetTagName(tag), bytes, budget);
+			WARN_MSG((const u8char*)message);
+		}
+	}
+	void MemoryTracker::OnDeallocate(void* block, sizeint size, MemoryTag tag) {
+		TrackingRecord* record = (TrackingRecord*)block;
+		{
+			auto& list = GetRecordList();
+			std::lock_guard<std::mutex> lock(list.mutex);
+			if (record->previous != nullptr) {
+				record->previous->next = record->next;
+			} else {
+				list.head = record->next;
+			}
+			if (record->next != nullptr) {
+				record->next->previous = record->previous;
+			}
+		}
+
+		auto& counter = counters[(int32)tag];
+		sizeint bytes = counter.bytes.fetch_sub(size, std::memory_order_relaxed) - size;
+		counter.count.fetch_sub(1, std::memory_order_relaxed);
+		if (bytes <= counter.budget.load(std::memory_order_relaxed)) {
+			counter.overBudget.store(false, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+
+namespace Engine {
+	struct MemoryTagStats {
+		/// @brief Bytes currently allocated.
+		sizeint bytes = 0;
+		/// @brief Highest bytes since tracking started or MemoryTracker::ResetPeaks().
+		sizeint peakBytes = 0;
+		/// @brief Allocations currently alive.
+		int64 count = 0;
+		/// @brief Allocations ever made.
+		uint64 totalCount = 0;
+		/// @brief 0 means no budget.
+		sizeint budget = 0;
+	};
+
+	/// @brief Opt-in accounting of Memory allocations by MemoryTag.\n
+	/// Only allocations made while enabled are tracked, each one costs RecordSize more bytes and a global lock.\n
+	/// Use Memory::TagScope or Memory::Allocate(size, tag) to tag the allocations.
+	class MemoryTracker final {
+		STATIC_CLASS(MemoryTracker);
+
+	public:
+		/// @brief Bytes put before every tracked allocation.
+		static inline constexpr sizeint RecordSize = 48;
+
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled();
+
+		static MemoryTagStats GetStats(MemoryTag tag);
+		static void ResetPeaks();
+		/// @brief Warn once every time the tracked bytes of the tag go over the budget.
+		/// @param bytes 0 for no budget.
+		static void SetBudget(MemoryTag tag, sizeint bytes);
+		static const u8char* GetTagName(MemoryTag tag);
+
+		/// @brief Get the serial number the next tracked allocation will get.\n
+		/// Take one before a suspicious section and dump the allocations since then to find leaks.
+		static uint64 GetSerial();
+		/// @brief Print the stats of every tag, and the tracked allocations still alive which are made since the serial.
+		/// @return Count of the printed allocations.
+		static int32 DumpLiveAllocations(uint64 sinceSerial = 0);
+
+	private:
+		friend class Memory;
+		static void OnAllocate(void* record, sizeint size, MemoryTag tag);
+		static void OnDeallocate(void* record, sizeint size, MemoryTag tag);
+	};
+}
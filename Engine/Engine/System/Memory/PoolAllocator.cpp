@@ -0,0 +1,162 @@
+#include "Engine/System/Memory/PoolAllocator.h"
+#include "Engine/System/Debug.h"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+namespace Engine {
+	namespace {
+		// Free blocks are linked through their first bytes.
+		struct BlockFreeList {
+			void* head = nullptr;
+			int32 count = 0;
+
+			void Push(void* block) {
+				*(void**)block = head;
+				head = block;
+				count += 1;
+			}
+			void* Pop() {
+				void* block = head;
+				head = *(void**)block;
+				count -= 1;
+				return block;
+			}
+			void MoveTo(BlockFreeList& target, int32 count) {
+				for (int32 i = 0; i < count && head != nullptr; i += 1) {
+					target.Push(Pop());
+				}
+			}
+		};
+
+		std::atomic<sizeint> reservedSize{ 0 };
+
+		struct SharedPool {
+			std::mutex mutex;
+			BlockFreeList free[PoolAllocator::ClassCount];
+
+			// Called with the mutex locked.
+			void AllocateSlab(int32 sizeClass) {
+				// Straight from the system, Memory::Allocate() is the one calling us.
+				byte* slab = (byte*)std::malloc(PoolAllocator::SlabSize);
+				FATAL_ASSERT(slab != nullptr, u8"Out of memory!");
+				reservedSize.fetch_add(PoolAllocator::SlabSize, std::memory_order_relaxed);
+
+				sizeint blockSize = PoolAllocator::GetBlockSize(sizeClass);
+				for (sizeint offset = 0; offset + blockSize <= PoolAllocator::SlabSize; offset += blockSize) {
+					free[sizeClass].Push(slab + offset);
+				}
+			}
+		};
+		SharedPool& GetSharedPool() {
+			// Never destroyed, blocks may still be freed during static destruction.
+			static SharedPool* pool = new SharedPool();
+			return *pool;
+		}
+
+		// Trivially destructible, so it stays usable while the thread is shutting down.
+		struct LocalCache {
+			BlockFreeList free[PoolAllocator::ClassCount];
+			bool registered;
+			bool destroyed;
+		};
+		thread_local LocalCache localCache;
+
+		// Gives the cached blocks back when the thread exits.
+		struct LocalCacheFlusher {
+			~LocalCacheFlusher() {
+				auto& shared = GetSharedPool();
+				std::lock_guard<std::mutex> lock(shared.mutex);
+				for (int32 i = 0; i < PoolAllocator::ClassCount; i += 1) {
+					localCache.free[i].MoveTo(shared.free[i], localCache.free[i].count);
+				}
+				localCache.destroyed = true;
+			}
+		};
+		thread_local LocalCacheFlusher localCacheFlusher;
+	}
+
+	int32 PoolAllocator::GetSizeClass(sizeint size) {
+		if (size <= 256) {
+			return size == 0 ? 0 : (int32)((size + 15) / 16) - 1;
+		}
+		if (size <= 512) {
+			return 16 + (int32)((size - 256 + 63) / 64) - 1;
+		}
+		if (size <= MaxBlockSize) {
+			return 20 + (int32)((size - 512 + 127) / 128) - 1;
+		}
+		return -1;
+	}
+	sizeint PoolAllocator::GetBlockSize(int32 sizeClass) {
+		if (sizeClass < 16) {
+			return (sizeint)(sizeClass + 1) * 16;
+		}
+		if (sizeClass < 20) {
+			return 256 + (sizeint)(sizeClass - 15) * 64;
+		}
+		return 512 + (sizeint)(sizeClass - 19) * 128;
+	}
+
+	void* PoolAllocator::Allocate(int32 sizeClass) {
+		auto& local = localCache.free[sizeClass];
+		if (local.head != nullptr) {
+			return local.Pop();
+		}
+
+		auto& shared = GetSharedPool();
+		std::lock_guard<std::mutex> lock(shared.mutex);
+		if (shared.free[sizeClass].head == nullptr) {
+			shared.AllocateSlab(sizeClass);
+		}
+		if (localCache.destroyed) {
+			return shared.free[sizeClass].Pop();
+		}
+		if (!localCache.registered) {
+			// Touch the flusher so it gets constructed, and destructed on thread exit.
+			(void)&localCacheFlusher;
+			localCache.registered = true;
+		}
+		shared.free[sizeClass].MoveTo(local, BatchSize);
+		return local.Pop();
+	}
+	void PoolAllocator::AllocateMany(int32 sizeClass, int32 count, void** blocks) {
+		auto& local = localCache.free[sizeClass];
+		int32 i = 0;
+		while (i < count && local.head != nullptr) {
+			blocks[i] = local.Pop();
+			i += 1;
+		}
+		if (i >= count) {
+			return;
+		}
+
+		auto& shared = GetSharedPool();
+		std::lock_guard<std::mutex> lock(shared.mutex);
+		for (; i < count; i += 1) {
+			if (shared.free[sizeClass].head == nullptr) {
+				shared.AllocateSlab(sizeClass);
+			}
+			blocks[i] = shared.free[sizeClass].Pop();
+		}
+	}
+	void PoolAllocator::Deallocate(void* block, int32 sizeClass) {
+		auto& local = localCache.free[sizeClass];
+		if (localCache.destroyed) {
+			auto& shared = GetSharedPool();
+			std::lock_guard<std::mutex> lock(shared.mutex);
+			shared.free[sizeClass].Push(block);
+			return;
+		}
+
+		local.Push(block);
+		if (local.count > LocalLimit) {
+			auto& shared = GetSharedPool();
+			std::lock_guard<std::mutex> lock(shared.mutex);
+			local.MoveTo(shared.free[sizeClass], LocalLimit - BatchSize);
+		}
+	}
+	sizeint PoolAllocator::GetReservedSize() {
+		return reservedSize.load(std::memory_order_relaxed);
+	}
+}
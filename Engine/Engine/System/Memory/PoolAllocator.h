@@ -0,0 +1,33 @@
+#pragma once
+#include "Engine/System/Definition.h"
+
+namespace Engine {
+	/// @brief Fixed-size block pools for small allocations, used by Memory::Allocate().\n
+	/// Each thread caches free blocks of every size class, exchanging them with the shared pools in batches.\n
+	/// Blocks can be freed on any thread. Slabs are never given back to the system.
+	class PoolAllocator final {
+		STATIC_CLASS(PoolAllocator);
+
+	public:
+		static inline constexpr sizeint MaxBlockSize = 1024;
+		/// @brief 16 byte steps up to 256, 64 byte steps up to 512, 128 byte steps up to 1024.
+		static inline constexpr int32 ClassCount = 24;
+		static inline constexpr sizeint SlabSize = 64 * 1024;
+		static inline constexpr int32 BatchSize = 32;
+		static inline constexpr int32 LocalLimit = BatchSize * 4;
+
+		/// @return -1 if the size is larger than MaxBlockSize.
+		static int32 GetSizeClass(sizeint size);
+		static sizeint GetBlockSize(int32 sizeClass);
+
+		/// @brief Get a block of the size class. Aligned to 16 bytes.
+		static void* Allocate(int32 sizeClass);
+		/// @brief Get count blocks of the size class, taking what the thread doesn't cache from the shared pool under a single lock.
+		static void AllocateMany(int32 sizeClass, int32 count, void** blocks);
+		/// @param sizeClass Must be the one the block is allocated with.
+		static void Deallocate(void* block, int32 sizeClass);
+
+		/// @brief Bytes taken from the system by all the pools.
+		static sizeint GetReservedSize();
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Thread/Epoch.h"
+#include <atomic>
+
+namespace Engine {
+	/// @brief A value read far more often than written, read without locking nor reference counting.\n
+	/// Writers publish a modified copy atomically and the old version is freed through Epoch once no reader can see it.
+	/// Unlike CopyOnWrite, reading writes nothing shared, and the handle may be read and written from different threads at once.\n
+	/// Writes are serialized by the caller, each copies the whole value, so keep it for small ones changing rarely.
+	template<typename T>
+	class ReadMostly final {
+	public:
+		ReadMostly() :current(MEMNEW(T())) {}
+		explicit ReadMostly(T&& value) :current(MEMNEW(T(Memory::Move(value)))) {}
+		~ReadMostly() {
+			// Readers pinned earlier may still see it.
+			Epoch::Retire(current.load(std::memory_order_relaxed));
+		}
+		ReadMostly(const ReadMostly&) = delete;
+		ReadMostly& operator=(const ReadMostly&) = delete;
+
+		/// @brief The current version, never nullptr.
+		/// Valid until the end of the EpochGuard it is read in, or until the next write on the thread writing.
+		const T* Read() const {
+			return current.load(std::memory_order_acquire);
+		}
+		/// @brief Publish a copy of the current version changed by modify(T&).
+		template<typename F>
+		void Update(F&& modify) {
+			T* next = MEMNEW(T(*current.load(std::memory_order_relaxed)));
+			modify(*next);
+			Publish(next);
+		}
+		void Set(T&& value) {
+			Publish(MEMNEW(T(Memory::Move(value))));
+		}
+
+	private:
+		void Publish(T* next) {
+			Epoch::Retire(current.exchange(next, std::memory_order_acq_rel));
+		}
+
+		std::atomic<T*> current;
+	};
+}
@@ -8,14 +8,33 @@ namespace Engine {
 	struct SharedPtrCounter {
 		ReferenceCount refCount;
 		ReferenceCount weakCount;
+		// Set when the object lives in the same block with the counter, see SharedPtr::Create().
+		// Otherwise the object is deleted with MEMDEL.
+		void (*destroyObject)(SharedPtrCounter* counter) = nullptr;
+	};
+	/// @brief The counter and the object in one allocation.
+	template<typename T>
+	struct SharedPtrBlock {
+		SharedPtrCounter counter;
+		alignas(T) byte storage[sizeof(T)];
 	};
 
 	template<typename T>
 	class SharedPtr {
 	public:
+		/// @brief Create an object together with its counter in a single allocation.
 		template<typename ... Args>
 		static SharedPtr Create(Args&& ... args) {
-			return SharedPtr(MEMNEW(T(Memory::Forward<Args>(args)...)));
+			using Block = SharedPtrBlock<T>;
+			Block* block = (Block*)Memory::AllocateAligned(sizeof(Block), alignof(Block));
+			Memory::Construct(&block->counter);
+			T* object = (T*)block->storage;
+			Memory::Construct(object, Memory::Forward<Args>(args)...);
+			block->counter.destroyObject = [](SharedPtrCounter* counter) {
+				// The counter is the first member, so it shares the address with the block.
+				Memory::Destruct((T*)((Block*)counter)->storage);
+			};
+			return SharedPtr(object, &block->counter);
 		}
 
 		SharedPtr(T* ptr, SharedPtrCounter* data) :ptr(ptr), data(data) {
@@ -23,6 +42,7 @@ namespace Engine {
 		}
 
 		SharedPtr() {}
+		/// @brief Adopt an object allocated with MEMNEW. The counter is allocated separately.
 		explicit SharedPtr(T* ptr) :ptr(ptr) {
 			if (ptr == nullptr) {
 				return;
@@ -120,7 +140,12 @@ namespace Engine {
 				return;
 			}
 			if (data->refCount.Dereference() == 0) {
-				MEMDEL(ptr);
+				if (data->destroyObject != nullptr) {
+					// Destroyed as the created type, the storage goes with the counter.
+					data->destroyObject(data);
+				} else {
+					MEMDEL(ptr);
+				}
 
 				if (data->weakCount.Get() == 0) {
 					MEMDEL(data);
@@ -131,4 +156,25 @@ namespace Engine {
 		T* ptr = nullptr;
 		SharedPtrCounter* data = nullptr;
 	};
+
+	/// @brief An object in static storage, shared through SharedPtr without allocating.\n
+	/// The block keeps a reference of its own and is never destructed, so the object stays valid for SharedPtrs released during static destruction.
+	template<typename T>
+	class StaticSharedPtrBlock final {
+	public:
+		template<typename ... Args>
+		StaticSharedPtrBlock(Args&& ... args) {
+			Memory::Construct((T*)storage, Memory::Forward<Args>(args)...);
+			counter.refCount.Reference();
+		}
+		StaticSharedPtrBlock(const StaticSharedPtrBlock&) = delete;
+		StaticSharedPtrBlock& operator=(const StaticSharedPtrBlock&) = delete;
+
+		SharedPtr<T> Get() {
+			return SharedPtr<T>((T*)storage, &counter);
+		}
+	private:
+		SharedPtrCounter counter;
+		alignas(T) byte storage[sizeof(T)];
+	};
 }
\ No newline at end of file
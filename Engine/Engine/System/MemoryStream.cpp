@@ -0,0 +1,97 @@
+#include "Engine/System/MemoryStream.h"
+#include <cstring>
+
+namespace Engine {
+	MemoryStream::MemoryStream(List<byte>&& data) :owned(Memory::Move(data)) {
+		length = owned.GetCount();
+	}
+	MemoryStream::MemoryStream(const byte* data, int32 length) :borrowed(data), length(length), isOwned(false) {
+		ERR_ASSERT(length >= 0 && (data != nullptr || length == 0), u8"data is not valid.", this->length = 0);
+	}
+
+	void MemoryStream::Close() {
+		owned.Clear();
+		borrowed = nullptr;
+		length = 0;
+		position = 0;
+		valid = false;
+	}
+	bool MemoryStream::IsValid() const {
+		return valid;
+	}
+	bool MemoryStream::CanRead() const {
+		return valid;
+	}
+	bool MemoryStream::CanWrite() const {
+		return valid && isOwned;
+	}
+	bool MemoryStream::CanRandomAccess() const {
+		return true;
+	}
+
+	ResultCode MemoryStream::SetPosition(int64 position) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return ResultCode::InvalidStream);
+		ERR_ASSERT(position >= 0 && position <= length, u8"position out of the stream.", return ResultCode::InvalidArgument);
+		this->position = (int32)position;
+		return ResultCode::OK;
+	}
+	int64 MemoryStream::GetPosition() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return -1);
+		return position;
+	}
+	int64 MemoryStream::GetLength() const {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return -1);
+		return length;
+	}
+
+	bool MemoryStream::CanReadSpan() const {
+		return valid;
+	}
+	ByteSpan MemoryStream::ReadSpan(int32 length) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid stream!", return ByteSpan());
+		ERR_ASSERT(length >= 0, u8"length must be greater than 0.", return ByteSpan());
+		int32 size = this->length - position < length ? this->length - position : length;
+		ByteSpan result{ GetData() + position, size };
+		position += size;
+		return result;
+	}
+
+	bool MemoryStream::IsOwned() const {
+		return isOwned;
+	}
+	const byte* MemoryStream::GetData() const {
+		return isOwned ? owned.GetRawElementPtr() : borrowed;
+	}
+	List<byte> MemoryStream::TakeData() {
+		ERR_ASSERT(isOwned, u8"The bytes are borrowed.", return List<byte>());
+		List<byte> result = Memory::Move(owned);
+		Close();
+		return result;
+	}
+
+	ResultCode MemoryStream::WriteBytesUnchecked(const byte* valuePtr, int32 length) {
+		ERR_ASSERT(isOwned, u8"Cannot write to borrowed bytes.", return ResultCode::NoPermission);
+		if (position + length > owned.GetCount()) {
+			// The bytes may come from the stream itself, find them again once it grew.
+			const byte* start = owned.GetRawElementPtr();
+			bool inside = start != nullptr && valuePtr >= start && valuePtr < start + owned.GetCount();
+			sizeint offset = inside ? (sizeint)(valuePtr - start) : 0;
+			owned.SetCount(position + length);
+			if (inside) {
+				valuePtr = owned.GetRawElementPtr() + offset;
+			}
+		}
+		std::memmove(owned.GetRawElementPtr() + position, valuePtr, length);
+		position += length;
+		this->length = owned.GetCount();
+		return ResultCode::OK;
+	}
+	int32 MemoryStream::ReadBytesUnchecked(byte* buffer, int32 length) {
+		int32 size = this->length - position < length ? this->length - position : length;
+		if (size > 0) {
+			std::memcpy(buffer, GetData() + position, size);
+			position += size;
+		}
+		return size;
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Engine/System/Stream.h"
+
+namespace Engine {
+	/// @brief A Stream over bytes in memory, either owned in a List that grows on writes, or borrowed read-only from somewhere else.\n
+	/// ReadSpan() reads in place, so resources already in memory can be parsed without a copy per field.
+	/// Borrowed memory must outlive the stream.
+	class MemoryStream final :public Stream {
+		REFLECTION_CLASS(::Engine::MemoryStream, ::Engine::Stream) {}
+
+	public:
+		/// @brief An empty owned stream, for writing.
+		MemoryStream() = default;
+		/// @brief Own the bytes, reading from the start.
+		explicit MemoryStream(List<byte>&& data);
+		/// @brief Borrow the bytes read-only.
+		MemoryStream(const byte* data, int32 length);
+
+		void Close() override;
+		bool IsValid() const override;
+		bool CanRead() const override;
+		bool CanWrite() const override;
+		bool CanRandomAccess() const override;
+
+		ResultCode SetPosition(int64 position) override;
+		int64 GetPosition() const override;
+		int64 GetLength() const override;
+
+		bool CanReadSpan() const override;
+		ByteSpan ReadSpan(int32 length) override;
+
+		bool IsOwned() const;
+		/// @brief All the bytes, whatever the position. Writes may move them.
+		const byte* GetData() const;
+		/// @brief Move the owned bytes out, the stream is closed.
+		List<byte> TakeData();
+
+	protected:
+		ResultCode WriteBytesUnchecked(const byte* valuePtr, int32 length) override;
+		int32 ReadBytesUnchecked(byte* buffer, int32 length) override;
+
+	private:
+		List<byte> owned{};
+		const byte* borrowed = nullptr;
+		int32 length = 0;
+		int32 position = 0;
+		bool isOwned = true;
+		bool valid = true;
+	};
+}
@@ -0,0 +1,93 @@
+#include "Engine/System/Object/DeferredCallQueue.h"
+#include "Engine/System/Collection/SmallList.h"
+
+namespace Engine {
+	DeferredCallQueue& DeferredCallQueue::GetCurrent() {
+		static thread_local DeferredCallQueue queue;
+		return queue;
+	}
+
+	bool DeferredCallQueue::IsSameCall(const Call& call, const Variant** arguments, int32 argumentCount) const {
+		if (call.argumentCount != argumentCount) {
+			return false;
+		}
+		for (int32 i = 0; i < argumentCount; i += 1) {
+			if (!(this->arguments[call.argumentStart + i] == *(arguments[i]))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool DeferredCallQueue::Push(const Invokable& invokable, const Variant** arguments, int32 argumentCount) {
+		ERR_ASSERT(argumentCount >= 0, u8"argumentCount must not be negative.", return false);
+
+		int32 previous = -1;
+		int32* last = lastCalls.Find(invokable);
+		if (last != nullptr) {
+			previous = *last;
+			for (int32 index = previous; index >= 0; index = calls[index].previous) {
+				if (IsSameCall(calls[index], arguments, argumentCount)) {
+					return false;
+				}
+			}
+		}
+
+		Call call{ invokable, this->arguments.GetCount(), argumentCount, previous };
+		for (int32 i = 0; i < argumentCount; i += 1) {
+			this->arguments.Add(*(arguments[i]));
+		}
+		lastCalls.Set(invokable, calls.GetCount());
+		calls.Add(call);
+		return true;
+	}
+
+	int32 DeferredCallQueue::Flush() {
+		// A handler flushing again would run calls of the next batch early.
+		if (flushing || calls.GetCount() == 0) {
+			return 0;
+		}
+		flushing = true;
+
+		List<Call> swapCalls = Memory::Move(flushingCalls);
+		flushingCalls = Memory::Move(calls);
+		calls = Memory::Move(swapCalls);
+		List<Variant> swapArguments = Memory::Move(flushingArguments);
+		flushingArguments = Memory::Move(arguments);
+		arguments = Memory::Move(swapArguments);
+		lastCalls.Clear();
+
+		int32 count = 0;
+		SmallList<const Variant*, 8> pointers;
+		for (int32 i = 0; i < flushingCalls.GetCount(); i += 1) {
+			const Call& call = flushingCalls[i];
+			Object* target = Object::GetInstance(call.invokable.instanceId);
+			if (target == nullptr) {
+				continue;
+			}
+
+			pointers.Clear();
+			for (int32 a = 0; a < call.argumentCount; a += 1) {
+				pointers.Add(flushingArguments.GetRawElementPtr() + call.argumentStart + a);
+			}
+			Variant result;
+			target->InvokeMethod(call.invokable.methodName, pointers.GetRawElementPtr(), call.argumentCount, result);
+			count += 1;
+		}
+
+		flushingCalls.Clear();
+		flushingArguments.Clear();
+		flushing = false;
+		return count;
+	}
+
+	void DeferredCallQueue::Clear() {
+		calls.Clear();
+		arguments.Clear();
+		lastCalls.Clear();
+	}
+
+	int32 DeferredCallQueue::GetCount() const {
+		return calls.GetCount();
+	}
+}
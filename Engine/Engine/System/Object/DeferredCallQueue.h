@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Object/Object.h"
+#include "Engine/System/Object/Variant.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+
+namespace Engine {
+	/// @brief Method calls queued to run later at a defined point, such as signals connected with ReflectionSignal::ConnectFlag::Deferred.\n
+	/// Every thread has its own queue, NodeTree flushes the one of its thread once per update. Other threads flush theirs themselves.\n
+	/// Arguments are copied into a single List of Variants which keeps its storage between flushes, so queuing stops allocating once it has warmed up.\n
+	/// A call equal to one still waiting, the same method of the same object with equal arguments, is coalesced into that one.
+	class DeferredCallQueue final {
+	public:
+		DeferredCallQueue() = default;
+		DeferredCallQueue(const DeferredCallQueue&) = delete;
+		DeferredCallQueue& operator=(const DeferredCallQueue&) = delete;
+
+		/// @brief Get the queue of the current thread.
+		static DeferredCallQueue& GetCurrent();
+
+		/// @brief Queue a call, the arguments are copied.
+		/// @return false if it was coalesced into an equal call already waiting.
+		bool Push(const Invokable& invokable, const Variant** arguments, int32 argumentCount);
+		/// @brief Run the waiting calls in the order they were queued. Objects gone meanwhile are skipped.\n
+		/// Calls queued by the handlers wait for the next Flush(), so a cascade of deferred signals advances one step per flush.
+		/// @return The count of calls run.
+		int32 Flush();
+		/// @brief Drop the waiting calls without running them.
+		void Clear();
+
+		/// @brief Get the count of the waiting calls.
+		int32 GetCount() const;
+
+	private:
+		struct Call {
+			Invokable invokable;
+			int32 argumentStart;
+			int32 argumentCount;
+			/// @brief The call queued before it with the same invokable, -1 if none.
+			int32 previous;
+		};
+		bool IsSameCall(const Call& call, const Variant** arguments, int32 argumentCount) const;
+
+		List<Call> calls{};
+		List<Variant> arguments{};
+		/// @brief The last call of every invokable, heads of the chains walked for coalescing.
+		FlatDictionary<Invokable, int32> lastCalls{};
+
+		// Swapped with the waiting ones by Flush(), so both keep their storage.
+		List<Call> flushingCalls{};
+		List<Variant> flushingArguments{};
+		bool flushing = false;
+	};
+}
@@ -2,15 +2,11 @@
 #include "Engine/System/Object/ObjectUtil.h"
 
 namespace Engine {
-	AtomicValue<uint64> InstanceId::lastManual{};
-	AtomicValue<uint64> InstanceId::lastReferenced{};
-
-	InstanceId InstanceId::Generate(bool referenced) {
+	InstanceId InstanceId::Compose(uint32 index, uint32 generation, bool referenced) {
 		InstanceId r{};
-		if (!referenced) {
-			r.value = lastManual.Add(1);
-		} else {
-			r.value = lastReferenced.Add(1) | (uint64)1 << 63;
+		r.value = (uint64)index | (uint64)(generation & MaxGeneration) << 32;
+		if (referenced) {
+			r.value |= (uint64)1 << 63;
 		}
 		return r;
 	}
@@ -25,6 +21,12 @@ namespace Engine {
 	bool InstanceId::IsReferenced() const {
 		return value >> 63 == 1;
 	}
+	uint32 InstanceId::GetIndex() const {
+		return (uint32)value;
+	}
+	uint32 InstanceId::GetGeneration() const {
+		return (uint32)(value >> 32) & MaxGeneration;
+	}
 	bool InstanceId::operator==(const InstanceId& obj) const {
 		return value == obj.value;
 	}
@@ -1,17 +1,23 @@
 #pragma once
 
 #include "Engine/System/Definition.h"
-#include "Engine/System/Thread/Atomic.h"
 
 namespace Engine{
+	/// @brief Identifies an Object, see ObjectRegistry.\n
+	/// The highest bit tells if it's a ReferencedObject, the next 31 bits are the slot generation and the lowest 32 bits are the slot index.
 	struct InstanceId{
 	public:
-		static InstanceId Generate(bool referenced);
+		static inline constexpr uint32 MaxGeneration = 0x7FFFFFFF;
+
+		/// @param generation Starts from 1, so a valid id is never 0.
+		static InstanceId Compose(uint32 index, uint32 generation, bool referenced);
 
 		explicit InstanceId(uint64 id = 0);
 		uint64 Get() const;
 		bool IsValid() const;
 		bool IsReferenced() const;
+		uint32 GetIndex() const;
+		uint32 GetGeneration() const;
 		bool operator==(const InstanceId& obj) const;
 		bool operator!=(const InstanceId& obj) const;
 
@@ -20,8 +26,5 @@ namespace Engine{
 	private:
 		// The highest bit == 1 == ReferencedObject
 		uint64 value;
-
-		static AtomicValue<uint64> lastManual;
-		static AtomicValue<uint64> lastReferenced;
 	};
 }
@@ -1,11 +1,13 @@
 #include "Engine/System/Object/Object.h"
 #include "Engine/System/Object/ObjectUtil.h"
+#include "Engine/System/Object/ObjectRegistry.h"
+#include "Engine/System/Object/DeferredCallQueue.h"
 #include "Engine/System/String.h"
 
 namespace Engine {
-	Invokable::Invokable() :instanceId(InstanceId()), methodName(String::GetEmpty()) {}
-	Invokable::Invokable(const InstanceId& object, const String& methodName) :instanceId(object), methodName(methodName) {}
-	Invokable::Invokable(Object* object, const String& methodName) : instanceId(object == nullptr ? InstanceId() : object->GetInstanceId()), methodName(methodName) {}
+	Invokable::Invokable() :instanceId(InstanceId()) {}
+	Invokable::Invokable(const InstanceId& object, const StringName& methodName) :instanceId(object), methodName(methodName) {}
+	Invokable::Invokable(Object* object, const StringName& methodName) : instanceId(object == nullptr ? InstanceId() : object->GetInstanceId()), methodName(methodName) {}
 	int32 Invokable::GetHashCode() const {
 		return ObjectUtil::GetHashCode(instanceId) ^ ObjectUtil::GetHashCode(methodName);
 	}
@@ -14,11 +16,11 @@ namespace Engine {
 	}
 
 #pragma region Object
-	// Change this capacity value to a reasonable one.
-	Dictionary<InstanceId, Object*> Object::objectLookup{ 100 };
-
 	Object::~Object() {
-		objectLookup.Remove(instanceId);
+		// Pooled objects give their id up while waiting to be reused.
+		if (instanceId.IsValid()) {
+			ObjectRegistry::Unregister(instanceId);
+		}
 	}
 
 	String Object::ToString() const {
@@ -33,63 +35,71 @@ namespace Engine {
 	}
 
 	bool Object::IsInstanceValid(const InstanceId& id) {
-		return objectLookup.ContainsKey(id);
+		return ObjectRegistry::IsValid(id);
 	}
 	Object* Object::GetInstance(const InstanceId& id) {
-		Object* obj = nullptr;
-		objectLookup.TryGet(id, obj);
-		return obj;
+		return ObjectRegistry::Get(id);
 	}
 
-	bool Object::HasProperty(const String& name) const {
-		return Reflection::GetClass(GetReflectionClassName())->HasProperty(name);
+	bool Object::HasProperty(const StringName& name) const {
+		return GetReflectionClass()->HasProperty(name);
 	}
-	bool Object::CanPropertyGet(const String& name) const {
-		ReflectionProperty* prop = Reflection::GetClass(GetReflectionClassName())->GetProperty(name);
+	bool Object::CanPropertyGet(const StringName& name) const {
+		ReflectionProperty* prop = GetReflectionClass()->GetProperty(name);
 		if (prop == nullptr) {
 			return false;
 		}
 		return prop->CanGet();
 	}
-	bool Object::CanPropertySet(const String& name) const {
-		ReflectionProperty* prop = Reflection::GetClass(GetReflectionClassName())->GetProperty(name);
+	bool Object::CanPropertySet(const StringName& name) const {
+		ReflectionProperty* prop = GetReflectionClass()->GetProperty(name);
 		if (prop == nullptr) {
 			return false;
 		}
 		return prop->CanSet();
 	}
-	ResultCode Object::GetPropertyValue(const String& name, Variant& result) const {
-		ReflectionProperty* prop = Reflection::GetClass(GetReflectionClassName())->GetProperty(name);
+	ResultCode Object::GetPropertyValue(const StringName& name, Variant& result) const {
+		ReflectionProperty* prop = GetReflectionClass()->GetProperty(name);
 		ERR_ASSERT(prop != nullptr, String::Format(STRL("Property \"{0}\" not found!"), name).GetRawArray(), return ResultCode::NotFound);
 		return prop->Get(this, result);
 	}
-	ResultCode Object::SetPropertyValue(const String& name,const Variant& value) {
-		ReflectionProperty* prop = Reflection::GetClass(GetReflectionClassName())->GetProperty(name);
+	ResultCode Object::SetPropertyValue(const StringName& name,const Variant& value) {
+		ReflectionProperty* prop = GetReflectionClass()->GetProperty(name);
 		ERR_ASSERT(prop != nullptr, String::Format(STRL("Property \"{0}\" not found!"), name).GetRawArray(), return ResultCode::NotFound);
 		return prop->Set(this, value);
 	}
 
-	bool Object::HasMethod(const String& name) const {
-		return Reflection::GetClass(GetReflectionClassName())->HasMethod(name);
+	bool Object::HasMethod(const StringName& name) const {
+		return GetReflectionClass()->HasMethod(name);
 	}
-	ResultCode Object::InvokeMethod(const String& name, const Variant** arguments, int32 argumentCount, Variant& result) {
-		ReflectionMethod* method = Reflection::GetClass(GetReflectionClassName())->GetMethod(name);
+	ResultCode Object::InvokeMethod(const StringName& name, const Variant** arguments, int32 argumentCount, Variant& result) {
+		ReflectionMethod* method = GetReflectionClass()->GetMethod(name);
 		ERR_ASSERT(method != nullptr, String::Format(STRING_LITERAL("Method {0}::{1} not found!"), GetReflectionClassName(), name).GetRawArray(), return ResultCode::NotFound);
 		return method->Invoke(this, arguments, argumentCount, result);
 	}
 
-	bool Object::HasSignal(const String& name) const {
-		return Reflection::GetClass(GetReflectionClassName())->HasSignal(name);
+	bool Object::HasSignal(const StringName& name) const {
+		return GetReflectionClass()->HasSignal(name);
 	}
-	bool Object::IsSignalConnected(const String& signal, const Invokable& invokable) const {
-		SharedPtr<SignalConnectionGroup> group;
-		bool found = signalConnections.TryGet(signal, group);
-		if (!found) {
+	int32 Object::SignalConnectionGroup::IndexOf(const Invokable& invokable) const {
+		// Only called by the writing thread, which needs no pin.
+		const List<SignalConnection>& list = *(connections.Read());
+		for (int32 i = 0; i < list.GetCount(); i += 1) {
+			if (list[i].invokable == invokable) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	bool Object::IsSignalConnected(const StringName& signal, const Invokable& invokable) const {
+		SharedPtr<SignalConnectionGroup>* group = signalConnections.Find(signal);
+		if (group == nullptr) {
 			return false;
 		}
-		return group->connections.DoRead()->ContainsKey(invokable);
+		return (*group)->IndexOf(invokable) >= 0;
 	}
-	ResultCode Object::ConnectSignal(const String& signal, const Invokable& invokable, ReflectionSignal::ConnectFlag flag) {
+	ResultCode Object::ConnectSignal(const StringName& signal, const Invokable& invokable, ReflectionSignal::ConnectFlag flag) {
 		SharedPtr<SignalConnectionGroup> group;
 		bool found = signalConnections.TryGet(signal, group);
 		// Not found, try to add.
@@ -102,38 +112,53 @@ namespace Engine {
 			}
 		}
 
-		ERR_ASSERT(IsInstanceValid(invokable.instanceId), u8"Cannot connect to a non-existing object!", return ResultCode::InvalidObject);
+		Object* target = GetInstance(invokable.instanceId);
+		ERR_ASSERT(target != nullptr, u8"Cannot connect to a non-existing object!", return ResultCode::InvalidObject);
+		ERR_ASSERT(group->IndexOf(invokable) < 0, u8"The signal is already connected to the method.", return ResultCode::AlreadyExists);
+
+		// The class of an object never changes, so the method can be resolved once here.
+		MethodHandle method = target->GetReflectionClass()->ResolveMethod(invokable.methodName);
+		ERR_ASSERT(method.IsValid(), String::Format(STRING_LITERAL("Method {0}::{1} not found!"), target->GetReflectionClassName(), invokable.methodName).GetRawArray(), return ResultCode::NotFound);
 
-		group->connections.DoWrite()->Add(invokable, flag);
+		group->connections.Update([&invokable, &method, flag](List<SignalConnection>& connections) {
+			connections.Add(SignalConnection{ invokable, method, flag });
+		});
 
 		return ResultCode::OK;
 	}
-	bool Object::DisconnectSignal(const String& signal, const Invokable& invokable) {
-		SharedPtr<SignalConnectionGroup> group;
-		bool found = signalConnections.TryGet(signal, group);
-		if (!found) {
+	bool Object::DisconnectSignal(const StringName& signal, const Invokable& invokable) {
+		SharedPtr<SignalConnectionGroup>* group = signalConnections.Find(signal);
+		if (group == nullptr) {
 			return false;
 		}
 
-		return group->connections.DoWrite()->Remove(invokable);
+		int32 index = (*group)->IndexOf(invokable);
+		if (index < 0) {
+			return false;
+		}
+		(*group)->connections.Update([index](List<SignalConnection>& connections) {
+			connections.RemoveAt(index);
+		});
+		return true;
 	}
-	bool Object::EmitSignal(const String& signal,const Variant** arguments,int32 argumentCount) {
-		SharedPtr<SignalConnectionGroup> group;
-		bool found = signalConnections.TryGet(signal, group);
-		if (!found) {
+	bool Object::EmitSignal(const StringName& signal,const Variant** arguments,int32 argumentCount) {
+		SharedPtr<SignalConnectionGroup>* group = signalConnections.Find(signal);
+		if (group == nullptr) {
 			return false;
 		}
 
-		// Get the COW Dictionary.
-		// When other connection functions are operating the dictionary, COW will make a new copy.
-		SignalConnectionGroup::ConnectionsType cow = group->connections;
-		
-		// Iterate the dictionary.
-		for (const auto& entry : *(cow.DoRead())) {
-			const Invokable& invokable = entry.key;
-			ReflectionSignal::ConnectFlag flag = entry.value;
-			
+		// Pinned, the version read stays valid even if handlers connect, disconnect or destroy the object meanwhile.
+		// Nothing shared is written, unlike counting a reference to it. The pin holds back reclamation while the handlers run.
+		// The group pointer may be invalidated by the handlers, don't touch it after this.
+		EpochGuard guard{};
+		const List<SignalConnection>& connections = *((*group)->connections.Read());
+
+		for (int32 i = 0; i < connections.GetCount(); i += 1) {
+			const SignalConnection& connection = connections[i];
+			const Invokable& invokable = connection.invokable;
+			ReflectionSignal::ConnectFlag flag = connection.flag;
 
+			// A generation-checked slot lookup, no hashing.
 			Object* target = Object::GetInstance(invokable.instanceId);
 
 			// Disconnect the connection if the object doesn't exists anymore.
@@ -147,8 +172,17 @@ namespace Engine {
 				continue;
 			}
 
-			Variant temp;
-			target->InvokeMethod(invokable.methodName, arguments, argumentCount, temp);
+			if (((int32)flag & (int32)ReflectionSignal::ConnectFlag::Deferred) != 0) {
+				DeferredCallQueue::GetCurrent().Push(invokable, arguments, argumentCount);
+			} else {
+				Variant temp;
+				connection.method.Invoke(target, arguments, argumentCount, temp);
+			}
+
+			// Safe while iterating, the disconnection makes a new copy of the connections.
+			if (((int32)flag & (int32)ReflectionSignal::ConnectFlag::Once) != 0) {
+				DisconnectSignal(signal, invokable);
+			}
 		}
 
 		return true;
@@ -158,8 +192,7 @@ namespace Engine {
 
 #pragma region ManualObject
 	ManualObject::ManualObject() {
-		instanceId = InstanceId::Generate(false);
-		objectLookup.Add(instanceId, this);
+		instanceId = ObjectRegistry::Register(this, false);
 	}
 	ManualObject::~ManualObject() {}
 	bool ManualObject::IsReferenced() const {
@@ -169,8 +202,7 @@ namespace Engine {
 
 #pragma region ReferencedObject
 	ReferencedObject::ReferencedObject() {
-		instanceId = InstanceId::Generate(true);
-		objectLookup.Add(instanceId, this);
+		instanceId = ObjectRegistry::Register(this, true);
 	}
 	ReferencedObject::~ReferencedObject() {}
 	bool ReferencedObject::IsReferenced() const {
@@ -185,5 +217,8 @@ namespace Engine {
 	uint32 ReferencedObject::GetReferenceCount() const {
 		return referenceCount.Get();
 	}
+	bool ReferencedObject::TryReference() const {
+		return referenceCount.TryReference();
+	}
 #pragma endregion
 }
\ No newline at end of file
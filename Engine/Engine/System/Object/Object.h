@@ -2,20 +2,22 @@
 
 #include "Engine/System/Definition.h"
 #include "Engine/System/String.h"
+#include "Engine/System/StringName.h"
 #include "Engine/System/Thread/Atomic.h"
 #include "Engine/System/Object/InstanceId.h"
 #include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Collection/FlatDictionary.h"
 #include "Engine/System/Object/Reflection.h"
-#include "Engine/System/Memory/CopyOnWrite.h"
+#include "Engine/System/Memory/ReadMostly.h"
 
 namespace Engine{
 	struct Invokable final {
 		Invokable();
-		Invokable(const InstanceId& object, const String& methodName);
-		Invokable(Object* object, const String& methodName);
+		Invokable(const InstanceId& object, const StringName& methodName);
+		Invokable(Object* object, const StringName& methodName);
 
 		InstanceId instanceId;
-		String methodName;
+		StringName methodName;
 		int32 GetHashCode() const;
 		bool operator==(const Invokable& obj) const;
 	};
@@ -47,32 +49,41 @@ namespace Engine{
 		InstanceId GetInstanceId() const;
 
 #pragma region Reflection
-		bool HasProperty(const String& name) const;
-		bool CanPropertySet(const String& name) const;
-		bool CanPropertyGet(const String& name) const;
-		ResultCode GetPropertyValue(const String& name, Variant& result) const;
-		ResultCode SetPropertyValue(const String& name, const Variant& value);
-
-		bool HasMethod(const String& name) const;
-		ResultCode InvokeMethod(const String& name, const Variant** arguments, int32 argumentCount, Variant& result);
+		// Names passed as Strings are interned on every call, keep StringNames around on hot paths.
+		// The class comes from GetReflectionClass(), a static pointer per class, so the only lookup left is the member name.
+		bool HasProperty(const StringName& name) const;
+		bool CanPropertySet(const StringName& name) const;
+		bool CanPropertyGet(const StringName& name) const;
+		ResultCode GetPropertyValue(const StringName& name, Variant& result) const;
+		ResultCode SetPropertyValue(const StringName& name, const Variant& value);
+
+		bool HasMethod(const StringName& name) const;
+		ResultCode InvokeMethod(const StringName& name, const Variant** arguments, int32 argumentCount, Variant& result);
 		 
-		bool HasSignal(const String& name) const;
-		bool IsSignalConnected(const String& signal, const Invokable& invokable) const;
-		ResultCode ConnectSignal(const String& signal, const Invokable& invokable, ReflectionSignal::ConnectFlag flag=ReflectionSignal::ConnectFlag::Null);
-		bool DisconnectSignal(const String& signal, const Invokable& invokable);
-		bool EmitSignal(const String& signal,const Variant** arguments,int32 argumentCount);
+		bool HasSignal(const StringName& name) const;
+		bool IsSignalConnected(const StringName& signal, const Invokable& invokable) const;
+		ResultCode ConnectSignal(const StringName& signal, const Invokable& invokable, ReflectionSignal::ConnectFlag flag=ReflectionSignal::ConnectFlag::Null);
+		bool DisconnectSignal(const StringName& signal, const Invokable& invokable);
+		bool EmitSignal(const StringName& signal,const Variant** arguments,int32 argumentCount);
 #pragma endregion
 
 	protected:
-		static Dictionary<InstanceId, Object*> objectLookup;
 		InstanceId instanceId;
 
 	private:
+		/// @brief A connection resolved on ConnectSignal(), so emitting doesn't look the method up by name.
+		struct SignalConnection {
+			Invokable invokable;
+			MethodHandle method;
+			ReflectionSignal::ConnectFlag flag;
+		};
 		struct SignalConnectionGroup {
-			using ConnectionsType = CopyOnWrite<Dictionary<Invokable, ReflectionSignal::ConnectFlag>>;
-			ConnectionsType connections = ConnectionsType::Create();
+			/// @brief In the order of connecting. Emitting iterates the version it pinned, connecting and disconnecting meanwhile publish a new one.
+			ReadMostly<List<SignalConnection>> connections{};
+
+			int32 IndexOf(const Invokable& invokable) const;
 		};
-		Dictionary<String, SharedPtr<SignalConnectionGroup>> signalConnections;
+		FlatDictionary<StringName, SharedPtr<SignalConnectionGroup>> signalConnections;
 	};
 
 	// Represents a Object which its memory management is done by the user.
@@ -101,6 +112,8 @@ namespace Engine{
 		uint32 Reference() const;
 		uint32 Dereference() const;
 		uint32 GetReferenceCount() const;
+		/// @brief Reference only if the count didn't drop to 0 yet, see ReferenceCount::TryReference().
+		bool TryReference() const;
 	private:
 		mutable ReferenceCount referenceCount;
 	};
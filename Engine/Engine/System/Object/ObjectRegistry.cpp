@@ -0,0 +1,235 @@
+#include "Engine/System/Object/ObjectRegistry.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Debug.h"
+
+namespace Engine {
+	/// @brief Free slots owned by a thread, and the objects it registered minus those it unregistered.
+	struct ObjectRegistry::ThreadCache {
+		static inline constexpr int32 Capacity = BlockSize * 2;
+
+		ThreadCache();
+		~ThreadCache();
+
+		/// @brief Used as a stack, the slot freed last is reused first while still in cache.
+		int32 free[Capacity];
+		int32 freeCount = 0;
+		/// @brief Only written by the owning thread, read by GetCount().
+		std::atomic<int32> live{ 0 };
+		// Guarded by the mutex.
+		ThreadCache* previous = nullptr;
+		ThreadCache* next = nullptr;
+	};
+
+	// All constant-initialized, objects may be registered during static initialization.
+	std::atomic<ObjectRegistry::Slot*> ObjectRegistry::chunks[MaxChunkCount]{};
+	std::mutex ObjectRegistry::mutex{};
+	int32 ObjectRegistry::slotCount = 0;
+	int32 ObjectRegistry::freeIndex = -1;
+	ObjectRegistry::ThreadCache* ObjectRegistry::caches = nullptr;
+	std::atomic<int32> ObjectRegistry::count{ 0 };
+
+	namespace {
+		// Trivially destructible, still readable by objects destroyed after the cache of the thread.
+		thread_local bool threadCacheGone = false;
+	}
+
+	ObjectRegistry::ThreadCache::ThreadCache() {
+		std::lock_guard<std::mutex> lock(mutex);
+		next = caches;
+		if (next != nullptr) {
+			next->previous = this;
+		}
+		caches = this;
+	}
+	ObjectRegistry::ThreadCache::~ThreadCache() {
+		std::lock_guard<std::mutex> lock(mutex);
+		GiveBack(*this, freeCount);
+		count.fetch_add(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		if (previous != nullptr) {
+			previous->next = next;
+		} else {
+			caches = next;
+		}
+		if (next != nullptr) {
+			next->previous = previous;
+		}
+		threadCacheGone = true;
+	}
+
+	ObjectRegistry::Slot* ObjectRegistry::GetSlot(uint32 index) {
+		uint32 chunk = index / ChunkSize;
+		if (chunk >= (uint32)MaxChunkCount) {
+			return nullptr;
+		}
+		Slot* slots = chunks[chunk].load(std::memory_order_acquire);
+		if (slots == nullptr) {
+			return nullptr;
+		}
+		return slots + index % ChunkSize;
+	}
+	ObjectRegistry::ThreadCache* ObjectRegistry::GetThreadCache() {
+		if (threadCacheGone) {
+			return nullptr;
+		}
+		thread_local ThreadCache cache{};
+		return &cache;
+	}
+
+	InstanceId ObjectRegistry::Register(Object* object, bool referenced) {
+		ThreadCache* cache = GetThreadCache();
+		if (cache == nullptr) {
+			int32 index = -1;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				index = AllocateUnlocked();
+			}
+			count.fetch_add(1, std::memory_order_relaxed);
+			return Publish(index, object, referenced);
+		}
+
+		if (cache->freeCount == 0) {
+			std::lock_guard<std::mutex> lock(mutex);
+			Refill(*cache);
+		}
+		cache->freeCount -= 1;
+		InstanceId id = Publish(cache->free[cache->freeCount], object, referenced);
+		// Only this thread writes it, no need for an atomic add.
+		cache->live.store(cache->live.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		return id;
+	}
+	void ObjectRegistry::Unregister(const InstanceId& id) {
+		bool released = Release(id);
+		ERR_ASSERT(released, u8"The id is not registered.", return);
+
+		ThreadCache* cache = GetThreadCache();
+		if (cache == nullptr) {
+			count.fetch_sub(1, std::memory_order_relaxed);
+			if (IsReusable(id)) {
+				std::lock_guard<std::mutex> lock(mutex);
+				FreeUnlocked(id.GetIndex());
+			}
+			return;
+		}
+
+		cache->live.store(cache->live.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+		if (!IsReusable(id)) {
+			return;
+		}
+		if (cache->freeCount == ThreadCache::Capacity) {
+			std::lock_guard<std::mutex> lock(mutex);
+			GiveBack(*cache, BlockSize);
+		}
+		cache->free[cache->freeCount] = id.GetIndex();
+		cache->freeCount += 1;
+	}
+	void ObjectRegistry::RegisterMany(Object* const* objects, int32 count, bool referenced, InstanceId* ids) {
+		for (int32 i = 0; i < count; i += 1) {
+			ids[i] = Register(objects[i], referenced);
+		}
+	}
+	void ObjectRegistry::UnregisterMany(const InstanceId* ids, int32 count) {
+		for (int32 i = 0; i < count; i += 1) {
+			Unregister(ids[i]);
+		}
+	}
+
+	InstanceId ObjectRegistry::Publish(int32 index, Object* object, bool referenced) {
+		Slot* slot = GetSlot(index);
+		// The thread owns the free slot, whoever released it last is synchronized by the mutex or by Release().
+		slot->generation += 1;
+		InstanceId id = InstanceId::Compose(index, slot->generation, referenced);
+
+		// The object goes first, a lookup seeing the new id must see the new object.
+		slot->object.store(object, std::memory_order_release);
+		slot->id.store(id.Get(), std::memory_order_release);
+		return id;
+	}
+	bool ObjectRegistry::Release(const InstanceId& id) {
+		Slot* slot = GetSlot(id.GetIndex());
+		if (slot == nullptr || !id.IsValid()) {
+			return false;
+		}
+		// Acquire pairs with Publish(), the generation written there is seen by whoever reuses the slot next.
+		uint64 expected = id.Get();
+		if (!slot->id.compare_exchange_strong(expected, 0, std::memory_order_acquire, std::memory_order_relaxed)) {
+			return false;
+		}
+		// The id goes first, a lookup seeing the cleared object must see the cleared id.
+		slot->object.store(nullptr, std::memory_order_release);
+		return true;
+	}
+	bool ObjectRegistry::IsReusable(const InstanceId& id) {
+		// Retire the slot for good once the generation runs out, so ids are never reused.
+		return id.GetGeneration() < InstanceId::MaxGeneration;
+	}
+
+	int32 ObjectRegistry::AllocateUnlocked() {
+		if (freeIndex >= 0) {
+			int32 index = freeIndex;
+			freeIndex = GetSlot(index)->nextFree;
+			return index;
+		}
+		FATAL_ASSERT(slotCount < ChunkSize * MaxChunkCount, u8"Too many objects alive!");
+		int32 index = slotCount;
+		int32 chunk = index / ChunkSize;
+		if (chunks[chunk].load(std::memory_order_relaxed) == nullptr) {
+			// Never freed, lookups may touch any chunk at any time.
+			chunks[chunk].store(MEMNEWARR(Slot, ChunkSize), std::memory_order_release);
+		}
+		slotCount += 1;
+		return index;
+	}
+	void ObjectRegistry::FreeUnlocked(int32 index) {
+		Slot* slot = GetSlot(index);
+		slot->nextFree = freeIndex;
+		freeIndex = index;
+	}
+	void ObjectRegistry::Refill(ThreadCache& cache) {
+		// Reversed so the slots come out of the cache in the order they were allocated.
+		int32 taken[BlockSize];
+		for (int32 i = 0; i < BlockSize; i += 1) {
+			taken[i] = AllocateUnlocked();
+		}
+		for (int32 i = BlockSize - 1; i >= 0; i -= 1) {
+			cache.free[cache.freeCount] = taken[i];
+			cache.freeCount += 1;
+		}
+	}
+	void ObjectRegistry::GiveBack(ThreadCache& cache, int32 count) {
+		for (int32 i = 0; i < count; i += 1) {
+			FreeUnlocked(cache.free[i]);
+		}
+		for (int32 i = count; i < cache.freeCount; i += 1) {
+			cache.free[i - count] = cache.free[i];
+		}
+		cache.freeCount -= count;
+	}
+
+	Object* ObjectRegistry::Get(const InstanceId& id) {
+		if (!id.IsValid()) {
+			return nullptr;
+		}
+		Slot* slot = GetSlot(id.GetIndex());
+		if (slot == nullptr || slot->id.load(std::memory_order_acquire) != id.Get()) {
+			return nullptr;
+		}
+		Object* object = slot->object.load(std::memory_order_acquire);
+		// Check again in case the slot got reused in between.
+		if (slot->id.load(std::memory_order_acquire) != id.Get()) {
+			return nullptr;
+		}
+		return object;
+	}
+	bool ObjectRegistry::IsValid(const InstanceId& id) {
+		return Get(id) != nullptr;
+	}
+
+	int32 ObjectRegistry::GetCount() {
+		std::lock_guard<std::mutex> lock(mutex);
+		int32 result = count.load(std::memory_order_relaxed);
+		for (const ThreadCache* cache = caches; cache != nullptr; cache = cache->next) {
+			result += cache->live.load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+}
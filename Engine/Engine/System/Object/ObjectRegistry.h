@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Object/InstanceId.h"
+#include <atomic>
+#include <mutex>
+
+namespace Engine {
+	class Object;
+
+	/// @brief Thread-safe generational slot map from InstanceIds to live Objects.\n
+	/// An InstanceId holds a slot index and the generation of the slot, see InstanceId::Compose().
+	/// Lookups are a lock-free array access. Each thread hands out free slots from a cache of its own,
+	/// reserved from the shared free list BlockSize at a time, so registering and unregistering only lock once per block.\n
+	/// Slots live in fixed chunks which are never moved or freed, so lookups can race with registration safely.
+	class ObjectRegistry final {
+	public:
+		STATIC_CLASS(ObjectRegistry);
+
+		static inline constexpr int32 ChunkSize = 4096;
+		static inline constexpr int32 MaxChunkCount = 4096;
+		/// @brief Count of free slots a thread reserves or gives back at once.
+		static inline constexpr int32 BlockSize = 256;
+
+		/// @brief Give the object a slot and an id.
+		static InstanceId Register(Object* object, bool referenced);
+		/// @brief Release the slot of the id. Ids of the released slot are never valid again.
+		static void Unregister(const InstanceId& id);
+		/// @brief Register several objects at once, as pools do.
+		/// @param ids Receives the id of every object.
+		static void RegisterMany(Object* const* objects, int32 count, bool referenced, InstanceId* ids);
+		static void UnregisterMany(const InstanceId* ids, int32 count);
+
+		/// @brief Get the object registered with the id, nullptr if it's gone.\n
+		/// Nothing keeps the object alive, the caller must make sure it isn't destroyed at the same time.
+		static Object* Get(const InstanceId& id);
+		static bool IsValid(const InstanceId& id);
+
+		/// @brief Get the count of live objects.
+		static int32 GetCount();
+
+	private:
+		struct Slot {
+			// The id currently living in the slot, 0 when free.
+			std::atomic<uint64> id{ 0 };
+			std::atomic<Object*> object{ nullptr };
+			// Only touched by the thread owning the free slot, or under the mutex.
+			uint32 generation = 0;
+			// Guarded by the mutex.
+			int32 nextFree = -1;
+		};
+		struct ThreadCache;
+
+		static Slot* GetSlot(uint32 index);
+		/// @brief The cache of the current thread, nullptr once the thread is exiting.
+		static ThreadCache* GetThreadCache();
+		/// @brief Give the object the free slot at index, owned by the current thread.
+		static InstanceId Publish(int32 index, Object* object, bool referenced);
+		/// @brief Clear the slot of the id, false if it isn't registered.
+		static bool Release(const InstanceId& id);
+		static bool IsReusable(const InstanceId& id);
+		// The lock needs to be held.
+		static int32 AllocateUnlocked();
+		static void FreeUnlocked(int32 index);
+		static void Refill(ThreadCache& cache);
+		/// @brief Move the count of slots longest in the cache back to the shared free list.
+		static void GiveBack(ThreadCache& cache, int32 count);
+
+		static std::atomic<Slot*> chunks[MaxChunkCount];
+		static std::mutex mutex;
+		static int32 slotCount;
+		static int32 freeIndex;
+		// Guarded by the mutex.
+		static ThreadCache* caches;
+		/// @brief Objects registered minus unregistered without a thread cache, or by threads now gone.
+		static std::atomic<int32> count;
+	};
+}
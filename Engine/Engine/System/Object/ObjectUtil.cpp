@@ -1,39 +1,48 @@
 #include "Engine/System/Object/ObjectUtil.h"
 
 namespace Engine {
+	namespace {
+		// Numbers are short enough to stay small Strings, no heap allocation.
+		template<typename T>
+		String NumberToString(T value) {
+			u8char buffer[ObjectUtil::MaxNumberChars];
+			return String(buffer, ObjectUtil::ToChars(value, buffer, ObjectUtil::MaxNumberChars));
+		}
+	}
+
 #pragma region ToStrings
 	String ObjectUtil::ToString(bool obj) {
 		return (obj ? u8"True" : u8"False");
 	}
 	String ObjectUtil::ToString(byte obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(sbyte obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(int16 obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(uint16 obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(int32 obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(uint32 obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(int64 obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(uint64 obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(float obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 	String ObjectUtil::ToString(double obj) {
-		return std::to_string(obj);
+		return NumberToString(obj);
 	}
 #pragma endregion
 
@@ -86,5 +95,8 @@ namespace Engine {
 		sizeint v = *((sizeint*)(&obj));
 		return GetHashCode(v);
 	}
+	int32 ObjectUtil::GetHashCode(std::string_view obj) {
+		return GetHashCode(std::hash<std::string_view>{}(obj));
+	}
 #pragma endregion
 }
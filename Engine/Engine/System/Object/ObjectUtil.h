@@ -2,6 +2,9 @@
 #include "Engine/System/Definition.h"
 #include "Engine/System/String.h"
 #include "Engine/System/Concept.h"
+#include <string_view>
+#include <charconv>
+#include <type_traits>
 
 namespace Engine{
 	class ObjectUtil final {
@@ -26,8 +29,35 @@ namespace Engine{
 		static String ToString(double obj);
 #pragma endregion
 
+#pragma region Chars
+		/// @brief Enough chars for any number written by ToChars().
+		static inline constexpr int32 MaxNumberChars = 32;
+
+		/// @brief Write a number into the buffer without allocating, no NULL appended.\n
+		/// Floating point numbers are written in the shortest form that reads back to the same value.
+		/// @return The count of chars written, -1 if the buffer is too small.
+		template<typename T> requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+		static int32 ToChars(T value, u8char* buffer, int32 capacity) {
+			std::to_chars_result result = std::to_chars((char*)buffer, (char*)buffer + capacity, value);
+			return (result.ec == std::errc() ? (int32)(result.ptr - (char*)buffer) : -1);
+		}
+		/// @brief Read a number written like ToChars() does. The whole string must be the number.
+		/// @return false if the string isn't a number or it's out of the range of T. result is untouched then.
+		template<typename T> requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+		static bool FromChars(std::string_view string, T& result) {
+			const char* end = string.data() + string.size();
+			T value;
+			std::from_chars_result parsed = std::from_chars(string.data(), end, value);
+			if (parsed.ec != std::errc() || parsed.ptr != end) {
+				return false;
+			}
+			result = value;
+			return true;
+		}
+#pragma endregion
+
 #pragma region GetHashCodes
-		template<typename T>
+		template<typename T> requires (!Concept::IsEnum<T>)
 		static int32 GetHashCode(const T& obj) {
 			return obj.GetHashCode();
 		}
@@ -47,6 +77,8 @@ namespace Engine{
 		static int32 GetHashCode(float obj);
 		static int32 GetHashCode(double obj);
 		static int32 GetHashCode(const void* obj);
+		/// @brief The same as the hash code of a String with the same content.
+		static int32 GetHashCode(std::string_view obj);
 #pragma endregion
 	};
 }
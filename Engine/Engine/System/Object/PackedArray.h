@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Memory/CopyOnWrite.h"
+#include "Engine/System/Math/Vector.h"
+#include "Engine/System/Debug.h"
+#include <initializer_list>
+
+namespace Engine {
+	/// @brief A contiguous array of plain values, for passing bulk data through Variants and reflection calls at once.\n
+	/// Copies share the storage until one of them is modified, then that one copies the elements first.\n
+	/// Native callers read the elements in place through GetData(), without copying.
+	/// @tparam T The element type. Needs to be default-constructable and copy-constructable.
+	template<typename T>
+	class PackedArray final {
+	public:
+		PackedArray() = default;
+		/// @brief Copy count elements from data.
+		PackedArray(const T* data, int32 count) {
+			ERR_ASSERT(count >= 0, u8"count must not be negative.", return);
+			if (count == 0) {
+				return;
+			}
+			List<T>* list = Write();
+			list->RequireCapacity(count);
+			for (int32 i = 0; i < count; i += 1) {
+				list->Add(data[i]);
+			}
+		}
+		PackedArray(std::initializer_list<T> values) :PackedArray(values.begin(), (int32)values.size()) {}
+
+		int32 GetCount() const {
+			const List<T>* list = storage.DoRead();
+			return list == nullptr ? 0 : list->GetCount();
+		}
+		bool IsEmpty() const {
+			return GetCount() == 0;
+		}
+		/// @brief If the storage isn't shared with any other copy, so writing won't copy the elements.
+		bool IsExclusive() const {
+			return storage.IsExclusive();
+		}
+
+		const T& Get(int32 index) const {
+			FATAL_ASSERT(index >= 0 && index < GetCount(), u8"index out of bounds.");
+			return GetData()[index];
+		}
+		void Set(int32 index, const T& value) {
+			ERR_ASSERT(index >= 0 && index < GetCount(), u8"index out of bounds.", return);
+			Write()->Set(index, value);
+		}
+		void Add(const T& value) {
+			Write()->Add(value);
+		}
+		void RemoveAt(int32 index) {
+			ERR_ASSERT(index >= 0 && index < GetCount(), u8"index out of bounds.", return);
+			Write()->RemoveAt(index);
+		}
+		/// @brief Change the element count, new elements are default-constructed.
+		void Resize(int32 count) {
+			ERR_ASSERT(count >= 0, u8"count must not be negative.", return);
+			if (count == GetCount()) {
+				return;
+			}
+			Write()->SetCount(count);
+		}
+		/// @brief Drop the elements. The storage is only kept if it isn't shared.
+		void Clear() {
+			if (!IsExclusive()) {
+				storage = CopyOnWrite<List<T>>();
+				return;
+			}
+			List<T>* list = Write();
+			list->Clear();
+		}
+
+		/// @brief The elements in place, nullptr if nothing was ever stored. Valid until this array is modified.
+		const T* GetData() const {
+			const List<T>* list = storage.DoRead();
+			return list == nullptr ? nullptr : list->GetRawElementPtr();
+		}
+		/// @brief The elements for writing in place, copied first if the storage is shared. Valid until the count changes.
+		T* GetDataForWrite() {
+			if (IsEmpty()) {
+				return nullptr;
+			}
+			return Write()->GetRawElementPtr();
+		}
+
+		bool operator==(const PackedArray& obj) const {
+			int32 count = GetCount();
+			if (count != obj.GetCount()) {
+				return false;
+			}
+			const T* a = GetData();
+			const T* b = obj.GetData();
+			if (a == b) {
+				return true;
+			}
+			for (int32 i = 0; i < count; i += 1) {
+				if (!(a[i] == b[i])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		bool operator!=(const PackedArray& obj) const {
+			return !(*this == obj);
+		}
+
+		const T* begin() const {
+			return GetData();
+		}
+		const T* end() const {
+			return GetData() + GetCount();
+		}
+
+	private:
+		List<T>* Write() {
+			if (storage.DoRead() == nullptr) {
+				storage = CopyOnWrite<List<T>>::Create();
+			}
+			return storage.DoWrite();
+		}
+
+		CopyOnWrite<List<T>> storage;
+	};
+
+	using PackedByteArray = PackedArray<byte>;
+	using PackedInt64Array = PackedArray<int64>;
+	using PackedFloat32Array = PackedArray<float>;
+	using PackedVector2Array = PackedArray<Vector2>;
+}
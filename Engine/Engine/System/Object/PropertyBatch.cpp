@@ -0,0 +1,102 @@
+#include "Engine/System/Object/PropertyBatch.h"
+#include "Engine/System/Object/Object.h"
+#include "Engine/System/Object/Variant.h"
+
+namespace Engine {
+	PropertyBatch::PropertyBatch(const ReflectionClass* reflectionClass, const StringName* names, int32 count) :reflectionClass(reflectionClass), properties(count) {
+		ERR_ASSERT(reflectionClass != nullptr, u8"reflectionClass cannot be nullptr.", return);
+		for (int32 i = 0; i < count; i += 1) {
+			ReflectionProperty* property = reflectionClass->GetProperty(names[i]);
+			if (property == nullptr) {
+				ERR_MSG(String::Format(STRING_LITERAL("Property {0}::{1} not found!"), reflectionClass->GetName(), names[i]).GetRawArray());
+				continue;
+			}
+			properties.Add(property);
+		}
+	}
+	PropertyBatch::PropertyBatch(const ReflectionClass* reflectionClass, std::initializer_list<StringName> names) :PropertyBatch(reflectionClass, names.begin(), (int32)names.size()) {}
+
+	const ReflectionClass* PropertyBatch::GetClass() const {
+		return reflectionClass;
+	}
+	int32 PropertyBatch::GetCount() const {
+		return properties.GetCount();
+	}
+	ReflectionProperty* PropertyBatch::GetProperty(int32 index) const {
+		return properties.Get(index);
+	}
+
+	bool PropertyBatch::IsOfClass(const Object* obj) const {
+		if (obj == nullptr || reflectionClass == nullptr) {
+			return false;
+		}
+		const ReflectionClass* target = obj->GetReflectionClass();
+		return target == reflectionClass || target->IsChildOf(reflectionClass);
+	}
+
+	ResultCode PropertyBatch::GetValues(const Object* const* objects, int32 objectCount, Variant* values) const {
+		int32 count = properties.GetCount();
+		ReflectionProperty* const* props = properties.GetRawElementPtr();
+		for (int32 o = 0; o < objectCount; o += 1) {
+			const Object* obj = objects[o];
+			ERR_ASSERT(IsOfClass(obj), u8"The object is not of the class of the batch.", return ResultCode::InvalidObject);
+
+			Variant* target = values + o * count;
+			for (int32 p = 0; p < count; p += 1) {
+				if (props[p]->CanGet()) {
+					props[p]->Get(obj, target[p]);
+				} else {
+					target[p].Clear();
+				}
+			}
+		}
+		return ResultCode::OK;
+	}
+	ResultCode PropertyBatch::GetValues(const Object* const* objects, int32 objectCount, List<Variant>& values) const {
+		int32 total = objectCount * properties.GetCount();
+		values.Clear();
+		values.RequireCapacity(total);
+		for (int32 i = 0; i < total; i += 1) {
+			values.Add(Variant());
+		}
+		return GetValues(objects, objectCount, values.GetRawElementPtr());
+	}
+	ResultCode PropertyBatch::SetValues(Object* const* objects, int32 objectCount, const Variant* values) const {
+		int32 count = properties.GetCount();
+		ReflectionProperty* const* props = properties.GetRawElementPtr();
+		for (int32 o = 0; o < objectCount; o += 1) {
+			Object* obj = objects[o];
+			ERR_ASSERT(IsOfClass(obj), u8"The object is not of the class of the batch.", return ResultCode::InvalidObject);
+
+			const Variant* source = values + o * count;
+			for (int32 p = 0; p < count; p += 1) {
+				if (props[p]->CanSet()) {
+					props[p]->Set(obj, source[p]);
+				}
+			}
+		}
+		return ResultCode::OK;
+	}
+	ResultCode PropertyBatch::Copy(const Object* const* sources, Object* const* targets, int32 count) const {
+		int32 propertyCount = properties.GetCount();
+		ReflectionProperty* const* props = properties.GetRawElementPtr();
+		Variant temp;
+		for (int32 i = 0; i < count; i += 1) {
+			const Object* source = sources[i];
+			Object* target = targets[i];
+			ERR_ASSERT(IsOfClass(source) && IsOfClass(target), u8"The object is not of the class of the batch.", return ResultCode::InvalidObject);
+
+			for (int32 p = 0; p < propertyCount; p += 1) {
+				ReflectionProperty* property = props[p];
+				ReflectionFieldBind* field = property->GetField();
+				if (field != nullptr) {
+					field->Copy(source, target);
+				} else if (property->CanGet() && property->CanSet()) {
+					property->Get(source, temp);
+					property->Set(target, temp);
+				}
+			}
+		}
+		return ResultCode::OK;
+	}
+}
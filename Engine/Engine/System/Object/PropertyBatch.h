@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/StringName.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Object/Reflection.h"
+#include <initializer_list>
+
+namespace Engine {
+	class Object;
+	class Variant;
+
+	/// @brief Properties of a class looked up once, for reading, writing and copying them on many objects in one call,
+	/// such as saving a scene or animating a group of nodes.\n
+	/// Values are laid out object by object, GetCount() values per object in the order of the properties.\n
+	/// Objects must be of the class or its children. The properties are the ones the class sees, ones a child class redeclares are not used.\n
+	/// Properties declared with REFLECTION_FIELD() access the member directly, Copy() doesn't even make a Variant for them.
+	class PropertyBatch final {
+	public:
+		PropertyBatch() = default;
+		/// @brief Resolve the properties by name. Names the class doesn't have are reported and left out.
+		PropertyBatch(const ReflectionClass* reflectionClass, const StringName* names, int32 count);
+		PropertyBatch(const ReflectionClass* reflectionClass, std::initializer_list<StringName> names);
+
+		const ReflectionClass* GetClass() const;
+		int32 GetCount() const;
+		ReflectionProperty* GetProperty(int32 index) const;
+
+		/// @brief Read the properties of every object. Properties without a way to get them read as Null.
+		/// @param values Room for objectCount * GetCount() values.
+		/// @return InvalidObject at the first object not of the class, the values before it are read already.
+		ResultCode GetValues(const Object* const* objects, int32 objectCount, Variant* values) const;
+		/// @brief Read the properties of every object into values, replacing its content.
+		ResultCode GetValues(const Object* const* objects, int32 objectCount, List<Variant>& values) const;
+		/// @brief Write the properties of every object. Properties without a way to set them are skipped.
+		/// @param values objectCount * GetCount() values as GetValues() lays them out.
+		/// @return InvalidObject at the first object not of the class, the objects before it are written already.
+		ResultCode SetValues(Object* const* objects, int32 objectCount, const Variant* values) const;
+		/// @brief Copy the properties from every source to the target of the same index.
+		/// @return InvalidObject at the first pair with an object not of the class, the pairs before it are copied already.
+		ResultCode Copy(const Object* const* sources, Object* const* targets, int32 count) const;
+
+	private:
+		bool IsOfClass(const Object* obj) const;
+
+		const ReflectionClass* reflectionClass = nullptr;
+		List<ReflectionProperty*> properties;
+	};
+}
@@ -1,48 +1,123 @@
 #include "Engine/System/Object/Reflection.h"
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/Thread/ThreadUtil.h"
 
 namespace Engine{
 #pragma region Reflection
 	Reflection::ClassData& Reflection::GetData() {
-		static ClassData classes{ 30 };
-		return classes;
+		static ClassData data{};
+		return data;
 	}
 	bool Reflection::IsClassExists(const String& name) {
-		return GetData().ContainsKey(name);
+		ClassData& data = GetData();
+		SharedLock<ReadWriteLock> lock(data.lock);
+		return data.classes.ContainsKey(name);
 	}
 	ReflectionClass* Reflection::AddClass(const String& name, const String& parent) {
-		SharedPtr<ReflectionClass> data = SharedPtr<ReflectionClass>::Create();
+		ClassData& data = GetData();
+		SimpleLock<ReadWriteLock> lock(data.lock);
+		ReflectionClass* parentClass = nullptr;
+		if (parent.GetCount() > 0) {
+			SharedPtr<ReflectionClass>* found = data.classes.Find(parent);
+			parentClass = found == nullptr ? nullptr : found->GetRaw();
+			ERR_ASSERT(parentClass != nullptr, String::Format(STRING_LITERAL("Cannot register class {0}, its parent {1} isn't registered!"), name, parent).GetRawArray(), return nullptr);
+		}
 
-		data->name = name;
-		data->parentName = parent;
+		SharedPtr<ReflectionClass> c = SharedPtr<ReflectionClass>::Create();
+		c->name = name;
+		c->parentName = parent;
+		c->parent = parentClass;
+		c->id = data.classIds.GetCount();
 
-		return (GetData().Add(name, data) ? data.GetRaw() : nullptr);
+		if (!data.classes.Add(name, c)) {
+			return nullptr;
+		}
+		data.classIds.Add(c.GetRaw());
+		return c.GetRaw();
 	}
 	ReflectionClass* Reflection::GetClass(const String& name) {
-		SharedPtr<ReflectionClass> result;
-		GetData().TryGet(name, result);
-		return result.GetRaw();
+		ClassData& data = GetData();
+		SharedLock<ReadWriteLock> lock(data.lock);
+		SharedPtr<ReflectionClass>* result = data.classes.Find(name);
+		return result == nullptr ? nullptr : result->GetRaw();
+	}
+	ReflectionClass* Reflection::GetClass(int32 id) {
+		ClassData& data = GetData();
+		SharedLock<ReadWriteLock> lock(data.lock);
+		ERR_ASSERT(id >= 0 && id < data.classIds.GetCount(), u8"id out of bounds.", return nullptr);
+		return data.classIds[id];
+	}
+	Object* Reflection::Instantiate(int32 classId) {
+		ReflectionClass* c = GetClass(classId);
+		return c == nullptr ? nullptr : c->Instantiate();
+	}
+	int32 Reflection::InstantiateMany(int32 classId, int32 count, Object** results) {
+		ReflectionClass* c = GetClass(classId);
+		return c == nullptr ? 0 : c->InstantiateMany(count, results);
+	}
+	int32 Reflection::GetClassCount() {
+		ClassData& data = GetData();
+		SharedLock<ReadWriteLock> lock(data.lock);
+		return data.classIds.GetCount();
 	}
 #pragma endregion
 
 #pragma region ReflectionClass
+	namespace {
+		/// @brief Merge the own members with the inherited ones, both sorted by name, the own ones win.
+		template<typename T>
+		void FlattenMembers(const FlatMap<StringName, SharedPtr<T>>& own, const FlatMap<StringName, T*>* inherited, FlatMap<StringName, T*>& result) {
+			int32 ownCount = own.GetCount();
+			int32 inheritedCount = (inherited == nullptr ? 0 : inherited->GetCount());
+			result = FlatMap<StringName, T*>(ownCount + inheritedCount);
+
+			// Adding in order always appends, nothing is shifted.
+			int32 i = 0;
+			int32 j = 0;
+			while (i < ownCount || j < inheritedCount) {
+				if (j >= inheritedCount || (i < ownCount && !(inherited->GetKey(j) < own.GetKey(i)))) {
+					if (j < inheritedCount && inherited->GetKey(j) == own.GetKey(i)) {
+						// Overridden.
+						j += 1;
+					}
+					result.Add(own.GetKey(i), own.GetValue(i).GetRaw());
+					i += 1;
+				} else {
+					result.Add(inherited->GetKey(j), inherited->GetValue(j));
+					j += 1;
+				}
+			}
+			result.Freeze();
+		}
+
+		template<typename T>
+		T* FindMember(const FlatMap<StringName, T*>& table, const StringName& name) {
+			T** result = table.Find(name);
+			return result == nullptr ? nullptr : *result;
+		}
+	}
+
 	String ReflectionClass::GetName() const {
 		return name;
 	}
 	String ReflectionClass::GetParentName() const {
 		return parentName;
 	}
+	int32 ReflectionClass::GetId() const {
+		return id;
+	}
+	ReflectionClass* ReflectionClass::GetParent() const {
+		return parent;
+	}
 	bool ReflectionClass::IsChildOf(const ReflectionClass* target) const {
 		if (target == nullptr) {
 			return false;
 		}
-		const ReflectionClass* current = this;
-		do {
+		for (const ReflectionClass* current = this; current != nullptr; current = current->parent) {
 			if (current == target) {
 				return true;
 			}
-			current = (Reflection::IsClassExists(current->parentName) ? Reflection::GetClass(current->parentName) : nullptr);
-		} while (current != nullptr);
+		}
 		return false;
 	}
 	bool ReflectionClass::IsParentOf(const ReflectionClass* target) const {
@@ -57,69 +132,154 @@ namespace Engine{
 	void ReflectionClass::SetInstantiable(bool instantiable) {
 		this->instantiable = instantiable;
 	}
+	Object* ReflectionClass::Instantiate() const {
+		Object* result = nullptr;
+		InstantiateMany(1, &result);
+		return result;
+	}
+	int32 ReflectionClass::InstantiateMany(int32 count, Object** results) const {
+		ERR_ASSERT(count >= 0, u8"count cannot be negative.", return 0);
+		ERR_ASSERT(results != nullptr || count == 0, u8"results cannot be nullptr.", return 0);
+		if (!instantiable || constructor == nullptr) {
+			return 0;
+		}
+		constructor(count, results);
+		return count;
+	}
+	typename ReflectionClass::Constructor ReflectionClass::GetConstructor() const {
+		return constructor;
+	}
+	void ReflectionClass::SetConstructor(Constructor constructor) {
+		this->constructor = constructor;
+	}
 
 
-	bool ReflectionClass::HasMethod(const String& name) const {
-		return methods.ContainsKey(name);
+	bool ReflectionClass::HasMethod(const StringName& name) const {
+		return GetMethod(name) != nullptr;
+	}
+
+	ReflectionMethod* ReflectionClass::GetMethod(const StringName& name) const {
+		if (IsFrozen()) {
+			return FindMember(resolvedMethods, name);
+		}
+		// Still registering, the parent is frozen already.
+		SharedPtr<ReflectionMethod>* result = methods.Find(name);
+		if (result != nullptr) {
+			return result->GetRaw();
+		}
+		return parent == nullptr ? nullptr : parent->GetMethod(name);
+	}
+
+	int32 ReflectionClass::GetMethodCount() const {
+		return methods.GetCount();
+	}
+	ReflectionMethod* ReflectionClass::GetMethodAt(int32 index) const {
+		ERR_ASSERT(index >= 0 && index < methods.GetCount(), u8"index out of bounds.", return nullptr);
+		return methods.GetValue(index).GetRaw();
 	}
 
-	ReflectionMethod* ReflectionClass::GetMethod(const String& name) const {
-		SharedPtr<ReflectionMethod> result;
-		methods.TryGet(name, result);
-		return result.GetRaw();
+	MethodHandle ReflectionClass::ResolveMethod(const StringName& name) const {
+		return MethodHandle(GetMethod(name));
 	}
 
 	ReflectionMethod* ReflectionClass::AddMethod(SharedPtr<ReflectionMethod> method) {
+		ERR_ASSERT(!IsFrozen(), String::Format(STRING_LITERAL("Cannot add method {0}::{1}, the class is frozen!"), name, method->GetName()).GetRawArray(), return nullptr);
 		bool succeeded = methods.Add(method->GetName(), method);
 		FATAL_ASSERT(succeeded, String::Format(STRING_LITERAL("Method {0}::{1} is already registered!"), name, method->GetName()).GetRawArray());
 		return method.GetRaw();
 	}
 
-	bool ReflectionClass::RemoveMethod(const String& name) {
+	bool ReflectionClass::RemoveMethod(const StringName& name) {
 		return methods.Remove(name);
 	}
 
 
-	bool ReflectionClass::HasProperty(const String& name) const {
-		return properties.ContainsKey(name);
+	bool ReflectionClass::HasProperty(const StringName& name) const {
+		return GetProperty(name) != nullptr;
 	}
 
-	ReflectionProperty* ReflectionClass::GetProperty(const String& name) const {
-		SharedPtr<ReflectionProperty> result;
-		properties.TryGet(name, result);
-		return result.GetRaw();
+	ReflectionProperty* ReflectionClass::GetProperty(const StringName& name) const {
+		if (IsFrozen()) {
+			return FindMember(resolvedProperties, name);
+		}
+		// Still registering, the parent is frozen already.
+		SharedPtr<ReflectionProperty>* result = properties.Find(name);
+		if (result != nullptr) {
+			return result->GetRaw();
+		}
+		return parent == nullptr ? nullptr : parent->GetProperty(name);
+	}
+
+	int32 ReflectionClass::GetPropertyCount() const {
+		return properties.GetCount();
+	}
+	ReflectionProperty* ReflectionClass::GetPropertyAt(int32 index) const {
+		ERR_ASSERT(index >= 0 && index < properties.GetCount(), u8"index out of bounds.", return nullptr);
+		return properties.GetValue(index).GetRaw();
 	}
 
 	ReflectionProperty* ReflectionClass::AddProperty(SharedPtr<ReflectionProperty> prop) {
+		ERR_ASSERT(!IsFrozen(), String::Format(STRING_LITERAL("Cannot add property {0}::{1}, the class is frozen!"), name, prop->GetName()).GetRawArray(), return nullptr);
 		bool succeeded = properties.Add(prop->GetName(), prop);
 		FATAL_ASSERT(succeeded, String::Format(STRING_LITERAL("Property {0}::{1} is already registered!"), name, prop->GetName()).GetRawArray());
 		return prop.GetRaw();
 	}
 
-	bool ReflectionClass::RemoveProperty(const String& name) {
+	bool ReflectionClass::RemoveProperty(const StringName& name) {
 		return properties.Remove(name);
 	}
 
 
-	bool ReflectionClass::HasSignal(const String& name) const {
-		return signals.ContainsKey(name);
+	bool ReflectionClass::HasSignal(const StringName& name) const {
+		return GetSignal(name) != nullptr;
 	}
 
-	ReflectionSignal* ReflectionClass::GetSignal(const String& name) const {
-		SharedPtr<ReflectionSignal> result;
-		signals.TryGet(name, result);
-		return result.GetRaw();
+	ReflectionSignal* ReflectionClass::GetSignal(const StringName& name) const {
+		if (IsFrozen()) {
+			return FindMember(resolvedSignals, name);
+		}
+		// Still registering, the parent is frozen already.
+		SharedPtr<ReflectionSignal>* result = signals.Find(name);
+		if (result != nullptr) {
+			return result->GetRaw();
+		}
+		return parent == nullptr ? nullptr : parent->GetSignal(name);
 	}
 
 	ReflectionSignal* ReflectionClass::AddSignal(SharedPtr<ReflectionSignal> signal) {
+		ERR_ASSERT(!IsFrozen(), String::Format(STRING_LITERAL("Cannot add signal {0}::{1}, the class is frozen!"), name, signal->GetName()).GetRawArray(), return nullptr);
 		bool succeeded = signals.Add(signal->GetName(), signal);
 		FATAL_ASSERT(succeeded, String::Format(STRING_LITERAL("Signal {0}::{1} is already registered!"), name, signal->GetName()).GetRawArray());
 		return signal.GetRaw();
 	}
 
-	bool ReflectionClass::RemoveSignal(const String& name) {
+	bool ReflectionClass::RemoveSignal(const StringName& name) {
 		return signals.Remove(name);
 	}
+
+	void ReflectionClass::Freeze() {
+		if (IsFrozen()) {
+			return;
+		}
+		FlattenMembers(methods, (parent == nullptr ? nullptr : &parent->resolvedMethods), resolvedMethods);
+		FlattenMembers(properties, (parent == nullptr ? nullptr : &parent->resolvedProperties), resolvedProperties);
+		FlattenMembers(signals, (parent == nullptr ? nullptr : &parent->resolvedSignals), resolvedSignals);
+
+		methods.Freeze();
+		properties.Freeze();
+		signals.Freeze();
+
+		// Indices into the sorted tables, which no longer change.
+		for (int32 i = 0; i < methods.GetCount(); i += 1) {
+			methods.GetValue(i)->index = i;
+		}
+		for (int32 i = 0; i < properties.GetCount(); i += 1) {
+			properties.GetValue(i)->index = i;
+		}
+	}
+	bool ReflectionClass::IsFrozen() const {
+		return methods.IsFrozen();
+	}
 #pragma endregion
 
 #pragma region ReflectionMethod
@@ -129,9 +289,12 @@ namespace Engine{
 		std::initializer_list<String> argumentNames, std::initializer_list<Variant> defaultArguments
 	) : name(name), bind(bind), argumentNames(argumentNames), defaultArguments(defaultArguments) {}
 
-	String ReflectionMethod::GetName() const {
+	StringName ReflectionMethod::GetName() const {
 		return name;
 	}
+	int32 ReflectionMethod::GetIndex() const {
+		return index;
+	}
 	bool ReflectionMethod::IsConst() const {
 		return bind->IsConst();
 	}
@@ -172,29 +335,63 @@ namespace Engine{
 	}
 #pragma endregion
 
+#pragma region MethodHandle
+	MethodHandle::MethodHandle(const ReflectionMethod* method) :method(method) {
+		if (method != nullptr) {
+			bind = method->GetBind().GetRaw();
+			isStatic = method->IsStatic();
+		}
+	}
+	bool MethodHandle::IsValid() const {
+		return method != nullptr;
+	}
+	const ReflectionMethod* MethodHandle::GetMethod() const {
+		return method;
+	}
+	ResultCode MethodHandle::Invoke(Object* target, const Variant** arguments, int32 argumentCount, Variant& result) const {
+		ERR_ASSERT(IsValid(), u8"The method handle is invalid.", return ResultCode::NotFound);
+		return method->Invoke(target, arguments, argumentCount, result);
+	}
+#pragma endregion
+
 #pragma region ReflectionProperty
 	ReflectionProperty::ReflectionProperty(
 		const String& name,
 		ReflectionMethod* getter, ReflectionMethod* setter,
 		Hint hint, const String& hintText
 	) :name(name), getter(getter), setter(setter), hint(hint), hintText(hintText) {}
+	ReflectionProperty::ReflectionProperty(
+		const String& name,
+		SharedPtr<ReflectionFieldBind> field,
+		Hint hint, const String& hintText
+	) :name(name), hint(hint), hintText(hintText), field(field) {}
 
-	String ReflectionProperty::GetName() const {
+	StringName ReflectionProperty::GetName() const {
 		return name;
 	}
+	int32 ReflectionProperty::GetIndex() const {
+		return index;
+	}
 	Variant::Type ReflectionProperty::GetType() const {
+		if (field != nullptr) {
+			return field->GetType();
+		}
 		if (!CanGet()) {
 			return Variant::Type::Null;
 		}
 		return getter->GetReturnType();
 	}
 	bool ReflectionProperty::CanGet() const {
-		return getter != nullptr;
+		return getter != nullptr || field != nullptr;
 	}
 	bool ReflectionProperty::CanSet() const {
-		return setter != nullptr;
+		return setter != nullptr || field != nullptr;
 	}
 	ResultCode ReflectionProperty::Get(const Object* obj,Variant& result) const {
+		if (field != nullptr) {
+			field->Get(obj, result);
+			return ResultCode::OK;
+		}
 		ERR_ASSERT(CanGet(), u8"The property cannot get.", return ResultCode::NotSupported);
 		
 		auto invokeResult = getter->Invoke(const_cast<Object*>(obj), nullptr, 0, result);
@@ -203,6 +400,10 @@ namespace Engine{
 		return ResultCode::OK;
 	}
 	ResultCode ReflectionProperty::Set(Object* obj,const Variant& value) {
+		if (field != nullptr) {
+			field->Set(obj, value);
+			return ResultCode::OK;
+		}
 		ERR_ASSERT(CanSet(), u8"The property cannot set.", return ResultCode::NotSupported);
 
 		const Variant* args[1] = { &value };
@@ -210,8 +411,12 @@ namespace Engine{
 		auto result = setter->Invoke(obj, (const Variant**)args, 1, returnValue);
 
 		ERR_ASSERT(result == ResultCode::OK, u8"Failed to invoke setter.", return result);
+		return ResultCode::OK;
 	}
 
+	ReflectionFieldBind* ReflectionProperty::GetField() const {
+		return field.GetRaw();
+	}
 	ReflectionMethod* ReflectionProperty::GetGetter() const {
 		return getter;
 	}
@@ -243,7 +448,7 @@ namespace Engine{
 	ReflectionSignal::ArgumentInfo::ArgumentInfo() :name(STRING_LITERAL("error")), type(Variant::Type::Null), detailedClass(String::GetEmpty()) {}
 	ReflectionSignal::ArgumentInfo::ArgumentInfo(const String& name, Variant::Type type, const String& detailedClass) :name(name), type(type), detailedClass(detailedClass) {}
 
-	String ReflectionSignal::GetName() const {
+	StringName ReflectionSignal::GetName() const {
 		return name;
 	}
 	int32 ReflectionSignal::GetArgumentCount() const {
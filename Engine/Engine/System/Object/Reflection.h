@@ -2,10 +2,13 @@
 
 #include "Engine/System/Definition.h"
 #include "Engine/System/String.h"
+#include "Engine/System/StringName.h"
 #include "Engine/System/Memory/UniquePtr.h"
 #include "Engine/System/Memory/SharedPtr.h"
-#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+#include "Engine/System/Collection/FlatMap.h"
 #include "Engine/System/Collection/List.h"
+#include "Engine/System/Thread/ReadWriteLock.h"
 #include "Engine/System/Object/Variant.h"
 #include "Engine/System/Object/InstanceId.h"
 
@@ -37,6 +40,15 @@ public:																									\
 	}																									\
 	virtual ::Engine::String GetReflectionParentClassName() const{										\
 		return ::Engine::String::GetEmpty();															\
+	}																									\
+	static ::Engine::ReflectionClass* GetReflectionClassStatic(){										\
+		if(_reflectionClass==nullptr){																	\
+			_InitializeReflection();																	\
+		}																								\
+		return _reflectionClass;																		\
+	}																									\
+	virtual ::Engine::ReflectionClass* GetReflectionClass() const{										\
+		return GetReflectionClassStatic();																\
 	}																									\
 																										\
 protected:																								\
@@ -52,11 +64,14 @@ protected:																								\
 		);																								\
 		FATAL_ASSERT(ptr!=nullptr,u8"Failed to register class.");										\
 		_InitializeCustomReflection(ptr);																\
+		ptr->Freeze();																					\
+		_reflectionClass=ptr;																			\
 																										\
 		inited=true;																					\
 	}																									\
 																										\
 private:																								\
+	inline static ::Engine::ReflectionClass* _reflectionClass=nullptr;									\
 	_REFLECTION_CLASS_AUTO_REGISTER();																	\
 	static void _InitializeCustomReflection(::Engine::ReflectionClass* c)
 
@@ -78,6 +93,15 @@ public:																									\
 	}																									\
 	virtual ::Engine::String GetReflectionParentClassName() const override{								\
 		return STRING_LITERAL(#parent);																	\
+	}																									\
+	static ::Engine::ReflectionClass* GetReflectionClassStatic(){										\
+		if(_reflectionClass==nullptr){																	\
+			_InitializeReflection();																	\
+		}																								\
+		return _reflectionClass;																		\
+	}																									\
+	virtual ::Engine::ReflectionClass* GetReflectionClass() const override{								\
+		return GetReflectionClassStatic();																\
 	}																									\
 																										\
 protected:																								\
@@ -95,24 +119,30 @@ protected:																								\
 		);																								\
 		FATAL_ASSERT(ptr!=nullptr,u8"Failed to register class.");										\
 		_InitializeCustomReflection(ptr);																\
+		ptr->Freeze();																					\
+		_reflectionClass=ptr;																			\
 																										\
 		inited=true;																					\
 	}																									\
 																										\
 private:																								\
+	inline static ::Engine::ReflectionClass* _reflectionClass=nullptr;									\
 	_REFLECTION_CLASS_AUTO_REGISTER();																	\
 	static void _InitializeCustomReflection(::Engine::ReflectionClass* c)
 
 #pragma endregion
 
 #define REFLECTION_CLASS_INSTANTIABLE(instantiable) c->SetInstantiable(instantiable)
+// Lets ReflectionClass::Instantiate() create the class with its default constructor, type is the class itself.
+// Batches from InstantiateMany() share their PoolAllocator trips.
+#define REFLECTION_CLASS_CONSTRUCTIBLE(type) c->SetConstructor(::Engine::ReflectionConstructorHelper::Create<type>())
 
 #define ARGLIST(...) {__VA_ARGS__}
 
 #define REFLECTION_METHOD(name,func,argNames,defaultArgs)							\
 c->AddMethod(::Engine::SharedPtr<::Engine::ReflectionMethod>::Create(				\
 	name,																			\
-	::Engine::ReflectionMethodBindHelper::Create(&func),							\
+	::Engine::ReflectionMethodBindHelper::CreateStatic<&func>(),					\
 	std::initializer_list<::Engine::String> argNames,								\
 	std::initializer_list<::Engine::Variant> defaultArgs							\
 ))
@@ -120,7 +150,7 @@ c->AddMethod(::Engine::SharedPtr<::Engine::ReflectionMethod>::Create(				\
 #define REFLECTION_STATIC_METHOD(name,func,argNames,defaultArgs)					\
 c->AddMethod(::Engine::SharedPtr<::Engine::ReflectionMethod>::Create(				\
 	name,																			\
-	::Engine::ReflectionMethodBindHelper::Create(func),								\
+	::Engine::ReflectionMethodBindHelper::CreateStatic<func>(),						\
 	std::initializer_list<::Engine::String> argNames,								\
 	std::initializer_list<::Engine::Variant> defaultArgs							\
 ))
@@ -135,6 +165,17 @@ c->AddProperty(::Engine::SharedPtr<::Engine::ReflectionProperty>::Create(			\
 	name,c->GetMethod(getterName),c->GetMethod(setterName),hint,hintText			\
 ))
 
+// A property reading and writing a member field directly, without a getter and a setter method.
+#define REFLECTION_FIELD(name,field)												\
+c->AddProperty(::Engine::SharedPtr<::Engine::ReflectionProperty>::Create(			\
+	name,::Engine::ReflectionFieldBindHelper::CreateStatic<&field>()				\
+))
+
+#define REFLECTION_FIELD_HINT(name,field,hint,hintText)								\
+c->AddProperty(::Engine::SharedPtr<::Engine::ReflectionProperty>::Create(			\
+	name,::Engine::ReflectionFieldBindHelper::CreateStatic<&field>(),hint,hintText	\
+))
+
 #define SIGARG(name,type) ::Engine::ReflectionSignal::ArgumentInfo(name,type)
 #define SIGARGD(name,type,detailedType) ::Engine::ReflectionSignal::ArgumentInfo(name,type,detailedType)
 
@@ -156,7 +197,9 @@ namespace Engine {
 	class ReflectionMethod;
 	class ReflectionMethodBind;
 	class ReflectionProperty;
+	class ReflectionFieldBind;
 	class ReflectionSignal;
+	class MethodHandle;
 
 	class Variant;
 
@@ -167,12 +210,28 @@ namespace Engine {
 
 		static bool IsClassExists(const String& name);
 
+		/// @brief Look a class up by name. Objects get theirs from Object::GetReflectionClass() without a lookup.
 		static ReflectionClass* GetClass(const String& name);
+		/// @brief Get a class by its id, see ReflectionClass::GetId().
+		static ReflectionClass* GetClass(int32 id);
+		static int32 GetClassCount();
 
+		/// @brief Register a class. The parent must be registered already.
 		static ReflectionClass* AddClass(const String& name, const String& parent);
 
+		/// @brief Create an object of the class with the id, see ReflectionClass::Instantiate().
+		static Object* Instantiate(int32 classId);
+		/// @brief Create count objects of the class with the id, see ReflectionClass::InstantiateMany().
+		static int32 InstantiateMany(int32 classId, int32 count, Object** results);
+
 	private:
-		using ClassData = Dictionary<String, SharedPtr<ReflectionClass>>;
+		struct ClassData {
+			/// @brief Classes register lazily on first use, which may be on a job while others look classes up, loading scenes for example.
+			ReadWriteLock lock{};
+			FlatDictionary<String, SharedPtr<ReflectionClass>> classes{ 30 };
+			/// @brief Indexed by the class ids.
+			List<ReflectionClass*> classIds{ 30 };
+		};
 		static ClassData& GetData();
 	};
 
@@ -180,42 +239,86 @@ namespace Engine {
 	public:
 		String GetName() const;
 		String GetParentName() const;
+		/// @brief A dense id assigned on registration, parents get lower ids than their children.\n
+		/// Ids follow the registration order, which may differ between builds. Don't save them.
+		int32 GetId() const;
+		/// @brief nullptr for root classes.
+		ReflectionClass* GetParent() const;
 
 		bool IsInstantiatable() const;
 		void SetInstantiable(bool instantiable);
 
+		/// @brief Fills results with count new objects of the class.
+		using Constructor = void (*)(int32 count, Object** results);
+		/// @brief Create an object of the class, nullptr if it isn't instantiable or has no constructor, see REFLECTION_CLASS_CONSTRUCTIBLE().\n
+		/// ReferencedObjects come out without a reference taken. Constructors aren't inherited.
+		Object* Instantiate() const;
+		/// @brief Create count objects of the class at once, their memory taken from the pools together. Each is freed by MEMDEL() on its own.
+		/// @return count, or 0 if the class can't be instantiated.
+		int32 InstantiateMany(int32 count, Object** results) const;
+		Constructor GetConstructor() const;
+		void SetConstructor(Constructor constructor);
+
 		bool IsParentOf(const ReflectionClass* target) const;
 		bool IsChildOf(const ReflectionClass* target) const;
 
-		bool HasMethod(const String& name) const;
-		ReflectionMethod* GetMethod(const String& name) const;
+		// Has and Get of methods, properties and signals see the inherited ones too, the class's own ones first.
+		// Once the class is frozen they are a single probe into a table flattened with the parents.
+		// Count and At only cover the ones declared by the class itself.
+
+		bool HasMethod(const StringName& name) const;
+		ReflectionMethod* GetMethod(const StringName& name) const;
+		int32 GetMethodCount() const;
+		/// @brief Get a method declared by the class by its index, see ReflectionMethod::GetIndex().
+		ReflectionMethod* GetMethodAt(int32 index) const;
+		/// @brief Look a method up once for calling it through the handle later. The handle is invalid if it's not found.
+		MethodHandle ResolveMethod(const StringName& name) const;
 		ReflectionMethod* AddMethod(SharedPtr<ReflectionMethod> method);
-		bool RemoveMethod(const String& name);
+		bool RemoveMethod(const StringName& name);
 
-		bool HasProperty(const String& name) const;
-		ReflectionProperty* GetProperty(const String& name) const;
+		bool HasProperty(const StringName& name) const;
+		ReflectionProperty* GetProperty(const StringName& name) const;
+		int32 GetPropertyCount() const;
+		/// @brief Get a property declared by the class by its index, see ReflectionProperty::GetIndex().
+		ReflectionProperty* GetPropertyAt(int32 index) const;
 		ReflectionProperty* AddProperty(SharedPtr<ReflectionProperty> prop);
-		bool RemoveProperty(const String& name);
+		bool RemoveProperty(const StringName& name);
 
-		bool HasSignal(const String& name) const;
-		ReflectionSignal* GetSignal(const String& name) const;
+		bool HasSignal(const StringName& name) const;
+		ReflectionSignal* GetSignal(const StringName& name) const;
 		ReflectionSignal* AddSignal(SharedPtr<ReflectionSignal> signal);
-		bool RemoveSignal(const String& name);
+		bool RemoveSignal(const StringName& name);
+
+		/// @brief Trim the method, property and signal tables and assign the method and property indices, done once the class is registered.\n
+		/// Also flattens the tables with the ones of the parent, which is frozen already.
+		/// No methods, properties or signals can be added or removed afterwards, so the flattened tables never go stale.
+		void Freeze();
+		bool IsFrozen() const;
 	private:
 		friend class Reflection;
 
 		String name;
 		String parentName;
+		ReflectionClass* parent = nullptr;
+		int32 id = -1;
 		bool instantiable = true;
+		Constructor constructor = nullptr;
 
-		using MethodData = Dictionary<String, SharedPtr<ReflectionMethod>>;
+		using MethodData = FlatMap<StringName, SharedPtr<ReflectionMethod>>;
 		MethodData methods{};
 
-		using PropertyData = Dictionary<String, SharedPtr<ReflectionProperty>>;
+		using PropertyData = FlatMap<StringName, SharedPtr<ReflectionProperty>>;
 		PropertyData properties{};
 
-		using SignalData = Dictionary<String, SharedPtr<ReflectionSignal>>;
+		using SignalData = FlatMap<StringName, SharedPtr<ReflectionSignal>>;
 		SignalData signals{};
+
+		// Own and inherited members, built by Freeze().
+		template<typename T>
+		using ResolvedData = FlatMap<StringName, T*>;
+		ResolvedData<ReflectionMethod> resolvedMethods{};
+		ResolvedData<ReflectionProperty> resolvedProperties{};
+		ResolvedData<ReflectionSignal> resolvedSignals{};
 	};
 
 	class ReflectionMethod final {
@@ -226,7 +329,9 @@ namespace Engine {
 			std::initializer_list<String> argumentNames, std::initializer_list<Variant> defaultArguments
 		);
 
-		String GetName() const;
+		StringName GetName() const;
+		/// @brief The index in the methods of the class, -1 until the class is frozen.
+		int32 GetIndex() const;
 		bool IsConst() const;
 		bool IsStatic() const;
 		Variant::Type GetReturnType() const;
@@ -243,7 +348,8 @@ namespace Engine {
 	private:
 		friend class ReflectionClass;
 
-		String name;
+		StringName name;
+		int32 index = -1;
 		List<String> argumentNames;
 		List<Variant> defaultArguments;
 
@@ -261,10 +367,23 @@ namespace Engine {
 		//virtual Variant::Type GetArgumentType(int32 index) const = 0;
 
 		virtual ResultCode Invoke(Object* target, const Variant** arguments, int32 argumentCount, const List<Variant>& defaultArguments,Variant& result) const = 0;
+
+		/// @brief Identifies the native signature, the return and argument types without references and const.
+		virtual const void* GetSignature() const = 0;
+		/// @brief Call with native values, skipping Variants and default arguments. See MethodHandle::PtrCall().
+		/// @param arguments Pointers to every argument, of the exact argument types.
+		/// @param result Points to a value of the exact return type, unused for void.
+		virtual void PtrCall(Object* target, const void* const* arguments, void* result) const = 0;
 	};
 
 	/// @internal
 
+	// One id per native signature, compared by address.
+	template<typename TReturn, typename ... TArgs>
+	struct _ReflectionSignature final {
+		static inline constexpr byte id = 0;
+	};
+
 	// Static, return a value.
 	template<typename TReturn,typename ... TArgs>
 	class _ReflectionMethodBindStaticReturn final:public ReflectionMethodBind {
@@ -301,6 +420,17 @@ namespace Engine {
 			return InternalInvoke(target, args, result,std::make_index_sequence<sizeof...(TArgs)>());
 		}
 
+		const void* GetSignature() const override {
+			return &_ReflectionSignature<std::remove_cvref_t<TReturn>, std::remove_cvref_t<TArgs>...>::id;
+		}
+		template<sizeint...Index>
+		void InternalPtrCall(Object* target, const void* const* arguments, void* result, std::index_sequence<Index...>) const {
+			*static_cast<std::remove_cvref_t<TReturn>*>(result) = (*method)(*static_cast<std::remove_cvref_t<TArgs>*>(const_cast<void*>(arguments[Index]))...);
+		}
+		void PtrCall(Object* target, const void* const* arguments, void* result) const override {
+			InternalPtrCall(target, arguments, result, std::make_index_sequence<sizeof...(TArgs)>());
+		}
+
 		TReturn(*method)(TArgs...);
 	};
 
@@ -341,6 +471,17 @@ namespace Engine {
 			return InternalInvoke(target, args, result, std::make_index_sequence<sizeof...(TArgs)>());
 		}
 
+		const void* GetSignature() const override {
+			return &_ReflectionSignature<void, std::remove_cvref_t<TArgs>...>::id;
+		}
+		template<sizeint...Index>
+		void InternalPtrCall(Object* target, const void* const* arguments, void* result, std::index_sequence<Index...>) const {
+			(*method)(*static_cast<std::remove_cvref_t<TArgs>*>(const_cast<void*>(arguments[Index]))...);
+		}
+		void PtrCall(Object* target, const void* const* arguments, void* result) const override {
+			InternalPtrCall(target, arguments, result, std::make_index_sequence<sizeof...(TArgs)>());
+		}
+
 		void (*method)(TArgs...);
 	};
 
@@ -380,6 +521,17 @@ namespace Engine {
 			return InternalInvoke(target, args, result, std::make_index_sequence<sizeof...(TArgs)>());
 		}
 
+		const void* GetSignature() const override {
+			return &_ReflectionSignature<std::remove_cvref_t<TReturn>, std::remove_cvref_t<TArgs>...>::id;
+		}
+		template<sizeint...Index>
+		void InternalPtrCall(Object* target, const void* const* arguments, void* result, std::index_sequence<Index...>) const {
+			*static_cast<std::remove_cvref_t<TReturn>*>(result) = (((TClass*)target)->*method)(*static_cast<std::remove_cvref_t<TArgs>*>(const_cast<void*>(arguments[Index]))...);
+		}
+		void PtrCall(Object* target, const void* const* arguments, void* result) const override {
+			InternalPtrCall(target, arguments, result, std::make_index_sequence<sizeof...(TArgs)>());
+		}
+
 		TReturn(TClass::*method)(TArgs...);
 	};
 
@@ -419,6 +571,17 @@ namespace Engine {
 			return InternalInvoke(target, args, result, std::make_index_sequence<sizeof...(TArgs)>());
 		}
 
+		const void* GetSignature() const override {
+			return &_ReflectionSignature<std::remove_cvref_t<TReturn>, std::remove_cvref_t<TArgs>...>::id;
+		}
+		template<sizeint...Index>
+		void InternalPtrCall(Object* target, const void* const* arguments, void* result, std::index_sequence<Index...>) const {
+			*static_cast<std::remove_cvref_t<TReturn>*>(result) = (((TClass*)target)->*method)(*static_cast<std::remove_cvref_t<TArgs>*>(const_cast<void*>(arguments[Index]))...);
+		}
+		void PtrCall(Object* target, const void* const* arguments, void* result) const override {
+			InternalPtrCall(target, arguments, result, std::make_index_sequence<sizeof...(TArgs)>());
+		}
+
 		TReturn(TClass::* method)(TArgs...) const;
 	};
 
@@ -459,6 +622,17 @@ namespace Engine {
 			return InternalInvoke(target, args, result, std::make_index_sequence<sizeof...(TArgs)>());
 		}
 
+		const void* GetSignature() const override {
+			return &_ReflectionSignature<void, std::remove_cvref_t<TArgs>...>::id;
+		}
+		template<sizeint...Index>
+		void InternalPtrCall(Object* target, const void* const* arguments, void* result, std::index_sequence<Index...>) const {
+			(((TClass*)target)->*method)(*static_cast<std::remove_cvref_t<TArgs>*>(const_cast<void*>(arguments[Index]))...);
+		}
+		void PtrCall(Object* target, const void* const* arguments, void* result) const override {
+			InternalPtrCall(target, arguments, result, std::make_index_sequence<sizeof...(TArgs)>());
+		}
+
 		void(TClass::* method)(TArgs...);
 	};
 
@@ -499,11 +673,48 @@ namespace Engine {
 			return InternalInvoke(target, args, result, std::make_index_sequence<sizeof...(TArgs)>());
 		}
 
+		const void* GetSignature() const override {
+			return &_ReflectionSignature<void, std::remove_cvref_t<TArgs>...>::id;
+		}
+		template<sizeint...Index>
+		void InternalPtrCall(Object* target, const void* const* arguments, void* result, std::index_sequence<Index...>) const {
+			(((TClass*)target)->*method)(*static_cast<std::remove_cvref_t<TArgs>*>(const_cast<void*>(arguments[Index]))...);
+		}
+		void PtrCall(Object* target, const void* const* arguments, void* result) const override {
+			InternalPtrCall(target, arguments, result, std::make_index_sequence<sizeof...(TArgs)>());
+		}
+
 		void(TClass::* method)(TArgs...) const;
 	};
 
 	/// @endinternal
 
+	class ReflectionConstructorHelper final {
+	public:
+		template<typename T>
+		static ReflectionClass::Constructor Create() {
+			return [](int32 count, Object** results) {
+				if constexpr (alignof(T) > alignof(std::max_align_t)) {
+					for (int32 i = 0; i < count; i += 1) {
+						results[i] = MEMNEW(T);
+					}
+				} else {
+					constexpr int32 BatchSize = 64;
+					void* blocks[BatchSize];
+					for (int32 done = 0; done < count; done += BatchSize) {
+						int32 batch = (count - done < BatchSize ? count - done : BatchSize);
+						Memory::AllocateMany(sizeof(T), batch, blocks);
+						for (int32 i = 0; i < batch; i += 1) {
+							T* object = static_cast<T*>(blocks[i]);
+							Memory::Construct(object);
+							results[done + i] = object;
+						}
+					}
+				}
+			};
+		}
+	};
+
 	class ReflectionMethodBindHelper final{
 	public:
 		// Static, no return.
@@ -537,6 +748,138 @@ namespace Engine {
 		static SharedPtr<ReflectionMethodBind> Create(TReturn(TClass::* method)(TArgs...) const) {
 			return SharedPtr<_ReflectionMethodBindReturnConst<TClass, TReturn, TArgs...>>::Create(method);
 		}
+
+		/// @brief The bind of a method known at compile time, kept in static storage instead of allocated.\n
+		/// Every call with the same method returns the same bind, registering it is only taking a reference.
+		template<auto method>
+		static SharedPtr<ReflectionMethodBind> CreateStatic() {
+			static StaticSharedPtrBlock<decltype(BindOf(method))> block(method);
+			return block.Get();
+		}
+
+	private:
+		// Only for picking the bind type of a method in CreateStatic(), never defined.
+		template<typename ... TArgs>
+		static _ReflectionMethodBindStaticVoid<TArgs...> BindOf(void (*method)(TArgs...));
+		template<typename TReturn, typename ... TArgs>
+		static _ReflectionMethodBindStaticReturn<TReturn, TArgs...> BindOf(TReturn(*method)(TArgs...));
+		template<typename TClass, typename ... TArgs>
+		static _ReflectionMethodBindVoid<TClass, TArgs...> BindOf(void(TClass::* method)(TArgs...));
+		template<typename TClass, typename TReturn, typename ... TArgs>
+		static _ReflectionMethodBindReturn<TClass, TReturn, TArgs...> BindOf(TReturn(TClass::* method)(TArgs...));
+		template<typename TClass, typename ... TArgs>
+		static _ReflectionMethodBindVoidConst<TClass, TArgs...> BindOf(void(TClass::* method)(TArgs...) const);
+		template<typename TClass, typename TReturn, typename ... TArgs>
+		static _ReflectionMethodBindReturnConst<TClass, TReturn, TArgs...> BindOf(TReturn(TClass::* method)(TArgs...) const);
+	};
+#pragma endregion
+
+	/// @brief A method resolved once, to be called many times without looking it up by name.\n
+	/// PtrCall() goes straight to the bound native function when the native signature is known.\n
+	/// Holds the bind of the method as it was resolved, resolve again after ReflectionMethod::SetBind().
+	class MethodHandle final {
+	public:
+		MethodHandle() = default;
+		MethodHandle(const ReflectionMethod* method);
+
+		/// @brief false if the method wasn't found.
+		bool IsValid() const;
+		const ReflectionMethod* GetMethod() const;
+
+		/// @brief Call with Variants, the same as ReflectionMethod::Invoke().
+		ResultCode Invoke(Object* target, const Variant** arguments, int32 argumentCount, Variant& result) const;
+
+		/// @brief Check if the method takes exactly these types, ignoring references and const.
+		template<typename TReturn, typename ... TArgs>
+		bool HasSignature() const {
+			return bind != nullptr && bind->GetSignature() == &_ReflectionSignature<std::remove_cvref_t<TReturn>, std::remove_cvref_t<TArgs>...>::id;
+		}
+		/// @brief Call the native function directly with native arguments, no Variant is made.\n
+		/// The types must match the bound function exactly, see HasSignature(), no conversions are done and all arguments have to be given.
+		/// @return The default value of TReturn if the signature doesn't match.
+		template<typename TReturn = void, typename ... TArgs>
+		TReturn PtrCall(Object* target, const TArgs& ... args) const {
+			ERR_ASSERT((HasSignature<TReturn, TArgs...>()), u8"The native signature doesn't match the method!", return TReturn());
+			ERR_ASSERT(isStatic || target != nullptr, u8"target cannot be nullptr for a non-static method.", return TReturn());
+
+			const void* arguments[sizeof...(TArgs) == 0 ? 1 : sizeof...(TArgs)] = { static_cast<const void*>(&args)... };
+			if constexpr (std::is_void_v<TReturn>) {
+				bind->PtrCall(target, arguments, nullptr);
+			} else {
+				std::remove_cvref_t<TReturn> result{};
+				bind->PtrCall(target, arguments, &result);
+				return result;
+			}
+		}
+
+	private:
+		const ReflectionMethod* method = nullptr;
+		ReflectionMethodBind* bind = nullptr;
+		bool isStatic = false;
+	};
+
+#pragma region FieldBind
+	/// @brief Reads and writes a member field of an object, for properties declared with REFLECTION_FIELD().
+	class ReflectionFieldBind {
+	public:
+		virtual ~ReflectionFieldBind() = default;
+		virtual Variant::Type GetType() const = 0;
+		virtual void Get(const Object* obj, Variant& result) const = 0;
+		virtual void Set(Object* obj, const Variant& value) const = 0;
+		/// @brief Copy the field from one object to another without making a Variant. Both must be of the class declaring the field.
+		virtual void Copy(const Object* source, Object* target) const = 0;
+	};
+
+	/// @internal
+
+	template<typename TClass, typename T>
+	class _ReflectionFieldBind final :public ReflectionFieldBind {
+	public:
+		_ReflectionFieldBind(T TClass::* field) :field(field) {}
+
+		Variant::Type GetType() const override {
+			return Variant::GetTypeFromNative<T>::type;
+		}
+		void Get(const Object* obj, Variant& result) const override {
+			const T& value = static_cast<const TClass*>(obj)->*field;
+			if constexpr (std::is_enum_v<T>) {
+				result = Variant((int64)value);
+			} else {
+				result = Variant(value);
+			}
+		}
+		void Set(Object* obj, const Variant& value) const override {
+			static_cast<TClass*>(obj)->*field = Variant::CastToNative<T>::Cast(value);
+		}
+		void Copy(const Object* source, Object* target) const override {
+			static_cast<TClass*>(target)->*field = static_cast<const TClass*>(source)->*field;
+		}
+	private:
+		T TClass::* field;
+	};
+
+	/// @endinternal
+
+	class ReflectionFieldBindHelper final {
+	public:
+		STATIC_CLASS(ReflectionFieldBindHelper);
+
+		template<typename TClass, typename T>
+		static SharedPtr<ReflectionFieldBind> Create(T TClass::* field) {
+			return SharedPtr<_ReflectionFieldBind<TClass, T>>::Create(field);
+		}
+
+		/// @brief The bind of a field known at compile time, kept in static storage instead of allocated.
+		template<auto field>
+		static SharedPtr<ReflectionFieldBind> CreateStatic() {
+			static StaticSharedPtrBlock<decltype(BindOf(field))> block(field);
+			return block.Get();
+		}
+
+	private:
+		// Only for picking the bind type of a field in CreateStatic(), never defined.
+		template<typename TClass, typename T>
+		static _ReflectionFieldBind<TClass, T> BindOf(T TClass::* field);
 	};
 #pragma endregion
 
@@ -575,8 +918,16 @@ namespace Engine {
 			ReflectionMethod* getter, ReflectionMethod* setter,
 			Hint hint = Hint::Null, const String& hintText = String::GetEmpty()
 		);
+		/// @brief A property of a member field, see REFLECTION_FIELD().
+		ReflectionProperty(
+			const String& name,
+			SharedPtr<ReflectionFieldBind> field,
+			Hint hint = Hint::Null, const String& hintText = String::GetEmpty()
+		);
 
-		String GetName() const;
+		StringName GetName() const;
+		/// @brief The index in the properties of the class, -1 until the class is frozen.
+		int32 GetIndex() const;
 		Variant::Type GetType() const;
 
 		bool CanGet() const;
@@ -584,6 +935,10 @@ namespace Engine {
 		ResultCode Get(const Object* obj, Variant& result) const;
 		ResultCode Set(Object* obj, const Variant& value);
 
+		/// @brief nullptr unless the property is a member field.\n
+		/// Get() and Set() of a field go straight to the member, and PropertyBatch copies fields between objects without Variants.
+		ReflectionFieldBind* GetField() const;
+
 		ReflectionMethod* GetGetter() const;
 		void SetGetter(ReflectionMethod* method);
 		ReflectionMethod* GetSetter() const;
@@ -595,11 +950,15 @@ namespace Engine {
 		void SetHintText(const String& hintText);
 
 	private:
-		String name;
+		friend class ReflectionClass;
+
+		StringName name;
+		int32 index = -1;
 		Hint hint;
 		String hintText;
-		ReflectionMethod* getter;
-		ReflectionMethod* setter;
+		ReflectionMethod* getter = nullptr;
+		ReflectionMethod* setter = nullptr;
+		SharedPtr<ReflectionFieldBind> field;
 	};
 
 	class ReflectionSignal final {
@@ -618,14 +977,14 @@ namespace Engine {
 			Once = 0b0010
 		};
 
-		String GetName() const;
+		StringName GetName() const;
 		int32 GetArgumentCount() const;
 		ArgumentInfo GetArgument(int32 index) const;
 
 		ReflectionSignal(String name, std::initializer_list<ArgumentInfo> arguments);
 
 	private:
-		String name;
+		StringName name;
 		List<ArgumentInfo> arguments;
 	};
 }
\ No newline at end of file
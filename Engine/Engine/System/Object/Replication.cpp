@@ -0,0 +1,604 @@
+#include "Engine/System/Object/Replication.h"
+#include "Engine/System/Object/Object.h"
+#include "Engine/System/Object/ObjectRegistry.h"
+#include "Engine/System/Object/Reflection.h"
+#include "Engine/System/Stream.h"
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+
+namespace Engine {
+	namespace {
+		/// @brief Packs values of any bit count, low bits first.
+		struct BitWriter {
+			List<byte> data{};
+			uint64 pending = 0;
+			int32 pendingBits = 0;
+
+			void Write(uint64 value, int32 bits) {
+				if (bits > 32) {
+					Write(value & 0xFFFFFFFF, 32);
+					Write(value >> 32, bits - 32);
+					return;
+				}
+				pending |= (value & (((uint64)1 << bits) - 1)) << pendingBits;
+				pendingBits += bits;
+				while (pendingBits >= 8) {
+					data.Add((byte)pending);
+					pending >>= 8;
+					pendingBits -= 8;
+				}
+			}
+			void WriteBit(bool value) {
+				Write(value ? 1 : 0, 1);
+			}
+			/// @brief The count of significant bits first, so small values take few bits.
+			void WriteVarBits(uint64 value) {
+				int32 bits = (int32)std::bit_width(value);
+				Write((uint64)bits, 7);
+				Write(value, bits);
+			}
+			void Finish() {
+				if (pendingBits > 0) {
+					data.Add((byte)pending);
+					pending = 0;
+					pendingBits = 0;
+				}
+			}
+		};
+		/// @brief Reads what a BitWriter packed, every read past the end fails and marks the reader as failed.
+		struct BitReader {
+			const byte* data = nullptr;
+			int32 length = 0;
+			int32 position = 0;
+			uint64 pending = 0;
+			int32 pendingBits = 0;
+			bool failed = false;
+
+			uint64 Read(int32 bits) {
+				if (bits > 32) {
+					uint64 low = Read(32);
+					return low | (Read(bits - 32) << 32);
+				}
+				while (pendingBits < bits) {
+					if (position >= length) {
+						failed = true;
+						return 0;
+					}
+					pending |= (uint64)data[position] << pendingBits;
+					position += 1;
+					pendingBits += 8;
+				}
+				uint64 result = pending & (((uint64)1 << bits) - 1);
+				pending >>= bits;
+				pendingBits -= bits;
+				return result;
+			}
+			bool ReadBit() {
+				return Read(1) != 0;
+			}
+			uint64 ReadVarBits() {
+				int32 bits = (int32)Read(7);
+				if (bits > 64) {
+					failed = true;
+					return 0;
+				}
+				return Read(bits);
+			}
+		};
+
+		uint64 ZigZag(int64 value) {
+			return ((uint64)value << 1) ^ (uint64)(value >> 63);
+		}
+		int64 UnZigZag(uint64 value) {
+			return (int64)(value >> 1) ^ -(int64)(value & 1);
+		}
+
+		// Bits of the quantized levels, and quantized values never take more.
+		constexpr int32 MaxQuantizedBits = 32;
+		// Strings longer than this aren't worth replicating every change of, and bound what malformed data can make us allocate.
+		constexpr uint64 MaxStringLength = 0xFFFF;
+		constexpr uint32 NoBaseline = 0xFFFFFFFF;
+	}
+
+#pragma region Snapshot
+	uint32 Snapshot::GetSequence() const {
+		return sequence;
+	}
+	int32 Snapshot::GetObjectCount() const {
+		return networkIds.GetCount();
+	}
+	uint32 Snapshot::GetNetworkId(int32 index) const {
+		return networkIds.Get(index);
+	}
+#pragma endregion
+
+#pragma region SnapshotHistory
+	SnapshotHistory::SnapshotHistory(int32 capacity) :capacity(capacity), snapshots(capacity) {
+		ERR_ASSERT(capacity > 0, u8"capacity must be larger than 0.", this->capacity = DefaultCapacity);
+	}
+	void SnapshotHistory::Add(Snapshot&& snapshot) {
+		if (snapshots.GetCount() < capacity) {
+			snapshots.Add(Memory::Move(snapshot));
+		} else {
+			snapshots[next] = Memory::Move(snapshot);
+		}
+		next = (next + 1) % capacity;
+	}
+	const Snapshot* SnapshotHistory::Find(uint32 sequence) const {
+		for (const Snapshot& snapshot : snapshots) {
+			if (snapshot.GetSequence() == sequence) {
+				return &snapshot;
+			}
+		}
+		return nullptr;
+	}
+	const Snapshot* SnapshotHistory::GetLatest() const {
+		if (snapshots.GetCount() == 0) {
+			return nullptr;
+		}
+		return &snapshots[(next + capacity - 1) % capacity];
+	}
+	void SnapshotHistory::Clear() {
+		snapshots.Clear();
+		next = 0;
+	}
+#pragma endregion
+
+#pragma region Replicator
+	namespace {
+		/// @brief Parse "Min,Max,Step" of a NumberRange hint, the step is optional.
+		bool ParseRange(const String& text, double& minimum, double& maximum, double& step) {
+			const char* current = (const char*)text.GetRawArray();
+			char* next = nullptr;
+			minimum = std::strtod(current, &next);
+			if (next == current || *next != ',') {
+				return false;
+			}
+			current = next + 1;
+			maximum = std::strtod(current, &next);
+			if (next == current) {
+				return false;
+			}
+			if (*next == ',') {
+				current = next + 1;
+				double parsed = std::strtod(current, &next);
+				if (next != current) {
+					step = parsed;
+				}
+			}
+			return maximum > minimum && step > 0;
+		}
+	}
+
+	ResultCode Replicator::SetProperties(const ReflectionClass* reflectionClass, const StringName* names, int32 count) {
+		ERR_ASSERT(reflectionClass != nullptr, u8"reflectionClass cannot be nullptr.", return ResultCode::InvalidArgument);
+		for (const Schema& schema : schemas) {
+			if (schema.reflectionClass == reflectionClass) {
+				return ResultCode::AlreadyExists;
+			}
+		}
+
+		Schema schema{};
+		schema.reflectionClass = reflectionClass;
+		for (int32 i = 0; i < count; i += 1) {
+			ReflectionProperty* property = reflectionClass->GetProperty(names[i]);
+			if (property == nullptr) {
+				ERR_MSG(String::Format(STRING_LITERAL("Property {0}::{1} not found!"), reflectionClass->GetName(), names[i]).GetRawArray());
+				return ResultCode::NotFound;
+			}
+			Field field{};
+			field.property = property;
+			field.type = property->GetType();
+			switch (field.type) {
+				case Variant::Type::Bool:
+				case Variant::Type::String:
+					break;
+				case Variant::Type::Int64:
+				case Variant::Type::Double:
+				case Variant::Type::Vector2:
+				{
+					if (field.type == Variant::Type::Vector2) {
+						field.components = 2;
+					}
+					// Doubles without a step stay raw, integers step by 1.
+					double minimum = 0;
+					double maximum = 0;
+					double step = (field.type == Variant::Type::Int64 ? 1 : 0);
+					if (property->GetHint() == ReflectionProperty::Hint::NumberRange && ParseRange(property->GetHintText(), minimum, maximum, step)) {
+						double levels = std::floor((maximum - minimum) / step + 0.5);
+						int32 bits = (int32)std::bit_width((uint64)levels);
+						if (levels < 4294967296.0 && bits <= MaxQuantizedBits) {
+							field.quantized = true;
+							field.minimum = minimum;
+							field.step = step;
+							field.maxLevel = (uint64)levels;
+							field.bits = bits;
+						}
+					}
+					break;
+				}
+				default:
+					ERR_MSG(String::Format(STRING_LITERAL("Property {0}::{1} is of a type which can't be replicated."), reflectionClass->GetName(), names[i]).GetRawArray());
+					return ResultCode::NotSupported;
+			}
+			schema.wordCount += field.components;
+			schema.fields.Add(field);
+		}
+		schemas.Add(Memory::Move(schema));
+		return ResultCode::OK;
+	}
+	ResultCode Replicator::SetProperties(const ReflectionClass* reflectionClass, std::initializer_list<StringName> names) {
+		return SetProperties(reflectionClass, names.begin(), (int32)names.size());
+	}
+
+	int32 Replicator::FindSchema(const ReflectionClass* reflectionClass) const {
+		// The closest class with properties set.
+		for (const ReflectionClass* current = reflectionClass; current != nullptr; current = current->GetParent()) {
+			for (int32 i = 0; i < schemas.GetCount(); i += 1) {
+				if (schemas[i].reflectionClass == current) {
+					return i;
+				}
+			}
+		}
+		return -1;
+	}
+	int32 Replicator::FindEntry(uint32 networkId) const {
+		int32 low = 0;
+		int32 high = entries.GetCount();
+		while (low < high) {
+			int32 middle = low + (high - low) / 2;
+			if (entries[middle].networkId < networkId) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		if (low < entries.GetCount() && entries[low].networkId == networkId) {
+			return low;
+		}
+		return ~low;
+	}
+
+	ResultCode Replicator::Add(uint32 networkId, Object* object) {
+		ERR_ASSERT(object != nullptr, u8"object cannot be nullptr.", return ResultCode::InvalidArgument);
+		int32 index = FindEntry(networkId);
+		if (index >= 0) {
+			return ResultCode::AlreadyExists;
+		}
+		int32 schema = FindSchema(object->GetReflectionClass());
+		if (schema < 0) {
+			return ResultCode::NotSupported;
+		}
+		Entry entry{};
+		entry.networkId = networkId;
+		entry.instance = object->GetInstanceId();
+		entry.schema = schema;
+		entries.Insert(~index, entry);
+		return ResultCode::OK;
+	}
+	bool Replicator::Remove(uint32 networkId) {
+		int32 index = FindEntry(networkId);
+		if (index < 0) {
+			return false;
+		}
+		entries.RemoveAt(index);
+		return true;
+	}
+	int32 Replicator::GetCount() const {
+		return entries.GetCount();
+	}
+
+	void Replicator::Capture(uint32 sequence, Snapshot& result) const {
+		result.sequence = sequence;
+		result.networkIds.Clear();
+		result.offsets.Clear();
+		result.words.Clear();
+		result.strings.Clear();
+		result.offsets.Add(0);
+
+		Variant value{};
+		for (const Entry& entry : entries) {
+			const Object* object = ObjectRegistry::Get(entry.instance);
+			if (object == nullptr) {
+				continue;
+			}
+			result.networkIds.Add(entry.networkId);
+			for (const Field& field : schemas[entry.schema].fields) {
+				if (!field.property->CanGet() || field.property->Get(object, value) != ResultCode::OK) {
+					value.Clear();
+				}
+				auto quantize = [&field](double number) -> uint64 {
+					double level = std::floor((number - field.minimum) / field.step + 0.5);
+					if (!(level > 0)) {
+						return 0;
+					}
+					return level >= (double)field.maxLevel ? field.maxLevel : (uint64)level;
+				};
+				switch (field.type) {
+					case Variant::Type::Bool:
+						result.words.Add(value.AsBool() ? 1 : 0);
+						break;
+					case Variant::Type::Int64:
+						result.words.Add(field.quantized ? quantize((double)value.AsInt64()) : (uint64)value.AsInt64());
+						break;
+					case Variant::Type::Double:
+						result.words.Add(field.quantized ? quantize(value.AsDouble()) : std::bit_cast<uint64>(value.AsDouble()));
+						break;
+					case Variant::Type::Vector2:
+					{
+						Vector2 v = value.AsVector2();
+						result.words.Add(field.quantized ? quantize(v.x) : std::bit_cast<uint32>(v.x));
+						result.words.Add(field.quantized ? quantize(v.y) : std::bit_cast<uint32>(v.y));
+						break;
+					}
+					default:
+						result.words.Add((uint64)result.strings.GetCount());
+						result.strings.Add(value.AsString());
+						break;
+				}
+			}
+			result.offsets.Add(result.words.GetCount());
+		}
+	}
+
+	namespace {
+		// Per field, how a component is written: in full without a baseline, or as a change from it.
+		template<typename TField>
+		void WriteComponent(BitWriter& writer, const TField& field, uint64 current, const uint64* baseline) {
+			if (field.quantized || field.type == Variant::Type::Bool) {
+				writer.Write(current, field.type == Variant::Type::Bool ? 1 : field.bits);
+			} else if (field.type == Variant::Type::Int64) {
+				writer.WriteVarBits(ZigZag((int64)current - (baseline == nullptr ? 0 : (int64)*baseline)));
+			} else {
+				writer.Write(current, field.type == Variant::Type::Vector2 ? 32 : 64);
+			}
+		}
+		template<typename TField>
+		uint64 ReadComponent(BitReader& reader, const TField& field, const uint64* baseline) {
+			if (field.quantized || field.type == Variant::Type::Bool) {
+				uint64 value = reader.Read(field.type == Variant::Type::Bool ? 1 : field.bits);
+				if (field.type != Variant::Type::Bool && value > field.maxLevel) {
+					reader.failed = true;
+				}
+				return value;
+			} else if (field.type == Variant::Type::Int64) {
+				return (uint64)(UnZigZag(reader.ReadVarBits()) + (baseline == nullptr ? 0 : (int64)*baseline));
+			} else {
+				return reader.Read(field.type == Variant::Type::Vector2 ? 32 : 64);
+			}
+		}
+	}
+
+	ResultCode Replicator::WriteDelta(const Snapshot* baseline, const Snapshot& current, Stream* stream) const {
+		ERR_ASSERT(stream != nullptr && stream->CanWrite(), u8"stream is not writable.", return ResultCode::InvalidStream);
+		BitWriter writer{};
+		writer.Write(current.sequence, 32);
+		writer.Write(baseline == nullptr ? NoBaseline : baseline->sequence, 32);
+		writer.WriteVarBits((uint64)current.networkIds.GetCount());
+
+		// Both are sorted by network id, so the baseline of each object is found walking along.
+		int32 base = 0;
+		int32 baseCount = (baseline == nullptr ? 0 : baseline->networkIds.GetCount());
+		uint32 previousId = 0;
+		for (int32 i = 0; i < current.networkIds.GetCount(); i += 1) {
+			uint32 networkId = current.networkIds[i];
+			writer.WriteVarBits(networkId - previousId);
+			previousId = networkId;
+			int32 entry = FindEntry(networkId);
+			ERR_ASSERT(entry >= 0, u8"The snapshot has an object not added to this replicator.", return ResultCode::InvalidArgument);
+			const Schema& schema = schemas[entries[entry].schema];
+
+			while (base < baseCount && baseline->networkIds[base] < networkId) {
+				base += 1;
+			}
+			const uint64* from = current.words.GetRawElementPtr() + current.offsets[i];
+			const uint64* baseFrom = nullptr;
+			if (base < baseCount && baseline->networkIds[base] == networkId) {
+				baseFrom = baseline->words.GetRawElementPtr() + baseline->offsets[base];
+			}
+
+			// Which fields changed, all of them without a baseline.
+			bool anyChanged = (baseFrom == nullptr);
+			bool changed[64]{};
+			int32 word = 0;
+			for (int32 f = 0; f < schema.fields.GetCount(); f += 1) {
+				const Field& field = schema.fields[f];
+				bool fieldChanged = (baseFrom == nullptr);
+				if (!fieldChanged) {
+					if (field.type == Variant::Type::String) {
+						fieldChanged = current.strings[(int32)from[word]] != baseline->strings[(int32)baseFrom[word]];
+					} else {
+						for (int32 c = 0; c < field.components; c += 1) {
+							fieldChanged = fieldChanged || from[word + c] != baseFrom[word + c];
+						}
+					}
+				}
+				if (f < 64) {
+					changed[f] = fieldChanged;
+				}
+				anyChanged = anyChanged || fieldChanged;
+				word += field.components;
+			}
+
+			if (baseFrom != nullptr) {
+				writer.WriteBit(anyChanged);
+				if (!anyChanged) {
+					continue;
+				}
+			}
+			word = 0;
+			for (int32 f = 0; f < schema.fields.GetCount(); f += 1) {
+				const Field& field = schema.fields[f];
+				bool fieldChanged = (f < 64 ? changed[f] : true);
+				if (baseFrom != nullptr) {
+					writer.WriteBit(fieldChanged);
+				}
+				if (fieldChanged) {
+					if (field.type == Variant::Type::String) {
+						const String& text = current.strings[(int32)from[word]];
+						int32 length = (text.GetCount() < (int32)MaxStringLength ? text.GetCount() : (int32)MaxStringLength);
+						writer.WriteVarBits((uint64)length);
+						const byte* raw = (const byte*)text.GetRawArray();
+						for (int32 b = 0; b < length; b += 1) {
+							writer.Write(raw[b], 8);
+						}
+					} else {
+						for (int32 c = 0; c < field.components; c += 1) {
+							WriteComponent(writer, field, from[word + c], baseFrom == nullptr ? nullptr : baseFrom + word + c);
+						}
+					}
+				}
+				word += field.components;
+			}
+		}
+		writer.Finish();
+
+		ResultCode result = stream->WriteUInt32((uint32)writer.data.GetCount());
+		if (result != ResultCode::OK) {
+			return result;
+		}
+		return stream->WriteBytes(writer.data);
+	}
+
+	ResultCode Replicator::ReadDelta(const SnapshotHistory& history, Stream* stream, Snapshot& result) const {
+		ERR_ASSERT(stream != nullptr && stream->CanRead(), u8"stream is not readable.", return ResultCode::InvalidStream);
+		uint32 length = stream->ReadUInt32();
+		if (stream->CanRandomAccess() && (int64)length > stream->GetLength() - stream->GetPosition()) {
+			return ResultCode::InvalidStream;
+		}
+		List<byte> data{};
+		if (length > 0x7FFFFFFF || stream->ReadBytes((int32)length, data) != (int32)length) {
+			return ResultCode::InvalidStream;
+		}
+
+		BitReader reader{};
+		reader.data = data.GetRawElementPtr();
+		reader.length = data.GetCount();
+		uint32 sequence = (uint32)reader.Read(32);
+		uint32 baselineSequence = (uint32)reader.Read(32);
+		uint64 count = reader.ReadVarBits();
+		// Every object takes a byte at least.
+		if (reader.failed || count > (uint64)data.GetCount()) {
+			return ResultCode::InvalidStream;
+		}
+		const Snapshot* baseline = nullptr;
+		if (baselineSequence != NoBaseline) {
+			baseline = history.Find(baselineSequence);
+			if (baseline == nullptr) {
+				return ResultCode::NotFound;
+			}
+		}
+
+		Snapshot read{};
+		read.sequence = sequence;
+		read.offsets.Add(0);
+		int32 base = 0;
+		int32 baseCount = (baseline == nullptr ? 0 : baseline->networkIds.GetCount());
+		uint64 previousId = 0;
+		for (uint64 i = 0; i < count; i += 1) {
+			uint64 networkId = previousId + reader.ReadVarBits();
+			if (reader.failed || networkId > 0xFFFFFFFF || (i > 0 && networkId == previousId)) {
+				return ResultCode::InvalidStream;
+			}
+			previousId = networkId;
+			int32 entry = FindEntry((uint32)networkId);
+			if (entry < 0) {
+				return ResultCode::InvalidStream;
+			}
+			const Schema& schema = schemas[entries[entry].schema];
+			read.networkIds.Add((uint32)networkId);
+
+			while (base < baseCount && baseline->networkIds[base] < networkId) {
+				base += 1;
+			}
+			const uint64* baseFrom = nullptr;
+			if (base < baseCount && baseline->networkIds[base] == networkId) {
+				baseFrom = baseline->words.GetRawElementPtr() + baseline->offsets[base];
+				if (baseline->offsets[base + 1] - baseline->offsets[base] != schema.wordCount) {
+					return ResultCode::InvalidStream;
+				}
+			}
+			bool anyChanged = (baseFrom == nullptr || reader.ReadBit());
+
+			int32 word = 0;
+			for (const Field& field : schema.fields) {
+				bool fieldChanged = anyChanged && (baseFrom == nullptr || reader.ReadBit());
+				if (field.type == Variant::Type::String) {
+					read.words.Add((uint64)read.strings.GetCount());
+					if (!fieldChanged) {
+						read.strings.Add(baseline->strings[(int32)baseFrom[word]]);
+					} else {
+						uint64 textLength = reader.ReadVarBits();
+						if (textLength > MaxStringLength) {
+							return ResultCode::InvalidStream;
+						}
+						List<u8char> text((int32)textLength);
+						for (uint64 b = 0; b < textLength; b += 1) {
+							text.Add((u8char)reader.Read(8));
+						}
+						read.strings.Add(String(text.GetRawElementPtr(), text.GetCount()));
+					}
+				} else {
+					for (int32 c = 0; c < field.components; c += 1) {
+						const uint64* baseWord = (baseFrom == nullptr ? nullptr : baseFrom + word + c);
+						read.words.Add(fieldChanged ? ReadComponent(reader, field, baseWord) : *baseWord);
+					}
+				}
+				if (reader.failed) {
+					return ResultCode::InvalidStream;
+				}
+				word += field.components;
+			}
+			read.offsets.Add(read.words.GetCount());
+		}
+		result = Memory::Move(read);
+		return ResultCode::OK;
+	}
+
+	void Replicator::Apply(const Snapshot& snapshot) const {
+		Variant value{};
+		for (int32 i = 0; i < snapshot.networkIds.GetCount(); i += 1) {
+			int32 entry = FindEntry(snapshot.networkIds[i]);
+			if (entry < 0) {
+				continue;
+			}
+			Object* object = ObjectRegistry::Get(entries[entry].instance);
+			if (object == nullptr) {
+				continue;
+			}
+			const uint64* from = snapshot.words.GetRawElementPtr() + snapshot.offsets[i];
+			for (const Field& field : schemas[entries[entry].schema].fields) {
+				auto dequantize = [&field](uint64 level) -> double {
+					return field.minimum + (double)level * field.step;
+				};
+				switch (field.type) {
+					case Variant::Type::Bool:
+						value = Variant(from[0] != 0);
+						break;
+					case Variant::Type::Int64:
+						value = Variant(field.quantized ? (int64)std::llround(dequantize(from[0])) : (int64)from[0]);
+						break;
+					case Variant::Type::Double:
+						value = Variant(field.quantized ? dequantize(from[0]) : std::bit_cast<double>(from[0]));
+						break;
+					case Variant::Type::Vector2:
+						if (field.quantized) {
+							value = Variant(Vector2((float)dequantize(from[0]), (float)dequantize(from[1])));
+						} else {
+							value = Variant(Vector2(std::bit_cast<float>((uint32)from[0]), std::bit_cast<float>((uint32)from[1])));
+						}
+						break;
+					default:
+						value = Variant(snapshot.strings[(int32)from[0]]);
+						break;
+				}
+				if (field.property->CanSet()) {
+					field.property->Set(object, value);
+				}
+				from += field.components;
+			}
+		}
+	}
+#pragma endregion
+}
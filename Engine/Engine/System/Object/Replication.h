@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/String.h"
+#include "Engine/System/StringName.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Object/InstanceId.h"
+#include "Engine/System/Object/Variant.h"
+#include <initializer_list>
+
+namespace Engine {
+	class Object;
+	class Stream;
+	class ReflectionClass;
+	class ReflectionProperty;
+
+	/// @brief The replicated properties of the objects of a Replicator at one moment, packed as quantized integers.
+	class Snapshot final {
+	public:
+		uint32 GetSequence() const;
+		int32 GetObjectCount() const;
+		/// @brief The network id of the object at the index, increasing with the index.
+		uint32 GetNetworkId(int32 index) const;
+
+	private:
+		friend class Replicator;
+
+		uint32 sequence = 0;
+		List<uint32> networkIds{};
+		/// @brief Where the words of each object start, with one more entry ending the last object once any is captured.
+		List<int32> offsets{};
+		List<uint64> words{};
+		/// @brief The String values, the words hold their indices.
+		List<String> strings{};
+	};
+
+	/// @brief The latest snapshots, kept for diffing against the one a peer acknowledged last.
+	class SnapshotHistory final {
+	public:
+		static inline constexpr int32 DefaultCapacity = 32;
+
+		explicit SnapshotHistory(int32 capacity = DefaultCapacity);
+
+		/// @brief Keep the snapshot, dropping the oldest one once full.
+		void Add(Snapshot&& snapshot);
+		/// @return nullptr if it was never added or dropped already.
+		const Snapshot* Find(uint32 sequence) const;
+		const Snapshot* GetLatest() const;
+		void Clear();
+
+	private:
+		int32 capacity;
+		/// @brief A ring, next is where the next one goes.
+		List<Snapshot> snapshots{};
+		int32 next = 0;
+	};
+
+	/// @brief Replicates reflected properties of objects from one peer to others, as bit-packed deltas between snapshots.\n
+	/// Every peer adds the same objects under the same network ids, by instantiating the same scene for example. Only the values travel.\n
+	/// A class replicates the properties given to SetProperties(). A NumberRange hint, "Min,Max,Step", quantizes a number or both components of a Vector2
+	/// to the fewest bits holding the range at the step, the value clamped to the range. The step of an Int64 defaults to 1.
+	/// Other Int64 go as zigzag differences from the baseline, Double and Vector2 raw, Bool as a bit and String as UTF-8, each only when changed.
+	/// Properties of other types aren't replicated.\n
+	/// The sending peer captures a snapshot each tick into a SnapshotHistory, and writes each receiver the delta from the last snapshot it acknowledged,
+	/// or every value before the first acknowledgement. Receivers keep what they read in a history of their own to find the baselines.
+	class Replicator final {
+	public:
+		Replicator() = default;
+		Replicator(const Replicator&) = delete;
+		Replicator& operator=(const Replicator&) = delete;
+
+		/// @brief Replicate the properties of the class and of its children without properties of their own. Before adding objects of the class.
+		/// @return NotFound if a property doesn't exist, NotSupported if it can't be replicated, AlreadyExists if the class has its properties already.
+		ResultCode SetProperties(const ReflectionClass* reflectionClass, const StringName* names, int32 count);
+		ResultCode SetProperties(const ReflectionClass* reflectionClass, std::initializer_list<StringName> names);
+
+		/// @brief Replicate the object under the network id, the same on every peer.
+		/// @return AlreadyExists if the id is taken, NotSupported if neither the class nor a parent has its properties set.
+		ResultCode Add(uint32 networkId, Object* object);
+		bool Remove(uint32 networkId);
+		int32 GetCount() const;
+
+		/// @brief Read the replicated properties of the objects still alive.
+		void Capture(uint32 sequence, Snapshot& result) const;
+		/// @brief Write the changes from the baseline to the current snapshot, both captured by this replicator.
+		/// @param baseline nullptr for writing every value.
+		ResultCode WriteDelta(const Snapshot* baseline, const Snapshot& current, Stream* stream) const;
+		/// @brief Read a delta, finding the snapshot it was written against in the history.
+		/// @return NotFound if that snapshot isn't in the history, InvalidStream if the data is malformed or has an object not added here.
+		ResultCode ReadDelta(const SnapshotHistory& history, Stream* stream, Snapshot& result) const;
+		/// @brief Set the values of the snapshot on the objects still alive.
+		void Apply(const Snapshot& snapshot) const;
+
+	private:
+		struct Field {
+			ReflectionProperty* property = nullptr;
+			Variant::Type type = Variant::Type::Null;
+			/// @brief Words taken, 2 for a Vector2.
+			int32 components = 1;
+			bool quantized = false;
+			double minimum = 0;
+			double step = 1;
+			/// @brief Bits of a quantized component.
+			int32 bits = 0;
+			uint64 maxLevel = 0;
+		};
+		struct Schema {
+			const ReflectionClass* reflectionClass = nullptr;
+			List<Field> fields{};
+			int32 wordCount = 0;
+		};
+		struct Entry {
+			uint32 networkId = 0;
+			InstanceId instance{};
+			int32 schema = -1;
+		};
+
+		/// @return The index of the entry, or the bitwise complement of where it would go.
+		int32 FindEntry(uint32 networkId) const;
+		int32 FindSchema(const ReflectionClass* reflectionClass) const;
+
+		List<Schema> schemas{};
+		/// @brief Sorted by network id.
+		List<Entry> entries{};
+	};
+}
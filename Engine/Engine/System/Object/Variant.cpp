@@ -1,8 +1,176 @@
 #include "Engine/System/Object/Variant.h"
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/Object/ObjectRegistry.h"
 #include "Engine/System/Debug.h"
+#include "Engine/System/StringBuilder.h"
 
 namespace Engine {
+	namespace {
+		static_assert(sizeof(Vector2) == sizeof(float) * 2, "Vector2 elements are processed as pairs of floats.");
+
+		// The loops work on raw element pointers so the compiler can vectorize them.
+		template<typename T, typename TRight, typename F>
+		void ApplyElements(const T* a, const TRight* b, bool bIsArray, T* out, int32 count, const F& function) {
+			if (bIsArray) {
+				for (int32 i = 0; i < count; i += 1) {
+					out[i] = function(a[i], b[i]);
+				}
+			} else {
+				TRight value = *b;
+				for (int32 i = 0; i < count; i += 1) {
+					out[i] = function(a[i], value);
+				}
+			}
+		}
+		/// @brief Apply an arithmetic operator over count numbers, b is an array or a single value.\n
+		/// Integer divisors must have been checked for zeros already.
+		template<typename T>
+		bool ApplyArithmetic(Variant::Operator op, const T* a, const T* b, bool bIsArray, T* out, int32 count) {
+			using Operator = Variant::Operator;
+			switch (op) {
+				case Operator::Add:
+					ApplyElements(a, b, bIsArray, out, count, [](T x, T y) { return x + y; });
+					return true;
+				case Operator::Subtract:
+					ApplyElements(a, b, bIsArray, out, count, [](T x, T y) { return x - y; });
+					return true;
+				case Operator::Multiply:
+					ApplyElements(a, b, bIsArray, out, count, [](T x, T y) { return x * y; });
+					return true;
+				case Operator::Divide:
+					ApplyElements(a, b, bIsArray, out, count, [](T x, T y) { return x / y; });
+					return true;
+				case Operator::Mod:
+					if constexpr (std::is_integral_v<T>) {
+						ApplyElements(a, b, bIsArray, out, count, [](T x, T y) { return x % y; });
+						return true;
+					}
+					break;
+				default:
+					break;
+			}
+			return false;
+		}
+		template<typename T>
+		bool HasZeroDivisor(Variant::Operator op, const T* b, int32 count) {
+			if constexpr (std::is_integral_v<T>) {
+				if (op == Variant::Operator::Divide || op == Variant::Operator::Mod) {
+					for (int32 i = 0; i < count; i += 1) {
+						if (b[i] == 0) {
+							return true;
+						}
+					}
+				}
+			}
+			return false;
+		}
+		template<typename T>
+		bool IsBatchSupported(Variant::Operator op) {
+			using Operator = Variant::Operator;
+			return op == Operator::Add || op == Operator::Subtract || op == Operator::Multiply || op == Operator::Divide || (std::is_integral_v<T> && op == Operator::Mod);
+		}
+		/// @brief Take the storage out of result to write into, so it isn't shared anymore if nothing else holds it.
+		template<typename T>
+		PackedArray<T> TakeResultArray(Variant& result, int32 count) {
+			PackedArray<T> array = result.GetType() == Variant::GetTypeFromNative<PackedArray<T>>::type ? Variant::CastToNative<PackedArray<T>>::Cast(result) : PackedArray<T>();
+			result.Clear();
+			array.Resize(count);
+			return array;
+		}
+
+		/// @brief Two arrays of the same element type, element by element.
+		template<typename T>
+		bool EvaluateArrays(Variant::Operator op, const PackedArray<T>& a, const PackedArray<T>& b, Variant& result) {
+			if constexpr (std::is_same_v<T, Vector2>) {
+				// Vector2 by Vector2 is only added or subtracted.
+				if (op != Variant::Operator::Add && op != Variant::Operator::Subtract) {
+					return false;
+				}
+			} else if (!IsBatchSupported<T>(op)) {
+				return false;
+			}
+			ERR_ASSERT(a.GetCount() == b.GetCount(), u8"The arrays must have the same count.", return false);
+			int32 count = a.GetCount();
+			ERR_ASSERT(!HasZeroDivisor(op, b.GetData(), count), u8"Integer division by zero.", return false);
+
+			PackedArray<T> array = TakeResultArray<T>(result, count);
+			if (count > 0) {
+				if constexpr (std::is_same_v<T, Vector2>) {
+					ApplyArithmetic(op, (const float*)a.GetData(), (const float*)b.GetData(), true, (float*)array.GetDataForWrite(), count * 2);
+				} else {
+					ApplyArithmetic(op, a.GetData(), b.GetData(), true, array.GetDataForWrite(), count);
+				}
+			}
+			result = Variant(array);
+			return true;
+		}
+		/// @brief An array with a single value for every element.
+		template<typename T, typename TValue>
+		bool EvaluateArrayWithValue(Variant::Operator op, const PackedArray<T>& a, const TValue& value, Variant& result) {
+			using Operator = Variant::Operator;
+			int32 count = a.GetCount();
+			if constexpr (std::is_same_v<T, Vector2> && std::is_same_v<TValue, Vector2>) {
+				if (op != Operator::Add && op != Operator::Subtract) {
+					return false;
+				}
+				PackedArray<T> array = TakeResultArray<T>(result, count);
+				float pair[2] = { value.x, value.y };
+				const float* source = (const float*)a.GetData();
+				float* out = (float*)array.GetDataForWrite();
+				float sign = (op == Operator::Add ? 1.0f : -1.0f);
+				for (int32 i = 0; i < count * 2; i += 1) {
+					out[i] = source[i] + sign * pair[i & 1];
+				}
+				result = Variant(array);
+				return true;
+			} else if constexpr (std::is_same_v<T, Vector2>) {
+				// Scaled by a number.
+				if (op != Operator::Multiply && op != Operator::Divide) {
+					return false;
+				}
+				PackedArray<T> array = TakeResultArray<T>(result, count);
+				if (count > 0) {
+					ApplyArithmetic(op, (const float*)a.GetData(), &value, false, (float*)array.GetDataForWrite(), count * 2);
+				}
+				result = Variant(array);
+				return true;
+			} else {
+				if (!IsBatchSupported<T>(op)) {
+					return false;
+				}
+				T single = (T)value;
+				ERR_ASSERT(!HasZeroDivisor(op, &single, 1), u8"Integer division by zero.", return false);
+				PackedArray<T> array = TakeResultArray<T>(result, count);
+				if (count > 0) {
+					ApplyArithmetic(op, a.GetData(), &single, false, array.GetDataForWrite(), count);
+				}
+				result = Variant(array);
+				return true;
+			}
+		}
+
+		// Prints "[a, b, c]".
+		template<typename T>
+		String PackedArrayToString(const PackedArray<T>& array) {
+			StringBuilder builder;
+			builder.Append(u8'[');
+			for (int32 i = 0; i < array.GetCount(); i += 1) {
+				if (i > 0) {
+					builder.Append(u8", ");
+				}
+				if constexpr (std::is_same_v<T, Vector2>) {
+					builder.Append(array.Get(i).ToString());
+				} else if constexpr (std::is_same_v<T, byte>) {
+					builder.Append((int32)array.Get(i));
+				} else {
+					builder.Append(array.Get(i));
+				}
+			}
+			builder.Append(u8']');
+			return builder.ToString();
+		}
+	}
+
 	String Variant::GetTypeName(Type type) {
 		switch (type) {
 			case Type::Null:
@@ -18,9 +186,21 @@ namespace Engine {
 			case Type::String:
 				return STRING_LITERAL("String");
 
+			case Type::Vector2:
+				return STRING_LITERAL("Vector2");
+
 			case Type::Object:
 				return STRING_LITERAL("Object");
 
+			case Type::PackedByteArray:
+				return STRING_LITERAL("PackedByteArray");
+			case Type::PackedInt64Array:
+				return STRING_LITERAL("PackedInt64Array");
+			case Type::PackedFloat32Array:
+				return STRING_LITERAL("PackedFloat32Array");
+			case Type::PackedVector2Array:
+				return STRING_LITERAL("PackedVector2Array");
+
 			default:
 				return STRING_LITERAL("Undefined Type");
 		}
@@ -135,12 +315,20 @@ namespace Engine {
 		ConstructVector2(value);
 	}
 	Variant::Variant(Object* value) {
-		ConstructObject(ObjectData(value, (value != nullptr ? value->GetInstanceId() : InstanceId())));
+		ConstructObject(value);
 	}
 
-	template<Concept::IsEnum T>
-	Variant::Variant(T value) {
-		ConstructInt64((int64)value);
+	Variant::Variant(const PackedByteArray& value) {
+		ConstructBoxed(Type::PackedByteArray, value);
+	}
+	Variant::Variant(const PackedInt64Array& value) {
+		ConstructBoxed(Type::PackedInt64Array, value);
+	}
+	Variant::Variant(const PackedFloat32Array& value) {
+		ConstructBoxed(Type::PackedFloat32Array, value);
+	}
+	Variant::Variant(const PackedVector2Array& value) {
+		ConstructBoxed(Type::PackedVector2Array, value);
 	}
 #pragma endregion
 
@@ -166,6 +354,9 @@ namespace Engine {
 				return data.vInt64;
 			case Type::Double:
 				return static_cast<int64>(data.vDouble);
+			case Type::String:
+				ObjectUtil::FromChars(GetBoxed<String>().GetStringView(), defaultValue);
+				break;
 		}
 		return defaultValue;
 	}
@@ -177,6 +368,9 @@ namespace Engine {
 				return static_cast<double>(data.vInt64);
 			case Type::Double:
 				return data.vDouble;
+			case Type::String:
+				ObjectUtil::FromChars(GetBoxed<String>().GetStringView(), defaultValue);
+				break;
 		}
 		return defaultValue;
 	}
@@ -192,17 +386,28 @@ namespace Engine {
 			case Type::Double:
 				return ObjectUtil::ToString(data.vDouble);
 			case Type::String:
-				return data.vString;
+				return GetBoxed<String>();
 			case Type::Vector2:
 				return data.vVector2.ToString();
 			case Type::Object:
-				if (data.vObject.ptr == nullptr) {
+			{
+				if (!data.vObject.IsValid()) {
 					return STRING_LITERAL("[Nullptr]");
 				}
-				if(!Object::IsInstanceValid(data.vObject.id)){
+				Object* object = ObjectRegistry::Get(data.vObject);
+				if (object == nullptr) {
 					return STRING_LITERAL("[Released Object]");
 				}
-				return data.vObject.ptr->ToString();
+				return object->ToString();
+			}
+			case Type::PackedByteArray:
+				return PackedArrayToString(GetBoxed<PackedByteArray>());
+			case Type::PackedInt64Array:
+				return PackedArrayToString(GetBoxed<PackedInt64Array>());
+			case Type::PackedFloat32Array:
+				return PackedArrayToString(GetBoxed<PackedFloat32Array>());
+			case Type::PackedVector2Array:
+				return PackedArrayToString(GetBoxed<PackedVector2Array>());
 		}
 		return defaultValue;
 	}
@@ -216,10 +421,22 @@ namespace Engine {
 	Object* Variant::AsObject(Object* defaultValue) const {
 		switch (type) {
 			case Type::Object:
-				return data.vObject.ptr;
+				return ObjectRegistry::Get(data.vObject);
 		}
 		return defaultValue;
 	}
+	PackedByteArray Variant::AsPackedByteArray(const PackedByteArray& defaultValue) const {
+		return type == Type::PackedByteArray ? GetBoxed<PackedByteArray>() : defaultValue;
+	}
+	PackedInt64Array Variant::AsPackedInt64Array(const PackedInt64Array& defaultValue) const {
+		return type == Type::PackedInt64Array ? GetBoxed<PackedInt64Array>() : defaultValue;
+	}
+	PackedFloat32Array Variant::AsPackedFloat32Array(const PackedFloat32Array& defaultValue) const {
+		return type == Type::PackedFloat32Array ? GetBoxed<PackedFloat32Array>() : defaultValue;
+	}
+	PackedVector2Array Variant::AsPackedVector2Array(const PackedVector2Array& defaultValue) const {
+		return type == Type::PackedVector2Array ? GetBoxed<PackedVector2Array>() : defaultValue;
+	}
 #pragma endregion
 
 	String Variant::ToString() const {
@@ -252,22 +469,30 @@ namespace Engine {
 		// !! AddTypeHint 7.0: Add a entry to destruct the value.
 		switch (type) {
 			case Type::String:
-				Memory::Destruct(&data.vString);
+				ReleaseBoxed<String>(data.vBoxed);
 				break;
-
-			case Type::Vector2:
-				Memory::Destruct(&data.vVector2);
+			case Type::PackedByteArray:
+				ReleaseBoxed<PackedByteArray>(data.vBoxed);
+				break;
+			case Type::PackedInt64Array:
+				ReleaseBoxed<PackedInt64Array>(data.vBoxed);
+				break;
+			case Type::PackedFloat32Array:
+				ReleaseBoxed<PackedFloat32Array>(data.vBoxed);
+				break;
+			case Type::PackedVector2Array:
+				ReleaseBoxed<PackedVector2Array>(data.vBoxed);
 				break;
 
 			case Type::Object:
-				if (data.vObject.id.IsReferenced()) {
+				if (data.vObject.IsReferenced()) {
 					// Containing object is reference-counted. Do the dereferencing.
-					ReferencedObject* refObj = static_cast<ReferencedObject*>(data.vObject.ptr);
-					if (refObj->Dereference() == 0) {
+					// It can't be released while referenced here, so the lookup always finds it.
+					ReferencedObject* refObj = static_cast<ReferencedObject*>(ObjectRegistry::Get(data.vObject));
+					if (refObj != nullptr && refObj->Dereference() == 0) {
 						MEMDEL(refObj);
 					}
 				}
-				Memory::Destruct(&data.vObject);
 				break;
 		}
 
@@ -278,29 +503,27 @@ namespace Engine {
 		return type;
 	}
 
+	bool Variant::IsBoxed() const {
+		return type == Type::String || (type >= Type::PackedByteArray && type <= Type::PackedVector2Array);
+	}
+	bool Variant::IsReferenced() const {
+		return IsBoxed() || (type == Type::Object && data.vObject.IsReferenced());
+	}
 	void Variant::AssignValue(const Variant& obj) {
+		// !! AddTypeHint 6.0: Types not stored in the payload need their reference taken here.
 		type = obj.type;
+		data = obj.data;
+		if (!IsReferenced()) {
+			return;
+		}
 
-		// !! AddTypeHint 6.0: Add an entry to call the value constructor.
-		switch (type) {
-			case Type::Bool:
-				ConstructBool(obj.data.vBool);
-				break;
-			case Type::Int64:
-				ConstructInt64(obj.data.vInt64);
-				break;
-			case Type::Double:
-				ConstructDouble(obj.data.vDouble);
-				break;
-			case Type::String:
-				ConstructString(obj.data.vString);
-				break;
-			case Type::Vector2:
-				ConstructVector2(obj.data.vVector2);
-				break;
-			case Type::Object:
-				ConstructObject(obj.data.vObject);
-				break;
+		if (IsBoxed()) {
+			data.vBoxed->referenceCount.Reference();
+		} else {
+			ReferencedObject* refObj = static_cast<ReferencedObject*>(ObjectRegistry::Get(data.vObject));
+			if (refObj != nullptr) {
+				refObj->Reference();
+			}
 		}
 	}
 	Variant::Variant(const Variant& obj) {
@@ -317,6 +540,22 @@ namespace Engine {
 
 		return *this;
 	}
+	Variant::Variant(Variant&& obj) noexcept :data(obj.data), type(obj.type) {
+		obj.type = Type::Null;
+	}
+	Variant& Variant::operator=(Variant&& obj) noexcept {
+		if (&obj == this) {
+			return *this;
+		}
+
+		Clear();
+
+		type = obj.type;
+		data = obj.data;
+		obj.type = Type::Null;
+
+		return *this;
+	}
 
 #pragma region Value constructors
 	// !! AddTypeHint 3.1: Implement your value constructor.
@@ -334,43 +573,39 @@ namespace Engine {
 		data.vDouble = value;
 	}
 	void Variant::ConstructString(const String& value) {
-		type = Type::String;
-		Memory::Construct(&data.vString, value);
+		ConstructBoxed(Type::String, value);
 	}
 	void Variant::ConstructVector2(const Vector2& value) {
 		type = Type::Vector2;
-		Memory::Construct(&data.vVector2, value);
+		data.vVector2 = value;
 	}
-	void Variant::ConstructObject(const ObjectData& value) {
+	void Variant::ConstructObject(Object* value) {
 		type = Type::Object;
-		if (value.ptr != nullptr) {
-			if (value.id.IsReferenced()) {
-				// Containing object is reference-counted. Do the referencing.
-				ReferencedObject* refObj = static_cast<ReferencedObject*>(value.ptr);
-				refObj->Reference();
-			}
+		data.vObject = (value != nullptr ? value->GetInstanceId() : InstanceId());
+		if (data.vObject.IsReferenced()) {
+			// Containing object is reference-counted. Do the referencing.
+			static_cast<ReferencedObject*>(value)->Reference();
 		}
-		Memory::Construct(&data.vObject, value);
 	}
 #pragma endregion
 
-	Variant::ObjectData::ObjectData(Object* ptr, const InstanceId& id) :ptr(ptr), id(id) {}
-	Variant::DataUnion::DataUnion() {}
-	Variant::DataUnion::~DataUnion() {}
+	Variant::DataUnion::DataUnion() :vInt64(0) {}
 
 #pragma region Evaluating
 #pragma region Operators
 	bool Variant::operator==(const Variant& obj) const {
-		if (!CanEvaluateDirectly(Operator::Equal, type, obj.type)) {
+		Variant result;
+		if (!Evaluate(Operator::Equal, *this, obj, result)) {
 			return false;
 		}
-		return EvaluateDirectly(Operator::Equal, *this, obj).AsBool();
+		return result.AsBool();
 	}
 	bool Variant::operator!=(const Variant& obj) const {
-		if (!CanEvaluateDirectly(Operator::NotEqual, type, obj.type)) {
+		Variant result;
+		if (!Evaluate(Operator::NotEqual, *this, obj, result)) {
 			return true;
 		}
-		return EvaluateDirectly(Operator::NotEqual, *this, obj).AsBool();
+		return result.AsBool();
 	}
 	bool Variant::operator<(const Variant& obj) const {
 		return EvaluateDirectly(Operator::Less, *this, obj).AsBool();
@@ -441,12 +676,301 @@ namespace Engine {
 
 		return evaluatorTable[(sizeint)a][(sizeint)b][(sizeint)op] != nullptr;
 	}
+	bool Variant::CanEvaluate(Operator op, Type a, Type b) {
+		return CanEvaluateDirectly(op, a, b);
+	}
 	Variant Variant::EvaluateDirectly(Operator op, const Variant& a, const Variant& b) {
-		ERR_ASSERT(CanEvaluateDirectly(op, a.type, b.type), String::Format(u8"No evaluator registered for [{0}] with [{1}] and [{2}].", GetOperatorName(op), GetTypeName(a.type), GetTypeName(b.type)).GetRawArray(), return Variant());
+		Variant result;
+		bool succeeded = Evaluate(op, a, b, result);
+		ERR_ASSERT(succeeded, String::Format(u8"No evaluator registered for [{0}] with [{1}] and [{2}].", GetOperatorName(op), GetTypeName(a.type), GetTypeName(b.type)).GetRawArray(), return Variant());
+		return result;
+	}
+	Variant Variant::Evaluate(Operator op, const Variant& a, const Variant& b) {
+		return EvaluateDirectly(op, a, b);
+	}
+	bool Variant::Evaluate(Operator op, const Variant& a, const Variant& b, Variant& result) {
+		FastResult fast = EvaluateFast(op, a, b, result);
+		if (fast != FastResult::NotHandled) {
+			return fast == FastResult::Done;
+		}
+
+		if (op < Operator::End && a.type < Type::End && b.type < Type::End) {
+			Evaluator ev = evaluatorTable[(sizeint)a.type][(sizeint)b.type][(sizeint)op];
+			if (ev != nullptr) {
+				result = ev(a, b);
+				return true;
+			}
+		}
+		result.Clear();
+		return false;
+	}
+
+	template<typename T>
+	Variant::FastResult Variant::EvaluateArithmetic(Operator op, T a, T b, Variant& result) {
+		switch (op) {
+			case Operator::Add:
+				result = a + b;
+				return FastResult::Done;
+			case Operator::Subtract:
+				result = a - b;
+				return FastResult::Done;
+			case Operator::Multiply:
+				result = a * b;
+				return FastResult::Done;
+			case Operator::Divide:
+				if constexpr (std::is_integral_v<T>) {
+					ERR_ASSERT(b != 0, u8"Integer division by zero.", result.Clear(); return FastResult::Failed);
+				}
+				result = a / b;
+				return FastResult::Done;
+			case Operator::Mod:
+				if constexpr (std::is_integral_v<T>) {
+					ERR_ASSERT(b != 0, u8"Integer division by zero.", result.Clear(); return FastResult::Failed);
+					result = a % b;
+					return FastResult::Done;
+				}
+				break;
+			default:
+				break;
+		}
+		return FastResult::NotHandled;
+	}
+	template<typename T>
+	Variant::FastResult Variant::EvaluateComparison(Operator op, T a, T b, Variant& result) {
+		switch (op) {
+			case Operator::Equal:
+				result = (a == b);
+				return FastResult::Done;
+			case Operator::NotEqual:
+				result = (a != b);
+				return FastResult::Done;
+			case Operator::Less:
+				result = (a < b);
+				return FastResult::Done;
+			case Operator::LessEqual:
+				result = (a <= b);
+				return FastResult::Done;
+			case Operator::Greater:
+				result = (a > b);
+				return FastResult::Done;
+			case Operator::GreaterEqual:
+				result = (a >= b);
+				return FastResult::Done;
+			default:
+				break;
+		}
+		return FastResult::NotHandled;
+	}
+	Variant::FastResult Variant::EvaluateBitwise(Operator op, int64 a, int64 b, Variant& result) {
+		switch (op) {
+			case Operator::BitAnd:
+				result = a & b;
+				return FastResult::Done;
+			case Operator::BitOr:
+				result = a | b;
+				return FastResult::Done;
+			case Operator::BitXOr:
+				result = a ^ b;
+				return FastResult::Done;
+			case Operator::BitShiftLeft:
+				result = a << b;
+				return FastResult::Done;
+			case Operator::BitShiftRight:
+				result = a >> b;
+				return FastResult::Done;
+			default:
+				break;
+		}
+		return FastResult::NotHandled;
+	}
+	template<typename TA, typename TB>
+	Variant::FastResult Variant::EvaluateScale(Operator op, const TA& a, const TB& b, Variant& result) {
+		switch (op) {
+			case Operator::Multiply:
+				result = a * b;
+				return FastResult::Done;
+			case Operator::Divide:
+				result = a / b;
+				return FastResult::Done;
+			default:
+				break;
+		}
+		return FastResult::NotHandled;
+	}
+
+	Variant::FastResult Variant::EvaluateFast(Operator op, const Variant& a, const Variant& b, Variant& result) {
+		// Only the operand pairs the evaluator table registers are handled, so both ways give the same results.
+		switch (a.type) {
+			case Type::Int64:
+				switch (b.type) {
+					case Type::Int64:
+					{
+						FastResult arithmetic = EvaluateArithmetic(op, a.data.vInt64, b.data.vInt64, result);
+						if (arithmetic != FastResult::NotHandled) {
+							return arithmetic;
+						}
+						FastResult comparison = EvaluateComparison(op, a.data.vInt64, b.data.vInt64, result);
+						if (comparison != FastResult::NotHandled) {
+							return comparison;
+						}
+						return EvaluateBitwise(op, a.data.vInt64, b.data.vInt64, result);
+					}
+					case Type::Double:
+						return EvaluateArithmetic(op, (double)a.data.vInt64, b.data.vDouble, result);
+					case Type::Null:
+					{
+						int64 value = a.data.vInt64;
+						switch (op) {
+							case Operator::Positive:
+								result = +value;
+								return FastResult::Done;
+							case Operator::Negative:
+								result = -value;
+								return FastResult::Done;
+							case Operator::BitFlip:
+								result = ~value;
+								return FastResult::Done;
+							default:
+								break;
+						}
+						break;
+					}
+					case Type::Vector2:
+						return EvaluateScale(op, (float)a.data.vInt64, b.data.vVector2, result);
+					default:
+						break;
+				}
+				break;
 
-		Evaluator ev = evaluatorTable[(sizeint)a.type][(sizeint)b.type][(sizeint)op];
+			case Type::Double:
+				switch (b.type) {
+					case Type::Double:
+					{
+						FastResult arithmetic = EvaluateArithmetic(op, a.data.vDouble, b.data.vDouble, result);
+						if (arithmetic != FastResult::NotHandled) {
+							return arithmetic;
+						}
+						return EvaluateComparison(op, a.data.vDouble, b.data.vDouble, result);
+					}
+					case Type::Int64:
+						return EvaluateArithmetic(op, a.data.vDouble, (double)b.data.vInt64, result);
+					case Type::Null:
+					{
+						double value = a.data.vDouble;
+						switch (op) {
+							case Operator::Positive:
+								result = +value;
+								return FastResult::Done;
+							case Operator::Negative:
+								result = -value;
+								return FastResult::Done;
+							default:
+								break;
+						}
+						break;
+					}
+					case Type::Vector2:
+						return EvaluateScale(op, (float)a.data.vDouble, b.data.vVector2, result);
+					default:
+						break;
+				}
+				break;
+
+			case Type::Vector2:
+			{
+				Vector2 value = a.data.vVector2;
+				switch (b.type) {
+					case Type::Vector2:
+					{
+						Vector2 other = b.data.vVector2;
+						switch (op) {
+							case Operator::Add:
+								result = value + other;
+								return FastResult::Done;
+							case Operator::Subtract:
+								result = value - other;
+								return FastResult::Done;
+							case Operator::Equal:
+								result = (value == other);
+								return FastResult::Done;
+							case Operator::NotEqual:
+								result = (value != other);
+								return FastResult::Done;
+							default:
+								break;
+						}
+						break;
+					}
+					case Type::Int64:
+						return EvaluateScale(op, value, (float)b.data.vInt64, result);
+					case Type::Double:
+						return EvaluateScale(op, value, (float)b.data.vDouble, result);
+					case Type::Null:
+						switch (op) {
+							case Operator::Positive:
+								result = +value;
+								return FastResult::Done;
+							case Operator::Negative:
+								result = -value;
+								return FastResult::Done;
+							default:
+								break;
+						}
+						break;
+					default:
+						break;
+				}
+				break;
+			}
+			default:
+				break;
+		}
+		return FastResult::NotHandled;
+	}
 
-		return ev(a, b);
+	bool Variant::EvaluateBatch(Operator op, const Variant& a, const Variant& b, Variant& result) {
+		// Take the operands first, result may be one of them.
+		switch (a.type) {
+			case Type::PackedInt64Array:
+			{
+				PackedInt64Array left = a.AsPackedInt64Array();
+				if (b.type == Type::PackedInt64Array) {
+					return EvaluateArrays(op, left, b.AsPackedInt64Array(), result);
+				}
+				if (b.type == Type::Int64) {
+					return EvaluateArrayWithValue(op, left, b.data.vInt64, result);
+				}
+				break;
+			}
+			case Type::PackedFloat32Array:
+			{
+				PackedFloat32Array left = a.AsPackedFloat32Array();
+				if (b.type == Type::PackedFloat32Array) {
+					return EvaluateArrays(op, left, b.AsPackedFloat32Array(), result);
+				}
+				if (b.type == Type::Int64 || b.type == Type::Double) {
+					return EvaluateArrayWithValue(op, left, (float)b.AsDouble(), result);
+				}
+				break;
+			}
+			case Type::PackedVector2Array:
+			{
+				PackedVector2Array left = a.AsPackedVector2Array();
+				if (b.type == Type::PackedVector2Array) {
+					return EvaluateArrays(op, left, b.AsPackedVector2Array(), result);
+				}
+				if (b.type == Type::Vector2) {
+					return EvaluateArrayWithValue(op, left, b.data.vVector2, result);
+				}
+				if (b.type == Type::Int64 || b.type == Type::Double) {
+					return EvaluateArrayWithValue(op, left, (float)b.AsDouble(), result);
+				}
+				break;
+			}
+			default:
+				break;
+		}
+		return false;
 	}
 
 	Variant::Evaluator Variant::evaluatorTable[(sizeint)Type::End][(sizeint)Type::End][(sizeint)Operator::End]{};
@@ -473,12 +997,19 @@ namespace Engine {
 		VARIANT_EVALUATOR(Int64, Int64, Add) { return a.AsInt64() + b.AsInt64(); };
 		VARIANT_EVALUATOR(Int64, Int64, Subtract) { return a.AsInt64() - b.AsInt64(); };
 		VARIANT_EVALUATOR(Int64, Int64, Multiply) { return a.AsInt64() * b.AsInt64(); };
-		VARIANT_EVALUATOR(Int64, Int64, Divide) { return a.AsInt64() / b.AsInt64(); };
+		VARIANT_EVALUATOR(Int64, Int64, Divide) {
+			// Same as EvaluateArithmetic(), which handles the pair first.
+			ERR_ASSERT(b.AsInt64() != 0, u8"Integer division by zero.", return Variant());
+			return a.AsInt64() / b.AsInt64();
+		};
 		VARIANT_EVALUATOR(Int64, Double, Add) { return a.AsInt64() + b.AsDouble(); };
 		VARIANT_EVALUATOR(Int64, Double, Subtract) { return a.AsInt64() - b.AsDouble(); };
 		VARIANT_EVALUATOR(Int64, Double, Multiply) { return a.AsInt64() * b.AsDouble(); };
 		VARIANT_EVALUATOR(Int64, Double, Divide) { return a.AsInt64() / b.AsDouble(); };
-		VARIANT_EVALUATOR(Int64, Int64, Mod) { return a.AsInt64() % b.AsInt64(); };
+		VARIANT_EVALUATOR(Int64, Int64, Mod) {
+			ERR_ASSERT(b.AsInt64() != 0, u8"Integer division by zero.", return Variant());
+			return a.AsInt64() % b.AsInt64();
+		};
 		VARIANT_EVALUATOR(Int64, Null, Positive) { return +(a.AsInt64()); };
 		VARIANT_EVALUATOR(Int64, Null, Negative) { return -(a.AsInt64()); };
 
@@ -534,6 +1065,17 @@ namespace Engine {
 		VARIANT_EVALUATOR(Object, Object, NotEqual) { return a.AsObject() != b.AsObject(); };
 #pragma endregion
 
+#pragma region Packed arrays
+		VARIANT_EVALUATOR(PackedByteArray, PackedByteArray, Equal) { return a.GetBoxed<PackedByteArray>() == b.GetBoxed<PackedByteArray>(); };
+		VARIANT_EVALUATOR(PackedByteArray, PackedByteArray, NotEqual) { return a.GetBoxed<PackedByteArray>() != b.GetBoxed<PackedByteArray>(); };
+		VARIANT_EVALUATOR(PackedInt64Array, PackedInt64Array, Equal) { return a.GetBoxed<PackedInt64Array>() == b.GetBoxed<PackedInt64Array>(); };
+		VARIANT_EVALUATOR(PackedInt64Array, PackedInt64Array, NotEqual) { return a.GetBoxed<PackedInt64Array>() != b.GetBoxed<PackedInt64Array>(); };
+		VARIANT_EVALUATOR(PackedFloat32Array, PackedFloat32Array, Equal) { return a.GetBoxed<PackedFloat32Array>() == b.GetBoxed<PackedFloat32Array>(); };
+		VARIANT_EVALUATOR(PackedFloat32Array, PackedFloat32Array, NotEqual) { return a.GetBoxed<PackedFloat32Array>() != b.GetBoxed<PackedFloat32Array>(); };
+		VARIANT_EVALUATOR(PackedVector2Array, PackedVector2Array, Equal) { return a.GetBoxed<PackedVector2Array>() == b.GetBoxed<PackedVector2Array>(); };
+		VARIANT_EVALUATOR(PackedVector2Array, PackedVector2Array, NotEqual) { return a.GetBoxed<PackedVector2Array>() != b.GetBoxed<PackedVector2Array>(); };
+#pragma endregion
+
 #pragma region Vector2
 		VARIANT_EVALUATOR(Vector2, Vector2, Equal) { return a.AsVector2() == b.AsVector2(); };
 		VARIANT_EVALUATOR(Vector2, Vector2, NotEqual) { return a.AsVector2() != b.AsVector2(); };
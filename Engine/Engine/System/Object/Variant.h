@@ -2,7 +2,9 @@
 
 #include "Engine/System/Definition.h"
 #include "Engine/System/String.h"
+#include "Engine/System/Thread/Atomic.h"
 #include "Engine/System/Object/InstanceId.h"
+#include "Engine/System/Object/PackedArray.h"
 #include "Engine/System/Math/Vector.h"
 #include "Engine/System/Concept.h"
 #include <type_traits>
@@ -10,6 +12,11 @@
 namespace Engine {
 	class Object;
 
+	/// @brief A dynamically typed value, used by reflection calls, properties and signal arguments.\n
+	/// A Variant is 16 bytes: an 8-byte payload and the type.
+	/// Null, Bool, Int64, Double and Vector2 live in the payload and copy as plain bytes.\n
+	/// Only Strings, packed arrays and ReferencedObjects take the slow path on copies. Strings and packed arrays are boxed in a shared reference counted block
+	/// and an Object is kept by its InstanceId, so a released ManualObject reads as nullptr instead of dangling.
 	class Variant final {
 	public:
 		// !! AddTypeHint 0.0: To add a new type, search for "AddTypeHint" for the guide.
@@ -32,6 +39,11 @@ namespace Engine {
 
 			Object,		// ManualObject or ReferencedObject
 
+			PackedByteArray,
+			PackedInt64Array,
+			PackedFloat32Array,
+			PackedVector2Array,
+
 			End,		// Marks the end
 		};
 
@@ -101,9 +113,16 @@ namespace Engine {
 		Variant(const Vector2& value);
 		Variant(const u8char* value);
 		Variant(Object* value);
+		Variant(const PackedByteArray& value);
+		Variant(const PackedInt64Array& value);
+		Variant(const PackedFloat32Array& value);
+		Variant(const PackedVector2Array& value);
 
+		/// @brief Stored as Int64. Defined here, every enum reaching it instantiates its own.
 		template<Concept::IsEnum T>
-		Variant(T value);
+		Variant(T value) {
+			ConstructInt64((int64)value);
+		}
 
 #pragma endregion
 
@@ -111,11 +130,18 @@ namespace Engine {
 		// !! AddTypeHint 5.0: Add a AsType function for getting the original value.
 
 		bool AsBool(bool defaultValue=false) const;
+		/// @brief Strings are parsed with ObjectUtil::FromChars(), defaultValue if they aren't a number.
 		int64 AsInt64(int64 defaultValue = 0) const;
+		/// @brief Strings are parsed with ObjectUtil::FromChars(), defaultValue if they aren't a number.
 		double AsDouble(double defaultValue = 0) const;
 		String AsString(String defaultValue = u8"") const;
 		Vector2 AsVector2(const Vector2& defaultValue = Vector2()) const;
 		Object* AsObject(Object* defaultValue = nullptr) const;
+		// Packed arrays are returned sharing the storage, no element is copied.
+		PackedByteArray AsPackedByteArray(const PackedByteArray& defaultValue = PackedByteArray()) const;
+		PackedInt64Array AsPackedInt64Array(const PackedInt64Array& defaultValue = PackedInt64Array()) const;
+		PackedFloat32Array AsPackedFloat32Array(const PackedFloat32Array& defaultValue = PackedFloat32Array()) const;
+		PackedVector2Array AsPackedVector2Array(const PackedVector2Array& defaultValue = PackedVector2Array()) const;
 #pragma endregion
 
 		static bool CanConvertImplicitly(Type from, Type to);
@@ -124,6 +150,9 @@ namespace Engine {
 
 		Variant(const Variant& obj);
 		Variant& operator=(const Variant& obj);
+		/// @brief Takes the value over, obj becomes Null. No reference count is touched.
+		Variant(Variant&& obj) noexcept;
+		Variant& operator=(Variant&& obj) noexcept;
 
 #pragma region Operators
 		bool operator==(const Variant& obj) const;
@@ -161,12 +190,57 @@ namespace Engine {
 		static Variant EvaluateDirectly(Operator op, const Variant& a, const Variant& b);
 		// Evaluate operand a and b with operator directly, without type formatting.
 		static Variant Evaluate(Operator op, const Variant& a, const Variant& b);
+		/// @brief Evaluate into result instead of returning a new Variant, result may be a or b.\n
+		/// Int64, Double and Vector2 operands are computed in place without going through the evaluator table.
+		/// Integer Divide and Mod by zero print an error and fail instead of crashing.
+		/// @return false without an error message if there's no evaluator for the operand types, result is Null then.
+		static bool Evaluate(Operator op, const Variant& a, const Variant& b, Variant& result);
+		/// @brief Evaluate every element of a packed array in one call.\n
+		/// a is a PackedInt64Array, PackedFloat32Array or PackedVector2Array, b is either an array of the same type and count or a single value applied to every element.
+		/// The result is an array of the type of a, reusing the array storage of result when it isn't shared.\n
+		/// Supports Add, Subtract, Multiply and Divide, and Mod for Int64 elements. Vector2 elements are multiplied and divided by numbers only.
+		/// @return false if the operator or the operands aren't supported, result is left untouched then.
+		static bool EvaluateBatch(Operator op, const Variant& a, const Variant& b, Variant& result);
 	private:
-		struct ObjectData {
-			ObjectData(Object* ptr, const InstanceId& id);
-			Object* ptr;
-			InstanceId id;
+		enum class FastResult :byte {
+			NotHandled,
+			Done,
+			Failed,
+		};
+		static FastResult EvaluateFast(Operator op, const Variant& a, const Variant& b, Variant& result);
+		// Defined and only used in Variant.cpp.
+		template<typename T>
+		static FastResult EvaluateArithmetic(Operator op, T a, T b, Variant& result);
+		template<typename T>
+		static FastResult EvaluateComparison(Operator op, T a, T b, Variant& result);
+		static FastResult EvaluateBitwise(Operator op, int64 a, int64 b, Variant& result);
+		template<typename TA, typename TB>
+		static FastResult EvaluateScale(Operator op, const TA& a, const TB& b, Variant& result);
+
+		/// @brief A value too big for the payload, shared between copies of a Variant.
+		struct BoxedBase {
+			ReferenceCount referenceCount{ 1 };
+		};
+		template<typename T>
+		struct BoxedData :BoxedBase {
+			BoxedData(const T& value) :value(value) {}
+			T value;
 		};
+		template<typename T>
+		const T& GetBoxed() const {
+			return static_cast<BoxedData<T>*>(data.vBoxed)->value;
+		}
+		template<typename T>
+		static void ReleaseBoxed(BoxedBase* boxed) {
+			if (boxed->referenceCount.Dereference() == 0) {
+				MEMDEL(static_cast<BoxedData<T>*>(boxed));
+			}
+		}
+		template<typename T>
+		void ConstructBoxed(Type type, const T& value) {
+			this->type = type;
+			data.vBoxed = MEMNEW(BoxedData<T>)(value);
+		}
 
 #pragma region Union
 		// !! AddTypeHint 2.0: Add an entry in DataUnion.
@@ -175,12 +249,13 @@ namespace Engine {
 			bool vBool;
 			int64 vInt64;
 			double vDouble;
-			String vString;
 			Vector2 vVector2;
-			ObjectData vObject;
+			// String and packed arrays.
+			BoxedBase* vBoxed;
+			InstanceId vObject;
 			DataUnion();
-			~DataUnion();
 		};
+		static_assert(sizeof(DataUnion) == 8, "The payload of a Variant must stay 8 bytes.");
 #pragma endregion
 
 #pragma region Value constructor
@@ -190,14 +265,18 @@ namespace Engine {
 		void ConstructInt64(int64 value);
 		void ConstructDouble(double value);
 		void ConstructString(const String& value);
-		void ConstructObject(const ObjectData& value);
+		void ConstructObject(Object* value);
 		void ConstructVector2(const Vector2& value);
 #pragma endregion
 
 		DataUnion data;
 		Type type = Type::Null;
 
+		/// @brief Copy the payload and take a reference for the types that need one. The Variant must be Null.
 		void AssignValue(const Variant& obj);
+		/// @brief If the value needs a reference taken on copies.
+		bool IsReferenced() const;
+		bool IsBoxed() const;
 
 
 		typedef Variant(*Evaluator)(const Variant& a, const Variant& b);
@@ -215,6 +294,7 @@ namespace Engine {
 		};
 		inline static Initializer _initializer{};
 	};
+	static_assert(sizeof(Variant) == 16, "Variant must stay 16 bytes.");
 
 
 #pragma region GetTypeFromNative
@@ -273,6 +353,23 @@ namespace Engine {
 		static const Type type = Type::Vector2;
 	};
 
+	template<>
+	struct Variant::GetTypeFromNative<PackedByteArray> {
+		static const Type type = Type::PackedByteArray;
+	};
+	template<>
+	struct Variant::GetTypeFromNative<PackedInt64Array> {
+		static const Type type = Type::PackedInt64Array;
+	};
+	template<>
+	struct Variant::GetTypeFromNative<PackedFloat32Array> {
+		static const Type type = Type::PackedFloat32Array;
+	};
+	template<>
+	struct Variant::GetTypeFromNative<PackedVector2Array> {
+		static const Type type = Type::PackedVector2Array;
+	};
+
 	template<Concept::IsObject T>
 	struct Variant::GetTypeFromNative<T*> {
 		static const Type type = Type::Object;
@@ -356,6 +453,18 @@ namespace Engine {
 		}
 	};
 	template<>
+	struct Variant::CastToNative<float> {
+		static float Cast(const Variant& obj) {
+			return (float)obj.AsDouble();
+		}
+	};
+	template<>
+	struct Variant::CastToNative<double> {
+		static double Cast(const Variant& obj) {
+			return obj.AsDouble();
+		}
+	};
+	template<>
 	struct Variant::CastToNative<String> {
 		static String Cast(const Variant& obj) {
 			return obj.AsString();
@@ -379,6 +488,54 @@ namespace Engine {
 			return obj.AsVector2();
 		}
 	};
+	template<>
+	struct Variant::CastToNative<PackedByteArray> {
+		static PackedByteArray Cast(const Variant& obj) {
+			return obj.AsPackedByteArray();
+		}
+	};
+	template<>
+	struct Variant::CastToNative<const PackedByteArray&> {
+		static PackedByteArray Cast(const Variant& obj) {
+			return obj.AsPackedByteArray();
+		}
+	};
+	template<>
+	struct Variant::CastToNative<PackedInt64Array> {
+		static PackedInt64Array Cast(const Variant& obj) {
+			return obj.AsPackedInt64Array();
+		}
+	};
+	template<>
+	struct Variant::CastToNative<const PackedInt64Array&> {
+		static PackedInt64Array Cast(const Variant& obj) {
+			return obj.AsPackedInt64Array();
+		}
+	};
+	template<>
+	struct Variant::CastToNative<PackedFloat32Array> {
+		static PackedFloat32Array Cast(const Variant& obj) {
+			return obj.AsPackedFloat32Array();
+		}
+	};
+	template<>
+	struct Variant::CastToNative<const PackedFloat32Array&> {
+		static PackedFloat32Array Cast(const Variant& obj) {
+			return obj.AsPackedFloat32Array();
+		}
+	};
+	template<>
+	struct Variant::CastToNative<PackedVector2Array> {
+		static PackedVector2Array Cast(const Variant& obj) {
+			return obj.AsPackedVector2Array();
+		}
+	};
+	template<>
+	struct Variant::CastToNative<const PackedVector2Array&> {
+		static PackedVector2Array Cast(const Variant& obj) {
+			return obj.AsPackedVector2Array();
+		}
+	};
 	template<Concept::IsObject T>
 	struct Variant::CastToNative<T*> {
 		static T* Cast(const Variant& obj) {
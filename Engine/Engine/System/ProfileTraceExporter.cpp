@@ -0,0 +1,107 @@
+#include "Engine/System/ProfileTraceExporter.h"
+#include "Engine/System/Stream.h"
+#include "Engine/System/File/FileSystem.h"
+#include "Engine/System/File/FileStream.h"
+
+namespace Engine {
+	namespace {
+		const char* GetCategory(ProfileEventKind kind) {
+			// Every kind has its case, so a new one shows up as a -Wswitch warning instead of a generic category.
+			switch (kind) {
+				case ProfileEventKind::Zone:
+					return "zone";
+				case ProfileEventKind::Job:
+					return "job";
+				case ProfileEventKind::LockWait:
+					return "lock";
+				case ProfileEventKind::LockHold:
+					return "lock_hold";
+			}
+			return "zone";
+		}
+
+		void AppendJsonString(StringBuilder& result, std::string_view text) {
+			result.Append(u8'"');
+			for (char c : text) {
+				if (c == '"' || c == '\\') {
+					result.Append(u8'\\');
+					result.Append((u8char)c);
+				} else if ((unsigned char)c < 0x20) {
+					result.AppendFormat(STRL("\\u{:04x}"), (int32)(unsigned char)c);
+				} else {
+					result.Append((u8char)c);
+				}
+			}
+			result.Append(u8'"');
+		}
+
+		void AppendMicroseconds(StringBuilder& result, uint64 nanoseconds) {
+			// Exact to the nanosecond, without going through floating point.
+			result.AppendFormat(STRL("{}.{:03}"), nanoseconds / 1000, nanoseconds % 1000);
+		}
+	}
+
+	void ProfileTraceExporter::WriteChromeTrace(const ProfileCapture& capture, StringBuilder& result) {
+		result.Append(u8"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+		bool first = true;
+		auto separate = [&result, &first]() {
+			if (!first) {
+				result.Append(u8",\n");
+			} else {
+				result.Append(u8'\n');
+			}
+			first = false;
+		};
+
+		for (int32 i = 0; i < capture.threads.GetCount(); i += 1) {
+			const ProfileCaptureThread& thread = capture.threads[i];
+			if (thread.name.GetCount() == 0) {
+				continue;
+			}
+			separate();
+			result.AppendFormat(STRL("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":"), thread.id);
+			AppendJsonString(result, thread.name.GetStringView());
+			result.Append(u8"}}");
+		}
+
+		for (int32 i = 0; i < capture.events.GetCount(); i += 1) {
+			const ProfileCaptureEvent& event = capture.events[i];
+			// Zones that began before the capture are clipped to it.
+			uint64 begin = event.beginNanoseconds < capture.beginNanoseconds ? capture.beginNanoseconds : event.beginNanoseconds;
+			uint64 end = event.endNanoseconds < begin ? begin : event.endNanoseconds;
+
+			separate();
+			result.Append(u8"{\"name\":");
+			AppendJsonString(result, event.name);
+			result.AppendFormat(STRL(",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":"), GetCategory(event.kind), event.thread);
+			AppendMicroseconds(result, begin - capture.beginNanoseconds);
+			result.Append(u8",\"dur\":");
+			AppendMicroseconds(result, end - begin);
+			result.Append(u8'}');
+		}
+
+		result.AppendFormat(STRL("\n],\"otherData\":{{\"droppedEvents\":{}}}}}\n"), capture.droppedEvents);
+	}
+
+	ResultCode ProfileTraceExporter::WriteChromeTrace(const ProfileCapture& capture, Stream* stream) {
+		ERR_ASSERT(stream != nullptr, u8"stream must not be null.", return ResultCode::InvalidArgument);
+		ERR_ASSERT(stream->CanWrite(), u8"stream must be writable.", return ResultCode::InvalidStream);
+
+		StringBuilder builder(4096);
+		WriteChromeTrace(capture, builder);
+		std::string_view text = builder.GetStringView();
+		return stream->WriteBytes((const byte*)text.data(), (int32)text.size());
+	}
+
+	ResultCode ProfileTraceExporter::ExportChromeTrace(const ProfileCapture& capture, FileSystem* fileSystem, const String& path) {
+		ERR_ASSERT(fileSystem != nullptr, u8"fileSystem must not be null.", return ResultCode::InvalidArgument);
+
+		auto opened = fileSystem->OpenFile(path, FileStream::OpenMode::WriteTruncate);
+		if (opened.result != ResultCode::OK) {
+			return opened.result;
+		}
+		ResultCode result = WriteChromeTrace(capture, opened.value.GetRaw());
+		opened.value->Close();
+		return result;
+	}
+}
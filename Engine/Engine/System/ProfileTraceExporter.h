@@ -0,0 +1,22 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Profiler.h"
+#include "Engine/System/StringBuilder.h"
+
+namespace Engine {
+	class Stream;
+	class FileSystem;
+
+	/// @brief Writes profiler captures as Chrome Trace Event JSON, which chrome://tracing and the Perfetto UI both open.\n
+	/// Zones become complete events on the timeline of their thread, named threads get their names as metadata.\n
+	/// The categories are "zone", "job", "lock" and "lock_hold", after ProfileEventKind.
+	class ProfileTraceExporter final {
+		STATIC_CLASS(ProfileTraceExporter);
+	public:
+		/// @brief Format the capture as JSON. Timestamps are microseconds since the capture began.
+		static void WriteChromeTrace(const ProfileCapture& capture, StringBuilder& result);
+		static ResultCode WriteChromeTrace(const ProfileCapture& capture, Stream* stream);
+		/// @brief Write the capture into a file through the FileSystem, replacing the file if it exists.
+		static ResultCode ExportChromeTrace(const ProfileCapture& capture, FileSystem* fileSystem, const String& path);
+	};
+}
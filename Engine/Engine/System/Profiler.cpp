@@ -0,0 +1,304 @@
+#include "Engine/System/Profiler.h"
+#include "Engine/System/Collection/SpscRing.h"
+#include <cstring>
+#include <mutex>
+
+namespace Engine {
+	namespace {
+		struct ProfileEvent {
+			const char* name = nullptr;
+			uint64 begin = 0;
+			uint64 end = 0;
+			ProfileEventKind kind = ProfileEventKind::Zone;
+		};
+
+		struct ThreadBuffer;
+		struct ProfilerData {
+			std::mutex mutex;
+			List<ThreadBuffer*> buffers{};
+			int32 nextThreadId = 0;
+			// Left behind by threads that exited since the last collection.
+			List<ProfileCaptureEvent> orphanedEvents{};
+			int32 orphanedDropped = 0;
+
+			ProfileFrame lastFrame{};
+			uint64 frameCount = 0;
+			uint64 frameBegin = 0;
+
+			ProfileCapture capture{};
+			bool capturing = false;
+		};
+		ProfilerData& GetData() {
+			static ProfilerData data{};
+			return data;
+		}
+
+		void AddCaptureThread(ProfilerData& data, int32 id, const String& name) {
+			if (data.capture.FindThread(id) != nullptr) {
+				return;
+			}
+			ProfileCaptureThread thread;
+			thread.id = id;
+			thread.name = name;
+			data.capture.threads.Add(thread);
+		}
+
+		/// @brief The events of one thread, the thread produces and the collection consumes.
+		struct ThreadBuffer {
+			ThreadBuffer() {
+				ProfilerData& data = GetData();
+				std::lock_guard<std::mutex> lock(data.mutex);
+				id = data.nextThreadId;
+				data.nextThreadId += 1;
+				data.buffers.Add(this);
+			}
+			~ThreadBuffer() {
+				ProfilerData& data = GetData();
+				std::lock_guard<std::mutex> lock(data.mutex);
+				ProfileEvent event;
+				while (events.Pop(event)) {
+					ProfileCaptureEvent orphan;
+					orphan.name = event.name;
+					orphan.beginNanoseconds = event.begin;
+					orphan.endNanoseconds = event.end;
+					orphan.thread = id;
+					orphan.kind = event.kind;
+					data.orphanedEvents.Add(orphan);
+				}
+				data.orphanedDropped += dropped.load(std::memory_order_relaxed);
+				if (data.capturing) {
+					// The name is gone after this.
+					AddCaptureThread(data, id, name);
+				}
+				for (int32 i = 0; i < data.buffers.GetCount(); i += 1) {
+					if (data.buffers[i] == this) {
+						data.buffers.RemoveAt(i);
+						break;
+					}
+				}
+			}
+
+			SpscRing<ProfileEvent> events{ Profiler::ThreadBufferCapacity };
+			std::atomic<int32> dropped{ 0 };
+			int32 id = -1;
+			// Guarded by the mutex of ProfilerData.
+			String name{};
+		};
+		ThreadBuffer& GetThreadBuffer() {
+			thread_local ThreadBuffer buffer{};
+			return buffer;
+		}
+
+		ProfileZoneStats& GetZone(List<ProfileZoneStats>& zones, const char* name) {
+			// Only a few dozen zones finish in a frame, and most share the pointer of the literal.
+			for (int32 i = 0; i < zones.GetCount(); i += 1) {
+				ProfileZoneStats& zone = zones[i];
+				if (zone.name == name || std::strcmp(zone.name, name) == 0) {
+					return zone;
+				}
+			}
+			ProfileZoneStats zone;
+			zone.name = name;
+			zones.Add(zone);
+			return zones[zones.GetCount() - 1];
+		}
+
+		ProfileLockStats& GetLock(List<ProfileLockStats>& locks, const char* name) {
+			for (int32 i = 0; i < locks.GetCount(); i += 1) {
+				ProfileLockStats& lock = locks[i];
+				if (lock.name == name || std::strcmp(lock.name, name) == 0) {
+					return lock;
+				}
+			}
+			ProfileLockStats lock;
+			lock.name = name;
+			locks.Add(lock);
+			return locks[locks.GetCount() - 1];
+		}
+
+		void AddLockEvent(ProfileFrame& frame, const ProfileCaptureEvent& event, uint64 duration) {
+			ProfileLockStats& lock = GetLock(frame.locks, event.name);
+			if (event.kind == ProfileEventKind::LockWait) {
+				lock.contentions += 1;
+				lock.waitNanoseconds += duration;
+				if (duration > lock.maxWaitNanoseconds) {
+					lock.maxWaitNanoseconds = duration;
+				}
+			} else {
+				lock.acquisitions += 1;
+				lock.holdNanoseconds += duration;
+				if (duration > lock.maxHoldNanoseconds) {
+					lock.maxHoldNanoseconds = duration;
+				}
+			}
+		}
+
+		void AddEvent(ProfilerData& data, ProfileFrame* frame, const ProfileCaptureEvent& event) {
+			if (frame != nullptr && event.kind == ProfileEventKind::LockHold) {
+				AddLockEvent(*frame, event, event.endNanoseconds - event.beginNanoseconds);
+			} else if (frame != nullptr) {
+				uint64 duration = event.endNanoseconds - event.beginNanoseconds;
+				if (event.kind == ProfileEventKind::LockWait) {
+					AddLockEvent(*frame, event, duration);
+				}
+				ProfileZoneStats& zone = GetZone(frame->zones, event.name);
+				zone.totalNanoseconds += duration;
+				if (duration > zone.maxNanoseconds) {
+					zone.maxNanoseconds = duration;
+				}
+				zone.count += 1;
+			}
+			if (data.capturing) {
+				if (data.capture.events.GetCount() < Profiler::MaxCaptureEvents) {
+					data.capture.events.Add(event);
+				} else {
+					data.capture.droppedEvents += 1;
+				}
+			}
+		}
+
+		/// @brief Empty every thread buffer into the frame if given, and into the capture if capturing.
+		void Collect(ProfilerData& data, ProfileFrame* frame) {
+			int32 dropped = 0;
+			ProfileEvent events[64];
+			std::lock_guard<std::mutex> lock(data.mutex);
+			for (int32 i = 0; i < data.buffers.GetCount(); i += 1) {
+				ThreadBuffer* buffer = data.buffers[i];
+				int32 count;
+				while ((count = buffer->events.PopBatch(events, 64)) > 0) {
+					for (int32 j = 0; j < count; j += 1) {
+						ProfileCaptureEvent event;
+						event.name = events[j].name;
+						event.beginNanoseconds = events[j].begin;
+						event.endNanoseconds = events[j].end;
+						event.thread = buffer->id;
+						event.kind = events[j].kind;
+						AddEvent(data, frame, event);
+					}
+					if (data.capturing) {
+						AddCaptureThread(data, buffer->id, buffer->name);
+					}
+				}
+				dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+			}
+			for (int32 i = 0; i < data.orphanedEvents.GetCount(); i += 1) {
+				AddEvent(data, frame, data.orphanedEvents[i]);
+			}
+			dropped += data.orphanedDropped;
+			data.orphanedEvents.Clear();
+			data.orphanedDropped = 0;
+
+			if (frame != nullptr) {
+				frame->droppedEvents += dropped;
+			}
+			if (data.capturing) {
+				data.capture.droppedEvents += dropped;
+			}
+		}
+	}
+
+	uint64 ProfileFrame::GetDurationNanoseconds() const {
+		return endNanoseconds - beginNanoseconds;
+	}
+	const ProfileZoneStats* ProfileFrame::FindZone(const char* name) const {
+		for (int32 i = 0; i < zones.GetCount(); i += 1) {
+			const ProfileZoneStats& zone = zones[i];
+			if (zone.name == name || std::strcmp(zone.name, name) == 0) {
+				return &zone;
+			}
+		}
+		return nullptr;
+	}
+	const ProfileLockStats* ProfileFrame::FindLock(const char* name) const {
+		for (int32 i = 0; i < locks.GetCount(); i += 1) {
+			const ProfileLockStats& lock = locks[i];
+			if (lock.name == name || std::strcmp(lock.name, name) == 0) {
+				return &lock;
+			}
+		}
+		return nullptr;
+	}
+
+	const ProfileCaptureThread* ProfileCapture::FindThread(int32 id) const {
+		for (int32 i = 0; i < threads.GetCount(); i += 1) {
+			if (threads[i].id == id) {
+				return &threads[i];
+			}
+		}
+		return nullptr;
+	}
+
+	void Profiler::SetEnabled(bool enabled) {
+		Profiler::enabled.store(enabled, std::memory_order_relaxed);
+	}
+	void Profiler::SetLockTracking(bool tracking) {
+		Profiler::lockTracking.store(tracking, std::memory_order_relaxed);
+	}
+	void Profiler::BeginFrame() {
+		GetData().frameBegin = GetTimestamp();
+	}
+	void Profiler::EndFrame() {
+		ProfilerData& data = GetData();
+		ProfileFrame& frame = data.lastFrame;
+		frame.index = data.frameCount;
+		frame.beginNanoseconds = data.frameBegin;
+		frame.endNanoseconds = GetTimestamp();
+		frame.zones.Clear();
+		frame.locks.Clear();
+		frame.droppedEvents = 0;
+		data.frameCount += 1;
+
+		Collect(data, &frame);
+	}
+	const ProfileFrame& Profiler::GetLastFrame() {
+		return GetData().lastFrame;
+	}
+
+	void Profiler::BeginCapture() {
+		ProfilerData& data = GetData();
+		std::lock_guard<std::mutex> lock(data.mutex);
+		data.capture = ProfileCapture();
+		data.capture.beginNanoseconds = GetTimestamp();
+		data.capturing = true;
+	}
+	void Profiler::EndCapture() {
+		ProfilerData& data = GetData();
+		Collect(data, nullptr);
+		std::lock_guard<std::mutex> lock(data.mutex);
+		data.capture.endNanoseconds = GetTimestamp();
+		data.capturing = false;
+	}
+	bool Profiler::IsCapturing() {
+		ProfilerData& data = GetData();
+		std::lock_guard<std::mutex> lock(data.mutex);
+		return data.capturing;
+	}
+	const ProfileCapture& Profiler::GetCapture() {
+		return GetData().capture;
+	}
+
+	void Profiler::SetCurrentThreadName(const String& name) {
+		ThreadBuffer& buffer = GetThreadBuffer();
+		ProfilerData& data = GetData();
+		std::lock_guard<std::mutex> lock(data.mutex);
+		buffer.name = name;
+		// Renamed during a capture.
+		for (int32 i = 0; i < data.capture.threads.GetCount(); i += 1) {
+			if (data.capture.threads[i].id == buffer.id) {
+				data.capture.threads[i].name = name;
+			}
+		}
+	}
+
+	void Profiler::Record(const char* name, uint64 begin, uint64 end, ProfileEventKind kind) {
+		ThreadBuffer& buffer = GetThreadBuffer();
+		ProfileEvent event;
+		event.name = name;
+		event.begin = begin;
+		event.end = end;
+		event.kind = kind;
+		if (!buffer.events.Push(event)) {
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
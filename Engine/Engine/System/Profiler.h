@@ -0,0 +1,221 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/String.h"
+#include "Engine/System/Clock.h"
+#include "Engine/System/Collection/List.h"
+#include <atomic>
+
+#define PROFILE_ENABLED true
+
+#define _PROFILE_CONCAT_INNER(a,b) a##b
+#define _PROFILE_CONCAT(a,b) _PROFILE_CONCAT_INNER(a,b)
+
+#if(PROFILE_ENABLED)
+/// @brief Time the rest of the enclosing scope as a zone.
+/// @param name Stored as it is, needs to live as long as the program, like a string literal.
+#define PROFILE_SCOPE(name) ::Engine::ProfileScope _PROFILE_CONCAT(_profileScope,__LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) do {} while (false)
+#endif
+
+namespace Engine {
+	enum class ProfileEventKind :byte {
+		Zone,
+		/// @brief A job running on a worker.
+		Job,
+		/// @brief Time spent blocked on a lock, see ProfiledLock.
+		LockWait,
+		/// @brief Time a lock was held, only recorded while Profiler::IsLockTracking().
+		LockHold
+	};
+
+	/// @brief Time spent in a zone during a frame, summed over every thread.
+	struct ProfileZoneStats {
+		const char* name = nullptr;
+		/// @brief Summed time of every call, nested calls of the same zone are counted again.
+		uint64 totalNanoseconds = 0;
+		uint64 maxNanoseconds = 0;
+		int32 count = 0;
+	};
+
+	/// @brief Contention of a lock during a frame, summed over every thread, see ProfiledLock.
+	struct ProfileLockStats {
+		const char* name = nullptr;
+		/// @brief Times the lock was taken, only counted while Profiler::IsLockTracking().
+		int32 acquisitions = 0;
+		/// @brief Times a thread had to wait for the lock.
+		int32 contentions = 0;
+		uint64 waitNanoseconds = 0;
+		uint64 maxWaitNanoseconds = 0;
+		/// @brief Only measured while Profiler::IsLockTracking().
+		uint64 holdNanoseconds = 0;
+		uint64 maxHoldNanoseconds = 0;
+	};
+
+	/// @brief Aggregated zones of a single frame.
+	struct ProfileFrame {
+		uint64 index = 0;
+		uint64 beginNanoseconds = 0;
+		uint64 endNanoseconds = 0;
+		/// @brief In the order they first finished during the frame. Lock waits count as zones of the name of the lock, holds don't.
+		List<ProfileZoneStats> zones{};
+		/// @brief In the order they were first waited for or released during the frame.
+		List<ProfileLockStats> locks{};
+		/// @brief Events lost because a thread recorded more than its buffer holds in a frame.
+		int32 droppedEvents = 0;
+
+		uint64 GetDurationNanoseconds() const;
+		/// @brief Zones are compared by name. nullptr if the zone didn't finish during the frame.
+		const ProfileZoneStats* FindZone(const char* name) const;
+		/// @brief Locks are compared by name. nullptr if the lock wasn't waited for nor released, when tracking, during the frame.
+		const ProfileLockStats* FindLock(const char* name) const;
+	};
+
+	/// @brief A single finished zone kept by a capture.
+	struct ProfileCaptureEvent {
+		const char* name = nullptr;
+		uint64 beginNanoseconds = 0;
+		uint64 endNanoseconds = 0;
+		/// @brief See ProfileCaptureThread::id.
+		int32 thread = -1;
+		ProfileEventKind kind = ProfileEventKind::Zone;
+	};
+	struct ProfileCaptureThread {
+		/// @brief Given in the order threads first recorded a zone, stays the same for the lifetime of the thread.
+		int32 id = -1;
+		/// @brief Set by Profiler::SetCurrentThreadName(), empty otherwise.
+		String name{};
+	};
+	/// @brief Every zone finished between Profiler::BeginCapture() and Profiler::EndCapture(), for exporting timelines.
+	struct ProfileCapture {
+		uint64 beginNanoseconds = 0;
+		uint64 endNanoseconds = 0;
+		/// @brief In the order they were collected, the events of a thread stay in the order they finished.
+		List<ProfileCaptureEvent> events{};
+		List<ProfileCaptureThread> threads{};
+		/// @brief Events lost to full thread buffers, or past Profiler::MaxCaptureEvents.
+		int32 droppedEvents = 0;
+
+		/// @brief nullptr if the thread didn't record anything during the capture.
+		const ProfileCaptureThread* FindThread(int32 id) const;
+	};
+
+	/// @brief A low overhead frame profiler.\n
+	/// Each thread records finished zones into a buffer of its own without locking, EndFrame() collects the buffers into per-frame aggregates.\n
+	/// Zones are attributed to the frame in which they finish.
+	class Profiler final {
+		STATIC_CLASS(Profiler);
+	public:
+		/// @brief Events each thread can record between two collections.
+		static inline constexpr int32 ThreadBufferCapacity = 4096;
+		static inline constexpr int32 MaxCaptureEvents = 1 << 20;
+
+		/// @brief Disabled by default, zones cost a single check then.
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled() {
+			return enabled.load(std::memory_order_relaxed);
+		}
+		/// @brief Have every ProfiledLock record how long it was held too, as a ProfileEventKind::LockHold zone, besides the waits.\n
+		/// Off by default since it reads the clock twice and records an event at every acquisition, contended or not; uncontended locks would fill the buffers otherwise.
+		/// Only takes effect while enabled.
+		static void SetLockTracking(bool tracking);
+		static bool IsLockTracking() {
+			return lockTracking.load(std::memory_order_relaxed) && IsEnabled();
+		}
+
+		/// @brief Monotonic nanoseconds, see Clock::GetNanoseconds().
+		static uint64 GetTimestamp() {
+			return Clock::GetNanoseconds();
+		}
+
+		static void BeginFrame();
+		/// @brief Collect every zone finished since BeginFrame() into the last frame.
+		static void EndFrame();
+		/// @brief The last frame finished by EndFrame(). Only valid on the thread calling EndFrame(), until the next EndFrame().
+		static const ProfileFrame& GetLastFrame();
+
+		/// @brief Keep every zone collected from now on, besides aggregating them. The previous capture is dropped.
+		static void BeginCapture();
+		/// @brief Collect the zones still pending into the capture and stop capturing.\n
+		/// Zones collected here don't count into a frame.
+		static void EndCapture();
+		static bool IsCapturing();
+		/// @brief The last capture. Only valid while not capturing.
+		static const ProfileCapture& GetCapture();
+
+		/// @brief Name the current thread in captures.
+		static void SetCurrentThreadName(const String& name);
+
+		/// @brief Record a finished zone on the current thread.
+		static void Record(const char* name, uint64 begin, uint64 end, ProfileEventKind kind = ProfileEventKind::Zone);
+
+	private:
+		inline static std::atomic<bool> enabled{ false };
+		inline static std::atomic<bool> lockTracking{ false };
+	};
+
+	/// @brief Records the time between its construction and destruction as a zone, see PROFILE_SCOPE().
+	class ProfileScope final {
+	public:
+		ProfileScope(const char* name, ProfileEventKind kind = ProfileEventKind::Zone) :name(name), kind(kind) {
+			if (Profiler::IsEnabled()) {
+				begin = Profiler::GetTimestamp();
+			}
+		}
+		~ProfileScope() {
+			if (begin != 0) {
+				Profiler::Record(name, begin, Profiler::GetTimestamp(), kind);
+			}
+		}
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+	private:
+		const char* name;
+		uint64 begin = 0;
+		ProfileEventKind kind;
+	};
+
+	/// @brief Locks a mutex like SimpleLock, recording the time blocked as a ProfileEventKind::LockWait zone.\n
+	/// Nothing is recorded when the lock is taken right away, unless Profiler::IsLockTracking() which records the time held as well.
+	/// Both end up in ProfileFrame::locks by the name given.
+	template<typename T>
+	class ProfiledLock final {
+	public:
+		/// @param name Stored as it is, needs to live as long as the program, like a string literal.
+		ProfiledLock(T& mutex, const char* name) :mutex(mutex), name(name) {
+			if (mutex.try_lock()) {
+				if (Profiler::IsLockTracking()) {
+					acquired = Profiler::GetTimestamp();
+				}
+				return;
+			}
+			if (!Profiler::IsEnabled()) {
+				mutex.lock();
+				return;
+			}
+			uint64 begin = Profiler::GetTimestamp();
+			mutex.lock();
+			uint64 end = Profiler::GetTimestamp();
+			Profiler::Record(name, begin, end, ProfileEventKind::LockWait);
+			if (Profiler::IsLockTracking()) {
+				acquired = end;
+			}
+		}
+		~ProfiledLock() {
+			if (acquired == 0) {
+				mutex.unlock();
+				return;
+			}
+			uint64 released = Profiler::GetTimestamp();
+			mutex.unlock();
+			// Recorded after unlocking, to not hold the lock any longer.
+			Profiler::Record(name, acquired, released, ProfileEventKind::LockHold);
+		}
+		ProfiledLock(const ProfiledLock&) = delete;
+		ProfiledLock& operator=(const ProfiledLock&) = delete;
+	private:
+		T& mutex;
+		const char* name;
+		uint64 acquired = 0;
+	};
+}
@@ -1,4 +1,6 @@
 #include "Engine/System/Regex.h"
+#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Collection/Sorting.h"
 
 namespace Engine {
 	Regex::MatchRange::MatchRange() :from(-1), to(-1) {}
@@ -54,32 +56,749 @@ namespace Engine {
 		return ResultCode::OK;
 	}
 
+	namespace {
+		struct RegexCache {
+			Mutex mutex{};
+			/// @brief The least recently used first.
+			List<SharedPtr<CompiledRegex>> entries{};
+			int32 capacity = Regex::DefaultCacheCapacity;
+		};
+		RegexCache& GetRegexCache() {
+			static RegexCache cache{};
+			return cache;
+		}
+	}
+
 	ResultCode Regex::Match(const String& content, const String& pattern, List<Regex::MatchRange>& results) {
-		// Construct regex expression
-		std::regex expression;
-		ResultCode expressionResult = CreateRegex(pattern, expression);
-		ERR_ASSERT(expressionResult == ResultCode::OK, u8"Failed to construct regex expression.", return expressionResult);
+		auto compiled = GetCompiled(pattern);
+		ERR_ASSERT(compiled->GetResult() == ResultCode::OK, u8"Failed to construct regex expression.", return compiled->GetResult());
+		return compiled->Match(content, results);
+	}
+	bool Regex::IsMatch(const String& content, const String& pattern) {
+		auto compiled = GetCompiled(pattern);
+		ERR_ASSERT(compiled->GetResult() == ResultCode::OK, u8"Failed to construct regex expression.", return false);
+		return compiled->IsMatch(content);
+	}
+	SharedPtr<CompiledRegex> Regex::GetCompiled(const String& pattern) {
+		RegexCache& cache = GetRegexCache();
+		{
+			SimpleLock<Mutex> lock(cache.mutex);
+			for (int32 i = cache.entries.GetCount() - 1; i >= 0; i -= 1) {
+				if (cache.entries[i]->GetPattern() == pattern) {
+					SharedPtr<CompiledRegex> result = cache.entries[i];
+					cache.entries.RemoveAt(i);
+					cache.entries.Add(result);
+					return result;
+				}
+			}
+		}
+
+		// Compile outside the lock, another thread may add the same pattern meanwhile, the later one wins.
+		auto result = SharedPtr<CompiledRegex>::Create(pattern);
+		SimpleLock<Mutex> lock(cache.mutex);
+		if (cache.capacity > 0) {
+			if (cache.entries.GetCount() >= cache.capacity) {
+				cache.entries.RemoveAt(0);
+			}
+			cache.entries.Add(result);
+		}
+		return result;
+	}
+	void Regex::SetCacheCapacity(int32 capacity) {
+		ERR_ASSERT(capacity >= 0, u8"capacity cannot be negative.", return);
+		RegexCache& cache = GetRegexCache();
+		SimpleLock<Mutex> lock(cache.mutex);
+		cache.capacity = capacity;
+		while (cache.entries.GetCount() > capacity) {
+			cache.entries.RemoveAt(0);
+		}
+	}
+	int32 Regex::GetCacheCapacity() {
+		RegexCache& cache = GetRegexCache();
+		SimpleLock<Mutex> lock(cache.mutex);
+		return cache.capacity;
+	}
+
+	struct CompiledRegex::Automaton {
+		static inline constexpr int32 MaxNodes = 4096;
+		/// @brief The cache of DFA states is cleared when it gets that big, a state takes about 1 KB.
+		static inline constexpr int32 MaxStates = 1024;
+
+		/// @brief The bytes a node consumes, a bit each.
+		struct ByteSet {
+			uint64 bits[4] = {};
+
+			void Add(int32 value) {
+				bits[value >> 6] |= 1ull << (value & 63);
+			}
+			void AddRange(int32 from, int32 to) {
+				for (int32 i = from; i <= to; i += 1) {
+					Add(i);
+				}
+			}
+			void Add(const ByteSet& other) {
+				for (int32 i = 0; i < 4; i += 1) {
+					bits[i] |= other.bits[i];
+				}
+			}
+			void Invert() {
+				for (int32 i = 0; i < 4; i += 1) {
+					bits[i] = ~bits[i];
+				}
+			}
+			bool Contains(int32 value) const {
+				return (bits[value >> 6] >> (value & 63)) & 1;
+			}
+		};
+		enum class Kind :byte {
+			/// @brief Goes to out without consuming.
+			Empty,
+			/// @brief Goes to both out and out1 without consuming.
+			Split,
+			/// @brief Consumes a byte of the set.
+			Bytes,
+			/// @brief ^, goes to out at the start of the content.
+			Begin,
+			/// @brief $, goes to out at the end of the content.
+			End,
+			Match,
+		};
+		struct Node {
+			Kind kind;
+			int32 out;
+			int32 out1;
+			int32 set;
+		};
+		/// @brief A part of the NFA, its end is an Empty node to link onwards.
+		struct Fragment {
+			int32 start;
+			int32 end;
+		};
+		/// @brief A DFA state, the sorted NFA nodes it stands for.
+		struct State {
+			List<int32> nodes{};
+			/// @brief The state after each byte, -1 until computed.
+			int32 next[256];
+			/// @brief The next state with the same hash.
+			int32 nextInBucket;
+			bool initial;
+			bool match;
+			/// @brief Whether it matches at the end of the content, -1 until computed.
+			sbyte endMatch;
+		};
+
+		bool Build(std::string_view pattern);
+		bool IsMatch(std::string_view content);
+
+		// Parsing, false for what isn't supported.
+		bool ParseAlternation(Fragment& result);
+		bool ParseConcatenation(Fragment& result);
+		bool ParseRepetition(Fragment& result);
+		bool ParseAtom(Fragment& result, bool& assertion);
+		bool ParseClass(ByteSet& result);
+		bool ParseClassItem(ByteSet& result, int32& single);
+		bool ParseEscape(ByteSet& result, int32& single);
+		bool ParseBounds(int32& min, int32& max);
+		int32 AddNode(Kind kind, int32 set = -1);
+		bool AddSetFragment(const ByteSet& set, Fragment& result);
+		void Link(Fragment& fragment, const Fragment& next);
+
+		// Matching
+		void Closure(bool atBegin, bool atEnd);
+		int32 Intern(bool initial);
+		int32 GetInitialState();
+		int32 Step(int32 state, byte value);
+		bool MatchesAtEnd(int32 state);
+		void ClearStates();
+
+		std::string_view text{};
+		int32 position = 0;
+
+		List<Node> nodes{};
+		List<ByteSet> sets{};
+		int32 start = -1;
+
+		List<State> states{};
+		/// @brief The first state of each hash.
+		Dictionary<int32, int32> buckets{};
+		int32 initialState = -1;
+		/// @brief Closure() goes from the seeds into the closure.
+		List<int32> seeds{};
+		List<int32> closure{};
+		List<int32> marks{};
+		int32 generation = 0;
+	};
+
+	bool CompiledRegex::Automaton::Build(std::string_view pattern) {
+		text = pattern;
+		position = 0;
+		Fragment fragment;
+		if (!ParseAlternation(fragment) || position != (int32)text.size()) {
+			return false;
+		}
+		int32 match = AddNode(Kind::Match);
+		if (match < 0) {
+			return false;
+		}
+		nodes[fragment.end].out = match;
+		start = fragment.start;
+		marks.SetCount(nodes.GetCount());
+		return true;
+	}
+	int32 CompiledRegex::Automaton::AddNode(Kind kind, int32 set) {
+		if (nodes.GetCount() >= MaxNodes) {
+			return -1;
+		}
+		nodes.Add(Node{ kind, -1, -1, set });
+		return nodes.GetCount() - 1;
+	}
+	bool CompiledRegex::Automaton::AddSetFragment(const ByteSet& set, Fragment& result) {
+		sets.Add(set);
+		int32 bytes = AddNode(Kind::Bytes, sets.GetCount() - 1);
+		int32 end = AddNode(Kind::Empty);
+		if (bytes < 0 || end < 0) {
+			return false;
+		}
+		nodes[bytes].out = end;
+		result = Fragment{ bytes, end };
+		return true;
+	}
+	void CompiledRegex::Automaton::Link(Fragment& fragment, const Fragment& next) {
+		nodes[fragment.end].out = next.start;
+		fragment.end = next.end;
+	}
+
+	bool CompiledRegex::Automaton::ParseAlternation(Fragment& result) {
+		if (!ParseConcatenation(result)) {
+			return false;
+		}
+		while (position < (int32)text.size() && text[position] == '|') {
+			position += 1;
+			Fragment right;
+			if (!ParseConcatenation(right)) {
+				return false;
+			}
+			int32 split = AddNode(Kind::Split);
+			int32 end = AddNode(Kind::Empty);
+			if (split < 0 || end < 0) {
+				return false;
+			}
+			nodes[split].out = result.start;
+			nodes[split].out1 = right.start;
+			nodes[result.end].out = end;
+			nodes[right.end].out = end;
+			result = Fragment{ split, end };
+		}
+		return true;
+	}
+	bool CompiledRegex::Automaton::ParseConcatenation(Fragment& result) {
+		int32 empty = AddNode(Kind::Empty);
+		if (empty < 0) {
+			return false;
+		}
+		result = Fragment{ empty, empty };
+		while (position < (int32)text.size() && text[position] != '|' && text[position] != ')') {
+			Fragment next;
+			if (!ParseRepetition(next)) {
+				return false;
+			}
+			Link(result, next);
+		}
+		return true;
+	}
+	bool CompiledRegex::Automaton::ParseRepetition(Fragment& result) {
+		int32 atomStart = position;
+		bool assertion = false;
+		Fragment atom;
+		if (!ParseAtom(atom, assertion)) {
+			return false;
+		}
+		if (position >= (int32)text.size()) {
+			result = atom;
+			return true;
+		}
+
+		int32 min = 0;
+		int32 max = -1;
+		char c = text[position];
+		if (c == '*') {
+			position += 1;
+		} else if (c == '+') {
+			min = 1;
+			position += 1;
+		} else if (c == '?') {
+			max = 1;
+			position += 1;
+		} else if (c == '{') {
+			if (!ParseBounds(min, max)) {
+				return false;
+			}
+		} else {
+			result = atom;
+			return true;
+		}
+		// Lazy or greedy find the same contents.
+		if (position < (int32)text.size() && text[position] == '?') {
+			position += 1;
+		}
+		if (assertion || (position < (int32)text.size() && (text[position] == '*' || text[position] == '+' || text[position] == '?' || text[position] == '{'))) {
+			return false;
+		}
+
+		// Each copy beyond the first parses the atom again.
+		int32 end = position;
+		int32 copies = 0;
+		auto nextCopy = [&](Fragment& copy) {
+			if (copies++ == 0) {
+				copy = atom;
+				return true;
+			}
+			position = atomStart;
+			bool unused = false;
+			bool parsed = ParseAtom(copy, unused);
+			position = end;
+			return parsed;
+		};
+
+		int32 empty = AddNode(Kind::Empty);
+		if (empty < 0) {
+			return false;
+		}
+		result = Fragment{ empty, empty };
+		for (int32 i = 0; i < min; i += 1) {
+			Fragment copy;
+			if (!nextCopy(copy)) {
+				return false;
+			}
+			Link(result, copy);
+		}
+		for (int32 i = min; max < 0 ? i == min : i < max; i += 1) {
+			Fragment copy;
+			if (!nextCopy(copy)) {
+				return false;
+			}
+			int32 split = AddNode(Kind::Split);
+			int32 exit = AddNode(Kind::Empty);
+			if (split < 0 || exit < 0) {
+				return false;
+			}
+			nodes[split].out = copy.start;
+			nodes[split].out1 = exit;
+			// Unbounded loops back to the split, bounded goes on.
+			nodes[copy.end].out = max < 0 ? split : exit;
+			Link(result, Fragment{ split, exit });
+		}
+		return true;
+	}
+	bool CompiledRegex::Automaton::ParseBounds(int32& min, int32& max) {
+		// {n}, {n,} or {n,m}
+		position += 1;
+		auto parseNumber = [&](int32& result) {
+			int32 from = position;
+			result = 0;
+			while (position < (int32)text.size() && text[position] >= '0' && text[position] <= '9' && position - from < 4) {
+				result = result * 10 + (text[position] - '0');
+				position += 1;
+			}
+			return position > from && (position >= (int32)text.size() || text[position] < '0' || text[position] > '9');
+		};
+		if (!parseNumber(min)) {
+			return false;
+		}
+		max = min;
+		if (position < (int32)text.size() && text[position] == ',') {
+			position += 1;
+			max = -1;
+			if (position < (int32)text.size() && text[position] != '}' && !parseNumber(max)) {
+				return false;
+			}
+		}
+		if (position >= (int32)text.size() || text[position] != '}' || (max >= 0 && max < min)) {
+			return false;
+		}
+		position += 1;
+		return true;
+	}
+	bool CompiledRegex::Automaton::ParseAtom(Fragment& result, bool& assertion) {
+		char c = text[position];
+		ByteSet set;
+		int32 single = -1;
+		switch (c) {
+			case '(': {
+				position += 1;
+				if (position < (int32)text.size() && text[position] == '?') {
+					// Only non-capturing groups, not lookaheads.
+					if (position + 1 >= (int32)text.size() || text[position + 1] != ':') {
+						return false;
+					}
+					position += 2;
+				}
+				if (!ParseAlternation(result) || position >= (int32)text.size() || text[position] != ')') {
+					return false;
+				}
+				position += 1;
+				return true;
+			}
+			case '^':
+			case '$': {
+				position += 1;
+				assertion = true;
+				int32 node = AddNode(c == '^' ? Kind::Begin : Kind::End);
+				int32 end = AddNode(Kind::Empty);
+				if (node < 0 || end < 0) {
+					return false;
+				}
+				nodes[node].out = end;
+				result = Fragment{ node, end };
+				return true;
+			}
+			case '.':
+				position += 1;
+				set.AddRange(0, 255);
+				set.bits['\n' >> 6] &= ~(1ull << ('\n' & 63));
+				set.bits['\r' >> 6] &= ~(1ull << ('\r' & 63));
+				return AddSetFragment(set, result);
+			case '[':
+				return ParseClass(set) && AddSetFragment(set, result);
+			case '\\':
+				return ParseEscape(set, single) && AddSetFragment(set, result);
+			case '*':
+			case '+':
+			case '?':
+			case '{':
+			case '}':
+			case ']':
+			case ')':
+			case '|':
+				return false;
+			default:
+				position += 1;
+				set.Add((byte)c);
+				return AddSetFragment(set, result);
+		}
+	}
+	bool CompiledRegex::Automaton::ParseClass(ByteSet& result) {
+		position += 1;
+		bool negated = false;
+		if (position < (int32)text.size() && text[position] == '^') {
+			negated = true;
+			position += 1;
+		}
+		// [] and [^] mean different things to different libraries.
+		if (position >= (int32)text.size() || text[position] == ']') {
+			return false;
+		}
+		while (true) {
+			if (position >= (int32)text.size()) {
+				return false;
+			}
+			if (text[position] == ']') {
+				position += 1;
+				break;
+			}
+			ByteSet item;
+			int32 low = -1;
+			if (!ParseClassItem(item, low)) {
+				return false;
+			}
+			if (low >= 0 && position + 1 < (int32)text.size() && text[position] == '-' && text[position + 1] != ']') {
+				position += 1;
+				int32 high = -1;
+				if (!ParseClassItem(item, high) || high < low) {
+					return false;
+				}
+				result.AddRange(low, high);
+			} else {
+				result.Add(item);
+			}
+		}
+		if (negated) {
+			result.Invert();
+		}
+		return true;
+	}
+	bool CompiledRegex::Automaton::ParseClassItem(ByteSet& result, int32& single) {
+		char c = text[position];
+		if (c == '\\') {
+			return ParseEscape(result, single);
+		}
+		// [:alpha:], [.a.] and [=a=]
+		if (c == '[' && position + 1 < (int32)text.size() && (text[position + 1] == ':' || text[position + 1] == '.' || text[position + 1] == '=')) {
+			return false;
+		}
+		position += 1;
+		single = (byte)c;
+		result.Add(single);
+		return true;
+	}
+	bool CompiledRegex::Automaton::ParseEscape(ByteSet& result, int32& single) {
+		position += 1;
+		if (position >= (int32)text.size()) {
+			return false;
+		}
+		char c = text[position];
+		position += 1;
+		single = -1;
+		ByteSet set;
+		switch (c) {
+			case 'd':
+			case 'D':
+				set.AddRange('0', '9');
+				break;
+			case 'w':
+			case 'W':
+				set.AddRange('a', 'z');
+				set.AddRange('A', 'Z');
+				set.AddRange('0', '9');
+				set.Add('_');
+				break;
+			case 's':
+			case 'S':
+				set.Add(' ');
+				set.AddRange('\t', '\r');
+				break;
+			case 'n':
+				single = '\n';
+				break;
+			case 'r':
+				single = '\r';
+				break;
+			case 't':
+				single = '\t';
+				break;
+			case 'v':
+				single = '\v';
+				break;
+			case 'f':
+				single = '\f';
+				break;
+			case 'x': {
+				auto hex = [](char h) {
+					return h >= '0' && h <= '9' ? h - '0' : h >= 'a' && h <= 'f' ? h - 'a' + 10 : h >= 'A' && h <= 'F' ? h - 'A' + 10 : -1;
+				};
+				if (position + 1 >= (int32)text.size() || hex(text[position]) < 0 || hex(text[position + 1]) < 0) {
+					return false;
+				}
+				single = hex(text[position]) * 16 + hex(text[position + 1]);
+				position += 2;
+				break;
+			}
+			default:
+				// \b, backreferences, \u and the like.
+				if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+					return false;
+				}
+				single = (byte)c;
+				break;
+		}
+		if (c == 'D' || c == 'W' || c == 'S') {
+			set.Invert();
+		}
+		if (single >= 0) {
+			set.Add(single);
+		}
+		result.Add(set);
+		return true;
+	}
+
+	void CompiledRegex::Automaton::Closure(bool atBegin, bool atEnd) {
+		generation += 1;
+		closure.Clear();
+		while (seeds.GetCount() > 0) {
+			int32 node = seeds[seeds.GetCount() - 1];
+			seeds.RemoveAt(seeds.GetCount() - 1);
+			if (marks[node] == generation) {
+				continue;
+			}
+			marks[node] = generation;
+
+			const Node& n = nodes[node];
+			switch (n.kind) {
+				case Kind::Empty:
+					seeds.Add(n.out);
+					break;
+				case Kind::Split:
+					seeds.Add(n.out1);
+					seeds.Add(n.out);
+					break;
+				case Kind::Begin:
+					if (atBegin) {
+						seeds.Add(n.out);
+					}
+					break;
+				case Kind::End:
+					if (atEnd) {
+						seeds.Add(n.out);
+					} else {
+						// Kept, for MatchesAtEnd().
+						closure.Add(node);
+					}
+					break;
+				case Kind::Bytes:
+				case Kind::Match:
+					closure.Add(node);
+					break;
+			}
+		}
+		Sorting::Sort(closure.GetRawElementPtr(), closure.GetCount());
+	}
+	int32 CompiledRegex::Automaton::Intern(bool initial) {
+		uint32 hash = initial ? 2166136261u : 2166136262u;
+		for (int32 i = 0; i < closure.GetCount(); i += 1) {
+			hash = (hash ^ (uint32)closure[i]) * 16777619u;
+		}
+
+		int32 first = -1;
+		if (buckets.TryGet((int32)hash, first)) {
+			for (int32 i = first; i >= 0; i = states[i].nextInBucket) {
+				const State& state = states[i];
+				if (state.initial == initial && state.nodes.GetCount() == closure.GetCount()
+					&& std::memcmp(state.nodes.GetRawElementPtr(), closure.GetRawElementPtr(), closure.GetCount() * sizeof(int32)) == 0) {
+					return i;
+				}
+			}
+		}
+
+		State& state = states.Emplace();
+		state.nodes = closure;
+		std::memset(state.next, 0xFF, sizeof(state.next));
+		state.nextInBucket = first;
+		state.initial = initial;
+		state.match = false;
+		state.endMatch = -1;
+		for (int32 i = 0; i < closure.GetCount(); i += 1) {
+			if (nodes[closure[i]].kind == Kind::Match) {
+				state.match = true;
+			}
+		}
+		buckets.Set((int32)hash, states.GetCount() - 1);
+		return states.GetCount() - 1;
+	}
+	int32 CompiledRegex::Automaton::GetInitialState() {
+		if (initialState < 0) {
+			seeds.Clear();
+			seeds.Add(start);
+			Closure(true, false);
+			initialState = Intern(true);
+		}
+		return initialState;
+	}
+	int32 CompiledRegex::Automaton::Step(int32 state, byte value) {
+		// Where the nodes go with the byte, and the start again, for the matches beginning after it.
+		seeds.Clear();
+		seeds.Add(start);
+		const List<int32>& from = states[state].nodes;
+		for (int32 i = from.GetCount() - 1; i >= 0; i -= 1) {
+			const Node& node = nodes[from[i]];
+			if (node.kind == Kind::Bytes && sets[node.set].Contains(value)) {
+				seeds.Add(node.out);
+			}
+		}
+		Closure(false, false);
+
+		if (states.GetCount() >= MaxStates) {
+			ClearStates();
+			return Intern(false);
+		}
+		int32 next = Intern(false);
+		states[state].next[value] = next;
+		return next;
+	}
+	bool CompiledRegex::Automaton::MatchesAtEnd(int32 state) {
+		if (states[state].endMatch < 0) {
+			seeds.Clear();
+			const List<int32>& from = states[state].nodes;
+			for (int32 i = 0; i < from.GetCount(); i += 1) {
+				if (nodes[from[i]].kind == Kind::End) {
+					seeds.Add(nodes[from[i]].out);
+				}
+			}
+			Closure(states[state].initial, true);
+			bool match = false;
+			for (int32 i = 0; i < closure.GetCount(); i += 1) {
+				if (nodes[closure[i]].kind == Kind::Match) {
+					match = true;
+				}
+			}
+			states[state].endMatch = match ? 1 : 0;
+		}
+		return states[state].endMatch == 1;
+	}
+	void CompiledRegex::Automaton::ClearStates() {
+		states.Clear();
+		buckets.Clear();
+		initialState = -1;
+	}
+	bool CompiledRegex::Automaton::IsMatch(std::string_view content) {
+		int32 state = GetInitialState();
+		if (states[state].match) {
+			return true;
+		}
+		for (char c : content) {
+			int32 next = states[state].next[(byte)c];
+			state = next >= 0 ? next : Step(state, (byte)c);
+			if (states[state].match) {
+				return true;
+			}
+		}
+		return MatchesAtEnd(state);
+	}
+
+	CompiledRegex::CompiledRegex(const String& pattern) :pattern(pattern) {
+		result = Regex::CreateRegex(pattern, expression);
+		if (result != ResultCode::OK) {
+			return;
+		}
+		automaton.Reset(MEMNEW(Automaton()));
+		if (!automaton->Build(pattern.GetStringView())) {
+			automaton.Reset();
+		}
+	}
+	CompiledRegex::~CompiledRegex() = default;
+
+	ResultCode CompiledRegex::GetResult() const {
+		return result;
+	}
+	const String& CompiledRegex::GetPattern() const {
+		return pattern;
+	}
+	bool CompiledRegex::HasAutomaton() const {
+		return automaton.GetRaw() != nullptr;
+	}
+
+	ResultCode CompiledRegex::Match(const String& content, List<Regex::MatchRange>& results) const {
+		ERR_ASSERT(result == ResultCode::OK, u8"The regex expression didn't compile.", return result);
+		results.Clear();
+		if (HasAutomaton() && !IsMatch(content)) {
+			return ResultCode::OK;
+		}
 
 		// Get ready for matching
 		std::string_view contentSv = content.GetStringView();
 		using TIter = decltype(contentSv.cbegin());
 
-		std::regex_iterator<TIter> iter(contentSv.cbegin(), contentSv.cend(),expression);
+		std::regex_iterator<TIter> iter(contentSv.cbegin(), contentSv.cend(), expression);
 		std::regex_iterator<TIter> end;
 
-		// Clear result list.
-		results.Clear();
-
 		// Match and iterate all matches
 		while (iter != end) {
 			const auto& matches = *iter;
 			for (int32 i = 0; i < matches.size(); ++i) {
 				const auto& match = matches[i];
-				results.Add(MatchRange(match.first - contentSv.begin(), match.second - contentSv.begin()));
+				results.Add(Regex::MatchRange(match.first - contentSv.begin(), match.second - contentSv.begin()));
 			}
 			++iter;
 		}
 
 		return ResultCode::OK;
 	}
+	bool CompiledRegex::IsMatch(const String& content) const {
+		ERR_ASSERT(result == ResultCode::OK, u8"The regex expression didn't compile.", return false);
+		std::string_view contentSv = content.GetStringView();
+		if (!HasAutomaton()) {
+			return std::regex_search(contentSv.begin(), contentSv.end(), expression);
+		}
+		SimpleLock<Mutex> lock(mutex);
+		return automaton->IsMatch(contentSv);
+	}
 }
@@ -1,9 +1,14 @@
 #pragma once
 #include "Engine/System/String.h"
 #include "Engine/System/Collection/List.h"
+#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/Thread/ThreadUtil.h"
 #include <regex>
 
 namespace Engine {
+	class CompiledRegex;
+
 	class Regex final {
 	public:
 		struct MatchRange {
@@ -13,11 +18,58 @@ namespace Engine {
 			int32 to;
 			bool IsValid() const;
 		};
+		static inline constexpr int32 DefaultCacheCapacity = 32;
 
 
+		/// @brief Match with the compiled pattern from the cache, compiling it on a miss. See CompiledRegex::Match().
 		static ResultCode Match(const String& content, const String& pattern, List<MatchRange>& results);
+		/// @brief Test with the compiled pattern from the cache, compiling it on a miss. See CompiledRegex::IsMatch().
+		static bool IsMatch(const String& content, const String& pattern);
+		/// @brief The compiled pattern, from the cache of the least recently used ones. Thread-safe.\n
+		/// Patterns that don't compile are cached too, with the error in CompiledRegex::GetResult().
+		static SharedPtr<CompiledRegex> GetCompiled(const String& pattern);
+		/// @brief How many compiled patterns the cache keeps, 0 to not cache.
+		static void SetCacheCapacity(int32 capacity);
+		static int32 GetCacheCapacity();
 
 	private:
+		friend class CompiledRegex;
 		static ResultCode CreateRegex(const String& pattern, std::regex& result);
 	};
+
+	/// @brief A pattern compiled once, to match many contents with.\n
+	/// Besides the std::regex, patterns made of literals, classes, groups, alternations, quantifiers, ^ and $ get a DFA,
+	/// built lazily a state at a time while matching and scanning each byte of the content once.
+	/// It answers IsMatch() alone and lets Match() skip the std::regex for the contents without a match.
+	/// Other patterns, with backreferences, lookaheads or \\b for example, only use the std::regex.\n
+	/// Thread-safe, the DFA is guarded by a lock.
+	class CompiledRegex final {
+	public:
+		/// @brief See GetResult() for whether it compiled.
+		explicit CompiledRegex(const String& pattern);
+		~CompiledRegex();
+		CompiledRegex(const CompiledRegex&) = delete;
+		CompiledRegex& operator=(const CompiledRegex&) = delete;
+
+		/// @brief ResultCode::OK, or why the pattern didn't compile.
+		ResultCode GetResult() const;
+		const String& GetPattern() const;
+		/// @brief Whether the pattern could be compiled to a DFA.
+		bool HasAutomaton() const;
+
+		/// @brief Find all matches, the whole one then each group for every match, into the cleared results.
+		ResultCode Match(const String& content, List<Regex::MatchRange>& results) const;
+		/// @brief Whether the pattern matches anywhere in the content.
+		bool IsMatch(const String& content) const;
+
+	private:
+		/// @brief The DFA and the NFA it comes from, defined with the implementation.
+		struct Automaton;
+
+		String pattern;
+		ResultCode result;
+		std::regex expression{};
+		UniquePtr<Automaton> automaton;
+		mutable Mutex mutex{};
+	};
 }
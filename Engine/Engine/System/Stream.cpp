@@ -1,4 +1,17 @@
 #include "Engine/System/Stream.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include <cstdint>
+#include <cstring>
+#if defined(__SSSE3__) || defined(__AVX__)
+#define STREAM_SSSE3
+#include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STREAM_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define STREAM_NEON
+#include <arm_neon.h>
+#endif
 
 namespace Engine {
 	Stream::Endianness Stream::GetCurrentEndianness() const {
@@ -8,6 +21,13 @@ namespace Engine {
 		currentEndianness = endianness;
 	}
 
+	bool Stream::CanReadSpan() const {
+		return false;
+	}
+	ByteSpan Stream::ReadSpan(int32 length) {
+		return ByteSpan();
+	}
+
 	ResultCode Stream::WriteBytes(const byte* valuePtr, int32 length) {
 		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return ResultCode::InvalidStream);
 		ERR_ASSERT(CanWrite(), u8"This FileStream cannot write.", return ResultCode::NoPermission);
@@ -29,9 +49,16 @@ namespace Engine {
 			return WriteBytesUnchecked(valuePtr, length);
 		}
 
+		// Reverse into a small buffer, from the end of the value, a chunk per write.
+		byte reversed[64];
 		ResultCode r = ResultCode::OK;
-		for (int32 i = length - 1; i >= 0 && r == ResultCode::OK; i -= 1) {
-			r = WriteBytesUnchecked(valuePtr + i, 1);
+		for (int32 done = 0; done < length && r == ResultCode::OK;) {
+			int32 size = length - done < (int32)sizeof(reversed) ? length - done : (int32)sizeof(reversed);
+			for (int32 i = 0; i < size; i += 1) {
+				reversed[i] = valuePtr[length - 1 - done - i];
+			}
+			r = WriteBytesUnchecked(reversed, size);
+			done += size;
 		}
 		return r;
 	}
@@ -41,20 +68,24 @@ namespace Engine {
 			return 0;
 		}
 
-		//Prepare result container
-		result.RequireCapacity(result.GetCapacity() + length);
-		for (int32 i = 0; i < length; i += 1) {
-			result.Add(0);
-		}
+		int32 start = result.GetCount();
+		result.SetCount(start + length);
 
-		int32 read = ReadBytesUnchecked(length, result);
+		int32 read = ReadBytes(result.GetRawElementPtr() + start, length);
+		result.SetCount(start + read);
 
-		int32 remove = length - read;
-		for (int32 i = 0; i < remove; i += 1) {
-			result.RemoveAt(result.GetCount() - 1 - i);
+		return read;
+	}
+	int32 Stream::ReadBytes(byte* buffer, int32 length) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return 0);
+		ERR_ASSERT(CanRead(), u8"This FileStream cannot read.", return 0);
+		ERR_ASSERT(length >= 0, u8"length must be greater than 0.", return 0);
+		if (length == 0) {
+			return 0;
 		}
 
-		return read;
+		int32 read = ReadBytesUnchecked(buffer, length);
+		return read < 0 ? 0 : read;
 	}
 	int32 Stream::ReadBytesEndian(int32 length, List<byte>& result) {
 		int32 read = ReadBytes(length, result);
@@ -75,6 +106,106 @@ namespace Engine {
 		return read;
 	}
 
+	void Stream::SwapBytes(byte* values, int64 count, int32 size) {
+		ERR_ASSERT(size == 1 || size == 2 || size == 4 || size == 8, u8"Only values of 2, 4 or 8 bytes can be swapped.", return);
+		if (size == 1) {
+			return;
+		}
+		int64 length = count * size;
+		int64 i = 0;
+#if defined(STREAM_SSSE3)
+		__m128i mask = size == 2 ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+			: size == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+			: _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+		for (; i + 16 <= length; i += 16) {
+			__m128i chunk = _mm_loadu_si128((const __m128i*)(values + i));
+			_mm_storeu_si128((__m128i*)(values + i), _mm_shuffle_epi8(chunk, mask));
+		}
+#elif defined(STREAM_SSE2)
+		// No byte shuffle without SSSE3: swap the bytes of each 16 bits, then reorder the 16 bits of wider values.
+		for (; i + 16 <= length; i += 16) {
+			__m128i chunk = _mm_loadu_si128((const __m128i*)(values + i));
+			chunk = _mm_or_si128(_mm_slli_epi16(chunk, 8), _mm_srli_epi16(chunk, 8));
+			if (size == 4) {
+				chunk = _mm_shufflehi_epi16(_mm_shufflelo_epi16(chunk, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+			} else if (size == 8) {
+				chunk = _mm_shufflehi_epi16(_mm_shufflelo_epi16(chunk, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+			}
+			_mm_storeu_si128((__m128i*)(values + i), chunk);
+		}
+#elif defined(STREAM_NEON)
+		for (; i + 16 <= length; i += 16) {
+			uint8x16_t chunk = vld1q_u8(values + i);
+			chunk = size == 2 ? vrev16q_u8(chunk) : size == 4 ? vrev32q_u8(chunk) : vrev64q_u8(chunk);
+			vst1q_u8(values + i, chunk);
+		}
+#endif
+		for (; i < length; i += size) {
+			if (size == 2) {
+				uint16 value;
+				std::memcpy(&value, values + i, sizeof(value));
+				value = SwapBytes(value);
+				std::memcpy(values + i, &value, sizeof(value));
+			} else if (size == 4) {
+				uint32 value;
+				std::memcpy(&value, values + i, sizeof(value));
+				value = SwapBytes(value);
+				std::memcpy(values + i, &value, sizeof(value));
+			} else {
+				uint64 value;
+				std::memcpy(&value, values + i, sizeof(value));
+				value = SwapBytes(value);
+				std::memcpy(values + i, &value, sizeof(value));
+			}
+		}
+	}
+	ResultCode Stream::WriteElements(const byte* values, int32 count, int32 size, int32 scalarSize) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return ResultCode::InvalidStream);
+		ERR_ASSERT(CanWrite(), u8"This FileStream cannot write.", return ResultCode::NoPermission);
+		ERR_ASSERT(count >= 0, u8"count must be greater than 0.", return ResultCode::InvalidArgument);
+		int64 length = (int64)count * size;
+		bool swap = scalarSize > 1 && Stream::LocalEndianness != GetCurrentEndianness();
+
+		// Straight from the values, in as few writes as int32 lengths allow.
+		// Swapped through a buffer instead, a whole number of scalars per write.
+		byte swapped[4096];
+		int64 chunk = swap ? (int64)sizeof(swapped) : (INT32_MAX / size) * (int64)size;
+		ResultCode r = ResultCode::OK;
+		for (int64 done = 0; done < length && r == ResultCode::OK; done += chunk) {
+			int32 part = (int32)(length - done < chunk ? length - done : chunk);
+			if (swap) {
+				std::memcpy(swapped, values + done, part);
+				SwapBytes(swapped, part / scalarSize, scalarSize);
+				r = WriteBytesUnchecked(swapped, part);
+			} else {
+				r = WriteBytesUnchecked(values + done, part);
+			}
+		}
+		return r;
+	}
+	int32 Stream::ReadElements(byte* values, int32 count, int32 size, int32 scalarSize) {
+		ERR_ASSERT(IsValid(), u8"Attempted to operate an invalid FileStream!", return 0);
+		ERR_ASSERT(CanRead(), u8"This FileStream cannot read.", return 0);
+		ERR_ASSERT(count >= 0, u8"count must be greater than 0.", return 0);
+		int64 length = (int64)count * size;
+		int64 chunk = (INT32_MAX / size) * (int64)size;
+		int64 done = 0;
+		while (done < length) {
+			int32 part = (int32)(length - done < chunk ? length - done : chunk);
+			int32 read = ReadBytesUnchecked(values + done, part);
+			if (read <= 0) {
+				break;
+			}
+			done += read;
+		}
+
+		int32 result = (int32)(done / size);
+		if (scalarSize > 1 && Stream::LocalEndianness != GetCurrentEndianness()) {
+			SwapBytes(values, (int64)result * size / scalarSize, scalarSize);
+		}
+		return result;
+	}
+
 	ResultCode Stream::WriteByte(byte value) {
 		return WriteBytes(&value, sizeof(byte));
 	}
@@ -108,10 +239,22 @@ namespace Engine {
 	ResultCode Stream::WriteDouble(double value) {
 		return WriteBytesEndian((byte*)&value, sizeof(double));
 	}
-	// TODO: Implement this.
 	ResultCode Stream::WriteString(const String& value) {
-		FATAL_CRASH(u8"Not implemented.");
-		return ResultCode::NotSupported;
+		// 7 bits of the length per byte, the high bit tells that more follow.
+		byte length[5];
+		int32 size = 0;
+		for (uint32 left = (uint32)value.GetCount(); ; left >>= 7) {
+			if (left < 0x80) {
+				length[size++] = (byte)left;
+				break;
+			}
+			length[size++] = (byte)(left | 0x80);
+		}
+		ResultCode r = WriteBytes(length, size);
+		if (r != ResultCode::OK) {
+			return r;
+		}
+		return WriteText(value);
 	}
 	ResultCode Stream::WriteText(const String& value) {
 		return WriteBytes((byte*)value.GetStartPtr(), value.GetCount());
@@ -182,30 +325,80 @@ namespace Engine {
 		ERR_ASSERT(read == sizeof(double), u8"Cannot read a double.", return 0);
 		return *((double*)(readCache.GetRawElementPtr() + readCache.GetCount() - read));
 	}
-	// TODO: Implement this.
 	String Stream::ReadString() {
-		FATAL_CRASH(u8"Not implemented.");
-		return String::GetEmpty();
+		uint32 length = 0;
+		for (int32 shift = 0; ; shift += 7) {
+			ERR_ASSERT(shift < 35, u8"The length of the string is not valid.", return String::GetEmpty());
+			byte part = 0;
+			ERR_ASSERT(ReadBytes(&part, 1) == 1, u8"Cannot read the length of the string.", return String::GetEmpty());
+			length |= (uint32)(part & 0x7F) << shift;
+			if ((part & 0x80) == 0) {
+				break;
+			}
+		}
+		ERR_ASSERT(length <= INT32_MAX - 1, u8"The length of the string is not valid.", return String::GetEmpty());
+		return ReadText((int32)length);
 	}
 
-	// TODO: Implement this.
 	String Stream::ReadTextLine() {
-		FATAL_CRASH(u8"Not implemented.");
-		return String::GetEmpty();
+		readCache.Clear();
+		if (!CanRandomAccess()) {
+			// Nothing read past the line can be given back, so no byte past it is read.
+			byte c = 0;
+			while (ReadBytes(&c, 1) == 1 && c != (byte)'\n') {
+				readCache.Add(c);
+			}
+		} else {
+			constexpr int32 chunkSize = 128;
+			while (true) {
+				int32 start = readCache.GetCount();
+				int32 read = ReadBytes(chunkSize, readCache);
+				const byte* chunk = readCache.GetRawElementPtr() + start;
+				int32 found = 0;
+				while (found < read && chunk[found] != (byte)'\n') {
+					found += 1;
+				}
+				if (found < read) {
+					// Give back what follows the line.
+					SetPosition(GetPosition() - (read - found - 1));
+					readCache.SetCount(start + found);
+					break;
+				}
+				if (read < chunkSize) {
+					break;
+				}
+			}
+		}
+
+		int32 count = readCache.GetCount();
+		if (count > 0 && readCache[count - 1] == (byte)'\r') {
+			count -= 1;
+		}
+		return String((const u8char*)readCache.GetRawElementPtr(), count);
 	}
-	
+
 	String Stream::ReadAllText() {
 		ERR_ASSERT(CanRandomAccess(), u8"Stream must be capable with random accessing!", return String::GetEmpty());
 
 		SetPosition(0);
-		int32 length = GetLength();
-		
-		readCache.Clear();
-		readCache.RequireCapacity(length + 1);
+		int64 length = GetLength();
+		ERR_ASSERT(length >= 0 && length <= INT32_MAX - 1, u8"The stream is too long for a String.", return String::GetEmpty());
+		return ReadText((int32)length);
+	}
 
-		int32 read=ReadBytes(length, readCache);
-		ERR_ASSERT(read == length, u8"Error when read bytes!", return String::GetEmpty());
+	String Stream::ReadText(int32 length) {
+		if (length <= String::SmallCapacity) {
+			u8char small[String::SmallCapacity];
+			int32 read = ReadBytes((byte*)small, length);
+			ERR_ASSERT(read == length, u8"Error when read bytes!", return String::GetEmpty());
+			return String(small, length);
+		}
 
-		return String((u8char*)readCache.GetRawElementPtr(), length);
+		Memory::TagScope tag{ MemoryTag::String };
+		UniquePtr<u8char[]> data = UniquePtr<u8char[]>::Create(length + 1);
+		int32 read = ReadBytes((byte*)data.GetRaw(), length);
+		ERR_ASSERT(read == length, u8"Error when read bytes!", return String::GetEmpty());
+		data.GetRaw()[length] = '\0';
+		return String(IntrusivePtr<String::ContentData>::Create(Memory::Move(data), length + 1));
 	}
 }
@@ -1,8 +1,28 @@
 #pragma once
 #include "Engine/System/Object/Object.h"
 #include <bit>
+#include <type_traits>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <stdlib.h>
+#endif
 
 namespace Engine {
+	/// @brief Bytes read in place from the memory behind a stream. Only valid while the stream keeps that memory.
+	struct ByteSpan final {
+		const byte* data = nullptr;
+		int32 length = 0;
+
+		bool IsEmpty() const {
+			return length == 0;
+		}
+		const byte* begin() const {
+			return data;
+		}
+		const byte* end() const {
+			return data + length;
+		}
+	};
+
 	class Stream :public ReferencedObject {
 		REFLECTION_CLASS(::Engine::Stream, ::Engine::ReferencedObject) {
 			REFLECTION_CLASS_INSTANTIABLE(false);
@@ -26,6 +46,11 @@ namespace Engine {
 		/// This affects how this Stream deal with data.\n
 		/// Default endianness will always be small-endian.
 		void SetCurrentEndianness(Endianness endian);
+		/// @brief Reverse the bytes of an integer or floating point value, without going through memory.
+		template<typename T>
+		static T SwapBytes(T value);
+		/// @brief Reverse the bytes of each of count values of size 2, 4 or 8 in place, 16 bytes at a time.
+		static void SwapBytes(byte* values, int64 count, int32 size);
 
 
 		virtual void Close() = 0;
@@ -38,6 +63,13 @@ namespace Engine {
 		virtual int64 GetPosition() const = 0;
 		virtual int64 GetLength() const = 0;
 
+		/// @brief Whether the stream has its bytes in memory, so ReadSpan() can read them in place.
+		virtual bool CanReadSpan() const;
+		/// @brief Take up to length bytes in place and move past them, for parsing without copies.\n
+		/// The span stays valid until the stream is written, closed or destroyed.
+		/// @return Shorter than length at the end of the stream, empty if CanReadSpan() is false.
+		virtual ByteSpan ReadSpan(int32 length);
+
 
 		/// @brief Write some bytes, byte by byte.
 		ResultCode WriteBytes(const byte* valuePtr, int32 length);
@@ -46,9 +78,21 @@ namespace Engine {
 		/// @brief Read some bytes, byte by byte.
 		/// @return number of bytes read.
 		int32 ReadBytes(int32 length, List<byte>& result);
+		/// @brief Read up to length bytes straight into the buffer, which must have room for them.
+		/// @return number of bytes read.
+		int32 ReadBytes(byte* buffer, int32 length);
 		/// @brief Read some bytes, do conversions of endianness.
 		/// @return number of bytes read.
 		int32 ReadBytesEndian(int32 length, List<byte>& result);
+		/// @brief Write count values in one transfer, in the current endianness.\n
+		/// T is any trivially copyable type. Its bytes are swapped a Scalar at a time,
+		/// so name the one it is made of when it isn't an integer or floating point itself, WriteArray<Vector3, float>() for example.
+		template<typename T, typename Scalar = T>
+		ResultCode WriteArray(const T* values, int32 count);
+		/// @brief Read up to count values in one transfer, in the current endianness. See WriteArray().
+		/// @return The number of values read. The bytes of a partial last value are consumed but not counted.
+		template<typename T, typename Scalar = T>
+		int32 ReadArray(T* values, int32 count);
 
 
 		ResultCode WriteByte(byte value);
@@ -83,17 +127,69 @@ namespace Engine {
 		/// Starting with a 7-bit encoded integer as the length information, followed by the actual string data encoded in UTF-8.
 		String ReadString();
 
+		/// @brief Read up to the next '\n', which is consumed but not returned, and a '\r' before it.\n
+		/// Without a buffer this goes a chunk at a time on random access streams and a byte at a time on the others,
+		/// use a TextReader to read many lines.
 		String ReadTextLine();
+		/// @brief Read the whole stream from the start, right into the allocation of the returned String.
 		String ReadAllText();
 
 	protected:
 		/// @brief Implement this. No need to do the safe check.
 		virtual ResultCode WriteBytesUnchecked(const byte* valuePtr, int32 length) = 0;
-		/// @brief Implement this. No need to do the safe check.
-		virtual int32 ReadBytesUnchecked(int32 length, List<byte>& result) = 0;
+		/// @brief Implement this. No need to do the safe check.\n
+		/// The buffer has room for length bytes, the ones past the returned count are left as they are.
+		virtual int32 ReadBytesUnchecked(byte* buffer, int32 length) = 0;
 
 	private:
+		/// @brief Read exactly length bytes as a String, small or in a ContentData of its own.
+		String ReadText(int32 length);
+		ResultCode WriteElements(const byte* values, int32 count, int32 size, int32 scalarSize);
+		int32 ReadElements(byte* values, int32 count, int32 size, int32 scalarSize);
+
 		Endianness currentEndianness = Endianness::Little;
 		List<byte> readCache;
 	};
+
+	template<typename T>
+	inline T Stream::SwapBytes(T value) {
+		static_assert(std::is_arithmetic_v<T>, "Only integers and floating points can be swapped.");
+		if constexpr (sizeof(T) == 1) {
+			return value;
+		} else if constexpr (sizeof(T) == 2) {
+#if defined(_MSC_VER) && !defined(__clang__)
+			return std::bit_cast<T>(_byteswap_ushort(std::bit_cast<uint16>(value)));
+#else
+			return std::bit_cast<T>(__builtin_bswap16(std::bit_cast<uint16>(value)));
+#endif
+		} else if constexpr (sizeof(T) == 4) {
+#if defined(_MSC_VER) && !defined(__clang__)
+			return std::bit_cast<T>((uint32)_byteswap_ulong(std::bit_cast<uint32>(value)));
+#else
+			return std::bit_cast<T>(__builtin_bswap32(std::bit_cast<uint32>(value)));
+#endif
+		} else {
+			static_assert(sizeof(T) == 8, "Unsupported size.");
+#if defined(_MSC_VER) && !defined(__clang__)
+			return std::bit_cast<T>((uint64)_byteswap_uint64(std::bit_cast<uint64>(value)));
+#else
+			return std::bit_cast<T>((uint64)__builtin_bswap64(std::bit_cast<uint64>(value)));
+#endif
+		}
+	}
+
+	template<typename T, typename Scalar>
+	inline ResultCode Stream::WriteArray(const T* values, int32 count) {
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written.");
+		static_assert(std::is_arithmetic_v<Scalar> || std::is_enum_v<Scalar>, "Name the integer or floating point T is made of.");
+		static_assert(sizeof(T) % sizeof(Scalar) == 0, "T must be made of whole Scalars.");
+		return WriteElements((const byte*)values, count, (int32)sizeof(T), (int32)sizeof(Scalar));
+	}
+	template<typename T, typename Scalar>
+	inline int32 Stream::ReadArray(T* values, int32 count) {
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read.");
+		static_assert(std::is_arithmetic_v<Scalar> || std::is_enum_v<Scalar>, "Name the integer or floating point T is made of.");
+		static_assert(sizeof(T) % sizeof(Scalar) == 0, "T must be made of whole Scalars.");
+		return ReadElements((byte*)values, count, (int32)sizeof(T), (int32)sizeof(Scalar));
+	}
 }
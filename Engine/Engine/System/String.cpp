@@ -7,12 +7,144 @@
 #include <string>
 #include <cstring>
 #include <string_view>
+#include <new>
+#include <bit>
+#include "Engine/System/Collection/SmallList.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define STRING_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define STRING_NEON
+#include <arm_neon.h>
+#endif
 
 
 namespace Engine {
+	namespace {
+#if defined(STRING_NEON)
+		/// @brief Pack a NEON compare result into 4 bits per byte, the counterpart of a movemask.
+		uint64 GetNeonMask(uint8x16_t compared) {
+			uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(compared), 4);
+			return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+		}
+#endif
+
+		/// @brief Find the first c in the chars, a block of bytes at a time.
+		/// @return The index, -1 if not found.
+		int32 FindChar(const u8char* text, int32 count, u8char c) {
+			int32 i = 0;
+#if defined(STRING_AVX2)
+			__m256i needleWide = _mm256_set1_epi8((char)c);
+			for (; i + 32 <= count; i += 32) {
+				__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+				uint32 mask = (uint32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needleWide));
+				if (mask != 0) {
+					return i + std::countr_zero(mask);
+				}
+			}
+#endif
+#if defined(STRING_SSE2)
+			__m128i needle = _mm_set1_epi8((char)c);
+			for (; i + 16 <= count; i += 16) {
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+				uint32 mask = (uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+				if (mask != 0) {
+					return i + std::countr_zero(mask);
+				}
+			}
+#elif defined(STRING_NEON)
+			uint8x16_t needle = vdupq_n_u8((byte)c);
+			for (; i + 16 <= count; i += 16) {
+				uint64 mask = GetNeonMask(vceqq_u8(vld1q_u8(reinterpret_cast<const byte*>(text + i)), needle));
+				if (mask != 0) {
+					return i + std::countr_zero(mask) / 4;
+				}
+			}
+#endif
+			for (; i < count; i += 1) {
+				if (text[i] == c) {
+					return i;
+				}
+			}
+			return -1;
+		}
+
+		/// @brief Find the first occurence of a pattern of at least 2 chars.\n
+		/// Candidate positions are those matching both the first and the last char of the pattern, tested a block of positions at a time.
+		/// Only the candidates get their middle compared.
+		/// @return The index, -1 if not found.
+		int32 FindPattern(const u8char* text, int32 count, const u8char* pattern, int32 patternCount) {
+			if (patternCount > count) {
+				return -1;
+			}
+			int32 last = patternCount - 1;
+			// Positions up to this one can start a match.
+			int32 end = count - patternCount;
+			int32 i = 0;
+#if defined(STRING_AVX2)
+			__m256i firstWide = _mm256_set1_epi8((char)pattern[0]);
+			__m256i lastWide = _mm256_set1_epi8((char)pattern[last]);
+			for (; i + 32 <= end + 1; i += 32) {
+				__m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+				__m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + last));
+				uint32 mask = (uint32)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, firstWide), _mm256_cmpeq_epi8(blockLast, lastWide)));
+				while (mask != 0) {
+					int32 offset = std::countr_zero(mask);
+					if (std::memcmp(text + i + offset + 1, pattern + 1, patternCount - 2) == 0) {
+						return i + offset;
+					}
+					mask &= mask - 1;
+				}
+			}
+#endif
+#if defined(STRING_SSE2)
+			__m128i first = _mm_set1_epi8((char)pattern[0]);
+			__m128i lastChar = _mm_set1_epi8((char)pattern[last]);
+			for (; i + 16 <= end + 1; i += 16) {
+				__m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+				__m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + last));
+				uint32 mask = (uint32)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, lastChar)));
+				while (mask != 0) {
+					int32 offset = std::countr_zero(mask);
+					if (std::memcmp(text + i + offset + 1, pattern + 1, patternCount - 2) == 0) {
+						return i + offset;
+					}
+					mask &= mask - 1;
+				}
+			}
+#elif defined(STRING_NEON)
+			uint8x16_t first = vdupq_n_u8((byte)pattern[0]);
+			uint8x16_t lastChar = vdupq_n_u8((byte)pattern[last]);
+			for (; i + 16 <= end + 1; i += 16) {
+				uint8x16_t blockFirst = vld1q_u8(reinterpret_cast<const byte*>(text + i));
+				uint8x16_t blockLast = vld1q_u8(reinterpret_cast<const byte*>(text + i + last));
+				uint64 mask = GetNeonMask(vandq_u8(vceqq_u8(blockFirst, first), vceqq_u8(blockLast, lastChar)));
+				while (mask != 0) {
+					int32 offset = std::countr_zero(mask) / 4;
+					if (std::memcmp(text + i + offset + 1, pattern + 1, patternCount - 2) == 0) {
+						return i + offset;
+					}
+					mask &= ~(0xFull << (offset * 4));
+				}
+			}
+#endif
+			for (; i <= end; i += 1) {
+				if (text[i] == pattern[0] && text[i + last] == pattern[last] && std::memcmp(text + i + 1, pattern + 1, patternCount - 2) == 0) {
+					return i;
+				}
+			}
+			return -1;
+		}
+	}
+
 #pragma region ContentData
 	String::ContentData::ContentData(const u8char* data, int32 length) :data(data), length(length), staticData(true) {}
-	String::ContentData::ContentData(UniquePtr<u8char[]>&& data, int32 length) : data(data.Release()), length(length), staticData(false) {}
+	String::ContentData::ContentData(UniquePtr<u8char[]>&& data, int32 length, bool threadLocal) : data(data.Release()), length(length), staticData(false), threadLocal(threadLocal) {}
 
 	String::ContentData::~ContentData() {
 		if (!staticData) {
@@ -23,20 +155,50 @@ namespace Engine {
 		if (staticData) {
 			return 1;
 		}
+		if (threadLocal) {
+			return localReferenceCount.Reference();
+		}
 		return referenceCount.Reference();
 	}
 	uint32 String::ContentData::Dereference() const {
 		if (staticData) {
 			return 1;
 		}
+		if (threadLocal) {
+			return localReferenceCount.Dereference();
+		}
 		return referenceCount.Dereference();
 	}
 	uint32 String::ContentData::GetReferenceCount() const {
 		if (staticData) {
 			return 1;
 		}
+		if (threadLocal) {
+			return localReferenceCount.Get();
+		}
 		return referenceCount.Get();
 	}
+	bool String::ContentData::IsThreadLocal() const {
+		return threadLocal;
+	}
+	int32 String::ContentData::GetHashCode() const {
+		int32 result;
+		if (TryGetCachedHashCode(result)) {
+			return result;
+		}
+		// Racing threads compute the same value, whichever stores last doesn't matter.
+		result = ObjectUtil::GetHashCode(std::string_view((const char*)data, length - 1));
+		hashCode.Set(result);
+		hashCached.Set(true);
+		return result;
+	}
+	bool String::ContentData::TryGetCachedHashCode(int32& result) const {
+		if (!hashCached.Get()) {
+			return false;
+		}
+		result = hashCode.Get();
+		return true;
+	}
 	
 	IntrusivePtr<String::ContentData> String::ContentData::GetEmpty() {
 		static const ContentData empty(u8"", 1);
@@ -56,7 +218,8 @@ namespace Engine {
 
 		int32 pos = 0;
 		for (int32 i = 0; i < lenPattern; i += 1) {
-			if (pos > lenTarget - 1) {
+			// The window must not reach past the target, which may be a part of a larger string.
+			if (pos > lenTarget - lenPattern) {
 				// Not found
 				return -1;
 			}
@@ -83,7 +246,7 @@ namespace Engine {
 
 
 	String String::GetEmpty() {
-		return String(IntrusivePtr<ContentData>(ContentData::GetEmpty()));
+		return String(u8"", 0);
 	}
 
 	String::String(const u8char* string,int32 count) {
@@ -104,50 +267,169 @@ namespace Engine {
 		PrepareData(string.c_str(), static_cast<int32>(string.length()));
 	}
 
-	String::String(IntrusivePtr<ContentData> dataPtr, int32 start, int32 count) :data(dataPtr), refStart(start), refCount(count < 0 ? dataPtr->length - 1 : count) {}
+	String::String(IntrusivePtr<ContentData> dataPtr, int32 start, int32 count) {
+		SetShared(Memory::Move(dataPtr), start, count);
+	}
+
+	String::String(const String& obj) {
+		if (obj.IsSmall()) {
+			std::memcpy(storage, obj.storage, sizeof(storage));
+			smallCount = obj.smallCount;
+		} else {
+			const SharedView& view = obj.GetShared();
+			SetShared(view.data, view.refStart, view.refCount);
+		}
+	}
+	String& String::operator=(const String& obj) {
+		if (this == &obj) {
+			return *this;
+		}
+		if (obj.IsSmall()) {
+			Reset();
+			std::memcpy(storage, obj.storage, sizeof(storage));
+			smallCount = obj.smallCount;
+		} else {
+			const SharedView& view = obj.GetShared();
+			SetShared(view.data, view.refStart, view.refCount);
+		}
+		return *this;
+	}
+	String::String(String&& obj) noexcept {
+		if (obj.IsSmall()) {
+			std::memcpy(storage, obj.storage, sizeof(storage));
+			smallCount = obj.smallCount;
+		} else {
+			SharedView& view = obj.GetShared();
+			SetShared(Memory::Move(view.data), view.refStart, view.refCount);
+		}
+		obj.Reset();
+	}
+	String& String::operator=(String&& obj) noexcept {
+		if (this == &obj) {
+			return *this;
+		}
+		if (obj.IsSmall()) {
+			Reset();
+			std::memcpy(storage, obj.storage, sizeof(storage));
+			smallCount = obj.smallCount;
+		} else {
+			SharedView& view = obj.GetShared();
+			SetShared(Memory::Move(view.data), view.refStart, view.refCount);
+		}
+		obj.Reset();
+		return *this;
+	}
+	String::~String() {
+		Reset();
+	}
+
+	String::SharedView& String::GetShared() {
+		return *std::launder(reinterpret_cast<SharedView*>(storage));
+	}
+	const String::SharedView& String::GetShared() const {
+		return *std::launder(reinterpret_cast<const SharedView*>(storage));
+	}
+	void String::SetSmall(const u8char* string, int32 count) {
+		// string may point into the content being released.
+		u8char buffer[SmallCapacity + 1];
+		std::memcpy(buffer, string, count);
+		buffer[count] = '\0';
+
+		Reset();
+		std::memcpy(storage, buffer, count + 1);
+		smallCount = (byte)count;
+	}
+	void String::SetShared(IntrusivePtr<ContentData> dataPtr, int32 start, int32 count) {
+		if (count < 0) {
+			count = dataPtr->length - 1;
+		}
+		if (!IsSmall()) {
+			SharedView& view = GetShared();
+			view.data = Memory::Move(dataPtr);
+			view.refStart = start;
+			view.refCount = count;
+			return;
+		}
+		Memory::Construct(reinterpret_cast<SharedView*>(storage), SharedView{ Memory::Move(dataPtr), start, count });
+		smallCount = SharedMark;
+	}
+	void String::Reset() {
+		if (!IsSmall()) {
+			Memory::Destruct(&GetShared());
+		}
+		storage[0] = '\0';
+		smallCount = 0;
+	}
 
-	void String::PrepareData(const u8char* string, sizeint count) {
-		// Use public empty string.
+	void String::PrepareData(const u8char* string, sizeint count, bool threadLocal) {
 		if (count <= 0) {
-			data = ContentData::GetEmpty();
-			refStart = 0;
-			refCount = 0;
+			Reset();
+			return;
+		}
+		// Thread-local content is asked for explicitly, keep it as a ContentData.
+		if (!threadLocal && count <= SmallCapacity) {
+			SetSmall(string, (int32)count);
 			return;
 		}
 
+		Memory::TagScope tag{ MemoryTag::String };
 		sizeint len = count + 1;
 		UniquePtr<u8char[]> strData = UniquePtr<u8char[]>::Create(len);
 		std::memcpy(strData.GetRaw(), string, count);
 		std::memset(strData.GetRaw() + len-1, '\0', 1);
 
-		data = IntrusivePtr<ContentData>::Create(Memory::Move(strData), len);
-		refStart = 0;
-		refCount = count;
+		SetShared(IntrusivePtr<ContentData>::Create(Memory::Move(strData), (int32)len, threadLocal), 0, (int32)count);
 	}
 
+	bool String::IsSmall() const {
+		return smallCount != SharedMark;
+	}
 	bool String::IsIndividual() const {
-		return (refStart == 0 && refCount == data->length - 1);
+		if (IsSmall()) {
+			return true;
+		}
+		const SharedView& view = GetShared();
+		return (view.refStart == 0 && view.refCount == view.data->length - 1);
+	}
+
+	bool String::IsNullTerminated() const {
+		if (IsSmall()) {
+			return true;
+		}
+		const SharedView& view = GetShared();
+		return view.refStart + view.refCount == view.data->length - 1;
 	}
 
 	String String::ToIndividual() const {
 		if (IsIndividual()) {
 			return *this;
 		}
-		return String(data->data + refStart, refCount);
+		return String(GetStartPtr(), GetCount());
+	}
+	String String::ToThreadLocal() const {
+		if (IsThreadLocal() && IsIndividual()) {
+			return *this;
+		}
+		String result;
+		result.PrepareData(GetStartPtr(), GetCount(), true);
+		return result;
+	}
+	bool String::IsThreadLocal() const {
+		return !IsSmall() && GetShared().data->IsThreadLocal();
 	}
 
 	u8char String::operator[](int32 index) const {
 		ERR_ASSERT(index >= 0 && index <= GetCount(), u8"index out of bounds.", return '\0');
 		
-		return *(data->data + refStart + index);
+		return *(GetStartPtr() + index);
 	}
 
 	int32 String::GetCount() const {
-		return refCount;
+		return IsSmall() ? smallCount : GetShared().refCount;
 	}
 
 	const u8char* String::GetRawArray() const {
-		return data->data;
+		return IsSmall() ? reinterpret_cast<const u8char*>(storage) : GetShared().data->data;
 	}
 
 	int32 String::IndexOf(const String& pattern,int32 startFrom,int32 count) const {
@@ -163,10 +445,39 @@ namespace Engine {
 		if (count == -1) {
 			count = GetCount() - startFrom;
 		}
-		int32 found=searcher.Search(GetStartPtr()+startFrom, count, pattern.GetStartPtr(), pattern.GetCount());
+		if (pattern.GetCount() == 0) {
+			return startFrom;
+		}
+		int32 found = (pattern.GetCount() == 1 ?
+			FindChar(GetStartPtr() + startFrom, count, pattern.GetStartPtr()[0]) :
+			FindPattern(GetStartPtr() + startFrom, count, pattern.GetStartPtr(), pattern.GetCount())
+		);
+		return (found < 0 ? -1 : startFrom + found);
+	}
+	int32 String::IndexOf(u8char c, int32 startFrom, int32 count) const {
+		ERR_ASSERT(startFrom >= 0 && startFrom < GetCount(), u8"startFrom out of bounds.", return -1);
+		ERR_ASSERT(count >= -1 && count <= (GetCount() - startFrom), u8"count out of bounds.", return -1);
+
+		if (count == -1) {
+			count = GetCount() - startFrom;
+		}
+		int32 found = FindChar(GetStartPtr() + startFrom, count, c);
 		return (found < 0 ? -1 : startFrom + found);
 	}
 
+	int32 String::IndexOfAny(const CharMask& chars, int32 startFrom) const {
+		ERR_ASSERT(startFrom >= 0 && startFrom <= GetCount(), u8"startFrom out of bounds.", return -1);
+
+		const u8char* text = GetStartPtr();
+		int32 count = GetCount();
+		for (int32 i = startFrom; i < count; i += 1) {
+			if (chars.Contains(text[i])) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
 	bool String::Contains(const String& pattern) const {
 		return IndexOf(pattern) >= 0;
 	}
@@ -175,16 +486,87 @@ namespace Engine {
 		ERR_ASSERT(startIndex >= 0 && startIndex < GetCount(), u8"startIndex out of bounds.", return String());
 		ERR_ASSERT(count >= 0 && count <= (GetCount() - startIndex), u8"count out of bounds.", return String());
 
-		String substr = *this;
-		substr.refStart = startIndex;
-		substr.refCount = count;
-		return substr;
+		if (IsSmall()) {
+			return String(GetStartPtr() + startIndex, count);
+		}
+		const SharedView& view = GetShared();
+		return String(view.data, view.refStart + startIndex, count);
+	}
+
+	String String::Slice(int32 startIndex, int32 count) const {
+		if (count == 0) {
+			return String();
+		}
+		if (IsSmall()) {
+			return String(GetStartPtr() + startIndex, count);
+		}
+		const SharedView& view = GetShared();
+		return String(view.data, view.refStart + startIndex, count);
 	}
 
-	List<sizeint> String::replacerIndexes{ 32 };
+	List<String> String::Split(const String& separator, bool skipEmpty) const {
+		List<String> result;
+		Tokenizer tokenizer(*this, separator, skipEmpty);
+		String piece;
+		while (tokenizer.Next(piece)) {
+			result.Add(Memory::Move(piece));
+		}
+		return result;
+	}
+	String::Tokenizer String::Tokenize(const String& separator, bool skipEmpty) const {
+		return Tokenizer(*this, separator, skipEmpty);
+	}
+
+	String::Tokenizer::Tokenizer(const String& source, const String& separator, bool skipEmpty) :source(source), separator(separator), skipEmpty(skipEmpty) {}
+
+	bool String::Tokenizer::Advance(int32& start, int32& count) {
+		int32 total = source.GetCount();
+		int32 separatorCount = separator.GetCount();
+		while (!finished) {
+			start = position;
+			int32 index = (separatorCount == 0 || position >= total ? -1 : source.IndexOf(separator, position));
+			if (index < 0) {
+				count = total - position;
+				position = total;
+				finished = true;
+			} else {
+				count = index - position;
+				position = index + separatorCount;
+			}
+			if (count > 0 || !skipEmpty) {
+				return true;
+			}
+		}
+		return false;
+	}
+	bool String::Tokenizer::Next(String& result) {
+		int32 start, count;
+		if (!Advance(start, count)) {
+			return false;
+		}
+		result = source.Slice(start, count);
+		return true;
+	}
+	bool String::Tokenizer::Next(std::string_view& result) {
+		int32 start, count;
+		if (!Advance(start, count)) {
+			return false;
+		}
+		result = std::string_view((const char*)source.GetStartPtr() + start, count);
+		return true;
+	}
+	String String::Tokenizer::GetRemaining() const {
+		if (finished) {
+			return String();
+		}
+		return source.Slice(position, source.GetCount() - position);
+	}
 
 	String String::Replace(const String& from, const String& to) const {
-		replacerIndexes.Clear();
+		if (from.GetCount() == 0) {
+			return *this;
+		}
+		SmallList<int32, 16> replacerIndexes;
 
 		// Search for appearence times.
 		{
@@ -205,9 +587,13 @@ namespace Engine {
 			return *this;
 		}
 
+		Memory::TagScope tag{ MemoryTag::String };
 		sizeint rawlen = GetCount() + (-from.GetCount() + to.GetCount()) * times + 1;
-		UniquePtr<u8char[]> rawptr = UniquePtr<u8char[]>::Create(rawlen);
-		u8char* raw = rawptr.GetRaw();
+		// Small results are built on the stack and copied inline.
+		bool small = (rawlen - 1 <= SmallCapacity);
+		u8char buffer[SmallCapacity + 1];
+		UniquePtr<u8char[]> rawptr = (small ? UniquePtr<u8char[]>() : UniquePtr<u8char[]>::Create(rawlen));
+		u8char* raw = (small ? buffer : rawptr.GetRaw());
 
 		// Fill the string.
 		sizeint rawi = 0;
@@ -222,23 +608,20 @@ namespace Engine {
 			rawi += to.GetCount();
 		}
 		sizeint end = replacerIndexes.Get(times-1);
-		std::memcpy(raw + rawi, GetStartPtr() + (end + 1), GetCount() - (end + 1));
+		std::memcpy(raw + rawi, GetStartPtr() + (end + from.GetCount()), GetCount() - (end + from.GetCount()));
 		std::memset(raw + rawlen - 1, '\0', 1);
 
-		return String(IntrusivePtr<ContentData>::Create(Memory::Move(rawptr), rawlen));
+		if (small) {
+			return String(raw, (int32)rawlen - 1);
+		}
+		return String(IntrusivePtr<ContentData>::Create(Memory::Move(rawptr), (int32)rawlen));
 	}
 
 	bool String::StartsWith(const String& pattern) const {
-		if (GetCount() < pattern.GetCount()) {
-			return false;
-		}
-		return (Substring(0, pattern.GetCount()) == pattern);
+		return GetStringView().starts_with(pattern.GetStringView());
 	}
 	bool String::EndsWith(const String& pattern) const {
-		if (GetCount() < pattern.GetCount()) {
-			return false;
-		}
-		return (Substring(GetCount() - pattern.GetCount(), pattern.GetCount()) == pattern);
+		return GetStringView().ends_with(pattern.GetStringView());
 	}
 
 	bool String::IsEqual(const String& obj) const {
@@ -246,23 +629,22 @@ namespace Engine {
 			return false;
 		}
 
-		if (data.GetRaw() == obj.data.GetRaw() && refStart == obj.refStart) {
-			return true;
-		}
-
-		if (GetHashCode() != obj.GetHashCode()) {
-			return false;
-		}
+		if (!IsSmall() && !obj.IsSmall()) {
+			const SharedView& a = GetShared();
+			const SharedView& b = obj.GetShared();
+			if (a.data.GetRaw() == b.data.GetRaw() && a.refStart == b.refStart) {
+				return true;
+			}
 
-		const u8char* ptrA = GetStartPtr();
-		const u8char* ptrB = obj.GetStartPtr();
-		for (int i = 0; i < GetCount(); i += 1, ptrA += 1, ptrB += 1) {
-			if (*ptrA != *ptrB) {
+			// Only use hash codes already cached, computing them costs more than comparing the bytes.
+			int32 hashA;
+			int32 hashB;
+			if (IsIndividual() && obj.IsIndividual() && a.data->TryGetCachedHashCode(hashA) && b.data->TryGetCachedHashCode(hashB) && hashA != hashB) {
 				return false;
 			}
 		}
 
-		return true;
+		return std::memcmp(GetStartPtr(), obj.GetStartPtr(), GetCount()) == 0;
 	}
 
 	bool String::operator==(const String& obj) const {
@@ -271,28 +653,135 @@ namespace Engine {
 	bool String::operator!=(const String& obj) const {
 		return !IsEqual(obj);
 	}
+	bool String::operator==(std::string_view obj) const {
+		return GetStringView() == obj;
+	}
+	bool String::operator!=(std::string_view obj) const {
+		return GetStringView() != obj;
+	}
+	bool String::operator<(const String& obj) const {
+		return GetStringView() < obj.GetStringView();
+	}
+	bool String::operator<(std::string_view obj) const {
+		return GetStringView() < obj;
+	}
 
 	String String::ToString() const {
 		return *this;
 	}
 	int32 String::GetHashCode() const {
-		return ObjectUtil::GetHashCode(std::hash<std::string_view>{}(GetStringView()));
+		// Parts of a larger block can't use the cached hash code of the block, small content is hashed directly.
+		if (!IsSmall() && IsIndividual()) {
+			return GetShared().data->GetHashCode();
+		}
+		return ObjectUtil::GetHashCode(GetStringView());
 	}
 
 	int32 String::GetStartIndex() const {
-		return refStart;
+		return IsSmall() ? 0 : GetShared().refStart;
 	}
 	const u8char* String::GetStartPtr() const {
-		return data->data + refStart;
+		if (IsSmall()) {
+			return reinterpret_cast<const u8char*>(storage);
+		}
+		const SharedView& view = GetShared();
+		return view.data->data + view.refStart;
 	}
 
-	String String::operator+(const String& obj) {
-		return String::Format(u8"{0}{1}", *this, obj);
+	String String::RemoveChars(const CharMask& chars) const {
+		int32 first = IndexOfAny(chars);
+		if (first < 0) {
+			return *this;
+		}
+
+		const u8char* text = GetStartPtr();
+		int32 count = GetCount();
+		int32 removed = 0;
+		for (int32 i = first; i < count; i += 1) {
+			removed += (chars.Contains(text[i]) ? 1 : 0);
+		}
+		int32 total = count - removed;
+		if (total == 0) {
+			return String();
+		}
+
+		Memory::TagScope tag{ MemoryTag::String };
+		bool small = (total <= SmallCapacity);
+		u8char buffer[SmallCapacity + 1];
+		UniquePtr<u8char[]> rawptr = (small ? UniquePtr<u8char[]>() : UniquePtr<u8char[]>::Create(total + 1));
+		u8char* raw = (small ? buffer : rawptr.GetRaw());
+
+		std::memcpy(raw, text, first);
+		int32 rawi = first;
+		for (int32 i = first + 1; i < count; i += 1) {
+			raw[rawi] = text[i];
+			// Always write, only advance past the kept chars.
+			rawi += (chars.Contains(text[i]) ? 0 : 1);
+		}
+		raw[total] = '\0';
+
+		if (small) {
+			return String(raw, total);
+		}
+		return String(IntrusivePtr<ContentData>::Create(Memory::Move(rawptr), total + 1));
+	}
+	String String::ReplaceChars(const CharMask& chars, u8char to) const {
+		int32 first = IndexOfAny(chars);
+		if (first < 0) {
+			return *this;
+		}
+
+		const u8char* text = GetStartPtr();
+		int32 count = GetCount();
+		Memory::TagScope tag{ MemoryTag::String };
+		bool small = (count <= SmallCapacity);
+		u8char buffer[SmallCapacity + 1];
+		UniquePtr<u8char[]> rawptr = (small ? UniquePtr<u8char[]>() : UniquePtr<u8char[]>::Create(count + 1));
+		u8char* raw = (small ? buffer : rawptr.GetRaw());
+
+		std::memcpy(raw, text, first);
+		for (int32 i = first; i < count; i += 1) {
+			raw[i] = (chars.Contains(text[i]) ? to : text[i]);
+		}
+		raw[count] = '\0';
+
+		if (small) {
+			return String(raw, count);
+		}
+		return String(IntrusivePtr<ContentData>::Create(Memory::Move(rawptr), count + 1));
+	}
+
+	String String::operator+(const String& obj) const {
+		int32 countA = GetCount();
+		int32 countB = obj.GetCount();
+		int32 total = countA + countB;
+		if (total <= SmallCapacity) {
+			u8char buffer[SmallCapacity + 1];
+			std::memcpy(buffer, GetStartPtr(), countA);
+			std::memcpy(buffer + countA, obj.GetStartPtr(), countB);
+			return String(buffer, total);
+		}
+
+		Memory::TagScope tag{ MemoryTag::String };
+		UniquePtr<u8char[]> raw = UniquePtr<u8char[]>::Create(total + 1);
+		std::memcpy(raw.GetRaw(), GetStartPtr(), countA);
+		std::memcpy(raw.GetRaw() + countA, obj.GetStartPtr(), countB);
+		raw.GetRaw()[total] = '\0';
+		return String(IntrusivePtr<ContentData>::Create(Memory::Move(raw), total + 1));
+	}
+
+	bool String::IsValidUTF8() const {
+		return Unicode::IsValidUTF8(GetStartPtr(), GetCount());
+	}
+	int32 String::GetCodepointCount() const {
+		return Unicode::CountCodepoints(GetStartPtr(), GetCount());
+	}
+	Unicode::CodepointRange String::GetCodepoints() const {
+		return Unicode::CodepointRange(GetStartPtr(), GetCount());
 	}
 
 	std::string_view String::GetStringView() const {
 		return std::string_view(reinterpret_cast<const char*>(GetStartPtr()), GetCount());
 	}
 
-	String::SearcherSunday String::searcher{};
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Engine/System/Memory/UniquePtr.h"
 #include "Engine/System/Memory/IntrusivePtr.h"
 #include "Engine/System/Collection/List.h"
+#include "Engine/System/Unicode.h"
 #include <string_view>
 
 /// @brief Make a UTF-8 String literal. No need to add u8 prefix.
@@ -22,7 +23,8 @@
 
 namespace Engine {
 	/// @brief A string holding a NULL-termined char array.
-	/// The actual content is reference counted, so it's cheap to copy around.
+	/// Content up to SmallCapacity chars is stored inline in the String, without heap allocation or reference counting.\n
+	/// Larger content, literals and thread-local content is reference counted, so it's cheap to copy around.
 	class String final {
 	public:
 		/// @brief Container of actual content data of Strings. Shared between Strings. 
@@ -36,7 +38,8 @@ namespace Engine {
 			/// @brief Accept data as a memory block on heap. Will free the data.
 			/// @param data A UniquePtr holding string data block on heap. Use Memory::Move to "move" it in.
 			/// @param length The length of the given string data block. NULL included.
-			ContentData(UniquePtr<u8char[]>&& data, int32 length);
+			/// @param threadLocal Use non-atomic reference counting. The content must never leave the current thread.
+			ContentData(UniquePtr<u8char[]>&& data, int32 length, bool threadLocal = false);
 
 			~ContentData();
 
@@ -48,12 +51,23 @@ namespace Engine {
 			uint32 Reference() const;
 			uint32 Dereference() const;
 			uint32 GetReferenceCount() const;
+			bool IsThreadLocal() const;
+
+			/// @brief Get the hash code of the whole block, computed on the first call and cached.
+			int32 GetHashCode() const;
+			/// @brief Get the cached hash code of the whole block without computing it.
+			/// @return false if GetHashCode() hasn't been called yet.
+			bool TryGetCachedHashCode(int32& result) const;
 
 			/// @brief Get the global empty content data.
 			static IntrusivePtr<ContentData> GetEmpty();
 		private:
 			bool staticData;
+			bool threadLocal = false;
 			mutable ReferenceCount referenceCount;
+			mutable LocalReferenceCount localReferenceCount;
+			mutable AtomicValue<int32> hashCode{ 0 };
+			mutable AtomicValue<bool> hashCached{ false };
 		};
 
 		class SearcherSunday {
@@ -63,6 +77,26 @@ namespace Engine {
 			int32 charPos[256] = { -1 };
 		};
 
+		/// @brief A set of chars as a 256-bit mask, for testing a char with a single lookup.\n
+		/// Multi-byte UTF-8 chars can't be told apart by their bytes, use it for ASCII chars only.
+		class CharMask final {
+		public:
+			constexpr CharMask() = default;
+			constexpr CharMask(std::string_view chars) {
+				for (char c : chars) {
+					Add((u8char)c);
+				}
+			}
+			constexpr void Add(u8char c) {
+				bits[(byte)c >> 6] |= (uint64)1 << ((byte)c & 63);
+			}
+			constexpr bool Contains(u8char c) const {
+				return (bits[(byte)c >> 6] >> ((byte)c & 63)) & 1;
+			}
+		private:
+			uint64 bits[4] = {};
+		};
+
 		/// @brief Get the global empty String.
 		static String GetEmpty();
 
@@ -84,23 +118,40 @@ namespace Engine {
 		/// @param start The start index of referencing content.
 		/// @param count The char count for referencing content. NULL NOT included. -1 for auto detection.
 		String(IntrusivePtr<ContentData> dataPtr, int32 start = 0, int32 count = -1);
+
+		String(const String& obj);
+		String& operator=(const String& obj);
+		String(String&& obj) noexcept;
+		String& operator=(String&& obj) noexcept;
+		~String();
 #pragma endregion
 
 #pragma region Tool functions
 		/// @brief Get char count. NULL NOT included.
 		int32 GetCount() const;
 
-		/// @brief Get the internal C-Style string array pointer. Do not store the pointer.
+		/// @brief Get the internal C-Style string array pointer. Do not store the pointer.\n
+		/// Small content lives inside the String, the pointer is invalidated when the String is moved or destroyed.
 		const u8char* GetRawArray() const;
 
 		/// @brief Check if the string is a individual one.
 		/// Individual string means that the content of this string is exactally the same as the underlying raw string array.
 		bool IsIndividual() const;
+		/// @brief Check if the char right after the content is NULL, so GetStartPtr() is a C-Style string as it is.\n
+		/// True for individual strings and for the substrings running to the end of a shared one.
+		bool IsNullTerminated() const;
 		
 		/// @return A individual string whose content is the same as current string.
 		/// If current string is already individual, return self.
 		String ToIndividual() const;
 
+		/// @return A individual copy of current string whose content is counted non-atomically.\n
+		/// Copying it around is cheaper, but the result and all its copies must stay on the current thread.
+		String ToThreadLocal() const;
+
+		/// @brief Check if the content is counted non-atomically. See ToThreadLocal().
+		bool IsThreadLocal() const;
+
 		/// @brief Get the char at the given index.
 		u8char operator[](int32 index) const;
 
@@ -113,6 +164,18 @@ namespace Engine {
 		/// -1 if not found.
 		int32 IndexOf(const String& pattern,int32 startFrom=0,int32 count=-1) const;
 
+		/// @brief Find the position of the char appearance in the string.
+		/// @param c The char to search.
+		/// @param startFrom The index to start searching from.
+		/// @param count The count of chars from the start index to search.
+		/// -1 to search to the end of the string.
+		/// @return The position of the char. -1 if not found.
+		int32 IndexOf(u8char c, int32 startFrom = 0, int32 count = -1) const;
+
+		/// @brief Find the position of the first char in the mask.
+		/// @return -1 if none of the chars appear.
+		int32 IndexOfAny(const CharMask& chars, int32 startFrom = 0) const;
+
 		/// @brief Check if the string contains another string.
 		/// @param pattern The substring to search.
 		bool Contains(const String& pattern) const;
@@ -129,11 +192,28 @@ namespace Engine {
 		/// @param count The count of chars from the start index to cut.
 		String Substring(int32 startIndex, int32 count) const;
 
+		/// @brief Split the string into the pieces between the separators.\n
+		/// Pieces of a shared String reference its content instead of copying it, pieces of a small String are small themselves.
+		/// @param separator The substring to split at. An empty separator gives back the whole string as one piece.
+		/// @param skipEmpty Leave out the empty pieces between adjacent separators and at both ends.
+		List<String> Split(const String& separator, bool skipEmpty = false) const;
+
+		class Tokenizer;
+		/// @brief Get a Tokenizer walking the same pieces as Split(), one at a time without collecting them.
+		Tokenizer Tokenize(const String& separator, bool skipEmpty = false) const;
+
 		/// @brief Replace a substring to another.
 		/// @param from The substring to be replaced.
 		/// @param to The string to be replaced to.
 		String Replace(const String& from, const String& to) const;
 
+		/// @brief Remove all the chars in the mask in one pass.
+		/// @return The String itself, without copying, if none of the chars appear.
+		String RemoveChars(const CharMask& chars) const;
+		/// @brief Replace all the chars in the mask with another char in one pass.
+		/// @return The String itself, without copying, if none of the chars appear.
+		String ReplaceChars(const CharMask& chars, u8char to) const;
+
 		String ToString() const;
 		int32 GetHashCode() const;
 
@@ -142,8 +222,25 @@ namespace Engine {
 
 		bool operator==(const String& obj) const;
 		bool operator!=(const String& obj) const;
-
+		/// @brief Compare the content with a view, without constructing a String.
+		bool operator==(std::string_view obj) const;
+		bool operator!=(std::string_view obj) const;
+		/// @brief Compare the UTF-8 bytes lexicographically.
+		bool operator<(const String& obj) const;
+		bool operator<(std::string_view obj) const;
+
+		/// @brief Get a view of the content. Like GetRawArray(), don't keep it past the String.
 		std::string_view GetStringView() const;
+
+		/// @brief Check if the content is stored inline in the String.
+		bool IsSmall() const;
+
+		/// @brief Check if the content is well-formed UTF-8, see Unicode::IsValidUTF8().
+		bool IsValidUTF8() const;
+		/// @brief Get the count of codepoints instead of chars.
+		int32 GetCodepointCount() const;
+		/// @brief Get the codepoints for a range-based for loop. Like GetRawArray(), don't keep it past the String.
+		Unicode::CodepointRange GetCodepoints() const;
 #pragma endregion
 
 #pragma region Format
@@ -153,24 +250,72 @@ namespace Engine {
 		}
 #pragma endregion
 
-		String operator+(const String& obj);
+		/// @brief Concatenate with a single allocation of the exact size, none if the result is small.\n
+		/// Use StringBuilder to join more pieces.
+		String operator+(const String& obj) const;
+
+		/// @brief The most chars stored inline, without a ContentData.
+		static inline constexpr int32 SmallCapacity = 22;
 
 	private:
+		/// @brief A view into a shared ContentData.
+		struct SharedView {
+			IntrusivePtr<ContentData> data;
+			int32 refStart;
+			int32 refCount;
+		};
+		/// @brief The smallCount of a String holding a SharedView.
+		static inline constexpr byte SharedMark = 0xFF;
+
 		bool IsEqual(const String& obj) const;
+		/// @brief Like Substring() but without the bound checks, and count may be 0.
+		String Slice(int32 startIndex, int32 count) const;
 
 		/// @brief Prepares a string, the string data will be copied.
 		/// Count does not accept -1.
-		void PrepareData(const u8char* string, sizeint count);
-
-		IntrusivePtr<ContentData> data;
+		void PrepareData(const u8char* string, sizeint count, bool threadLocal = false);
+
+		SharedView& GetShared();
+		const SharedView& GetShared() const;
+		/// @brief Replace the content with a copy of the chars. count must not exceed SmallCapacity.
+		void SetSmall(const u8char* string, int32 count);
+		void SetShared(IntrusivePtr<ContentData> dataPtr, int32 start, int32 count);
+		/// @brief Release the shared content if any, leaving an empty small String.
+		void Reset();
+
+		// Small: the chars and the NULL are in storage, smallCount is the char count.
+		// Shared: storage holds a SharedView, smallCount is SharedMark.
+		alignas(SharedView) byte storage[SmallCapacity + 1];
+		byte smallCount = 0;
+		static_assert(sizeof(SharedView) <= SmallCapacity + 1, "A SharedView must fit in the small storage.");
 
-		int32 refStart = 0;
-		int32 refCount = 0;
+	};
 
-		/// @brief Global sunday string searcher.
-		static SearcherSunday searcher;
+	/// @brief Walks the pieces of a String between the separators lazily, see String::Split().\n
+	/// Holds a copy of the source, so the pieces stay valid after the source String is gone.
+	class String::Tokenizer final {
+	public:
+		Tokenizer(const String& source, const String& separator, bool skipEmpty = false);
+
+		/// @brief Get the next piece as a String sharing the content of the source.
+		/// @return false if there are no pieces left.
+		bool Next(String& result);
+		/// @brief Get the next piece as a view into the source, without touching any reference count.\n
+		/// The view is valid as long as the Tokenizer.
+		/// @return false if there are no pieces left.
+		bool Next(std::string_view& result);
+		/// @brief Get the rest of the source after the last piece returned, separators included.
+		String GetRemaining() const;
 
-		static List<sizeint> replacerIndexes;
+	private:
+		/// @brief Find the next piece, returns false when done.
+		bool Advance(int32& start, int32& count);
+
+		String source;
+		String separator;
+		int32 position = 0;
+		bool skipEmpty;
+		bool finished = false;
 	};
 }
 
@@ -0,0 +1,114 @@
+#include "Engine/System/StringBuilder.h"
+#include "Engine/System/Debug.h"
+#include <cstring>
+
+namespace Engine {
+	StringBuilder::StringBuilder(int32 capacity, Allocator* allocator) :allocator(allocator) {
+		Reserve(capacity);
+	}
+	StringBuilder::~StringBuilder() {
+		if (data != nullptr) {
+			Allocator::DeallocateTo(allocator, data, capacity);
+		}
+	}
+	StringBuilder::StringBuilder(StringBuilder&& obj) noexcept :data(obj.data), count(obj.count), capacity(obj.capacity), allocator(obj.allocator) {
+		obj.data = nullptr;
+		obj.count = 0;
+		obj.capacity = 0;
+	}
+	StringBuilder& StringBuilder::operator=(StringBuilder&& obj) noexcept {
+		if (this == &obj) {
+			return *this;
+		}
+		if (data != nullptr) {
+			Allocator::DeallocateTo(allocator, data, capacity);
+		}
+		data = obj.data;
+		count = obj.count;
+		capacity = obj.capacity;
+		allocator = obj.allocator;
+		obj.data = nullptr;
+		obj.count = 0;
+		obj.capacity = 0;
+		return *this;
+	}
+
+	StringBuilder& StringBuilder::Append(std::string_view string) {
+		int32 length = (int32)string.size();
+		if (length == 0) {
+			return *this;
+		}
+		if (count + length > capacity) {
+			Grow(count + length);
+		}
+		std::memcpy(data + count, string.data(), length);
+		count += length;
+		return *this;
+	}
+	StringBuilder& StringBuilder::Append(const String& string) {
+		return Append(string.GetStringView());
+	}
+	StringBuilder& StringBuilder::Append(const u8char* string) {
+		return Append(std::string_view((const char*)string));
+	}
+	StringBuilder& StringBuilder::Append(u8char c) {
+		if (count + 1 > capacity) {
+			Grow(count + 1);
+		}
+		data[count] = c;
+		count += 1;
+		return *this;
+	}
+
+	void StringBuilder::Reserve(int32 capacity) {
+		ERR_ASSERT(capacity >= 0, u8"capacity must not be negative!", return);
+		if (capacity <= this->capacity) {
+			return;
+		}
+		data = (u8char*)(data == nullptr ?
+			Allocator::AllocateFrom(allocator, capacity, alignof(u8char)) :
+			Allocator::ReallocateFrom(allocator, data, this->capacity, capacity, alignof(u8char))
+		);
+		this->capacity = capacity;
+	}
+	void StringBuilder::Grow(int32 count) {
+		int32 target = (capacity < 16 ? 16 : capacity * 2);
+		Reserve(target < count ? count : target);
+	}
+	void StringBuilder::Clear() {
+		count = 0;
+	}
+
+	int32 StringBuilder::GetCount() const {
+		return count;
+	}
+	int32 StringBuilder::GetCapacity() const {
+		return capacity;
+	}
+	Allocator* StringBuilder::GetAllocator() const {
+		return allocator;
+	}
+
+	std::string_view StringBuilder::GetStringView() const {
+		return std::string_view((const char*)data, count);
+	}
+	String StringBuilder::ToString() const {
+		return String(data, count);
+	}
+
+	sizeint StringBuilder::size() const {
+		return count;
+	}
+	void StringBuilder::resize(sizeint count) {
+		if ((int32)count > capacity) {
+			Grow((int32)count);
+		}
+		this->count = (int32)count;
+	}
+	char& StringBuilder::operator[](sizeint index) {
+		return ((char*)data)[index];
+	}
+	void StringBuilder::push_back(char c) {
+		Append((u8char)c);
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/String.h"
+#include "Engine/System/Object/ObjectUtil.h"
+#include "Engine/System/Memory/Allocator.h"
+#include "fmt/format.h"
+#include <string_view>
+#include <iterator>
+#include <type_traits>
+
+namespace Engine {
+	/// @brief Builds a String piece by piece in a growable buffer, instead of making a new String on every concatenation.\n
+	/// Formatting with AppendFormat() writes into the buffer directly.\n
+	/// The buffer comes from the Allocator given on construction, or from Memory by default.
+	class StringBuilder final {
+	public:
+		StringBuilder(int32 capacity = 0, Allocator* allocator = nullptr);
+		~StringBuilder();
+
+		StringBuilder(const StringBuilder&) = delete;
+		StringBuilder& operator=(const StringBuilder&) = delete;
+		StringBuilder(StringBuilder&& obj) noexcept;
+		StringBuilder& operator=(StringBuilder&& obj) noexcept;
+
+		StringBuilder& Append(std::string_view string);
+		StringBuilder& Append(const String& string);
+		StringBuilder& Append(const u8char* string);
+		StringBuilder& Append(u8char c);
+		/// @brief Append a number or a bool the way String::Format() prints it with "{0}".\n
+		/// Numbers are written straight into the buffer with ObjectUtil::ToChars().
+		template<typename T> requires std::is_arithmetic_v<T>
+		StringBuilder& Append(T value) {
+			if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+				fmt::format_to(std::back_inserter(*this), "{}", value);
+			} else {
+				if (count + ObjectUtil::MaxNumberChars > capacity) {
+					Grow(count + ObjectUtil::MaxNumberChars);
+				}
+				count += ObjectUtil::ToChars(value, data + count, capacity - count);
+			}
+			return *this;
+		}
+		/// @brief Append a formatted string, the same format as String::Format().
+		template<typename ... Ts>
+		StringBuilder& AppendFormat(const String& format, const Ts& ... args) {
+			fmt::format_to(std::back_inserter(*this), format.GetStringView(), args...);
+			return *this;
+		}
+
+		/// @brief Make sure the buffer holds at least capacity chars.
+		void Reserve(int32 capacity);
+		/// @brief Remove the content, the buffer is kept.
+		void Clear();
+
+		int32 GetCount() const;
+		int32 GetCapacity() const;
+		/// @brief nullptr means Memory is used.
+		Allocator* GetAllocator() const;
+
+		/// @brief Get a view of the content, invalidated by the next append.
+		std::string_view GetStringView() const;
+		/// @brief Copy the content into a String of the exact size.
+		String ToString() const;
+
+#pragma region fmt contiguous container
+		// The minimal container interface fmt::format_to() writes through, not for direct use.
+		using value_type = char;
+		sizeint size() const;
+		void resize(sizeint count);
+		char& operator[](sizeint index);
+		void push_back(char c);
+#pragma endregion
+
+	private:
+		void Grow(int32 count);
+
+		u8char* data = nullptr;
+		int32 count = 0;
+		int32 capacity = 0;
+		Allocator* allocator = nullptr;
+	};
+}
+
+namespace fmt {
+	template<>
+	struct is_contiguous<::Engine::StringBuilder> : std::true_type {};
+}
@@ -0,0 +1,166 @@
+#include "Engine/System/StringName.h"
+#include "Engine/System/Object/ObjectUtil.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+#include "Engine/System/Thread/Atomic.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Memory/Memory.h"
+#include <mutex>
+
+namespace Engine {
+	struct StringName::Entry {
+		Entry(const String& string, int32 hash) :string(string), hash(hash) {}
+
+		String string;
+		int32 hash;
+		AtomicValue<uint32> referenceCount{ 1 };
+	};
+
+	struct StringName::InternTable {
+		/// @brief Shards are picked by the highest bits of the hash, the tables inside use the lower ones.
+		static inline constexpr int32 ShardBits = 4;
+		static inline constexpr int32 ShardCount = 1 << ShardBits;
+
+		struct alignas(ThreadUtil::CacheLineSize) Shard {
+			std::mutex mutex;
+			FlatDictionary<String, Entry*> entries;
+		};
+		Shard shards[ShardCount];
+
+		Shard& GetShard(int32 hash) {
+			return shards[(uint32)hash >> (32 - ShardBits)];
+		}
+	};
+
+	StringName::InternTable& StringName::GetTable() {
+		// Never destroyed, static StringNames may still be released during static destruction.
+		static InternTable* table = MEMNEW(InternTable);
+		return *table;
+	}
+
+	StringName::Entry* StringName::Intern(std::string_view string, const String* source) {
+		if (string.empty()) {
+			return nullptr;
+		}
+
+		int32 hash = ObjectUtil::GetHashCode(string);
+		InternTable::Shard& shard = GetTable().GetShard(hash);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		Entry** found = shard.entries.Find(string);
+		if (found != nullptr) {
+			(*found)->referenceCount.FetchAdd(1);
+			return *found;
+		}
+
+		// The entry outlives the source, so don't keep a part of a larger String or a thread-local one.
+		bool reusable = (source != nullptr && source->IsIndividual() && !source->IsThreadLocal());
+		String content = (reusable ? *source : String((const u8char*)string.data(), (int32)string.size()));
+		Entry* entry = MEMNEW(Entry(content, hash));
+		shard.entries.Add(content, entry);
+		return entry;
+	}
+
+	void StringName::Release() {
+		if (entry == nullptr) {
+			return;
+		}
+		Entry* target = entry;
+		entry = nullptr;
+
+		// Only the last reference is dropped under the lock, so Intern() never picks up an entry being removed.
+		uint32 count = target->referenceCount.Get();
+		while (count > 1) {
+			if (target->referenceCount.CompareExchange(count, count - 1)) {
+				return;
+			}
+		}
+
+		InternTable::Shard& shard = GetTable().GetShard(target->hash);
+		{
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			if (target->referenceCount.Subtract(1) > 0) {
+				// Interned again while waiting for the lock.
+				return;
+			}
+			shard.entries.Remove(target->string);
+		}
+		MEMDEL(target);
+	}
+
+	StringName::StringName(const String& string) :entry(Intern(string.GetStringView(), &string)) {}
+	StringName::StringName(std::string_view string) : entry(Intern(string, nullptr)) {}
+	StringName::StringName(const u8char* string) : entry(Intern(std::string_view((const char*)string), nullptr)) {}
+	StringName::~StringName() {
+		Release();
+	}
+
+	StringName::StringName(const StringName& obj) :entry(obj.entry) {
+		if (entry != nullptr) {
+			entry->referenceCount.FetchAdd(1);
+		}
+	}
+	StringName& StringName::operator=(const StringName& obj) {
+		if (entry == obj.entry) {
+			return *this;
+		}
+		if (obj.entry != nullptr) {
+			obj.entry->referenceCount.FetchAdd(1);
+		}
+		Release();
+		entry = obj.entry;
+		return *this;
+	}
+	StringName::StringName(StringName&& obj) noexcept :entry(obj.entry) {
+		obj.entry = nullptr;
+	}
+	StringName& StringName::operator=(StringName&& obj) noexcept {
+		if (this == &obj) {
+			return *this;
+		}
+		Release();
+		entry = obj.entry;
+		obj.entry = nullptr;
+		return *this;
+	}
+
+	StringName StringName::Find(std::string_view string) {
+		StringName result;
+		if (string.empty()) {
+			return result;
+		}
+
+		InternTable::Shard& shard = GetTable().GetShard(ObjectUtil::GetHashCode(string));
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		Entry** found = shard.entries.Find(string);
+		if (found != nullptr) {
+			(*found)->referenceCount.FetchAdd(1);
+			result.entry = *found;
+		}
+		return result;
+	}
+	int32 StringName::GetInternedCount() {
+		int32 count = 0;
+		for (InternTable::Shard& shard : GetTable().shards) {
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			count += shard.entries.GetCount();
+		}
+		return count;
+	}
+
+	bool StringName::IsEmpty() const {
+		return entry == nullptr;
+	}
+	const String& StringName::GetString() const {
+		static const String empty = String::GetEmpty();
+		return entry == nullptr ? empty : entry->string;
+	}
+	std::string_view StringName::GetStringView() const {
+		return GetString().GetStringView();
+	}
+	String StringName::ToString() const {
+		return GetString();
+	}
+	int32 StringName::GetHashCode() const {
+		return entry == nullptr ? ObjectUtil::GetHashCode(std::string_view()) : entry->hash;
+	}
+}
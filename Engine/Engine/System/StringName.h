@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/String.h"
+#include <string_view>
+#include <functional>
+
+namespace Engine {
+	/// @brief An interned String for identifiers, such as method, property, signal and node names.\n
+	/// StringNames with the same content share one entry of a global intern table,
+	/// so comparing two of them is a pointer compare and the hash code is computed only once.\n
+	/// Making one from a String looks it up in the table under a lock. Keep StringNames around instead of making them on every call.\n
+	/// Entries are reference counted and leave the table together with their last StringName.\n
+	/// operator< orders by identity instead of content, which is enough for sorted lookups but differs between runs.
+	class StringName final {
+	public:
+		StringName() = default;
+		StringName(const String& string);
+		StringName(std::string_view string);
+		StringName(const u8char* string);
+		~StringName();
+
+		StringName(const StringName& obj);
+		StringName& operator=(const StringName& obj);
+		StringName(StringName&& obj) noexcept;
+		StringName& operator=(StringName&& obj) noexcept;
+
+		/// @brief Get the StringName of the content only if it is interned already, without adding it to the table.
+		/// @return An empty StringName when the content isn't interned.
+		static StringName Find(std::string_view string);
+		/// @brief Get the entry count of the global intern table.
+		static int32 GetInternedCount();
+
+		bool IsEmpty() const;
+		const String& GetString() const;
+		std::string_view GetStringView() const;
+
+		String ToString() const;
+		/// @brief The same as the hash code of a String with the same content.
+		int32 GetHashCode() const;
+
+		bool operator==(const StringName& obj) const {
+			return entry == obj.entry;
+		}
+		bool operator!=(const StringName& obj) const {
+			return entry != obj.entry;
+		}
+		bool operator<(const StringName& obj) const {
+			return std::less<const Entry*>()(entry, obj.entry);
+		}
+
+	private:
+		struct Entry;
+		struct InternTable;
+		static InternTable& GetTable();
+		static Entry* Intern(std::string_view string, const String* source);
+		void Release();
+
+		Entry* entry = nullptr;
+	};
+}
+
+namespace fmt {
+	template<>
+	struct formatter<::Engine::StringName> : formatter<string_view> {
+		template <typename FormatContext>
+		auto format(const ::Engine::StringName& c, FormatContext& ctx) {
+			return formatter<string_view>::format(c.GetStringView(), ctx);
+		}
+	};
+}
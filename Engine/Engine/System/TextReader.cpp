@@ -0,0 +1,72 @@
+#include "Engine/System/TextReader.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include <cstring>
+
+namespace Engine {
+	TextReader::TextReader(const IntrusivePtr<Stream>& stream, int32 bufferSize) :stream(stream), bufferSize(bufferSize) {
+		ERR_ASSERT(bufferSize > 0, u8"bufferSize must be greater than 0.", this->bufferSize = DefaultBufferSize);
+		ERR_ASSERT(stream.GetRaw() != nullptr && stream->CanRead(), u8"The stream cannot read.", ended = true);
+	}
+
+	bool TextReader::ReadLine(String& line) {
+		int32 searchFrom = start;
+		while (true) {
+			int32 found = (searchFrom < end ? block.IndexOf(u8'\n', searchFrom, end - searchFrom) : -1);
+			if (found >= 0) {
+				line = MakeLine(start, found);
+				start = found + 1;
+				return true;
+			}
+			if (ended) {
+				if (start == end) {
+					return false;
+				}
+				line = MakeLine(start, end);
+				start = end;
+				return true;
+			}
+			// The chars kept for the next block are already known to have no '\n'.
+			searchFrom = end - start;
+			Fill();
+		}
+	}
+	bool TextReader::IsEnd() {
+		if (start == end && !ended) {
+			Fill();
+		}
+		return start == end && ended;
+	}
+	const IntrusivePtr<Stream>& TextReader::GetStream() const {
+		return stream;
+	}
+
+	void TextReader::Fill() {
+		int32 kept = end - start;
+		// A line longer than the buffer makes the blocks bigger.
+		int32 capacity = (kept * 2 > bufferSize ? kept * 2 : bufferSize);
+
+		Memory::TagScope tag{ MemoryTag::String };
+		UniquePtr<u8char[]> data = UniquePtr<u8char[]>::Create(capacity + 1);
+		if (kept > 0) {
+			std::memcpy(data.GetRaw(), block.GetStartPtr() + start, kept);
+		}
+		int32 read = stream->ReadBytes((byte*)data.GetRaw() + kept, capacity - kept);
+		if (read == 0) {
+			ended = true;
+		}
+		int32 count = kept + read;
+		data.GetRaw()[count] = '\0';
+		block = String(IntrusivePtr<String::ContentData>::Create(Memory::Move(data), count + 1));
+		start = 0;
+		end = count;
+	}
+	String TextReader::MakeLine(int32 start, int32 end) const {
+		if (end > start && block.GetStartPtr()[end - 1] == u8'\r') {
+			end -= 1;
+		}
+		if (end == start) {
+			return String::GetEmpty();
+		}
+		return block.Substring(start, end - start);
+	}
+}
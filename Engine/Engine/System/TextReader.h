@@ -0,0 +1,40 @@
+#pragma once
+#include "Engine/System/Stream.h"
+#include "Engine/System/Memory/IntrusivePtr.h"
+
+namespace Engine {
+	/// @brief Reads lines of text from a Stream a block at a time.\n
+	/// A block is read into a ContentData of its own and scanned for '\n' with the SIMD search of String::IndexOf().
+	/// The lines are views into the block, so reading a line neither allocates nor copies,
+	/// and a block stays alive as long as one of its lines does.\n
+	/// The stream is read from its current position, and the reader is ahead of it by up to a block.
+	class TextReader final {
+	public:
+		static inline constexpr int32 DefaultBufferSize = 16384;
+
+		TextReader(const IntrusivePtr<Stream>& stream, int32 bufferSize = DefaultBufferSize);
+		TextReader(const TextReader&) = delete;
+		TextReader& operator=(const TextReader&) = delete;
+
+		/// @brief Read up to the next '\n', without it and a '\r' before it.\n
+		/// The last line doesn't need a '\n'.
+		/// @return false at the end of the stream, with line left as it is.
+		bool ReadLine(String& line);
+		/// @brief Whether every line has been read.
+		bool IsEnd();
+		const IntrusivePtr<Stream>& GetStream() const;
+
+	private:
+		/// @brief Start a new block with the unread chars of the current one, followed by the next part of the stream.
+		void Fill();
+		String MakeLine(int32 start, int32 end) const;
+
+		IntrusivePtr<Stream> stream{};
+		int32 bufferSize;
+		/// @brief A view over a whole block, the unread chars are [start, end).
+		String block{};
+		int32 start = 0;
+		int32 end = 0;
+		bool ended = false;
+	};
+}
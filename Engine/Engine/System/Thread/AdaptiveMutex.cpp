@@ -0,0 +1,30 @@
+#include "Engine/System/Thread/AdaptiveMutex.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+
+namespace Engine {
+	void AdaptiveMutex::LockSlow() {
+		if (ThreadUtil::IsSpinningUseful()) {
+			// Spin up to twice as long as it took lately, a bit more so it recovers after a run of sleeps.
+			int32 estimate = spins.load(std::memory_order_relaxed);
+			int32 limit = estimate * 2 + 10;
+			limit = limit < MaxSpins ? limit : MaxSpins;
+			for (int32 i = 0; i < limit; i += 1) {
+				// Only try once it looks free, failed exchanges steal the cache line from the holder.
+				if (state.load(std::memory_order_relaxed) == Unlocked) {
+					uint32 expected = Unlocked;
+					if (state.compare_exchange_weak(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+						spins.store(estimate + (i - estimate) / 8, std::memory_order_relaxed);
+						return;
+					}
+				}
+				ThreadUtil::SpinPause();
+			}
+			spins.store(estimate + (limit - estimate) / 8, std::memory_order_relaxed);
+		}
+
+		// Marked contended so the holder wakes us, whoever takes it from here keeps it marked in case others sleep too.
+		while (state.exchange(Contended, std::memory_order_acquire) != Unlocked) {
+			state.wait(Contended, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include <atomic>
+
+namespace Engine {
+	/// @brief A mutex for short critical sections, spinning a while before sleeping when it is taken.\n
+	/// A Mutex goes to the kernel as soon as it is contended, which costs far more than a critical section of a few instructions.
+	/// This one spins first, for about as long as it took to get the lock lately, and only then sleeps on the atomic,
+	/// which is a futex on Linux. Uncontended, locking and unlocking are a single atomic operation each.\n
+	/// Works with SimpleLock, AdvanceLock and ProfiledLock, not with ConditionVariable.
+	/// Prefer Mutex for sections that may block or run long, spinning on those only wastes the core.
+	class AdaptiveMutex final {
+	public:
+		/// @brief Most spins before sleeping.
+		static inline constexpr int32 MaxSpins = 128;
+
+		AdaptiveMutex() = default;
+		AdaptiveMutex(const AdaptiveMutex&) = delete;
+		AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+
+		void lock() {
+			uint32 expected = Unlocked;
+			if (!state.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+				LockSlow();
+			}
+		}
+		bool try_lock() {
+			uint32 expected = Unlocked;
+			return state.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+		}
+		void unlock() {
+			if (state.exchange(Unlocked, std::memory_order_release) == Contended) {
+				state.notify_one();
+			}
+		}
+
+	private:
+		static inline constexpr uint32 Unlocked = 0;
+		static inline constexpr uint32 Locked = 1;
+		/// @brief Locked, and some thread may be sleeping on it.
+		static inline constexpr uint32 Contended = 2;
+
+		void LockSlow();
+
+		std::atomic<uint32> state{ Unlocked };
+		/// @brief Running average of the spins the lock took to get lately, a hint only.
+		std::atomic<int32> spins{ 0 };
+	};
+}
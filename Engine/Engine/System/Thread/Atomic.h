@@ -19,6 +19,10 @@ namespace Engine {
 		T Exchange(T value) {
 			return this->value.exchange(value, std::memory_order_acq_rel);
 		}
+		// Replaces with desired if the value equals to expected, otherwise loads the current value to expected.
+		bool CompareExchange(T& expected, T desired) {
+			return this->value.compare_exchange_strong(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire);
+		}
 		// Returns the value before operation.
 		T FetchAdd(T value) {
 			return this->value.fetch_add(value, std::memory_order_acq_rel);
@@ -60,20 +64,61 @@ namespace Engine {
 		std::atomic<bool> value;
 	};
 
+	/// @brief Thread-safe reference counter.\n
+	/// Increments are relaxed since taking a new reference requires already holding one.
+	/// Only decrements synchronize, so the thread dropping the last reference sees all writes to the object.
 	class ReferenceCount {
 	public:
 		ReferenceCount(uint32 count = 0) :count(count) {}
 
 		uint32 Get() const {
-			return count.Get();
+			return count.load(std::memory_order_acquire);
+		}
+		uint32 Reference() {
+			return count.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+		uint32 Dereference() {
+			return count.fetch_sub(1, std::memory_order_acq_rel) - 1;
+		}
+		/// @brief Take a reference only if some are left, for weak references to objects that may be dying.
+		bool TryReference() {
+			uint32 current = count.load(std::memory_order_relaxed);
+			while (current > 0) {
+				if (count.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+					return true;
+				}
+			}
+			return false;
+		}
+	private:
+		std::atomic<uint32> count;
+	};
+
+	/// @brief Non-atomic reference counter with the same interface as ReferenceCount.\n
+	/// Only for objects that never leave the thread they are created on.
+	class LocalReferenceCount {
+	public:
+		LocalReferenceCount(uint32 count = 0) :count(count) {}
+
+		uint32 Get() const {
+			return count;
 		}
 		uint32 Reference() {
-			return count.Add(1);
+			count += 1;
+			return count;
 		}
 		uint32 Dereference() {
-			return count.Subtract(1);
+			count -= 1;
+			return count;
+		}
+		bool TryReference() {
+			if (count == 0) {
+				return false;
+			}
+			count += 1;
+			return true;
 		}
 	private:
-		AtomicValue<uint32> count;
+		uint32 count;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "Engine/System/Thread/Epoch.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Memory/Memory.h"
+
+namespace Engine {
+	namespace {
+		/// @brief The pin of a thread, alone on its cache line so pinning doesn't disturb other threads.
+		struct alignas(ThreadUtil::CacheLineSize) ThreadRecord {
+			ThreadRecord();
+			~ThreadRecord();
+
+			/// @brief The epoch pinned, 0 while not pinned.
+			std::atomic<uint64> epoch{ 0 };
+			/// @brief Only touched by the thread itself.
+			int32 nesting = 0;
+		};
+		struct Retired {
+			void* ptr;
+			Epoch::Deleter deleter;
+			uint64 epoch;
+		};
+		struct EpochData {
+			~EpochData() {
+				// Every thread is gone, nothing can read these anymore.
+				for (const auto& retired : retired) {
+					retired.deleter(retired.ptr);
+				}
+			}
+
+			/// @brief Starts at 1 since records use 0 for not pinned.
+			std::atomic<uint64> global{ 1 };
+			std::atomic<int32> pending{ 0 };
+
+			Mutex mutex;
+			/// @brief Guarded by the mutex.
+			List<ThreadRecord*> records{};
+			/// @brief Guarded by the mutex. In the order retired, so by epoch too.
+			List<Retired> retired{};
+		};
+		EpochData& GetData() {
+			static EpochData data{};
+			return data;
+		}
+		ThreadRecord& GetRecord() {
+			thread_local ThreadRecord record{};
+			return record;
+		}
+
+		ThreadRecord::ThreadRecord() {
+			EpochData& data = GetData();
+			SimpleLock<Mutex> lock(data.mutex);
+			data.records.Add(this);
+		}
+		ThreadRecord::~ThreadRecord() {
+			EpochData& data = GetData();
+			SimpleLock<Mutex> lock(data.mutex);
+			for (int32 i = 0; i < data.records.GetCount(); i += 1) {
+				if (data.records[i] == this) {
+					data.records.RemoveAt(i);
+					break;
+				}
+			}
+		}
+
+		/// @brief Advance the global epoch if every pinned thread has seen it. Called with the mutex held.
+		bool TryAdvance(EpochData& data) {
+			// Pairs with the fence of Epoch::Pin(), either we see the thread pinned or it sees what was published before.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			uint64 current = data.global.load(std::memory_order_relaxed);
+			for (const ThreadRecord* record : data.records) {
+				uint64 pinned = record->epoch.load(std::memory_order_relaxed);
+				if (pinned != 0 && pinned != current) {
+					return false;
+				}
+			}
+			data.global.store(current + 1, std::memory_order_release);
+			return true;
+		}
+	}
+
+	void Epoch::Pin() {
+		ThreadRecord& record = GetRecord();
+		record.nesting += 1;
+		if (record.nesting > 1) {
+			return;
+		}
+		// A stale epoch only holds back reclamation longer.
+		record.epoch.store(GetData().global.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		// The reads that follow must not move above the pin, or a writer could miss it and free what they read.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+	void Epoch::Unpin() {
+		ThreadRecord& record = GetRecord();
+		ERR_ASSERT(record.nesting > 0, u8"Unpinned more than pinned.", return);
+		record.nesting -= 1;
+		if (record.nesting == 0) {
+			record.epoch.store(0, std::memory_order_release);
+		}
+	}
+	bool Epoch::IsPinned() {
+		return GetRecord().nesting > 0;
+	}
+
+	void Epoch::Retire(void* ptr, Deleter deleter) {
+		ERR_ASSERT(deleter != nullptr, u8"deleter cannot be nullptr.", return);
+		if (ptr == nullptr) {
+			return;
+		}
+		EpochData& data = GetData();
+		{
+			SimpleLock<Mutex> lock(data.mutex);
+			// Read after the caller unpublished the memory, so any reader still seeing it pinned this epoch or an earlier one.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			Retired retired{ ptr, deleter, data.global.load(std::memory_order_relaxed) };
+			data.retired.Add(retired);
+			data.pending.store(data.retired.GetCount(), std::memory_order_relaxed);
+		}
+		Collect();
+	}
+	int32 Epoch::Collect() {
+		EpochData& data = GetData();
+		if (data.pending.load(std::memory_order_relaxed) == 0) {
+			return 0;
+		}
+
+		List<Retired> freed{};
+		int32 remaining = 0;
+		{
+			SimpleLock<Mutex> lock(data.mutex);
+			// Twice lets memory retired in the current epoch go right away when nobody reads.
+			if (TryAdvance(data)) {
+				TryAdvance(data);
+			}
+			// Anyone pinned now pinned the current epoch or the one before, memory retired before those is unreachable.
+			uint64 global = data.global.load(std::memory_order_relaxed);
+			int32 count = 0;
+			while (count < data.retired.GetCount() && data.retired[count].epoch + 2 <= global) {
+				count += 1;
+			}
+			if (count > 0) {
+				List<Retired> kept(data.retired.GetCount() - count);
+				for (int32 i = 0; i < data.retired.GetCount(); i += 1) {
+					(i < count ? freed : kept).Add(data.retired[i]);
+				}
+				data.retired = Memory::Move(kept);
+			}
+			remaining = data.retired.GetCount();
+			data.pending.store(remaining, std::memory_order_relaxed);
+		}
+		// Outside the lock, deleters may retire more.
+		for (const auto& retired : freed) {
+			retired.deleter(retired.ptr);
+		}
+		return remaining;
+	}
+	int32 Epoch::GetPendingCount() {
+		return GetData().pending.load(std::memory_order_relaxed);
+	}
+}
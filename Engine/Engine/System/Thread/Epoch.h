@@ -0,0 +1,56 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include <atomic>
+
+namespace Engine {
+	/// @brief Epoch-based reclamation: memory replaced under readers is freed once every reader that might still see it left.\n
+	/// Readers pin the current epoch with an EpochGuard, which writes to a record of their own thread only, no cache line is shared with other readers.
+	/// Writers publish a new version, then Retire() the old one. It is freed two epochs later,
+	/// the global epoch advancing only once every pinned thread has seen the current one.\n
+	/// A reader pinned for long holds back every reclamation, keep guards around short reads.
+	/// See ReadMostly for a value published this way.
+	class Epoch final {
+		STATIC_CLASS(Epoch);
+	public:
+		using Deleter = void (*)(void* ptr);
+
+		/// @brief Free the memory once no reader can see it anymore, possibly right away, on this thread or another one retiring later.
+		static void Retire(void* ptr, Deleter deleter);
+		/// @brief Retire memory made by MEMNEW.
+		template<typename T>
+		static void Retire(T* ptr) {
+			Retire(const_cast<void*>(static_cast<const void*>(ptr)), [](void* ptr) {
+				MEMDEL(static_cast<T*>(ptr));
+			});
+		}
+
+		/// @brief Try to advance the epoch and free what no reader can see. Retire() does it too, this frees what waits when nothing retires for a while.
+		/// @return Count of retired memory still waiting.
+		static int32 Collect();
+		/// @brief Count of retired memory waiting for readers to leave.
+		static int32 GetPendingCount();
+
+		/// @brief Whether the current thread is inside an EpochGuard.
+		static bool IsPinned();
+
+	private:
+		static void Pin();
+		static void Unpin();
+
+		friend class EpochGuard;
+	};
+
+	/// @brief Pins the current epoch for the scope, reads of memory retired meanwhile stay valid until it ends. Guards nest.
+	class EpochGuard final {
+	public:
+		EpochGuard() {
+			Epoch::Pin();
+		}
+		~EpochGuard() {
+			Epoch::Unpin();
+		}
+		EpochGuard(const EpochGuard&) = delete;
+		EpochGuard& operator=(const EpochGuard&) = delete;
+	};
+}
@@ -0,0 +1,99 @@
+#include "Engine/System/Thread/Fiber.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Debug.h"
+#include "Engine/Platform/Definition.h"
+
+#if CURRENT_PLATFORM_WINDOWS
+#	include "Engine/Platform/Windows/BetterWindows.h"
+#elif CURRENT_PLATFORM_LINUX
+#	include <ucontext.h>
+#endif
+
+namespace Engine {
+	thread_local Fiber* Fiber::current = nullptr;
+
+	Fiber* Fiber::GetCurrent() {
+		return current;
+	}
+	void Fiber::Entry(void* fiber) {
+		Fiber* self = (Fiber*)fiber;
+		self->function(self->data);
+		FATAL_CRASH(u8"Fiber function returned! Switch to another fiber instead.");
+	}
+
+#if CURRENT_PLATFORM_WINDOWS
+	Fiber::Fiber() :isThread(true) {
+		handle = ConvertThreadToFiber(nullptr);
+		FATAL_ASSERT(handle != nullptr, u8"ConvertThreadToFiber failed!");
+	}
+	Fiber::Fiber(Function function, void* data, sizeint stackSize) :function(function), data(data) {
+		handle = CreateFiber(stackSize, [](LPVOID fiber) {
+			Entry(fiber);
+		}, this);
+		FATAL_ASSERT(handle != nullptr, u8"CreateFiber failed!");
+	}
+	Fiber::~Fiber() {
+		if (!isThread) {
+			DeleteFiber(handle);
+		}
+	}
+	void Fiber::RevertCurrentThread() {
+		ERR_ASSERT(current != nullptr && current->isThread, u8"The current thread is not a converted thread fiber.", return);
+		ConvertFiberToThread();
+		MEMDEL(current);
+		current = nullptr;
+	}
+	void Fiber::SwitchTo() {
+		ERR_ASSERT(current != nullptr, u8"The current thread is not converted to a fiber.", return);
+		if (current == this) {
+			return;
+		}
+		current = this;
+		SwitchToFiber(handle);
+	}
+#elif CURRENT_PLATFORM_LINUX
+	Fiber::Fiber() :isThread(true) {
+		handle = MEMNEW(ucontext_t);
+		// Filled when switching away.
+		getcontext((ucontext_t*)handle);
+	}
+	Fiber::Fiber(Function function, void* data, sizeint stackSize) :function(function), data(data) {
+		ucontext_t* context = MEMNEW(ucontext_t);
+		handle = context;
+		stack = Memory::Allocate(stackSize, MemoryTag::Job);
+
+		getcontext(context);
+		context->uc_stack.ss_sp = stack;
+		context->uc_stack.ss_size = stackSize;
+		context->uc_link = nullptr;
+		// makecontext only passes ints, so the fiber finds itself via Fiber::current.
+		makecontext(context, []() {
+			Entry(current);
+		}, 0);
+	}
+	Fiber::~Fiber() {
+		MEMDEL((ucontext_t*)handle);
+		Memory::Deallocate(stack);
+	}
+	void Fiber::RevertCurrentThread() {
+		ERR_ASSERT(current != nullptr && current->isThread, u8"The current thread is not a converted thread fiber.", return);
+		MEMDEL(current);
+		current = nullptr;
+	}
+	void Fiber::SwitchTo() {
+		ERR_ASSERT(current != nullptr, u8"The current thread is not converted to a fiber.", return);
+		if (current == this) {
+			return;
+		}
+		Fiber* from = current;
+		current = this;
+		swapcontext((ucontext_t*)from->handle, (ucontext_t*)handle);
+	}
+#endif
+
+	Fiber* Fiber::ConvertCurrentThread() {
+		ERR_ASSERT(current == nullptr, u8"The current thread is already a fiber.", return current);
+		current = MEMNEW(Fiber());
+		return current;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Engine/System/Definition.h"
+
+namespace Engine {
+	/// @brief A user-mode execution context with its own stack, switched cooperatively.\n
+	/// A thread must be converted with Fiber::ConvertCurrentThread() before switching to any fiber.
+	class Fiber final {
+	public:
+		using Function = void (*)(void* data);
+		static inline constexpr sizeint DefaultStackSize = 256 * 1024;
+
+		/// @brief Create a fiber which runs function(data) on the first switch.\n
+		/// The function must never return, switch away instead.
+		Fiber(Function function, void* data, sizeint stackSize = DefaultStackSize);
+		~Fiber();
+		Fiber(const Fiber&) = delete;
+		Fiber& operator=(const Fiber&) = delete;
+
+		/// @brief Turn the current thread into a fiber, so it can switch to others and be switched back.
+		static Fiber* ConvertCurrentThread();
+		/// @brief Undo ConvertCurrentThread(). Must be called on the thread fiber itself.
+		static void RevertCurrentThread();
+		/// @brief Get the fiber running on the current thread, nullptr if the thread is not converted.
+		static Fiber* GetCurrent();
+
+		/// @brief Suspend the current fiber and continue this one.
+		void SwitchTo();
+
+	private:
+		// For thread fibers.
+		Fiber();
+
+		static void Entry(void* fiber);
+
+		Function function = nullptr;
+		void* data = nullptr;
+		bool isThread = false;
+		// Platform specific context.
+		void* handle = nullptr;
+		void* stack = nullptr;
+
+		static thread_local Fiber* current;
+	};
+}
@@ -1,66 +1,560 @@
 #include "Engine/System/Thread/JobSystem.h"
 #include "Engine/System/String.h"
+#include "Engine/System/Profiler.h"
+#include "Engine/System/Clock.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
 
 namespace Engine {
+#pragma region JobHandle
+	JobHandle::JobHandle(Job* job, uint32 generation) :job(job), generation(generation) {}
+
+	bool JobHandle::IsValid() const {
+		return job != nullptr;
+	}
+	bool JobHandle::IsFinished() const {
+		return job == nullptr || job->generation.Get() != generation;
+	}
+#pragma endregion
+
+#pragma region JobPool
+	namespace {
+		// Free jobs are linked through their data zone.
+		Job*& GetNextFreeJob(Job* job) {
+			return *job->GetDataAs<Job*>();
+		}
+
+		struct JobFreeList {
+			Job* head = nullptr;
+			int32 count = 0;
+
+			void Push(Job* job) {
+				GetNextFreeJob(job) = head;
+				head = job;
+				count += 1;
+			}
+			Job* Pop() {
+				Job* job = head;
+				head = GetNextFreeJob(job);
+				count -= 1;
+				return job;
+			}
+			// Move up to count jobs to the target.
+			void MoveTo(JobFreeList& target, int32 count) {
+				for (int32 i = 0; i < count && head != nullptr; i += 1) {
+					target.Push(Pop());
+				}
+			}
+		};
+
+		struct SharedJobPool {
+			Mutex mutex;
+			JobFreeList free;
+			// Jobs are never given back to the system, so handles can always read the generation safely.
+			List<void*> slabs;
+
+			~SharedJobPool() {
+				for (auto slab : slabs) {
+					Memory::Deallocate(slab);
+				}
+			}
+			void Refill(JobFreeList& target) {
+				auto lock = SimpleLock<Mutex>(mutex);
+				if (free.count <= 0) {
+					AllocateSlab();
+				}
+				free.MoveTo(target, JobPool::BatchSize);
+			}
+			void AllocateSlab() {
+				void* slab = Memory::AllocateAligned(sizeof(Job) * JobPool::SlabSize, alignof(Job), MemoryTag::Job);
+				slabs.Add(slab);
+
+				Job* jobs = (Job*)slab;
+				for (int32 i = 0; i < JobPool::SlabSize; i += 1) {
+					Memory::Construct(jobs + i);
+					free.Push(jobs + i);
+				}
+			}
+		};
+		SharedJobPool& GetSharedJobPool() {
+			static SharedJobPool pool;
+			return pool;
+		}
+
+		struct LocalJobPool {
+			JobFreeList free;
+
+			~LocalJobPool() {
+				if (free.count <= 0) {
+					return;
+				}
+				auto& shared = GetSharedJobPool();
+				auto lock = SimpleLock<Mutex>(shared.mutex);
+				free.MoveTo(shared.free, free.count);
+			}
+		};
+		thread_local LocalJobPool localJobPool;
+	}
+
+	Job* JobPool::Allocate() {
+		auto& local = localJobPool.free;
+		if (local.head == nullptr) {
+			GetSharedJobPool().Refill(local);
+		}
+		return local.Pop();
+	}
+	void JobPool::Release(Job* job) {
+		job->function = nullptr;
+		job->counter = SharedPtr<JobCounter>();
+		job->generation.Add(1);
+
+		auto& local = localJobPool.free;
+		local.Push(job);
+		if (local.count > LocalLimit) {
+			auto& shared = GetSharedJobPool();
+			auto lock = SimpleLock<Mutex>(shared.mutex);
+			local.MoveTo(shared.free, LocalLimit - BatchSize);
+		}
+	}
+
+	namespace {
+		// Free payloads are linked through their first bytes.
+		struct PayloadFreeList {
+			void* head = nullptr;
+			int32 count = 0;
+
+			void Push(void* payload) {
+				*(void**)payload = head;
+				head = payload;
+				count += 1;
+			}
+			void* Pop() {
+				void* payload = head;
+				head = *(void**)payload;
+				count -= 1;
+				return payload;
+			}
+			void MoveTo(PayloadFreeList& target, int32 count) {
+				for (int32 i = 0; i < count && head != nullptr; i += 1) {
+					target.Push(Pop());
+				}
+			}
+		};
+
+		int32 GetPayloadClass(sizeint size) {
+			int32 index = 0;
+			sizeint classSize = JobPool::MinPayloadSize;
+			while (classSize < size) {
+				classSize <<= 1;
+				index += 1;
+			}
+			return index;
+		}
+
+		struct SharedPayloadPool {
+			Mutex mutex;
+			PayloadFreeList free[JobPool::PayloadClassCount];
+
+			~SharedPayloadPool() {
+				for (auto& list : free) {
+					while (list.head != nullptr) {
+						Memory::Deallocate(list.Pop());
+					}
+				}
+			}
+		};
+		SharedPayloadPool& GetSharedPayloadPool() {
+			static SharedPayloadPool pool;
+			return pool;
+		}
+
+		struct LocalPayloadPool {
+			PayloadFreeList free[JobPool::PayloadClassCount];
+
+			~LocalPayloadPool() {
+				auto& shared = GetSharedPayloadPool();
+				auto lock = SimpleLock<Mutex>(shared.mutex);
+				for (int32 i = 0; i < JobPool::PayloadClassCount; i += 1) {
+					free[i].MoveTo(shared.free[i], free[i].count);
+				}
+			}
+		};
+		thread_local LocalPayloadPool localPayloadPool;
+	}
+
+	void* JobPool::AllocatePayload(sizeint size) {
+		if (size > MaxPayloadSize) {
+			return Memory::Allocate(size, MemoryTag::Job);
+		}
+
+		int32 index = GetPayloadClass(size);
+		auto& local = localPayloadPool.free[index];
+		if (local.head == nullptr) {
+			auto& shared = GetSharedPayloadPool();
+			auto lock = SimpleLock<Mutex>(shared.mutex);
+			shared.free[index].MoveTo(local, BatchSize);
+		}
+		if (local.head == nullptr) {
+			return Memory::Allocate(MinPayloadSize << index, MemoryTag::Job);
+		}
+		return local.Pop();
+	}
+	void JobPool::ReleasePayload(void* payload, sizeint size) {
+		if (size > MaxPayloadSize) {
+			Memory::Deallocate(payload);
+			return;
+		}
+
+		int32 index = GetPayloadClass(size);
+		auto& local = localPayloadPool.free[index];
+		local.Push(payload);
+		if (local.count > LocalLimit) {
+			auto& shared = GetSharedPayloadPool();
+			auto lock = SimpleLock<Mutex>(shared.mutex);
+			local.MoveTo(shared.free[index], LocalLimit - BatchSize);
+		}
+	}
+#pragma endregion
+
+#pragma region JobCounter
+	JobCounter::JobCounter(int32 value) :value(value) {}
+
+	int32 JobCounter::GetValue() const {
+		return value.Get();
+	}
+	bool JobCounter::IsFinished() const {
+		return value.Get() <= 0;
+	}
+	void JobCounter::Increase(int32 count) {
+		value.Add(count);
+	}
+	void JobCounter::Decrease() {
+		if (value.Subtract(1) > 0) {
+			return;
+		}
+
+		List<Continuation> ready;
+		{
+			auto lock = ProfiledLock<AdaptiveMutex>(continuationsMutex, "JobCounter::continuationsMutex");
+			ready = Memory::Move(continuations);
+		}
+		for (const auto& item : ready) {
+			item.system->ScheduleJob(item.job, item.preference);
+		}
+	}
+	void JobCounter::AddContinuation(JobSystem* system, Job* job, Job::Preference preference) {
+		{
+			auto lock = ProfiledLock<AdaptiveMutex>(continuationsMutex, "JobCounter::continuationsMutex");
+			// Decrease() takes the lock after reaching zero, so either it sees this continuation or we see zero.
+			if (!IsFinished()) {
+				Continuation item;
+				item.system = system;
+				item.job = job;
+				item.preference = preference;
+				continuations.Add(item);
+				return;
+			}
+		}
+		system->ScheduleJob(job, preference);
+	}
+#pragma endregion
+
 #pragma region JobWorker
-	JobWorker::JobWorker(JobSystem* manager, int32 id) :manager(manager), id(id) {}
+	namespace {
+		int64 GetNanoseconds() {
+			return (int64)Clock::GetNanoseconds();
+		}
+	}
+
+	JobWorker::JobWorker(JobSystem* manager, int32 id) :manager(manager), stealSeed((uint32)id * 2654435761u + 1), id(id) {}
+	JobWorker::~JobWorker() {
+		// Release the jobs left in the local deques.
+		Job* job = nullptr;
+		for (auto& queue : localJobs) {
+			while (queue.Pop(job)) {
+				JobPool::Release(job);
+			}
+		}
+	}
 
 	void JobWorker::Start() {
 		shouldRun = true;
 
 		thread = std::thread(ThreadFunction, this);
-		thread.detach();
 	}
 	void JobWorker::RequireStop() {
 		shouldRun = false;
 	}
+	void JobWorker::Join() {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	thread_local JobWorker* JobWorker::current = nullptr;
 
 	void JobWorker::ThreadFunction(JobWorker* worker) {
 		worker->running = true;
+		current = worker;
+
+		ThreadUtil::SetCurrentThreadName(worker->name);
+		Profiler::SetCurrentThreadName(worker->name);
+		if (worker->core >= 0 && !ThreadUtil::SetCurrentThreadAffinity(worker->core)) {
+			WARN_MSG(String::Format(STRL("Failed to pin job worker {0} to core {1}."), worker->id, worker->core).GetRawArray());
+		}
+		if (worker->priority != ThreadUtil::Priority::Normal && !ThreadUtil::SetCurrentThreadPriority(worker->priority)) {
+			WARN_MSG(String::Format(STRL("Failed to set the priority of job worker {0}."), worker->id).GetRawArray());
+		}
 		//INFO_MSG(String::Format(STRL("Job worker {0} started."), worker->id).GetRawArray());
 
-		SharedPtr<Job> job;
-		while (worker->ShouldRun()) {
+		if (worker->useFibers) {
+			worker->RunFiberLoop();
+		} else {
+			while (worker->ShouldRun()) {
+				Job* job = worker->GetJob();
+				if (job == nullptr) {
+					job = worker->Search();
+				}
+				if (job == nullptr) {
+					job = worker->Park();
+				}
+				if (job != nullptr) {
+					RunJob(job);
+					if (worker->fetchCount % JobSystem::LoadCheckInterval == 0) {
+						worker->manager->UpdateLoad();
+					}
+				}
+			}
+		}
+
+		current = nullptr;
+		//INFO_MSG(String::Format(STRL("Job worker {0} stopped."), worker->id).GetRawArray());
+		worker->running = false;
+	}
+	Job* JobWorker::Search() {
+		if (manager->IsEfficiencyMode() || !ThreadUtil::IsSpinningUseful()) {
+			return nullptr;
+		}
+		for (int32 spins = 1; spins <= JobSystem::MaxSearchSpins && ShouldRun(); spins *= 2) {
+			for (int32 i = 0; i < spins; i += 1) {
+				ThreadUtil::SpinPause();
+			}
+			Job* job = GetJob();
 			if (job != nullptr) {
-				RunJob(job);
-				job = SharedPtr<Job>(nullptr);
+				return job;
 			}
+		}
+		return nullptr;
+	}
+	Job* JobWorker::Park() {
+		manager->UpdateLoad();
+		manager->AddIdleWorker(this);
+
+		// Check again after announcing idle, jobs added before that won't wake us.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		Job* job = ShouldRun() ? GetJob() : nullptr;
+		if (job == nullptr && ShouldRun()) {
+			PROFILE_SCOPE("JobWorker::Park");
+			int64 begin = GetNanoseconds();
+			parkBegin.Set(begin);
+			wakeSemaphore.acquire();
+			parkBegin.Set(0);
+			parkedTime.FetchAdd(GetNanoseconds() - begin);
+			return nullptr;
+		}
+
+		// Found a job or stopping, leave the idle list.
+		if (!manager->RemoveIdleWorker(this)) {
+			// A waker has taken us and is releasing the semaphore, consume it.
+			wakeSemaphore.acquire();
+		}
+		return job;
+	}
+
+	struct JobWorker::JobFiber {
+		JobWorker* worker = nullptr;
+		Fiber* fiber = nullptr;
+		// The job to run, nullptr once it is finished.
+		Job* job = nullptr;
+		// What the fiber waits for when suspended.
+		SharedPtr<JobCounter> waitCounter;
+		JobHandle waitJob;
+
+		bool IsWaitOver() const {
+			return (waitCounter == nullptr || waitCounter->IsFinished()) && waitJob.IsFinished();
+		}
+	};
+	void JobWorker::RunFiberLoop() {
+		threadFiber = Fiber::ConvertCurrentThread();
 
-			{
-				auto lock = AdvanceLock<Mutex>(worker->manager->jobsCondMutex);
-				worker->manager->jobsCond.wait(lock, [worker, &job]() {
-					if (!worker->ShouldRun()) {
-						return true;
+		while (ShouldRun()) {
+			// Resuming suspended jobs goes before starting new ones.
+			JobFiber* fiber = GetReadyFiber();
+			if (fiber == nullptr) {
+				Job* job = GetJob();
+				if (job == nullptr) {
+					if (waitingFibers.GetCount() > 0) {
+						// Finished counters don't wake us up, keep polling the suspended fibers.
+						ThreadUtil::YieldThread();
+						continue;
 					}
+					job = Search();
 					if (job == nullptr) {
-						job = worker->GetJob();
+						job = Park();
 					}
-					return job != nullptr;
-				});
+					if (job == nullptr) {
+						continue;
+					}
+				}
+				fiber = GetFreeFiber();
+				fiber->job = job;
+			}
+
+			runningFiber = fiber;
+			fiber->fiber->SwitchTo();
+			runningFiber = nullptr;
+			if (fetchCount % JobSystem::LoadCheckInterval == 0) {
+				manager->UpdateLoad();
+			}
+
+			if (fiber->job == nullptr) {
+				freeFibers.Add(fiber);
+			} else {
+				waitingFibers.Add(fiber);
 			}
 		}
 
-		//INFO_MSG(String::Format(STRL("Job worker {0} stopped."), worker->id).GetRawArray());
-		worker->running = false;
+		if (waitingFibers.GetCount() > 0) {
+			WARN_MSG(String::Format(STRL("Job worker {0} stopped with {1} suspended jobs, they will never finish."), id, waitingFibers.GetCount()).GetRawArray());
+		}
+		for (auto fiber : freeFibers) {
+			MEMDEL(fiber->fiber);
+			MEMDEL(fiber);
+		}
+		for (auto fiber : waitingFibers) {
+			MEMDEL(fiber->fiber);
+			MEMDEL(fiber);
+		}
+		freeFibers.Clear();
+		waitingFibers.Clear();
+
+		Fiber::RevertCurrentThread();
+		threadFiber = nullptr;
+	}
+	void JobWorker::FiberFunction(void* data) {
+		JobFiber* self = (JobFiber*)data;
+		while (true) {
+			RunJob(self->job);
+			self->job = nullptr;
+			self->worker->threadFiber->SwitchTo();
+		}
+	}
+	void JobWorker::SuspendFiber(const SharedPtr<JobCounter>& counter, const JobHandle& handle) {
+		JobFiber* fiber = runningFiber;
+		fiber->waitCounter = counter;
+		fiber->waitJob = handle;
+
+		// Resumed by RunFiberLoop() once the wait is over.
+		threadFiber->SwitchTo();
+
+		fiber->waitCounter = SharedPtr<JobCounter>();
+		fiber->waitJob = JobHandle();
+	}
+	JobWorker::JobFiber* JobWorker::GetReadyFiber() {
+		int32 count = waitingFibers.GetCount();
+		auto elements = waitingFibers.GetRawElementPtr();
+		for (int32 i = 0; i < count; i += 1) {
+			JobFiber* fiber = elements[i];
+			if (fiber->IsWaitOver()) {
+				elements[i] = elements[count - 1];
+				waitingFibers.RemoveAt(count - 1);
+				return fiber;
+			}
+		}
+		return nullptr;
 	}
-	void JobWorker::RunJob(SharedPtr<Job>& job) {
-		job->function(job.GetRaw());
-		job->finished = true;
+	JobWorker::JobFiber* JobWorker::GetFreeFiber() {
+		int32 count = freeFibers.GetCount();
+		if (count > 0) {
+			JobFiber* fiber = freeFibers.Get(count - 1);
+			freeFibers.RemoveAt(count - 1);
+			return fiber;
+		}
+
+		JobFiber* fiber = MEMNEW(JobFiber);
+		fiber->worker = this;
+		fiber->fiber = MEMNEW(Fiber(FiberFunction, fiber, fiberStackSize));
+		return fiber;
+	}
+
+	void JobWorker::RunJob(Job* job) {
+		{
+			ProfileScope scope("JobWorker::RunJob", ProfileEventKind::Job);
+			job->function(job);
+		}
+
+		// Handles are finished as soon as the job is back to the pool.
+		auto counter = Memory::Move(job->counter);
+		JobPool::Release(job);
+
+		if (counter != nullptr) {
+			counter->Decrease();
+		}
+	}
+	Job* JobWorker::GetJob() {
+		// Highest priority first, but background jobs go first once in a while.
+		int32 first = (fetchCount % JobSystem::BackgroundInterval == JobSystem::BackgroundInterval - 1) ? Job::PriorityCount - 1 : 0;
+		fetchCount += 1;
+
+		for (int32 i = 0; i < Job::PriorityCount; i += 1) {
+			Job* job = GetJob((Job::Priority)((first + i) % Job::PriorityCount));
+			if (job != nullptr) {
+				return job;
+			}
+		}
+		return nullptr;
 	}
-	SharedPtr<Job> JobWorker::GetJob() {
+	Job* JobWorker::GetJob(Job::Priority priority) {
+		int32 index = (int32)priority;
 		{
-			auto lock = SimpleLock<Mutex>(exclusiveJobMutex);
-			if (exclusiveJobs.GetCount() > 0) {
-				auto job = exclusiveJobs.Get(exclusiveJobs.GetCount() - 1);
-				exclusiveJobs.RemoveAt(exclusiveJobs.GetCount() - 1);
+			auto lock = ProfiledLock<AdaptiveMutex>(exclusiveJobMutex, "JobSystem::exclusiveJobMutex");
+			auto& exclusive = exclusiveJobs[index];
+			if (exclusive.GetCount() > 0) {
+				auto job = exclusive.Get(exclusive.GetCount() - 1);
+				exclusive.RemoveAt(exclusive.GetCount() - 1);
 				return job;
 			}
 		}
-		return manager->GetJob();
+
+		Job* job = nullptr;
+		if (localJobs[index].Pop(job)) {
+			return job;
+		}
+
+		job = manager->GetJob(priority);
+		if (job != nullptr) {
+			return job;
+		}
+
+		return manager->StealJob(this, stealSeed, priority);
+	}
+	void JobWorker::AddExclusiveJob(Job* job) {
+		auto lock = ProfiledLock<AdaptiveMutex>(exclusiveJobMutex, "JobSystem::exclusiveJobMutex");
+		exclusiveJobs[(int32)job->priority].Add(job);
+	}
+	bool JobWorker::AddLocalJob(Job* job) {
+		return localJobs[(int32)job->priority].Push(job);
+	}
+	Job* JobWorker::GetStolen(Job::Priority priority) {
+		Job* job = nullptr;
+		if (localJobs[(int32)priority].Steal(job)) {
+			return job;
+		}
+		return nullptr;
 	}
-	void JobWorker::AddExclusiveJob(SharedPtr<Job> job) {
-		auto lock = SimpleLock<Mutex>(exclusiveJobMutex);
-		exclusiveJobs.Add(job);
+	JobWorker* JobWorker::GetCurrent() {
+		return current;
 	}
 	bool JobWorker::ShouldRun() const {
 		return shouldRun;
@@ -75,19 +569,43 @@ namespace Engine {
 #pragma endregion
 
 #pragma region JobSystem
-	JobSystem::JobSystem() {
+	JobSystem::JobSystem() :JobSystem(JobSystemConfig()) {}
+	JobSystem::JobSystem(const JobSystemConfig& config) {
 		int32 hardware = ThreadUtil::GetHardwareThreadCount();
-		INFO_MSG(String::Format(STRING_LITERAL("{0} hardware threads, creating {1} job workers."), hardware, hardware - 1).GetRawArray());
+		int32 count = config.workerCount;
+		if (count < 0) {
+			count = hardware - 1 - config.reservedThreadCount;
+			if (count < 0) {
+				count = 0;
+			}
+		}
+		INFO_MSG(String::Format(STRING_LITERAL("{0} hardware threads, creating {1} job workers."), hardware, count).GetRawArray());
 		//INFO_MSG(String::Format(STRING_LITERAL("L1 cache line size: {0} bytes."), CacheLineSize).GetRawArray());
 		INFO_MSG(String::Format(STRING_LITERAL("Job struct size: {0} bytes."), sizeof(Job)).GetRawArray());
 
-		preferenceToWorker.Add(Job::Preference::Window, 0);
+		if (config.windowWorker >= 0) {
+			if (config.windowWorker < count) {
+				preferenceToWorker.Add(Job::Preference::Window, config.windowWorker);
+			} else {
+				WARN_MSG(u8"The window worker doesn't exist, window jobs will run on any worker.");
+			}
+		}
+		preferenceToWorker.Freeze();
 
-		for (int32 i = 0; i < hardware - 1; i += 1) {
+		for (int32 i = 0; i < count; i += 1) {
 			lastId += 1;
 			auto worker = SharedPtr<JobWorker>::Create(this,lastId);
+			worker->name = String::Format(STRING_LITERAL("{0} {1}"), config.workerNamePrefix, lastId);
+			worker->priority = config.workerPriority;
+			worker->useFibers = config.useFibers;
+			worker->fiberStackSize = config.fiberStackSize;
+			if (config.pinWorkers && hardware > 0) {
+				worker->core = (1 + config.reservedThreadCount + i) % hardware;
+			}
 			workers.Add(worker);
 		}
+		activeWorkerLimit.Set(count > 0 ? count : 1);
+		efficiencyMode.Set(config.efficiencyMode);
 	}
 
 	void JobSystem::Start() {
@@ -98,42 +616,62 @@ namespace Engine {
 		}
 	}
 
+	JobSystem::~JobSystem() {
+		if (running) {
+			Stop();
+		}
+	}
+
 	void JobSystem::Stop() {
 		for (const auto& worker : workers) {
 			worker->RequireStop();
 		}
 
-		// Wait for all threads stop.
-		bool stop = true;
-		do {
-			stop = true;
-			jobsCond.notify_all();
-
-			for (const auto& worker : workers) {
-				if (worker->IsRunning()) {
-					stop = false;
-					break;
-				}
-			}
-		} while (!stop);
+		// Wake everyone up and wait for all threads stop.
+		WakeAllWorkers();
+		for (const auto& worker : workers) {
+			worker->Join();
+		}
 
 		running = false;
 	}
 
-	SharedPtr<Job> JobSystem::AddJob(Job::WorkFunction function,void* data,sizeint dataLength,Job::Preference preference) {
+	JobHandle JobSystem::AddJob(Job::WorkFunction function, void* data, sizeint dataLength, Job::Preference preference, const SharedPtr<JobCounter>& counter, Job::Priority priority) {
+		Job* job = PrepareJob(function, data, dataLength, counter, priority);
+		// Take the generation before scheduling, the job can be finished at any time after that.
+		JobHandle handle(job, job->generation.Get());
+		ScheduleJob(job, preference);
+		return handle;
+	}
+	JobHandle JobSystem::AddJobAfter(const SharedPtr<JobCounter>& dependency, Job::WorkFunction function, void* data, sizeint dataLength, Job::Preference preference, const SharedPtr<JobCounter>& counter, Job::Priority priority) {
+		Job* job = PrepareJob(function, data, dataLength, counter, priority);
+		JobHandle handle(job, job->generation.Get());
+		if (dependency == nullptr) {
+			ScheduleJob(job, preference);
+		} else {
+			dependency->AddContinuation(this, job, preference);
+		}
+		return handle;
+	}
+	Job* JobSystem::PrepareJob(Job::WorkFunction function, void* data, sizeint dataLength, const SharedPtr<JobCounter>& counter, Job::Priority priority) {
 		if (data != nullptr) {
-			FATAL_ASSERT(dataLength <= Job::DataLength, u8"data is too large to put into a job! Consider putting a pointer to the actual data.");
+			FATAL_ASSERT(dataLength <= Job::DataLength, u8"data is too large to put into a job! Consider adding a callable job, or putting a pointer to the actual data.");
 		}
 
 		// Prepare job
-		auto job = SharedPtr<Job>::Create();
+		Job* job = JobPool::Allocate();
 		job->function = function;
+		job->priority = priority;
 		if (data != nullptr) {
-			for (sizeint i = 0; i < dataLength; i += 1) {
-				job->data[i] = ((byte*)data)[i];
-			}
+			std::memcpy(job->data, data, dataLength);
 		}
-
+		if (counter != nullptr) {
+			counter->Increase();
+			job->counter = counter;
+		}
+		return job;
+	}
+	void JobSystem::ScheduleJob(Job* job, Job::Preference preference) {
 		// Exclusive job targeting
 		int32 worker = -1;
 		if (preference != Job::Preference::Null) {
@@ -142,42 +680,316 @@ namespace Engine {
 		
 		// Add job
 		if (worker < 0) {
-			auto lock = SimpleLock<Mutex>(jobsMutex);
-			jobs.Add(job);
+			// Workers keep their own jobs locally, other threads inject to the public queue.
+			JobWorker* current = JobWorker::GetCurrent();
+			if (current == nullptr || current->manager != this || !current->AddLocalJob(job)) {
+				AddPublicJob(job);
+			}
 		} else if (worker < workers.GetCount()) {
-			workers.Get(worker)->AddExclusiveJob(job);
+			JobWorker* target = workers.GetRawElementPtr()[worker].GetRaw();
+			target->AddExclusiveJob(job);
+			WakeWorker(target);
+			return;
 		} else {
 			FATAL_CRASH(u8"PreferenceToWorker map error! Trying to add exclusive work to unexisting worker!");
 		}
 
+		WakeWorker();
+	}
+	void JobSystem::WakeWorker() {
+		// Pairs with the fence in JobWorker::Park(), either we see the idle worker or it sees the new job.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int32 idle = idleWorkerCount.Get();
+		if (idle <= 0) {
+			return;
+		}
+		// The awake workers take the job, as long as the load doesn't need more of them.
+		if (efficiencyMode.Get() && workers.GetCount() - idle >= activeWorkerLimit.Get()) {
+			return;
+		}
+
+		JobWorker* worker = nullptr;
 		{
-			auto lock = SimpleLock<Mutex>(jobsCondMutex);
-			jobsCond.notify_all();
+			auto lock = ProfiledLock<AdaptiveMutex>(idleWorkersMutex, "JobSystem::idleWorkersMutex");
+			int32 count = idleWorkers.GetCount();
+			if (count <= 0) {
+				return;
+			}
+			worker = idleWorkers.Get(count - 1);
+			idleWorkers.RemoveAt(count - 1);
+			idleWorkerCount.Set(count - 1);
+		}
+		worker->wakeSemaphore.release();
+	}
+	void JobSystem::WakeWorker(JobWorker* worker) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (idleWorkerCount.Get() <= 0) {
+			return;
+		}
+		if (RemoveIdleWorker(worker)) {
+			worker->wakeSemaphore.release();
+		}
+	}
+	void JobSystem::WakeAllWorkers() {
+		List<JobWorker*> woken{};
+		{
+			auto lock = ProfiledLock<AdaptiveMutex>(idleWorkersMutex, "JobSystem::idleWorkersMutex");
+			woken = Memory::Move(idleWorkers);
+			idleWorkerCount.Set(0);
+		}
+		for (auto worker : woken) {
+			worker->wakeSemaphore.release();
 		}
-		return job;
 	}
-	SharedPtr<Job> JobSystem::GetJob() {
-		auto lock = SimpleLock<Mutex>(jobsMutex);
+	void JobSystem::AddIdleWorker(JobWorker* worker) {
+		auto lock = ProfiledLock<AdaptiveMutex>(idleWorkersMutex, "JobSystem::idleWorkersMutex");
+		idleWorkers.Add(worker);
+		idleWorkerCount.Set(idleWorkers.GetCount());
+	}
+	void JobSystem::SetEfficiencyMode(bool enabled) {
+		efficiencyMode.Set(enabled);
+	}
+	bool JobSystem::IsEfficiencyMode() const {
+		return efficiencyMode.Get();
+	}
+	int32 JobSystem::GetActiveWorkerCount() const {
+		return workers.GetCount() - idleWorkerCount.Get();
+	}
+	int32 JobSystem::GetActiveWorkerLimit() const {
+		return activeWorkerLimit.Get();
+	}
+	void JobSystem::UpdateLoad() {
+		int32 count = workers.GetCount();
+		int64 now = GetNanoseconds();
+		int64 last = lastLoadUpdate.Get();
+		if (count == 0 || now - last < LoadInterval || !lastLoadUpdate.CompareExchange(last, now)) {
+			return;
+		}
+
+		// Parks in progress count up to now. Reading the two apart may miss or double a park ending meanwhile, which only blurs one measurement.
+		int64 parked = 0;
+		for (const auto& worker : workers) {
+			parked += worker->parkedTime.Get();
+			int64 begin = worker->parkBegin.Get();
+			if (begin > 0 && begin < now) {
+				parked += now - begin;
+			}
+		}
+		// Claims are ordered by lastLoadUpdate, so relaxed is enough.
+		int64 parkedSince = parked - lastParkedTime.load(std::memory_order_relaxed);
+		lastParkedTime.store(parked, std::memory_order_relaxed);
+		if (last == 0) {
+			return;
+		}
+
+		double capacity = (double)(now - last) * count;
+		double busy = 1.0 - (double)parkedSince / capacity;
+		busy = busy < 0 ? 0 : (busy > 1 ? 1 : busy);
+		int32 limit = (int32)std::ceil(busy * count * 2) + 1;
+		limit = (limit < count ? limit : count);
+		int32 previous = activeWorkerLimit.Exchange(limit);
+		// Jobs queued already don't wake anyone, the busy workers might be behind on them.
+		if (efficiencyMode.Get()) {
+			for (int32 i = previous; i < limit; i += 1) {
+				WakeWorker();
+			}
+		}
+	}
+	bool JobSystem::RemoveIdleWorker(JobWorker* worker) {
+		auto lock = ProfiledLock<AdaptiveMutex>(idleWorkersMutex, "JobSystem::idleWorkersMutex");
+		int32 count = idleWorkers.GetCount();
+		auto elements = idleWorkers.GetRawElementPtr();
+		for (int32 i = 0; i < count; i += 1) {
+			if (elements[i] == worker) {
+				// Order doesn't matter, swap with the last one.
+				elements[i] = elements[count - 1];
+				idleWorkers.RemoveAt(count - 1);
+				idleWorkerCount.Set(count - 1);
+				return true;
+			}
+		}
+		return false;
+	}
+	void JobSystem::AddPublicJob(Job* job) {
+		auto lock = ProfiledLock<AdaptiveMutex>(jobsMutex, "JobSystem::jobsMutex");
+		jobs[(int32)job->priority].Add(job);
+	}
+	Job* JobSystem::GetJob(Job::Priority priority) {
+		auto lock = ProfiledLock<AdaptiveMutex>(jobsMutex, "JobSystem::jobsMutex");
 
-		if (jobs.GetCount()>0) {
-			auto job = jobs.Get(jobs.GetCount() - 1);
-			jobs.RemoveAt(jobs.GetCount() - 1);
+		auto& queue = jobs[(int32)priority];
+		if (queue.GetCount()>0) {
+			auto job = queue.Get(queue.GetCount() - 1);
+			queue.RemoveAt(queue.GetCount() - 1);
 			return job;
 		} else {
-			return SharedPtr<Job>(nullptr);
+			return nullptr;
 		}
 	}
+	Job* JobSystem::StealJob(JobWorker* thief, uint32& seed, Job::Priority priority) {
+		int32 count = workers.GetCount();
+		if (count <= 0 || (count == 1 && thief != nullptr)) {
+			return nullptr;
+		}
+
+		// Xorshift, cheap enough for picking a random victim.
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+
+		auto workerPtrs = workers.GetRawElementPtr();
+		int32 start = (int32)(seed % (uint32)count);
+		for (int32 i = 0; i < count; i += 1) {
+			JobWorker* victim = workerPtrs[(start + i) % count].GetRaw();
+			if (victim == thief) {
+				continue;
+			}
+			Job* job = victim->GetStolen(priority);
+			if (job != nullptr) {
+				return job;
+			}
+		}
+		return nullptr;
+	}
 	bool JobSystem::IsRunning() const {
 		return running;
 	}
+	int32 JobSystem::GetWorkerCount() const {
+		return workers.GetCount();
+	}
+
+	int32 JobSystem::GetAutoGrainSize(int32 count) const {
+		// Several chunks per thread for balancing, but not too small to waste time on scheduling.
+		static constexpr int32 ChunksPerThread = 4;
+		int32 chunks = (workers.GetCount() + 1) * ChunksPerThread;
+		int32 grain = count / chunks;
+		return grain > 0 ? grain : 1;
+	}
+	void JobSystem::RunParallelFor(ParallelForContext& context) {
+		int32 chunkCount = (context.end - context.begin + context.grainSize - 1) / context.grainSize;
+		int32 jobCount = chunkCount - 1;
+		if (jobCount > workers.GetCount()) {
+			jobCount = workers.GetCount();
+		}
 
-	void JobSystem::WaitJob(SharedPtr<Job> job) {
-		while (!job->finished) {
+		auto job = [](Job* job) {
+			ParallelForContext* context = *job->GetDataAs<ParallelForContext*>();
+			RunParallelForChunks(context);
+		};
+
+		auto counter = SharedPtr<JobCounter>::Create();
+		ParallelForContext* contextPtr = &context;
+		// The caller is blocked on the chunks, so they are critical.
+		for (int32 i = 0; i < jobCount; i += 1) {
+			AddJob(job, &contextPtr, sizeof(contextPtr), Job::Preference::Null, counter, Job::Priority::Critical);
+		}
+
+		// The calling thread works too.
+		RunParallelForChunks(contextPtr);
+		WaitCounter(counter);
+	}
+	void JobSystem::RunParallelForChunks(ParallelForContext* context) {
+		while (true) {
+			int32 from = context->next.FetchAdd(context->grainSize);
+			if (from >= context->end) {
+				return;
+			}
+			int32 to = from + context->grainSize;
+			if (to > context->end || to < from) {
+				to = context->end;
+			}
+			context->invoke(context->function, from, to);
+		}
+	}
+
+	bool JobSystem::RunPendingJob() {
+		Job* job = nullptr;
+
+		JobWorker* current = JobWorker::GetCurrent();
+		if (current != nullptr && current->manager == this) {
+			job = current->GetJob();
+		} else {
+			// Not a worker, exclusive jobs are off limits.
+			static thread_local uint32 seed = 2463534242u;
+			for (int32 i = 0; i < Job::PriorityCount && job == nullptr; i += 1) {
+				job = GetJob((Job::Priority)i);
+				if (job == nullptr) {
+					job = StealJob(nullptr, seed, (Job::Priority)i);
+				}
+			}
+		}
+
+		if (job == nullptr) {
+			return false;
+		}
+		JobWorker::RunJob(job);
+		return true;
+	}
+
+	namespace {
+		/// @brief Spin, then yield, then sleep for a short while when there is nothing to help.
+		class WaitBackoff final {
+		public:
+			void Wait() {
+				if (count < SpinCount) {
+					for (int32 i = 0; i < (1 << count); i += 1) {
+						ThreadUtil::SpinPause();
+					}
+				} else if (count < YieldCount) {
+					ThreadUtil::YieldThread();
+				} else {
+					std::this_thread::sleep_for(std::chrono::microseconds(SleepMicroseconds));
+					return;
+				}
+				count += 1;
+			}
+			void Reset() {
+				count = 0;
+			}
+
+		private:
+			static inline constexpr int32 SpinCount = 6;
+			static inline constexpr int32 YieldCount = 16;
+			static inline constexpr int32 SleepMicroseconds = 50;
+			int32 count = 0;
+		};
+	}
+
+	void JobSystem::WaitCounter(const SharedPtr<JobCounter>& counter) {
+		JobWorker* current = JobWorker::GetCurrent();
+		if (current != nullptr && current->manager == this && current->runningFiber != nullptr) {
+			if (!counter->IsFinished()) {
+				current->SuspendFiber(counter, JobHandle());
+			}
+			return;
+		}
+
+		WaitBackoff backoff;
+		while (!counter->IsFinished()) {
+			if (RunPendingJob()) {
+				backoff.Reset();
+			} else {
+				backoff.Wait();
+			}
+		}
+	}
+	void JobSystem::WaitJob(const JobHandle& job) {
+		JobWorker* current = JobWorker::GetCurrent();
+		if (current != nullptr && current->manager == this && current->runningFiber != nullptr) {
+			if (!job.IsFinished()) {
+				current->SuspendFiber(SharedPtr<JobCounter>(), job);
+			}
+			return;
+		}
+
+		WaitBackoff backoff;
+		while (!job.IsFinished()) {
 			// Help run jobs when waiting.
-			//auto job = GetJob();
-			//if (job!=nullptr) {
-			//	JobWorker::RunJob(job);
-			//}
+			if (RunPendingJob()) {
+				backoff.Reset();
+			} else {
+				backoff.Wait();
+			}
 		}
 	}
 #pragma endregion
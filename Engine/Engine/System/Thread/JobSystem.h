@@ -1,45 +1,149 @@
 #pragma once
 #include "Engine/System/Definition.h"
 #include "Engine/System/Collection/List.h"
-#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Collection/FlatMap.h"
 #include "Engine/System/Memory/SharedPtr.h"
 #include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Thread/Atomic.h"
+#include "Engine/System/Thread/AdaptiveMutex.h"
+#include "Engine/System/Thread/WorkStealingQueue.h"
+#include "Engine/System/Thread/Fiber.h"
+#include <atomic>
+#include <cstddef>
 #include <thread>
+#include <type_traits>
 
 #undef GetJob
 
 namespace Engine {
 	class JobSystem;
 	class JobWorker;
+	class JobCounter;
 	struct Job;
 
-	struct Job {
+	/// @brief A job, allocated from JobPool. Each one takes exactly one cache line.
+	struct alignas(ThreadUtil::CacheLineSize) Job {
 		using WorkFunction = void (*)(Job* job);
-		static inline constexpr sizeint DataLength = 64 - 8 - 1;
+		static inline constexpr sizeint HeaderLength = sizeof(WorkFunction) + sizeof(SharedPtr<JobCounter>) + sizeof(uint32) + sizeof(byte);
+		/// @brief The data zone is aligned for holding callables inline.
+		static inline constexpr sizeint DataAlignment = 16;
+		static inline constexpr sizeint DataLength = ThreadUtil::CacheLineSize - (HeaderLength + DataAlignment - 1) / DataAlignment * DataAlignment;
 		enum class Preference :byte {
 			Null,
 			Window
 		};
+		/// @brief Higher priority jobs are taken first. Background jobs still get a turn regularly so they never starve.
+		enum class Priority :byte {
+			/// @brief Jobs the current frame is waiting for.
+			Critical,
+			Normal,
+			/// @brief Streaming, asset loading and other long running work.
+			Background
+		};
+		static inline constexpr int32 PriorityCount = 3;
 		template<typename T>
-		volatile T* GetDataAs() {
-			return (volatile T*)(&data);
+		T* GetDataAs() {
+			return (T*)(&data);
 		}
 
-		WorkFunction function;
-		volatile bool finished = false;
+		WorkFunction function = nullptr;
+		// Decreased when the job is finished.
+		SharedPtr<JobCounter> counter;
+		// Increased every time the job is returned to the pool, which finishes all the handles to it.
+		AtomicValue<uint32> generation;
+		Priority priority = Priority::Normal;
 		// Data zone, also prevents false sharing.
-		volatile byte data[DataLength];
+		alignas(DataAlignment) byte data[DataLength];
+	};
+	static_assert(sizeof(Job) == ThreadUtil::CacheLineSize, "Job must fit in one cache line.");
+
+	/// @brief A generation-checked handle to a job.\n
+	/// The job returns to the pool as soon as it finishes, so do not access its data via the handle afterwards.
+	class JobHandle final {
+	public:
+		JobHandle() {}
+
+		/// @brief Indicates that the handle refers to a job at all.
+		bool IsValid() const;
+		/// @brief Indicates that the job has finished. Invalid handles are always finished.
+		bool IsFinished() const;
+
+	private:
+		friend class JobSystem;
+		JobHandle(Job* job, uint32 generation);
+
+		Job* job = nullptr;
+		uint32 generation = 0;
+	};
+
+	/// @brief Allocation-free job storage in steady state.\n
+	/// Each thread keeps its own free list, exchanging jobs with the shared pool in batches.
+	class JobPool final {
+		STATIC_CLASS(JobPool);
+
+	public:
+		static inline constexpr int32 SlabSize = 256;
+		static inline constexpr int32 BatchSize = 64;
+		static inline constexpr int32 LocalLimit = BatchSize * 4;
+
+		static Job* Allocate();
+		/// @brief Return a job to the pool. Finishes all the handles to it.
+		static void Release(Job* job);
+
+		/// @brief Payloads are pooled in power of 2 size classes from MinPayloadSize to MaxPayloadSize.
+		static inline constexpr sizeint MinPayloadSize = 64;
+		static inline constexpr int32 PayloadClassCount = 4;
+		static inline constexpr sizeint MaxPayloadSize = MinPayloadSize << (PayloadClassCount - 1);
+
+		/// @brief Get storage for a callable too large for the job data zone.\n
+		/// Larger than MaxPayloadSize goes to the heap directly.
+		static void* AllocatePayload(sizeint size);
+		/// @param size Must be the same as the one passed to AllocatePayload().
+		static void ReleasePayload(void* payload, sizeint size);
+	};
+
+	/// @brief An atomic counter for tracking a group of jobs.\n
+	/// Jobs added with a counter increase it, and decrease it when they finish.\n
+	/// Jobs added after a counter are queued automatically once the counter reaches zero.
+	class JobCounter final {
+	public:
+		JobCounter(int32 value = 0);
+
+		int32 GetValue() const;
+		/// @brief Indicates that all the tracked jobs are finished.
+		bool IsFinished() const;
+
+		void Increase(int32 count = 1);
+		/// @brief Decrease the counter, queues the continuation jobs when it reaches zero.
+		void Decrease();
+
+	private:
+		friend class JobSystem;
+
+		struct Continuation {
+			JobSystem* system = nullptr;
+			Job* job = nullptr;
+			Job::Preference preference = Job::Preference::Null;
+		};
+		void AddContinuation(JobSystem* system, Job* job, Job::Preference preference);
+
+		AtomicValue<int32> value;
+		List<Continuation> continuations;
+		mutable AdaptiveMutex continuationsMutex;
 	};
 
 	class JobWorker final {
 	public:
 		JobWorker(JobSystem* manager,int32 id);
+		~JobWorker();
 
 		/// @brief Start the worker.
 		void Start();
 		/// @brief Require the worker to stop.\n
-		/// Use JobWorker::IsRunning() to check if the worker has stopped.
+		/// Use JobWorker::IsRunning() to check if the worker has stopped, or JobWorker::Join() to wait for it.
 		void RequireStop();
+		/// @brief Block until the worker thread exits.
+		void Join();
 
 		/// @brief Indicates that should this worker continue running.
 		bool ShouldRun() const;
@@ -49,59 +153,320 @@ namespace Engine {
 		/// @brief Job worker thread function. 
 		static void ThreadFunction(JobWorker* worker);
 		/// @brief Job running sequence.
-		static void RunJob(SharedPtr<Job>& job);
+		static void RunJob(Job* job);
 
 		int32 GetId() const;
 
+		/// @brief Get the worker running on the current thread, nullptr if the current thread is not a job worker.
+		static JobWorker* GetCurrent();
+
 	private:
 		friend class JobSystem;
 
-		SharedPtr<Job> GetJob();
-		void AddExclusiveJob(SharedPtr<Job> job);
+		/// @brief Sleep until woken up by the job system. Returns a job if some found before sleeping.
+		Job* Park();
+		/// @brief Look for jobs again a few times with exponentially longer pauses in between, before parking.\n
+		/// Jobs added shortly after running out of them are taken without a wake up. Skipped in efficiency mode.
+		Job* Search();
+
+		struct JobFiber;
+		/// @brief Fiber mode main loop. Every job runs on a pooled fiber, which is suspended instead of blocking when waiting.
+		void RunFiberLoop();
+		/// @brief Switch back to the worker thread until the counter and the job are finished. Must be called on a job fiber.
+		void SuspendFiber(const SharedPtr<JobCounter>& counter, const JobHandle& handle);
+		/// @brief Take a suspended fiber whose wait is over.
+		JobFiber* GetReadyFiber();
+		JobFiber* GetFreeFiber();
+		static void FiberFunction(void* data);
+
+		Job* GetJob();
+		/// @brief Get a job of the specific priority from all the sources.
+		Job* GetJob(Job::Priority priority);
+		void AddExclusiveJob(Job* job);
+		/// @brief Push a job to the local deque. Must be called on the worker thread.
+		/// @return false when the local deque is full.
+		bool AddLocalJob(Job* job);
+		/// @brief Steal a job from the local deque. Called by other workers.
+		Job* GetStolen(Job::Priority priority);
 
 		JobSystem* manager;
 		std::thread thread;
 		volatile bool running = false;
 		volatile bool shouldRun = false;
 
-		List<SharedPtr<Job>> exclusiveJobs{ 30 };
-		mutable Mutex exclusiveJobMutex;
+		List<Job*> exclusiveJobs[Job::PriorityCount];
+		mutable AdaptiveMutex exclusiveJobMutex;
+
+		// Jobs pushed by this worker itself. Owner pops LIFO, other workers steal FIFO.
+		WorkStealingQueue<Job*> localJobs[Job::PriorityCount];
+		uint32 stealSeed;
+		// Counts GetJob() calls, for giving background jobs a regular turn.
+		uint32 fetchCount = 0;
+
+		// Released once every time the worker is taken from the idle list.
+		Semaphore wakeSemaphore{ 0 };
+		// Nanoseconds spent parked in total, and when the current park began, 0 if not parked. For measuring the load.
+		AtomicValue<int64> parkedTime{ 0 };
+		AtomicValue<int64> parkBegin{ 0 };
 
 		int32 id;
+
+		// Applied on the worker thread when it starts.
+		String name;
+		int32 core = -1;
+		ThreadUtil::Priority priority = ThreadUtil::Priority::Normal;
+
+		// Fiber mode, only touched by the worker thread.
+		bool useFibers = false;
+		sizeint fiberStackSize = Fiber::DefaultStackSize;
+		Fiber* threadFiber = nullptr;
+		JobFiber* runningFiber = nullptr;
+		List<JobFiber*> freeFibers{};
+		// Suspended fibers always resume on the worker which suspended them.
+		List<JobFiber*> waitingFibers{};
+
+		static thread_local JobWorker* current;
+	};
+
+	struct JobSystemConfig {
+		/// @brief Negative to use all the hardware threads except the calling thread and the reserved ones.
+		int32 workerCount = -1;
+		/// @brief Hardware threads kept away from the workers, for render or IO threads.
+		int32 reservedThreadCount = 0;
+		/// @brief Pin every worker to its own core. Core 0 is left to the calling thread, followed by the reserved ones.
+		bool pinWorkers = false;
+		ThreadUtil::Priority workerPriority = ThreadUtil::Priority::Normal;
+		/// @brief Workers are named "<prefix> <id>".
+		String workerNamePrefix = STRL("Job Worker");
+		/// @brief The worker running Job::Preference::Window jobs. Negative to run them like the others.
+		int32 windowWorker = 0;
+		/// @brief Run jobs on fibers. A job waiting for a counter or another job gets suspended,\n
+		/// leaving the worker free for other jobs, instead of nesting them on its own stack.
+		bool useFibers = false;
+		sizeint fiberStackSize = Fiber::DefaultStackSize;
+		/// @brief Start in efficiency mode, see JobSystem::SetEfficiencyMode().
+		bool efficiencyMode = false;
 	};
 
 	class JobSystem final {
 	public:
 		JobSystem();
+		JobSystem(const JobSystemConfig& config);
+		~JobSystem();
 
 		/// @brief Start the job system.
 		void Start();
 		/// @brief Stop the job system.\n
-		/// Will block until all the worker threads stop.
+		/// Wakes all the workers and blocks until their threads exit.
 		void Stop();
-		/// @brief Add a job.
-		SharedPtr<Job> AddJob(Job::WorkFunction function, void* data = nullptr, sizeint dataLength = 0, Job::Preference preference = Job::Preference::Null);
+		/// @brief Add a job.\n
+		/// Jobs added from a worker thread go to its local deque, others go to the public job queue.
+		/// @param counter Optional, increased now and decreased when the job finishes.
+		JobHandle AddJob(Job::WorkFunction function, void* data = nullptr, sizeint dataLength = 0, Job::Preference preference = Job::Preference::Null, const SharedPtr<JobCounter>& counter = SharedPtr<JobCounter>(), Job::Priority priority = Job::Priority::Normal);
+		/// @brief Add a callable taking no arguments as a job, such as a lambda with captures.\n
+		/// Small callables are moved into the job itself, larger ones into a pooled payload.
+		/// @param counter Optional, increased now and decreased when the job finishes.
+		template<typename Callable> requires std::is_invocable_v<std::decay_t<Callable>&>
+		JobHandle AddJob(Callable&& callable, Job::Preference preference = Job::Preference::Null, const SharedPtr<JobCounter>& counter = SharedPtr<JobCounter>(), Job::Priority priority = Job::Priority::Normal) {
+			using T = std::decay_t<Callable>;
+
+			Job* job = PrepareJob(nullptr, nullptr, 0, counter, priority);
+			if constexpr (sizeof(T) <= Job::DataLength && alignof(T) <= Job::DataAlignment) {
+				Memory::Construct(job->GetDataAs<T>(), Memory::Forward<Callable>(callable));
+				job->function = [](Job* job) {
+					T* callable = job->GetDataAs<T>();
+					(*callable)();
+					Memory::Destruct(callable);
+				};
+			} else {
+				static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned callables are not supported.");
+				T* payload = (T*)JobPool::AllocatePayload(sizeof(T));
+				Memory::Construct(payload, Memory::Forward<Callable>(callable));
+				*job->GetDataAs<T*>() = payload;
+				job->function = [](Job* job) {
+					T* callable = *job->GetDataAs<T*>();
+					(*callable)();
+					Memory::Destruct(callable);
+					JobPool::ReleasePayload(callable, sizeof(T));
+				};
+			}
+
+			JobHandle handle(job, job->generation.Get());
+			ScheduleJob(job, preference);
+			return handle;
+		}
+		/// @brief Add a job which will only be queued after the dependency counter reaches zero.
+		/// @param counter Optional, increased now and decreased when the job finishes.
+		JobHandle AddJobAfter(const SharedPtr<JobCounter>& dependency, Job::WorkFunction function, void* data = nullptr, sizeint dataLength = 0, Job::Preference preference = Job::Preference::Null, const SharedPtr<JobCounter>& counter = SharedPtr<JobCounter>(), Job::Priority priority = Job::Priority::Normal);
 		/// @brief Indicates if the job system is still running.
 		bool IsRunning() const;
-		/// @brief Wait for a job stop. Will help run other jobs while waiting.
-		void WaitJob(SharedPtr<Job> job);
+		int32 GetWorkerCount() const;
+		/// @brief Wait for a job stop. Will help run other jobs while waiting.\n
+		/// Inside a fiber mode job, suspends the job until then instead.
+		void WaitJob(const JobHandle& job);
+		/// @brief Wait for a counter reaches zero. Will help run other jobs while waiting.\n
+		/// Inside a fiber mode job, suspends the job until then instead.
+		void WaitCounter(const SharedPtr<JobCounter>& counter);
+		/// @brief Call function(index) for every index in [begin, end), split into chunks across the workers.\n
+		/// The calling thread takes part in the work, returns after all the indices are done.
+		/// @param grainSize Indices per chunk. 0 or less to pick one automatically.
+		template<typename Function>
+		void ParallelFor(int32 begin, int32 end, int32 grainSize, const Function& function) {
+			if (end <= begin) {
+				return;
+			}
+
+			ParallelForContext context;
+			context.begin = begin;
+			context.end = end;
+			context.grainSize = grainSize > 0 ? grainSize : GetAutoGrainSize(end - begin);
+			context.next.Set(begin);
+			context.function = &function;
+			context.invoke = [](const void* function, int32 from, int32 to) {
+				const Function& f = *(const Function*)function;
+				for (int32 i = from; i < to; i += 1) {
+					f(i);
+				}
+			};
+			RunParallelFor(context);
+		}
+		/// @brief Call function(element) for every element in the list in parallel. See ParallelFor().
+		template<typename T, typename Function>
+		void ParallelForEach(List<T>& list, int32 grainSize, const Function& function) {
+			T* elements = list.GetRawElementPtr();
+			ParallelFor(0, list.GetCount(), grainSize, [elements, &function](int32 index) {
+				function(elements[index]);
+			});
+		}
+
+		/// @brief Sort the list in parallel, equal elements may be reordered.\n
+		/// The list is split into a power of 2 of runs which are sorted with introsort at once, then merged pairwise in rounds.\n
+		/// Lists shorter than ParallelSortThreshold are sorted on the calling thread.\n
+		/// The merge buffer comes from the list's allocator.
+		/// @param compare Returns true if the first argument goes before the second. Called from several threads at once.
+		template<typename T, typename Compare = SortLess>
+		void ParallelSort(List<T>& list, const Compare& compare = Compare()) {
+			int32 count = list.GetCount();
+			int32 runCount = 1;
+			while (runCount < GetWorkerCount() + 1 && count / (runCount * 2) >= ParallelSortThreshold / 2) {
+				runCount *= 2;
+			}
+			if (count < ParallelSortThreshold || runCount == 1) {
+				list.Sort(compare);
+				return;
+			}
+
+			T* elements = list.GetRawElementPtr();
+			auto bound = [count, runCount](int32 run) {
+				return (int32)((int64)count * run / runCount);
+			};
+			ParallelFor(0, runCount, 1, [elements, &bound, &compare](int32 run) {
+				int32 begin = bound(run);
+				Sorting::Sort(elements + begin, bound(run + 1) - begin, compare);
+			});
+
+			// Each merge only uses the part of the buffer under its own left run.
+			T* buffer = (T*)Allocator::AllocateFrom(list.GetAllocator(), sizeof(T) * count, alignof(T));
+			for (int32 width = 1; width < runCount; width *= 2) {
+				ParallelFor(0, runCount / (width * 2), 1, [elements, buffer, width, &bound, &compare](int32 pair) {
+					int32 begin = bound(pair * width * 2);
+					int32 middle = bound(pair * width * 2 + width);
+					int32 end = bound(pair * width * 2 + width * 2);
+					Sorting::Merge(elements + begin, middle - begin, end - begin, buffer + begin, compare);
+				});
+			}
+			Allocator::DeallocateTo(list.GetAllocator(), buffer, sizeof(T) * count);
+		}
+		/// @brief Lists shorter than this are not sorted in parallel by ParallelSort().
+		static inline constexpr int32 ParallelSortThreshold = 8192;
+
+		/// @brief Once in this many fetches a worker looks at the background jobs first.
+		static inline constexpr uint32 BackgroundInterval = 16;
+
+		/// @brief Trade latency for power, for many headless instances packed on a host or running on battery.\n
+		/// Workers park as soon as they run out of jobs instead of searching for more first,
+		/// and new jobs only wake workers while fewer than GetActiveWorkerLimit() are awake.
+		void SetEfficiencyMode(bool enabled);
+		bool IsEfficiencyMode() const;
+		/// @brief Count of workers not parked.
+		int32 GetActiveWorkerCount() const;
+		/// @brief How many workers are kept awake in efficiency mode.\n
+		/// Follows the share of the time workers spent running lately, twice that plus one so a rising load gets room quickly.
+		int32 GetActiveWorkerLimit() const;
+		/// @brief Pauses of the longest wait of JobWorker::Search(), doubling from 1.
+		static inline constexpr int32 MaxSearchSpins = 64;
+		/// @brief Nanoseconds between measurements of the load.
+		static inline constexpr int64 LoadInterval = 4000000;
+		/// @brief Workers check whether to measure the load once in this many fetches, also whenever they park.
+		static inline constexpr uint32 LoadCheckInterval = 64;
+
+		/// @brief Run one pending job on the current thread.\n
+		/// Exclusive jobs are only taken when the current thread is their target worker.
+		/// @return false if there are no jobs to run.
+		bool RunPendingJob();
 
 	private:
 		friend class JobWorker;
+		friend class JobCounter;
+
+		struct ParallelForContext {
+			int32 begin = 0;
+			int32 end = 0;
+			int32 grainSize = 1;
+			// Next index to be taken.
+			AtomicValue<int32> next;
+			const void* function = nullptr;
+			void (*invoke)(const void* function, int32 from, int32 to) = nullptr;
+		};
+		int32 GetAutoGrainSize(int32 count) const;
+		void RunParallelFor(ParallelForContext& context);
+		/// @brief Take chunks from the context until all of them are taken.
+		static void RunParallelForChunks(ParallelForContext* context);
+
+		Job* PrepareJob(Job::WorkFunction function, void* data, sizeint dataLength, const SharedPtr<JobCounter>& counter, Job::Priority priority);
+		/// @brief Put a prepared job into the queues and wake up the workers.
+		void ScheduleJob(Job* job, Job::Preference preference);
 
 		/// @brief Get a job from the public job queue.
-		SharedPtr<Job> GetJob();
+		Job* GetJob(Job::Priority priority);
+		/// @brief Try stealing a job from the workers' local deques, starting from a random victim.
+		/// @param thief The worker who steals, will be skipped. Can be nullptr.
+		Job* StealJob(JobWorker* thief, uint32& seed, Job::Priority priority);
+		void AddPublicJob(Job* job);
+
+		/// @brief Wake up one idle worker if any.
+		void WakeWorker();
+		/// @brief Wake up the specific worker if it is idle.
+		void WakeWorker(JobWorker* worker);
+		void WakeAllWorkers();
+		/// @brief Put a worker into the idle list. Used by JobWorker::Park().
+		void AddIdleWorker(JobWorker* worker);
+		/// @return false if the worker has already been taken by a waker.
+		bool RemoveIdleWorker(JobWorker* worker);
+		/// @brief Measure the load and update the active worker limit, by whichever worker comes first once LoadInterval passed.
+		void UpdateLoad();
 
 		volatile bool running = false;
 
 		List<SharedPtr<JobWorker>> workers{ 12 };
 
-		List<SharedPtr<Job>> jobs{ 100 };
-		mutable Mutex jobsMutex;
-		ConditionVariable jobsCond;
-		mutable Mutex jobsCondMutex;
+		// Injection point for non-worker threads and overflow of full local deques.
+		List<Job*> jobs[Job::PriorityCount];
+		mutable AdaptiveMutex jobsMutex;
+
+		// Sleeping workers, woken one by one when there are new jobs.
+		List<JobWorker*> idleWorkers{ 12 };
+		mutable AdaptiveMutex idleWorkersMutex;
+		AtomicValue<int32> idleWorkerCount;
+
+		AtomicValue<bool> efficiencyMode{ false };
+		AtomicValue<int32> activeWorkerLimit{ 1 };
+		// When the load was measured last, claimed by the worker measuring it.
+		AtomicValue<int64> lastLoadUpdate{ 0 };
+		// Written by the worker which claimed the measurement, the workers claiming the next ones read it.
+		std::atomic<int64> lastParkedTime{ 0 };
 
-		Dictionary<Job::Preference, int32> preferenceToWorker;
+		FlatMap<Job::Preference, int32> preferenceToWorker;
 
 		int32 lastId = -1;
 	};
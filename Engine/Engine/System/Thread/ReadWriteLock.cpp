@@ -0,0 +1,64 @@
+#include "Engine/System/Thread/ReadWriteLock.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+
+namespace Engine {
+	template<typename F>
+	bool ReadWriteLock::Spin(F try_) {
+		if (!ThreadUtil::IsSpinningUseful()) {
+			return false;
+		}
+		int32 estimate = spins.load(std::memory_order_relaxed);
+		int32 limit = estimate * 2 + 10;
+		limit = limit < MaxSpins ? limit : MaxSpins;
+		for (int32 i = 0; i < limit; i += 1) {
+			ThreadUtil::SpinPause();
+			if (try_()) {
+				spins.store(estimate + (i - estimate) / 8, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		spins.store(estimate + (limit - estimate) / 8, std::memory_order_relaxed);
+		return false;
+	}
+	template<typename F>
+	void ReadWriteLock::Park(F try_) {
+		waiters.fetch_add(1, std::memory_order_relaxed);
+		// Pairs with the fence of WakeIfWaiting().
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while (true) {
+			// Read before trying, so a release after the try bumps it past what we wait on.
+			uint32 seen = sequence.load(std::memory_order_acquire);
+			if (try_()) {
+				break;
+			}
+			sequence.wait(seen, std::memory_order_acquire);
+		}
+		waiters.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void ReadWriteLock::LockSharedSlow() {
+		auto tryLock = [this]() {
+			return try_lock_shared();
+		};
+		if (!Spin(tryLock)) {
+			Park(tryLock);
+		}
+	}
+	void ReadWriteLock::LockSlow() {
+		auto tryLock = [this]() {
+			return state.load(std::memory_order_relaxed) == 0 && try_lock();
+		};
+		if (Spin(tryLock)) {
+			return;
+		}
+		// New readers wait from now on, the current ones are let finish.
+		writersWaiting.fetch_add(1, std::memory_order_relaxed);
+		Park(tryLock);
+		// The readers held off are woken when this writer unlocks.
+		writersWaiting.fetch_sub(1, std::memory_order_relaxed);
+	}
+	void ReadWriteLock::Wake() {
+		sequence.fetch_add(1, std::memory_order_release);
+		sequence.notify_all();
+	}
+}
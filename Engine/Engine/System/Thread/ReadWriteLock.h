@@ -0,0 +1,88 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include <atomic>
+#include <shared_mutex>
+
+namespace Engine {
+	template<typename T>
+	using SharedLock = std::shared_lock<T>;
+
+	/// @brief A lock any number of readers hold at once, or a single writer, for structures read far more often than written.\n
+	/// Like AdaptiveMutex it spins a while before sleeping on an atomic, and taking it uncontended is a single atomic operation.
+	/// Waiting writers hold off new readers, so a steady stream of readers doesn't starve them.\n
+	/// Lock for reading with SharedLock, for writing with SimpleLock or AdvanceLock. Not recursive, asking for writing while reading deadlocks.
+	class ReadWriteLock final {
+	public:
+		/// @brief Most spins before sleeping.
+		static inline constexpr int32 MaxSpins = 128;
+
+		ReadWriteLock() = default;
+		ReadWriteLock(const ReadWriteLock&) = delete;
+		ReadWriteLock& operator=(const ReadWriteLock&) = delete;
+
+		void lock_shared() {
+			if (!try_lock_shared()) {
+				LockSharedSlow();
+			}
+		}
+		bool try_lock_shared() {
+			uint32 current = state.load(std::memory_order_relaxed);
+			while ((current & Writer) == 0 && writersWaiting.load(std::memory_order_relaxed) == 0) {
+				if (state.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+					return true;
+				}
+			}
+			return false;
+		}
+		void unlock_shared() {
+			// Only the last reader leaving can let anyone in.
+			if (state.fetch_sub(1, std::memory_order_release) == 1) {
+				WakeIfWaiting();
+			}
+		}
+
+		void lock() {
+			if (!try_lock()) {
+				LockSlow();
+			}
+		}
+		bool try_lock() {
+			uint32 expected = 0;
+			return state.compare_exchange_strong(expected, Writer, std::memory_order_acquire, std::memory_order_relaxed);
+		}
+		void unlock() {
+			state.store(0, std::memory_order_release);
+			WakeIfWaiting();
+		}
+
+	private:
+		static inline constexpr uint32 Writer = 1u << 31;
+
+		void LockSharedSlow();
+		void LockSlow();
+		void WakeIfWaiting() {
+			// Pairs with the fence taken by the threads going to sleep, either we see them waiting or they see the lock free.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (waiters.load(std::memory_order_relaxed) > 0) {
+				Wake();
+			}
+		}
+		void Wake();
+		/// @brief Spin until try() succeeds, for up to about as long as it took lately.
+		template<typename F>
+		bool Spin(F try_);
+		/// @brief Sleep until try() succeeds, woken by the releases.
+		template<typename F>
+		void Park(F try_);
+
+		/// @brief The Writer bit, or the count of readers.
+		std::atomic<uint32> state{ 0 };
+		std::atomic<int32> writersWaiting{ 0 };
+		/// @brief Threads sleeping or about to, readers and writers.
+		std::atomic<int32> waiters{ 0 };
+		/// @brief What the sleeping threads wait on, bumped to wake them. Waiting on the state would miss a release followed by another acquisition.
+		std::atomic<uint32> sequence{ 0 };
+		/// @brief Running average of the spins the lock took to get lately, a hint only.
+		std::atomic<int32> spins{ 0 };
+	};
+}
@@ -0,0 +1,198 @@
+#include "Engine/System/Thread/TaskGraph.h"
+#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Profiler.h"
+
+namespace Engine {
+	TaskGraph::~TaskGraph() {
+		ERR_ASSERT(!running, u8"A task graph is destroyed while running.", return);
+		for (const Phase& phase : phases) {
+			if (phase.destroy != nullptr) {
+				phase.destroy(phase.data);
+			}
+		}
+		ReleasePending();
+	}
+
+	bool TaskGraph::AddPhase(const StringName& name, PhaseFunction function, void* data, std::initializer_list<StringName> reads, std::initializer_list<StringName> writes, Job::Preference preference) {
+		ERR_ASSERT(function != nullptr, u8"function cannot be nullptr.", return false);
+		ERR_ASSERT(!running, u8"Phases cannot be added while the graph runs.", return false);
+		if (FindPhase(name) >= 0) {
+			return false;
+		}
+		Phase phase{};
+		phase.name = name;
+		phase.function = function;
+		phase.data = data;
+		phase.preference = preference;
+		for (const StringName& resource : reads) {
+			phase.reads.Add(resource);
+		}
+		for (const StringName& resource : writes) {
+			phase.writes.Add(resource);
+		}
+		phases.Add(Memory::Move(phase));
+		compiled = false;
+		return true;
+	}
+	bool TaskGraph::RemovePhase(const StringName& name) {
+		ERR_ASSERT(!running, u8"Phases cannot be removed while the graph runs.", return false);
+		int32 index = FindPhase(name);
+		if (index < 0) {
+			return false;
+		}
+		if (phases[index].destroy != nullptr) {
+			phases[index].destroy(phases[index].data);
+		}
+		phases.RemoveAt(index);
+		compiled = false;
+		return true;
+	}
+	int32 TaskGraph::FindPhase(const StringName& name) const {
+		for (int32 i = 0; i < phases.GetCount(); i += 1) {
+			if (phases[i].name == name) {
+				return i;
+			}
+		}
+		return -1;
+	}
+	int32 TaskGraph::GetPhaseCount() const {
+		return phases.GetCount();
+	}
+	const StringName& TaskGraph::GetPhaseName(int32 index) const {
+		return phases[index].name;
+	}
+	const List<int32>& TaskGraph::GetDependencies(int32 index) {
+		if (!compiled) {
+			Compile();
+		}
+		return phases[index].dependencies;
+	}
+
+	void TaskGraph::Compile() {
+		ERR_ASSERT(!running, u8"The graph cannot be compiled while it runs.", return);
+		// The last writer of each resource and the readers since, over the phases before the current one.
+		struct Access {
+			int32 writer = -1;
+			List<int32> readers{};
+		};
+		List<Access> accesses{};
+		Dictionary<StringName, int32> accessIndices{};
+		auto find = [&accesses, &accessIndices](const StringName& resource) -> Access& {
+			int32 index = -1;
+			if (!accessIndices.TryGet(resource, index)) {
+				index = accesses.GetCount();
+				accesses.Add(Access());
+				accessIndices.Add(resource, index);
+			}
+			return accesses[index];
+		};
+		auto depend = [this](int32 index, int32 dependency) {
+			if (dependency < 0 || dependency == index) {
+				return;
+			}
+			for (int32 existing : phases[index].dependencies) {
+				if (existing == dependency) {
+					return;
+				}
+			}
+			phases[index].dependencies.Add(dependency);
+			phases[dependency].dependents.Add(index);
+		};
+
+		for (int32 i = 0; i < phases.GetCount(); i += 1) {
+			phases[i].dependencies.Clear();
+			phases[i].dependents.Clear();
+		}
+		for (int32 i = 0; i < phases.GetCount(); i += 1) {
+			Phase& phase = phases[i];
+			for (const StringName& resource : phase.reads) {
+				depend(i, find(resource).writer);
+			}
+			for (const StringName& resource : phase.writes) {
+				Access& access = find(resource);
+				depend(i, access.writer);
+				for (int32 reader : access.readers) {
+					depend(i, reader);
+				}
+			}
+			// Recorded after the whole phase, a phase reading and writing the same resource doesn't wait for itself.
+			for (const StringName& resource : phase.reads) {
+				find(resource).readers.Add(i);
+			}
+			for (const StringName& resource : phase.writes) {
+				Access& access = find(resource);
+				access.writer = i;
+				access.readers.Clear();
+			}
+		}
+
+		if (pendingCount != phases.GetCount()) {
+			ReleasePending();
+			if (phases.GetCount() > 0) {
+				pending = MEMNEWARR(AtomicValue<int32>, phases.GetCount());
+				pendingCount = phases.GetCount();
+			}
+		}
+		compiled = true;
+	}
+
+	void TaskGraph::Run(JobSystem* jobSystem) {
+		ERR_ASSERT(!running, u8"The graph is running already.", return);
+		if (!compiled) {
+			Compile();
+		}
+		if (phases.GetCount() == 0) {
+			return;
+		}
+		running = true;
+
+		if (jobSystem == nullptr || !jobSystem->IsRunning()) {
+			// Dependencies always come earlier, so the order of adding satisfies all of them.
+			for (int32 i = 0; i < phases.GetCount(); i += 1) {
+				RunPhase(i);
+			}
+			running = false;
+			return;
+		}
+
+		this->jobSystem = jobSystem;
+		if (counter == nullptr) {
+			counter = SharedPtr<JobCounter>::Create();
+		}
+		for (int32 i = 0; i < phases.GetCount(); i += 1) {
+			pending[i].Set(phases[i].dependencies.GetCount());
+		}
+		for (int32 i = 0; i < phases.GetCount(); i += 1) {
+			if (phases[i].dependencies.GetCount() == 0) {
+				Schedule(i);
+			}
+		}
+		// A phase queues its dependents before its own job finishes, so the counter only reaches zero once all of them did.
+		jobSystem->WaitCounter(counter);
+		this->jobSystem = nullptr;
+		running = false;
+	}
+
+	void TaskGraph::Schedule(int32 index) {
+		jobSystem->AddJob([this, index]() {
+			RunPhase(index);
+			for (int32 dependent : phases[index].dependents) {
+				if (pending[dependent].Subtract(1) == 0) {
+					Schedule(dependent);
+				}
+			}
+		}, phases[index].preference, counter, Job::Priority::Critical);
+	}
+	void TaskGraph::RunPhase(int32 index) {
+		PROFILE_SCOPE("TaskGraph::RunPhase");
+		const Phase& phase = phases[index];
+		phase.function(phase.data);
+	}
+	void TaskGraph::ReleasePending() {
+		if (pending != nullptr) {
+			MEMDELARR(pending);
+			pending = nullptr;
+		}
+		pendingCount = 0;
+	}
+}
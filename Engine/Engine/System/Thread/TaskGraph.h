@@ -0,0 +1,80 @@
+#pragma once
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/StringName.h"
+#include <initializer_list>
+
+namespace Engine {
+	/// @brief Phases declaring the resources they read and write, run as jobs in an order derived from them.\n
+	/// A phase runs after every earlier added phase writing what it reads, and a writer also after the earlier readers since the last write.
+	/// Phases touching nothing in common run at the same time. Resources are only names, they can stand for anything, such as "Transforms".\n
+	/// The dependencies are compiled once after phases change, a Run() afterwards is allocation-free apart from the jobs.
+	class TaskGraph final {
+	public:
+		using PhaseFunction = void (*)(void* data);
+
+		TaskGraph() = default;
+		~TaskGraph();
+		TaskGraph(const TaskGraph&) = delete;
+		TaskGraph& operator=(const TaskGraph&) = delete;
+
+		/// @brief Add a phase after the others.
+		/// @param preference Job::Preference::Window for a phase which must run on the window worker.
+		/// @return false if a phase of the name exists already.
+		bool AddPhase(const StringName& name, PhaseFunction function, void* data, std::initializer_list<StringName> reads, std::initializer_list<StringName> writes, Job::Preference preference = Job::Preference::Null);
+		/// @brief Add a callable taking no arguments as a phase, kept until the phase is removed.
+		template<typename Callable> requires std::is_invocable_v<std::decay_t<Callable>&>
+		bool AddPhase(const StringName& name, Callable&& callable, std::initializer_list<StringName> reads, std::initializer_list<StringName> writes, Job::Preference preference = Job::Preference::Null) {
+			using T = std::decay_t<Callable>;
+			if (FindPhase(name) >= 0) {
+				return false;
+			}
+			T* stored = MEMNEW(T(Memory::Forward<Callable>(callable)));
+			AddPhase(name, [](void* data) { (*(T*)data)(); }, stored, reads, writes, preference);
+			phases[phases.GetCount() - 1].destroy = [](void* data) { MEMDEL((T*)data); };
+			return true;
+		}
+		bool RemovePhase(const StringName& name);
+		/// @return The index of the phase, -1 if not found.
+		int32 FindPhase(const StringName& name) const;
+		int32 GetPhaseCount() const;
+		const StringName& GetPhaseName(int32 index) const;
+		/// @brief The phases which must finish before the phase, compiling the graph first if needed.
+		const List<int32>& GetDependencies(int32 index);
+
+		/// @brief Derive the dependencies, done by Run() when the phases changed since.
+		void Compile();
+		/// @brief Run every phase once and return when all of them finished. The calling thread helps running them.\n
+		/// Without a running job system they run one after another on the calling thread, in the order they were added.
+		void Run(JobSystem* jobSystem);
+
+	private:
+		struct Phase {
+			StringName name{};
+			PhaseFunction function = nullptr;
+			void* data = nullptr;
+			/// @brief Frees the data of callables.
+			void (*destroy)(void* data) = nullptr;
+			List<StringName> reads{};
+			List<StringName> writes{};
+			Job::Preference preference = Job::Preference::Null;
+			/// @brief Compiled, phases this one waits for and phases waiting for this one.
+			List<int32> dependencies{};
+			List<int32> dependents{};
+		};
+		/// @brief Queue the phase as a job, counted by the counter of the run.
+		void Schedule(int32 index);
+		void RunPhase(int32 index);
+		void ReleasePending();
+
+		List<Phase> phases{};
+		bool compiled = false;
+		bool running = false;
+
+		// State of the run in progress.
+		JobSystem* jobSystem = nullptr;
+		SharedPtr<JobCounter> counter{};
+		/// @brief Per phase, the dependencies not finished yet in this run.
+		AtomicValue<int32>* pending = nullptr;
+		int32 pendingCount = 0;
+	};
+}
@@ -1,8 +1,115 @@
 #include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/Platform/Definition.h"
 #include <thread>
 
+#if CURRENT_PLATFORM_WINDOWS
+#	include "Engine/Platform/Windows/BetterWindows.h"
+#	include "Engine/Platform/Windows/UnicodeHelper.h"
+#elif CURRENT_PLATFORM_LINUX
+#	include <pthread.h>
+#	include <sched.h>
+#	include <sys/resource.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#	include <immintrin.h>
+#	define SPIN_PAUSE() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#	define SPIN_PAUSE() __asm__ __volatile__("yield")
+#else
+#	define SPIN_PAUSE() ((void)0)
+#endif
+
 namespace Engine {
 	int32 ThreadUtil::GetHardwareThreadCount() {
 		return (int32)std::thread::hardware_concurrency();
 	}
+	void ThreadUtil::SpinPause() {
+		SPIN_PAUSE();
+	}
+	bool ThreadUtil::IsSpinningUseful() {
+		static const bool useful = GetHardwareThreadCount() > 1;
+		return useful;
+	}
+	void ThreadUtil::YieldThread() {
+		std::this_thread::yield();
+	}
+
+#if CURRENT_PLATFORM_WINDOWS
+	bool ThreadUtil::SetCurrentThreadName(const String& name) {
+		UniquePtr<WCHAR[]> buffer;
+		if (!PlatformSpecific::Windows::UnicodeHelper::UTF8ToUnicode(name, buffer)) {
+			return false;
+		}
+		return SUCCEEDED(SetThreadDescription(GetCurrentThread(), buffer.GetRaw()));
+	}
+	bool ThreadUtil::SetCurrentThreadAffinity(int32 core) {
+		ERR_ASSERT(core >= 0 && core < 64, u8"core out of range.", return false);
+		return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0;
+	}
+	bool ThreadUtil::SetCurrentThreadPriority(Priority priority) {
+		int value = THREAD_PRIORITY_NORMAL;
+		switch (priority) {
+			case Priority::Lowest:
+				value = THREAD_PRIORITY_LOWEST;
+				break;
+			case Priority::Low:
+				value = THREAD_PRIORITY_BELOW_NORMAL;
+				break;
+			case Priority::Normal:
+				value = THREAD_PRIORITY_NORMAL;
+				break;
+			case Priority::High:
+				value = THREAD_PRIORITY_ABOVE_NORMAL;
+				break;
+			case Priority::Highest:
+				value = THREAD_PRIORITY_HIGHEST;
+				break;
+		}
+		return SetThreadPriority(GetCurrentThread(), value);
+	}
+#elif CURRENT_PLATFORM_LINUX
+	bool ThreadUtil::SetCurrentThreadName(const String& name) {
+		// Linux limits thread names to 15 bytes.
+		static constexpr int32 MaxLength = 15;
+		char buffer[MaxLength + 1] = {};
+		int32 length = name.GetCount() < MaxLength ? name.GetCount() : MaxLength;
+		const u8char* raw = name.GetRawArray();
+		for (int32 i = 0; i < length; i += 1) {
+			buffer[i] = (char)raw[i];
+		}
+		return pthread_setname_np(pthread_self(), buffer) == 0;
+	}
+	bool ThreadUtil::SetCurrentThreadAffinity(int32 core) {
+		ERR_ASSERT(core >= 0 && core < CPU_SETSIZE, u8"core out of range.", return false);
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(core, &set);
+		return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+	}
+	bool ThreadUtil::SetCurrentThreadPriority(Priority priority) {
+		// Normal threads are scheduled by their nice value.
+		int value = 0;
+		switch (priority) {
+			case Priority::Lowest:
+				value = 19;
+				break;
+			case Priority::Low:
+				value = 10;
+				break;
+			case Priority::Normal:
+				value = 0;
+				break;
+			case Priority::High:
+				value = -5;
+				break;
+			case Priority::Highest:
+				value = -10;
+				break;
+		}
+		return setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), value) == 0;
+	}
+#endif
 }
@@ -1,23 +1,48 @@
 #pragma once
 #include "Engine/System/Definition.h"
+#include "Engine/System/String.h"
 #include <mutex>
 #include <condition_variable>
+#include <semaphore>
 #include <new>
 
 namespace Engine{
 	using Mutex = std::mutex;
+	/// @brief See ProfiledLock for the same with its waits and holds showing in the profiler.
 	template<typename T>
 	using SimpleLock = std::lock_guard<T>;
 	template<typename T>
 	using AdvanceLock = std::unique_lock<T>;
 
 	using ConditionVariable = std::condition_variable;
+	using Semaphore = std::counting_semaphore<>;
 
 	class ThreadUtil final{
 		STATIC_CLASS(ThreadUtil);
 
 	public:
+		enum class Priority :byte {
+			Lowest,
+			Low,
+			Normal,
+			High,
+			Highest
+		};
+
 		static int32 GetHardwareThreadCount();
+		/// @brief Name the current thread for debuggers and profilers. Might be truncated by the platform.
+		static bool SetCurrentThreadName(const String& name);
+		/// @brief Pin the current thread to a single logical core.
+		/// @param core Zero-based logical core index.
+		static bool SetCurrentThreadAffinity(int32 core);
+		/// @brief Raising the priority may require extra permission on some platforms.
+		static bool SetCurrentThreadPriority(Priority priority);
+		/// @brief Hint the CPU that the current thread is spin-waiting.
+		static void SpinPause();
+		/// @brief Whether spin-waiting for another thread can pay off, false with a single hardware thread where the other can't run meanwhile.
+		static bool IsSpinningUseful();
+		/// @brief Give up the rest of the current time slice.
+		static void YieldThread();
 		static inline constexpr sizeint CacheLineSize = 64;//std::hardware_destructive_interference_size;
 	};
 }
@@ -0,0 +1,109 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+#include <type_traits>
+
+// Chase-Lev work-stealing deque, memory orderings follow
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al., 2013).
+
+namespace Engine {
+	/// @brief A fixed capacity lock-free work-stealing deque.\n
+	/// Only the owner thread may call Push() and Pop(), which work on the bottom side (LIFO).\n
+	/// Any thread may call Steal(), which takes from the top side (FIFO).
+	template<typename T>
+	class WorkStealingQueue final {
+		static_assert(std::is_trivially_copyable_v<T>, "WorkStealingQueue only holds trivially copyable values, such as pointers.");
+
+	public:
+		static inline constexpr int64 DefaultCapacity = 1024;
+
+		/// @param capacity Will be rounded up to the power of 2.
+		WorkStealingQueue(int64 capacity = DefaultCapacity) {
+			ERR_ASSERT(capacity > 0, u8"capacity must be larger than 0.", capacity = DefaultCapacity);
+
+			int64 size = 1;
+			while (size < capacity) {
+				size <<= 1;
+			}
+			mask = size - 1;
+			buffer = MEMNEWARR(std::atomic<T>, size);
+		}
+		~WorkStealingQueue() {
+			MEMDELARR(buffer);
+		}
+		WorkStealingQueue(const WorkStealingQueue&) = delete;
+		WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+		/// @brief Push a value to the bottom. Owner thread only.
+		/// @return false when the queue is full.
+		bool Push(T value) {
+			int64 b = bottom.load(std::memory_order_relaxed);
+			int64 t = top.load(std::memory_order_acquire);
+			if (b - t > mask) {
+				return false;
+			}
+			buffer[b & mask].store(value, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return true;
+		}
+		/// @brief Pop the latest pushed value from the bottom. Owner thread only.
+		bool Pop(T& result) {
+			int64 b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 t = top.load(std::memory_order_relaxed);
+
+			if (t > b) {
+				// Empty.
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			result = buffer[b & mask].load(std::memory_order_relaxed);
+			if (t == b) {
+				// Last element, race against thieves.
+				bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+		/// @brief Steal the oldest value from the top. Can be called from any thread.\n
+		/// May fail spuriously when racing with other thieves.
+		bool Steal(T& result) {
+			int64 t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 b = bottom.load(std::memory_order_acquire);
+			if (t >= b) {
+				return false;
+			}
+
+			T value = buffer[t & mask].load(std::memory_order_relaxed);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				return false;
+			}
+			result = value;
+			return true;
+		}
+
+		/// @brief Get an approximate element count. Only exact when called by the owner with no thieves around.
+		int64 GetCount() const {
+			int64 b = bottom.load(std::memory_order_relaxed);
+			int64 t = top.load(std::memory_order_relaxed);
+			return b > t ? b - t : 0;
+		}
+		int64 GetCapacity() const {
+			return mask + 1;
+		}
+
+	private:
+		// Keep the thief side and the owner side on different cache lines.
+		alignas(ThreadUtil::CacheLineSize) std::atomic<int64> top{ 0 };
+		alignas(ThreadUtil::CacheLineSize) std::atomic<int64> bottom{ 0 };
+		std::atomic<T>* buffer = nullptr;
+		int64 mask = 0;
+	};
+}
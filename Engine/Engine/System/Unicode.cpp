@@ -0,0 +1,152 @@
+#include "Engine/System/Unicode.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNICODE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define UNICODE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Engine {
+	namespace {
+		/// @brief Get the count of ASCII chars at the start, checking a block of bytes at a time.
+		int32 SkipASCII(const u8char* text, int32 count) {
+			int32 i = 0;
+#if defined(UNICODE_SSE2)
+			for (; i + 16 <= count; i += 16) {
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+				if (_mm_movemask_epi8(block) != 0) {
+					break;
+				}
+			}
+#elif defined(UNICODE_NEON)
+			uint8x16_t highBit = vdupq_n_u8(0x80);
+			for (; i + 16 <= count; i += 16) {
+				uint8x16_t block = vandq_u8(vld1q_u8(reinterpret_cast<const byte*>(text + i)), highBit);
+				uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(block), 4);
+				if (vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) != 0) {
+					break;
+				}
+			}
+#endif
+			// Eight bytes at a time in a word.
+			for (; i + 8 <= count; i += 8) {
+				uint64 word;
+				std::memcpy(&word, text + i, sizeof(word));
+				if ((word & 0x8080808080808080ull) != 0) {
+					break;
+				}
+			}
+			for (; i < count && (byte)text[i] < 0x80; i += 1);
+			return i;
+		}
+
+		/// @brief Decode a multi-byte sequence.
+		/// @return The byte count, 0 if the sequence is invalid.
+		int32 DecodeSequence(const u8char* text, int32 count, uint32& codepoint) {
+			byte lead = (byte)text[0];
+			int32 length;
+			uint32 value;
+			uint32 minimum;
+			if (lead >= 0xC2 && lead <= 0xDF) {
+				length = 2;
+				value = lead & 0x1F;
+				minimum = 0x80;
+			} else if (lead >= 0xE0 && lead <= 0xEF) {
+				length = 3;
+				value = lead & 0x0F;
+				minimum = 0x800;
+			} else if (lead >= 0xF0 && lead <= 0xF4) {
+				length = 4;
+				value = lead & 0x07;
+				minimum = 0x10000;
+			} else {
+				// ASCII is not handled here. 0x80-0xC1 are continuations or overlong leads, 0xF5-0xFF are never valid.
+				return 0;
+			}
+			if (count < length) {
+				return 0;
+			}
+			for (int32 i = 1; i < length; i += 1) {
+				byte c = (byte)text[i];
+				if ((c & 0xC0) != 0x80) {
+					return 0;
+				}
+				value = (value << 6) | (c & 0x3F);
+			}
+			if (value < minimum || value > Unicode::MaxCodepoint || (value >= 0xD800 && value <= 0xDFFF)) {
+				return 0;
+			}
+			codepoint = value;
+			return length;
+		}
+	}
+
+	bool Unicode::IsValidUTF8(const u8char* text, int32 count) {
+		int32 i = 0;
+		while (i < count) {
+			i += SkipASCII(text + i, count - i);
+			if (i >= count) {
+				break;
+			}
+			uint32 codepoint;
+			int32 length = DecodeSequence(text + i, count - i, codepoint);
+			if (length == 0) {
+				return false;
+			}
+			i += length;
+		}
+		return true;
+	}
+	int32 Unicode::CountCodepoints(const u8char* text, int32 count) {
+		int32 result = 0;
+		for (int32 i = 0; i < count; i += 1) {
+			result += (((byte)text[i] & 0xC0) != 0x80 ? 1 : 0);
+		}
+		return result;
+	}
+
+	int32 Unicode::DecodeUTF8(const u8char* text, int32 count, uint32& codepoint) {
+		if (count <= 0) {
+			codepoint = 0;
+			return 0;
+		}
+		if ((byte)text[0] < 0x80) {
+			codepoint = (byte)text[0];
+			return 1;
+		}
+		int32 length = DecodeSequence(text, count, codepoint);
+		if (length == 0) {
+			codepoint = ReplacementChar;
+			return 1;
+		}
+		return length;
+	}
+	int32 Unicode::EncodeUTF8(uint32 codepoint, u8char* buffer) {
+		if (codepoint > MaxCodepoint || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+			codepoint = ReplacementChar;
+		}
+		if (codepoint < 0x80) {
+			buffer[0] = (u8char)codepoint;
+			return 1;
+		}
+		if (codepoint < 0x800) {
+			buffer[0] = (u8char)(0xC0 | (codepoint >> 6));
+			buffer[1] = (u8char)(0x80 | (codepoint & 0x3F));
+			return 2;
+		}
+		if (codepoint < 0x10000) {
+			buffer[0] = (u8char)(0xE0 | (codepoint >> 12));
+			buffer[1] = (u8char)(0x80 | ((codepoint >> 6) & 0x3F));
+			buffer[2] = (u8char)(0x80 | (codepoint & 0x3F));
+			return 3;
+		}
+		buffer[0] = (u8char)(0xF0 | (codepoint >> 18));
+		buffer[1] = (u8char)(0x80 | ((codepoint >> 12) & 0x3F));
+		buffer[2] = (u8char)(0x80 | ((codepoint >> 6) & 0x3F));
+		buffer[3] = (u8char)(0x80 | (codepoint & 0x3F));
+		return 4;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+
+namespace Engine {
+	/// @brief UTF-8 validation, decoding and encoding over raw char arrays.\n
+	/// Runs of ASCII are skipped a block of bytes at a time, only multi-byte sequences are decoded one by one.
+	class Unicode final {
+	public:
+		STATIC_CLASS(Unicode);
+
+		/// @brief The codepoint given back for invalid sequences, U+FFFD.
+		static inline constexpr uint32 ReplacementChar = 0xFFFD;
+		static inline constexpr uint32 MaxCodepoint = 0x10FFFF;
+		/// @brief The most bytes a codepoint takes in UTF-8.
+		static inline constexpr int32 MaxUTF8Bytes = 4;
+
+		/// @brief Check if the chars are well-formed UTF-8.\n
+		/// Rejects overlong forms, surrogates, codepoints past MaxCodepoint and cut-off sequences.
+		static bool IsValidUTF8(const u8char* text, int32 count);
+		/// @brief Count the codepoints by their lead bytes. Exact for valid UTF-8.
+		static int32 CountCodepoints(const u8char* text, int32 count);
+
+		/// @brief Decode the codepoint at the start of the chars.
+		/// @param codepoint ReplacementChar if the sequence is invalid.
+		/// @return The byte count of the sequence, 1 for an invalid one so decoding can go on. 0 if count is 0.
+		static int32 DecodeUTF8(const u8char* text, int32 count, uint32& codepoint);
+		/// @brief Encode a codepoint into at least MaxUTF8Bytes chars, no NULL appended.\n
+		/// Surrogates and codepoints past MaxCodepoint are encoded as ReplacementChar.
+		/// @return The byte count written.
+		static int32 EncodeUTF8(uint32 codepoint, u8char* buffer);
+
+		/// @brief Walks the codepoints of UTF-8 chars, invalid sequences come out as ReplacementChar.
+		class CodepointIterator {
+		public:
+			CodepointIterator(const u8char* text, const u8char* end) :text(text), end(end) {
+				Decode();
+			}
+			bool operator!=(const CodepointIterator& obj) const {
+				return text != obj.text;
+			}
+			uint32 operator*() const {
+				return codepoint;
+			}
+			CodepointIterator& operator++() {
+				text += length;
+				Decode();
+				return *this;
+			}
+			/// @brief The position of the current codepoint in the chars.
+			const u8char* GetPosition() const {
+				return text;
+			}
+		private:
+			void Decode() {
+				if (text >= end) {
+					length = 0;
+					codepoint = 0;
+				} else if ((byte)*text < 0x80) {
+					length = 1;
+					codepoint = (byte)*text;
+				} else {
+					length = DecodeUTF8(text, (int32)(end - text), codepoint);
+				}
+			}
+
+			const u8char* text;
+			const u8char* end;
+			uint32 codepoint = 0;
+			int32 length = 0;
+		};
+		/// @brief A range of codepoints for range-based for loops. Doesn't hold the chars, keep them alive while iterating.
+		class CodepointRange {
+		public:
+			CodepointRange(const u8char* text, int32 count) :text(text), count(count) {}
+			CodepointIterator begin() const {
+				return CodepointIterator(text, text + count);
+			}
+			CodepointIterator end() const {
+				return CodepointIterator(text + count, text + count);
+			}
+		private:
+			const u8char* text;
+			int32 count;
+		};
+	};
+}
@@ -0,0 +1,508 @@
+#include "Engine/System/VariantStream.h"
+#include "Engine/System/Object/PropertyBatch.h"
+#include <cstdint>
+#include <cstring>
+
+namespace Engine {
+	namespace {
+		/// @brief The first byte of every value.
+		enum class Tag :byte {
+			Null,
+			False,
+			True,
+			Int64,
+			Double,
+			/// @brief A String written for the first time, its length and UTF-8 bytes follow.
+			String,
+			/// @brief The index of a String written before.
+			StringReference,
+			Vector2,
+			PackedByteArray,
+			PackedInt64Array,
+			PackedFloat32Array,
+			PackedVector2Array,
+			/// @brief A blob of VariantWriter::WriteProperties().
+			Properties,
+		};
+		static_assert(sizeof(Vector2) == sizeof(float) * 2, "Vector2 is written as two raw floats.");
+
+		// Small magnitudes of either sign take few bytes.
+		uint64 ZigZag(int64 value) {
+			return ((uint64)value << 1) ^ (uint64)(value >> 63);
+		}
+		int64 UnZigZag(uint64 value) {
+			return (int64)(value >> 1) ^ -(int64)(value & 1);
+		}
+	}
+
+#pragma region VariantWriter
+	VariantWriter::VariantWriter(const IntrusivePtr<Stream>& stream, int32 bufferSize) :stream(stream), bufferSize(bufferSize) {
+		ERR_ASSERT(bufferSize >= 16, u8"bufferSize must be at least 16.", this->bufferSize = DefaultBufferSize);
+		ERR_ASSERT(stream.GetRaw() != nullptr && stream->CanWrite(), u8"The stream cannot write.", error = ResultCode::InvalidStream);
+		buffer.SetCount(this->bufferSize);
+	}
+	VariantWriter::~VariantWriter() {
+		Flush();
+	}
+
+	ResultCode VariantWriter::WriteVariant(const Variant& value) {
+		switch (value.GetType()) {
+			case Variant::Type::Bool:
+				WriteTag((byte)(value.AsBool() ? Tag::True : Tag::False));
+				break;
+			case Variant::Type::Int64:
+				WriteTag((byte)Tag::Int64);
+				WriteVarUInt(ZigZag(value.AsInt64()));
+				break;
+			case Variant::Type::Double:
+			{
+				double v = value.AsDouble();
+				WriteTag((byte)Tag::Double);
+				WriteRaw(&v, 1, sizeof(double));
+				break;
+			}
+			case Variant::Type::String:
+				WriteText(value.AsString());
+				break;
+			case Variant::Type::Vector2:
+			{
+				Vector2 v = value.AsVector2();
+				WriteTag((byte)Tag::Vector2);
+				WriteRaw(&v, 2, sizeof(float));
+				break;
+			}
+			case Variant::Type::PackedByteArray:
+			{
+				PackedByteArray array = value.AsPackedByteArray();
+				WriteTag((byte)Tag::PackedByteArray);
+				WriteVarUInt((uint64)array.GetCount());
+				WriteRaw(array.GetData(), array.GetCount(), sizeof(byte));
+				break;
+			}
+			case Variant::Type::PackedInt64Array:
+			{
+				PackedInt64Array array = value.AsPackedInt64Array();
+				WriteTag((byte)Tag::PackedInt64Array);
+				WriteVarUInt((uint64)array.GetCount());
+				WriteRaw(array.GetData(), array.GetCount(), sizeof(int64));
+				break;
+			}
+			case Variant::Type::PackedFloat32Array:
+			{
+				PackedFloat32Array array = value.AsPackedFloat32Array();
+				WriteTag((byte)Tag::PackedFloat32Array);
+				WriteVarUInt((uint64)array.GetCount());
+				WriteRaw(array.GetData(), array.GetCount(), sizeof(float));
+				break;
+			}
+			case Variant::Type::PackedVector2Array:
+			{
+				PackedVector2Array array = value.AsPackedVector2Array();
+				WriteTag((byte)Tag::PackedVector2Array);
+				WriteVarUInt((uint64)array.GetCount());
+				WriteRaw(array.GetData(), array.GetCount() * 2, sizeof(float));
+				break;
+			}
+			default:
+				// Null, and objects which can't be stored.
+				WriteTag((byte)Tag::Null);
+				break;
+		}
+		return error;
+	}
+	ResultCode VariantWriter::WriteProperties(const PropertyBatch& batch, const Object* const* objects, int32 objectCount) {
+		List<Variant> values{};
+		ResultCode result = batch.GetValues(objects, objectCount, values);
+		if (result != ResultCode::OK) {
+			return result;
+		}
+
+		WriteTag((byte)Tag::Properties);
+		WriteVarUInt((uint64)batch.GetCount());
+		for (int32 i = 0; i < batch.GetCount(); i += 1) {
+			WriteText(batch.GetProperty(i)->GetName().GetString());
+		}
+		WriteVarUInt((uint64)objectCount);
+		for (const Variant& value : values) {
+			WriteVariant(value);
+		}
+		return error;
+	}
+	ResultCode VariantWriter::Flush() {
+		if (error == ResultCode::OK && used > 0) {
+			error = stream->WriteBytes(buffer.GetRawElementPtr(), used);
+		}
+		used = 0;
+		return error;
+	}
+	const IntrusivePtr<Stream>& VariantWriter::GetStream() const {
+		return stream;
+	}
+
+	byte* VariantWriter::Reserve(int32 length) {
+		if (used + length > buffer.GetCount()) {
+			Flush();
+		}
+		byte* result = buffer.GetRawElementPtr() + used;
+		used += length;
+		return result;
+	}
+	void VariantWriter::WriteTag(byte tag) {
+		*Reserve(1) = tag;
+	}
+	void VariantWriter::WriteVarUInt(uint64 value) {
+		// 7 bits per byte, the high bit tells that more follow.
+		constexpr int32 MaxSize = 10;
+		byte* out = Reserve(MaxSize);
+		int32 size = 0;
+		while (value >= 0x80) {
+			out[size] = (byte)(value | 0x80);
+			size += 1;
+			value >>= 7;
+		}
+		out[size] = (byte)value;
+		used -= MaxSize - (size + 1);
+	}
+	void VariantWriter::WriteText(const String& value) {
+		int32 index = -1;
+		if (strings.TryGet(value, index)) {
+			WriteTag((byte)Tag::StringReference);
+			WriteVarUInt((uint64)index);
+			return;
+		}
+		if (value.GetCount() > 0) {
+			strings.Add(value, strings.GetCount());
+		}
+		WriteTag((byte)Tag::String);
+		WriteVarUInt((uint64)value.GetCount());
+		WriteRaw(value.GetRawArray(), value.GetCount(), 1);
+	}
+	void VariantWriter::WriteRaw(const void* values, int32 count, int32 size) {
+		const byte* bytes = (const byte*)values;
+		int64 length = (int64)count * size;
+		// Whole values at a time, so big endian platforms can swap them in the buffer.
+		int64 chunk = (int64)(bufferSize / size) * size;
+		for (int64 done = 0; done < length; done += chunk) {
+			int32 part = (int32)(length - done < chunk ? length - done : chunk);
+			if constexpr (Stream::LocalEndianness == Stream::Endianness::Little) {
+				if (part == chunk) {
+					Flush();
+					if (error == ResultCode::OK) {
+						error = stream->WriteBytes(bytes + done, part);
+					}
+					continue;
+				}
+			}
+			byte* out = Reserve(part);
+			std::memcpy(out, bytes + done, part);
+			if constexpr (Stream::LocalEndianness == Stream::Endianness::Big) {
+				if (size > 1) {
+					Stream::SwapBytes(out, part / size, size);
+				}
+			}
+		}
+	}
+#pragma endregion
+
+#pragma region VariantReader
+	VariantReader::VariantReader(const IntrusivePtr<Stream>& stream, int32 bufferSize) :stream(stream), bufferSize(bufferSize) {
+		ERR_ASSERT(bufferSize >= 16, u8"bufferSize must be at least 16.", this->bufferSize = DefaultBufferSize);
+		ERR_ASSERT(stream.GetRaw() != nullptr && stream->CanRead(), u8"The stream cannot read.", ended = true);
+		buffer.SetCount(this->bufferSize);
+	}
+
+	bool VariantReader::ReadVariant(Variant& value) {
+		if (IsEnd()) {
+			return false;
+		}
+		Variant result{};
+		if (!ReadValue(ReadTag(), result)) {
+			return false;
+		}
+		value = result;
+		return true;
+	}
+	ResultCode VariantReader::ReadProperties(const PropertyBatch& batch, Object* const* objects, int32 objectCount) {
+		// What the blob doesn't have stays as it is, and objects of other classes are refused before reading anything.
+		List<Variant> values{};
+		ResultCode result = batch.GetValues(objects, objectCount, values);
+		if (result != ResultCode::OK) {
+			return result;
+		}
+
+		if (IsEnd() || ReadTag() != (byte)Tag::Properties) {
+			failed = true;
+			return ResultCode::InvalidStream;
+		}
+		int32 propertyCount = ReadCount(1);
+		List<int32> targets(propertyCount);
+		for (int32 i = 0; i < propertyCount; i += 1) {
+			String text{};
+			if (!ReadText(ReadTag(), text)) {
+				return ResultCode::InvalidStream;
+			}
+			StringName name(text);
+			int32 target = -1;
+			for (int32 j = 0; j < batch.GetCount(); j += 1) {
+				if (batch.GetProperty(j)->GetName() == name) {
+					target = j;
+					break;
+				}
+			}
+			targets.Add(target);
+		}
+		// Every value takes a byte at least.
+		int32 storedCount = ReadCount(propertyCount > 0 ? propertyCount : 1);
+		if (failed) {
+			return ResultCode::InvalidStream;
+		}
+
+		int32 batchCount = batch.GetCount();
+		for (int32 i = 0; i < storedCount; i += 1) {
+			for (int32 j = 0; j < propertyCount; j += 1) {
+				Variant value{};
+				if (!ReadValue(ReadTag(), value)) {
+					return ResultCode::InvalidStream;
+				}
+				// Values of a blob for another count are read through, so the reader stays at the next value.
+				if (storedCount == objectCount && targets[j] >= 0) {
+					values[i * batchCount + targets[j]] = value;
+				}
+			}
+		}
+		ERR_ASSERT(storedCount == objectCount, u8"The blob is for another count of objects.", return ResultCode::InvalidArgument);
+		return batch.SetValues(objects, objectCount, values.GetRawElementPtr());
+	}
+	bool VariantReader::IsEnd() {
+		if (failed) {
+			return true;
+		}
+		Fill(1);
+		return start == end;
+	}
+	bool VariantReader::IsFailed() const {
+		return failed;
+	}
+	const IntrusivePtr<Stream>& VariantReader::GetStream() const {
+		return stream;
+	}
+
+	void VariantReader::Fill(int32 length) {
+		if (end - start >= length || ended) {
+			return;
+		}
+		// Keep the unread bytes at the front, followed by the next part of the stream.
+		int32 unread = end - start;
+		if (start > 0) {
+			std::memmove(buffer.GetRawElementPtr(), buffer.GetRawElementPtr() + start, unread);
+			start = 0;
+			end = unread;
+		}
+		if (length > buffer.GetCount()) {
+			buffer.SetCount(length);
+		}
+		while (end < length && !ended) {
+			int32 read = stream->ReadBytes(buffer.GetRawElementPtr() + end, buffer.GetCount() - end);
+			if (read <= 0) {
+				ended = true;
+			} else {
+				end += read;
+			}
+		}
+	}
+	bool VariantReader::Require(int32 length) {
+		if (failed) {
+			return false;
+		}
+		Fill(length);
+		if (end - start < length) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+	byte VariantReader::ReadTag() {
+		if (!Require(1)) {
+			// Never a valid tag, ReadValue() turns it down.
+			return 0xFF;
+		}
+		byte tag = buffer[start];
+		start += 1;
+		return tag;
+	}
+	uint64 VariantReader::ReadVarUInt() {
+		uint64 result = 0;
+		for (int32 shift = 0; shift < 64; shift += 7) {
+			if (!Require(1)) {
+				return 0;
+			}
+			byte part = buffer[start];
+			start += 1;
+			result |= (uint64)(part & 0x7F) << shift;
+			if ((part & 0x80) == 0) {
+				return result;
+			}
+		}
+		failed = true;
+		return 0;
+	}
+	int32 VariantReader::ReadCount(int32 size) {
+		uint64 count = ReadVarUInt();
+		if (failed) {
+			return 0;
+		}
+		// Malformed data must not make huge allocations, the stream has to hold the elements.
+		uint64 limit = (uint64)INT32_MAX / size;
+		if (stream->CanRandomAccess()) {
+			int64 available = stream->GetLength() - stream->GetPosition() + (end - start);
+			uint64 fits = (available <= 0 ? 0 : (uint64)available / size);
+			limit = (fits < limit ? fits : limit);
+		}
+		if (count > limit) {
+			failed = true;
+			return 0;
+		}
+		return (int32)count;
+	}
+	bool VariantReader::ReadText(byte tag, String& value) {
+		if (tag == (byte)Tag::StringReference) {
+			uint64 index = ReadVarUInt();
+			if (failed || index >= (uint64)strings.GetCount()) {
+				failed = true;
+				return false;
+			}
+			value = strings[(int32)index];
+			return true;
+		}
+		if (tag != (byte)Tag::String) {
+			failed = true;
+			return false;
+		}
+		int32 count = ReadCount(1);
+		if (!Require(count)) {
+			return false;
+		}
+		value = String((const u8char*)(buffer.GetRawElementPtr() + start), count);
+		start += count;
+		if (count > 0) {
+			strings.Add(value);
+		}
+		return true;
+	}
+	void VariantReader::ReadRaw(void* values, int32 count, int32 size) {
+		byte* out = (byte*)values;
+		int64 length = (int64)count * size;
+		if (length == 0) {
+			return;
+		}
+		if (length <= bufferSize) {
+			if (!Require((int32)length)) {
+				return;
+			}
+			std::memcpy(out, buffer.GetRawElementPtr() + start, (sizeint)length);
+			start += (int32)length;
+		} else {
+			// The buffered bytes first, the rest straight from the stream.
+			int32 buffered = end - start;
+			std::memcpy(out, buffer.GetRawElementPtr() + start, buffered);
+			start = end;
+			for (int64 done = buffered; done < length;) {
+				int32 read = (ended ? 0 : stream->ReadBytes(out + done, (int32)(length - done)));
+				if (read <= 0) {
+					ended = true;
+					failed = true;
+					return;
+				}
+				done += read;
+			}
+		}
+		if constexpr (Stream::LocalEndianness == Stream::Endianness::Big) {
+			if (size > 1) {
+				Stream::SwapBytes(out, count, size);
+			}
+		}
+	}
+	bool VariantReader::ReadValue(byte tag, Variant& value) {
+		if (failed) {
+			return false;
+		}
+		switch ((Tag)tag) {
+			case Tag::Null:
+				value = Variant();
+				break;
+			case Tag::False:
+				value = Variant(false);
+				break;
+			case Tag::True:
+				value = Variant(true);
+				break;
+			case Tag::Int64:
+			{
+				int64 v = UnZigZag(ReadVarUInt());
+				value = Variant(v);
+				break;
+			}
+			case Tag::Double:
+			{
+				double v = 0;
+				ReadRaw(&v, 1, sizeof(double));
+				value = Variant(v);
+				break;
+			}
+			case Tag::String:
+			case Tag::StringReference:
+			{
+				String text{};
+				if (!ReadText(tag, text)) {
+					return false;
+				}
+				value = Variant(text);
+				break;
+			}
+			case Tag::Vector2:
+			{
+				Vector2 v{};
+				ReadRaw(&v, 2, sizeof(float));
+				value = Variant(v);
+				break;
+			}
+			case Tag::PackedByteArray:
+			{
+				PackedByteArray array{};
+				array.Resize(ReadCount(sizeof(byte)));
+				ReadRaw(array.GetDataForWrite(), array.GetCount(), sizeof(byte));
+				value = Variant(array);
+				break;
+			}
+			case Tag::PackedInt64Array:
+			{
+				PackedInt64Array array{};
+				array.Resize(ReadCount(sizeof(int64)));
+				ReadRaw(array.GetDataForWrite(), array.GetCount(), sizeof(int64));
+				value = Variant(array);
+				break;
+			}
+			case Tag::PackedFloat32Array:
+			{
+				PackedFloat32Array array{};
+				array.Resize(ReadCount(sizeof(float)));
+				ReadRaw(array.GetDataForWrite(), array.GetCount(), sizeof(float));
+				value = Variant(array);
+				break;
+			}
+			case Tag::PackedVector2Array:
+			{
+				PackedVector2Array array{};
+				array.Resize(ReadCount(sizeof(Vector2)));
+				ReadRaw(array.GetDataForWrite(), array.GetCount() * 2, sizeof(float));
+				value = Variant(array);
+				break;
+			}
+			default:
+				failed = true;
+				break;
+		}
+		return !failed;
+	}
+#pragma endregion
+}
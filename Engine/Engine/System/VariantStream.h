@@ -0,0 +1,100 @@
+#pragma once
+#include "Engine/System/Stream.h"
+#include "Engine/System/Memory/IntrusivePtr.h"
+#include "Engine/System/Collection/Dictionary.h"
+
+namespace Engine {
+	class PropertyBatch;
+
+	/// @brief Writes Variants to a Stream in a compact binary form, read back by VariantReader.\n
+	/// Each value is a tag byte and its payload: integers as zigzag varints, lengths as varints,
+	/// doubles, Vector2 and the elements of packed arrays raw in little endian, whatever the endianness of the stream.
+	/// A String repeated is written once, later ones refer back to it, so the strings of a writer and its reader must be read in order.\n
+	/// Objects are runtime references and are written as Null.\n
+	/// The writer buffers up to a block ahead of the stream, Flush() or destroy it before using the stream again.
+	class VariantWriter final {
+	public:
+		static inline constexpr int32 DefaultBufferSize = 16384;
+
+		VariantWriter(const IntrusivePtr<Stream>& stream, int32 bufferSize = DefaultBufferSize);
+		~VariantWriter();
+		VariantWriter(const VariantWriter&) = delete;
+		VariantWriter& operator=(const VariantWriter&) = delete;
+
+		/// @return The first error of the stream, every write after it fails the same way.
+		ResultCode WriteVariant(const Variant& value);
+		/// @brief Write the properties of the batch for every object as a blob, the names first so it can be read by another batch.
+		/// @return InvalidObject at an object not of the class of the batch, nothing is written then.
+		ResultCode WriteProperties(const PropertyBatch& batch, const Object* const* objects, int32 objectCount);
+		/// @brief Write what is buffered to the stream.
+		ResultCode Flush();
+		const IntrusivePtr<Stream>& GetStream() const;
+
+	private:
+		void WriteTag(byte tag);
+		void WriteVarUInt(uint64 value);
+		void WriteText(const String& value);
+		/// @brief Append count values of the size, swapped to little endian. Large ones skip the buffer.
+		void WriteRaw(const void* values, int32 count, int32 size);
+		/// @brief Have room for length more bytes in the buffer, flushing it first if needed.
+		byte* Reserve(int32 length);
+
+		IntrusivePtr<Stream> stream{};
+		int32 bufferSize;
+		/// @brief The bytes not written to the stream yet are [0, used).
+		List<byte> buffer{};
+		int32 used = 0;
+		/// @brief Index of every String written so far.
+		Dictionary<String, int32> strings{};
+		ResultCode error = ResultCode::OK;
+	};
+
+	/// @brief Reads the Variants written by a VariantWriter, from the current position of the stream.\n
+	/// The reader is ahead of the stream by up to a block. Malformed or truncated data fails the reader for good.
+	class VariantReader final {
+	public:
+		static inline constexpr int32 DefaultBufferSize = 16384;
+
+		VariantReader(const IntrusivePtr<Stream>& stream, int32 bufferSize = DefaultBufferSize);
+		VariantReader(const VariantReader&) = delete;
+		VariantReader& operator=(const VariantReader&) = delete;
+
+		/// @return false at the end of the stream or if the data is malformed, see IsFailed(), value is left as it is then.
+		bool ReadVariant(Variant& value);
+		/// @brief Read a blob of WriteProperties() into the objects, matching the properties by name.\n
+		/// Properties of the blob the batch doesn't have are skipped, those the blob doesn't have are left as they are.
+		/// @return InvalidArgument if the blob is for another count of objects, InvalidStream if it's malformed.
+		ResultCode ReadProperties(const PropertyBatch& batch, Object* const* objects, int32 objectCount);
+		/// @brief Whether every value has been read.
+		bool IsEnd();
+		bool IsFailed() const;
+		const IntrusivePtr<Stream>& GetStream() const;
+
+	private:
+		/// @brief Buffer the next bytes of the stream until there are length of them, or the stream ends.
+		void Fill(int32 length);
+		/// @brief Have at least length bytes buffered, failing if the stream ends before.
+		bool Require(int32 length);
+		byte ReadTag();
+		uint64 ReadVarUInt();
+		/// @brief A count of elements of the size, failing if the stream can't hold them.
+		int32 ReadCount(int32 size);
+		/// @brief Read the String of a String or StringReference tag.
+		bool ReadText(byte tag, String& value);
+		/// @brief Read count values of the size, swapped from little endian. Large ones skip the buffer.
+		void ReadRaw(void* values, int32 count, int32 size);
+		/// @brief Read what follows the tag.
+		bool ReadValue(byte tag, Variant& value);
+
+		IntrusivePtr<Stream> stream{};
+		int32 bufferSize;
+		/// @brief The unread bytes are [start, end).
+		List<byte> buffer{};
+		int32 start = 0;
+		int32 end = 0;
+		bool ended = false;
+		bool failed = false;
+		/// @brief Every String read so far, by the index the writer gave it.
+		List<String> strings{};
+	};
+}
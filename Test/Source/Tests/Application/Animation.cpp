@@ -0,0 +1,242 @@
+#include "doctest.h"
+#include "Engine/Application/Animation/AnimationSystem.h"
+#include "Engine/Application/Node/Node2D.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Math/Random.h"
+#include <cmath>
+
+using namespace Engine;
+
+namespace AnimationTest {
+	/// @brief The value of a float track by walking all its keys, held before the first and after the last.
+	float Interpolate(const List<float>& times, const List<float>& values, float time) {
+		if (time <= times[0]) {
+			return values[0];
+		}
+		for (int32 i = 0; i + 1 < times.GetCount(); i += 1) {
+			if (time < times[i + 1]) {
+				float weight = (time - times[i]) / (times[i + 1] - times[i]);
+				return values[i] + (values[i + 1] - values[i]) * weight;
+			}
+		}
+		return values[values.GetCount() - 1];
+	}
+	float SampleFloat(const AnimationClip& clip, int32 track, float time, int32& cursor) {
+		float result = 0;
+		clip.Sample(track, time, cursor, &result);
+		return result;
+	}
+}
+using AnimationTest::Interpolate;
+using AnimationTest::SampleFloat;
+
+TEST_SUITE("Animation") {
+	TEST_CASE("Interpolation") {
+		AnimationClip clip;
+		int32 track = clip.AddTrack(StringName(STRL("Value")), AnimationTrackType::Float);
+		CHECK(clip.FindTrack(StringName(STRL("Value"))) == track);
+		CHECK(clip.FindTrack(StringName(STRL("Missing"))) == -1);
+
+		// No keys, the result is left alone.
+		int32 cursor = 0;
+		float result = 7;
+		clip.Sample(track, 1, cursor, &result);
+		CHECK(result == 7);
+
+		List<float> times{};
+		List<float> values{};
+		for (int32 i = 0; i < 50; i += 1) {
+			times.Add((float)i * 0.1f + (float)(i % 3) * 0.01f);
+			values.Add(std::sin((float)i * 0.7f));
+			CHECK(clip.AddKey(track, times[i], values[i]));
+		}
+		CHECK(!clip.AddKey(track, 0, 1.0f));
+		CHECK(clip.GetKeyCount(track) == 50);
+		CHECK(clip.GetLength() == doctest::Approx(times[49]));
+
+		bool same = true;
+		for (float time = -1; time < 6; time += 0.013f) {
+			same = same && std::fabs(SampleFloat(clip, track, time, cursor) - Interpolate(times, values, time)) < 1e-5f;
+		}
+		CHECK(same);
+		CHECK(SampleFloat(clip, track, times[10], cursor) == doctest::Approx(values[10]));
+		CHECK(SampleFloat(clip, track, -5, cursor) == doctest::Approx(values[0]));
+		CHECK(SampleFloat(clip, track, 100, cursor) == doctest::Approx(values[49]));
+
+		// Every component of a vector goes its own way.
+		int32 vector = clip.AddTrack(StringName(STRL("Vector")), AnimationTrackType::Vector3);
+		CHECK(AnimationClip::GetComponentCount(AnimationTrackType::Vector3) == 3);
+		clip.AddKey(vector, 1, Vector3(0, 10, -2));
+		clip.AddKey(vector, 3, Vector3(4, 0, -2));
+		float components[3] = {};
+		cursor = 0;
+		clip.Sample(vector, 1.5f, cursor, components);
+		CHECK(components[0] == doctest::Approx(1));
+		CHECK(components[1] == doctest::Approx(7.5f));
+		CHECK(components[2] == doctest::Approx(-2));
+
+		// The negated end is the same rotation, the shortest way to it is a quarter turn about z, not three.
+		int32 rotation = clip.AddTrack(StringName(STRL("Rotation")), AnimationTrackType::Quaternion);
+		float half = std::sqrt(0.5f);
+		clip.AddKey(rotation, 0, Quaternion(0, 0, 0, 1));
+		clip.AddKey(rotation, 1, Quaternion(0, 0, -half, -half));
+		float quaternion[4] = {};
+		cursor = 0;
+		clip.Sample(rotation, 0.5f, cursor, quaternion);
+		float sign = quaternion[3] < 0 ? -1.0f : 1.0f;
+		CHECK(quaternion[0] == doctest::Approx(0));
+		CHECK(quaternion[1] == doctest::Approx(0));
+		CHECK(quaternion[2] * sign == doctest::Approx(std::sin(Math::PI / 8)).epsilon(0.001));
+		CHECK(quaternion[3] * sign == doctest::Approx(std::cos(Math::PI / 8)).epsilon(0.001));
+	}
+
+	TEST_CASE("Cursor moving backwards") {
+		AnimationClip clip;
+		int32 track = clip.AddTrack(StringName(STRL("Value")), AnimationTrackType::Float);
+		List<float> times{};
+		List<float> values{};
+		for (int32 i = 0; i < 200; i += 1) {
+			times.Add((float)i * 0.25f);
+			values.Add((float)((i * 37) % 11));
+			clip.AddKey(track, times[i], values[i]);
+		}
+
+		// Played forward first, then rewound and jumping around, the cursor a caller keeps is only a hint.
+		int32 cursor = 0;
+		bool same = true;
+		for (float time = 0; time < 50; time += 0.1f) {
+			same = same && std::fabs(SampleFloat(clip, track, time, cursor) - Interpolate(times, values, time)) < 1e-4f;
+		}
+		for (float time = 52; time > -1; time -= 0.37f) {
+			same = same && std::fabs(SampleFloat(clip, track, time, cursor) - Interpolate(times, values, time)) < 1e-4f;
+		}
+		Random random(3);
+		for (int32 i = 0; i < 500; i += 1) {
+			float time = random.NextFloat(-1, 51);
+			same = same && std::fabs(SampleFloat(clip, track, time, cursor) - Interpolate(times, values, time)) < 1e-4f;
+			same = same && (times[cursor] <= time || (time < times[0] && cursor == 0));
+		}
+		CHECK(same);
+
+		// Cursors out of the keys are searched again.
+		cursor = -5;
+		CHECK(SampleFloat(clip, track, 10.1f, cursor) == doctest::Approx(Interpolate(times, values, 10.1f)));
+		CHECK(cursor == 40);
+		cursor = 1000;
+		CHECK(SampleFloat(clip, track, 3.3f, cursor) == doctest::Approx(Interpolate(times, values, 3.3f)));
+		CHECK(cursor == 13);
+	}
+
+	TEST_CASE("Looping") {
+		SharedPtr<AnimationClip> clip = SharedPtr<AnimationClip>::Create();
+		int32 track = clip->AddTrack(StringName(STRL("Value")), AnimationTrackType::Float);
+		clip->AddKey(track, 0, 0.0f);
+		clip->AddKey(track, 1, 4.0f);
+		// Holding the last key for a second before wrapping.
+		clip->SetLength(2);
+		CHECK(clip->GetLength() == 2);
+
+		AnimationSystem system;
+		float looped = -1;
+		float once = -1;
+		int32 looping = system.AddPlayer(clip, true);
+		int32 single = system.AddPlayer(clip, false);
+		CHECK(system.BindValue(looping, track, &looped));
+		CHECK(system.BindValue(single, track, &once));
+
+		system.Update(0.5f);
+		CHECK(looped == doctest::Approx(2));
+		system.Update(1);
+		CHECK(system.GetTime(looping) == doctest::Approx(1.5f));
+		CHECK(looped == doctest::Approx(4));
+		system.Update(0.75f);
+		CHECK(system.GetTime(looping) == doctest::Approx(0.25f));
+		CHECK(looped == doctest::Approx(1));
+		CHECK(system.GetTime(single) == doctest::Approx(2));
+		CHECK(!system.IsPlaying(single));
+		CHECK(once == doctest::Approx(4));
+
+		// Backwards the time wraps to the end of the clip.
+		system.SetSpeed(looping, -1);
+		system.Update(0.5f);
+		CHECK(system.GetTime(looping) == doctest::Approx(1.75f));
+		CHECK(looped == doctest::Approx(4));
+		system.Update(1.25f);
+		CHECK(system.GetTime(looping) == doctest::Approx(0.5f));
+		CHECK(looped == doctest::Approx(2));
+
+		// Several lengths in one update still land where a single wrap would.
+		system.SetSpeed(looping, 1);
+		system.Update(6.25f);
+		CHECK(system.GetTime(looping) == doctest::Approx(0.75f));
+		CHECK(looped == doctest::Approx(3));
+	}
+
+	TEST_CASE("Batch matches per-track sampling") {
+		SharedPtr<AnimationClip> clip = SharedPtr<AnimationClip>::Create();
+		int32 value = clip->AddTrack(StringName(STRL("Value")), AnimationTrackType::Float);
+		int32 position = clip->AddTrack(StringName(STRL("Position")), AnimationTrackType::Vector2);
+		int32 rotation = clip->AddTrack(StringName(STRL("Rotation")), AnimationTrackType::Float);
+		Random random(17);
+		for (int32 i = 0; i < 40; i += 1) {
+			float time = (float)i * 0.2f;
+			clip->AddKey(value, time, random.NextFloat(-1, 1));
+			clip->AddKey(position, time, Vector2(random.NextFloat(-5, 5), random.NextFloat(-5, 5)));
+			clip->AddKey(rotation, time, random.NextFloat(-3, 3));
+		}
+
+		// More players than the threshold, so the update is split over the workers.
+		constexpr int32 count = AnimationSystem::ParallelUpdateThreshold * 4;
+		JobSystemConfig config{};
+		config.workerCount = 2;
+		JobSystem jobSystem(config);
+		jobSystem.Start();
+		AnimationSystem system;
+		List<int32> players{};
+		List<float> values(count);
+		values.SetCount(count);
+		List<Node2D*> nodes{};
+		for (int32 i = 0; i < count; i += 1) {
+			int32 player = system.AddPlayer(clip, i % 3 != 0);
+			system.SetSpeed(player, random.NextFloat(-2, 2));
+			system.SetTime(player, random.NextFloat(0, clip->GetLength()));
+			Node2D* node = MEMNEW(Node2D);
+			CHECK(system.BindValue(player, value, &values[i]));
+			CHECK(system.BindNode2D(player, position, node, AnimationChannel::Position));
+			CHECK(system.BindNode2D(player, rotation, node, AnimationChannel::Rotation));
+			players.Add(player);
+			nodes.Add(node);
+		}
+
+		bool same = true;
+		for (int32 frame = 0; frame < 20; frame += 1) {
+			system.Update(random.NextFloat(0, 0.3f), &jobSystem);
+			for (int32 i = 0; i < count; i += 1) {
+				float time = system.GetTime(players[i]);
+				int32 cursor = 0;
+				float expected[2] = {};
+				clip->Sample(value, time, cursor, expected);
+				same = same && values[i] == expected[0];
+				clip->Sample(position, time, cursor, expected);
+				same = same && nodes[i]->GetPosition() == Vector2(expected[0], expected[1]);
+				clip->Sample(rotation, time, cursor, expected);
+				same = same && nodes[i]->GetRotation() == expected[0];
+			}
+		}
+		CHECK(same);
+		jobSystem.Stop();
+
+		for (Node2D* node : nodes) {
+			system.UnbindTarget(node);
+			MEMDEL(node);
+		}
+		// The first player stops at the end of the clip, the second one keeps looping.
+		values[1] = -10;
+		system.Update(0.1f);
+		CHECK(values[1] != -10);
+		system.UnbindTarget(&values[1]);
+		values[1] = -10;
+		system.Update(0.1f);
+		CHECK(values[1] == -10);
+	}
+}
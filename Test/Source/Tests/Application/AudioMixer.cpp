@@ -0,0 +1,237 @@
+#include "doctest.h"
+#include "Engine/Application/Audio/AudioMixer.h"
+#include "Engine/System/Math/Math.h"
+#include <cmath>
+
+using namespace Engine;
+
+namespace AudioMixerTest {
+	/// @brief Mixed by the test itself, one block at a time, like a device pulling samples from its callback.
+	class PulledMixer :public AudioMixer {
+	public:
+		PulledMixer(int32 blockFrameCount, int32 voiceCount = 8) :AudioMixer(48000, blockFrameCount, voiceCount) {
+			StartPulled();
+		}
+		~PulledMixer() {
+			Stop();
+		}
+		List<float> MixFrames(int32 frameCount) {
+			List<float> samples(frameCount * 2);
+			samples.SetCount(frameCount * 2);
+			Mix(samples.GetRawElementPtr(), frameCount);
+			return samples;
+		}
+		using AudioMixer::Mix;
+	};
+
+	SharedPtr<AudioClip> MakeClip(const List<float>& samples, int32 channelCount, int32 sampleRate = 48000) {
+		SharedPtr<AudioClip> clip = SharedPtr<AudioClip>::Create();
+		REQUIRE(clip->SetSamples(samples.GetRawElementPtr(), samples.GetCount() / channelCount, channelCount, sampleRate) == ResultCode::OK);
+		return clip;
+	}
+	SharedPtr<AudioClip> MakeConstantClip(float value, int32 frameCount) {
+		List<float> samples{};
+		for (int32 i = 0; i < frameCount; i += 1) {
+			samples.Add(value);
+		}
+		return MakeClip(samples, 1);
+	}
+	/// @brief The gains of GetPanGains(), at constant power.
+	float GetLeftGain(float gain, float pan) {
+		return gain * std::cos((pan + 1) * (Math::PI / 4));
+	}
+	float GetRightGain(float gain, float pan) {
+		return gain * std::sin((pan + 1) * (Math::PI / 4));
+	}
+}
+using AudioMixerTest::PulledMixer;
+using AudioMixerTest::MakeClip;
+using AudioMixerTest::MakeConstantClip;
+using AudioMixerTest::GetLeftGain;
+using AudioMixerTest::GetRightGain;
+
+TEST_SUITE("AudioMixer") {
+	TEST_CASE("Gain ramps") {
+		constexpr int32 frames = 64;
+		PulledMixer mixer(frames);
+		SharedPtr<AudioClip> clip = MakeConstantClip(0.5f, 10000);
+		int32 voice = mixer.Play(clip);
+
+		// Starts at its gain right away.
+		List<float> block = mixer.MixFrames(frames);
+		float from = GetLeftGain(1, 0);
+		CHECK(block[0] == doctest::Approx(0.5f * from));
+		CHECK(block[1] == doctest::Approx(0.5f * from));
+		CHECK(block[2 * frames - 1] == doctest::Approx(0.5f * from));
+
+		// The new gain is reached over the next block, starting from the old one and one step short of the new one at its end.
+		mixer.SetVoiceGain(voice, 0.25f, 0);
+		float to = GetLeftGain(0.25f, 0);
+		block = mixer.MixFrames(frames);
+		bool ramped = true;
+		for (int32 i = 0; i < frames; i += 1) {
+			float gain = from + (to - from) * i / frames;
+			ramped = ramped && std::fabs(block[2 * i] - 0.5f * gain) < 1e-5f && std::fabs(block[2 * i + 1] - 0.5f * gain) < 1e-5f;
+		}
+		CHECK(ramped);
+		CHECK(block[0] == doctest::Approx(0.5f * from));
+		CHECK(block[2 * (frames - 1)] == doctest::Approx(0.5f * (from + (to - from) * (frames - 1) / frames)));
+		block = mixer.MixFrames(frames);
+		CHECK(block[0] == doctest::Approx(0.5f * to));
+		CHECK(block[2 * frames - 1] == doctest::Approx(0.5f * to));
+
+		// Panned fully right, the left side fades to nothing.
+		mixer.SetVoiceGain(voice, 1, 1);
+		mixer.MixFrames(frames);
+		block = mixer.MixFrames(frames);
+		CHECK(block[0] == doctest::Approx(0).epsilon(1e-6));
+		CHECK(block[1] == doctest::Approx(0.5f));
+
+		// The master gain ramps the same way, over the whole mix.
+		mixer.SetMasterGain(0.5f);
+		CHECK(mixer.GetMasterGain() == 0.5f);
+		block = mixer.MixFrames(frames);
+		CHECK(block[1] == doctest::Approx(0.5f));
+		CHECK(block[2 * (frames - 1) + 1] == doctest::Approx(0.5f * (1 - 0.5f * (frames - 1) / frames)));
+		block = mixer.MixFrames(frames);
+		CHECK(block[1] == doctest::Approx(0.25f));
+		CHECK(mixer.GetMixedFrameCount() == 7 * frames);
+	}
+
+	TEST_CASE("Pitch steps through the source") {
+		constexpr int32 frames = 32;
+		PulledMixer mixer(frames);
+		List<float> ramp{};
+		for (int32 i = 0; i < 1000; i += 1) {
+			ramp.Add((float)i / 1000);
+		}
+		SharedPtr<AudioClip> clip = MakeClip(ramp, 1);
+
+		// Panned fully left, the left side gets the source at a gain of 1.
+		int32 voice = mixer.Play(clip, 1, -1, 0.5f);
+		List<float> block = mixer.MixFrames(frames);
+		bool stepped = true;
+		for (int32 i = 0; i < frames; i += 1) {
+			// Half way between two source frames on every odd frame.
+			stepped = stepped && std::fabs(block[2 * i] - 0.5f * i / 1000) < 1e-6f && std::fabs(block[2 * i + 1]) < 1e-6f;
+		}
+		CHECK(stepped);
+
+		// Picked up from where the last block ended, at the new step.
+		mixer.SetVoicePitch(voice, 2);
+		block = mixer.MixFrames(frames);
+		stepped = true;
+		for (int32 i = 0; i < frames; i += 1) {
+			stepped = stepped && std::fabs(block[2 * i] - (0.5f * frames + 2.0f * i) / 1000) < 1e-6f;
+		}
+		CHECK(stepped);
+
+		// Clamped to MaxPitch.
+		mixer.SetVoicePitch(voice, 100);
+		block = mixer.MixFrames(frames);
+		CHECK(block[2] - block[0] == doctest::Approx(AudioMixer::MaxPitch / 1000));
+
+		// A source at half the output rate steps by half a frame at a pitch of 1.
+		SharedPtr<AudioClip> slow = MakeClip(ramp, 1, 24000);
+		mixer.StopVoice(voice);
+		mixer.Play(slow, 1, -1);
+		block = mixer.MixFrames(frames);
+		block = mixer.MixFrames(frames);
+		CHECK(block[2 * 3] == doctest::Approx((0.5f * (frames + 3)) / 1000));
+	}
+
+	TEST_CASE("Ended voices are reported") {
+		constexpr int32 frames = 64;
+		PulledMixer mixer(frames, 2);
+		SharedPtr<AudioClip> clip = MakeConstantClip(0.5f, 100);
+		int32 voice = mixer.Play(clip, 1, -1);
+		CHECK(mixer.IsVoicePlaying(voice));
+		CHECK(mixer.GetPlayingVoiceCount() == 1);
+
+		mixer.MixFrames(frames);
+		mixer.Update();
+		CHECK(mixer.IsVoicePlaying(voice));
+		// The clip runs out 36 frames into the block, the rest is silent.
+		List<float> block = mixer.MixFrames(frames);
+		CHECK(block[2 * 35] == doctest::Approx(0.5f));
+		CHECK(block[2 * 36] == 0);
+		CHECK(block[2 * (frames - 1)] == 0);
+		// Known as playing until the next update.
+		CHECK(mixer.IsVoicePlaying(voice));
+		mixer.Update();
+		CHECK(!mixer.IsVoicePlaying(voice));
+		CHECK(mixer.GetPlayingVoiceCount() == 0);
+
+		// The slot is reused with another id, the ended one stays ended.
+		int32 looping = mixer.Play(clip, 1, -1, 1, true);
+		CHECK(looping != voice);
+		CHECK(!mixer.IsVoicePlaying(voice));
+		int32 other = mixer.Play(clip, 1, -1);
+		CHECK(mixer.Play(clip) == AudioMixer::InvalidVoice);
+		for (int32 i = 0; i < 5; i += 1) {
+			mixer.MixFrames(frames);
+			mixer.Update();
+		}
+		CHECK(mixer.IsVoicePlaying(looping));
+		CHECK(!mixer.IsVoicePlaying(other));
+
+		// Stopping fades out over a block, then the voice ends.
+		mixer.StopVoice(looping);
+		block = mixer.MixFrames(frames);
+		CHECK(block[0] == doctest::Approx(0.5f));
+		CHECK(block[2 * (frames - 1)] == doctest::Approx(0.5f / frames));
+		mixer.Update();
+		CHECK(!mixer.IsVoicePlaying(looping));
+		block = mixer.MixFrames(frames);
+		CHECK(block[0] == 0);
+
+		// Without mixing, the voices end on the next update unheard.
+		int32 unheard = mixer.Play(clip);
+		mixer.Stop();
+		mixer.Update();
+		CHECK(!mixer.IsVoicePlaying(unheard));
+		CHECK(mixer.GetPlayingVoiceCount() == 0);
+	}
+
+	TEST_CASE("Scalar and SIMD paths agree") {
+		// Mixed one frame at a time only the scalar tails run, whole blocks go 4 samples at once with a frame left for the tail.
+		constexpr int32 frames = 63;
+		PulledMixer scalar(1, 16);
+		PulledMixer wide(frames, 16);
+		List<float> stereo{};
+		List<float> mono{};
+		for (int32 i = 0; i < 3000; i += 1) {
+			stereo.Add(std::sin((float)i * 0.05f));
+			stereo.Add(std::cos((float)i * 0.031f));
+			mono.Add(std::sin((float)i * 0.013f) * 0.8f);
+		}
+		SharedPtr<AudioClip> stereoClip = MakeClip(stereo, 2);
+		SharedPtr<AudioClip> monoClip = MakeClip(mono, 1, 22050);
+		for (PulledMixer* mixer : { &scalar, &wide }) {
+			// Loud enough to clip, reached before anything plays so neither ramps while mixing the voices.
+			mixer->SetMasterGain(1.5f);
+			mixer->MixFrames(1);
+			mixer->Play(stereoClip, 0.9f, -0.3f, 1.25f, true);
+			mixer->Play(monoClip, 0.7f, 0.6f, 0.8f, true);
+			mixer->Play(stereoClip, 0.4f, 1, 0.5f);
+		}
+
+		List<float> expected{};
+		for (int32 i = 0; i < frames * 20; i += 1) {
+			List<float> frame = scalar.MixFrames(1);
+			expected.Add(frame[0]);
+			expected.Add(frame[1]);
+		}
+		bool same = true;
+		bool clipped = false;
+		for (int32 block = 0; block < 20; block += 1) {
+			List<float> samples = wide.MixFrames(frames);
+			for (int32 i = 0; i < frames * 2; i += 1) {
+				same = same && std::fabs(samples[i] - expected[block * frames * 2 + i]) < 1e-5f;
+				clipped = clipped || samples[i] == 1 || samples[i] == -1;
+			}
+		}
+		CHECK(same);
+		CHECK(clipped);
+	}
+}
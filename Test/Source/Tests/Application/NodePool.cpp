@@ -0,0 +1,170 @@
+#include "doctest.h"
+#include "Engine/Application/Node/NodePool.h"
+#include "Engine/Application/Node/NodeTree.h"
+#include "Engine/Application/Node/Node2D.h"
+#include "Engine/Application/Time.h"
+#include "Engine/System/Object/ObjectRegistry.h"
+
+using namespace Engine;
+
+namespace NodePoolTest {
+	/// @brief A projectile with a trail node under it, counting its hits.
+	class Bullet :public Node2D {
+		REFLECTION_CLASS(::NodePoolTest::Bullet, ::Engine::Node2D) {
+			REFLECTION_CLASS_CONSTRUCTIBLE(Bullet);
+		}
+
+	public:
+		int32 hits = 0;
+	};
+
+	int32 builds = 0;
+	int32 resets = 0;
+	Node* BuildBullet() {
+		builds += 1;
+		Bullet* bullet = MEMNEW(Bullet);
+		Node* trail = MEMNEW(Node);
+		trail->SetName(STRL("Trail"));
+		bullet->AddChild(trail);
+		return bullet;
+	}
+	void ResetBullet(Node* node) {
+		resets += 1;
+		Bullet* bullet = static_cast<Bullet*>(node);
+		bullet->hits = 0;
+		bullet->SetPosition(Vector2(0, 0));
+	}
+	/// @brief Every node of the subtree has an id pointing back at it, or none of them has one.
+	bool IsRegistered(Node* node, bool registered) {
+		if (ObjectRegistry::IsValid(node->GetInstanceId()) != registered) {
+			return false;
+		}
+		if (registered && ObjectRegistry::Get(node->GetInstanceId()) != node) {
+			return false;
+		}
+		for (int32 i = 0; i < node->GetChildrenCount(); i += 1) {
+			if (!IsRegistered(node->GetChildByIndex(i), registered)) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+using NodePoolTest::Bullet;
+using NodePoolTest::BuildBullet;
+using NodePoolTest::ResetBullet;
+using NodePoolTest::IsRegistered;
+
+TEST_SUITE("NodePool") {
+	TEST_CASE("Acquire reuses released instances") {
+		NodePoolTest::builds = 0;
+		NodePool pool(BuildBullet, ResetBullet);
+		pool.Reserve(4);
+		CHECK(NodePoolTest::builds == 4);
+		CHECK(pool.GetReleasedCount() == 4);
+		CHECK(pool.GetInstanceCount() == 4);
+		// Reserving less than what's released builds nothing.
+		pool.Reserve(2);
+		CHECK(NodePoolTest::builds == 4);
+
+		Bullet* bullet = pool.Acquire<Bullet>();
+		CHECK(pool.GetReleasedCount() == 3);
+		CHECK(IsRegistered(bullet, true));
+		CHECK(bullet->GetChildrenCount() == 1);
+		InstanceId id = bullet->GetInstanceId();
+		InstanceId trailId = bullet->GetChildByIndex(0)->GetInstanceId();
+
+		pool.Release(bullet);
+		CHECK(pool.GetReleasedCount() == 4);
+		CHECK(IsRegistered(bullet, false));
+		CHECK(!ObjectRegistry::IsValid(id));
+		CHECK(!ObjectRegistry::IsValid(trailId));
+
+		// The instance released last comes back first, with new ids.
+		Bullet* again = pool.Acquire<Bullet>();
+		CHECK(again == bullet);
+		CHECK(IsRegistered(again, true));
+		CHECK(again->GetInstanceId() != id);
+		CHECK(NodePoolTest::builds == 4);
+
+		// Out of released instances, new ones are built.
+		List<Node*> many{};
+		many.Add(again);
+		pool.AcquireMany(6, many);
+		REQUIRE(many.GetCount() == 7);
+		CHECK(NodePoolTest::builds == 7);
+		CHECK(pool.GetReleasedCount() == 0);
+		CHECK(pool.GetInstanceCount() == 7);
+		bool registered = true;
+		for (Node* node : many) {
+			registered = registered && IsRegistered(node, true);
+		}
+		CHECK(registered);
+
+		// Destroyed instances leave the pool.
+		MEMDEL(many[6]);
+		many.RemoveAt(6);
+		CHECK(pool.GetInstanceCount() == 6);
+		for (Node* node : many) {
+			pool.Release(node);
+		}
+		CHECK(pool.GetReleasedCount() == 6);
+	}
+
+	TEST_CASE("Released instances are reset") {
+		NodePoolTest::resets = 0;
+		NodePool pool(BuildBullet, ResetBullet);
+		NodeTree tree;
+		tree.OnStart();
+
+		Bullet* bullet = pool.Acquire<Bullet>();
+		bullet->hits = 3;
+		bullet->SetPosition(Vector2(5, -2));
+		tree.GetRoot()->AddChild(bullet);
+		CHECK(bullet->GetTree() == &tree);
+		pool.Release(bullet);
+		CHECK(NodePoolTest::resets == 1);
+		CHECK(!bullet->HasParent());
+		CHECK(bullet->GetTree() == nullptr);
+		CHECK(bullet->hits == 0);
+		CHECK(bullet->GetPosition() == Vector2(0, 0));
+		// The subtree built is kept as it is.
+		REQUIRE(bullet->GetChildrenCount() == 1);
+		CHECK(bullet->GetChildByIndex(0)->GetName() == StringName(STRL("Trail")));
+
+		// Freed in the tree, it goes back to the pool after the frame instead of being destroyed.
+		bullet = pool.Acquire<Bullet>();
+		bullet->hits = 1;
+		tree.GetRoot()->AddChild(bullet);
+		bullet->QueueFree();
+		CHECK(bullet->IsQueuedForFree());
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(NodePoolTest::resets == 2);
+		CHECK(pool.GetReleasedCount() == 1);
+		CHECK(pool.GetInstanceCount() == 1);
+		CHECK(!bullet->HasParent());
+		CHECK(!bullet->IsQueuedForFree());
+		CHECK(bullet->hits == 0);
+		Node* reused = pool.Acquire();
+		CHECK(reused == bullet);
+
+		// Acquired instances outlive the pool.
+		{
+			NodePool other(BuildBullet);
+			bullet = other.Acquire<Bullet>();
+			bullet->hits = 2;
+			other.Release(bullet);
+			CHECK(bullet->hits == 2);
+			bullet = other.Acquire<Bullet>();
+		}
+		tree.GetRoot()->AddChild(bullet);
+		CHECK(IsRegistered(bullet, true));
+		bullet->QueueFree();
+		tree.OnUpdate(time);
+		CHECK(tree.GetRoot()->GetChildrenCount() == 0);
+		tree.OnStop();
+		pool.Release(reused);
+	}
+}
@@ -0,0 +1,463 @@
+#include "doctest.h"
+#include "Engine/Application/Node/NodeTree.h"
+#include "Engine/Application/Time.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include <functional>
+#include <thread>
+#include <chrono>
+
+using namespace Engine;
+
+namespace NodeTreeTest {
+	/// @brief Logs its id on every update and runs the action given to it.
+	class Recorder :public Node {
+		REFLECTION_CLASS(::NodeTreeTest::Recorder, ::Engine::Node) {
+			REFLECTION_CLASS_CONSTRUCTIBLE(Recorder);
+		}
+
+	public:
+		Recorder() {
+			SetUpdateEnabled(true);
+		}
+		Recorder(List<int32>* log, int32 id) :log(log), id(id) {
+			SetUpdateEnabled(true);
+		}
+		~Recorder() {
+			if (destroyed != nullptr) {
+				*destroyed += 1;
+			}
+		}
+		void OnReady() override {
+			if (ready) {
+				ready(this);
+			}
+		}
+		void OnUpdate(float delta) override {
+			if (log != nullptr) {
+				log->Add(id);
+			}
+			lastDelta = delta;
+			updates += 1;
+			if (action) {
+				action(this);
+			}
+		}
+
+		List<int32>* log = nullptr;
+		int32 id = 0;
+		int32* destroyed = nullptr;
+		float lastDelta = 0;
+		int32 updates = 0;
+		std::function<void(Recorder*)> action{};
+		std::function<void(Recorder*)> ready{};
+	};
+
+	/// @brief Takes at least 2 ms to update and owns 1000 bytes on top of the node.
+	class Heavy :public Recorder {
+		REFLECTION_CLASS(::NodeTreeTest::Heavy, ::NodeTreeTest::Recorder) {
+			REFLECTION_CLASS_CONSTRUCTIBLE(Heavy);
+		}
+
+	public:
+		Heavy() {
+			action = [](Recorder*) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			};
+		}
+
+	protected:
+		sizeint GetExtraMemoryUsage() const override {
+			return 1000;
+		}
+	};
+
+	bool Equals(const List<int32>& log, std::initializer_list<int32> expected) {
+		if (log.GetCount() != (int32)expected.size()) {
+			return false;
+		}
+		int32 i = 0;
+		for (int32 value : expected) {
+			if (log[i] != value) {
+				return false;
+			}
+			i += 1;
+		}
+		return true;
+	}
+}
+using NodeTreeTest::Recorder;
+using NodeTreeTest::Heavy;
+using NodeTreeTest::Equals;
+
+TEST_SUITE("NodeTree") {
+	TEST_CASE("Update order") {
+		List<int32> log{};
+		NodeTree tree;
+		Recorder* a = MEMNEW(Recorder(&log, 1));
+		Recorder* a1 = MEMNEW(Recorder(&log, 2));
+		Recorder* a2 = MEMNEW(Recorder(&log, 3));
+		Recorder* b = MEMNEW(Recorder(&log, 4));
+		Node* silent = MEMNEW(Node);
+		a->AddChild(a1);
+		a->AddChild(a2);
+		tree.GetRoot()->AddChild(a);
+		tree.GetRoot()->AddChild(silent);
+		tree.GetRoot()->AddChild(b);
+		tree.OnStart();
+		CHECK(tree.GetUpdateNodeCount() == 4);
+
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 1, 2, 3, 4 }));
+
+		// Switching the update moves the node out of the order and back in its place.
+		log.Clear();
+		a1->SetUpdateEnabled(false);
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 1, 3, 4 }));
+		log.Clear();
+		a1->SetUpdateEnabled(true);
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 1, 2, 3, 4 }));
+		tree.OnStop();
+	}
+
+	TEST_CASE("Changes while updating") {
+		List<int32> log{};
+		NodeTree tree;
+		Recorder* a = MEMNEW(Recorder(&log, 1));
+		Recorder* b = MEMNEW(Recorder(&log, 2));
+		Recorder* c = MEMNEW(Recorder(&log, 3));
+		tree.GetRoot()->AddChild(a);
+		tree.GetRoot()->AddChild(b);
+		tree.GetRoot()->AddChild(c);
+		tree.OnStart();
+		Time time;
+		time.Advance(0.1f);
+
+		// Added after the cursor, updated in the same frame.
+		Recorder* late = MEMNEW(Recorder(&log, 4));
+		a->action = [late](Recorder* self) {
+			self->GetParent()->AddChild(late);
+			self->action = nullptr;
+		};
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 1, 2, 3, 4 }));
+
+		// Added before the cursor, waits for the next frame without the others updating twice.
+		log.Clear();
+		Recorder* early = MEMNEW(Recorder(&log, 5));
+		c->action = [early](Recorder* self) {
+			self->GetParent()->AddChild(early, 0);
+			self->action = nullptr;
+		};
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 1, 2, 3, 4 }));
+		log.Clear();
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 5, 1, 2, 3, 4 }));
+
+		// Removing the node itself and the next one skips nothing else.
+		log.Clear();
+		b->action = [c](Recorder* self) {
+			Node* parent = self->GetParent();
+			parent->RemoveChild(self);
+			parent->RemoveChild(c);
+		};
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 5, 1, 2, 4 }));
+		log.Clear();
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 5, 1, 4 }));
+		CHECK(tree.GetUpdateNodeCount() == 3);
+		tree.OnStop();
+		MEMDEL(b);
+		MEMDEL(c);
+	}
+
+	TEST_CASE("Group intervals and slices") {
+		NodeTree tree;
+		StringName slow{ STRL("Slow") };
+		StringName sliced{ STRL("Sliced") };
+		tree.SetUpdateGroupInterval(slow, 3);
+		tree.SetUpdateGroupInterval(sliced, 2, true);
+		Recorder* everyFrame = MEMNEW(Recorder);
+		Recorder* slowNode = MEMNEW(Recorder);
+		slowNode->SetUpdateGroup(slow);
+		Recorder* slices[4];
+		tree.GetRoot()->AddChild(everyFrame);
+		tree.GetRoot()->AddChild(slowNode);
+		for (int32 i = 0; i < 4; i += 1) {
+			slices[i] = MEMNEW(Recorder);
+			slices[i]->SetUpdateGroup(sliced);
+			tree.GetRoot()->AddChild(slices[i]);
+		}
+		tree.OnStart();
+		CHECK(tree.GetUpdateGroupNodeCount(slow) == 1);
+		CHECK(tree.GetUpdateGroupNodeCount(sliced) == 4);
+		CHECK(tree.GetUpdateGroupNodeCount(StringName()) == 1);
+
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(everyFrame->updates == 1);
+		CHECK(slowNode->updates == 1);
+		CHECK(slowNode->lastDelta == doctest::Approx(0.1f));
+		// The first slice goes first, every other node of the group.
+		CHECK(slices[0]->updates == 1);
+		CHECK(slices[1]->updates == 0);
+		CHECK(slices[2]->updates == 1);
+		CHECK(slices[3]->updates == 0);
+
+		tree.OnUpdate(time);
+		CHECK(slowNode->updates == 1);
+		CHECK(slices[1]->updates == 1);
+		CHECK(slices[3]->updates == 1);
+		// The second slice waited two frames.
+		CHECK(slices[1]->lastDelta == doctest::Approx(0.2f));
+
+		tree.OnUpdate(time);
+		CHECK(slices[0]->updates == 2);
+		CHECK(slices[0]->lastDelta == doctest::Approx(0.2f));
+		tree.OnUpdate(time);
+		// The slow group sums up the three frames since its last update.
+		CHECK(slowNode->updates == 2);
+		CHECK(slowNode->lastDelta == doctest::Approx(0.3f));
+		CHECK(everyFrame->updates == 4);
+		CHECK(everyFrame->lastDelta == doctest::Approx(0.1f));
+		tree.OnStop();
+	}
+
+	TEST_CASE("Group priorities") {
+		List<int32> log{};
+		NodeTree tree;
+		StringName late{ STRL("Late") };
+		StringName early{ STRL("Early") };
+		tree.SetUpdateGroupPriority(late, 10);
+		tree.SetUpdateGroupPriority(early, -5);
+		Recorder* lateNode = MEMNEW(Recorder(&log, 3));
+		lateNode->SetUpdateGroup(late);
+		Recorder* defaultNode = MEMNEW(Recorder(&log, 2));
+		Recorder* earlyNode = MEMNEW(Recorder(&log, 1));
+		earlyNode->SetUpdateGroup(early);
+		tree.GetRoot()->AddChild(lateNode);
+		tree.GetRoot()->AddChild(defaultNode);
+		tree.GetRoot()->AddChild(earlyNode);
+		tree.OnStart();
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 1, 2, 3 }));
+
+		// Moved behind everything.
+		log.Clear();
+		tree.SetUpdateGroupPriority(early, 20);
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 2, 3, 1 }));
+
+		// Switching groups moves the node between the orders.
+		log.Clear();
+		defaultNode->SetUpdateGroup(late);
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 3, 2, 1 }));
+		tree.OnStop();
+	}
+
+	TEST_CASE("Queued changes") {
+		List<int32> log{};
+		int32 destroyed = 0;
+		NodeTree tree;
+		Recorder* spawner = MEMNEW(Recorder(&log, 1));
+		Recorder* doomed = MEMNEW(Recorder(&log, 2));
+		Recorder* doomedChild = MEMNEW(Recorder(&log, 3));
+		doomed->destroyed = &destroyed;
+		doomedChild->destroyed = &destroyed;
+		doomed->AddChild(doomedChild);
+		tree.GetRoot()->AddChild(spawner);
+		tree.GetRoot()->AddChild(doomed);
+		tree.OnStart();
+
+		// The spawned node spawns its own child when ready, applied in the same flush.
+		Recorder* spawned = MEMNEW(Recorder(&log, 4));
+		Recorder* grandchild = MEMNEW(Recorder(&log, 5));
+		spawned->ready = [grandchild](Recorder* self) {
+			self->AddChildDeferred(grandchild);
+			self->ready = nullptr;
+		};
+		int32 queuedWhileUpdating = -1;
+		bool addedWhileUpdating = true;
+		spawner->action = [&](Recorder* self) {
+			self->AddChildDeferred(spawned);
+			// Queued twice, freed once.
+			doomed->QueueFree();
+			doomed->QueueFree();
+			doomedChild->QueueFree();
+			queuedWhileUpdating = self->GetTree()->GetQueuedChangeCount();
+			addedWhileUpdating = spawned->HasParent();
+			self->action = nullptr;
+		};
+
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(queuedWhileUpdating == 3);
+		CHECK(!addedWhileUpdating);
+		// The queued nodes still updated this frame.
+		CHECK(Equals(log, { 1, 2, 3 }));
+		CHECK(tree.GetQueuedChangeCount() == 0);
+		CHECK(destroyed == 2);
+		CHECK(spawned->GetParent() == spawner);
+		CHECK(grandchild->GetParent() == spawned);
+		CHECK(grandchild->GetTree() == &tree);
+
+		log.Clear();
+		tree.OnUpdate(time);
+		CHECK(Equals(log, { 1, 4, 5 }));
+		tree.OnStop();
+	}
+
+	TEST_CASE("Parallel update") {
+		JobSystem jobSystem;
+		NodeTree tree;
+		tree.SetParallelUpdate(&jobSystem);
+		CHECK(tree.GetParallelUpdate() == &jobSystem);
+
+		List<Recorder*> safe{};
+		for (int32 i = 0; i < 16; i += 1) {
+			Recorder* node = MEMNEW(Recorder);
+			node->SetUpdateThreadSafe(true);
+			tree.GetRoot()->AddChild(node);
+			safe.Add(node);
+		}
+		// An independent subtree updates on one worker, in order.
+		List<int32> subtreeLog{};
+		Recorder* independent = MEMNEW(Recorder(&subtreeLog, 1));
+		independent->SetUpdateIndependent(true);
+		independent->AddChild(MEMNEW(Recorder(&subtreeLog, 2)));
+		independent->AddChild(MEMNEW(Recorder(&subtreeLog, 3)));
+		tree.GetRoot()->AddChild(independent);
+		Recorder* serial = MEMNEW(Recorder);
+		tree.GetRoot()->AddChild(serial);
+		tree.OnStart();
+
+		Recorder* added = MEMNEW(Recorder);
+		bool parallel = false;
+		bool addedMeanwhile = true;
+		safe[3]->action = [&](Recorder* self) {
+			parallel = self->GetTree()->IsUpdatingInParallel();
+			CHECK(self->GetParent()->AddChild(added));
+			self->SetName(STRL("Renamed"));
+			addedMeanwhile = added->HasParent();
+			self->action = nullptr;
+		};
+		bool serialParallel = true;
+		serial->action = [&](Recorder* self) {
+			serialParallel = self->GetTree()->IsUpdatingInParallel();
+		};
+
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(parallel);
+		CHECK(!serialParallel);
+		CHECK(!addedMeanwhile);
+		CHECK(!tree.IsUpdatingInParallel());
+		// Replayed once the batch finished, behind the cursor so it updated in the same frame.
+		CHECK(added->GetParent() == tree.GetRoot());
+		CHECK(added->updates == 1);
+		CHECK(safe[3]->GetName() == StringName(STRL("Renamed")));
+		CHECK(Equals(subtreeLog, { 1, 2, 3 }));
+		for (Recorder* node : safe) {
+			CHECK(node->updates == 1);
+		}
+		CHECK(serial->updates == 1);
+
+		tree.OnUpdate(time);
+		CHECK(added->updates == 2);
+		CHECK(safe[0]->updates == 2);
+		tree.SetParallelUpdate(nullptr);
+		tree.OnStop();
+	}
+
+	TEST_CASE("Cost accounting") {
+		NodeTree tree;
+		Node* group = MEMNEW(Node);
+		group->SetName(STRL("Group"));
+		List<Heavy*> heavy{};
+		for (int32 i = 0; i < 3; i += 1) {
+			Heavy* node = MEMNEW(Heavy);
+			group->AddChild(node);
+			heavy.Add(node);
+		}
+		tree.GetRoot()->AddChild(group);
+		for (int32 i = 0; i < 12; i += 1) {
+			tree.GetRoot()->AddChild(MEMNEW(Node));
+		}
+		tree.OnStart();
+
+		// Node counts and memory add up over the subtree whether tracking or not.
+		NodeCost groupCost = group->GetSubtreeCost();
+		CHECK(groupCost.nodeCount == 4);
+		sizeint memory = group->GetMemoryUsage();
+		for (Heavy* node : heavy) {
+			CHECK(node->GetMemoryUsage() >= sizeof(Heavy) + 1000);
+			memory += node->GetMemoryUsage();
+		}
+		CHECK(groupCost.memoryBytes == memory);
+		CHECK(group->GetMemoryUsage() >= sizeof(Node) + 5);
+		NodeCost rootCost = tree.GetRoot()->GetSubtreeCost();
+		CHECK(rootCost.nodeCount == 17);
+		CHECK(rootCost.memoryBytes >= groupCost.memoryBytes + 12 * sizeof(Node));
+		// A longer name is counted in full.
+		sizeint before = group->GetMemoryUsage();
+		group->SetName(STRL("GroupOfHeavyNodes"));
+		CHECK(group->GetMemoryUsage() == before + 12);
+
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(!tree.IsCostTracking());
+		CHECK(heavy[0]->updates == 1);
+		CHECK(heavy[0]->GetLastFrameUpdateNanoseconds() == 0);
+		CHECK(group->GetSubtreeCost().updateNanoseconds == 0);
+
+		tree.SetCostTracking(true);
+		CHECK(tree.IsCostTracking());
+		tree.OnUpdate(time);
+		CHECK(heavy[0]->GetLastFrameUpdateNanoseconds() >= 2000000);
+		groupCost = group->GetSubtreeCost();
+		CHECK(groupCost.updateNanoseconds >= 6000000);
+		CHECK(groupCost.updateNanoseconds == heavy[0]->GetLastFrameUpdateNanoseconds() + heavy[1]->GetLastFrameUpdateNanoseconds() + heavy[2]->GetLastFrameUpdateNanoseconds());
+		// Nothing else updates.
+		CHECK(tree.GetRoot()->GetSubtreeCost().updateNanoseconds == groupCost.updateNanoseconds);
+
+		List<NodeClassCost> classCosts{};
+		tree.GetRoot()->GetSubtreeClassCosts(classCosts);
+		REQUIRE(classCosts.GetCount() == 2);
+		CHECK(classCosts[0].className == String(STRL("::NodeTreeTest::Heavy")));
+		CHECK(classCosts[0].cost.nodeCount == 3);
+		CHECK(classCosts[0].cost.updateNanoseconds == groupCost.updateNanoseconds);
+		CHECK(classCosts[1].cost.nodeCount == 14);
+		CHECK(classCosts[0].cost.memoryBytes + classCosts[1].cost.memoryBytes == tree.GetRoot()->GetSubtreeCost().memoryBytes);
+		CHECK(tree.GetRoot()->GetTreeCostFormated().Contains(STRL("GroupOfHeavyNodes (::Engine::Node) 4 nodes")));
+
+		// Calls made on the workers are timed as well.
+		JobSystem jobSystem;
+		for (Heavy* node : heavy) {
+			node->SetUpdateThreadSafe(true);
+		}
+		tree.SetParallelUpdate(&jobSystem);
+		tree.OnUpdate(time);
+		CHECK(heavy[2]->updates == 3);
+		CHECK(group->GetSubtreeCost().updateNanoseconds >= 6000000);
+		tree.SetParallelUpdate(nullptr);
+
+		// Costs of frames not tracked read as 0.
+		tree.SetCostTracking(false);
+		tree.OnUpdate(time);
+		CHECK(heavy[0]->GetLastFrameUpdateNanoseconds() == 0);
+		CHECK(group->GetSubtreeCost().updateNanoseconds == 0);
+		tree.OnStop();
+	}
+}
@@ -0,0 +1,219 @@
+#include "doctest.h"
+#include "Engine/Application/Node/PackedScene.h"
+#include "Engine/Application/Node/Node2D.h"
+#include "Engine/System/MemoryStream.h"
+#include <cstring>
+
+using namespace Engine;
+
+namespace PackedSceneTest {
+	class Tagged :public Node2D {
+		REFLECTION_CLASS(::PackedSceneTest::Tagged, ::Engine::Node2D) {
+			REFLECTION_CLASS_CONSTRUCTIBLE(Tagged);
+
+			REFLECTION_METHOD(STRL("GetScore"), Tagged::GetScore, {}, {});
+			REFLECTION_METHOD(STRL("SetScore"), Tagged::SetScore, { STRL("score") }, {});
+			REFLECTION_PROPERTY(STRL("Score"), STRL("GetScore"), STRL("SetScore"));
+			REFLECTION_METHOD(STRL("GetLabel"), Tagged::GetLabel, {}, {});
+			REFLECTION_METHOD(STRL("SetLabel"), Tagged::SetLabel, { STRL("label") }, {});
+			REFLECTION_PROPERTY(STRL("Label"), STRL("GetLabel"), STRL("SetLabel"));
+		}
+
+	public:
+		int32 GetScore() const {
+			return score;
+		}
+		void SetScore(int32 score) {
+			this->score = score;
+		}
+		String GetLabel() const {
+			return label;
+		}
+		void SetLabel(const String& label) {
+			this->label = label;
+		}
+
+	private:
+		int32 score = 1;
+		String label{};
+	};
+	/// @brief Has no REFLECTION_CLASS_CONSTRUCTIBLE(), so it can't be built again.
+	class Fixed :public Node {
+		REFLECTION_CLASS(::PackedSceneTest::Fixed, ::Engine::Node) {}
+	};
+
+	bool IsAutoName(const Node* node) {
+		return node->GetName().GetString().StartsWith(STRL("@@"));
+	}
+	/// @brief The same classes and names in the same places. Auto names are generated again, only both need to be one.
+	bool SameTree(const Node* a, const Node* b) {
+		if (a->GetReflectionClassName() != b->GetReflectionClassName() || a->GetChildrenCount() != b->GetChildrenCount()) {
+			return false;
+		}
+		if (IsAutoName(a) ? !IsAutoName(b) : a->GetName() != b->GetName()) {
+			return false;
+		}
+		for (int32 i = 0; i < a->GetChildrenCount(); i += 1) {
+			if (!SameTree(a->GetChildByIndex(i), b->GetChildByIndex(i))) {
+				return false;
+			}
+		}
+		return true;
+	}
+	/// @brief The values of Node2D and Tagged all match.
+	bool SameValues(const Node* a, const Node* b) {
+		if (a->IsUpdateEnabled() != b->IsUpdateEnabled() || a->IsPhysicsUpdateEnabled() != b->IsPhysicsUpdateEnabled()) {
+			return false;
+		}
+		const Node2D* a2 = dynamic_cast<const Node2D*>(a);
+		const Node2D* b2 = dynamic_cast<const Node2D*>(b);
+		if (a2 != nullptr && (a2->GetPosition() != b2->GetPosition() || a2->GetScale() != b2->GetScale() || a2->GetRotation() != b2->GetRotation())) {
+			return false;
+		}
+		const Tagged* aTagged = dynamic_cast<const Tagged*>(a);
+		const Tagged* bTagged = dynamic_cast<const Tagged*>(b);
+		if (aTagged != nullptr && (aTagged->GetScore() != bTagged->GetScore() || aTagged->GetLabel() != bTagged->GetLabel())) {
+			return false;
+		}
+		for (int32 i = 0; i < a->GetChildrenCount(); i += 1) {
+			if (!SameValues(a->GetChildByIndex(i), b->GetChildByIndex(i))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// @brief Level > Enemy, an auto-named group > Marker, Plain.
+	Node* BuildLevel() {
+		Node2D* level = MEMNEW(Node2D);
+		level->SetName(STRL("Level"));
+		level->SetPosition(Vector2(3, 4));
+		level->SetRotation(0.5f);
+
+		Tagged* enemy = MEMNEW(Tagged);
+		enemy->SetName(STRL("Enemy"));
+		enemy->SetScore(7);
+		enemy->SetLabel(STRL("Boss"));
+		enemy->SetUpdateEnabled(true);
+		level->AddChild(enemy);
+
+		Node* group = MEMNEW(Node);
+		group->SetPhysicsUpdateEnabled(true);
+		level->AddChild(group);
+		Node2D* marker = MEMNEW(Node2D);
+		marker->SetName(STRL("Marker"));
+		marker->SetScale(Vector2(2, 0.5f));
+		group->AddChild(marker);
+
+		Tagged* plain = MEMNEW(Tagged);
+		plain->SetName(STRL("Plain"));
+		level->AddChild(plain);
+		return level;
+	}
+}
+using PackedSceneTest::Tagged;
+using PackedSceneTest::Fixed;
+using PackedSceneTest::IsAutoName;
+using PackedSceneTest::SameTree;
+using PackedSceneTest::SameValues;
+using PackedSceneTest::BuildLevel;
+
+TEST_SUITE("PackedScene") {
+	TEST_CASE("Pack and instantiate") {
+		Node* level = BuildLevel();
+		PackedScene scene;
+		CHECK(scene.IsEmpty());
+		CHECK(scene.Instantiate() == nullptr);
+		REQUIRE(scene.Pack(level) == ResultCode::OK);
+		CHECK(scene.GetNodeCount() == 5);
+
+		Node* copy = scene.Instantiate();
+		REQUIRE(copy != nullptr);
+		CHECK(!copy->HasParent());
+		CHECK(SameTree(level, copy));
+		CHECK(SameValues(level, copy));
+		Tagged* enemy = dynamic_cast<Tagged*>(copy->GetChildByName(StringName(STRL("Enemy"))));
+		REQUIRE(enemy != nullptr);
+		CHECK(enemy->GetScore() == 7);
+		CHECK(enemy->GetLabel() == STRL("Boss"));
+		CHECK(enemy->IsUpdateEnabled());
+		// Names are generated again, not copied.
+		Node* group = copy->GetChildByIndex(1);
+		CHECK(IsAutoName(group));
+		CHECK(group->GetName() != level->GetChildByIndex(1)->GetName());
+		CHECK(group->IsPhysicsUpdateEnabled());
+		CHECK(static_cast<Node2D*>(group->GetChildByIndex(0))->GetScale() == Vector2(2, 0.5f));
+		// Defaults stay defaults.
+		Tagged* plain = static_cast<Tagged*>(copy->GetChildByIndex(2));
+		CHECK(plain->GetScore() == 1);
+		CHECK(plain->GetLabel() == String::GetEmpty());
+
+		// Every instance is a tree of its own.
+		Node* another = scene.Instantiate();
+		CHECK(another != copy);
+		CHECK(SameTree(copy, another));
+		static_cast<Tagged*>(another->GetChildByIndex(0))->SetScore(9);
+		CHECK(enemy->GetScore() == 7);
+
+		// A subtree packs alone.
+		PackedScene part;
+		REQUIRE(part.Pack(level->GetChildByIndex(1)) == ResultCode::OK);
+		CHECK(part.GetNodeCount() == 2);
+		Node* partCopy = part.Instantiate();
+		CHECK(SameTree(level->GetChildByIndex(1), partCopy));
+
+		MEMDEL(partCopy);
+		MEMDEL(another);
+		MEMDEL(copy);
+		MEMDEL(level);
+	}
+
+	TEST_CASE("Saved and loaded") {
+		Node* level = BuildLevel();
+		PackedScene scene;
+		REQUIRE(scene.Pack(level) == ResultCode::OK);
+		List<byte> data{};
+		scene.Serialize(data);
+
+		PackedScene loaded;
+		REQUIRE(loaded.Deserialize(data.GetRawElementPtr(), data.GetCount()) == ResultCode::OK);
+		CHECK(loaded.GetNodeCount() == 5);
+		Node* copy = loaded.Instantiate();
+		CHECK(SameTree(level, copy));
+		CHECK(SameValues(level, copy));
+		MEMDEL(copy);
+
+		// Through a stream, the bytes are the same.
+		MemoryStream stream;
+		REQUIRE(scene.Save(&stream) == ResultCode::OK);
+		CHECK(stream.GetLength() == data.GetCount());
+		CHECK(std::memcmp(stream.GetData(), data.GetRawElementPtr(), data.GetCount()) == 0);
+		stream.SetPosition(0);
+		REQUIRE(loaded.Load(&stream) == ResultCode::OK);
+		copy = loaded.Instantiate();
+		CHECK(SameValues(level, copy));
+		MEMDEL(copy);
+
+		// Broken data leaves the scene empty.
+		CHECK(loaded.Deserialize(data.GetRawElementPtr(), data.GetCount() / 2) == ResultCode::InvalidStream);
+		CHECK(loaded.IsEmpty());
+		List<byte> wrong = data;
+		wrong[0] ^= 0xFF;
+		CHECK(loaded.Deserialize(wrong.GetRawElementPtr(), wrong.GetCount()) == ResultCode::InvalidStream);
+		CHECK(loaded.IsEmpty());
+		MEMDEL(level);
+	}
+
+	TEST_CASE("Classes that can't be instantiated") {
+		Node* level = BuildLevel();
+		PackedScene scene;
+		REQUIRE(scene.Pack(level) == ResultCode::OK);
+		// Deep down counts too, and what was stored before is gone.
+		level->GetChildByIndex(1)->GetChildByIndex(0)->AddChild(MEMNEW(Fixed));
+		CHECK(scene.Pack(level) == ResultCode::NotSupported);
+		CHECK(scene.IsEmpty());
+		CHECK(scene.GetNodeCount() == 0);
+		CHECK(scene.Instantiate() == nullptr);
+		MEMDEL(level);
+	}
+}
@@ -0,0 +1,234 @@
+#include "doctest.h"
+#include "Engine/Application/Resource/Resource.h"
+#include "Engine/System/File/FileSystem.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Engine;
+
+namespace ResourceTest {
+	class TextResource :public Resource {
+		REFLECTION_CLASS(::ResourceTest::TextResource, ::Engine::Resource) {}
+	public:
+		String text{};
+	};
+
+	/// @brief Loads .res files listing the paths they depend on, one per line, and logs the order they are decoded in.
+	class TextHandler :public ResourceFileHandler {
+		REFLECTION_CLASS(::ResourceTest::TextHandler, ::Engine::ResourceFileHandler) {}
+	public:
+		TextHandler() {
+			extensions.Add(STRL("res"));
+		}
+		ResultCode Load(const String& path, IntrusivePtr<Resource>& result) const override {
+			loads.fetch_add(1);
+			IntrusivePtr<TextResource> resource = IntrusivePtr<TextResource>::Create();
+			resource->text = path;
+			result = resource;
+			return ResultCode::OK;
+		}
+		ResultCode Save(const String& path, const IntrusivePtr<Resource>& resource) override {
+			return ResultCode::NotSupported;
+		}
+		bool CanLoadFromData() const override {
+			return true;
+		}
+		ResultCode LoadFromData(const String& path, const List<byte>& data, IntrusivePtr<Resource>& result) const override {
+			// Holds the I/O thread, which decodes without a job system, so the reads queued meanwhile wait.
+			if (path == STRL("file://ResourceTestGate.res")) {
+				while (!open.load()) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+			{
+				SimpleLock<Mutex> lock(mutex);
+				decoded.Add(path);
+			}
+			IntrusivePtr<TextResource> resource = IntrusivePtr<TextResource>::Create();
+			resource->text = path;
+			result = resource;
+			return ResultCode::OK;
+		}
+		void GetDependencies(const String& path, const List<byte>& data, List<String>& result) const override {
+			String text((const u8char*)data.GetRawElementPtr(), data.GetCount());
+			for (const auto& line : text.Split(STRL("\n"), true)) {
+				result.Add(line);
+			}
+		}
+
+		mutable std::atomic<int32> loads{ 0 };
+		mutable std::atomic<bool> open{ true };
+		mutable Mutex mutex{};
+		mutable List<String> decoded{};
+	};
+
+	void WriteFile(FileSystem& fs, const String& path, const String& text) {
+		auto r = fs.OpenFile(path, FileStream::OpenMode::WriteTruncate);
+		REQUIRE(r.result == ResultCode::OK);
+		r.value->WriteText(text);
+		r.value->Close();
+	}
+	void RemoveFiles(FileSystem& fs, std::initializer_list<String> paths) {
+		for (const String& path : paths) {
+			CHECK(fs.RemoveFile(path) == ResultCode::OK);
+		}
+	}
+	bool WaitDone(const SharedPtr<ResourceLoad>& load) {
+		for (int32 i = 0; i < 2000 && !load->IsDone(); i += 1) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return load->IsDone();
+	}
+}
+using ResourceTest::TextResource;
+using ResourceTest::TextHandler;
+using ResourceTest::WriteFile;
+using ResourceTest::RemoveFiles;
+using ResourceTest::WaitDone;
+
+TEST_SUITE("Resource") {
+	TEST_CASE("Cache hits and expiry") {
+		ResourceSystem system;
+		SharedPtr<TextHandler> handler = SharedPtr<TextHandler>::Create();
+		system.AddFileHandler(handler);
+
+		IntrusivePtr<Resource> first{};
+		IntrusivePtr<Resource> second{};
+		CHECK(system.Load(STRL("ResourceTest/a.res"), first) == ResultCode::OK);
+		CHECK(system.Load(STRL("ResourceTest/a.res"), second) == ResultCode::OK);
+		CHECK(first.GetRaw() == second.GetRaw());
+		CHECK(handler->loads.load() == 1);
+		CHECK(first->GetPath() == STRL("ResourceTest/a.res"));
+		CHECK(system.GetCachedCount() == 1);
+		IntrusivePtr<Resource> other{};
+		CHECK(system.Load(STRL("ResourceTest/a.txt"), other) == ResultCode::NotSupported);
+
+		// Nothing holds it anymore, it's gone from the cache and loaded again.
+		first = IntrusivePtr<Resource>();
+		second = IntrusivePtr<Resource>();
+		CHECK(system.GetCached(STRL("ResourceTest/a.res")).GetRaw() == nullptr);
+		CHECK(system.GetCachedCount() == 0);
+		CHECK(system.Load(STRL("ResourceTest/a.res"), first) == ResultCode::OK);
+		CHECK(handler->loads.load() == 2);
+		first = IntrusivePtr<Resource>();
+
+		// The two loaded last stay alive without anything holding them.
+		system.SetRetainCount(2);
+		for (const auto& path : { STRL("ResourceTest/x.res"), STRL("ResourceTest/y.res"), STRL("ResourceTest/z.res") }) {
+			IntrusivePtr<Resource> loaded{};
+			CHECK(system.Load(path, loaded) == ResultCode::OK);
+		}
+		CHECK(system.GetCachedCount() == 2);
+		CHECK(system.GetCached(STRL("ResourceTest/x.res")).GetRaw() == nullptr);
+		CHECK(system.GetCached(STRL("ResourceTest/z.res")).GetRaw() != nullptr);
+		int32 loads = handler->loads.load();
+		CHECK(system.Load(STRL("ResourceTest/y.res"), first) == ResultCode::OK);
+		CHECK(handler->loads.load() == loads);
+
+		// A cached path loads asynchronously at once.
+		SharedPtr<ResourceLoad> load = system.LoadAsync(STRL("ResourceTest/y.res"));
+		CHECK(load->IsDone());
+		CHECK(load->GetResult() == ResultCode::OK);
+		CHECK(load->GetResource().GetRaw() == first.GetRaw());
+		load = SharedPtr<ResourceLoad>();
+
+		system.ClearRetained();
+		CHECK(system.GetCachedCount() == 1);
+		first = IntrusivePtr<Resource>();
+		CHECK(system.GetCachedCount() == 0);
+	}
+
+	TEST_CASE("Dependencies load first") {
+		FileSystem fs;
+		ResourceSystem system(&fs);
+		SharedPtr<TextHandler> handler = SharedPtr<TextHandler>::Create();
+		system.AddFileHandler(handler);
+		WriteFile(fs, STRL("file://ResourceTestA.res"), STRL("file://ResourceTestB.res\nfile://ResourceTestC.res"));
+		WriteFile(fs, STRL("file://ResourceTestB.res"), STRL("file://ResourceTestC.res"));
+		WriteFile(fs, STRL("file://ResourceTestC.res"), STRL(""));
+
+		SharedPtr<ResourceLoad> load = system.LoadAsync(STRL("file://ResourceTestA.res"));
+		REQUIRE(WaitDone(load));
+		CHECK(load->GetResult() == ResultCode::OK);
+		CHECK(load->GetProgress() == 1.0f);
+		CHECK(((TextResource*)load->GetResource().GetRaw())->text == STRL("file://ResourceTestA.res"));
+		CHECK(system.GetLoadingCount() == 0);
+		// C is shared by A and B, decoded once and before both.
+		REQUIRE(handler->decoded.GetCount() == 3);
+		CHECK(handler->decoded[0] == STRL("file://ResourceTestC.res"));
+		CHECK(handler->decoded[1] == STRL("file://ResourceTestB.res"));
+		CHECK(handler->decoded[2] == STRL("file://ResourceTestA.res"));
+
+		// A dependency failing fails the resource needing it.
+		WriteFile(fs, STRL("file://ResourceTestD.res"), STRL("file://ResourceTestMissing.res"));
+		load = system.LoadAsync(STRL("file://ResourceTestD.res"));
+		REQUIRE(WaitDone(load));
+		CHECK(load->GetResult() == ResultCode::NotFound);
+		CHECK(load->GetResource().GetRaw() == nullptr);
+		RemoveFiles(fs, { STRL("file://ResourceTestA.res"), STRL("file://ResourceTestB.res"), STRL("file://ResourceTestC.res"), STRL("file://ResourceTestD.res") });
+	}
+
+	TEST_CASE("Cancel") {
+		FileSystem fs;
+		ResourceSystem system(&fs);
+		SharedPtr<TextHandler> handler = SharedPtr<TextHandler>::Create();
+		system.AddFileHandler(handler);
+		WriteFile(fs, STRL("file://ResourceTestParent.res"), STRL("file://ResourceTestGate.res"));
+		WriteFile(fs, STRL("file://ResourceTestGate.res"), STRL(""));
+
+		handler->open.store(false);
+		SharedPtr<ResourceLoad> load = system.LoadAsync(STRL("file://ResourceTestParent.res"));
+		for (int32 i = 0; i < 2000 && load->GetStage() != ResourceLoad::Stage::Dependencies; i += 1) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		CHECK(load->GetStage() == ResourceLoad::Stage::Dependencies);
+		load->Cancel();
+		CHECK(load->IsCancelled());
+		handler->open.store(true);
+		REQUIRE(WaitDone(load));
+		CHECK(load->GetResult() == ResultCode::Cancelled);
+		CHECK(load->GetResource().GetRaw() == nullptr);
+		// The dependency kept loading, the parent was never decoded.
+		REQUIRE(handler->decoded.GetCount() == 1);
+		CHECK(handler->decoded[0] == STRL("file://ResourceTestGate.res"));
+		CHECK(system.GetLoadingCount() == 0);
+		RemoveFiles(fs, { STRL("file://ResourceTestParent.res"), STRL("file://ResourceTestGate.res") });
+	}
+
+	TEST_CASE("Circular dependencies") {
+		FileSystem fs;
+		ResourceSystem system(&fs);
+		SharedPtr<TextHandler> handler = SharedPtr<TextHandler>::Create();
+		system.AddFileHandler(handler);
+		WriteFile(fs, STRL("file://ResourceTestSelf.res"), STRL("file://ResourceTestSelf.res"));
+		WriteFile(fs, STRL("file://ResourceTestLoopA.res"), STRL("file://ResourceTestLoopB.res"));
+		WriteFile(fs, STRL("file://ResourceTestLoopB.res"), STRL("file://ResourceTestLoopA.res"));
+		WriteFile(fs, STRL("file://ResourceTestGate.res"), STRL(""));
+
+		SharedPtr<ResourceLoad> self = system.LoadAsync(STRL("file://ResourceTestSelf.res"));
+		REQUIRE(WaitDone(self));
+		CHECK(self->GetResult() == ResultCode::InvalidArgument);
+
+		// A down the chain of B.
+		SharedPtr<ResourceLoad> chained = system.LoadAsync(STRL("file://ResourceTestLoopA.res"));
+		REQUIRE(WaitDone(chained));
+		CHECK(chained->GetResult() == ResultCode::InvalidArgument);
+
+		// Started apart, each finds the other loading already. The gate holds the I/O thread until both are requested.
+		handler->open.store(false);
+		SharedPtr<ResourceLoad> gate = system.LoadAsync(STRL("file://ResourceTestGate.res"));
+		SharedPtr<ResourceLoad> a = system.LoadAsync(STRL("file://ResourceTestLoopA.res"));
+		SharedPtr<ResourceLoad> b = system.LoadAsync(STRL("file://ResourceTestLoopB.res"));
+		handler->open.store(true);
+		REQUIRE(WaitDone(a));
+		REQUIRE(WaitDone(b));
+		REQUIRE(WaitDone(gate));
+		CHECK(a->GetResult() == ResultCode::InvalidArgument);
+		CHECK(b->GetResult() == ResultCode::InvalidArgument);
+		CHECK(gate->GetResult() == ResultCode::OK);
+		CHECK(system.GetLoadingCount() == 0);
+		CHECK(system.GetCached(STRL("file://ResourceTestLoopA.res")).GetRaw() == nullptr);
+		RemoveFiles(fs, { STRL("file://ResourceTestSelf.res"), STRL("file://ResourceTestLoopA.res"), STRL("file://ResourceTestLoopB.res"), STRL("file://ResourceTestGate.res") });
+	}
+}
@@ -0,0 +1,339 @@
+#include "doctest.h"
+#include "Engine/Application/Node/NodeTree.h"
+#include "Engine/Application/Node/Node3D.h"
+#include "Engine/Application/Time.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Math/Random.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Engine;
+
+namespace SpatialIndex3DTest {
+	/// @brief The nodes of a tree with the world boxes they should have, to check the index against a scan over all of them.
+	struct Scene {
+		NodeTree tree;
+		Time time;
+		List<Node3D*> nodes{};
+
+		Scene() {
+			tree.OnStart();
+			time.Advance(0.1f);
+		}
+		~Scene() {
+			tree.OnStop();
+		}
+		const SpatialIndex3D& GetIndex() const {
+			return tree.GetSpatialIndex3D();
+		}
+		Node3D* Add(const Vector3& position, const Vector3& extent) {
+			Node3D* node = MEMNEW(Node3D);
+			node->SetPosition(position);
+			node->SetBounds(Vector3(0, 0, 0), extent);
+			tree.GetRoot()->AddChild(node);
+			nodes.Add(node);
+			return node;
+		}
+		void Remove(int32 index) {
+			Node3D* node = nodes[index];
+			tree.GetRoot()->RemoveChild(node);
+			MEMDEL(node);
+			nodes.RemoveAt(index);
+		}
+		void Update() {
+			tree.OnUpdate(time);
+		}
+
+		static Vector3 GetMin(const Node3D* node) {
+			return node->GetPosition() - node->GetBoundsExtent();
+		}
+		static Vector3 GetMax(const Node3D* node) {
+			return node->GetPosition() + node->GetBoundsExtent();
+		}
+		List<Node3D*> ScanBox(const Vector3& min, const Vector3& max) const {
+			List<Node3D*> result{};
+			for (Node3D* node : nodes) {
+				Vector3 a = GetMin(node);
+				Vector3 b = GetMax(node);
+				if (a.x <= max.x && b.x >= min.x && a.y <= max.y && b.y >= min.y && a.z <= max.z && b.z >= min.z) {
+					result.Add(node);
+				}
+			}
+			return result;
+		}
+		List<Node3D*> ScanSphere(const Vector3& center, float radius) const {
+			List<Node3D*> result{};
+			for (Node3D* node : nodes) {
+				Vector3 a = GetMin(node);
+				Vector3 b = GetMax(node);
+				Vector3 closest(std::clamp(center.x, a.x, b.x), std::clamp(center.y, a.y, b.y), std::clamp(center.z, a.z, b.z));
+				if ((closest - center).GetLengthSquared() <= radius * radius) {
+					result.Add(node);
+				}
+			}
+			return result;
+		}
+		/// @brief The nearest distance at which the ray enters a box, -1 if it enters none.
+		float ScanRay(const Vector3& origin, const Vector3& direction, float maxDistance) const {
+			Vector3 normal = direction / direction.GetLength();
+			float nearest = -1;
+			for (Node3D* node : nodes) {
+				Vector3 a = GetMin(node);
+				Vector3 b = GetMax(node);
+				float enter = 0;
+				float exit = maxDistance;
+				const float low[3] = { a.x, a.y, a.z };
+				const float high[3] = { b.x, b.y, b.z };
+				const float start[3] = { origin.x, origin.y, origin.z };
+				const float step[3] = { normal.x, normal.y, normal.z };
+				for (int32 axis = 0; axis < 3; axis += 1) {
+					float t0 = (low[axis] - start[axis]) / step[axis];
+					float t1 = (high[axis] - start[axis]) / step[axis];
+					enter = std::max(enter, std::min(t0, t1));
+					exit = std::min(exit, std::max(t0, t1));
+				}
+				if (enter <= exit && (nearest < 0 || enter < nearest)) {
+					nearest = enter;
+				}
+			}
+			return nearest;
+		}
+
+		/// @brief Every box, sphere and ray query gives what the scan gives.
+		bool MatchesScan(Random& random, int32 count) const {
+			const SpatialIndex3D& index = GetIndex();
+			if (index.GetCount() != nodes.GetCount()) {
+				return false;
+			}
+			for (int32 i = 0; i < count; i += 1) {
+				Vector3 center(random.NextFloat(-60, 60), random.NextFloat(-60, 60), random.NextFloat(-60, 60));
+				Vector3 size(random.NextFloat(0, 20), random.NextFloat(0, 20), random.NextFloat(0, 20));
+				List<Node3D*> found{};
+				index.QueryBox(center - size, center + size, found);
+				if (!SameNodes(found, ScanBox(center - size, center + size))) {
+					return false;
+				}
+				found.Clear();
+				index.QuerySphere(center, size.x, found);
+				if (!SameNodes(found, ScanSphere(center, size.x))) {
+					return false;
+				}
+
+				Vector3 direction(random.NextFloat(-1, 1), random.NextFloat(-1, 1), random.NextFloat(-1, 1));
+				if (direction.GetLengthSquared() < 0.01f) {
+					continue;
+				}
+				float expected = ScanRay(center, direction, 150);
+				RaycastHit3D hit{};
+				bool hitAny = index.Raycast(center, direction, 150, hit);
+				if (hitAny != (expected >= 0) || index.RaycastAny(center, direction, 150) != hitAny) {
+					return false;
+				}
+				if (hitAny) {
+					Vector3 point = center + direction / direction.GetLength() * hit.distance;
+					if (std::fabs(hit.distance - expected) > 1e-3f || (hit.point - point).GetLength() > 1e-3f) {
+						return false;
+					}
+					// Ties between boxes may pick either one, the one picked must be entered at that distance.
+					Vector3 a = GetMin(hit.node) - Vector3(1e-3f, 1e-3f, 1e-3f);
+					Vector3 b = GetMax(hit.node) + Vector3(1e-3f, 1e-3f, 1e-3f);
+					if (point.x < a.x || point.y < a.y || point.z < a.z || point.x > b.x || point.y > b.y || point.z > b.z) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+		static bool SameNodes(List<Node3D*> a, List<Node3D*> b) {
+			if (a.GetCount() != b.GetCount()) {
+				return false;
+			}
+			a.Sort();
+			b.Sort();
+			for (int32 i = 0; i < a.GetCount(); i += 1) {
+				if (a[i] != b[i]) {
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	/// @brief The height a tree kept balanced by rotations stays within, about 1.44 log2(count) with a little slack.
+	int32 GetHeightBound(int32 count) {
+		return (int32)(1.5f * std::log2((float)count + 2)) + 2;
+	}
+}
+using SpatialIndex3DTest::Scene;
+using SpatialIndex3DTest::GetHeightBound;
+
+TEST_SUITE("SpatialIndex3D") {
+	TEST_CASE("Insert and query") {
+		Scene scene;
+		CHECK(scene.GetIndex().GetCount() == 0);
+		CHECK(scene.GetIndex().GetHeight() == 0);
+		Random random(11);
+		for (int32 i = 0; i < 200; i += 1) {
+			Vector3 position(random.NextFloat(-50, 50), random.NextFloat(-50, 50), random.NextFloat(-50, 50));
+			scene.Add(position, Vector3(random.NextFloat(0, 4), random.NextFloat(0, 4), random.NextFloat(0, 4)));
+		}
+		// Empty bounds still go in as points.
+		Node3D* point = scene.Add(Vector3(200, 200, 200), Vector3(0, 0, 0));
+		scene.Update();
+		CHECK(scene.GetIndex().GetCount() == 201);
+		CHECK(scene.MatchesScan(random, 300));
+
+		List<Node3D*> found{};
+		scene.GetIndex().QueryBox(Vector3(200, 200, 200), Vector3(200, 200, 200), found);
+		CHECK(found.GetCount() == 1);
+		CHECK(found[0] == point);
+
+		// Passing beside every box, nothing is hit and the hit is left alone.
+		RaycastHit3D hit{};
+		hit.distance = -5;
+		CHECK(!scene.GetIndex().Raycast(Vector3(500, 500, 500), Vector3(1, 0, 0), 1000, hit));
+		CHECK(hit.node == nullptr);
+		CHECK(hit.distance == -5);
+	}
+
+	TEST_CASE("Update and remove") {
+		Scene scene;
+		Random random(23);
+		for (int32 i = 0; i < 150; i += 1) {
+			Vector3 position(random.NextFloat(-50, 50), random.NextFloat(-50, 50), random.NextFloat(-50, 50));
+			scene.Add(position, Vector3(random.NextFloat(0.5f, 3), random.NextFloat(0.5f, 3), random.NextFloat(0.5f, 3)));
+		}
+		scene.Update();
+
+		// Small moves stay inside the enlarged boxes, large ones reinsert the leaves, the queries see both.
+		for (int32 frame = 0; frame < 10; frame += 1) {
+			for (Node3D* node : scene.nodes) {
+				float reach = random.NextFloat() < 0.2f ? 20.0f : SpatialIndex3D::DefaultMargin * 0.5f;
+				Vector3 offset(random.NextFloat(-reach, reach), random.NextFloat(-reach, reach), random.NextFloat(-reach, reach));
+				node->SetPosition(node->GetPosition() + offset);
+			}
+			scene.Update();
+			CHECK(scene.MatchesScan(random, 50));
+		}
+
+		// Growing the bounds in place moves the node in the index too.
+		scene.nodes[0]->SetBounds(Vector3(0, 0, 0), Vector3(30, 30, 30));
+		scene.Update();
+		CHECK(scene.MatchesScan(random, 100));
+
+		for (int32 i = 0; i < 100; i += 1) {
+			scene.Remove(random.Next(0, scene.nodes.GetCount()));
+		}
+		CHECK(scene.GetIndex().GetCount() == 50);
+		CHECK(scene.MatchesScan(random, 200));
+		while (scene.nodes.GetCount() > 0) {
+			scene.Remove(scene.nodes.GetCount() - 1);
+		}
+		CHECK(scene.GetIndex().GetCount() == 0);
+		CHECK(scene.GetIndex().GetHeight() == 0);
+		CHECK(!scene.GetIndex().RaycastAny(Vector3(0, 0, 0), Vector3(1, 0, 0), 100));
+	}
+
+	TEST_CASE("Rebuild") {
+		Scene scene;
+		Random random(37);
+		for (int32 i = 0; i < 300; i += 1) {
+			Vector3 position(random.NextFloat(-50, 50), random.NextFloat(-50, 50), random.NextFloat(-50, 50));
+			scene.Add(position, Vector3(random.NextFloat(0, 2), random.NextFloat(0, 2), random.NextFloat(0, 2)));
+		}
+		scene.Update();
+		float incremental = scene.GetIndex().GetAreaRatio();
+
+		scene.tree.GetSpatialIndex3D().Rebuild();
+		CHECK(scene.GetIndex().GetCount() == 300);
+		CHECK(scene.GetIndex().GetAreaRatio() <= incremental * 1.1f);
+		CHECK(scene.GetIndex().GetHeight() <= GetHeightBound(300) * 2);
+		CHECK(scene.MatchesScan(random, 300));
+
+		// The rebuilt leaves still move and leave like inserted ones.
+		for (int32 i = 0; i < 50; i += 1) {
+			scene.nodes[i]->SetPosition(Vector3(random.NextFloat(-50, 50), random.NextFloat(-50, 50), random.NextFloat(-50, 50)));
+		}
+		scene.Update();
+		for (int32 i = 0; i < 50; i += 1) {
+			scene.Remove(0);
+		}
+		scene.Add(Vector3(0, 0, 0), Vector3(1, 1, 1));
+		scene.Update();
+		CHECK(scene.MatchesScan(random, 300));
+	}
+
+	TEST_CASE("Batches match single rays") {
+		Scene scene;
+		Random random(41);
+		for (int32 i = 0; i < 100; i += 1) {
+			Vector3 position(random.NextFloat(-30, 30), random.NextFloat(-30, 30), random.NextFloat(-30, 30));
+			scene.Add(position, Vector3(1, 1, 1));
+		}
+		scene.Update();
+
+		constexpr int32 count = SpatialIndex3D::ParallelBatchThreshold * 3;
+		List<Vector3> origins{};
+		List<Vector3> directions{};
+		for (int32 i = 0; i < count; i += 1) {
+			origins.Add(Vector3(random.NextFloat(-40, 40), random.NextFloat(-40, 40), random.NextFloat(-40, 40)));
+			directions.Add(Vector3(random.NextFloat(0.1f, 1), random.NextFloat(-1, 1), random.NextFloat(-1, 1)));
+		}
+		List<RaycastHit3D> hits(count);
+		hits.SetCount(count);
+		List<bool> any(count);
+		any.SetCount(count);
+		JobSystem jobSystem;
+		scene.GetIndex().RaycastBatch(origins.GetRawElementPtr(), directions.GetRawElementPtr(), count, 80, hits.GetRawElementPtr(), &jobSystem);
+		scene.GetIndex().RaycastAnyBatch(origins.GetRawElementPtr(), directions.GetRawElementPtr(), count, 80, any.GetRawElementPtr(), &jobSystem);
+		bool same = true;
+		for (int32 i = 0; i < count; i += 1) {
+			RaycastHit3D hit{};
+			bool result = scene.GetIndex().Raycast(origins[i], directions[i], 80, hit);
+			same = same && hits[i].node == hit.node && hits[i].distance == hit.distance && any[i] == result;
+		}
+		CHECK(same);
+	}
+
+	TEST_CASE("Balanced under sorted insertions") {
+		// Boxes inserted in order along a line, unbalanced insertion would make a list of them.
+		Scene scene;
+		Random random(53);
+		constexpr int32 count = 1024;
+		for (int32 i = 0; i < count; i += 1) {
+			scene.Add(Vector3((float)i * 3, 0, 0), Vector3(1, 1, 1));
+			if (i % 64 == 63) {
+				scene.Update();
+			}
+		}
+		scene.Update();
+		CHECK(scene.GetIndex().GetCount() == count);
+		CHECK(scene.GetIndex().GetHeight() <= GetHeightBound(count));
+
+		// Moving every node far in the same direction reinserts all the leaves at one end of the tree.
+		for (int32 step = 0; step < 4; step += 1) {
+			for (Node3D* node : scene.nodes) {
+				node->SetPosition(node->GetPosition() + Vector3(0, 10, 0));
+			}
+			scene.Update();
+			CHECK(scene.GetIndex().GetHeight() <= GetHeightBound(count));
+		}
+
+		// Removing whole runs of neighbours empties one side of the tree.
+		while (scene.nodes.GetCount() > count / 4) {
+			scene.Remove(0);
+		}
+		CHECK(scene.GetIndex().GetHeight() <= GetHeightBound(count / 4));
+
+		// Along the line the queries still find exactly the neighbours.
+		bool same = true;
+		for (int32 i = 0; i < 200; i += 1) {
+			float x = random.NextFloat(0, (float)count * 3);
+			List<Node3D*> found{};
+			scene.GetIndex().QueryBox(Vector3(x - 4, 35, -1), Vector3(x + 4, 45, 1), found);
+			same = same && Scene::SameNodes(found, scene.ScanBox(Vector3(x - 4, 35, -1), Vector3(x + 4, 45, 1)));
+		}
+		CHECK(same);
+		CHECK(scene.MatchesScan(random, 100));
+	}
+}
@@ -0,0 +1,192 @@
+#include "doctest.h"
+#include "Engine/Application/Rendering/TextureAtlas.h"
+#include "Engine/Application/Rendering/SpriteBatcher.h"
+#include "Engine/System/Math/Random.h"
+
+using namespace Engine;
+
+namespace TextureAtlasTest {
+	/// @brief Every region is inside its page with the padding around it, and the padded regions of a page never overlap.
+	bool IsLaidOut(const TextureAtlas& atlas, const List<uint32>& textures) {
+		int32 size = atlas.GetPageSize();
+		int32 padding = atlas.GetPadding();
+		List<AtlasRegion> regions{};
+		for (uint32 texture : textures) {
+			AtlasRegion region{};
+			if (!atlas.TryGetRegion(texture, region)) {
+				return false;
+			}
+			if (region.x < padding || region.y < padding || region.x + region.width + padding > size || region.y + region.height + padding > size) {
+				return false;
+			}
+			regions.Add(region);
+		}
+		for (int32 i = 0; i < regions.GetCount(); i += 1) {
+			for (int32 j = i + 1; j < regions.GetCount(); j += 1) {
+				const AtlasRegion& a = regions[i];
+				const AtlasRegion& b = regions[j];
+				if (a.page != b.page) {
+					continue;
+				}
+				bool apart = a.x + a.width + 2 * padding <= b.x || b.x + b.width + 2 * padding <= a.x
+					|| a.y + a.height + 2 * padding <= b.y || b.y + b.height + 2 * padding <= a.y;
+				if (!apart) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+using TextureAtlasTest::IsLaidOut;
+
+TEST_SUITE("TextureAtlas") {
+	TEST_CASE("No overlaps") {
+		TextureAtlas atlas(1000, 1024, 128, 2, 8);
+		Random random(5);
+		List<uint32> live{};
+		uint32 next = 1;
+		bool laidOut = true;
+		for (int32 round = 0; round < 20; round += 1) {
+			for (int32 i = 0; i < 150; i += 1) {
+				uint32 texture = next;
+				next += 1;
+				if (atlas.Add(texture, random.Next(8, 128), random.Next(8, 128))) {
+					live.Add(texture);
+				}
+			}
+			for (int32 i = 0; i < 100 && live.GetCount() > 0; i += 1) {
+				int32 index = random.Next(0, live.GetCount());
+				CHECK(atlas.Remove(live[index]));
+				live.RemoveAt(index);
+			}
+			laidOut = laidOut && IsLaidOut(atlas, live);
+		}
+		CHECK(laidOut);
+		CHECK(atlas.GetTextureCount() == live.GetCount());
+		CHECK(atlas.GetPageCount() <= 8);
+		for (int32 page = 0; page < atlas.GetPageCount(); page += 1) {
+			CHECK(atlas.GetPageOccupancy(page) <= 1);
+		}
+
+		// Adding again keeps the region, removing twice fails.
+		AtlasRegion before{};
+		atlas.TryGetRegion(live[0], before);
+		CHECK(atlas.Add(live[0], 16, 16));
+		AtlasRegion after{};
+		atlas.TryGetRegion(live[0], after);
+		CHECK(after.x == before.x);
+		CHECK(after.y == before.y);
+		CHECK(atlas.Remove(live[0]));
+		CHECK(!atlas.Remove(live[0]));
+		CHECK(!atlas.Contains(live[0]));
+		CHECK(!atlas.Add(next, 129, 8));
+	}
+
+	TEST_CASE("Padding") {
+		TextureAtlas atlas(1, 64, 64, 3, 1);
+		CHECK(atlas.Add(1, 10, 20));
+		CHECK(atlas.Add(2, 10, 20));
+		AtlasRegion first{};
+		AtlasRegion second{};
+		REQUIRE(atlas.TryGetRegion(1, first));
+		REQUIRE(atlas.TryGetRegion(2, second));
+		CHECK(first.x == 3);
+		CHECK(first.y == 3);
+		CHECK(first.width == 10);
+		CHECK(first.height == 20);
+		// The padding of both sits between them.
+		CHECK(((second.x == 3 + 10 + 6 && second.y == 3) || (second.x == 3 && second.y == 3 + 20 + 6)));
+		CHECK(atlas.GetPageOccupancy(0) == doctest::Approx(2.0f * 16 * 26 / (64 * 64)));
+		// With its padding it takes more than the page.
+		CHECK(!atlas.Add(3, 60, 8));
+	}
+
+	TEST_CASE("An empty page is reset") {
+		TextureAtlas atlas(10, 256, 256, 2, 4);
+		// Four padded quarters fill the first page, the fifth opens another.
+		for (uint32 texture = 1; texture <= 5; texture += 1) {
+			CHECK(atlas.Add(texture, 124, 124));
+		}
+		CHECK(atlas.GetPageOccupancy(0) == doctest::Approx(1));
+		CHECK(atlas.GetPageCount() == 2);
+		AtlasRegion region{};
+		atlas.TryGetRegion(5, region);
+		CHECK(region.page == 1);
+		CHECK(region.pageTexture == 11);
+
+		for (uint32 texture = 1; texture <= 4; texture += 1) {
+			CHECK(atlas.Remove(texture));
+		}
+		CHECK(atlas.GetPageOccupancy(0) == 0);
+		// Needs the whole page, which only a reset page has.
+		CHECK(atlas.Add(6, 252, 252));
+		atlas.TryGetRegion(6, region);
+		CHECK(region.page == 0);
+		CHECK(atlas.GetPageCount() == 2);
+	}
+
+	TEST_CASE("A fragmented page is rebuilt") {
+		TextureAtlas atlas(10, 256, 256, 0, 4);
+		for (uint32 texture = 1; texture <= 4; texture += 1) {
+			CHECK(atlas.Add(texture, 128, 128));
+		}
+		CHECK(atlas.GetPageCount() == 1);
+		// Freeing the two quarters along the top leaves two free rectangles, neither wide enough on its own.
+		for (uint32 texture = 1; texture <= 4; texture += 1) {
+			AtlasRegion region{};
+			atlas.TryGetRegion(texture, region);
+			if (region.y == 0) {
+				CHECK(atlas.Remove(texture));
+			}
+		}
+		CHECK(atlas.GetTextureCount() == 2);
+		CHECK(atlas.GetPageOccupancy(0) == doctest::Approx(0.5f));
+
+		// Rebuilt from the used quarters, the top half is one rectangle again and no page is added.
+		CHECK(atlas.Add(5, 256, 128));
+		AtlasRegion region{};
+		atlas.TryGetRegion(5, region);
+		CHECK(region.page == 0);
+		CHECK(region.x == 0);
+		CHECK(region.y == 0);
+		CHECK(atlas.GetPageCount() == 1);
+		CHECK(atlas.GetPageOccupancy(0) == doctest::Approx(1));
+	}
+
+	TEST_CASE("Pending copies and remapped uvs") {
+		TextureAtlas atlas(100, 512, 128, 2, 2);
+		CHECK(atlas.Add(7, 64, 32));
+		CHECK(atlas.Add(8, 16, 16));
+		CHECK(atlas.Add(9, 16, 16));
+		REQUIRE(atlas.GetPendingCopies().GetCount() == 3);
+		CHECK(atlas.GetPendingCopies()[0].sourceTexture == 7);
+		CHECK(atlas.GetPendingCopies()[2].sourceTexture == 9);
+		// A texture removed before it was copied is not copied.
+		atlas.Remove(8);
+		REQUIRE(atlas.GetPendingCopies().GetCount() == 2);
+		CHECK(atlas.GetPendingCopies()[1].sourceTexture == 9);
+		atlas.ClearPendingCopies();
+		CHECK(atlas.GetPendingCopies().GetCount() == 0);
+
+		AtlasRegion region{};
+		REQUIRE(atlas.TryGetRegion(7, region));
+		SpriteDrawItem item{};
+		item.texture = 7;
+		item.uvMin = Vector2(0.25f, 0);
+		item.uvMax = Vector2(0.75f, 1);
+		atlas.Remap(item);
+		CHECK(item.texture == 100);
+		CHECK(item.uvMin.x == doctest::Approx((region.x + 0.25f * 64) / 512));
+		CHECK(item.uvMin.y == doctest::Approx((float)region.y / 512));
+		CHECK(item.uvMax.x == doctest::Approx((region.x + 0.75f * 64) / 512));
+		CHECK(item.uvMax.y == doctest::Approx((float)(region.y + 32) / 512));
+
+		SpriteDrawItem other{};
+		other.texture = 55;
+		atlas.Remap(other);
+		CHECK(other.texture == 55);
+		CHECK(other.uvMin == Vector2(0, 0));
+		CHECK(other.uvMax == Vector2(1, 1));
+	}
+}
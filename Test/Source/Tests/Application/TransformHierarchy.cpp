@@ -0,0 +1,175 @@
+#include "doctest.h"
+#include "Engine/Application/Node/NodeTree.h"
+#include "Engine/Application/Node/Node2D.h"
+#include "Engine/Application/Time.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Math/Math.h"
+#include <cmath>
+
+using namespace Engine;
+
+namespace TransformHierarchyTest {
+	/// @brief Every cached global transform matches the one computed from the parents.
+	bool GlobalsMatch(const TransformHierarchy& transforms) {
+		const TransformMatrix* globals = transforms.GetGlobals();
+		for (int32 slot = 0; slot < transforms.GetSlotCount(); slot += 1) {
+			Node* node = transforms.GetNode(slot);
+			if (node == nullptr) {
+				continue;
+			}
+			TransformMatrix expected = TransformHierarchy::ComputeGlobal(node);
+			for (int32 i = 0; i < 4; i += 1) {
+				for (int32 j = 0; j < 4; j += 1) {
+					if (std::fabs(globals[slot].matrix[i][j] - expected.matrix[i][j]) > 1e-4f) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+	bool Near(const Vector2& a, const Vector2& b) {
+		return std::fabs(a.x - b.x) < 1e-4f && std::fabs(a.y - b.y) < 1e-4f;
+	}
+
+	/// @brief A root with a chain of children below it, every node offset from its parent by (1, 1).
+	Node2D* AddChain(Node* parent, int32 depth) {
+		Node2D* top = nullptr;
+		for (int32 i = 0; i < depth; i += 1) {
+			Node2D* node = MEMNEW(Node2D);
+			node->SetPosition(Vector2(1, 1));
+			parent->AddChild(node);
+			if (top == nullptr) {
+				top = node;
+			}
+			parent = node;
+		}
+		return top;
+	}
+}
+using TransformHierarchyTest::GlobalsMatch;
+using TransformHierarchyTest::Near;
+using TransformHierarchyTest::AddChain;
+
+TEST_SUITE("TransformHierarchy") {
+	TEST_CASE("Moving a parent moves its descendants") {
+		NodeTree tree;
+		Node2D* parent = MEMNEW(Node2D);
+		// A node without a transform in between, its children compose with the closest parent which has one.
+		Node* plain = MEMNEW(Node);
+		Node2D* child = MEMNEW(Node2D);
+		Node2D* grandchild = MEMNEW(Node2D);
+		parent->SetPosition(Vector2(10, 0));
+		child->SetPosition(Vector2(1, 2));
+		grandchild->SetPosition(Vector2(0, 3));
+		tree.GetRoot()->AddChild(parent);
+		parent->AddChild(plain);
+		plain->AddChild(child);
+		child->AddChild(grandchild);
+		tree.OnStart();
+		CHECK(tree.GetTransforms().GetCount() == 3);
+
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(Near(grandchild->GetGlobalTransform().GetOrigin(), Vector2(11, 5)));
+
+		parent->SetPosition(Vector2(-4, 1));
+		tree.OnUpdate(time);
+		CHECK(Near(child->GetGlobalTransform().GetOrigin(), Vector2(-3, 3)));
+		CHECK(Near(grandchild->GetGlobalTransform().GetOrigin(), Vector2(-3, 6)));
+
+		// Rotating the parent swings the children around it.
+		parent->SetRotation(Math::PI / 2);
+		tree.OnUpdate(time);
+		CHECK(GlobalsMatch(tree.GetTransforms()));
+		Vector2 expected = Vector2(-4, 1) + parent->GetGlobalTransform().TransformVector(Vector2(1, 5));
+		CHECK(Near(grandchild->GetGlobalTransform().GetOrigin(), expected));
+		tree.OnStop();
+	}
+
+	TEST_CASE("Compact keeps the hierarchy") {
+		JobSystem jobSystem;
+		NodeTree tree;
+		// Parallel updates group the slots by root, so they are compacted too.
+		tree.SetParallelUpdate(&jobSystem);
+		List<Node2D*> roots{};
+		for (int32 i = 0; i < 24; i += 1) {
+			roots.Add(AddChain(tree.GetRoot(), 5));
+		}
+		tree.OnStart();
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(GlobalsMatch(tree.GetTransforms()));
+
+		// Over a quarter of the slots removed, so the next update compacts them away.
+		List<Node2D*> removed{};
+		for (int32 i = 0; i < 24; i += 2) {
+			tree.GetRoot()->RemoveChild(roots[i]);
+			removed.Add(roots[i]);
+		}
+		CHECK(tree.GetTransforms().GetCount() == 60);
+		CHECK(tree.GetTransforms().GetSlotCount() == 120);
+		for (int32 i = 1; i < 24; i += 2) {
+			roots[i]->SetPosition(Vector2((float)i, -1));
+		}
+		tree.OnUpdate(time);
+		CHECK(tree.GetTransforms().GetSlotCount() == 60);
+		CHECK(GlobalsMatch(tree.GetTransforms()));
+		for (int32 i = 1; i < 24; i += 2) {
+			// The fifth node of the chain is four steps of (1, 1) below the root.
+			Node2D* leaf = (Node2D*)roots[i]->GetChildByIndex(0)->GetChildByIndex(0)->GetChildByIndex(0)->GetChildByIndex(0);
+			CHECK(Near(leaf->GetGlobalTransform().GetOrigin(), Vector2((float)i + 4, 3)));
+		}
+
+		// Moving after the compaction still reaches the remapped children.
+		roots[1]->SetPosition(Vector2(100, 100));
+		tree.OnUpdate(time);
+		CHECK(GlobalsMatch(tree.GetTransforms()));
+		CHECK(Near(((Node2D*)roots[1]->GetChildByIndex(0))->GetGlobalTransform().GetOrigin(), Vector2(101, 101)));
+
+		// Nodes added after the compaction aren't grouped yet, their root still updates after them.
+		Node2D* late = AddChain(roots[3], 3);
+		roots[3]->SetPosition(Vector2(-10, 0));
+		tree.OnUpdate(time);
+		CHECK(GlobalsMatch(tree.GetTransforms()));
+		CHECK(Near(late->GetGlobalTransform().GetOrigin(), Vector2(-9, 1)));
+		tree.SetParallelUpdate(nullptr);
+		tree.OnStop();
+		for (Node2D* node : removed) {
+			MEMDEL(node);
+		}
+	}
+
+	TEST_CASE("Removing a subtree") {
+		NodeTree tree;
+		Node2D* kept = AddChain(tree.GetRoot(), 3);
+		Node2D* parent = AddChain(tree.GetRoot(), 2);
+		Node2D* subtree = AddChain(parent, 3);
+		Node2D* sibling = AddChain(parent, 2);
+		tree.OnStart();
+		Time time;
+		time.Advance(0.1f);
+		tree.OnUpdate(time);
+		CHECK(tree.GetTransforms().GetCount() == 10);
+
+		parent->RemoveChild(subtree);
+		CHECK(tree.GetTransforms().GetCount() == 7);
+		parent->SetPosition(Vector2(5, 5));
+		kept->SetPosition(Vector2(-2, 0));
+		tree.OnUpdate(time);
+		CHECK(GlobalsMatch(tree.GetTransforms()));
+		CHECK(Near(sibling->GetGlobalTransform().GetOrigin(), Vector2(6, 6)));
+		CHECK(Near(((Node2D*)kept->GetChildByIndex(0)->GetChildByIndex(0))->GetGlobalTransform().GetOrigin(), Vector2(0, 2)));
+		// Outside the tree, the removed nodes compute their transform from their own parents.
+		CHECK(Near(((Node2D*)subtree->GetChildByIndex(0))->GetGlobalTransform().GetOrigin(), Vector2(2, 2)));
+
+		// Added again, the subtree follows its new parent.
+		sibling->AddChild(subtree);
+		tree.OnUpdate(time);
+		CHECK(GlobalsMatch(tree.GetTransforms()));
+		CHECK(Near(subtree->GetGlobalTransform().GetOrigin(), Vector2(7, 7)));
+		tree.OnStop();
+	}
+}
@@ -0,0 +1,118 @@
+#include "doctest.h"
+#include "Engine/System/Collection/BitList.h"
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("BitList") {
+		BitList flags(130);
+		CHECK(flags.GetCount() == 130);
+		CHECK(flags.GetWordCount() == 3);
+		CHECK(!flags.Any());
+		CHECK(flags.FindFirstSet() == -1);
+
+		flags.Set(0, true);
+		flags.Set(63, true);
+		flags.Set(64, true);
+		flags.Set(129, true);
+		CHECK(flags.Get(63));
+		CHECK(!flags.Get(62));
+		CHECK(flags.PopCount() == 4);
+		CHECK(flags.FindFirstSet() == 0);
+		CHECK(flags.FindFirstSet(1) == 63);
+		CHECK(flags.FindFirstSet(65) == 129);
+		CHECK(flags.FindFirstSet(130) == -1);
+
+		List<int32> visited{};
+		flags.ForEachSet([&visited](int32 index) {
+			visited.Add(index);
+		});
+		REQUIRE(visited.GetCount() == 4);
+		CHECK(visited[0] == 0);
+		CHECK(visited[1] == 63);
+		CHECK(visited[2] == 64);
+		CHECK(visited[3] == 129);
+
+		flags.Flip(129);
+		flags.Set(0, false);
+		CHECK(flags.PopCount() == 2);
+
+		// The bits past the count stay clear whatever is done to the words.
+		flags.SetAll(true);
+		CHECK(flags.PopCount() == 130);
+		flags.SetCount(70);
+		CHECK(flags.PopCount() == 70);
+		flags.SetCount(200, true);
+		CHECK(flags.PopCount() == 200);
+		flags.SetCount(260);
+		CHECK(flags.PopCount() == 200);
+		CHECK(flags.FindFirstSet(200) == -1);
+		flags.Add(true);
+		CHECK(flags.Get(260));
+		CHECK(flags.PopCount() == 201);
+
+		flags.Clear();
+		CHECK(flags.GetCount() == 0);
+		CHECK(flags.PopCount() == 0);
+	}
+
+	TEST_CASE("BitList combining") {
+		constexpr int32 Count = 1000;
+		BitList a(Count);
+		BitList b(Count);
+		for (int32 i = 0; i < Count; i += 1) {
+			a.Set(i, i % 2 == 0);
+			b.Set(i, i % 3 == 0);
+		}
+
+		BitList both = a;
+		both.And(b);
+		BitList either = a;
+		either.Or(b);
+		BitList onlyA = a;
+		onlyA.AndNot(b);
+		BitList one = a;
+		one.Xor(b);
+		bool correct = true;
+		for (int32 i = 0; i < Count; i += 1) {
+			bool x = i % 2 == 0;
+			bool y = i % 3 == 0;
+			correct = correct && both.Get(i) == (x && y) && either.Get(i) == (x || y) && onlyA.Get(i) == (x && !y) && one.Get(i) == (x != y);
+		}
+		CHECK(correct);
+		CHECK(both.PopCount() == 167);
+		CHECK(a.Intersects(b));
+		CHECK(!onlyA.Intersects(b));
+		CHECK(both != a);
+		one.Xor(b);
+		CHECK(one == a);
+	}
+
+	TEST_CASE("BitSet") {
+		BitSet<100> set{};
+		CHECK(set.GetCount() == 100);
+		CHECK(!set.Any());
+		set.Set(99, true);
+		set.Set(3, true);
+		CHECK(set.PopCount() == 2);
+		CHECK(set.FindFirstSet() == 3);
+		CHECK(set.FindFirstSet(4) == 99);
+
+		BitSet<100> all{};
+		all.SetAll(true);
+		CHECK(all.PopCount() == 100);
+		all.AndNot(set);
+		CHECK(all.PopCount() == 98);
+		CHECK(!all.Intersects(set));
+		all.Or(set);
+		BitSet<100> full{};
+		full.SetAll(true);
+		CHECK(all == full);
+
+		int32 sum = 0;
+		set.ForEachSet([&sum](int32 index) {
+			sum += index;
+		});
+		CHECK(sum == 102);
+	}
+}
@@ -1,6 +1,8 @@
 #include "doctest.h"
 #include "Engine/System/Collection/Deque.h"
+#include "Engine/System/Memory/UniquePtr.h"
 #include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
 
 using namespace Engine;
 
@@ -76,5 +78,104 @@ TEST_SUITE("Collections") {
 		deque.PushFront(5);
 		deque.PushBack(6);
 		CHECK(deque.GetCount() == 7);
+
+		// 5 3 1 0 2 4 6
+		Deque<MemoryObject> copy = deque;
+		CHECK(copy.GetCount() == 7);
+		s = copy.PopFront() == MemoryObject(5) && copy.PopBack() == MemoryObject(6);
+		CHECK(s);
+		CHECK(deque.GetCount() == 7);
+
+		Deque<MemoryObject> moved = Memory::Move(deque);
+		CHECK(deque.GetCount() == 0);
+		CHECK(moved.GetCount() == 7);
+		s = moved.PopFront() == MemoryObject(5);
+		CHECK(s);
+	}
+
+	TEST_CASE("Deque wrap around") {
+		// A queue that wraps around its ring many times, growing once in between.
+		Deque<int32> deque;
+		int32 pushed = 0;
+		int32 popped = 0;
+		bool correct = true;
+		for (int32 round = 0; round < 200; round += 1) {
+			int32 pushes = (round == 100 ? 300 : 7);
+			for (int32 i = 0; i < pushes; i += 1) {
+				deque.PushBack(pushed);
+				pushed += 1;
+			}
+			for (int32 i = 0; i < 7; i += 1) {
+				if (deque.PopFront() != popped) {
+					correct = false;
+				}
+				popped += 1;
+			}
+		}
+		CHECK(correct);
+		CHECK(deque.GetCount() == 293);
+
+		// Elements stay in place while others are pushed around them.
+		int32& element = deque.EmplaceBack(-1);
+		for (int32 i = 0; i < 1000; i += 1) {
+			deque.PushFront(i);
+		}
+		CHECK(element == -1);
+		CHECK(deque.PopBack() == -1);
+		CHECK(deque.PopFront() == 999);
+
+		deque.Clear();
+		CHECK(deque.GetCount() == 0);
+		int32 value = 0;
+		CHECK(!deque.TryPopFront(value));
+		deque.PushFront(42);
+		CHECK(deque.PopBack() == 42);
+	}
+
+	TEST_CASE("Deque move only") {
+		Deque<UniquePtr<int32>> deque;
+		for (int32 i = 0; i < 20; i += 1) {
+			UniquePtr<int32> ptr(MEMNEW(int32));
+			*ptr = i;
+			deque.PushBack(Memory::Move(ptr));
+		}
+		deque.EmplaceFront(MEMNEW(int32));
+
+		UniquePtr<int32> result;
+		CHECK(deque.TryPopBack(result));
+		CHECK(*result == 19);
+		CHECK(deque.GetCount() == 20);
+	}
+
+	TEST_CASE("Deque allocator") {
+		CountingAllocator allocator;
+		{
+			Deque<int32> deque{ &allocator };
+			for (int32 i = 0; i < 20; i += 1) {
+				deque.PushBack(i);
+				deque.PushFront(-i);
+			}
+			CHECK(allocator.allocations > 0);
+			CHECK(deque.PopFront() == -19);
+			CHECK(deque.PopBack() == 19);
+
+			// A steady queue reuses its retired chunks instead of allocating.
+			deque.Clear();
+			for (int32 i = 0; i < 64; i += 1) {
+				deque.PushBack(i);
+			}
+			for (int32 i = 0; i < 64; i += 1) {
+				deque.PopFront();
+			}
+			int32 allocations = allocator.allocations;
+			for (int32 i = 0; i < 10000; i += 1) {
+				deque.PushBack(i);
+				if (deque.GetCount() > 50) {
+					deque.PopFront();
+				}
+			}
+			CHECK(allocator.allocations == allocations);
+		}
+		CHECK(allocator.allocations == 0);
 	}
 }
@@ -2,6 +2,7 @@
 #include "Engine/System/Collection/Dictionary.h"
 #include "Engine/System/String.h"
 #include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
 
 using namespace Engine;
 
@@ -70,6 +71,154 @@ TEST_SUITE("Collections") {
 			}
 			bool result = sb && yjsp && mur && ark && sxc;
 			CHECK(result);
+
+			// Lookup without constructing a String.
+			int value = 0;
+			CHECK(dic.ContainsKey(std::string_view("YJSP")));
+			CHECK(dic.TryGet(std::string_view("MUR"), value));
+			CHECK(value == 393);
+			CHECK(!dic.ContainsKey(std::string_view("YJS")));
+			CHECK(!dic.TryGet(std::string_view("Arknights2"), value));
+		}
+	}
+
+	TEST_CASE("Dictionary incremental rehash") {
+		Dictionary<int32, MemoryObject> dic{};
+		dic.SetIncrementalRehash(true);
+		CHECK(dic.IsIncrementalRehash());
+
+		bool rehashed = false;
+		bool correct = true;
+		for (int32 i = 0; i < 20000; i += 1) {
+			dic.Add(i, MemoryObject(i));
+			if (dic.IsRehashing()) {
+				rehashed = true;
+				// Everything stays reachable while the entries are split between both tables.
+				if (!dic.ContainsKey(0) || dic.Get(i / 2).Get() != i / 2 || dic.GetCount() != i + 1) {
+					correct = false;
+				}
+			}
+		}
+		CHECK(rehashed);
+		CHECK(correct);
+		CHECK(!dic.Add(19999, MemoryObject(0)));
+
+		// Grow once more and work with the dictionary halfway.
+		while (!dic.IsRehashing()) {
+			dic.Add(dic.GetCount(), MemoryObject(dic.GetCount()));
+		}
+		int32 count = dic.GetCount();
+		dic.Set(1, MemoryObject(-1));
+		CHECK(dic.Get(1).Get() == -1);
+		CHECK(dic.Remove(2));
+		CHECK(!dic.Remove(2));
+		CHECK(!dic.ContainsKey(2));
+		count -= 1;
+		CHECK(dic.GetCount() == count);
+
+		int32 iterated = 0;
+		for (const auto& pair : dic) {
+			CHECK(dic.ContainsKey(pair.key));
+			iterated += 1;
+		}
+		CHECK(iterated == count);
+
+		Dictionary<int32, MemoryObject> copy = dic;
+		CHECK(copy.GetCount() == count);
+		CHECK(copy.Get(1).Get() == -1);
+
+		Dictionary<int32, MemoryObject> moved = Memory::Move(dic);
+		CHECK(moved.GetCount() == count);
+		CHECK(dic.GetCount() == 0);
+		CHECK(!dic.IsRehashing());
+
+		// Disabling finishes the rehash.
+		copy.SetIncrementalRehash(false);
+		CHECK(!copy.IsRehashing());
+		CHECK(copy.GetCount() == count);
+		CHECK(copy.Get(count).Get() == count);
+
+		moved.Clear();
+		CHECK(!moved.IsRehashing());
+		CHECK(moved.GetCount() == 0);
+	}
+
+	TEST_CASE("Dictionary order") {
+		Dictionary<int32, MemoryObject> dic{};
+		for (int32 i = 0; i < 100; i += 1) {
+			dic.Add(i * 7, MemoryObject(i));
+		}
+		int32 expected = 0;
+		bool ordered = true;
+		for (const auto& pair : dic) {
+			ordered = ordered && pair.key == expected * 7 && pair.value.Get() == expected;
+			expected += 1;
+		}
+		CHECK(ordered);
+		CHECK(expected == 100);
+
+		// The last entry fills the hole, everything stays reachable.
+		CHECK(dic.Remove(0));
+		CHECK(dic.Remove(50 * 7));
+		CHECK(dic.GetCount() == 98);
+		ordered = true;
+		int32 index = 0;
+		for (const auto& pair : dic) {
+			int32 expectedKey = (index == 0 ? 99 : (index == 50 ? 98 : index)) * 7;
+			ordered = ordered && pair.key == expectedKey;
+			index += 1;
+		}
+		CHECK(ordered);
+		CHECK(index == 98);
+		bool reachable = true;
+		for (int32 i = 1; i < 100; i += 1) {
+			reachable = reachable && (i == 50 ? !dic.ContainsKey(i * 7) : dic.Get(i * 7).Get() == i);
+		}
+		CHECK(reachable);
+
+		// Removing the last one and adding again.
+		CHECK(dic.Remove(98 * 7));
+		CHECK(dic.Add(1000, MemoryObject(1000)));
+		CHECK(dic.Get(1000).Get() == 1000);
+		CHECK(dic.GetCount() == 98);
+	}
+
+	TEST_CASE("Dictionary reserve") {
+		Dictionary<int32, int32> dic{};
+		CHECK(dic.Reserve(1000));
+		CHECK(dic.GetCapacity() == 1000);
+		for (int32 i = 0; i < 1000; i += 1) {
+			dic.Add(i, i);
+		}
+		CHECK(dic.GetCapacity() == 1000);
+		CHECK(dic.Reserve(10));
+		CHECK(dic.GetCapacity() == 1000);
+		CHECK(dic.Get(999) == 999);
+	}
+
+	TEST_CASE("Dictionary allocator") {
+		CountingAllocator allocator;
+		{
+			Dictionary<int32, MemoryObject> dictionary(0, &allocator);
+			CHECK(dictionary.GetAllocator() == &allocator);
+			for (int32 i = 0; i < 100; i += 1) {
+				dictionary.Add(i, MemoryObject(i));
+			}
+			CHECK(allocator.allocations == 2);
+
+			Dictionary<int32, MemoryObject> copy = dictionary;
+			CHECK(copy.GetAllocator() == nullptr);
+			CHECK(copy.Get(42).Get() == 42);
+
+			// Assigning keeps the target's allocator and releases its old storage.
+			Dictionary<int32, MemoryObject> assigned(0, &allocator);
+			assigned.Add(1, MemoryObject(1));
+			assigned = copy;
+			CHECK(assigned.GetAllocator() == &allocator);
+			CHECK(assigned.Get(99).Get() == 99);
+			CHECK(allocator.allocations == 4);
 		}
+		CHECK(allocator.allocations == 0);
+		CHECK(allocator.bytes == 0);
 	}
-}
\ No newline at end of file
+}
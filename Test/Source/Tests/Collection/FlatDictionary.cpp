@@ -0,0 +1,138 @@
+#include "doctest.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+#include "Engine/System/String.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("FlatDictionary") {
+		{
+			FlatDictionary<MemoryObject, String> dic{};
+			CHECK(dic.Add(MemoryObject(1), u8"f"));
+			CHECK(dic.Add(MemoryObject(2), u8"u"));
+			CHECK(dic.Add(MemoryObject(3), u8"r"));
+			CHECK(!dic.Add(MemoryObject(3), u8"x"));
+
+			CHECK(dic.GetCount() == 3);
+			CHECK(dic.ContainsKey(MemoryObject(3)));
+			CHECK(dic.Get(MemoryObject(1)) == u8"f");
+			CHECK(dic.Get(MemoryObject(3)) == u8"r");
+
+			CHECK(dic.Remove(MemoryObject(2)));
+			CHECK(!dic.Remove(MemoryObject(2)));
+			CHECK(!dic.ContainsKey(MemoryObject(2)));
+			CHECK(dic.ContainsKey(MemoryObject(3)));
+
+			dic.Set(MemoryObject(2), u8"a");
+			dic.Set(MemoryObject(1), u8"b");
+			CHECK(dic.Get(MemoryObject(2)) == u8"a");
+			CHECK(*dic.Find(MemoryObject(1)) == u8"b");
+			CHECK(dic.Find(MemoryObject(4)) == nullptr);
+
+			FlatDictionary<MemoryObject, String> dic2 = dic;
+			FlatDictionary<MemoryObject, String> dic3{};
+			dic3 = dic2;
+			CHECK(dic3.Get(MemoryObject(3)) == u8"r");
+
+			FlatDictionary<MemoryObject, String> dic4 = Memory::Move(dic);
+			CHECK(dic.GetCount() == 0);
+			CHECK(dic4.GetCount() == 3);
+		}
+
+		{
+			// Grow through several rehashes, with tombstones in between.
+			FlatDictionary<int32, int32> dic{};
+			for (int32 i = 0; i < 1000; i += 1) {
+				dic.Add(i * 7919, i);
+			}
+			for (int32 i = 0; i < 1000; i += 2) {
+				CHECK(dic.Remove(i * 7919));
+			}
+			CHECK(dic.GetCount() == 500);
+			int32 capacity = dic.GetCapacity();
+			CHECK((capacity & (capacity - 1)) == 0);
+
+			// Churn reuses the space, it should not keep growing.
+			for (int32 round = 0; round < 20; round += 1) {
+				for (int32 i = 0; i < 100; i += 1) {
+					dic.Add(-1 - i, i);
+				}
+				for (int32 i = 0; i < 100; i += 1) {
+					dic.Remove(-1 - i);
+				}
+			}
+			CHECK(dic.GetCapacity() == capacity);
+
+			bool correct = true;
+			for (int32 i = 0; i < 1000; i += 1) {
+				int32 value = -1;
+				bool found = dic.TryGet(i * 7919, value);
+				if (found != (i % 2 == 1) || (found && value != i)) {
+					correct = false;
+				}
+			}
+			CHECK(correct);
+
+			int32 iterated = 0;
+			int64 sum = 0;
+			for (const auto& pair : dic) {
+				iterated += 1;
+				sum += pair.value;
+			}
+			CHECK(iterated == 500);
+			CHECK(sum == 250000);
+
+			dic.Clear();
+			CHECK(dic.GetCount() == 0);
+			CHECK(!dic.ContainsKey(7919));
+		}
+
+		{
+			FlatDictionary<String, int32> dic(100);
+			int32 capacity = dic.GetCapacity();
+			CHECK(capacity * 7 / 8 >= 100);
+			for (int32 i = 0; i < 100; i += 1) {
+				dic.Add(String::Format(STRL("key{0}"), i), i);
+			}
+			CHECK(dic.GetCapacity() == capacity);
+			CHECK(dic.Get(STRL("key42")) == 42);
+
+			// Lookup without constructing a String.
+			int32 value = -1;
+			CHECK(dic.TryGet(std::string_view("key42"), value));
+			CHECK(value == 42);
+			CHECK(*dic.Find(std::string_view("key7")) == 7);
+			CHECK(!dic.ContainsKey(std::string_view("key100")));
+			CHECK(dic.Remove(std::string_view("key0")));
+			CHECK(!dic.ContainsKey(STRL("key0")));
+			CHECK(dic.GetCount() == 99);
+		}
+	}
+
+	TEST_CASE("FlatDictionary allocator") {
+		CountingAllocator allocator;
+		{
+			FlatDictionary<int32, MemoryObject> dictionary(0, &allocator);
+			CHECK(dictionary.GetAllocator() == &allocator);
+			for (int32 i = 0; i < 100; i += 1) {
+				dictionary.Add(i, MemoryObject(i));
+			}
+			CHECK(allocator.allocations == 2);
+
+			FlatDictionary<int32, MemoryObject> copy = dictionary;
+			CHECK(copy.GetAllocator() == nullptr);
+			CHECK(copy.Get(42).Get() == 42);
+
+			FlatDictionary<int32, MemoryObject> assigned(0, &allocator);
+			assigned.Add(1, MemoryObject(1));
+			assigned = copy;
+			CHECK(assigned.GetAllocator() == &allocator);
+			CHECK(assigned.Get(99).Get() == 99);
+			CHECK(allocator.allocations == 4);
+		}
+		CHECK(allocator.allocations == 0);
+		CHECK(allocator.bytes == 0);
+	}
+}
@@ -0,0 +1,109 @@
+#include "doctest.h"
+#include "Engine/System/Collection/FlatMap.h"
+#include "Engine/System/String.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("FlatMap") {
+		FlatMap<int32, MemoryObject> map{};
+		for (int32 i : { 5, 1, 9, 3, 7 }) {
+			CHECK(map.Add(i, MemoryObject(i * 10)));
+		}
+		CHECK(!map.Add(3, MemoryObject(0)));
+		CHECK(map.GetCount() == 5);
+
+		// Keys are kept sorted.
+		int32 last = -1;
+		bool sorted = true;
+		for (auto pair : map) {
+			sorted = sorted && pair.key > last && pair.value.Get() == pair.key * 10;
+			last = pair.key;
+		}
+		CHECK(sorted);
+
+		CHECK(map.ContainsKey(9));
+		CHECK(!map.ContainsKey(4));
+		CHECK(!map.ContainsKey(0));
+		CHECK(!map.ContainsKey(10));
+		CHECK(map.Get(7).Get() == 70);
+		CHECK(map.Find(2) == nullptr);
+		CHECK(map.IndexOf(1) == 0);
+		CHECK(map.IndexOf(9) == 4);
+
+		CHECK(map.Set(4, MemoryObject(40)));
+		CHECK(map.GetKey(2) == 4);
+		CHECK(map.Remove(1));
+		CHECK(!map.Remove(1));
+		CHECK(map.GetKey(0) == 3);
+
+		FlatMap<int32, MemoryObject> copy = map;
+		CHECK(copy.Get(4).Get() == 40);
+
+		map.Freeze();
+		CHECK(map.IsFrozen());
+		CHECK(map.GetCapacity() == map.GetCount());
+		CHECK(map.Get(9).Get() == 90);
+		CHECK(!map.Add(11, MemoryObject(0)));
+		CHECK(!map.Remove(9));
+		CHECK(map.Set(9, MemoryObject(-9)));
+		CHECK(!map.Set(12, MemoryObject(0)));
+		CHECK(map.Get(9).Get() == -9);
+		CHECK(map.GetCount() == 5);
+
+		FlatMap<int32, MemoryObject> moved = Memory::Move(copy);
+		CHECK(moved.GetCount() == 5);
+		CHECK(copy.GetCount() == 0);
+	}
+
+	TEST_CASE("FlatMap lookup") {
+		FlatMap<String, int32> map{};
+		map.Add(STRL("Position"), 1);
+		map.Add(STRL("Scale"), 2);
+		map.Add(STRL("Rotation"), 3);
+		map.Add(STRL("Name"), 4);
+		map.Freeze();
+
+		CHECK(map.GetKey(0) == STRL("Name"));
+		int32 value = 0;
+		CHECK(map.TryGet(std::string_view("Rotation"), value));
+		CHECK(value == 3);
+		CHECK(map.ContainsKey(std::string_view("Scale")));
+		CHECK(!map.ContainsKey(std::string_view("Scal")));
+		CHECK(!map.ContainsKey(std::string_view("Z")));
+
+		// A custom order.
+		auto greater = [](int32 a, int32 b) {
+			return a > b;
+		};
+		FlatMap<int32, int32, decltype(greater)> reversed{};
+		for (int32 i = 0; i < 100; i += 1) {
+			reversed.Add((i * 37) % 100, i);
+		}
+		CHECK(reversed.GetKey(0) == 99);
+		CHECK(reversed.GetKey(99) == 0);
+		bool found = true;
+		for (int32 i = 0; i < 100; i += 1) {
+			found = found && reversed.Get((i * 37) % 100) == i;
+		}
+		CHECK(found);
+	}
+
+	TEST_CASE("FlatMap allocator") {
+		CountingAllocator allocator;
+		{
+			FlatMap<int32, MemoryObject> map(0, &allocator);
+			CHECK(map.GetAllocator() == &allocator);
+			for (int32 i = 0; i < 20; i += 1) {
+				map.Add(i, MemoryObject(i));
+			}
+			map.Freeze();
+			CHECK(map.GetAllocator() == &allocator);
+			CHECK(allocator.allocations == 2);
+		}
+		CHECK(allocator.allocations == 0);
+		CHECK(allocator.bytes == 0);
+	}
+}
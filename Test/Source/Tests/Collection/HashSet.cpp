@@ -0,0 +1,67 @@
+#include "doctest.h"
+#include "Engine/System/Collection/HashSet.h"
+#include "Engine/System/String.h"
+#include "../System/MemoryObject.h"
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("HashSet") {
+		{
+			HashSet<MemoryObject> set{};
+			CHECK(set.Add(MemoryObject(1)));
+			CHECK(set.Add(MemoryObject(2)));
+			CHECK(set.Add(MemoryObject(3)));
+			CHECK(!set.Add(MemoryObject(3)));
+			CHECK(set.GetCount() == 3);
+
+			CHECK(set.Contains(MemoryObject(2)));
+			CHECK(set.Remove(MemoryObject(2)));
+			CHECK(!set.Remove(MemoryObject(2)));
+			CHECK(!set.Contains(MemoryObject(2)));
+			CHECK(set.GetCount() == 2);
+
+			HashSet<MemoryObject> set2 = set;
+			HashSet<MemoryObject> set3{};
+			set3 = set2;
+			CHECK(set3.Contains(MemoryObject(1)));
+			CHECK(set3.Contains(MemoryObject(3)));
+
+			HashSet<MemoryObject> set4 = Memory::Move(set);
+			CHECK(set.GetCount() == 0);
+			CHECK(set4.GetCount() == 2);
+		}
+
+		{
+			HashSet<int32> set{};
+			for (int32 i = 0; i < 1000; i += 1) {
+				set.Add(i * 7919);
+			}
+			for (int32 i = 0; i < 1000; i += 2) {
+				CHECK(set.Remove(i * 7919));
+			}
+			int64 sum = 0;
+			int32 iterated = 0;
+			for (int32 value : set) {
+				sum += value;
+				iterated += 1;
+			}
+			CHECK(iterated == 500);
+			CHECK(sum == (int64)7919 * 250000);
+
+			set.Clear();
+			CHECK(set.GetCount() == 0);
+			CHECK(!set.Contains(7919));
+		}
+
+		{
+			HashSet<String> set{ STRL("Rabbik"), STRL("Engine"), STRL("Rabbik") };
+			CHECK(set.GetCount() == 2);
+			CHECK(set.Contains(std::string_view("Engine")));
+			CHECK(!set.Contains(std::string_view("Engin")));
+			CHECK(set.Remove(std::string_view("Rabbik")));
+			CHECK(!set.Contains(STRL("Rabbik")));
+			CHECK(set.GetCount() == 1);
+		}
+	}
+}
@@ -1,9 +1,33 @@
 #include "doctest.h"
 #include "Engine/System/Collection/List.h"
 #include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
 
 using namespace Engine;
 
+namespace {
+	/// @brief Counts copies, so moves can be told apart.
+	struct CopyCounter {
+		CopyCounter(int32 value = 0) :value(value) {}
+		CopyCounter(const CopyCounter& obj) :value(obj.value) {
+			copies += 1;
+		}
+		CopyCounter(CopyCounter&& obj) :value(obj.value) {}
+		CopyCounter& operator=(const CopyCounter& obj) {
+			value = obj.value;
+			copies += 1;
+			return *this;
+		}
+		CopyCounter& operator=(CopyCounter&& obj) {
+			value = obj.value;
+			return *this;
+		}
+
+		int32 value;
+		static inline int32 copies = 0;
+	};
+}
+
 TEST_SUITE("Collections") {
 	TEST_CASE("List") {
 		List<MemoryObject> list{};
@@ -70,4 +94,224 @@ TEST_SUITE("Collections") {
 
 		List<MemoryObject> list4 = Memory::Move(list);
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("List allocator") {
+		CountingAllocator allocator;
+		{
+			List<MemoryObject> list(0, &allocator);
+			CHECK(list.GetAllocator() == &allocator);
+			for (int32 i = 0; i < 100; i += 1) {
+				list.Add(MemoryObject(i));
+			}
+			CHECK(allocator.allocations == 1);
+			CHECK(allocator.bytes == list.GetCapacity() * sizeof(MemoryObject));
+
+			// Copies live on the default allocator, moves take the allocator along.
+			List<MemoryObject> copy = list;
+			CHECK(copy.GetAllocator() == nullptr);
+			CHECK(copy.Get(99).Get() == 99);
+			List<MemoryObject> moved = Memory::Move(list);
+			CHECK(moved.GetAllocator() == &allocator);
+			CHECK(moved.Get(50).Get() == 50);
+
+			// A copy of an empty list with spare capacity can still grow.
+			List<int32> empty(8);
+			List<int32> emptyCopy = empty;
+			emptyCopy.Add(1);
+			CHECK(emptyCopy.Get(0) == 1);
+		}
+		CHECK(allocator.allocations == 0);
+		CHECK(allocator.bytes == 0);
+	}
+
+	TEST_CASE("List move and emplace") {
+		CopyCounter::copies = 0;
+		List<CopyCounter> list{};
+		for (int32 i = 0; i < 20; i += 1) {
+			list.Emplace(i);
+		}
+		list.Add(CopyCounter(20));
+		list.Insert(0, CopyCounter(-1));
+		list.EmplaceAt(5, 100);
+		list.RemoveAt(1);
+		list.Set(0, CopyCounter(-2));
+		CHECK(CopyCounter::copies == 0);
+		CHECK(list.GetCount() == 22);
+		CHECK(list[0].value == -2);
+		CHECK(list[1].value == 1);
+		CHECK(list[4].value == 100);
+		CHECK(list[5].value == 4);
+		CHECK(list[21].value == 20);
+
+		list[3].value = 33;
+		CHECK(list.Get(3).value == 33);
+		CHECK(CopyCounter::copies == 1);
+
+		// Adding an element of the list itself while it grows.
+		List<MemoryObject> objects{};
+		objects.Add(MemoryObject(7));
+		for (int32 i = 0; i < 10; i += 1) {
+			objects.Add(objects[0]);
+		}
+		objects.Insert(0, objects[10]);
+		CHECK(objects.GetCount() == 12);
+		for (const auto& obj : objects) {
+			CHECK(obj.Get() == 7);
+		}
+
+		// Trivially copyable elements are shifted in bulk.
+		List<int32> ints{};
+		for (int32 i = 0; i < 8; i += 1) {
+			ints.Add(i);
+		}
+		ints.Insert(0, -1);
+		ints.Insert(4, 40);
+		ints.RemoveAt(8);
+		// -1 0 1 2 40 3 4 5 7
+		CHECK(ints.GetCount() == 9);
+		int32 expected[] = { -1, 0, 1, 2, 40, 3, 4, 5, 7 };
+		for (int32 i = 0; i < 9; i += 1) {
+			CHECK(ints[i] == expected[i]);
+		}
+
+		// Resizing in one step, new elements are zeroed or default-constructed.
+		ints.SetCount(100);
+		CHECK(ints.GetCount() == 100);
+		CHECK(ints.GetCapacity() >= 100);
+		CHECK(ints[8] == 7);
+		CHECK(ints[99] == 0);
+		ints.SetCount(3);
+		CHECK(ints.GetCount() == 3);
+		CHECK(ints[2] == 1);
+
+		objects.SetCount(20);
+		CHECK(objects[11].Get() == 7);
+		CHECK(objects[19].Get() == 0);
+		objects.SetCount(0);
+		CHECK(objects.GetCount() == 0);
+
+		// Trivially copyable, but the default member initializers still apply.
+		struct Initialized {
+			int32 value = 5;
+			float scale = 1;
+		};
+		List<Initialized> initialized{};
+		initialized.SetCount(4);
+		CHECK(initialized[3].value == 5);
+		CHECK(initialized[3].scale == 1);
+	}
+
+	TEST_CASE("List sort") {
+		uint32 seed = 12345;
+		auto random = [&seed]() {
+			seed = seed * 1664525u + 1013904223u;
+			return (int32)(seed >> 8);
+		};
+		auto isSorted = [](const auto& list, const auto& compare) {
+			for (int32 i = 1; i < list.GetCount(); i += 1) {
+				if (compare(list[i], list[i - 1])) {
+					return false;
+				}
+			}
+			return true;
+		};
+
+		List<int32> ints{};
+		for (int32 i = 0; i < 5000; i += 1) {
+			ints.Add(random() % 1000 - 500);
+		}
+		List<int32> copy = ints;
+		ints.Sort();
+		CHECK(isSorted(ints, SortLess()));
+
+		// Sorted, reversed and all-equal inputs.
+		ints.Sort();
+		CHECK(isSorted(ints, SortLess()));
+		auto greater = [](int32 a, int32 b) {
+			return a > b;
+		};
+		ints.Sort(greater);
+		CHECK(isSorted(ints, greater));
+		List<int32> same(0);
+		for (int32 i = 0; i < 1000; i += 1) {
+			same.Add(3);
+		}
+		same.Sort();
+		CHECK(same[999] == 3);
+
+		copy.RadixSort([](int32 value) {
+			return value;
+		});
+		CHECK(isSorted(copy, SortLess()));
+		CHECK(copy[0] == ints[ints.GetCount() - 1]);
+
+		// Stable sorts keep equal keys in insertion order.
+		struct Item {
+			int32 key;
+			int32 order;
+		};
+		List<Item> items{};
+		for (int32 i = 0; i < 3000; i += 1) {
+			items.Add(Item{ random() % 50, i });
+		}
+		List<Item> radixItems = items;
+		auto byKey = [](const Item& a, const Item& b) {
+			return a.key < b.key;
+		};
+		auto stable = [](const List<Item>& list) {
+			for (int32 i = 1; i < list.GetCount(); i += 1) {
+				if (list[i].key < list[i - 1].key || (list[i].key == list[i - 1].key && list[i].order < list[i - 1].order)) {
+					return false;
+				}
+			}
+			return true;
+		};
+		items.StableSort(byKey);
+		CHECK(stable(items));
+		radixItems.RadixSort([](const Item& item) {
+			return item.key;
+		});
+		CHECK(stable(radixItems));
+
+		List<float> floats{ 3.5f, -1.0f, 0.0f, -7.25f, 100.0f, 2.0f, -0.5f };
+		floats.RadixSort([](float value) {
+			return value;
+		});
+		CHECK(isSorted(floats, SortLess()));
+		CHECK(floats[0] == -7.25f);
+		CHECK(floats[6] == 100.0f);
+
+		List<uint64> wide{ 0xFFFFFFFF00000000ull, 1, 0x100000000ull, 0 };
+		wide.RadixSort([](uint64 value) {
+			return value;
+		});
+		CHECK(isSorted(wide, SortLess()));
+
+		// Elements are only ever moved.
+		List<CopyCounter> counters{};
+		for (int32 i = 0; i < 100; i += 1) {
+			counters.Add(CopyCounter(random() % 100));
+		}
+		CopyCounter::copies = 0;
+		auto byValue = [](const CopyCounter& a, const CopyCounter& b) {
+			return a.value < b.value;
+		};
+		counters.Sort(byValue);
+		counters.StableSort(byValue);
+		counters.RadixSort([](const CopyCounter& counter) {
+			return counter.value;
+		});
+		CHECK(CopyCounter::copies == 0);
+		CHECK(isSorted(counters, byValue));
+
+		List<MemoryObject> objects{};
+		for (int32 i = 0; i < 200; i += 1) {
+			objects.Add(MemoryObject(random() % 100));
+		}
+		auto byObject = [](const MemoryObject& a, const MemoryObject& b) {
+			return a.Get() < b.Get();
+		};
+		objects.StableSort(byObject);
+		CHECK(isSorted(objects, byObject));
+	}
+}
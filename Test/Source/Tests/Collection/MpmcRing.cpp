@@ -0,0 +1,96 @@
+#include "doctest.h"
+#include "Engine/System/Collection/MpmcRing.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("MpmcRing") {
+		CountingAllocator allocator;
+		{
+			MpmcRing<MemoryObject> ring(1, &allocator);
+			CHECK(ring.GetCapacity() == 2);
+			CHECK(ring.Push(MemoryObject(1)));
+			CHECK(ring.Push(MemoryObject(2)));
+			CHECK(!ring.Push(MemoryObject(3)));
+
+			MemoryObject obj;
+			CHECK(ring.Pop(obj));
+			CHECK(obj.Get() == 1);
+			CHECK(ring.Emplace(3));
+
+			MemoryObject results[4];
+			CHECK(ring.PopBatch(results, 4) == 2);
+			bool s = results[0].Get() == 2 && results[1].Get() == 3;
+			CHECK(s);
+			CHECK(!ring.Pop(obj));
+
+			MemoryObject values[3] = { 4, 5, 6 };
+			CHECK(ring.PushBatch(values, 3) == 2);
+			CHECK(ring.GetCount() == 2);
+			// Values left in the ring are destroyed with it.
+		}
+		CHECK(allocator.allocations == 0);
+	}
+
+	TEST_CASE("MpmcRing threads") {
+		MpmcRing<int64> ring(128);
+		static constexpr int32 ThreadCount = 4;
+		static constexpr int64 CountPerThread = 20000;
+
+		std::atomic<int64> sum{ 0 };
+		std::atomic<int64> popped{ 0 };
+		std::vector<std::thread> threads;
+		for (int32 t = 0; t < ThreadCount; t += 1) {
+			threads.emplace_back([&, t]() {
+				int64 values[8];
+				int64 next = 0;
+				while (next < CountPerThread) {
+					if (t % 2 == 0) {
+						int32 n = 0;
+						for (; n < 8 && next + n < CountPerThread; n += 1) {
+							values[n] = t * CountPerThread + next + n;
+						}
+						int32 pushed = ring.PushBatch(values, n);
+						next += pushed;
+						if (pushed == 0) {
+							std::this_thread::yield();
+						}
+					} else if (ring.Push(t * CountPerThread + next)) {
+						next += 1;
+					} else {
+						std::this_thread::yield();
+					}
+				}
+			});
+			threads.emplace_back([&, t]() {
+				int64 results[8];
+				while (popped.load() < ThreadCount * CountPerThread) {
+					int32 n = (t % 2 == 0 ? ring.PopBatch(results, 8) : (ring.Pop(results[0]) ? 1 : 0));
+					if (n == 0) {
+						std::this_thread::yield();
+						continue;
+					}
+					int64 local = 0;
+					for (int32 i = 0; i < n; i += 1) {
+						local += results[i];
+					}
+					sum += local;
+					popped += n;
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		int64 total = ThreadCount * CountPerThread;
+		CHECK(popped.load() == total);
+		CHECK(sum.load() == total * (total - 1) / 2);
+		CHECK(ring.GetCount() == 0);
+	}
+}
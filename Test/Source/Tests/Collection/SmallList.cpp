@@ -0,0 +1,77 @@
+#include "doctest.h"
+#include "Engine/System/Collection/SmallList.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("SmallList") {
+		CountingAllocator allocator;
+		{
+			SmallList<MemoryObject, 4> list(0, &allocator);
+			CHECK(list.IsInline());
+			CHECK(list.GetCapacity() == 4);
+
+			for (int32 i = 0; i < 4; i += 1) {
+				list.Add(MemoryObject(i));
+			}
+			CHECK(list.IsInline());
+			CHECK(allocator.allocations == 0);
+
+			// Spills to the heap beyond the inline capacity.
+			list.Add(MemoryObject(4));
+			CHECK(!list.IsInline());
+			CHECK(allocator.allocations == 1);
+			for (int32 i = 5; i < 20; i += 1) {
+				list.Add(MemoryObject(i));
+			}
+			CHECK(allocator.allocations == 1);
+
+			list.Insert(0, MemoryObject(-1));
+			list.RemoveAt(10);
+			// -1 0 1 ... 8 10 11 ... 19
+			CHECK(list.GetCount() == 20);
+			CHECK(list[0].Get() == -1);
+			CHECK(list[9].Get() == 8);
+			CHECK(list[10].Get() == 10);
+			CHECK(list.Get(19).Get() == 19);
+
+			SmallList<MemoryObject, 4> copy = list;
+			CHECK(copy.GetAllocator() == nullptr);
+			CHECK(copy[19].Get() == 19);
+
+			SmallList<MemoryObject, 4> moved = Memory::Move(list);
+			CHECK(list.IsInline());
+			CHECK(list.GetCount() == 0);
+			CHECK(moved.GetAllocator() == &allocator);
+			CHECK(moved[5].Get() == 4);
+
+			// Shrinking back to inline frees the heap storage.
+			while (moved.GetCount() > 3) {
+				moved.RemoveAt(moved.GetCount() - 1);
+			}
+			moved.SetCapacity(moved.GetCount());
+			CHECK(moved.IsInline());
+			CHECK(allocator.allocations == 0);
+			CHECK(moved[2].Get() == 1);
+		}
+		CHECK(allocator.allocations == 0);
+		CHECK(allocator.bytes == 0);
+
+		// Inline lists are moved element by element.
+		SmallList<MemoryObject, 4> inlineList{ MemoryObject(1), MemoryObject(2) };
+		SmallList<MemoryObject, 4> inlineMoved{};
+		inlineMoved = Memory::Move(inlineList);
+		CHECK(inlineMoved.IsInline());
+		CHECK(inlineMoved.GetCount() == 2);
+		CHECK(inlineMoved[1].Get() == 2);
+		CHECK(inlineList.GetCount() == 0);
+
+		int32 sum = 0;
+		for (const auto& value : inlineMoved) {
+			sum += value.Get();
+		}
+		CHECK(sum == 3);
+	}
+}
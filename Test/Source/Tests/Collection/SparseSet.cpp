@@ -0,0 +1,81 @@
+#include "doctest.h"
+#include "Engine/System/Collection/SparseSet.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("SparseSet") {
+		SparseSet<MemoryObject> set{};
+		InstanceId a = InstanceId::Compose(3, 1, false);
+		InstanceId b = InstanceId::Compose(5000, 1, false);
+		InstanceId c = InstanceId::Compose(7, 2, true);
+		CHECK(set.Add(a, MemoryObject(1)));
+		CHECK(set.Add(b, MemoryObject(2)));
+		CHECK(set.Add(c, MemoryObject(3)));
+		CHECK(!set.Add(b, MemoryObject(4)));
+		CHECK(set.GetCount() == 3);
+
+		CHECK(set.Contains(b));
+		CHECK(set.Find(c)->Get() == 3);
+		CHECK(set.IndexOf(a) == 0);
+		CHECK(!set.Contains(InstanceId::Compose(4, 1, false)));
+		CHECK(!set.Contains(InstanceId::Compose(123456, 1, false)));
+
+		// An older generation of the same slot is not found.
+		CHECK(!set.Contains(InstanceId::Compose(7, 1, true)));
+
+		// Removing moves the last value into the hole.
+		CHECK(set.Remove(a));
+		CHECK(!set.Remove(a));
+		CHECK(set.GetCount() == 2);
+		CHECK(set.GetId(0) == c);
+		CHECK(set.GetValue(0).Get() == 3);
+		CHECK(set.IndexOf(c) == 0);
+		CHECK(set.IndexOf(b) == 1);
+
+		set.Swap(0, 1);
+		CHECK(set.GetId(0) == b);
+		CHECK(set.Find(b)->Get() == 2);
+		CHECK(set.Find(c)->Get() == 3);
+
+		int32 sum = 0;
+		for (MemoryObject& value : set) {
+			sum += value.Get();
+		}
+		CHECK(sum == 5);
+
+		// A newer generation replaces the stale value of its slot.
+		InstanceId newC = InstanceId::Compose(7, 3, true);
+		CHECK(set.Emplace(newC, 9)->Get() == 9);
+		CHECK(!set.Contains(c));
+		CHECK(set.GetCount() == 2);
+
+		SparseSet<MemoryObject> copy = set;
+		CHECK(copy.Find(newC)->Get() == 9);
+		SparseSet<MemoryObject> moved = Memory::Move(set);
+		CHECK(set.GetCount() == 0);
+		CHECK(moved.Find(b)->Get() == 2);
+
+		moved.Clear();
+		CHECK(moved.GetCount() == 0);
+		CHECK(!moved.Contains(b));
+		CHECK(moved.Add(b, MemoryObject(5)));
+	}
+
+	TEST_CASE("SparseSet allocator") {
+		CountingAllocator allocator;
+		{
+			SparseSet<int32> set(&allocator);
+			CHECK(set.GetAllocator() == &allocator);
+			for (uint32 i = 0; i < 100; i += 1) {
+				set.Add(InstanceId::Compose(i * 97, 1, false), (int32)i);
+			}
+			CHECK(allocator.allocations > 0);
+			CHECK(*set.Find(InstanceId::Compose(97 * 42, 1, false)) == 42);
+		}
+		CHECK(allocator.allocations == 0);
+		CHECK(allocator.bytes == 0);
+	}
+}
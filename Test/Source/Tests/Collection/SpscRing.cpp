@@ -0,0 +1,93 @@
+#include "doctest.h"
+#include "Engine/System/Collection/SpscRing.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+#include <thread>
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("SpscRing") {
+		CountingAllocator allocator;
+		{
+			SpscRing<MemoryObject> ring(5, &allocator);
+			CHECK(ring.GetCapacity() == 8);
+			for (int32 i = 0; i < 8; i += 1) {
+				CHECK(ring.Push(MemoryObject(i)));
+			}
+			CHECK(!ring.Push(MemoryObject(8)));
+			CHECK(ring.GetCount() == 8);
+
+			MemoryObject obj;
+			CHECK(ring.Pop(obj));
+			CHECK(obj.Get() == 0);
+			CHECK(ring.Push(MemoryObject(8)));
+
+			MemoryObject results[4];
+			CHECK(ring.PopBatch(results, 4) == 4);
+			bool s = results[0].Get() == 1 && results[3].Get() == 4;
+			CHECK(s);
+
+			MemoryObject values[6] = { 9, 10, 11, 12, 13, 14 };
+			CHECK(ring.PushBatch(values, 6) == 4);
+			CHECK(ring.GetCount() == 8);
+			// Values left in the ring are destroyed with it.
+		}
+		CHECK(allocator.allocations == 0);
+
+		SpscRing<UniquePtr<int32>> pointers(2);
+		CHECK(pointers.Emplace(MEMNEW(int32)));
+		UniquePtr<int32> ptr;
+		CHECK(pointers.Pop(ptr));
+		CHECK(ptr != nullptr);
+		CHECK(!pointers.Pop(ptr));
+	}
+
+	TEST_CASE("SpscRing threads") {
+		SpscRing<int64> ring(64);
+		static constexpr int64 Count = 100000;
+
+		std::thread producer([&]() {
+			int64 values[16];
+			int64 next = 0;
+			while (next < Count) {
+				if (next % 3 == 0) {
+					int32 n = 0;
+					for (; n < 16 && next + n < Count; n += 1) {
+						values[n] = next + n;
+					}
+					int32 pushed = ring.PushBatch(values, n);
+					next += pushed;
+					if (pushed == 0) {
+						std::this_thread::yield();
+					}
+				} else if (ring.Push(next)) {
+					next += 1;
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		bool ordered = true;
+		int64 expected = 0;
+		int64 results[16];
+		while (expected < Count) {
+			int32 n = ring.PopBatch(results, 16);
+			if (n == 0) {
+				std::this_thread::yield();
+			}
+			for (int32 i = 0; i < n; i += 1) {
+				if (results[i] != expected) {
+					ordered = false;
+				}
+				expected += 1;
+			}
+		}
+		producer.join();
+
+		CHECK(ordered);
+		CHECK(ring.GetCount() == 0);
+	}
+}
@@ -0,0 +1,119 @@
+#include "doctest.h"
+#include "Engine/System/Math/ColorBatch.h"
+#include <cmath>
+
+using namespace Engine;
+
+namespace {
+	float ExactDecode(float value) {
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+	float ExactEncode(float value) {
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1 / 2.4f) - 0.055f;
+	}
+}
+
+TEST_SUITE("Math") {
+	TEST_CASE("ColorBatch sRGB") {
+		// Every step of the curve, through both segments.
+		constexpr int32 Count = 1001;
+		Color colors[Count]{};
+		for (int32 i = 0; i < Count; i += 1) {
+			float value = i / (float)(Count - 1);
+			colors[i] = Color(value, 1 - value, value * value, 0.25f);
+		}
+		Color linear[Count]{};
+		Color encoded[Count]{};
+		ColorBatch::SrgbToLinear(colors, linear, Count);
+		ColorBatch::LinearToSrgb(colors, encoded, Count);
+		bool accurate = true;
+		for (int32 i = 0; i < Count; i += 1) {
+			accurate = accurate && std::abs(linear[i].r - ExactDecode(colors[i].r)) < 1e-5f && std::abs(linear[i].g - ExactDecode(colors[i].g)) < 1e-5f && std::abs(linear[i].b - ExactDecode(colors[i].b)) < 1e-5f;
+			accurate = accurate && std::abs(encoded[i].r - ExactEncode(colors[i].r)) < 1e-5f && std::abs(encoded[i].b - ExactEncode(colors[i].b)) < 1e-5f;
+			accurate = accurate && linear[i].a == 0.25f && encoded[i].a == 0.25f;
+		}
+		CHECK(accurate);
+
+		// Round trip in place.
+		ColorBatch::SrgbToLinear(encoded, encoded, Count);
+		bool roundTrip = true;
+		for (int32 i = 0; i < Count; i += 1) {
+			roundTrip = roundTrip && std::abs(encoded[i].r - colors[i].r) < 2e-5f && std::abs(encoded[i].g - colors[i].g) < 2e-5f;
+		}
+		CHECK(roundTrip);
+
+		Color outside[2] = { Color(-1, 2, 0.5f, 3), Color(1, 0, 0, -1) };
+		ColorBatch::LinearToSrgb(outside, outside, 2);
+		CHECK(outside[0].r == doctest::Approx(0));
+		CHECK(outside[0].g == doctest::Approx(1).epsilon(1e-5));
+		CHECK(outside[0].a == 3);
+		CHECK(outside[1].a == -1);
+	}
+
+	TEST_CASE("ColorBatch packing") {
+		// Not a multiple of 4, so the remainder goes through the scalar loop.
+		constexpr int32 Count = 259;
+		Color colors[Count]{};
+		for (int32 i = 0; i < Count; i += 1) {
+			colors[i] = Color::From8((byte)i, (byte)(255 - i), (byte)(i * 7), (byte)(i * 3));
+		}
+		colors[Count - 1] = Color(-0.5f, 1.5f, 0.5f, 1);
+
+		uint32 packed[Count]{};
+		ColorBatch::PackRGBA8(colors, packed, Count);
+		CHECK(packed[1] == (0x01u | (0xFEu << 8) | (0x07u << 16) | (0x03u << 24)));
+		CHECK(packed[Count - 1] == (0x00u | (0xFFu << 8) | (0x80u << 16) | (0xFFu << 24)));
+		Color unpacked[Count]{};
+		ColorBatch::UnpackRGBA8(packed, unpacked, Count);
+		bool exact = true;
+		for (int32 i = 0; i < Count - 1; i += 1) {
+			exact = exact && std::abs(unpacked[i].r - colors[i].r) < 1e-6f && std::abs(unpacked[i].g - colors[i].g) < 1e-6f && std::abs(unpacked[i].b - colors[i].b) < 1e-6f && std::abs(unpacked[i].a - colors[i].a) < 1e-6f;
+		}
+		CHECK(exact);
+
+		// The table decodes every 8 bit value to the exact curve, and encoding it back gives the same byte.
+		uint32 grays[256]{};
+		for (uint32 i = 0; i < 256; i += 1) {
+			grays[i] = i | (i << 8) | (i << 16) | (255u << 24);
+		}
+		Color decoded[256]{};
+		ColorBatch::UnpackSrgbRGBA8(grays, decoded, 256);
+		uint32 encoded[256]{};
+		ColorBatch::PackSrgbRGBA8(decoded, encoded, 256);
+		bool stable = true;
+		for (int32 i = 0; i < 256; i += 1) {
+			stable = stable && std::abs(decoded[i].g - ExactDecode(i / 255.0f)) < 1e-6f && decoded[i].a == 1 && encoded[i] == grays[i];
+		}
+		CHECK(stable);
+
+		uint32 wide[Count]{};
+		ColorBatch::PackRGB10A2(colors, wide, Count);
+		CHECK((wide[Count - 1] & 0x3FF) == 0);
+		CHECK(((wide[Count - 1] >> 10) & 0x3FF) == 1023);
+		CHECK(((wide[Count - 1] >> 20) & 0x3FF) == 512);
+		CHECK((wide[Count - 1] >> 30) == 3);
+		Color widened[Count]{};
+		ColorBatch::UnpackRGB10A2(wide, widened, Count);
+		bool close = true;
+		for (int32 i = 0; i < Count - 1; i += 1) {
+			close = close && std::abs(widened[i].r - colors[i].r) <= 0.5f / 1023 + 1e-6f && std::abs(widened[i].b - colors[i].b) <= 0.5f / 1023 + 1e-6f && std::abs(widened[i].a - colors[i].a) <= 0.5f / 3 + 1e-6f;
+		}
+		CHECK(close);
+	}
+
+	TEST_CASE("ColorBatch premultiply") {
+		Color colors[3] = { Color(1, 0.5f, 0.25f, 0.5f), Color(0.2f, 0.4f, 0.6f, 0), Color(0.3f, 0.6f, 0.9f, 1) };
+		Color premultiplied[3]{};
+		ColorBatch::Premultiply(colors, premultiplied, 3);
+		CHECK(premultiplied[0].r == doctest::Approx(0.5f));
+		CHECK(premultiplied[0].b == doctest::Approx(0.125f));
+		CHECK(premultiplied[0].a == 0.5f);
+		CHECK(premultiplied[1].g == 0);
+		ColorBatch::Unpremultiply(premultiplied, premultiplied, 3);
+		CHECK(premultiplied[0].r == doctest::Approx(1));
+		CHECK(premultiplied[0].g == doctest::Approx(0.5f));
+		CHECK(premultiplied[1].r == 0);
+		CHECK(premultiplied[1].b == 0);
+		CHECK(premultiplied[2].b == doctest::Approx(0.9f));
+	}
+}
@@ -0,0 +1,33 @@
+#include "doctest.h"
+#include "Engine/System/Math/Math.h"
+#include "Engine/System/Math/Vector.h"
+#include "Engine/System/Math/Color.h"
+
+using namespace Engine;
+
+TEST_SUITE("Math") {
+	TEST_CASE("Constant expressions") {
+		static_assert(Math::Clamp(5, 0, 3) == 3);
+		static_assert(Math::Lerp(2.0f, 4.0f, 0.5f) == 3.0f);
+		static_assert(Math::Abs(-2.0f) == 2.0f);
+		static_assert(Vector2::Dot(Vector2::Right, Vector2::Up) == 0);
+		static_assert(Vector3::Cross(Vector3::Right, Vector3::Up).GetLengthSquared() == 1);
+		static_assert((Vector3::One * 2 - Vector3::One) == Vector3::One);
+		static_assert(Color::Lerp(Color::Black, Color::White, 0.5f).r == 0.5f);
+		CHECK(Math::IsInfinity(Math::Infinity));
+	}
+	TEST_CASE("Fast approximations") {
+		SUBCASE("Inverse square root") {
+			for (float value = 0.001f; value < 10000; value *= 1.37f) {
+				float expected = 1 / Math::Sqrt(value);
+				CHECK(Math::Abs(Math::FastInverseSqrt(value) - expected) <= expected * 1e-5f);
+			}
+		}
+		SUBCASE("Sine and cosine") {
+			for (float value = -10; value <= 10; value += 0.01f) {
+				CHECK(Math::Abs(Math::FastSin(value) - Math::Sin(value)) < 1e-5f);
+				CHECK(Math::Abs(Math::FastCos(value) - Math::Cos(value)) < 1e-5f);
+			}
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#include "doctest.h"
+#include "Engine/System/Math/Quaternion.h"
+
+using namespace Engine;
+
+namespace {
+	Quaternion MultiplyScalar(const Quaternion& a, const Quaternion& b) {
+		return Quaternion(
+			a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+			a.w * b.y + a.y * b.w + a.z * b.x - a.x * b.z,
+			a.w * b.z + a.z * b.w + a.x * b.y - a.y * b.x,
+			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+		);
+	}
+	void CheckEqual(const Quaternion& a, const Quaternion& b) {
+		CHECK(a.x == doctest::Approx(b.x));
+		CHECK(a.y == doctest::Approx(b.y));
+		CHECK(a.z == doctest::Approx(b.z));
+		CHECK(a.w == doctest::Approx(b.w));
+	}
+	void CheckEqual(const Vector3& a, const Vector3& b) {
+		CHECK(a.x == doctest::Approx(b.x));
+		CHECK(a.y == doctest::Approx(b.y));
+		CHECK(a.z == doctest::Approx(b.z));
+	}
+}
+
+TEST_SUITE("Math") {
+	TEST_CASE("Quaternion") {
+		Quaternion a = Quaternion::FromAxisAngle(Vector3(1, 2, 3), 0.8f);
+		Quaternion b = Quaternion::FromAxisAngle(Vector3(-2, 0.5f, 1), 2.1f);
+
+		SUBCASE("Multiply") {
+			CheckEqual(a * b, MultiplyScalar(a, b));
+			CheckEqual(b * a, MultiplyScalar(b, a));
+		}
+		SUBCASE("Rotate") {
+			Vector3 v(3, -1, 2);
+			TransformMatrix m = a.ToTransformMatrix();
+			Vector3 expected;
+			TransformMatrix::TransformPoints(m, &v, &expected, 1);
+			CheckEqual(a.Rotate(v), expected);
+			CheckEqual(a.Rotate(v).GetNormalized(), a * v);
+		}
+		SUBCASE("Interpolation") {
+			CheckEqual(Quaternion::Slerp(a, b, 0), a);
+			CheckEqual(Quaternion::Slerp(a, b, 1), b);
+			CheckEqual(Quaternion::NLerp(a, b, 0), a);
+			CheckEqual(Quaternion::NLerp(a, b, 1), b);
+			// Halfway along the arc between two rotations around the same axis is the rotation by the mean angle.
+			Quaternion from = Quaternion::FromAxisAngle(Vector3(0, 1, 0), 0.2f);
+			Quaternion to = Quaternion::FromAxisAngle(Vector3(0, 1, 0), 1.4f);
+			CheckEqual(Quaternion::Slerp(from, to, 0.5f), Quaternion::FromAxisAngle(Vector3(0, 1, 0), 0.8f));
+			CheckEqual(Quaternion::NLerp(from, to, 0.5f), Quaternion::FromAxisAngle(Vector3(0, 1, 0), 0.8f));
+			CheckEqual(Quaternion::Slerp(from, to, 0.25f), Quaternion::FromAxisAngle(Vector3(0, 1, 0), 0.5f));
+			// The negated quaternion is the same rotation, the shorter arc is taken.
+			Quaternion negated(-to.x, -to.y, -to.z, -to.w);
+			CheckEqual(Quaternion::Slerp(from, negated, 0.5f), Quaternion::FromAxisAngle(Vector3(0, 1, 0), 0.8f));
+			CheckEqual(Quaternion::NLerp(from, negated, 0.5f), Quaternion::FromAxisAngle(Vector3(0, 1, 0), 0.8f));
+
+			Quaternion as[3] = { a, b, from };
+			Quaternion bs[3] = { b, a, negated };
+			Quaternion result[3];
+			Quaternion::Slerp(as, bs, 0.3f, result, 3);
+			for (int32 i = 0; i < 3; i += 1) {
+				CheckEqual(result[i], Quaternion::Slerp(as[i], bs[i], 0.3f));
+			}
+			Quaternion::NLerp(as, bs, 0.3f, as, 3);
+			CheckEqual(as[0], Quaternion::NLerp(a, b, 0.3f));
+			CHECK(as[1].GetMagnitude() == doctest::Approx(1));
+		}
+		SUBCASE("Matrices") {
+			Vector3 scale(2, 3, 4);
+			Vector3 translation(-1, 5, 2);
+			TransformMatrix expected = TransformMatrix::Translate(translation) * (TransformMatrix::Scale(scale) * a.ToTransformMatrix());
+			TransformMatrix composed = a.ToTransformMatrix(scale, translation);
+			Quaternion rotations[2] = { a, b };
+			Vector3 scales[2] = { scale, Vector3(1, 1, 1) };
+			Vector3 translations[2] = { translation, Vector3() };
+			TransformMatrix batch[2];
+			Quaternion::ToTransformMatrices(rotations, scales, translations, batch, 2);
+			TransformMatrix unscaled[2];
+			Quaternion::ToTransformMatrices(rotations, nullptr, nullptr, unscaled, 2);
+			for (int32 i = 0; i < 4; i += 1) {
+				for (int32 j = 0; j < 4; j += 1) {
+					CHECK(composed.matrix[i][j] == doctest::Approx(expected.matrix[i][j]));
+					CHECK(batch[0].matrix[i][j] == doctest::Approx(expected.matrix[i][j]));
+					CHECK(batch[1].matrix[i][j] == doctest::Approx(b.ToTransformMatrix().matrix[i][j]));
+					CHECK(unscaled[1].matrix[i][j] == doctest::Approx(b.ToTransformMatrix().matrix[i][j]));
+				}
+			}
+		}
+	}
+}
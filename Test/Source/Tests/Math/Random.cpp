@@ -0,0 +1,84 @@
+#include "doctest.h"
+#include "Engine/System/Math/Random.h"
+#include <thread>
+
+using namespace Engine;
+
+TEST_SUITE("Math") {
+	TEST_CASE("Random") {
+		SUBCASE("Seeded") {
+			Random a(42);
+			Random b(42);
+			for (int32 i = 0; i < 100; i += 1) {
+				CHECK(a.NextUInt64() == b.NextUInt64());
+			}
+			a.SetSeed(7);
+			b.SetSeed(8);
+			CHECK(a.NextUInt64() != b.NextUInt64());
+			// A zero seed still gives a working generator.
+			Random zero(0);
+			CHECK(zero.NextUInt64() != zero.NextUInt64());
+		}
+		SUBCASE("Ranges") {
+			Random random(1);
+			bool seen[10]{};
+			for (int32 i = 0; i < 2000; i += 1) {
+				int32 value = random.Next(-3, 7);
+				CHECK(value >= -3);
+				CHECK(value < 7);
+				seen[value + 3] = true;
+
+				float f = random.NextFloat(2, 5);
+				CHECK(f >= 2);
+				CHECK(f < 5);
+				double d = random.NextDouble();
+				CHECK(d >= 0);
+				CHECK(d < 1);
+			}
+			for (bool value : seen) {
+				CHECK(value);
+			}
+			CHECK(random.Next(4, 4) == 4);
+			int32 wide = random.Next(-2147483647 - 1, 2147483647);
+			CHECK(wide < 2147483647);
+		}
+		SUBCASE("Fill") {
+			Random random(3);
+			Random copy(3);
+			int32 ints[9]{};
+			random.Fill(ints, 9, 10, 20);
+			for (int32 value : ints) {
+				CHECK(value >= 10);
+				CHECK(value < 20);
+			}
+			float floats[9]{};
+			random.Fill(floats, 9, -1, 1);
+			for (float value : floats) {
+				CHECK(value >= -1);
+				CHECK(value < 1);
+			}
+			// Fill uses both halves of each number, the same numbers Next and NextFloat would take one by one.
+			uint64 first = copy.NextUInt64();
+			CHECK(ints[0] == 10 + (int32)(((first >> 32) * 10) >> 32));
+		}
+		SUBCASE("Jump") {
+			Random a(5);
+			Random b(5);
+			b.Jump();
+			CHECK(a.NextUInt64() != b.NextUInt64());
+		}
+		SUBCASE("Per thread") {
+			Random* main = &Random::GetCurrent();
+			CHECK(main == &Random::GetCurrent());
+			Random* other = nullptr;
+			uint64 otherValue = 0;
+			std::thread thread([&]() {
+				other = &Random::GetCurrent();
+				otherValue = other->NextUInt64();
+			});
+			thread.join();
+			CHECK(other != main);
+			CHECK(otherValue != main->NextUInt64());
+		}
+	}
+}
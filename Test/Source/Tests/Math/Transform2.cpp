@@ -0,0 +1,65 @@
+#include "doctest.h"
+#include "Engine/System/Math/Transform2.h"
+
+using namespace Engine;
+
+namespace {
+	void CheckEqual(const Transform2& a, const Transform2& b) {
+		for (int32 i = 0; i < 3; i += 1) {
+			CHECK(a.matrix[i][0] == doctest::Approx(b.matrix[i][0]));
+			CHECK(a.matrix[i][1] == doctest::Approx(b.matrix[i][1]));
+		}
+	}
+}
+
+TEST_SUITE("Math") {
+	TEST_CASE("Transform2") {
+		Transform2 parent = Transform2::Translate(Vector2(3, -2)) * (Transform2::Scale(Vector2(2, 0.5f)) * Transform2::Rotate(0.7f));
+		Transform2 child = Transform2::Translate(Vector2(-1, 4)) * Transform2::Rotate(-1.3f);
+
+		SUBCASE("Matches TransformMatrix") {
+			TransformMatrix full = parent.ToTransformMatrix() * child.ToTransformMatrix();
+			CheckEqual(parent * child, Transform2::FromTransformMatrix(full));
+			TransformMatrix rotation = TransformMatrix::Rotate(Vector3(0, 0, 1), 0.7f);
+			CheckEqual(Transform2::Rotate(0.7f), Transform2::FromTransformMatrix(rotation));
+		}
+		SUBCASE("Apply") {
+			Transform2 t = Transform2::Translate(Vector2(1, 2)) * Transform2::Scale(Vector2(2, 3));
+			Vector2 point = t.TransformPoint(Vector2(1, 1));
+			CHECK(point.x == doctest::Approx(3));
+			CHECK(point.y == doctest::Approx(5));
+			Vector2 vector = t.TransformVector(Vector2(1, 1));
+			CHECK(vector.x == doctest::Approx(2));
+			CHECK(vector.y == doctest::Approx(3));
+			CHECK(t.GetOrigin() == Vector2(1, 2));
+		}
+		SUBCASE("Inverse") {
+			CheckEqual(parent * parent.GetInverse(), Transform2());
+			CheckEqual(parent.GetInverse() * parent, Transform2());
+			Vector2 point = parent.GetInverse().TransformPoint(parent.TransformPoint(Vector2(5, -7)));
+			CHECK(point.x == doctest::Approx(5));
+			CHECK(point.y == doctest::Approx(-7));
+			CHECK(Transform2::Scale(Vector2(0, 1)).GetInverse() == Transform2());
+		}
+		SUBCASE("Batch") {
+			Vector2 points[3] = { Vector2(0, 0), Vector2(1, 0), Vector2(-2, 3) };
+			Vector2 result[3];
+			Transform2::TransformPoints(parent, points, result, 3);
+			for (int32 i = 0; i < 3; i += 1) {
+				Vector2 expected = parent.TransformPoint(points[i]);
+				CHECK(result[i].x == doctest::Approx(expected.x));
+				CHECK(result[i].y == doctest::Approx(expected.y));
+			}
+
+			Transform2 parents[2] = { parent, child };
+			Transform2 children[2] = { child, parent };
+			Transform2 composed[2];
+			Transform2::Multiply(parents, children, composed, 2);
+			CheckEqual(composed[0], parent * child);
+			CheckEqual(composed[1], child * parent);
+			Transform2::Multiply(parent, children, children, 2);
+			CheckEqual(children[0], parent * child);
+			CheckEqual(children[1], parent * parent);
+		}
+	}
+}
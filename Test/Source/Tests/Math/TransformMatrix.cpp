@@ -0,0 +1,77 @@
+#include "doctest.h"
+#include "Engine/System/Math/TransformMatrix.h"
+
+using namespace Engine;
+
+namespace {
+	TransformMatrix MultiplyScalar(const TransformMatrix& parent, const TransformMatrix& child) {
+		TransformMatrix result;
+		for (int32 i = 0; i < 4; i += 1) {
+			for (int32 j = 0; j < 4; j += 1) {
+				float value = 0;
+				for (int32 k = 0; k < 4; k += 1) {
+					value += child.matrix[i][k] * parent.matrix[k][j];
+				}
+				result.matrix[i][j] = value;
+			}
+		}
+		return result;
+	}
+	TransformMatrix Sample(float seed) {
+		TransformMatrix result;
+		for (int32 i = 0; i < 4; i += 1) {
+			for (int32 j = 0; j < 4; j += 1) {
+				result.matrix[i][j] = seed * (i * 4 + j + 1) - 3;
+			}
+		}
+		return result;
+	}
+}
+
+TEST_SUITE("Math") {
+	TEST_CASE("TransformMatrix") {
+		CHECK(alignof(TransformMatrix) >= 16);
+
+		SUBCASE("Multiply") {
+			TransformMatrix a = Sample(0.5f);
+			TransformMatrix b = Sample(-0.25f);
+			TransformMatrix expected = MultiplyScalar(a, b);
+			TransformMatrix result = a * b;
+			for (int32 i = 0; i < 4; i += 1) {
+				for (int32 j = 0; j < 4; j += 1) {
+					CHECK(result.matrix[i][j] == doctest::Approx(expected.matrix[i][j]));
+				}
+			}
+		}
+		SUBCASE("Vector") {
+			TransformMatrix a = Sample(0.5f);
+			Vector3 v(1, -2, 3);
+			Vector3 result = a * v;
+			CHECK(result.x == doctest::Approx(a.matrix[0][0] * v.x + a.matrix[0][1] * v.y + a.matrix[0][2] * v.z));
+			CHECK(result.y == doctest::Approx(a.matrix[1][0] * v.x + a.matrix[1][1] * v.y + a.matrix[1][2] * v.z));
+			CHECK(result.z == doctest::Approx(a.matrix[2][0] * v.x + a.matrix[2][1] * v.y + a.matrix[2][2] * v.z));
+		}
+		SUBCASE("TransformPoints") {
+			TransformMatrix transform = TransformMatrix::Translate(Vector3(1, 2, 3)) * TransformMatrix::Scale(Vector3(2, 3, 4));
+			Vector3 points[5] = { Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1), Vector3(-1, 2, -3) };
+			Vector3 result[5];
+			TransformMatrix::TransformPoints(transform, points, result, 5);
+			for (int32 i = 0; i < 5; i += 1) {
+				TransformMatrix expected = transform * TransformMatrix::Translate(points[i]);
+				CHECK(result[i].x == doctest::Approx(expected.matrix[3][0]));
+				CHECK(result[i].y == doctest::Approx(expected.matrix[3][1]));
+				CHECK(result[i].z == doctest::Approx(expected.matrix[3][2]));
+			}
+			CHECK(result[0].x == doctest::Approx(1));
+			CHECK(result[1].x == doctest::Approx(3));
+
+			// In place.
+			TransformMatrix::TransformPoints(transform, points, points, 5);
+			for (int32 i = 0; i < 5; i += 1) {
+				CHECK(points[i].x == result[i].x);
+				CHECK(points[i].y == result[i].y);
+				CHECK(points[i].z == result[i].z);
+			}
+		}
+	}
+}
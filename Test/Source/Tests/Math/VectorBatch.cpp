@@ -0,0 +1,79 @@
+#include "doctest.h"
+#include "Engine/System/Math/VectorBatch.h"
+#include "Engine/System/Math/Vector.h"
+
+using namespace Engine;
+
+TEST_SUITE("Math") {
+	TEST_CASE("VectorBatch") {
+		// Not a multiple of 4, so the remainder goes through the scalar loop.
+		constexpr int32 Count = 11;
+		float x[Count]{};
+		float y[Count]{};
+		float z[Count]{};
+		for (int32 i = 0; i < Count; i += 1) {
+			x[i] = i * 0.5f - 2;
+			y[i] = 3 - i * 0.25f;
+			z[i] = (i % 3) - 1.0f;
+		}
+		// A zero vector.
+		x[5] = 0;
+		y[5] = 0;
+		z[5] = 0;
+
+		SUBCASE("Length and dot") {
+			float length2[Count]{};
+			float length3[Count]{};
+			float dot2[Count]{};
+			float dot3[Count]{};
+			VectorBatch::Length(x, y, length2, Count);
+			VectorBatch::Length(x, y, z, length3, Count);
+			VectorBatch::Dot(x, y, y, x, dot2, Count);
+			VectorBatch::Dot(x, y, z, z, y, x, dot3, Count);
+			for (int32 i = 0; i < Count; i += 1) {
+				CHECK(length2[i] == doctest::Approx(Vector2(x[i], y[i]).GetLength()));
+				CHECK(length3[i] == doctest::Approx(Vector3(x[i], y[i], z[i]).GetLength()));
+				CHECK(dot2[i] == doctest::Approx(Vector2::Dot(Vector2(x[i], y[i]), Vector2(y[i], x[i]))));
+				CHECK(dot3[i] == doctest::Approx(Vector3::Dot(Vector3(x[i], y[i], z[i]), Vector3(z[i], y[i], x[i]))));
+			}
+		}
+		SUBCASE("Normalize") {
+			float nx[Count];
+			float ny[Count];
+			float nz[Count];
+			for (int32 i = 0; i < Count; i += 1) {
+				nx[i] = x[i];
+				ny[i] = y[i];
+				nz[i] = z[i];
+			}
+			VectorBatch::Normalize(nx, ny, nz, Count);
+			for (int32 i = 0; i < Count; i += 1) {
+				if (i == 5) {
+					CHECK(nx[i] == 0);
+					CHECK(ny[i] == 0);
+					CHECK(nz[i] == 0);
+					continue;
+				}
+				Vector3 expected = Vector3(x[i], y[i], z[i]).GetNormalized();
+				CHECK(nx[i] == doctest::Approx(expected.x));
+				CHECK(ny[i] == doctest::Approx(expected.y));
+				CHECK(nz[i] == doctest::Approx(expected.z));
+			}
+			VectorBatch::Normalize(x, y, Count);
+			for (int32 i = 0; i < Count; i += 1) {
+				CHECK(Vector2(x[i], y[i]).GetLength() == doctest::Approx(i == 5 ? 0 : 1));
+			}
+		}
+		SUBCASE("Lerp and multiply add") {
+			float result[Count]{};
+			VectorBatch::Lerp(x, y, 0.25f, result, Count);
+			for (int32 i = 0; i < Count; i += 1) {
+				CHECK(result[i] == doctest::Approx(x[i] + (y[i] - x[i]) * 0.25f));
+			}
+			VectorBatch::MultiplyAdd(result, z, 2, Count);
+			for (int32 i = 0; i < Count; i += 1) {
+				CHECK(result[i] == doctest::Approx(x[i] + (y[i] - x[i]) * 0.25f + z[i] * 2));
+			}
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#include "doctest.h"
+#include "Engine/System/Clock.h"
+#include <chrono>
+#include <thread>
+
+using namespace Engine;
+
+TEST_SUITE("Clock") {
+	TEST_CASE("Monotonic") {
+		uint64 previous = Clock::Now();
+		for (int32 i = 0; i < 100000; i += 1) {
+			uint64 now = Clock::Now();
+			CHECK(now >= previous);
+			previous = now;
+		}
+		uint64 nanoseconds = Clock::GetNanoseconds();
+		CHECK(Clock::GetNanoseconds() >= nanoseconds);
+	}
+	TEST_CASE("Agrees with the system clock") {
+		CHECK(Clock::GetFrequency() > 0);
+
+		auto systemBegin = std::chrono::steady_clock::now();
+		uint64 begin = Clock::Now();
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		uint64 end = Clock::Now();
+		double system = std::chrono::duration<double>(std::chrono::steady_clock::now() - systemBegin).count();
+
+		double seconds = Clock::ToSeconds(end - begin);
+		CHECK(seconds >= 0.049);
+		CHECK(seconds <= system + 0.001);
+		CHECK((double)Clock::ToNanoseconds(end - begin) == doctest::Approx(seconds * 1e9).epsilon(0.001));
+	}
+	TEST_CASE("Conversions") {
+		CHECK(Clock::FromSeconds(-1) == 0);
+		CHECK(Clock::ToSeconds(Clock::FromSeconds(2.5)) == doctest::Approx(2.5).epsilon(0.000001));
+		CHECK(Clock::ToSeconds(Clock::GetFrequency()) == doctest::Approx(1.0));
+		// Exact over spans far longer than a double holds ticks exactly.
+		uint64 frequency = Clock::GetFrequency();
+		CHECK(Clock::ToNanoseconds(frequency) == 1000000000ull);
+		CHECK(Clock::ToNanoseconds(frequency * 3600 * 24 * 365 * 10) == 1000000000ull * 3600 * 24 * 365 * 10);
+		// Half a second, short of a nanosecond at most with an odd frequency.
+		CHECK(100000500000000ull - Clock::ToNanoseconds(frequency * 100000 + frequency / 2) <= 1);
+		CHECK(Clock::ToNanoseconds(0) == 0);
+	}
+}
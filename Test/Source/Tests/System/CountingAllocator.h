@@ -0,0 +1,24 @@
+#pragma once
+#include "Engine/System/Memory/Allocator.h"
+
+/// @brief Forwards to Memory and counts the live allocations and bytes.
+class CountingAllocator final :public ::Engine::Allocator {
+public:
+	void* Allocate(::Engine::sizeint size, ::Engine::sizeint alignment) override {
+		allocations += 1;
+		bytes += size;
+		return ::Engine::Memory::AllocateAligned(size, alignment);
+	}
+	void* Reallocate(void* ptr, ::Engine::sizeint oldSize, ::Engine::sizeint newSize, ::Engine::sizeint alignment) override {
+		bytes += newSize - oldSize;
+		return ::Engine::Memory::Reallocate(ptr, newSize);
+	}
+	void Deallocate(void* ptr, ::Engine::sizeint size) override {
+		allocations -= 1;
+		bytes -= size;
+		::Engine::Memory::Deallocate(ptr);
+	}
+
+	::Engine::int32 allocations = 0;
+	::Engine::sizeint bytes = 0;
+};
@@ -0,0 +1,119 @@
+#include "doctest.h"
+#include "Engine/System/Debug.h"
+#include "Engine/System/Collection/List.h"
+#include <mutex>
+#include <string>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+
+using namespace Engine;
+
+namespace DebugCapture {
+	std::mutex mutex;
+	List<std::string> lines;
+
+	void Capture(const char* text) {
+		std::lock_guard<std::mutex> lock(mutex);
+		lines.Add(std::string(text));
+	}
+	void Reset() {
+		std::lock_guard<std::mutex> lock(mutex);
+		lines.Clear();
+	}
+}
+
+TEST_SUITE("Debug") {
+	TEST_CASE("Levels") {
+		DebugCapture::Reset();
+		DebugSetOutput(DebugCapture::Capture);
+
+		CHECK(DebugIsLevelEnabled(nullptr, DebugLevel::Info));
+		DebugSetCategoryLevel("DebugTestQuiet", DebugLevel::Error);
+		CHECK(!DebugIsLevelEnabled("DebugTestQuiet", DebugLevel::Info));
+		CHECK(!DebugIsLevelEnabled("DebugTestQuiet", DebugLevel::Warning));
+		CHECK(DebugIsLevelEnabled("DebugTestQuiet", DebugLevel::Error));
+		// Compared by name, not by address.
+		char name[] = "DebugTestQuiet";
+		CHECK(!DebugIsLevelEnabled(name, DebugLevel::Info));
+		// Other categories follow the global level.
+		CHECK(DebugIsLevelEnabled("DebugTestOther", DebugLevel::Info));
+
+		// Filtered messages aren't evaluated.
+		int32 evaluated = 0;
+		auto message = [&evaluated]() {
+			evaluated += 1;
+			return u8"counted";
+		};
+		INFO_MSG_CATEGORY("DebugTestQuiet", message());
+		WARN_MSG_CATEGORY("DebugTestQuiet", message());
+		CHECK(evaluated == 0);
+		ERR_MSG_CATEGORY("DebugTestQuiet", message());
+		CHECK(evaluated == 1);
+		INFO_MSG_CATEGORY("DebugTestOther", message());
+		CHECK(evaluated == 2);
+
+		DebugSetLevel(DebugLevel::Warning);
+		CHECK(!DebugIsLevelEnabled("DebugTestOther", DebugLevel::Info));
+		CHECK(DebugIsLevelEnabled(nullptr, DebugLevel::Fatal));
+		DebugSetLevel(DebugLevel::Info);
+		DebugSetCategoryLevel("DebugTestQuiet", DebugLevel::Info);
+
+		DebugSetOutput(nullptr);
+		REQUIRE(DebugCapture::lines.GetCount() == 2);
+		CHECK(DebugCapture::lines[1] == "DebugTestOther: counted\n");
+	}
+
+	TEST_CASE("Asynchronous printing") {
+		DebugCapture::Reset();
+		DebugSetOutput(DebugCapture::Capture);
+		DebugStartAsync();
+		CHECK(DebugIsAsync());
+
+		constexpr int32 threadCount = 4;
+		constexpr int32 messageCount = 300;
+		std::thread threads[threadCount];
+		for (int32 t = 0; t < threadCount; t += 1) {
+			threads[t] = std::thread([t]() {
+				char message[32];
+				for (int32 i = 0; i < messageCount; i += 1) {
+					std::snprintf(message, sizeof(message), "%d %d", t, i);
+					INFO_MSG_CATEGORY("DebugTestAsync", (const u8char*)message);
+				}
+			});
+		}
+		for (int32 t = 0; t < threadCount; t += 1) {
+			threads[t].join();
+		}
+
+		// Longer than a queued entry holds, printed after everything before it.
+		std::string longMessage(1500, 'x');
+		INFO_MSG((const u8char*)longMessage.c_str());
+		DebugFlush();
+
+		{
+			std::lock_guard<std::mutex> lock(DebugCapture::mutex);
+			REQUIRE(DebugCapture::lines.GetCount() == threadCount * messageCount + 1);
+			// Every thread's messages stay in their order.
+			int32 next[threadCount] = {};
+			bool ordered = true;
+			for (int32 i = 0; i < threadCount * messageCount; i += 1) {
+				int t = -1, index = -1;
+				std::sscanf(DebugCapture::lines[i].c_str(), "DebugTestAsync: %d %d", &t, &index);
+				if (t < 0 || t >= threadCount || index != next[t]) {
+					ordered = false;
+					break;
+				}
+				next[t] += 1;
+			}
+			CHECK(ordered);
+			CHECK(DebugCapture::lines[threadCount * messageCount] == longMessage + "\n");
+		}
+
+		DebugStopAsync();
+		CHECK(!DebugIsAsync());
+		INFO_MSG(u8"synchronous");
+		CHECK(DebugCapture::lines[DebugCapture::lines.GetCount() - 1] == "synchronous\n");
+		DebugSetOutput(nullptr);
+	}
+}
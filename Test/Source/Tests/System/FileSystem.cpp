@@ -1,5 +1,12 @@
 #include "doctest.h"
 #include "Engine/System/File/FileSystem.h"
+#include "Engine/System/File/FileWatcher.h"
+#include "Engine/System/File/Glob.h"
+#include "Engine/System/File/Protocol/Native.h"
+#include "Engine/System/File/Protocol/Pack.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include <atomic>
+#include <thread>
 
 using namespace Engine;
 
@@ -18,5 +25,343 @@ TEST_SUITE("File System") {
 			file->Close();
 		}
 		CHECK(fs.IsFileExists(path));
+		CHECK(fs.RemoveFile(path) == ResultCode::OK);
+	}
+
+	TEST_CASE("Mapped") {
+		FileSystem fs;
+		String path = STRL("file://MappedFileTest.bin");
+		{
+			auto r = fs.OpenFile(path, FileStream::OpenMode::WriteTruncate);
+			REQUIRE(r.result == ResultCode::OK);
+			for (int32 i = 0; i < 1000; i += 1) {
+				r.value->WriteInt32(i);
+			}
+			r.value->Close();
+		}
+
+		auto r = fs.MapFile(path);
+		REQUIRE(r.result == ResultCode::OK);
+		auto file = r.value;
+		CHECK(file->CanRead());
+		CHECK(!file->CanWrite());
+		CHECK(file->GetLength() == 4000);
+		CHECK(file->GetSpan().length == 4000);
+
+		CHECK(file->ReadInt32() == 0);
+		ByteSpan span = file->ReadSpan(8);
+		CHECK(span.length == 8);
+		CHECK(*(const int32*)(span.data + 4) == 2);
+		CHECK(file->GetPosition() == 12);
+
+		file->SetPosition(3996);
+		CHECK(file->ReadInt32() == 999);
+		CHECK(file->ReadSpan(16).IsEmpty());
+		file->Close();
+		CHECK(!file->IsValid());
+
+		{
+			auto empty = fs.OpenFile(path, FileStream::OpenMode::WriteTruncate);
+			empty.value->Close();
+		}
+		auto emptyMap = fs.MapFile(path);
+		REQUIRE(emptyMap.result == ResultCode::OK);
+		CHECK(emptyMap.value->GetLength() == 0);
+		CHECK(emptyMap.value->ReadSpan(4).IsEmpty());
+		emptyMap.value->Close();
+		CHECK(fs.RemoveFile(path) == ResultCode::OK);
+	}
+
+	TEST_CASE("Async") {
+		FileSystem fs;
+		String path = STRL("file://AsyncFileTest.bin");
+		{
+			auto r = fs.OpenFile(path, FileStream::OpenMode::WriteTruncate);
+			REQUIRE(r.result == ResultCode::OK);
+			for (int32 i = 0; i < 256; i += 1) {
+				r.value->WriteByte((byte)i);
+			}
+			r.value->Close();
+		}
+
+		std::atomic<int32> called{ 0 };
+		auto onDone = [](AsyncFileRead& read, void* userData) {
+			((std::atomic<int32>*)userData)->fetch_add(1);
+		};
+		auto read = fs.ReadFileAsync(path, onDone, &called);
+		auto missing = fs.ReadFileAsync(STRL("file://AsyncFileMissing.bin"), onDone, &called);
+		for (int32 i = 0; i < 1000 && called.load() < 2; i += 1) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		REQUIRE(read->IsDone());
+		REQUIRE(missing->IsDone());
+		CHECK(called.load() == 2);
+		CHECK(read->GetResult() == ResultCode::OK);
+		CHECK(read->GetData().GetCount() == 256);
+		CHECK(read->GetData()[255] == 255);
+		CHECK(missing->GetResult() == ResultCode::NotFound);
+		CHECK(fs.RemoveFile(path) == ResultCode::OK);
+	}
+
+	TEST_CASE("Pack") {
+		String path = STRL("file://PackFileTest.pack");
+		{
+			// Mounted until the file system is gone, which has to happen before the pack can be removed.
+			FileSystem fs;
+			{
+				PackFileWriter writer(64);
+				List<byte> big{};
+				for (int32 i = 0; i < 1000; i += 1) {
+					big.Add((byte)i);
+				}
+				CHECK(writer.Add(STRL("textures/big.bin"), big) == ResultCode::OK);
+				CHECK(writer.Add(STRL("/textures/ui/icon.txt"), (const byte*)"icon", 4) == ResultCode::OK);
+				CHECK(writer.Add(STRL("readme.txt"), (const byte*)"hello", 5) == ResultCode::OK);
+				CHECK(writer.Add(STRL("empty.bin"), nullptr, 0) == ResultCode::OK);
+				CHECK(writer.Add(STRL("readme.txt"), (const byte*)"again", 5) == ResultCode::AlreadyExists);
+				CHECK(writer.GetCount() == 4);
+
+				auto r = fs.OpenFile(path, FileStream::OpenMode::WriteTruncate);
+				REQUIRE(r.result == ResultCode::OK);
+				CHECK(writer.Write(*r.value.GetRaw()) == ResultCode::OK);
+				r.value->Close();
+			}
+			CHECK(!fs.IsFileExists(STRL("res://readme.txt")));
+			REQUIRE(fs.MountResourcePack(path) == ResultCode::OK);
+
+			CHECK(fs.IsFileExists(STRL("res://readme.txt")));
+			CHECK(fs.IsFileExists(STRL("res://textures/ui/icon.txt")));
+			CHECK(!fs.IsFileExists(STRL("res://textures")));
+			CHECK(fs.IsDirectoryExists(STRL("res://textures/ui")));
+			CHECK(!fs.IsDirectoryExists(STRL("res://sounds")));
+
+			auto big = fs.OpenFile(STRL("res://textures/big.bin"), FileStream::OpenMode::ReadOnly);
+			REQUIRE(big.result == ResultCode::OK);
+			CHECK(big.value->GetLength() == 1000);
+			big.value->SetPosition(999);
+			CHECK(big.value->ReadByte() == (byte)999);
+			auto mapped = fs.MapFile(STRL("res://textures/big.bin"));
+			REQUIRE(mapped.result == ResultCode::OK);
+			CHECK(((uintptr_t)mapped.value->GetSpan().data) % 64 == 0);
+
+			CHECK(fs.OpenFile(STRL("res://readme.txt"), FileStream::OpenMode::ReadOnly).value->ReadAllText() == STRL("hello"));
+			CHECK(fs.OpenFile(STRL("res://empty.bin"), FileStream::OpenMode::ReadOnly).value->GetLength() == 0);
+			CHECK(fs.OpenFile(STRL("res://missing.bin"), FileStream::OpenMode::ReadOnly).result == ResultCode::NotFound);
+			CHECK(fs.OpenFile(STRL("res://readme.txt"), FileStream::OpenMode::WriteTruncate).result == ResultCode::NoPermission);
+			CHECK(fs.RemoveFile(STRL("res://readme.txt")) == ResultCode::NoPermission);
+
+			List<String> files{};
+			CHECK(fs.GetAllFiles(STRL("res://"), files) == ResultCode::OK);
+			CHECK(files.GetCount() == 2);
+			List<String> directories{};
+			CHECK(fs.GetAllDirectories(STRL("res://textures"), directories) == ResultCode::OK);
+			REQUIRE(directories.GetCount() == 1);
+			CHECK(directories[0] == STRL("textures/ui"));
+		}
+		FileSystem fs;
+		CHECK(fs.RemoveFile(path) == ResultCode::OK);
+	}
+
+	TEST_CASE("Cache") {
+		FileSystem fs;
+		auto native = static_cast<FileProtocolNative*>(fs.GetProtocolHandler(FileProtocol::Protocol::Native));
+		REQUIRE(native != nullptr);
+		native->SetCacheEnabled(true);
+		CHECK(native->IsCacheEnabled());
+
+		FilePath directory = fs.ParsePath(STRL("file://CacheTest"));
+		FilePath file = fs.ParsePath(STRL("file://CacheTest/file.txt"));
+		REQUIRE(file.IsValid());
+		CHECK(file.GetProtocol() == FileProtocol::Protocol::Native);
+		CHECK(file.GetHandlerPath() == STRL("CacheTest/file.txt"));
+		CHECK(!fs.ParsePath(STRL("none://CacheTest")).IsValid());
+
+		fs.RemoveDirectory(directory);
+		CHECK(!fs.IsDirectoryExists(directory));
+		CHECK(fs.CreateDirectory(directory) == ResultCode::OK);
+		CHECK(fs.IsDirectoryExists(directory));
+		CHECK(!fs.IsFileExists(file));
+		CHECK(fs.OpenFile(file, FileStream::OpenMode::ReadOnly).result == ResultCode::NotFound);
+
+		fs.OpenFile(file, FileStream::OpenMode::WriteTruncate).value->Close();
+		CHECK(fs.IsFileExists(file));
+		List<String> files{};
+		CHECK(fs.GetAllFiles(directory, files) == ResultCode::OK);
+		CHECK(files.GetCount() == 1);
+
+		// Changed behind the back of the protocol, the OS tells.
+		std::remove("CacheTest/file.txt");
+		CHECK(!fs.IsFileExists(file));
+		files.Clear();
+		CHECK(fs.GetAllFiles(directory, files) == ResultCode::OK);
+		CHECK(files.GetCount() == 0);
+
+		CHECK(fs.RemoveDirectory(directory) == ResultCode::OK);
+		CHECK(!fs.IsDirectoryExists(directory));
+		native->SetCacheEnabled(false);
+		CHECK(!native->IsCacheEnabled());
+	}
+
+	TEST_CASE("Glob") {
+		CHECK(Glob::Match("*.png", "icon.png"));
+		CHECK(!Glob::Match("*.png", "ui/icon.png"));
+		CHECK(!Glob::Match("*.png", "icon.png.bak"));
+		CHECK(Glob::Match("**/*.png", "icon.png"));
+		CHECK(Glob::Match("**/*.png", "textures/ui/icon.png"));
+		CHECK(Glob::Match("textures/**", "textures/ui/icon.png"));
+		CHECK(Glob::Match("icon?.[pj]ng", "icon2.jng"));
+		CHECK(!Glob::Match("icon?.[!pj]ng", "icon2.png"));
+		CHECK(Glob::Match("[a-c]*", "banana"));
+		CHECK(Glob::Match("\\*", "*"));
+		CHECK(!Glob::Match("\\*", "a"));
+		CHECK(Glob::Match("?", "\u00e9"));
+		CHECK(Glob::Match("[oops", "[oops"));
+		CHECK(Glob::HasSeparator("a/*"));
+	}
+
+	TEST_CASE("Enumerate") {
+		FileSystem fs;
+		String root = STRL("file://EnumerateTest");
+		fs.RemoveDirectory(root);
+		REQUIRE(fs.CreateDirectory(STRL("file://EnumerateTest/a/b")) == ResultCode::OK);
+		REQUIRE(fs.CreateDirectory(STRL("file://EnumerateTest/c")) == ResultCode::OK);
+		const char* files[] = { "top.txt", "a/one.png", "a/b/two.png", "a/b/three.txt", "c/four.png" };
+		for (const char* file : files) {
+			auto r = fs.OpenFile(STRL("file://EnumerateTest/") + String((const u8char*)file), FileStream::OpenMode::WriteTruncate);
+			REQUIRE(r.result == ResultCode::OK);
+			r.value->WriteText(String((const u8char*)file));
+			r.value->Close();
+		}
+
+		auto find = [](const FileEntryList& list, std::string_view name) {
+			for (int32 i = 0; i < list.GetCount(); i += 1) {
+				if (list.GetName(i) == name) {
+					return i;
+				}
+			}
+			return -1;
+		};
+
+		JobSystem js{};
+		js.Start();
+		for (JobSystem* jobSystem : { (JobSystem*)nullptr, &js }) {
+			FileEnumerateConfig config{};
+			config.jobSystem = jobSystem;
+			FileEntryList all{};
+			REQUIRE(fs.Enumerate(root, config, all) == ResultCode::OK);
+			CHECK(all.GetCount() == 8);
+			int32 two = find(all, "a/b/two.png");
+			REQUIRE(two >= 0);
+			CHECK(all[two].type == FileEntry::Type::File);
+			CHECK(all[two].size == 11);
+			CHECK(all[two].modifiedTime > 0);
+			int32 b = find(all, "a/b");
+			REQUIRE(b >= 0);
+			CHECK(all[b].type == FileEntry::Type::Directory);
+			CHECK(all.GetPath(b) == STRL("a/b"));
+
+			config.filter = STRL("*.png");
+			config.includeDirectories = false;
+			FileEntryList png{};
+			REQUIRE(fs.Enumerate(root, config, png) == ResultCode::OK);
+			CHECK(png.GetCount() == 3);
+			CHECK(find(png, "c/four.png") >= 0);
+
+			config.filter = STRL("a/**");
+			config.recursive = false;
+			FileEntryList shallow{};
+			REQUIRE(fs.Enumerate(root, config, shallow) == ResultCode::OK);
+			CHECK(shallow.GetCount() == 0);
+		}
+		js.Stop();
+
+		FileEntryList missing{};
+		CHECK(fs.Enumerate(STRL("file://EnumerateMissing"), FileEnumerateConfig(), missing) == ResultCode::NotFound);
+		CHECK(fs.Enumerate(STRL("res://"), FileEnumerateConfig(), missing) == ResultCode::NotSupported);
+		fs.RemoveDirectory(root);
+	}
+
+	TEST_CASE("Watcher") {
+		FileSystem fs;
+		String root = STRL("file://WatcherTest");
+		fs.RemoveDirectory(root);
+		REQUIRE(fs.CreateDirectory(root) == ResultCode::OK);
+
+		FileWatcher watcher(&fs);
+		CHECK(watcher.Watch(STRL("file://WatcherMissing")).result == ResultCode::NotFound);
+		CHECK(watcher.Watch(STRL("res://")).result == ResultCode::NotSupported);
+		auto watch = watcher.Watch(root);
+		REQUIRE(watch.result == ResultCode::OK);
+		CHECK(watcher.GetWatchCount() == 1);
+		watcher.SetDebounceTime(0);
+
+		auto write = [&fs](const String& path) {
+			auto r = fs.OpenFile(path, FileStream::OpenMode::WriteTruncate);
+			REQUIRE(r.result == ResultCode::OK);
+			r.value->WriteText(path);
+			r.value->Close();
+		};
+		auto find = [](const List<FileChange>& changes, const String& path) -> const FileChange* {
+			for (const FileChange& change : changes) {
+				if (change.path == path) {
+					return &change;
+				}
+			}
+			return nullptr;
+		};
+
+		// Created then written is reported once, as added.
+		String file = STRL("file://WatcherTest/file.txt");
+		write(file);
+		write(file);
+		List<FileChange> changes{};
+		watcher.Update(changes);
+		REQUIRE(changes.GetCount() == 1);
+		CHECK(changes[0].kind == FileChange::Kind::Added);
+		CHECK(changes[0].path == file);
+		CHECK(changes[0].watch == watch.value);
+		CHECK(!changes[0].directory);
+
+		changes.Clear();
+		write(file);
+		watcher.Update(changes);
+		REQUIRE(changes.GetCount() == 1);
+		CHECK(changes[0].kind == FileChange::Kind::Modified);
+
+		// Came and went, nothing to tell.
+		changes.Clear();
+		write(STRL("file://WatcherTest/temporary.txt"));
+		fs.RemoveFile(STRL("file://WatcherTest/temporary.txt"));
+		watcher.Update(changes);
+		CHECK(changes.GetCount() == 0);
+
+		// The files of a new directory are reported, and the directory is watched from then on.
+		REQUIRE(fs.CreateDirectory(STRL("file://WatcherTest/sub")) == ResultCode::OK);
+		write(STRL("file://WatcherTest/sub/early.txt"));
+		watcher.Update(changes);
+		const FileChange* sub = find(changes, STRL("file://WatcherTest/sub"));
+		REQUIRE(sub != nullptr);
+		CHECK(sub->kind == FileChange::Kind::Added);
+		CHECK(sub->directory);
+		REQUIRE(find(changes, STRL("file://WatcherTest/sub/early.txt")) != nullptr);
+		changes.Clear();
+		fs.RemoveFile(STRL("file://WatcherTest/sub/early.txt"));
+		watcher.Update(changes);
+		REQUIRE(changes.GetCount() == 1);
+		CHECK(changes[0].kind == FileChange::Kind::Removed);
+		CHECK(changes[0].path == STRL("file://WatcherTest/sub/early.txt"));
+
+		// Held back while the debounce time lasts.
+		changes.Clear();
+		watcher.SetDebounceTime(60000);
+		write(file);
+		watcher.Update(changes);
+		CHECK(changes.GetCount() == 0);
+		CHECK(watcher.GetPendingCount() == 1);
+
+		watcher.Unwatch(watch.value);
+		CHECK(watcher.GetWatchCount() == 0);
+		CHECK(watcher.GetPendingCount() == 0);
+		fs.RemoveDirectory(root);
 	}
 }
@@ -2,6 +2,11 @@
 #include "Engine/System/Memory/Memory.h"
 #include "Engine/System/Memory/SharedPtr.h"
 #include "Engine/System/Memory/CopyOnWrite.h"
+#include "Engine/System/Memory/FrameAllocator.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Memory/PoolAllocator.h"
+#include "Engine/System/Memory/MemoryTracker.h"
+#include <thread>
 #include "MemoryObject.h"
 using namespace Engine;
 
@@ -52,6 +57,44 @@ TEST_SUITE("Memory"){
 		SharedPtr<Base> b{ d };
 	}
 
+	TEST_CASE("SharedPtr single allocation") {
+		struct Tracked {
+			Tracked(int32* destructions) :destructions(destructions) {}
+			~Tracked() {
+				*destructions += 1;
+			}
+			int32* destructions;
+			int64 payload = 7;
+		};
+		struct alignas(64) Wide {
+			int32 value = 5;
+		};
+
+		MemoryTracker::SetEnabled(true);
+		uint64 before = MemoryTracker::GetStats(MemoryTag::General).totalCount;
+		int32 destructions = 0;
+		{
+			SharedPtr<Tracked> a = SharedPtr<Tracked>::Create(&destructions);
+			CHECK(MemoryTracker::GetStats(MemoryTag::General).totalCount == before + 1);
+			SharedPtr<Tracked> b = a;
+			CHECK(a.GetReferenceCount() == 2);
+			CHECK(b->payload == 7);
+		}
+		MemoryTracker::SetEnabled(false);
+		CHECK(destructions == 1);
+
+		// Adopted pointers still work.
+		{
+			SharedPtr<Tracked> adopted{ MEMNEW(Tracked(&destructions)) };
+			CHECK(adopted.GetReferenceCount() == 1);
+		}
+		CHECK(destructions == 2);
+
+		auto wide = SharedPtr<Wide>::Create();
+		CHECK(((sizeint)wide.GetRaw() & 63) == 0);
+		CHECK(wide->value == 5);
+	}
+
 	TEST_CASE("CopyOnWrite") {
 		using Type = CopyOnWrite<MemoryObject>;
 		Type a = Type::Create();
@@ -74,4 +117,185 @@ TEST_SUITE("Memory"){
 		CHECK(!b.IsExclusive());
 		CHECK(c.IsExclusive());
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("FrameAllocator") {
+		FrameAllocator::Reset();
+		CHECK(FrameAllocator::GetUsedSize() == 0);
+
+		int32* value = FrameAllocator::New<int32>(42);
+		CHECK(*value == 42);
+		void* aligned = FrameAllocator::Allocate(16, 64);
+		CHECK(((sizeint)aligned & 63) == 0);
+		int64* array = FrameAllocator::NewArray<int64>(8);
+		for (int32 i = 0; i < 8; i += 1) {
+			CHECK(array[i] == 0);
+		}
+
+		// Larger than a block, the next frame gets everything in one block.
+		FrameAllocator::Allocate(FrameAllocator::DefaultBlockSize * 2);
+		sizeint capacity = FrameAllocator::GetCapacity();
+		CHECK(capacity > FrameAllocator::DefaultBlockSize * 2);
+
+		uint64 frame = FrameAllocator::GetFrame();
+		FrameAllocator::Reset();
+		CHECK(FrameAllocator::GetFrame() == frame + 1);
+		CHECK(FrameAllocator::GetUsedSize() == 0);
+		CHECK(FrameAllocator::GetCapacity() == capacity);
+
+		// Memory is reused after reset.
+		int32* reused = FrameAllocator::New<int32>(7);
+		CHECK(*reused == 7);
+		CHECK(FrameAllocator::GetCapacity() == capacity);
+
+		// Containers living in the frame.
+		List<int32> list(0, FrameAllocator::GetAllocator());
+		for (int32 i = 0; i < 100; i += 1) {
+			list.Add(i);
+		}
+		CHECK(list.Get(99) == 99);
+		CHECK(FrameAllocator::GetUsedSize() > 100 * sizeof(int32));
+	}
+
+	TEST_CASE("PoolAllocator") {
+		CHECK(PoolAllocator::GetSizeClass(1) == 0);
+		CHECK(PoolAllocator::GetSizeClass(16) == 0);
+		CHECK(PoolAllocator::GetSizeClass(17) == 1);
+		CHECK(PoolAllocator::GetSizeClass(PoolAllocator::MaxBlockSize) == PoolAllocator::ClassCount - 1);
+		CHECK(PoolAllocator::GetSizeClass(PoolAllocator::MaxBlockSize + 1) == -1);
+		for (int32 i = 0; i < PoolAllocator::ClassCount; i += 1) {
+			sizeint size = PoolAllocator::GetBlockSize(i);
+			CHECK(size % 16 == 0);
+			CHECK(PoolAllocator::GetSizeClass(size) == i);
+		}
+
+		// Growing from pooled blocks up to the system keeps the content.
+		byte* ptr = (byte*)Memory::Allocate(8);
+		CHECK(((sizeint)ptr & 15) == 0);
+		CHECK(Memory::GetAllocationSize(ptr) == 8);
+		for (int32 i = 0; i < 8; i += 1) {
+			ptr[i] = (byte)i;
+		}
+		ptr = (byte*)Memory::Reallocate(ptr, 500);
+		ptr = (byte*)Memory::Reallocate(ptr, 4000);
+		CHECK(Memory::GetAllocationSize(ptr) == 4000);
+		for (int32 i = 0; i < 8; i += 1) {
+			CHECK(ptr[i] == (byte)i);
+		}
+		ptr = (byte*)Memory::Reallocate(ptr, 8);
+		CHECK(ptr[7] == 7);
+		Memory::Deallocate(ptr);
+
+		// Blocks can be freed on other threads.
+		static constexpr int32 Count = 1000;
+		int32* blocks[Count];
+		for (int32 i = 0; i < Count; i += 1) {
+			blocks[i] = MEMNEW(int32(i));
+		}
+		std::thread([&blocks]() {
+			for (int32 i = 0; i < Count; i += 1) {
+				CHECK(*blocks[i] == i);
+				MEMDEL(blocks[i]);
+			}
+		}).join();
+
+		// Many at once, more than the thread caches, each freed on its own.
+		void* many[Count];
+		Memory::AllocateMany(24, Count, many);
+		for (int32 i = 0; i < Count; i += 1) {
+			CHECK(((sizeint)many[i] & 15) == 0);
+			CHECK(Memory::GetAllocationSize(many[i]) == 24);
+			for (int32 j = 0; j < i; j += 97) {
+				CHECK(many[j] != many[i]);
+			}
+		}
+		for (void* block : many) {
+			Memory::Deallocate(block);
+		}
+		Memory::AllocateMany(4000, 2, many);
+		CHECK(Memory::GetAllocationSize(many[1]) == 4000);
+		Memory::Deallocate(many[0]);
+		Memory::Deallocate(many[1]);
+	}
+
+	TEST_CASE("MemoryTracker") {
+		MemoryTracker::SetEnabled(true);
+		MemoryTagStats before = MemoryTracker::GetStats(MemoryTag::Node);
+		uint64 serial = MemoryTracker::GetSerial();
+
+		void* tagged = nullptr;
+		int32* scoped = nullptr;
+		{
+			Memory::TagScope scope{ MemoryTag::Node };
+			CHECK(Memory::GetCurrentTag() == MemoryTag::Node);
+			scoped = MEMNEW(int32(1));
+			tagged = Memory::Allocate(2000, MemoryTag::Resource);
+		}
+		CHECK(Memory::GetCurrentTag() == MemoryTag::General);
+		CHECK(Memory::GetAllocationTag(scoped) == MemoryTag::Node);
+		CHECK(Memory::GetAllocationTag(tagged) == MemoryTag::Resource);
+		CHECK(((sizeint)scoped & 15) == 0);
+
+		MemoryTagStats during = MemoryTracker::GetStats(MemoryTag::Node);
+		CHECK(during.bytes == before.bytes + sizeof(int32));
+		CHECK(during.count == before.count + 1);
+		CHECK(during.peakBytes >= during.bytes);
+		CHECK(MemoryTracker::DumpLiveAllocations(serial) == 2);
+
+		// Growing keeps the tag.
+		tagged = Memory::Reallocate(tagged, 4000);
+		CHECK(Memory::GetAllocationTag(tagged) == MemoryTag::Resource);
+
+		MemoryTracker::SetBudget(MemoryTag::Node, 1);
+		CHECK(MemoryTracker::GetStats(MemoryTag::Node).budget == 1);
+		MemoryTracker::SetBudget(MemoryTag::Node, 0);
+
+		MEMDEL(scoped);
+		Memory::Deallocate(tagged);
+		MemoryTagStats after = MemoryTracker::GetStats(MemoryTag::Node);
+		CHECK(after.bytes == before.bytes);
+		CHECK(after.count == before.count);
+		CHECK(MemoryTracker::DumpLiveAllocations(serial) == 0);
+
+		// Freeing tracked memory after disabling still balances the counters.
+		int32* late = MEMNEW(int32(2));
+		MemoryTracker::SetEnabled(false);
+		MEMDEL(late);
+		CHECK(MemoryTracker::GetStats(MemoryTag::General).count >= 0);
+	}
+
+	TEST_CASE("Aligned allocation") {
+		struct alignas(64) CacheLine {
+			int32 value = 3;
+		};
+		struct alignas(32) Simd {
+			float values[8];
+		};
+
+		for (sizeint alignment : { (sizeint)16, (sizeint)64, (sizeint)256, (sizeint)4096 }) {
+			byte* ptr = (byte*)Memory::AllocateAligned(100, alignment);
+			CHECK(((sizeint)ptr & (alignment - 1)) == 0);
+			ptr[0] = 42;
+			// Growing keeps both the alignment and the content, through the pools and the system.
+			ptr = (byte*)Memory::Reallocate(ptr, 5000);
+			CHECK(((sizeint)ptr & (alignment - 1)) == 0);
+			CHECK(ptr[0] == 42);
+			Memory::Deallocate(ptr);
+		}
+
+		CacheLine* line = MEMNEW(CacheLine);
+		CHECK(((sizeint)line & 63) == 0);
+		CHECK(line->value == 3);
+		MEMDEL(line);
+
+		Simd* array = MEMNEWARR(Simd, 5);
+		CHECK(((sizeint)array & 31) == 0);
+		CHECK(Memory::GetHeapArrayElementCount(array) == 5);
+		MEMDELARR(array);
+
+		List<CacheLine> list{};
+		for (int32 i = 0; i < 20; i += 1) {
+			list.Add(CacheLine());
+			CHECK(((sizeint)list.GetRawElementPtr() & 63) == 0);
+		}
+	}
+}
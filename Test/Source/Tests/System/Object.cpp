@@ -1,5 +1,8 @@
 #include "doctest.h"
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/Object/ObjectRegistry.h"
+#include "Engine/System/Object/DeferredCallQueue.h"
+#include <thread>
 
 using namespace Engine;
 
@@ -20,6 +23,23 @@ public:
 	int32 value = 0;
 };
 
+class ChainHandler :public ManualObject {
+	REFLECTION_CLASS(::ChainHandler, ::Engine::ManualObject) {
+		REFLECTION_METHOD(STRL("OnChain"), ChainHandler::OnChain, { STRL("value") }, {});
+	}
+public:
+	// Queues itself again with a smaller value until it reaches 0.
+	void OnChain(int32 v) {
+		count += 1;
+		if (v > 0) {
+			Variant next = v - 1;
+			const Variant* args[] = { &next };
+			DeferredCallQueue::GetCurrent().Push(Invokable(this, STRL("OnChain")), args, 1);
+		}
+	}
+	int32 count = 0;
+};
+
 TEST_CASE("Object") {
 	String signame = STRL("TestSignal");
 	String recvname = STRL("OnTestSignal");
@@ -59,4 +79,180 @@ TEST_CASE("Object") {
 	CHECK(hd1->value == 2);
 	CHECK(hd2->value == 3);
 	CHECK(hd3->value == 2);
+
+	// Methods are resolved when connecting.
+	CHECK(sig->ConnectSignal(signame, Invokable(hd2.GetRaw(), STRL("SB"))) == ResultCode::NotFound);
+	CHECK(sig->ConnectSignal(signame, Invokable(hd1.GetRaw(), recvname)) == ResultCode::AlreadyExists);
+	CHECK(!sig->DisconnectSignal(signame, Invokable(hd2.GetRaw(), recvname)));
+
+	// Connections to destroyed objects are dropped while emitting, the others still run.
+	Invokable gone(hd1.GetRaw(), recvname);
+	hd1.Reset();
+	v = 1;
+	CHECK(sig->EmitSignal(signame, (const Variant**)args, 1));
+	CHECK(hd3->value == 3);
+	CHECK(!sig->IsSignalConnected(signame, gone));
+}
+
+TEST_CASE("Deferred signals") {
+	DeferredCallQueue& queue = DeferredCallQueue::GetCurrent();
+	queue.Clear();
+
+	StringName signame = STRL("TestSignal");
+	StringName recvname = STRL("OnTestSignal");
+	UniquePtr<SignalTest> sig = UniquePtr<SignalTest>::Create();
+	UniquePtr<SignalHandler> deferred = UniquePtr<SignalHandler>::Create();
+	UniquePtr<SignalHandler> once = UniquePtr<SignalHandler>::Create();
+	CHECK(sig->ConnectSignal(signame, Invokable(deferred.GetRaw(), recvname), ReflectionSignal::ConnectFlag::Deferred) == ResultCode::OK);
+	CHECK(sig->ConnectSignal(signame, Invokable(once.GetRaw(), recvname), ReflectionSignal::ConnectFlag::Once) == ResultCode::OK);
+
+	Variant v = 3;
+	const Variant* args[] = { &v };
+	CHECK(sig->EmitSignal(signame, args, 1));
+	CHECK(deferred->value == 0);
+	CHECK(once->value == 3);
+	CHECK(!sig->IsSignalConnected(signame, Invokable(once.GetRaw(), recvname)));
+
+	SUBCASE("Flush") {
+		CHECK(queue.GetCount() == 1);
+		CHECK(queue.Flush() == 1);
+		CHECK(deferred->value == 3);
+		CHECK(queue.GetCount() == 0);
+		CHECK(queue.Flush() == 0);
+		CHECK(once->value == 3);
+	}
+	SUBCASE("Coalescing") {
+		// Equal arguments are coalesced, different ones are kept.
+		CHECK(sig->EmitSignal(signame, args, 1));
+		CHECK(queue.GetCount() == 1);
+		v = 5;
+		CHECK(sig->EmitSignal(signame, args, 1));
+		v = 3;
+		CHECK(sig->EmitSignal(signame, args, 1));
+		CHECK(queue.GetCount() == 2);
+		CHECK(queue.Flush() == 2);
+		CHECK(deferred->value == 8);
+	}
+	SUBCASE("Gone target") {
+		deferred.Reset();
+		CHECK(queue.Flush() == 0);
+		CHECK(queue.GetCount() == 0);
+	}
+	SUBCASE("Queued while flushing") {
+		queue.Clear();
+		UniquePtr<ChainHandler> chain = UniquePtr<ChainHandler>::Create();
+		Variant start = 2;
+		const Variant* chainArgs[] = { &start };
+		CHECK(queue.Push(Invokable(chain.GetRaw(), STRL("OnChain")), chainArgs, 1));
+		CHECK(!queue.Push(Invokable(chain.GetRaw(), STRL("OnChain")), chainArgs, 1));
+
+		CHECK(queue.Flush() == 1);
+		CHECK(chain->count == 1);
+		CHECK(queue.GetCount() == 1);
+		CHECK(queue.Flush() == 1);
+		CHECK(queue.Flush() == 1);
+		CHECK(chain->count == 3);
+		CHECK(queue.Flush() == 0);
+	}
+	queue.Clear();
+}
+
+class PooledObject :public ManualObject {
+	REFLECTION_CLASS(::PooledObject, ::Engine::ManualObject) {}
+public:
+	void SetInstanceId(const InstanceId& id) {
+		instanceId = id;
+	}
+};
+
+TEST_CASE("Object registry") {
+	int32 count = ObjectRegistry::GetCount();
+
+	SignalHandler* a = MEMNEW(SignalHandler);
+	InstanceId idA = a->GetInstanceId();
+	CHECK(idA.IsValid());
+	CHECK(!idA.IsReferenced());
+	CHECK(idA.GetGeneration() > 0);
+	CHECK(Object::GetInstance(idA) == a);
+	CHECK(ObjectRegistry::GetCount() == count + 1);
+
+	// The slot is reused, but the old id stays invalid.
+	MEMDEL(a);
+	CHECK(!Object::IsInstanceValid(idA));
+	CHECK(Object::GetInstance(idA) == nullptr);
+	UniquePtr<SignalHandler> b = UniquePtr<SignalHandler>::Create();
+	InstanceId idB = b->GetInstanceId();
+	CHECK(idB.GetIndex() == idA.GetIndex());
+	CHECK(idB != idA);
+	CHECK(!Object::IsInstanceValid(idA));
+	CHECK(Object::GetInstance(idB) == b.GetRaw());
+
+	CHECK(Object::GetInstance(InstanceId()) == nullptr);
+	CHECK(Object::GetInstance(InstanceId::Compose(0x7FFFFFF0, 1, false)) == nullptr);
+
+	// Objects created and destroyed from several threads at once.
+	std::thread threads[4];
+	bool correct[4]{};
+	for (int32 t = 0; t < 4; t += 1) {
+		threads[t] = std::thread([&correct, t]() {
+			correct[t] = true;
+			for (int32 i = 0; i < 1000; i += 1) {
+				SignalHandler* handler = MEMNEW(SignalHandler);
+				InstanceId id = handler->GetInstanceId();
+				if (Object::GetInstance(id) != handler) {
+					correct[t] = false;
+				}
+				MEMDEL(handler);
+				if (Object::IsInstanceValid(id)) {
+					correct[t] = false;
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (bool result : correct) {
+		CHECK(result);
+	}
+	CHECK(ObjectRegistry::GetCount() == count + 1);
+
+	// Objects outliving their thread, over several blocks of slots, destroyed by another thread.
+	constexpr int32 handedCount = ObjectRegistry::BlockSize * 3;
+	SignalHandler* handed[handedCount]{};
+	std::thread creator([&handed]() {
+		for (auto& handler : handed) {
+			handler = MEMNEW(SignalHandler);
+		}
+	});
+	creator.join();
+	CHECK(ObjectRegistry::GetCount() == count + 1 + handedCount);
+	std::thread destroyer([&handed]() {
+		for (auto handler : handed) {
+			MEMDEL(handler);
+		}
+	});
+	destroyer.join();
+	CHECK(ObjectRegistry::GetCount() == count + 1);
+
+	// Ids given up and registered again in batches, as pools do.
+	PooledObject pooled[3];
+	InstanceId oldIds[3];
+	for (int32 i = 0; i < 3; i += 1) {
+		oldIds[i] = pooled[i].GetInstanceId();
+	}
+	ObjectRegistry::UnregisterMany(oldIds, 3);
+	CHECK(ObjectRegistry::GetCount() == count + 1);
+	for (InstanceId id : oldIds) {
+		CHECK(!Object::IsInstanceValid(id));
+	}
+	Object* objects[3]{ &pooled[0], &pooled[1], &pooled[2] };
+	InstanceId newIds[3];
+	ObjectRegistry::RegisterMany(objects, 3, false, newIds);
+	CHECK(ObjectRegistry::GetCount() == count + 4);
+	for (int32 i = 0; i < 3; i += 1) {
+		CHECK(newIds[i] != oldIds[i]);
+		CHECK(Object::GetInstance(newIds[i]) == &pooled[i]);
+		pooled[i].SetInstanceId(newIds[i]);
+	}
 }
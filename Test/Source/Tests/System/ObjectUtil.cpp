@@ -0,0 +1,65 @@
+#include "doctest.h"
+#include "Engine/System/Object/ObjectUtil.h"
+#include <limits>
+
+using namespace Engine;
+
+TEST_SUITE("ObjectUtil") {
+	TEST_CASE("ToString") {
+		CHECK(ObjectUtil::ToString(0) == STRL("0"));
+		CHECK(ObjectUtil::ToString(-114514) == STRL("-114514"));
+		CHECK(ObjectUtil::ToString(std::numeric_limits<int64>::min()) == STRL("-9223372036854775808"));
+		CHECK(ObjectUtil::ToString(std::numeric_limits<uint64>::max()) == STRL("18446744073709551615"));
+		CHECK(ObjectUtil::ToString((byte)255) == STRL("255"));
+		CHECK(ObjectUtil::ToString((sbyte)-128) == STRL("-128"));
+		CHECK(ObjectUtil::ToString(true) == STRL("True"));
+
+		// Shortest form that reads back the same.
+		CHECK(ObjectUtil::ToString(1.5) == STRL("1.5"));
+		CHECK(ObjectUtil::ToString(0.1) == STRL("0.1"));
+		CHECK(ObjectUtil::ToString(0.1f) == STRL("0.1"));
+		CHECK(ObjectUtil::ToString(-2.0) == STRL("-2"));
+		CHECK(ObjectUtil::ToString(1e300) == STRL("1e+300"));
+		CHECK(ObjectUtil::ToString(1.0).IsSmall());
+	}
+	TEST_CASE("ToChars") {
+		u8char buffer[ObjectUtil::MaxNumberChars];
+		int32 count = ObjectUtil::ToChars(-12345, buffer, ObjectUtil::MaxNumberChars);
+		CHECK(std::string_view((char*)buffer, count) == "-12345");
+		CHECK(ObjectUtil::ToChars(-12345, buffer, 3) == -1);
+
+		count = ObjectUtil::ToChars(std::numeric_limits<double>::lowest(), buffer, ObjectUtil::MaxNumberChars);
+		REQUIRE(count > 0);
+		double back = 0;
+		CHECK(ObjectUtil::FromChars(std::string_view((char*)buffer, count), back));
+		CHECK(back == std::numeric_limits<double>::lowest());
+
+		// Round trip through the shortest form.
+		for (double value : { 0.3, 1.0 / 3.0, 123456789.125, 5e-324, 2.2250738585072014e-308 }) {
+			count = ObjectUtil::ToChars(value, buffer, ObjectUtil::MaxNumberChars);
+			REQUIRE(count > 0);
+			CHECK(ObjectUtil::FromChars(std::string_view((char*)buffer, count), back));
+			CHECK(back == value);
+		}
+	}
+	TEST_CASE("FromChars") {
+		int64 i = 7;
+		CHECK(ObjectUtil::FromChars("-42", i));
+		CHECK(i == -42);
+		CHECK(!ObjectUtil::FromChars("42abc", i));
+		CHECK(!ObjectUtil::FromChars("", i));
+		CHECK(!ObjectUtil::FromChars("99999999999999999999", i));
+		CHECK(i == -42);
+
+		int32 small = 0;
+		CHECK(!ObjectUtil::FromChars("3000000000", small));
+		uint32 big = 0;
+		CHECK(ObjectUtil::FromChars("3000000000", big));
+		CHECK(big == 3000000000u);
+
+		double d = 0;
+		CHECK(ObjectUtil::FromChars("2.5e3", d));
+		CHECK(d == 2500.0);
+		CHECK(!ObjectUtil::FromChars("2.5 ", d));
+	}
+}
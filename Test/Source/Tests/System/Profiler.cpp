@@ -0,0 +1,227 @@
+#include "doctest.h"
+#include "Engine/System/Profiler.h"
+#include "Engine/System/ProfileTraceExporter.h"
+#include "Engine/System/File/FileSystem.h"
+#include <mutex>
+#include <thread>
+
+using namespace Engine;
+
+namespace ProfilerTest {
+	/// @brief Always looks taken, so locking it counts as waiting.
+	struct BusyMutex {
+		bool try_lock() {
+			return false;
+		}
+		void lock() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		void unlock() {}
+	};
+}
+using ProfilerTest::BusyMutex;
+
+TEST_SUITE("Profiler") {
+	TEST_CASE("Frame aggregates") {
+		Profiler::SetEnabled(true);
+		Profiler::BeginFrame();
+		Profiler::EndFrame();
+		uint64 firstIndex = Profiler::GetLastFrame().index;
+
+		Profiler::BeginFrame();
+		{
+			PROFILE_SCOPE("ProfilerTest::Outer");
+			for (int32 i = 0; i < 3; i += 1) {
+				PROFILE_SCOPE("ProfilerTest::Inner");
+			}
+		}
+		std::thread worker([]() {
+			PROFILE_SCOPE("ProfilerTest::Inner");
+		});
+		worker.join();
+		Profiler::EndFrame();
+
+		const ProfileFrame& frame = Profiler::GetLastFrame();
+		CHECK(frame.index == firstIndex + 1);
+		CHECK(frame.droppedEvents == 0);
+		CHECK(frame.endNanoseconds >= frame.beginNanoseconds);
+		const ProfileZoneStats* outer = frame.FindZone("ProfilerTest::Outer");
+		const ProfileZoneStats* inner = frame.FindZone("ProfilerTest::Inner");
+		REQUIRE(outer != nullptr);
+		REQUIRE(inner != nullptr);
+		CHECK(outer->count == 1);
+		// Summed over every thread.
+		CHECK(inner->count == 4);
+		CHECK(inner->maxNanoseconds <= inner->totalNanoseconds);
+		CHECK(outer->totalNanoseconds <= frame.GetDurationNanoseconds());
+		CHECK(frame.FindZone("ProfilerTest::Missing") == nullptr);
+
+		// Collected zones don't show up again.
+		Profiler::BeginFrame();
+		Profiler::EndFrame();
+		CHECK(Profiler::GetLastFrame().FindZone("ProfilerTest::Outer") == nullptr);
+
+		// Disabled zones aren't recorded.
+		Profiler::SetEnabled(false);
+		Profiler::BeginFrame();
+		{
+			PROFILE_SCOPE("ProfilerTest::Outer");
+		}
+		Profiler::EndFrame();
+		CHECK(Profiler::GetLastFrame().FindZone("ProfilerTest::Outer") == nullptr);
+	}
+
+	TEST_CASE("Dropped events") {
+		Profiler::SetEnabled(true);
+		Profiler::BeginFrame();
+		for (int32 i = 0; i < Profiler::ThreadBufferCapacity + 10; i += 1) {
+			PROFILE_SCOPE("ProfilerTest::Flood");
+		}
+		Profiler::EndFrame();
+		Profiler::SetEnabled(false);
+
+		const ProfileFrame& frame = Profiler::GetLastFrame();
+		const ProfileZoneStats* flood = frame.FindZone("ProfilerTest::Flood");
+		REQUIRE(flood != nullptr);
+		CHECK(flood->count == Profiler::ThreadBufferCapacity);
+		CHECK(frame.droppedEvents == 10);
+	}
+
+	TEST_CASE("Lock statistics") {
+		Profiler::SetEnabled(true);
+		Profiler::BeginFrame();
+		{
+			// Waits are recorded without tracking, holds aren't.
+			BusyMutex busy;
+			auto lock = ProfiledLock<BusyMutex>(busy, "ProfilerTest::Contended");
+		}
+		{
+			std::mutex mutex;
+			auto lock = ProfiledLock<std::mutex>(mutex, "ProfilerTest::Free");
+		}
+		Profiler::EndFrame();
+		const ProfileLockStats* contended = Profiler::GetLastFrame().FindLock("ProfilerTest::Contended");
+		REQUIRE(contended != nullptr);
+		CHECK(contended->contentions == 1);
+		CHECK(contended->acquisitions == 0);
+		CHECK(contended->waitNanoseconds >= 1000000);
+		CHECK(contended->maxWaitNanoseconds == contended->waitNanoseconds);
+		CHECK(contended->holdNanoseconds == 0);
+		CHECK(Profiler::GetLastFrame().FindLock("ProfilerTest::Free") == nullptr);
+		// Waits still count as zones.
+		CHECK(Profiler::GetLastFrame().FindZone("ProfilerTest::Contended") != nullptr);
+
+		Profiler::SetLockTracking(true);
+		CHECK(Profiler::IsLockTracking());
+		Profiler::BeginFrame();
+		std::mutex mutex;
+		for (int32 i = 0; i < 3; i += 1) {
+			auto lock = ProfiledLock<std::mutex>(mutex, "ProfilerTest::Free");
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::thread worker([]() {
+			BusyMutex busy;
+			auto lock = ProfiledLock<BusyMutex>(busy, "ProfilerTest::Contended");
+		});
+		worker.join();
+		Profiler::EndFrame();
+
+		const ProfileFrame& frame = Profiler::GetLastFrame();
+		const ProfileLockStats* free = frame.FindLock("ProfilerTest::Free");
+		REQUIRE(free != nullptr);
+		CHECK(free->acquisitions == 3);
+		CHECK(free->contentions == 0);
+		CHECK(free->waitNanoseconds == 0);
+		CHECK(free->holdNanoseconds >= 3000000);
+		CHECK(free->maxHoldNanoseconds <= free->holdNanoseconds);
+		// Holds aren't zones.
+		CHECK(frame.FindZone("ProfilerTest::Free") == nullptr);
+		contended = frame.FindLock("ProfilerTest::Contended");
+		REQUIRE(contended != nullptr);
+		CHECK(contended->acquisitions == 1);
+		CHECK(contended->contentions == 1);
+
+		// Tracking needs the profiler enabled.
+		Profiler::SetEnabled(false);
+		CHECK(!Profiler::IsLockTracking());
+		Profiler::SetLockTracking(false);
+		Profiler::BeginFrame();
+		{
+			auto lock = ProfiledLock<std::mutex>(mutex, "ProfilerTest::Free");
+		}
+		Profiler::EndFrame();
+		CHECK(Profiler::GetLastFrame().FindLock("ProfilerTest::Free") == nullptr);
+	}
+
+	TEST_CASE("Capture and Chrome trace") {
+		Profiler::SetEnabled(true);
+		Profiler::BeginCapture();
+		CHECK(Profiler::IsCapturing());
+
+		std::thread worker([]() {
+			Profiler::SetCurrentThreadName(STRL("Capture \"Worker\""));
+			PROFILE_SCOPE("ProfilerTest::Work");
+			BusyMutex busy;
+			auto lock = ProfiledLock<BusyMutex>(busy, "ProfilerTest::Lock");
+		});
+		worker.join();
+		{
+			PROFILE_SCOPE("ProfilerTest::Main");
+			// Not contended, not recorded.
+			std::mutex mutex;
+			auto lock = ProfiledLock<std::mutex>(mutex, "ProfilerTest::FreeLock");
+		}
+		uint64 holdBegin = Profiler::GetTimestamp();
+		Profiler::Record("ProfilerTest::Hold", holdBegin, Profiler::GetTimestamp(), ProfileEventKind::LockHold);
+		Profiler::EndCapture();
+		Profiler::SetEnabled(false);
+		CHECK(!Profiler::IsCapturing());
+
+		const ProfileCapture& capture = Profiler::GetCapture();
+		CHECK(capture.droppedEvents == 0);
+		const ProfileCaptureEvent* work = nullptr;
+		const ProfileCaptureEvent* lock = nullptr;
+		const ProfileCaptureEvent* main = nullptr;
+		bool freeLock = false;
+		for (const ProfileCaptureEvent& event : capture.events) {
+			std::string_view name = event.name;
+			if (name == "ProfilerTest::Work") {
+				work = &event;
+			} else if (name == "ProfilerTest::Lock") {
+				lock = &event;
+			} else if (name == "ProfilerTest::Main") {
+				main = &event;
+			} else if (name == "ProfilerTest::FreeLock") {
+				freeLock = true;
+			}
+		}
+		REQUIRE(work != nullptr);
+		REQUIRE(lock != nullptr);
+		REQUIRE(main != nullptr);
+		CHECK(!freeLock);
+		CHECK(lock->kind == ProfileEventKind::LockWait);
+		CHECK(lock->thread == work->thread);
+		CHECK(main->thread != work->thread);
+		CHECK(lock->beginNanoseconds >= work->beginNanoseconds);
+		CHECK(lock->endNanoseconds <= work->endNanoseconds);
+		const ProfileCaptureThread* workerThread = capture.FindThread(work->thread);
+		REQUIRE(workerThread != nullptr);
+		CHECK(workerThread->name == STRL("Capture \"Worker\""));
+
+		StringBuilder json;
+		ProfileTraceExporter::WriteChromeTrace(capture, json);
+		std::string_view text = json.GetStringView();
+		CHECK(text.starts_with("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+		CHECK(text.find("\"name\":\"thread_name\"") != std::string_view::npos);
+		CHECK(text.find("\"name\":\"Capture \\\"Worker\\\"\"") != std::string_view::npos);
+		CHECK(text.find("\"name\":\"ProfilerTest::Lock\",\"cat\":\"lock\",\"ph\":\"X\"") != std::string_view::npos);
+		CHECK(text.find("\"name\":\"ProfilerTest::Work\",\"cat\":\"zone\"") != std::string_view::npos);
+		CHECK(text.find("\"name\":\"ProfilerTest::Hold\",\"cat\":\"lock_hold\"") != std::string_view::npos);
+
+		FileSystem fs;
+		String path = STRL("file://ProfilerTrace.json");
+		CHECK(ProfileTraceExporter::ExportChromeTrace(capture, &fs, path) == ResultCode::OK);
+		CHECK(fs.IsFileExists(path));
+		fs.RemoveFile(path);
+	}
+}
@@ -1,5 +1,6 @@
 #include "doctest.h"
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/Object/PropertyBatch.h"
 
 using namespace Engine;
 TEST_SUITE("Reflection") {
@@ -21,6 +22,12 @@ TEST_SUITE("Reflection") {
 		CHECK(cMan->IsChildOf(cObj));
 		CHECK(cRef->IsChildOf(cObj));
 		CHECK(!cMan->IsChildOf(cRef));
+
+		// Registered classes are frozen.
+		CHECK(cObj->IsFrozen());
+		ReflectionClass* cObjMutable = Reflection::GetClass(u8"::Engine::Object");
+		CHECK(cObjMutable->AddSignal(SharedPtr<ReflectionSignal>::Create(STRL("late"), std::initializer_list<ReflectionSignal::ArgumentInfo>{})) == nullptr);
+		CHECK(!cObjMutable->RemoveMethod(STRL("nothing")));
 	}
 
 
@@ -55,6 +62,24 @@ TEST_SUITE("Reflection") {
 		CHECK(foo->IsConst() == true);
 	}
 
+	TEST_CASE("ReflectionMethodBind in static storage") {
+		auto a = ReflectionMethodBindHelper::CreateStatic<&Test::FuckWhy>();
+		auto b = ReflectionMethodBindHelper::CreateStatic<&Test::FuckWhy>();
+		CHECK(a.GetRaw() == b.GetRaw());
+		CHECK(a->IsConst() == true);
+		CHECK(a->GetArgumentCount() == 2);
+		CHECK(ReflectionMethodBindHelper::CreateStatic<Test::Fuck>()->IsStatic() == true);
+
+		// Dropping every handed out reference doesn't destroy the bind.
+		ReflectionMethodBind* raw = a.GetRaw();
+		uint32 count = a.GetReferenceCount();
+		a = SharedPtr<ReflectionMethodBind>();
+		b = SharedPtr<ReflectionMethodBind>();
+		auto c = ReflectionMethodBindHelper::CreateStatic<&Test::FuckWhy>();
+		CHECK(c.GetRaw() == raw);
+		CHECK(c.GetReferenceCount() == count - 1);
+	}
+
 	class Bar :public ManualObject {
 		REFLECTION_CLASS(::Bar, ::Engine::ManualObject) {
 			REFLECTION_STATIC_METHOD(STRL("SetStatic"), SetStatic, { STRL("value") }, { 114514 });
@@ -175,4 +200,269 @@ TEST_SUITE("Reflection") {
 		CHECK(prop->Get(&obj, r)==ResultCode::OK);
 		CHECK(r.AsString() == value);
 	}
-}
\ No newline at end of file
+	TEST_CASE("Class ids and member indices") {
+		ReflectionClass* cObj = Reflection::GetClass(u8"::Engine::Object");
+		ReflectionClass* cMan = Reflection::GetClass(u8"::Engine::ManualObject");
+		ReflectionClass* cBar = Reflection::GetClass(STRL("::Bar"));
+		REQUIRE(cBar != nullptr);
+
+		CHECK(Reflection::GetClass(cObj->GetId()) == cObj);
+		CHECK(Reflection::GetClass(cBar->GetId()) == cBar);
+		CHECK(Reflection::GetClassCount() > cBar->GetId());
+		CHECK(cObj->GetId() < cMan->GetId());
+		CHECK(cMan->GetId() < cBar->GetId());
+		CHECK(cBar->GetParent() == cMan);
+		CHECK(cObj->GetParent() == nullptr);
+
+		// The class of an object, without looking it up by name.
+		Bar obj;
+		CHECK(Bar::GetReflectionClassStatic() == cBar);
+		CHECK(obj.GetReflectionClass() == cBar);
+		CHECK(static_cast<Object&>(obj).GetReflectionClass() == cBar);
+		CHECK(Object::GetReflectionClassStatic() == cObj);
+
+		CHECK(cBar->GetMethodCount() == 4);
+		for (int32 i = 0; i < cBar->GetMethodCount(); i += 1) {
+			ReflectionMethod* method = cBar->GetMethodAt(i);
+			CHECK(method->GetIndex() == i);
+			CHECK(cBar->GetMethod(method->GetName()) == method);
+		}
+		ReflectionProperty* prop = cBar->GetProperty(STRL("Value"));
+		CHECK(cBar->GetPropertyCount() == 1);
+		CHECK(cBar->GetPropertyAt(prop->GetIndex()) == prop);
+	}
+	TEST_CASE("MethodHandle") {
+		ReflectionClass* cBar = Reflection::GetClass(STRL("::Bar"));
+		MethodHandle set = cBar->ResolveMethod(STRL("Set"));
+		MethodHandle get = cBar->ResolveMethod(STRL("Get"));
+		MethodHandle setStatic = cBar->ResolveMethod(STRL("SetStatic"));
+		MethodHandle getStatic = cBar->ResolveMethod(STRL("GetStatic"));
+		REQUIRE(set.IsValid());
+		CHECK(set.GetMethod() == cBar->GetMethod(STRL("Set")));
+		CHECK(!cBar->ResolveMethod(STRL("Nothing")).IsValid());
+
+		CHECK(set.HasSignature<void, String>());
+		CHECK(get.HasSignature<String>());
+		CHECK(getStatic.HasSignature<int32>());
+		CHECK(!getStatic.HasSignature<int64>());
+		CHECK(!set.HasSignature<void, int32>());
+
+		Bar obj;
+		set.PtrCall(&obj, String(u8"Native"));
+		CHECK(obj.value == STRL("Native"));
+		CHECK(get.PtrCall<String>(&obj) == STRL("Native"));
+
+		setStatic.PtrCall(nullptr, (int32)1919);
+		CHECK(getStatic.PtrCall<int32>(nullptr) == 1919);
+		CHECK(Bar::staticValue == 1919);
+
+		// The Variant path still works through the handle.
+		Variant argValue = STRL("Boxed");
+		const Variant* args[1] = { &argValue };
+		Variant returnValue;
+		CHECK(set.Invoke(&obj, args, 1, returnValue) == ResultCode::OK);
+		CHECK(obj.value == STRL("Boxed"));
+
+		// Mismatching signatures are refused instead of calling with wrong types.
+		CHECK(getStatic.PtrCall<int64>(nullptr) == 0);
+		CHECK(get.PtrCall<String>(nullptr) == String::GetEmpty());
+	}
+}
+
+namespace ReflectionInheritance {
+	class Speaker :public ManualObject {
+		REFLECTION_CLASS(::ReflectionInheritance::Speaker, ::Engine::ManualObject) {
+			REFLECTION_METHOD(STRL("Set"), Speaker::Set, { STRL("value") }, {});
+			REFLECTION_METHOD(STRL("Get"), Speaker::Get, {}, {});
+			REFLECTION_PROPERTY(STRL("Value"), STRL("Get"), STRL("Set"));
+			REFLECTION_SIGNAL(STRL("Spoken"), {});
+		}
+
+	public:
+		String value;
+		void Set(const String& value) {
+			this->value = value;
+		}
+		String Get() const {
+			return value;
+		}
+	};
+	class Shouter :public Speaker {
+		REFLECTION_CLASS(::ReflectionInheritance::Shouter, ::ReflectionInheritance::Speaker) {
+			REFLECTION_METHOD(STRL("Get"), Shouter::GetShouted, {}, {});
+			REFLECTION_METHOD(STRL("Clear"), Shouter::Clear, {}, {});
+			// The setter is inherited.
+			REFLECTION_PROPERTY(STRL("Shouted"), STRL("Get"), STRL("Set"));
+		}
+
+	public:
+		String GetShouted() const {
+			return value + STRL("!");
+		}
+		void Clear() {
+			value = String::GetEmpty();
+		}
+	};
+}
+
+TEST_SUITE("Reflection") {
+	TEST_CASE("Inherited members") {
+		ReflectionClass* cObj = Reflection::GetClass(u8"::Engine::Object");
+		ReflectionClass* cSpeaker = Reflection::GetClass(STRL("::ReflectionInheritance::Speaker"));
+		ReflectionClass* cShouter = Reflection::GetClass(STRL("::ReflectionInheritance::Shouter"));
+		REQUIRE(cShouter != nullptr);
+		CHECK(cShouter->GetParent() == cSpeaker);
+
+		// Own members are counted alone, lookups see the inherited ones.
+		CHECK(cShouter->GetMethodCount() == 2);
+		CHECK(cShouter->HasMethod(STRL("Clear")));
+		CHECK(cShouter->GetMethod(STRL("Set")) == cSpeaker->GetMethod(STRL("Set")));
+		CHECK(cShouter->GetMethod(STRL("ToString")) == cObj->GetMethod(STRL("ToString")));
+		CHECK(cSpeaker->GetMethod(STRL("ToString")) == cObj->GetMethod(STRL("ToString")));
+		CHECK(!cSpeaker->HasMethod(STRL("Clear")));
+		CHECK(cShouter->GetSignal(STRL("Spoken")) == cSpeaker->GetSignal(STRL("Spoken")));
+		CHECK(cShouter->GetProperty(STRL("Value")) == cSpeaker->GetProperty(STRL("Value")));
+		CHECK(cShouter->HasProperty(STRL("Shouted")));
+		CHECK(!cSpeaker->HasProperty(STRL("Shouted")));
+
+		// Overrides win.
+		ReflectionMethod* get = cShouter->GetMethod(STRL("Get"));
+		CHECK(get != cSpeaker->GetMethod(STRL("Get")));
+		CHECK(get == cShouter->GetMethodAt(get->GetIndex()));
+
+		ReflectionInheritance::Shouter obj;
+		Variant value = STRL("Hey");
+		const Variant* args[1] = { &value };
+		Variant result;
+		CHECK(obj.InvokeMethod(STRL("Set"), args, 1, result) == ResultCode::OK);
+		CHECK(obj.InvokeMethod(STRL("Get"), nullptr, 0, result) == ResultCode::OK);
+		CHECK(result.AsString() == STRL("Hey!"));
+		CHECK(obj.GetPropertyValue(STRL("Value"), result) == ResultCode::OK);
+		CHECK(result.AsString() == STRL("Hey"));
+		CHECK(obj.GetPropertyValue(STRL("Shouted"), result) == ResultCode::OK);
+		CHECK(result.AsString() == STRL("Hey!"));
+		CHECK(obj.InvokeMethod(STRL("ToString"), nullptr, 0, result) == ResultCode::OK);
+		CHECK(obj.HasSignal(STRL("Spoken")));
+	}
+}
+
+namespace ReflectionFields {
+	class Particle :public ManualObject {
+		REFLECTION_CLASS(::ReflectionFields::Particle, ::Engine::ManualObject) {
+			REFLECTION_FIELD(STRL("Position"), Particle::position);
+			REFLECTION_FIELD(STRL("Speed"), Particle::speed);
+			REFLECTION_METHOD(STRL("SetLabel"), Particle::SetLabel, { STRL("label") }, {});
+			REFLECTION_METHOD(STRL("GetLabel"), Particle::GetLabel, {}, {});
+			REFLECTION_PROPERTY(STRL("Label"), STRL("GetLabel"), STRL("SetLabel"));
+		}
+
+	public:
+		void SetLabel(const String& label) {
+			this->label = label;
+		}
+		String GetLabel() const {
+			return label;
+		}
+
+		Vector2 position;
+		double speed = 0;
+	private:
+		String label;
+	};
+}
+
+TEST_SUITE("Reflection") {
+	TEST_CASE("Fields and property batches") {
+		using ReflectionFields::Particle;
+		ReflectionClass* c = Particle::GetReflectionClassStatic();
+		ReflectionProperty* position = c->GetProperty(STRL("Position"));
+		REQUIRE(position != nullptr);
+		CHECK(position->GetField() != nullptr);
+		CHECK(position->GetType() == Variant::Type::Vector2);
+		CHECK(c->GetProperty(STRL("Label"))->GetField() == nullptr);
+
+		Particle a;
+		CHECK(a.SetPropertyValue(STRL("Speed"), 2.5) == ResultCode::OK);
+		CHECK(a.speed == 2.5);
+
+		PropertyBatch batch(c, { STRL("Position"), STRL("Speed"), STRL("Label") });
+		REQUIRE(batch.GetCount() == 3);
+
+		Particle b;
+		Object* objects[2] = { &a, &b };
+		Variant values[6] = { Vector2(1, 2), 3.0, STRL("A"), Vector2(4, 5), 6.0, STRL("B") };
+		CHECK(batch.SetValues(objects, 2, values) == ResultCode::OK);
+		CHECK(a.position == Vector2(1, 2));
+		CHECK(b.speed == 6.0);
+		CHECK(b.GetLabel() == STRL("B"));
+
+		List<Variant> read;
+		CHECK(batch.GetValues((const Object* const*)objects, 2, read) == ResultCode::OK);
+		REQUIRE(read.GetCount() == 6);
+		CHECK(read[0] == Vector2(1, 2));
+		CHECK(read[2] == STRL("A"));
+		CHECK(read[5] == STRL("B"));
+
+		Particle c1, c2;
+		const Object* sources[2] = { &a, &b };
+		Object* targets[2] = { &c1, &c2 };
+		CHECK(batch.Copy(sources, targets, 2) == ResultCode::OK);
+		CHECK(c1.position == Vector2(1, 2));
+		CHECK(c1.GetLabel() == STRL("A"));
+		CHECK(c2.speed == 6.0);
+
+		// Registered binds are the ones in static storage.
+		CHECK(c->GetProperty(STRL("Speed"))->GetField() == ReflectionFieldBindHelper::CreateStatic<&Particle::speed>().GetRaw());
+		CHECK(c->GetMethod(STRL("GetLabel"))->GetBind().GetRaw() == ReflectionMethodBindHelper::CreateStatic<&Particle::GetLabel>().GetRaw());
+
+		// Objects of other classes are refused.
+		ReflectionInheritance::Speaker speaker;
+		Object* wrong[1] = { &speaker };
+		CHECK(batch.SetValues(wrong, 1, values) == ResultCode::InvalidObject);
+	}
+
+	class Constructible :public ManualObject {
+		REFLECTION_CLASS(::Constructible, ::Engine::ManualObject) {
+			REFLECTION_CLASS_CONSTRUCTIBLE(Constructible);
+		}
+	public:
+		int32 value = 7;
+	};
+	class NotConstructible :public ManualObject {
+		REFLECTION_CLASS(::NotConstructible, ::Engine::ManualObject) {}
+	};
+
+	TEST_CASE("Constructors") {
+		ReflectionClass* c = Reflection::GetClass(STRL("::Constructible"));
+		Object* created = c->Instantiate();
+		REQUIRE(created != nullptr);
+		CHECK(created->GetReflectionClass() == c);
+		CHECK(static_cast<Constructible*>(created)->value == 7);
+		MEMDEL(created);
+
+		CHECK(Reflection::GetClass(STRL("::NotConstructible"))->Instantiate() == nullptr);
+		CHECK(Reflection::GetClass(STRL("::Engine::ManualObject"))->Instantiate() == nullptr);
+
+		// By id and in batches larger than a single trip to the pools.
+		created = Reflection::Instantiate(c->GetId());
+		REQUIRE(created != nullptr);
+		CHECK(created->GetReflectionClass() == c);
+		MEMDEL(created);
+		Object* batch[150]{};
+		CHECK(Reflection::InstantiateMany(c->GetId(), 150, batch) == 150);
+		for (int32 i = 0; i < 150; i += 1) {
+			REQUIRE(batch[i] != nullptr);
+			CHECK(batch[i]->GetReflectionClass() == c);
+			CHECK(static_cast<Constructible*>(batch[i])->value == 7);
+			CHECK(Object::GetInstance(batch[i]->GetInstanceId()) == batch[i]);
+		}
+		for (Object* object : batch) {
+			MEMDEL(object);
+		}
+
+		c->SetInstantiable(false);
+		CHECK(c->Instantiate() == nullptr);
+		CHECK(c->InstantiateMany(150, batch) == 0);
+		c->SetInstantiable(true);
+	}
+}
@@ -1,5 +1,6 @@
 #include "doctest.h"
 #include "Engine/System/Regex.h"
+#include <regex>
 
 using namespace Engine;
 
@@ -23,4 +24,79 @@ TEST_SUITE("Regex") {
 		CHECK(match.from == index);
 		CHECK(match.to == index+3);
 	}
+
+	TEST_CASE("Compiled") {
+		CompiledRegex regex(STRL("(\\w+)@(\\w+)\\.com"));
+		REQUIRE(regex.GetResult() == ResultCode::OK);
+		CHECK(regex.HasAutomaton());
+
+		List<Regex::MatchRange> matches{};
+		CHECK(regex.Match(STRL("mail a@b.com or cd@ef.com"), matches) == ResultCode::OK);
+		// The whole match, then each group.
+		REQUIRE(matches.GetCount() == 6);
+		CHECK(matches[0].from == 5);
+		CHECK(matches[0].to == 12);
+		CHECK(matches[2].from == 7);
+		CHECK(matches[2].to == 8);
+		CHECK(matches[3].from == 16);
+
+		// No match skips the std::regex, and still clears the results.
+		CHECK(regex.Match(STRL("nothing here"), matches) == ResultCode::OK);
+		CHECK(matches.GetCount() == 0);
+		CHECK(!regex.IsMatch(STRL("a@b.org")));
+		CHECK(regex.IsMatch(STRL("a@b.com")));
+
+		// Backreferences have no DFA, std::regex answers everything.
+		CompiledRegex backreference(STRL("(a+)b\\1"));
+		REQUIRE(backreference.GetResult() == ResultCode::OK);
+		CHECK(!backreference.HasAutomaton());
+		CHECK(backreference.IsMatch(STRL("xaabaa")));
+		CHECK(!backreference.IsMatch(STRL("xaabx")));
+
+		CompiledRegex invalid(STRL("(a"));
+		CHECK(invalid.GetResult() == ResultCode::InvalidArgument);
+	}
+
+	TEST_CASE("Same as std::regex") {
+		const char* patterns[] = {
+			"abc", "a|ab", "^abc", "abc$", "^$", "^", "$", "a*", "a+b", "a?b?c", "(ab)+c", "(?:ab|cd)*e",
+			"[a-c]+x", "[^a-c]x", "[-a]", "[a-]b", "[\\]]", "[\\d.]+", "\\d{3}", "\\w{2,}z", "x{1,3}y", "x{0,2}$",
+			"^(a|b)*$", "\\s+\\S", ".b", "a.c", "\\.", "\\x41", "^a|b$", "(a*)*b", "a*?b", "(x|)y", "colou?r",
+			"[A-Z][a-z]*\\d?", "\\D\\W", "^.{4}$", "(^a)", "\\$\\^",
+		};
+		const char* contents[] = {
+			"", "a", "ab", "abc", "xabcx", "cab", "b", "aaab", "ababc", "cdcde", "e", "dx", "-", "]", "1.5", "12", "123",
+			"wz", "abz", "xxxy", "y", "xxx", "abab", "abc ", "  q", "a\nb", "a\rc", "abc\n", ".", "A", "aab", "color", "colour",
+			"Hello5", "5!", "abcd", "\n", "$^", "line with error: 42",
+		};
+		for (const char* pattern : patterns) {
+			String source = String(std::string(pattern));
+			CompiledRegex regex(source);
+			REQUIRE(regex.GetResult() == ResultCode::OK);
+			CHECK_MESSAGE(regex.HasAutomaton(), pattern);
+			std::regex expected(pattern);
+			for (const char* content : contents) {
+				bool found = std::regex_search(content, expected);
+				CHECK_MESSAGE(regex.IsMatch(String(std::string(content))) == found, pattern, " on ", content);
+			}
+		}
+	}
+
+	TEST_CASE("Cache") {
+		int32 capacity = Regex::GetCacheCapacity();
+		Regex::SetCacheCapacity(2);
+		auto first = Regex::GetCompiled(STRL("a+"));
+		CHECK(Regex::GetCompiled(STRL("a+")).GetRaw() == first.GetRaw());
+		Regex::GetCompiled(STRL("b+"));
+		// a+ was used last, so c+ evicts b+.
+		CHECK(Regex::GetCompiled(STRL("a+")).GetRaw() == first.GetRaw());
+		auto second = Regex::GetCompiled(STRL("b+"));
+		Regex::GetCompiled(STRL("c+"));
+		CHECK(Regex::GetCompiled(STRL("b+")).GetRaw() == second.GetRaw());
+		CHECK(Regex::GetCompiled(STRL("a+")).GetRaw() != first.GetRaw());
+
+		CHECK(Regex::IsMatch(STRL("xaay"), STRL("a+")));
+		CHECK(!Regex::IsMatch(STRL("xy"), STRL("a+")));
+		Regex::SetCacheCapacity(capacity);
+	}
 }
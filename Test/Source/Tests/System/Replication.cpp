@@ -0,0 +1,179 @@
+#include "doctest.h"
+#include "Engine/System/MemoryStream.h"
+#include "Engine/System/Object/Replication.h"
+#include "Engine/System/Object/ObjectUtil.h"
+#include <cmath>
+
+using namespace Engine;
+
+namespace ReplicationTest {
+	class Unit :public ManualObject {
+		REFLECTION_CLASS(::ReplicationTest::Unit, ::Engine::ManualObject) {
+			REFLECTION_FIELD_HINT(STRL("Health"), Unit::health, ReflectionProperty::Hint::NumberRange, STRL("0,100,1"));
+			REFLECTION_FIELD_HINT(STRL("Position"), Unit::position, ReflectionProperty::Hint::NumberRange, STRL("-512,512,0.01"));
+			REFLECTION_FIELD(STRL("Score"), Unit::score);
+			REFLECTION_FIELD(STRL("Speed"), Unit::speed);
+			REFLECTION_FIELD(STRL("Alive"), Unit::alive);
+			REFLECTION_FIELD(STRL("Name"), Unit::name);
+		}
+
+	public:
+		int32 health = 0;
+		Vector2 position{};
+		int64 score = 0;
+		double speed = 0;
+		bool alive = false;
+		String name{};
+	};
+}
+
+namespace {
+	using ReplicationTest::Unit;
+
+	void SetUp(Replicator& replicator, Unit* units, int32 count) {
+		const ReflectionClass* c = Reflection::GetClass(STRL("::ReplicationTest::Unit"));
+		REQUIRE(c != nullptr);
+		REQUIRE(replicator.SetProperties(c, {
+			StringName(STRL("Health")), StringName(STRL("Position")), StringName(STRL("Score")),
+			StringName(STRL("Speed")), StringName(STRL("Alive")), StringName(STRL("Name"))
+		}) == ResultCode::OK);
+		for (int32 i = 0; i < count; i += 1) {
+			REQUIRE(replicator.Add((uint32)(10 + i * 3), &units[i]) == ResultCode::OK);
+		}
+	}
+}
+
+TEST_SUITE("Replication") {
+	TEST_CASE("Deltas") {
+		constexpr int32 Count = 4;
+		Unit sent[Count];
+		Unit received[Count];
+		for (int32 i = 0; i < Count; i += 1) {
+			sent[i].health = 50 + i;
+			sent[i].position = Vector2(i * 1.234f, -i * 100.5f);
+			sent[i].score = 1000000 + i;
+			sent[i].speed = i * 0.1;
+			sent[i].alive = (i % 2 == 0);
+			sent[i].name = String::Format(STRING_LITERAL("Unit{0}"), i);
+		}
+		Replicator sender{};
+		Replicator receiver{};
+		SetUp(sender, sent, Count);
+		SetUp(receiver, received, Count);
+		CHECK(sender.GetCount() == Count);
+
+		// Every value before the first acknowledgement.
+		SnapshotHistory sentHistory{};
+		SnapshotHistory receivedHistory{};
+		Snapshot first{};
+		sender.Capture(1, first);
+		CHECK(first.GetObjectCount() == Count);
+		auto stream = IntrusivePtr<MemoryStream>::Create();
+		REQUIRE(sender.WriteDelta(nullptr, first, stream.GetRaw()) == ResultCode::OK);
+		int64 fullLength = stream->GetLength();
+		sentHistory.Add(Memory::Move(first));
+
+		stream->SetPosition(0);
+		Snapshot read{};
+		REQUIRE(receiver.ReadDelta(receivedHistory, stream.GetRaw(), read) == ResultCode::OK);
+		CHECK(read.GetSequence() == 1);
+		receiver.Apply(read);
+		receivedHistory.Add(Memory::Move(read));
+		for (int32 i = 0; i < Count; i += 1) {
+			CHECK(received[i].health == sent[i].health);
+			CHECK(std::abs(received[i].position.x - sent[i].position.x) <= 0.005f);
+			CHECK(std::abs(received[i].position.y - sent[i].position.y) <= 0.005f);
+			CHECK(received[i].score == sent[i].score);
+			CHECK(received[i].speed == sent[i].speed);
+			CHECK(received[i].alive == sent[i].alive);
+			CHECK(received[i].name == sent[i].name);
+		}
+
+		// Against the acknowledged one only what changed goes, a fraction of it.
+		sent[1].health = 20;
+		sent[2].score += 3;
+		sent[3].name = STRL("Renamed");
+		Snapshot second{};
+		sender.Capture(2, second);
+		auto deltaStream = IntrusivePtr<MemoryStream>::Create();
+		REQUIRE(sender.WriteDelta(sentHistory.Find(1), second, deltaStream.GetRaw()) == ResultCode::OK);
+		CHECK(deltaStream->GetLength() * 3 < fullLength);
+		sentHistory.Add(Memory::Move(second));
+
+		deltaStream->SetPosition(0);
+		REQUIRE(receiver.ReadDelta(receivedHistory, deltaStream.GetRaw(), read) == ResultCode::OK);
+		CHECK(read.GetSequence() == 2);
+		receiver.Apply(read);
+		CHECK(received[1].health == 20);
+		CHECK(received[2].score == sent[2].score);
+		CHECK(received[3].name == STRL("Renamed"));
+		CHECK(received[0].name == sent[0].name);
+		receivedHistory.Add(Memory::Move(read));
+
+		// Quantized values are clamped to their range.
+		sent[0].health = 250;
+		sent[0].position = Vector2(10000, -10000);
+		Snapshot third{};
+		sender.Capture(3, third);
+		deltaStream->SetPosition(0);
+		REQUIRE(sender.WriteDelta(sentHistory.Find(2), third, deltaStream.GetRaw()) == ResultCode::OK);
+		deltaStream->SetPosition(0);
+		REQUIRE(receiver.ReadDelta(receivedHistory, deltaStream.GetRaw(), read) == ResultCode::OK);
+		receiver.Apply(read);
+		CHECK(received[0].health == 100);
+		CHECK(std::abs(received[0].position.x - 512) <= 0.005f);
+		CHECK(std::abs(received[0].position.y + 512) <= 0.005f);
+	}
+
+	TEST_CASE("Baselines and removal") {
+		Unit sent[2];
+		Unit received[2];
+		Replicator sender{};
+		Replicator receiver{};
+		SetUp(sender, sent, 2);
+		SetUp(receiver, received, 2);
+		CHECK(sender.Add(10, &sent[1]) == ResultCode::AlreadyExists);
+
+		SnapshotHistory sentHistory(2);
+		for (uint32 sequence = 1; sequence <= 3; sequence += 1) {
+			Snapshot snapshot{};
+			sender.Capture(sequence, snapshot);
+			sentHistory.Add(Memory::Move(snapshot));
+		}
+		CHECK(sentHistory.Find(1) == nullptr);
+		REQUIRE(sentHistory.GetLatest() != nullptr);
+		CHECK(sentHistory.GetLatest()->GetSequence() == 3);
+
+		// The receiver never got the baseline.
+		auto stream = IntrusivePtr<MemoryStream>::Create();
+		REQUIRE(sender.WriteDelta(sentHistory.Find(2), *sentHistory.GetLatest(), stream.GetRaw()) == ResultCode::OK);
+		stream->SetPosition(0);
+		SnapshotHistory receivedHistory{};
+		Snapshot read{};
+		CHECK(receiver.ReadDelta(receivedHistory, stream.GetRaw(), read) == ResultCode::NotFound);
+
+		// Removed objects aren't captured, and an id the receiver doesn't have is malformed data.
+		CHECK(sender.Remove(10));
+		CHECK_FALSE(sender.Remove(10));
+		sent[1].health = 7;
+		Snapshot snapshot{};
+		sender.Capture(4, snapshot);
+		REQUIRE(snapshot.GetObjectCount() == 1);
+		CHECK(snapshot.GetNetworkId(0) == 13);
+		stream = IntrusivePtr<MemoryStream>::Create();
+		REQUIRE(sender.WriteDelta(nullptr, snapshot, stream.GetRaw()) == ResultCode::OK);
+		stream->SetPosition(0);
+		REQUIRE(receiver.ReadDelta(receivedHistory, stream.GetRaw(), read) == ResultCode::OK);
+		receiver.Apply(read);
+		CHECK(received[1].health == 7);
+		CHECK(received[0].health == 0);
+
+		CHECK(receiver.Remove(13));
+		stream->SetPosition(0);
+		CHECK(receiver.ReadDelta(receivedHistory, stream.GetRaw(), read) == ResultCode::InvalidStream);
+
+		// Truncated data.
+		auto truncated = IntrusivePtr<MemoryStream>::Create(stream->GetData(), (int32)stream->GetLength() - 1);
+		CHECK(sender.ReadDelta(receivedHistory, truncated.GetRaw(), read) == ResultCode::InvalidStream);
+	}
+}
@@ -0,0 +1,424 @@
+#include "doctest.h"
+#include "Engine/System/File/FileSystem.h"
+#include "Engine/System/BufferedStream.h"
+#include "Engine/System/CompressedStream.h"
+#include "Engine/System/Compression/Lz4.h"
+#include "Engine/System/MemoryStream.h"
+#include "Engine/System/TextReader.h"
+#include "Engine/System/VariantStream.h"
+#include "Engine/System/Object/PropertyBatch.h"
+#include <cstring>
+
+using namespace Engine;
+
+namespace StreamVariants {
+	class Saved :public ManualObject {
+		REFLECTION_CLASS(::StreamVariants::Saved, ::Engine::ManualObject) {
+			REFLECTION_FIELD(STRL("Position"), Saved::position);
+			REFLECTION_FIELD(STRL("Speed"), Saved::speed);
+			REFLECTION_FIELD(STRL("Label"), Saved::label);
+		}
+
+	public:
+		Vector2 position{};
+		double speed = 0;
+		String label{};
+	};
+}
+
+TEST_SUITE("Stream") {
+	TEST_CASE("Swap bytes") {
+		CHECK(Stream::SwapBytes((uint16)0x1234) == 0x3412);
+		CHECK(Stream::SwapBytes((uint32)0x12345678u) == 0x78563412u);
+		CHECK(Stream::SwapBytes((uint64)0x0102030405060708ull) == 0x0807060504030201ull);
+		CHECK(Stream::SwapBytes(Stream::SwapBytes(1.5f)) == 1.5f);
+		CHECK(Stream::SwapBytes(Stream::SwapBytes(-2.25)) == -2.25);
+	}
+
+	TEST_CASE("Buffered") {
+		FileSystem fs;
+		String path = STRL("file://BufferedStreamTest.bin");
+		List<int32> values{};
+		for (int32 i = 0; i < 3000; i += 1) {
+			values.Add(i * 7 - 1000);
+		}
+		{
+			auto r = fs.OpenFile(path, FileStream::OpenMode::WriteTruncate);
+			REQUIRE(r.result == ResultCode::OK);
+			// A small buffer, so the values cross its end.
+			auto stream = IntrusivePtr<BufferedStream>::Create(r.value, 64);
+			stream->SetCurrentEndianness(Stream::Endianness::Big);
+			CHECK(stream->Write((uint16)0xABCD) == ResultCode::OK);
+			CHECK(stream->Write(values.GetRawElementPtr(), values.GetCount()) == ResultCode::OK);
+			CHECK(stream->Write(3.5) == ResultCode::OK);
+			stream->SetCurrentEndianness(Stream::Endianness::Little);
+			CHECK(stream->WriteInt32(42) == ResultCode::OK);
+			CHECK(stream->GetPosition() == 2 + 3000 * 4 + 8 + 4);
+			stream->Close();
+		}
+		{
+			auto r = fs.OpenFile(path, FileStream::OpenMode::ReadOnly);
+			REQUIRE(r.result == ResultCode::OK);
+			CHECK(r.value->GetLength() == 2 + 3000 * 4 + 8 + 4);
+			// Big endian on disk.
+			CHECK(r.value->ReadByte() == 0xAB);
+			r.value->SetPosition(0);
+
+			auto stream = IntrusivePtr<BufferedStream>::Create(r.value, 64);
+			stream->SetCurrentEndianness(Stream::Endianness::Big);
+			CHECK(stream->Read<uint16>() == 0xABCD);
+			List<int32> read{};
+			read.SetCount(values.GetCount());
+			CHECK(stream->Read(read.GetRawElementPtr(), read.GetCount()) == values.GetCount());
+			bool same = true;
+			for (int32 i = 0; i < values.GetCount(); i += 1) {
+				same = same && read[i] == values[i];
+			}
+			CHECK(same);
+			CHECK(stream->Read<double>() == 3.5);
+			stream->SetCurrentEndianness(Stream::Endianness::Little);
+			CHECK(stream->ReadInt32() == 42);
+
+			// Reads that skip the buffer, then random access.
+			stream->SetPosition(2);
+			List<byte> bytes{};
+			CHECK(stream->ReadBytes(1000, bytes) == 1000);
+			CHECK(bytes.GetCount() == 1000);
+			CHECK(stream->GetPosition() == 1002);
+			stream->SetPosition(stream->GetLength() - 4);
+			CHECK(stream->ReadInt32() == 42);
+			CHECK(stream->ReadBytes(10, bytes) == 0);
+			CHECK(bytes.GetCount() == 1000);
+			stream->Close();
+		}
+		CHECK(fs.RemoveFile(path) == ResultCode::OK);
+	}
+
+	TEST_CASE("Memory") {
+		auto stream = IntrusivePtr<MemoryStream>::Create();
+		CHECK(stream->CanWrite());
+		CHECK(stream->CanReadSpan());
+		stream->WriteInt32(7);
+		stream->WriteUInt16(0xBEEF);
+		stream->WriteText(STRL("abc"));
+		CHECK(stream->GetLength() == 9);
+
+		stream->SetPosition(0);
+		CHECK(stream->ReadInt32() == 7);
+		ByteSpan span = stream->ReadSpan(100);
+		CHECK(span.length == 5);
+		CHECK(*(const uint16*)span.data == 0xBEEF);
+		CHECK(span.data[2] == 'a');
+		CHECK(stream->ReadSpan(1).IsEmpty());
+
+		// Overwriting keeps the length, writing past the end grows it.
+		stream->SetPosition(4);
+		stream->WriteByte(1);
+		CHECK(stream->GetLength() == 9);
+		stream->SetPosition(9);
+		stream->WriteInt64(-1);
+		CHECK(stream->GetLength() == 17);
+
+		List<byte> data = stream->TakeData();
+		CHECK(data.GetCount() == 17);
+		CHECK(data[4] == 1);
+		CHECK(!stream->IsValid());
+
+		// Borrowed bytes are read in place.
+		MemoryStream borrowed(data.GetRawElementPtr(), data.GetCount());
+		CHECK(!borrowed.CanWrite());
+		CHECK(borrowed.ReadSpan(4).data == data.GetRawElementPtr());
+		CHECK(borrowed.GetPosition() == 4);
+		auto buffered = IntrusivePtr<BufferedStream>::Create(IntrusivePtr<MemoryStream>::Create(Memory::Move(data)), 8);
+		CHECK(buffered->Read<int32>() == 7);
+		CHECK(buffered->Read<uint16>() == 0xBE01);
+	}
+
+	TEST_CASE("Arrays") {
+		struct Point {
+			float x;
+			float y;
+			float z;
+		};
+
+		// Enough values for the vector swaps and a tail.
+		List<uint16> shorts{};
+		List<uint32> ints{};
+		List<uint64> longs{};
+		for (int32 i = 0; i < 37; i += 1) {
+			shorts.Add((uint16)(i * 0x0103));
+			ints.Add((uint32)i * 0x01020304u);
+			longs.Add((uint64)i * 0x0102030405060708ull);
+		}
+		Point points[5];
+		for (int32 i = 0; i < 5; i += 1) {
+			points[i] = Point{ i + 0.5f, -i * 2.0f, 100.0f };
+		}
+
+		auto stream = IntrusivePtr<MemoryStream>::Create();
+		stream->SetCurrentEndianness(Stream::Endianness::Big);
+		CHECK(stream->WriteArray(shorts.GetRawElementPtr(), shorts.GetCount()) == ResultCode::OK);
+		CHECK(stream->WriteArray(ints.GetRawElementPtr(), ints.GetCount()) == ResultCode::OK);
+		CHECK(stream->WriteArray(longs.GetRawElementPtr(), longs.GetCount()) == ResultCode::OK);
+		CHECK(stream->WriteArray<Point, float>(points, 5) == ResultCode::OK);
+		CHECK(stream->GetLength() == 37 * 14 + 5 * 12);
+		// The values were left as they were.
+		CHECK(ints[1] == 0x01020304u);
+
+		// The same bytes as writing one at a time.
+		stream->SetPosition(37 * 2);
+		CHECK(stream->ReadUInt32() == 0);
+		CHECK(stream->ReadUInt32() == 0x01020304u);
+		stream->SetPosition(37 * 6);
+		stream->SetCurrentEndianness(Stream::Endianness::Little);
+		stream->ReadUInt64();
+		CHECK(stream->ReadUInt64() == 0x0807060504030201ull);
+
+		stream->SetPosition(0);
+		stream->SetCurrentEndianness(Stream::Endianness::Big);
+		List<uint16> readShorts{};
+		List<uint32> readInts{};
+		List<uint64> readLongs{};
+		readShorts.SetCount(37);
+		readInts.SetCount(37);
+		readLongs.SetCount(37);
+		CHECK(stream->ReadArray(readShorts.GetRawElementPtr(), 37) == 37);
+		CHECK(stream->ReadArray(readInts.GetRawElementPtr(), 37) == 37);
+		CHECK(stream->ReadArray(readLongs.GetRawElementPtr(), 37) == 37);
+		CHECK(std::memcmp(readShorts.GetRawElementPtr(), shorts.GetRawElementPtr(), 37 * 2) == 0);
+		CHECK(std::memcmp(readInts.GetRawElementPtr(), ints.GetRawElementPtr(), 37 * 4) == 0);
+		CHECK(std::memcmp(readLongs.GetRawElementPtr(), longs.GetRawElementPtr(), 37 * 8) == 0);
+
+		// A partial last value is consumed but not counted.
+		Point readPoints[6];
+		CHECK(stream->ReadArray<Point, float>(readPoints, 6) == 5);
+		CHECK(readPoints[4].x == 4.5f);
+		CHECK(readPoints[4].y == -8.0f);
+		CHECK(readPoints[4].z == 100.0f);
+		stream->SetPosition(stream->GetLength() - 7);
+		CHECK(stream->ReadArray(readLongs.GetRawElementPtr(), 1) == 0);
+		CHECK(stream->GetPosition() == stream->GetLength());
+
+		// Through a buffer smaller than what is written at once.
+		auto memory = IntrusivePtr<MemoryStream>::Create();
+		auto buffered = IntrusivePtr<BufferedStream>::Create(memory, 20);
+		buffered->SetCurrentEndianness(Stream::Endianness::Big);
+		CHECK(buffered->Write(ints.GetRawElementPtr(), ints.GetCount()) == ResultCode::OK);
+		CHECK(buffered->Flush() == ResultCode::OK);
+		memory->SetPosition(0);
+		memory->SetCurrentEndianness(Stream::Endianness::Big);
+		readInts.SetCount(37);
+		CHECK(memory->ReadArray(readInts.GetRawElementPtr(), 37) == 37);
+		CHECK(std::memcmp(readInts.GetRawElementPtr(), ints.GetRawElementPtr(), 37 * 4) == 0);
+	}
+
+	TEST_CASE("Text") {
+		auto stream = IntrusivePtr<MemoryStream>::Create();
+		stream->WriteString(STRL("short"));
+		String longText = STRL("A string long enough to need more than one byte of length. ");
+		for (int32 i = 0; i < 2; i += 1) {
+			longText = longText + longText;
+		}
+		stream->WriteString(longText);
+		stream->WriteString(String::GetEmpty());
+		stream->SetPosition(0);
+		CHECK(stream->ReadString() == STRL("short"));
+		CHECK(stream->GetPosition() == 6);
+		CHECK(stream->ReadString() == longText);
+		CHECK(stream->ReadString() == String::GetEmpty());
+		CHECK(stream->GetPosition() == stream->GetLength());
+
+		auto lines = IntrusivePtr<MemoryStream>::Create();
+		lines->WriteTextLine(STRL("first"));
+		lines->WriteText(STRL("second\r\n\n"));
+		lines->WriteText(longText);
+		lines->WriteTextLine(String::GetEmpty());
+		lines->WriteText(STRL("last"));
+		CHECK(lines->ReadAllText().GetCount() == lines->GetLength());
+
+		lines->SetPosition(0);
+		CHECK(lines->ReadTextLine() == STRL("first"));
+		CHECK(lines->GetPosition() == 6);
+		CHECK(lines->ReadTextLine() == STRL("second"));
+		CHECK(lines->ReadTextLine() == String::GetEmpty());
+		CHECK(lines->ReadTextLine() == longText);
+		CHECK(lines->ReadTextLine() == STRL("last"));
+
+		// A small buffer, so lines cross blocks and one is longer than a block.
+		lines->SetPosition(0);
+		TextReader reader(lines, 16);
+		String line{};
+		List<String> read{};
+		while (reader.ReadLine(line)) {
+			read.Add(line);
+		}
+		REQUIRE(read.GetCount() == 5);
+		CHECK(read[0] == STRL("first"));
+		CHECK(read[1] == STRL("second"));
+		CHECK(read[2] == String::GetEmpty());
+		CHECK(read[3] == longText);
+		CHECK(read[4] == STRL("last"));
+		CHECK(reader.IsEnd());
+		CHECK(!reader.ReadLine(line));
+	}
+
+	TEST_CASE("Compressed") {
+		// Runs to compress, with some noise breaking them.
+		List<byte> data{};
+		uint32 seed = 1;
+		for (int32 i = 0; i < 100000; i += 1) {
+			seed = seed * 1664525u + 1013904223u;
+			data.Add((seed >> 28) == 0 ? (byte)(seed >> 20) : (byte)(i / 64));
+		}
+
+		List<byte> block{};
+		block.SetCount(Lz4::GetMaxCompressedSize(data.GetCount()));
+		int32 compressed = Lz4::Compress(data.GetRawElementPtr(), data.GetCount(), block.GetRawElementPtr(), block.GetCount());
+		CHECK(compressed > 0);
+		CHECK(compressed < data.GetCount() / 2);
+		List<byte> decompressed{};
+		decompressed.SetCount(data.GetCount());
+		CHECK(Lz4::Decompress(block.GetRawElementPtr(), compressed, decompressed.GetRawElementPtr(), decompressed.GetCount()) == data.GetCount());
+		CHECK(std::memcmp(decompressed.GetRawElementPtr(), data.GetRawElementPtr(), data.GetCount()) == 0);
+		CHECK(Lz4::Decompress(block.GetRawElementPtr(), compressed - 1, decompressed.GetRawElementPtr(), decompressed.GetCount()) == -1);
+		CHECK(Lz4::Decompress(block.GetRawElementPtr(), compressed, decompressed.GetRawElementPtr(), 100) == -1);
+
+		auto memory = IntrusivePtr<MemoryStream>::Create();
+		{
+			CompressedStream stream(memory, CompressedStream::Mode::Compress, CompressedStream::Codec::Lz4, 4096);
+			CHECK(stream.WriteBytes(data) == ResultCode::OK);
+			CHECK(stream.GetLength() == data.GetCount());
+			CHECK(stream.GetBlockCount() == data.GetCount() / 4096);
+		}
+		CHECK(memory->GetLength() < data.GetCount() / 2);
+
+		memory->SetPosition(0);
+		CompressedStream stream(memory, CompressedStream::Mode::Decompress);
+		REQUIRE(stream.IsValid());
+		CHECK(stream.GetBlockSize() == 4096);
+		CHECK(stream.GetBlockCount() == (data.GetCount() + 4095) / 4096);
+		CHECK(stream.GetLength() == data.GetCount());
+
+		// Reads across blocks, then seeks back.
+		List<byte> read{};
+		stream.SetPosition(4000);
+		CHECK(stream.ReadBytes(10000, read) == 10000);
+		CHECK(std::memcmp(read.GetRawElementPtr(), data.GetRawElementPtr() + 4000, 10000) == 0);
+		stream.SetPosition(10);
+		CHECK(stream.ReadByte() == data[10]);
+
+		read.Clear();
+		CHECK(stream.ReadAll(read) == ResultCode::OK);
+		REQUIRE(read.GetCount() == data.GetCount() - 11);
+		CHECK(std::memcmp(read.GetRawElementPtr(), data.GetRawElementPtr() + 11, read.GetCount()) == 0);
+		CHECK(stream.GetPosition() == stream.GetLength());
+
+		// Data that doesn't compress is stored as it is.
+		auto stored = IntrusivePtr<MemoryStream>::Create();
+		{
+			CompressedStream raw(stored, CompressedStream::Mode::Compress, CompressedStream::Codec::None, 1000);
+			raw.WriteBytes(data.GetRawElementPtr(), 2500);
+		}
+		stored->SetPosition(0);
+		CompressedStream raw(stored, CompressedStream::Mode::Decompress);
+		REQUIRE(raw.IsValid());
+		CHECK(raw.GetCodec() == CompressedStream::Codec::None);
+		read.Clear();
+		CHECK(raw.ReadAll(read) == ResultCode::OK);
+		REQUIRE(read.GetCount() == 2500);
+		CHECK(std::memcmp(read.GetRawElementPtr(), data.GetRawElementPtr(), 2500) == 0);
+	}
+
+	TEST_CASE("Variants") {
+		PackedFloat32Array floats{};
+		for (int32 i = 0; i < 10000; i += 1) {
+			floats.Add(i * 0.5f);
+		}
+		String label = STRL("A label long enough for a reference to be shorter than it");
+		Variant values[] = {
+			Variant(), Variant(true), Variant(false), Variant((int64)0), Variant((int64)-1), Variant((int64)INT64_MIN), Variant((int64)INT64_MAX),
+			Variant(3.25), Variant(STRL("")), Variant(label), Variant(label), Variant(Vector2(1.5f, -2)),
+			Variant(PackedByteArray{ 1, 2, 3 }), Variant(PackedInt64Array{ -5, 1LL << 40 }), Variant(floats),
+			Variant(PackedVector2Array{ Vector2(1, 2), Vector2(3, 4) }), Variant(PackedInt64Array{}),
+		};
+
+		auto stream = IntrusivePtr<MemoryStream>::Create();
+		{
+			// A small buffer makes large arrays go around it.
+			VariantWriter writer(stream, 16);
+			for (const Variant& value : values) {
+				CHECK(writer.WriteVariant(value) == ResultCode::OK);
+			}
+		}
+		// Small integers take a byte after the tag, the repeated String a reference, the floats their raw bytes.
+		CHECK(stream->GetLength() < label.GetCount() + 10000 * 4 + 150);
+
+		stream->SetPosition(0);
+		VariantReader reader(stream, 16);
+		for (const Variant& expected : values) {
+			Variant read{};
+			REQUIRE(reader.ReadVariant(read));
+			CHECK(read.GetType() == expected.GetType());
+			CHECK(read == expected);
+		}
+		Variant read{};
+		CHECK(!reader.ReadVariant(read));
+		CHECK(reader.IsEnd());
+		CHECK(!reader.IsFailed());
+
+		// Truncated data fails instead of making up values.
+		List<byte> data = stream->TakeData();
+		data.SetCount(data.GetCount() - 100);
+		VariantReader truncated(IntrusivePtr<MemoryStream>::Create(Memory::Move(data)));
+		int32 readCount = 0;
+		while (truncated.ReadVariant(read)) {
+			readCount += 1;
+		}
+		CHECK(readCount == 14);
+		CHECK(truncated.IsFailed());
+	}
+
+	TEST_CASE("Property blobs") {
+		using StreamVariants::Saved;
+		const ReflectionClass* c = Reflection::GetClass(STRL("::StreamVariants::Saved"));
+		REQUIRE(c != nullptr);
+		Saved sources[3];
+		for (int32 i = 0; i < 3; i += 1) {
+			sources[i].position = Vector2((float)i, 1);
+			sources[i].speed = i * 2.5;
+			sources[i].label = STRL("Shared");
+		}
+		const Object* sourceObjects[3]{ &sources[0], &sources[1], &sources[2] };
+		PropertyBatch all(c, { StringName(STRL("Position")), StringName(STRL("Speed")), StringName(STRL("Label")) });
+
+		auto stream = IntrusivePtr<MemoryStream>::Create();
+		{
+			VariantWriter writer(stream);
+			CHECK(writer.WriteProperties(all, sourceObjects, 3) == ResultCode::OK);
+			CHECK(writer.WriteProperties(all, sourceObjects, 1) == ResultCode::OK);
+			CHECK(writer.WriteVariant(Variant((int64)42)) == ResultCode::OK);
+		}
+
+		// Matched by name, in another order, what the batch doesn't have stays.
+		stream->SetPosition(0);
+		VariantReader reader(stream);
+		Saved targets[3];
+		for (auto& target : targets) {
+			target.label = STRL("Kept");
+		}
+		Object* targetObjects[3]{ &targets[0], &targets[1], &targets[2] };
+		PropertyBatch some(c, { StringName(STRL("Speed")), StringName(STRL("Position")) });
+		CHECK(reader.ReadProperties(some, targetObjects, 3) == ResultCode::OK);
+		for (int32 i = 0; i < 3; i += 1) {
+			CHECK(targets[i].position == sources[i].position);
+			CHECK(targets[i].speed == sources[i].speed);
+			CHECK(targets[i].label == STRL("Kept"));
+		}
+
+		// A blob for another count is passed over.
+		CHECK(reader.ReadProperties(some, targetObjects, 3) == ResultCode::InvalidArgument);
+		Variant read{};
+		REQUIRE(reader.ReadVariant(read));
+		CHECK(read.AsInt64() == 42);
+	}
+}
@@ -1,5 +1,6 @@
 #include "doctest.h"
 #include "Engine/System/String.h"
+#include "Engine/System/Object/ObjectUtil.h"
 
 using namespace Engine;
 
@@ -66,8 +67,29 @@ TEST_SUITE("String") {
 		String individual = substr.ToIndividual();
 		CHECK(individual.IsIndividual());
 		CHECK(substr.GetRawArray() != individual.GetRawArray());
+
+		CHECK(!substr.IsNullTerminated());
+		CHECK(original.Substring(6, 6).IsNullTerminated());
+		CHECK(individual.IsNullTerminated());
 	}
 
+	TEST_CASE("Thread local") {
+		String original = STRING_LITERAL("Hello World!");
+		CHECK(!original.IsThreadLocal());
+
+		String local = original.Substring(6, 5).ToThreadLocal();
+		CHECK(local.IsThreadLocal());
+		CHECK(local.IsIndividual());
+		CHECK(local == STRING_LITERAL("World"));
+		CHECK(local.GetRawArray() != original.GetRawArray());
+		CHECK(local.ToThreadLocal().GetRawArray() == local.GetRawArray());
+		{
+			String copy = local;
+			CHECK(copy.IsThreadLocal());
+			CHECK(copy.GetRawArray() == local.GetRawArray());
+		}
+		CHECK(local.Substring(1, 3) == STRING_LITERAL("orl"));
+	}
 	TEST_CASE("StartsWith & EndsWith") {
 		String target = STRING_LITERAL("伞兵一号卢本伟，准备就绪！");
 		CHECK(target.StartsWith(STRING_LITERAL("伞兵")));
@@ -75,4 +97,193 @@ TEST_SUITE("String") {
 		CHECK(target.EndsWith(STRING_LITERAL("准备就绪！")));
 		CHECK(!target.EndsWith(STRING_LITERAL("跟我比划比划")));
 	}
-}
\ No newline at end of file
+	TEST_CASE("Hash code caching") {
+		String whole = String(u8"Hash code caching");
+		String part = whole.Substring(5, 4);
+		CHECK(part.GetHashCode() == ObjectUtil::GetHashCode(std::string_view("code")));
+		CHECK(whole.GetHashCode() == ObjectUtil::GetHashCode(std::string_view("Hash code caching")));
+		// Computed once on the whole block, the part doesn't touch the cache.
+		CHECK(whole.GetHashCode() == ObjectUtil::GetHashCode(std::string_view("Hash code caching")));
+		CHECK(part.GetHashCode() == String(u8"code").GetHashCode());
+
+		// Equal lengths, different hash codes already cached.
+		String other = String(u8"Hash code cachinG");
+		other.GetHashCode();
+		CHECK(whole != other);
+		// Same content without a cached hash code.
+		CHECK(whole == String(u8"Hash code caching"));
+		CHECK(part == String(u8"code"));
+		CHECK(part != String(u8"codE"));
+	}
+	TEST_CASE("Small strings") {
+		String small = String(u8"Node2D");
+		CHECK(small.IsSmall());
+		CHECK(small.IsIndividual());
+		CHECK(!small.IsThreadLocal());
+		CHECK(small.GetRawArray()[small.GetCount()] == u8'\0');
+		CHECK(small == STRL("Node2D"));
+
+		String exact = String(u8"0123456789012345678901");
+		CHECK(exact.GetCount() == String::SmallCapacity);
+		CHECK(exact.IsSmall());
+		String large = String(u8"01234567890123456789012");
+		CHECK(!large.IsSmall());
+		CHECK(large.IsIndividual());
+
+		// Literals keep referencing their static data.
+		CHECK(!STRL("Node2D").IsSmall());
+
+		// Copies and moves own their chars.
+		String copy = small;
+		CHECK(copy.GetRawArray() != small.GetRawArray());
+		CHECK(copy == small);
+		String moved = Memory::Move(copy);
+		CHECK(moved == STRL("Node2D"));
+		CHECK(copy.GetCount() == 0);
+		moved = large;
+		CHECK(!moved.IsSmall());
+		CHECK(moved == large);
+		moved = small;
+		CHECK(moved.IsSmall());
+		CHECK(moved == small);
+
+		// Parts of small strings are small, parts of shared ones keep sharing.
+		String part = small.Substring(4, 2);
+		CHECK(part.IsSmall());
+		CHECK(part == STRL("2D"));
+		String sharedPart = large.Substring(2, 10);
+		CHECK(!sharedPart.IsSmall());
+		CHECK(sharedPart.GetRawArray() == large.GetRawArray());
+		CHECK(sharedPart.Substring(1, 3) == STRL("345"));
+		CHECK(sharedPart.ToIndividual().IsSmall());
+
+		CHECK(small.Replace(STRL("2D"), STRL("3D")) == STRL("Node3D"));
+		CHECK(small.Replace(STRL("2D"), STRL("3D")).IsSmall());
+		CHECK(small.Replace(STRL("Node"), STRL("VeryLongNodeTypeName")) == STRL("VeryLongNodeTypeName2D"));
+		CHECK(!small.Replace(STRL("Node"), STRL("VeryLongNodeTypeNames")).IsSmall());
+
+		String assigned = String(u8"");
+		CHECK(assigned.GetCount() == 0);
+		assigned = u8"Short";
+		CHECK(assigned.IsSmall());
+		assigned = assigned.GetRawArray();
+		CHECK(assigned == STRL("Short"));
+
+		CHECK(String::Format(STRL("{0}{1}"), 12, 34).IsSmall());
+		CHECK(small.GetHashCode() == STRL("Node2D").GetHashCode());
+	}
+	TEST_CASE("Block search") {
+		// Matches at every offset around the block sizes, compared with std::string_view::find.
+		std::string text;
+		for (int32 i = 0; i < 150; i += 1) {
+			text += (char)('a' + (i * 7) % 13);
+		}
+		String target = String(text);
+		std::string_view view = text;
+		for (int32 length = 1; length <= 40; length += 1) {
+			for (int32 start = 0; start + length <= (int32)text.size(); start += 3) {
+				String pattern = target.Substring(start, length);
+				CHECK(target.IndexOf(pattern) == (int32)view.find(pattern.GetStringView()));
+				CHECK(target.IndexOf(pattern, start) == start);
+			}
+		}
+		for (char c = 'a'; c <= 'z'; c += 1) {
+			int32 expected = (int32)view.find(c);
+			CHECK(target.IndexOf((u8char)c) == (expected == (int32)std::string_view::npos ? -1 : expected));
+		}
+		CHECK(target.IndexOf(STRL("zz")) == -1);
+		CHECK(target.IndexOf(u8'a', 1) == 13);
+
+		// Searching a part never sees the chars after it.
+		String whole = STRL("Hello World, this is a longer string for searching.");
+		String hell = whole.Substring(0, 4);
+		CHECK(hell.IndexOf(STRL("llo")) == -1);
+		CHECK(hell.IndexOf(u8'o') == -1);
+		CHECK(whole.IndexOf(STRL("searching."), 0, whole.GetCount() - 1) == -1);
+		CHECK(whole.IndexOf(STRL("searching."), 0, whole.GetCount()) == 41);
+
+		// Replace with multi-char patterns across blocks.
+		String many = STRL("abcabcabcabcabcabcabcabcabcabcabcabc");
+		CHECK(many.Replace(STRL("bc"), STRL("-")) == STRL("a-a-a-a-a-a-a-a-a-a-a-a-"));
+		CHECK(many.Replace(STRL("abc"), String::GetEmpty()) == String::GetEmpty());
+		CHECK(many.Replace(String::GetEmpty(), STRL("x")) == many);
+	}
+	TEST_CASE("Split") {
+		String csv = String(u8"alpha,beta,,a much longer gamma piece,");
+		CHECK(!csv.IsSmall());
+		List<String> pieces = csv.Split(STRL(","));
+		REQUIRE(pieces.GetCount() == 5);
+		CHECK(pieces[0] == STRL("alpha"));
+		CHECK(pieces[1] == STRL("beta"));
+		CHECK(pieces[2] == String::GetEmpty());
+		CHECK(pieces[3] == STRL("a much longer gamma piece"));
+		CHECK(pieces[4] == String::GetEmpty());
+		// Pieces reference the content of the source.
+		CHECK(pieces[0].GetRawArray() == csv.GetRawArray());
+		CHECK(pieces[3].GetStartPtr() == csv.GetStartPtr() + 12);
+
+		List<String> nonEmpty = csv.Split(STRL(","), true);
+		REQUIRE(nonEmpty.GetCount() == 3);
+		CHECK(nonEmpty[2] == STRL("a much longer gamma piece"));
+
+		List<String> small = String(u8"a::b::::c").Split(STRL("::"));
+		REQUIRE(small.GetCount() == 4);
+		CHECK(small[0].IsSmall());
+		CHECK(small[1] == STRL("b"));
+		CHECK(small[2] == String::GetEmpty());
+		CHECK(small[3] == STRL("c"));
+
+		CHECK(String::GetEmpty().Split(STRL(",")).GetCount() == 1);
+		CHECK(String::GetEmpty().Split(STRL(","), true).GetCount() == 0);
+		List<String> whole = csv.Split(String::GetEmpty());
+		REQUIRE(whole.GetCount() == 1);
+		CHECK(whole[0] == csv);
+	}
+	TEST_CASE("Tokenizer") {
+		String text = STRL("key = value = more");
+		String::Tokenizer tokenizer = text.Tokenize(STRL(" = "));
+		std::string_view view;
+		REQUIRE(tokenizer.Next(view));
+		CHECK(view == "key");
+		CHECK(tokenizer.GetRemaining() == STRL("value = more"));
+		String piece;
+		REQUIRE(tokenizer.Next(piece));
+		CHECK(piece == STRL("value"));
+		REQUIRE(tokenizer.Next(piece));
+		CHECK(piece == STRL("more"));
+		CHECK(!tokenizer.Next(piece));
+		CHECK(!tokenizer.Next(view));
+		CHECK(tokenizer.GetRemaining() == String::GetEmpty());
+
+		String::Tokenizer words = String(u8"  two   words  ").Tokenize(STRL(" "), true);
+		int32 count = 0;
+		while (words.Next(view)) {
+			CHECK((view == "two" || view == "words"));
+			count += 1;
+		}
+		CHECK(count == 2);
+	}
+	TEST_CASE("Remove & replace chars") {
+		constexpr String::CharMask separators{ "./:\r\n" };
+		CHECK(separators.Contains(u8'/'));
+		CHECK(!separators.Contains(u8'a'));
+		CHECK(!separators.Contains((u8char)0xE4));
+
+		String clean = String(u8"A perfectly fine node name");
+		CHECK(clean.IndexOfAny(separators) == -1);
+		// Nothing to remove, the content is shared instead of copied.
+		CHECK(clean.RemoveChars(separators).GetRawArray() == clean.GetRawArray());
+		CHECK(clean.ReplaceChars(separators, u8'_').GetRawArray() == clean.GetRawArray());
+
+		CHECK(String(u8"a.b/c").IndexOfAny(separators) == 1);
+		CHECK(String(u8"a.b/c").IndexOfAny(separators, 2) == 3);
+		CHECK(String(u8"a.b/c").RemoveChars(separators) == STRL("abc"));
+		CHECK(String(u8"a.b/c").ReplaceChars(separators, u8'_') == STRL("a_b_c"));
+		CHECK(String(u8"./:").RemoveChars(separators) == String::GetEmpty());
+
+		String big = String(u8"/root/some/deeply/nested/node:with.a:long name\n");
+		CHECK(big.RemoveChars(separators) == STRL("rootsomedeeplynestednodewithalong name"));
+		CHECK(big.ReplaceChars(separators, u8' ') == STRL(" root some deeply nested node with a long name "));
+		CHECK(STRL("伞兵.一号").RemoveChars(separators) == STRL("伞兵一号"));
+	}
+}
@@ -0,0 +1,72 @@
+#include "doctest.h"
+#include "Engine/System/StringBuilder.h"
+#include "CountingAllocator.h"
+
+using namespace Engine;
+
+TEST_SUITE("StringBuilder") {
+	TEST_CASE("Appending") {
+		StringBuilder builder;
+		CHECK(builder.GetCount() == 0);
+		CHECK(builder.ToString() == String::GetEmpty());
+
+		builder.Append(STRL("Node")).Append(u8'_').Append(std::string_view("view")).Append(u8" raw");
+		CHECK(builder.GetStringView() == std::string_view("Node_view raw"));
+
+		builder.Clear();
+		builder.Append(12).Append(u8' ').Append(-3ll).Append(u8' ').Append(1.5).Append(u8' ').Append(true);
+		CHECK(builder.ToString() == STRL("12 -3 1.5 true"));
+	}
+	TEST_CASE("Formatting") {
+		StringBuilder builder;
+		builder.Append(STRL("["));
+		builder.AppendFormat(STRL("{0}: {1} ({2})"), 3, STRL("Name"), 0.25f);
+		builder.Append(STRL("]"));
+		CHECK(builder.ToString() == STRL("[3: Name (0.25)]"));
+		CHECK(builder.ToString() == String::Format(STRL("[{0}: {1} ({2})]"), 3, STRL("Name"), 0.25f));
+
+		// Long output grows the buffer in the middle of formatting.
+		builder.Clear();
+		for (int32 i = 0; i < 200; i += 1) {
+			builder.AppendFormat(STRL("{0},"), i);
+		}
+		String result = builder.ToString();
+		CHECK(result.GetCount() == builder.GetCount());
+		CHECK(result.StartsWith(STRL("0,1,2,")));
+		CHECK(result.EndsWith(STRL("198,199,")));
+	}
+	TEST_CASE("Allocator") {
+		CountingAllocator allocator;
+		{
+			StringBuilder builder(8, &allocator);
+			CHECK(builder.GetCapacity() == 8);
+			CHECK(builder.GetAllocator() == &allocator);
+			for (int32 i = 0; i < 100; i += 1) {
+				builder.Append(STRL("0123456789"));
+			}
+			CHECK(builder.GetCount() == 1000);
+			CHECK(builder.GetCapacity() >= 1000);
+			CHECK(allocator.allocations == 1);
+			CHECK(allocator.bytes == (sizeint)builder.GetCapacity());
+
+			StringBuilder moved = Memory::Move(builder);
+			CHECK(builder.GetCount() == 0);
+			CHECK(moved.GetCount() == 1000);
+		}
+		CHECK(allocator.allocations == 0);
+		CHECK(allocator.bytes == 0);
+	}
+	TEST_CASE("Concatenation") {
+		String small = STRL("Node") + STRL("2D");
+		CHECK(small == STRL("Node2D"));
+		CHECK(small.IsSmall());
+
+		String large = STRL("A rather long prefix, ") + STRL("and a long suffix.");
+		CHECK(large == STRL("A rather long prefix, and a long suffix."));
+		CHECK(large.IsIndividual());
+
+		String part = large.Substring(2, 6);
+		CHECK(part + STRL("!") == STRL("rather!"));
+		CHECK(String::GetEmpty() + String::GetEmpty() == String::GetEmpty());
+	}
+}
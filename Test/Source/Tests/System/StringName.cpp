@@ -0,0 +1,117 @@
+#include "doctest.h"
+#include "Engine/System/StringName.h"
+#include "Engine/System/Object/ObjectUtil.h"
+#include "Engine/System/Collection/FlatDictionary.h"
+#include <thread>
+
+using namespace Engine;
+
+TEST_SUITE("StringName") {
+	TEST_CASE("Interning") {
+		StringName a = STRL("StringNameTestA");
+		StringName b = String(u8"StringNameTestA");
+		StringName c = std::string_view("StringNameTestA");
+		StringName d = STRL("StringNameTestB");
+
+		CHECK(a == b);
+		CHECK(a == c);
+		CHECK(a != d);
+		CHECK(a.GetString() == STRL("StringNameTestA"));
+		CHECK(a.GetStringView() == std::string_view("StringNameTestA"));
+		CHECK(a.GetHashCode() == STRL("StringNameTestA").GetHashCode());
+		CHECK(a.GetHashCode() == ObjectUtil::GetHashCode(a));
+
+		// Ordered by identity, either way but never both.
+		CHECK((a < d) != (d < a));
+		CHECK(!(a < b));
+
+		// The formatter prints the content.
+		CHECK(String::Format(STRL("{0}!"), a) == STRL("StringNameTestA!"));
+	}
+	TEST_CASE("Empty") {
+		StringName empty;
+		CHECK(empty.IsEmpty());
+		CHECK(empty == StringName(String::GetEmpty()));
+		CHECK(empty == StringName(u8""));
+		CHECK(empty.GetString() == String::GetEmpty());
+		CHECK(empty.GetHashCode() == String::GetEmpty().GetHashCode());
+		CHECK(empty != StringName(STRL("StringNameTestA")));
+	}
+	TEST_CASE("Lifetime") {
+		int32 before = StringName::GetInternedCount();
+		CHECK(StringName::Find("StringNameTestLifetime").IsEmpty());
+		{
+			StringName a = STRL("StringNameTestLifetime");
+			CHECK(StringName::GetInternedCount() == before + 1);
+
+			StringName copy = a;
+			StringName moved = Memory::Move(copy);
+			CHECK(copy.IsEmpty());
+			CHECK(moved == a);
+			CHECK(StringName::Find("StringNameTestLifetime") == a);
+			CHECK(StringName::GetInternedCount() == before + 1);
+
+			a = StringName();
+			// Still held by moved.
+			CHECK(!StringName::Find("StringNameTestLifetime").IsEmpty());
+		}
+		// The entry is gone with its last StringName.
+		CHECK(StringName::Find("StringNameTestLifetime").IsEmpty());
+		CHECK(StringName::GetInternedCount() == before);
+	}
+	TEST_CASE("Owned content") {
+		String source = STRL("PrefixStringNameTestOwnedSuffix");
+		StringName name;
+		{
+			String part = source.Substring(6, 19);
+			name = part;
+		}
+		// The interned content doesn't refer into the larger String.
+		CHECK(name.GetString() == STRL("StringNameTestOwned"));
+		CHECK(name.GetString().IsIndividual());
+
+		StringName local = STRL("StringNameTestOwned").ToThreadLocal();
+		CHECK(local == name);
+		CHECK(!name.GetString().IsThreadLocal());
+	}
+	TEST_CASE("Dictionary key") {
+		FlatDictionary<StringName, int32> dict;
+		CHECK(dict.Add(STRL("Alpha"), 1));
+		CHECK(dict.Add(STRL("Beta"), 2));
+		CHECK(!dict.Add(StringName(std::string_view("Alpha")), 3));
+		CHECK(dict.Get(STRL("Beta")) == 2);
+		CHECK(!dict.ContainsKey(STRL("Gamma")));
+	}
+	TEST_CASE("Threaded") {
+		static constexpr int32 ThreadCount = 4;
+		static constexpr int32 Rounds = 2000;
+		int32 before = StringName::GetInternedCount();
+		StringName results[ThreadCount];
+
+		std::thread threads[ThreadCount];
+		for (int32 t = 0; t < ThreadCount; t += 1) {
+			threads[t] = std::thread([&results, t]() {
+				for (int32 i = 0; i < Rounds; i += 1) {
+					// Interning and dropping the same content races the removal of its entry.
+					StringName name = std::string_view("StringNameTestThreaded");
+					StringName other = String::Format(STRL("StringNameTestThreaded{0}"), i % 8);
+					if (i == Rounds - 1) {
+						results[t] = name;
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		for (int32 t = 1; t < ThreadCount; t += 1) {
+			CHECK(results[t] == results[0]);
+		}
+		CHECK(StringName::GetInternedCount() == before + 1);
+		for (auto& result : results) {
+			result = StringName();
+		}
+		CHECK(StringName::GetInternedCount() == before);
+	}
+}
@@ -0,0 +1,89 @@
+#include "doctest.h"
+#include "Engine/System/Unicode.h"
+#include "Engine/System/String.h"
+#include <string>
+
+using namespace Engine;
+
+TEST_SUITE("Unicode") {
+	bool IsValid(std::string_view text) {
+		return Unicode::IsValidUTF8((const u8char*)text.data(), (int32)text.size());
+	}
+
+	TEST_CASE("Validation") {
+		CHECK(IsValid(""));
+		CHECK(IsValid("Plain ASCII text"));
+		CHECK(IsValid("\xC2\xA9 \xE4\xBC\x9E\xE5\x85\xB5 \xF0\x9F\x98\x80"));
+		CHECK(IsValid("\xF4\x8F\xBF\xBF"));
+
+		CHECK(!IsValid("\x80"));
+		CHECK(!IsValid("\xC0\xAF"));
+		CHECK(!IsValid("\xE0\x80\xAF"));
+		CHECK(!IsValid("\xED\xA0\x80"));
+		CHECK(!IsValid("\xF4\x90\x80\x80"));
+		CHECK(!IsValid("\xF5\x80\x80\x80"));
+		CHECK(!IsValid("\xE4\xBC"));
+		CHECK(!IsValid("\xE4\x41\x9E"));
+
+		// Errors at every offset around the block sizes.
+		for (int32 length = 1; length < 70; length += 1) {
+			std::string text(length, 'a');
+			CHECK(IsValid(text));
+			for (int32 at = 0; at < length; at += 1) {
+				std::string broken = text;
+				broken[at] = '\xFF';
+				CHECK(!IsValid(broken));
+				if (at + 3 <= length) {
+					std::string multi = text;
+					multi.replace(at, 3, "\xE4\xBC\x9E");
+					CHECK(IsValid(multi));
+				}
+			}
+		}
+	}
+	TEST_CASE("Decode & encode") {
+		u8char buffer[Unicode::MaxUTF8Bytes];
+		for (uint32 codepoint : { 0x24u, 0xA9u, 0x4F1Eu, 0x1F600u, 0x10FFFFu }) {
+			int32 length = Unicode::EncodeUTF8(codepoint, buffer);
+			uint32 decoded = 0;
+			CHECK(Unicode::DecodeUTF8(buffer, length, decoded) == length);
+			CHECK(decoded == codepoint);
+			CHECK(Unicode::IsValidUTF8(buffer, length));
+		}
+		CHECK(Unicode::EncodeUTF8(0xD800, buffer) == 3);
+		uint32 decoded = 0;
+		Unicode::DecodeUTF8(buffer, 3, decoded);
+		CHECK(decoded == Unicode::ReplacementChar);
+
+		CHECK(Unicode::DecodeUTF8((const u8char*)"\xE4\xBC", 2, decoded) == 1);
+		CHECK(decoded == Unicode::ReplacementChar);
+		CHECK(Unicode::DecodeUTF8(buffer, 0, decoded) == 0);
+	}
+	TEST_CASE("Codepoints") {
+		String text = STRL("A伞😀!");
+		CHECK(text.IsValidUTF8());
+		CHECK(text.GetCount() == 9);
+		CHECK(text.GetCodepointCount() == 4);
+
+		uint32 expected[] = { 0x41, 0x4F1E, 0x1F600, 0x21 };
+		int32 index = 0;
+		for (uint32 codepoint : text.GetCodepoints()) {
+			REQUIRE(index < 4);
+			CHECK(codepoint == expected[index]);
+			index += 1;
+		}
+		CHECK(index == 4);
+
+		// An invalid byte comes out as one replacement char and iteration goes on.
+		String broken = String((const u8char*)"a\xFF" "b");
+		CHECK(!broken.IsValidUTF8());
+		index = 0;
+		uint32 brokenExpected[] = { 0x61, Unicode::ReplacementChar, 0x62 };
+		for (uint32 codepoint : broken.GetCodepoints()) {
+			REQUIRE(index < 3);
+			CHECK(codepoint == brokenExpected[index]);
+			index += 1;
+		}
+		CHECK(index == 3);
+	}
+}
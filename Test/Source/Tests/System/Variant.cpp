@@ -1,6 +1,7 @@
 #include "doctest.h"
 #include "Engine/System/Object/Variant.h"
 #include "Engine/System/Object/Object.h"
+#include <cmath>
 
 using namespace Engine;
 
@@ -30,4 +31,146 @@ TEST_SUITE("Variant") {
 		int32 b=Variant::CastToNative<int32>::Cast(a);
 		CHECK(b == 114514);
 	}
+	TEST_CASE("Copy & move") {
+		CHECK(sizeof(Variant) == 16);
+
+		Variant text = STRL("A string too long to be stored inline");
+		Variant copied = text;
+		CHECK(copied == text);
+		Variant moved = Memory::Move(copied);
+		CHECK(copied.GetType() == Variant::Type::Null);
+		CHECK(moved.AsString() == STRL("A string too long to be stored inline"));
+		text = 5;
+		CHECK(moved.GetType() == Variant::Type::String);
+		moved = Memory::Move(text);
+		CHECK(moved == 5);
+		CHECK(text.GetType() == Variant::Type::Null);
+
+		Variant v = Vector2(1, 2);
+		Variant w = v;
+		CHECK(w.AsVector2() == Vector2(1, 2));
+	}
+	TEST_CASE("Released object") {
+		class Manual :public ManualObject {};
+		Manual* object = MEMNEW(Manual);
+		Variant v = (Object*)object;
+		CHECK(v.AsObject() == object);
+		MEMDEL(object);
+		CHECK(v.GetType() == Variant::Type::Object);
+		CHECK(v.AsObject() == nullptr);
+		CHECK(v.AsString() == STRL("[Released Object]"));
+		CHECK(Variant((Object*)nullptr).AsString() == STRL("[Nullptr]"));
+	}
+	TEST_CASE("Packed arrays") {
+		PackedInt64Array ints{ 1, 2, 3 };
+		Variant v = ints;
+		CHECK(v.GetType() == Variant::Type::PackedInt64Array);
+		CHECK(v.AsString() == STRL("[1, 2, 3]"));
+
+		// Reading shares the storage.
+		PackedInt64Array read = v.AsPackedInt64Array();
+		CHECK(read.GetData() == ints.GetData());
+		CHECK(!read.IsExclusive());
+
+		// Writing copies it first.
+		read.Set(0, 10);
+		CHECK(read.Get(0) == 10);
+		CHECK(ints.Get(0) == 1);
+		CHECK(v.AsPackedInt64Array().Get(0) == 1);
+		CHECK(v != Variant(read));
+		CHECK(v == Variant(PackedInt64Array{ 1, 2, 3 }));
+
+		read.Resize(5);
+		CHECK(read.GetCount() == 5);
+		CHECK(read.Get(4) == 0);
+		read.Resize(1);
+		CHECK(read.GetCount() == 1);
+		read.Clear();
+		CHECK(read.IsEmpty());
+		CHECK(PackedInt64Array().GetData() == nullptr);
+
+		CHECK(v.AsPackedFloat32Array().IsEmpty());
+		CHECK(Variant(PackedVector2Array{ Vector2(1, 2) }).AsPackedVector2Array().Get(0) == Vector2(1, 2));
+		CHECK(Variant(PackedByteArray{ 255 }).AsString() == STRL("[255]"));
+
+		int32 native = Variant::CastToNative<const PackedInt64Array&>::Cast(v).GetCount();
+		CHECK(native == 3);
+	}
+	TEST_CASE("Evaluate in place") {
+		Variant result = STRL("Replaced");
+		CHECK(Variant::Evaluate(Variant::Operator::Add, 2, 3, result));
+		CHECK(result.GetType() == Variant::Type::Int64);
+		CHECK(result == 5);
+		CHECK(Variant::Evaluate(Variant::Operator::Multiply, result, 0.5, result));
+		CHECK(result == 2.5);
+		CHECK(Variant::Evaluate(Variant::Operator::Less, 1, 2, result));
+		CHECK(result == true);
+		CHECK(Variant::Evaluate(Variant::Operator::Divide, Vector2(2, 4), 2, result));
+		CHECK(result == Vector2(1, 2));
+		CHECK(Variant::Evaluate(Variant::Operator::Negative, 7, Variant(), result));
+		CHECK(result == -7);
+		CHECK(Variant::Evaluate(Variant::Operator::Add, STRL("a"), 1, result));
+		CHECK(result == STRL("a1"));
+
+		// The same pairs as the evaluator table, mixed number comparisons stay unsupported.
+		CHECK(!Variant::Evaluate(Variant::Operator::Equal, 1, 1.0, result));
+		CHECK(result.GetType() == Variant::Type::Null);
+		CHECK(Variant(7) % Variant(4) == 3);
+
+		// Integer division by zero fails with an error instead of crashing, though the pair itself is supported.
+		result = 1;
+		CHECK(!Variant::Evaluate(Variant::Operator::Divide, 1, 0, result));
+		CHECK(result.GetType() == Variant::Type::Null);
+		result = 1;
+		CHECK(!Variant::Evaluate(Variant::Operator::Mod, 1, 0, result));
+		CHECK(result.GetType() == Variant::Type::Null);
+		CHECK(Variant::CanEvaluate(Variant::Operator::Divide, Variant::Type::Int64, Variant::Type::Int64));
+		// Floating point division keeps IEEE results.
+		CHECK(Variant::Evaluate(Variant::Operator::Divide, 1.0, 0, result));
+		CHECK(std::isinf(result.AsDouble()));
+	}
+	TEST_CASE("Evaluate batch") {
+		Variant ints = PackedInt64Array{ 1, 2, 3 };
+		Variant result;
+		CHECK(Variant::EvaluateBatch(Variant::Operator::Multiply, ints, 10, result));
+		CHECK(result == Variant(PackedInt64Array{ 10, 20, 30 }));
+		CHECK(Variant::EvaluateBatch(Variant::Operator::Subtract, result, ints, result));
+		CHECK(result == Variant(PackedInt64Array{ 9, 18, 27 }));
+		CHECK(Variant::EvaluateBatch(Variant::Operator::Mod, result, 4, result));
+		CHECK(result == Variant(PackedInt64Array{ 1, 2, 3 }));
+		CHECK(ints == Variant(PackedInt64Array{ 1, 2, 3 }));
+
+		CHECK(!Variant::EvaluateBatch(Variant::Operator::Divide, ints, 0, result));
+		CHECK(!Variant::EvaluateBatch(Variant::Operator::Divide, ints, PackedInt64Array{ 1, 0, 1 }, result));
+		CHECK(!Variant::EvaluateBatch(Variant::Operator::Add, ints, PackedInt64Array{ 1 }, result));
+		CHECK(!Variant::EvaluateBatch(Variant::Operator::Less, ints, 1, result));
+		CHECK(result == Variant(PackedInt64Array{ 1, 2, 3 }));
+
+		Variant floats = PackedFloat32Array{ 1, 2 };
+		CHECK(Variant::EvaluateBatch(Variant::Operator::Divide, floats, 2, result));
+		CHECK(result == Variant(PackedFloat32Array{ 0.5f, 1 }));
+
+		Variant vectors = PackedVector2Array{ Vector2(1, 2), Vector2(3, 4) };
+		CHECK(Variant::EvaluateBatch(Variant::Operator::Multiply, vectors, 2.0, result));
+		CHECK(result == Variant(PackedVector2Array{ Vector2(2, 4), Vector2(6, 8) }));
+		CHECK(Variant::EvaluateBatch(Variant::Operator::Subtract, vectors, Vector2(1, 1), result));
+		CHECK(result == Variant(PackedVector2Array{ Vector2(0, 1), Vector2(2, 3) }));
+		CHECK(Variant::EvaluateBatch(Variant::Operator::Add, vectors, vectors, result));
+		CHECK(result == Variant(PackedVector2Array{ Vector2(2, 4), Vector2(6, 8) }));
+		CHECK(!Variant::EvaluateBatch(Variant::Operator::Multiply, vectors, vectors, result));
+	}
+	TEST_CASE("Numbers from strings") {
+		Variant i = STRL("-1234");
+		CHECK(i.AsInt64() == -1234);
+		CHECK(i.AsDouble() == -1234.0);
+		Variant d = STRL("0.125");
+		CHECK(d.AsDouble() == 0.125);
+		CHECK(d.AsInt64(-1) == -1);
+		Variant text = STRL("Not a number");
+		CHECK(text.AsInt64(5) == 5);
+		CHECK(text.AsDouble(0.5) == 0.5);
+
+		CHECK(Variant(0.25).AsString() == STRL("0.25"));
+		CHECK(Variant(-7).AsString() == STRL("-7"));
+	}
 }
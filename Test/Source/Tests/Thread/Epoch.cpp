@@ -0,0 +1,118 @@
+#include "doctest.h"
+#include "Engine/System/Thread/Epoch.h"
+#include "Engine/System/Memory/ReadMostly.h"
+#include <thread>
+
+using namespace Engine;
+
+namespace EpochTest {
+	std::atomic<int32> freed{ 0 };
+	void Free(void* ptr) {
+		freed.fetch_add(1);
+		MEMDEL((int32*)ptr);
+	}
+
+	struct Pair {
+		~Pair() {
+			// Readers of a version freed too early see it torn.
+			first = -1;
+		}
+
+		int64 first = 0;
+		int64 second = 0;
+	};
+}
+
+TEST_SUITE("Thread") {
+	TEST_CASE("Epoch") {
+		using EpochTest::freed;
+		Epoch::Collect();
+		freed.store(0);
+
+		SUBCASE("Freed right away without readers") {
+			Epoch::Retire(MEMNEW(int32(1)), &EpochTest::Free);
+			CHECK(freed.load() == 1);
+			CHECK(Epoch::GetPendingCount() == 0);
+		}
+		SUBCASE("Held back by pinned readers") {
+			std::atomic<int32> step{ 0 };
+			std::thread reader([&step]() {
+				EpochGuard guard{};
+				{
+					// Nested guards don't unpin early.
+					EpochGuard nested{};
+				}
+				CHECK(Epoch::IsPinned());
+				step.store(1);
+				while (step.load() != 2) {
+					std::this_thread::yield();
+				}
+			});
+			while (step.load() != 1) {
+				std::this_thread::yield();
+			}
+			CHECK(!Epoch::IsPinned());
+			Epoch::Retire(MEMNEW(int32(1)), &EpochTest::Free);
+			CHECK(freed.load() == 0);
+			CHECK(Epoch::Collect() == 1);
+			CHECK(freed.load() == 0);
+
+			step.store(2);
+			reader.join();
+			CHECK(Epoch::Collect() == 0);
+			CHECK(freed.load() == 1);
+		}
+		SUBCASE("Retired by a pinned thread") {
+			{
+				EpochGuard guard{};
+				Epoch::Retire(MEMNEW(int32(1)), &EpochTest::Free);
+				CHECK(freed.load() == 0);
+			}
+			CHECK(Epoch::Collect() == 0);
+			CHECK(freed.load() == 1);
+		}
+	}
+
+	TEST_CASE("ReadMostly") {
+		using EpochTest::Pair;
+		ReadMostly<Pair> value{};
+		CHECK(value.Read()->first == 0);
+		value.Update([](Pair& pair) {
+			pair.first = 1;
+		});
+		CHECK(value.Read()->first == 1);
+		CHECK(value.Read()->second == 0);
+		value.Set(Pair{ 2, 2 });
+		CHECK(value.Read()->first == 2);
+
+		// Readers never see a version half written nor freed.
+		constexpr int32 writes = 2000;
+		std::atomic<bool> done{ false };
+		std::atomic<bool> torn{ false };
+		std::thread readers[4];
+		for (auto& reader : readers) {
+			reader = std::thread([&value, &done, &torn]() {
+				while (!done.load()) {
+					EpochGuard guard{};
+					const Pair* pair = value.Read();
+					if (pair->first != pair->second) {
+						torn.store(true);
+					}
+				}
+			});
+		}
+		for (int32 i = 0; i < writes; i += 1) {
+			value.Update([](Pair& pair) {
+				pair.first += 1;
+				pair.second += 1;
+			});
+		}
+		done.store(true);
+		for (auto& reader : readers) {
+			reader.join();
+		}
+		CHECK(!torn.load());
+		CHECK(value.Read()->first == 2 + writes);
+		CHECK(Epoch::Collect() == 0);
+	}
+}
@@ -0,0 +1,36 @@
+#include "doctest.h"
+#include "Engine/System/Thread/Fiber.h"
+#include "Engine/System/Memory/Memory.h"
+
+using namespace Engine;
+
+TEST_SUITE("Thread") {
+	TEST_CASE("Fiber") {
+		struct Data {
+			Fiber* thread = nullptr;
+			int32 steps = 0;
+		};
+		Data data;
+		data.thread = Fiber::ConvertCurrentThread();
+		REQUIRE(data.thread != nullptr);
+		CHECK(Fiber::GetCurrent() == data.thread);
+
+		Fiber* fiber = MEMNEW(Fiber([](void* ptr) {
+			Data* data = (Data*)ptr;
+			while (true) {
+				data->steps += 1;
+				data->thread->SwitchTo();
+			}
+		}, &data, 64 * 1024));
+
+		for (int32 i = 1; i <= 3; i += 1) {
+			fiber->SwitchTo();
+			CHECK(data.steps == i);
+			CHECK(Fiber::GetCurrent() == data.thread);
+		}
+
+		MEMDEL(fiber);
+		Fiber::RevertCurrentThread();
+		CHECK(Fiber::GetCurrent() == nullptr);
+	}
+}
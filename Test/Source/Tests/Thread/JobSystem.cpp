@@ -0,0 +1,307 @@
+#include "doctest.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include <thread>
+
+using namespace Engine;
+
+TEST_SUITE("Thread") {
+	TEST_CASE("JobSystem") {
+		JobSystem js{};
+		js.Start();
+
+		static constexpr int32 Count = 64;
+		AtomicValue<int32> sum{ 0 };
+		AtomicValue<int32>* sumPtr = &sum;
+
+		auto add = [](Job* job) {
+			auto data = job->GetDataAs<AtomicValue<int32>*>();
+			(*data)->FetchAdd(1);
+		};
+
+		SUBCASE("WaitJob") {
+			auto job = js.AddJob(add, &sumPtr, sizeof(sumPtr));
+			js.WaitJob(job);
+			CHECK(job.IsFinished());
+			CHECK(sum.Get() == 1);
+		}
+
+		SUBCASE("Counter") {
+			auto counter = SharedPtr<JobCounter>::Create();
+			for (int32 i = 0; i < Count; i += 1) {
+				js.AddJob(add, &sumPtr, sizeof(sumPtr), Job::Preference::Null, counter);
+			}
+			js.WaitCounter(counter);
+			CHECK(counter->IsFinished());
+			CHECK(sum.Get() == Count);
+		}
+
+		SUBCASE("Continuation") {
+			auto first = SharedPtr<JobCounter>::Create();
+			auto second = SharedPtr<JobCounter>::Create();
+			first->Increase();
+			for (int32 i = 0; i < Count; i += 1) {
+				js.AddJobAfter(first, add, &sumPtr, sizeof(sumPtr), Job::Preference::Null, second);
+			}
+			// Nothing runs before the dependency is finished.
+			CHECK(second->GetValue() == Count);
+			CHECK(sum.Get() == 0);
+
+			first->Decrease();
+			js.WaitCounter(second);
+			CHECK(sum.Get() == Count);
+
+			// Already finished dependency queues the job right away.
+			auto job = js.AddJobAfter(first, add, &sumPtr, sizeof(sumPtr));
+			js.WaitJob(job);
+			CHECK(sum.Get() == Count + 1);
+		}
+
+		SUBCASE("Handle generation") {
+			CHECK(!JobHandle().IsValid());
+			CHECK(JobHandle().IsFinished());
+
+			auto first = js.AddJob(add, &sumPtr, sizeof(sumPtr));
+			js.WaitJob(first);
+
+			// The recycled job must not revive the old handle.
+			auto dependency = SharedPtr<JobCounter>::Create(1);
+			auto second = js.AddJobAfter(dependency, add, &sumPtr, sizeof(sumPtr));
+			CHECK(first.IsFinished());
+			CHECK(!second.IsFinished());
+
+			dependency->Decrease();
+			js.WaitJob(second);
+			CHECK(second.IsFinished());
+			CHECK(sum.Get() == 2);
+		}
+
+		SUBCASE("Callable") {
+			auto counter = SharedPtr<JobCounter>::Create();
+			// Fits in the job.
+			js.AddJob([&sum]() {
+				sum.FetchAdd(1);
+			}, Job::Preference::Null, counter);
+
+			// Pooled payload.
+			int32 medium[64];
+			for (int32 i = 0; i < 64; i += 1) {
+				medium[i] = i;
+			}
+			js.AddJob([&sum, medium]() {
+				for (int32 value : medium) {
+					sum.FetchAdd(value);
+				}
+			}, Job::Preference::Null, counter);
+
+			// Directly on the heap.
+			int32 large[1024];
+			for (int32 i = 0; i < 1024; i += 1) {
+				large[i] = 1;
+			}
+			js.AddJob([&sum, large]() {
+				for (int32 value : large) {
+					sum.FetchAdd(value);
+				}
+			}, Job::Preference::Null, counter);
+
+			js.WaitCounter(counter);
+			CHECK(sum.Get() == 1 + 2016 + 1024);
+		}
+
+		SUBCASE("ParallelFor") {
+			static constexpr int32 Length = 1000;
+			List<int32> values(Length);
+			for (int32 i = 0; i < Length; i += 1) {
+				values.Add(0);
+			}
+			int32* raw = values.GetRawElementPtr();
+
+			js.ParallelFor(0, Length, 7, [raw](int32 index) {
+				raw[index] += index;
+			});
+			js.ParallelForEach(values, 0, [](int32& value) {
+				value *= 2;
+			});
+
+			bool correct = true;
+			for (int32 i = 0; i < Length; i += 1) {
+				correct = correct && values.Get(i) == i * 2;
+			}
+			CHECK(correct);
+
+			// Empty range does nothing.
+			js.ParallelFor(5, 5, 1, [&sum](int32 index) {
+				sum.FetchAdd(1);
+			});
+			CHECK(sum.Get() == 0);
+		}
+
+		SUBCASE("ParallelSort") {
+			static constexpr int32 Length = 100000;
+			List<int32> values(Length);
+			uint32 seed = 1;
+			int64 total = 0;
+			for (int32 i = 0; i < Length; i += 1) {
+				seed = seed * 1664525u + 1013904223u;
+				values.Add((int32)(seed >> 4) - 0x8000000);
+				total += values[i];
+			}
+
+			js.ParallelSort(values);
+
+			bool sorted = true;
+			int64 sortedTotal = values[0];
+			for (int32 i = 1; i < Length; i += 1) {
+				sorted = sorted && values[i - 1] <= values[i];
+				sortedTotal += values[i];
+			}
+			CHECK(sorted);
+			CHECK(sortedTotal == total);
+
+			// Short lists are sorted in place.
+			List<int32> small{ 3, 1, 2 };
+			js.ParallelSort(small, [](int32 a, int32 b) {
+				return a > b;
+			});
+			CHECK(small[0] == 3);
+			CHECK(small[2] == 1);
+		}
+
+		js.Stop();
+	}
+
+	TEST_CASE("JobSystem priority") {
+		// Not started, the waiting thread runs everything in order.
+		JobSystem js{};
+
+		List<int32> order{};
+		List<int32>* orderPtr = &order;
+		auto record = [](Job* job) {
+			auto list = *job->GetDataAs<List<int32>*>();
+			list->Add((int32)job->priority);
+		};
+
+		auto counter = SharedPtr<JobCounter>::Create();
+		js.AddJob(record, &orderPtr, sizeof(orderPtr), Job::Preference::Null, counter, Job::Priority::Background);
+		js.AddJob(record, &orderPtr, sizeof(orderPtr), Job::Preference::Null, counter, Job::Priority::Normal);
+		js.AddJob(record, &orderPtr, sizeof(orderPtr), Job::Preference::Null, counter, Job::Priority::Critical);
+		js.WaitCounter(counter);
+
+		REQUIRE(order.GetCount() == 3);
+		CHECK(order.Get(0) == (int32)Job::Priority::Critical);
+		CHECK(order.Get(1) == (int32)Job::Priority::Normal);
+		CHECK(order.Get(2) == (int32)Job::Priority::Background);
+	}
+
+	TEST_CASE("JobSystem config") {
+		JobSystemConfig config;
+		config.workerCount = 2;
+		config.windowWorker = -1;
+		config.workerNamePrefix = STRL("Test Worker");
+
+		JobSystem js{ config };
+		CHECK(js.GetWorkerCount() == 2);
+		js.Start();
+
+		AtomicValue<int32> sum{ 0 };
+		js.ParallelFor(0, 100, 1, [&sum](int32 index) {
+			sum.FetchAdd(index);
+		});
+		CHECK(sum.Get() == 4950);
+
+		// Window jobs run anywhere without a window worker.
+		auto counter = SharedPtr<JobCounter>::Create();
+		AtomicValue<int32>* sumPtr = &sum;
+		js.AddJob([](Job* job) {
+			(*job->GetDataAs<AtomicValue<int32>*>())->FetchAdd(1);
+		}, &sumPtr, sizeof(sumPtr), Job::Preference::Window, counter);
+		js.WaitCounter(counter);
+		CHECK(sum.Get() == 4951);
+
+		js.Stop();
+	}
+
+	TEST_CASE("JobSystem fibers") {
+		JobSystemConfig config;
+		config.workerCount = 2;
+		config.windowWorker = -1;
+		config.useFibers = true;
+
+		JobSystem js{ config };
+		js.Start();
+
+		struct Data {
+			JobSystem* js;
+			AtomicValue<int32>* sum;
+		};
+		AtomicValue<int32> sum{ 0 };
+		Data data{ &js, &sum };
+
+		// Outer jobs get suspended while waiting for their inner jobs.
+		static constexpr int32 OuterCount = 8;
+		static constexpr int32 InnerCount = 16;
+		auto counter = SharedPtr<JobCounter>::Create();
+		for (int32 i = 0; i < OuterCount; i += 1) {
+			js.AddJob([](Job* job) {
+				Data data = *(Data*)job->GetDataAs<Data>();
+				auto inner = SharedPtr<JobCounter>::Create();
+				for (int32 j = 0; j < InnerCount; j += 1) {
+					data.js->AddJob([](Job* job) {
+						(*job->GetDataAs<AtomicValue<int32>*>())->FetchAdd(1);
+					}, &data.sum, sizeof(data.sum), Job::Preference::Null, inner);
+				}
+				data.js->WaitCounter(inner);
+				CHECK(inner->IsFinished());
+				data.sum->FetchAdd(1000);
+			}, &data, sizeof(data), Job::Preference::Null, counter);
+		}
+		js.WaitCounter(counter);
+		CHECK(sum.Get() == OuterCount * (InnerCount + 1000));
+
+		js.Stop();
+	}
+
+	TEST_CASE("JobSystem efficiency") {
+		JobSystemConfig config;
+		config.workerCount = 4;
+		config.windowWorker = -1;
+		config.efficiencyMode = true;
+
+		JobSystem js{ config };
+		CHECK(js.IsEfficiencyMode());
+		CHECK(js.GetActiveWorkerLimit() == 4);
+		js.Start();
+
+		// However few workers are awake, every job gets done.
+		AtomicValue<int32> sum{ 0 };
+		for (int32 round = 0; round < 20; round += 1) {
+			js.ParallelFor(0, 1000, 1, [&sum](int32 index) {
+				sum.FetchAdd(1);
+			});
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		CHECK(sum.Get() == 20000);
+
+		// Idle for a while, a single job measures a light load when its worker parks.
+		std::this_thread::sleep_for(std::chrono::nanoseconds(JobSystem::LoadInterval * 3));
+		auto counter = SharedPtr<JobCounter>::Create();
+		js.AddJob([&sum]() {
+			sum.FetchAdd(1);
+		}, Job::Preference::Null, counter);
+		js.WaitCounter(counter);
+		for (int32 i = 0; i < 1000 && js.GetActiveWorkerCount() > 0; i += 1) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		CHECK(js.GetActiveWorkerCount() == 0);
+		CHECK(js.GetActiveWorkerLimit() <= 2);
+
+		js.SetEfficiencyMode(false);
+		CHECK_FALSE(js.IsEfficiencyMode());
+		js.ParallelFor(0, 1000, 1, [&sum](int32 index) {
+			sum.FetchAdd(1);
+		});
+		CHECK(sum.Get() == 21001);
+
+		js.Stop();
+	}
+}
@@ -0,0 +1,113 @@
+#include "doctest.h"
+#include "Engine/System/Thread/AdaptiveMutex.h"
+#include "Engine/System/Thread/ReadWriteLock.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <thread>
+
+using namespace Engine;
+
+TEST_SUITE("Thread") {
+	TEST_CASE("AdaptiveMutex") {
+		AdaptiveMutex mutex;
+		CHECK(mutex.try_lock());
+		CHECK(!mutex.try_lock());
+		mutex.unlock();
+		{
+			auto lock = SimpleLock<AdaptiveMutex>(mutex);
+			CHECK(!mutex.try_lock());
+		}
+		CHECK(mutex.try_lock());
+		mutex.unlock();
+
+		// Contended by more threads than cores, so some of them sleep.
+		constexpr int32 threadCount = 8;
+		constexpr int32 increments = 20000;
+		int64 counter = 0;
+		std::thread threads[threadCount];
+		for (int32 i = 0; i < threadCount; i += 1) {
+			threads[i] = std::thread([&mutex, &counter]() {
+				for (int32 j = 0; j < increments; j += 1) {
+					auto lock = SimpleLock<AdaptiveMutex>(mutex);
+					counter += 1;
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		CHECK(counter == (int64)threadCount * increments);
+	}
+
+	TEST_CASE("ReadWriteLock") {
+		ReadWriteLock lock;
+		SUBCASE("Exclusion") {
+			CHECK(lock.try_lock_shared());
+			CHECK(lock.try_lock_shared());
+			// Readers share it, a writer waits for all of them.
+			CHECK(!lock.try_lock());
+			lock.unlock_shared();
+			CHECK(!lock.try_lock());
+			lock.unlock_shared();
+			CHECK(lock.try_lock());
+			CHECK(!lock.try_lock_shared());
+			CHECK(!lock.try_lock());
+			lock.unlock();
+			{
+				auto reading = SharedLock<ReadWriteLock>(lock);
+				CHECK(!lock.try_lock());
+			}
+			CHECK(lock.try_lock());
+			lock.unlock();
+		}
+		SUBCASE("Writer waits for readers and holds off new ones") {
+			lock.lock_shared();
+			std::atomic<bool> written{ false };
+			std::thread writer([&lock, &written]() {
+				auto writing = SimpleLock<ReadWriteLock>(lock);
+				written.store(true);
+			});
+			// Until the writer is waiting, after which readers are held off.
+			while (lock.try_lock_shared()) {
+				lock.unlock_shared();
+				ThreadUtil::YieldThread();
+			}
+			CHECK(!written.load());
+			lock.unlock_shared();
+			writer.join();
+			CHECK(written.load());
+			CHECK(lock.try_lock_shared());
+			lock.unlock_shared();
+		}
+		SUBCASE("Contended") {
+			// A pair a writer changes together, readers must never see them apart.
+			int64 values[2] = {};
+			std::atomic<bool> torn{ false };
+			constexpr int32 writes = 5000;
+			std::thread threads[8];
+			for (int32 i = 0; i < 2; i += 1) {
+				threads[i] = std::thread([&lock, &values]() {
+					for (int32 j = 0; j < writes; j += 1) {
+						auto writing = SimpleLock<ReadWriteLock>(lock);
+						values[0] += 1;
+						values[1] += 1;
+					}
+				});
+			}
+			for (int32 i = 2; i < 8; i += 1) {
+				threads[i] = std::thread([&lock, &values, &torn]() {
+					for (int32 j = 0; j < writes; j += 1) {
+						auto reading = SharedLock<ReadWriteLock>(lock);
+						if (values[0] != values[1]) {
+							torn.store(true);
+						}
+					}
+				});
+			}
+			for (auto& thread : threads) {
+				thread.join();
+			}
+			CHECK(!torn.load());
+			CHECK(values[0] == 2 * writes);
+		}
+	}
+}
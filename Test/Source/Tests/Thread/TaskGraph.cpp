@@ -0,0 +1,100 @@
+#include "doctest.h"
+#include "Engine/System/Thread/TaskGraph.h"
+
+using namespace Engine;
+
+namespace {
+	bool HasDependency(TaskGraph& graph, const char* phase, const char* dependency) {
+		int32 index = graph.FindPhase(StringName(String(phase)));
+		int32 target = graph.FindPhase(StringName(String(dependency)));
+		REQUIRE(index >= 0);
+		REQUIRE(target >= 0);
+		for (int32 existing : graph.GetDependencies(index)) {
+			if (existing == target) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+TEST_SUITE("Thread") {
+	TEST_CASE("TaskGraph") {
+		StringName input(STRL("Input"));
+		StringName transforms(STRL("Transforms"));
+		StringName bodies(STRL("Bodies"));
+		StringName visible(STRL("Visible"));
+		StringName audio(STRL("AudioState"));
+
+		// Each phase records when it ran, so orders can be checked afterwards.
+		AtomicValue<int32> clock{ 0 };
+		int32 finished[6]{};
+		auto phase = [&clock, &finished](int32 index) {
+			return [&clock, &finished, index]() {
+				finished[index] = clock.Add(1);
+			};
+		};
+
+		TaskGraph graph{};
+		CHECK(graph.AddPhase(STRL("Input"), phase(0), {}, { input }));
+		CHECK(graph.AddPhase(STRL("Logic"), phase(1), { input }, { transforms }));
+		CHECK(graph.AddPhase(STRL("Physics"), phase(2), { input }, { bodies }));
+		CHECK(graph.AddPhase(STRL("Transforms"), phase(3), { bodies }, { transforms }));
+		CHECK(graph.AddPhase(STRL("Culling"), phase(4), { transforms }, { visible }));
+		CHECK(graph.AddPhase(STRL("Audio"), phase(5), { transforms }, { audio }));
+		CHECK_FALSE(graph.AddPhase(STRL("Audio"), phase(5), {}, {}));
+		CHECK(graph.GetPhaseCount() == 6);
+
+		CHECK(HasDependency(graph, "Logic", "Input"));
+		CHECK(HasDependency(graph, "Physics", "Input"));
+		CHECK_FALSE(HasDependency(graph, "Physics", "Logic"));
+		// Writing after a write, and after the physics it reads.
+		CHECK(HasDependency(graph, "Transforms", "Logic"));
+		CHECK(HasDependency(graph, "Transforms", "Physics"));
+		CHECK(HasDependency(graph, "Culling", "Transforms"));
+		CHECK_FALSE(HasDependency(graph, "Culling", "Logic"));
+		CHECK_FALSE(HasDependency(graph, "Audio", "Culling"));
+
+		auto checkOrder = [&graph, &finished]() {
+			for (int32 i = 0; i < graph.GetPhaseCount(); i += 1) {
+				CHECK(finished[i] > 0);
+				for (int32 dependency : graph.GetDependencies(i)) {
+					CHECK(finished[dependency] < finished[i]);
+				}
+			}
+		};
+
+		SUBCASE("Serial") {
+			graph.Run(nullptr);
+			checkOrder();
+			for (int32 i = 0; i < 6; i += 1) {
+				CHECK(finished[i] == i + 1);
+			}
+		}
+
+		SUBCASE("Jobs") {
+			JobSystemConfig config{};
+			config.workerCount = 4;
+			JobSystem js(config);
+			js.Start();
+			for (int32 frame = 0; frame < 100; frame += 1) {
+				clock.Set(0);
+				for (int32& value : finished) {
+					value = 0;
+				}
+				graph.Run(&js);
+				checkOrder();
+			}
+			js.Stop();
+		}
+
+		SUBCASE("Readers before a writer") {
+			CHECK(graph.AddPhase(STRL("Submit"), phase(0), {}, { transforms, visible }));
+			CHECK(HasDependency(graph, "Submit", "Culling"));
+			CHECK(HasDependency(graph, "Submit", "Audio"));
+			CHECK(graph.RemovePhase(STRL("Submit")));
+			CHECK_FALSE(graph.RemovePhase(STRL("Submit")));
+			CHECK(graph.GetPhaseCount() == 6);
+		}
+	}
+}
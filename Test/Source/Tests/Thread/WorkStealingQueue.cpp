@@ -0,0 +1,85 @@
+#include "doctest.h"
+#include "Engine/System/Thread/WorkStealingQueue.h"
+#include "Engine/System/Thread/Atomic.h"
+#include <thread>
+
+using namespace Engine;
+
+TEST_SUITE("Thread") {
+	TEST_CASE("WorkStealingQueue") {
+		WorkStealingQueue<int32> queue{ 4 };
+		CHECK(queue.GetCapacity() == 4);
+
+		CHECK(queue.Push(0));
+		CHECK(queue.Push(1));
+		CHECK(queue.Push(2));
+		CHECK(queue.Push(3));
+		CHECK(!queue.Push(4));
+		CHECK(queue.GetCount() == 4);
+
+		int32 value = -1;
+		// Owner pops LIFO.
+		CHECK(queue.Pop(value));
+		CHECK(value == 3);
+		// Thief steals FIFO.
+		CHECK(queue.Steal(value));
+		CHECK(value == 0);
+		CHECK(queue.GetCount() == 2);
+
+		CHECK(queue.Pop(value));
+		CHECK(value == 2);
+		CHECK(queue.Pop(value));
+		CHECK(value == 1);
+		CHECK(!queue.Pop(value));
+		CHECK(!queue.Steal(value));
+		CHECK(queue.GetCount() == 0);
+
+		// Wrap around.
+		for (int32 i = 0; i < 10; i += 1) {
+			CHECK(queue.Push(i));
+			CHECK(queue.Steal(value));
+			CHECK(value == i);
+		}
+	}
+
+	TEST_CASE("WorkStealingQueue concurrent steal") {
+		static constexpr int32 Count = 10000;
+		WorkStealingQueue<int32> queue{ Count };
+		AtomicValue<int64> sum{ 0 };
+		AtomicValue<int32> taken{ 0 };
+		AtomicValue<bool> done{ false };
+
+		auto thief = [&]() {
+			int32 value;
+			while (!done.Get() || queue.GetCount() > 0) {
+				if (queue.Steal(value)) {
+					sum.FetchAdd(value);
+					taken.FetchAdd(1);
+				}
+			}
+		};
+		std::thread t1(thief);
+		std::thread t2(thief);
+
+		int64 expected = 0;
+		int32 value;
+		for (int32 i = 0; i < Count; i += 1) {
+			queue.Push(i);
+			expected += i;
+			if (i % 3 == 0 && queue.Pop(value)) {
+				sum.FetchAdd(value);
+				taken.FetchAdd(1);
+			}
+		}
+		while (queue.Pop(value)) {
+			sum.FetchAdd(value);
+			taken.FetchAdd(1);
+		}
+		done.Set(true);
+		t1.join();
+		t2.join();
+
+		CHECK(taken.Get() == Count);
+		CHECK(sum.Get() == expected);
+	}
+}